@@ -57,10 +57,19 @@ if(NOT ORIGIN_INCLUDED)
     include_directories(${ORIGIN_FAKE_ROOT}/..)
   endif()
 
+  # The instrumentation hooks in the hot paths of the library (see
+  # origin/instrument/instrument.hpp) are compiled only when requested, since
+  # they must be enabled in every translation unit or in none.
+  option(ORIGIN_INSTRUMENT "Compile the instrumentation hooks" OFF)
+  if(ORIGIN_INSTRUMENT)
+    add_definitions(-DORIGIN_INSTRUMENT=1)
+  endif()
+
   # Include Origin-specific macros
   include(OriginVersion)
   include(OriginModule)
   include(OriginTest)
+  include(OriginPerformance)
 
 endif()
 
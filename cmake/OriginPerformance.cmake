@@ -8,45 +8,75 @@
 
 
 # This module contains macros used to build performance testing targets.
-# Each performance test is hosted in a different directory (usually as a
-# subdirectory of tests/perf), and contains one or more programs that are
-# compiled and run (using 'make performance') to produce and compile results.
+# Each performance comparison is hosted in the module that it measures (as an
+# "x.perf" directory next to "x.test"), and contains one or more programs
+# that are compiled and run (using 'make perform') to produce and compare
+# results.
 #
-# Note that a full system for compiling performance test results is still
-# being worked out.
+# Each program is written using the benchmark library (origin.benchmark),
+# and runs its suite with benchmark_main, so that every program accepts the
+# same options and writes its results in the same formats. None of the
+# programs are built by default.
 
 
-# Tools used to analyze and graph results
+# The perform target runs all performance comparisons.
+if(NOT TARGET perform)
+  add_custom_target(perform)
+endif()
 
-set(ORIGIN_PLOT_COMP_RATIO ${ORIGIN_ROOT}/tools/)
+# The tool used to compare the results of the programs in a comparison.
+set(ORIGIN_PERF_REPORT origin.perf_report)
+
+
+# Build the report tool once.
+macro(origin_perf_report_tool)
+  if(NOT TARGET ${ORIGIN_PERF_REPORT})
+    add_executable(${ORIGIN_PERF_REPORT} EXCLUDE_FROM_ALL
+                   ${ORIGIN_PROJECT_ROOT}/tools/perf_report.cpp)
+    target_link_libraries(${ORIGIN_PERF_REPORT} origin.benchmark)
+  endif()
+endmacro()
+
+
+# Create an optimized benchmark program tgt from the source file src.
+macro(origin_perf_program tgt src)
+  # The programs are optimized whatever the build type, since unoptimized
+  # results mean nothing.
+  add_executable(${tgt} EXCLUDE_FROM_ALL ${src})
+  set_target_properties(${tgt} PROPERTIES COMPILE_FLAGS "-O2 -DNDEBUG")
+  link_imports(${tgt} ${ORIGIN_CURRENT_MODULE} origin.benchmark)
+endmacro()
 
 
 # Build a head-to-head performance comparison for two different source code
 # files implementing similar tests.
 #
-#   origin_perf_comparison(target COMPARE file1 file2 [REPEAT n])
-#
-# If REPEAT is not given, the default value is 1. For head-to-head performance
-# tests, that isn't generally a good idea.
+#   origin_perf_comparison(target COMPARE file1 file2 [REPEAT n] [MAX_RATIO r])
 #
-# TODO: Support arguments for annotating the resulting documents or selecting
-# the output format. Currently, we generate pdf, but generating png might be
-# useful for web reporting. Or build commands that generate generate all such
-# outputs and build a single target that intgrates the performance reporting.
+# Each program is run with n samples per benchmark; if REPEAT is not given,
+# the benchmark library's default number of samples is used. The results of
+# each program are written as CSV, to perf_<target>_<file>.csv, and are
+# compared in a text report, perf_<target>.txt, giving the median time of
+# each benchmark of the first program and its ratio in the others. If
+# MAX_RATIO is given, the comparison fails when any ratio exceeds r.
 #
-# FIXME: I will need to change the call mechanism when I get the performance
-# tester's argument parsing in better shape. Repetitions will probably be
-# passed as an option (-r or --repeat).
+# The programs are linked against the current module and its imports, so
+# this macro must follow origin_module.
 macro(origin_perf_comparison id)
   # Parse the command line arguments.
-  parse_arguments(parsed "COMPARE;REPEAT" "" ${ARGN})
+  parse_arguments(parsed "COMPARE;REPEAT;MAX_RATIO" "" ${ARGN})
   set(files ${parsed_COMPARE})
+  set(args --format=csv)
   if(parsed_REPEAT)
-    set(repeat ${parsed_REPEAT})
-  else()
-    set(repeat 1)
+    list(APPEND args --samples=${parsed_REPEAT})
+  endif()
+  set(report_args)
+  if(parsed_MAX_RATIO)
+    list(APPEND report_args --max-ratio=${parsed_MAX_RATIO})
   endif()
 
+  origin_perf_report_tool()
+
   set(bin ${CMAKE_CURRENT_BINARY_DIR})
   set(main "perf_${id}")
 
@@ -56,35 +86,63 @@ macro(origin_perf_comparison id)
     set(tgt ${main}_${name})
 
     # Create a target for the test program.
-    origin_executable(${tgt} ${i})
-    target_link_libraries(${tgt} origin)
-
-    # And create a command that will generate its output.
-    # FIXME: This probably won't work in a non-unix environment or
-    # anywhere where executable targets have a non-empty suffix.
-    set(exe ${bin}/${tgt})
-    set(txt ${exe}.txt)
+    origin_perf_program(${tgt} ${i})
+
+    # And create a command that will generate its output. Naming the target
+    # in the command runs the program wherever it was built.
+    set(csv ${bin}/${tgt}.csv)
     add_custom_command(
-      OUTPUT ${txt}
-      COMMAND ${exe} ${repeat} > ${txt}
+      OUTPUT ${csv}
+      COMMAND ${tgt} ${args} --output=${csv}
       DEPENDS ${tgt})
 
-    # Add the output text to the list of dependencies that this
-    # performance comparison will depend upon.
-    list(APPEND results ${txt})
+    # Add the output to the list of dependencies that this performance
+    # comparison will depend upon.
+    list(APPEND results ${csv})
   endforeach()
 
-  # Generate a command to synthesize the output into a graph of some kind.
-  set(pdf ${main}.pdf)
+  # Compare the results of the programs.
+  set(txt ${bin}/${main}.txt)
   add_custom_command(
-    OUTPUT ${pdf}
-    COMMAND ${ORIGIN_PLOT_COMP_RATIO}.py -o ${pdf} ${results}
-    DEPENDS ${results})
+    OUTPUT ${txt}
+    COMMAND ${ORIGIN_PERF_REPORT} ${report_args} --output=${txt} ${results}
+    COMMAND ${CMAKE_COMMAND} -E echo "Wrote ${txt}"
+    DEPENDS ${results} ${ORIGIN_PERF_REPORT})
 
   # Build a target for this performance comparison
-  add_custom_target(${main} DEPENDS ${pdf})
+  add_custom_target(${main} DEPENDS ${txt})
 
   # Register this performance test as a dependency of the perf target.
   add_dependencies(perform ${main})
 
 endmacro()
+
+
+# Build a performance suite: a single program whose results are reported
+# on their own, rather than compared with those of other programs.
+#
+#   origin_perf_suite(target SOURCE file [REPEAT n] [ARGS args...])
+#
+# The program is run with n samples per benchmark and the arguments args,
+# and its results are written as a text report, perf_<target>.txt, which
+# includes the rates of the benchmarks that describe their work.
+macro(origin_perf_suite id)
+  parse_arguments(parsed "SOURCE;REPEAT;ARGS" "" ${ARGN})
+  set(args --format=text ${parsed_ARGS})
+  if(parsed_REPEAT)
+    list(APPEND args --samples=${parsed_REPEAT})
+  endif()
+
+  set(main "perf_${id}")
+  origin_perf_program(${main} ${parsed_SOURCE})
+
+  set(txt ${CMAKE_CURRENT_BINARY_DIR}/${main}.txt)
+  add_custom_command(
+    OUTPUT ${txt}
+    COMMAND ${main} ${args} --output=${txt}
+    COMMAND ${CMAKE_COMMAND} -E echo "Wrote ${txt}"
+    DEPENDS ${main})
+
+  add_custom_target(${main}_report DEPENDS ${txt})
+  add_dependencies(perform ${main}_report)
+endmacro()
@@ -0,0 +1,924 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define ORIGIN_BENCHMARK_HAS_PERF 1
+#endif
+
+#include <origin/memory/tracking.hpp>
+
+#include "benchmark.hpp"
+
+namespace origin
+{
+  namespace benchmark_impl
+  {
+    void
+    escape(const volatile void* p)
+    {
+      static const volatile void* volatile sink;
+      sink = p;
+    }
+  } // namespace benchmark_impl
+
+
+  namespace
+  {
+    // Returns the median of the sorted samples xs.
+    double
+    sorted_median(const std::vector<double>& xs)
+    {
+      std::size_t n = xs.size();
+      return n % 2 ? xs[n / 2] : (xs[n / 2 - 1] + xs[n / 2]) / 2;
+    }
+  } // namespace
+
+  sample_statistics
+  summarize(std::vector<double> xs)
+  {
+    if (xs.empty())
+      throw std::invalid_argument("summarize: no samples");
+    std::sort(xs.begin(), xs.end());
+
+    sample_statistics s;
+    std::size_t n = xs.size();
+    s.count = n;
+    s.min = xs.front();
+    s.max = xs.back();
+    double sum = 0;
+    for (double x : xs)
+      sum += x;
+    s.mean = sum / n;
+    s.median = sorted_median(xs);
+
+    std::vector<double> ds;
+    for (double x : xs)
+      ds.push_back(std::abs(x - s.median));
+    std::sort(ds.begin(), ds.end());
+    s.mad = sorted_median(ds);
+
+    // The ranks j and k of the bounds of the interval, counted from 1, are
+    // n/2 -/+ 1.96 standard deviations of the binomial distribution
+    // B(n, 1/2), so that the median lies within [x(j), x(k + 1)] with about
+    // 95% probability.
+    double h = 1.96 * std::sqrt(double(n)) / 2;
+    double j = std::round(n / 2.0 - h) - 1;
+    double k = std::round(n / 2.0 + h);
+    s.ci_lower = xs[std::size_t(std::max(j, 0.0))];
+    s.ci_upper = xs[std::size_t(std::min(k, double(n - 1)))];
+    return s;
+  }
+
+
+  namespace
+  {
+    const char* counter_names[] = {
+      "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses",
+      "dtlb-misses", "page-faults"
+    };
+
+    constexpr std::size_t counter_count =
+      sizeof(counter_names) / sizeof(counter_names[0]);
+
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    // Returns the perf_event configuration of a cache event.
+    constexpr std::uint64_t
+    cache_event(std::uint64_t cache, std::uint64_t op, std::uint64_t result)
+    {
+      return cache | (op << 8) | (result << 16);
+    }
+
+    // Returns a descriptor counting the events c of the calling thread,
+    // disabled, or -1 if the counter cannot be opened.
+    int
+    open_counter(hardware_counter c)
+    {
+      perf_event_attr a;
+      std::memset(&a, 0, sizeof(a));
+      a.size = sizeof(a);
+      a.type = PERF_TYPE_HARDWARE;
+      switch (c) {
+      case hardware_counter::cycles:
+        a.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case hardware_counter::instructions:
+        a.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case hardware_counter::l1d_misses:
+        a.type = PERF_TYPE_HW_CACHE;
+        a.config = cache_event(PERF_COUNT_HW_CACHE_L1D,
+                               PERF_COUNT_HW_CACHE_OP_READ,
+                               PERF_COUNT_HW_CACHE_RESULT_MISS);
+        break;
+      case hardware_counter::llc_misses:
+        a.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      case hardware_counter::branch_misses:
+        a.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+      case hardware_counter::dtlb_misses:
+        a.type = PERF_TYPE_HW_CACHE;
+        a.config = cache_event(PERF_COUNT_HW_CACHE_DTLB,
+                               PERF_COUNT_HW_CACHE_OP_READ,
+                               PERF_COUNT_HW_CACHE_RESULT_MISS);
+        break;
+      case hardware_counter::page_faults:
+        a.type = PERF_TYPE_SOFTWARE;
+        a.config = PERF_COUNT_SW_PAGE_FAULTS;
+        break;
+      }
+      a.disabled = 1;
+      a.exclude_kernel = 1;
+      a.exclude_hv = 1;
+      a.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                    | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      return int(syscall(__NR_perf_event_open, &a, 0, -1, -1, 0));
+    }
+#endif
+  } // namespace
+
+  std::vector<hardware_counter>
+  all_hardware_counters()
+  {
+    std::vector<hardware_counter> cs;
+    for (std::size_t i = 0; i != counter_count; ++i)
+      cs.push_back(hardware_counter(i));
+    return cs;
+  }
+
+  const char*
+  counter_name(hardware_counter c)
+  {
+    return counter_names[std::size_t(c)];
+  }
+
+  hardware_counter
+  parse_counter(const std::string& s)
+  {
+    for (std::size_t i = 0; i != counter_count; ++i)
+      if (s == counter_names[i])
+        return hardware_counter(i);
+    throw std::invalid_argument("unknown hardware counter: " + s);
+  }
+
+  counter_group::counter_group(const std::vector<hardware_counter>& xs)
+  {
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    for (hardware_counter c : xs) {
+      int fd = open_counter(c);
+      if (fd < 0)
+        continue;
+      cs.push_back(c);
+      fds.push_back(fd);
+    }
+#endif
+  }
+
+  counter_group::~counter_group()
+  {
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    for (int fd : fds)
+      close(fd);
+#endif
+  }
+
+  void
+  counter_group::reset()
+  {
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    for (int fd : fds)
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+#endif
+  }
+
+  void
+  counter_group::enable()
+  {
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    for (int fd : fds)
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  void
+  counter_group::disable()
+  {
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    for (int fd : fds)
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+  }
+
+  // Each read gives the count, and the times for which the counter was
+  // enabled and running.
+  std::vector<double>
+  counter_group::read() const
+  {
+    std::vector<double> xs;
+#if defined(ORIGIN_BENCHMARK_HAS_PERF)
+    for (int fd : fds) {
+      std::uint64_t v[3];
+      if (::read(fd, v, sizeof(v)) != ssize_t(sizeof(v)) || v[2] == 0) {
+        xs.push_back(std::nan(""));
+        continue;
+      }
+      xs.push_back(double(v[0]) * (double(v[1]) / double(v[2])));
+    }
+#endif
+    return xs;
+  }
+
+
+  benchmark_options::benchmark_options()
+    : samples(20), min_sample_time(0.01), warmup_time(0.1),
+      max_iterations(std::size_t(1) << 30), format(output_format::text),
+      peak_gflops(0), peak_gbs(0)
+  { }
+
+  namespace
+  {
+    // Returns true if the argument arg has the form --name=value, and sets
+    // value.
+    bool
+    option(const std::string& arg, const char* name, std::string& value)
+    {
+      std::string prefix = std::string("--") + name + "=";
+      if (arg.compare(0, prefix.size(), prefix) != 0)
+        return false;
+      value = arg.substr(prefix.size());
+      return true;
+    }
+
+    double
+    to_number(const std::string& arg, const std::string& value)
+    {
+      char* end;
+      double x = std::strtod(value.c_str(), &end);
+      if (value.empty() || *end || !(x >= 0))
+        throw std::invalid_argument("invalid benchmark argument: " + arg);
+      return x;
+    }
+  } // namespace
+
+  void
+  parse_options(int argc, char** argv, benchmark_options& o)
+  {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      std::string v;
+      if (option(arg, "samples", v))
+        o.samples = std::size_t(to_number(arg, v));
+      else if (option(arg, "min-time", v))
+        o.min_sample_time = to_number(arg, v);
+      else if (option(arg, "warmup", v))
+        o.warmup_time = to_number(arg, v);
+      else if (option(arg, "filter", v))
+        o.filter = v;
+      else if (option(arg, "output", v))
+        o.output = v;
+      else if (option(arg, "peak-gflops", v))
+        o.peak_gflops = to_number(arg, v);
+      else if (option(arg, "peak-gbs", v))
+        o.peak_gbs = to_number(arg, v);
+      else if (option(arg, "counters", v)) {
+        o.counters.clear();
+        if (v == "all") {
+          o.counters = all_hardware_counters();
+          continue;
+        }
+        std::istringstream ss(v);
+        try {
+          for (std::string x; std::getline(ss, x, ',');)
+            o.counters.push_back(parse_counter(x));
+        } catch (std::invalid_argument&) {
+          throw std::invalid_argument("invalid benchmark argument: " + arg);
+        }
+      }
+      else if (option(arg, "sizes", v)) {
+        o.sizes.clear();
+        std::istringstream ss(v);
+        for (std::string x; std::getline(ss, x, ',');)
+          o.sizes.push_back(std::size_t(to_number(arg, x)));
+        if (o.sizes.empty())
+          throw std::invalid_argument("invalid benchmark argument: " + arg);
+      } else if (option(arg, "format", v)) {
+        if (v == "text")
+          o.format = output_format::text;
+        else if (v == "csv")
+          o.format = output_format::csv;
+        else if (v == "json")
+          o.format = output_format::json;
+        else
+          throw std::invalid_argument("invalid benchmark argument: " + arg);
+      } else {
+        throw std::invalid_argument("invalid benchmark argument: " + arg);
+      }
+    }
+    if (o.samples == 0)
+      throw std::invalid_argument("invalid benchmark argument: --samples");
+  }
+
+
+  namespace
+  {
+    using bench_clock = std::chrono::steady_clock;
+
+    // Returns the time, in seconds, taken by f(n).
+    double
+    time_batch(const batch_function& f, std::size_t n)
+    {
+      auto start = bench_clock::now();
+      f(n);
+      auto stop = bench_clock::now();
+      return std::chrono::duration<double>(stop - start).count();
+    }
+
+    // Returns the number of iterations of f that take at least t seconds,
+    // growing the batch geometrically. Each guess is extrapolated from the
+    // previous batch, but grows by at most a factor of 10, so that a batch
+    // made fast by a cold cache does not overshoot.
+    std::size_t
+    calibrate(const batch_function& f, double t, std::size_t max)
+    {
+      std::size_t n = 1;
+      while (n < max) {
+        double s = time_batch(f, n);
+        if (s >= t)
+          break;
+        double g = s > 0 ? 1.2 * t / s : 10;
+        n = std::min(max, std::size_t(n * std::min(std::max(g, 2.0), 10.0)));
+      }
+      return n;
+    }
+  } // namespace
+
+  benchmark_result
+  run_benchmark(const std::string& name,
+                const batch_function& f,
+                const benchmark_options& o,
+                const benchmark_work& w)
+  {
+    // Warm the caches and the branch predictors, and let the processor
+    // reach its operating frequency.
+    double warm = 0;
+    std::size_t n = 1;
+    do {
+      warm += time_batch(f, n);
+      n = std::min(2 * n, o.max_iterations);
+    } while (warm < o.warmup_time);
+
+    n = calibrate(f, o.min_sample_time, o.max_iterations);
+    std::vector<double> xs;
+    xs.reserve(o.samples);
+
+    // The counters are enabled outside of the timed batches, so that the
+    // system calls are not timed.
+    counter_group g(o.counters);
+    g.reset();
+    allocation_scope s;
+    for (std::size_t i = 0; i != o.samples; ++i) {
+      g.enable();
+      double t = time_batch(f, n);
+      g.disable();
+      xs.push_back(t * 1e9 / n);
+    }
+    allocation_counts c = s.counts();
+    double iterations = double(n) * o.samples;
+    benchmark_result r {
+      name, n, summarize(std::move(xs)), w,
+      {c.allocations / iterations, c.bytes_allocated / iterations}
+    };
+    std::vector<double> counts = g.read();
+    for (std::size_t i = 0; i != counts.size(); ++i)
+      if (!std::isnan(counts[i]))
+        r.counters.push_back({g.counters()[i], counts[i] / iterations});
+    return r;
+  }
+
+  const double*
+  find_counter(const benchmark_result& r, hardware_counter c)
+  {
+    for (const benchmark_counter& x : r.counters)
+      if (x.counter == c)
+        return &x.per_iteration;
+    return nullptr;
+  }
+
+  std::vector<benchmark_result>
+  benchmark_suite::run(const benchmark_options& o) const
+  {
+    std::vector<benchmark_result> rs;
+    for (const entry& b : benchmarks)
+      if (b.name.find(o.filter) != std::string::npos)
+        rs.push_back(run_benchmark(b.name, b.run, o, b.work));
+    return rs;
+  }
+
+
+  namespace
+  {
+    // Returns the greatest of n rates measured by f, which returns the
+    // amount of work done and sets the time taken, in seconds.
+    template <typename F>
+      double
+      best_rate(std::size_t n, F f)
+      {
+        double best = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+          double t;
+          double x = f(t);
+          best = std::max(best, x / t);
+        }
+        return best;
+      }
+  } // namespace
+
+  namespace
+  {
+    // Apply n multiply-adds to each of the chains acc. The chains are
+    // copied to local variables, so that they are held in registers.
+    void
+    multiply_add(double (&acc)[16], std::size_t n, double a, double b)
+    {
+      double x[16];
+      std::copy(acc, acc + 16, x);
+      for (std::size_t i = 0; i != n; ++i) {
+        x[0] = x[0] * a + b;   x[1] = x[1] * a + b;
+        x[2] = x[2] * a + b;   x[3] = x[3] * a + b;
+        x[4] = x[4] * a + b;   x[5] = x[5] * a + b;
+        x[6] = x[6] * a + b;   x[7] = x[7] * a + b;
+        x[8] = x[8] * a + b;   x[9] = x[9] * a + b;
+        x[10] = x[10] * a + b; x[11] = x[11] * a + b;
+        x[12] = x[12] * a + b; x[13] = x[13] * a + b;
+        x[14] = x[14] * a + b; x[15] = x[15] * a + b;
+      }
+      std::copy(x, x + 16, acc);
+    }
+  } // namespace
+
+  double
+  measure_peak_gflops()
+  {
+    // Sixteen independent chains of multiply-adds hide the latency of each
+    // operation, and can be vectorized.
+    const std::size_t n = std::size_t(1) << 22;
+    return best_rate(5, [=](double& t) {
+      double acc[16];
+      for (std::size_t j = 0; j != 16; ++j)
+        acc[j] = 1 + j * 1e-3;
+      auto start = bench_clock::now();
+      multiply_add(acc, n, 0.999999, 1e-6);
+      auto stop = bench_clock::now();
+      do_not_optimize(acc);
+      t = std::chrono::duration<double>(stop - start).count();
+      return 2.0 * 16 * n / 1e9;
+    });
+  }
+
+  double
+  measure_peak_gbs()
+  {
+    // Three arrays of 32 MB each.
+    const std::size_t n = std::size_t(1) << 22;
+    std::vector<double> a(n), b(n, 1), c(n, 2);
+    return best_rate(5, [&](double& t) {
+      const double s = 3;
+      auto start = bench_clock::now();
+      for (std::size_t i = 0; i != n; ++i)
+        a[i] = b[i] + s * c[i];
+      clobber_memory();
+      auto stop = bench_clock::now();
+      do_not_optimize(a[n / 2]);
+      t = std::chrono::duration<double>(stop - start).count();
+      return 3.0 * sizeof(double) * n / 1e9;
+    });
+  }
+
+  machine_peak
+  find_peak(const benchmark_options& o)
+  {
+    machine_peak p = {o.peak_gflops, o.peak_gbs};
+    if (p.gflops == 0)
+      p.gflops = measure_peak_gflops();
+    if (p.gbs == 0)
+      p.gbs = measure_peak_gbs();
+    return p;
+  }
+
+  namespace
+  {
+    void
+    write_results(std::ostream& os, output_format f,
+                  const std::vector<benchmark_result>& rs,
+                  const machine_peak& p)
+    {
+      switch (f) {
+      case output_format::text:
+        write_text(os, rs, p);
+        break;
+      case output_format::csv:
+        write_csv(os, rs);
+        break;
+      case output_format::json:
+        write_json(os, rs, p);
+        break;
+      }
+    }
+
+    // Returns true if any of the results rs describes its work.
+    bool
+    has_work(const std::vector<benchmark_result>& rs)
+    {
+      return std::any_of(rs.begin(), rs.end(), [](const benchmark_result& r) {
+        return r.work.flops > 0 || r.work.bytes > 0;
+      });
+    }
+
+    // Returns true if any of the results rs made allocations.
+    bool
+    has_allocations(const std::vector<benchmark_result>& rs)
+    {
+      return std::any_of(rs.begin(), rs.end(), [](const benchmark_result& r) {
+        return r.allocations.count > 0;
+      });
+    }
+
+    // Returns the counters counted by any of the results rs, in order.
+    std::vector<hardware_counter>
+    counted(const std::vector<benchmark_result>& rs)
+    {
+      std::vector<hardware_counter> cs;
+      for (hardware_counter c : all_hardware_counters())
+        if (std::any_of(rs.begin(), rs.end(), [c](const benchmark_result& r) {
+              return find_counter(r, c) != nullptr;
+            }))
+          cs.push_back(c);
+      return cs;
+    }
+  } // namespace
+
+  namespace
+  {
+    // Write the results rs as specified by the options o. Returns the exit
+    // status of the program.
+    int
+    report_results(const benchmark_options& o,
+                   const std::vector<benchmark_result>& rs)
+    {
+      machine_peak p = {};
+      if (o.format != output_format::csv && has_work(rs))
+        p = find_peak(o);
+      if (o.output.empty()) {
+        write_results(std::cout, o.format, rs, p);
+        return 0;
+      }
+      std::ofstream os(o.output);
+      write_results(os, o.format, rs, p);
+      if (!os) {
+        std::cerr << "cannot write " << o.output << '\n';
+        return 1;
+      }
+      return 0;
+    }
+  } // namespace
+
+  int
+  benchmark_main(int argc, char** argv, const benchmark_suite& s)
+  {
+    benchmark_options o;
+    try {
+      parse_options(argc, argv, o);
+    } catch (std::invalid_argument& e) {
+      std::cerr << e.what() << '\n';
+      return 2;
+    }
+    return report_results(o, s.run(o));
+  }
+
+  int
+  benchmark_main(int argc, char** argv,
+                 const std::vector<std::size_t>& sizes,
+                 const suite_builder& f)
+  {
+    benchmark_options o;
+    o.sizes = sizes;
+    try {
+      parse_options(argc, argv, o);
+    } catch (std::invalid_argument& e) {
+      std::cerr << e.what() << '\n';
+      return 2;
+    }
+    std::vector<benchmark_result> rs;
+    for (std::size_t n : o.sizes) {
+      benchmark_suite s;
+      f(s, n);
+      std::vector<benchmark_result> xs = s.run(o);
+      rs.insert(rs.end(), xs.begin(), xs.end());
+    }
+    return report_results(o, rs);
+  }
+
+
+  void
+  write_text(std::ostream& os, const std::vector<benchmark_result>& rs,
+             const machine_peak& p)
+  {
+    bool rates = has_work(rs);
+    bool peaks = rates && p.gflops > 0 && p.gbs > 0;
+    bool allocs = has_allocations(rs);
+    std::vector<hardware_counter> cs = counted(rs);
+    bool ipc = std::count(cs.begin(), cs.end(), hardware_counter::cycles)
+            && std::count(cs.begin(), cs.end(), hardware_counter::instructions);
+
+    std::size_t w = 9;
+    for (const benchmark_result& r : rs)
+      w = std::max(w, r.name.size());
+    os << std::left << std::setw(w) << "benchmark" << std::right
+       << std::setw(14) << "median ns" << std::setw(12) << "mad ns"
+       << std::setw(26) << "95% ci ns" << std::setw(12) << "iterations";
+    if (rates)
+      os << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s";
+    if (peaks)
+      os << std::setw(8) << "%flops" << std::setw(8) << "%bw";
+    if (allocs)
+      os << std::setw(10) << "allocs" << std::setw(12) << "alloc B";
+    for (hardware_counter c : cs)
+      os << std::setw(15) << counter_name(c);
+    if (ipc)
+      os << std::setw(7) << "IPC";
+    os << '\n';
+    for (const benchmark_result& r : rs) {
+      std::ostringstream ci;
+      ci << std::fixed << std::setprecision(2)
+         << '[' << r.time.ci_lower << ", " << r.time.ci_upper << ']';
+      os << std::left << std::setw(w) << r.name << std::right
+         << std::fixed << std::setprecision(2)
+         << std::setw(14) << r.time.median << std::setw(12) << r.time.mad
+         << ' ' << std::setw(25) << ci.str() << std::setw(12) << r.iterations;
+      if (rates)
+        os << std::setw(10) << flop_rate(r) << std::setw(10) << byte_rate(r);
+      if (peaks)
+        os << std::setprecision(1)
+           << std::setw(8) << 100 * flop_rate(r) / p.gflops
+           << std::setw(8) << 100 * byte_rate(r) / p.gbs;
+      if (allocs)
+        os << std::setprecision(2) << std::setw(10) << r.allocations.count
+           << std::setw(12) << r.allocations.bytes;
+      os << std::setprecision(2);
+      for (hardware_counter c : cs) {
+        if (const double* x = find_counter(r, c))
+          os << std::setw(15) << *x;
+        else
+          os << std::setw(15) << "-";
+      }
+      if (ipc) {
+        const double* cycles = find_counter(r, hardware_counter::cycles);
+        const double* insts = find_counter(r, hardware_counter::instructions);
+        if (cycles && insts && *cycles > 0)
+          os << std::setw(7) << *insts / *cycles;
+        else
+          os << std::setw(7) << "-";
+      }
+      os << '\n';
+    }
+    if (peaks)
+      os << std::setprecision(2) << "peak: " << p.gflops << " GFLOP/s, "
+         << p.gbs << " GB/s\n";
+  }
+
+  namespace
+  {
+    const char* csv_header =
+      "name,iterations,samples,median_ns,mad_ns,ci_lower_ns,ci_upper_ns,"
+      "mean_ns,min_ns,max_ns,flops,bytes";
+
+    // Returns the columns of s, each preceded by a comma, keeping empty
+    // ones. Returns no columns if s is empty.
+    std::vector<std::string>
+    split_columns(const std::string& s)
+    {
+      std::vector<std::string> xs;
+      if (s.empty())
+        return xs;
+      if (s[0] != ',')
+        throw std::invalid_argument("read_csv: invalid columns: " + s);
+      std::size_t i = 1;
+      while (true) {
+        std::size_t j = s.find(',', i);
+        xs.push_back(s.substr(i, j - i));
+        if (j == std::string::npos)
+          break;
+        i = j + 1;
+      }
+      return xs;
+    }
+  } // namespace
+
+  // The counts of hardware counters follow the fixed columns, named by
+  // their counters. The count of a counter that a result did not count is
+  // empty.
+  void
+  write_csv(std::ostream& os, const std::vector<benchmark_result>& rs)
+  {
+    std::vector<hardware_counter> cs = counted(rs);
+    os << csv_header;
+    for (hardware_counter c : cs)
+      os << ',' << counter_name(c);
+    os << '\n' << std::setprecision(17);
+    for (const benchmark_result& r : rs) {
+      const sample_statistics& s = r.time;
+      os << r.name << ',' << r.iterations << ',' << s.count << ','
+         << s.median << ',' << s.mad << ',' << s.ci_lower << ','
+         << s.ci_upper << ',' << s.mean << ',' << s.min << ',' << s.max
+         << ',' << r.work.flops << ',' << r.work.bytes;
+      for (hardware_counter c : cs) {
+        os << ',';
+        if (const double* x = find_counter(r, c))
+          os << *x;
+      }
+      os << '\n';
+    }
+  }
+
+  namespace
+  {
+    // Write the string s as a JSON string.
+    void
+    write_string(std::ostream& os, const std::string& s)
+    {
+      os << '"';
+      for (char c : s) {
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << int(c) << std::dec << std::setfill(' ');
+        else
+          os << c;
+      }
+      os << '"';
+    }
+  } // namespace
+
+  void
+  write_json(std::ostream& os, const std::vector<benchmark_result>& rs,
+             const machine_peak& p)
+  {
+    os << "{\n  \"context\": {\n    \"compiler\": ";
+#if defined(__VERSION__)
+    write_string(os, __VERSION__);
+#else
+    write_string(os, "unknown");
+#endif
+    os << ",\n    \"hardware_threads\": " << std::thread::hardware_concurrency()
+       << std::setprecision(17);
+    if (p.gflops > 0 && p.gbs > 0)
+      os << ",\n    \"peak_gflops\": " << p.gflops
+         << ",\n    \"peak_gbs\": " << p.gbs;
+    os << "\n  },\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i != rs.size(); ++i) {
+      const sample_statistics& s = rs[i].time;
+      os << (i ? ",\n" : "\n") << "    {\"name\": ";
+      write_string(os, rs[i].name);
+      os << ", \"iterations\": " << rs[i].iterations
+         << ", \"samples\": " << s.count
+         << ", \"median_ns\": " << s.median
+         << ", \"mad_ns\": " << s.mad
+         << ", \"ci_lower_ns\": " << s.ci_lower
+         << ", \"ci_upper_ns\": " << s.ci_upper
+         << ", \"mean_ns\": " << s.mean
+         << ", \"min_ns\": " << s.min
+         << ", \"max_ns\": " << s.max;
+      if (rs[i].work.flops > 0 || rs[i].work.bytes > 0)
+        os << ", \"flops\": " << rs[i].work.flops
+           << ", \"bytes\": " << rs[i].work.bytes
+           << ", \"gflops\": " << flop_rate(rs[i])
+           << ", \"gbs\": " << byte_rate(rs[i]);
+      if (rs[i].allocations.count > 0)
+        os << ", \"allocations\": " << rs[i].allocations.count
+           << ", \"allocated_bytes\": " << rs[i].allocations.bytes;
+      if (!rs[i].counters.empty()) {
+        os << ", \"counters\": {";
+        for (std::size_t j = 0; j != rs[i].counters.size(); ++j) {
+          const benchmark_counter& c = rs[i].counters[j];
+          os << (j ? ", \"" : "\"") << counter_name(c.counter) << "\": "
+             << c.per_iteration;
+        }
+        os << "}";
+      }
+      os << "}";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  std::vector<benchmark_result>
+  read_csv(std::istream& is)
+  {
+    std::string line;
+    std::size_t n = std::strlen(csv_header);
+    if (!std::getline(is, line) || line.compare(0, n, csv_header) != 0)
+      throw std::invalid_argument("read_csv: invalid header");
+    std::vector<hardware_counter> cs;
+    try {
+      for (const std::string& x : split_columns(line.substr(n)))
+        cs.push_back(parse_counter(x));
+    } catch (std::invalid_argument&) {
+      throw std::invalid_argument("read_csv: invalid header");
+    }
+    std::vector<benchmark_result> rs;
+    while (std::getline(is, line)) {
+      if (line.empty())
+        continue;
+      std::istringstream ss(line);
+      benchmark_result r {};
+      sample_statistics& s = r.time;
+      char c[10];
+      std::getline(ss, r.name, ',');
+      ss >> r.iterations >> c[0] >> s.count >> c[1] >> s.median >> c[2]
+         >> s.mad >> c[3] >> s.ci_lower >> c[4] >> s.ci_upper >> c[5]
+         >> s.mean >> c[6] >> s.min >> c[7] >> s.max >> c[8]
+         >> r.work.flops >> c[9] >> r.work.bytes;
+      if (!ss || std::count(c, c + 10, ',') != 10)
+        throw std::invalid_argument("read_csv: invalid line: " + line);
+      std::string rest;
+      std::getline(ss, rest);
+      std::vector<std::string> xs = split_columns(rest);
+      if (xs.size() != cs.size())
+        throw std::invalid_argument("read_csv: invalid line: " + line);
+      for (std::size_t i = 0; i != xs.size(); ++i)
+        if (!xs[i].empty())
+          r.counters.push_back({cs[i], std::strtod(xs[i].c_str(), nullptr)});
+      rs.push_back(r);
+    }
+    return rs;
+  }
+
+  double
+  write_comparison(std::ostream& os,
+                   const std::vector<std::string>& names,
+                   const std::vector<std::vector<benchmark_result>>& rs)
+  {
+    double worst = 0;
+    if (rs.empty())
+      return worst;
+    std::size_t w = 9;
+    for (const benchmark_result& r : rs[0])
+      w = std::max(w, r.name.size());
+    os << std::left << std::setw(w) << "benchmark" << std::right;
+    for (std::size_t i = 0; i != rs.size(); ++i) {
+      std::string name = i < names.size() ? names[i] : "";
+      os << std::setw(std::max<std::size_t>(14, name.size() + 2)) << name;
+      if (i)
+        os << std::setw(8) << "ratio";
+    }
+    os << '\n';
+    for (const benchmark_result& r : rs[0]) {
+      os << std::left << std::setw(w) << r.name << std::right
+         << std::fixed << std::setprecision(2);
+      for (std::size_t i = 0; i != rs.size(); ++i) {
+        std::string name = i < names.size() ? names[i] : "";
+        std::size_t cw = std::max<std::size_t>(14, name.size() + 2);
+        auto p = std::find_if(rs[i].begin(), rs[i].end(),
+                              [&r](const benchmark_result& x) {
+                                return x.name == r.name;
+                              });
+        if (p == rs[i].end()) {
+          os << std::setw(cw) << "-";
+          if (i)
+            os << std::setw(8) << "-";
+          continue;
+        }
+        os << std::setw(cw) << p->time.median;
+        if (i) {
+          double q = p->time.median / r.time.median;
+          worst = std::max(worst, q);
+          os << std::setw(8) << q;
+        }
+      }
+      os << '\n';
+    }
+    return worst;
+  }
+
+} // namespace origin
@@ -0,0 +1,419 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_BENCHMARK_BENCHMARK_HPP
+#define ORIGIN_BENCHMARK_BENCHMARK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Optimization barriers                                       bench.barrier
+  //
+  // The code being measured by a benchmark often computes values that are
+  // never used, and the compiler is free to remove it. The do_not_optimize
+  // function forces the value x to be computed and stored, and
+  // clobber_memory forces all pending writes to memory to be performed, as
+  // if the memory were read by code the compiler cannot see. For example:
+  //
+  //    suite.add("push_back", [&v]() {
+  //      v.push_back(42);
+  //      clobber_memory();
+  //    });
+  //
+  // Neither function generates any instructions of its own.
+  namespace benchmark_impl
+  {
+    // Escape the object pointed to by p, for compilers without inline
+    // assembly.
+    void escape(const volatile void* p);
+  } // namespace benchmark_impl
+
+  template <typename T>
+    inline void
+    do_not_optimize(const T& x)
+    {
+#if defined(__GNUC__)
+      asm volatile("" : : "r,m"(x) : "memory");
+#else
+      benchmark_impl::escape(&x);
+#endif
+    }
+
+  inline void
+  clobber_memory()
+  {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Sample statistics                                             bench.stats
+  //
+  // The times measured by a benchmark are summarized by robust statistics:
+  // the median, and the median absolute deviation (MAD) from the median.
+  // Unlike the mean and standard deviation, these are not disturbed by the
+  // occasional sample delayed by an interrupt or a context switch. The
+  // confidence interval of the median is distribution free: its bounds are
+  // the order statistics that contain the median with a probability of at
+  // least 95%, so there must be at least 9 samples for the interval to be
+  // narrower than the range of the samples.
+  struct sample_statistics
+  {
+    std::size_t count;
+    double min;
+    double max;
+    double mean;
+    double median;
+    double mad;
+    double ci_lower;
+    double ci_upper;
+  };
+
+  // Returns the statistics of the samples xs, which must not be empty.
+  sample_statistics summarize(std::vector<double> xs);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Hardware counters                                          bench.counters
+  //
+  // Besides its time, a benchmark can count hardware events, so that a
+  // change can be shown to reduce cache or TLB misses rather than to be
+  // faster by chance. The counters are read with the Linux perf_event
+  // interface:
+  //
+  //    cycles           CPU cycles
+  //    instructions     Instructions retired
+  //    l1d-misses       L1 data cache read misses
+  //    llc-misses       Last level cache misses
+  //    branch-misses    Mispredicted branches
+  //    dtlb-misses      Data TLB read misses
+  //    page-faults      Page faults (counted by the kernel)
+  //
+  // Events are counted in user mode, on the thread that runs the benchmark;
+  // the work of tasks run by other threads is not counted. If more counters
+  // are requested than the processor has, the kernel multiplexes them, and
+  // each count is scaled by the fraction of the time that it was counting.
+  // A counter that cannot be opened is omitted from the results: hardware
+  // events are not available in most virtual machines, and may be forbidden
+  // by /proc/sys/kernel/perf_event_paranoid.
+  enum class hardware_counter
+  {
+    cycles,
+    instructions,
+    l1d_misses,
+    llc_misses,
+    branch_misses,
+    dtlb_misses,
+    page_faults
+  };
+
+  // Returns every hardware counter, in order.
+  std::vector<hardware_counter> all_hardware_counters();
+
+  // Returns the name of the counter c, as given above.
+  const char* counter_name(hardware_counter c);
+
+  // Returns the counter named s. Throws std::invalid_argument if there is
+  // none.
+  hardware_counter parse_counter(const std::string& s);
+
+  // A counter group counts the events of a set of counters on the calling
+  // thread while it is enabled.
+  class counter_group
+  {
+  public:
+    // Open the counters cs. Counters that cannot be opened are left out.
+    explicit counter_group(const std::vector<hardware_counter>& cs);
+    ~counter_group();
+
+    counter_group(const counter_group&) = delete;
+    counter_group& operator=(const counter_group&) = delete;
+
+    // Returns the counters that were opened.
+    const std::vector<hardware_counter>& counters() const { return cs; }
+
+    bool empty() const { return cs.empty(); }
+
+    // Set the counts to 0, and start or stop counting. The counts of
+    // successive periods of counting are added.
+    void reset();
+    void enable();
+    void disable();
+
+    // Returns the counts of the counters, scaled for multiplexing. The
+    // count of a counter that was never scheduled is NaN.
+    std::vector<double> read() const;
+
+  private:
+    std::vector<hardware_counter> cs;
+    std::vector<int> fds;
+  };
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Benchmark options                                           bench.options
+  //
+  // Each sample of a benchmark runs its function as many times as needed to
+  // take at least min_sample_time seconds, so that the resolution of the
+  // clock does not affect the results. The number of iterations per sample
+  // is calibrated once, after a warmup of warmup_time seconds, and is the
+  // same for each sample.
+  //
+  // The options are initialized from the command line of a benchmark
+  // program by parse_options. The arguments are:
+  //
+  //    --samples=n          The number of samples (20)
+  //    --min-time=s         The minimum time of each sample (0.01)
+  //    --warmup=s           The warmup time of each benchmark (0.1)
+  //    --filter=text        Run only benchmarks whose names contain text
+  //    --format=f           The output format: text, csv or json (text)
+  //    --output=path        Write the results to path instead of stdout
+  //    --sizes=n,...        The problem sizes of a sized suite (e.g., 1e5,1e6)
+  //    --peak-gflops=r      The peak floating point rate of the machine
+  //    --peak-gbs=r         The peak memory bandwidth of the machine
+  //    --counters=c,...     The hardware counters to read, or all (none)
+  enum class output_format { text, csv, json };
+
+  struct benchmark_options
+  {
+    benchmark_options();
+
+    std::size_t   samples;
+    double        min_sample_time;
+    double        warmup_time;
+    std::size_t   max_iterations;
+    std::string   filter;
+    output_format format;
+    std::string   output;
+
+    std::vector<std::size_t> sizes;
+
+    double peak_gflops;
+    double peak_gbs;
+
+    std::vector<hardware_counter> counters;
+  };
+
+  // Update the options o from the command line arguments. Throws
+  // std::invalid_argument if an argument is not recognized.
+  void parse_options(int argc, char** argv, benchmark_options& o);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Benchmarks                                                 bench.benchmark
+  //
+  // A benchmark is a named function. A simple benchmark is a nullary
+  // function that runs one iteration of the code being measured. A batch
+  // benchmark is a function f(n) that runs n iterations, so that the cost
+  // of preparing its state is shared by all n iterations. The results of a
+  // benchmark are the number of iterations per sample and the statistics of
+  // the time per iteration, in nanoseconds.
+  //
+  // A benchmark may also describe the work done by each iteration: the
+  // number of floating point operations, and the number of bytes moved to or
+  // from memory. The results of such a benchmark are also reported as rates,
+  // in GFLOP/s and GB/s, and as a fraction of the peak rates of the machine
+  // (see [bench.peak]).
+  //
+  // The allocations made by a benchmark are counted by the default
+  // allocation counter (see [mem.tracking]), so that when the global new
+  // hook is installed in the benchmark program, the results also give the
+  // number of allocations and of bytes allocated per iteration.
+  //
+  // When the options request hardware counters (see [bench.counters]), the
+  // results also give the events counted per iteration over all samples.
+  //
+  // A benchmark suite is a sequence of benchmarks, run in the order in which
+  // they were added.
+  struct benchmark_work
+  {
+    double flops;
+    double bytes;
+  };
+
+  struct benchmark_allocations
+  {
+    double count;
+    double bytes;
+  };
+
+  struct benchmark_counter
+  {
+    hardware_counter counter;
+    double           per_iteration;
+  };
+
+  struct benchmark_result
+  {
+    std::string           name;
+    std::size_t           iterations;
+    sample_statistics     time;
+    benchmark_work        work;
+    benchmark_allocations allocations;
+
+    std::vector<benchmark_counter> counters;
+  };
+
+  // Returns the count of c per iteration of r, or nullptr if r did not
+  // count c.
+  const double* find_counter(const benchmark_result& r, hardware_counter c);
+
+  // Returns the floating point rate, in GFLOP/s, and the bandwidth, in GB/s,
+  // of the median iteration of r. The rates are 0 if r does no such work.
+  inline double
+  flop_rate(const benchmark_result& r) { return r.work.flops / r.time.median; }
+
+  inline double
+  byte_rate(const benchmark_result& r) { return r.work.bytes / r.time.median; }
+
+  using batch_function = std::function<void(std::size_t)>;
+
+  // Run the batch function f, named name, with the options o. Each
+  // iteration does the work w.
+  benchmark_result run_benchmark(const std::string& name,
+                                 const batch_function& f,
+                                 const benchmark_options& o,
+                                 const benchmark_work& w = {});
+
+  class benchmark_suite
+  {
+  public:
+    // Add a benchmark that runs f() once per iteration, doing the work w.
+    template <typename F>
+      void add(const std::string& name, F f, const benchmark_work& w = {})
+      {
+        add_batch(name, [f](std::size_t n) mutable {
+          for (std::size_t i = 0; i != n; ++i)
+            f();
+        }, w);
+      }
+
+    // Add a benchmark that runs f(n) to run n iterations, each doing the
+    // work w.
+    template <typename F>
+      void add_batch(const std::string& name, F f, const benchmark_work& w = {})
+      {
+        benchmarks.push_back({name, batch_function(std::move(f)), w});
+      }
+
+    std::size_t size() const { return benchmarks.size(); }
+
+    // Run the benchmarks selected by the options o.
+    std::vector<benchmark_result> run(const benchmark_options& o) const;
+
+  private:
+    struct entry
+    {
+      std::string    name;
+      batch_function run;
+      benchmark_work work;
+    };
+
+    std::vector<entry> benchmarks;
+  };
+
+  // Run the suite s with the options given by the command line, and write
+  // the results. If any benchmark describes its work, the peak rates of the
+  // machine not given by the options are measured, so that the rates can be
+  // reported as fractions of the peak. Returns the exit status of the
+  // program.
+  int benchmark_main(int argc, char** argv, const benchmark_suite& s);
+
+  // A suite builder adds the benchmarks for the problem size n to a suite.
+  using suite_builder = std::function<void(benchmark_suite&, std::size_t)>;
+
+  // Run the suites built by f for each problem size given by the command
+  // line, or for each of the default sizes if none are given, and write the
+  // results. Each suite is built, run and destroyed before the next one is
+  // built, so that the state of only one problem size is held in memory.
+  int benchmark_main(int argc, char** argv,
+                     const std::vector<std::size_t>& sizes,
+                     const suite_builder& f);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Peak rates                                                     bench.peak
+  //
+  // The peak rates of a machine are the floating point rate and the memory
+  // bandwidth that one thread can attain. They are best taken from the
+  // specification of the processor and memory, and given as options. When
+  // they are not given, they are measured: the floating point rate by a loop
+  // of independent multiply-adds on registers, and the bandwidth by a
+  // triad (a[i] = b[i] + s * c[i]) over arrays much larger than the caches.
+  // The measured rates are what the compiler and machine attain for simple
+  // code, so they are lower bounds of the theoretical peaks.
+  struct machine_peak
+  {
+    double gflops;
+    double gbs;
+  };
+
+  // Measure the peak rates of the machine.
+  double measure_peak_gflops();
+  double measure_peak_gbs();
+
+  // Returns the peak rates given by the options o, measuring those that are
+  // not given.
+  machine_peak find_peak(const benchmark_options& o);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Reporting                                                    bench.report
+  //
+  // The results of a suite are written as a text table, as comma separated
+  // values with a header line, or as a JSON document that also describes the
+  // compiler and machine used. Times are given in nanoseconds. Results
+  // written as CSV can be read back, so that the results of several
+  // programs can be compared. If the results describe their work, the text
+  // and JSON reports include their rates and, when the peak rates p are
+  // known (nonzero), their fractions of the peak. The allocations per
+  // iteration are reported by the text and JSON reports of results that
+  // made allocations. The hardware counts per iteration are reported by all
+  // three formats, with the instructions per cycle in the text report when
+  // both were counted.
+  //
+  // A comparison of the results of several programs, rs, lists the median
+  // time of each benchmark of the first program and its ratio to the
+  // medians of the same benchmark in the other programs.
+  void write_text(std::ostream& os, const std::vector<benchmark_result>& rs,
+                  const machine_peak& p = {});
+  void write_csv(std::ostream& os, const std::vector<benchmark_result>& rs);
+  void write_json(std::ostream& os, const std::vector<benchmark_result>& rs,
+                  const machine_peak& p = {});
+
+  // Read results written by write_csv. Throws std::invalid_argument if the
+  // input is malformed.
+  std::vector<benchmark_result> read_csv(std::istream& is);
+
+  // Write a comparison of the results rs of the programs named names. Returns
+  // the greatest ratio of the median of a benchmark to the median of the
+  // same benchmark in the first program.
+  double write_comparison(std::ostream& os,
+                          const std::vector<std::string>& names,
+                          const std::vector<std::vector<benchmark_result>>& rs);
+
+} // namespace origin
+
+#endif
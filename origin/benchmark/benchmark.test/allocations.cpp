@@ -0,0 +1,48 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define ORIGIN_TRACK_GLOBAL_NEW
+#include <origin/memory/tracking.hpp>
+#include <origin/benchmark/benchmark.hpp>
+
+using namespace std;
+using namespace origin;
+
+// With the global new hook installed, the results give the allocations per
+// iteration.
+int main()
+{
+  benchmark_options o;
+  o.samples = 5;
+  o.min_sample_time = 0.001;
+  o.warmup_time = 0;
+
+  benchmark_suite s;
+  s.add("none", []() { clobber_memory(); });
+  s.add("vector", []() {
+    vector<int> v(4);
+    do_not_optimize(v);
+  });
+  vector<benchmark_result> rs = s.run(o);
+  assert(rs[0].allocations.count == 0);
+  assert(rs[1].allocations.count == 1);
+  assert(rs[1].allocations.bytes == 4 * sizeof(int));
+
+  ostringstream ts;
+  write_text(ts, rs);
+  assert(ts.str().find("allocs") != string::npos);
+
+  ostringstream js;
+  write_json(js, rs);
+  assert(js.str().find("\"allocations\": 1,") != string::npos);
+  assert(js.str().find("\"allocations\"") == js.str().rfind("\"allocations\""));
+}
@@ -0,0 +1,269 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/benchmark/benchmark.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+check_statistics()
+{
+  sample_statistics s = summarize({5, 1, 4, 2, 3});
+  assert(s.count == 5);
+  assert(s.min == 1 && s.max == 5);
+  assert(s.mean == 3 && s.median == 3 && s.mad == 1);
+
+  // An outlier disturbs the mean, but not the median or the MAD.
+  s = summarize({10, 11, 10, 12, 11, 10, 1000, 11, 12, 10});
+  assert(s.median == 11 && s.mad == 1);
+  assert(s.mean > 100);
+  assert(s.ci_lower <= s.median && s.median <= s.ci_upper);
+  assert(s.ci_upper < 1000);
+
+  try {
+    summarize({});
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+void
+check_options()
+{
+  const char* argv[] = {"bench", "--samples=7", "--min-time=0.001",
+                        "--format=csv", "--filter=pool"};
+  benchmark_options o;
+  parse_options(5, const_cast<char**>(argv), o);
+  assert(o.samples == 7 && o.min_sample_time == 0.001);
+  assert(o.format == output_format::csv && o.filter == "pool");
+  assert(o.warmup_time == 0.1 && o.output.empty());
+  assert(o.sizes.empty());
+
+  const char* sized[] = {"bench", "--sizes=1e5,300"};
+  parse_options(2, const_cast<char**>(sized), o);
+  assert(o.sizes.size() == 2 && o.sizes[0] == 100000 && o.sizes[1] == 300);
+
+  const char* peak[] = {"bench", "--peak-gflops=32", "--peak-gbs=20.5"};
+  parse_options(3, const_cast<char**>(peak), o);
+  assert(o.peak_gflops == 32 && o.peak_gbs == 20.5);
+  machine_peak p = find_peak(o);
+  assert(p.gflops == 32 && p.gbs == 20.5);
+
+  const char* bad[] = {"bench", "--samples=x"};
+  try {
+    parse_options(2, const_cast<char**>(bad), o);
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+// Benchmarks are calibrated so that each sample runs for at least the
+// minimum sample time.
+void
+check_run()
+{
+  benchmark_options o;
+  o.samples = 6;
+  o.min_sample_time = 0.001;
+  o.warmup_time = 0;
+
+  benchmark_suite s;
+  long count = 0;
+  s.add("count", [&count]() { do_not_optimize(++count); });
+  s.add_batch("vector.push_back", [](size_t n) {
+    vector<int> v;
+    for (size_t i = 0; i != n; ++i) {
+      v.push_back(int(i));
+      clobber_memory();
+    }
+    do_not_optimize(v);
+  });
+  assert(s.size() == 2);
+
+  vector<benchmark_result> rs = s.run(o);
+  assert(rs.size() == 2);
+  assert(rs[0].name == "count" && rs[0].iterations > 1);
+  assert(rs[0].time.count == 6 && rs[0].time.median > 0);
+  assert(count >= long(6 * rs[0].iterations));
+  assert(rs[0].work.flops == 0 && flop_rate(rs[0]) == 0);
+
+  // Without the global new hook, no allocations are counted.
+  assert(rs[1].allocations.count == 0);
+
+  o.filter = "vector";
+  assert(s.run(o).size() == 1);
+
+  // Results written as CSV are read back.
+  stringstream ss;
+  write_csv(ss, rs);
+  vector<benchmark_result> xs = read_csv(ss);
+  assert(xs.size() == 2 && xs[1].name == "vector.push_back");
+  assert(xs[1].iterations == rs[1].iterations);
+  assert(xs[1].time.median == rs[1].time.median);
+
+  // Comparing results with themselves gives ratios of 1.
+  ostringstream os;
+  assert(write_comparison(os, {"a", "b"}, {xs, xs}) == 1);
+  assert(os.str().find("vector.push_back") != string::npos);
+
+  ostringstream js;
+  write_json(js, rs);
+  assert(js.str().find("\"name\": \"count\"") != string::npos);
+  assert(js.str().find("\"median_ns\": ") != string::npos);
+
+  ostringstream ts;
+  write_text(ts, rs);
+  assert(ts.str().find("median ns") != string::npos);
+  assert(ts.str().find("GFLOP/s") == string::npos);
+
+  istringstream bad("name,median\n");
+  try {
+    read_csv(bad);
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+// Benchmarks that describe their work are reported as rates.
+void
+check_rates()
+{
+  benchmark_options o;
+  o.samples = 3;
+  o.min_sample_time = 0.001;
+  o.warmup_time = 0;
+
+  vector<double> a(1000, 1), b(1000, 2);
+  benchmark_suite s;
+  s.add("axpy", [&a, &b]() {
+    for (size_t i = 0; i != a.size(); ++i)
+      a[i] += 2 * b[i];
+    clobber_memory();
+  }, {2000, 24000});
+
+  vector<benchmark_result> rs = s.run(o);
+  assert(rs[0].work.flops == 2000 && rs[0].work.bytes == 24000);
+  assert(flop_rate(rs[0]) > 0);
+  double r = byte_rate(rs[0]) / flop_rate(rs[0]);
+  assert(r > 11.999 && r < 12.001);
+
+  stringstream ss;
+  write_csv(ss, rs);
+  vector<benchmark_result> xs = read_csv(ss);
+  assert(xs[0].work.flops == 2000 && xs[0].work.bytes == 24000);
+
+  ostringstream ts;
+  write_text(ts, rs, {10, 10});
+  assert(ts.str().find("GFLOP/s") != string::npos);
+  assert(ts.str().find("%flops") != string::npos);
+
+  ostringstream js;
+  write_json(js, rs, {10, 10});
+  assert(js.str().find("\"peak_gflops\": 10") != string::npos);
+  assert(js.str().find("\"gbs\": ") != string::npos);
+
+  // The measured peaks are positive.
+  assert(measure_peak_gflops() > 0 && measure_peak_gbs() > 0);
+}
+
+// A sized suite is built and run once for each problem size.
+void
+check_sizes()
+{
+  const char* argv[] = {"bench", "--samples=3", "--min-time=0.0001",
+                        "--warmup=0", "--sizes=10,20", "--format=csv",
+                        "--output=/dev/null"};
+  vector<size_t> built;
+  int status = benchmark_main(7, const_cast<char**>(argv), {1, 2, 3},
+                              [&built](benchmark_suite& s, size_t n) {
+    built.push_back(n);
+    s.add("sum/" + to_string(n), [n]() {
+      size_t x = 0;
+      for (size_t i = 0; i != n; ++i)
+        do_not_optimize(x += i);
+    });
+  });
+  assert(status == 0);
+  assert(built == vector<size_t>({10, 20}));
+}
+
+// Hardware counters are read around the samples when they are available,
+// and are reported and read back with the other results.
+void
+check_counters()
+{
+  const char* argv[] = {"bench", "--counters=cycles,page-faults"};
+  benchmark_options o;
+  parse_options(2, const_cast<char**>(argv), o);
+  assert(o.counters.size() == 2);
+  assert(o.counters[1] == hardware_counter::page_faults);
+  const char* all[] = {"bench", "--counters=all"};
+  parse_options(2, const_cast<char**>(all), o);
+  assert(o.counters == all_hardware_counters());
+  const char* bad[] = {"bench", "--counters=cycles,bogus"};
+  try {
+    parse_options(2, const_cast<char**>(bad), o);
+    assert(false);
+  } catch (invalid_argument&) { }
+  assert(parse_counter(counter_name(hardware_counter::dtlb_misses))
+         == hardware_counter::dtlb_misses);
+
+  // Touching fresh pages faults, if page faults can be counted at all.
+  counter_group g({hardware_counter::page_faults});
+  if (!g.empty()) {
+    g.reset();
+    g.enable();
+    vector<char> v(1 << 24, 1);
+    do_not_optimize(v.data());
+    g.disable();
+    assert(g.read()[0] > 0);
+  }
+
+  o.samples = 3;
+  o.min_sample_time = 0.001;
+  o.warmup_time = 0;
+  benchmark_result r = run_benchmark("sum", [](size_t n) {
+    size_t x = 0;
+    for (size_t i = 0; i != n; ++i)
+      do_not_optimize(x += i);
+  }, o);
+  for (const benchmark_counter& c : r.counters)
+    assert(c.per_iteration >= 0 && find_counter(r, c.counter));
+
+  // Results with and without counters are written and read back.
+  vector<benchmark_result> rs {r, r};
+  rs[0].counters = {{hardware_counter::cycles, 12.5},
+                    {hardware_counter::llc_misses, 0.25}};
+  rs[1].counters = {{hardware_counter::llc_misses, 0.5}};
+  stringstream ss;
+  write_csv(ss, rs);
+  vector<benchmark_result> xs = read_csv(ss);
+  assert(xs.size() == 2 && xs[0].counters.size() == 2);
+  assert(*find_counter(xs[0], hardware_counter::cycles) == 12.5);
+  assert(*find_counter(xs[1], hardware_counter::llc_misses) == 0.5);
+  assert(!find_counter(xs[1], hardware_counter::cycles));
+
+  ostringstream ts, js;
+  write_text(ts, rs);
+  assert(ts.str().find("llc-misses") != string::npos);
+  write_json(js, rs);
+  assert(js.str().find("\"counters\": {\"cycles\": 12.5") != string::npos);
+}
+
+int main()
+{
+  check_statistics();
+  check_options();
+  check_run();
+  check_rates();
+  check_sizes();
+  check_counters();
+}
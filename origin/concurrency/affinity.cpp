@@ -0,0 +1,72 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+#include "affinity.hpp"
+
+namespace origin
+{
+  std::size_t
+  hardware_threads()
+  {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+#if defined(__linux__)
+  namespace
+  {
+    bool
+    pin(pthread_t t, std::size_t cpu)
+    {
+      cpu_set_t s;
+      CPU_ZERO(&s);
+      CPU_SET(cpu % hardware_threads(), &s);
+      return pthread_setaffinity_np(t, sizeof(s), &s) == 0;
+    }
+  } // namespace
+
+  bool
+  pin_current_thread(std::size_t cpu)
+  {
+    return pin(pthread_self(), cpu);
+  }
+
+  bool
+  pin_thread(std::thread& t, std::size_t cpu)
+  {
+    return t.joinable() && pin(t.native_handle(), cpu);
+  }
+
+  bool
+  unpin_current_thread()
+  {
+    cpu_set_t s;
+    CPU_ZERO(&s);
+    for (std::size_t i = 0, n = hardware_threads(); i != n; ++i)
+      CPU_SET(i, &s);
+    return pthread_setaffinity_np(pthread_self(), sizeof(s), &s) == 0;
+  }
+
+  int
+  current_processor()
+  {
+    return sched_getcpu();
+  }
+#else
+  bool pin_current_thread(std::size_t) { return false; }
+  bool pin_thread(std::thread&, std::size_t) { return false; }
+  bool unpin_current_thread() { return false; }
+  int current_processor() { return -1; }
+#endif
+
+} // namespace origin
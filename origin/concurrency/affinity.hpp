@@ -0,0 +1,49 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_CONCURRENCY_AFFINITY_HPP
+#define ORIGIN_CONCURRENCY_AFFINITY_HPP
+
+#include <cstddef>
+#include <thread>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [conc.affinity]
+  //                            Thread Affinity
+  //
+  // A thread pinned to a processor runs only on that processor, so that the
+  // data it has brought into the processor's caches stays there, and the
+  // operating system does not move it to a processor of another socket,
+  // away from the memory it has touched. Processors are numbered from 0 to
+  // hardware_threads() - 1, and a processor number is taken modulo that
+  // count. Pinning is supported on Linux; elsewhere the pinning functions
+  // do nothing and return false.
+
+  // Returns the number of hardware threads, and at least 1.
+  std::size_t hardware_threads();
+
+  // Pin the calling thread to the processor cpu. Returns false if the
+  // thread could not be pinned.
+  bool pin_current_thread(std::size_t cpu);
+
+  // Pin the thread t to the processor cpu. Returns false if the thread
+  // could not be pinned.
+  bool pin_thread(std::thread& t, std::size_t cpu);
+
+  // Allow the calling thread to run on any processor. Returns false if the
+  // affinity of the thread could not be changed.
+  bool unpin_current_thread();
+
+  // Returns the processor on which the calling thread is running, or -1 if
+  // it is not known.
+  int current_processor();
+
+} // namespace origin
+
+#endif
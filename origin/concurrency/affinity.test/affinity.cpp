@@ -0,0 +1,40 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <thread>
+
+#include <origin/concurrency/affinity.hpp>
+
+using namespace std;
+using namespace origin;
+
+int main()
+{
+  assert(hardware_threads() >= 1);
+
+#if defined(__linux__)
+  // A sandbox may forbid pinning to some processors, so only a successful
+  // pin is checked.
+  if (pin_current_thread(0))
+    assert(current_processor() == 0);
+  unpin_current_thread();
+
+  int cpu = -1;
+  thread t([&cpu]() {
+    this_thread::sleep_for(chrono::milliseconds(10));
+    cpu = current_processor();
+  });
+  bool pinned = pin_thread(t, hardware_threads() - 1);
+  t.join();
+  if (pinned)
+    assert(cpu == int(hardware_threads() - 1));
+#else
+  assert(!pin_current_thread(0));
+  assert(current_processor() == -1);
+#endif
+}
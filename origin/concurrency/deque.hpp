@@ -0,0 +1,175 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_CONCURRENCY_DEQUE_HPP
+#define ORIGIN_CONCURRENCY_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [conc.deque]
+  //                          Work-Stealing Deques
+  //
+  // A work-stealing deque is the double-ended queue of Chase and Lev, with
+  // the memory orders given by Le, Pop, Cohen and Zappa Nardelli for weak
+  // memory models. One thread, the owner of the deque, pushes and pops
+  // values at its bottom; any other thread may steal a value from its top.
+  // The owner's operations need no atomic read-modify-write except when
+  // the deque holds a single value, and a steal is a single compare and
+  // exchange, so a deque is used by its owner almost as cheaply as a
+  // vector.
+  //
+  // The values are stored in a circular array that the owner doubles when
+  // it is full. A thief may still be reading the old array, so the old
+  // arrays are kept until the deque is destroyed; since each is half the
+  // size of the next, they never occupy more than the current array. The
+  // values are read and written atomically, and so must be trivially
+  // copyable; a deque usually holds pointers.
+  template <typename T>
+    class work_stealing_deque
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "the values of a work-stealing deque must be "
+                    "trivially copyable");
+
+      struct buffer
+      {
+        explicit buffer(std::size_t n)
+          : mask(n - 1), values(new std::atomic<T>[n])
+        { }
+
+        std::size_t size() const { return mask + 1; }
+
+        T get(std::int64_t i) const
+        {
+          return values[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, T x)
+        {
+          values[i & mask].store(x, std::memory_order_relaxed);
+        }
+
+        std::size_t mask;
+        std::unique_ptr<std::atomic<T>[]> values;
+      };
+
+    public:
+      // Create an empty deque whose array has room for n values, rounded up
+      // to a power of two.
+      explicit work_stealing_deque(std::size_t n = 64)
+        : top_(0), bottom_(0)
+      {
+        std::size_t m = 1;
+        while (m < n)
+          m *= 2;
+        buffers_.emplace_back(new buffer(m));
+        array_.store(buffers_.back().get(), std::memory_order_relaxed);
+      }
+
+      work_stealing_deque(const work_stealing_deque&) = delete;
+      work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+      // Returns true if the deque appears to be empty. The result may be out
+      // of date as soon as it is returned.
+      bool empty() const
+      {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+        return b <= t;
+      }
+
+      // Push x onto the bottom of the deque. Only the owner may push.
+      void push(T x)
+      {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        buffer* a = array_.load(std::memory_order_relaxed);
+        if (b - t > std::int64_t(a->size()) - 1)
+          a = grow(a, t, b);
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+
+      // Pop the value at the bottom of the deque into x. Returns false if
+      // the deque is empty, or its last value was stolen. Only the owner
+      // may pop.
+      bool pop(T& x)
+      {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        buffer* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+          bottom_.store(b + 1, std::memory_order_relaxed);
+          return false;
+        }
+        x = a->get(b);
+        if (t == b) {
+          // The last value: race the thieves for it.
+          bool won = top_.compare_exchange_strong(t, t + 1,
+                                                  std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed);
+          bottom_.store(b + 1, std::memory_order_relaxed);
+          return won;
+        }
+        return true;
+      }
+
+      // Steal the value at the top of the deque into x. Returns false if
+      // the deque is empty, or another thread took the value first. Any
+      // thread may steal.
+      bool steal(T& x)
+      {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b)
+          return false;
+        buffer* a = array_.load(std::memory_order_acquire);
+        x = a->get(t);
+        return top_.compare_exchange_strong(t, t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+      }
+
+    private:
+      // Replace the array a, holding the values [t, b), by one twice its
+      // size.
+      buffer* grow(buffer* a, std::int64_t t, std::int64_t b)
+      {
+        buffers_.emplace_back(new buffer(2 * a->size()));
+        buffer* n = buffers_.back().get();
+        for (std::int64_t i = t; i != b; ++i)
+          n->put(i, a->get(i));
+        array_.store(n, std::memory_order_release);
+        return n;
+      }
+
+    private:
+      // The indexes are kept on separate cache lines, since the owner writes
+      // the bottom and thieves write the top.
+      alignas(64) std::atomic<std::int64_t> top_;
+      alignas(64) std::atomic<std::int64_t> bottom_;
+      alignas(64) std::atomic<buffer*> array_;
+
+      // The current array and the arrays it replaced, owned by the owner.
+      std::vector<std::unique_ptr<buffer>> buffers_;
+    };
+
+} // namespace origin
+
+#endif
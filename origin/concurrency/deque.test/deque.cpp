@@ -0,0 +1,79 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include <origin/concurrency/deque.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The owner pops in LIFO order, and thieves steal in FIFO order, across
+// the growth of the array.
+void
+check_order()
+{
+  work_stealing_deque<int> d(2);
+  assert(d.empty());
+  for (int i = 0; i != 100; ++i)
+    d.push(i);
+  int x;
+  assert(d.steal(x) && x == 0);
+  assert(d.steal(x) && x == 1);
+  assert(d.pop(x) && x == 99);
+  assert(d.pop(x) && x == 98);
+  for (int i = 2; i != 98; ++i)
+    assert(d.pop(x) && x == 97 - (i - 2));
+  assert(d.empty());
+  assert(!d.pop(x));
+  assert(!d.steal(x));
+}
+
+// Each value pushed is taken exactly once, by the owner or by a thief.
+void
+check_races()
+{
+  const int n = 100000;
+  work_stealing_deque<int> d;
+  vector<atomic<int>> taken(n);
+  for (atomic<int>& t : taken)
+    t = 0;
+  atomic<bool> done(false);
+
+  vector<thread> thieves;
+  for (int i = 0; i != 3; ++i)
+    thieves.emplace_back([&]() {
+      int x;
+      while (!done.load())
+        if (d.steal(x))
+          ++taken[x];
+    });
+
+  int x;
+  for (int i = 0; i != n; ++i) {
+    d.push(i);
+    if (i % 3 == 0 && d.pop(x))
+      ++taken[x];
+  }
+  while (d.pop(x))
+    ++taken[x];
+  done = true;
+  for (thread& t : thieves)
+    t.join();
+
+  for (atomic<int>& t : taken)
+    assert(t == 1);
+}
+
+int main()
+{
+  check_order();
+  check_races();
+}
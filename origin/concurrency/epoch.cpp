@@ -0,0 +1,289 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "epoch.hpp"
+
+namespace origin
+{
+  constexpr std::size_t epoch_domain::collect_threshold;
+
+  namespace concurrency_impl
+  {
+    // The record of a thread in a domain. A pinned thread announces
+    // 2e + 1, where e is the epoch it observed; an unpinned thread
+    // announces 0. Only the owner writes the record, except for owned,
+    // which a thread sets to take a free record.
+    struct epoch_record
+    {
+      alignas(64) std::atomic<std::uint64_t> announce;
+      std::atomic<bool> owned;
+      std::size_t depth;
+      std::size_t since;
+      std::vector<retired_object> retired;
+      epoch_record* next;
+    };
+
+    // The records of a domain are never removed from its list until the
+    // domain is destroyed, so that they can be traversed without locks.
+    // The objects left by exited threads are its orphans.
+    struct epoch_state
+    {
+      std::uint64_t id;
+      std::atomic<std::uint64_t> epoch;
+      std::atomic<epoch_record*> records;
+      std::atomic<std::size_t> orphan_count;
+      std::mutex mutex;
+      std::vector<retired_object> orphans;
+
+      ~epoch_state()
+      {
+        epoch_record* r = records.load();
+        while (r) {
+          for (retired_object& x : r->retired)
+            x.free(x.p, x.n);
+          epoch_record* next = r->next;
+          delete r;
+          r = next;
+        }
+        for (retired_object& x : orphans)
+          x.free(x.p, x.n);
+      }
+    };
+  } // namespace concurrency_impl
+
+  using concurrency_impl::epoch_record;
+  using concurrency_impl::epoch_state;
+  using concurrency_impl::retired_object;
+
+  namespace
+  {
+    // Domains are identified in the threads' caches by numbers that are
+    // never reused, so that an entry of a destroyed domain cannot match a
+    // new one at the same address.
+    std::atomic<std::uint64_t> next_domain(1);
+
+    // Take a free record of s, or add one.
+    epoch_record*
+    acquire(epoch_state& s)
+    {
+      for (epoch_record* r = s.records.load(std::memory_order_acquire); r;
+           r = r->next) {
+        bool free = false;
+        if (!r->owned.load(std::memory_order_relaxed) &&
+            r->owned.compare_exchange_strong(free, true))
+          return r;
+      }
+      epoch_record* r = new epoch_record;
+      r->announce.store(0, std::memory_order_relaxed);
+      r->owned.store(true, std::memory_order_relaxed);
+      r->depth = 0;
+      r->since = 0;
+      r->next = s.records.load(std::memory_order_relaxed);
+      while (!s.records.compare_exchange_weak(r->next, r))
+        ;
+      return r;
+    }
+
+    // Release the record r of s when its thread exits, leaving its retired
+    // objects to the other threads.
+    void
+    release(epoch_state& s, epoch_record& r)
+    {
+      r.depth = 0;
+      r.since = 0;
+      r.announce.store(0, std::memory_order_release);
+      if (!r.retired.empty()) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.orphans.insert(s.orphans.end(), r.retired.begin(), r.retired.end());
+        s.orphan_count.store(s.orphans.size(), std::memory_order_relaxed);
+        r.retired.clear();
+      }
+      r.owned.store(false, std::memory_order_release);
+    }
+
+    // The records of the calling thread. The entries of destroyed domains
+    // are pruned when a record is added.
+    struct thread_records
+    {
+      struct entry
+      {
+        std::uint64_t id;
+        epoch_record* record;
+        std::weak_ptr<epoch_state> state;
+      };
+
+      ~thread_records()
+      {
+        for (entry& e : entries)
+          if (std::shared_ptr<epoch_state> s = e.state.lock())
+            release(*s, *e.record);
+      }
+
+      std::vector<entry> entries;
+    };
+
+    thread_local thread_records local_records;
+
+    // Advance the epoch of s if every pinned thread has announced it.
+    // Returns the epoch, advanced or not.
+    std::uint64_t
+    try_advance(epoch_state& s)
+    {
+      std::uint64_t e = s.epoch.load();
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      for (epoch_record* r = s.records.load(std::memory_order_acquire); r;
+           r = r->next) {
+        std::uint64_t a = r->announce.load(std::memory_order_acquire);
+        if ((a & 1) && (a >> 1) != e)
+          return e;
+      }
+      if (s.epoch.compare_exchange_strong(e, e + 1))
+        return e + 1;
+      return e;
+    }
+
+    // Returns true if the object x cannot be referred to in epoch e.
+    inline bool
+    expired(const retired_object& x, std::uint64_t e)
+    {
+      return x.epoch + 2 <= e;
+    }
+
+    // Free the objects of the calling thread's list that have expired in
+    // epoch e. The list is in the order of retirement, so they are a
+    // prefix.
+    void
+    collect(std::vector<retired_object>& v, std::uint64_t e)
+    {
+      auto i = v.begin();
+      for (; i != v.end() && expired(*i, e); ++i)
+        i->free(i->p, i->n);
+      v.erase(v.begin(), i);
+    }
+
+    // Free the orphans of s that have expired in epoch e. They are freed
+    // outside the lock.
+    void
+    collect_orphans(epoch_state& s, std::uint64_t e)
+    {
+      if (s.orphan_count.load(std::memory_order_relaxed) == 0)
+        return;
+      std::vector<retired_object> ready;
+      {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto i = std::stable_partition(s.orphans.begin(), s.orphans.end(),
+                                       [e](const retired_object& x) {
+                                         return !expired(x, e);
+                                       });
+        ready.assign(i, s.orphans.end());
+        s.orphans.erase(i, s.orphans.end());
+        s.orphan_count.store(s.orphans.size(), std::memory_order_relaxed);
+      }
+      for (retired_object& x : ready)
+        x.free(x.p, x.n);
+    }
+  } // namespace
+
+
+  epoch_domain::epoch_domain()
+    : state_(std::make_shared<epoch_state>())
+  {
+    state_->id = next_domain.fetch_add(1);
+    state_->epoch.store(0);
+    state_->records.store(nullptr);
+    state_->orphan_count.store(0);
+  }
+
+  // The state is destroyed, freeing the retired objects, when the last
+  // exiting thread that holds it releases it.
+  epoch_domain::~epoch_domain()
+  { }
+
+  epoch_record&
+  epoch_domain::record() const
+  {
+    std::vector<thread_records::entry>& es = local_records.entries;
+    for (thread_records::entry& e : es)
+      if (e.id == state_->id)
+        return *e.record;
+
+    es.erase(std::remove_if(es.begin(), es.end(),
+                            [](const thread_records::entry& e) {
+                              return e.state.expired();
+                            }),
+             es.end());
+    epoch_record* r = acquire(*state_);
+    es.push_back({state_->id, r, state_});
+    return *r;
+  }
+
+  // The announcement must be visible to a thread advancing the epoch
+  // before this thread reads shared data, hence the fence.
+  void
+  epoch_domain::enter()
+  {
+    epoch_record& r = record();
+    if (r.depth++ == 0) {
+      std::uint64_t e = state_->epoch.load(std::memory_order_relaxed);
+      r.announce.store((e << 1) | 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  void
+  epoch_domain::exit()
+  {
+    epoch_record& r = record();
+    if (--r.depth == 0)
+      r.announce.store(0, std::memory_order_release);
+  }
+
+  bool
+  epoch_domain::pinned() const
+  {
+    return record().depth != 0;
+  }
+
+  void
+  epoch_domain::retire(void* p, std::size_t n, void (*f)(void*, std::size_t))
+  {
+    epoch_record& r = record();
+    r.retired.push_back({state_->epoch.load(), p, n, f});
+    if (++r.since >= collect_threshold)
+      reclaim();
+  }
+
+  std::size_t
+  epoch_domain::reclaim()
+  {
+    epoch_record& r = record();
+    r.since = 0;
+    std::uint64_t e = try_advance(*state_);
+    collect(r.retired, e);
+    collect_orphans(*state_, e);
+    return r.retired.size();
+  }
+
+  std::uint64_t
+  epoch_domain::epoch() const
+  {
+    return state_->epoch.load();
+  }
+
+
+  epoch_domain&
+  default_epoch_domain()
+  {
+    static epoch_domain d;
+    return d;
+  }
+
+} // namespace origin
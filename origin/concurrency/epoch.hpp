@@ -0,0 +1,174 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_CONCURRENCY_EPOCH_HPP
+#define ORIGIN_CONCURRENCY_EPOCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [conc.epoch]
+  //                        Epoch-Based Reclamation
+  //
+  // An epoch domain defers the freeing of memory that concurrent readers may
+  // still refer to. A reader pins the domain while it reads shared data, by
+  // holding an epoch_guard; a writer that unlinks an object from the shared
+  // data retires it, and the domain frees it once every thread that might
+  // have seen it has unpinned:
+  //
+  //    epoch_domain d;
+  //
+  //    {                                 // Reader
+  //      epoch_guard g(d);
+  //      node* p = head.load();
+  //      ...                             // p is not freed while g lives
+  //    }
+  //
+  //    node* p = unlink(...);            // Writer
+  //    d.retire(p);                      // Deleted later
+  //
+  // Pinning takes no lock and writes only the calling thread's record. The
+  // domain has a global epoch, and a pinned thread announces the epoch it
+  // observed. A retired object is tagged with the global epoch; the epoch
+  // advances when every pinned thread has announced the current one, and
+  // an object is freed when the epoch has advanced twice past its tag, at
+  // which point no thread pinned before it was unlinked remains pinned.
+  // Guards may be nested.
+  //
+  // Each thread has a record in the domain, taken on the thread's first use
+  // of it, with its own list of retired objects. When a thread has retired
+  // collect_threshold objects since it last collected, it tries to advance
+  // the epoch and frees the objects of its list that are old enough, in a
+  // batch, so that memory is reclaimed in time bounded by the length of the
+  // longest read. reclaim() collects at any time. When a thread exits, its
+  // record is released for reuse by another thread, and the objects it left
+  // are collected by the other threads. Objects still retired when the
+  // domain is destroyed are freed then; no thread may be pinned.
+  //
+  // An object is freed by a function f(p, n), which by default deletes p.
+  // Memory obtained from a pool (see [mem.pool]) can be returned to it in
+  // this way:
+  //
+  //    p->~node();
+  //    d.retire(p, sizeof(node), pool_deallocate);
+  //
+  // and objects allocated by a stateless allocator, such as pool_allocator
+  // or an arena_allocator of a static arena, by retire<Alloc>(p, n). A long
+  // read delays reclamation for every thread of the domain, so a reader
+  // should not stay pinned while it blocks.
+  //
+  // The default domain, returned by default_epoch_domain(), may be shared by
+  // the data structures of a program.
+
+
+  namespace concurrency_impl
+  {
+    // A retired object, to be freed by free(p, n) once the global epoch
+    // has reached epoch + 2.
+    struct retired_object
+    {
+      std::uint64_t epoch;
+      void* p;
+      std::size_t n;
+      void (*free)(void*, std::size_t);
+    };
+
+    struct epoch_state;
+    struct epoch_record;
+  } // namespace concurrency_impl
+
+
+  class epoch_domain
+  {
+  public:
+    // The number of objects a thread retires between collections.
+    static constexpr std::size_t collect_threshold = 64;
+
+    epoch_domain();
+    ~epoch_domain();
+
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    // Pin and unpin the calling thread. Calls may be nested; the thread is
+    // unpinned by the exit matching its outermost enter.
+    void enter();
+    void exit();
+
+    // Returns true if the calling thread is pinned.
+    bool pinned() const;
+
+    // Free p later by calling f(p, n).
+    void retire(void* p, std::size_t n, void (*f)(void*, std::size_t));
+
+    // Delete p later.
+    template <typename T>
+      void retire(T* p)
+      {
+        retire(p, 1, [](void* q, std::size_t) { delete static_cast<T*>(q); });
+      }
+
+    // Destroy the n objects at p and return them to a stateless allocator
+    // later.
+    template <typename Alloc, typename T>
+      void retire(T* p, std::size_t n)
+      {
+        retire(p, n, [](void* q, std::size_t m) {
+          T* x = static_cast<T*>(q);
+          for (std::size_t i = 0; i != m; ++i)
+            x[i].~T();
+          Alloc a;
+          a.deallocate(x, m);
+        });
+      }
+
+    // Try to advance the epoch, and free the objects retired by the calling
+    // thread, or left by exited threads, that no thread can refer to.
+    // Returns the number of objects the calling thread still has retired.
+    std::size_t reclaim();
+
+    // Returns the global epoch.
+    std::uint64_t epoch() const;
+
+  private:
+    concurrency_impl::epoch_record& record() const;
+
+    std::shared_ptr<concurrency_impl::epoch_state> state_;
+  };
+
+
+  // An epoch guard pins the calling thread in a domain for its lifetime.
+  class epoch_guard
+  {
+  public:
+    explicit epoch_guard(epoch_domain& d)
+      : domain_(d)
+    {
+      domain_.enter();
+    }
+
+    ~epoch_guard() { domain_.exit(); }
+
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+
+  private:
+    epoch_domain& domain_;
+  };
+
+
+  // Returns the domain shared by the program.
+  epoch_domain& default_epoch_domain();
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,161 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <origin/concurrency/epoch.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Nodes are not released to the heap when they are freed, but marked dead,
+// so that a reader can check that no node it sees has been freed.
+struct node
+{
+  atomic<bool> dead;
+  int value;
+};
+
+atomic<size_t> freed(0);
+
+void
+free_node(void* p, size_t)
+{
+  static_cast<node*>(p)->dead.store(true);
+  ++freed;
+}
+
+struct counted
+{
+  ~counted() { ++freed; }
+};
+
+void
+test_serial()
+{
+  freed = 0;
+  {
+    epoch_domain d;
+    assert(!d.pinned());
+    {
+      epoch_guard g1(d);
+      epoch_guard g2(d);
+      assert(d.pinned());
+    }
+    assert(!d.pinned());
+
+    // A pinned thread keeps what it retired.
+    node n;
+    n.dead = false;
+    {
+      epoch_guard g(d);
+      d.retire(&n, 1, free_node);
+      for (int i = 0; i != 10; ++i)
+        assert(d.reclaim() == 1);
+      assert(!n.dead);
+    }
+    while (d.reclaim() != 0)
+      ;
+    assert(n.dead && freed == 1);
+
+    // Objects are collected in batches as they are retired.
+    for (size_t i = 0; i != epoch_domain::collect_threshold * 4; ++i)
+      d.retire(new counted);
+    assert(freed > 1);
+
+    // Objects of a stateless allocator are destroyed and deallocated.
+    allocator<counted> a;
+    counted* p = a.allocate(3);
+    for (int i = 0; i != 3; ++i)
+      new (p + i) counted;
+    d.retire<allocator<counted>>(p, 3);
+  }
+  assert(freed == 1 + epoch_domain::collect_threshold * 4 + 3);
+}
+
+// The objects left by an exited thread are collected by another.
+void
+test_orphans()
+{
+  freed = 0;
+  epoch_domain d;
+  thread t([&] {
+    for (int i = 0; i != 10; ++i)
+      d.retire(new counted);
+  });
+  t.join();
+  while (d.reclaim() != 0 || freed != 10)
+    ;
+
+  // The record of the thread is reused.
+  thread u([&] { epoch_guard g(d); });
+  u.join();
+}
+
+// Readers never see a freed node while writers replace the shared one.
+void
+test_concurrent()
+{
+  freed = 0;
+  const int readers = 4;
+  const int writes = 20000;
+  vector<unique_ptr<node>> nodes(2 * writes + 1);
+  for (size_t i = 0; i != nodes.size(); ++i) {
+    nodes[i].reset(new node);
+    nodes[i]->dead = false;
+    nodes[i]->value = int(i);
+  }
+
+  {
+    epoch_domain d;
+    atomic<node*> shared(nodes[0].get());
+    atomic<bool> done(false);
+    atomic<size_t> reads(0);
+
+    vector<thread> ts;
+    for (int r = 0; r != readers; ++r)
+      ts.emplace_back([&] {
+        while (!done) {
+          epoch_guard g(d);
+          node* p = shared.load();
+          for (int i = 0; i != 8; ++i)
+            assert(!p->dead);
+          ++reads;
+        }
+      });
+    for (int w = 0; w != 2; ++w)
+      ts.emplace_back([&, w] {
+        for (int i = 0; i != writes; ++i) {
+          node* p = nodes[1 + w * writes + i].get();
+          node* old = shared.exchange(p);
+          d.retire(old, 1, free_node);
+        }
+      });
+    for (int i = readers; i != readers + 2; ++i)
+      ts[i].join();
+    done = true;
+    for (int i = 0; i != readers; ++i)
+      ts[i].join();
+
+    assert(reads > 0);
+    assert(freed > 0 && freed <= size_t(2 * writes));
+    assert(!shared.load()->dead);
+  }
+  assert(freed == size_t(2 * writes));
+}
+
+int main()
+{
+  test_serial();
+  test_orphans();
+  test_concurrent();
+  assert(&default_epoch_domain() == &default_epoch_domain());
+}
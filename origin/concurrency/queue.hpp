@@ -0,0 +1,364 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_CONCURRENCY_QUEUE_HPP
+#define ORIGIN_CONCURRENCY_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [conc.queue]
+  //                            Bounded Queues
+  //
+  // A bounded queue passes values between threads through a fixed ring of
+  // slots, without locks. Two kinds of queue are provided:
+  //
+  //    spsc_queue<T>   One producer thread and one consumer thread
+  //    mpmc_queue<T>   Any number of producer and consumer threads
+  //
+  // The single-producer queue is a ring buffer with a head index written
+  // only by the consumer and a tail index written only by the producer; each
+  // side keeps a copy of the other's index and reads the shared one only
+  // when its copy says the queue is full or empty. The multi-producer queue
+  // is that of Vyukov: each slot has a sequence number that says whether it
+  // is ready to be written or read in the current lap of the ring, so that
+  // a push or pop is a single compare and exchange of the tail or head. In
+  // both, the indexes are kept on separate cache lines, so that producers
+  // and consumers do not invalidate each other's lines.
+  //
+  // Both queues have the same operations:
+  //
+  //    q.try_push(x)           Push x, or return false if q is full
+  //    q.try_pop(x)            Pop into x, or return false if q is empty
+  //    q.push(x), q.pop(x)     Wait until the value can be pushed or popped
+  //    q.try_push(first, last) Push a prefix of the forward range [first,
+  //                            last), returning the end of the values
+  //                            pushed
+  //    q.try_pop(out, n)       Pop up to n values into out, returning the
+  //                            number popped
+  //
+  // A batch is claimed with a single update of the index, so handing over
+  // values in batches amortizes the cost of synchronization. The range of a
+  // batch is measured before any value is moved from it, so it must be a
+  // forward range. The waiting operations yield the processor while they
+  // wait; they suit pipeline stages that usually find their queues neither
+  // full nor empty. The capacity of a queue is rounded up to a power of two.
+  namespace concurrency_impl
+  {
+    // Returns the least power of two that is at least n, and at least 2.
+    inline std::size_t
+    ring_size(std::size_t n)
+    {
+      std::size_t m = 2;
+      while (m < n)
+        m *= 2;
+      return m;
+    }
+
+    // Uninitialized storage for a T.
+    template <typename T>
+      struct slot_storage
+      {
+        T* get() { return reinterpret_cast<T*>(&data); }
+
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data;
+      };
+  } // namespace concurrency_impl
+
+
+  template <typename T>
+    class spsc_queue
+    {
+      using slot = concurrency_impl::slot_storage<T>;
+    public:
+      using value_type = T;
+
+      explicit spsc_queue(std::size_t capacity)
+        : mask_(concurrency_impl::ring_size(capacity) - 1),
+          slots_(new slot[mask_ + 1]),
+          head_(0), tail_cache_(0), tail_(0), head_cache_(0)
+      { }
+
+      ~spsc_queue()
+      {
+        std::size_t t = tail_.load(std::memory_order_relaxed);
+        for (std::size_t h = head_.load(std::memory_order_relaxed); h != t; ++h)
+          slots_[h & mask_].get()->~T();
+      }
+
+      spsc_queue(const spsc_queue&) = delete;
+      spsc_queue& operator=(const spsc_queue&) = delete;
+
+      // Returns the number of values the queue can hold.
+      std::size_t capacity() const { return mask_ + 1; }
+
+      // Returns the number of values in the queue. The result may be out of
+      // date as soon as it is returned.
+      std::size_t size() const
+      {
+        return tail_.load(std::memory_order_acquire)
+             - head_.load(std::memory_order_acquire);
+      }
+
+      bool empty() const { return size() == 0; }
+
+      // Producer operations
+      bool try_push(const T& x) { return try_emplace(x); }
+      bool try_push(T&& x) { return try_emplace(std::move(x)); }
+
+      template <typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+          std::size_t t = tail_.load(std::memory_order_relaxed);
+          if (room(t, 1) == 0)
+            return false;
+          new (slots_[t & mask_].get()) T(std::forward<Args>(args)...);
+          tail_.store(t + 1, std::memory_order_release);
+          return true;
+        }
+
+      // I must be a forward iterator: the range is measured with
+      // std::distance before any value is moved from it.
+      template <typename I>
+        I try_push(I first, I last)
+        {
+          std::size_t t = tail_.load(std::memory_order_relaxed);
+          std::size_t n = room(t, std::distance(first, last));
+          std::size_t k = t;
+          for (; first != last && k - t != n; ++first, ++k)
+            new (slots_[k & mask_].get()) T(std::move(*first));
+          tail_.store(k, std::memory_order_release);
+          return first;
+        }
+
+      template <typename U>
+        void push(U&& x)
+        {
+          while (!try_emplace(std::forward<U>(x)))
+            std::this_thread::yield();
+        }
+
+      // Consumer operations
+      bool try_pop(T& x) { return try_pop(&x, 1) == 1; }
+
+      template <typename O>
+        std::size_t try_pop(O out, std::size_t n)
+        {
+          std::size_t h = head_.load(std::memory_order_relaxed);
+          if (tail_cache_ - h < n)
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+          std::size_t k = std::min(n, tail_cache_ - h);
+          for (std::size_t i = h; i != h + k; ++i, ++out) {
+            T* p = slots_[i & mask_].get();
+            *out = std::move(*p);
+            p->~T();
+          }
+          head_.store(h + k, std::memory_order_release);
+          return k;
+        }
+
+      void pop(T& x)
+      {
+        while (!try_pop(x))
+          std::this_thread::yield();
+      }
+
+    private:
+      // Returns the number of free slots after the tail t. The head is read
+      // only if the copy leaves fewer than n free slots.
+      std::size_t room(std::size_t t, std::size_t n)
+      {
+        if (mask_ + 1 - (t - head_cache_) < n)
+          head_cache_ = head_.load(std::memory_order_acquire);
+        return mask_ + 1 - (t - head_cache_);
+      }
+
+    private:
+      const std::size_t mask_;
+      const std::unique_ptr<slot[]> slots_;
+
+      // The consumer's index and its copy of the tail.
+      alignas(64) std::atomic<std::size_t> head_;
+      std::size_t tail_cache_;
+
+      // The producer's index and its copy of the head.
+      alignas(64) std::atomic<std::size_t> tail_;
+      std::size_t head_cache_;
+    };
+
+
+  template <typename T>
+    class mpmc_queue
+    {
+      struct cell
+      {
+        std::atomic<std::size_t> seq;
+        concurrency_impl::slot_storage<T> value;
+      };
+
+    public:
+      using value_type = T;
+
+      explicit mpmc_queue(std::size_t capacity)
+        : mask_(concurrency_impl::ring_size(capacity) - 1),
+          cells_(new cell[mask_ + 1]),
+          head_(0), tail_(0)
+      {
+        for (std::size_t i = 0; i != mask_ + 1; ++i)
+          cells_[i].seq.store(i, std::memory_order_relaxed);
+      }
+
+      ~mpmc_queue()
+      {
+        std::size_t t = tail_.load(std::memory_order_relaxed);
+        for (std::size_t h = head_.load(std::memory_order_relaxed); h != t; ++h)
+          cells_[h & mask_].value.get()->~T();
+      }
+
+      mpmc_queue(const mpmc_queue&) = delete;
+      mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+      // Returns the number of values the queue can hold.
+      std::size_t capacity() const { return mask_ + 1; }
+
+      // Returns the number of values claimed by producers and not yet
+      // claimed by consumers. The result may be out of date as soon as it
+      // is returned.
+      std::size_t size() const
+      {
+        std::size_t h = head_.load(std::memory_order_acquire);
+        std::size_t t = tail_.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+      }
+
+      bool empty() const { return size() == 0; }
+
+      // Producer operations
+      bool try_push(const T& x) { return try_emplace(x); }
+      bool try_push(T&& x) { return try_emplace(std::move(x)); }
+
+      template <typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+          std::size_t t;
+          if (claim(tail_, 0, 1, t) == 0)
+            return false;
+          cell& c = cells_[t & mask_];
+          new (c.value.get()) T(std::forward<Args>(args)...);
+          c.seq.store(t + 1, std::memory_order_release);
+          return true;
+        }
+
+      // I must be a forward iterator: the range is measured with
+      // std::distance before any value is moved from it.
+      template <typename I>
+        I try_push(I first, I last)
+        {
+          std::size_t t;
+          std::size_t n = claim(tail_, 0, std::distance(first, last), t);
+          for (std::size_t i = t; i != t + n; ++i, ++first) {
+            cell& c = cells_[i & mask_];
+            new (c.value.get()) T(std::move(*first));
+            c.seq.store(i + 1, std::memory_order_release);
+          }
+          return first;
+        }
+
+      template <typename U>
+        void push(U&& x)
+        {
+          while (!try_emplace(std::forward<U>(x)))
+            std::this_thread::yield();
+        }
+
+      // Consumer operations
+      bool try_pop(T& x) { return try_pop(&x, 1) == 1; }
+
+      template <typename O>
+        std::size_t try_pop(O out, std::size_t n)
+        {
+          std::size_t h;
+          std::size_t k = claim(head_, 1, n, h);
+          for (std::size_t i = h; i != h + k; ++i, ++out) {
+            cell& c = cells_[i & mask_];
+            T* p = c.value.get();
+            *out = std::move(*p);
+            p->~T();
+            c.seq.store(i + mask_ + 1, std::memory_order_release);
+          }
+          return k;
+        }
+
+      void pop(T& x)
+      {
+        while (!try_pop(x))
+          std::this_thread::yield();
+      }
+
+    private:
+      // Claim up to n consecutive cells at the index x, whose sequence
+      // numbers are their positions plus lag: 0 for cells ready to be
+      // written, and 1 for cells ready to be read. The first position is
+      // stored in p, and the number of cells claimed is returned. A cell
+      // that is ready stays ready until it is claimed, so a batch whose
+      // cells are all ready can be claimed by one compare and exchange.
+      std::size_t claim(std::atomic<std::size_t>& x, std::size_t lag,
+                        std::size_t n, std::size_t& p)
+      {
+        if (n == 0)
+          return 0;
+        std::size_t pos = x.load(std::memory_order_relaxed);
+        while (true) {
+          std::size_t k = 0;
+          for (; k != n && k != mask_ + 1; ++k) {
+            std::size_t s = cells_[(pos + k) & mask_].seq.load(
+              std::memory_order_acquire);
+            if (s != pos + k + lag)
+              break;
+          }
+          if (k == 0) {
+            // Either the queue is full (or empty), or another thread has
+            // claimed the cell at pos.
+            std::size_t s = cells_[pos & mask_].seq.load(
+              std::memory_order_acquire);
+            std::intptr_t d = std::intptr_t(s) - std::intptr_t(pos + lag);
+            if (d < 0)
+              return 0;
+            pos = x.load(std::memory_order_relaxed);
+            continue;
+          }
+          if (x.compare_exchange_weak(pos, pos + k,
+                                      std::memory_order_relaxed))
+          {
+            p = pos;
+            return k;
+          }
+        }
+      }
+
+    private:
+      const std::size_t mask_;
+      const std::unique_ptr<cell[]> cells_;
+
+      alignas(64) std::atomic<std::size_t> head_;
+      alignas(64) std::atomic<std::size_t> tail_;
+    };
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,155 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <origin/concurrency/queue.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The operations of a queue used by a single thread.
+template <typename Q>
+  void
+  check_serial()
+  {
+    Q q(5);
+    assert(q.capacity() == 8);
+    assert(q.empty());
+    int x;
+    assert(!q.try_pop(x));
+    for (int i = 0; i != 8; ++i)
+      assert(q.try_push(i));
+    assert(!q.try_push(8));
+    assert(q.size() == 8);
+    assert(q.try_pop(x) && x == 0);
+
+    // A batch is pushed up to the capacity.
+    vector<int> v {10, 11, 12};
+    assert(q.try_push(v.begin(), v.end()) == v.begin() + 1);
+    int out[16];
+    assert(q.try_pop(out, 16) == 8);
+    assert(out[0] == 1 && out[6] == 7 && out[7] == 10);
+    assert(q.empty());
+
+    // Across the end of the ring.
+    for (int lap = 0; lap != 5; ++lap) {
+      assert(q.try_push(v.begin(), v.end()) == v.end());
+      assert(q.try_pop(out, 2) == 2 && out[0] == 10 && out[1] == 11);
+      assert(q.try_pop(out, 2) == 1 && out[0] == 12);
+    }
+  }
+
+// Values that are not trivial are moved in and out, and those left in the
+// queue are destroyed with it.
+template <typename Q>
+  void
+  check_values()
+  {
+    auto p = make_shared<int>(1);
+    {
+      Q q(4);
+      q.push(p);
+      q.push(p);
+      assert(p.use_count() == 3);
+      shared_ptr<int> x;
+      q.pop(x);
+      assert(x == p);
+    }
+    assert(p.use_count() == 1);
+  }
+
+// One producer and one consumer pass values in batches, in order.
+void
+check_spsc()
+{
+  const int n = 200000;
+  spsc_queue<int> q(64);
+  thread producer([&q]() {
+    int batch[7];
+    for (int i = 0; i < n; i += 7) {
+      int k = min(7, n - i);
+      for (int j = 0; j != k; ++j)
+        batch[j] = i + j;
+      int* p = batch;
+      while (p != batch + k) {
+        p = q.try_push(p, batch + k);
+        this_thread::yield();
+      }
+    }
+  });
+  int next = 0;
+  int out[5];
+  while (next != n) {
+    size_t k = q.try_pop(out, 5);
+    for (size_t j = 0; j != k; ++j)
+      assert(out[j] == next++);
+  }
+  producer.join();
+  assert(q.empty());
+}
+
+// Each value pushed by several producers is popped once, and the values of
+// each producer are popped by each consumer in order.
+void
+check_mpmc()
+{
+  const int producers = 3, consumers = 3, n = 50000;
+  mpmc_queue<int> q(128);
+  vector<atomic<int>> seen(producers * n);
+  for (atomic<int>& s : seen)
+    s = 0;
+  atomic<int> popped(0);
+
+  vector<thread> ts;
+  for (int p = 0; p != producers; ++p)
+    ts.emplace_back([&q, p]() {
+      for (int i = 0; i != n; i += 4) {
+        int batch[4] = {p * n + i, p * n + i + 1, p * n + i + 2,
+                        p * n + i + 3};
+        int* b = batch;
+        int* e = batch + min(4, n - i);
+        while ((b = q.try_push(b, e)) != e)
+          this_thread::yield();
+      }
+    });
+  for (int c = 0; c != consumers; ++c)
+    ts.emplace_back([&]() {
+      vector<int> last(producers, -1);
+      int out[3];
+      while (popped.load() != producers * n) {
+        size_t k = q.try_pop(out, 3);
+        for (size_t j = 0; j != k; ++j) {
+          ++seen[out[j]];
+          int p = out[j] / n;
+          assert(out[j] > last[p]);
+          last[p] = out[j];
+        }
+        popped += int(k);
+      }
+    });
+  for (thread& t : ts)
+    t.join();
+
+  for (atomic<int>& s : seen)
+    assert(s == 1);
+}
+
+int main()
+{
+  check_serial<spsc_queue<int>>();
+  check_serial<mpmc_queue<int>>();
+  check_values<spsc_queue<shared_ptr<int>>>();
+  check_values<mpmc_queue<shared_ptr<int>>>();
+  check_spsc();
+  check_mpmc();
+}
@@ -0,0 +1,284 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdint>
+#include <string>
+
+#include <origin/instrument/trace.hpp>
+
+#include "scheduler.hpp"
+
+namespace origin
+{
+  namespace
+  {
+    // The scheduler and deque of the current thread, if it is a worker.
+    thread_local task_scheduler* current_scheduler = nullptr;
+    thread_local std::size_t current_deque = 0;
+
+    // The state of the generator that chooses the victims of the current
+    // thread's steals.
+    thread_local std::uint64_t victim_state = 0;
+
+    // Returns a random number in [0, n), for n > 0.
+    std::size_t
+    random_victim(std::size_t n)
+    {
+      std::uint64_t& x = victim_state;
+      if (x == 0)
+        x = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      return std::size_t(x % n);
+    }
+  } // namespace
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Shared Queue
+
+  namespace concurrency_impl
+  {
+    void
+    shared_queue::push(task* t)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      tasks.push_back(t);
+    }
+
+    bool
+    shared_queue::pop(task*& t)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      if (tasks.empty())
+        return false;
+      t = tasks.back();
+      tasks.pop_back();
+      return true;
+    }
+
+    bool
+    shared_queue::steal(task*& t)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      if (tasks.empty())
+        return false;
+      t = tasks.front();
+      tasks.pop_front();
+      return true;
+    }
+  } // namespace concurrency_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                             Task Scheduler
+
+  task_scheduler::task_scheduler(std::size_t threads, thread_pinning p)
+    : pending_(0), sleeping_(0), stop_(false)
+  {
+    if (threads == 0)
+      threads = hardware_threads();
+    for (std::size_t i = 0; i != threads - 1; ++i)
+      deques_.emplace_back(new deque_type());
+    workers_.reserve(threads - 1);
+    for (std::size_t i = 0; i != threads - 1; ++i)
+      workers_.emplace_back(&task_scheduler::work, this, i, p);
+  }
+
+  // Tasks left in the queues belong to groups that were destroyed without
+  // waiting, which is an error; they are discarded.
+  task_scheduler::~task_scheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : workers_)
+      t.join();
+
+    concurrency_impl::task* t;
+    for (std::unique_ptr<deque_type>& d : deques_)
+      while (d->steal(t))
+        delete t;
+    while (shared_.steal(t))
+      delete t;
+  }
+
+  // Push the task onto the deque of the current worker, or the shared queue,
+  // and wake a sleeping worker. Sleeping workers check the number of pending
+  // tasks while holding the lock, so taking the lock before notifying
+  // ensures that the wakeup is not lost.
+  void
+  task_scheduler::spawn(concurrency_impl::task&& t)
+  {
+    concurrency_impl::task* p = new concurrency_impl::task(std::move(t));
+    if (current_scheduler == this)
+      deques_[current_deque]->push(p);
+    else
+      shared_.push(p);
+    pending_.fetch_add(1);
+    if (sleeping_.load() != 0) {
+      { std::lock_guard<std::mutex> lock(m_); }
+      wake_.notify_one();
+    }
+  }
+
+  // Find a task for the current thread. A worker pops from its own deque,
+  // then steals from the other deques, starting at a random victim, and
+  // last from the shared queue. Other threads pop from the shared queue
+  // before stealing from the workers.
+  bool
+  task_scheduler::find(concurrency_impl::task*& t)
+  {
+    bool worker = current_scheduler == this;
+    if (worker ? deques_[current_deque]->pop(t) : shared_.pop(t))
+      return true;
+    std::size_t n = deques_.size();
+    if (n != 0) {
+      std::size_t v = random_victim(n);
+      for (std::size_t i = 0; i != n; ++i, v = (v + 1) % n)
+        if (!(worker && v == current_deque) && deques_[v]->steal(t)) {
+          trace_instant("steal", v);
+          return true;
+        }
+    }
+    return worker && shared_.steal(t);
+  }
+
+  // Run one task, returning false if no task could be found.
+  bool
+  task_scheduler::run_one()
+  {
+    if (pending_.load(std::memory_order_relaxed) == 0)
+      return false;
+    concurrency_impl::task* t;
+    if (!find(t))
+      return false;
+    pending_.fetch_sub(1);
+
+    std::exception_ptr e;
+    try {
+      trace_scope span("task");
+      t->fn();
+    } catch (...) {
+      e = std::current_exception();
+    }
+    task_group* g = t->group;
+    delete t;
+    g->finish(e);
+    return true;
+  }
+
+  void
+  task_scheduler::work(std::size_t i, thread_pinning p)
+  {
+    current_scheduler = this;
+    current_deque = i;
+    if (p == thread_pinning::compact)
+      pin_current_thread(i + 1);
+    set_trace_thread_name("worker " + std::to_string(i));
+    while (true) {
+      if (run_one())
+        continue;
+      std::unique_lock<std::mutex> lock(m_);
+      sleeping_.fetch_add(1);
+      {
+        trace_scope idle("idle");
+        wake_.wait(lock, [this]() { return stop_ || pending_.load() != 0; });
+      }
+      sleeping_.fetch_sub(1);
+      if (stop_)
+        return;
+    }
+  }
+
+
+  namespace
+  {
+    // The configuration of the default scheduler, and whether it has been
+    // created.
+    std::mutex default_mutex;
+    std::size_t default_threads = 0;
+    thread_pinning default_pinning = thread_pinning::none;
+    bool default_created = false;
+
+    task_scheduler*
+    create_default_scheduler()
+    {
+      std::lock_guard<std::mutex> lock(default_mutex);
+      default_created = true;
+      return new task_scheduler(default_threads, default_pinning);
+    }
+  } // namespace
+
+  task_scheduler&
+  default_scheduler()
+  {
+    static std::unique_ptr<task_scheduler> s(create_default_scheduler());
+    return *s;
+  }
+
+  bool
+  configure_default_scheduler(std::size_t threads, thread_pinning p)
+  {
+    std::lock_guard<std::mutex> lock(default_mutex);
+    if (default_created)
+      return false;
+    default_threads = threads;
+    default_pinning = p;
+    return true;
+  }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                               Task Groups
+
+  task_group::~task_group()
+  {
+    join();
+  }
+
+  void
+  task_group::wait()
+  {
+    join();
+    std::exception_ptr e;
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      std::swap(e, error_);
+    }
+    if (e)
+      std::rethrow_exception(e);
+  }
+
+  // Run tasks until the group is complete.
+  void
+  task_group::join()
+  {
+    while (count_.load(std::memory_order_acquire) != 0)
+      if (!sched_.run_one())
+        std::this_thread::yield();
+  }
+
+  // Record the completion of a task, which threw the exception e if it is
+  // not null.
+  void
+  task_group::finish(std::exception_ptr e)
+  {
+    if (e) {
+      std::lock_guard<std::mutex> lock(m_);
+      if (!error_)
+        error_ = e;
+    }
+    count_.fetch_sub(1, std::memory_order_release);
+  }
+
+} // namespace origin
@@ -0,0 +1,327 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_CONCURRENCY_SCHEDULER_HPP
+#define ORIGIN_CONCURRENCY_SCHEDULER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <origin/concurrency/deque.hpp>
+#include <origin/concurrency/affinity.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [conc.sched]
+  //                             Task Scheduling
+  //
+  // A task scheduler runs tasks on a fixed set of worker threads. Each
+  // worker owns a work-stealing deque of tasks (see [conc.deque]). A task
+  // spawned by a worker is pushed onto the bottom of that worker's deque,
+  // and each worker runs the tasks at the bottom of its own deque first, so
+  // that recently spawned (and usually smaller) tasks run on the thread
+  // that spawned them, while their data is still in cache. A worker whose
+  // deque is empty steals the task at the top of the deque of another
+  // worker, chosen at random: the oldest, and usually largest, task. Tasks
+  // spawned by other threads are pushed onto a shared queue, from which all
+  // workers steal.
+  //
+  // Tasks are spawned in a task group, and a thread waits for the tasks in a
+  // group to complete by calling wait(). A waiting thread runs other tasks
+  // until the group is complete, so that tasks can spawn and wait for tasks
+  // of their own without blocking the workers (fork-join parallelism). If a
+  // task throws an exception, one of the exceptions thrown by the tasks of a
+  // group is rethrown by wait().
+  //
+  // A scheduler created to run on n threads has n - 1 workers: the thread
+  // waiting for a group is the nth. A scheduler with a single thread runs
+  // all tasks in wait(). Idle workers sleep until a task is spawned.
+  //
+  // The default scheduler, returned by default_scheduler(), is shared by
+  // the parallel algorithms of every module, so that a program never runs
+  // more workers than it has hardware threads however its parallel parts
+  // are nested. It uses one thread for each hardware thread unless it is
+  // configured otherwise before its first use.
+  //
+  // While tracing (see instrument.trace), each thread records the tasks
+  // that it runs, its steals, and, for workers, the time that it sleeps.
+
+
+  // The pinning of the workers of a scheduler (see [conc.affinity]).
+  //
+  //    none      Workers run on any processor.
+  //    compact   Worker i is pinned to processor i + 1, leaving processor 0
+  //              to the thread that created the scheduler.
+  enum class thread_pinning
+  {
+    none,
+    compact
+  };
+
+
+  class task_group;
+
+  namespace concurrency_impl
+  {
+    // A task is a function to run, and the group in which it was spawned.
+    struct task
+    {
+      std::function<void()> fn;
+      task_group* group;
+    };
+
+    // The queue of the tasks spawned by threads that are not workers. Its
+    // tasks are popped at the back by those threads, and stolen from the
+    // front by workers.
+    class shared_queue
+    {
+    public:
+      void push(task* t);
+      bool pop(task*& t);
+      bool steal(task*& t);
+
+    private:
+      std::mutex m;
+      std::deque<task*> tasks;
+    };
+
+  } // namespace concurrency_impl
+
+
+  // A task scheduler runs tasks on a set of worker threads. See
+  // scheduler.cpp.
+  class task_scheduler
+  {
+    friend class task_group;
+  public:
+    // Create a scheduler for the given number of threads, whose workers are
+    // pinned by p. If threads is 0, one thread is used for each hardware
+    // thread.
+    explicit task_scheduler(std::size_t threads = 0,
+                            thread_pinning p = thread_pinning::none);
+    ~task_scheduler();
+
+    task_scheduler(const task_scheduler&) = delete;
+    task_scheduler& operator=(const task_scheduler&) = delete;
+
+    // Returns the number of threads on which tasks run, including the
+    // waiting thread.
+    std::size_t size() const { return workers_.size() + 1; }
+
+  private:
+    void spawn(concurrency_impl::task&& t);
+    bool run_one();
+    bool find(concurrency_impl::task*& t);
+    void work(std::size_t i, thread_pinning p);
+
+  private:
+    std::vector<std::thread> workers_;
+
+    // The deque of each worker.
+    using deque_type = work_stealing_deque<concurrency_impl::task*>;
+    std::vector<std::unique_ptr<deque_type>> deques_;
+    concurrency_impl::shared_queue shared_;
+
+    std::atomic<std::size_t> pending_;  // The number of queued tasks
+    std::atomic<std::size_t> sleeping_; // The number of sleeping workers
+    std::mutex m_;
+    std::condition_variable wake_;
+    bool stop_;
+  };
+
+  // Returns the scheduler used by parallel algorithms by default.
+  task_scheduler& default_scheduler();
+
+  // Set the number of threads and the pinning of the default scheduler.
+  // Returns false, and changes nothing, if the default scheduler has
+  // already been created.
+  bool configure_default_scheduler(std::size_t threads,
+                                   thread_pinning p = thread_pinning::none);
+
+
+  // A task group spawns tasks on a scheduler and waits for them to complete.
+  // Tasks may be added to a group by any thread, including the tasks of the
+  // group. A task group must not be destroyed while it has incomplete
+  // tasks; the destructor waits for them, but discards their exceptions.
+  class task_group
+  {
+    friend class task_scheduler;
+  public:
+    explicit task_group(task_scheduler& s = default_scheduler())
+      : sched_(s), count_(0)
+    { }
+
+    ~task_group();
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    // Returns the scheduler of the group.
+    task_scheduler& scheduler() const { return sched_; }
+
+    // Spawn a task that calls f().
+    template<typename F>
+      void run(F f)
+      {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sched_.spawn(concurrency_impl::task{std::move(f), this});
+      }
+
+    // Run tasks until all the tasks of the group have completed. If a task
+    // of the group threw an exception, it is rethrown.
+    void wait();
+
+  private:
+    void join();
+    void finish(std::exception_ptr e);
+
+  private:
+    task_scheduler& sched_;
+    std::atomic<std::size_t> count_;  // The number of incomplete tasks
+    std::mutex m_;
+    std::exception_ptr error_;
+  };
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                 [conc.fork]
+  //                          Fork-Join Primitives
+  //
+  // The fork-join primitives are the common patterns of task groups:
+  //
+  //    fork_join(s, f, g)                  Call f() and g() in parallel
+  //    parallel_for(s, first, last, n, f)  Call f(i, j) for the subranges
+  //                                        [i, j) of [first, last)
+  //    parallel_apply(s, n, k, f)          Call f(i) for each i in [0, n)
+  //                                        on at most k threads
+  //
+  // Each runs on the scheduler s, or on the default scheduler if s is
+  // omitted, and returns when all of its calls have returned. The
+  // positions of parallel_for are integers or random access iterators; it
+  // splits its range in halves until they have at most n elements, so that
+  // the largest subranges are the first to be stolen. The subranges of a
+  // bounded range, or of any splittable range, are visited in the same way
+  // by for_each_subrange in origin/sequence/range.hpp.
+  // The calls of parallel_apply are claimed one at a time from a shared
+  // counter by k - 1 tasks and the calling thread, which suits calls of
+  // uneven cost, and lets a module limit the threads used by one of its
+  // operations without running threads of its own.
+
+  // Call f() and g() in parallel, using the scheduler s.
+  template<typename F, typename G>
+    void
+    fork_join(task_scheduler& s, F f, G g)
+    {
+      task_group grp(s);
+      grp.run(std::move(f));
+      g();
+      grp.wait();
+    }
+
+  template<typename F, typename G>
+    inline void
+    fork_join(F f, G g)
+    {
+      fork_join(default_scheduler(), std::move(f), std::move(g));
+    }
+
+
+  // Call f(i, j) for subranges [i, j) partitioning [first, last), each of
+  // at most grain elements, using the scheduler s.
+  template<typename P, typename F>
+    void
+    parallel_for(task_scheduler& s, P first, P last, std::size_t grain, F f)
+    {
+      grain = std::max<std::size_t>(grain, 1);
+      if (std::size_t(last - first) <= grain) {
+        if (first != last)
+          f(first, last);
+        return;
+      }
+      // The group is declared after the function run by its tasks, so
+      // that it waits for them before the function is destroyed.
+      std::function<void(P, P)> split;
+      task_group g(s);
+      split = [&](P i, P j) {
+        while (std::size_t(j - i) > grain) {
+          P mid = i + (j - i) / 2;
+          g.run([&split, mid, j]() { split(mid, j); });
+          j = mid;
+        }
+        f(i, j);
+      };
+      split(first, last);
+      g.wait();
+    }
+
+  template<typename P, typename F>
+    inline void
+    parallel_for(P first, P last, std::size_t grain, F f)
+    {
+      parallel_for(default_scheduler(), first, last, grain, std::move(f));
+    }
+
+
+  // Call f(i) for each i in [0, n), using at most threads threads of the
+  // scheduler s. Every call is made even if some throw; one of the
+  // exceptions thrown is rethrown.
+  template<typename F>
+    void
+    parallel_apply(task_scheduler& s, std::size_t n, std::size_t threads,
+                   F f)
+    {
+      threads = std::max<std::size_t>(std::min({threads, s.size(), n}), 1);
+
+      std::atomic<std::size_t> next {0};
+      std::mutex m;
+      std::exception_ptr error;
+      auto work = [&]() {
+        std::size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < n) {
+          try {
+            f(i);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(m);
+            if (!error)
+              error = std::current_exception();
+          }
+        }
+      };
+
+      if (threads == 1) {
+        work();
+      } else {
+        task_group g(s);
+        for (std::size_t i = 1; i != threads; ++i)
+          g.run(work);
+        work();
+        g.wait();
+      }
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+  template<typename F>
+    inline void
+    parallel_apply(std::size_t n, std::size_t threads, F f)
+    {
+      parallel_apply(default_scheduler(), n, threads, std::move(f));
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,131 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/concurrency/scheduler.hpp>
+#include <origin/instrument/trace.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Sum [first, last) by recursive fork-join.
+long
+sum(task_scheduler& s, long first, long last)
+{
+  if (last - first < 1000) {
+    long n = 0;
+    for (long i = first; i != last; ++i)
+      n += i;
+    return n;
+  }
+  long mid = first + (last - first) / 2;
+  long a = 0, b = 0;
+  fork_join(s, [&]() { a = sum(s, first, mid); },
+               [&]() { b = sum(s, mid, last); });
+  return a + b;
+}
+
+void
+check_scheduler(task_scheduler& s)
+{
+  assert(sum(s, 0, 1000000) == 999999L * 1000000 / 2);
+
+  // Integer positions.
+  vector<int> v(100000);
+  parallel_for(s, size_t(0), v.size(), 1000, [&](size_t i, size_t j) {
+    assert(j - i <= 1000);
+    for (; i != j; ++i)
+      ++v[i];
+  });
+  for (int x : v)
+    assert(x == 1);
+
+  // Iterator positions.
+  parallel_for(s, v.begin(), v.end(), 333, [](vector<int>::iterator i,
+                                              vector<int>::iterator j) {
+    for (; i != j; ++i)
+      ++*i;
+  });
+  for (int x : v)
+    assert(x == 2);
+
+  // Every call is made, and an exception is rethrown.
+  atomic<int> n(0);
+  parallel_apply(s, 100, 4, [&n](size_t i) { n += int(i); });
+  assert(n == 4950);
+  n = 0;
+  try {
+    parallel_apply(s, 100, 4, [&n](size_t i) {
+      ++n;
+      if (i == 50)
+        throw runtime_error("apply");
+    });
+    assert(false);
+  } catch (runtime_error&) { }
+  assert(n == 100);
+}
+
+// Tasks are recorded in the trace by the threads that run them, and the
+// workers are named.
+void
+check_trace()
+{
+  task_scheduler s(3);
+  start_trace();
+  assert(sum(s, 0, 100000) == 99999L * 100000 / 2);
+  stop_trace();
+
+  size_t tasks = 0;
+  for (const trace_thread& t : trace_snapshot()) {
+    assert(t.name.empty() || t.name.compare(0, 7, "worker ") == 0);
+    int depth = 0;
+    for (const trace_event& e : t.events) {
+      if (strcmp(e.name, "task") != 0)
+        continue;
+      if (e.phase == trace_phase::begin) {
+        ++tasks;
+        ++depth;
+      } else {
+        assert(depth-- > 0);
+      }
+    }
+    assert(depth == 0);
+  }
+  assert(tasks > 0);
+  clear_trace();
+}
+
+int main()
+{
+  // The default scheduler is configured before its first use.
+  assert(configure_default_scheduler(3));
+  assert(default_scheduler().size() == 3);
+  assert(!configure_default_scheduler(2));
+  check_scheduler(default_scheduler());
+
+  task_scheduler one(1);
+  check_scheduler(one);
+
+  task_scheduler pinned(4, thread_pinning::compact);
+  check_scheduler(pinned);
+
+  // Tasks spawned by tasks of another scheduler.
+  task_scheduler other(2);
+  task_group g(other);
+  atomic<long> total(0);
+  for (int i = 0; i != 8; ++i)
+    g.run([&]() { total += sum(pinned, 0, 10000); });
+  g.wait();
+  assert(total == 8 * (9999L * 10000 / 2));
+
+  check_trace();
+}
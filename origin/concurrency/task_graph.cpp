@@ -0,0 +1,109 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <stdexcept>
+
+#include "task_graph.hpp"
+
+namespace origin
+{
+  void
+  task_graph::precede(task a, task b)
+  {
+    nodes_[a].succs.push_back(b);
+    ++nodes_[b].preds;
+  }
+
+  void
+  task_graph::precede(task a, std::initializer_list<task> bs)
+  {
+    for (task b : bs)
+      precede(a, b);
+  }
+
+  void
+  task_graph::precede(std::initializer_list<task> as, task b)
+  {
+    for (task a : as)
+      precede(a, b);
+  }
+
+  // The graph is acyclic if a topological sort (Kahn's algorithm) reaches
+  // every task.
+  bool
+  task_graph::acyclic() const
+  {
+    std::size_t n = nodes_.size();
+    std::vector<std::size_t> preds(n);
+    std::vector<task> ready;
+    for (task t = 0; t != n; ++t)
+      if ((preds[t] = nodes_[t].preds) == 0)
+        ready.push_back(t);
+    std::size_t reached = 0;
+    while (!ready.empty()) {
+      task t = ready.back();
+      ready.pop_back();
+      ++reached;
+      for (task s : nodes_[t].succs)
+        if (--preds[s] == 0)
+          ready.push_back(s);
+    }
+    return reached == n;
+  }
+
+  void
+  task_graph::run(task_scheduler& s)
+  {
+    if (!acyclic())
+      throw std::invalid_argument("task graph has a cycle");
+
+    std::size_t n = nodes_.size();
+    execution e(s, n);
+    for (task t = 0; t != n; ++t)
+      e.pending[t].store(nodes_[t].preds, std::memory_order_relaxed);
+    for (task t = 0; t != n; ++t)
+      if (nodes_[t].preds == 0)
+        e.group.run([this, &e, t]() { execute(e, t); });
+    e.group.wait();
+    if (e.error)
+      std::rethrow_exception(e.error);
+  }
+
+  // Run the task t, then a successor that it makes ready, and so on,
+  // spawning the other successors that become ready. The decrement of a
+  // successor's count is an acquire and release, so that a successor sees
+  // the effects of all of its predecessors.
+  void
+  task_graph::execute(execution& e, task t)
+  {
+    const std::size_t none = std::size_t(-1);
+    while (t != none) {
+      if (!e.failed.load(std::memory_order_relaxed)) {
+        try {
+          nodes_[t].fn();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(e.m);
+          if (!e.error)
+            e.error = std::current_exception();
+          e.failed.store(true, std::memory_order_relaxed);
+        }
+      }
+
+      task next = none;
+      for (task s : nodes_[t].succs) {
+        if (e.pending[s].fetch_sub(1, std::memory_order_acq_rel) != 1)
+          continue;
+        if (next == none)
+          next = s;
+        else
+          e.group.run([this, &e, s]() { execute(e, s); });
+      }
+      t = next;
+    }
+  }
+
+} // namespace origin
@@ -0,0 +1,128 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_CONCURRENCY_TASK_GRAPH_HPP
+#define ORIGIN_CONCURRENCY_TASK_GRAPH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <origin/concurrency/scheduler.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                 [conc.flow]
+  //                              Task Graphs
+  //
+  // A task graph is a directed acyclic graph of tasks, in which an edge from
+  // a task a to a task b says that a must complete before b starts. Tasks
+  // that are not ordered by the graph may run at the same time. A graph is
+  // built once and may be run any number of times. For example:
+  //
+  //    task_graph g;
+  //    auto load = g.add([&]() { csr = load_csr(file); });
+  //    auto cc = g.add([&]() { components = connected_components(csr); });
+  //    auto pr = g.add([&]() { ranks = page_rank(csr); });
+  //    auto kc = g.add([&]() { cores = core_numbers(csr); });
+  //    auto done = g.add([&]() { report(components, ranks, cores); });
+  //    g.precede(load, {cc, pr, kc});
+  //    g.precede({cc, pr, kc}, done);
+  //    g.run();
+  //
+  // A run counts the predecessors of each task that have not completed.
+  // The tasks without predecessors are spawned on the scheduler (see
+  // [conc.sched]); when a task completes, the counts of its successors are
+  // decremented, and each that reaches zero is ready. The completing thread
+  // continues with one of the ready successors itself, and spawns the
+  // others so that idle workers can steal them. A chain of tasks therefore
+  // runs on one thread, with its data in that thread's cache, while the
+  // branches of the graph spread over the workers.
+  //
+  // If a task throws an exception, the tasks that have not started when it
+  // is thrown are skipped, and the exception is rethrown by run. A run of a
+  // graph that has a cycle throws invalid_argument before any task starts.
+  class task_graph
+  {
+  public:
+    // The handle of a task in the graph.
+    using task = std::size_t;
+
+    task_graph() = default;
+
+    task_graph(const task_graph&) = delete;
+    task_graph& operator=(const task_graph&) = delete;
+
+    // Returns the number of tasks in the graph.
+    std::size_t size() const { return nodes_.size(); }
+
+    // Add a task that calls f(), and return its handle.
+    template<typename F>
+      task add(F f)
+      {
+        nodes_.push_back(node {std::function<void()>(std::move(f)), {}, 0});
+        return nodes_.size() - 1;
+      }
+
+    // Require that the task a completes before the task b starts.
+    void precede(task a, task b);
+
+    // Require that a completes before each task of bs starts, or each task
+    // of as completes before b starts.
+    void precede(task a, std::initializer_list<task> bs);
+    void precede(std::initializer_list<task> as, task b);
+
+    // Returns the number of tasks that must complete before the task t
+    // starts, and the tasks that wait for t.
+    std::size_t predecessors(task t) const { return nodes_[t].preds; }
+    const std::vector<task>& successors(task t) const
+    {
+      return nodes_[t].succs;
+    }
+
+    // Run the tasks of the graph on the scheduler s, and wait for them to
+    // complete.
+    void run(task_scheduler& s = default_scheduler());
+
+  private:
+    struct node
+    {
+      std::function<void()> fn;
+      std::vector<task>     succs;
+      std::size_t           preds;
+    };
+
+    // The state of a run.
+    struct execution
+    {
+      execution(task_scheduler& s, std::size_t n)
+        : group(s), pending(new std::atomic<std::size_t>[n]), failed(false)
+      { }
+
+      task_group group;
+      std::unique_ptr<std::atomic<std::size_t>[]> pending;
+      std::atomic<bool> failed;
+      std::mutex m;
+      std::exception_ptr error;
+    };
+
+    bool acyclic() const;
+    void execute(execution& e, task t);
+
+  private:
+    std::vector<node> nodes_;
+  };
+
+} // namespace origin
+
+#endif
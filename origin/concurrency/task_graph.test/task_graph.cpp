@@ -0,0 +1,133 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/concurrency/task_graph.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Each task starts after its predecessors complete.
+void
+check_order(task_scheduler& s)
+{
+  atomic<int> clock(0);
+  vector<int> start(6, -1), finish(6, -1);
+  task_graph g;
+  auto stamp = [&](int i) {
+    return [&, i]() {
+      start[i] = clock++;
+      finish[i] = clock++;
+    };
+  };
+  auto load = g.add(stamp(0));
+  auto a = g.add(stamp(1));
+  auto b = g.add(stamp(2));
+  auto c = g.add(stamp(3));
+  auto join = g.add(stamp(4));
+  auto other = g.add(stamp(5));
+  g.precede(load, {a, b, c});
+  g.precede({a, b, c}, join);
+  assert(g.size() == 6);
+  assert(g.predecessors(join) == 3);
+  assert(g.successors(load).size() == 3);
+  assert(g.predecessors(other) == 0);
+
+  for (int run = 0; run != 3; ++run) {
+    g.run(s);
+    for (task_graph::task t : {a, b, c}) {
+      assert(start[t] > finish[load]);
+      assert(start[join] > finish[t]);
+    }
+    assert(finish[other] >= 0);
+  }
+}
+
+// A long chain and a wide fan.
+void
+check_shapes(task_scheduler& s)
+{
+  task_graph g;
+  int n = 0;
+  task_graph::task prev = g.add([&n]() { ++n; });
+  for (int i = 1; i != 100000; ++i) {
+    task_graph::task t = g.add([&n]() { ++n; });
+    g.precede(prev, t);
+    prev = t;
+  }
+  g.run(s);
+  assert(n == 100000);
+
+  task_graph f;
+  atomic<int> m(0);
+  auto root = f.add([]() { });
+  auto sink = f.add([&m]() { assert(m == 1000); });
+  for (int i = 0; i != 1000; ++i) {
+    auto t = f.add([&m]() { ++m; });
+    f.precede(root, t);
+    f.precede(t, sink);
+  }
+  f.run(s);
+  assert(m == 1000);
+
+  // Tasks may run graphs of their own.
+  task_graph outer;
+  atomic<int> k(0);
+  for (int i = 0; i != 4; ++i)
+    outer.add([&]() {
+      task_graph inner;
+      auto x = inner.add([&k]() { ++k; });
+      auto y = inner.add([&k]() { ++k; });
+      inner.precede(x, y);
+      inner.run(s);
+    });
+  outer.run(s);
+  assert(k == 8);
+}
+
+// Tasks that have not started when a task throws are skipped, and a cycle
+// is rejected.
+void
+check_errors(task_scheduler& s)
+{
+  task_graph g;
+  bool ran = false;
+  auto a = g.add([]() { throw runtime_error("task"); });
+  auto b = g.add([&ran]() { ran = true; });
+  g.precede(a, b);
+  try {
+    g.run(s);
+    assert(false);
+  } catch (runtime_error&) { }
+  assert(!ran);
+
+  task_graph c;
+  auto x = c.add([]() { });
+  auto y = c.add([]() { });
+  c.precede(x, y);
+  c.precede(y, x);
+  try {
+    c.run(s);
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+int main()
+{
+  task_scheduler s(4);
+  check_order(s);
+  check_shapes(s);
+  check_errors(s);
+
+  task_scheduler one(1);
+  check_order(one);
+  check_shapes(one);
+}
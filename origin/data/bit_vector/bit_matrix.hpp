@@ -0,0 +1,558 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_BIT_VECTOR_BIT_MATRIX_HPP
+#define ORIGIN_DATA_BIT_VECTOR_BIT_MATRIX_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <origin/data/bit_vector/bit_vector.hpp>
+
+namespace origin
+{
+  namespace bit_matrix_impl
+  {
+    using bit_vector_impl::word;
+    using bit_vector_impl::word_bits;
+
+    // Transpose the 64 x 64 block of bits a in place, where bit j of a[i]
+    // is the element (i, j). The quadrants of each power-of-two size are
+    // exchanged by masked shifts, from 32 down to 1.
+    inline void
+    transpose_block(word* a)
+    {
+      word m = 0x00000000ffffffffull;
+      for (std::size_t j = 32; j != 0; j >>= 1, m ^= m << j) {
+        for (std::size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+          word t = ((a[k] >> j) ^ a[k | j]) & m;
+          a[k] ^= t << j;
+          a[k | j] ^= t;
+        }
+      }
+    }
+
+    // Returns the number of set bits in a[i] & b[i] for each i in [0, n).
+    inline std::size_t
+    count_and(const word* a, const word* b, std::size_t n)
+    {
+      std::size_t c = 0;
+      for (std::size_t i = 0; i != n; ++i)
+        c += bit_vector_impl::count_bits(a[i] & b[i]);
+      return c;
+    }
+
+    // The four Russians product uses tables of all the combinations of 8
+    // rows of the right operand.
+    constexpr std::size_t group_bits = 8;
+
+    // The tables cover panels of at most 64 words (4096 columns), so that a
+    // table fits in 128 KiB.
+    constexpr std::size_t panel_words = 64;
+
+  } // namespace bit_matrix_impl
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Bit Matrix                                                 data.bit_matrix
+  //
+  // A bit matrix is a rows x cols matrix of bits, packed 64 to a word by
+  // rows, which is 8 times smaller than a matrix of bool. It is the
+  // adjacency matrix of a dense relation: the edges of a graph for
+  // reachability and transitive closure, or a set of sets.
+  //
+  // Each row starts at a word, so that a row is a bit vector, and the bits
+  // beyond cols() in the last word of a row are always clear. The
+  // operations work a word at a time, as for bit_vector:
+  //
+  //    - a &= b, a |= b, a ^= b and a -= b combine matrices of the same
+  //      extents, 2 or 4 words per instruction with SSE2 or AVX2,
+  //    - row_or(i, j), row_and(i, j), row_xor(i, j) and row_or(i, x) combine
+  //      rows, so that the row of a vertex can absorb that of its neighbor,
+  //    - count(), row_count(i) and common(i, j) count set bits (and the set
+  //      bits of the intersection of two rows, such as common neighbors)
+  //      with a population count instruction, and
+  //    - find(i, n) returns the least set bit of row i not less than n.
+  //
+  // The boolean product a * b, in which the element (i, j) is the OR over k
+  // of a(i, k) AND b(k, j), uses the method of the four Russians. The rows
+  // of b are divided into groups of 8, and for each group, a table of the
+  // ORs of all 256 combinations of its rows is built with one row operation
+  // per entry. Each row of the product then ORs in the entry selected by
+  // the 8 bits of the row of a over the group. This takes n^3 / (8 * 64)
+  // word operations for n x n matrices, against n^3 for a product of
+  // matrices of bool. The columns are divided into panels so that the
+  // tables remain in cache.
+  //
+  // The transitive closure uses Warshall's algorithm on rows: for each k,
+  // each row i that reaches k absorbs row k, in n^3 / 64 word operations.
+  class bit_matrix
+  {
+    using word = bit_vector_impl::word;
+    static constexpr std::size_t bits = bit_vector_impl::word_bits;
+  public:
+    using word_type = word;
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = -1;
+
+    bit_matrix()
+      : rows_(0), cols_(0), stride_(0)
+    { }
+
+    // Construct a rows x cols matrix of copies of the bit x.
+    bit_matrix(size_type rows, size_type cols, bool x = false)
+      : words_(rows * words(cols)),
+        rows_(rows), cols_(cols), stride_(words(cols))
+    {
+      if (x)
+        set();
+    }
+
+    // Construct a matrix from rows of bits, which must have equal lengths.
+    bit_matrix(std::initializer_list<std::initializer_list<bool>> list);
+
+    // Returns the n x n identity matrix.
+    static bit_matrix identity(size_type n);
+
+    // Extents
+    size_type rows() const { return rows_; }
+    size_type cols() const { return cols_; }
+    size_type size() const { return rows_ * cols_; }
+    bool empty() const { return size() == 0; }
+
+    // Returns the memory footprint of the matrix.
+    memory_footprint memory_usage() const
+    {
+      return contiguous_footprint(words_);
+    }
+
+    // Returns the words of the matrix. Row i is the row_words() words
+    // starting at row_data(i); bit j of the row is in its word j / 64.
+    size_type row_words() const { return stride_; }
+    word* row_data(size_type i) { return words_.data() + i * stride_; }
+    const word* row_data(size_type i) const
+    {
+      return words_.data() + i * stride_;
+    }
+
+    // Element access
+    bool test(size_type i, size_type j) const;
+    bool operator()(size_type i, size_type j) const { return test(i, j); }
+
+    void set(size_type i, size_type j);
+    void set(size_type i, size_type j, bool x)
+    {
+      x ? set(i, j) : reset(i, j);
+    }
+    void reset(size_type i, size_type j);
+    void flip(size_type i, size_type j);
+
+    // Set, clear or flip every bit.
+    void set();
+    void reset();
+    void flip();
+
+    // Row operations
+    //
+    // Assign row(i) op row(j) to row i, or for row_or(i, x), row(i) | x,
+    // where x has cols() bits.
+    void row_or(size_type i, size_type j);
+    void row_and(size_type i, size_type j);
+    void row_xor(size_type i, size_type j);
+    void row_or(size_type i, const bit_vector& x);
+
+    // Returns the number of set bits in row i.
+    size_type row_count(size_type i) const;
+
+    // Returns the number of set bits in both rows i and j.
+    size_type common(size_type i, size_type j) const;
+
+    // Returns the least set bit of row i not less than n, or npos if there
+    // is none.
+    size_type find(size_type i, size_type n) const;
+
+    // Returns row i as a bit vector.
+    bit_vector row(size_type i) const;
+
+    // Returns the number of set bits.
+    size_type count() const;
+
+    bool any() const;
+    bool none() const { return !any(); }
+
+    // Bulk operations
+    bit_matrix& operator&=(const bit_matrix& x);
+    bit_matrix& operator|=(const bit_matrix& x);
+    bit_matrix& operator^=(const bit_matrix& x);
+    bit_matrix& operator-=(const bit_matrix& x);
+
+    void swap(bit_matrix& x)
+    {
+      words_.swap(x.words_);
+      std::swap(rows_, x.rows_);
+      std::swap(cols_, x.cols_);
+      std::swap(stride_, x.stride_);
+    }
+
+    bool operator==(const bit_matrix& x) const
+    {
+      return rows_ == x.rows_ && cols_ == x.cols_ && words_ == x.words_;
+    }
+
+    bool operator!=(const bit_matrix& x) const { return !(*this == x); }
+
+  private:
+    // Returns the number of words holding n bits.
+    static size_type words(size_type n) { return (n + bits - 1) / bits; }
+
+    static word mask(size_type n) { return word(1) << (n % bits); }
+
+    // Clear the bits beyond cols() in the last word of each row.
+    void trim();
+
+    template <typename Op>
+      bit_matrix& apply(const bit_matrix& x, Op op);
+
+  private:
+    std::vector<word> words_; // The rows, each starting at a word
+    size_type rows_;
+    size_type cols_;
+    size_type stride_;        // The number of words in a row
+  };
+
+  inline
+  bit_matrix::bit_matrix(
+      std::initializer_list<std::initializer_list<bool>> list)
+    : bit_matrix(list.size(), list.size() ? list.begin()->size() : 0)
+  {
+    size_type i = 0;
+    for (const auto& r : list) {
+      assert(r.size() == cols_);
+      size_type j = 0;
+      for (bool x : r) {
+        if (x)
+          set(i, j);
+        ++j;
+      }
+      ++i;
+    }
+  }
+
+  inline bit_matrix
+  bit_matrix::identity(size_type n)
+  {
+    bit_matrix m(n, n);
+    for (size_type i = 0; i != n; ++i)
+      m.set(i, i);
+    return m;
+  }
+
+  inline bool
+  bit_matrix::test(size_type i, size_type j) const
+  {
+    assert(i < rows_ && j < cols_);
+    return row_data(i)[j / bits] & mask(j);
+  }
+
+  inline void
+  bit_matrix::set(size_type i, size_type j)
+  {
+    assert(i < rows_ && j < cols_);
+    row_data(i)[j / bits] |= mask(j);
+  }
+
+  inline void
+  bit_matrix::reset(size_type i, size_type j)
+  {
+    assert(i < rows_ && j < cols_);
+    row_data(i)[j / bits] &= ~mask(j);
+  }
+
+  inline void
+  bit_matrix::flip(size_type i, size_type j)
+  {
+    assert(i < rows_ && j < cols_);
+    row_data(i)[j / bits] ^= mask(j);
+  }
+
+  inline void
+  bit_matrix::set()
+  {
+    for (word& w : words_)
+      w = ~word(0);
+    trim();
+  }
+
+  inline void
+  bit_matrix::reset()
+  {
+    for (word& w : words_)
+      w = 0;
+  }
+
+  inline void
+  bit_matrix::flip()
+  {
+    for (word& w : words_)
+      w = ~w;
+    trim();
+  }
+
+  inline void
+  bit_matrix::row_or(size_type i, size_type j)
+  {
+    assert(i < rows_ && j < rows_);
+    bit_vector_impl::apply(row_data(i), row_data(j), stride_,
+                           bit_vector_impl::or_op());
+  }
+
+  inline void
+  bit_matrix::row_and(size_type i, size_type j)
+  {
+    assert(i < rows_ && j < rows_);
+    bit_vector_impl::apply(row_data(i), row_data(j), stride_,
+                           bit_vector_impl::and_op());
+  }
+
+  inline void
+  bit_matrix::row_xor(size_type i, size_type j)
+  {
+    assert(i < rows_ && j < rows_);
+    bit_vector_impl::apply(row_data(i), row_data(j), stride_,
+                           bit_vector_impl::xor_op());
+  }
+
+  inline void
+  bit_matrix::row_or(size_type i, const bit_vector& x)
+  {
+    assert(i < rows_ && x.size() == cols_);
+    bit_vector_impl::apply(row_data(i), x.data(), stride_,
+                           bit_vector_impl::or_op());
+  }
+
+  inline bit_matrix::size_type
+  bit_matrix::row_count(size_type i) const
+  {
+    assert(i < rows_);
+    const word* r = row_data(i);
+    size_type n = 0;
+    for (size_type k = 0; k != stride_; ++k)
+      n += bit_vector_impl::count_bits(r[k]);
+    return n;
+  }
+
+  inline bit_matrix::size_type
+  bit_matrix::common(size_type i, size_type j) const
+  {
+    assert(i < rows_ && j < rows_);
+    return bit_matrix_impl::count_and(row_data(i), row_data(j), stride_);
+  }
+
+  inline bit_matrix::size_type
+  bit_matrix::find(size_type i, size_type n) const
+  {
+    assert(i < rows_);
+    size_type w = n / bits;
+    if (w >= stride_)
+      return npos;
+    const word* r = row_data(i);
+    word x = r[w] & (~word(0) << (n % bits));
+    while (x == 0) {
+      if (++w == stride_)
+        return npos;
+      x = r[w];
+    }
+    return w * bits + bit_vector_impl::lowest_bit(x);
+  }
+
+  inline bit_vector
+  bit_matrix::row(size_type i) const
+  {
+    assert(i < rows_);
+    bit_vector v(cols_);
+    for (size_type j = find(i, 0); j != npos; j = find(i, j + 1))
+      v.set(j);
+    return v;
+  }
+
+  inline bit_matrix::size_type
+  bit_matrix::count() const
+  {
+    size_type n = 0;
+    for (word w : words_)
+      n += bit_vector_impl::count_bits(w);
+    return n;
+  }
+
+  inline bool
+  bit_matrix::any() const
+  {
+    for (word w : words_)
+      if (w)
+        return true;
+    return false;
+  }
+
+  template <typename Op>
+    inline bit_matrix&
+    bit_matrix::apply(const bit_matrix& x, Op op)
+    {
+      assert(rows_ == x.rows_ && cols_ == x.cols_);
+      bit_vector_impl::apply(words_.data(), x.words_.data(), words_.size(), op);
+      return *this;
+    }
+
+  inline bit_matrix&
+  bit_matrix::operator&=(const bit_matrix& x)
+  {
+    return apply(x, bit_vector_impl::and_op());
+  }
+
+  inline bit_matrix&
+  bit_matrix::operator|=(const bit_matrix& x)
+  {
+    return apply(x, bit_vector_impl::or_op());
+  }
+
+  inline bit_matrix&
+  bit_matrix::operator^=(const bit_matrix& x)
+  {
+    return apply(x, bit_vector_impl::xor_op());
+  }
+
+  inline bit_matrix&
+  bit_matrix::operator-=(const bit_matrix& x)
+  {
+    return apply(x, bit_vector_impl::andnot_op());
+  }
+
+  inline void
+  bit_matrix::trim()
+  {
+    if (cols_ % bits != 0) {
+      word m = ~(~word(0) << (cols_ % bits));
+      for (size_type i = 0; i != rows_; ++i)
+        row_data(i)[stride_ - 1] &= m;
+    }
+  }
+
+  inline bit_matrix
+  operator&(bit_matrix a, const bit_matrix& b) { return a &= b; }
+
+  inline bit_matrix
+  operator|(bit_matrix a, const bit_matrix& b) { return a |= b; }
+
+  inline bit_matrix
+  operator^(bit_matrix a, const bit_matrix& b) { return a ^= b; }
+
+  inline bit_matrix
+  operator-(bit_matrix a, const bit_matrix& b) { return a -= b; }
+
+  inline void
+  swap(bit_matrix& a, bit_matrix& b)
+  {
+    a.swap(b);
+  }
+
+
+  // Returns the transpose of m, computed in blocks of 64 x 64 bits.
+  inline bit_matrix
+  transpose(const bit_matrix& m)
+  {
+    using bit_matrix_impl::word;
+    const std::size_t bits = bit_matrix_impl::word_bits;
+    bit_matrix t(m.cols(), m.rows());
+    word block[64];
+    for (std::size_t bi = 0; bi < m.rows(); bi += bits) {
+      std::size_t nr = std::min(bits, m.rows() - bi);
+      for (std::size_t bj = 0; bj != m.row_words(); ++bj) {
+        for (std::size_t r = 0; r != bits; ++r)
+          block[r] = r < nr ? m.row_data(bi + r)[bj] : 0;
+        bit_matrix_impl::transpose_block(block);
+        std::size_t nc = std::min(bits, m.cols() - bj * bits);
+        for (std::size_t c = 0; c != nc; ++c)
+          t.row_data(bj * bits + c)[bi / bits] = block[c];
+      }
+    }
+    return t;
+  }
+
+
+  // Compute c |= a * b, the boolean product of a and b, where a is n x k,
+  // b is k x m and c is n x m.
+  inline void
+  bit_product(const bit_matrix& a, const bit_matrix& b, bit_matrix& c)
+  {
+    using namespace bit_matrix_impl;
+    assert(a.cols() == b.rows());
+    assert(c.rows() == a.rows() && c.cols() == b.cols());
+    const std::size_t stride = b.row_words();
+    const std::size_t entries = std::size_t(1) << group_bits;
+    std::vector<word> table(entries * std::min(stride, panel_words));
+
+    for (std::size_t p = 0; p < stride; p += panel_words) {
+      const std::size_t pw = std::min(panel_words, stride - p);
+      for (std::size_t k = 0; k < b.rows(); k += group_bits) {
+        // Build the table of the group: entry x is the OR of the rows of b
+        // whose bits are set in x, and extends the entry without the least
+        // of those bits.
+        const std::size_t g = std::min(group_bits, b.rows() - k);
+        const std::size_t n = std::size_t(1) << g;
+        std::fill_n(table.begin(), pw, word(0));
+        for (std::size_t x = 1; x != n; ++x) {
+          word* e = table.data() + x * pw;
+          std::copy_n(table.data() + (x & (x - 1)) * pw, pw, e);
+          std::size_t r = k + bit_vector_impl::lowest_bit(x);
+          bit_vector_impl::apply(e, b.row_data(r) + p, pw,
+                                 bit_vector_impl::or_op());
+        }
+
+        // Each row of c absorbs the entry selected by its row of a.
+        const std::size_t w = k / word_bits;
+        const std::size_t s = k % word_bits;
+        for (std::size_t i = 0; i != a.rows(); ++i) {
+          std::size_t x = (a.row_data(i)[w] >> s) & (n - 1);
+          if (x != 0)
+            bit_vector_impl::apply(c.row_data(i) + p, table.data() + x * pw,
+                                   pw, bit_vector_impl::or_op());
+        }
+      }
+    }
+  }
+
+  // Returns the boolean product of a and b.
+  inline bit_matrix
+  operator*(const bit_matrix& a, const bit_matrix& b)
+  {
+    bit_matrix c(a.rows(), b.cols());
+    bit_product(a, b, c);
+    return c;
+  }
+
+
+  // Returns the transitive closure of the square matrix m: the element
+  // (i, j) is set if there is a path of one or more steps from i to j in
+  // the relation m.
+  inline bit_matrix
+  transitive_closure(bit_matrix m)
+  {
+    assert(m.rows() == m.cols());
+    for (std::size_t k = 0; k != m.rows(); ++k)
+      for (std::size_t i = 0; i != m.rows(); ++i)
+        if (m.test(i, k))
+          m.row_or(i, k);
+    return m;
+  }
+
+} // namespace origin
+
+#endif
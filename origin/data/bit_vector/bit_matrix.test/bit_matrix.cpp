@@ -0,0 +1,197 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+
+#include <cassert>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/data/bit_vector/bit_matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using bools = vector<vector<bool>>;
+
+// Returns a matrix of random bits, each set with probability 1 / d, and its
+// copy in v.
+bit_matrix random_bits(size_t r, size_t c, size_t d, bools& v,
+                       minstd_rand& gen)
+{
+  bit_matrix m(r, c);
+  v.assign(r, vector<bool>(c));
+  for (size_t i = 0; i != r; ++i)
+    for (size_t j = 0; j != c; ++j)
+      if (gen() % d == 0) {
+        m.set(i, j);
+        v[i][j] = true;
+      }
+  return m;
+}
+
+bool same(const bit_matrix& m, const bools& v)
+{
+  if (m.rows() != v.size())
+    return false;
+  for (size_t i = 0; i != v.size(); ++i) {
+    if (m.cols() != v[i].size())
+      return false;
+    for (size_t j = 0; j != v[i].size(); ++j)
+      if (m(i, j) != v[i][j])
+        return false;
+  }
+  return true;
+}
+
+void check_access()
+{
+  bit_matrix m(3, 70);
+  assert(m.rows() == 3 && m.cols() == 70 && m.row_words() == 2);
+  assert(m.none() && m.count() == 0);
+  m.set(0, 0);
+  m.set(1, 64);
+  m.set(2, 69);
+  assert(m.test(1, 64) && !m.test(1, 63) && m.count() == 3);
+  m.flip(1, 64);
+  m.reset(0, 0);
+  assert(m.count() == 1 && m.row_count(2) == 1);
+
+  // The bits beyond the columns remain clear.
+  m.set();
+  assert(m.count() == 210 && m.row_count(1) == 70);
+  m.flip();
+  assert(m.none());
+
+  bit_matrix c {{true, false, true},
+                {false, true, false}};
+  assert(c.rows() == 2 && c.cols() == 3 && c.count() == 3);
+  assert(c(0, 2) && !c(1, 2));
+  assert(c.row(0) == bit_vector({true, false, true}));
+  assert(c.find(0, 1) == 2 && c.find(1, 2) == bit_matrix::npos);
+
+  bit_matrix i = bit_matrix::identity(100);
+  assert(i.count() == 100 && i(99, 99) && !i(98, 99));
+}
+
+// The row and bulk operations agree with those on each bit.
+void check_rows()
+{
+  minstd_rand gen;
+  for (size_t c : {1, 63, 64, 65, 200, 257}) {
+    bools v;
+    bit_matrix m = random_bits(4, c, 3, v, gen);
+
+    size_t n = 0;
+    for (size_t j = 0; j != c; ++j)
+      n += v[0][j] && v[1][j];
+    assert(m.common(0, 1) == n);
+
+    bit_matrix x = m;
+    x.row_or(0, 1);
+    x.row_and(2, 3);
+    x.row_xor(3, 1);
+    bit_vector r(c);
+    r.set(c - 1);
+    x.row_or(1, r);
+    for (size_t j = 0; j != c; ++j) {
+      assert(x(0, j) == (v[0][j] || v[1][j]));
+      assert(x(1, j) == (v[1][j] || j == c - 1));
+      assert(x(2, j) == (v[2][j] && v[3][j]));
+      assert(x(3, j) == (v[3][j] != v[1][j]));
+    }
+
+    bools u;
+    bit_matrix b = random_bits(4, c, 2, u, gen);
+    bools w = v;
+    for (size_t i = 0; i != 4; ++i)
+      for (size_t j = 0; j != c; ++j)
+        w[i][j] = v[i][j] && !u[i][j];
+    assert(same(m - b, w));
+    for (size_t i = 0; i != 4; ++i)
+      for (size_t j = 0; j != c; ++j)
+        w[i][j] = v[i][j] != u[i][j];
+    assert(same(m ^ b, w));
+    assert((m | b).count() + (m & b).count() == m.count() + b.count());
+  }
+}
+
+void check_transpose()
+{
+  minstd_rand gen;
+  for (auto e : {make_pair(1, 1), make_pair(64, 64), make_pair(70, 130),
+                 make_pair(200, 3)}) {
+    bools v;
+    bit_matrix m = random_bits(e.first, e.second, 3, v, gen);
+    bit_matrix t = transpose(m);
+    assert(t.rows() == m.cols() && t.cols() == m.rows());
+    for (size_t i = 0; i != m.rows(); ++i)
+      for (size_t j = 0; j != m.cols(); ++j)
+        assert(t(j, i) == m(i, j));
+    assert(transpose(t) == m);
+  }
+}
+
+// The four Russians product agrees with the product of each bit, for
+// extents that end in partial groups, words and panels.
+void check_product()
+{
+  minstd_rand gen;
+  for (auto e : {make_tuple(1, 1, 1), make_tuple(10, 13, 7),
+                 make_tuple(65, 130, 70), make_tuple(20, 30, 4200)}) {
+    size_t n = get<0>(e), k = get<1>(e), m = get<2>(e);
+    bools u, v;
+    bit_matrix a = random_bits(n, k, 9, u, gen);
+    bit_matrix b = random_bits(k, m, 9, v, gen);
+    bools w(n, vector<bool>(m));
+    for (size_t i = 0; i != n; ++i)
+      for (size_t l = 0; l != k; ++l)
+        if (u[i][l])
+          for (size_t j = 0; j != m; ++j)
+            w[i][j] = w[i][j] || v[l][j];
+    bit_matrix c = a * b;
+    assert(same(c, w));
+
+    // The product accumulates.
+    bit_product(a, b, c);
+    assert(same(c, w));
+  }
+}
+
+void check_closure()
+{
+  // A cycle of 100 vertices, and a tail of 50 leading into it.
+  bit_matrix g(150, 150);
+  for (size_t i = 0; i != 100; ++i)
+    g.set(i, (i + 1) % 100);
+  for (size_t i = 100; i != 149; ++i)
+    g.set(i, i + 1);
+  g.set(149, 0);
+
+  bit_matrix c = transitive_closure(g);
+  for (size_t i = 0; i != 150; ++i) {
+    assert(c.row_count(i) == (i < 100 ? 100 : 100 + 149 - i));
+    assert(c(i, 0));
+  }
+  assert(!c(0, 100) && c(100, 149) && !c(149, 100));
+
+  // The closure is the fixed point of squaring.
+  bit_matrix r = g | bit_matrix::identity(150);
+  for (size_t i = 0; i != 8; ++i)
+    r = r * r;
+  assert((c | bit_matrix::identity(150)) == r);
+}
+
+int main()
+{
+  check_access();
+  check_rows();
+  check_transpose();
+  check_product();
+  check_closure();
+}
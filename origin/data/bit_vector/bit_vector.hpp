@@ -0,0 +1,679 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_BIT_VECTOR_BIT_VECTOR_HPP
+#define ORIGIN_DATA_BIT_VECTOR_BIT_VECTOR_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#if defined(__AVX2__) || defined(__BMI2__)
+#  include <immintrin.h>
+#endif
+
+#include <origin/memory/concepts.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  namespace bit_vector_impl
+  {
+    using word = std::uint64_t;
+    constexpr std::size_t word_bits = 64;
+
+    // Returns the index of the least set bit of x, which must not be 0.
+    inline std::size_t
+    lowest_bit(word x)
+    {
+      assert(x != 0);
+#if defined(__GNUC__)
+      return __builtin_ctzll(x);
+#else
+      std::size_t n = 0;
+      for ( ; !(x & 1); x >>= 1)
+        ++n;
+      return n;
+#endif
+    }
+
+    // Returns the index of the greatest set bit of x, which must not be 0.
+    inline std::size_t
+    highest_bit(word x)
+    {
+      assert(x != 0);
+#if defined(__GNUC__)
+      return 63 - __builtin_clzll(x);
+#else
+      std::size_t n = 63;
+      for ( ; !(x >> 63); x <<= 1)
+        --n;
+      return n;
+#endif
+    }
+
+    // Returns the number of set bits in x.
+    inline std::size_t
+    count_bits(word x)
+    {
+#if defined(__GNUC__)
+      return __builtin_popcountll(x);
+#else
+      std::size_t n = 0;
+      for ( ; x; x &= x - 1)
+        ++n;
+      return n;
+#endif
+    }
+
+    // Returns the index of the set bit of x that has k set bits below it.
+    // There must be more than k set bits in x.
+    inline std::size_t
+    select_bit(word x, std::size_t k)
+    {
+      assert(k < count_bits(x));
+#if defined(__BMI2__)
+      return lowest_bit(_pdep_u64(word(1) << k, x));
+#else
+      std::size_t n = 0;
+      for (std::size_t c; k >= (c = count_bits(x & 0xff)); k -= c) {
+        x >>= 8;
+        n += 8;
+      }
+      for ( ; k != 0; --k)
+        x &= x - 1;
+      return n + lowest_bit(x);
+#endif
+    }
+
+    // The bitwise operations applied to whole bit vectors. Each is applied
+    // to a word, and to a vector register of words when there is one.
+    struct and_op
+    {
+      word operator()(word a, word b) const { return a & b; }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i a, __m128i b) const
+      {
+        return _mm_and_si128(a, b);
+      }
+#endif
+#if defined(__AVX2__)
+      __m256i operator()(__m256i a, __m256i b) const
+      {
+        return _mm256_and_si256(a, b);
+      }
+#endif
+    };
+
+    struct or_op
+    {
+      word operator()(word a, word b) const { return a | b; }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i a, __m128i b) const
+      {
+        return _mm_or_si128(a, b);
+      }
+#endif
+#if defined(__AVX2__)
+      __m256i operator()(__m256i a, __m256i b) const
+      {
+        return _mm256_or_si256(a, b);
+      }
+#endif
+    };
+
+    struct xor_op
+    {
+      word operator()(word a, word b) const { return a ^ b; }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i a, __m128i b) const
+      {
+        return _mm_xor_si128(a, b);
+      }
+#endif
+#if defined(__AVX2__)
+      __m256i operator()(__m256i a, __m256i b) const
+      {
+        return _mm256_xor_si256(a, b);
+      }
+#endif
+    };
+
+    // Computes a & ~b. Note that the vector instructions negate their first
+    // operand.
+    struct andnot_op
+    {
+      word operator()(word a, word b) const { return a & ~b; }
+#if defined(__SSE2__)
+      __m128i operator()(__m128i a, __m128i b) const
+      {
+        return _mm_andnot_si128(b, a);
+      }
+#endif
+#if defined(__AVX2__)
+      __m256i operator()(__m256i a, __m256i b) const
+      {
+        return _mm256_andnot_si256(b, a);
+      }
+#endif
+    };
+
+    // Assign op(a[i], b[i]) to a[i] for each i in [0, n).
+    template <typename Op>
+      void
+      apply(word* a, const word* b, std::size_t n, Op op)
+      {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for ( ; i + 4 <= n; i += 4) {
+          __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+          __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+          _mm256_storeu_si256((__m256i*)(a + i), op(x, y));
+        }
+#endif
+#if defined(__SSE2__)
+        for ( ; i + 2 <= n; i += 2) {
+          __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+          __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+          _mm_storeu_si128((__m128i*)(a + i), op(x, y));
+        }
+#endif
+        for ( ; i != n; ++i)
+          a[i] = op(a[i], b[i]);
+      }
+
+    // Atomic access to a word of a bit vector. The operations are relaxed:
+    // they order nothing but the accesses to the word itself.
+    inline word
+    atomic_load(const word& w)
+    {
+#if defined(__GNUC__)
+      return __atomic_load_n(&w, __ATOMIC_RELAXED);
+#else
+      return reinterpret_cast<const std::atomic<word>&>(w)
+        .load(std::memory_order_relaxed);
+#endif
+    }
+
+    inline word
+    atomic_or(word& w, word m)
+    {
+#if defined(__GNUC__)
+      return __atomic_fetch_or(&w, m, __ATOMIC_RELAXED);
+#else
+      return reinterpret_cast<std::atomic<word>&>(w)
+        .fetch_or(m, std::memory_order_relaxed);
+#endif
+    }
+
+    inline word
+    atomic_and(word& w, word m)
+    {
+#if defined(__GNUC__)
+      return __atomic_fetch_and(&w, m, __ATOMIC_RELAXED);
+#else
+      return reinterpret_cast<std::atomic<word>&>(w)
+        .fetch_and(m, std::memory_order_relaxed);
+#endif
+    }
+  } // namespace bit_vector_impl
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Bit Vector                                                 data.bit_vector
+  //
+  // A bit vector is a resizable sequence of bits, packed 64 to a word. It
+  // is the dense set of indexes used for the live slots of a pool, and the
+  // visited and frontier sets of a search.
+  //
+  // The operations on the whole vector work a word at a time:
+  //
+  //    - count() counts the set bits with a population count instruction,
+  //    - find(n) returns the least set bit not less than n, skipping 64
+  //      clear bits per word with a find-first-set instruction, and
+  //      find_first(), find_next(n) and rfind(n) are its variants, and
+  //    - a &= b, a |= b, a ^= b and a -= b (a and not b) combine vectors of
+  //      the same size, 2 or 4 words per instruction with SSE2 or AVX2.
+  //
+  // The bits beyond size() in the last word are always clear.
+  //
+  // The atomic operations atomic_test(n), atomic_set(n) and
+  // atomic_reset(n) may be called concurrently on any bits of the vector,
+  // including bits of the same word, as long as the vector is not resized.
+  // atomic_set(n) returns true if it set the bit, so that of several
+  // threads that reach a vertex, exactly one claims it. The operations are
+  // relaxed; a parallel algorithm orders its other accesses by the joins
+  // between its steps.
+  //
+  // Rank and select queries are answered by a separate index over the bits
+  // (see data.rank_select).
+  //
+  // The words are allocated by the allocator A, rebound to std::uint64_t;
+  // bit_vector allocates them from the global heap.
+  template <typename A = std::allocator<std::uint64_t>>
+    class basic_bit_vector
+    {
+      using word = bit_vector_impl::word;
+      static constexpr std::size_t bits = bit_vector_impl::word_bits;
+    public:
+      using word_type = word;
+      using size_type = std::size_t;
+      using allocator_type = A;
+
+      static constexpr size_type npos = -1;
+
+      basic_bit_vector()
+        : size_(0)
+      { }
+
+      explicit basic_bit_vector(const A& a)
+        : words_(word_allocator(a)), size_(0)
+      { }
+
+      // Construct a vector of n copies of the bit x.
+      explicit basic_bit_vector(size_type n, bool x = false,
+                                const A& a = A())
+        : words_(word_allocator(a)), size_(0)
+      {
+        resize(n, x);
+      }
+
+      basic_bit_vector(std::initializer_list<bool> list, const A& a = A())
+        : words_(word_allocator(a)), size_(0)
+      {
+        reserve(list.size());
+        for (bool x : list)
+          push_back(x);
+      }
+
+      // Returns the allocator of the vector.
+      A get_allocator() const { return A(words_.get_allocator()); }
+
+      // Returns the number of bits.
+      size_type size() const { return size_; }
+      bool empty() const { return size_ == 0; }
+
+      // Capacity
+      size_type capacity() const { return words_.capacity() * bits; }
+      void reserve(size_type n) { words_.reserve(words(n)); }
+      void shrink_to_fit() { words_.shrink_to_fit(); }
+
+      // Returns the memory footprint of the vector.
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(words_);
+      }
+
+      // Returns the words of the vector; bit n is in the word n / 64.
+      const word* data() const { return words_.data(); }
+      size_type word_count() const { return words_.size(); }
+
+      // Element access
+      bool test(size_type n) const;
+      bool operator[](size_type n) const { return test(n); }
+
+      void set(size_type n);
+      void set(size_type n, bool x) { x ? set(n) : reset(n); }
+      void reset(size_type n);
+      void flip(size_type n);
+
+      // Set, clear or flip every bit.
+      void set();
+      void reset();
+      void flip();
+
+      // Atomic element access
+      bool atomic_test(size_type n) const;
+      bool atomic_set(size_type n);
+      bool atomic_reset(size_type n);
+
+      // Append the bit x, which is 0 by default.
+      void push_back(bool x = false);
+      void pop_back();
+
+      void resize(size_type n, bool x = false);
+      void clear();
+
+      // Returns the number of set bits.
+      size_type count() const;
+
+      bool any() const;
+      bool none() const { return !any(); }
+
+      // Returns the least set bit not less than n, or npos if there is none.
+      size_type find(size_type n) const;
+
+      size_type find_first() const { return find(0); }
+
+      // Returns the least set bit greater than n, or npos.
+      size_type find_next(size_type n) const
+      {
+        return n == npos ? npos : find(n + 1);
+      }
+
+      // Returns the greatest set bit not greater than n, or npos if there is
+      // none.
+      size_type rfind(size_type n) const;
+
+      // Bulk operations
+      basic_bit_vector& operator&=(const basic_bit_vector& x);
+      basic_bit_vector& operator|=(const basic_bit_vector& x);
+      basic_bit_vector& operator^=(const basic_bit_vector& x);
+      basic_bit_vector& operator-=(const basic_bit_vector& x);
+
+      void swap(basic_bit_vector& x)
+      {
+        words_.swap(x.words_);
+        std::swap(size_, x.size_);
+      }
+
+      bool operator==(const basic_bit_vector& x) const
+      {
+        return size_ == x.size_ && words_ == x.words_;
+      }
+
+      bool operator!=(const basic_bit_vector& x) const { return !(*this == x); }
+
+    private:
+      // Returns the number of words holding n bits.
+      static size_type words(size_type n) { return (n + bits - 1) / bits; }
+
+      static word mask(size_type n) { return word(1) << (n % bits); }
+
+      // Clear the bits beyond the size in the last word.
+      void trim();
+
+      template <typename Op>
+        basic_bit_vector& apply(const basic_bit_vector& x, Op op);
+
+    private:
+      using word_allocator = Rebind_allocator<A, word>;
+
+      std::vector<word, word_allocator> words_; // One bit for each index
+      size_type size_;                          // The number of bits
+    };
+
+  template <typename A>
+    constexpr typename basic_bit_vector<A>::size_type
+    basic_bit_vector<A>::npos;
+
+  using bit_vector = basic_bit_vector<>;
+
+  template <typename A>
+    inline bool
+    basic_bit_vector<A>::test(size_type n) const
+    {
+      assert(n < size_);
+      return words_[n / bits] & mask(n);
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::set(size_type n)
+    {
+      assert(n < size_);
+      words_[n / bits] |= mask(n);
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::reset(size_type n)
+    {
+      assert(n < size_);
+      words_[n / bits] &= ~mask(n);
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::flip(size_type n)
+    {
+      assert(n < size_);
+      words_[n / bits] ^= mask(n);
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::set()
+    {
+      for (word& w : words_)
+        w = ~word(0);
+      trim();
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::reset()
+    {
+      for (word& w : words_)
+        w = 0;
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::flip()
+    {
+      for (word& w : words_)
+        w = ~w;
+      trim();
+    }
+
+  template <typename A>
+    inline bool
+    basic_bit_vector<A>::atomic_test(size_type n) const
+    {
+      assert(n < size_);
+      return bit_vector_impl::atomic_load(words_[n / bits]) & mask(n);
+    }
+
+  template <typename A>
+    inline bool
+    basic_bit_vector<A>::atomic_set(size_type n)
+    {
+      assert(n < size_);
+      return !(bit_vector_impl::atomic_or(words_[n / bits], mask(n)) & mask(n));
+    }
+
+  template <typename A>
+    inline bool
+    basic_bit_vector<A>::atomic_reset(size_type n)
+    {
+      assert(n < size_);
+      return bit_vector_impl::atomic_and(words_[n / bits], ~mask(n)) & mask(n);
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::push_back(bool x)
+    {
+      if (size_ % bits == 0)
+        words_.push_back(0);
+      if (x)
+        words_.back() |= mask(size_);
+      ++size_;
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::pop_back()
+    {
+      assert(size_ != 0);
+      --size_;
+      if (size_ % bits == 0)
+        words_.pop_back();
+      else
+        words_.back() &= ~mask(size_);
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::resize(size_type n, bool x)
+    {
+      if (n > size_ && x) {
+        if (size_ % bits != 0)
+          words_.back() |= ~word(0) << (size_ % bits);
+        words_.resize(words(n), ~word(0));
+      } else {
+        words_.resize(words(n), 0);
+      }
+      size_ = n;
+      trim();
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::clear()
+    {
+      words_.clear();
+      size_ = 0;
+    }
+
+  template <typename A>
+    inline auto
+    basic_bit_vector<A>::count() const -> size_type
+    {
+      size_type n = 0;
+      for (word w : words_)
+        n += bit_vector_impl::count_bits(w);
+      return n;
+    }
+
+  template <typename A>
+    inline bool
+    basic_bit_vector<A>::any() const
+    {
+      for (word w : words_)
+        if (w)
+          return true;
+      return false;
+    }
+
+  template <typename A>
+    inline auto
+    basic_bit_vector<A>::find(size_type n) const -> size_type
+    {
+      size_type w = n / bits;
+      if (w >= words_.size())
+        return npos;
+      word x = words_[w] & (~word(0) << (n % bits));
+      while (x == 0) {
+        if (++w == words_.size())
+          return npos;
+        x = words_[w];
+      }
+      return w * bits + bit_vector_impl::lowest_bit(x);
+    }
+
+  template <typename A>
+    inline auto
+    basic_bit_vector<A>::rfind(size_type n) const -> size_type
+    {
+      if (size_ == 0)
+        return npos;
+      if (n >= size_)
+        n = size_ - 1;
+      size_type w = n / bits;
+      word x = words_[w] & (~word(0) >> (bits - 1 - n % bits));
+      while (x == 0) {
+        if (w == 0)
+          return npos;
+        x = words_[--w];
+      }
+      return w * bits + bit_vector_impl::highest_bit(x);
+    }
+
+  template <typename A>
+    template <typename Op>
+      inline basic_bit_vector<A>&
+      basic_bit_vector<A>::apply(const basic_bit_vector& x, Op op)
+      {
+        assert(size_ == x.size_);
+        bit_vector_impl::apply(words_.data(), x.words_.data(), words_.size(),
+                               op);
+        return *this;
+      }
+
+  template <typename A>
+    inline basic_bit_vector<A>&
+    basic_bit_vector<A>::operator&=(const basic_bit_vector& x)
+    {
+      return apply(x, bit_vector_impl::and_op());
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>&
+    basic_bit_vector<A>::operator|=(const basic_bit_vector& x)
+    {
+      return apply(x, bit_vector_impl::or_op());
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>&
+    basic_bit_vector<A>::operator^=(const basic_bit_vector& x)
+    {
+      return apply(x, bit_vector_impl::xor_op());
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>&
+    basic_bit_vector<A>::operator-=(const basic_bit_vector& x)
+    {
+      return apply(x, bit_vector_impl::andnot_op());
+    }
+
+  template <typename A>
+    inline void
+    basic_bit_vector<A>::trim()
+    {
+      if (size_ % bits != 0)
+        words_.back() &= ~(~word(0) << (size_ % bits));
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>
+    operator&(basic_bit_vector<A> a, const basic_bit_vector<A>& b)
+    {
+      return a &= b;
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>
+    operator|(basic_bit_vector<A> a, const basic_bit_vector<A>& b)
+    {
+      return a |= b;
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>
+    operator^(basic_bit_vector<A> a, const basic_bit_vector<A>& b)
+    {
+      return a ^= b;
+    }
+
+  template <typename A>
+    inline basic_bit_vector<A>
+    operator-(basic_bit_vector<A> a, const basic_bit_vector<A>& b)
+    {
+      return a -= b;
+    }
+
+  template <typename A>
+    inline void
+    swap(basic_bit_vector<A>& a, basic_bit_vector<A>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
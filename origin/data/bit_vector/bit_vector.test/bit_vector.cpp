@@ -0,0 +1,153 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+
+#include <cassert>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <origin/data/bit_vector/bit_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns a vector of n random bits, and its copy in v.
+bit_vector random_bits(size_t n, vector<bool>& v, minstd_rand& gen)
+{
+  bit_vector b;
+  v.clear();
+  for (size_t i = 0; i != n; ++i) {
+    bool x = gen() % 3 == 0;
+    b.push_back(x);
+    v.push_back(x);
+  }
+  return b;
+}
+
+bool same(const bit_vector& b, const vector<bool>& v)
+{
+  if (b.size() != v.size())
+    return false;
+  for (size_t i = 0; i != v.size(); ++i)
+    if (b[i] != v[i])
+      return false;
+  return true;
+}
+
+void check_access()
+{
+  bit_vector b(130);
+  assert(b.size() == 130 && b.none() && b.count() == 0);
+  b.set(0);
+  b.set(64);
+  b.set(129);
+  assert(b.test(64) && !b.test(63) && b.count() == 3);
+  b.flip(64);
+  b.reset(0);
+  assert(b.count() == 1 && b.any());
+
+  b.set();
+  assert(b.count() == 130);
+  b.flip();
+  assert(b.none());
+
+  // Growing with set bits fills the rest of the last word.
+  b.resize(70);
+  b.resize(200, true);
+  assert(b.count() == 130 && !b[69] && b[70]);
+  b.resize(65, true);
+  b.set(0);
+  assert(b.count() == 1 && b.word_count() == 2);
+  b.push_back(true);
+  b.pop_back();
+  assert(b.count() == 1 && b.word_count() == 2);
+  b.pop_back();
+  assert(b.count() == 1 && b.word_count() == 1);
+
+  bit_vector c {true, false, true};
+  assert(c.size() == 3 && c.count() == 2 && !c[1]);
+  assert(c == bit_vector({true, false, true}));
+  assert(c != bit_vector({true, false, false}));
+}
+
+void check_find()
+{
+  bit_vector b(300);
+  assert(b.find_first() == bit_vector::npos);
+  for (size_t n : {3, 64, 65, 130, 299})
+    b.set(n);
+  assert(b.find_first() == 3);
+  assert(b.find(4) == 64 && b.find(64) == 64);
+  assert(b.find_next(64) == 65 && b.find_next(65) == 130);
+  assert(b.find_next(299) == bit_vector::npos);
+  assert(b.find_next(bit_vector::npos) == bit_vector::npos);
+  assert(b.rfind(bit_vector::npos) == 299);
+  assert(b.rfind(129) == 65 && b.rfind(2) == bit_vector::npos);
+
+  size_t n = 0;
+  for (size_t i = b.find_first(); i != bit_vector::npos; i = b.find_next(i))
+    ++n;
+  assert(n == b.count());
+}
+
+// The bulk operations agree with those on each bit, for sizes that end in
+// both whole and partial vector registers.
+void check_bulk()
+{
+  minstd_rand gen;
+  for (size_t n : {0, 1, 63, 64, 65, 128, 200, 257, 1000}) {
+    vector<bool> u, v;
+    bit_vector a = random_bits(n, u, gen);
+    bit_vector b = random_bits(n, v, gen);
+
+    vector<bool> w(n);
+    for (size_t i = 0; i != n; ++i)
+      w[i] = u[i] && v[i];
+    assert(same(a & b, w));
+    for (size_t i = 0; i != n; ++i)
+      w[i] = u[i] || v[i];
+    assert(same(a | b, w));
+    for (size_t i = 0; i != n; ++i)
+      w[i] = u[i] != v[i];
+    assert(same(a ^ b, w));
+    for (size_t i = 0; i != n; ++i)
+      w[i] = u[i] && !v[i];
+    assert(same(a - b, w));
+
+    a -= a;
+    assert(a.none());
+  }
+}
+
+// Of several threads setting each bit, exactly one sets it.
+void check_atomic()
+{
+  const size_t n = 10000;
+  bit_vector b(n);
+  vector<size_t> claimed(4);
+  vector<thread> ts;
+  for (size_t t = 0; t != 4; ++t)
+    ts.emplace_back([&b, &claimed, t] {
+      for (size_t i = 0; i != n; ++i)
+        if (b.atomic_set(i))
+          ++claimed[t];
+    });
+  for (thread& t : ts)
+    t.join();
+  assert(claimed[0] + claimed[1] + claimed[2] + claimed[3] == n);
+  assert(b.count() == n && b.atomic_test(n - 1));
+  assert(b.atomic_reset(7) && !b.atomic_reset(7) && !b.test(7));
+}
+
+int main()
+{
+  check_access();
+  check_find();
+  check_bulk();
+  check_atomic();
+}
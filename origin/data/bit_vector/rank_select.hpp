@@ -0,0 +1,201 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_BIT_VECTOR_RANK_SELECT_HPP
+#define ORIGIN_DATA_BIT_VECTOR_RANK_SELECT_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <origin/data/bit_vector/bit_vector.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Rank and Select                                          data.rank_select
+  //
+  // A rank-select index answers two queries about the bits of a bit vector
+  // in constant time:
+  //
+  //    rank(n)     returns the number of set bits less than n, and
+  //    select(k)   returns the set bit that has k set bits below it.
+  //
+  // They are inverses: rank(select(k)) == k. The number of clear bits less
+  // than n is n - rank(n).
+  //
+  // The index is that of Zhou, Andersen and Kaminsky's "poppy". The bits
+  // are divided into blocks of 2048, and each block has one 64-bit entry:
+  // the number of set bits before the block, in the high 32 bits, and the
+  // counts of its first three sub-blocks of 512 bits, in 10 bits each. The
+  // count before the block is relative to a superblock of 2^32 bits, whose
+  // absolute count is stored separately. A rank query reads one entry and
+  // counts at most 7 words and a partial word with population counts. A
+  // select query starts from a sample, the block of every 8192nd set bit,
+  // binary searches the entries that follow, and then scans the sub-block
+  // counts, the words and the bits of a word (with pdep when there is
+  // BMI2). The entries take 3.1% of the space of the bits, and the samples
+  // at most another 0.8%.
+  //
+  // The index refers to the bit vector it is built from, which must not be
+  // destroyed while the index is used. It describes the bits as they were
+  // when it was built, and must be rebuilt when they change.
+  class rank_select
+  {
+    using word = bit_vector_impl::word;
+  public:
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = -1;
+
+    rank_select()
+      : bits_(nullptr), ones_(0)
+    { }
+
+    explicit rank_select(const bit_vector& b)
+    {
+      build(b);
+    }
+
+    // Index the bits of b.
+    void build(const bit_vector& b);
+
+    // Returns the number of bits of the indexed vector.
+    size_type size() const { return bits_ ? bits_->size() : 0; }
+
+    // Returns the number of set bits.
+    size_type count() const { return ones_; }
+
+    // Returns the number of set bits less than n, where n is not greater
+    // than size().
+    size_type rank(size_type n) const;
+
+    // Returns the set bit that has k set bits below it, or npos if k is not
+    // less than count().
+    size_type select(size_type k) const;
+
+    // Returns the memory footprint of the index, not including the bits.
+    memory_footprint memory_usage() const
+    {
+      return contiguous_footprint(blocks_) + contiguous_footprint(supers_)
+           + contiguous_footprint(samples_);
+    }
+
+  private:
+    static constexpr size_type block_words = 32;
+    static constexpr size_type sub_words = 8;
+    static constexpr size_type super_shift = 21; // Blocks per superblock
+    static constexpr size_type sample_rate = 8192;
+
+    // Returns the number of set bits before block b.
+    size_type before(size_type b) const
+    {
+      return supers_[b >> super_shift] + (blocks_[b] >> 32);
+    }
+
+  private:
+    const bit_vector* bits_;
+    std::vector<std::uint64_t> blocks_; // The entry of each block
+    std::vector<std::uint64_t> supers_; // Set bits before each superblock
+    std::vector<size_type> samples_;    // Block of each 8192nd set bit
+    size_type ones_;                    // The number of set bits
+  };
+
+  inline void
+  rank_select::build(const bit_vector& b)
+  {
+    using bit_vector_impl::count_bits;
+    bits_ = &b;
+    blocks_.clear();
+    supers_.clear();
+    samples_.clear();
+
+    // There is an entry for the block holding the word past the last, so
+    // that rank(size()) needs no special case.
+    const word* w = b.data();
+    size_type n = b.word_count();
+    size_type total = 0;
+    for (size_type k = 0; k <= n; k += block_words) {
+      if ((k / block_words) % (size_type(1) << super_shift) == 0)
+        supers_.push_back(total);
+      std::uint64_t e = std::uint64_t(total - supers_.back()) << 32;
+      size_type c = 0;
+      for (size_type s = 0; s != block_words / sub_words; ++s) {
+        size_type m = 0;
+        size_type i = k + s * sub_words;
+        for ( ; i != k + (s + 1) * sub_words && i < n; ++i)
+          m += count_bits(w[i]);
+        if (s != 3)
+          e |= std::uint64_t(m) << (10 * s);
+        c += m;
+      }
+      blocks_.push_back(e);
+      while (samples_.size() * sample_rate < total + c)
+        samples_.push_back(k / block_words);
+      total += c;
+    }
+    ones_ = total;
+  }
+
+  inline rank_select::size_type
+  rank_select::rank(size_type n) const
+  {
+    using bit_vector_impl::count_bits;
+    assert(n <= size());
+    size_type b = n / (block_words * 64);
+    std::uint64_t e = blocks_[b];
+    size_type r = supers_[b >> super_shift] + (e >> 32);
+    size_type s = (n / (sub_words * 64)) % (block_words / sub_words);
+    for (size_type j = 0; j != s; ++j)
+      r += (e >> (10 * j)) & 1023;
+
+    const word* w = bits_->data();
+    size_type last = n / 64;
+    for (size_type i = b * block_words + s * sub_words; i != last; ++i)
+      r += count_bits(w[i]);
+    if (n % 64 != 0)
+      r += count_bits(w[last] & ~(~word(0) << (n % 64)));
+    return r;
+  }
+
+  inline rank_select::size_type
+  rank_select::select(size_type k) const
+  {
+    using bit_vector_impl::count_bits;
+    if (k >= ones_)
+      return npos;
+
+    // Find the last block with at most k set bits before it.
+    size_type j = k / sample_rate;
+    size_type lo = samples_[j];
+    size_type hi = j + 1 < samples_.size() ? samples_[j + 1] + 1
+                                           : blocks_.size();
+    while (hi - lo > 1) {
+      size_type mid = lo + (hi - lo) / 2;
+      if (before(mid) <= k)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    k -= before(lo);
+
+    // Find the sub-block, then the word.
+    std::uint64_t e = blocks_[lo];
+    size_type s = 0;
+    for (size_type c; s != 3 && k >= (c = (e >> (10 * s)) & 1023); ++s)
+      k -= c;
+    const word* w = bits_->data();
+    size_type i = lo * block_words + s * sub_words;
+    for (size_type c; k >= (c = count_bits(w[i])); ++i)
+      k -= c;
+    return i * 64 + bit_vector_impl::select_bit(w[i], k);
+  }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,67 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include <origin/data/bit_vector/rank_select.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check every rank and select query on b against a count of its bits.
+void check_queries(const bit_vector& b)
+{
+  rank_select rs(b);
+  assert(rs.size() == b.size() && rs.count() == b.count());
+
+  size_t r = 0;
+  for (size_t n = 0; n != b.size(); ++n) {
+    assert(rs.rank(n) == r);
+    if (b[n]) {
+      assert(rs.select(r) == n);
+      ++r;
+    }
+  }
+  assert(rs.rank(b.size()) == r);
+  assert(rs.select(r) == rank_select::npos);
+}
+
+void check_density(size_t n, unsigned one_in)
+{
+  minstd_rand gen(n);
+  bit_vector b(n);
+  for (size_t i = 0; i != n; ++i)
+    if (gen() % one_in == 0)
+      b.set(i);
+  check_queries(b);
+}
+
+int main()
+{
+  check_queries(bit_vector());
+  check_queries(bit_vector(2048));
+  check_queries(bit_vector(2048, true));
+  check_queries(bit_vector(5000, true));
+
+  // Sizes around the blocks, sub-blocks and samples of the index.
+  for (size_t n : {1, 63, 64, 511, 512, 2047, 2049, 4096, 70000})
+    for (unsigned d : {1, 2, 7, 100})
+      check_density(n, d);
+
+  // The index takes less than 5% of the space of the bits.
+  bit_vector b(1 << 20, true);
+  rank_select rs(b);
+  assert(rs.memory_usage().live * 20 < b.memory_usage().live);
+
+  // The index is rebuilt when the bits change.
+  b.reset(0);
+  rs.build(b);
+  assert(rs.rank(1) == 0 && rs.select(0) == 1);
+}
@@ -0,0 +1,309 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_CACHE_CLOCK_CACHE_HPP
+#define ORIGIN_DATA_CACHE_CLOCK_CACHE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <origin/memory/usage.hpp>
+#include <origin/data/flat_hash/flat_hash_map.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Cache Statistics                                           data.cache_stats
+  //
+  // The statistics of a cache count its lookups that found a value (hits),
+  // those that did not (misses), and the values it discarded to make room
+  // for others (evictions).
+  struct cache_stats
+  {
+    cache_stats()
+      : hits(0), misses(0), evictions(0)
+    { }
+
+    // Returns the fraction of lookups that were hits, or 0 if there were
+    // none.
+    double hit_ratio() const
+    {
+      std::size_t n = hits + misses;
+      return n ? double(hits) / n : 0.0;
+    }
+
+    cache_stats& operator+=(const cache_stats& x)
+    {
+      hits += x.hits;
+      misses += x.misses;
+      evictions += x.evictions;
+      return *this;
+    }
+
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+  };
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Clock Cache                                                data.clock_cache
+  //
+  // A clock cache is a map of bounded size that memoizes the results of an
+  // expensive function, such as the distances of a search from each source
+  // vertex:
+  //
+  //    clock_cache<vertex_handle, std::vector<double>> c(1000);
+  //    const auto& d = c.find_or_compute(s, [&](vertex_handle s) {
+  //      return distances_from(g, s);
+  //    });
+  //
+  // When the cache is full, inserting a value evicts another, chosen by the
+  // CLOCK algorithm, an approximation of least recently used. The entries
+  // are kept in a circular array, each with a bit that is set when it is
+  // found. To evict, a hand sweeps the array from where it last stopped,
+  // clearing the bits that are set, and takes the first entry whose bit is
+  // clear: one that has not been found since the hand last passed it. A
+  // lookup sets one bit rather than moving its entry to the front of a
+  // list, and the entries are not linked.
+  //
+  // The keys and values are stored in arrays of the capacity of the cache,
+  // which are allocated when it is constructed, and the position of each key
+  // in a flat hash map (see data.flat_hash_map) that is reserved for all of
+  // them, so that no operation allocates memory for an entry (the values
+  // themselves may allocate). An evicted value is replaced by assignment.
+  //
+  // The lookups update the bits and the statistics (see data.cache_stats),
+  // so that they are not const; contains(k) tests a key without either. A
+  // pointer or reference to a value is invalidated by the next insertion
+  // or erasure.
+  //
+  // Template Parameters:
+  //    K -- The key type
+  //    V -- The mapped type
+  //    H -- The hash function
+  //    E -- The key equality
+  template <typename K,
+            typename V,
+            typename H = std::hash<K>,
+            typename E = std::equal_to<K>>
+    class clock_cache
+    {
+    public:
+      using key_type = K;
+      using mapped_type = V;
+      using size_type = std::size_t;
+      using hasher = H;
+      using key_equal = E;
+
+      // Construct a cache that holds at most n values, where n is positive.
+      explicit clock_cache(size_type n, const H& hash = H(), const E& eq = E());
+
+      // Observers
+      size_type size() const { return keys_.size(); }
+      size_type capacity() const { return capacity_; }
+      bool empty() const { return keys_.empty(); }
+      bool full() const { return keys_.size() == capacity_; }
+
+      hasher hash_function() const { return index_.hash_function(); }
+      key_equal key_eq() const { return index_.key_eq(); }
+
+      // Lookup
+      //
+      // Returns the value of k, or null if k is not cached.
+      V* find(const K& k);
+
+      bool contains(const K& k) const { return index_.contains(k); }
+
+      // Returns the value of k, computing it by f(k) and caching it if k is
+      // not cached.
+      template <typename F>
+        V& find_or_compute(const K& k, F f);
+
+      // Modifiers
+      //
+      // Cache v as the value of k, returning true if k was not cached.
+      bool insert(const K& k, V v);
+
+      bool erase(const K& k);
+
+      // Remove all values. The statistics are kept.
+      void clear();
+
+      // Statistics
+      const cache_stats& stats() const { return stats_; }
+      void reset_stats() { stats_ = cache_stats(); }
+
+      // Returns the footprint of the entries and the index. The index is
+      // estimated as a slot and a control byte per element.
+      memory_footprint memory_usage() const
+      {
+        using slot = std::pair<const K, size_type>;
+        memory_footprint m = contiguous_footprint(keys_)
+                           + contiguous_footprint(values_)
+                           + contiguous_footprint(refs_);
+        return m + memory_footprint(index_.size() * (sizeof(slot) + 1),
+                                    index_.capacity() * (sizeof(slot) + 1));
+      }
+
+      void swap(clock_cache& x)
+      {
+        using std::swap;
+        index_.swap(x.index_);
+        keys_.swap(x.keys_);
+        values_.swap(x.values_);
+        refs_.swap(x.refs_);
+        swap(hand_, x.hand_);
+        swap(capacity_, x.capacity_);
+        swap(stats_, x.stats_);
+      }
+
+    private:
+      // Returns the entry to replace, advancing the hand past it.
+      size_type victim();
+
+    private:
+      flat_hash_map<K, size_type, H, E> index_;
+      std::vector<K>             keys_;
+      std::vector<V>             values_;
+      std::vector<unsigned char> refs_;  // The reference bit of each entry
+      size_type                  hand_;
+      size_type                  capacity_;
+      cache_stats                stats_;
+    };
+
+  // The index is reserved for a third more keys than the cache holds, so
+  // that the tombstones left by evictions are removed by rehashing it in
+  // place rather than by growing it.
+  template <typename K, typename V, typename H, typename E>
+    clock_cache<K, V, H, E>::clock_cache(size_type n, const H& hash,
+                                         const E& eq)
+      : index_(0, hash, eq), hand_(0), capacity_(n)
+    {
+      assert(n != 0);
+      index_.reserve(n + n / 3);
+      keys_.reserve(n);
+      values_.reserve(n);
+      refs_.reserve(n);
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline V*
+    clock_cache<K, V, H, E>::find(const K& k)
+    {
+      auto i = index_.find(k);
+      if (i == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+      }
+      ++stats_.hits;
+      refs_[i->second] = 1;
+      return &values_[i->second];
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    template <typename F>
+      V&
+      clock_cache<K, V, H, E>::find_or_compute(const K& k, F f)
+      {
+        if (V* p = find(k))
+          return *p;
+        insert(k, f(k));
+        return values_[index_.find(k)->second];
+      }
+
+  template <typename K, typename V, typename H, typename E>
+    auto
+    clock_cache<K, V, H, E>::victim() -> size_type
+    {
+      while (refs_[hand_]) {
+        refs_[hand_] = 0;
+        hand_ = hand_ + 1 == capacity_ ? 0 : hand_ + 1;
+      }
+      size_type i = hand_;
+      hand_ = hand_ + 1 == capacity_ ? 0 : hand_ + 1;
+      return i;
+    }
+
+  // A new entry's bit is clear, so that a value that is never found again
+  // is evicted when the hand next reaches it.
+  template <typename K, typename V, typename H, typename E>
+    bool
+    clock_cache<K, V, H, E>::insert(const K& k, V v)
+    {
+      auto i = index_.find(k);
+      if (i != index_.end()) {
+        values_[i->second] = std::move(v);
+        return false;
+      }
+      if (!full()) {
+        index_.insert({k, keys_.size()});
+        keys_.push_back(k);
+        values_.push_back(std::move(v));
+        refs_.push_back(0);
+        return true;
+      }
+      size_type j = victim();
+      index_.erase(keys_[j]);
+      index_.insert({k, j});
+      keys_[j] = k;
+      values_[j] = std::move(v);
+      refs_[j] = 0;
+      ++stats_.evictions;
+      return true;
+    }
+
+  // The last entry is moved into the place of the erased one, so that the
+  // entries stay contiguous.
+  template <typename K, typename V, typename H, typename E>
+    bool
+    clock_cache<K, V, H, E>::erase(const K& k)
+    {
+      auto i = index_.find(k);
+      if (i == index_.end())
+        return false;
+      size_type j = i->second;
+      size_type last = keys_.size() - 1;
+      index_.erase(i);
+      if (j != last) {
+        keys_[j] = std::move(keys_[last]);
+        values_[j] = std::move(values_[last]);
+        refs_[j] = refs_[last];
+        index_.find(keys_[j])->second = j;
+      }
+      keys_.pop_back();
+      values_.pop_back();
+      refs_.pop_back();
+      if (hand_ >= keys_.size())
+        hand_ = 0;
+      return true;
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline void
+    clock_cache<K, V, H, E>::clear()
+    {
+      index_.clear();
+      keys_.clear();
+      values_.clear();
+      refs_.clear();
+      hand_ = 0;
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline void
+    swap(clock_cache<K, V, H, E>& a, clock_cache<K, V, H, E>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
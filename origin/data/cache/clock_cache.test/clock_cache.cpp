@@ -0,0 +1,108 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/data/cache/clock_cache.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A key that was found since the hand last passed it survives the next
+// eviction; one that was not is evicted.
+void check_clock()
+{
+  clock_cache<int, string> c(3);
+  assert(c.empty() && c.capacity() == 3);
+  assert(c.insert(1, "a"));
+  assert(c.insert(2, "b"));
+  assert(c.insert(3, "c"));
+  assert(c.full());
+  assert(!c.insert(3, "C"));
+  assert(*c.find(3) == "C");
+
+  // 1 and 2 have clear bits; 1 is evicted first.
+  assert(c.find(2));
+  c.insert(4, "d");
+  assert(!c.contains(1));
+  assert(c.contains(2) && c.contains(3) && c.contains(4));
+
+  // The hand clears the bits of 2 and 3 and evicts 4, which was never
+  // found, then evicts 2.
+  c.insert(5, "e");
+  assert(!c.contains(4));
+  c.insert(6, "f");
+  assert(!c.contains(2));
+  assert(c.size() == 3);
+  assert(*c.find(3) == "C" && *c.find(5) == "e" && *c.find(6) == "f");
+  assert(!c.find(1));
+
+  const cache_stats& s = c.stats();
+  assert(s.hits == 5 && s.misses == 1 && s.evictions == 3);
+  assert(s.hit_ratio() == 5.0 / 6);
+  c.reset_stats();
+  assert(c.stats().hits == 0 && c.stats().hit_ratio() == 0);
+}
+
+// Erasure keeps the entries contiguous, and the erased places are filled
+// before any value is evicted.
+void check_erase()
+{
+  clock_cache<int, int> c(4);
+  for (int i = 0; i != 4; ++i)
+    c.insert(i, 10 * i);
+  assert(c.erase(1));
+  assert(!c.erase(1));
+  assert(c.size() == 3 && !c.full());
+  assert(*c.find(3) == 30 && *c.find(0) == 0 && *c.find(2) == 20);
+  c.insert(7, 70);
+  assert(c.full() && c.stats().evictions == 0);
+  assert(*c.find(7) == 70);
+
+  c.clear();
+  assert(c.empty() && !c.contains(0));
+  c.insert(0, 1);
+  assert(*c.find(0) == 1);
+}
+
+// Memoize a function of random keys, checking each value, and that the
+// cache never holds more than its capacity.
+void check_memoize()
+{
+  minstd_rand gen(3);
+  uniform_int_distribution<int> dist(0, 300);
+  clock_cache<int, vector<int>> c(100);
+  int calls = 0;
+  auto f = [&](int k) { ++calls; return vector<int>(3, k); };
+  for (int i = 0; i != 20000; ++i) {
+    int k = dist(gen);
+    const vector<int>& v = c.find_or_compute(k, f);
+    assert(v.size() == 3 && v[0] == k);
+    assert(c.size() <= 100);
+  }
+  assert(c.full());
+  const cache_stats& s = c.stats();
+  assert(int(s.misses) == calls && s.hits + s.misses == 20000);
+  assert(s.evictions == s.misses - 100);
+  assert(s.hits > 0);
+  size_t n = 100 * (sizeof(int) + sizeof(vector<int>));
+  assert(c.memory_usage().reserved >= n);
+
+  clock_cache<int, vector<int>> d(1);
+  swap(c, d);
+  assert(c.capacity() == 1 && d.capacity() == 100);
+}
+
+int main()
+{
+  check_clock();
+  check_erase();
+  check_memoize();
+}
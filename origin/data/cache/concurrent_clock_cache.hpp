@@ -0,0 +1,300 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_CACHE_CONCURRENT_CLOCK_CACHE_HPP
+#define ORIGIN_DATA_CACHE_CONCURRENT_CLOCK_CACHE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include <origin/type/hash.hpp>
+#include <origin/memory/allocator.hpp>
+#include <origin/data/cache/clock_cache.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Concurrent Clock Cache                          data.concurrent_clock_cache
+  //
+  // A concurrent clock cache is a clock cache (see data.clock_cache) that
+  // many threads may use at once. It is divided into shards by the high
+  // bits of the hash of a key, as the stripes of data.concurrent_hash_map.
+  // Each shard is a clock cache of an equal part of the capacity, with a
+  // mutex that serializes its operations, on its own cache lines. Threads
+  // that use keys in different shards do not contend.
+  //
+  // Since a value may be evicted by another thread as soon as the lock of
+  // its shard is released, lookups copy the value out:
+  //
+  //    c.find(k, v)              Copy the value of k to v, or return false
+  //    c.contains(k)             True if k is cached
+  //    c.find_or_compute(k, f)   Returns the value of k, computing it by f(k)
+  //    c.insert(k, v)            Cache v as the value of k
+  //    c.erase(k)                Erase k, if it is cached
+  //
+  // find_or_compute(k, f) calls f outside the lock, so that an expensive
+  // computation does not stall the other users of the shard. Two threads
+  // that miss the same key may both compute its value; the last to finish
+  // caches it.
+  //
+  // The statistics are the sums of those of the shards. They, and the size,
+  // may change while they are read. The cache cannot be copied or moved.
+  //
+  // Template Parameters:
+  //    K -- The key type
+  //    V -- The mapped type
+  //    H -- The hash function
+  //    E -- The key equality
+  template <typename K,
+            typename V,
+            typename H = std::hash<K>,
+            typename E = std::equal_to<K>>
+    class concurrent_clock_cache
+    {
+      struct shard;
+    public:
+      using key_type = K;
+      using mapped_type = V;
+      using size_type = std::size_t;
+      using hasher = H;
+      using key_equal = E;
+
+      // The default number of shards.
+      static constexpr size_type default_shards = 16;
+
+      // Construct a cache that holds at least n values, divided into the
+      // given number of shards, which is rounded up to a power of two and is
+      // at most 2^16. Each shard holds n / shards values, rounded up.
+      explicit concurrent_clock_cache(size_type n,
+                                      size_type shards = default_shards,
+                                      const H& hash = H(),
+                                      const E& eq = E());
+
+      concurrent_clock_cache(const concurrent_clock_cache&) = delete;
+      concurrent_clock_cache&
+      operator=(const concurrent_clock_cache&) = delete;
+
+      ~concurrent_clock_cache();
+
+      // Observers
+      size_type size() const;
+      size_type capacity() const;
+      bool empty() const { return size() == 0; }
+      size_type shards() const { return mask_ + 1; }
+
+      hasher hash_function() const { return hash_; }
+
+      // Lookup
+      bool find(const K& k, V& v);
+      bool contains(const K& k) const;
+
+      template <typename F>
+        V find_or_compute(const K& k, F f);
+
+      // Modifiers
+      bool insert(const K& k, V v);
+      bool erase(const K& k);
+      void clear();
+
+      // Statistics
+      cache_stats stats() const;
+      void reset_stats();
+
+      memory_footprint memory_usage() const;
+
+    private:
+      using cache_type = clock_cache<K, V, H, E>;
+
+      struct shard
+      {
+        shard(size_type n, const H& hash, const E& eq)
+          : cache(n, hash, eq)
+        { }
+
+        alignas(64) mutable std::mutex lock;
+        cache_type cache;
+      };
+
+      shard& shard_of(const K& k) const
+      {
+        constexpr int shift = std::numeric_limits<size_type>::digits - 16;
+        return shards_[(hash_mix(hash_(k)) >> shift) & mask_];
+      }
+
+    private:
+      H hash_;
+      shard* shards_;
+      size_type mask_;  // The number of shards, less 1
+    };
+
+  template <typename K, typename V, typename H, typename E>
+    constexpr typename concurrent_clock_cache<K, V, H, E>::size_type
+    concurrent_clock_cache<K, V, H, E>::default_shards;
+
+  template <typename K, typename V, typename H, typename E>
+    concurrent_clock_cache<K, V, H, E>::concurrent_clock_cache(
+      size_type n, size_type shards, const H& hash, const E& eq)
+      : hash_(hash), mask_(1)
+    {
+      assert(n != 0);
+      assert(shards <= (size_type(1) << 16));
+      while (mask_ < shards)
+        mask_ *= 2;
+      size_type m = (n + mask_ - 1) / mask_;
+      --mask_;
+      void* p = aligned_allocate((mask_ + 1) * sizeof(shard), 64);
+      shards_ = static_cast<shard*>(p);
+      size_type i = 0;
+      try {
+        for ( ; i <= mask_; ++i)
+          ::new (shards_ + i) shard(m, hash, eq);
+      } catch (...) {
+        while (i != 0)
+          shards_[--i].~shard();
+        aligned_deallocate(shards_);
+        throw;
+      }
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    concurrent_clock_cache<K, V, H, E>::~concurrent_clock_cache()
+    {
+      for (size_type i = 0; i <= mask_; ++i)
+        shards_[i].~shard();
+      aligned_deallocate(shards_);
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    typename concurrent_clock_cache<K, V, H, E>::size_type
+    concurrent_clock_cache<K, V, H, E>::size() const
+    {
+      size_type n = 0;
+      for (size_type i = 0; i <= mask_; ++i) {
+        std::lock_guard<std::mutex> g(shards_[i].lock);
+        n += shards_[i].cache.size();
+      }
+      return n;
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline typename concurrent_clock_cache<K, V, H, E>::size_type
+    concurrent_clock_cache<K, V, H, E>::capacity() const
+    {
+      return shards() * shards_[0].cache.capacity();
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline bool
+    concurrent_clock_cache<K, V, H, E>::find(const K& k, V& v)
+    {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> g(s.lock);
+      if (V* p = s.cache.find(k)) {
+        v = *p;
+        return true;
+      }
+      return false;
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline bool
+    concurrent_clock_cache<K, V, H, E>::contains(const K& k) const
+    {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> g(s.lock);
+      return s.cache.contains(k);
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    template <typename F>
+      V
+      concurrent_clock_cache<K, V, H, E>::find_or_compute(const K& k, F f)
+      {
+        shard& s = shard_of(k);
+        {
+          std::lock_guard<std::mutex> g(s.lock);
+          if (V* p = s.cache.find(k))
+            return *p;
+        }
+        V v = f(k);
+        std::lock_guard<std::mutex> g(s.lock);
+        s.cache.insert(k, v);
+        return v;
+      }
+
+  template <typename K, typename V, typename H, typename E>
+    inline bool
+    concurrent_clock_cache<K, V, H, E>::insert(const K& k, V v)
+    {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> g(s.lock);
+      return s.cache.insert(k, std::move(v));
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    inline bool
+    concurrent_clock_cache<K, V, H, E>::erase(const K& k)
+    {
+      shard& s = shard_of(k);
+      std::lock_guard<std::mutex> g(s.lock);
+      return s.cache.erase(k);
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    void
+    concurrent_clock_cache<K, V, H, E>::clear()
+    {
+      for (size_type i = 0; i <= mask_; ++i) {
+        std::lock_guard<std::mutex> g(shards_[i].lock);
+        shards_[i].cache.clear();
+      }
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    cache_stats
+    concurrent_clock_cache<K, V, H, E>::stats() const
+    {
+      cache_stats x;
+      for (size_type i = 0; i <= mask_; ++i) {
+        std::lock_guard<std::mutex> g(shards_[i].lock);
+        x += shards_[i].cache.stats();
+      }
+      return x;
+    }
+
+  template <typename K, typename V, typename H, typename E>
+    void
+    concurrent_clock_cache<K, V, H, E>::reset_stats()
+    {
+      for (size_type i = 0; i <= mask_; ++i) {
+        std::lock_guard<std::mutex> g(shards_[i].lock);
+        shards_[i].cache.reset_stats();
+      }
+    }
+
+  // Returns the footprint of the shards and their caches.
+  template <typename K, typename V, typename H, typename E>
+    memory_footprint
+    concurrent_clock_cache<K, V, H, E>::memory_usage() const
+    {
+      size_type n = (mask_ + 1) * sizeof(shard);
+      memory_footprint m(n, n);
+      for (size_type i = 0; i <= mask_; ++i) {
+        std::lock_guard<std::mutex> g(shards_[i].lock);
+        m += shards_[i].cache.memory_usage();
+      }
+      return m;
+    }
+
+} // namespace origin
+
+#endif
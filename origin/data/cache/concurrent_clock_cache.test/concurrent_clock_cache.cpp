@@ -0,0 +1,71 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include <origin/data/cache/concurrent_clock_cache.hpp>
+
+using namespace std;
+using namespace origin;
+
+void check_sequential()
+{
+  concurrent_clock_cache<int, int> c(100, 5);
+  assert(c.shards() == 8);
+  assert(c.capacity() == 8 * 13);
+  assert(c.empty());
+  assert(c.insert(1, 10));
+  assert(!c.insert(1, 11));
+  int v = 0;
+  assert(c.find(1, v) && v == 11);
+  assert(!c.find(2, v));
+  assert(c.contains(1));
+  assert(c.erase(1));
+  assert(!c.contains(1));
+  assert(c.find_or_compute(3, [](int k) { return 2 * k; }) == 6);
+  assert(c.size() == 1);
+
+  cache_stats s = c.stats();
+  assert(s.hits == 1 && s.misses == 2);
+  c.reset_stats();
+  assert(c.stats().misses == 0);
+  c.clear();
+  assert(c.empty());
+  assert(c.memory_usage().reserved >= 8 * 13 * 2 * sizeof(int));
+}
+
+// Threads memoize a function of overlapping keys; every value returned is
+// correct, and each lookup is counted once.
+void check_threads()
+{
+  concurrent_clock_cache<int, long> c(256);
+  atomic<int> calls(0);
+  auto f = [&](int k) { ++calls; return long(k) * k; };
+  vector<thread> ts;
+  for (int t = 0; t != 4; ++t)
+    ts.emplace_back([&, t]() {
+      for (int i = 0; i != 20000; ++i) {
+        int k = (i * (t + 1)) % 500;
+        assert(c.find_or_compute(k, f) == long(k) * k);
+      }
+    });
+  for (thread& t : ts)
+    t.join();
+  cache_stats s = c.stats();
+  assert(s.hits + s.misses == 80000);
+  assert(int(s.misses) == calls.load());
+  assert(c.size() <= c.capacity());
+}
+
+int main()
+{
+  check_sequential();
+  check_threads();
+}
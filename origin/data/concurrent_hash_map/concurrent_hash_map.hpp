@@ -0,0 +1,628 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_CONCURRENT_HASH_MAP_CONCURRENT_HASH_MAP_HPP
+#define ORIGIN_DATA_CONCURRENT_HASH_MAP_CONCURRENT_HASH_MAP_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/type/hash.hpp>
+#include <origin/memory/allocator.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Concurrent Hash Map                                data.concurrent_hash_map
+  //
+  // A concurrent hash map is a map that many threads may read and update at
+  // once. It suits shared lookup tables, such as a map from external ids to
+  // vertex handles, that are read far more often than they are written.
+  //
+  // The map is divided into stripes by the high bits of the hash of a key.
+  // Each stripe is an open-addressing table with linear probing, a mutex
+  // that serializes its writers, and a version number that is odd while a
+  // writer is changing it, as in a seqlock. Readers take no lock and write
+  // no shared memory: a lookup reads the version, probes the table, copies
+  // the value, and retries if the version has changed. When the writers of
+  // different stripes do not contend, and readers do not contend with
+  // anyone, the throughput of lookups grows with the number of threads.
+  //
+  // Because a reader may copy a key or value while a writer changes it (and
+  // then discard the copy), K and V must be trivially copyable: integers,
+  // handles, and aggregates of them. A table that maps strings can store a
+  // hash or an interned id of each string instead.
+  //
+  // Erasure shifts the elements that follow the erased one back into its
+  // slot, so a table never holds tombstones, and a stripe's table is
+  // replaced only when it doubles. A replaced table may still be read by a
+  // concurrent lookup, so it is kept until reclaim() is called or the map
+  // is destroyed. Since each table is twice the size of the one before, the
+  // retired tables of a stripe take less space than its current table.
+  // reclaim() must not be called concurrently with any other operation.
+  //
+  // The operations are:
+  //
+  //    m.find(k, v)              Copy the value of k to v, or return false
+  //    m.contains(k)             True if k is in the map
+  //    m.insert(k, v)            Insert (k, v), if k is not in the map
+  //    m.insert_or_assign(k, v)  Insert (k, v), or assign v to the value of k
+  //    m.erase(k)                Erase k, if it is in the map
+  //    m.insert(first, last)     Insert the pairs of [first, last)
+  //    m.snapshot()              Returns a vector of the elements
+  //    m.for_each(f)             Call f on each element
+  //
+  // The bulk insertion sorts the pairs by stripe and takes the lock of each
+  // stripe once. A snapshot copies each stripe while holding its lock, so it
+  // holds every element that is in the map for the duration of the call,
+  // and none that is absent for its duration; for_each calls f on such a
+  // copy of each stripe, outside of the lock. The size is the sum of the
+  // sizes of the stripes, which may change while it is read.
+  //
+  // The tables are allocated by the allocator A, rebound to the slot type.
+  // The stripes are allocated from the global heap, aligned to cache lines.
+  // The map cannot be copied or moved.
+  //
+  // Template Parameters:
+  //    K -- The key type
+  //    V -- The mapped type
+  //    H -- The hash function
+  //    E -- The key equality
+  //    A -- The allocator of the elements
+  template <typename K,
+            typename V,
+            typename H = std::hash<K>,
+            typename E = std::equal_to<K>,
+            typename A = std::allocator<std::pair<const K, V>>>
+    class concurrent_hash_map
+    {
+      static_assert(std::is_trivially_copyable<K>::value,
+                    "the key type must be trivially copyable");
+      static_assert(std::is_trivially_copyable<V>::value,
+                    "the mapped type must be trivially copyable");
+
+      struct slot;
+      struct table;
+      struct stripe;
+
+      using slot_allocator =
+        typename std::allocator_traits<A>::template rebind_alloc<slot>;
+      using slot_traits = std::allocator_traits<slot_allocator>;
+      using table_allocator =
+        typename std::allocator_traits<A>::template rebind_alloc<table>;
+      using table_traits = std::allocator_traits<table_allocator>;
+    public:
+      using key_type = K;
+      using mapped_type = V;
+      using value_type = std::pair<const K, V>;
+      using size_type = std::size_t;
+      using hasher = H;
+      using key_equal = E;
+      using allocator_type = A;
+
+      // The default number of stripes.
+      static constexpr size_type default_stripes = 64;
+
+      // Construct a map with room for n elements, divided into the given
+      // number of stripes, which is rounded up to a power of two and is at
+      // most 2^16.
+      explicit concurrent_hash_map(size_type n = 0,
+                                   size_type stripes = default_stripes,
+                                   const H& hash = H(),
+                                   const E& eq = E(),
+                                   const A& alloc = A());
+
+      concurrent_hash_map(const concurrent_hash_map&) = delete;
+      concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+      ~concurrent_hash_map();
+
+      // Observers
+      size_type size() const;
+      bool empty() const { return size() == 0; }
+      size_type stripes() const { return mask_ + 1; }
+
+      hasher hash_function() const { return hash_; }
+      key_equal key_eq() const { return eq_; }
+      allocator_type get_allocator() const { return A(alloc_); }
+
+      // Lookup
+      bool find(const K& k, V& v) const;
+      bool contains(const K& k) const;
+
+      // Modifiers
+      bool insert(const K& k, const V& v);
+      bool insert_or_assign(const K& k, const V& v);
+      bool erase(const K& k);
+
+      // Insert the pairs of the input range [first, last), returning the
+      // number inserted. Keys that are already in the map keep their values.
+      template <typename I>
+        size_type insert(I first, I last);
+
+      void clear();
+
+      // Make room for n elements.
+      void reserve(size_type n);
+
+      // Snapshots
+      std::vector<std::pair<K, V>> snapshot() const;
+
+      template <typename F>
+        void for_each(F f) const;
+
+      // Free the tables replaced by growth.
+      void reclaim();
+
+    private:
+      // A slot is empty when its hash is 0. The hash of a key is never 0.
+      struct slot
+      {
+        K& key() { return *reinterpret_cast<K*>(&k); }
+        V& value() { return *reinterpret_cast<V*>(&v); }
+        const K& key() const { return *reinterpret_cast<const K*>(&k); }
+        const V& value() const { return *reinterpret_cast<const V*>(&v); }
+
+        size_type hash;
+        typename std::aligned_storage<sizeof(K), alignof(K)>::type k;
+        typename std::aligned_storage<sizeof(V), alignof(V)>::type v;
+      };
+
+      struct table
+      {
+        size_type mask;  // The number of slots, less 1
+        slot* slots;
+        table* next;     // The next retired table
+      };
+
+      // The version is on its own cache line, so that the stripes do not
+      // invalidate each other's lines.
+      struct stripe
+      {
+        alignas(64) std::atomic<unsigned> version;
+        std::atomic<table*> current;
+        std::atomic<size_type> size;
+        table* retired;
+        std::mutex lock;
+      };
+
+      // An element of a bulk insertion.
+      struct entry
+      {
+        size_type hash;
+        K key;
+        V value;
+      };
+
+      size_type hash(const K& k) const
+      {
+        size_type h = hash_mix(hash_(k));
+        return h ? h : 1;
+      }
+
+      size_type stripe_index(size_type h) const
+      {
+        constexpr int shift = std::numeric_limits<size_type>::digits - 16;
+        return (h >> shift) & mask_;
+      }
+
+      stripe& stripe_of(size_type h) const
+      {
+        return stripes_[stripe_index(h)];
+      }
+
+      // Returns the slot of the key k with the hash h in t, or the empty
+      // slot at which the probe for it ends. If a reader sees a table with
+      // neither, which is being changed, the result is null.
+      slot* probe(const table* t, const K& k, size_type h) const;
+
+      // The writer's operations, called with the lock of s held.
+      void begin_write(stripe& s);
+      void end_write(stripe& s);
+      void grow(stripe& s, size_type n);
+      bool put(stripe& s, const K& k, const V& v, size_type h, bool assign);
+
+      table* allocate(size_type n);
+      void deallocate(table* t);
+
+    private:
+      H hash_;
+      E eq_;
+      slot_allocator alloc_;
+      stripe* stripes_;
+      size_type mask_;  // The number of stripes, less 1
+    };
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    constexpr typename concurrent_hash_map<K, V, H, E, A>::size_type
+    concurrent_hash_map<K, V, H, E, A>::default_stripes;
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    concurrent_hash_map<K, V, H, E, A>::concurrent_hash_map(
+      size_type n, size_type stripes, const H& hash, const E& eq, const A& a)
+      : hash_(hash), eq_(eq), alloc_(a), mask_(1)
+    {
+      assert(stripes <= (size_type(1) << 16));
+      while (mask_ < stripes)
+        mask_ *= 2;
+      --mask_;
+      void* p = aligned_allocate((mask_ + 1) * sizeof(stripe), 64);
+      stripes_ = static_cast<stripe*>(p);
+      for (size_type i = 0; i <= mask_; ++i) {
+        stripe& s = *::new (stripes_ + i) stripe();
+        s.version.store(0, std::memory_order_relaxed);
+        s.current.store(allocate(8), std::memory_order_relaxed);
+        s.size.store(0, std::memory_order_relaxed);
+        s.retired = nullptr;
+      }
+      reserve(n);
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    concurrent_hash_map<K, V, H, E, A>::~concurrent_hash_map()
+    {
+      reclaim();
+      for (size_type i = 0; i <= mask_; ++i) {
+        deallocate(stripes_[i].current.load(std::memory_order_relaxed));
+        stripes_[i].~stripe();
+      }
+      aligned_deallocate(stripes_);
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    typename concurrent_hash_map<K, V, H, E, A>::size_type
+    concurrent_hash_map<K, V, H, E, A>::size() const
+    {
+      size_type n = 0;
+      for (size_type i = 0; i <= mask_; ++i)
+        n += stripes_[i].size.load(std::memory_order_relaxed);
+      return n;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    auto
+    concurrent_hash_map<K, V, H, E, A>::probe(const table* t, const K& k,
+                                              size_type h) const -> slot*
+    {
+      size_type i = h & t->mask;
+      for (size_type n = 0; n <= t->mask; ++n, i = (i + 1) & t->mask) {
+        slot* x = t->slots + i;
+        size_type xh = x->hash;
+        if (xh == 0 || (xh == h && eq_(x->key(), k)))
+          return x;
+      }
+      return nullptr;
+    }
+
+  // The value is copied to a buffer, and to v only when the version shows
+  // that no writer changed the stripe while it was copied.
+  template <typename K, typename V, typename H, typename E, typename A>
+    bool
+    concurrent_hash_map<K, V, H, E, A>::find(const K& k, V& v) const
+    {
+      size_type h = hash(k);
+      stripe& s = stripe_of(h);
+      typename std::aligned_storage<sizeof(V), alignof(V)>::type buf;
+      for (;;) {
+        unsigned before = s.version.load(std::memory_order_acquire);
+        if (before & 1) {
+          std::this_thread::yield();
+          continue;
+        }
+        const table* t = s.current.load(std::memory_order_acquire);
+        const slot* x = probe(t, k, h);
+        bool found = x && x->hash == h;
+        if (found)
+          std::memcpy(&buf, &x->v, sizeof(V));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.version.load(std::memory_order_relaxed) == before) {
+          if (found)
+            std::memcpy(&v, &buf, sizeof(V));
+          return found;
+        }
+      }
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    bool
+    concurrent_hash_map<K, V, H, E, A>::contains(const K& k) const
+    {
+      size_type h = hash(k);
+      stripe& s = stripe_of(h);
+      for (;;) {
+        unsigned before = s.version.load(std::memory_order_acquire);
+        if (before & 1) {
+          std::this_thread::yield();
+          continue;
+        }
+        const table* t = s.current.load(std::memory_order_acquire);
+        const slot* x = probe(t, k, h);
+        bool found = x && x->hash == h;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.version.load(std::memory_order_relaxed) == before)
+          return found;
+      }
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    inline void
+    concurrent_hash_map<K, V, H, E, A>::begin_write(stripe& s)
+    {
+      unsigned n = s.version.load(std::memory_order_relaxed);
+      s.version.store(n + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    inline void
+    concurrent_hash_map<K, V, H, E, A>::end_write(stripe& s)
+    {
+      unsigned n = s.version.load(std::memory_order_relaxed);
+      s.version.store(n + 1, std::memory_order_release);
+    }
+
+  // Replace the table of s with one that holds n elements at a load of at
+  // most 3/4. The old table is not changed, so readers need not retry.
+  template <typename K, typename V, typename H, typename E, typename A>
+    void
+    concurrent_hash_map<K, V, H, E, A>::grow(stripe& s, size_type n)
+    {
+      table* old = s.current.load(std::memory_order_relaxed);
+      size_type m = old->mask + 1;
+      while (n * 4 > m * 3)
+        m *= 2;
+      if (m == old->mask + 1)
+        return;
+      table* t = allocate(m);
+      for (size_type i = 0; i <= old->mask; ++i) {
+        const slot& x = old->slots[i];
+        if (x.hash != 0)
+          *probe(t, x.key(), x.hash) = x;
+      }
+      s.current.store(t, std::memory_order_release);
+      old->next = s.retired;
+      s.retired = old;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    bool
+    concurrent_hash_map<K, V, H, E, A>::put(stripe& s, const K& k, const V& v,
+                                            size_type h, bool assign)
+    {
+      table* t = s.current.load(std::memory_order_relaxed);
+      slot* x = probe(t, k, h);
+      if (x->hash == h) {
+        if (assign) {
+          begin_write(s);
+          ::new (&x->v) V(v);
+          end_write(s);
+        }
+        return false;
+      }
+      size_type n = s.size.load(std::memory_order_relaxed) + 1;
+      if (n * 4 > (t->mask + 1) * 3) {
+        grow(s, n);
+        t = s.current.load(std::memory_order_relaxed);
+        x = probe(t, k, h);
+      }
+      begin_write(s);
+      ::new (&x->k) K(k);
+      ::new (&x->v) V(v);
+      x->hash = h;
+      end_write(s);
+      s.size.store(n, std::memory_order_relaxed);
+      return true;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    bool
+    concurrent_hash_map<K, V, H, E, A>::insert(const K& k, const V& v)
+    {
+      size_type h = hash(k);
+      stripe& s = stripe_of(h);
+      std::lock_guard<std::mutex> guard(s.lock);
+      return put(s, k, v, h, false);
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    bool
+    concurrent_hash_map<K, V, H, E, A>::insert_or_assign(const K& k,
+                                                         const V& v)
+    {
+      size_type h = hash(k);
+      stripe& s = stripe_of(h);
+      std::lock_guard<std::mutex> guard(s.lock);
+      return put(s, k, v, h, true);
+    }
+
+  // Erase by backward shifting: each following element of the run that
+  // may occupy the vacated slot (its probe starts at or before the slot)
+  // is moved into it, and the slot it left is vacated in turn.
+  template <typename K, typename V, typename H, typename E, typename A>
+    bool
+    concurrent_hash_map<K, V, H, E, A>::erase(const K& k)
+    {
+      size_type h = hash(k);
+      stripe& s = stripe_of(h);
+      std::lock_guard<std::mutex> guard(s.lock);
+      table* t = s.current.load(std::memory_order_relaxed);
+      slot* x = probe(t, k, h);
+      if (x->hash != h)
+        return false;
+
+      begin_write(s);
+      size_type i = x - t->slots;
+      for (size_type j = (i + 1) & t->mask; t->slots[j].hash != 0;
+           j = (j + 1) & t->mask) {
+        size_type home = t->slots[j].hash & t->mask;
+        if (((j - home) & t->mask) >= ((j - i) & t->mask)) {
+          t->slots[i] = t->slots[j];
+          i = j;
+        }
+      }
+      t->slots[i].hash = 0;
+      end_write(s);
+      s.size.store(s.size.load(std::memory_order_relaxed) - 1,
+                   std::memory_order_relaxed);
+      return true;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    template <typename I>
+      typename concurrent_hash_map<K, V, H, E, A>::size_type
+      concurrent_hash_map<K, V, H, E, A>::insert(I first, I last)
+      {
+        // Sort the entries by stripe, counting those of each stripe.
+        std::vector<entry> es;
+        std::vector<size_type> counts(mask_ + 2);
+        for ( ; first != last; ++first) {
+          size_type h = hash(first->first);
+          es.push_back(entry {h, first->first, first->second});
+          ++counts[stripe_index(h) + 1];
+        }
+        for (size_type i = 1; i != counts.size(); ++i)
+          counts[i] += counts[i - 1];
+        std::vector<size_type> order(es.size());
+        for (size_type k = 0; k != es.size(); ++k)
+          order[counts[stripe_index(es[k].hash)]++] = k;
+
+        // The entries of the stripe i are now those of order from
+        // counts[i - 1] to counts[i].
+        size_type n = 0;
+        for (size_type i = 0, j = 0; i <= mask_; j = counts[i++]) {
+          if (j == counts[i])
+            continue;
+          stripe& s = stripes_[i];
+          std::lock_guard<std::mutex> guard(s.lock);
+          grow(s, s.size.load(std::memory_order_relaxed) + counts[i] - j);
+          for ( ; j != counts[i]; ++j) {
+            const entry& e = es[order[j]];
+            n += put(s, e.key, e.value, e.hash, false);
+          }
+        }
+        return n;
+      }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    void
+    concurrent_hash_map<K, V, H, E, A>::clear()
+    {
+      for (size_type i = 0; i <= mask_; ++i) {
+        stripe& s = stripes_[i];
+        std::lock_guard<std::mutex> guard(s.lock);
+        table* t = s.current.load(std::memory_order_relaxed);
+        begin_write(s);
+        for (size_type j = 0; j <= t->mask; ++j)
+          t->slots[j].hash = 0;
+        end_write(s);
+        s.size.store(0, std::memory_order_relaxed);
+      }
+    }
+
+  // The elements are assumed to be spread evenly over the stripes, with
+  // room for a few more in each.
+  template <typename K, typename V, typename H, typename E, typename A>
+    void
+    concurrent_hash_map<K, V, H, E, A>::reserve(size_type n)
+    {
+      size_type m = n / (mask_ + 1);
+      m += m / 8;
+      for (size_type i = 0; i <= mask_; ++i) {
+        stripe& s = stripes_[i];
+        std::lock_guard<std::mutex> guard(s.lock);
+        grow(s, m);
+      }
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    std::vector<std::pair<K, V>>
+    concurrent_hash_map<K, V, H, E, A>::snapshot() const
+    {
+      std::vector<std::pair<K, V>> r;
+      r.reserve(size());
+      for_each([&r](const value_type& x) { r.push_back(x); });
+      return r;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    template <typename F>
+      void
+      concurrent_hash_map<K, V, H, E, A>::for_each(F f) const
+      {
+        std::vector<value_type> buf;
+        for (size_type i = 0; i <= mask_; ++i) {
+          stripe& s = stripes_[i];
+          buf.clear();
+          {
+            std::lock_guard<std::mutex> guard(s.lock);
+            const table* t = s.current.load(std::memory_order_relaxed);
+            for (size_type j = 0; j <= t->mask; ++j) {
+              const slot& x = t->slots[j];
+              if (x.hash != 0)
+                buf.emplace_back(x.key(), x.value());
+            }
+          }
+          for (const value_type& x : buf)
+            f(x);
+        }
+      }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    void
+    concurrent_hash_map<K, V, H, E, A>::reclaim()
+    {
+      for (size_type i = 0; i <= mask_; ++i) {
+        stripe& s = stripes_[i];
+        while (table* t = s.retired) {
+          s.retired = t->next;
+          deallocate(t);
+        }
+      }
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    auto
+    concurrent_hash_map<K, V, H, E, A>::allocate(size_type n) -> table*
+    {
+      table_allocator ta(alloc_);
+      table* t = table_traits::allocate(ta, 1);
+      try {
+        t->slots = slot_traits::allocate(alloc_, n);
+      } catch (...) {
+        table_traits::deallocate(ta, t, 1);
+        throw;
+      }
+      for (size_type i = 0; i != n; ++i)
+        t->slots[i].hash = 0;
+      t->mask = n - 1;
+      t->next = nullptr;
+      return t;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    void
+    concurrent_hash_map<K, V, H, E, A>::deallocate(table* t)
+    {
+      table_allocator ta(alloc_);
+      slot_traits::deallocate(alloc_, t->slots, t->mask + 1);
+      table_traits::deallocate(ta, t, 1);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,140 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <origin/data/concurrent_hash_map/concurrent_hash_map.hpp>
+
+using namespace std;
+using namespace origin;
+
+using map_type = concurrent_hash_map<int, int>;
+
+void check_basic()
+{
+  map_type m;
+  assert(m.empty() && m.stripes() == map_type::default_stripes);
+  assert(m.insert(1, 10) && !m.insert(1, 11));
+  int v = 0;
+  assert(m.find(1, v) && v == 10);
+  assert(!m.insert_or_assign(1, 12) && m.find(1, v) && v == 12);
+  assert(m.insert_or_assign(2, 20) && m.size() == 2);
+  assert(m.contains(2) && !m.contains(3) && !m.find(3, v) && v == 12);
+  assert(m.erase(1) && !m.erase(1) && !m.contains(1) && m.size() == 1);
+  m.clear();
+  assert(m.empty() && !m.contains(2));
+
+  concurrent_hash_map<int, int> one(0, 1);
+  assert(one.stripes() == 1);
+  concurrent_hash_map<int, int> odd(0, 5);
+  assert(odd.stripes() == 8);
+}
+
+// Random insertions and erasures agree with those of an unordered map. The
+// few stripes and dense keys give long runs for erasure to shift.
+void check_random()
+{
+  map_type m(0, 2);
+  unordered_map<int, int> u;
+  minstd_rand gen;
+  for (int i = 0; i != 50000; ++i) {
+    int k = gen() % 2000;
+    switch (gen() % 3) {
+    case 0:
+      assert(m.insert(k, i) == u.emplace(k, i).second);
+      break;
+    case 1:
+      assert(m.insert_or_assign(k, i) == !u.count(k));
+      u[k] = i;
+      break;
+    case 2:
+      assert(m.erase(k) == (u.erase(k) == 1));
+      break;
+    }
+  }
+  assert(m.size() == u.size());
+  for (int k = 0; k != 2000; ++k) {
+    int v;
+    bool found = m.find(k, v);
+    assert(found == (u.count(k) == 1));
+    assert(!found || v == u[k]);
+  }
+  m.reclaim();
+  assert(m.size() == u.size());
+}
+
+void check_bulk()
+{
+  map_type m;
+  vector<pair<int, int>> xs;
+  for (int i = 0; i != 1000; ++i)
+    xs.emplace_back(i, -i);
+  xs.emplace_back(5, 5);
+  assert(m.insert(xs.begin(), xs.end()) == 1000);
+  assert(m.size() == 1000);
+  int v;
+  assert(m.find(5, v) && v == -5);
+
+  vector<pair<int, int>> s = m.snapshot();
+  assert(s.size() == 1000);
+  sort(s.begin(), s.end());
+  for (int i = 0; i != 1000; ++i)
+    assert(s[i].first == i && s[i].second == -i);
+
+  long sum = 0;
+  m.for_each([&sum](const pair<const int, int>& x) { sum += x.first; });
+  assert(sum == 999 * 1000 / 2);
+}
+
+// Readers see either no value or the value that a writer stored for the
+// key, even while writers grow, assign and erase.
+void check_concurrent()
+{
+  map_type m;
+  const int n = 20000;
+  vector<thread> ts;
+  for (int t = 0; t != 4; ++t)
+    ts.emplace_back([&m, t] {
+      for (int i = t; i < n; i += 4) {
+        m.insert_or_assign(i, 2 * i);
+        if (i % 3 == 0)
+          m.erase(i);
+      }
+    });
+  vector<int> bad(4);
+  for (int t = 0; t != 4; ++t)
+    ts.emplace_back([&m, &bad, t] {
+      minstd_rand gen(t);
+      for (int r = 0; r != 100000; ++r) {
+        int k = gen() % n;
+        int v;
+        if (m.find(k, v) && v != 2 * k)
+          ++bad[t];
+      }
+    });
+  for (thread& t : ts)
+    t.join();
+  assert(count(bad.begin(), bad.end(), 0) == 4);
+  assert(m.size() == size_t(n - (n + 2) / 3));
+  for (int i = 0; i != n; ++i)
+    assert(m.contains(i) == (i % 3 != 0));
+}
+
+int main()
+{
+  check_basic();
+  check_random();
+  check_bulk();
+  check_concurrent();
+}
@@ -0,0 +1,295 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FILTER_BLOOM_FILTER_HPP
+#define ORIGIN_DATA_FILTER_BLOOM_FILTER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+#include <origin/type/hash.hpp>
+#include <origin/memory/allocator.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  namespace bloom_filter_impl
+  {
+    // A block is a cache line of 8 words. Each key sets one bit in each
+    // word of its block.
+    constexpr std::size_t block_words = 8;
+    constexpr std::size_t block_bits = 64 * block_words;
+
+    // The odd multipliers that select the bit of a key in each word. They
+    // are those of the split block Bloom filters of Impala and Parquet.
+    constexpr std::uint32_t salt[block_words] = {
+      0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+      0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+    };
+
+    // Write the bits of the key whose hash is h to m.
+    inline void
+    make_mask(std::uint32_t h, std::uint64_t* m)
+    {
+      for (std::size_t i = 0; i != block_words; ++i)
+        m[i] = std::uint64_t(1) << (std::uint32_t(h * salt[i]) >> 26);
+    }
+
+#if defined(__AVX2__)
+    // Returns the bits of the key whose hash is h, in two vectors of four
+    // words.
+    inline void
+    make_mask(std::uint32_t h, __m256i& lo, __m256i& hi)
+    {
+      const __m256i s = _mm256_setr_epi32(
+        salt[0], salt[1], salt[2], salt[3],
+        salt[4], salt[5], salt[6], salt[7]);
+      __m256i p = _mm256_mullo_epi32(_mm256_set1_epi32(h), s);
+      p = _mm256_srli_epi32(p, 26);
+      const __m256i one = _mm256_set1_epi64x(1);
+      __m128i p0 = _mm256_castsi256_si128(p);
+      __m128i p1 = _mm256_extracti128_si256(p, 1);
+      lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(p0));
+      hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(p1));
+    }
+#endif
+
+    // Set the bits of the key whose hash is h in the block b.
+    inline void
+    set_bits(std::uint64_t* b, std::uint32_t h)
+    {
+#if defined(__AVX2__)
+      __m256i lo, hi;
+      make_mask(h, lo, hi);
+      __m256i* p = reinterpret_cast<__m256i*>(b);
+      _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), lo));
+      _mm256_store_si256(p + 1, _mm256_or_si256(_mm256_load_si256(p + 1), hi));
+#else
+      std::uint64_t m[block_words];
+      make_mask(h, m);
+      for (std::size_t i = 0; i != block_words; ++i)
+        b[i] |= m[i];
+#endif
+    }
+
+    // Returns true if the bits of the key whose hash is h are set in the
+    // block b.
+    inline bool
+    test_bits(const std::uint64_t* b, std::uint32_t h)
+    {
+#if defined(__AVX2__)
+      __m256i lo, hi;
+      make_mask(h, lo, hi);
+      const __m256i* p = reinterpret_cast<const __m256i*>(b);
+      return _mm256_testc_si256(_mm256_load_si256(p), lo)
+           & _mm256_testc_si256(_mm256_load_si256(p + 1), hi);
+#elif defined(__SSE2__)
+      alignas(16) std::uint64_t m[block_words];
+      make_mask(h, m);
+      const __m128i* p = reinterpret_cast<const __m128i*>(b);
+      const __m128i* q = reinterpret_cast<const __m128i*>(m);
+      __m128i x = _mm_setzero_si128();
+      for (std::size_t i = 0; i != block_words / 2; ++i)
+        x = _mm_or_si128(x, _mm_andnot_si128(_mm_load_si128(p + i),
+                                             _mm_load_si128(q + i)));
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128()))
+          == 0xffff;
+#else
+      std::uint64_t m[block_words];
+      make_mask(h, m);
+      std::uint64_t x = 0;
+      for (std::size_t i = 0; i != block_words; ++i)
+        x |= m[i] & ~b[i];
+      return x == 0;
+#endif
+    }
+  } // namespace bloom_filter_impl
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Blocked Bloom Filter                                      data.bloom_filter
+  //
+  // A Bloom filter is a set that may report false positives: contains(x)
+  // is true for every x that was inserted, and for a small fraction of the
+  // other values. It stores a few bits per value rather than the values, so
+  // that it can guard an expensive search: a query that it answers with
+  // false needs no search.
+  //
+  // The filter is blocked, in the manner of Putze, Sanders and Singler: its
+  // bits are divided into cache lines of 512 bits, a value is hashed to one
+  // of them, and sets (or tests) one bit in each of its 8 words. A query
+  // touches one cache line, and with AVX2 the 8 bits are computed and
+  // tested by a handful of vector instructions (with SSE2, they are tested
+  // as 4 pairs of words). With 10 bits per value, about 1% of the values
+  // that were not inserted are reported; with 16, about 0.1%.
+  //
+  // The number of bits is fixed when the filter is constructed or reset,
+  // from the expected number of values and the bits per value. Inserting
+  // more values makes false positives more frequent; values cannot be
+  // erased (see data.cuckoo_filter).
+  //
+  // The user's hash is mixed before it is used, as in data.flat_hash_set.
+  //
+  // Template Parameters:
+  //    T -- The value type
+  //    H -- The hash function
+  template <typename T, typename H = std::hash<T>>
+    class blocked_bloom_filter
+    {
+      using words_type =
+        std::vector<std::uint64_t, aligned_allocator<std::uint64_t, 64>>;
+    public:
+      using value_type = T;
+      using hasher = H;
+      using size_type = std::size_t;
+
+      static constexpr size_type default_bits = 10;
+
+      blocked_bloom_filter()
+        : blocks_(0), size_(0)
+      { }
+
+      // Construct a filter for n values of bits bits each.
+      explicit blocked_bloom_filter(size_type n, size_type bits = default_bits,
+                                    const H& h = H())
+        : hash_(h), blocks_(0), size_(0)
+      {
+        reset(n, bits);
+      }
+
+      // Remove all values, and size the filter for n values of bits bits
+      // each.
+      void reset(size_type n, size_type bits = default_bits);
+
+      // Remove all values.
+      void clear();
+
+      // Returns the number of insertions, which counts a value as many times
+      // as it was inserted.
+      size_type size() const { return size_; }
+      bool empty() const { return size_ == 0; }
+
+      // Returns the number of blocks of the filter.
+      size_type block_count() const { return blocks_; }
+
+      hasher hash_function() const { return hash_; }
+
+      // Add x to the filter.
+      void insert(const T& x);
+
+      template <typename I>
+        void insert(I first, I last)
+        {
+          for ( ; first != last; ++first)
+            insert(*first);
+        }
+
+      // Returns false if x was not inserted, and true if it was or if x is
+      // a false positive.
+      bool contains(const T& x) const;
+
+      // Returns the memory footprint of the bits.
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(words_);
+      }
+
+      void swap(blocked_bloom_filter& x)
+      {
+        using std::swap;
+        swap(hash_, x.hash_);
+        words_.swap(x.words_);
+        swap(blocks_, x.blocks_);
+        swap(size_, x.size_);
+      }
+
+    private:
+      // Returns the block of the mixed hash h. The high half of h is
+      // reduced to the number of blocks by a multiplication, and the low
+      // half selects the bits.
+      const std::uint64_t* block(std::uint64_t h) const
+      {
+        std::uint64_t b = ((h >> 32) * blocks_) >> 32;
+        return words_.data() + b * bloom_filter_impl::block_words;
+      }
+
+      std::uint64_t* block(std::uint64_t h)
+      {
+        std::uint64_t b = ((h >> 32) * blocks_) >> 32;
+        return words_.data() + b * bloom_filter_impl::block_words;
+      }
+
+    private:
+      H          hash_;
+      words_type words_;
+      size_type  blocks_;
+      size_type  size_;
+    };
+
+  template <typename T, typename H>
+    void
+    blocked_bloom_filter<T, H>::reset(size_type n, size_type bits)
+    {
+      using bloom_filter_impl::block_bits;
+      using bloom_filter_impl::block_words;
+      blocks_ = (n * bits + block_bits - 1) / block_bits;
+      if (blocks_ == 0)
+        blocks_ = 1;
+      words_.assign(blocks_ * block_words, 0);
+      size_ = 0;
+    }
+
+  template <typename T, typename H>
+    inline void
+    blocked_bloom_filter<T, H>::clear()
+    {
+      std::fill(words_.begin(), words_.end(), 0);
+      size_ = 0;
+    }
+
+  template <typename T, typename H>
+    inline void
+    blocked_bloom_filter<T, H>::insert(const T& x)
+    {
+      if (blocks_ == 0)
+        reset(1);
+      std::uint64_t h = hash_mix(hash_(x));
+      bloom_filter_impl::set_bits(block(h), std::uint32_t(h));
+      ++size_;
+    }
+
+  template <typename T, typename H>
+    inline bool
+    blocked_bloom_filter<T, H>::contains(const T& x) const
+    {
+      if (blocks_ == 0)
+        return false;
+      std::uint64_t h = hash_mix(hash_(x));
+      return bloom_filter_impl::test_bits(block(h), std::uint32_t(h));
+    }
+
+  template <typename T, typename H>
+    inline void
+    swap(blocked_bloom_filter<T, H>& a, blocked_bloom_filter<T, H>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
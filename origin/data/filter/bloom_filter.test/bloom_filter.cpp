@@ -0,0 +1,73 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include <origin/data/filter/bloom_filter.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Every inserted value is found, and few of the others are.
+void check_dense(size_t n, size_t bits, size_t limit)
+{
+  blocked_bloom_filter<size_t> f(n, bits);
+  assert(f.block_count() == (n * bits + 511) / 512);
+  for (size_t i = 0; i != n; ++i)
+    f.insert(2 * i);
+  assert(f.size() == n);
+  for (size_t i = 0; i != n; ++i)
+    assert(f.contains(2 * i));
+
+  size_t fp = 0;
+  for (size_t i = 0; i != n; ++i)
+    fp += f.contains(2 * i + 1);
+  assert(fp * 1000 <= n * limit);
+}
+
+void check_strings()
+{
+  vector<string> ws {"alpha", "beta", "gamma", "delta"};
+  blocked_bloom_filter<string> f(ws.size());
+  f.insert(ws.begin(), ws.end());
+  for (const string& w : ws)
+    assert(f.contains(w));
+
+  f.clear();
+  assert(f.empty());
+  for (const string& w : ws)
+    assert(!f.contains(w));
+}
+
+void check_default()
+{
+  blocked_bloom_filter<int> f;
+  assert(f.block_count() == 0);
+  assert(!f.contains(1));
+  f.insert(1);
+  assert(f.contains(1));
+  assert(f.block_count() == 1);
+  assert(f.memory_usage().live == 64);
+
+  blocked_bloom_filter<int> g(1000);
+  g.insert(2);
+  swap(f, g);
+  assert(f.contains(2));
+  assert(g.contains(1));
+  assert(g.block_count() == 1);
+}
+
+int main()
+{
+  check_dense(100000, 10, 20);
+  check_dense(100000, 16, 3);
+  check_dense(10, 10, 1000);
+  check_strings();
+  check_default();
+}
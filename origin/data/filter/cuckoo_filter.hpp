@@ -0,0 +1,338 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FILTER_CUCKOO_FILTER_HPP
+#define ORIGIN_DATA_FILTER_CUCKOO_FILTER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <origin/type/hash.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  namespace cuckoo_filter_impl
+  {
+    // A bucket is a word of 4 fingerprints of 16 bits. The fingerprint 0
+    // marks an empty slot.
+    using bucket = std::uint64_t;
+    using fingerprint = std::uint16_t;
+
+    constexpr std::size_t slots = 4;
+    constexpr bucket lsbs = 0x0001000100010001ull;
+    constexpr bucket msbs = 0x8000800080008000ull;
+
+    inline fingerprint
+    get(bucket b, std::size_t i)
+    {
+      return fingerprint(b >> (16 * i));
+    }
+
+    inline bucket
+    put(bucket b, std::size_t i, fingerprint f)
+    {
+      return (b & ~(bucket(0xffff) << (16 * i))) | (bucket(f) << (16 * i));
+    }
+
+    // Returns true if some slot of b holds f. The slots are compared at
+    // once: a slot of b ^ (f in each slot) is zero where f is.
+    inline bool
+    has(bucket b, fingerprint f)
+    {
+      bucket x = b ^ (lsbs * f);
+      return ((x - lsbs) & ~x & msbs) != 0;
+    }
+
+    // Returns the first slot of b that holds f, or slots if there is none.
+    inline std::size_t
+    find(bucket b, fingerprint f)
+    {
+      for (std::size_t i = 0; i != slots; ++i)
+        if (get(b, i) == f)
+          return i;
+      return slots;
+    }
+  } // namespace cuckoo_filter_impl
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Cuckoo Filter                                            data.cuckoo_filter
+  //
+  // A cuckoo filter is a set that may report false positives, like a Bloom
+  // filter (see data.bloom_filter), from which values can also be erased.
+  // It is that of Fan, Andersen, Kaminsky and Mitzenmacher: a cuckoo hash
+  // table of buckets of 4 slots, which stores a 16-bit fingerprint of each
+  // value rather than the value. A value may be in one of two buckets, the
+  // second of which is computed from the first and the fingerprint, so that
+  // a fingerprint can be moved to its other bucket without knowing its
+  // value. A query reads two buckets, each one word, and compares the
+  // fingerprint with their 4 slots at once. About 0.01% of the values that
+  // were not inserted are reported.
+  //
+  // When both buckets of a value are full, insertion evicts a fingerprint
+  // from one of them, and moves it to its other bucket, evicting another if
+  // that is full, up to 500 times. If there is still a fingerprint without
+  // a bucket, it is kept aside, and the filter is full: later insertions
+  // fail, and return false, until a value is erased. A filter is full at
+  // around 95% of its capacity, but may be much sooner if a value is
+  // inserted more than 8 times.
+  //
+  // Only values that were inserted may be erased. Erasing any other value
+  // may erase the fingerprint of a value that was inserted, which would
+  // then be reported as absent.
+  //
+  // The user's hash is mixed before it is used, as in data.flat_hash_set.
+  //
+  // Template Parameters:
+  //    T -- The value type
+  //    H -- The hash function
+  template <typename T, typename H = std::hash<T>>
+    class cuckoo_filter
+    {
+      using bucket = cuckoo_filter_impl::bucket;
+      using fingerprint = cuckoo_filter_impl::fingerprint;
+    public:
+      using value_type = T;
+      using hasher = H;
+      using size_type = std::size_t;
+
+      static constexpr size_type max_kicks = 500;
+
+      cuckoo_filter()
+        : mask_(0), size_(0), victim_(0), victim_index_(0), seed_(1)
+      { }
+
+      // Construct a filter with room for at least n values.
+      explicit cuckoo_filter(size_type n, const H& h = H())
+        : hash_(h), mask_(0), size_(0), victim_(0), victim_index_(0),
+          seed_(1)
+      {
+        reset(n);
+      }
+
+      // Remove all values, and make room for at least n values.
+      void reset(size_type n);
+
+      // Remove all values.
+      void clear();
+
+      // Returns the number of values in the filter.
+      size_type size() const { return size_; }
+      bool empty() const { return size_ == 0; }
+
+      // Returns the number of slots of the filter.
+      size_type capacity() const { return buckets_.size() * 4; }
+      size_type bucket_count() const { return buckets_.size(); }
+
+      // Returns true if the filter is full, so that insertions fail.
+      bool full() const { return victim_ != 0; }
+
+      hasher hash_function() const { return hash_; }
+
+      // Add x to the filter, returning false if the filter is full, in which
+      // case x is not added.
+      bool insert(const T& x);
+
+      // Remove x, which was inserted, from the filter. Returns false if x
+      // was not found.
+      bool erase(const T& x);
+
+      // Returns false if x is not in the filter, and true if it is or if x
+      // is a false positive.
+      bool contains(const T& x) const;
+
+      // Returns the memory footprint of the buckets.
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(buckets_);
+      }
+
+      void swap(cuckoo_filter& x)
+      {
+        using std::swap;
+        swap(hash_, x.hash_);
+        buckets_.swap(x.buckets_);
+        swap(mask_, x.mask_);
+        swap(size_, x.size_);
+        swap(victim_, x.victim_);
+        swap(victim_index_, x.victim_index_);
+        swap(seed_, x.seed_);
+      }
+
+    private:
+      // Split the mixed hash of x into its fingerprint and first bucket.
+      void locate(const T& x, fingerprint& f, size_type& i) const
+      {
+        std::uint64_t h = hash_mix(hash_(x));
+        f = fingerprint(h >> 48);
+        if (f == 0)
+          f = 1;
+        i = h & mask_;
+      }
+
+      // Returns the other bucket of the fingerprint f in the bucket i.
+      size_type other(size_type i, fingerprint f) const
+      {
+        return (i ^ hash_mix(f)) & mask_;
+      }
+
+      // Store f in an empty slot of the bucket i, if there is one.
+      bool place(size_type i, fingerprint f)
+      {
+        std::size_t s = cuckoo_filter_impl::find(buckets_[i], 0);
+        if (s == cuckoo_filter_impl::slots)
+          return false;
+        buckets_[i] = cuckoo_filter_impl::put(buckets_[i], s, f);
+        return true;
+      }
+
+      // Store f in the full bucket i, moving fingerprints to their other
+      // buckets to make room. If there is still no room after max_kicks
+      // moves, the last fingerprint moved is kept as the victim.
+      void relocate(size_type i, fingerprint f);
+
+      // Returns a pseudo-random number, for the choice of evictions.
+      std::uint32_t next()
+      {
+        seed_ = seed_ * 1103515245u + 12345u;
+        return seed_ >> 16;
+      }
+
+    private:
+      H                   hash_;
+      std::vector<bucket> buckets_;
+      size_type           mask_;
+      size_type           size_;
+      fingerprint         victim_;       // A fingerprint without a bucket
+      size_type           victim_index_; // One of the buckets of the victim
+      std::uint32_t       seed_;
+    };
+
+  template <typename T, typename H>
+    void
+    cuckoo_filter<T, H>::reset(size_type n)
+    {
+      // Leave 5% of the slots free, so that insertions rarely fail.
+      size_type b = 1;
+      while (b * cuckoo_filter_impl::slots * 19 < n * 20)
+        b *= 2;
+      buckets_.assign(b, 0);
+      mask_ = b - 1;
+      size_ = 0;
+      victim_ = 0;
+    }
+
+  template <typename T, typename H>
+    inline void
+    cuckoo_filter<T, H>::clear()
+    {
+      std::fill(buckets_.begin(), buckets_.end(), 0);
+      size_ = 0;
+      victim_ = 0;
+    }
+
+  template <typename T, typename H>
+    bool
+    cuckoo_filter<T, H>::insert(const T& x)
+    {
+      if (buckets_.empty())
+        reset(1);
+      if (full())
+        return false;
+      fingerprint f;
+      size_type i;
+      locate(x, f, i);
+      ++size_;
+      if (!place(i, f) && !place(other(i, f), f))
+        relocate(next() & 1 ? i : other(i, f), f);
+      return true;
+    }
+
+  template <typename T, typename H>
+    void
+    cuckoo_filter<T, H>::relocate(size_type i, fingerprint f)
+    {
+      using namespace cuckoo_filter_impl;
+      for (size_type k = 0; k != max_kicks; ++k) {
+        std::size_t s = next() % slots;
+        fingerprint g = get(buckets_[i], s);
+        buckets_[i] = put(buckets_[i], s, f);
+        f = g;
+        i = other(i, f);
+        if (place(i, f))
+          return;
+      }
+      victim_ = f;
+      victim_index_ = i;
+    }
+
+  template <typename T, typename H>
+    bool
+    cuckoo_filter<T, H>::erase(const T& x)
+    {
+      using namespace cuckoo_filter_impl;
+      if (buckets_.empty())
+        return false;
+      fingerprint f;
+      size_type i;
+      locate(x, f, i);
+      size_type j = other(i, f);
+      if (victim_ == f && (victim_index_ == i || victim_index_ == j)) {
+        victim_ = 0;
+        --size_;
+        return true;
+      }
+      std::size_t s = find(buckets_[i], f);
+      if (s == slots) {
+        i = j;
+        s = find(buckets_[i], f);
+        if (s == slots)
+          return false;
+      }
+      buckets_[i] = put(buckets_[i], s, 0);
+      --size_;
+
+      // The erasure made room for the victim.
+      if (victim_) {
+        fingerprint v = victim_;
+        victim_ = 0;
+        if (!place(victim_index_, v) && !place(other(victim_index_, v), v))
+          relocate(victim_index_, v);
+      }
+      return true;
+    }
+
+  template <typename T, typename H>
+    inline bool
+    cuckoo_filter<T, H>::contains(const T& x) const
+    {
+      using namespace cuckoo_filter_impl;
+      if (buckets_.empty())
+        return false;
+      fingerprint f;
+      size_type i;
+      locate(x, f, i);
+      size_type j = other(i, f);
+      return has(buckets_[i], f) || has(buckets_[j], f)
+          || (victim_ == f && (victim_index_ == i || victim_index_ == j));
+    }
+
+  template <typename T, typename H>
+    inline void
+    swap(cuckoo_filter<T, H>& a, cuckoo_filter<T, H>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
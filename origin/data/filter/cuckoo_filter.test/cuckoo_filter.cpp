@@ -0,0 +1,118 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <unordered_map>
+
+#include <origin/data/filter/cuckoo_filter.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Random insertions and erasures are checked against a multiset: every
+// value in it is found, and few of the others are.
+void check_random()
+{
+  minstd_rand gen(7);
+  uniform_int_distribution<size_t> dist(0, 20000);
+  cuckoo_filter<size_t> f(10000);
+  unordered_map<size_t, int> u;
+  size_t n = 0;
+  for (int i = 0; i != 100000; ++i) {
+    size_t x = dist(gen);
+    if (u[x] == 0 || dist(gen) < 10500) {
+      if (f.insert(x)) {
+        ++u[x];
+        ++n;
+      }
+    } else {
+      assert(f.erase(x));
+      --u[x];
+      --n;
+    }
+    assert(f.size() == n);
+  }
+  for (const auto& p : u)
+    if (p.second)
+      assert(f.contains(p.first));
+
+  size_t fp = 0;
+  for (size_t x = 100000; x != 200000; ++x)
+    fp += f.contains(x);
+  assert(fp < 100);
+}
+
+// Fill the filter until it is full, then erase everything.
+void check_full()
+{
+  cuckoo_filter<size_t> f(900);
+  assert(f.capacity() == 1024);
+  size_t n = 0;
+  while (f.insert(n))
+    ++n;
+  assert(f.full());
+  assert(n * 10 >= f.capacity() * 9);
+  for (size_t i = 0; i != n; ++i)
+    assert(f.contains(i));
+
+  // Erasing a value makes room for the one without a bucket.
+  assert(f.erase(0));
+  assert(!f.full());
+  for (size_t i = 1; i != n; ++i)
+    assert(f.contains(i));
+  for (size_t i = 1; i != n; ++i)
+    assert(f.erase(i));
+  assert(f.empty());
+}
+
+// A value inserted many times fills its two buckets, and needs as many
+// erasures.
+void check_repeated()
+{
+  cuckoo_filter<size_t> f(1000);
+  size_t n = 0;
+  while (f.insert(42))
+    ++n;
+  assert(n == 9);
+  assert(!f.insert(43));
+  for (size_t i = 0; i != n; ++i) {
+    assert(f.contains(42));
+    assert(f.erase(42));
+  }
+  assert(!f.contains(42));
+  assert(!f.erase(42));
+  assert(f.empty());
+  assert(f.insert(43));
+}
+
+void check_default()
+{
+  cuckoo_filter<int> f;
+  assert(!f.contains(1));
+  assert(!f.erase(1));
+  assert(f.insert(1));
+  assert(f.contains(1));
+
+  cuckoo_filter<int> g(100);
+  g.insert(2);
+  swap(f, g);
+  assert(f.contains(2));
+  assert(g.contains(1));
+  g.clear();
+  assert(g.empty());
+  assert(!g.contains(1));
+  assert(g.memory_usage().live == g.bucket_count() * 8);
+}
+
+int main()
+{
+  check_random();
+  check_full();
+  check_repeated();
+  check_default();
+}
@@ -0,0 +1,894 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FLAT_HASH_IMPL_TABLE_HPP
+#define ORIGIN_DATA_FLAT_HASH_IMPL_TABLE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+#include <origin/type/traits.hpp>
+#include <origin/sequence/random.hpp>
+
+namespace origin
+{
+  namespace flat_hash_impl
+  {
+    // The control byte of a slot is one of the following values, or the
+    // low 7 bits of the hash of the key in the slot, which is non-negative.
+    using ctrl_t = signed char;
+
+    constexpr ctrl_t ctrl_empty = -128;
+    constexpr ctrl_t ctrl_deleted = -2;
+    constexpr ctrl_t ctrl_sentinel = -1;
+
+    // A group is a window of control bytes that are matched at once. The
+    // masks returned by a group have the bit (or byte) i set when the ith
+    // byte matches.
+#if defined(__SSE2__)
+    struct group
+    {
+      using mask = std::uint32_t;
+
+      static constexpr std::size_t width = 16;
+
+      explicit group(const ctrl_t* p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))
+      { }
+
+      // Returns the slots whose control byte is h.
+      mask match(ctrl_t h) const
+      {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), ctrl));
+      }
+
+      mask match_empty() const { return match(ctrl_empty); }
+
+      mask match_empty_or_deleted() const
+      {
+        __m128i s = _mm_set1_epi8(ctrl_sentinel);
+        return _mm_movemask_epi8(_mm_cmpgt_epi8(s, ctrl));
+      }
+
+      // Returns the index of the first slot of the non-zero mask m, and the
+      // number of slots after its last.
+      static std::size_t lowest(mask m) { return __builtin_ctz(m); }
+      static std::size_t leading(mask m) { return __builtin_clz(m) - 16; }
+
+      __m128i ctrl;
+    };
+#else
+    // Without vector instructions, a group is 8 bytes, which are matched by
+    // word operations. The match of h2 may report a full slot that does not
+    // match, which is harmless since the keys are compared.
+    struct group
+    {
+      using mask = std::uint64_t;
+
+      static constexpr std::size_t width = 8;
+      static constexpr mask lsbs = 0x0101010101010101ull;
+      static constexpr mask msbs = 0x8080808080808080ull;
+
+      explicit group(const ctrl_t* p)
+      {
+        std::memcpy(&ctrl, p, sizeof(ctrl));
+      }
+
+      mask match(ctrl_t h) const
+      {
+        mask x = ctrl ^ (lsbs * static_cast<unsigned char>(h));
+        return (x - lsbs) & ~x & msbs;
+      }
+
+      mask match_empty() const { return (ctrl & ~(ctrl << 6)) & msbs; }
+
+      mask match_empty_or_deleted() const
+      {
+        return (ctrl & ~(ctrl << 7)) & msbs;
+      }
+
+      static std::size_t lowest(mask m) { return __builtin_ctzll(m) >> 3; }
+      static std::size_t leading(mask m) { return __builtin_clzll(m) >> 3; }
+
+      mask ctrl;
+    };
+#endif
+
+    // Returns the least capacity, one less than a power of two and at least
+    // the width of a group less one, that is at least n.
+    inline std::size_t
+    normalize_capacity(std::size_t n)
+    {
+      std::size_t c = group::width - 1;
+      while (c < n)
+        c = 2 * c + 1;
+      return c;
+    }
+
+    // Returns the number of elements that a table of capacity c holds
+    // before it grows: 7/8 of its slots.
+    inline std::size_t
+    capacity_to_growth(std::size_t c)
+    {
+      return c == 7 ? 6 : c - c / 8;
+    }
+
+    // Returns a capacity large enough to hold n elements without growing.
+    inline std::size_t
+    growth_to_capacity(std::size_t n)
+    {
+      return n == 0 ? 0 : n + (n - 1) / 7;
+    }
+
+    // The hash function of the table mixes the user's hash, so that hashes
+    // of dense handles, which are usually their indexes, fill the table.
+    inline std::size_t
+    mix_hash(std::size_t h)
+    {
+      return random_impl::mix(h);
+    }
+
+    // The key argument of a lookup is the key type, unless both the hash
+    // function and key equality are transparent, in which case it is any
+    // type that they accept.
+    template <typename T, typename = void>
+      struct is_transparent : std::false_type { };
+
+    template <typename T>
+      struct is_transparent<T, typename std::conditional<
+                                 true, void, typename T::is_transparent>::type>
+        : std::true_type
+      { };
+
+    template <bool B>
+      struct key_arg_impl
+      {
+        template <typename K, typename Key>
+          using type = Key;
+      };
+
+    template <>
+      struct key_arg_impl<true>
+      {
+        template <typename K, typename Key>
+          using type = K;
+      };
+
+    // The element type and key of a set and a map.
+    template <typename K>
+      struct set_policy
+      {
+        using key_type = K;
+        using value_type = K;
+
+        // Set elements are not modified through iterators.
+        static constexpr bool constant = true;
+
+        static const K& key(const value_type& x) { return x; }
+      };
+
+    template <typename K, typename V>
+      struct map_policy
+      {
+        using key_type = K;
+        using value_type = std::pair<const K, V>;
+
+        static constexpr bool constant = false;
+
+        static const K& key(const value_type& x) { return x.first; }
+      };
+
+
+    // An iterator over the full slots of a table. The control bytes end with
+    // the sentinel, which stops the iteration.
+    template <typename V>
+      class table_iterator
+      {
+        template <typename U>
+          friend class table_iterator;
+
+        template <typename P, typename H, typename E, typename A>
+          friend class table;
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename std::remove_const<V>::type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = V*;
+        using reference         = V&;
+
+        table_iterator()
+          : ctrl_(nullptr), slot_(nullptr)
+        { }
+
+        template <typename U,
+                  typename = Requires<Convertible<U*, V*>()>>
+          table_iterator(const table_iterator<U>& x)
+            : ctrl_(x.ctrl_), slot_(x.slot_)
+          { }
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        table_iterator& operator++()
+        {
+          ++ctrl_;
+          ++slot_;
+          skip();
+          return *this;
+        }
+
+        table_iterator operator++(int)
+        {
+          table_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        // Iterators and const iterators are compared.
+        template <typename U>
+          bool operator==(const table_iterator<U>& x) const
+          {
+            return ctrl_ == x.ctrl_;
+          }
+
+        template <typename U>
+          bool operator!=(const table_iterator<U>& x) const
+          {
+            return ctrl_ != x.ctrl_;
+          }
+
+      private:
+        table_iterator(const ctrl_t* c, V* s)
+          : ctrl_(c), slot_(s)
+        { }
+
+        // Move past the empty and deleted slots.
+        void skip()
+        {
+          while (*ctrl_ < ctrl_sentinel) {
+            ++ctrl_;
+            ++slot_;
+          }
+        }
+
+        const ctrl_t* ctrl_;
+        V* slot_;
+      };
+
+
+    // The table is the implementation of flat_hash_set and flat_hash_map.
+    // The policy P gives the element type and the key of each element.
+    template <typename P, typename H, typename E, typename A>
+      class table
+      {
+        using traits = std::allocator_traits<A>;
+        using ctrl_allocator = typename traits::template rebind_alloc<ctrl_t>;
+        using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+        template <typename K>
+          using key_arg = typename key_arg_impl<
+            is_transparent<H>::value && is_transparent<E>::value
+          >::template type<K, typename P::key_type>;
+
+        static constexpr std::size_t npos = -1;
+      public:
+        using key_type        = typename P::key_type;
+        using value_type      = typename P::value_type;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher          = H;
+        using key_equal       = E;
+        using allocator_type  = A;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using pointer         = typename traits::pointer;
+        using const_pointer   = typename traits::const_pointer;
+        using iterator        = table_iterator<
+          typename std::conditional<P::constant,
+                                    const value_type,
+                                    value_type>::type>;
+        using const_iterator  = table_iterator<const value_type>;
+
+        // Construction
+        explicit table(size_type n = 0,
+                       const H& hash = H(),
+                       const E& eq = E(),
+                       const A& alloc = A())
+          : hash_(hash), eq_(eq), alloc_(alloc),
+            ctrl_(nullptr), slots_(nullptr),
+            capacity_(0), size_(0), growth_left_(0)
+        {
+          if (n != 0)
+            resize(normalize_capacity(n));
+        }
+
+        explicit table(const A& alloc)
+          : table(0, H(), E(), alloc)
+        { }
+
+        template <typename I>
+          table(I first, I last,
+                size_type n = 0,
+                const H& hash = H(),
+                const E& eq = E(),
+                const A& alloc = A())
+            : table(n, hash, eq, alloc)
+          {
+            insert(first, last);
+          }
+
+        table(std::initializer_list<value_type> list,
+              size_type n = 0,
+              const H& hash = H(),
+              const E& eq = E(),
+              const A& alloc = A())
+          : table(list.begin(), list.end(), n, hash, eq, alloc)
+        { }
+
+        table(const table& x);
+        table(table&& x);
+        ~table();
+
+        // The assignment of a table copies (or moves) the allocator, the
+        // hash function and key equality with the elements.
+        table& operator=(const table& x)
+        {
+          table tmp(x);
+          swap(tmp);
+          return *this;
+        }
+
+        table& operator=(table&& x)
+        {
+          table tmp(std::move(x));
+          swap(tmp);
+          return *this;
+        }
+
+        table& operator=(std::initializer_list<value_type> list)
+        {
+          clear();
+          insert(list.begin(), list.end());
+          return *this;
+        }
+
+        // Iterators
+        iterator begin() { return make_begin<iterator>(slots_); }
+        iterator end()
+        {
+          return iterator(ctrl_ + capacity_, slots_ + capacity_);
+        }
+
+        const_iterator begin() const { return cbegin(); }
+        const_iterator end() const { return cend(); }
+
+        const_iterator cbegin() const
+        {
+          return make_begin<const_iterator>(slots_);
+        }
+        const_iterator cend() const
+        {
+          return const_iterator(ctrl_ + capacity_, slots_ + capacity_);
+        }
+
+        // Capacity
+        bool      empty() const { return size_ == 0; }
+        size_type size() const { return size_; }
+        size_type max_size() const { return traits::max_size(alloc_); }
+
+        // Returns the number of slots of the table, and the number of
+        // elements it can hold before it grows.
+        size_type capacity() const { return capacity_; }
+        size_type bucket_count() const { return capacity_; }
+
+        float load_factor() const
+        {
+          return capacity_ ? float(size_) / capacity_ : 0.0f;
+        }
+
+        float max_load_factor() const { return 0.875f; }
+
+        // Insertion
+        std::pair<iterator, bool> insert(const value_type& x)
+        {
+          return emplace_key(P::key(x), x);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& x)
+        {
+          return emplace_key(P::key(x), std::move(x));
+        }
+
+        template <typename I>
+          void insert(I first, I last)
+          {
+            for ( ; first != last; ++first)
+              insert(*first);
+          }
+
+        void insert(std::initializer_list<value_type> list)
+        {
+          insert(list.begin(), list.end());
+        }
+
+        // Construct an element from args, and insert it if its key is not
+        // in the table.
+        template <typename... Args>
+          std::pair<iterator, bool> emplace(Args&&... args)
+          {
+            value_type x(std::forward<Args>(args)...);
+            return insert(std::move(x));
+          }
+
+        // Erasure
+        iterator erase(const_iterator pos)
+        {
+          iterator i(pos.ctrl_, slots_ + (pos.ctrl_ - ctrl_));
+          ++i;
+          erase_at(pos.ctrl_ - ctrl_);
+          return i;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+          while (first != last)
+            first = erase(first);
+          return iterator(last.ctrl_, slots_ + (last.ctrl_ - ctrl_));
+        }
+
+        template <typename K = key_type>
+          size_type erase(const key_arg<K>& k)
+          {
+            size_type i = find_index(k);
+            if (i == npos)
+              return 0;
+            erase_at(i);
+            return 1;
+          }
+
+        // Remove every element, keeping the capacity.
+        void clear();
+
+        void swap(table& x)
+        {
+          using std::swap;
+          swap(hash_, x.hash_);
+          swap(eq_, x.eq_);
+          swap(alloc_, x.alloc_);
+          swap(ctrl_, x.ctrl_);
+          swap(slots_, x.slots_);
+          swap(capacity_, x.capacity_);
+          swap(size_, x.size_);
+          swap(growth_left_, x.growth_left_);
+        }
+
+        // Lookup
+        template <typename K = key_type>
+          iterator find(const key_arg<K>& k)
+          {
+            return at_index<iterator>(find_index(k));
+          }
+
+        template <typename K = key_type>
+          const_iterator find(const key_arg<K>& k) const
+          {
+            return at_index<const_iterator>(find_index(k));
+          }
+
+        template <typename K = key_type>
+          bool contains(const key_arg<K>& k) const
+          {
+            return find_index(k) != npos;
+          }
+
+        template <typename K = key_type>
+          size_type count(const key_arg<K>& k) const
+          {
+            return contains(k);
+          }
+
+        template <typename K = key_type>
+          std::pair<iterator, iterator> equal_range(const key_arg<K>& k)
+          {
+            iterator i = find(k);
+            iterator j = i;
+            return {i, i == end() ? j : ++j};
+          }
+
+        template <typename K = key_type>
+          std::pair<const_iterator, const_iterator>
+          equal_range(const key_arg<K>& k) const
+          {
+            const_iterator i = find(k);
+            const_iterator j = i;
+            return {i, i == end() ? j : ++j};
+          }
+
+        // Hashing
+        //
+        // Reserving room for n elements ensures that inserting them does
+        // not grow the table. Rehashing to n slots sets the capacity to at
+        // least n, and enough for the elements; it also removes the
+        // tombstones left by erasure. A rehash to 0 slots of an empty table
+        // releases its storage.
+        void reserve(size_type n)
+        {
+          if (n > size_ + growth_left_)
+            resize(normalize_capacity(growth_to_capacity(n)));
+        }
+
+        void rehash(size_type n);
+
+        // Observers
+        hasher hash_function() const { return hash_; }
+        key_equal key_eq() const { return eq_; }
+        allocator_type get_allocator() const { return alloc_; }
+
+        // Equality comparable
+        friend bool operator==(const table& a, const table& b)
+        {
+          if (a.size() != b.size())
+            return false;
+          for (const value_type& x : a) {
+            const_iterator i = b.find(P::key(x));
+            if (i == b.end() || !(*i == x))
+              return false;
+          }
+          return true;
+        }
+
+        friend bool operator!=(const table& a, const table& b)
+        {
+          return !(a == b);
+        }
+
+      protected:
+        // The position of an element with a given key: the index of its
+        // slot, and whether the key was found. If it was not, the slot is
+        // free, and the element must be constructed in it and committed.
+        struct position
+        {
+          size_type index;
+          ctrl_t h2;
+          bool found;
+        };
+
+        template <typename K>
+          position find_or_prepare(const K& k);
+
+        // Record that an element has been constructed in the prepared slot.
+        void commit(position p);
+
+        template <typename K, typename... Args>
+          std::pair<iterator, bool> emplace_key(const K& k, Args&&... args)
+          {
+            position p = find_or_prepare(k);
+            if (!p.found) {
+              traits::construct(alloc_, slots_ + p.index,
+                                std::forward<Args>(args)...);
+              commit(p);
+            }
+            return {at_index<iterator>(p.index), !p.found};
+          }
+
+        template <typename It>
+          It at_index(size_type i) const
+          {
+            if (i == npos)
+              return It(ctrl_ + capacity_, slots_ + capacity_);
+            return It(ctrl_ + i, slots_ + i);
+          }
+
+      private:
+        template <typename It>
+          It make_begin(value_type* s) const
+          {
+            if (capacity_ == 0)
+              return It(ctrl_, s);
+            It i(ctrl_, s);
+            i.skip();
+            return i;
+          }
+
+        template <typename K>
+          std::size_t hash_of(const K& k) const
+          {
+            return mix_hash(hash_(k));
+          }
+
+        template <typename K>
+          size_type find_index(const K& k) const
+          {
+            return size_ == 0 ? npos : find_index(k, hash_of(k));
+          }
+
+        template <typename K>
+          size_type find_index(const K& k, std::size_t h) const;
+
+        size_type first_non_full(std::size_t h) const;
+
+        // Set the control byte of the slot i and of its clone after the
+        // sentinel, so that a group loaded near the end of the table wraps
+        // to its start.
+        void set_ctrl(size_type i, ctrl_t c)
+        {
+          const size_type w = group::width - 1;
+          ctrl_[i] = c;
+          ctrl_[((i - w) & capacity_) + w] = c;
+        }
+
+        void erase_at(size_type i);
+        void resize(size_type n);
+        void destroy_slots();
+
+        // Move the element at x into the free slot p, ending the lifetime
+        // of x. Trivially relocatable elements are copied (see
+        // type.relocatable).
+        void relocate_slot(value_type* p, value_type* x, std::true_type)
+        {
+          std::memcpy(static_cast<void*>(p), static_cast<void*>(x),
+                      sizeof(value_type));
+        }
+
+        void relocate_slot(value_type* p, value_type* x, std::false_type)
+        {
+          traits::construct(alloc_, p, std::move(*x));
+          traits::destroy(alloc_, x);
+        }
+
+      private:
+        H hash_;
+        E eq_;
+        A alloc_;
+
+        // The control bytes: one for each slot, the sentinel, and copies of
+        // the first group::width - 1 bytes.
+        ctrl_t* ctrl_;
+        value_type* slots_;
+        size_type capacity_;
+        size_type size_;
+        size_type growth_left_;
+      };
+
+    template <typename P, typename H, typename E, typename A>
+      table<P, H, E, A>::table(const table& x)
+        : hash_(x.hash_), eq_(x.eq_),
+          alloc_(traits::select_on_container_copy_construction(x.alloc_)),
+          ctrl_(nullptr), slots_(nullptr),
+          capacity_(0), size_(0), growth_left_(0)
+      {
+        reserve(x.size_);
+        for (const value_type& v : x) {
+          std::size_t h = hash_of(P::key(v));
+          position p {first_non_full(h), ctrl_t(h & 0x7f), false};
+          traits::construct(alloc_, slots_ + p.index, v);
+          commit(p);
+        }
+      }
+
+    template <typename P, typename H, typename E, typename A>
+      table<P, H, E, A>::table(table&& x)
+        : hash_(x.hash_), eq_(x.eq_), alloc_(std::move(x.alloc_)),
+          ctrl_(x.ctrl_), slots_(x.slots_),
+          capacity_(x.capacity_), size_(x.size_),
+          growth_left_(x.growth_left_)
+      {
+        x.ctrl_ = nullptr;
+        x.slots_ = nullptr;
+        x.capacity_ = x.size_ = x.growth_left_ = 0;
+      }
+
+    template <typename P, typename H, typename E, typename A>
+      table<P, H, E, A>::~table()
+      {
+        destroy_slots();
+      }
+
+    template <typename P, typename H, typename E, typename A>
+      void
+      table<P, H, E, A>::clear()
+      {
+        for (size_type i = 0; i != capacity_; ++i)
+          if (ctrl_[i] >= 0)
+            traits::destroy(alloc_, slots_ + i);
+        if (capacity_) {
+          std::memset(ctrl_, ctrl_empty, capacity_ + group::width);
+          ctrl_[capacity_] = ctrl_sentinel;
+        }
+        size_ = 0;
+        growth_left_ = capacity_to_growth(capacity_);
+      }
+
+    template <typename P, typename H, typename E, typename A>
+      void
+      table<P, H, E, A>::rehash(size_type n)
+      {
+        if (n == 0 && size_ == 0) {
+          destroy_slots();
+          ctrl_ = nullptr;
+          slots_ = nullptr;
+          capacity_ = growth_left_ = 0;
+          return;
+        }
+        size_type m = std::max(n, growth_to_capacity(size_));
+        resize(normalize_capacity(m));
+      }
+
+    // The probe sequence visits the groups at the offsets 0, width,
+    // 3 width, 6 width, and so on from the slot given by the high bits of
+    // the hash. Since the capacity is one less than a power of two, the
+    // sequence visits every group. Each group is matched against the low 7
+    // bits of the hash, and only the slots that match are compared. A group
+    // with an empty slot ends the search, since an insertion would have
+    // used that slot.
+    template <typename P, typename H, typename E, typename A>
+      template <typename K>
+        auto
+        table<P, H, E, A>::find_index(const K& k, std::size_t h) const
+          -> size_type
+        {
+          ctrl_t h2 = h & 0x7f;
+          size_type pos = (h >> 7) & capacity_;
+          size_type step = 0;
+          while (true) {
+            group g(ctrl_ + pos);
+            for (auto m = g.match(h2); m; m &= m - 1) {
+              size_type i = (pos + group::lowest(m)) & capacity_;
+              if (eq_(P::key(slots_[i]), k))
+                return i;
+            }
+            if (g.match_empty())
+              return npos;
+            step += group::width;
+            pos = (pos + step) & capacity_;
+          }
+        }
+
+    template <typename P, typename H, typename E, typename A>
+      auto
+      table<P, H, E, A>::first_non_full(std::size_t h) const -> size_type
+      {
+        size_type pos = (h >> 7) & capacity_;
+        size_type step = 0;
+        while (true) {
+          group g(ctrl_ + pos);
+          if (auto m = g.match_empty_or_deleted())
+            return (pos + group::lowest(m)) & capacity_;
+          step += group::width;
+          pos = (pos + step) & capacity_;
+        }
+      }
+
+    // A key that is not found is inserted in the first empty or deleted
+    // slot of its probe sequence. If the table has no room, it is rehashed:
+    // in place when at least a fifth of its slots are tombstones, and into
+    // twice the capacity otherwise.
+    template <typename P, typename H, typename E, typename A>
+      template <typename K>
+        auto
+        table<P, H, E, A>::find_or_prepare(const K& k) -> position
+        {
+          std::size_t h = hash_of(k);
+          ctrl_t h2 = h & 0x7f;
+          if (size_ != 0) {
+            size_type i = find_index(k, h);
+            if (i != npos)
+              return {i, h2, true};
+          }
+          if (capacity_ == 0)
+            resize(normalize_capacity(0));
+          size_type i = first_non_full(h);
+          if (growth_left_ == 0 && ctrl_[i] != ctrl_deleted) {
+            if (capacity_ > group::width && size_ * 32 <= capacity_ * 25)
+              resize(capacity_);
+            else
+              resize(2 * capacity_ + 1);
+            i = first_non_full(h);
+          }
+          return {i, h2, false};
+        }
+
+    template <typename P, typename H, typename E, typename A>
+      inline void
+      table<P, H, E, A>::commit(position p)
+      {
+        if (ctrl_[p.index] == ctrl_empty)
+          --growth_left_;
+        set_ctrl(p.index, p.h2);
+        ++size_;
+      }
+
+    // An erased slot can be marked empty if no probe sequence passed over
+    // it while it was full: that is, if every group containing it has an
+    // empty slot. Otherwise it is marked deleted, so that searches for the
+    // keys after it continue.
+    template <typename P, typename H, typename E, typename A>
+      void
+      table<P, H, E, A>::erase_at(size_type i)
+      {
+        traits::destroy(alloc_, slots_ + i);
+        --size_;
+        size_type before = (i - group::width) & capacity_;
+        auto empty_after = group(ctrl_ + i).match_empty();
+        auto empty_before = group(ctrl_ + before).match_empty();
+        bool never_full = empty_before && empty_after
+          && group::lowest(empty_after) + group::leading(empty_before)
+             < group::width;
+        set_ctrl(i, never_full ? ctrl_empty : ctrl_deleted);
+        if (never_full)
+          ++growth_left_;
+      }
+
+    // Move the elements into new storage of n slots.
+    template <typename P, typename H, typename E, typename A>
+      void
+      table<P, H, E, A>::resize(size_type n)
+      {
+        ctrl_allocator ca(alloc_);
+        ctrl_t* old_ctrl = ctrl_;
+        value_type* old_slots = slots_;
+        size_type old_capacity = capacity_;
+
+        slots_ = traits::allocate(alloc_, n);
+        try {
+          ctrl_ = ctrl_traits::allocate(ca, n + group::width);
+        } catch (...) {
+          traits::deallocate(alloc_, slots_, n);
+          slots_ = old_slots;
+          throw;
+        }
+        std::memset(ctrl_, ctrl_empty, n + group::width);
+        ctrl_[n] = ctrl_sentinel;
+        capacity_ = n;
+        growth_left_ = capacity_to_growth(n) - size_;
+
+        for (size_type i = 0; i != old_capacity; ++i) {
+          if (old_ctrl[i] < 0)
+            continue;
+          std::size_t h = hash_of(P::key(old_slots[i]));
+          size_type j = first_non_full(h);
+          set_ctrl(j, h & 0x7f);
+          relocate_slot(slots_ + j, old_slots + i,
+                        is_trivially_relocatable<value_type>());
+        }
+        if (old_capacity) {
+          traits::deallocate(alloc_, old_slots, old_capacity);
+          ctrl_traits::deallocate(ca, old_ctrl, old_capacity + group::width);
+        }
+      }
+
+    template <typename P, typename H, typename E, typename A>
+      void
+      table<P, H, E, A>::destroy_slots()
+      {
+        if (capacity_ == 0)
+          return;
+        for (size_type i = 0; i != capacity_; ++i)
+          if (ctrl_[i] >= 0)
+            traits::destroy(alloc_, slots_ + i);
+        traits::deallocate(alloc_, slots_, capacity_);
+        ctrl_allocator ca(alloc_);
+        ctrl_traits::deallocate(ca, ctrl_, capacity_ + group::width);
+      }
+
+  } // namespace flat_hash_impl
+} // namespace origin
+
+#endif
@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FLAT_HASH_FLAT_HASH_MAP_HPP
+#define ORIGIN_DATA_FLAT_HASH_FLAT_HASH_MAP_HPP
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <origin/data/concepts.hpp>
+#include <origin/data/flat_hash/flat_hash.impl/table.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Flat Hash Map                                            data.flat_hash_map
+  //
+  // A flat hash map is an unordered map stored in the same open-addressing
+  // table as a flat hash set (see data.flat_hash_set). The elements are
+  // pairs of a key and a mapped value, stored in the slots of the table.
+  // As with the set, lookups are heterogeneous when H and E are both
+  // transparent, and insertion may invalidate every iterator.
+  //
+  // In addition to the operations of the set, a map has operator[], at,
+  // try_emplace, which constructs the mapped value only when the key is
+  // not in the map, and insert_or_assign.
+  //
+  // Template Parameters:
+  //    K -- The key type
+  //    V -- The mapped type
+  //    H -- The hash function
+  //    E -- The key equality
+  //    A -- The allocator of the elements
+  template <typename K,
+            typename V,
+            typename H = std::hash<K>,
+            typename E = std::equal_to<K>,
+            typename A = std::allocator<std::pair<const K, V>>>
+    class flat_hash_map
+      : public flat_hash_impl::table<flat_hash_impl::map_policy<K, V>, H, E, A>
+    {
+      using base =
+        flat_hash_impl::table<flat_hash_impl::map_policy<K, V>, H, E, A>;
+    public:
+      using mapped_type = V;
+      using typename base::key_type;
+      using typename base::value_type;
+      using typename base::iterator;
+
+      using base::base;
+      using base::operator=;
+
+      flat_hash_map() = default;
+
+      // Element access
+      V& operator[](const K& k) { return try_emplace(k).first->second; }
+      V& operator[](K&& k) { return try_emplace(std::move(k)).first->second; }
+
+      V& at(const K& k);
+      const V& at(const K& k) const;
+
+      // Insert an element whose mapped value is constructed from args, if
+      // the key k is not in the map.
+      template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const K& k, Args&&... args)
+        {
+          return this->emplace_key(k, std::piecewise_construct,
+                                   std::forward_as_tuple(k),
+                                   std::forward_as_tuple(
+                                     std::forward<Args>(args)...));
+        }
+
+      template <typename... Args>
+        std::pair<iterator, bool> try_emplace(K&& k, Args&&... args)
+        {
+          return this->emplace_key(k, std::piecewise_construct,
+                                   std::forward_as_tuple(std::move(k)),
+                                   std::forward_as_tuple(
+                                     std::forward<Args>(args)...));
+        }
+
+      // Insert the element (k, x), or assign x to the mapped value of k.
+      template <typename X>
+        std::pair<iterator, bool> insert_or_assign(const K& k, X&& x)
+        {
+          auto r = try_emplace(k, std::forward<X>(x));
+          if (!r.second)
+            r.first->second = std::forward<X>(x);
+          return r;
+        }
+    };
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    V&
+    flat_hash_map<K, V, H, E, A>::at(const K& k)
+    {
+      auto i = this->find(k);
+      if (i == this->end())
+        throw std::out_of_range("flat_hash_map::at");
+      return i->second;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    const V&
+    flat_hash_map<K, V, H, E, A>::at(const K& k) const
+    {
+      auto i = this->find(k);
+      if (i == this->end())
+        throw std::out_of_range("flat_hash_map::at");
+      return i->second;
+    }
+
+  template <typename K, typename V, typename H, typename E, typename A>
+    inline void
+    swap(flat_hash_map<K, V, H, E, A>& a, flat_hash_map<K, V, H, E, A>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
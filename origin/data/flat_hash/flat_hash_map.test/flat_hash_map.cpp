@@ -0,0 +1,86 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <origin/data/flat_hash/flat_hash_map.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check random updates against an unordered map.
+void check_random()
+{
+  minstd_rand gen(7);
+  uniform_int_distribution<int> dist(0, 3000);
+  flat_hash_map<int, int> m;
+  unordered_map<int, int> u;
+  for (int i = 0; i != 30000; ++i) {
+    int k = dist(gen);
+    int op = dist(gen) % 4;
+    if (op == 0) {
+      assert(m.erase(k) == u.erase(k));
+    } else if (op == 1) {
+      m[k] += i;
+      u[k] += i;
+    } else {
+      auto r = m.insert({k, i});
+      assert(r.second == u.insert({k, i}).second);
+      assert(r.first->first == k && r.first->second == u[k]);
+    }
+  }
+  assert(m.size() == u.size());
+  for (const auto& x : m)
+    assert(u.at(x.first) == x.second);
+  for (const auto& x : u)
+    assert(m.at(x.first) == x.second);
+
+  // Mapped values are modified through iterators.
+  for (auto& x : m)
+    x.second = -x.first;
+  const flat_hash_map<int, int>& c = m;
+  for (auto i = c.begin(); i != c.end(); ++i)
+    assert(i->second == -i->first && c.at(i->first) == i->second);
+}
+
+void check_access()
+{
+  flat_hash_map<string, unique_ptr<int>> m;
+  assert(m.try_emplace("a", new int(1)).second);
+  assert(!m.try_emplace("a", nullptr).second && *m["a"] == 1);
+  string b = "b";
+  m.try_emplace(std::move(b));
+  assert(m.size() == 2 && !m["b"]);
+
+  flat_hash_map<string, int> n;
+  n["x"] = 1;
+  assert(n.insert_or_assign("x", 2).second == false && n["x"] == 2);
+  assert(n.insert_or_assign("y", 3).second && n.at("y") == 3);
+  bool thrown = false;
+  try {
+    n.at("z");
+  } catch (out_of_range&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  auto r = n.equal_range("x");
+  assert(r.first != n.end() && r.first->second == 2);
+  assert(++r.first == r.second);
+  assert(n.emplace("z", 4).second && n.count("z") == 1);
+}
+
+int main()
+{
+  check_random();
+  check_access();
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FLAT_HASH_FLAT_HASH_SET_HPP
+#define ORIGIN_DATA_FLAT_HASH_FLAT_HASH_SET_HPP
+
+#include <functional>
+#include <memory>
+
+#include <origin/data/concepts.hpp>
+#include <origin/data/flat_hash/flat_hash.impl/table.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Flat Hash Set                                            data.flat_hash_set
+  //
+  // A flat hash set is an unordered set that stores its elements in one
+  // array of slots, with open addressing, in the manner of Google's
+  // SwissTable. Each slot has a control byte that says whether it is empty,
+  // deleted, or full; a full slot's byte holds 7 bits of the hash of its
+  // element. A lookup probes groups of 16 control bytes (8 without SSE2),
+  // and matches the hash bits against the whole group in a few vector
+  // instructions, so that keys are compared only in the slots that are
+  // likely to hold them. Elements are not allocated one by one, and a
+  // table grows when it is 7/8 full.
+  //
+  // The user's hash is mixed before it is split into the probe position and
+  // the control bits, so that hashes that are not well distributed, such as
+  // the std::hash of vertex and edge handles (see graph.handle), work well.
+  //
+  // If both H and E define is_transparent, the lookup operations (find,
+  // contains, count, equal_range and erase by key) accept any key type that
+  // they do, so that a set of strings can be searched with a string view
+  // without constructing a string.
+  //
+  // Unlike std::unordered_set, inserting an element may invalidate every
+  // iterator and reference, and erasure invalidates only those to the
+  // erased element. The capacity is controlled by reserve(n), which makes
+  // room for n elements, and rehash(n), which sets the number of slots.
+  //
+  // Template Parameters:
+  //    K -- The element type
+  //    H -- The hash function
+  //    E -- The key equality
+  //    A -- The allocator of the elements
+  template <typename K,
+            typename H = std::hash<K>,
+            typename E = std::equal_to<K>,
+            typename A = std::allocator<K>>
+    class flat_hash_set
+      : public flat_hash_impl::table<flat_hash_impl::set_policy<K>, H, E, A>
+    {
+      using base =
+        flat_hash_impl::table<flat_hash_impl::set_policy<K>, H, E, A>;
+    public:
+      using base::base;
+      using base::operator=;
+
+      flat_hash_set() = default;
+    };
+
+  template <typename K, typename H, typename E, typename A>
+    inline void
+    swap(flat_hash_set<K, H, E, A>& a, flat_hash_set<K, H, E, A>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,172 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <origin/data/flat_hash/flat_hash_set.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check the set against an unordered set.
+template <typename S>
+void check_same(const S& s, const unordered_set<size_t>& u)
+{
+  assert(s.size() == u.size());
+  size_t n = 0;
+  for (size_t x : s) {
+    assert(u.count(x));
+    ++n;
+  }
+  assert(n == u.size());
+}
+
+// Random insertions and erasures of dense keys, which leave many
+// tombstones, and of keys that share their low bits.
+void check_random(size_t stride)
+{
+  minstd_rand gen(stride);
+  uniform_int_distribution<size_t> dist(0, 2000);
+  flat_hash_set<size_t> s;
+  unordered_set<size_t> u;
+  for (int i = 0; i != 20000; ++i) {
+    size_t x = dist(gen) * stride;
+    if (dist(gen) < 1200) {
+      bool a = s.insert(x).second;
+      bool b = u.insert(x).second;
+      assert(a == b);
+    } else {
+      assert(s.erase(x) == u.erase(x));
+    }
+    assert(s.contains(x) == (u.count(x) != 0));
+  }
+  check_same(s, u);
+  assert(s.load_factor() <= s.max_load_factor());
+
+  // Erase through iterators.
+  for (auto i = s.begin(); i != s.end(); ) {
+    if (*i % 3 == 0) {
+      u.erase(*i);
+      i = s.erase(i);
+    } else {
+      ++i;
+    }
+  }
+  check_same(s, u);
+  s.clear();
+  assert(s.empty() && s.begin() == s.end() && s.capacity() != 0);
+}
+
+void check_capacity()
+{
+  flat_hash_set<int> s;
+  assert(s.capacity() == 0 && s.begin() == s.end() && !s.contains(1));
+  s.reserve(1000);
+  size_t c = s.capacity();
+  assert(c >= 1000);
+  for (int i = 0; i != 1000; ++i)
+    s.insert(i);
+  assert(s.capacity() == c);
+  s.rehash(5000);
+  assert(s.capacity() >= 5000 && s.size() == 1000);
+  for (int i = 0; i != 1000; ++i)
+    assert(s.contains(i));
+  for (int i = 0; i != 1000; ++i)
+    s.erase(i);
+  s.rehash(0);
+  assert(s.capacity() == 0);
+  s.insert(3);
+  assert(s.count(3) == 1);
+}
+
+// A hash function and equality that accept C strings and strings.
+struct string_hash
+{
+  using is_transparent = void;
+
+  size_t operator()(const string& s) const { return hash<string>()(s); }
+  size_t operator()(const char* s) const { return hash<string>()(s); }
+};
+
+struct string_equal
+{
+  using is_transparent = void;
+
+  bool operator()(const string& a, const string& b) const { return a == b; }
+  bool operator()(const string& a, const char* b) const { return a == b; }
+};
+
+// An allocator that counts the storage it holds.
+template <typename T>
+  struct counting_allocator : std::allocator<T>
+  {
+    template <typename U>
+      struct rebind { using other = counting_allocator<U>; };
+
+    counting_allocator() = default;
+
+    template <typename U>
+      counting_allocator(const counting_allocator<U>&) { }
+
+    T* allocate(size_t n)
+    {
+      live += n * sizeof(T);
+      return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+      live -= n * sizeof(T);
+      std::allocator<T>::deallocate(p, n);
+    }
+
+    static long live;
+  };
+
+template <typename T>
+  long counting_allocator<T>::live = 0;
+
+void check_strings()
+{
+  using set = flat_hash_set<string, string_hash, string_equal,
+                            counting_allocator<string>>;
+  {
+    set s {"a", "bb", "ccc"};
+    assert(s.size() == 3 && s.contains("bb") && !s.contains("b"));
+    assert(s.find("ccc") != s.end() && *s.find("ccc") == "ccc");
+    assert(s.erase("a") == 1 && s.size() == 2);
+    assert(s.emplace(4, 'd').second && s.contains("dddd"));
+
+    set t = s;
+    assert(t == s);
+    t.insert(string(100, 'x'));
+    assert(t != s);
+    set u = std::move(t);
+    assert(u.size() == 4 && t.empty());
+    swap(s, u);
+    assert(s.size() == 4 && u.size() == 3);
+    u = s;
+    assert(u == s);
+  }
+  assert(counting_allocator<string>::live == 0);
+  assert(counting_allocator<char>::live == 0);
+  assert(counting_allocator<signed char>::live == 0);
+}
+
+int main()
+{
+  check_random(1);
+  check_random(1024);
+  check_capacity();
+  check_strings();
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FLAT_MAP_FLAT_MAP_HPP
+#define ORIGIN_DATA_FLAT_MAP_FLAT_MAP_HPP
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <origin/data/concepts.hpp>
+#include <origin/data/flat_map/flat_map.impl/flat_tree.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Flat Map                                                     data.flat_map
+  //
+  // A flat map is an ordered map stored in a sorted vector of key-value
+  // pairs, as a flat set is (see data.flat_set). It has the same bulk
+  // construction and insertion, and the same optional lookup index.
+  //
+  // The elements are std::pair<K, V>, not std::pair<const K, V>, so that
+  // they can be moved within the vector. The key of an element must not be
+  // modified through an iterator.
+  //
+  // In addition to the operations of the set, a map has operator[], at,
+  // try_emplace, which constructs the mapped value only when the key is
+  // not in the map, and insert_or_assign.
+  //
+  // Template Parameters:
+  //    K -- The key type
+  //    V -- The mapped type
+  //    C -- The strict weak order of the keys
+  //    A -- The allocator of the elements
+  template <typename K,
+            typename V,
+            typename C = std::less<K>,
+            typename A = std::allocator<std::pair<K, V>>>
+    class flat_map
+      : public flat_map_impl::flat_tree<flat_map_impl::map_policy<K, V>, C, A>
+    {
+      using base =
+        flat_map_impl::flat_tree<flat_map_impl::map_policy<K, V>, C, A>;
+    public:
+      using mapped_type = V;
+      using typename base::key_type;
+      using typename base::value_type;
+      using typename base::iterator;
+      using typename base::size_type;
+
+      using base::base;
+      using base::operator=;
+
+      flat_map() = default;
+
+      // Element access
+      V& operator[](const K& k) { return try_emplace(k).first->second; }
+      V& operator[](K&& k) { return try_emplace(std::move(k)).first->second; }
+
+      V& at(const K& k);
+      const V& at(const K& k) const;
+
+      // Insert an element whose mapped value is constructed from args, if
+      // the key k is not in the map.
+      template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const K& k, Args&&... args)
+        {
+          size_type r = this->lower_rank(k);
+          if (this->matches(r, k))
+            return {this->begin() + r, false};
+          value_type x(std::piecewise_construct, std::forward_as_tuple(k),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+          return {this->insert_at(r, std::move(x)), true};
+        }
+
+      template <typename... Args>
+        std::pair<iterator, bool> try_emplace(K&& k, Args&&... args)
+        {
+          size_type r = this->lower_rank(k);
+          if (this->matches(r, k))
+            return {this->begin() + r, false};
+          value_type x(std::piecewise_construct,
+                       std::forward_as_tuple(std::move(k)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+          return {this->insert_at(r, std::move(x)), true};
+        }
+
+      // Insert the element (k, x), or assign x to the mapped value of k.
+      template <typename X>
+        std::pair<iterator, bool> insert_or_assign(const K& k, X&& x)
+        {
+          auto r = try_emplace(k, std::forward<X>(x));
+          if (!r.second)
+            r.first->second = std::forward<X>(x);
+          return r;
+        }
+    };
+
+  template <typename K, typename V, typename C, typename A>
+    V&
+    flat_map<K, V, C, A>::at(const K& k)
+    {
+      auto i = this->find(k);
+      if (i == this->end())
+        throw std::out_of_range("flat_map::at");
+      return i->second;
+    }
+
+  template <typename K, typename V, typename C, typename A>
+    const V&
+    flat_map<K, V, C, A>::at(const K& k) const
+    {
+      auto i = this->find(k);
+      if (i == this->end())
+        throw std::out_of_range("flat_map::at");
+      return i->second;
+    }
+
+  template <typename K, typename V, typename C, typename A>
+    inline void
+    swap(flat_map<K, V, C, A>& a, flat_map<K, V, C, A>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,552 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FLAT_MAP_IMPL_FLAT_TREE_HPP
+#define ORIGIN_DATA_FLAT_MAP_IMPL_FLAT_TREE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/range.hpp>
+#include <origin/data/static_search/eytzinger_array.hpp>
+
+namespace origin
+{
+  // The sorted_unique tag says that a range is sorted by the order of a
+  // flat container and has no equivalent keys, so that the container can
+  // copy it without sorting.
+  struct sorted_unique_t { };
+
+  constexpr sorted_unique_t sorted_unique { };
+
+
+  namespace flat_map_impl
+  {
+    // The policies of the flat containers say how keys are found in their
+    // elements, and how elements are compared by their keys.
+    template <typename K>
+      struct set_policy
+      {
+        using key_type = K;
+        using value_type = K;
+
+        // Set elements are not modified through iterators.
+        static constexpr bool constant = true;
+
+        static const K& key(const value_type& x) { return x; }
+
+        // The elements of a set are compared by the key order itself, so
+        // that origin::stable_sort can radix sort integer keys.
+        template <typename C>
+          using value_compare = C;
+      };
+
+    template <typename K, typename V>
+      struct map_policy
+      {
+        using key_type = K;
+        using value_type = std::pair<K, V>;
+
+        static constexpr bool constant = false;
+
+        static const K& key(const value_type& x) { return x.first; }
+
+        template <typename C>
+          struct value_compare
+          {
+            value_compare(const C& c = C()) : comp(c) { }
+
+            bool operator()(const value_type& a, const value_type& b) const
+            {
+              return comp(a.first, b.first);
+            }
+
+            C comp;
+          };
+      };
+
+
+    // -------------------------------------------------------------------- //
+    //                              Flat Tree
+    //
+    // The flat tree is the implementation of flat_set and flat_map: a vector
+    // of elements sorted by key, with no two equivalent keys. The policy P
+    // gives the key of an element. See data.flat_set for the interface.
+    template <typename P, typename C, typename A>
+      class flat_tree
+      {
+        using vector_type = std::vector<typename P::value_type, A>;
+      public:
+        using key_type        = typename P::key_type;
+        using value_type      = typename P::value_type;
+        using key_compare     = C;
+        using value_compare   = typename P::template value_compare<C>;
+        using allocator_type  = A;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+        using const_iterator = typename vector_type::const_iterator;
+        using iterator = typename std::conditional<
+          P::constant, const_iterator, typename vector_type::iterator
+        >::type;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        explicit flat_tree(const C& comp = C(), const A& alloc = A())
+          : comp_(comp), v_(alloc), index_(comp), indexed_(false)
+        { }
+
+        explicit flat_tree(const A& alloc)
+          : flat_tree(C(), alloc)
+        { }
+
+        // Construct the container from the elements of [first, last), in
+        // any order. Of equivalent elements, the first is kept.
+        template <typename I>
+          flat_tree(I first, I last, const C& comp = C(), const A& alloc = A())
+            : flat_tree(comp, alloc)
+          {
+            insert(first, last);
+          }
+
+        // Construct the container from the sorted unique range
+        // [first, last).
+        template <typename I>
+          flat_tree(sorted_unique_t, I first, I last,
+                    const C& comp = C(), const A& alloc = A())
+            : comp_(comp), v_(first, last, alloc), index_(comp),
+              indexed_(false)
+          {
+            assert(is_sorted_unique());
+          }
+
+        flat_tree(std::initializer_list<value_type> list,
+                  const C& comp = C(), const A& alloc = A())
+          : flat_tree(list.begin(), list.end(), comp, alloc)
+        { }
+
+        flat_tree& operator=(std::initializer_list<value_type> list)
+        {
+          clear();
+          insert(list);
+          return *this;
+        }
+
+        // Observers
+        key_compare key_comp() const { return comp_; }
+        value_compare value_comp() const { return value_compare(comp_); }
+        allocator_type get_allocator() const { return v_.get_allocator(); }
+
+        // Capacity
+        bool      empty() const    { return v_.empty(); }
+        size_type size() const     { return v_.size(); }
+        size_type max_size() const { return v_.max_size(); }
+        size_type capacity() const { return v_.capacity(); }
+
+        void reserve(size_type n) { v_.reserve(n); }
+        void shrink_to_fit()      { v_.shrink_to_fit(); }
+
+        // Returns the elements, sorted by key.
+        const value_type* data() const { return v_.data(); }
+
+        // Iterators
+        iterator       begin()       { return v_.begin(); }
+        const_iterator begin() const { return v_.begin(); }
+        iterator       end()         { return v_.end(); }
+        const_iterator end() const   { return v_.end(); }
+
+        const_iterator cbegin() const { return v_.begin(); }
+        const_iterator cend() const   { return v_.end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const
+        {
+          return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const
+        {
+          return const_reverse_iterator(begin());
+        }
+
+        // Lookup
+        iterator       find(const key_type& k);
+        const_iterator find(const key_type& k) const;
+
+        size_type count(const key_type& k) const { return contains(k); }
+        bool contains(const key_type& k) const { return find(k) != end(); }
+
+        iterator lower_bound(const key_type& k)
+        {
+          return begin() + lower_rank(k);
+        }
+
+        const_iterator lower_bound(const key_type& k) const
+        {
+          return begin() + lower_rank(k);
+        }
+
+        iterator upper_bound(const key_type& k)
+        {
+          return begin() + upper_rank(k);
+        }
+
+        const_iterator upper_bound(const key_type& k) const
+        {
+          return begin() + upper_rank(k);
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type& k)
+        {
+          size_type r = lower_rank(k);
+          return {begin() + r, begin() + r + matches(r, k)};
+        }
+
+        std::pair<const_iterator, const_iterator>
+        equal_range(const key_type& k) const
+        {
+          size_type r = lower_rank(k);
+          return {begin() + r, begin() + r + matches(r, k)};
+        }
+
+        // Lookup index
+        void build_index();
+        bool has_index() const { return indexed_; }
+
+        // Insert
+        std::pair<iterator, bool> insert(const value_type& x)
+        {
+          return emplace_value(x);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& x)
+        {
+          return emplace_value(std::move(x));
+        }
+
+        iterator insert(const_iterator hint, const value_type& x)
+        {
+          return emplace_hint_value(hint, x);
+        }
+
+        iterator insert(const_iterator hint, value_type&& x)
+        {
+          return emplace_hint_value(hint, std::move(x));
+        }
+
+        template <typename... Args>
+          std::pair<iterator, bool> emplace(Args&&... args)
+          {
+            return emplace_value(value_type(std::forward<Args>(args)...));
+          }
+
+        template <typename... Args>
+          iterator emplace_hint(const_iterator hint, Args&&... args)
+          {
+            value_type x(std::forward<Args>(args)...);
+            return emplace_hint_value(hint, std::move(x));
+          }
+
+        // Insert the elements of [first, last), in any order, and return
+        // the number inserted. Elements whose keys are in the container, or
+        // that are equivalent to an earlier element, are not inserted.
+        template <typename I>
+          size_type insert(I first, I last);
+
+        size_type insert(std::initializer_list<value_type> list)
+        {
+          return insert(list.begin(), list.end());
+        }
+
+        // Insert the elements of the sorted unique range [first, last).
+        template <typename I>
+          size_type insert(sorted_unique_t, I first, I last);
+
+        // Erase
+        iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+        size_type erase(const key_type& k);
+
+        void clear()
+        {
+          v_.clear();
+          drop_index();
+        }
+
+        void swap(flat_tree& x)
+        {
+          using std::swap;
+          swap(comp_, x.comp_);
+          v_.swap(x.v_);
+          swap(index_, x.index_);
+          swap(indexed_, x.indexed_);
+        }
+
+        // Equality and order compare the elements.
+        bool operator==(const flat_tree& x) const { return v_ == x.v_; }
+        bool operator!=(const flat_tree& x) const { return v_ != x.v_; }
+        bool operator<(const flat_tree& x) const  { return v_ < x.v_; }
+
+      protected:
+        // Returns the rank of the first element whose key is not less than
+        // k, or greater than k.
+        size_type lower_rank(const key_type& k) const;
+        size_type upper_rank(const key_type& k) const;
+
+        // Returns true if the element at the rank r has the key k.
+        bool matches(size_type r, const key_type& k) const
+        {
+          return r != v_.size() && !comp_(k, P::key(v_[r]));
+        }
+
+        // Insert x at the rank r, which must be its position.
+        iterator insert_at(size_type r, value_type&& x)
+        {
+          drop_index();
+          return v_.insert(v_.begin() + r, std::move(x));
+        }
+
+        std::pair<iterator, bool> emplace_value(value_type x);
+        iterator emplace_hint_value(const_iterator hint, value_type x);
+
+        void drop_index()
+        {
+          if (indexed_) {
+            const key_type* none = nullptr;
+            index_.assign(none, none);
+            indexed_ = false;
+          }
+        }
+
+        // Sort the elements from the rank m and merge them into those that
+        // precede them, keeping the first of equivalent elements.
+        void merge_from(size_type m);
+
+        bool is_sorted_unique() const;
+
+        void index_keys(std::true_type);
+        void index_keys(std::false_type);
+
+        bool equivalent(const value_type& a, const value_type& b) const
+        {
+          return !comp_(P::key(a), P::key(b)) && !comp_(P::key(b), P::key(a));
+        }
+
+      protected:
+        C comp_;
+        vector_type v_;
+        eytzinger_array<key_type, C> index_; // The keys, if indexed_
+        bool indexed_;
+      };
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::lower_rank(const key_type& k) const -> size_type
+      {
+        if (indexed_)
+          return index_.lower_bound(k);
+        auto i = std::lower_bound(v_.begin(), v_.end(), k,
+          [this](const value_type& x, const key_type& k) {
+            return comp_(P::key(x), k);
+          });
+        return i - v_.begin();
+      }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::upper_rank(const key_type& k) const -> size_type
+      {
+        if (indexed_)
+          return index_.upper_bound(k);
+        auto i = std::upper_bound(v_.begin(), v_.end(), k,
+          [this](const key_type& k, const value_type& x) {
+            return comp_(k, P::key(x));
+          });
+        return i - v_.begin();
+      }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::find(const key_type& k) -> iterator
+      {
+        size_type r = lower_rank(k);
+        return matches(r, k) ? begin() + r : end();
+      }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::find(const key_type& k) const -> const_iterator
+      {
+        size_type r = lower_rank(k);
+        return matches(r, k) ? begin() + r : end();
+      }
+
+    // The index is a copy of the keys in the Eytzinger layout (see
+    // data.eytzinger_array), whose searches return ranks in the vector.
+    template <typename P, typename C, typename A>
+      void
+      flat_tree<P, C, A>::build_index()
+      {
+        index_keys(std::integral_constant<bool, P::constant>());
+        indexed_ = true;
+      }
+
+    template <typename P, typename C, typename A>
+      void
+      flat_tree<P, C, A>::index_keys(std::true_type)
+      {
+        index_.assign(v_.begin(), v_.end());
+      }
+
+    template <typename P, typename C, typename A>
+      void
+      flat_tree<P, C, A>::index_keys(std::false_type)
+      {
+        std::vector<key_type> keys;
+        keys.reserve(v_.size());
+        for (const value_type& x : v_)
+          keys.push_back(P::key(x));
+        index_.assign(keys.begin(), keys.end());
+      }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::emplace_value(value_type x)
+        -> std::pair<iterator, bool>
+      {
+        size_type r = lower_rank(P::key(x));
+        if (matches(r, P::key(x)))
+          return {begin() + r, false};
+        return {insert_at(r, std::move(x)), true};
+      }
+
+    // The hint is used if x belongs immediately before it.
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::emplace_hint_value(const_iterator hint,
+                                             value_type x) -> iterator
+      {
+        const key_type& k = P::key(x);
+        if ((hint == cend() || comp_(k, P::key(*hint)))
+            && (hint == cbegin() || comp_(P::key(*std::prev(hint)), k)))
+          return insert_at(hint - cbegin(), std::move(x));
+        return emplace_value(std::move(x)).first;
+      }
+
+    // The new elements are appended and sorted with origin::stable_sort,
+    // which radix sorts integer sets, and a stable merge then follows them
+    // with any equivalent elements that were already in the container, so
+    // that removing adjacent equivalents keeps the old elements.
+    template <typename P, typename C, typename A>
+      void
+      flat_tree<P, C, A>::merge_from(size_type m)
+      {
+        using I = typename vector_type::iterator;
+        auto eq = [this](const value_type& a, const value_type& b) {
+          return equivalent(a, b);
+        };
+        I mid = v_.begin() + m;
+        origin::stable_sort(bounded_range<I>(mid, v_.end()), value_comp());
+        v_.erase(std::unique(mid, v_.end(), eq), v_.end());
+        mid = v_.begin() + m;
+        if (m != 0 && mid != v_.end()
+            && !comp_(P::key(*std::prev(mid)), P::key(*mid))) {
+          std::inplace_merge(v_.begin(), mid, v_.end(), value_comp());
+          v_.erase(std::unique(v_.begin(), v_.end(), eq), v_.end());
+        }
+      }
+
+    template <typename P, typename C, typename A>
+      template <typename I>
+        auto
+        flat_tree<P, C, A>::insert(I first, I last) -> size_type
+        {
+          size_type n = v_.size();
+          v_.insert(v_.end(), first, last);
+          if (v_.size() != n) {
+            drop_index();
+            merge_from(n);
+          }
+          return v_.size() - n;
+        }
+
+    template <typename P, typename C, typename A>
+      template <typename I>
+        auto
+        flat_tree<P, C, A>::insert(sorted_unique_t, I first, I last)
+          -> size_type
+        {
+          size_type n = v_.size();
+          v_.insert(v_.end(), first, last);
+          if (v_.size() != n) {
+            drop_index();
+            auto mid = v_.begin() + n;
+            if (n != 0 && !comp_(P::key(*std::prev(mid)), P::key(*mid))) {
+              std::inplace_merge(v_.begin(), mid, v_.end(), value_comp());
+              auto eq = [this](const value_type& a, const value_type& b) {
+                return equivalent(a, b);
+              };
+              v_.erase(std::unique(v_.begin(), v_.end(), eq), v_.end());
+            }
+          }
+          return v_.size() - n;
+        }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::erase(const_iterator pos) -> iterator
+      {
+        drop_index();
+        return v_.erase(pos);
+      }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::erase(const_iterator first, const_iterator last)
+        -> iterator
+      {
+        drop_index();
+        return v_.erase(first, last);
+      }
+
+    template <typename P, typename C, typename A>
+      auto
+      flat_tree<P, C, A>::erase(const key_type& k) -> size_type
+      {
+        const_iterator i = static_cast<const flat_tree&>(*this).find(k);
+        if (i == cend())
+          return 0;
+        erase(i);
+        return 1;
+      }
+
+    template <typename P, typename C, typename A>
+      bool
+      flat_tree<P, C, A>::is_sorted_unique() const
+      {
+        for (size_type i = 1; i < v_.size(); ++i)
+          if (!comp_(P::key(v_[i - 1]), P::key(v_[i])))
+            return false;
+        return true;
+      }
+  } // namespace flat_map_impl
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+
+#include <cassert>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/data/flat_map/flat_map.hpp>
+
+using namespace std;
+using namespace origin;
+
+static_assert(Container<flat_map<int, string>>(), "");
+
+void check_access()
+{
+  flat_map<int, string> m {{3, "c"}, {1, "a"}, {3, "x"}};
+  assert(m.size() == 2 && m.begin()->first == 1 && m[3] == "c");
+  m[2] = "b";
+  assert(m.size() == 3 && m.at(2) == "b");
+  assert(!m.try_emplace(2, "z").second && m[2] == "b");
+  assert(!m.insert_or_assign(2, "y").second && m[2] == "y");
+  assert(m.insert_or_assign(4, "d").second && m.rbegin()->second == "d");
+
+  bool thrown = false;
+  try {
+    m.at(10);
+  } catch (out_of_range&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  const flat_map<int, string>& c = m;
+  assert(c.at(1) == "a" && c.find(5) == c.end());
+}
+
+// Bulk insertion keeps the existing values, and lookups through the index
+// agree with those of std::map.
+void check_bulk()
+{
+  minstd_rand gen;
+  flat_map<int, int> m;
+  map<int, int> t;
+  for (int round = 0; round != 10; ++round) {
+    vector<pair<int, int>> v;
+    for (int i = 0; i != 300; ++i)
+      v.emplace_back(gen() % 2000, round);
+    m.insert(v.begin(), v.end());
+    t.insert(v.begin(), v.end());
+  }
+  assert(m.size() == t.size());
+  m.build_index();
+  for (int k = -1; k != 2001; ++k) {
+    auto i = m.find(k);
+    auto j = t.find(k);
+    assert((i == m.end()) == (j == t.end()));
+    assert(i == m.end() || i->second == j->second);
+    auto lb = m.lower_bound(k);
+    auto tb = t.lower_bound(k);
+    assert((lb == m.end()) == (tb == t.end()));
+    assert(lb == m.end() || lb->first == tb->first);
+  }
+  assert(m.has_index());
+  m[5000] = 1;
+  assert(!m.has_index());
+}
+
+int main()
+{
+  check_access();
+  check_bulk();
+}
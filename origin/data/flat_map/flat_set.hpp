@@ -0,0 +1,74 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_FLAT_MAP_FLAT_SET_HPP
+#define ORIGIN_DATA_FLAT_MAP_FLAT_SET_HPP
+
+#include <functional>
+#include <memory>
+
+#include <origin/data/concepts.hpp>
+#include <origin/data/flat_map/flat_map.impl/flat_tree.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Flat Set                                                     data.flat_set
+  //
+  // A flat set is an ordered set that stores its elements in a sorted
+  // vector. It uses a fraction of the memory of a node-based std::set, and
+  // a lookup is a binary search of contiguous memory. Inserting or erasing
+  // one element moves the elements after it, so a flat set suits sets that
+  // are built once, or in bulk, and then mostly read: property tables or
+  // sorted neighbor sets, for example.
+  //
+  // A flat set is built from a range in any order in O(n log n) time: the
+  // elements are sorted with origin::stable_sort (which radix sorts integer
+  // keys under std::less), and the first of each run of equivalent elements
+  // is kept. Inserting a range appends it, sorts it in the same way, and
+  // merges it into the elements in O(n + k log k) time for k new elements.
+  // A range that is known to be sorted and unique is tagged by
+  // sorted_unique, as in s.insert(sorted_unique, first, last), and is
+  // merged without sorting.
+  //
+  // After build_index(), the lookups (find, contains, count, lower_bound,
+  // upper_bound and equal_range) search an Eytzinger copy of the keys (see
+  // data.eytzinger_array) instead of the vector, which fetches fewer cache
+  // lines for large sets. Any modification discards the index. The index
+  // copies the keys, so it doubles the memory of the set.
+  //
+  // Unlike std::set, inserting or erasing an element invalidates the
+  // iterators and references at and after its position.
+  //
+  // Template Parameters:
+  //    K -- The element type
+  //    C -- The strict weak order of the elements
+  //    A -- The allocator of the elements
+  template <typename K,
+            typename C = std::less<K>,
+            typename A = std::allocator<K>>
+    class flat_set
+      : public flat_map_impl::flat_tree<flat_map_impl::set_policy<K>, C, A>
+    {
+      using base = flat_map_impl::flat_tree<flat_map_impl::set_policy<K>, C, A>;
+    public:
+      using base::base;
+      using base::operator=;
+
+      flat_set() = default;
+    };
+
+  template <typename K, typename C, typename A>
+    inline void
+    swap(flat_set<K, C, A>& a, flat_set<K, C, A>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,123 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+
+#include <cassert>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <origin/data/flat_map/flat_set.hpp>
+
+using namespace std;
+using namespace origin;
+
+static_assert(Container<flat_set<int>>(), "");
+
+template <typename S>
+  bool same(const S& s, const set<int>& t)
+  {
+    return s.size() == t.size() && equal(s.begin(), s.end(), t.begin());
+  }
+
+void check_construct()
+{
+  flat_set<int> s {5, 1, 3, 1, 5, 2};
+  assert(s.size() == 4);
+  assert(same(s, {1, 2, 3, 5}));
+
+  vector<int> v {4, 2, 4, 6};
+  flat_set<int> t(v.begin(), v.end());
+  assert(same(t, {2, 4, 6}));
+
+  flat_set<int> u(sorted_unique, v.begin() + 1, v.begin() + 2);
+  assert(same(u, {2}));
+
+  flat_set<int, greater<int>> g {1, 3, 2};
+  assert(*g.begin() == 3);
+}
+
+void check_lookup(flat_set<int>& s)
+{
+  assert(s.contains(4) && !s.contains(5) && s.count(4) == 1);
+  assert(*s.find(4) == 4 && s.find(5) == s.end());
+  assert(*s.lower_bound(5) == 6 && *s.lower_bound(6) == 6);
+  assert(*s.upper_bound(6) == 8 && s.upper_bound(1000) == s.end());
+  auto r = s.equal_range(4);
+  assert(r.second - r.first == 1 && *r.first == 4);
+  r = s.equal_range(5);
+  assert(r.first == r.second && *r.first == 6);
+}
+
+void check_insert()
+{
+  flat_set<int> s;
+  for (int i = 0; i != 100; i += 2)
+    assert(s.insert(i).second);
+  assert(!s.insert(10).second);
+  check_lookup(s);
+
+  // With the index, the lookups are the same, and modifications drop it.
+  s.build_index();
+  assert(s.has_index());
+  check_lookup(s);
+  s.erase(50);
+  assert(!s.has_index() && !s.contains(50));
+
+  auto i = s.insert(s.find(52), 51);
+  assert(*i == 51 && *prev(i) == 48);
+  i = s.insert(s.begin(), 53);
+  assert(*i == 53 && *next(i) == 54);
+  assert(s.erase(53) == 1 && s.erase(53) == 0);
+  s.emplace(-1);
+  assert(*s.begin() == -1);
+}
+
+// Bulk insertion agrees with insertion into std::set.
+void check_bulk()
+{
+  minstd_rand gen;
+  flat_set<int> s;
+  set<int> t;
+  for (int round = 0; round != 20; ++round) {
+    vector<int> v;
+    for (int i = 0; i != 200; ++i)
+      v.push_back(gen() % 1000);
+    size_t n = t.size();
+    t.insert(v.begin(), v.end());
+    assert(s.insert(v.begin(), v.end()) == t.size() - n);
+    assert(same(s, t));
+  }
+
+  vector<int> more {2000, 2001, 2005};
+  s.insert(sorted_unique, more.begin(), more.end());
+  t.insert(more.begin(), more.end());
+  assert(same(s, t));
+  s.insert(sorted_unique, more.begin(), more.end());
+  assert(same(s, t));
+}
+
+// Of equivalent elements, the first is kept.
+void check_stable()
+{
+  auto by_length = [](const string& a, const string& b) {
+    return a.size() < b.size();
+  };
+  flat_set<string, decltype(by_length)> s({"bb", "a", "cc", "d"}, by_length);
+  assert(s.size() == 2 && *s.begin() == "a" && *next(s.begin()) == "bb");
+  s.insert({"e", "fff"});
+  assert(s.size() == 3 && *s.begin() == "a");
+}
+
+int main()
+{
+  check_construct();
+  check_insert();
+  check_bulk();
+  check_stable();
+}
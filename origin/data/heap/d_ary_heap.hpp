@@ -0,0 +1,187 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_HEAP_D_ARY_HEAP_HPP
+#define ORIGIN_DATA_HEAP_D_ARY_HEAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <origin/data/concepts.hpp>
+
+namespace origin
+{
+  namespace heap_impl
+  {
+    // Move the element at the position p of the heap at first towards the
+    // root, until its parent is not ordered before it. The parents that are
+    // passed are moved down into the hole rather than swapped.
+    template <std::size_t D, typename I, typename C>
+      void
+      sift_up(I first, std::size_t p, C comp)
+      {
+        auto x = std::move(first[p]);
+        while (p != 0) {
+          std::size_t q = (p - 1) / D;
+          if (!comp(first[q], x))
+            break;
+          first[p] = std::move(first[q]);
+          p = q;
+        }
+        first[p] = std::move(x);
+      }
+
+    // Move the element at the position p of the heap of n elements at first
+    // towards the leaves, until no child is ordered after it.
+    template <std::size_t D, typename I, typename C>
+      void
+      sift_down(I first, std::size_t n, std::size_t p, C comp)
+      {
+        auto x = std::move(first[p]);
+        while (true) {
+          std::size_t c = p * D + 1;
+          if (c >= n)
+            break;
+          std::size_t last = c + D < n ? c + D : n;
+          for (std::size_t j = c + 1; j < last; ++j)
+            if (comp(first[c], first[j]))
+              c = j;
+          if (!comp(x, first[c]))
+            break;
+          first[p] = std::move(first[c]);
+          p = c;
+        }
+        first[p] = std::move(x);
+      }
+  } // namespace heap_impl
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // D-ary Heap                                                 data.d_ary_heap
+  //
+  // A d-ary heap is a priority queue stored as an implicit tree in which
+  // each node has D children: those of the node at p are at the positions
+  // pD + 1 to pD + D. Like std::priority_queue, the top of the heap is the
+  // greatest element according to C, so that a heap ordered by greater<T>
+  // is a min-queue.
+  //
+  // A heap of arity D has height log_D(n). Pushing an element compares it
+  // with one node per level, so it makes fewer comparisons and moves than in
+  // a binary heap; popping compares the D children of each node on the way
+  // down, which share one or two cache lines when D is small. An arity of 4
+  // is usually faster than 2 for both.
+  //
+  // Template Parameters:
+  //    T -- The element type
+  //    D -- The number of children of each node
+  //    C -- The strict weak order of the elements
+  //    S -- The random access container that stores the elements
+  template <typename T,
+            std::size_t D = 4,
+            typename C = std::less<T>,
+            typename S = std::vector<T>>
+    class d_ary_heap
+    {
+      static_assert(D >= 2, "");
+      static_assert(Relation<C, T>(), "");
+    public:
+      using value_type      = T;
+      using value_compare   = C;
+      using container_type  = S;
+      using size_type       = std::size_t;
+      using reference       = typename S::reference;
+      using const_reference = typename S::const_reference;
+
+      // The number of children of each node.
+      static constexpr size_type arity = D;
+
+      explicit d_ary_heap(const C& comp = C())
+        : comp_(comp)
+      { }
+
+      // Construct a heap of the elements in [first, last), in linear time.
+      template <typename I>
+        d_ary_heap(I first, I last, const C& comp = C())
+          : seq_(first, last), comp_(comp)
+        {
+          size_type n = seq_.size();
+          if (n > 1)
+            for (size_type p = (n - 2) / D + 1; p-- != 0; )
+              heap_impl::sift_down<D>(seq_.begin(), n, p, comp_);
+        }
+
+      // Observers
+      bool      empty() const { return seq_.empty(); }
+      size_type size() const  { return seq_.size(); }
+
+      value_compare value_comp() const { return comp_; }
+
+      // Returns the elements in heap order.
+      const container_type& data() const { return seq_; }
+
+      // Returns the greatest element.
+      const_reference top() const
+      {
+        assert(!empty());
+        return seq_.front();
+      }
+
+      // Insertion
+      void push(const T& x) { emplace(x); }
+      void push(T&& x) { emplace(std::move(x)); }
+
+      template <typename... Args>
+        void emplace(Args&&... args)
+        {
+          seq_.emplace_back(std::forward<Args>(args)...);
+          heap_impl::sift_up<D>(seq_.begin(), seq_.size() - 1, comp_);
+        }
+
+      // Remove the greatest element.
+      void pop()
+      {
+        assert(!empty());
+        if (seq_.size() > 1) {
+          seq_.front() = std::move(seq_.back());
+          seq_.pop_back();
+          heap_impl::sift_down<D>(seq_.begin(), seq_.size(), 0, comp_);
+        } else {
+          seq_.pop_back();
+        }
+      }
+
+      void clear() { seq_.clear(); }
+
+      void swap(d_ary_heap& x)
+      {
+        using std::swap;
+        swap(seq_, x.seq_);
+        swap(comp_, x.comp_);
+      }
+
+    private:
+      S seq_;
+      C comp_;
+    };
+
+  template <typename T, std::size_t D, typename C, typename S>
+    constexpr std::size_t d_ary_heap<T, D, C, S>::arity;
+
+  template <typename T, std::size_t D, typename C, typename S>
+    inline void
+    swap(d_ary_heap<T, D, C, S>& a, d_ary_heap<T, D, C, S>& b)
+    {
+      a.swap(b);
+    }
+
+} // namespace origin
+
+#endif
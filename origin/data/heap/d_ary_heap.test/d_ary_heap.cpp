@@ -0,0 +1,94 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/data/heap/d_ary_heap.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check a sequence of random pushes and pops against a priority queue.
+template <size_t D, typename C>
+void check_queue()
+{
+  minstd_rand gen(D);
+  uniform_int_distribution<int> dist(0, 50);
+  d_ary_heap<int, D, C> h;
+  priority_queue<int, vector<int>, C> q;
+  for (int i = 0; i != 2000; ++i) {
+    if (dist(gen) < 30 || q.empty()) {
+      int x = dist(gen);
+      h.push(x);
+      q.push(x);
+    } else {
+      h.pop();
+      q.pop();
+    }
+    assert(h.size() == q.size());
+    if (!q.empty())
+      assert(h.top() == q.top());
+  }
+  while (!q.empty()) {
+    assert(h.top() == q.top());
+    h.pop();
+    q.pop();
+  }
+  assert(h.empty());
+}
+
+// Building a heap from a range orders every node before its parent.
+template <size_t D>
+void check_build(int n)
+{
+  vector<int> v(n);
+  for (int i = 0; i != n; ++i)
+    v[i] = (i * 7919) % 101;
+  d_ary_heap<int, D> h(v.begin(), v.end());
+  const vector<int>& a = h.data();
+  for (int i = 1; i < n; ++i)
+    assert(!(a[(i - 1) / D] < a[i]));
+
+  sort(v.begin(), v.end(), greater<int>());
+  for (int x : v) {
+    assert(h.top() == x);
+    h.pop();
+  }
+}
+
+int main()
+{
+  check_queue<2, less<int>>();
+  check_queue<3, greater<int>>();
+  check_queue<4, less<int>>();
+  check_queue<8, greater<int>>();
+  for (int n = 0; n != 40; ++n) {
+    check_build<2>(n);
+    check_build<4>(n);
+    check_build<5>(n);
+  }
+
+  d_ary_heap<string, 4, greater<string>> s;
+  s.emplace(3, 'b');
+  s.push("a");
+  s.push(string(2, 'c'));
+  assert(s.top() == "a");
+  s.pop();
+  assert(s.top() == "bbb");
+
+  d_ary_heap<string, 4, greater<string>> t;
+  swap(s, t);
+  assert(s.empty() && t.size() == 2);
+  t.clear();
+  assert(t.empty());
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_HEAP_INDEXED_HEAP_HPP
+#define ORIGIN_DATA_HEAP_INDEXED_HEAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <origin/data/concepts.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Indexed Heap                                             data.indexed_heap
+  //
+  // An indexed heap is a d-ary min-heap of the dense handles [0, n), ordered
+  // by a key associated with each handle. Unlike a priority queue, the key
+  // of an element in the heap can be decreased in O(log n) time, since the
+  // position of each element in the heap is recorded. Each element may be
+  // in the heap at most once.
+  //
+  // A heap of arity D has height log_D(n), so that pushing or decreasing a
+  // key makes fewer moves than in a binary heap, at the cost of comparing D
+  // children when popping. For the decrease-heavy workload of a shortest path
+  // search, an arity of 4 is a good compromise, and the children of a node
+  // share a cache line.
+  //
+  // The handles are of type H, which converts to and from std::size_t: an
+  // index, or a handle such as vertex_handle (see graph.handle).
+  //
+  // Template Parameters:
+  //    K -- The key type
+  //    D -- The number of children of each node
+  //    C -- The strict weak order of the keys; the top of the heap has the
+  //         least key
+  //    H -- The handle type
+  template <typename K,
+            std::size_t D = 4,
+            typename C = std::less<K>,
+            typename H = std::size_t>
+    class indexed_heap
+    {
+      static_assert(D >= 2, "");
+      static_assert(Relation<C, K>(), "");
+    public:
+      using key_type = K;
+      using key_compare = C;
+      using handle_type = H;
+
+      static constexpr std::size_t npos = -1;
+
+      // Initialize an empty heap of elements in [0, n).
+      explicit indexed_heap(std::size_t n, const C& comp = C())
+        : pos_(n, npos), keys_(n), comp_(comp)
+      { }
+
+      // Observers
+      bool        empty() const { return heap_.empty(); }
+      std::size_t size() const  { return heap_.size(); }
+
+      // Returns the number of handles that can be in the heap.
+      std::size_t capacity() const { return pos_.size(); }
+
+      // Returns true if i is in the heap.
+      bool contains(H i) const { return pos_[std::size_t(i)] != npos; }
+
+      // Returns the key of the element i, which must be in the heap.
+      const K& key(H i) const { return keys_[std::size_t(i)]; }
+
+      // Returns the element with the least key.
+      H top() const { return H(heap_.front()); }
+
+      // Insert i with key k. The element i must not be in the heap.
+      void push(H i, const K& k);
+
+      // Remove the element with the least key.
+      void pop();
+
+      // Decrease the key of i, which must be in the heap, to k.
+      void decrease(H i, const K& k);
+
+      // Insert i with key k if it is not in the heap, or decrease its key to
+      // k if k is less than its current key. Returns true if the heap is
+      // modified.
+      bool update(H i, const K& k);
+
+      // Remove every element, in time proportional to the size of the heap.
+      void clear();
+
+    private:
+      void place(std::size_t p, std::size_t i);
+      void sift_up(std::size_t p);
+      void sift_down(std::size_t p);
+
+    private:
+      std::vector<std::size_t> heap_; // Elements in heap order
+      std::vector<std::size_t> pos_;  // Position of each element in the heap
+      std::vector<K>           keys_; // Key of each element
+      C                        comp_;
+    };
+
+  template <typename K, std::size_t D, typename C, typename H>
+    constexpr std::size_t indexed_heap<K, D, C, H>::npos;
+
+  template <typename K, std::size_t D, typename C, typename H>
+    inline void
+    indexed_heap<K, D, C, H>::push(H h, const K& k)
+    {
+      assert(!contains(h));
+      std::size_t i = h;
+      keys_[i] = k;
+      heap_.push_back(i);
+      pos_[i] = heap_.size() - 1;
+      sift_up(heap_.size() - 1);
+    }
+
+  template <typename K, std::size_t D, typename C, typename H>
+    inline void
+    indexed_heap<K, D, C, H>::pop()
+    {
+      assert(!empty());
+      pos_[heap_.front()] = npos;
+      std::size_t i = heap_.back();
+      heap_.pop_back();
+      if (!heap_.empty()) {
+        place(0, i);
+        sift_down(0);
+      }
+    }
+
+  template <typename K, std::size_t D, typename C, typename H>
+    inline void
+    indexed_heap<K, D, C, H>::decrease(H h, const K& k)
+    {
+      assert(contains(h));
+      std::size_t i = h;
+      assert(!comp_(keys_[i], k));
+      keys_[i] = k;
+      sift_up(pos_[i]);
+    }
+
+  template <typename K, std::size_t D, typename C, typename H>
+    inline bool
+    indexed_heap<K, D, C, H>::update(H h, const K& k)
+    {
+      if (!contains(h)) {
+        push(h, k);
+        return true;
+      }
+      if (comp_(k, keys_[std::size_t(h)])) {
+        decrease(h, k);
+        return true;
+      }
+      return false;
+    }
+
+  template <typename K, std::size_t D, typename C, typename H>
+    inline void
+    indexed_heap<K, D, C, H>::clear()
+    {
+      for (std::size_t i : heap_)
+        pos_[i] = npos;
+      heap_.clear();
+    }
+
+  // Store the element i at position p of the heap.
+  template <typename K, std::size_t D, typename C, typename H>
+    inline void
+    indexed_heap<K, D, C, H>::place(std::size_t p, std::size_t i)
+    {
+      heap_[p] = i;
+      pos_[i] = p;
+    }
+
+  // Move the element at position p towards the root until its parent has a
+  // lesser or equal key. Moved parents are shifted down rather than swapped.
+  template <typename K, std::size_t D, typename C, typename H>
+    void
+    indexed_heap<K, D, C, H>::sift_up(std::size_t p)
+    {
+      std::size_t i = heap_[p];
+      while (p != 0) {
+        std::size_t q = (p - 1) / D;
+        if (!comp_(keys_[i], keys_[heap_[q]]))
+          break;
+        place(p, heap_[q]);
+        p = q;
+      }
+      place(p, i);
+    }
+
+  // Move the element at position p towards the leaves until none of its
+  // children have a lesser key.
+  template <typename K, std::size_t D, typename C, typename H>
+    void
+    indexed_heap<K, D, C, H>::sift_down(std::size_t p)
+    {
+      std::size_t n = heap_.size();
+      std::size_t i = heap_[p];
+      while (true) {
+        std::size_t first = p * D + 1;
+        if (first >= n)
+          break;
+        std::size_t last = first + D < n ? first + D : n;
+        std::size_t c = first;
+        for (std::size_t j = first + 1; j < last; ++j)
+          if (comp_(keys_[heap_[j]], keys_[heap_[c]]))
+            c = j;
+        if (!comp_(keys_[heap_[c]], keys_[i]))
+          break;
+        place(p, heap_[c]);
+        p = c;
+      }
+      place(p, i);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <origin/data/heap/indexed_heap.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A dense handle, such as a vertex handle.
+struct slot
+{
+  slot(size_t n) : n(n) { }
+  operator size_t() const { return n; }
+
+  size_t n;
+};
+
+// Check random pushes, decreases and pops against the keys of each element.
+template <size_t D>
+void check_decrease()
+{
+  const int n = 100;
+  minstd_rand gen(D);
+  uniform_int_distribution<int> dist(0, 1000);
+  indexed_heap<int, D, less<int>, slot> h(n);
+  vector<int> key(n, -1);
+  for (int step = 0; step != 5000; ++step) {
+    size_t i = dist(gen) % n;
+    int k = dist(gen);
+    if (key[i] < 0 || k < key[i])
+      key[i] = k;
+    h.update(i, k);
+    assert(h.contains(i) && h.key(i) == key[i]);
+
+    if (step % 3 == 0) {
+      size_t t = h.top();
+      for (int j = 0; j != n; ++j)
+        assert(key[j] < 0 || key[t] <= key[j]);
+      h.pop();
+      assert(!h.contains(t));
+      key[t] = -1;
+    }
+  }
+  int last = numeric_limits<int>::min();
+  while (!h.empty()) {
+    int k = h.key(h.top());
+    assert(last <= k);
+    last = k;
+    h.pop();
+  }
+}
+
+int main()
+{
+  check_decrease<2>();
+  check_decrease<4>();
+  check_decrease<7>();
+
+  // A max-heap of keys.
+  indexed_heap<int, 4, greater<int>> h(5);
+  h.push(0, 3);
+  h.push(3, 5);
+  h.push(4, 1);
+  assert(h.top() == 3);
+  assert(h.update(4, 9) && h.top() == 4);
+  assert(!h.update(4, 2));
+  h.clear();
+  assert(h.empty() && !h.contains(4) && h.capacity() == 5);
+  h.push(4, 0);
+  assert(h.top() == 4);
+}
@@ -0,0 +1,392 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_NULLABLE_VECTOR_NULLABLE_VECTOR_HPP
+#define ORIGIN_DATA_NULLABLE_VECTOR_NULLABLE_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+#include <origin/data/optional/optional.hpp>
+#include <origin/data/bit_vector/bit_vector.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Nullable Vector                                        data.nullable_vector
+  //
+  // A nullable vector is a sequence of optional values stored as columns: a
+  // dense array of values and a bit vector whose bit n says whether element
+  // n is valid (initialized). An element takes sizeof(T) bytes and a bit,
+  // where an optional<T> with a flag takes twice the size of a double, and
+  // the values are contiguous, so that loops over them can use vector
+  // instructions.
+  //
+  // An element is accessed through a proxy with the interface of optional:
+  //
+  //    nullable_vector<double> v {1.5, nullptr, 3.0};
+  //    if (v[1])                 // False: v[1] is null
+  //      ...
+  //    v[1] = 2.0;               // Initialize v[1]
+  //    v[0] = nullptr;           // Clear v[0]
+  //    double x = *v[2];         // Read a valid value
+  //
+  // A null element holds the value T(), so that the value array can be read
+  // as a whole. The reductions below skip the null elements:
+  //
+  //    v.count()   The number of valid elements
+  //    v.sum()     The sum of the valid elements, or T() if there are none
+  //    v.mean()    Their mean, as an optional<double>
+  //    v.min()     Their minimum, as an optional<T>
+  //    v.max()     Their maximum, as an optional<T>
+  //
+  // The sum adds the whole value array, in which the null elements are
+  // zeros, with independent partial sums that the compiler can keep in
+  // vector registers. The minimum and maximum examine the validity bits a
+  // word at a time: a block of 64 valid elements is reduced without
+  // branches, a block of null elements is skipped, and only the valid
+  // elements of a mixed block are visited. The minimum and maximum of
+  // values that include a NaN are unspecified.
+  //
+  // Template Parameters:
+  //    T -- The value type, which must be default constructible
+  namespace nullable_impl
+  {
+    // A reference to an element of a nullable vector. T is const and B is
+    // const bit_vector for a reference to a constant element; the operations
+    // that modify the element are then unusable.
+    template <typename T, typename B>
+      class element
+      {
+      public:
+        using value_type = typename std::remove_const<T>::type;
+
+        element(T& x, B& valid, std::size_t n)
+          : ptr_(&x), valid_(&valid), n_(n)
+        { }
+
+        // Returns true if the element is valid.
+        bool initialized() const { return valid_->test(n_); }
+
+        explicit operator bool() const { return initialized(); }
+
+        // Dereference
+        T& operator*() const { assert(initialized()); return *ptr_; }
+        T* operator->() const { assert(initialized()); return ptr_; }
+
+        // Returns a copy of the element.
+        operator optional<value_type>() const
+        {
+          if (initialized())
+            return *ptr_;
+          return nullptr;
+        }
+
+        // Assignment
+        element& operator=(const value_type& x)
+        {
+          *ptr_ = x;
+          valid_->set(n_);
+          return *this;
+        }
+
+        element& operator=(std::nullptr_t)
+        {
+          clear();
+          return *this;
+        }
+
+        template <typename S>
+          element& operator=(const optional<value_type, S>& x)
+          {
+            return x ? *this = *x : *this = nullptr;
+          }
+
+        // Assign the value of another element, not rebind the reference.
+        element& operator=(const element& x)
+        {
+          return x ? *this = *x : *this = nullptr;
+        }
+
+        void clear()
+        {
+          *ptr_ = value_type();
+          valid_->reset(n_);
+        }
+
+      private:
+        T* ptr_;
+        B* valid_;
+        std::size_t n_;
+      };
+
+    // A valid element compares equal to a value equal to it, and a null
+    // element compares equal to nullptr.
+    template <typename T, typename B>
+      inline bool
+      operator==(const element<T, B>& a,
+                 const typename element<T, B>::value_type& b)
+      {
+        return a && *a == b;
+      }
+
+    template <typename T, typename B>
+      inline bool
+      operator!=(const element<T, B>& a,
+                 const typename element<T, B>::value_type& b)
+      {
+        return !(a == b);
+      }
+
+    template <typename T, typename B>
+      inline bool
+      operator==(const element<T, B>& a, std::nullptr_t)
+      {
+        return !a;
+      }
+
+    template <typename T, typename B>
+      inline bool
+      operator!=(const element<T, B>& a, std::nullptr_t)
+      {
+        return bool(a);
+      }
+
+
+    // Returns the sum of the n values at p.
+    template <typename T>
+      T
+      sum(const T* p, std::size_t n)
+      {
+        T s[8] = {T(), T(), T(), T(), T(), T(), T(), T()};
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+          for (std::size_t k = 0; k != 8; ++k)
+            s[k] += p[i + k];
+        for (; i != n; ++i)
+          s[0] += p[i];
+        return ((s[0] + s[4]) + (s[1] + s[5]))
+             + ((s[2] + s[6]) + (s[3] + s[7]));
+      }
+
+    struct less_op
+    {
+      template <typename T>
+        bool operator()(const T& a, const T& b) const { return a < b; }
+    };
+
+    struct greater_op
+    {
+      template <typename T>
+        bool operator()(const T& a, const T& b) const { return b < a; }
+    };
+
+    // Fold the n values at p into m, keeping the value x for which
+    // better(x, m) is false for every other value. n is a multiple of 8,
+    // and the values are folded into 8 independent lanes.
+    template <typename T, typename Better>
+      void
+      fold(T& m, const T* p, std::size_t n, Better better)
+      {
+        T r[8];
+        for (std::size_t k = 0; k != 8; ++k)
+          r[k] = m;
+        for (std::size_t i = 0; i != n; i += 8)
+          for (std::size_t k = 0; k != 8; ++k)
+            r[k] = better(p[i + k], r[k]) ? p[i + k] : r[k];
+        for (std::size_t k = 0; k != 8; ++k)
+          m = better(r[k], m) ? r[k] : m;
+      }
+
+    // Returns the best of the valid values of p, whose validity bits are
+    // the words of valid, or null if there are none.
+    template <typename T, typename Better>
+      optional<T>
+      select(const T* p, const bit_vector& valid, Better better)
+      {
+        using word = bit_vector::word_type;
+        const std::size_t bits = bit_vector_impl::word_bits;
+        std::size_t first = valid.find_first();
+        if (first == bit_vector::npos)
+          return nullptr;
+        T m = p[first];
+        const word* w = valid.data();
+        std::size_t words = valid.word_count();
+        for (std::size_t k = first / bits; k != words; ++k) {
+          word x = w[k];
+          if (x == ~word(0)) {
+            fold(m, p + k * bits, bits, better);
+          } else {
+            for (; x; x &= x - 1) {
+              const T& y = p[k * bits + bit_vector_impl::lowest_bit(x)];
+              if (better(y, m))
+                m = y;
+            }
+          }
+        }
+        return m;
+      }
+  } // namespace nullable_impl
+
+
+  template <typename T>
+    class nullable_vector
+    {
+    public:
+      using value_type = T;
+      using size_type = std::size_t;
+      using reference = nullable_impl::element<T, bit_vector>;
+      using const_reference = nullable_impl::element<const T, const bit_vector>;
+
+      nullable_vector() = default;
+
+      // Construct a vector of n null elements.
+      explicit nullable_vector(size_type n)
+        : values_(n), valid_(n)
+      { }
+
+      // Construct a vector of n valid copies of x.
+      nullable_vector(size_type n, const T& x)
+        : values_(n, x), valid_(n, true)
+      { }
+
+      nullable_vector(std::initializer_list<optional<T>> list)
+      {
+        reserve(list.size());
+        for (const optional<T>& x : list)
+          push_back(x);
+      }
+
+      // Size and capacity
+      size_type size() const { return values_.size(); }
+      bool empty() const { return values_.empty(); }
+
+      void reserve(size_type n)
+      {
+        values_.reserve(n);
+        valid_.reserve(n);
+      }
+
+      void shrink_to_fit()
+      {
+        values_.shrink_to_fit();
+        valid_.shrink_to_fit();
+      }
+
+      // Returns the memory footprint of the vector.
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(values_) + valid_.memory_usage();
+      }
+
+      // Element access
+      reference operator[](size_type n)
+      {
+        assert(n < size());
+        return reference(values_[n], valid_, n);
+      }
+
+      const_reference operator[](size_type n) const
+      {
+        assert(n < size());
+        return const_reference(values_[n], valid_, n);
+      }
+
+      // Returns the value array, in which null elements hold T().
+      const T* data() const { return values_.data(); }
+
+      // Returns the validity bits.
+      const bit_vector& valid() const { return valid_; }
+
+      // Modifiers
+      void push_back(const T& x)
+      {
+        values_.push_back(x);
+        valid_.push_back(true);
+      }
+
+      void push_back(std::nullptr_t)
+      {
+        values_.push_back(T());
+        valid_.push_back(false);
+      }
+
+      template <typename S>
+        void push_back(const optional<T, S>& x)
+        {
+          x ? push_back(*x) : push_back(nullptr);
+        }
+
+      void pop_back()
+      {
+        values_.pop_back();
+        valid_.pop_back();
+      }
+
+      // Resize the vector, adding null elements.
+      void resize(size_type n)
+      {
+        values_.resize(n);
+        valid_.resize(n);
+      }
+
+      void clear()
+      {
+        values_.clear();
+        valid_.clear();
+      }
+
+      void swap(nullable_vector& x)
+      {
+        values_.swap(x.values_);
+        valid_.swap(x.valid_);
+      }
+
+      // Reductions
+      size_type count() const { return valid_.count(); }
+
+      T sum() const { return nullable_impl::sum(values_.data(), size()); }
+
+      optional<double> mean() const
+      {
+        size_type n = count();
+        if (n == 0)
+          return nullptr;
+        return double(sum()) / double(n);
+      }
+
+      optional<T> min() const
+      {
+        return nullable_impl::select(values_.data(), valid_,
+                                     nullable_impl::less_op());
+      }
+
+      optional<T> max() const
+      {
+        return nullable_impl::select(values_.data(), valid_,
+                                     nullable_impl::greater_op());
+      }
+
+      bool operator==(const nullable_vector& x) const
+      {
+        return valid_ == x.valid_ && values_ == x.values_;
+      }
+
+      bool operator!=(const nullable_vector& x) const { return !(*this == x); }
+
+    private:
+      std::vector<T> values_;  // The values; null elements hold T()
+      bit_vector valid_;       // Bit n is set if element n is valid
+    };
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+
+#include <origin/data/nullable_vector/nullable_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+test_elements()
+{
+  nullable_vector<double> v {1.5, nullptr, 3.0};
+  assert(v.size() == 3);
+  assert(v[0] && *v[0] == 1.5);
+  assert(!v[1] && v[1] == nullptr);
+  assert(v[2] == 3.0 && v[2] != 1.5);
+
+  v[1] = 2.0;
+  v[0] = nullptr;
+  assert(v[1] == 2.0 && !v[0].initialized());
+  assert(v.data()[0] == 0.0);
+
+  // Assigning an element copies its value.
+  v[0] = v[2];
+  assert(v[0] == 3.0);
+  v[2] = v[1] = nullptr;
+  assert(!v[1] && !v[2] && v.data()[2] == 0.0);
+
+  optional<double> x = v[0];
+  assert(x && *x == 3.0);
+  v[1] = optional<double>(4.0);
+  v[0] = optional<double>();
+  assert(!v[0] && v[1] == 4.0);
+
+  const nullable_vector<double>& c = v;
+  assert(c[1] == 4.0 && c[0] == nullptr);
+
+  v.push_back(5.0);
+  v.push_back(nullptr);
+  assert(v.size() == 5 && v.count() == 2);
+  v.pop_back();
+  v.resize(7);
+  assert(v.size() == 7 && v.count() == 2 && !v[6]);
+
+  assert((nullable_vector<int>(3, 7) == nullable_vector<int> {7, 7, 7}));
+  assert((nullable_vector<int>(2) == nullable_vector<int> {nullptr, nullptr}));
+}
+
+// A nullable vector of doubles takes a little more than half the space of
+// a vector of optional doubles.
+void
+test_footprint()
+{
+  nullable_vector<double> v(1 << 16, 1.0);
+  vector<optional<double>> o(1 << 16, 1.0);
+  assert(sizeof(optional<double>) == 2 * sizeof(double));
+  assert(v.memory_usage().live * 16 < o.size() * sizeof(o[0]) * 9);
+}
+
+// The reductions agree with those over the valid elements, for blocks that
+// are full, empty and mixed.
+void
+test_reductions()
+{
+  nullable_vector<int> e(100);
+  assert(e.sum() == 0 && !e.mean() && !e.min() && !e.max());
+
+  minstd_rand gen(7);
+  nullable_vector<int> v;
+  for (int i = 0; i != 1000; ++i) {
+    int x = int(gen() % 2001) - 1000;
+    bool valid = (i >= 64 && i < 256) || (i >= 512 && gen() % 3 == 0);
+    valid ? v.push_back(x) : v.push_back(nullptr);
+  }
+
+  long sum = 0;
+  size_t n = 0;
+  int lo = 1 << 30, hi = -(1 << 30);
+  for (size_t i = 0; i != v.size(); ++i) {
+    if (v[i]) {
+      sum += *v[i];
+      ++n;
+      lo = std::min(lo, *v[i]);
+      hi = std::max(hi, *v[i]);
+    }
+  }
+  assert(v.count() == n);
+  assert(v.sum() == sum);
+  assert(*v.mean() == double(sum) / n);
+  assert(*v.min() == lo && *v.max() == hi);
+
+  nullable_vector<double> d {nullptr, -2.5, nullptr, 4.0};
+  assert(d.sum() == 1.5 && *d.mean() == 0.75);
+  assert(*d.min() == -2.5 && *d.max() == 4.0);
+}
+
+int main()
+{
+  test_elements();
+  test_footprint();
+  test_reductions();
+}
@@ -10,11 +10,208 @@
 
 #include <cassert>
 #include <iosfwd>
+#include <limits>
+#include <type_traits>
 
 #include <origin/data/concepts.hpp>
 
 namespace origin
 {
+  //////////////////////////////////////////////////////////////////////////////
+  // Sentinel traits
+  //
+  // The sentinel traits of a type T name a value of T, returned by null(),
+  // that never occurs as a meaningful value. An optional type using
+  // sentinel traits represents the uninitialized state by storing that
+  // value, and is the same size as T. Sentinel traits are defined for:
+  //
+  //    - integer types, whose sentinel is their largest value, and
+  //    - types with a static npos member from which they can be
+  //      constructed, such as vertex and edge handles, whose sentinel is
+  //      T(T::npos).
+  //
+  // Other types may specialize sentinel_traits.
+  namespace optional_impl
+  {
+    // Deduce the type of the expression T::npos.
+    template <typename T>
+      struct get_npos_type
+      {
+      private:
+        template <typename X>
+          static auto check(X*) -> decltype(X::npos);
+
+        static subst_failure check(...);
+      public:
+        using type = decltype(check(std::declval<T*>()));
+      };
+
+    template <typename T>
+      using Npos_type = typename get_npos_type<T>::type;
+
+    // Returns true if T has a static npos member from which it can be
+    // constructed, and its values can be compared using ==.
+    template <typename T>
+      constexpr bool Has_npos()
+      {
+        return Subst_succeeded<Npos_type<T>>()
+            && Constructible<T, Npos_type<T>>()
+            && Has_equal<T>();
+      }
+  } // namespace optional_impl
+
+  template <typename T, typename = void>
+    struct sentinel_traits;
+
+  template <typename T>
+    struct sentinel_traits<T, Requires<Integer<T>()>>
+    {
+      static constexpr T null() { return std::numeric_limits<T>::max(); }
+    };
+
+  template <typename T>
+    struct sentinel_traits<T, Requires<optional_impl::Has_npos<T>()>>
+    {
+      static constexpr T null() { return T(T::npos); }
+    };
+
+
+
+  namespace optional_impl
+  {
+    // The flag storage of an optional value holds an initialization flag
+    // and uninitialized memory for a value of type T. When T is trivially
+    // copyable and destructible, so is the storage, and an optional value
+    // can be copied with memcpy. Otherwise, the specialization below copies,
+    // moves and destroys the value when it is initialized.
+    template <typename T,
+              bool = std::is_trivially_copyable<T>::value
+                  && std::is_trivially_destructible<T>::value>
+      struct flag_storage
+      {
+        flag_storage() : init(false) { }
+
+        bool initialized() const { return init; }
+
+        T*       ptr()       { return reinterpret_cast<T*>(&mem); }
+        const T* ptr() const { return reinterpret_cast<const T*>(&mem); }
+
+        // Construct the value, which must be uninitialized.
+        template <typename... Args>
+          void construct(Args&&... args)
+          {
+            ::new (static_cast<void*>(&mem)) T(std::forward<Args>(args)...);
+            init = true;
+          }
+
+        // Destroy the value, which must be initialized.
+        void destroy() { init = false; }
+
+        bool init;
+        Aligned_storage<sizeof(T), alignof(T)> mem;
+      };
+
+    template <typename T>
+      struct flag_storage<T, false> : flag_storage<T, true>
+      {
+        using base_type = flag_storage<T, true>;
+
+        flag_storage() = default;
+
+        flag_storage(flag_storage&& x)
+        {
+          if (x.init)
+            this->construct(std::move(*x.ptr()));
+        }
+
+        flag_storage(const flag_storage& x)
+        {
+          if (x.init)
+            this->construct(*x.ptr());
+        }
+
+        flag_storage& operator=(flag_storage&& x)
+        {
+          if (this->init && x.init)
+            *this->ptr() = std::move(*x.ptr());
+          else if (x.init)
+            this->construct(std::move(*x.ptr()));
+          else if (this->init)
+            destroy();
+          return *this;
+        }
+
+        flag_storage& operator=(const flag_storage& x)
+        {
+          if (this->init && x.init)
+            *this->ptr() = *x.ptr();
+          else if (x.init)
+            this->construct(*x.ptr());
+          else if (this->init)
+            destroy();
+          return *this;
+        }
+
+        ~flag_storage()
+        {
+          if (this->init)
+            this->ptr()->~T();
+        }
+
+        void destroy()
+        {
+          this->ptr()->~T();
+          this->init = false;
+        }
+      };
+
+
+    // The sentinel storage of an optional value always holds a value of
+    // type T, and is uninitialized when that value is the sentinel given
+    // by the traits S.
+    template <typename T, typename S>
+      struct sentinel_storage
+      {
+        sentinel_storage() : value(S::null()) { }
+
+        bool initialized() const { return !(value == S::null()); }
+
+        T*       ptr()       { return &value; }
+        const T* ptr() const { return &value; }
+
+        template <typename... Args>
+          void construct(Args&&... args)
+          {
+            value = T(std::forward<Args>(args)...);
+            assert(initialized());
+          }
+
+        void destroy() { value = S::null(); }
+
+        T value;
+      };
+
+
+    // Select the storage of an optional value. When S is void, the
+    // initialization state is stored in a flag.
+    template <typename T, typename S>
+      struct get_storage
+      {
+        using type = sentinel_storage<T, S>;
+      };
+
+    template <typename T>
+      struct get_storage<T, void>
+      {
+        using type = flag_storage<T>;
+      };
+
+    template <typename T, typename S>
+      using Storage = typename get_storage<T, S>::type;
+  } // namespace optional_impl
+
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Optional
   //
@@ -31,24 +228,27 @@ namespace origin
   // type is _not_ initialized until needed. Accessing the value of an optional
   // object in an uninitialized state results in undefined behavior.
   //
-  // TODO: Check this class for exception safety.
-  template <typename T>
-    class optional
+  // By default, the state is stored in a flag next to the value, and an
+  // optional object is trivially copyable and destructible whenever T is.
+  // When S names the sentinel traits of T, the uninitialized state is
+  // encoded as the sentinel value instead, so the optional object is the
+  // same size as T. The sentinel value itself cannot be stored. The
+  // compact_optional alias selects the sentinel traits of T. For example:
+  //
+  //    compact_optional<vertex_handle> v;
+  //    static_assert(sizeof(v) == sizeof(vertex_handle), "");
+  //
+  // A moved-from optional object remains initialized, holding the moved-from
+  // value.
+  template <typename T, typename S = void>
+    class optional : optional_impl::Storage<T, S>
     {
+      using base_type = optional_impl::Storage<T, S>;
     public:
       using value_type = T;
 
       // Default constructor
-      optional();
-      
-      // Move semantics
-      optional(optional&& x);
-      optional& operator=(optional&& x);
-      
-      // Copy semantics
-      optional(optional const& x);
-      optional& operator=(optional const& x);
-      
+      optional() = default;
       
       // Value initialization
       template <typename... Args, 
@@ -56,7 +256,7 @@ namespace origin
         optional(Args&&... args);
 
       template <typename Arg, 
-                typename = Requires<Assignable<T, Arg>()>>
+                typename = Requires<Assignable<T&, Arg>()>>
         optional& operator=(Arg&& args);
 
       template <typename... Args,
@@ -68,12 +268,9 @@ namespace origin
       optional(std::nullptr_t);
       optional& operator=(std::nullptr_t);
 
-      // Destruction
-      ~optional();
-
 
       // Returns true if the value is initialized.
-      bool initialized() const { return init; }
+      bool initialized() const { return base_type::initialized(); }
       
       // Dereference
       // Return a reference to the underlying object.
@@ -86,171 +283,90 @@ namespace origin
       const T* operator->() const { return &get(); }
 
       // Boolean
-      explicit operator bool() const { return init; }
+      explicit operator bool() const { return initialized(); }
       
       // Mutators
       void swap(optional& x);
       void clear();
 
     private:
-      // Return a pointer to the underlying memory.
-      T*       ptr()       { return reinterpret_cast<T*>(&mem); }
-      const T* ptr() const { return reinterpret_cast<T const*>(&mem); }
-      
       // Checked pointer access
-      T&       get()       { assert(init); return *ptr(); }
-      const T& get() const { assert(init); return *ptr(); }
-
-      template <typename... Args>
-        void construct(Args&&... args);
-
-    private:
-      bool init;
-      Aligned_storage<sizeof(T), alignof(T)> mem;
+      T&       get()       { assert(initialized()); return *this->ptr(); }
+      const T& get() const { assert(initialized()); return *this->ptr(); }
     };
 
 
-  // Construct the value of the uninitialized optional value with the
-  // given arguments. After construction, the value is initialized.
+  // An optional type whose uninitialized state is the sentinel value of T.
   template <typename T>
-    template <typename... Args>
-    inline void
-    optional<T>::construct(Args&&... args)
-    {
-      assert(!init);
-      new (ptr()) T(std::forward<Args>(args)...);
-      init = true;
-    }
-
+    using compact_optional = optional<T, sentinel_traits<T>>;
 
-  template <typename T>
-    inline
-    optional<T>::optional() 
-      : init(false)
-    { }
-
-  // Move semantics
-  template <typename T>      
-    inline
-    optional<T>::optional(optional&& x)
-      : init(x.init)
-    {
-      if (x.init)
-        new (ptr()) T {std::move(x.get())};
-      x.init = false;
-    }
-    
-  template <typename T>
-    inline auto
-    optional<T>::operator=(optional&& x) -> optional&
-    {
-      if (init) {
-        if (x.init)
-          *ptr() = std::move(*x.ptr());
-        else
-          clear();
-      } else {
-        if (x.init)
-          construct(std::move(*x.ptr()));
-      }     
-      return *this;
-    }
-    
-  // Copy semantics
-  template <typename T>
-    inline
-    optional<T>::optional(optional const& x)
-      : init(x.init)
-    {
-      if (x.init)
-        new (ptr()) T(x.get());
-    }
-    
-  template <typename T>
-    inline auto
-    optional<T>::operator=(optional const& x) -> optional& 
-    {
-      if (init) {
-        if (x.init)
-          *ptr() = *x.ptr();
-        else
-          clear();
-      } else {
-        if (x.init)
-          construct(*x.ptr());
-      }
-      return *this;
-    }
 
   // Value initialization
-  template <typename T>
+  template <typename T, typename S>
     template <typename... Args, typename Req>
-      inline optional<T>::optional(Args&&... args)
-        : init(true)
+      inline optional<T, S>::optional(Args&&... args)
       {
-        new (ptr()) T(std::forward<Args>(args)...);
+        this->construct(std::forward<Args>(args)...);
       }
 
-  template <typename T>
+  template <typename T, typename S>
     template <typename Arg, typename Req>
       inline auto 
-      optional<T>::operator=(Arg&& arg) -> optional&
+      optional<T, S>::operator=(Arg&& arg) -> optional&
       {
-        assign(std::forward<Arg>(arg));
+        if (initialized())
+          get() = std::forward<Arg>(arg);
+        else
+          this->construct(std::forward<Arg>(arg));
         return *this; 
       }
 
-  template <typename T>
+  template <typename T, typename S>
     template <typename... Args, typename Req>
       inline void
-      optional<T>::assign(Args&&... args)
+      optional<T, S>::assign(Args&&... args)
       {
-        if (init)
-          ptr()->~T();
-        new (ptr()) T(std::forward<Args>(args)...);
+        clear();
+        this->construct(std::forward<Args>(args)...);
       }
 
 
     // Nullptr initialization
-  template <typename T>
+  template <typename T, typename S>
     inline 
-    optional<T>::optional(std::nullptr_t)
-      : init {false}
+    optional<T, S>::optional(std::nullptr_t)
     { }
 
-  template <typename T>
+  template <typename T, typename S>
     inline auto
-    optional<T>::operator=(std::nullptr_t) -> optional&
+    optional<T, S>::operator=(std::nullptr_t) -> optional&
     { 
       clear(); 
       return *this; 
     }
 
-  // Destruction    
-  template <typename T>
-    inline
-    optional<T>::~optional()
-    {
-      if (init)
-        ptr()->~T(); 
-    }
-
-  template <typename T>
+  template <typename T, typename S>
     inline void 
-    optional<T>::swap(optional& x)
+    optional<T, S>::swap(optional& x)
     {
-      std::swap(init, x.init);
-      std::swap(mem, x.mem);
+      using std::swap;
+      if (initialized() && x.initialized()) {
+        swap(get(), x.get());
+      } else if (initialized()) {
+        x.construct(std::move(get()));
+        clear();
+      } else if (x.initialized()) {
+        this->construct(std::move(x.get()));
+        x.clear();
+      }
     }
 
-  template <typename T>
+  template <typename T, typename S>
     inline void 
-    optional<T>::clear()
+    optional<T, S>::clear()
     {
-      if(init) {
-        ptr()->~T();
-        init = false;
-      }
+      if (initialized())
+        this->destroy();
     }
 
 
@@ -259,9 +375,9 @@ namespace origin
   // Equality_comparable<optional<T>>
   // Two optional objects compare equal when they have the same initialization
   // and the initializedd values compare true.
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator==(const optional<T>& a, const optional<T>& b)
+    operator==(const optional<T, S>& a, const optional<T, S>& b)
     {
       if (a.initialized() == b.initialized())
         return a ? *a == *b : true;
@@ -269,9 +385,9 @@ namespace origin
         return false;
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator!=(const optional<T>& a, const optional<T>& b)
+    operator!=(const optional<T, S>& a, const optional<T, S>& b)
     {
       return !(a == b);
     }
@@ -280,30 +396,30 @@ namespace origin
   // Equality_comparable<optional<T>, T>
   // An optional object, a, compares equal to an object b of type T when a
   // is initialized and has the same value as b.
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator==(const optional<T>& a, const T& b) 
+    operator==(const optional<T, S>& a, const T& b) 
     { 
       return a && *a == b; 
     }
   
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator==(const T& a, const optional<T>& b) 
+    operator==(const T& a, const optional<T, S>& b) 
     { 
       return b && *b == a; 
     }
 
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator!=(const T& a, const optional<T>& b) 
+    operator!=(const T& a, const optional<T, S>& b) 
     { 
       return !(a == b); 
     }
 
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator!=(const optional<T>& a, const T& b) 
+    operator!=(const optional<T, S>& a, const T& b) 
     { 
       return !(a == b); 
     }
@@ -311,30 +427,30 @@ namespace origin
 
   // Equality_comparable<Optional<T>, nullptr_t>
   // An optional object compares equal to nullptr when it is uninitialized.
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator==(const optional<T>& a, std::nullptr_t) 
+    operator==(const optional<T, S>& a, std::nullptr_t) 
     { 
       return !a; 
     }
 
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator==(std::nullptr_t, const optional<T>& a) 
+    operator==(std::nullptr_t, const optional<T, S>& a) 
     { 
       return !a; 
     }
 
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator!=(const optional<T>& a, std::nullptr_t) 
+    operator!=(const optional<T, S>& a, std::nullptr_t) 
     { 
       return (bool)a; 
     }
   
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator!=(std::nullptr_t, const optional<T>& a) 
+    operator!=(std::nullptr_t, const optional<T, S>& a) 
     { 
       return (bool)a; 
     }
@@ -343,9 +459,9 @@ namespace origin
   // Totally ordered
   // When considering total ordereings, the "uninitialized state" is considered
   // to be less than all other values.
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<(const optional<T>& a, const optional<T>& b)
+    operator<(const optional<T, S>& a, const optional<T, S>& b)
     {
       if(!b)
         return false;
@@ -355,80 +471,80 @@ namespace origin
         return *a < *b;
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>(const optional<T>& a, const optional<T>& b) 
+    operator>(const optional<T, S>& a, const optional<T, S>& b) 
     { 
       return b < a;
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<=(const optional<T>& a, const optional<T>& b) 
+    operator<=(const optional<T, S>& a, const optional<T, S>& b) 
     { 
       return !(b < a); 
     }
 
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>=(const optional<T>& a, const optional<T>& b) 
+    operator>=(const optional<T, S>& a, const optional<T, S>& b) 
     { 
       return !(a < b);
     }
 
     // Totally_ordered<optional<T>, T>
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<(const optional<T>& a, const T& b) 
+    operator<(const optional<T, S>& a, const T& b) 
     {
       return a ? *a < b : true; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<(const T& a, const optional<T>& b) 
+    operator<(const T& a, const optional<T, S>& b) 
     { 
       return b ? a < *b : false; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>(const optional<T>& a, const T& b)  
+    operator>(const optional<T, S>& a, const T& b)  
     { 
       return a ? *a > b : false;
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>(const T& b, const optional<T>& a)  
+    operator>(const T& b, const optional<T, S>& a)  
     { 
       return a ? b > *a : true;
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<=(const optional<T>& a, const T& b) 
+    operator<=(const optional<T, S>& a, const T& b) 
     { 
       return !(b < a); 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<=(const T& a, const optional<T>& b) 
+    operator<=(const T& a, const optional<T, S>& b) 
     { 
       return !(b < a); 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>=(const optional<T>& a, const T& b) 
+    operator>=(const optional<T, S>& a, const T& b) 
     { 
       return !(a < b); 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>=(const T& a, const optional<T>& b) 
+    operator>=(const T& a, const optional<T, S>& b) 
     { 
       return !(a < b); 
     }
@@ -436,67 +552,67 @@ namespace origin
   
   // Totally_ordered<optional<T>, nullptr_t>
   // In these comparisons, nullptr is used to represent the uninitialized state.
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<(const optional<T>& a, std::nullptr_t)  
+    operator<(const optional<T, S>& a, std::nullptr_t)  
     {
       return false; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<(std::nullptr_t, const optional<T>& b)  
+    operator<(std::nullptr_t, const optional<T, S>& b)  
     { 
       return (bool)b; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>(const optional<T>& a, std::nullptr_t)  
+    operator>(const optional<T, S>& a, std::nullptr_t)  
     { 
       return (bool)a; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>(std::nullptr_t, const optional<T>& a)  
+    operator>(std::nullptr_t, const optional<T, S>& a)  
     { 
       return false; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<=(const optional<T>& a, std::nullptr_t) 
+    operator<=(const optional<T, S>& a, std::nullptr_t) 
     { 
       return !a; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator<=(std::nullptr_t, const optional<T>& b) 
+    operator<=(std::nullptr_t, const optional<T, S>& b) 
     { 
       return true; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>=(const optional<T>& a, std::nullptr_t) 
+    operator>=(const optional<T, S>& a, std::nullptr_t) 
     { 
       return true; 
     }
     
-  template <typename T>
+  template <typename T, typename S>
     inline bool 
-    operator>=(std::nullptr_t, const optional<T>& b) 
+    operator>=(std::nullptr_t, const optional<T, S>& b) 
     { 
       return !b; 
     }
 
 
   // Output streamable
-  template <typename T, typename Char, typename Traits>
+  template <typename T, typename S, typename Char, typename Traits>
     inline std::basic_ostream<Char, Traits>&
-    operator<<(std::basic_ostream<Char, Traits>& os, const optional<T>& opt)
+    operator<<(std::basic_ostream<Char, Traits>& os, const optional<T, S>& opt)
     {
       if (opt)
         os << *opt;
@@ -0,0 +1,121 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <origin/data/optional/optional.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A handle whose invalid value is npos, like the graph handles.
+struct handle
+{
+  static constexpr size_t npos = -1;
+
+  handle(size_t n = npos) : value(n) { }
+
+  bool operator==(const handle& x) const { return value == x.value; }
+  bool operator<(const handle& x) const { return value < x.value; }
+
+  size_t value;
+};
+
+constexpr size_t handle::npos;
+
+// Optionals of trivial types are trivially copyable, and can be copied
+// with memcpy.
+void
+check_trivial()
+{
+  using T = optional<int>;
+  static_assert(is_trivially_copyable<T>::value, "");
+  static_assert(is_trivially_destructible<T>::value, "");
+  static_assert(!is_trivially_copyable<optional<string>>::value, "");
+
+  T a[3] = {1, nullptr, 3};
+  T b[3];
+  memcpy(b, a, sizeof(a));
+  assert(b[0] == 1 && !b[1] && b[2] == 3);
+
+  T x = 4;
+  x = 5;
+  assert(x == 5);
+  x.assign(6);
+  assert(x == 6);
+  x = nullptr;
+  assert(!x);
+}
+
+// Optionals of other types copy, move and destroy their values.
+void
+check_nontrivial()
+{
+  using T = optional<string>;
+  T a = string(100, 'a');
+  T b = a;
+  assert(b == a && b->size() == 100);
+  T c = std::move(b);
+  assert(c == a && b);
+  T d;
+  d = c;
+  assert(d == a);
+  d = T();
+  assert(!d);
+
+  c.swap(d);
+  assert(!c && d == a);
+  d.clear();
+  assert(!d);
+
+  vector<T> v(10, a);
+  v.resize(20);
+  assert(v[9] == a && !v[19]);
+}
+
+// Compact optionals encode the uninitialized state as a sentinel value,
+// so they are the same size as their value type.
+void
+check_compact()
+{
+  using H = compact_optional<handle>;
+  static_assert(sizeof(H) == sizeof(handle), "");
+  static_assert(is_trivially_copyable<H>::value, "");
+  H h;
+  assert(!h && h == nullptr);
+  h = handle(3);
+  assert(h && h->value == 3);
+  H g = handle(2);
+  assert(g < h && g != h);
+  h.swap(g);
+  assert(h->value == 2 && g->value == 3);
+  h.clear();
+  assert(!h);
+  h.swap(g);
+  assert(h->value == 3 && !g);
+
+  using N = compact_optional<unsigned>;
+  static_assert(sizeof(N) == sizeof(unsigned), "");
+  N n;
+  assert(!n);
+  n = 0u;
+  assert(n && *n == 0);
+  n = nullptr;
+  assert(!n);
+  assert(sentinel_traits<int>::null() == numeric_limits<int>::max());
+}
+
+int main()
+{
+  check_trivial();
+  check_nontrivial();
+  check_compact();
+}
@@ -0,0 +1,835 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_RING_BUFFER_RING_BUFFER_HPP
+#define ORIGIN_DATA_RING_BUFFER_RING_BUFFER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <origin/data/concepts.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  namespace ring_buffer_impl
+  {
+    // A ring iterator refers to the element at the position pos of a
+    // buffer, which is an index into its storage before it is masked. The
+    // positions of the elements of a ring buffer increase from that of its
+    // first element, so that iterators are compared and subtracted by
+    // their positions.
+    template <typename T>
+      class ring_iterator
+      {
+        template <typename U>
+          friend class ring_iterator;
+      public:
+        using value_type        = typename std::remove_const<T>::type;
+        using reference         = T&;
+        using pointer           = T*;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+
+        ring_iterator()
+          : data_(nullptr), mask_(0), pos_(0)
+        { }
+
+        ring_iterator(T* data, std::size_t mask, std::size_t pos)
+          : data_(data), mask_(mask), pos_(pos)
+        { }
+
+        // A mutable iterator converts to a constant one.
+        template <typename U,
+                  typename = Requires<std::is_convertible<U*, T*>::value>>
+          ring_iterator(const ring_iterator<U>& x)
+            : data_(x.data_), mask_(x.mask_), pos_(x.pos_)
+          { }
+
+        // Readable
+        T& operator*() const { return data_[pos_ & mask_]; }
+        T* operator->() const { return &**this; }
+
+        T& operator[](difference_type n) const
+        {
+          return data_[(pos_ + n) & mask_];
+        }
+
+        // Random access
+        ring_iterator& operator++() { ++pos_; return *this; }
+        ring_iterator& operator--() { --pos_; return *this; }
+
+        ring_iterator operator++(int)
+        {
+          ring_iterator tmp = *this;
+          ++pos_;
+          return tmp;
+        }
+
+        ring_iterator operator--(int)
+        {
+          ring_iterator tmp = *this;
+          --pos_;
+          return tmp;
+        }
+
+        ring_iterator& operator+=(difference_type n)
+        {
+          pos_ += n;
+          return *this;
+        }
+
+        ring_iterator& operator-=(difference_type n)
+        {
+          pos_ -= n;
+          return *this;
+        }
+
+        friend ring_iterator operator+(ring_iterator i, difference_type n)
+        {
+          return i += n;
+        }
+
+        friend ring_iterator operator+(difference_type n, ring_iterator i)
+        {
+          return i += n;
+        }
+
+        friend ring_iterator operator-(ring_iterator i, difference_type n)
+        {
+          return i -= n;
+        }
+
+        template <typename U>
+          difference_type operator-(const ring_iterator<U>& x) const
+          {
+            return difference_type(pos_ - x.pos_);
+          }
+
+        // Totally ordered
+        template <typename U>
+          bool operator==(const ring_iterator<U>& x) const
+          {
+            return pos_ == x.pos_;
+          }
+
+        template <typename U>
+          bool operator!=(const ring_iterator<U>& x) const
+          {
+            return pos_ != x.pos_;
+          }
+
+        template <typename U>
+          bool operator<(const ring_iterator<U>& x) const
+          {
+            return pos_ < x.pos_;
+          }
+
+        template <typename U>
+          bool operator>(const ring_iterator<U>& x) const
+          {
+            return pos_ > x.pos_;
+          }
+
+        template <typename U>
+          bool operator<=(const ring_iterator<U>& x) const
+          {
+            return pos_ <= x.pos_;
+          }
+
+        template <typename U>
+          bool operator>=(const ring_iterator<U>& x) const
+          {
+            return pos_ >= x.pos_;
+          }
+
+      private:
+        T*          data_;
+        std::size_t mask_;
+        std::size_t pos_;
+      };
+  } // namespace ring_buffer_impl
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Ring Buffer                                                data.ring_buffer
+  //
+  // A ring buffer is a double-ended queue whose elements are stored in one
+  // circular array. Pushing and popping at either end take constant time,
+  // and only the growth of the array allocates: unlike std::deque, there
+  // are no blocks and no map of blocks, and a traversal reads contiguous
+  // memory, in at most two runs. It suits FIFO queues such as the frontier
+  // of a search, sliding windows over a stream, and the pending input of a
+  // parser.
+  //
+  // The capacity is a power of two, so that the position of an element is
+  // masked, not divided, to find its slot. When the buffer is full, pushing
+  // an element doubles the capacity, and moves the elements to the front
+  // of the new array. The storage is released only by shrink_to_fit(),
+  // which reduces the capacity to the least power of two that holds the
+  // elements.
+  //
+  // The bulk operations:
+  //
+  //    b.push_back(first, last)    Append the elements of [first, last)
+  //    b.pop_front(n)              Erase the first n elements
+  //    b.pop_front(n, out)         Move the first n elements to out
+  //    b.pop_back(n)               Erase the last n elements
+  //
+  // grow the buffer at most once, and copy and move elements in at most two
+  // contiguous runs.
+  //
+  // Iterators are random access. They are invalidated by any operation that
+  // changes the capacity, and by push_front, pop_front and clear. Pushing
+  // or popping at the back invalidates only the end iterator, unless the
+  // buffer grows. References are invalidated as iterators, except that
+  // push_front does not invalidate references unless the buffer grows.
+  //
+  // Template Parameters:
+  //    T -- The element type
+  //    A -- The allocator of the elements
+  template <typename T, typename A = std::allocator<T>>
+    class ring_buffer
+    {
+      static_assert(Allocator<A>(), "");
+
+      using traits = std::allocator_traits<A>;
+    public:
+      using value_type             = T;
+      using allocator_type         = A;
+      using size_type              = std::size_t;
+      using difference_type        = std::ptrdiff_t;
+      using reference              = T&;
+      using const_reference        = const T&;
+      using pointer                = T*;
+      using const_pointer          = const T*;
+      using iterator               = ring_buffer_impl::ring_iterator<T>;
+      using const_iterator         = ring_buffer_impl::ring_iterator<const T>;
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      // Default construction
+      ring_buffer() : impl(A()) { }
+      explicit ring_buffer(const A& a) : impl(a) { }
+
+      // Fill construction
+      explicit ring_buffer(size_type n, const A& a = A());
+      ring_buffer(size_type n, const T& x, const A& a = A());
+
+      // Range construction
+      template <typename I, typename = Requires<Input_iterator<I>()>>
+        ring_buffer(I first, I last, const A& a = A())
+          : impl(a)
+        {
+          push_back(first, last);
+        }
+
+      ring_buffer(std::initializer_list<T> list, const A& a = A())
+        : impl(a)
+      {
+        push_back(list.begin(), list.end());
+      }
+
+      // Copy semantics
+      ring_buffer(const ring_buffer& x);
+      ring_buffer& operator=(const ring_buffer& x);
+
+      // Move semantics
+      ring_buffer(ring_buffer&& x) noexcept;
+      ring_buffer& operator=(ring_buffer&& x);
+
+      ~ring_buffer() { release(); }
+
+      // Returns the allocator of the buffer.
+      A get_allocator() const { return alloc(); }
+
+      // Size and capacity
+      bool      empty() const    { return impl.size == 0; }
+      bool      full() const     { return impl.size == impl.cap; }
+      size_type size() const     { return impl.size; }
+      size_type capacity() const { return impl.cap; }
+      size_type max_size() const { return traits::max_size(alloc()); }
+
+      // Make room for at least n elements.
+      void reserve(size_type n)
+      {
+        if (n > capacity())
+          relocate(round_up(n));
+      }
+
+      void shrink_to_fit();
+
+      void resize(size_type n);
+      void resize(size_type n, const T& x);
+
+      // Returns the footprint of the elements and the array.
+      memory_footprint memory_usage() const
+      {
+        return {size() * sizeof(T), capacity() * sizeof(T)};
+      }
+
+      // Element access
+      T&       operator[](size_type n)       { return slot(n); }
+      const T& operator[](size_type n) const { return slot(n); }
+
+      T&       at(size_type n);
+      const T& at(size_type n) const;
+
+      T&       front()       { return slot(0); }
+      const T& front() const { return slot(0); }
+
+      T&       back()       { return slot(size() - 1); }
+      const T& back() const { return slot(size() - 1); }
+
+      // Insertion
+      void push_back(const T& x) { emplace_back(x); }
+      void push_back(T&& x)      { emplace_back(std::move(x)); }
+
+      void push_front(const T& x) { emplace_front(x); }
+      void push_front(T&& x)      { emplace_front(std::move(x)); }
+
+      template <typename... Args>
+        void emplace_back(Args&&... args);
+
+      template <typename... Args>
+        void emplace_front(Args&&... args);
+
+      // Append the elements of [first, last), which are not in the buffer.
+      template <typename I>
+        void push_back(I first, I last)
+        {
+          append(first, last, Iterator_category<I>());
+        }
+
+      // Erasure
+      void pop_back();
+      void pop_front();
+
+      void pop_back(size_type n);
+      void pop_front(size_type n);
+
+      // Move the first n elements to out and erase them, returning the end
+      // of the output.
+      template <typename O>
+        O pop_front(size_type n, O out);
+
+      void clear() { pop_back(size()); }
+
+      void swap(ring_buffer& x);
+
+      // Iterators
+      iterator begin() { return {impl.first, mask(), impl.head}; }
+      iterator end()   { return {impl.first, mask(), impl.head + size()}; }
+
+      const_iterator begin() const { return {impl.first, mask(), impl.head}; }
+      const_iterator end() const
+      {
+        return {impl.first, mask(), impl.head + size()};
+      }
+
+      const_iterator cbegin() const { return begin(); }
+      const_iterator cend() const   { return end(); }
+
+      reverse_iterator rbegin() { return reverse_iterator(end()); }
+      reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+      const_reverse_iterator rbegin() const
+      {
+        return const_reverse_iterator(end());
+      }
+
+      const_reverse_iterator rend() const
+      {
+        return const_reverse_iterator(begin());
+      }
+
+    private:
+      A&       alloc()       { return impl; }
+      const A& alloc() const { return impl; }
+
+      size_type mask() const { return impl.cap - 1; }
+
+      // Returns the nth element, or the slot after the last if n is the
+      // size.
+      T&       slot(size_type n)       { return impl.first[wrap(n)]; }
+      const T& slot(size_type n) const { return impl.first[wrap(n)]; }
+
+      // Returns the index of the slot of the nth element.
+      size_type wrap(size_type n) const { return (impl.head + n) & mask(); }
+
+      // Returns the least power of two not less than n, and at least 8.
+      static size_type round_up(size_type n)
+      {
+        size_type c = 8;
+        while (c < n)
+          c *= 2;
+        return c;
+      }
+
+      // Move the elements, in order, to the front of new storage for n
+      // elements. If moving an element throws, the new storage is released
+      // and the buffer keeps its storage.
+      void relocate(size_type n);
+      void relocate_elements(T* p, size_type n, std::true_type);
+      void relocate_elements(T* p, size_type n, std::false_type);
+
+      // Release the elements and their storage.
+      void release();
+
+      // Call f(p, k) on the k contiguous slots at p holding the n elements
+      // starting at the ith, in order.
+      template <typename F>
+        void each_run(size_type i, size_type n, F f);
+
+      template <typename I>
+        void append(I first, I last, std::input_iterator_tag);
+      template <typename I>
+        void append(I first, I last, std::forward_iterator_tag);
+
+    private:
+      // The allocator is a base class, so that empty allocators take no
+      // space in the buffer.
+      struct impl_type : A
+      {
+        impl_type(const A& a)
+          : A(a), first(nullptr), head(0), size(0), cap(0)
+        { }
+
+        T*        first; // The storage
+        size_type head;  // The slot of the first element
+        size_type size;  // The number of elements
+        size_type cap;   // The capacity of the storage, 0 or a power of two
+      };
+
+      impl_type impl;
+    };
+
+
+  template <typename T, typename A>
+    inline
+    ring_buffer<T, A>::ring_buffer(size_type n, const A& a)
+      : impl(a)
+    {
+      resize(n);
+    }
+
+  template <typename T, typename A>
+    inline
+    ring_buffer<T, A>::ring_buffer(size_type n, const T& x, const A& a)
+      : impl(a)
+    {
+      resize(n, x);
+    }
+
+  // Copy semantics
+  template <typename T, typename A>
+    inline
+    ring_buffer<T, A>::ring_buffer(const ring_buffer& x)
+      : impl(traits::select_on_container_copy_construction(x.alloc()))
+    {
+      push_back(x.begin(), x.end());
+    }
+
+  // If the allocator is propagated on copy assignment and differs from
+  // that of x, the storage of the buffer is released first.
+  template <typename T, typename A>
+    auto
+    ring_buffer<T, A>::operator=(const ring_buffer& x) -> ring_buffer&
+    {
+      if (&x == this)
+        return *this;
+      if (traits::propagate_on_container_copy_assignment::value) {
+        if (!(alloc() == x.alloc()))
+          release();
+        alloc() = x.alloc();
+      }
+      clear();
+      push_back(x.begin(), x.end());
+      return *this;
+    }
+
+  // Move semantics
+  template <typename T, typename A>
+    inline
+    ring_buffer<T, A>::ring_buffer(ring_buffer&& x) noexcept
+      : impl(x.alloc())
+    {
+      std::swap(impl.first, x.impl.first);
+      std::swap(impl.head, x.impl.head);
+      std::swap(impl.size, x.impl.size);
+      std::swap(impl.cap, x.impl.cap);
+    }
+
+  // If the allocators of the buffer and x are interchangeable, or the
+  // allocator is propagated on move assignment, the buffer takes the
+  // storage of x. Otherwise, the elements of x are moved into the storage
+  // of the buffer. In either case, x is left empty.
+  template <typename T, typename A>
+    auto
+    ring_buffer<T, A>::operator=(ring_buffer&& x) -> ring_buffer&
+    {
+      if (&x == this)
+        return *this;
+      bool pocma = traits::propagate_on_container_move_assignment::value;
+      if (pocma || alloc() == x.alloc()) {
+        release();
+        if (pocma)
+          alloc() = std::move(x.alloc());
+        std::swap(impl.first, x.impl.first);
+        std::swap(impl.head, x.impl.head);
+        std::swap(impl.size, x.impl.size);
+        std::swap(impl.cap, x.impl.cap);
+      } else {
+        clear();
+        push_back(std::make_move_iterator(x.begin()),
+                  std::make_move_iterator(x.end()));
+        x.clear();
+      }
+      return *this;
+    }
+
+
+  // Capacity
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::relocate(size_type n)
+    {
+      assert(n >= size() && (n & (n - 1)) == 0);
+      T* p = traits::allocate(alloc(), n);
+      relocate_elements(p, n, is_trivially_relocatable<T>());
+      impl.first = p;
+      impl.head = 0;
+      impl.cap = n;
+    }
+
+  // Move the elements to the front of the storage p, of n elements, and
+  // release the current storage. Trivially relocatable elements are copied
+  // by at most two memcpys, one for each part of the ring (see
+  // type.relocatable), and are not destroyed.
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::relocate_elements(T* p, size_type, std::true_type)
+    {
+      if (!impl.first)
+        return;
+      size_type k = std::min(size(), capacity() - impl.head);
+      std::memcpy(static_cast<void*>(p), impl.first + impl.head,
+                  k * sizeof(T));
+      std::memcpy(static_cast<void*>(p + k), impl.first,
+                  (size() - k) * sizeof(T));
+      traits::deallocate(alloc(), impl.first, capacity());
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::relocate_elements(T* p, size_type n, std::false_type)
+    {
+      size_type k = 0;
+      try {
+        for ( ; k != size(); ++k)
+          ::new (p + k) T(std::move_if_noexcept(slot(k)));
+      } catch (...) {
+        while (k != 0)
+          p[--k].~T();
+        traits::deallocate(alloc(), p, n);
+        throw;
+      }
+      size_type m = size();
+      release();
+      impl.size = m;
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::release()
+    {
+      clear();
+      if (impl.first)
+        traits::deallocate(alloc(), impl.first, capacity());
+      impl.first = nullptr;
+      impl.head = 0;
+      impl.cap = 0;
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::shrink_to_fit()
+    {
+      if (empty()) {
+        release();
+        return;
+      }
+      size_type n = round_up(size());
+      if (n < capacity())
+        relocate(n);
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::resize(size_type n)
+    {
+      if (n < size()) {
+        pop_back(size() - n);
+      } else {
+        reserve(n);
+        while (size() != n)
+          emplace_back();
+      }
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::resize(size_type n, const T& x)
+    {
+      if (n < size()) {
+        pop_back(size() - n);
+      } else {
+        reserve(n);
+        while (size() != n)
+          emplace_back(x);
+      }
+    }
+
+
+  // Element access
+  template <typename T, typename A>
+    inline T&
+    ring_buffer<T, A>::at(size_type n)
+    {
+      if (n >= size())
+        throw std::out_of_range("ring_buffer");
+      return slot(n);
+    }
+
+  template <typename T, typename A>
+    inline const T&
+    ring_buffer<T, A>::at(size_type n) const
+    {
+      if (n >= size())
+        throw std::out_of_range("ring_buffer");
+      return slot(n);
+    }
+
+
+  // Insertion
+  //
+  // When the buffer is full, it grows before the new element is
+  // constructed, so args must not refer to an element of the buffer.
+  template <typename T, typename A>
+    template <typename... Args>
+      inline void
+      ring_buffer<T, A>::emplace_back(Args&&... args)
+      {
+        if (full())
+          relocate(round_up(size() + 1));
+        ::new (&slot(size())) T(std::forward<Args>(args)...);
+        ++impl.size;
+      }
+
+  template <typename T, typename A>
+    template <typename... Args>
+      inline void
+      ring_buffer<T, A>::emplace_front(Args&&... args)
+      {
+        if (full())
+          relocate(round_up(size() + 1));
+        size_type h = (impl.head - 1) & mask();
+        ::new (impl.first + h) T(std::forward<Args>(args)...);
+        impl.head = h;
+        ++impl.size;
+      }
+
+  template <typename T, typename A>
+    template <typename F>
+      inline void
+      ring_buffer<T, A>::each_run(size_type i, size_type n, F f)
+      {
+        if (n == 0)
+          return;
+        size_type s = wrap(i);
+        size_type k = std::min(n, capacity() - s);
+        f(impl.first + s, k);
+        if (k != n)
+          f(impl.first, n - k);
+      }
+
+  template <typename T, typename A>
+    template <typename I>
+      inline void
+      ring_buffer<T, A>::append(I first, I last, std::input_iterator_tag)
+      {
+        for ( ; first != last; ++first)
+          emplace_back(*first);
+      }
+
+  // The elements are copied into at most two runs of slots. If a copy
+  // throws, the elements of the completed runs are kept.
+  template <typename T, typename A>
+    template <typename I>
+      void
+      ring_buffer<T, A>::append(I first, I last, std::forward_iterator_tag)
+      {
+        size_type n = std::distance(first, last);
+        reserve(size() + n);
+        each_run(size(), n, [&](T* p, size_type k) {
+          I mid = std::next(first, k);
+          std::uninitialized_copy(first, mid, p);
+          first = mid;
+          impl.size += k;
+        });
+      }
+
+
+  // Erasure
+  template <typename T, typename A>
+    inline void
+    ring_buffer<T, A>::pop_back()
+    {
+      assert(!empty());
+      --impl.size;
+      slot(size()).~T();
+    }
+
+  template <typename T, typename A>
+    inline void
+    ring_buffer<T, A>::pop_front()
+    {
+      assert(!empty());
+      impl.first[impl.head].~T();
+      impl.head = (impl.head + 1) & mask();
+      --impl.size;
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::pop_back(size_type n)
+    {
+      assert(n <= size());
+      each_run(size() - n, n, [](T* p, size_type k) {
+        for (size_type i = 0; i != k; ++i)
+          p[i].~T();
+      });
+      impl.size -= n;
+    }
+
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::pop_front(size_type n)
+    {
+      assert(n <= size());
+      each_run(0, n, [](T* p, size_type k) {
+        for (size_type i = 0; i != k; ++i)
+          p[i].~T();
+      });
+      if (n != 0) {
+        impl.head = wrap(n);
+        impl.size -= n;
+      }
+    }
+
+  template <typename T, typename A>
+    template <typename O>
+      O
+      ring_buffer<T, A>::pop_front(size_type n, O out)
+      {
+        assert(n <= size());
+        each_run(0, n, [&](T* p, size_type k) {
+          out = std::move(p, p + k, out);
+        });
+        pop_front(n);
+        return out;
+      }
+
+  // Exchange the elements of the buffer and x. Only the storage is
+  // exchanged; the allocators are exchanged if they are propagated on
+  // swap.
+  template <typename T, typename A>
+    void
+    ring_buffer<T, A>::swap(ring_buffer& x)
+    {
+      if (traits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(alloc(), x.alloc());
+      }
+      std::swap(impl.first, x.impl.first);
+      std::swap(impl.head, x.impl.head);
+      std::swap(impl.size, x.impl.size);
+      std::swap(impl.cap, x.impl.cap);
+    }
+
+  template <typename T, typename A>
+    inline void
+    swap(ring_buffer<T, A>& a, ring_buffer<T, A>& b)
+    {
+      a.swap(b);
+    }
+
+
+  // Equality comparable
+  template <typename T, typename A>
+    inline bool
+    operator==(const ring_buffer<T, A>& a, const ring_buffer<T, A>& b)
+    {
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+  template <typename T, typename A>
+    inline bool
+    operator!=(const ring_buffer<T, A>& a, const ring_buffer<T, A>& b)
+    {
+      return !(a == b);
+    }
+
+  // Totally ordered
+  template <typename T, typename A>
+    inline bool
+    operator<(const ring_buffer<T, A>& a, const ring_buffer<T, A>& b)
+    {
+      return std::lexicographical_compare(a.begin(), a.end(),
+                                          b.begin(), b.end());
+    }
+
+  template <typename T, typename A>
+    inline bool
+    operator>(const ring_buffer<T, A>& a, const ring_buffer<T, A>& b)
+    {
+      return b < a;
+    }
+
+  template <typename T, typename A>
+    inline bool
+    operator<=(const ring_buffer<T, A>& a, const ring_buffer<T, A>& b)
+    {
+      return !(b < a);
+    }
+
+  template <typename T, typename A>
+    inline bool
+    operator>=(const ring_buffer<T, A>& a, const ring_buffer<T, A>& b)
+    {
+      return !(a < b);
+    }
+
+  // A ring buffer refers to its storage only through a pointer, so that it
+  // is trivially relocatable when its allocator is (see type.relocatable).
+  template <typename T, typename A>
+    struct is_trivially_relocatable<ring_buffer<T, A>>
+      : is_trivially_relocatable<A>
+    { };
+
+} // namespace origin
+
+#endif
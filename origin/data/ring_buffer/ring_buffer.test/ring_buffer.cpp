@@ -0,0 +1,276 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <origin/data/ring_buffer/ring_buffer.hpp>
+
+using namespace std;
+using namespace origin;
+
+static_assert(Container<ring_buffer<int>>(), "");
+static_assert(Random_access_iterator<ring_buffer<int>::iterator>(), "");
+static_assert(Random_access_iterator<ring_buffer<int>::const_iterator>(), "");
+
+// A counted object tracks the number of live objects, so that leaked or
+// doubly destroyed elements are detected.
+struct counted
+{
+  static int live;
+
+  counted(int n = 0) : n(n) { ++live; }
+  counted(const counted& x) : n(x.n) { ++live; }
+  counted(counted&& x) : n(x.n) { x.n = -1; ++live; }
+  ~counted() { --live; }
+
+  counted& operator=(const counted&) = default;
+  counted& operator=(counted&&) = default;
+
+  bool operator==(const counted& x) const { return n == x.n; }
+  bool operator<(const counted& x) const { return n < x.n; }
+
+  int n;
+};
+
+int counted::live = 0;
+
+// A relocated object counts its moves. It is trivially relocatable, so that
+// growing a container copies its bytes rather than moving it.
+struct relocated
+{
+  static int moves;
+
+  relocated(int n = 0) : n(n) { }
+  relocated(relocated&& x) : n(x.n) { ++moves; }
+  ~relocated() { }
+
+  relocated& operator=(relocated&&) = default;
+
+  int n;
+};
+
+int relocated::moves = 0;
+
+namespace origin
+{
+  template <>
+    struct is_trivially_relocatable<relocated> : std::true_type { };
+} // namespace origin
+
+template <typename R>
+  bool
+  same(const R& r, const vector<int>& w)
+  {
+    if (r.size() != w.size())
+      return false;
+    for (size_t i = 0; i != w.size(); ++i)
+      if (r[i].n != w[i])
+        return false;
+    return true;
+  }
+
+void
+check_growth()
+{
+  using R = ring_buffer<counted>;
+  R r;
+  assert(r.empty() && r.capacity() == 0);
+  r.push_back(1);
+  assert(r.capacity() == 8);
+
+  // Wrap the elements around the end of the array, then grow.
+  for (int i = 2; i != 7; ++i)
+    r.push_back(i);
+  r.pop_front();
+  r.pop_front();
+  r.push_back(7);
+  r.push_back(8);
+  r.push_front(2);
+  r.push_front(1);
+  assert(r.full() && same(r, {1, 2, 3, 4, 5, 6, 7, 8}));
+  r.push_front(0);
+  assert(r.capacity() == 16 && same(r, {0, 1, 2, 3, 4, 5, 6, 7, 8}));
+
+  r.reserve(20);
+  assert(r.capacity() == 32);
+  r.shrink_to_fit();
+  assert(r.capacity() == 16 && r.size() == 9);
+  r.resize(3);
+  assert(same(r, {0, 1, 2}));
+  r.resize(5, counted(9));
+  assert(same(r, {0, 1, 2, 9, 9}));
+  r.clear();
+  r.shrink_to_fit();
+  assert(r.empty() && r.capacity() == 0);
+}
+
+void
+check_queue()
+{
+  // Use the buffer as a FIFO queue whose head cycles through the array.
+  ring_buffer<int> q;
+  vector<int> out;
+  int next = 0;
+  for (int i = 0; i != 1000; ++i) {
+    q.push_back(next++);
+    q.push_back(next++);
+    out.push_back(q.front());
+    q.pop_front();
+  }
+  assert(q.size() == 1000 && q.capacity() == 1024);
+  while (!q.empty()) {
+    out.push_back(q.front());
+    q.pop_front();
+  }
+  for (int i = 0; i != 2000; ++i)
+    assert(out[i] == i);
+
+  // And as a stack at the front.
+  for (int i = 0; i != 10; ++i)
+    q.emplace_front(i);
+  assert(q.front() == 9 && q.back() == 0 && q.at(3) == 6);
+  q.pop_back();
+  assert(q.back() == 1);
+  try {
+    q.at(9);
+    assert(false);
+  } catch (out_of_range&) { }
+}
+
+void
+check_bulk()
+{
+  ring_buffer<counted> r;
+  for (int i = 0; i != 6; ++i)
+    r.push_back(i);
+  r.pop_front(4);
+  assert(same(r, {4, 5}));
+
+  // The appended range wraps around the end of the array.
+  vector<int> v {6, 7, 8, 9, 10};
+  r.push_back(v.begin(), v.end());
+  assert(r.capacity() == 8 && same(r, {4, 5, 6, 7, 8, 9, 10}));
+
+  vector<counted> out;
+  r.pop_front(3, back_inserter(out));
+  assert(same(out, {4, 5, 6}) && same(r, {7, 8, 9, 10}));
+  r.pop_back(2);
+  assert(same(r, {7, 8}));
+
+  // Input iterators are appended one at a time.
+  list<int> l {11, 12};
+  r.push_back(l.begin(), l.end());
+  assert(same(r, {7, 8, 11, 12}));
+
+  // A range that outgrows the buffer.
+  vector<int> w(20, 1);
+  r.push_back(w.begin(), w.end());
+  assert(r.size() == 24 && r.capacity() == 32 && r[23].n == 1);
+  r.pop_front(r.size());
+  assert(r.empty());
+}
+
+void
+check_iterators()
+{
+  ring_buffer<int> r;
+  for (int i = 0; i != 8; ++i)
+    r.push_back(i);
+  r.pop_front(5);
+  for (int i = 8; i != 12; ++i)
+    r.push_back(i);
+  assert(r.capacity() == 8);
+
+  // The elements are in two runs.
+  assert(r.end() - r.begin() == 7);
+  auto i = r.begin() + 3;
+  assert(*i == 8 && i[1] == 9 && *(i - 3) == 5);
+  assert(r.begin() < i && i <= r.end());
+  ring_buffer<int>::const_iterator c = i;
+  assert(c == i && *c == 8);
+
+  vector<int> v(r.begin(), r.end());
+  assert((v == vector<int> {5, 6, 7, 8, 9, 10, 11}));
+  vector<int> b(r.rbegin(), r.rend());
+  assert((b == vector<int> {11, 10, 9, 8, 7, 6, 5}));
+
+  // Random access algorithms.
+  reverse(r.begin(), r.end());
+  sort(r.begin(), r.end());
+  assert(is_sorted(r.begin(), r.end()));
+  assert(*lower_bound(r.begin(), r.end(), 9) == 9);
+}
+
+void
+check_copy_move()
+{
+  ring_buffer<counted> r;
+  for (int i = 0; i != 10; ++i)
+    r.push_front(i);
+  ring_buffer<counted> s = r;
+  assert(s == r);
+  ring_buffer<counted> t = std::move(s);
+  assert(t == r && s.empty());
+  s = t;
+  assert(s == t);
+  t.pop_back();
+  assert(t < s && s > t && t != s);
+  t = std::move(s);
+  assert(t == r && s.empty());
+  swap(s, t);
+  assert(s == r && t.empty());
+
+  ring_buffer<string> x {"a", string(100, 'b')};
+  ring_buffer<string> y = std::move(x);
+  assert(y[1].size() == 100 && x.empty());
+  ring_buffer<int> z(5, 1);
+  assert(z.size() == 5 && z[4] == 1);
+}
+
+// Growing a wrapped buffer relocates trivially relocatable elements, in
+// order, without moving them.
+void
+check_relocation()
+{
+  ring_buffer<relocated> r;
+  for (int i = 0; i != 8; ++i)
+    r.emplace_back(i);
+  r.pop_front(3);
+  for (int i = 8; i != 11; ++i)
+    r.emplace_back(i);
+  for (int i = 11; i != 40; ++i)
+    r.emplace_back(i);
+  assert(relocated::moves == 0 && r.size() == 37);
+  for (int i = 0; i != 37; ++i)
+    assert(r[i].n == i + 3);
+
+  ring_buffer<unique_ptr<int>> u;
+  for (int i = 0; i != 6; ++i)
+    u.emplace_back(new int(i));
+  for (int i = 0; i != 6; ++i)
+    u.emplace_front(new int(-i - 1));
+  for (int i = 0; i != 12; ++i)
+    assert(*u[i] == i - 6);
+}
+
+int main()
+{
+  check_growth();
+  check_queue();
+  check_bulk();
+  check_iterators();
+  check_copy_move();
+  check_relocation();
+  assert(counted::live == 0);
+}
@@ -0,0 +1,755 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_SMALL_VECTOR_SMALL_VECTOR_HPP
+#define ORIGIN_DATA_SMALL_VECTOR_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <origin/data/concepts.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Small Vector                                              data.small_vector
+  //
+  // A small vector is a vector that stores up to N elements in a buffer
+  // inside the object, and allocates storage with the allocator A only when
+  // it grows past N elements. It is intended for the many short sequences
+  // of sparse data structures: the incident edges of a vertex of small
+  // degree are stored without a separate allocation, and traversing them
+  // does not follow a pointer into the heap.
+  //
+  // Iterators are pointers, and are invalidated as for std::vector. Unlike
+  // std::vector, moving (or swapping) a small vector whose elements are in
+  // its buffer moves the elements, which invalidates their iterators. Once
+  // the elements have been moved into allocated storage, they return to the
+  // buffer only when shrink_to_fit() is called on a vector whose elements
+  // fit.
+  //
+  // Template Parameters:
+  //    T -- The element type
+  //    N -- The number of elements stored in the buffer
+  //    A -- The allocator used when the elements do not fit in the buffer
+  template <typename T, std::size_t N, typename A = std::allocator<T>>
+    class small_vector
+    {
+      static_assert(N > 0, "");
+      static_assert(Allocator<A>(), "");
+
+      using traits = std::allocator_traits<A>;
+    public:
+      using value_type             = T;
+      using allocator_type         = A;
+      using size_type              = std::size_t;
+      using difference_type        = std::ptrdiff_t;
+      using reference              = T&;
+      using const_reference        = const T&;
+      using pointer                = T*;
+      using const_pointer          = const T*;
+      using iterator               = T*;
+      using const_iterator         = const T*;
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      // The number of elements stored in the buffer.
+      static constexpr size_type buffer_size = N;
+
+      // Default construction
+      small_vector();
+      explicit small_vector(const A& a);
+
+      // Fill construction
+      explicit small_vector(size_type n, const A& a = A());
+      small_vector(size_type n, const T& x, const A& a = A());
+
+      // Range construction
+      template <typename I, typename = Requires<Input_iterator<I>()>>
+        small_vector(I first, I last, const A& a = A());
+
+      small_vector(std::initializer_list<T> list, const A& a = A());
+
+      // Copy semantics
+      small_vector(const small_vector& x);
+      small_vector(const small_vector& x, const A& a);
+      small_vector& operator=(const small_vector& x);
+
+      // Move semantics
+      small_vector(small_vector&& x)
+        noexcept(std::is_nothrow_move_constructible<T>::value);
+      small_vector(small_vector&& x, const A& a);
+      small_vector& operator=(small_vector&& x);
+
+      small_vector& operator=(std::initializer_list<T> list);
+
+      ~small_vector();
+
+      // Returns the allocator of the vector.
+      A get_allocator() const { return alloc(); }
+
+      // Size and capacity
+      bool      empty() const    { return impl.size == 0; }
+      size_type size() const     { return impl.size; }
+      size_type capacity() const { return impl.cap; }
+      size_type max_size() const { return traits::max_size(alloc()); }
+
+      // Returns true if the elements are stored in the buffer.
+      bool small() const { return impl.first == buffer(); }
+
+      void reserve(size_type n);
+      void shrink_to_fit();
+
+      // Returns the footprint of the dynamically allocated elements. The
+      // buffer is part of the vector itself, and is not counted.
+      memory_footprint memory_usage() const
+      {
+        if (small())
+          return {};
+        return contiguous_footprint(*this);
+      }
+
+      void resize(size_type n);
+      void resize(size_type n, const T& x);
+
+      // Element access
+      T&       operator[](size_type n)       { return impl.first[n]; }
+      const T& operator[](size_type n) const { return impl.first[n]; }
+
+      T&       at(size_type n);
+      const T& at(size_type n) const;
+
+      T&       front()       { return impl.first[0]; }
+      const T& front() const { return impl.first[0]; }
+
+      T&       back()       { return impl.first[impl.size - 1]; }
+      const T& back() const { return impl.first[impl.size - 1]; }
+
+      T*       data()       { return impl.first; }
+      const T* data() const { return impl.first; }
+
+      // Insertion
+      void push_back(const T& x) { emplace_back(x); }
+      void push_back(T&& x)      { emplace_back(std::move(x)); }
+
+      template <typename... Args>
+        void emplace_back(Args&&... args);
+
+      iterator insert(const_iterator pos, const T& x);
+      iterator insert(const_iterator pos, T&& x);
+
+      template <typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args);
+
+      // Erasure
+      void pop_back();
+
+      iterator erase(const_iterator pos);
+      iterator erase(const_iterator first, const_iterator last);
+
+      void clear();
+
+      void swap(small_vector& x);
+
+      // Iterators
+      iterator       begin()       { return impl.first; }
+      iterator       end()         { return impl.first + impl.size; }
+      const_iterator begin() const { return impl.first; }
+      const_iterator end() const   { return impl.first + impl.size; }
+
+      const_iterator cbegin() const { return begin(); }
+      const_iterator cend() const   { return end(); }
+
+      reverse_iterator rbegin() { return reverse_iterator(end()); }
+      reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+      const_reverse_iterator rbegin() const
+      {
+        return const_reverse_iterator(end());
+      }
+
+      const_reverse_iterator rend() const
+      {
+        return const_reverse_iterator(begin());
+      }
+
+    private:
+      A&       alloc()       { return impl; }
+      const A& alloc() const { return impl; }
+
+      T*       buffer()       { return reinterpret_cast<T*>(&buf); }
+      const T* buffer() const { return reinterpret_cast<const T*>(&buf); }
+
+      // Returns the capacity to which the vector grows when it must hold at
+      // least n elements.
+      size_type grown(size_type n) const;
+
+      // Move the elements into new storage for n elements.
+      void relocate(size_type n);
+      void relocate_elements(T* p, std::true_type);
+      void relocate_elements(T* p, std::false_type);
+
+      // Release the elements and their storage, returning the vector to its
+      // buffer; the allocator is unchanged.
+      void release();
+
+      // Append the elements of [first, last), which are not in this vector.
+      template <typename I>
+        void append(I first, I last, std::input_iterator_tag);
+      template <typename I>
+        void append(I first, I last, std::forward_iterator_tag);
+
+      // Take the allocated storage of x, or move its elements when they are
+      // in its buffer. The vector must be empty and in its buffer.
+      void steal(small_vector& x);
+
+    private:
+      // The allocator is a base class, so that empty allocators take no
+      // space in the vector.
+      struct impl_type : A
+      {
+        impl_type(const A& a, T* p)
+          : A(a), first(p), size(0), cap(N)
+        { }
+
+        T*        first; // The first element
+        size_type size;  // The number of elements
+        size_type cap;   // The capacity of the storage at first
+      };
+
+      impl_type impl;
+      Aligned_storage<sizeof(T) * N, alignof(T)> buf;
+    };
+
+  template <typename T, std::size_t N, typename A>
+    constexpr std::size_t small_vector<T, N, A>::buffer_size;
+
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector()
+      : impl(A(), buffer())
+    { }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(const A& a)
+      : impl(a, buffer())
+    { }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(size_type n, const A& a)
+      : impl(a, buffer())
+    {
+      resize(n);
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(size_type n, const T& x, const A& a)
+      : impl(a, buffer())
+    {
+      resize(n, x);
+    }
+
+  template <typename T, std::size_t N, typename A>
+    template <typename I, typename Req>
+      inline
+      small_vector<T, N, A>::small_vector(I first, I last, const A& a)
+        : impl(a, buffer())
+      {
+        append(first, last, Iterator_category<I>());
+      }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(std::initializer_list<T> list,
+                                        const A& a)
+      : impl(a, buffer())
+    {
+      append(list.begin(), list.end(), std::random_access_iterator_tag());
+    }
+
+  // Copy semantics
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(const small_vector& x)
+      : impl(traits::select_on_container_copy_construction(x.alloc()),
+             buffer())
+    {
+      append(x.begin(), x.end(), std::random_access_iterator_tag());
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(const small_vector& x, const A& a)
+      : impl(a, buffer())
+    {
+      append(x.begin(), x.end(), std::random_access_iterator_tag());
+    }
+
+  // The elements of x are copied into the vector. If the allocator is
+  // propagated on copy assignment and differs from that of x, the storage
+  // of the vector is released first.
+  template <typename T, std::size_t N, typename A>
+    auto
+    small_vector<T, N, A>::operator=(const small_vector& x) -> small_vector&
+    {
+      if (&x == this)
+        return *this;
+      if (traits::propagate_on_container_copy_assignment::value) {
+        if (!(alloc() == x.alloc()))
+          release();
+        alloc() = x.alloc();
+      }
+      if (x.size() <= size()) {
+        iterator i = std::copy(x.begin(), x.end(), begin());
+        erase(i, end());
+      } else {
+        std::copy(x.begin(), x.begin() + size(), begin());
+        append(x.begin() + size(), x.end(), std::random_access_iterator_tag());
+      }
+      return *this;
+    }
+
+  // Move semantics
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(small_vector&& x)
+      noexcept(std::is_nothrow_move_constructible<T>::value)
+      : impl(x.alloc(), buffer())
+    {
+      steal(x);
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::small_vector(small_vector&& x, const A& a)
+      : impl(a, buffer())
+    {
+      if (alloc() == x.alloc())
+        steal(x);
+      else
+        append(std::make_move_iterator(x.begin()),
+               std::make_move_iterator(x.end()),
+               std::random_access_iterator_tag());
+    }
+
+  // If the allocators of the vector and x are interchangeable, or the
+  // allocator is propagated on move assignment, the vector takes the storage
+  // of x. Otherwise, the elements of x are moved into the storage of the
+  // vector. In either case, x is left empty.
+  template <typename T, std::size_t N, typename A>
+    auto
+    small_vector<T, N, A>::operator=(small_vector&& x) -> small_vector&
+    {
+      if (&x == this)
+        return *this;
+      bool pocma = traits::propagate_on_container_move_assignment::value;
+      if (pocma || alloc() == x.alloc()) {
+        release();
+        if (pocma)
+          alloc() = std::move(x.alloc());
+        steal(x);
+      } else {
+        clear();
+        append(std::make_move_iterator(x.begin()),
+               std::make_move_iterator(x.end()),
+               std::random_access_iterator_tag());
+        x.clear();
+      }
+      return *this;
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline auto
+    small_vector<T, N, A>::operator=(std::initializer_list<T> list)
+      -> small_vector&
+    {
+      clear();
+      append(list.begin(), list.end(), std::random_access_iterator_tag());
+      return *this;
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline
+    small_vector<T, N, A>::~small_vector()
+    {
+      release();
+    }
+
+
+  // Capacity
+  template <typename T, std::size_t N, typename A>
+    inline auto
+    small_vector<T, N, A>::grown(size_type n) const -> size_type
+    {
+      return std::max(n, 2 * capacity());
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline void
+    small_vector<T, N, A>::reserve(size_type n)
+    {
+      if (n > capacity())
+        relocate(n);
+    }
+
+  // Release any unused allocated storage. If the elements fit in the
+  // buffer, they are moved back into it.
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::shrink_to_fit()
+    {
+      if (small() || size() == capacity())
+        return;
+      if (size() <= N) {
+        T* p = impl.first;
+        T* q = buffer();
+        relocate_elements(q, is_trivially_relocatable<T>());
+        traits::deallocate(alloc(), p, capacity());
+        impl.first = q;
+        impl.cap = N;
+      } else {
+        relocate(size());
+      }
+    }
+
+  // Allocate storage for n elements, where n is at least the size of the
+  // vector, and move the elements into it. If moving an element throws,
+  // the new storage is released and the vector keeps its storage.
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::relocate(size_type n)
+    {
+      assert(n >= size());
+      T* p = traits::allocate(alloc(), n);
+      try {
+        relocate_elements(p, is_trivially_relocatable<T>());
+      } catch (...) {
+        traits::deallocate(alloc(), p, n);
+        throw;
+      }
+      if (!small())
+        traits::deallocate(alloc(), impl.first, capacity());
+      impl.first = p;
+      impl.cap = n;
+    }
+
+  // Move the elements into the uninitialized storage p, and destroy the
+  // originals. Trivially relocatable elements are copied by a single memcpy
+  // (see type.relocatable), and are not destroyed.
+  template <typename T, std::size_t N, typename A>
+    inline void
+    small_vector<T, N, A>::relocate_elements(T* p, std::true_type)
+    {
+      if (size())
+        std::memcpy(static_cast<void*>(p), impl.first, size() * sizeof(T));
+    }
+
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::relocate_elements(T* p, std::false_type)
+    {
+      std::uninitialized_copy(std::make_move_iterator(impl.first),
+                              std::make_move_iterator(impl.first + size()),
+                              p);
+      for (size_type i = 0; i != size(); ++i)
+        impl.first[i].~T();
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline void
+    small_vector<T, N, A>::release()
+    {
+      clear();
+      if (!small())
+        traits::deallocate(alloc(), impl.first, capacity());
+      impl.first = buffer();
+      impl.cap = N;
+    }
+
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::steal(small_vector& x)
+    {
+      assert(empty() && small());
+      if (x.small()) {
+        std::uninitialized_copy(std::make_move_iterator(x.begin()),
+                                std::make_move_iterator(x.end()), buffer());
+        impl.size = x.size();
+        x.clear();
+      } else {
+        impl.first = x.impl.first;
+        impl.size = x.impl.size;
+        impl.cap = x.impl.cap;
+        x.impl.first = x.buffer();
+        x.impl.size = 0;
+        x.impl.cap = N;
+      }
+    }
+
+  template <typename T, std::size_t N, typename A>
+    template <typename I>
+      inline void
+      small_vector<T, N, A>::append(I first, I last, std::input_iterator_tag)
+      {
+        for ( ; first != last; ++first)
+          emplace_back(*first);
+      }
+
+  template <typename T, std::size_t N, typename A>
+    template <typename I>
+      inline void
+      small_vector<T, N, A>::append(I first, I last, std::forward_iterator_tag)
+      {
+        size_type n = std::distance(first, last);
+        reserve(size() + n);
+        std::uninitialized_copy(first, last, end());
+        impl.size += n;
+      }
+
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::resize(size_type n)
+    {
+      if (n < size()) {
+        erase(begin() + n, end());
+      } else {
+        reserve(n);
+        for (; size() != n; ++impl.size)
+          ::new (end()) T();
+      }
+    }
+
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::resize(size_type n, const T& x)
+    {
+      if (n < size()) {
+        erase(begin() + n, end());
+      } else {
+        reserve(n);
+        std::uninitialized_fill(end(), begin() + n, x);
+        impl.size = n;
+      }
+    }
+
+
+  // Element access
+  template <typename T, std::size_t N, typename A>
+    inline T&
+    small_vector<T, N, A>::at(size_type n)
+    {
+      if (n >= size())
+        throw std::out_of_range("small_vector");
+      return impl.first[n];
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline const T&
+    small_vector<T, N, A>::at(size_type n) const
+    {
+      if (n >= size())
+        throw std::out_of_range("small_vector");
+      return impl.first[n];
+    }
+
+
+  // Insertion
+  //
+  // When the vector is full, the new element is constructed in the new
+  // storage before the elements are moved, so that args may refer to an
+  // element of the vector.
+  template <typename T, std::size_t N, typename A>
+    template <typename... Args>
+      inline void
+      small_vector<T, N, A>::emplace_back(Args&&... args)
+      {
+        if (size() != capacity()) {
+          ::new (end()) T(std::forward<Args>(args)...);
+          ++impl.size;
+          return;
+        }
+        size_type n = grown(size() + 1);
+        T* p = traits::allocate(alloc(), n);
+        try {
+          ::new (p + size()) T(std::forward<Args>(args)...);
+        } catch (...) {
+          traits::deallocate(alloc(), p, n);
+          throw;
+        }
+        relocate_elements(p, is_trivially_relocatable<T>());
+        if (!small())
+          traits::deallocate(alloc(), impl.first, capacity());
+        impl.first = p;
+        impl.cap = n;
+        ++impl.size;
+      }
+
+  template <typename T, std::size_t N, typename A>
+    inline auto
+    small_vector<T, N, A>::insert(const_iterator pos, const T& x) -> iterator
+    {
+      return emplace(pos, x);
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline auto
+    small_vector<T, N, A>::insert(const_iterator pos, T&& x) -> iterator
+    {
+      return emplace(pos, std::move(x));
+    }
+
+  // The new element is appended and rotated into position.
+  template <typename T, std::size_t N, typename A>
+    template <typename... Args>
+      auto
+      small_vector<T, N, A>::emplace(const_iterator pos, Args&&... args)
+        -> iterator
+      {
+        size_type n = pos - begin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + n, end() - 1, end());
+        return begin() + n;
+      }
+
+
+  // Erasure
+  template <typename T, std::size_t N, typename A>
+    inline void
+    small_vector<T, N, A>::pop_back()
+    {
+      assert(!empty());
+      --impl.size;
+      end()->~T();
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline auto
+    small_vector<T, N, A>::erase(const_iterator pos) -> iterator
+    {
+      return erase(pos, pos + 1);
+    }
+
+  // Erasing an empty range does nothing. Moving the tail onto itself
+  // would self-move-assign its elements, which may leave them empty.
+  template <typename T, std::size_t N, typename A>
+    auto
+    small_vector<T, N, A>::erase(const_iterator first, const_iterator last)
+      -> iterator
+    {
+      iterator i = begin() + (first - begin());
+      if (first == last)
+        return i;
+      iterator j = begin() + (last - begin());
+      iterator k = std::move(j, end(), i);
+      for (iterator p = k; p != end(); ++p)
+        p->~T();
+      impl.size = k - begin();
+      return i;
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline void
+    small_vector<T, N, A>::clear()
+    {
+      for (size_type i = 0; i != size(); ++i)
+        impl.first[i].~T();
+      impl.size = 0;
+    }
+
+  // Exchange the elements of the vector and x. If the elements of both
+  // vectors are in allocated storage, only the pointers are exchanged.
+  template <typename T, std::size_t N, typename A>
+    void
+    small_vector<T, N, A>::swap(small_vector& x)
+    {
+      if (&x == this)
+        return;
+      if (!small() && !x.small()) {
+        if (traits::propagate_on_container_swap::value) {
+          using std::swap;
+          swap(alloc(), x.alloc());
+        }
+        std::swap(impl.first, x.impl.first);
+        std::swap(impl.size, x.impl.size);
+        std::swap(impl.cap, x.impl.cap);
+      } else {
+        small_vector tmp(std::move(x));
+        x = std::move(*this);
+        *this = std::move(tmp);
+      }
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline void
+    swap(small_vector<T, N, A>& a, small_vector<T, N, A>& b)
+    {
+      a.swap(b);
+    }
+
+
+  // Equality comparable
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    operator==(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+    {
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    operator!=(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+    {
+      return !(a == b);
+    }
+
+  // Totally ordered
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    operator<(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+    {
+      return std::lexicographical_compare(a.begin(), a.end(),
+                                          b.begin(), b.end());
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    operator>(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+    {
+      return b < a;
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    operator<=(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+    {
+      return !(b < a);
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    operator>=(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+    {
+      return !(a < b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,228 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <origin/memory/arena.hpp>
+#include <origin/data/small_vector/small_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A counted object tracks the number of live objects, so that leaked or
+// doubly destroyed elements are detected.
+struct counted
+{
+  static int live;
+
+  counted(int n = 0) : n(n) { ++live; }
+  counted(const counted& x) : n(x.n) { ++live; }
+  counted(counted&& x) : n(x.n) { x.n = -1; ++live; }
+  ~counted() { --live; }
+
+  counted& operator=(const counted&) = default;
+  counted& operator=(counted&&) = default;
+
+  bool operator==(const counted& x) const { return n == x.n; }
+  bool operator<(const counted& x) const { return n < x.n; }
+
+  int n;
+};
+
+int counted::live = 0;
+
+// A relocated object counts its moves. It is trivially relocatable, so that
+// growing a container copies its bytes rather than moving it.
+struct relocated
+{
+  static int moves;
+
+  relocated(int n = 0) : n(n) { }
+  relocated(relocated&& x) : n(x.n) { ++moves; }
+  ~relocated() { }
+
+  relocated& operator=(relocated&&) = default;
+
+  int n;
+};
+
+int relocated::moves = 0;
+
+namespace origin
+{
+  template <>
+    struct is_trivially_relocatable<relocated> : std::true_type { };
+} // namespace origin
+
+template <typename V>
+  bool
+  same(const V& v, const vector<int>& w)
+  {
+    if (v.size() != w.size())
+      return false;
+    for (size_t i = 0; i != w.size(); ++i)
+      if (v[i].n != w[i])
+        return false;
+    return true;
+  }
+
+void
+check_growth()
+{
+  using V = small_vector<counted, 4>;
+  V v;
+  assert(v.empty() && v.small() && v.capacity() == 4);
+  for (int i = 0; i != 4; ++i)
+    v.push_back(i);
+  assert(v.small() && v.size() == 4);
+
+  // Growing past the buffer moves the elements into allocated storage.
+  v.emplace_back(4);
+  assert(!v.small() && v.capacity() >= 5);
+  assert(same(v, {0, 1, 2, 3, 4}));
+
+  // An element of the vector can be appended while growing.
+  while (v.size() != v.capacity())
+    v.push_back(0);
+  v.push_back(v[1]);
+  assert(v.back().n == 1);
+
+  // Shrinking returns elements that fit to the buffer.
+  v.resize(3);
+  v.shrink_to_fit();
+  assert(v.small() && same(v, {0, 1, 2}));
+  assert(counted::live == 3);
+}
+
+void
+check_modifiers()
+{
+  using V = small_vector<counted, 2>;
+  V v {1, 2, 3};
+  v.insert(v.begin(), counted(0));
+  v.emplace(v.begin() + 2, 9);
+  assert(same(v, {0, 1, 9, 2, 3}));
+  v.erase(v.begin() + 2);
+  assert(same(v, {0, 1, 2, 3}));
+  v.erase(v.begin(), v.begin() + 3);
+  assert(same(v, {3}));
+
+  // Erasing an empty range leaves the elements unchanged.
+  small_vector<string, 4> s {"a", "b", "c"};
+  assert(s.erase(s.begin(), s.begin()) == s.begin());
+  assert(s.erase(s.begin() + 1, s.begin() + 1) == s.begin() + 1);
+  assert(s.size() == 3 && s[0] == "a" && s[1] == "b" && s[2] == "c");
+  v.pop_back();
+  assert(v.empty());
+
+  v.resize(3, counted(7));
+  assert(same(v, {7, 7, 7}));
+  v.clear();
+  assert(counted::live == 0);
+
+  try {
+    v.at(0);
+    assert(false);
+  } catch (out_of_range&) { }
+}
+
+void
+check_copy_move()
+{
+  using V = small_vector<counted, 3>;
+  V a {1, 2};
+  V b {1, 2, 3, 4, 5};
+
+  // Copies are equal, in both representations.
+  V c = a;
+  V d = b;
+  assert(c == a && d == b && c.small() && !d.small());
+  c = b;
+  assert(c == b);
+  d = a;
+  assert(d == a);
+
+  // Moving allocated storage takes the pointer; moving the buffer moves
+  // the elements.
+  const counted* p = b.data();
+  V e = std::move(b);
+  assert(e.data() == p && b.empty() && b.small());
+  V f = std::move(a);
+  assert(same(f, {1, 2}) && a.empty());
+
+  e.swap(f);
+  assert(same(e, {1, 2}) && same(f, {1, 2, 3, 4, 5}));
+  swap(e, f);
+  assert(same(f, {1, 2}) && same(e, {1, 2, 3, 4, 5}));
+
+  e = std::move(f);
+  assert(same(e, {1, 2}));
+  assert(e < c && !(c < e) && e != c);
+}
+
+void
+check_allocator()
+{
+  // Elements that spill from the buffer are allocated by the allocator.
+  arena a;
+  using V = small_vector<int, 2, arena_allocator<int>>;
+  V v {arena_allocator<int>(a)};
+  v.push_back(1);
+  v.push_back(2);
+  assert(a.capacity() == 0);
+  v.push_back(3);
+  assert(a.capacity() != 0);
+  assert(&v.get_allocator().arena() == &a);
+
+  V w = v;
+  assert(&w.get_allocator().arena() == &a && w == v);
+
+  // Strings in the buffer keep their own storage.
+  small_vector<string, 2> s {"a", string(100, 'b')};
+  small_vector<string, 2> t = std::move(s);
+  assert(t[1].size() == 100 && s.empty());
+  vector<int> x {1, 2, 3};
+  small_vector<int, 8> u(x.begin(), x.end());
+  assert(u.size() == 3 && u[2] == 3);
+  small_vector<int, 8> z(5, 1);
+  assert(z.size() == 5 && z[4] == 1);
+}
+
+// Growing past the buffer and reallocating relocate trivially relocatable
+// elements without moving them.
+void
+check_relocation()
+{
+  small_vector<relocated, 4> v;
+  for (int i = 0; i != 100; ++i)
+    v.emplace_back(i);
+  v.resize(3);
+  v.shrink_to_fit();
+  assert(v.small() && relocated::moves == 0);
+  for (int i = 0; i != 3; ++i)
+    assert(v[i].n == i);
+
+  small_vector<unique_ptr<int>, 2> u;
+  for (int i = 0; i != 10; ++i)
+    u.emplace_back(new int(i));
+  for (int i = 0; i != 10; ++i)
+    assert(*u[i] == i);
+}
+
+int main()
+{
+  check_growth();
+  check_modifiers();
+  check_copy_move();
+  check_relocation();
+  assert(counted::live == 0);
+  check_allocator();
+}
@@ -0,0 +1,335 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_STATIC_SEARCH_EYTZINGER_ARRAY_HPP
+#define ORIGIN_DATA_STATIC_SEARCH_EYTZINGER_ARRAY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <origin/data/concepts.hpp>
+#include <origin/memory/allocator.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Eytzinger Array                                       data.eytzinger_array
+  //
+  // An Eytzinger array stores a sorted sequence in the order of a breadth
+  // first traversal of a complete binary search tree: the root is at index
+  // 1, and the children of the node at i are at 2i and 2i + 1. A binary
+  // search visits the elements in the order they are stored, so the top of
+  // the tree shares a few cache lines, and the 16 descendants of a node four
+  // levels down (for 4-byte values) fill one cache line, which is fetched
+  // while the search is still comparing above it. Each step of the search
+  // computes the next index as 2i + comp(a[i], x), without a branch.
+  //
+  // Searches return ranks: the position of the result in the sorted
+  // sequence the array was built from, or size() when there is none. A rank
+  // can index a separate array of values associated with the keys.
+  //
+  // The batched searches, lower_bound_many(keys, out) and upper_bound_many,
+  // write the rank of each key in the forward range keys to the output
+  // iterator out. They advance a group of searches one level at a time, so
+  // that the cache misses of independent searches overlap.
+  //
+  // Template Parameters:
+  //    T -- The element type
+  //    C -- The strict weak order of the elements
+  template <typename T, typename C = std::less<T>>
+    class eytzinger_array
+    {
+      static_assert(Relation<C, T>(), "");
+    public:
+      using value_type = T;
+      using value_compare = C;
+      using size_type = std::size_t;
+
+      // The number of searches advanced together by a batched search.
+      static constexpr size_type batch_size = 16;
+
+      explicit eytzinger_array(const C& comp = C())
+        : comp_(comp), n_(0), height_(0), leaves_(0)
+      { }
+
+      // Construct the array from the sorted range [first, last).
+      template <typename I>
+        eytzinger_array(I first, I last, const C& comp = C())
+          : comp_(comp)
+        {
+          assign(first, last);
+        }
+
+      eytzinger_array(std::initializer_list<T> list, const C& comp = C())
+        : comp_(comp)
+      {
+        assign(list.begin(), list.end());
+      }
+
+      // Replace the elements with those of the sorted range [first, last).
+      template <typename I>
+        void assign(I first, I last);
+
+      // Returns the number of elements.
+      size_type size() const { return n_; }
+      bool empty() const { return n_ == 0; }
+
+      value_compare value_comp() const { return comp_; }
+
+      // Copy the elements to out in sorted order.
+      template <typename O>
+        O copy(O out) const { return copy(out, 1); }
+
+      // Returns the rank of the first element that is not less than x.
+      size_type lower_bound(const T& x) const
+      {
+        return search(x, lower_step());
+      }
+
+      // Returns the rank of the first element that is greater than x.
+      size_type upper_bound(const T& x) const
+      {
+        return search(x, upper_step());
+      }
+
+      // Returns true if an element is equivalent to x.
+      bool contains(const T& x) const
+      {
+        size_type k = lower_bound(x);
+        return k != n_ && !comp_(x, at(k));
+      }
+
+      // Batched searches
+      template <typename R, typename O>
+        O lower_bound_many(const R& keys, O out) const
+        {
+          return search_many(keys, out, lower_step());
+        }
+
+      template <typename R, typename O>
+        O upper_bound_many(const R& keys, O out) const
+        {
+          return search_many(keys, out, upper_step());
+        }
+
+    private:
+      // The step of a search for the lower bound goes right past the
+      // elements less than x; that for the upper bound also goes right past
+      // those equivalent to x.
+      struct lower_step
+      {
+        bool operator()(const C& comp, const T& a, const T& x) const
+        {
+          return comp(a, x);
+        }
+      };
+
+      struct upper_step
+      {
+        bool operator()(const C& comp, const T& a, const T& x) const
+        {
+          return !comp(x, a);
+        }
+      };
+
+      // The number of elements in a cache line, rounded down to a power of
+      // two. The descendants of the node i that number of levels down start
+      // at the index stride * i.
+      static constexpr size_type stride()
+      {
+        return sizeof(T) > 32 ? 1
+             : sizeof(T) > 16 ? 2
+             : sizeof(T) > 8 ? 4
+             : sizeof(T) > 4 ? 8
+             : sizeof(T) > 2 ? 16
+             : sizeof(T) > 1 ? 32 : 64;
+      }
+
+      void prefetch(size_type i) const
+      {
+        __builtin_prefetch(a_.data() + std::min(stride() * i, n_));
+      }
+
+      template <typename I>
+        I build(I first, size_type i);
+
+      template <typename O>
+        O copy(O out, size_type i) const;
+
+      // Returns the element whose rank is k.
+      const T& at(size_type k) const;
+
+      // Returns the rank of the node i, or size() if i is 0.
+      size_type rank(size_type i) const;
+
+      // Returns the rank of the bound found by a search that left the tree
+      // at the index j. The bound is the node at which the search last went
+      // left: j with its trailing 1 bits and the 0 bit above them removed.
+      size_type bound(size_type j) const
+      {
+        return rank(j >> (__builtin_ctzll(~(unsigned long long)j) + 1));
+      }
+
+      template <typename S>
+        size_type search(const T& x, S step) const
+        {
+          const T* a = a_.data();
+          size_type i = 1;
+          while (i <= n_) {
+            prefetch(i);
+            i = 2 * i + step(comp_, a[i], x);
+          }
+          return bound(i);
+        }
+
+      template <typename R, typename O, typename S>
+        O search_many(const R& keys, O out, S step) const;
+
+    private:
+      // The elements are stored at the indexes 1 to n; the element at 0 is
+      // not used, so that the 64-byte alignment of the storage aligns the
+      // children of each node.
+      std::vector<T, aligned_allocator<T>> a_;
+      C comp_;
+      size_type n_;
+
+      // The depth of the last level of the tree, and the number of nodes in
+      // that level.
+      size_type height_;
+      size_type leaves_;
+    };
+
+
+  template <typename T, typename C>
+    template <typename I>
+      void
+      eytzinger_array<T, C>::assign(I first, I last)
+      {
+        assert(std::is_sorted(first, last, comp_));
+        n_ = std::distance(first, last);
+        a_.clear();
+        height_ = 0;
+        leaves_ = 0;
+        if (n_ == 0)
+          return;
+        a_.assign(n_ + 1, *first);
+        build(first, 1);
+        while ((size_type(2) << height_) <= n_)
+          ++height_;
+        leaves_ = n_ - ((size_type(1) << height_) - 1);
+      }
+
+  // Fill the subtree rooted at the node i by an in-order traversal of
+  // the sorted elements starting at first.
+  template <typename T, typename C>
+    template <typename I>
+      I
+      eytzinger_array<T, C>::build(I first, size_type i)
+      {
+        if (i <= n_) {
+          first = build(first, 2 * i);
+          a_[i] = *first;
+          ++first;
+          first = build(first, 2 * i + 1);
+        }
+        return first;
+      }
+
+  template <typename T, typename C>
+    template <typename O>
+      O
+      eytzinger_array<T, C>::copy(O out, size_type i) const
+      {
+        if (i <= n_) {
+          out = copy(out, 2 * i);
+          *out = a_[i];
+          ++out;
+          out = copy(out, 2 * i + 1);
+        }
+        return out;
+      }
+
+  // The node whose rank is k is found by the search for it, which is
+  // bounded by the height of the tree.
+  template <typename T, typename C>
+    const T&
+    eytzinger_array<T, C>::at(size_type k) const
+    {
+      size_type i = 1;
+      while (true) {
+        size_type r = rank(i);
+        if (r == k)
+          return a_[i];
+        i = 2 * i + (r < k);
+      }
+    }
+
+  // If the last level were full, the tree would be perfect, and the node
+  // at the position p of the level d would have the in-order rank
+  // (2p + 1) * 2^(H - d) - 1. The leaves of the perfect tree have the even
+  // ranks, and those not in the last level are at its end, so the rank in
+  // the complete tree is that, less the number of missing leaves before
+  // the node.
+  template <typename T, typename C>
+    auto
+    eytzinger_array<T, C>::rank(size_type i) const -> size_type
+    {
+      if (i == 0)
+        return n_;
+      size_type d = 63 - __builtin_clzll(i);
+      size_type p = i - (size_type(1) << d);
+      size_type r = ((2 * p + 1) << (height_ - d)) - 1;
+      size_type before = (r + 1) / 2;
+      return before > leaves_ ? r - (before - leaves_) : r;
+    }
+
+  // Each pass over a group advances its searches by one level. Every
+  // search passes through the first height levels, and only the last
+  // level, which may be partly filled, needs a test.
+  template <typename T, typename C>
+    template <typename R, typename O, typename S>
+      O
+      eytzinger_array<T, C>::search_many(const R& keys, O out, S step) const
+      {
+        using std::begin;
+        using std::end;
+        const T* a = a_.data();
+        const T* x[batch_size];
+        size_type i[batch_size];
+        auto first = begin(keys);
+        auto last = end(keys);
+        while (first != last) {
+          size_type g = 0;
+          for (; g != batch_size && first != last; ++g, ++first) {
+            x[g] = std::addressof(*first);
+            i[g] = 1;
+          }
+          for (size_type d = 0; d != height_; ++d) {
+            for (size_type k = 0; k != g; ++k) {
+              i[k] = 2 * i[k] + step(comp_, a[i[k]], *x[k]);
+              prefetch(i[k]);
+            }
+          }
+          for (size_type k = 0; k != g; ++k) {
+            if (i[k] <= n_)
+              i[k] = 2 * i[k] + step(comp_, a[i[k]], *x[k]);
+            *out = bound(i[k]);
+            ++out;
+          }
+        }
+        return out;
+      }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,66 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <origin/data/static_search/eytzinger_array.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check every search of an array of n elements, with runs of equal
+// elements, against those of the sorted vector.
+void check_searches(int n)
+{
+  vector<int> v(n);
+  for (int i = 0; i != n; ++i)
+    v[i] = i / 3 * 2;
+  eytzinger_array<int> a(v.begin(), v.end());
+  assert(a.size() == size_t(n));
+
+  vector<int> keys;
+  for (int x = -1; x <= 2 * (n / 3) + 2; ++x)
+    keys.push_back(x);
+  vector<size_t> lo, hi;
+  a.lower_bound_many(keys, back_inserter(lo));
+  a.upper_bound_many(keys, back_inserter(hi));
+  assert(lo.size() == keys.size() && hi.size() == keys.size());
+  for (size_t i = 0; i != keys.size(); ++i) {
+    int x = keys[i];
+    size_t l = lower_bound(v.begin(), v.end(), x) - v.begin();
+    size_t u = upper_bound(v.begin(), v.end(), x) - v.begin();
+    assert(a.lower_bound(x) == l && lo[i] == l);
+    assert(a.upper_bound(x) == u && hi[i] == u);
+    assert(a.contains(x) == binary_search(v.begin(), v.end(), x));
+  }
+
+  vector<int> w;
+  a.copy(back_inserter(w));
+  assert(w == v);
+}
+
+int main()
+{
+  for (int n = 0; n != 300; ++n)
+    check_searches(n);
+  check_searches(1023);
+  check_searches(1024);
+  check_searches(5000);
+
+  eytzinger_array<int> e;
+  assert(e.empty() && e.lower_bound(1) == 0 && !e.contains(1));
+
+  // A descending array of strings.
+  eytzinger_array<string, greater<string>> s {"d", "c", "b", "a"};
+  assert(s.lower_bound("c") == 1 && s.upper_bound("c") == 2);
+  assert(s.lower_bound("z") == 0 && s.upper_bound("0") == 4);
+  assert(s.contains("b") && !s.contains("e"));
+}
@@ -0,0 +1,286 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_DATA_STATIC_SEARCH_STATIC_BTREE_HPP
+#define ORIGIN_DATA_STATIC_SEARCH_STATIC_BTREE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <origin/data/concepts.hpp>
+#include <origin/memory/allocator.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Static B-tree                                           data.static_btree
+  //
+  // A static B-tree stores a sorted sequence as the leaves of an implicit
+  // B+ tree whose nodes hold B elements: by default, as many as fill a
+  // cache line. The leaves are the sorted elements, padded to a multiple of
+  // B with copies of the greatest. Each node above them has B keys and
+  // B + 1 children, and the key t of a node is the greatest element under
+  // its child t. A search reads one node per level, and chooses the child
+  // by counting the keys less than x, which is a loop over the node without
+  // branches. The tree has about log(n) / log(B + 1) levels, so it takes
+  // fewer cache misses than a binary search of any layout.
+  //
+  // The nodes are stored level by level, the leaves first, in storage
+  // aligned on cache lines. Searches return ranks, as for the Eytzinger
+  // array (see data.eytzinger_array), and the batched searches advance a
+  // group of searches in lockstep, prefetching the node that each reads
+  // next.
+  //
+  // Template Parameters:
+  //    T -- The element type
+  //    C -- The strict weak order of the elements
+  //    B -- The number of elements in a node
+  template <typename T,
+            typename C = std::less<T>,
+            std::size_t B = (sizeof(T) < 64 ? 64 / sizeof(T) : 1)>
+    class static_btree
+    {
+      static_assert(Relation<C, T>(), "");
+      static_assert(B > 0, "");
+    public:
+      using value_type = T;
+      using value_compare = C;
+      using size_type = std::size_t;
+
+      // The number of elements in a node.
+      static constexpr size_type node_size = B;
+
+      // The number of searches advanced together by a batched search.
+      static constexpr size_type batch_size = 16;
+
+      explicit static_btree(const C& comp = C())
+        : comp_(comp), n_(0)
+      { }
+
+      // Construct the tree from the sorted range [first, last).
+      template <typename I>
+        static_btree(I first, I last, const C& comp = C())
+          : comp_(comp)
+        {
+          assign(first, last);
+        }
+
+      static_btree(std::initializer_list<T> list, const C& comp = C())
+        : comp_(comp)
+      {
+        assign(list.begin(), list.end());
+      }
+
+      // Replace the elements with those of the sorted range [first, last).
+      template <typename I>
+        void assign(I first, I last);
+
+      // Returns the number of elements.
+      size_type size() const { return n_; }
+      bool empty() const { return n_ == 0; }
+
+      // Returns the number of levels of the tree.
+      size_type height() const { return width_.size(); }
+
+      value_compare value_comp() const { return comp_; }
+
+      // Returns the element whose rank is k.
+      const T& operator[](size_type k) const { return a_[k]; }
+
+      // Copy the elements to out in sorted order.
+      template <typename O>
+        O copy(O out) const { return std::copy_n(a_.data(), n_, out); }
+
+      // Returns the rank of the first element that is not less than x.
+      size_type lower_bound(const T& x) const
+      {
+        return search(x, lower_step());
+      }
+
+      // Returns the rank of the first element that is greater than x.
+      size_type upper_bound(const T& x) const
+      {
+        return search(x, upper_step());
+      }
+
+      // Returns true if an element is equivalent to x.
+      bool contains(const T& x) const
+      {
+        size_type k = lower_bound(x);
+        return k != n_ && !comp_(x, a_[k]);
+      }
+
+      // Batched searches
+      template <typename R, typename O>
+        O lower_bound_many(const R& keys, O out) const
+        {
+          return search_many(keys, out, lower_step());
+        }
+
+      template <typename R, typename O>
+        O upper_bound_many(const R& keys, O out) const
+        {
+          return search_many(keys, out, upper_step());
+        }
+
+    private:
+      // A search for the lower bound counts the keys less than x; one for
+      // the upper bound counts those not greater than x.
+      struct lower_step
+      {
+        bool operator()(const C& comp, const T& a, const T& x) const
+        {
+          return comp(a, x);
+        }
+      };
+
+      struct upper_step
+      {
+        bool operator()(const C& comp, const T& a, const T& x) const
+        {
+          return !comp(x, a);
+        }
+      };
+
+      // Returns the number of keys of the node p counted by step.
+      template <typename S>
+        size_type count(const T* p, const T& x, S step) const
+        {
+          size_type c = 0;
+          for (size_type t = 0; t != B; ++t)
+            c += step(comp_, p[t], x);
+          return c;
+        }
+
+      template <typename S>
+        size_type search(const T& x, S step) const
+        {
+          if (n_ == 0 || step(comp_, a_[n_ - 1], x))
+            return n_;
+          const T* a = a_.data();
+          size_type k = 0;
+          for (size_type l = width_.size() - 1; l != 0; --l)
+            k = k * (B + 1) + count(a + level_[l] + k * B, x, step);
+          return k * B + count(a + k * B, x, step);
+        }
+
+      template <typename R, typename O, typename S>
+        O search_many(const R& keys, O out, S step) const;
+
+    private:
+      // The leaves and the nodes above them. The level l starts at the
+      // offset level_[l] and has width_[l] nodes; the leaves are level 0.
+      std::vector<T, aligned_allocator<T>> a_;
+      std::vector<size_type> level_;
+      std::vector<size_type> width_;
+      C comp_;
+      size_type n_;
+    };
+
+
+  // The key t of a node is the greatest element under its child t, which is
+  // the last element under the last child of that child. The key of a child
+  // past the end of the level is the greatest element, so that no search
+  // that can succeed counts past the last child.
+  template <typename T, typename C, std::size_t B>
+    template <typename I>
+      void
+      static_btree<T, C, B>::assign(I first, I last)
+      {
+        assert(std::is_sorted(first, last, comp_));
+        n_ = std::distance(first, last);
+        a_.clear();
+        level_.clear();
+        width_.clear();
+        if (n_ == 0)
+          return;
+
+        width_.push_back((n_ + B - 1) / B);
+        while (width_.back() > 1)
+          width_.push_back((width_.back() + B) / (B + 1));
+        size_type total = 0;
+        for (size_type w : width_) {
+          level_.push_back(total);
+          total += w * B;
+        }
+
+        a_.reserve(total);
+        a_.insert(a_.end(), first, last);
+        a_.resize(width_[0] * B, a_[n_ - 1]);
+
+        // The rank of the greatest element under each node of the level
+        // below the one being built.
+        std::vector<size_type> last_rank(width_[0]);
+        for (size_type j = 0; j != width_[0]; ++j)
+          last_rank[j] = std::min((j + 1) * B, n_) - 1;
+        for (size_type l = 1; l != width_.size(); ++l) {
+          size_type below = width_[l - 1];
+          for (size_type j = 0; j != width_[l]; ++j) {
+            for (size_type t = 0; t != B; ++t) {
+              size_type c = j * (B + 1) + t;
+              a_.push_back(a_[c < below ? last_rank[c] : n_ - 1]);
+            }
+            size_type c = std::min((j + 1) * (B + 1), below) - 1;
+            last_rank[j] = last_rank[c];
+          }
+        }
+      }
+
+  // A search for a key greater than every element would count past the
+  // last child, so the child is clamped to its level, and the result is
+  // replaced by n.
+  template <typename T, typename C, std::size_t B>
+    template <typename R, typename O, typename S>
+      O
+      static_btree<T, C, B>::search_many(const R& keys, O out, S step) const
+      {
+        using std::begin;
+        using std::end;
+        const T* a = a_.data();
+        const T* x[batch_size];
+        size_type k[batch_size];
+        auto first = begin(keys);
+        auto last = end(keys);
+        while (first != last) {
+          size_type g = 0;
+          for (; g != batch_size && first != last; ++g, ++first) {
+            x[g] = std::addressof(*first);
+            k[g] = 0;
+          }
+          if (n_ == 0) {
+            out = std::fill_n(out, g, size_type(0));
+            continue;
+          }
+          for (size_type l = width_.size() - 1; l != 0; --l) {
+            const T* p = a + level_[l];
+            const T* q = a + level_[l - 1];
+            for (size_type j = 0; j != g; ++j) {
+              size_type c = k[j] * (B + 1) + count(p + k[j] * B, *x[j], step);
+              k[j] = std::min(c, width_[l - 1] - 1);
+              __builtin_prefetch(q + k[j] * B);
+            }
+          }
+          for (size_type j = 0; j != g; ++j) {
+            if (step(comp_, a[n_ - 1], *x[j]))
+              *out = n_;
+            else
+              *out = k[j] * B + count(a + k[j] * B, *x[j], step);
+            ++out;
+          }
+        }
+        return out;
+      }
+
+} // namespace origin
+
+#endif
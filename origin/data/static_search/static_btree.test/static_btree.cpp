@@ -0,0 +1,83 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <origin/data/static_search/static_btree.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check every search of a tree of n elements, with runs of equal
+// elements, against those of the sorted vector.
+template <std::size_t B>
+void check_searches(int n)
+{
+  vector<int> v(n);
+  for (int i = 0; i != n; ++i)
+    v[i] = i / 3 * 2;
+  static_btree<int, less<int>, B> a(v.begin(), v.end());
+  assert(a.size() == size_t(n));
+
+  vector<int> keys;
+  for (int x = -1; x <= 2 * (n / 3) + 2; ++x)
+    keys.push_back(x);
+  vector<size_t> lo, hi;
+  a.lower_bound_many(keys, back_inserter(lo));
+  a.upper_bound_many(keys, back_inserter(hi));
+  assert(lo.size() == keys.size() && hi.size() == keys.size());
+  for (size_t i = 0; i != keys.size(); ++i) {
+    int x = keys[i];
+    size_t l = lower_bound(v.begin(), v.end(), x) - v.begin();
+    size_t u = upper_bound(v.begin(), v.end(), x) - v.begin();
+    assert(a.lower_bound(x) == l && lo[i] == l);
+    assert(a.upper_bound(x) == u && hi[i] == u);
+    assert(a.contains(x) == binary_search(v.begin(), v.end(), x));
+  }
+
+  vector<int> w;
+  a.copy(back_inserter(w));
+  assert(w == v);
+  for (int i = 0; i != n; ++i)
+    assert(a[i] == v[i]);
+}
+
+int main()
+{
+  // Small nodes give trees of many levels.
+  for (int n = 0; n != 300; ++n) {
+    check_searches<16>(n);
+    check_searches<3>(n);
+    check_searches<1>(n);
+  }
+  check_searches<16>(4913);
+  check_searches<16>(5000);
+  check_searches<2>(5000);
+
+  // A root over 17 leaves of 16 elements, and one more level above 18.
+  vector<int> v(17 * 16);
+  iota(v.begin(), v.end(), 0);
+  static_btree<int> t(v.begin(), v.end());
+  assert(t.height() == 2);
+  v.push_back(v.size());
+  t.assign(v.begin(), v.end());
+  assert(t.height() == 3 && t.lower_bound(v.back()) == v.size() - 1);
+
+  static_btree<int> e;
+  assert(e.empty() && e.lower_bound(1) == 0 && !e.contains(1));
+
+  // A descending array of strings.
+  static_btree<string, greater<string>> s {"d", "c", "b", "a"};
+  assert(s.lower_bound("c") == 1 && s.upper_bound("c") == 2);
+  assert(s.lower_bound("z") == 0 && s.upper_bound("0") == 4);
+  assert(s.contains("b") && !s.contains("e"));
+}
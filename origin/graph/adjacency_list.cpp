@@ -6,3 +6,23 @@
 // and conditions.
 
 #include "adjacency_list.hpp"
+
+namespace origin
+{
+  // The instantiations declared in adjacency_list.hpp.
+  namespace adjacency_list_impl
+  {
+    template class pool<edge<empty_t, std::size_t>>;
+    template class pool<edge<double, std::size_t>>;
+  } // namespace adjacency_list_impl
+
+  template class
+    adjacency_list_impl::pool<directed_adjacency_list_impl::vertex<empty_t>>;
+  template class
+    adjacency_list_impl::pool<undirected_adjacency_list_impl::vertex<empty_t>>;
+
+  template class directed_adjacency_list<>;
+  template class directed_adjacency_list<empty_t, double>;
+  template class undirected_adjacency_list<>;
+  template class undirected_adjacency_list<empty_t, double>;
+} // namespace origin
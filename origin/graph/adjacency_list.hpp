@@ -9,22 +9,33 @@
 #define ORIGIN_GRAPH_ADJACENCY_LIST_HPP
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 #include <iostream>
+#include <memory>
 #include <queue>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include <origin/type/concepts.hpp>
 #include <origin/type/empty.hpp>
 #include <origin/type/typestr.hpp>
 #include <origin/type/functional.hpp>
+#include <origin/memory/concepts.hpp>
+#include <origin/memory/usage.hpp>
+#include <origin/data/bit_vector/bit_vector.hpp>
+#include <origin/data/heap/d_ary_heap.hpp>
+#include <origin/data/small_vector/small_vector.hpp>
+#include <origin/instrument/instrument.hpp>
 #include <origin/sequence/algorithm.hpp>
 #include <origin/sequence/range.hpp>
 
 #include <origin/graph/handle.hpp>
 #include <origin/graph/graph.hpp>
 #include <origin/graph/io.hpp>
+#include <origin/graph/edge_filter.hpp>
 
 #include <origin/graph/adjacency_list.impl/pool.hpp>
 
@@ -41,31 +52,46 @@ namespace origin
     template<typename C, typename H>
       struct handle_accessor;
 
-    template<typename T, typename H>
-      struct handle_accessor<pool<T>, H>
+    template<typename T, typename F, typename I, typename A, typename H>
+      struct handle_accessor<pool<T, F, I, A>, H>
       {
-        using I = Iterator_of<const pool<T>>;
+        using iterator = Iterator_of<const pool<T, F, I, A>>;
 
-        H get(I i) const { return i.index(); }
+        H get(iterator i) const { return i.index(); }
       };
 
-    template<typename T, typename H>
-      struct handle_accessor<std::vector<T>, H>
+    template<typename T, typename A, typename H>
+      struct handle_accessor<std::vector<T, A>, H>
       {
-        using I = Iterator_of<const std::vector<T>>;
+        using iterator = Iterator_of<const std::vector<T, A>>;
 
-        H get(I i) const { return *i; }
+        H get(iterator i) const { return *i; }
+      };
+
+    template<typename T, std::size_t N, typename A, typename H>
+      struct handle_accessor<small_vector<T, N, A>, H>
+      {
+        using iterator = Iterator_of<const small_vector<T, N, A>>;
+
+        H get(iterator i) const { return *i; }
       };
 
 
     // The handle iterator wraps a constant iterator of the container type C and
-    // returns handles of type H when dereferenced.
+    // returns handles of type H when dereferenced. The iterators of all the
+    // containers are at least bidirectional, and so are handle iterators.
     template<typename C, typename H>
       struct handle_iterator : handle_accessor<C, H>
       {
         using handle_type = H;
         using iterator = Iterator_of<const C>;
 
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = H;
+        using reference         = H;
+        using pointer           = const H*;
+        using difference_type   = std::ptrdiff_t;
+
         handle_iterator(iterator i)
           : iter(i)
         { }
@@ -75,6 +101,9 @@ namespace origin
         handle_iterator& operator++();
         handle_iterator  operator++(int);
 
+        handle_iterator& operator--();
+        handle_iterator  operator--(int);
+
         iterator iter;
       };
 
@@ -96,6 +125,23 @@ namespace origin
         return tmp;
       }
 
+    template<typename C, typename H>
+      inline handle_iterator<C, H>&
+      handle_iterator<C, H>::operator--()
+      {
+        --iter;
+        return *this;
+      }
+
+    template<typename C, typename H>
+      inline handle_iterator<C, H>
+      handle_iterator<C, H>::operator--(int)
+      {
+        handle_iterator tmp = *this;
+        --iter;
+        return tmp;
+      }
+
     // Equality
     template<typename C, typename H>
       inline bool
@@ -111,6 +157,29 @@ namespace origin
         return a.iter != b.iter;
       }
 
+    // Ranges of handles into a pool are split by splitting the underlying
+    // pool range, so the vertex and edge ranges of an adjacency list are
+    // splittable ranges.
+    template<typename T, typename F, typename I, typename A, typename H>
+      inline std::size_t
+      split_size(const bounded_range<handle_iterator<pool<T, F, I, A>, H>>& r)
+      {
+        using B = bounded_range<Iterator_of<const pool<T, F, I, A>>>;
+        return split_size(B(r.begin().iter, r.end().iter));
+      }
+
+    template<typename T, typename F, typename I, typename A, typename H>
+      inline std::pair<bounded_range<handle_iterator<pool<T, F, I, A>, H>>,
+                       bounded_range<handle_iterator<pool<T, F, I, A>, H>>>
+      split(const bounded_range<handle_iterator<pool<T, F, I, A>, H>>& r)
+      {
+        using B = bounded_range<Iterator_of<const pool<T, F, I, A>>>;
+        using R = bounded_range<handle_iterator<pool<T, F, I, A>, H>>;
+        auto halves = split(B(r.begin().iter, r.end().iter));
+        return {R(halves.first.begin(), halves.first.end()),
+                R(halves.second.begin(), halves.second.end())};
+      }
+
 
     // ---------------------------------------------------------------------- //
     //                            Edge Representation
@@ -122,60 +191,293 @@ namespace origin
     // In an undirected adjacency list, the source and target vertices refer to
     // the vertices in the order they were specified on addition. There is no
     // other meaning attributed to them.
-    template<typename E>
+    //
+    // The index type I determines the size of the vertex handles.
+    template<typename E, typename I = std::size_t>
       struct edge
       {
         using value_type = E;
+        using vertex_type = basic_vertex_handle<I>;
 
         edge()
           : data(-1, -1, E{})
         { }
 
-        edge(vertex_handle s, vertex_handle t)
+        edge(vertex_type s, vertex_type t)
           : data(s, t, E{})
         { }
 
         template<typename... Args>
-          edge(vertex_handle s, vertex_handle t, Args&&... args)
+          edge(vertex_type s, vertex_type t, Args&&... args)
             : data(s, t, std::forward<Args>(args)...)
           { }
 
-        std::size_t& source()       { return std::get<0>(data); }
-        std::size_t  source() const { return std::get<0>(data); }
+        vertex_type& source()       { return std::get<0>(data); }
+        vertex_type  source() const { return std::get<0>(data); }
 
-        std::size_t& target()       { return std::get<1>(data); }
-        std::size_t  target() const { return std::get<1>(data); }
+        vertex_type& target()       { return std::get<1>(data); }
+        vertex_type  target() const { return std::get<1>(data); }
 
         E&       value()       { return std::get<2>(data); }
         const E& value() const { return std::get<2>(data); }
 
-        std::tuple<vertex_handle, vertex_handle,  E> data;
+        std::tuple<vertex_type, vertex_type,  E> data;
       };
 
-    // An (incident) edge list is a vector of indexes.
-    using edge_list = std::vector<edge_handle>;
-  
+    // The number of incident edges stored inside each edge list.
+    constexpr std::size_t edge_buffer = 4;
+
+    // An (incident) edge list is a small vector of indexes, so that the
+    // edges of a vertex with at most edge_buffer incident edges are stored
+    // in the vertex, and only larger lists are allocated, by the allocator
+    // A of the graph rebound to the handle type.
+    template<typename I = std::size_t, typename A = std::allocator<char>>
+      using edge_list =
+        small_vector<basic_edge_handle<I>, edge_buffer,
+                     Rebind_allocator<A, basic_edge_handle<I>>>;
+
     // An alias for the edge pool.
-    template<typename E>
-      using edge_pool = pool<edge<E>>;
+    template<typename E, typename I, typename A = std::allocator<char>>
+      using edge_pool =
+        pool<edge<E, I>, bitmap_free_list, I, Rebind_allocator<A, edge<E, I>>>;
 
     // An alias for the vertex iterator.
-    template<typename E>
-      using edge_iterator = handle_iterator<edge_pool<E>, edge_handle>;
+    template<typename E, typename I, typename A = std::allocator<char>>
+      using edge_iterator =
+        handle_iterator<edge_pool<E, I, A>, basic_edge_handle<I>>;
 
     // An alias for the edge range.
-    template<typename E>
-      using edge_range = bounded_range<edge_iterator<E>>;
+    template<typename E, typename I, typename A = std::allocator<char>>
+      using edge_range = bounded_range<edge_iterator<E, I, A>>;
 
     // An alias for the incident edge iterator.
-    using incidence_iterator = handle_iterator<edge_list, edge_handle>;
+    template<typename I, typename A = std::allocator<char>>
+      using incidence_iterator =
+        handle_iterator<edge_list<I, A>, basic_edge_handle<I>>;
 
     // An alias for the icident edge range.
-    using incidence_range = bounded_range<incidence_iterator>;
+    template<typename I, typename A = std::allocator<char>>
+      using incidence_range = bounded_range<incidence_iterator<I, A>>;
+
+    // Returns the handle h renamed by the compaction map m.
+    template<typename H>
+      inline H
+      remap(const std::vector<std::size_t>& m, H h) { return H(m[h]); }
+
+    // Rename each handle in the edge list l by the compaction map m, and
+    // release its unused capacity.
+    template<typename L>
+      inline void
+      remap_list(const std::vector<std::size_t>& m, L& l)
+      {
+        for (auto& e : l)
+          e = remap(m, e);
+        l.shrink_to_fit();
+      }
+
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Edge Index
+    //
+    // An edge index maps pairs of vertices to the edges connecting them, so
+    // that the edges (u, v) can be found in constant expected time rather
+    // than by searching the incident edges of u or v. In an undirected
+    // index, the pairs (u, v) and (v, u) are the same.
+    //
+    // The index is disabled by default, in which case its operations do
+    // nothing; it costs nothing but its (empty) hash table.
+    template<typename I, bool Directed>
+      class edge_index
+      {
+        using edge_type = basic_edge_handle<I>;
+        using key_type = std::pair<std::size_t, std::size_t>;
+
+        struct key_hash
+        {
+          std::size_t operator()(const key_type& k) const
+          {
+            std::uint64_t x = k.first * 0x9e3779b97f4a7c15ull + k.second;
+            return std::hash<std::uint64_t>{}(x ^ (x >> 29));
+          }
+        };
+
+        using map_type = std::unordered_multimap<key_type, edge_type, key_hash>;
+      public:
+        edge_index()
+          : enabled_(false)
+        { }
+
+        bool enabled() const { return enabled_; }
+
+        // Enable the index, indexing each edge in g.
+        template<typename G>
+          void enable(const G& g);
+
+        // Disable the index, releasing its memory.
+        void disable();
+
+        // Remove all edges from the index.
+        void clear() { map_.clear(); }
+
+        // Returns the footprint of the hash table. The size of its nodes is
+        // estimated as an entry and a link, and that of its buckets as a
+        // link.
+        memory_footprint memory_usage() const
+        {
+          std::size_t node = sizeof(typename map_type::value_type);
+          std::size_t link = sizeof(void*);
+          return {map_.size() * node,
+                  map_.size() * (node + link) + map_.bucket_count() * link};
+        }
+
+        // Release the buckets not needed by the entries of the index.
+        void shrink_to_fit() { map_.rehash(0); }
+
+        void insert(std::size_t u, std::size_t v, edge_type e);
+        void erase(std::size_t u, std::size_t v, edge_type e);
+
+        // Returns the least edge connecting u and v, or an invalid handle if
+        // there is no such edge.
+        edge_type find(std::size_t u, std::size_t v) const;
+
+        // Returns all edges connecting u and v.
+        std::vector<edge_type> find_all(std::size_t u, std::size_t v) const;
+
+      private:
+        static key_type key(std::size_t u, std::size_t v);
+
+      private:
+        map_type map_;
+        bool     enabled_;
+      };
+
+    template<typename I, bool Directed>
+      inline auto
+      edge_index<I, Directed>::key(std::size_t u, std::size_t v) -> key_type
+      {
+        if (!Directed && v < u)
+          std::swap(u, v);
+        return {u, v};
+      }
+
+    template<typename I, bool Directed>
+      template<typename G>
+        void
+        edge_index<I, Directed>::enable(const G& g)
+        {
+          map_.clear();
+          map_.reserve(g.size());
+          enabled_ = true;
+          for (edge_type e : g.edges())
+            insert(g.source(e), g.target(e), e);
+        }
+
+    template<typename I, bool Directed>
+      inline void
+      edge_index<I, Directed>::disable()
+      {
+        map_type().swap(map_);
+        enabled_ = false;
+      }
+
+    template<typename I, bool Directed>
+      inline void
+      edge_index<I, Directed>::insert(std::size_t u, std::size_t v, edge_type e)
+      {
+        if (enabled_)
+          map_.emplace(key(u, v), e);
+      }
+
+    template<typename I, bool Directed>
+      inline void
+      edge_index<I, Directed>::erase(std::size_t u, std::size_t v, edge_type e)
+      {
+        if (!enabled_)
+          return;
+        auto r = map_.equal_range(key(u, v));
+        for (auto i = r.first; i != r.second; ++i)
+          if (i->second == e) {
+            map_.erase(i);
+            return;
+          }
+      }
+
+    template<typename I, bool Directed>
+      inline auto
+      edge_index<I, Directed>::find(std::size_t u, std::size_t v) const
+        -> edge_type
+      {
+        assert(enabled_);
+        edge_type e;
+        auto r = map_.equal_range(key(u, v));
+        for (auto i = r.first; i != r.second; ++i)
+          if (!e || i->second < e)
+            e = i->second;
+        return e;
+      }
+
+    template<typename I, bool Directed>
+      auto
+      edge_index<I, Directed>::find_all(std::size_t u, std::size_t v) const
+        -> std::vector<edge_type>
+      {
+        assert(enabled_);
+        std::vector<edge_type> es;
+        auto r = map_.equal_range(key(u, v));
+        for (auto i = r.first; i != r.second; ++i)
+          es.push_back(i->second);
+        return es;
+      }
 
   } // namespace adjacency_list_impl
 
 
+  // An edge is relocated by memcpy when the edge pool grows if its value is
+  // trivially relocatable (see type.relocatable).
+  template<typename E, typename I>
+    struct is_trivially_relocatable<adjacency_list_impl::edge<E, I>>
+      : is_trivially_relocatable<E>
+    { };
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                    [graph.adj_list.compact]
+  //                              Compaction
+  //
+  // Removing vertices and edges from an adjacency list leaves holes in its
+  // vertex and edge pools, which are only filled by later insertions. After
+  // many removals, the remaining vertices and edges are spread thinly across
+  // memory, and traversals follow the links between live nodes across the
+  // holes.
+  //
+  // The compact() operation of an adjacency list moves its vertices and edges
+  // to the front of their pools, preserving their order, releases unused
+  // capacity, and returns a compaction map describing how handles were
+  // renamed. All vertex and edge handles (and ranges) into the graph are
+  // invalidated by compaction; they can be renamed using the map.
+  struct compaction_map
+  {
+    // Returns the new handles of the vertex v and the edge e.
+    template<typename T>
+      basic_vertex_handle<T> vertex(basic_vertex_handle<T> v) const
+      {
+        return vertices[v];
+      }
+
+    template<typename T>
+      basic_edge_handle<T> edge(basic_edge_handle<T> e) const
+      {
+        return edges[e];
+      }
+
+    // The new index of each old vertex and edge, or size_t(-1) for the
+    // indexes of removed vertices and edges.
+    std::vector<std::size_t> vertices;
+    std::vector<std::size_t> edges;
+  };
+
+
 
   // ------------------------------------------------------------------------ //
   //                                                        [graph.adj_list.dir]
@@ -189,6 +491,7 @@ namespace origin
   {
     // Imports
     using adjacency_list_impl::pool;
+    using adjacency_list_impl::bitmap_free_list;
     using adjacency_list_impl::handle_iterator;
     using adjacency_list_impl::edge_list;
 
@@ -201,29 +504,44 @@ namespace origin
     // separate edge container.
     //
     // Note that the class will compress the value type if it is empty.
-    template<typename V>
+    //
+    // The edge lists are allocated by the allocator A of the graph.
+    template<typename V,
+             typename I = std::size_t,
+             typename A = std::allocator<char>>
       struct vertex
       {
         using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
+        using edge_type = basic_edge_handle<I>;
+        using list_type = edge_list<I, A>;
+        using list_allocator = typename list_type::allocator_type;
+        using iterator = typename list_type::iterator;
+        using const_iterator = typename list_type::const_iterator;
     
         vertex()
           : data()
         { }
 
+        // Construct a vertex whose edge lists are allocated by a, forwarding
+        // args to the constructor of the user-supplied data object.
+        vertex(std::allocator_arg_t, const A& a)
+          : data(std::allocator_arg, list_allocator(a))
+        { }
+
         template<typename... Args>
-          vertex(Args&&... args) 
-            : data(edge_list{}, edge_list{}, std::forward<Args>(args)...)
+          vertex(std::allocator_arg_t, const A& a, Args&&... args)
+            : data(list_type(list_allocator(a)),
+                   list_type(list_allocator(a)),
+                   std::forward<Args>(args)...)
           { }
 
         // Returns the out ege list
-        edge_list&       out()       { return std::get<0>(data); }
-        const edge_list& out() const { return std::get<0>(data); }
+        list_type&       out()       { return std::get<0>(data); }
+        const list_type& out() const { return std::get<0>(data); }
         
         // Returns the in edge list
-        edge_list&       in()       { return std::get<1>(data); }
-        const edge_list& in() const { return std::get<1>(data); }
+        list_type&       in()       { return std::get<1>(data); }
+        const list_type& in() const { return std::get<1>(data); }
 
         // Returns the user-supplied data object.
         V&       value()       { return std::get<2>(data); }
@@ -232,8 +550,8 @@ namespace origin
         // Out edges
         std::size_t out_degree() const { return out().size(); }
 
-        void insert_out(edge_handle e) { insert_edge(out(), e); }
-        void erase_out(edge_handle e)  { erase_edge(out(), e); }
+        void insert_out(edge_type e) { insert_edge(out(), e); }
+        void erase_out(edge_type e)  { erase_edge(out(), e); }
 
         iterator begin_out() { return out().begin(); }
         iterator end_out()   { return out().end(); }
@@ -243,8 +561,8 @@ namespace origin
         // In edges
         std::size_t in_degree() const { return in().size(); }
         
-        void insert_in(edge_handle e) { insert_edge(in(), e); }
-        void erase_in(edge_handle e)  { erase_edge(in(), e); }
+        void insert_in(edge_type e) { insert_edge(in(), e); }
+        void erase_in(edge_type e)  { erase_edge(in(), e); }
 
         iterator begin_in() { return in().begin(); }
         iterator end_in()   { return in().end(); }
@@ -252,23 +570,23 @@ namespace origin
         const_iterator end_in() const   { return in().end(); }
 
         // Helper functions
-        void insert_edge(edge_list& l, edge_handle e);
-        void erase_edge(edge_list& l, edge_handle e);
+        void insert_edge(list_type& l, edge_type e);
+        void erase_edge(list_type& l, edge_type e);
 
       public:
-        std::tuple<edge_list, edge_list, V> data;
+        std::tuple<list_type, list_type, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename I, typename A>
       inline void
-      vertex<V>::insert_edge(edge_list& l, edge_handle e)
+      vertex<V, I, A>::insert_edge(list_type& l, edge_type e)
       {
         l.push_back(e);
       }
 
-    template<typename V>
+    template<typename V, typename I, typename A>
       inline void
-      vertex<V>::erase_edge(edge_list& l, edge_handle e)
+      vertex<V, I, A>::erase_edge(list_type& l, edge_type e)
       {
         auto i = std::find(l.begin(), l.end(), e);
         if (i != l.end())
@@ -276,43 +594,253 @@ namespace origin
       }
 
     // A vertex set is a pool of vertices.
-    template<typename V>
-      using vertex_pool = pool<vertex<V>>;
+    template<typename V, typename I, typename A = std::allocator<char>>
+      using vertex_pool =
+        pool<vertex<V, I, A>, bitmap_free_list, I,
+             Rebind_allocator<A, vertex<V, I, A>>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_iterator<vertex_pool<V>, vertex_handle>;
+    template<typename V, typename I, typename A = std::allocator<char>>
+      using vertex_iterator =
+        handle_iterator<vertex_pool<V, I, A>, basic_vertex_handle<I>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename I, typename A = std::allocator<char>>
+      using vertex_range = bounded_range<vertex_iterator<V, I, A>>;
+
+    // ---------------------------------------------------------------------- //
+    //                        Incidence Policies
+    //
+    // An incidence policy determines how edges are inserted into and erased
+    // from the out and in edge lists of the vertices in a directed adjacency
+    // list.
+    //
+    //    - indexed_incidence records the position of each edge in the out
+    //      list of its source and in the in list of its target. An edge is
+    //      erased by moving the last edge of each list into its position, so
+    //      erasure takes O(1) time, but the order of the lists changes.
+    //    - stable_incidence preserves the order in which edges were added to
+    //      each list. Erasing an edge requires a linear search of both lists.
+    //
+    // After a list is changed in place, such as by applying a batch (see
+    // [graph.batch]), the policy is told the new order of its edges by
+    // reindex_out or reindex_in.
+    //
+    // The indexed policy is the default.
+    //
+    // The policies operate on edge lists of any type L, holding handles of
+    // type H.
+    class indexed_incidence
+    {
+      using position_list = std::vector<std::size_t>;
+    public:
+      template<typename L, typename H>
+        void insert_out(L& l, H e) { insert(out_, l, e); }
+      template<typename L, typename H>
+        void insert_in(L& l, H e)  { insert(in_, l, e); }
+
+      template<typename L, typename H>
+        void erase_out(L& l, H e) { erase(out_, l, e); }
+      template<typename L, typename H>
+        void erase_in(L& l, H e)  { erase(in_, l, e); }
+
+      template<typename L>
+        void reindex_out(const L& l) { reindex(out_, l); }
+      template<typename L>
+        void reindex_in(const L& l)  { reindex(in_, l); }
+
+      void clear();
+      void compact(const std::vector<std::size_t>& m);
+
+      memory_footprint memory_usage() const;
+      void shrink_to_fit();
+
+    private:
+      template<typename L, typename H>
+        static void insert(position_list& p, L& l, H e);
+      template<typename L, typename H>
+        static void erase(position_list& p, L& l, H e);
+      template<typename L>
+        static void reindex(position_list& p, const L& l);
+
+    private:
+      position_list out_; // The position of each edge in its source's list
+      position_list in_;  // The position of each edge in its target's list
+    };
+
+    inline void
+    indexed_incidence::clear()
+    {
+      out_.clear();
+      in_.clear();
+    }
+
+    // Rename the edges whose positions are recorded by the compaction map m.
+    // Compaction does not move edges within their lists.
+    inline void
+    indexed_incidence::compact(const std::vector<std::size_t>& m)
+    {
+      auto move = [&m](position_list& p) {
+        position_list q;
+        for (std::size_t e = 0; e != p.size() && e != m.size(); ++e)
+          if (m[e] != std::size_t(-1)) {
+            if (q.size() <= m[e])
+              q.resize(m[e] + 1);
+            q[m[e]] = p[e];
+          }
+        p.swap(q);
+      };
+      move(out_);
+      move(in_);
+    }
+
+    // Returns the footprint of the position lists.
+    inline memory_footprint
+    indexed_incidence::memory_usage() const
+    {
+      return contiguous_footprint(out_) + contiguous_footprint(in_);
+    }
+
+    inline void
+    indexed_incidence::shrink_to_fit()
+    {
+      out_.shrink_to_fit();
+      in_.shrink_to_fit();
+    }
+
+    template<typename L, typename H>
+      inline void
+      indexed_incidence::insert(position_list& p, L& l, H e)
+      {
+        std::size_t n = e;
+        if (p.size() <= n)
+          p.resize(n + 1);
+        p[n] = l.size();
+        l.push_back(e);
+      }
+
+    template<typename L, typename H>
+      inline void
+      indexed_incidence::erase(position_list& p, L& l, H e)
+      {
+        std::size_t i = p[e];
+        assert(l[i] == e);
+        H last = l.back();
+        l[i] = last;
+        p[last] = i;
+        l.pop_back();
+      }
+
+    // Record the position of each edge in the list l.
+    template<typename L>
+      inline void
+      indexed_incidence::reindex(position_list& p, const L& l)
+      {
+        for (std::size_t i = 0; i != l.size(); ++i)
+          p[l[i]] = i;
+      }
+
+
+    struct stable_incidence
+    {
+      template<typename L, typename H>
+        void insert_out(L& l, H e) { l.push_back(e); }
+      template<typename L, typename H>
+        void insert_in(L& l, H e)  { l.push_back(e); }
+
+      template<typename L, typename H>
+        void erase_out(L& l, H e) { erase(l, e); }
+      template<typename L, typename H>
+        void erase_in(L& l, H e)  { erase(l, e); }
+
+      template<typename L>
+        void reindex_out(const L&) { }
+      template<typename L>
+        void reindex_in(const L&)  { }
+
+      void clear() { }
+      void compact(const std::vector<std::size_t>&) { }
+
+      memory_footprint memory_usage() const { return {}; }
+      void shrink_to_fit() { }
+
+      template<typename L, typename H>
+        static void erase(L& l, H e);
+    };
+
+    template<typename L, typename H>
+      inline void
+      stable_incidence::erase(L& l, H e)
+      {
+        auto i = std::find(l.begin(), l.end(), e);
+        if (i != l.end())
+          l.erase(i);
+      }
 
   } // namespace directed_adjacency_list_impl
 
 
+  // Incidence policies
+  using directed_adjacency_list_impl::indexed_incidence;
+  using directed_adjacency_list_impl::stable_incidence;
+
+
   // Implementation of a diretected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  //
+  // The incidence policy L determines the order of the out and in edges of
+  // each vertex (see [Incidence Policies] above).
+  //
+  // The index type I determines the size of vertex and edge handles and of
+  // the links in the vertex and edge pools (see [graph.handle]). A graph
+  // with fewer than 2^32 - 1 vertices and edges can be indexed by
+  // std::uint32_t.
+  //
+  // The allocator A allocates the vertex and edge pools and the edge lists
+  // of each vertex; it is rebound for each of them, so its value type does
+  // not matter. The incidence policy and the edge index allocate from the
+  // global heap.
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename L = indexed_incidence,
+           typename I = std::size_t,
+           typename A = std::allocator<char>>
     class directed_adjacency_list
     {
-      using this_type = directed_adjacency_list<V, E>;
+      static_assert(Allocator<A>(), "");
+
+      using this_type = directed_adjacency_list<V, E, L, I, A>;
 
-      using vertex_node = directed_adjacency_list_impl::vertex<V>;
-      using vertex_set = directed_adjacency_list_impl::vertex_pool<V>;
-      using vertex_iter = directed_adjacency_list_impl::vertex_iterator<V>;
+      using vertex_node = directed_adjacency_list_impl::vertex<V, I, A>;
+      using vertex_set = directed_adjacency_list_impl::vertex_pool<V, I, A>;
+      using vertex_iter =
+        directed_adjacency_list_impl::vertex_iterator<V, I, A>;
 
-      using edge_node = adjacency_list_impl::edge<E>;
-      using edge_set = adjacency_list_impl::edge_pool<E>;
-      using edge_iter = adjacency_list_impl::edge_iterator<E>;
+      using edge_node = adjacency_list_impl::edge<E, I>;
+      using edge_set = adjacency_list_impl::edge_pool<E, I, A>;
+      using edge_iter = adjacency_list_impl::edge_iterator<E, I, A>;
 
-      using incidence_iter = adjacency_list_impl::incidence_iterator;
+      using incidence_iter = adjacency_list_impl::incidence_iterator<I, A>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = directed_adjacency_list_impl::vertex_range<V>;
+      using allocator_type = A;
+
+      using vertex = basic_vertex_handle<I>;
+      using vertex_range = directed_adjacency_list_impl::vertex_range<V, I, A>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_list_impl::edge_range<E>;
+      using edge = basic_edge_handle<I>;
+      using edge_range = adjacency_list_impl::edge_range<E, I, A>;
 
-      using incidence_range = adjacency_list_impl::incidence_range;
+      using incidence_range = adjacency_list_impl::incidence_range<I, A>;
+
+
+      directed_adjacency_list() = default;
+
+      // Construct an empty graph whose storage is allocated by a.
+      explicit directed_adjacency_list(const A& a)
+        : verts_(a), edges_(a)
+      { }
+
+      // Returns the allocator of the graph.
+      A get_allocator() const { return A(verts_.get_allocator()); }
 
 
       // Observers
@@ -331,6 +859,9 @@ namespace origin
       vertex source(edge e) const { return get_edge(e).source(); }
       vertex target(edge e) const { return get_edge(e).target(); }
 
+      // Prefetch the record of e (see [graph.prefetch]).
+      void prefetch_edge(edge e) const { __builtin_prefetch(&get_edge(e)); }
+
       // Data access
       V&       operator()(vertex v)       { return node(v).value(); }
       const V& operator()(vertex v) const { return node(v).value(); }
@@ -341,6 +872,9 @@ namespace origin
       // Edge relation
       edge operator()(vertex u, vertex v) const;
 
+      // Capacity
+      void reserve(std::size_t n, std::size_t m);
+
       // Vertex set
       vertex add_vertex();
       vertex add_vertex(V&& x);
@@ -352,6 +886,9 @@ namespace origin
       void remove_vertex(vertex v);
       void remove_vertices();
 
+      template<typename P>
+        void remove_vertices_if(P pred);
+
       // Edge set
       edge add_edge(vertex u, vertex v);
       edge add_edge(vertex u, vertex v, E&& x);
@@ -360,12 +897,47 @@ namespace origin
       template<typename... Args>
         edge emplace_edge(vertex u, vertex v, Args&&... args);
 
+      template<typename R>
+        void add_edges(R&& r);
+
+      edge add_unique_edge(vertex u, vertex v);
+
       void remove_edge(edge e);
       void remove_edge(vertex u, vertex v);
       void remove_edges(vertex u, vertex v);
       void remove_edges(vertex v);
       void remove_edges();
 
+      template<typename P>
+        void remove_edges_if(P pred);
+
+      // Batched updates
+      void apply(const edge_batch<this_type>& b);
+
+      // Compaction
+      compaction_map compact();
+
+      // Memory usage
+      memory_footprint memory_usage() const;
+      void shrink_to_fit();
+
+      // Handle capacity
+      //
+      // Every vertex and edge handle is less than these until the capacity
+      // of the pools grows. See [graph.property].
+      std::size_t vertex_capacity() const { return verts_.capacity(); }
+      std::size_t edge_capacity() const   { return edges_.capacity(); }
+
+      // Edge index
+      void enable_edge_index()        { index_.enable(*this); }
+      void disable_edge_index()       { index_.disable(); }
+      bool edge_index_enabled() const { return index_.enabled(); }
+
+      // Edge filter
+      void enable_edge_filter()        { filter_.enable(*this); }
+      void disable_edge_filter()       { filter_.disable(); }
+      bool edge_filter_enabled() const { return filter_.enabled(); }
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -394,51 +966,65 @@ namespace origin
       void unlink_in_edges(vertex u, vertex v);
       void unlink_target(edge e);
       void unlink_source(edge e);
+      void erase_edge(edge e);
+      void erase_marked_edges(const std::vector<char>& dead,
+                              const std::vector<char>& gone);
 
       template<typename S, typename P>
         void unlink_first_edge(S& seq, P pred);
 
-      template<typename S1, typename S2, typename P>
-        void unlink_multi_edge(S1& seq1, S2& seq2, P pred);
+      template<typename S, typename P>
+        void unlink_multi_edge(const S& seq, P pred);
 
     private:
       vertex_set verts_;
       edge_set   edges_;
+      L          incidence_;
+      adjacency_list_impl::edge_index<I, true> index_;
+      graph_impl::list_edge_filter<true> filter_;
     };
 
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::operator()(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, L, I, A>::
+      operator()(vertex u, vertex v) const -> edge
     {
+      if (!filter_.may_contain(u, v))
+        return edge();
+      if (index_.enabled())
+        return index_.find(u, v);
       if (out_degree(u) <= in_degree(v))
         return find_out_edge(u, v);
       else
         return find_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::find_out_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, L, I, A>::
+      find_out_edge(vertex u, vertex v) const -> edge
     {
       using P = has_target<this_type>;
       const vertex_node& n = node(u);
       return find_edge(n.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::find_in_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, L, I, A>::
+      find_in_edge(vertex u, vertex v) const -> edge
     {
       using P = has_source<this_type>;
       const vertex_node& n = node(v);
       return find_edge(n.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     template<typename S, typename P>
       inline auto
-      directed_adjacency_list<V, E>::find_edge(const S& seq, P pred) const -> edge
+      directed_adjacency_list<V, E, L, I, A>::
+        find_edge(const S& seq, P pred) const -> edge
       {
         auto i = find_if(seq, pred);
         return i == seq.end() ? edge() : *i;
@@ -446,79 +1032,86 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex() -> vertex
+    directed_adjacency_list<V, E, L, I, A>::add_vertex() -> vertex
     {
-      return verts_.emplace();
+      return verts_.emplace(std::allocator_arg, get_allocator());
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex(V&& x) -> vertex
+    directed_adjacency_list<V, E, L, I, A>::add_vertex(V&& x) -> vertex
     {
-      return verts_.emplace(std::move(x));
+      return verts_.emplace(std::allocator_arg, get_allocator(), std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex(const V& x) -> vertex
+    directed_adjacency_list<V, E, L, I, A>::add_vertex(const V& x) -> vertex
     {
-      return verts_.emplace(x);
+      return verts_.emplace(std::allocator_arg, get_allocator(), x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     template<typename... Args>
       inline auto
-      directed_adjacency_list<V, E>::emplace_vertex(Args&&... args) -> vertex
+      directed_adjacency_list<V, E, L, I, A>::
+        emplace_vertex(Args&&... args) -> vertex
       {
-        return verts_.emplace(std::forward<Args>(args)...);
+        return verts_.emplace(std::allocator_arg, get_allocator(),
+                              std::forward<Args>(args)...);
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_vertex(vertex v)
+    directed_adjacency_list<V, E, L, I, A>::remove_vertex(vertex v)
     {
       remove_edges(v);
       verts_.erase(v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_vertices()
+    directed_adjacency_list<V, E, L, I, A>::remove_vertices()
     {
       edges_.clear();
       verts_.clear();
+      incidence_.clear();
+      index_.clear();
+      filter_.clear();
     }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v) -> edge
+    directed_adjacency_list<V, E, L, I, A>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    directed_adjacency_list<V, E, L, I, A>::
+      add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    directed_adjacency_list<V, E, L, I, A>::
+      add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     template<typename... Args>
       inline auto
-      directed_adjacency_list<V, E>::
+      directed_adjacency_list<V, E, L, I, A>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.emplace(u, v, std::forward<Args>(args)...);
@@ -526,138 +1119,191 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::link_edge(vertex u, vertex v, edge e)
+    directed_adjacency_list<V, E, L, I, A>::
+      link_edge(vertex u, vertex v, edge e)
     {
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      un.insert_out(e);
-      vn.insert_in(e);
+      ORIGIN_COUNT("graph.edge.link");
+      incidence_.insert_out(node(u).out(), e);
+      incidence_.insert_in(node(v).in(), e);
+      index_.insert(u, v, e);
+      filter_.insert(u, v);
+      if (filter_.stale())
+        filter_.enable(*this);
+    }
+
+  // Reserve capacity for n vertices and m edges, so that adding them does
+  // not grow the vertex and edge pools.
+  template<typename V, typename E, typename L, typename I, typename A>
+    void
+    directed_adjacency_list<V, E, L, I, A>::reserve(std::size_t n,
+                                                    std::size_t m)
+    {
+      verts_.reserve(n);
+      edges_.reserve(m);
+    }
+
+  // Add each edge described by the range r to the graph (see [graph.bulk]).
+  // The out and in edge lists of each vertex are grown at most once.
+  template<typename V, typename E, typename L, typename I, typename A>
+    template<typename R>
+      void
+      directed_adjacency_list<V, E, L, I, A>::add_edges(R&& r)
+      {
+        std::vector<std::size_t> outs;
+        std::vector<std::size_t> ins;
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          graph_impl::count_incident(outs, std::get<0>(x));
+          graph_impl::count_incident(ins, std::get<1>(x));
+          ++m;
+        }
+
+        edges_.reserve(size() + m);
+        for (std::size_t v = 0; v != outs.size(); ++v)
+          if (outs[v])
+            node(v).out().reserve(out_degree(v) + outs[v]);
+        for (std::size_t v = 0; v != ins.size(); ++v)
+          if (ins[v])
+            node(v).in().reserve(in_degree(v) + ins[v]);
+
+        for (auto&& x : r)
+          graph_impl::add_described_edge(
+            *this, graph_impl::forward_element<R>(x));
+      }
+
+  // Returns the first edge connecting u to v, adding one if there is none.
+  // With an edge filter, most new edges are added without a search (see
+  // [graph.filter]).
+  template<typename V, typename E, typename L, typename I, typename A>
+    inline auto
+    directed_adjacency_list<V, E, L, I, A>::
+      add_unique_edge(vertex u, vertex v) -> edge
+    {
+      if (edge e = (*this)(u, v))
+        return e;
+      return add_edge(u, v);
     }
 
   // Remove the specified edge from the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_edge(edge e)
+    directed_adjacency_list<V, E, L, I, A>::remove_edge(edge e)
     {
       unlink_edge(source(e), target(e), e);
     }
 
   // Unlink the given edge from the source and target vertices, and erase
   // it from the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_edge(vertex u, vertex v, edge e)
+    directed_adjacency_list<V, E, L, I, A>::
+      unlink_edge(vertex u, vertex v, edge e)
     {
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      un.erase_out(e);
-      vn.erase_in(e);
-      edges_.erase(e);
+      incidence_.erase_out(node(u).out(), e);
+      incidence_.erase_in(node(v).in(), e);
+      erase_edge(e);
     }
 
 
   // Remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, L, I, A>::remove_edge(vertex u, vertex v)
     {
-      if (out_degree(u) <= in_degree(v))
+      if (!filter_.may_contain(u, v))
+        return;
+      if (index_.enabled()) {
+        if (edge e = index_.find(u, v))
+          remove_edge(e);
+      } else if (out_degree(u) <= in_degree(v))
         unlink_out_edge(u, v);
       else
         unlink_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_out_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, L, I, A>::unlink_out_edge(vertex u, vertex v)
     {
       using P = has_target<this_type>;
       vertex_node& un = node(u);
       unlink_first_edge(un.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_in_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, L, I, A>::unlink_in_edge(vertex u, vertex v)
     {
       using P = has_source<this_type>;
       vertex_node& vn = node(v);
       unlink_first_edge(vn.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     template<typename S, typename P>
       inline void
-      directed_adjacency_list<V, E>::unlink_first_edge(S& seq, P pred)
+      directed_adjacency_list<V, E, L, I, A>::unlink_first_edge(S& seq, P pred)
       {
         auto i = find_if(seq, pred);
-        if (i != seq.end());
+        if (i != seq.end())
           remove_edge(*i);
       }
 
   // Remove all edges connecting u to v. 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, L, I, A>::remove_edges(vertex u, vertex v)
     {
-      if (out_degree(u) <= in_degree(v))
+      if (!filter_.may_contain(u, v))
+        return;
+      if (index_.enabled()) {
+        for (edge e : index_.find_all(u, v))
+          remove_edge(e);
+      } else if (out_degree(u) <= in_degree(v))
         unlink_out_edges(u, v);
       else
         unlink_in_edges(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_out_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, L, I, A>::unlink_out_edges(vertex u, vertex v)
     {
       using P = has_target<this_type>;
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      unlink_multi_edge(un.out(), vn.in(), P(*this, v));
+      unlink_multi_edge(node(u).out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_in_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, L, I, A>::unlink_in_edges(vertex u, vertex v)
     {
       using P = has_source<this_type>;
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      unlink_multi_edge(vn.in(), un.out(), P(*this, u));
+      unlink_multi_edge(node(v).in(), P(*this, u));
     }
 
-  // Remove all edges from seq1 that are connected to seq2. 
-  template<typename V, typename E>
-    template<typename S1, typename S2, typename P>
+  // Remove all edges in seq that satisfy pred. The edges are collected
+  // before any are removed since removal may reorder seq.
+  template<typename V, typename E, typename L, typename I, typename A>
+    template<typename S, typename P>
       inline void
-      directed_adjacency_list<V, E>::unlink_multi_edge(S1& seq1, S2& seq2, P pred)
+      directed_adjacency_list<V, E, L, I, A>::
+        unlink_multi_edge(const S& seq, P pred)
       {
-        // Partition the 1st sequence by the given predicate into "save" and
-        // "erase" components. 
-        //
-        // NOTE: We may want this to be a stable partition... not sure. It
-        // seems like the saved edges are not reordered by the partitioning.
-        auto i = partition(seq1, negate(pred));
-        for (auto j = i; j != seq1.end(); ++j) {
-          // Remove those edges from the in 2nd sequence.
-          auto k = remove(seq2, *j);
-          seq2.erase(k, seq2.end());
-
-          // Erase the edge from the graph's edge set.
-          edges_.erase(*j);
-        }
-
-        // Finally, erase those edges from the first sequence.
-        seq1.erase(i, seq1.end());
+        std::vector<edge> es;
+        for (edge e : seq)
+          if (pred(e))
+            es.push_back(e);
+        for (edge e : es)
+          remove_edge(e);
       }
 
 
   // Remove all edges incident to the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_edges(vertex v)
+    directed_adjacency_list<V, E, L, I, A>::remove_edges(vertex v)
     {
       vertex_node& vn = node(v);
       
@@ -672,70 +1318,238 @@ namespace origin
       vn.in().clear();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_target(edge e)
+    directed_adjacency_list<V, E, L, I, A>::unlink_target(edge e)
     {
-      vertex_node& t = node(target(e));
-      auto i = find(t.in(), e);
-      t.in().erase(i);
-      edges_.erase(e);
+      incidence_.erase_in(node(target(e)).in(), e);
+      erase_edge(e);
     }
 
-  // Note that loops will not result in the double erasure of an edge. The
-  // edge is initially erased in unlink_source, and the erase operation
-  // here will have no effect.
-  template<typename V, typename E>
+  // Note that loops will not result in the double erasure of an edge. A loop
+  // is removed from the in edges of its vertex by unlink_target, before the
+  // in edges are visited.
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::unlink_source(edge e)
+    directed_adjacency_list<V, E, L, I, A>::unlink_source(edge e)
     {
-      vertex_node& t = node(source(e));
-      auto i = find(t.out(), e);
-      t.out().erase(i);
+      incidence_.erase_out(node(source(e)).out(), e);
+      erase_edge(e);
+    }
+
+  // Erase the edge e from the edge set, the edge index and the edge filter.
+  template<typename V, typename E, typename L, typename I, typename A>
+    inline void
+    directed_adjacency_list<V, E, L, I, A>::erase_edge(edge e)
+    {
+      ORIGIN_COUNT("graph.edge.unlink");
+      index_.erase(source(e), target(e), e);
+      filter_.erase(source(e), target(e));
       edges_.erase(e);
     }
 
 
+  // Apply the removals and then the insertions of the batch b (see
+  // [graph.batch]). The out list of each source and the in list of each
+  // target of a removed edge are filtered once.
+  template<typename V, typename E, typename L, typename I, typename A>
+    void
+    directed_adjacency_list<V, E, L, I, A>::
+      apply(const edge_batch<this_type>& b)
+    {
+      using graph_impl::distinct;
+      using graph_impl::erase_batch;
+      std::vector<edge> dead = graph_impl::batch_removals(*this, b);
+      if (!dead.empty()) {
+        std::vector<vertex> sources;
+        std::vector<vertex> targets;
+        for (edge e : dead) {
+          sources.push_back(source(e));
+          targets.push_back(target(e));
+        }
+        for (vertex u : distinct(std::move(sources)))
+          if (erase_batch(node(u).out(), dead))
+            incidence_.reindex_out(node(u).out());
+        for (vertex v : distinct(std::move(targets)))
+          if (erase_batch(node(v).in(), dead))
+            incidence_.reindex_in(node(v).in());
+        for (edge e : dead)
+          erase_edge(e);
+      }
+      add_edges(b.insertions());
+    }
+
+  // Remove each vertex v for which pred(v) is true, and its incident edges
+  // (see [graph.prune]).
+  template<typename V, typename E, typename L, typename I, typename A>
+    template<typename P>
+      void
+      directed_adjacency_list<V, E, L, I, A>::remove_vertices_if(P pred)
+      {
+        std::vector<char> gone(vertex_capacity());
+        bool any = false;
+        for (vertex v : vertices())
+          if (pred(v))
+            gone[v] = any = true;
+        if (!any)
+          return;
+        std::vector<char> dead(edge_capacity());
+        for (edge e : edges())
+          dead[e] = gone[source(e)] || gone[target(e)];
+        erase_marked_edges(dead, gone);
+        verts_.erase_if([&gone](std::size_t v) { return gone[v]; });
+      }
+
+  // Remove each edge e for which pred(e) is true (see [graph.prune]).
+  template<typename V, typename E, typename L, typename I, typename A>
+    template<typename P>
+      void
+      directed_adjacency_list<V, E, L, I, A>::remove_edges_if(P pred)
+      {
+        std::vector<char> dead(edge_capacity());
+        bool any = false;
+        for (edge e : edges())
+          if (pred(e))
+            dead[e] = any = true;
+        if (any)
+          erase_marked_edges(dead, std::vector<char>(vertex_capacity()));
+      }
+
+  // Remove the edges marked in dead from the graph. The out list of each
+  // source and the in list of each target of a marked edge are filtered
+  // once, except for the vertices marked in gone, which are about to be
+  // removed.
+  template<typename V, typename E, typename L, typename I, typename A>
+    void
+    directed_adjacency_list<V, E, L, I, A>::
+      erase_marked_edges(const std::vector<char>& dead,
+                         const std::vector<char>& gone)
+    {
+      using graph_impl::erase_marked;
+      std::vector<char> touched(vertex_capacity());
+      for (edge e : edges())
+        if (dead[e]) {
+          touched[source(e)] |= 1;
+          touched[target(e)] |= 2;
+          index_.erase(source(e), target(e), e);
+          filter_.erase(source(e), target(e));
+        }
+      for (vertex v : vertices()) {
+        if (gone[v])
+          continue;
+        vertex_node& vn = node(v);
+        if ((touched[v] & 1) && erase_marked(vn.out(), dead))
+          incidence_.reindex_out(vn.out());
+        if ((touched[v] & 2) && erase_marked(vn.in(), dead))
+          incidence_.reindex_in(vn.in());
+      }
+      edges_.erase_if([&dead](std::size_t e) { return dead[e]; });
+    }
+
   // Remove all edges from a graph, making it empty.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline void
-    directed_adjacency_list<V, E>::remove_edges()
+    directed_adjacency_list<V, E, L, I, A>::remove_edges()
     {
       for (vertex_node& n : verts_) {
         n.out().clear();
         n.in().clear();
       }
       edges_.clear();
+      incidence_.clear();
+      index_.clear();
+      filter_.clear();
+    }
+
+  // Compact the vertex and edge sets of the graph. See
+  // [graph.adj_list.compact].
+  template<typename V, typename E, typename L, typename I, typename A>
+    compaction_map
+    directed_adjacency_list<V, E, L, I, A>::compact()
+    {
+      using adjacency_list_impl::remap;
+      using adjacency_list_impl::remap_list;
+      compaction_map m;
+      m.vertices = verts_.compact();
+      m.edges = edges_.compact();
+      for (edge_node& e : edges_) {
+        e.source() = remap(m.vertices, e.source());
+        e.target() = remap(m.vertices, e.target());
+      }
+      for (vertex_node& v : verts_) {
+        remap_list(m.edges, v.out());
+        remap_list(m.edges, v.in());
+      }
+      incidence_.compact(m.edges);
+      if (index_.enabled())
+        index_.enable(*this);
+      if (filter_.enabled())
+        filter_.enable(*this);
+      return m;
+    }
+
+  // Returns the footprint of the vertex and edge pools, the incident edge
+  // lists, the incidence policy, the edge index and the edge filter. The
+  // dead slots are those of both pools. See [mem.usage].
+  template<typename V, typename E, typename L, typename I, typename A>
+    memory_footprint
+    directed_adjacency_list<V, E, L, I, A>::memory_usage() const
+    {
+      memory_footprint m = verts_.memory_usage() + edges_.memory_usage();
+      for (const vertex_node& v : verts_) {
+        m += v.out().memory_usage();
+        m += v.in().memory_usage();
+      }
+      return m + incidence_.memory_usage() + index_.memory_usage()
+               + filter_.memory_usage();
+    }
+
+  // Release the unused capacity of the graph. Dead slots are kept, so that
+  // handles remain valid; compact() removes them.
+  template<typename V, typename E, typename L, typename I, typename A>
+    void
+    directed_adjacency_list<V, E, L, I, A>::shrink_to_fit()
+    {
+      verts_.shrink_to_fit();
+      edges_.shrink_to_fit();
+      for (vertex_node& v : verts_) {
+        v.out().shrink_to_fit();
+        v.in().shrink_to_fit();
+      }
+      incidence_.shrink_to_fit();
+      index_.shrink_to_fit();
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::vertices() const -> vertex_range
+    directed_adjacency_list<V, E, L, I, A>::vertices() const -> vertex_range
     {
       return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::edges() const -> edge_range
+    directed_adjacency_list<V, E, L, I, A>::edges() const -> edge_range
     {
       return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::out_edges(vertex v) const -> incidence_range
+    directed_adjacency_list<V, E, L, I, A>::
+      out_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_out()), incidence_iter(vn.end_out())};
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename L, typename I, typename A>
     inline auto
-    directed_adjacency_list<V, E>::in_edges(vertex v) const -> incidence_range
+    directed_adjacency_list<V, E, L, I, A>::
+      in_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_in()), incidence_iter(vn.end_in())};
@@ -753,6 +1567,7 @@ namespace origin
   namespace undirected_adjacency_list_impl
   {
     using origin::adjacency_list_impl::pool;
+    using origin::adjacency_list_impl::bitmap_free_list;
     using origin::adjacency_list_impl::handle_iterator;
     using origin::adjacency_list_impl::edge_list;
 
@@ -761,25 +1576,37 @@ namespace origin
     
     // A vertex in an undirected adjacency list is simply a list of incident
     // edges. No distinction is made between in or out edges.
-    template<typename V>
+    //
+    // The edge list is allocated by the allocator A of the graph.
+    template<typename V,
+             typename I = std::size_t,
+             typename A = std::allocator<char>>
       struct vertex
       {
         using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
+        using list_type = edge_list<I, A>;
+        using list_allocator = typename list_type::allocator_type;
+        using iterator = typename list_type::iterator;
+        using const_iterator = typename list_type::const_iterator;
     
         vertex()
           : data()
         { }
 
+        // Construct a vertex whose edge list is allocated by a, forwarding
+        // args to the constructor of the user-supplied data object.
+        vertex(std::allocator_arg_t, const A& a)
+          : data(std::allocator_arg, list_allocator(a))
+        { }
+
         template<typename... Args>
-          vertex(Args&&... args) 
-            : data(edge_list{}, std::forward<Args>(args)...)
+          vertex(std::allocator_arg_t, const A& a, Args&&... args)
+            : data(list_type(list_allocator(a)), std::forward<Args>(args)...)
           { }
 
         // Returns the out ege list
-        edge_list&       edges()       { return std::get<0>(data); }
-        const edge_list& edges() const { return std::get<0>(data); }
+        list_type&       edges()       { return std::get<0>(data); }
+        const list_type& edges() const { return std::get<0>(data); }
         
         // Returns the user-supplied data object.
         V&       value()       { return std::get<1>(data); }
@@ -797,19 +1624,19 @@ namespace origin
         const_iterator end() const   { return edges().end(); }
 
       public:
-        std::tuple<edge_list, V> data;
+        std::tuple<list_type, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename I, typename A>
       inline void
-      vertex<V>::insert(std::size_t e)
+      vertex<V, I, A>::insert(std::size_t e)
       {
         edges().push_back(e);
       }
 
-    template<typename V>
+    template<typename V, typename I, typename A>
       inline void
-      vertex<V>::erase(std::size_t e)
+      vertex<V, I, A>::erase(std::size_t e)
       {
         auto i = std::find(begin(), end(), e);
         if (i != end())
@@ -817,43 +1644,72 @@ namespace origin
       }
 
     // A vertex set is a pool of vertices.
-    template<typename V>
-      using vertex_pool = pool<vertex<V>>;
+    template<typename V, typename I, typename A = std::allocator<char>>
+      using vertex_pool =
+        pool<vertex<V, I, A>, bitmap_free_list, I,
+             Rebind_allocator<A, vertex<V, I, A>>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_iterator<vertex_pool<V>, vertex_handle>;
+    template<typename V, typename I, typename A = std::allocator<char>>
+      using vertex_iterator =
+        handle_iterator<vertex_pool<V, I, A>, basic_vertex_handle<I>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename I, typename A = std::allocator<char>>
+      using vertex_range = bounded_range<vertex_iterator<V, I, A>>;
 
   } // namespace undirected_adjacency_list_impl
 
 
   // Implementation of the undirected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  //
+  // The index type I determines the size of vertex and edge handles and of
+  // the links in the vertex and edge pools (see [graph.handle]).
+  //
+  // The allocator A allocates the vertex and edge pools and the edge lists
+  // of each vertex, as in the directed adjacency list.
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename I = std::size_t,
+           typename A = std::allocator<char>>
     class undirected_adjacency_list
     {
-      using this_type = undirected_adjacency_list<V, E>;
+      static_assert(Allocator<A>(), "");
+
+      using this_type = undirected_adjacency_list<V, E, I, A>;
 
-      using vertex_node = undirected_adjacency_list_impl::vertex<V>;
-      using vertex_set = undirected_adjacency_list_impl::vertex_pool<V>;
-      using vertex_iter = undirected_adjacency_list_impl::vertex_iterator<V>;
+      using vertex_node = undirected_adjacency_list_impl::vertex<V, I, A>;
+      using vertex_set = undirected_adjacency_list_impl::vertex_pool<V, I, A>;
+      using vertex_iter =
+        undirected_adjacency_list_impl::vertex_iterator<V, I, A>;
 
-      using edge_node = adjacency_list_impl::edge<E>;
-      using edge_set = adjacency_list_impl::edge_pool<E>;
-      using edge_iter = adjacency_list_impl::edge_iterator<E>;
+      using edge_node = adjacency_list_impl::edge<E, I>;
+      using edge_set = adjacency_list_impl::edge_pool<E, I, A>;
+      using edge_iter = adjacency_list_impl::edge_iterator<E, I, A>;
 
-      using incidence_iter = adjacency_list_impl::incidence_iterator;
+      using incidence_iter = adjacency_list_impl::incidence_iterator<I, A>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = undirected_adjacency_list_impl::vertex_range<V>;
+      using allocator_type = A;
+
+      using vertex = basic_vertex_handle<I>;
+      using vertex_range =
+        undirected_adjacency_list_impl::vertex_range<V, I, A>;
+
+      using edge = basic_edge_handle<I>;
+      using edge_range = adjacency_list_impl::edge_range<E, I, A>;
+
+      using incidence_range = adjacency_list_impl::incidence_range<I, A>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_list_impl::edge_range<E>;
 
-      using incidence_range = adjacency_list_impl::incidence_range;
+      undirected_adjacency_list() = default;
+
+      // Construct an empty graph whose storage is allocated by a.
+      explicit undirected_adjacency_list(const A& a)
+        : verts_(a), edges_(a)
+      { }
+
+      // Returns the allocator of the graph.
+      A get_allocator() const { return A(verts_.get_allocator()); }
 
 
       // Observers
@@ -874,6 +1730,9 @@ namespace origin
       vertex source(edge e) const { return get_edge(e).source(); }
       vertex target(edge e) const { return get_edge(e).target(); }
 
+      // Prefetch the record of e (see [graph.prefetch]).
+      void prefetch_edge(edge e) const { __builtin_prefetch(&get_edge(e)); }
+
       // Data access
       V&       operator()(vertex v)       { return node(v).value(); }
       const V& operator()(vertex v) const { return node(v).value(); }
@@ -884,6 +1743,9 @@ namespace origin
       // Relation
       edge operator()(vertex u, vertex v) const;
 
+      // Capacity
+      void reserve(std::size_t n, std::size_t m);
+
       // Vertex set
       vertex add_vertex();
       vertex add_vertex(V&& x);
@@ -895,6 +1757,9 @@ namespace origin
       void remove_vertex(vertex v);
       void remove_vertices();
 
+      template<typename P>
+        void remove_vertices_if(P pred);
+
       // Edge set
       edge add_edge(vertex u, vertex v);
       edge add_edge(vertex u, vertex v, E&& x);
@@ -903,12 +1768,47 @@ namespace origin
       template<typename... Args>
         edge emplace_edge(vertex u, vertex v, Args&&... args);
 
+      template<typename R>
+        void add_edges(R&& r);
+
+      edge add_unique_edge(vertex u, vertex v);
+
       void remove_edge(edge e);
       void remove_edge(vertex u, vertex v);
       void remove_edges(vertex u, vertex v);
       void remove_edges(vertex v);
       void remove_edges();
 
+      template<typename P>
+        void remove_edges_if(P pred);
+
+      // Batched updates
+      void apply(const edge_batch<this_type>& b);
+
+      // Compaction
+      compaction_map compact();
+
+      // Memory usage
+      memory_footprint memory_usage() const;
+      void shrink_to_fit();
+
+      // Handle capacity
+      //
+      // Every vertex and edge handle is less than these until the capacity
+      // of the pools grows. See [graph.property].
+      std::size_t vertex_capacity() const { return verts_.capacity(); }
+      std::size_t edge_capacity() const   { return edges_.capacity(); }
+
+      // Edge index
+      void enable_edge_index()        { index_.enable(*this); }
+      void disable_edge_index()       { index_.disable(); }
+      bool edge_index_enabled() const { return index_.enabled(); }
+
+      // Edge filter
+      void enable_edge_filter()        { filter_.enable(*this); }
+      void disable_edge_filter()       { filter_.disable(); }
+      bool edge_filter_enabled() const { return filter_.enabled(); }
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -935,22 +1835,33 @@ namespace origin
       void unlink_multi_loop(vertex v);
       void unlink_multi_edge(vertex u, vertex v);
 
-      template<typename S, typename I>
-        void erase_loop(S& seq, I iter);
+      template<typename S, typename It>
+        void erase_loop(S& seq, It iter);
+
+      template<typename S, typename It>
+        void erase_edge(S& seq1, It iter1, S& seq2, It iter2);
 
-      template<typename S, typename I>
-        void erase_edge(S& seq1, I iter1, S& seq2, I iter2);
+      void erase_edge(edge e);
+      void erase_marked_edges(const std::vector<char>& dead,
+                              const std::vector<char>& gone);
 
     private:
       vertex_set verts_;
       edge_set   edges_;
+      adjacency_list_impl::edge_index<I, false> index_;
+      graph_impl::list_edge_filter<false> filter_;
     };
 
   // Returns true if the an edge {u, v} is in the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::operator()(vertex u, vertex v) const -> edge
+    undirected_adjacency_list<V, E, I, A>::
+      operator()(vertex u, vertex v) const -> edge
     {
+      if (!filter_.may_contain(u, v))
+        return edge();
+      if (index_.enabled())
+        return index_.find(u, v);
       if (degree(u) <= degree(v))
         return find_edge(u, v);
       else
@@ -963,9 +1874,10 @@ namespace origin
   // Note that, if u and v are connected, then the edge was added as either
   // (u, v) or (v, u). We prefer to search the vertex with the smaller degree
   // for evidence of either construction.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::find_edge(vertex u, vertex v) const -> edge
+    undirected_adjacency_list<V, E, I, A>::
+      find_edge(vertex u, vertex v) const -> edge
     {
       using P = has_endpoints<this_type>;
       const vertex_node& n = node(v);
@@ -974,10 +1886,10 @@ namespace origin
 
   // Return an iterator to the the first incident edge whose end (either
   // source or target) is equal to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     template<typename S, typename P>
       inline auto
-      undirected_adjacency_list<V, E>::
+      undirected_adjacency_list<V, E, I, A>::
         find_endpoints(const S& seq, P pred) const -> edge
       {
         auto i = find_if(seq, pred);
@@ -987,80 +1899,86 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex() -> vertex
+    undirected_adjacency_list<V, E, I, A>::add_vertex() -> vertex
     {
-      return verts_.emplace();
+      return verts_.emplace(std::allocator_arg, get_allocator());
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex(V&& x) -> vertex
+    undirected_adjacency_list<V, E, I, A>::add_vertex(V&& x) -> vertex
     {
-      return verts_.emplace(std::move(x));
+      return verts_.emplace(std::allocator_arg, get_allocator(), std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex(const V& x) -> vertex
+    undirected_adjacency_list<V, E, I, A>::add_vertex(const V& x) -> vertex
     {
-      return verts_.emplace(x);
+      return verts_.emplace(std::allocator_arg, get_allocator(), x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     template<typename... Args>
       inline auto
-      undirected_adjacency_list<V, E>::emplace_vertex(Args&&... args) -> vertex
+      undirected_adjacency_list<V, E, I, A>::
+        emplace_vertex(Args&&... args) -> vertex
       {
-        return verts_.emplace(std::forward<Args>(args)...);
+        return verts_.emplace(std::allocator_arg, get_allocator(),
+                              std::forward<Args>(args)...);
       }
 
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_vertex(vertex v)
+    undirected_adjacency_list<V, E, I, A>::remove_vertex(vertex v)
     {
       remove_edges(v);
       verts_.erase(v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_vertices()
+    undirected_adjacency_list<V, E, I, A>::remove_vertices()
     {
       edges_.clear();
       verts_.clear();
+      index_.clear();
+      filter_.clear();
     }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v) -> edge
+    undirected_adjacency_list<V, E, I, A>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    undirected_adjacency_list<V, E, I, A>::
+      add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    undirected_adjacency_list<V, E, I, A>::
+      add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     template<typename... Args>
       inline auto
-      undirected_adjacency_list<V, E>::
+      undirected_adjacency_list<V, E, I, A>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.emplace(u, v, std::forward<Args>(args)...);
@@ -1068,20 +1986,74 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::link_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_list<V, E, I, A>::link_edge(vertex u, vertex v, edge e)
     {
+      ORIGIN_COUNT("graph.edge.link");
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
       un.insert(e);
       vn.insert(e);
+      index_.insert(u, v, e);
+      filter_.insert(u, v);
+      if (filter_.stale())
+        filter_.enable(*this);
+    }
+
+  // Reserve capacity for n vertices and m edges, so that adding them does
+  // not grow the vertex and edge pools.
+  template<typename V, typename E, typename I, typename A>
+    void
+    undirected_adjacency_list<V, E, I, A>::reserve(std::size_t n,
+                                                   std::size_t m)
+    {
+      verts_.reserve(n);
+      edges_.reserve(m);
+    }
+
+  // Add each edge described by the range r to the graph (see [graph.bulk]).
+  // The incident edge list of each vertex is grown at most once.
+  template<typename V, typename E, typename I, typename A>
+    template<typename R>
+      void
+      undirected_adjacency_list<V, E, I, A>::add_edges(R&& r)
+      {
+        std::vector<std::size_t> counts;
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          graph_impl::count_incident(counts, std::get<0>(x));
+          graph_impl::count_incident(counts, std::get<1>(x));
+          ++m;
+        }
+
+        edges_.reserve(size() + m);
+        for (std::size_t v = 0; v != counts.size(); ++v)
+          if (counts[v])
+            node(v).edges().reserve(degree(v) + counts[v]);
+
+        for (auto&& x : r)
+          graph_impl::add_described_edge(
+            *this, graph_impl::forward_element<R>(x));
+      }
+
+  // Returns the first edge connecting u to v, adding one if there is none.
+  // With an edge filter, most new edges are added without a search (see
+  // [graph.filter]).
+  template<typename V, typename E, typename I, typename A>
+    inline auto
+    undirected_adjacency_list<V, E, I, A>::
+      add_unique_edge(vertex u, vertex v) -> edge
+    {
+      if (edge e = (*this)(u, v))
+        return e;
+      return add_edge(u, v);
     }
 
   // Remove the specified edge from the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_edge(edge e)
+    undirected_adjacency_list<V, E, I, A>::remove_edge(edge e)
     {
       vertex u = source(e);
       vertex v = target(e);
@@ -1092,9 +2064,9 @@ namespace origin
     }
 
   // Unlink the given edge from the vertex, when the edge is looped.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::unlink_loop(vertex v, edge e)
+    undirected_adjacency_list<V, E, I, A>::unlink_loop(vertex v, edge e)
     {
       vertex_node& n = node(v);
       auto i = find(n.edges(), e);
@@ -1103,20 +2075,21 @@ namespace origin
     }
 
   // Erase the loop edge referred to by the edge list iterator i.
-  template<typename V, typename E>
-    template<typename S, typename I>
+  template<typename V, typename E, typename I, typename A>
+    template<typename S, typename It>
       inline void
-      undirected_adjacency_list<V, E>::erase_loop(S& seq, I iter)
+      undirected_adjacency_list<V, E, I, A>::erase_loop(S& seq, It iter)
       {
-        edges_.erase(*iter);
+        erase_edge(*iter);
         seq.erase(iter, std::next(iter, 2));
       }
 
   // Unlink the given edge from the source and target vertices, and erase
   // it from the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::unlink_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_list<V, E, I, A>::
+      unlink_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
@@ -1130,22 +2103,39 @@ namespace origin
 
   // Erase the edge e from the graph by removing the endpoints and the edge
   // object.
-  template<typename V, typename E>
-    template<typename S, typename I>
+  template<typename V, typename E, typename I, typename A>
+    template<typename S, typename It>
       inline void
-      undirected_adjacency_list<V, E>::erase_edge(S& seq1, I iter1, S& seq2, I iter2)
+      undirected_adjacency_list<V, E, I, A>::
+        erase_edge(S& seq1, It iter1, S& seq2, It iter2)
         {
-          edges_.erase(*iter1);
+          erase_edge(*iter1);
           seq1.erase(iter1);
           seq2.erase(iter2);
         }
 
+  // Erase the edge e from the edge set, the edge index and the edge filter.
+  template<typename V, typename E, typename I, typename A>
+    inline void
+    undirected_adjacency_list<V, E, I, A>::erase_edge(edge e)
+    {
+      ORIGIN_COUNT("graph.edge.unlink");
+      index_.erase(source(e), target(e), e);
+      filter_.erase(source(e), target(e));
+      edges_.erase(e);
+    }
+
   // Remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, I, A>::remove_edge(vertex u, vertex v)
     {
-      if (u == v)
+      if (!filter_.may_contain(u, v))
+        return;
+      if (index_.enabled()) {
+        if (edge e = index_.find(u, v))
+          remove_edge(e);
+      } else if (u == v)
         unlink_first_loop(v);
       else if (degree(u) <= degree(v))
         unlink_first_edge(u, v);
@@ -1154,9 +2144,9 @@ namespace origin
     }
 
   // Find and remove the first loop connecting v to itself.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::unlink_first_loop(vertex v)
+    undirected_adjacency_list<V, E, I, A>::unlink_first_loop(vertex v)
     {
       using P = has_endpoint<this_type>;
       vertex_node& n = node(v); 
@@ -1166,9 +2156,9 @@ namespace origin
     }
 
   // Find and remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::unlink_first_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, I, A>::unlink_first_edge(vertex u, vertex v)
     {
       using P = has_endpoints<this_type>;
       vertex_node& un = node(u);
@@ -1182,37 +2172,42 @@ namespace origin
       
       // Find the corresponding edge in v's list. Note that *i must exist
       // in the incidence list of vn, otherwise, the graph is ill-formed.
-      auto j = find(vn.begin(), vn.end(), *i);
+      auto j = std::find(vn.begin(), vn.end(), *i);
       assert(j != vn.end());
       erase_edge(un.edges(), i, vn.edges(), j);
     }
 
   // Remove all edges connecting u to v. 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges(vertex u, vertex v)
+    undirected_adjacency_list<V, E, I, A>::remove_edges(vertex u, vertex v)
     {
-      if (u == v)
+      if (!filter_.may_contain(u, v))
+        return;
+      if (index_.enabled()) {
+        for (edge e : index_.find_all(u, v))
+          remove_edge(e);
+      } else if (u == v)
         unlink_multi_loop(u);
       else 
         unlink_multi_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::unlink_multi_loop(vertex v)
+    undirected_adjacency_list<V, E, I, A>::unlink_multi_loop(vertex v)
     {
       using P = is_looped<this_type>;
       vertex_node& n = node(v);
       auto i = partition(n, negate(P(*this, v)));
-      for (auto j = i; j != n.end(); advance(j, 2))
-        edges_.erase(*j);
+      for (auto j = i; j != n.end(); std::advance(j, 2))
+        erase_edge(*j);
       n.edges().erase(i, n.end());
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::unlink_multi_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, I, A>::unlink_multi_edge(vertex u, vertex v)
     {
       using P = has_endpoints<this_type>;
       vertex_node& un = node(u);
@@ -1221,16 +2216,16 @@ namespace origin
       auto i = partition(un.edges(), negate(P(*this, u, v)));
       auto j = partition(vn.edges(), negate(P(*this, v, u)));
       for (auto k = i; k != un.end(); ++k)
-        edges_.erase(*k);
+        erase_edge(*k);
       un.edges().erase(i, un.end());
       vn.edges().erase(j, vn.end());
     }
 
 
   // Remove all edges incident to the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges(vertex v)
+    undirected_adjacency_list<V, E, I, A>::remove_edges(vertex v)
     {
       vertex_node& vn = node(v);
       
@@ -1243,14 +2238,14 @@ namespace origin
       auto i = vn.begin();
       while (i != vn.end()) {
         if (is_loop(*this, *i)) {
-          edges_.erase(*i);
+          erase_edge(*i);
           std::advance(i, 2);
         } else {
           vertex_node& n = node(opposite(*this, *i, v));
           auto j = find(n.edges(), *i);
           if (j != n.end()) {
             n.edges().erase(j);
-            edges_.erase(*i);
+            erase_edge(*i);
           }
           ++i;
         }
@@ -1259,42 +2254,199 @@ namespace origin
     }
 
 
+  // Apply the removals and then the insertions of the batch b (see
+  // [graph.batch]). The edge list of each endpoint of a removed edge is
+  // filtered once.
+  template<typename V, typename E, typename I, typename A>
+    void
+    undirected_adjacency_list<V, E, I, A>::
+      apply(const edge_batch<this_type>& b)
+    {
+      std::vector<edge> dead = graph_impl::batch_removals(*this, b);
+      if (!dead.empty()) {
+        std::vector<vertex> ends;
+        for (edge e : dead) {
+          ends.push_back(source(e));
+          ends.push_back(target(e));
+        }
+        for (vertex v : graph_impl::distinct(std::move(ends)))
+          graph_impl::erase_batch(node(v).edges(), dead);
+        for (edge e : dead)
+          erase_edge(e);
+      }
+      add_edges(b.insertions());
+    }
+
+  // Remove each vertex v for which pred(v) is true, and its incident edges
+  // (see [graph.prune]).
+  template<typename V, typename E, typename I, typename A>
+    template<typename P>
+      void
+      undirected_adjacency_list<V, E, I, A>::remove_vertices_if(P pred)
+      {
+        std::vector<char> gone(vertex_capacity());
+        bool any = false;
+        for (vertex v : vertices())
+          if (pred(v))
+            gone[v] = any = true;
+        if (!any)
+          return;
+        std::vector<char> dead(edge_capacity());
+        for (edge e : edges())
+          dead[e] = gone[source(e)] || gone[target(e)];
+        erase_marked_edges(dead, gone);
+        verts_.erase_if([&gone](std::size_t v) { return gone[v]; });
+      }
+
+  // Remove each edge e for which pred(e) is true (see [graph.prune]).
+  template<typename V, typename E, typename I, typename A>
+    template<typename P>
+      void
+      undirected_adjacency_list<V, E, I, A>::remove_edges_if(P pred)
+      {
+        std::vector<char> dead(edge_capacity());
+        bool any = false;
+        for (edge e : edges())
+          if (pred(e))
+            dead[e] = any = true;
+        if (any)
+          erase_marked_edges(dead, std::vector<char>(vertex_capacity()));
+      }
+
+  // Remove the edges marked in dead from the graph. The edge list of each
+  // endpoint of a marked edge is filtered once, except for the vertices
+  // marked in gone, which are about to be removed.
+  template<typename V, typename E, typename I, typename A>
+    void
+    undirected_adjacency_list<V, E, I, A>::
+      erase_marked_edges(const std::vector<char>& dead,
+                         const std::vector<char>& gone)
+    {
+      std::vector<char> touched(vertex_capacity());
+      for (edge e : edges())
+        if (dead[e]) {
+          touched[source(e)] = touched[target(e)] = true;
+          index_.erase(source(e), target(e), e);
+          filter_.erase(source(e), target(e));
+        }
+      for (vertex v : vertices())
+        if (touched[v] && !gone[v])
+          graph_impl::erase_marked(node(v).edges(), dead);
+      edges_.erase_if([&dead](std::size_t e) { return dead[e]; });
+    }
+
   // Remove all edges from a graph, making it empty.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges()
+    undirected_adjacency_list<V, E, I, A>::remove_edges()
     {
       for (vertex_node& n : verts_)
         n.edges().clear();
       edges_.clear();
+      index_.clear();
+      filter_.clear();
+    }
+
+  // Compact the vertex and edge sets of the graph. See
+  // [graph.adj_list.compact].
+  template<typename V, typename E, typename I, typename A>
+    compaction_map
+    undirected_adjacency_list<V, E, I, A>::compact()
+    {
+      using adjacency_list_impl::remap;
+      using adjacency_list_impl::remap_list;
+      compaction_map m;
+      m.vertices = verts_.compact();
+      m.edges = edges_.compact();
+      for (edge_node& e : edges_) {
+        e.source() = remap(m.vertices, e.source());
+        e.target() = remap(m.vertices, e.target());
+      }
+      for (vertex_node& v : verts_)
+        remap_list(m.edges, v.edges());
+      if (index_.enabled())
+        index_.enable(*this);
+      if (filter_.enabled())
+        filter_.enable(*this);
+      return m;
+    }
+
+  // Returns the footprint of the vertex and edge pools, the incident edge
+  // lists, the edge index and the edge filter. See [mem.usage].
+  template<typename V, typename E, typename I, typename A>
+    memory_footprint
+    undirected_adjacency_list<V, E, I, A>::memory_usage() const
+    {
+      memory_footprint m = verts_.memory_usage() + edges_.memory_usage();
+      for (const vertex_node& v : verts_)
+        m += v.edges().memory_usage();
+      return m + index_.memory_usage() + filter_.memory_usage();
+    }
+
+  // Release the unused capacity of the graph. Dead slots are kept, so that
+  // handles remain valid; compact() removes them.
+  template<typename V, typename E, typename I, typename A>
+    void
+    undirected_adjacency_list<V, E, I, A>::shrink_to_fit()
+    {
+      verts_.shrink_to_fit();
+      edges_.shrink_to_fit();
+      for (vertex_node& v : verts_)
+        v.edges().shrink_to_fit();
+      index_.shrink_to_fit();
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::vertices() const -> vertex_range
+    undirected_adjacency_list<V, E, I, A>::vertices() const -> vertex_range
     {
       return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::edges() const -> edge_range
+    undirected_adjacency_list<V, E, I, A>::edges() const -> edge_range
     {
       return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename I, typename A>
     inline auto
-    undirected_adjacency_list<V, E>::edges(vertex v) const -> incidence_range
+    undirected_adjacency_list<V, E, I, A>::
+      edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin()), incidence_iter(vn.end())};
     }
 
 
+  // ------------------------------------------------------------------------ //
+  //                        Prebuilt Instantiations
+  //
+  // The adjacency lists of the common types, and the pools that store them,
+  // are instantiated once in the graph library rather than in each
+  // translation unit that uses them. Callers still inline the members that
+  // are declared inline; the others are compiled only in the library.
+  namespace adjacency_list_impl
+  {
+    extern template class pool<edge<empty_t, std::size_t>>;
+    extern template class pool<edge<double, std::size_t>>;
+  } // namespace adjacency_list_impl
+
+  extern template class
+    adjacency_list_impl::pool<directed_adjacency_list_impl::vertex<empty_t>>;
+  extern template class
+    adjacency_list_impl::pool<undirected_adjacency_list_impl::vertex<empty_t>>;
+
+  extern template class directed_adjacency_list<>;
+  extern template class directed_adjacency_list<empty_t, double>;
+  extern template class undirected_adjacency_list<>;
+  extern template class undirected_adjacency_list<empty_t, double>;
+
+
 } // namespace origin
 
 #endif
@@ -5,71 +5,279 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_HPP
+
 namespace origin
 {
   namespace adjacency_list_impl
   {
-    template<typename T> class pool_node;
-    template<typename T> class pool_iterator;
+    template<typename T, typename F, typename I, typename A>
+      class pool_iterator;
+
+
+    // Returns the index of the least set bit of x, which must not be 0.
+    inline std::size_t
+    lowest_bit(std::uint64_t x)
+    {
+      assert(x != 0);
+#if defined(__GNUC__)
+      return __builtin_ctzll(x);
+#else
+      std::size_t n = 0;
+      for ( ; !(x & 1); x >>= 1)
+        ++n;
+      return n;
+#endif
+    }
+
+    // Returns the index of the greatest set bit of x, which must not be 0.
+    inline std::size_t
+    highest_bit(std::uint64_t x)
+    {
+      assert(x != 0);
+#if defined(__GNUC__)
+      return 63 - __builtin_clzll(x);
+#else
+      std::size_t n = 63;
+      for ( ; !(x >> 63); x <<= 1)
+        --n;
+      return n;
+#endif
+    }
+
+    // Returns the number of set bits in x.
+    inline std::size_t
+    count_bits(std::uint64_t x)
+    {
+#if defined(__GNUC__)
+      return __builtin_popcountll(x);
+#else
+      std::size_t n = 0;
+      for ( ; x; x &= x - 1)
+        ++n;
+      return n;
+#endif
+    }
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Free Lists
+    //
+    // A free list records the erased indexes of a pool. The pool requires
+    // that its free list behaves like a min-queue: top() returns the least
+    // free index, push(n) adds the index n, and pop() removes the least
+    // index. Reusing the least index keeps the live elements packed toward
+    // the front of the pool.
+    //
+    // Two free lists are provided:
+    //    - heap_free_list is a 4-ary heap (see data.d_ary_heap). Insertion
+    //      and removal are O(log d), where d is the number of free indexes.
+    //    - bitmap_free_list is a two-level bitmap in which the least free
+    //      index is found with a find-first-set instruction. Insertion is
+    //      O(1). Removal is O(1) unless the lowest free indexes are all
+    //      taken, in which case the bitmap is scanned 4096 indexes at a
+    //      time for the next free index.
+    //
+    // The bitmap is the default. It also uses one bit per pool index
+    // rather than one word per free index. These bounds are checked by
+    // adjacency_list.test/complexity.cpp. The bitmap allocates its words
+    // with the allocator of its pool (see rebind_free_list below); the heap
+    // allocates from the global heap.
+
+    using heap_free_list = d_ary_heap<std::size_t, 4,
+                                      std::greater<std::size_t>>;
+
+    template<typename A = std::allocator<std::uint64_t>>
+      class basic_bitmap_free_list
+      {
+        using word = std::uint64_t;
+        using word_list = std::vector<word, Rebind_allocator<A, word>>;
+        static constexpr std::size_t bits = 64;
+      public:
+        basic_bitmap_free_list()
+          : count_(0), low_(0)
+        { }
+
+        explicit basic_bitmap_free_list(const A& a)
+          : words_(a), summary_(a), count_(0), low_(0)
+        { }
+
+        bool        empty() const { return count_ == 0; }
+        std::size_t size() const  { return count_; }
+
+        // Returns the least free index.
+        std::size_t top() const;
+
+        void push(std::size_t n);
+        void pop();
+
+      private:
+        word_list   words_;   // One bit for each index
+        word_list   summary_; // One bit for each non-zero word
+        std::size_t count_;   // The number of free indexes
+        std::size_t low_;     // The least non-zero summary word
+      };
+
+    using bitmap_free_list = basic_bitmap_free_list<>;
+
+    template<typename A>
+      inline std::size_t
+      basic_bitmap_free_list<A>::top() const
+      {
+        assert(!empty());
+        std::size_t w = low_ * bits + lowest_bit(summary_[low_]);
+        return w * bits + lowest_bit(words_[w]);
+      }
+
+    template<typename A>
+      inline void
+      basic_bitmap_free_list<A>::push(std::size_t n)
+      {
+        std::size_t w = n / bits;
+        std::size_t s = w / bits;
+        if (words_.size() <= w) {
+          words_.resize(w + 1);
+          summary_.resize(s + 1);
+        }
+        assert(!(words_[w] & (word(1) << (n % bits))));
+        words_[w] |= word(1) << (n % bits);
+        summary_[s] |= word(1) << (w % bits);
+        if (count_ == 0 || s < low_)
+          low_ = s;
+        ++count_;
+      }
+
+    template<typename A>
+      inline void
+      basic_bitmap_free_list<A>::pop()
+      {
+        std::size_t n = top();
+        std::size_t w = n / bits;
+        words_[w] &= ~(word(1) << (n % bits));
+        if (words_[w] == 0)
+          summary_[low_] &= ~(word(1) << (w % bits));
+        if (--count_ == 0)
+          low_ = 0;
+        else
+          while (summary_[low_] == 0)
+            ++low_;
+      }
+
+
+    // The free list F of a pool whose allocator is A. A bitmap free list is
+    // rebound to allocate with A, and make(a) returns an empty free list
+    // allocating with a. Other free lists are unchanged.
+    template<typename F, typename A>
+      struct rebind_free_list
+      {
+        using type = F;
+
+        static F make(const A&) { return F(); }
+      };
+
+    template<typename B, typename A>
+      struct rebind_free_list<basic_bitmap_free_list<B>, A>
+      {
+        using allocator_type = Rebind_allocator<A, std::uint64_t>;
+        using type = basic_bitmap_free_list<allocator_type>;
+
+        static type make(const A& a) { return type(allocator_type(a)); }
+      };
+
+
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Live Bitmap
+    //
+    // The live bitmap records which slots of a pool hold objects, with one
+    // bit per slot. It is a bit vector (see data.bit_vector): scanning for
+    // the next live slot with find(n) skips 64 dead slots per word, using a
+    // find-first-set instruction, without reading the slots themselves. The
+    // bitmap of a pool allocates its words with the allocator of the pool.
+    using live_bitmap = bit_vector;
+
+
 
     // ---------------------------------------------------------------------- //
     //                                 Pool
     //
-    // The node pool is the basis for the vertex and edge sets in the adjacency
-    // list data structure. The data structure is a cross between a vector and
-    // an object pool in that removing elements from the pool do not cause any
-    // additional data movements. Insertions into the pool always reuse a free
-    // (previously erased) index in the pool.
+    // The object pool is the basis for the vertex and edge sets in the
+    // adjacency list data structure. The data structure is a cross between a
+    // vector and an object pool in that removing elements from the pool do
+    // not cause any additional data movements. Insertions into the pool
+    // always reuse a free (previously erased) index in the pool.
+    //
+    // The objects are stored in a dense array of slots, each holding either
+    // an object or nothing. A separate live bitmap records which slots hold
+    // objects. When an object is erased, it is destroyed, its bit is cleared,
+    // and its index is added to the free index list, which behaves as a
+    // min-queue. When a new object is inserted, the least free index is
+    // taken from the queue and the object is constructed in that slot. If
+    // there are no free indexes, a slot is appended.
     //
     // The pool provides one other useful feature: iteration. The elements of
-    // the pool can be traversed in time proportional to the number of elements.
-    // Traversal skips deleted elements by jumping over the "dead" locations in
-    // the pool. This is done by creating a linked list rather than using a
-    // filtering technique.
+    // the pool can be traversed in index order by scanning the live bitmap,
+    // which skips runs of erased slots a word at a time without touching
+    // them. The slots of live objects are visited in increasing address
+    // order, so traversal streams through memory.
     //
-    // The data structure functions like normal vector until an object is
-    // erased. When erased, the object is cleared, and its index is added to the
-    // free index list, which is actually a min-queue. When a new object is
-    // inserted, the least index is taken from the queue and used as the
-    // location for the new object. The new object is woven into the linked
-    // list of live nodes in constant time. Re-linking list to incorporate the
-    // new node is done in constant time.
+    // The free list is a policy, F, which defaults to bitmap_free_list (see
+    // above). With the default policy, insertion and erasure usually take
+    // constant time. With a heap_free_list, both are O(log d), where d is
+    // the number of deleted objects in the pool.
     //
-    // Because the free index list is a min-queue, we always return the first
-    // unoccuped index. Unless that index is 0, we are guaranteed that the
-    // next lower index is occupied, and we can thus re-link the list based on
-    // its pointers. If the returned index is 0, we rely simply use the head
-    // pointer to find the first non-empty index and re-link the list with the
-    // new element at the head.
+    // The index type, I, bounds the number of slots: a pool indexed by
+    // std::uint32_t holds fewer than 2^32 - 1 objects.
     //
-    // Performance properties:
-    //    - Insertion: O(log2 d)
-    //    - Erasure: O(log2 d)
-    // Where d is the number of deleted nodes in the pool.
+    // The slot array is allocated by the allocator A, rebound to T, as are
+    // the live bitmap and, unless it is a heap, the free list.
     //
     // This data structure has some similarity to conventional object pools
-    // except that it doesn't really allocate memory, and it has additional
-    // requirements. In particular, it must maintain the correspondence between
-    // indices and the objects that they are mapped to. We also have to
-    // provide efficient iteration over elements in the pool.
-    template<typename T>
+    // except that it must maintain the correspondence between indices and the
+    // objects that they are mapped to. We also have to provide efficient
+    // iteration over elements in the pool.
+    template<typename T,
+             typename F = bitmap_free_list,
+             typename I = std::size_t,
+             typename A = std::allocator<T>>
       class pool
       {
-        friend class pool_iterator<T>;
-        friend class pool_iterator<const T>;
+        friend class pool_iterator<T, F, I, A>;
+        friend class pool_iterator<const T, F, I, A>;
       public:
         using value_type = T;
-        using node_type = pool_node<T>;
+        using index_type = I;
+
+        using iterator       = pool_iterator<T, F, I, A>;
+        using const_iterator = pool_iterator<const T, F, I, A>;
+
+        using allocator_type = A;
+        using slot_allocator = Rebind_allocator<A, T>;
+        using live_type = basic_bit_vector<Rebind_allocator<A, std::uint64_t>>;
+        using queue_type = typename rebind_free_list<F, A>::type;
+
+        static constexpr I npos = -1;
+
+        pool() = default;
+
+        explicit pool(const A& a)
+          : impl_(slot_allocator(a)), live_(a),
+            free_(rebind_free_list<F, A>::make(a))
+        { }
 
-        using iterator       = pool_iterator<T>;
-        using const_iterator = pool_iterator<const T>;
+        // Copy and move semantics
+        pool(const pool& x);
+        pool(pool&& x);
 
-        using list_type = std::vector<node_type>;
-        using queue_type = std::priority_queue<std::size_t, 
-                                               std::vector<std::size_t>, 
-                                               std::greater<size_t>>;
+        pool& operator=(const pool& x);
+        pool& operator=(pool&& x);
 
-        static constexpr std::size_t npos = node_type::npos;
+        ~pool();
+
+        // Returns the allocator of the pool.
+        A get_allocator() const { return A(impl_.alloc()); }
 
         // Observers
         bool empty() const;
@@ -78,12 +286,15 @@ namespace origin
         // Debugging and Testing
         // These are not part of the general interface. They are provided
         // solely for the purposes of debugging and testing.
-        const list_type& data() const;
+        const live_type& live() const;
         const queue_type& free() const;
         
         // Capacity
         std::size_t capacity() const;
         void reserve(std::size_t n);
+        void shrink_to_fit();
+
+        memory_footprint memory_usage() const;
 
         // Element access
         T&       operator[](std::size_t n);
@@ -98,549 +309,445 @@ namespace origin
         void erase(std::size_t x);
         void clear();
 
+        template<typename P>
+          std::size_t erase_if(P pred);
+
+        // Compaction
+        std::vector<std::size_t> compact();
+
         // Iterators
-        iterator begin() { return iterator(this, head_); }
-        iterator end()   { return iterator(this, npos); }
+        iterator begin() { return iterator(this, live_.find(0)); }
+        iterator end()   { return iterator(this, live_type::npos); }
         
-        const_iterator begin() const { return const_iterator(this, head_); }
-        const_iterator end() const   { return const_iterator(this, npos); }
+        const_iterator begin() const
+        {
+          return const_iterator(this, live_.find(0));
+        }
+
+        const_iterator end() const
+        {
+          return const_iterator(this, live_type::npos);
+        }
+
+        void swap(pool& x);
 
       private:
-        // Node access and properties
-        node_type&       node(std::size_t n)       { return nodes_[n]; }
-        const node_type& node(std::size_t n) const { return nodes_[n]; }
-        
-        node_type&       head()       { return node(head_); }
-        const node_type& head() const { return node(head_); }
-        
-        node_type&       tail()       { return node(tail_); }
-        const node_type& tail() const { return node(tail_); }
-        
-        node_type&       next(node_type& p)             { return node(p.next); }
-        const node_type& next(const node_type& p) const { return node(p.next); }
+        using traits = std::allocator_traits<slot_allocator>;
 
-        node_type&       prev(node_type& p)             { return node(p.prev); }
-        const node_type& prev(const node_type& p) const { return node(p.prev); }
-        
-        // Return the index of the given node.
-        std::size_t index(const node_type& p) const { return &p - &node(0); }
-
-        // Returns true if the node n is alive.
-        bool alive(std::size_t n) const { return node(n).valid(); }
-
-        // Insertion functions
-        // These functions have their arguments forwarded as parameter packs
-        // so I don't have to implement different versions of the same logic
-        // for copy insertion, move insertion, and emplacement. It's a pain,
-        // and it's gross, but it should be fast.
-        template<typename... Args> std::size_t append(Args&&... x);
-        template<typename... Args> void append_empty(Args&&... x);
-        template<typename... Args> void append_nonempty(std::size_t n, Args&&... x);
-
-        template<typename... Args> std::size_t reuse(Args&&... x);
-        template<typename... Args> void reuse_front(Args&&... x);
-        template<typename... Args> void reuse_middle(std::size_t n, Args&&... x);
-        template<typename... Args> void reuse_end(std::size_t n, Args&&... x);
-
-        std::size_t take();
-
-        // Erase functions
-        void reset(std::size_t n);
-        void reset_head(std::size_t n);
-        void reset_tail(std::size_t n);
-        void reset_middle(std::size_t n);
-        void recycle(std::size_t n);
+        // Slot access
+        T*       slot(std::size_t n)       { return impl_.first + n; }
+        const T* slot(std::size_t n) const { return impl_.first + n; }
+
+        // Returns true if the object at index n is alive.
+        bool alive(std::size_t n) const { return live_.test(n); }
+
+        // Move the live objects into a new slot array of capacity n.
+        void reallocate(std::size_t n);
+        void relocate(T* first, std::size_t n, std::true_type);
+        void relocate(T* first, std::size_t n, std::false_type);
+
+        // Destroy the live objects and release the slot array.
+        void destroy();
 
       private:
+        // The slot array. The allocator is a base class so that stateless
+        // allocators take no space.
+        struct impl_type : slot_allocator
+        {
+          impl_type() = default;
+
+          explicit impl_type(const slot_allocator& a)
+            : slot_allocator(a)
+          { }
+
+          slot_allocator&       alloc()       { return *this; }
+          const slot_allocator& alloc() const { return *this; }
 
-        list_type  nodes_; // The actual node vector
+          T*          first = nullptr; // The slots
+          std::size_t count = 0;       // The number of slots in use
+          std::size_t cap = 0;         // The number of allocated slots
+        };
+
+        impl_type  impl_;  // The slot array
+        live_type  live_;  // The live slots
         queue_type free_;  // The free index list
-        std::size_t head_; // Head of the live node list
-        std::size_t tail_; // Tail of the live node list
       };
 
-    // Returns true if the pool contains no nodes.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
+      pool<T, F, I, A>::pool(const pool& x)
+        : impl_(traits::select_on_container_copy_construction(x.impl_.alloc())),
+          live_(x.live_),
+          free_(x.free_)
+      {
+        if (x.impl_.count == 0)
+          return;
+        impl_.first = traits::allocate(impl_.alloc(), x.impl_.count);
+        impl_.cap = x.impl_.count;
+        std::size_t n = live_.find(0);
+        try {
+          for ( ; n != live_type::npos; n = live_.find(n + 1))
+            traits::construct(impl_.alloc(), slot(n), *x.slot(n));
+        } catch (...) {
+          for (std::size_t i = live_.find(0); i != n; i = live_.find(i + 1))
+            traits::destroy(impl_.alloc(), slot(i));
+          traits::deallocate(impl_.alloc(), impl_.first, impl_.cap);
+          throw;
+        }
+        impl_.count = x.impl_.count;
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      pool<T, F, I, A>::pool(pool&& x)
+        : impl_(std::move(x.impl_.alloc())),
+          live_(std::move(x.live_)),
+          free_(std::move(x.free_))
+      {
+        impl_.first = x.impl_.first;
+        impl_.count = x.impl_.count;
+        impl_.cap = x.impl_.cap;
+        x.impl_.first = nullptr;
+        x.impl_.count = x.impl_.cap = 0;
+        x.live_.clear();
+        x.free_ = rebind_free_list<F, A>::make(x.get_allocator());
+      }
+
+    // NOTE: Assignment exchanges allocators along with the slot arrays. This
+    // is correct for allocators that always compare equal, and for those
+    // that propagate on assignment.
+    template<typename T, typename F, typename I, typename A>
+      inline auto
+      pool<T, F, I, A>::operator=(const pool& x) -> pool&
+      {
+        pool tmp(x);
+        swap(tmp);
+        return *this;
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      inline auto
+      pool<T, F, I, A>::operator=(pool&& x) -> pool&
+      {
+        swap(x);
+        return *this;
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      inline
+      pool<T, F, I, A>::~pool() { destroy(); }
+
+    template<typename T, typename F, typename I, typename A>
+      inline void
+      pool<T, F, I, A>::swap(pool& x)
+      {
+        using std::swap;
+        swap(impl_, x.impl_);
+        swap(live_, x.live_);
+        swap(free_, x.free_);
+      }
+
+    // Returns true if the pool contains no objects.
+    template<typename T, typename F, typename I, typename A>
       inline bool
-      pool<T>::empty() const { return size() == 0; }
+      pool<T, F, I, A>::empty() const { return size() == 0; }
 
-    // Returns the number of nodes contained in the pool.
-    template<typename T>
+    // Returns the number of objects contained in the pool.
+    template<typename T, typename F, typename I, typename A>
       inline std::size_t
-      pool<T>::size() const { return nodes_.size() - free_.size(); }
+      pool<T, F, I, A>::size() const { return impl_.count - free_.size(); }
 
-    // Returns the objects in the data pool.
-    template<typename T>
+    // Returns the live bitmap.
+    template<typename T, typename F, typename I, typename A>
       inline auto
-      pool<T>::data() const -> const list_type& { return nodes_; }
+      pool<T, F, I, A>::live() const -> const live_type& { return live_; }
 
     // Returns the free index list.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline auto
-      pool<T>::free() const -> const queue_type& { return free_; }
+      pool<T, F, I, A>::free() const -> const queue_type& { return free_; }
 
     // Returns the capacity allocated to the pool.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline std::size_t
-      pool<T>::capacity() const { return nodes_.capacity(); }
+      pool<T, F, I, A>::capacity() const { return impl_.cap; }
 
     // Reserve at least n objects of capacity.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline void
-      pool<T>::reserve(std::size_t n) { nodes_.reserve(n); }
+      pool<T, F, I, A>::reserve(std::size_t n)
+      {
+        if (n > impl_.cap)
+          reallocate(n);
+      }
+
+    // Release the capacity of the slot array beyond its last slot. Dead slots
+    // are kept so that indexes are preserved; compact() removes them.
+    template<typename T, typename F, typename I, typename A>
+      void
+      pool<T, F, I, A>::shrink_to_fit()
+      {
+        if (impl_.cap != impl_.count) {
+          if (impl_.count == 0)
+            destroy();
+          else
+            reallocate(impl_.count);
+        }
+        live_.shrink_to_fit();
+      }
+
+    // Returns the memory footprint of the slot array and the live bitmap.
+    // The dead slots of the pool are those on its free list, whose size is
+    // not counted.
+    template<typename T, typename F, typename I, typename A>
+      inline memory_footprint
+      pool<T, F, I, A>::memory_usage() const
+      {
+        memory_footprint m(size() * sizeof(T), capacity() * sizeof(T),
+                           impl_.count - size());
+        return m + live_.memory_usage();
+      }
 
     // Returns a reference to the element in the nth position. This function
     // results in undefined behavior if the element at the nth position has been
     // previously erased.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline T&
-      pool<T>::operator[](std::size_t n)
+      pool<T, F, I, A>::operator[](std::size_t n)
       {
         assert(alive(n));
-        return nodes_[n].get();
+        return *slot(n);
       }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline const T&
-      pool<T>::operator[](std::size_t n) const
+      pool<T, F, I, A>::operator[](std::size_t n) const
       {
         assert(alive(n));
-        return nodes_[n].get();
+        return *slot(n);
       }
 
     // Move inser the value x into the pool.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline std::size_t
-      pool<T>::insert(T&& x)
+      pool<T, F, I, A>::insert(T&& x)
       {
-        if (free_.empty())
-          return append(std::move(x));
-        else
-          return reuse(std::move(x));
+        return emplace(std::move(x));
       }
 
     // Copy the value x into the vector. If there are dead indices, reuse
     // one. Otherwise, append the vertex.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline std::size_t
-      pool<T>::insert(const T& x)
+      pool<T, F, I, A>::insert(const T& x)
       {
-        if (free_.empty())
-          return append(x);
-        else 
-          return reuse(x);
+        return emplace(x);
       }
 
-    template<typename T>
+    // Construct an object in the least free slot, or in a new slot if there
+    // are none, returning its index. If the construction throws, the pool
+    // is unchanged (except possibly for its capacity).
+    template<typename T, typename F, typename I, typename A>
       template<typename... Args>
       inline std::size_t
-      pool<T>::emplace(Args&&... args)
+      pool<T, F, I, A>::emplace(Args&&... args)
       {
-        if (free_.empty())
-          return append(std::forward<Args>(args)...);
-        else
-          return reuse(std::forward<Args>(args)...);
-      }
-
-
-
-    // Insert the value x at the end of the node list, returning the index
-    // at which the object was stored.
-    template<typename T>
-      template<typename... Args>
-        inline std::size_t
-        pool<T>::append(Args&&... args)
-        {
-          std::size_t n = nodes_.size();
-          if (nodes_.empty())
-            append_empty(std::forward<Args>(args)...);
-          else
-            append_nonempty(n, std::forward<Args>(args)...);
+        ORIGIN_COUNT("graph.pool.insert");
+        if (free_.empty()) {
+          std::size_t n = impl_.count;
+          assert(n < npos);
+          if (n == impl_.cap)
+            reallocate(n ? 2 * n : 8);
+          if (live_.size() == n)
+            live_.push_back();
+          traits::construct(impl_.alloc(), slot(n),
+                            std::forward<Args>(args)...);
+          ++impl_.count;
+          live_.set(n);
           return n;
-        }
-
-    // Insert the value x into the front of the node list. This happens only
-    // when the pool is completely empty.
-    template<typename T>
-      template<typename... Args>
-        inline void
-        pool<T>::append_empty(Args&&... args)
-        {
-          nodes_.emplace_back(0, 0, std::forward<Args>(args)...);
-          head_ = 0;
-          tail_ = 0;
-        }
-
-    // Insert the value x into the list. This corresponds to thje following
-    // layout.
-    //
-    //    h ... t x
-    //
-    // Here, h is followed by 0 or more live nodes, and we are inserting into
-    // x. There are no free indexes in the pool. Note that n == nodes_.size(),
-    // whichn is the index of x.
-    template<typename T>
-      template<typename... Args>
-        inline void
-        pool<T>::append_nonempty(std::size_t n, Args&&... args)
-        {
-          nodes_.emplace_back(tail_, n, std::forward<Args>(args)...);
-          tail().next = n;
-          tail_ = n;
-        }
-
-
-    // Reuse a free index to store the object x.
-    template<typename T>
-      template<typename... Args>
-        inline std::size_t
-        pool<T>::reuse(Args&&... args)
-        {
-          std::size_t n = take();
-          if (n == 0)
-            reuse_front(std::forward<Args>(args)...);
-          else if (n < tail_)
-            reuse_middle(n, std::forward<Args>(args)...);
-          else
-            reuse_end(n, std::forward<Args>(args)...);
+        } else {
+          ORIGIN_COUNT("graph.pool.reuse");
+          std::size_t n = free_.top();
+          traits::construct(impl_.alloc(), slot(n),
+                            std::forward<Args>(args)...);
+          free_.pop();
+          live_.set(n);
           return n;
         }
-
-    // Reuse the free index at the front of the pool. This corresponds to the
-    // following layout.
-    //
-    //  p ... h ... t
-    //
-    // Here, the first free index (the node p) is succeeded by some number of
-    // live or dead nodes, which is in turn succeeded by h.
-    //
-    // There is a special case when there are no live nodes. Here, we simply
-    // overwrite the initial element. Here, we make p the both the head and
-    // the tail.
-    template<typename T>
-      template<typename... Args>
-        inline void
-        pool<T>::reuse_front(Args&&... args)
-        {
-          node_type& p = node(0);
-          if (head_ != npos) {
-            p.assign(0, head_, std::forward<Args>(args)...);
-            head().prev = 0;
-            head_ = 0;
-          } else {
-            p.assign(0, 0, std::forward<Args>(args)...);
-            head_ = 0;
-            tail_ = 0;
-          }
-        }
-
-
-
-    // Reuse a free index in the middle of the pool. This corresponds to the
-    // pool layout:
-    //
-    //    h ... q p ... r
-    //
-    // The first free index, p, succeeds the head and preceeds the tail by some
-    // number of live objects. Note that the node at n - 1 is always a live
-    // object, q. Otherwise, n would not be the least free index. The next
-    // live object, r, is directly accessible from q.
-    template<typename T>
-      template<typename... Args>
-        inline void
-        pool<T>::reuse_middle(std::size_t n, Args&&... args)
-        {
-          node_type& p = node(n);
-          node_type& q = node(n - 1);
-          node_type& r = next(q);
-          p.assign(n - 1, q.next, std::forward<Args>(args)...);
-          q.next = n;
-          r.prev = n;
-        }
-
-    // Reuse the free index at the end of the pool. This corresponds to the
-    // pool layout:
-    //
-    //   h ... t x
-    //
-    // We are reusing the first - and T is the tail. There are two things to
-    // observe here. First, t is preceeded by zero or more live objects. In
-    // other words, there are no free indexes before t. The case where h == t is
-    // also possible. Second, it is always the case that n == t + 1 (I'm not
-    // sure what that knowledge buys me though).
-    template<typename T>
-      template<typename... Args>
-        inline void
-        pool<T>::reuse_end(std::size_t n, Args&&... args)
-        {
-          node_type& p = node(n);
-          p.assign(tail_, n, std::forward<Args>(args)...);
-          tail().next = n;
-          tail_ = n;
-        }
-
-    // Take the next free index from the free list.
-    template<typename T>
-      inline std::size_t
-      pool<T>::take()
-      {
-        std::size_t n = free_.top();
-        free_.pop();
-        return n;
       }
 
     // Erase the element at the nth position in the pool, returning the index
     // n to the free list. If that element is not alive, do nothing.
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline void
-      pool<T>::erase(std::size_t n)
+      pool<T, F, I, A>::erase(std::size_t n)
       {
-        assert(n < nodes_.size());
+        assert(n < impl_.count);
         if (alive(n)) {
-          reset(n);
+          ORIGIN_COUNT("graph.pool.erase");
+          traits::destroy(impl_.alloc(), slot(n));
+          live_.reset(n);
+          free_.push(n);
         }
       }
 
-    // Reset the node at the nth position, depending on the value of n.
-    template<typename T>
-      inline void
-      pool<T>::reset(std::size_t n)
-      {
-        if (n == head_)
-          reset_head(n);
-        else if (n == tail_)
-          reset_tail(n);
-        else
-          reset_middle(n);
-      }
-
-    // Reset the head node. This corresponds to the following layout.
-    //
-    //    ... x/h ... p
-    //
-    // Here, x is the node being erased and x == h. x is follwed by zero or
-    // or more live live or dead nodes. Note that there can be no live nodes
-    // preceeding h, but any number of dead nodes is possible. Here, we
-    // advance h to the next live node. h is followed by at least one live
-    // node, which becomes the new head.
-    //
-    //    ... p/h ...
-    //
-    // There is a special case when h == t, corresponding to the erasure of
-    // the last live node. Both h and t are set to npos.
-    template<typename T>
-      inline void
-      pool<T>::reset_head(std::size_t n)
-      {
-        if (head_ != tail_) {
-          node_type& p = next(head());
-          p.prev = head().next;
-          head_ = head().next;
-        } else {
-          head_ = tail_ = npos;
+    // Erase every element whose index n satisfies pred(n), returning the
+    // number erased. The live slots are visited once, in index order, and
+    // their indexes are returned to the free list in increasing order.
+    template<typename T, typename F, typename I, typename A>
+      template<typename P>
+        std::size_t
+        pool<T, F, I, A>::erase_if(P pred)
+        {
+          std::size_t k = 0;
+          for (std::size_t n = live_.find(0); n != live_type::npos;
+               n = live_.find(n + 1))
+            if (pred(n)) {
+              traits::destroy(impl_.alloc(), slot(n));
+              live_.reset(n);
+              free_.push(n);
+              ++k;
+            }
+          ORIGIN_COUNT_N("graph.pool.erase", k);
+          return k;
         }
-        recycle(n);
-      }
-
-    // Reset the node at the the tail of the live node list. This corresponds
-    // to the following layout:
-    //
-    //    h * p t
-    //
-    // Note that there must be a previous element. If there is not, then
-    // we must be removing the head, which is handled by reset_head. The 
-    // previous live node is made the new tail.
-    template<typename T>
-      inline void
-      pool<T>::reset_tail(std::size_t n)
-      {
-        node_type& p = prev(tail());
-        p.next = tail().prev;
-        tail_ = tail().prev;
-        recycle(n);
-      }
 
-    // Reset a node in the middle of the live node list.
-    //
-    // Note that both the next and previos nodes must be valid. If not, the
-    // node at the nth position would be either the head or the tail.
-    template<typename T>
+    // Reset the pool to its initial state, keeping its capacity.
+    template<typename T, typename F, typename I, typename A>
       inline void
-      pool<T>::reset_middle(std::size_t n)
+      pool<T, F, I, A>::clear()
       {
-        node_type& p = node(n); 
-        prev(p).next = p.next;
-        next(p).prev = p.prev;
-        recycle(n);
+        for (std::size_t n = live_.find(0); n != live_type::npos;
+             n = live_.find(n + 1))
+          traits::destroy(impl_.alloc(), slot(n));
+        // The free list policy does not require a clear() method, so we have
+        // to reset the free list by brute force.
+        free_ = rebind_free_list<F, A>::make(get_allocator());
+        live_.clear();
+        impl_.count = 0;
       }
 
-    // Finally destroy the node at the nth position and return its index to the
-    // free index list.
-    template<typename T>
-      inline void
-      pool<T>::recycle(std::size_t n)
+    // Move the live objects into a new slot array for n objects. If a move
+    // throws, the new array is released and the pool is unchanged.
+    template<typename T, typename F, typename I, typename A>
+      void
+      pool<T, F, I, A>::reallocate(std::size_t n)
       {
-        node(n).reset();
-        free_.push(n);
+        assert(n >= impl_.count);
+        T* first = traits::allocate(impl_.alloc(), n);
+        relocate(first, n, is_trivially_relocatable<T>());
+        impl_.first = first;
+        impl_.cap = n;
       }
 
-    // Reset the pool to its initial state.
-    template<typename T>
-      inline void
-      pool<T>::clear()
+    // Relocate the live objects to the slot array first, of capacity n, and
+    // release the current one. Trivially relocatable objects are copied with
+    // a single memcpy of the slots in use, including dead ones, which is
+    // cheaper than visiting the live slots one by one. A large slot array is
+    // written with non-temporal stores (see [algo.stream]), so that growing
+    // it does not evict the graph from the cache.
+    template<typename T, typename F, typename I, typename A>
+      void
+      pool<T, F, I, A>::relocate(T* first, std::size_t, std::true_type)
       {
-        // std::priority_queue does not have clear() method, so we have to
-        // reset it by brute force.
-        free_ = std::move(queue_type());
-        nodes_.clear();
+        if (!impl_.first)
+          return;
+        algorithm_impl::stream_memcpy(
+          static_cast<void*>(first), impl_.first, impl_.count * sizeof(T),
+          algorithm_impl::streamed<T>(impl_.count));
+        traits::deallocate(impl_.alloc(), impl_.first, impl_.cap);
       }
 
-
-    // ---------------------------------------------------------------------- //
-    //                                Pool Node
-    //
-    // A pool node is a mix between an optional type and a linked list node.
-    // The prev and next fields refer to the corresponding "live" nodes in a
-    // pool. The data buffer stores a possibly initialized value.
-    //
-    // A node is uninitialized when either of prev or next is the same as
-    // limit (i.e., size_t(-1)).
-    template<typename T>
-      class pool_node
+    template<typename T, typename F, typename I, typename A>
+      void
+      pool<T, F, I, A>::relocate(T* first, std::size_t n, std::false_type)
       {
-      public:
-        static constexpr std::size_t npos = -1;
-
-        pool_node();
-
-        // Forwarding constructor
-        template<typename... Args>
-          pool_node(std::size_t p, std::size_t n, Args&&... args);
-
-
-        ~pool_node();
-
-        explicit operator bool() const { return valid(); }
-
-        // Returns true if the object is initialized.
-        bool valid() const;
-
-        // Returns a pointer to the stored object.
-        T*       ptr();
-        const T* ptr() const;
-
-        // Returns a reference to the stored object.
-        T&       get();
-        const T& get() const;
-
-        // Assign and reset
-        template<typename... Args>
-          void assign(std::size_t p, std::size_t n, Args&&... args);
-
-        void reset();
-        void destroy();
-
-        std::size_t prev;
-        std::size_t next;
-        Aligned_storage<sizeof(T), alignof(T)> data;
-      };
-
-    template<typename T>
-      pool_node<T>::pool_node() : prev(npos), next(npos) { }
-
-    template<typename T>
-      template<typename... Args>
-        pool_node<T>::pool_node(std::size_t p, std::size_t n, Args&&... args)
-          : prev(p), next(n)
-        {
-          new (&data) T(std::forward<Args>(args)...);
+        std::size_t i = live_.find(0);
+        try {
+          for ( ; i != live_type::npos; i = live_.find(i + 1))
+            traits::construct(impl_.alloc(), first + i,
+                              std::move_if_noexcept(*slot(i)));
+        } catch (...) {
+          for (std::size_t j = live_.find(0); j != i; j = live_.find(j + 1))
+            traits::destroy(impl_.alloc(), first + j);
+          traits::deallocate(impl_.alloc(), first, n);
+          throw;
         }
-
-    template<typename T>
-      pool_node<T>::~pool_node() { destroy(); }
-
-    template<typename T>
-      inline bool
-      pool_node<T>::valid() const { return next != npos; }
-
-    template<typename T>
-      inline T*
-      pool_node<T>::ptr() 
-      { 
-        assert(valid());
-        return reinterpret_cast<T*>(&data); 
-      }
-
-    template<typename T>
-      inline const T*
-      pool_node<T>::ptr() const 
-      { 
-        assert(valid());
-        return reinterpret_cast<const T*>(&data); 
+        std::size_t count = impl_.count;
+        destroy();
+        impl_.count = count;
       }
 
-    template<typename T>
-      inline T&
-      pool_node<T>::get() { return *ptr(); }
-
-    template<typename T>
-      inline const T&
-      pool_node<T>::get() const { return *ptr(); }
-
-    template<typename T>
-      template<typename... Args>
-        inline void
-        pool_node<T>::assign(std::size_t p, std::size_t n, Args&&... args)
-        {
-          prev = p;
-          next = n;
-          destroy();
-          new (&data) T(std::forward<Args>(args)...);
-        }
-
-    template<typename T>
-      inline void
-      pool_node<T>::reset()
+    // Destroy the live objects and release the slots, leaving the live
+    // bitmap and free list. The slot count is reset.
+    template<typename T, typename F, typename I, typename A>
+      void
+      pool<T, F, I, A>::destroy()
       {
-        assert(valid());
-        get().~T();
-        prev = next = npos;
+        if (!impl_.first)
+          return;
+        for (std::size_t n = live_.find(0); n != live_type::npos;
+             n = live_.find(n + 1))
+          traits::destroy(impl_.alloc(), slot(n));
+        traits::deallocate(impl_.alloc(), impl_.first, impl_.cap);
+        impl_.first = nullptr;
+        impl_.count = impl_.cap = 0;
       }
 
-    template<typename T>
-      inline void
-      pool_node<T>::destroy()
+
+    // Move the live objects of the pool to the front of the slot array,
+    // preserving their order, and release the excess capacity of the slot
+    // array and the free list. Returns a table m, indexed by the old index of
+    // each object such that m[n] is the new index of a live object n, and
+    // size_t(-1) for each erased index.
+    template<typename T, typename F, typename I, typename A>
+      std::vector<std::size_t>
+      pool<T, F, I, A>::compact()
       {
-        if (valid())
-          get().~T();
+        std::vector<std::size_t> map(impl_.count, std::size_t(-1));
+        pool p(get_allocator());
+        if (std::size_t m = size()) {
+          p.reallocate(m);
+          for (std::size_t n = live_.find(0); n != live_type::npos;
+               n = live_.find(n + 1)) {
+            std::size_t k = p.impl_.count;
+            p.live_.push_back();
+            traits::construct(p.impl_.alloc(), p.slot(k),
+                              std::move_if_noexcept(*slot(n)));
+            p.live_.set(k);
+            p.impl_.count = k + 1;
+            map[n] = k;
+          }
+        }
+        swap(p);
+        return map;
       }
 
 
     // ---------------------------------------------------------------------- //
     //                             Pool Iterator
     //
-    // A forward iterator over the elements in a pool.
-    //
-    // NOTE: This could be a bidirectional iterator, but we'd have to make some
-    // changes to the pool to accommodate that modification. In particular, we
-    // would have to have an extra object serving explicitly as the "end"
-    // so that we can decrement it to reach the last element. Because the
-    // current implementation uses a self-looped link to terminate the live
-    // node list, we can't effectively define an "end" position.
-    template<typename T>
+    // A bidirectional iterator over the elements in a pool, in index order.
+    // The iterator moves by scanning the live bitmap for the next or previous
+    // live slot. The end iterator has index live_bitmap::npos, and
+    // decrementing it finds the last live slot.
+    template<typename T, typename F, typename I, typename A>
       class pool_iterator
       {
       public:
-        using value_type = Remove_const<T>;
-        using pool_type = If<Const<T>(), const pool<value_type>, pool<value_type>>;
-        using node_type = If<Const<T>(), const pool_node<value_type>, pool_node<value_type>>;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = Remove_const<T>;
+        using reference         = T&;
+        using pointer           = T*;
+        using difference_type   = std::ptrdiff_t;
+        using pool_type =
+          If<Const<T>(), const pool<value_type, F, I, A>,
+                         pool<value_type, F, I, A>>;
 
         pool_iterator();
         pool_iterator(pool_type* p, std::size_t i);
 
         // Const conversion.
         template<typename U>
-          pool_iterator(const pool_iterator<U>& x)
+          pool_iterator(const pool_iterator<U, F, I, A>& x)
             : p_(x.container()), i_(x.index())
           { }
 
@@ -659,79 +766,153 @@ namespace origin
         pool_iterator& operator++();
         pool_iterator  operator++(int);
 
+        pool_iterator& operator--();
+        pool_iterator  operator--(int);
+
       private:
         void incr();
+        void decr();
       
       public:
         pool_type*  p_; // The pool
         std::size_t i_; // The current index
       };
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline
-      pool_iterator<T>::pool_iterator()
+      pool_iterator<T, F, I, A>::pool_iterator()
         : p_(nullptr), i_(-1)
       { }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline
-      pool_iterator<T>::pool_iterator(pool_type* p, std::size_t i)
+      pool_iterator<T, F, I, A>::pool_iterator(pool_type* p, std::size_t i)
         : p_(p), i_(i)
       { }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline T&
-      pool_iterator<T>::operator*() const
+      pool_iterator<T, F, I, A>::operator*() const
       {
-        return p_->node(i_).get();
+        return *p_->slot(i_);
       }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline T*
-      pool_iterator<T>::operator->() const
+      pool_iterator<T, F, I, A>::operator->() const
       {
-        return p_->node(i_).get();
+        return p_->slot(i_);
       }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline bool
-      pool_iterator<T>::operator==(const pool_iterator& x) const
+      pool_iterator<T, F, I, A>::operator==(const pool_iterator& x) const
       {
         assert(p_ == x.p_);
         return i_ == x.i_;
       }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline bool
-      pool_iterator<T>::operator!=(const pool_iterator& x) const
+      pool_iterator<T, F, I, A>::operator!=(const pool_iterator& x) const
       {
         return !operator==(x);
       }
 
-    template<typename T>
-      inline pool_iterator<T>&
-      pool_iterator<T>::operator++()
+    template<typename T, typename F, typename I, typename A>
+      inline pool_iterator<T, F, I, A>&
+      pool_iterator<T, F, I, A>::operator++()
       {
         incr();
         return *this;
       }
 
-    template<typename T>
-      inline pool_iterator<T>
-      pool_iterator<T>::operator++(int)
+    template<typename T, typename F, typename I, typename A>
+      inline pool_iterator<T, F, I, A>
+      pool_iterator<T, F, I, A>::operator++(int)
       {
         pool_iterator tmp = *this;
         incr();
         return tmp;
       }
 
-    template<typename T>
+    template<typename T, typename F, typename I, typename A>
       inline void
-      pool_iterator<T>::incr() 
+      pool_iterator<T, F, I, A>::incr() 
+      {
+        i_ = p_->live_.find(i_ + 1);
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      inline pool_iterator<T, F, I, A>&
+      pool_iterator<T, F, I, A>::operator--()
+      {
+        decr();
+        return *this;
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      inline pool_iterator<T, F, I, A>
+      pool_iterator<T, F, I, A>::operator--(int)
       {
-        const node_type& n = p_->node(i_);
-        i_ = (n.next == i_ ? pool_node<T>::npos : n.next);
+        pool_iterator tmp = *this;
+        decr();
+        return tmp;
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      inline void
+      pool_iterator<T, F, I, A>::decr()
+      {
+        assert(i_ != 0);
+        i_ = p_->live_.rfind(i_ == live_bitmap::npos ? i_ : i_ - 1);
+        assert(i_ != live_bitmap::npos);
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                            Splitting Pools
+    //
+    // A range of pool iterators is split at the middle of the slots spanned
+    // by its live objects: the first live slot at or after the midpoint
+    // begins the second half. Dead slots are skipped by the bitmap scan, so
+    // the halves are found in constant time for all but very sparse pools,
+    // and each half spans at most half of the slots of the range. Parallel
+    // algorithms over the vertices or edges of an adjacency list divide
+    // their work this way (see for_each_subrange).
+    //
+    // The size of a range, for the purpose of splitting, is the number of
+    // slots that it spans, which is an upper bound on its number of objects.
+    template<typename T, typename F, typename I, typename A>
+      inline std::size_t
+      split_size(const bounded_range<pool_iterator<T, F, I, A>>& range)
+      {
+        auto first = range.begin();
+        auto last = range.end();
+        if (first == last)
+          return 0;
+        --last;
+        return last.index() - first.index() + 1;
+      }
+
+    template<typename T, typename F, typename I, typename A>
+      inline std::pair<bounded_range<pool_iterator<T, F, I, A>>,
+                       bounded_range<pool_iterator<T, F, I, A>>>
+      split(const bounded_range<pool_iterator<T, F, I, A>>& range)
+      {
+        using Iter = pool_iterator<T, F, I, A>;
+        using B = bounded_range<Iter>;
+        Iter first = range.begin();
+        Iter last = range.end();
+        std::size_t n = split_size(range);
+        if (n < 2)
+          return {B(first, first), B(first, last)};
+        std::size_t m = first.container()->live().find(first.index() + n / 2);
+        Iter mid(first.container(), m);
+        return {B(first, mid), B(mid, last)};
       }
 
   } // namespace adjacency_list_impl
 } // namespace origin
+
+#endif
@@ -0,0 +1,64 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_PERF_FREE_LIST_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_PERF_FREE_LIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <origin/benchmark/benchmark.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+// The free list benchmarks measure the operations of a pool whose free
+// index list is of type F. A churning pool erases and reinserts objects at
+// scattered indexes, so that its free list holds many indexes.
+template<typename F>
+  int
+  free_list_main(int argc, char** argv)
+  {
+    using namespace origin;
+    using Pool = adjacency_list_impl::pool<std::size_t, F>;
+    const std::size_t n = 100000;
+
+    Pool p;
+    for (std::size_t i = 0; i != n; ++i)
+      p.insert(i);
+
+    benchmark_suite s;
+    std::uint64_t x = 88172645463325252ull;
+    s.add("pool.churn", [&p, &x, n]() {
+      // A xorshift generator scatters the erased indexes.
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      std::size_t i = x % n;
+      if (p.live().test(i))
+        p.erase(i);
+      do_not_optimize(p.insert(i));
+    });
+    // Reuse the least free index of a pool with every other index free.
+    Pool h;
+    for (std::size_t i = 0; i != n; ++i)
+      h.insert(i);
+    for (std::size_t i = 0; i < n; i += 2)
+      h.erase(i);
+    s.add("pool.reuse", [&h]() {
+      std::size_t j = h.insert(0);
+      do_not_optimize(j);
+      h.erase(j);
+    });
+    s.add("pool.iterate", [&p]() {
+      std::size_t sum = 0;
+      for (std::size_t v : p)
+        sum += v;
+      do_not_optimize(sum);
+    });
+    return benchmark_main(argc, argv, s);
+  }
+
+#endif
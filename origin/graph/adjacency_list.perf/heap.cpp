@@ -0,0 +1,14 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include "free_list.hpp"
+
+int main(int argc, char** argv)
+{
+  using origin::adjacency_list_impl::heap_free_list;
+  return free_list_main<heap_free_list>(argc, argv);
+}
@@ -5,7 +5,12 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <atomic>
 
+#include <origin/memory/allocator.hpp>
+#include <origin/memory/arena.hpp>
+#include <origin/memory/resource.hpp>
+#include <origin/sequence/execution.hpp>
 #include <origin/graph/adjacency_list.hpp>
 
 #include "../graph.test/testing.hpp"
@@ -42,6 +47,579 @@ trace_insert()
 }
 
 
+// Returns true if every edge in g appears exactly once in the out edges of
+// its source and the in edges of its target.
+template<typename G>
+  bool
+  is_consistent(const G& g)
+  {
+    size_t outs = 0;
+    size_t ins = 0;
+    for (Vertex<G> v : g.vertices()) {
+      for (Edge<G> e : g.out_edges(v)) {
+        if (g.source(e) != v)
+          return false;
+        ++outs;
+      }
+      for (Edge<G> e : g.in_edges(v)) {
+        if (g.target(e) != v)
+          return false;
+        ++ins;
+      }
+    }
+    return outs == g.size() && ins == g.size();
+  }
+
+// Remove edges from a hub vertex with many incident edges.
+template<typename G>
+  void
+  check_remove_hub_edges()
+  {
+    cout << "*** remove hub edges (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(20);
+    vector<Edge<G>> es;
+    for (int i = 1; i < 20; ++i) {
+      es.push_back(g.add_edge(0, i, i));
+      g.add_edge(i, 0, -i);
+    }
+    g.add_edge(0, 0, 0);
+
+    for (size_t i = 0; i < es.size(); i += 2)
+      g.remove_edge(es[i]);
+    assert(g.out_degree(0) == 10);
+    assert(g.in_degree(0) == 20);
+    assert(is_consistent(g));
+
+    g.remove_edges(0, 0);
+    g.remove_edge(3, 0);
+    assert(!g(3, 0));
+    assert(g.out_degree(0) == 9);
+    assert(g.in_degree(0) == 18);
+    assert(is_consistent(g));
+
+    g.remove_vertex(0);
+    assert(g.empty());
+    assert(is_consistent(g));
+  }
+
+// The stable policy preserves the order of the remaining edges.
+void
+check_stable_order()
+{
+  using S = directed_adjacency_list<char, int, stable_incidence>;
+  S g = build_n_graph<S>(5);
+  for (int i = 1; i < 5; ++i)
+    g.add_edge(0, i, i);
+  g.remove_edge(0, 2);
+
+  vector<int> vals;
+  for (Edge<S> e : g.out_edges(0))
+    vals.push_back(g(e));
+  assert((vals == vector<int>{1, 3, 4}));
+}
+
+// Returns the values of the endpoints and the value of each edge in g, in
+// sorted order.
+template<typename G>
+  vector<tuple<char, char, int>>
+  edge_values(const G& g)
+  {
+    vector<tuple<char, char, int>> vals;
+    for (Edge<G> e : g.edges())
+      vals.emplace_back(g(g.source(e)), g(g.target(e)), g(e));
+    sort(vals.begin(), vals.end());
+    return vals;
+  }
+
+// Applying a batch has the effect of its removals followed by its
+// insertions, and leaves the incidence lists usable by later updates.
+template<typename G>
+  void
+  check_apply_batch()
+  {
+    cout << "*** apply batch (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(30);
+    vector<Edge<G>> es;
+    for (int i = 0; i < 30; ++i) {
+      es.push_back(g.add_edge(i, (i * 7) % 30, i));
+      es.push_back(g.add_edge(i, (i + 1) % 30, -i));
+      g.add_edge(i, (i + 1) % 30, 100 + i);
+    }
+    g.add_edge(4, 4, 1000);
+    g.add_edge(4, 4, 1001);
+    g.enable_edge_index();
+    G h = g;
+
+    // The same changes, made one at a time to h.
+    edge_batch<G> b;
+    for (size_t i = 0; i < es.size(); i += 4) {
+      b.remove(es[i]);
+      h.remove_edge(es[i]);
+    }
+    b.remove(es[8]);
+    for (int i = 0; i < 30; i += 5) {
+      b.remove(i, (i + 1) % 30);
+      h.remove_edges(i, (i + 1) % 30);
+    }
+    b.remove(4, 4);
+    h.remove_edges(4, 4);
+    for (int i = 0; i < 30; i += 3) {
+      b.insert(i, (i + 2) % 30, 200 + i);
+      h.add_edge(i, (i + 2) % 30, 200 + i);
+    }
+    b.insert(7, 7, 2000);
+    h.add_edge(7, 7, 2000);
+
+    size_t n = b.size();
+    g.apply(b);
+    assert(b.size() == n);
+    assert(g.size() == h.size());
+    assert(edge_values(g) == edge_values(h));
+    assert(!g(0, 1));
+    assert(!g(4, 4));
+    assert(g(7, 7));
+
+    // The lists are still consistent after further updates.
+    size_t degrees = 0;
+    for (Vertex<G> v : g.vertices())
+      degrees += g.degree(v);
+    assert(degrees == 2 * g.size());
+    b.clear();
+    assert(b.empty());
+    while (!g.empty())
+      g.remove_edge(*g.edges().begin());
+    for (Vertex<G> v : g.vertices())
+      assert(g.degree(v) == 0);
+  }
+
+// Pruning removes the same vertices and edges as removing them one at a
+// time, and leaves the incidence lists usable by later updates.
+template<typename G>
+  void
+  check_prune()
+  {
+    cout << "*** prune (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(40);
+    for (int i = 0; i < 40; ++i) {
+      g.add_edge(i, (i * 7) % 40, i);
+      g.add_edge(i, (i + 1) % 40, -i);
+      g.add_edge(0, i, 100 + i);
+    }
+    g.add_edge(5, 5, 1000);
+    g.add_edge(6, 6, 1001);
+    g.enable_edge_index();
+    G h = g;
+
+    // Remove the edges with odd values, and then every third vertex but
+    // the hub.
+    vector<Edge<G>> es;
+    for (Edge<G> e : h.edges())
+      if (h(e) % 2)
+        es.push_back(e);
+    for (Edge<G> e : es)
+      h.remove_edge(e);
+    remove_edges_if(g, [&g](Edge<G> e) { return g(e) % 2 != 0; });
+    assert(g.size() == h.size());
+    assert(edge_values(g) == edge_values(h));
+
+    for (int i = 3; i < 40; i += 3)
+      h.remove_vertex(i);
+    remove_vertices_if(g, [](Vertex<G> v) { return v != 0 && v % 3 == 0; });
+    assert(g.order() == h.order() && g.size() == h.size());
+    assert(edge_values(g) == edge_values(h));
+    assert(g(0, 1) && !g(1, 7) && g(5, 5));
+
+    // Nothing to remove.
+    remove_edges_if(g, [](Edge<G>) { return false; });
+    assert(g.size() == h.size());
+
+    // The lists are still consistent after further updates.
+    size_t degrees = 0;
+    for (Vertex<G> v : g.vertices())
+      degrees += g.degree(v);
+    assert(degrees == 2 * g.size());
+    g.add_edge(1, 2, 7);
+    g.remove_edge(0, 1);
+    while (!g.empty())
+      g.remove_edge(*g.edges().begin());
+    for (Vertex<G> v : g.vertices())
+      assert(g.degree(v) == 0);
+    Vertex<G> v = g.add_vertex();
+    assert(v == 3);
+  }
+
+// Compaction preserves the structure and values of the graph, and renames
+// handles so that they are consecutive.
+template<typename G>
+  void
+  check_compact()
+  {
+    cout << "*** compact (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(60);
+    vector<Edge<G>> es;
+    for (int i = 0; i < 60; ++i) {
+      es.push_back(g.add_edge(i, (i * 7) % 60, i));
+      es.push_back(g.add_edge(i, (i + 1) % 60, -i));
+    }
+    for (int i = 0; i < 60; i += 3)
+      g.remove_vertex(i);
+    vector<Edge<G>> rs;
+    for (Edge<G> e : g.edges())
+      if (g(e) < 0 && g(e) % 5 == 0)
+        rs.push_back(e);
+    for (Edge<G> e : rs)
+      g.remove_edge(e);
+
+    auto vals = edge_values(g);
+    size_t n = g.order();
+    size_t m = g.size();
+    compaction_map cm = g.compact();
+    assert(g.order() == n);
+    assert(g.size() == m);
+    assert(edge_values(g) == vals);
+
+    // Vertices and edges are numbered [0, n) and [0, m).
+    size_t i = 0;
+    for (Vertex<G> v : g.vertices())
+      assert(v == i++);
+    i = 0;
+    for (Edge<G> e : g.edges())
+      assert(e == i++);
+
+    // Handles are renamed by the map.
+    assert(cm.vertices[0] == size_t(-1));
+    assert(cm.vertex(Vertex<G>(1)) == 0);
+    assert(g(cm.vertex(Vertex<G>(4))) == char('a' + 4));
+    Edge<G> e = cm.edge(es[2]);
+    assert(g(e) == 1);
+    assert(g(g.source(e)) == char('a' + 1));
+
+    // The compacted graph can be modified.
+    assert(g.add_vertex('z') == n);
+    g.remove_edge(e);
+    g.remove_vertex(0);
+    assert(g.size() < m - 1);
+    g.compact();
+    assert(g.order() == n);
+  }
+
+template<typename G>
+  void
+  check_compact_consistent()
+  {
+    G g = build_n_graph<G>(10);
+    for (int i = 0; i < 10; ++i)
+      for (int j = 0; j < 10; j += 3)
+        g.add_edge(i, j, i * 10 + j);
+    g.remove_vertex(3);
+    g.remove_vertex(6);
+    g.compact();
+    assert(is_consistent(g));
+    while (!g.empty()) {
+      g.remove_edge(*g.edges().begin());
+      assert(is_consistent(g));
+    }
+  }
+
+void
+check_compact_pools()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(1000);
+  for (int i = 0; i < 999; ++i)
+    g.add_edge(i, i + 1, i);
+  for (int i = 0; i < 1000; ++i)
+    if (i % 10)
+      g.remove_vertex(i);
+  g.compact();
+  assert(g.order() == 100);
+  assert(g.empty());
+
+  // Removing all vertices leaves a graph that can be compacted.
+  g.remove_vertices();
+  assert(g.vertices().begin() == g.vertices().end());
+  g.compact();
+  assert(g.null());
+  assert(g.add_vertex('a') == 0);
+}
+
+// The vertices and edges of a graph with removed elements are divided
+// among tasks by splitting their ranges.
+template<typename G>
+  void
+  check_split_ranges()
+  {
+    using V = typename G::vertex_range;
+    using E = typename G::edge_range;
+    static_assert(Splittable_range<V>(), "");
+    static_assert(Splittable_range<E>(), "");
+
+    G g = build_n_graph<G>(1000);
+    for (int i = 0; i < 999; ++i)
+      g.add_edge(i, i + 1, i);
+    for (int i = 0; i < 1000; i += 3)
+      g.remove_vertex(i);
+
+    task_scheduler s4(4);
+    atomic<long> order(0);
+    atomic<long> size(0);
+    for_each_subrange(par.on(s4), g.vertices(), 16, [&](V r) {
+      assert(split_size(r) <= 16);
+      for (Vertex<G> v : r)
+        order += v.value + 1;
+    });
+    for_each_subrange(par.on(s4), g.edges(), 16, [&](E r) {
+      for (Edge<G> e : r)
+        size += g(e) + 1;
+    });
+
+    long n = 0;
+    for (Vertex<G> v : g.vertices())
+      n += v.value + 1;
+    assert(order == n);
+    n = 0;
+    for (Edge<G> e : g.edges())
+      n += g(e) + 1;
+    assert(size == n && n != 0);
+  }
+
+// The footprint of a graph counts its pools and its edge lists, which grow
+// out of their buffers at high degree. Shrinking the graph keeps its dead
+// slots, which compaction removes.
+template<typename G>
+  void
+  check_memory_usage()
+  {
+    G g;
+    g.add_vertex('a');
+    memory_footprint m0 = g.memory_usage();
+    assert(m0.live != 0 && m0.dead == 0);
+
+    G h = build_n_graph<G>(100);
+    for (int i = 0; i < 100; ++i)
+      for (int j = 0; j < 20; ++j)
+        h.add_edge(i, (i + j) % 100, j);
+    memory_footprint m1 = h.memory_usage();
+    assert(m1.live >= h.size() * sizeof(Edge<G>));
+    assert(m1.reserved >= m1.live);
+
+    for (int i = 0; i < 50; ++i)
+      h.remove_vertex(i);
+    memory_footprint m2 = h.memory_usage();
+    assert(m2.dead >= 50);
+    assert(m2.live < m1.live);
+
+    h.shrink_to_fit();
+    memory_footprint m3 = h.memory_usage();
+    assert(m3.dead == m2.dead && m3.slack() <= m2.slack());
+
+    h.compact();
+    h.shrink_to_fit();
+    memory_footprint m4 = h.memory_usage();
+    assert(m4.dead == 0 && m4.reserved < m3.reserved);
+    assert(h.order() == 50);
+  }
+
+// Returns true if g and h have the same edges between each pair of
+// vertices, as found by the edge relation.
+template<typename G>
+  bool
+  same_relation(const G& g, const G& h)
+  {
+    for (Vertex<G> u : g.vertices())
+      for (Vertex<G> v : g.vertices()) {
+        Edge<G> e = g(u, v);
+        Edge<G> f = h(u, v);
+        if (bool(e) != bool(f))
+          return false;
+        if (e && !are_endpoints(g, e, u, v))
+          return false;
+      }
+    return true;
+  }
+
+// The edge index agrees with the incidence lists as edges are added and
+// removed.
+template<typename G>
+  void
+  check_edge_index()
+  {
+    cout << "*** edge index (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(12);
+    for (int i = 0; i < 12; ++i) {
+      g.add_edge(i, (i * 5) % 12, i);
+      g.add_edge(i, (i + 1) % 12, i);
+    }
+    g.add_edge(3, 4, 100);
+    g.add_edge(3, 3, 101);
+    g.enable_edge_index();
+    assert(g.edge_index_enabled());
+
+    // A copy without the index answers queries by searching.
+    G h = g;
+    h.disable_edge_index();
+    assert(!h.edge_index_enabled());
+    assert(same_relation(g, h));
+
+    // The least edge connecting two vertices is found.
+    Edge<G> e = g(3, 4);
+    assert(g(e) == 3);
+    g.add_edge(3, 0, 102);
+    h.add_edge(3, 0, 102);
+    assert(g(Vertex<G>(3), Vertex<G>(0)));
+    assert(same_relation(g, h));
+
+    g.remove_edge(3, 4);
+    h.remove_edge(e);
+    assert(g(g(3, 4)) == 100);
+    assert(same_relation(g, h));
+
+    g.remove_edges(3, 3);
+    h.remove_edges(3, 3);
+    assert(!g(3, 3));
+    g.remove_edge(*g.edges().begin());
+    h.remove_edge(*h.edges().begin());
+    assert(same_relation(g, h));
+
+    g.remove_vertex(5);
+    h.remove_vertex(5);
+    assert(g.size() == h.size());
+    assert(same_relation(g, h));
+
+    g.compact();
+    h.compact();
+    assert(same_relation(g, h));
+
+    g.remove_edges();
+    assert(!g(0, 1));
+    g.add_edge(0, 1, 7);
+    assert(g(g(0, 1)) == 7);
+  }
+
+
+// The edge filter admits every connected pair as edges are added and
+// removed, and as it is rebuilt, so that the edge relation is unchanged.
+// Unique insertion adds an edge only for pairs that are not connected.
+template<typename G>
+  void
+  check_edge_filter()
+  {
+    cout << "*** edge filter (" << typestr<G>() << ") ***\n";
+    G g = build_n_graph<G>(40);
+    for (int i = 0; i < 40; ++i)
+      g.add_edge(i, (i * 7) % 40, i);
+    g.enable_edge_filter();
+    assert(g.edge_filter_enabled());
+    G h = g;
+    h.disable_edge_filter();
+    assert(!h.edge_filter_enabled());
+    assert(same_relation(g, h));
+
+    // Enough edges to rebuild the filter, and parallel edges to saturate
+    // it.
+    for (int i = 0; i < 400; ++i) {
+      Edge<G> e = g.add_unique_edge(i % 40, (i * 3) % 40);
+      Edge<G> f = h.add_unique_edge(i % 40, (i * 3) % 40);
+      assert(g.size() == h.size() && g(e) == h(f));
+    }
+    assert(same_relation(g, h));
+    for (int i = 0; i < 20; ++i) {
+      g.add_edge(1, 2, i);
+      h.add_edge(1, 2, i);
+    }
+    assert(same_relation(g, h));
+
+    g.remove_edges(1, 2);
+    h.remove_edges(1, 2);
+    g.remove_edge(3, 9);
+    h.remove_edge(3, 9);
+    g.remove_edge(5, 6);
+    h.remove_edge(5, 6);
+    assert(same_relation(g, h));
+
+    g.remove_vertex(5);
+    h.remove_vertex(5);
+    g.compact();
+    h.compact();
+    assert(g.size() == h.size());
+    assert(same_relation(g, h));
+
+    // With the edge index, the filter is consulted first.
+    g.enable_edge_index();
+    assert(same_relation(g, h));
+    g.remove_edges();
+    assert(!g(0, 0));
+    Edge<G> e = g.add_unique_edge(0, 1);
+    assert(g.add_unique_edge(0, 1) == e);
+    assert(g.size() == 1);
+
+    // The footprint of the graph includes the filter.
+    memory_footprint m = g.memory_usage();
+    g.disable_edge_filter();
+    assert(g.memory_usage().reserved < m.reserved);
+  }
+
+
+// A graph allocated in an arena stores its vertices, edges and edge lists
+// there, and its copies and compactions allocate from the same arena.
+template<typename G>
+  void
+  check_arena()
+  {
+    cout << "*** arena (" << typestr<G>() << ") ***\n";
+    arena a;
+    arena_allocator<char> alloc(a);
+    G g(alloc);
+    assert(&g.get_allocator().arena() == &a);
+    for (int i = 0; i != 1000; ++i)
+      g.add_vertex('a' + i % 26);
+    for (int i = 0; i != 5000; ++i)
+      g.add_edge(i % 1000, (i * 7) % 1000, i);
+    assert(g.order() == 1000 && g.size() == 5000);
+    assert(a.capacity() >= 5000 * (2 * sizeof(Edge<G>) + sizeof(int)));
+
+    G h = g;
+    assert(&h.get_allocator().arena() == &a);
+    assert(same_relation(g, h));
+
+    g.remove_vertex(3);
+    g.remove_edges(10, 70);
+    h.remove_vertex(3);
+    h.remove_edges(10, 70);
+    g.compact();
+    assert(g.order() == 999 && g.size() == h.size());
+    assert(g(g(0, 0)) == 0);
+  }
+
+// Graphs of one type, with polymorphic allocators, are backed by
+// different memory resources chosen at run time.
+template<typename G>
+  void
+  check_resources()
+  {
+    cout << "*** resources (" << typestr<G>() << ") ***\n";
+    using A = typename G::allocator_type;
+    arena_resource a;
+    pool_resource p;
+    A aa(&a), pa(&p);
+    G g(aa);
+    G h(pa);
+    for (int i = 0; i != 100; ++i) {
+      g.add_vertex('a' + i % 26);
+      h.add_vertex('a' + i % 26);
+    }
+    for (int i = 0; i != 500; ++i) {
+      g.add_edge(i % 100, (i * 7) % 100, i);
+      h.add_edge(i % 100, (i * 7) % 100, i);
+    }
+    assert(g.get_allocator().resource() == &a);
+    assert(h.get_allocator().resource() == &p);
+    assert(a.arena().capacity() > 0);
+    assert(same_relation(g, h));
+    h.remove_vertex(3);
+    h.compact();
+    assert(h.order() == 99);
+  }
 
 int main()
 {
@@ -55,21 +633,111 @@ int main()
   check_default_init<G>();
   check_add_vertices<G>();
   check_add_edges<G>();
+  check_add_edges_bulk<G>();
   check_remove_specific_edge<G>();
   check_remove_first_simple_edge<G>();
   check_remove_first_multi_edge<G>();
   check_remove_multi_edge<G>();
   check_remove_vertex_edges<G>();
   check_remove_all_edges<G>();
+  check_workloads<G>();
   
   using D = directed_adjacency_list<char, int>;
   check_default_init<D>();
   check_add_vertices<D>();
   check_add_edges<D>();
+  check_add_edges_bulk<D>();
   check_remove_specific_edge<D>();
   check_remove_first_simple_edge<D>();
   check_remove_first_multi_edge<D>();
   check_remove_multi_edge<D>();
   check_remove_vertex_edges<D>();
   check_remove_all_edges<G>();
+  check_workloads<D>();
+
+  using S = directed_adjacency_list<char, int, stable_incidence>;
+  check_remove_hub_edges<D>();
+  check_remove_hub_edges<S>();
+  check_stable_order();
+
+  // Compact graphs use 32-bit handles and pool links.
+  using CG = undirected_adjacency_list<char, int, uint32_t>;
+  static_assert(sizeof(Vertex<CG>) == 4, "");
+  static_assert(sizeof(Edge<CG>) == 4, "");
+  check_default_init<CG>();
+  check_add_edges<CG>();
+  check_add_edges_bulk<CG>();
+  check_remove_first_multi_edge<CG>();
+  check_remove_multi_edge<CG>();
+  check_remove_vertex_edges<CG>();
+  check_remove_all_edges<CG>();
+
+  using CD = directed_adjacency_list<char, int, indexed_incidence, uint32_t>;
+  static_assert(sizeof(Vertex<CD>) == 4, "");
+  static_assert(sizeof(Edge<CD>) == 4, "");
+  check_default_init<CD>();
+  check_add_edges<CD>();
+  check_add_edges_bulk<CD>();
+  check_remove_first_multi_edge<CD>();
+  check_remove_multi_edge<CD>();
+  check_remove_vertex_edges<CD>();
+  check_remove_all_edges<CD>();
+  check_remove_hub_edges<CD>();
+
+  check_compact<G>();
+  check_compact<D>();
+  check_compact<S>();
+  check_compact<CG>();
+  check_compact<CD>();
+  check_compact_consistent<D>();
+  check_compact_consistent<S>();
+  check_compact_pools();
+  check_split_ranges<G>();
+  check_split_ranges<D>();
+  check_memory_usage<G>();
+  check_memory_usage<D>();
+  check_memory_usage<S>();
+
+  check_edge_index<G>();
+  check_edge_index<D>();
+  check_edge_index<S>();
+  check_edge_index<CG>();
+  check_edge_index<CD>();
+
+  check_edge_filter<G>();
+  check_edge_filter<D>();
+  check_edge_filter<S>();
+  check_edge_filter<CG>();
+
+  check_apply_batch<G>();
+  check_apply_batch<D>();
+  check_apply_batch<S>();
+  check_apply_batch<CG>();
+  check_apply_batch<CD>();
+  check_prune<G>();
+  check_prune<D>();
+  check_prune<S>();
+  check_prune<CD>();
+
+  // Graphs take an allocator, which is rebound for each of their pools and
+  // edge lists.
+  using AG = undirected_adjacency_list<char, int, size_t,
+                                       aligned_allocator<char>>;
+  using AD = directed_adjacency_list<char, int, indexed_incidence, size_t,
+                                     aligned_allocator<char>>;
+  check_add_edges<AG>();
+  check_add_edges_bulk<AD>();
+  check_remove_vertex_edges<AG>();
+  check_remove_vertex_edges<AD>();
+  check_compact<AG>();
+  check_compact<AD>();
+  check_arena<undirected_adjacency_list<char, int, size_t,
+                                        arena_allocator<char>>>();
+  check_arena<directed_adjacency_list<char, int, stable_incidence, uint32_t,
+                                      arena_allocator<char>>>();
+  check_resources<undirected_adjacency_list<char, int, size_t,
+                                            polymorphic_allocator<char>>>();
+  using PD = directed_adjacency_list<char, int, indexed_incidence, size_t,
+                                     polymorphic_allocator<char>>;
+  check_resources<PD>();
 }
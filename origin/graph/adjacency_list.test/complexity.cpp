@@ -0,0 +1,91 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstddef>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::adjacency_list_impl;
+using namespace origin::testing;
+
+// The complexity claims of the pools and incidence policies (see
+// adjacency_list.impl/pool.hpp and [graph.adjacency_list]) are checked by
+// timing their operations over a sweep of sizes.
+
+// Insertion into a pool is amortized O(1): building a pool of n objects
+// takes O(n) time.
+template<typename F>
+  void
+  check_pool_insert()
+  {
+    check_complexity(complexity::constant, [](size_t n) {
+      return time_per_call([n]() {
+        pool<size_t, F> p;
+        for (size_t i = 0; i != n; ++i)
+          p.insert(i);
+      }) / n;
+    });
+  }
+
+// Reusing an index of a pool with d free indexes is O(log d) with a heap
+// free list, and usually O(1) with a bitmap.
+template<typename F>
+  void
+  check_pool_reuse(complexity c)
+  {
+    check_complexity(c, [](size_t d) {
+      pool<size_t, F> p;
+      for (size_t i = 0; i != 2 * d; ++i)
+        p.insert(i);
+      for (size_t i = 0; i < 2 * d; i += 2)
+        p.erase(i);
+      return time_per_call([&p]() { p.erase(p.insert(0)); });
+    });
+  }
+
+// Removing an edge from a hub of degree d is O(1) with indexed incidence
+// and O(d) with stable incidence, which searches the out list of the hub.
+// The edge removed is always the last one added.
+template<typename G>
+  void
+  check_remove_edge(complexity c)
+  {
+    check_complexity(c, [](size_t d) {
+      G g;
+      Vertex<G> hub = g.add_vertex();
+      Vertex<G> v;
+      for (size_t i = 0; i != d; ++i) {
+        v = g.add_vertex();
+        g.add_edge(hub, v);
+      }
+      Edge<G> e = g.add_edge(hub, v);
+      return time_per_call([&]() {
+        g.remove_edge(e);
+        e = g.add_edge(hub, v);
+      });
+    });
+  }
+
+int main()
+{
+  context cxt;
+
+  check_pool_insert<bitmap_free_list>();
+  check_pool_insert<heap_free_list>();
+  check_pool_reuse<bitmap_free_list>(complexity::constant);
+  check_pool_reuse<heap_free_list>(complexity::logarithmic);
+
+  check_remove_edge<directed_adjacency_list<>>(complexity::constant);
+  using S = directed_adjacency_list<empty_t, empty_t, stable_incidence>;
+  check_remove_edge<S>(complexity::linear);
+
+  return cxt.failures();
+}
@@ -6,7 +6,9 @@
 // and conditions.
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #include <origin/graph/adjacency_list.hpp>
 
@@ -15,30 +17,15 @@ using namespace origin;
 using namespace origin::adjacency_list_impl;
 
 
-template<typename Q>
-  struct hack_queue : Q
-  {
-    using Q::c;
-    using Q::comp;
-  };
-
-template<typename Q>
-  const hack_queue<Q>& 
-  hack(const Q& q)
-  {
-    return reinterpret_cast<const hack_queue<Q>&>(q);
-  }
-
 template<typename P>
   void 
   print_queue(const P& p)
   {
-    using Hack = hack_queue<typename P::queue_type>;
-    const Hack& q = hack(p.free());
+    typename P::queue_type q = p.free();
 
     cout << "free: ";
-    for (const auto& x : q.c)
-      cout << x << ' ';
+    for ( ; !q.empty(); q.pop())
+      cout << q.top() << ' ';
     cout << '\n';
   }
 
@@ -46,13 +33,12 @@ template<typename P>
   void
   print_pool(const P& p)
   {
-    using Vec = typename P::list_type;
-    const Vec& v = p.data();
+    const live_bitmap& v = p.live();
 
     cout << "pool: ";
-    for (const auto& x : v) {
-      if (x)
-        cout << x.get() << ' ';
+    for (size_t n = 0; n != v.size(); ++n) {
+      if (v.test(n))
+        cout << p[n] << ' ';
       else
         cout << 'X' << ' ';
     }
@@ -80,14 +66,34 @@ template<typename P>
   }
 
 
-void check_node()
+// The live bitmap finds the next live slot across runs of dead slots.
+void check_live()
 {
-  pool_node<int> a;
-  assert(!a);
+  live_bitmap b;
+  assert(b.find(0) == live_bitmap::npos);
+  for (int i = 0; i < 300; ++i)
+    b.push_back();
+  assert(b.size() == 300 && b.count() == 0);
 
-  pool_node<int> b(0, 0, 3);
-  assert(b);
-  assert(b.get() == 3);
+  for (size_t n : {3, 64, 65, 130, 299})
+    b.set(n);
+  assert(b.count() == 5);
+  assert(b.test(64) && !b.test(63));
+  assert(b.find(0) == 3);
+  assert(b.find(4) == 64);
+  assert(b.find(66) == 130);
+  assert(b.find(131) == 299);
+  assert(b.find(300) == live_bitmap::npos);
+  assert(b.rfind(live_bitmap::npos) == 299);
+  assert(b.rfind(298) == 130);
+  assert(b.rfind(64) == 64);
+  assert(b.rfind(63) == 3);
+  assert(b.rfind(2) == live_bitmap::npos);
+
+  b.reset(299);
+  assert(b.find(131) == live_bitmap::npos);
+  b.clear();
+  assert(b.size() == 0);
 }
 
 void
@@ -95,6 +101,7 @@ check_pool_insert_1()
 {
   pool<int> p;
   assert(p.empty());
+  assert(p.begin() == p.end());
 
   size_t n = p.insert(10);
   assert(p.size() == 1);
@@ -138,6 +145,23 @@ check_pool_erase()
   debug_pool(p);
 }
 
+// Erasing by predicate frees the matching slots, which are reused least
+// first.
+void
+check_pool_erase_if()
+{
+  pool<int> p;
+  for (int i = 0; i < 200; ++i)
+    p.insert(i);
+  assert(p.erase_if([](size_t n) { return n % 3 == 1; }) == 67);
+  assert(p.size() == 133);
+  assert(p.erase_if([](size_t) { return false; }) == 0);
+  for (int x : p)
+    assert(x % 3 != 1);
+  assert(p.insert(-1) == 1);
+  assert(p.insert(-4) == 4);
+}
+
 void
 check_pool_reuse()
 {
@@ -191,14 +215,227 @@ check_pool_yoyo_rl()
   debug_pool(p);
 }
 
+// The free list returns the least free index first.
+template<typename F>
+  void
+  check_free_list()
+  {
+    F f;
+    for (size_t n : {130, 5, 4097, 64, 0, 4096, 63})
+      f.push(n);
+    assert(f.size() == 7);
+
+    vector<size_t> v;
+    for ( ; !f.empty(); f.pop())
+      v.push_back(f.top());
+    assert((v == vector<size_t>{0, 5, 63, 64, 130, 4096, 4097}));
+
+    f.push(10);
+    f.push(3);
+    assert(f.top() == 3);
+    f.pop();
+    f.push(1);
+    assert(f.top() == 1);
+    f.pop();
+    assert(f.top() == 10);
+  }
+
+// Erase many elements and re-fill the pool. Reinsertion always takes the
+// least free index, and the live list remains in index order.
+template<typename F, typename I = size_t>
+  void
+  check_pool_churn()
+  {
+    pool<int, F, I> p;
+    for (int i = 0; i < 1000; ++i)
+      p.insert(i);
+    for (int i = 0; i < 1000; i += 3)
+      p.erase(i);
+    for (int i = 999; i >= 0; i -= 7)
+      p.erase(i);
+
+    size_t prev = 0;
+    bool first = true;
+    while (p.size() != 1000) {
+      size_t n = p.insert(-1);
+      assert(first || prev < n);
+      p[n] = n;
+      prev = n;
+      first = false;
+    }
+
+    int k = 0;
+    for (int x : p)
+      assert(x == k++);
+    assert(k == 1000);
+  }
+
+
+// Objects that own memory survive reallocation of the pool.
+void
+check_pool_realloc()
+{
+  pool<vector<int>> p;
+  for (int i = 0; i < 100; ++i)
+    p.insert(vector<int>(10, i));
+  p.erase(3);
+  pool<vector<int>> q = p;
+  for (int i = 0; i < 100; ++i)
+    q.insert(vector<int>(10, i));
+  assert(q.size() == 199);
+  assert(q[3] == vector<int>(10, 0));
+  assert(q[99] == vector<int>(10, 99));
+  assert(p.size() == 99);
+
+  // Reusing an erased node does not destroy its object again.
+  p.erase(50);
+  size_t n = p.insert(vector<int>(5, 50));
+  assert(n == 3);
+  assert(p[n] == vector<int>(5, 50));
+  n = p.insert(vector<int>(5, 50));
+  assert(n == 50);
+  assert(p[n] == vector<int>(5, 50));
+
+  // Growing a slot array of more than 8 MiB streams the relocated slots.
+  pool<double> d;
+  const size_t big = (size_t(1) << 21) + 5;
+  for (size_t i = 0; i != big; ++i)
+    d.insert(double(i));
+  for (size_t i = 0; i != big; ++i)
+    assert(d[i] == double(i));
+}
+
+// Compaction packs the live nodes in order and empties the free list.
+template<typename F>
+  void
+  check_pool_compact()
+  {
+    pool<int, F> p;
+    for (int i = 0; i < 200; ++i)
+      p.insert(i);
+    for (int i = 0; i < 200; ++i)
+      if (i % 4 != 1)
+        p.erase(i);
+
+    vector<size_t> m = p.compact();
+    assert(m.size() == 200);
+    assert(m[0] == size_t(-1));
+    assert(m[1] == 0);
+    assert(m[5] == 1);
+    assert(p.size() == 50);
+    assert(p.free().empty());
+    assert(p.live().size() == 50 && p.live().count() == 50);
+    assert(p.capacity() == 50);
+    int n = 0;
+    for (int x : p)
+      assert(x == 4 * n++ + 1);
+    assert(n == 50);
+
+    // Erasure and insertion work after compaction.
+    p.erase(0);
+    p.erase(49);
+    assert(p.insert(7) == 0);
+    assert(p.insert(8) == 49);
+    assert(p.insert(9) == 50);
+
+    pool<int, F> q;
+    assert(q.compact().empty());
+    assert(q.begin() == q.end());
+  }
+
+// Pool iterators are bidirectional, and a pool range splits at the middle
+// of its slots.
+void
+check_pool_split()
+{
+  pool<int> p;
+  for (int i = 0; i < 1000; ++i)
+    p.insert(i);
+  for (int i = 0; i < 1000; ++i)
+    if (i % 7 || i > 900)
+      p.erase(i);
+
+  vector<int> v(p.begin(), p.end());
+  vector<int> r;
+  for (auto i = p.end(); i != p.begin(); )
+    r.push_back(*--i);
+  assert(r.size() == v.size() && equal(v.rbegin(), v.rend(), r.begin()));
+
+  using R = bounded_range<pool<int>::iterator>;
+  R all(p.begin(), p.end());
+  assert(split_size(all) == 897);
+  auto halves = split(all);
+  assert(*halves.second.begin() == 448);
+  assert(split_size(halves.first) <= 448);
+  assert(split_size(halves.second) <= 449);
+
+  // Splitting down to single objects visits each object once.
+  vector<R> work = {all};
+  vector<int> seen;
+  while (!work.empty()) {
+    R x = work.back();
+    work.pop_back();
+    if (split_size(x) > 1) {
+      auto h = split(x);
+      work.push_back(h.second);
+      work.push_back(h.first);
+    } else if (split_size(x) == 1) {
+      seen.push_back(*x.begin());
+    }
+  }
+  assert(seen == v);
+  assert(split_size(R(p.end(), p.end())) == 0);
+}
+
+// The footprint of a pool counts its live and dead slots, and shrinking it
+// releases the capacity beyond its last slot.
+void
+check_pool_usage()
+{
+  pool<double> p;
+  assert(p.memory_usage() == memory_footprint());
+  p.reserve(100);
+  for (int i = 0; i < 10; ++i)
+    p.insert(i);
+  p.erase(3);
+  p.erase(4);
+  memory_footprint m = p.memory_usage();
+  assert(m.dead == 2);
+  assert(m.live >= 8 * sizeof(double));
+  assert(m.reserved >= 100 * sizeof(double));
+
+  p.shrink_to_fit();
+  assert(p.capacity() == 10 && p.size() == 8);
+  assert(p[9] == 9 && p.memory_usage().dead == 2);
+  assert(p.insert(3) == 3);
+  p.compact();
+  assert(p.memory_usage().dead == 0 && p.size() == 9);
+
+  p.clear();
+  p.shrink_to_fit();
+  assert(p.capacity() == 0);
+  assert(p.memory_usage().reserved == 0);
+}
 
 int main()
 {
-  check_node();
+  check_live();
   check_pool_insert_1();
   check_pool_insert_n();
   check_pool_erase();
+  check_pool_erase_if();
   check_pool_reuse();
   check_pool_yoyo_lr();
   check_pool_yoyo_rl();
+  check_pool_realloc();
+  check_pool_split();
+  check_pool_usage();
+
+  check_free_list<bitmap_free_list>();
+  check_free_list<heap_free_list>();
+  check_pool_churn<bitmap_free_list>();
+  check_pool_churn<heap_free_list>();
+  check_pool_churn<bitmap_free_list, uint32_t>();
+  check_pool_compact<bitmap_free_list>();
+  check_pool_compact<heap_free_list>();
 }
@@ -9,8 +9,11 @@
 #define ORIGIN_GRAPH_ADJACENCY_VECTOR_HPP
 
 #include <cassert>
+#include <cstdint>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <queue>
 #include <tuple>
 #include <vector>
@@ -19,12 +22,19 @@
 #include <origin/type/empty.hpp>
 #include <origin/type/typestr.hpp>
 #include <origin/type/functional.hpp>
+#include <origin/memory/concepts.hpp>
+#include <origin/memory/usage.hpp>
+#include <origin/data/bit_vector/bit_vector.hpp>
+#include <origin/data/heap/d_ary_heap.hpp>
+#include <origin/data/small_vector/small_vector.hpp>
+#include <origin/instrument/instrument.hpp>
 #include <origin/sequence/algorithm.hpp>
 #include <origin/sequence/range.hpp>
 
 #include <origin/graph/handle.hpp>
 #include <origin/graph/graph.hpp>
 #include <origin/graph/io.hpp>
+#include <origin/graph/edge_filter.hpp>
 
 #include <origin/graph/adjacency_list.impl/pool.hpp>
 
@@ -34,24 +44,41 @@ namespace origin
   namespace adjacency_vector_impl
   {
 
-    // The handle iterator wraps a constant iterator of the container type C and
-    // returns handles of type H when dereferenced.
+    // The handle counter is an iterator over a contiguous sequence of
+    // indexes of type T. Dereferencing the iterator yields a handle of type
+    // H.
     //
-    // TODO: Make this a random access iterator.
+    // Because the vertices and edges of an adjacency vector are numbered
+    // consecutively, the handle counter is a random access iterator. The
+    // number of vertices or edges in a range is computed in constant time,
+    // and a range can be divided into chunks (e.g., for parallel
+    // processing) without enumerating its handles.
     template<typename T, typename H>
       struct handle_counter
       {
+        using value_type = H;
+        using reference = H;
+        using pointer = const H*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+
         using handle_type = H;
         using counter_type = T;
 
-        handle_counter(counter_type n)
+        handle_counter(counter_type n = 0)
           : count(n)
         { }
 
-        handle_type operator*() const { H(count); }
+        handle_type operator*() const { return H(count); }
+        handle_type operator[](difference_type n) const { return H(count + n); }
 
         handle_counter& operator++();
         handle_counter  operator++(int);
+        handle_counter& operator--();
+        handle_counter  operator--(int);
+
+        handle_counter& operator+=(difference_type n);
+        handle_counter& operator-=(difference_type n);
 
         T count;
       };
@@ -74,6 +101,59 @@ namespace origin
         return tmp;
       }
 
+    template<typename C, typename H>
+      inline handle_counter<C, H>&
+      handle_counter<C, H>::operator--()
+      {
+        --count;
+        return *this;
+      }
+
+    template<typename C, typename H>
+      inline handle_counter<C, H>
+      handle_counter<C, H>::operator--(int)
+      {
+        handle_counter tmp = *this;
+        --count;
+        return tmp;
+      }
+
+    template<typename C, typename H>
+      inline handle_counter<C, H>&
+      handle_counter<C, H>::operator+=(difference_type n)
+      {
+        count += n;
+        return *this;
+      }
+
+    template<typename C, typename H>
+      inline handle_counter<C, H>&
+      handle_counter<C, H>::operator-=(difference_type n)
+      {
+        count -= n;
+        return *this;
+      }
+
+    // Arithmetic
+    template<typename C, typename H>
+      inline handle_counter<C, H>
+      operator+(handle_counter<C, H> i, std::ptrdiff_t n) { return i += n; }
+
+    template<typename C, typename H>
+      inline handle_counter<C, H>
+      operator+(std::ptrdiff_t n, handle_counter<C, H> i) { return i += n; }
+
+    template<typename C, typename H>
+      inline handle_counter<C, H>
+      operator-(handle_counter<C, H> i, std::ptrdiff_t n) { return i -= n; }
+
+    template<typename C, typename H>
+      inline std::ptrdiff_t
+      operator-(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
+      {
+        return std::ptrdiff_t(a.count) - std::ptrdiff_t(b.count);
+      }
+
     // Equality
     template<typename C, typename H>
       inline bool
@@ -89,53 +169,151 @@ namespace origin
         return a.count != b.count;
       }
 
+    // Ordering
+    template<typename C, typename H>
+      inline bool
+      operator<(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
+      {
+        return a.count < b.count;
+      }
+
+    template<typename C, typename H>
+      inline bool
+      operator>(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
+      {
+        return a.count > b.count;
+      }
+
+    template<typename C, typename H>
+      inline bool
+      operator<=(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
+      {
+        return a.count <= b.count;
+      }
+
+    template<typename C, typename H>
+      inline bool
+      operator>=(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
+      {
+        return a.count >= b.count;
+      }
+
 
     // ---------------------------------------------------------------------- //
     //                            Edge Representation
     //
-    // An edge is a triple describing the source vertex, the target vertex and
-    // user data. The edge representation is the same for both directed and
-    // undirected adjacency lists. 
+    // The edge set is stored as a structure of arrays: the source and target
+    // of each edge are kept in separate vectors from the user data, so that
+    // algorithms that only follow the topology of the graph never load edge
+    // values into cache. An edge handle is an index into each of the arrays.
+    // The edge representation is the same for both directed and undirected
+    // adjacency vectors.
     //
-    // In an undirected adjacency list, the source and target vertices refer to
-    // the vertices in the order they were specified on addition. There is no
-    // other meaning attributed to them.
-    template<typename E>
-      struct edge
+    // In an undirected adjacency vector, the source and target vertices refer
+    // to the vertices in the order they were specified on addition. There is
+    // no other meaning attributed to them.
+    //
+    // Each array is allocated by the allocator A of the graph, rebound to
+    // the type of its elements.
+    template<typename T, typename A>
+      using rebind_vector = std::vector<T, Rebind_allocator<A, T>>;
+
+    template<typename E, typename A = std::allocator<char>>
+      struct edge_set
       {
-        using value_type = E;
+        edge_set() = default;
 
-        edge()
-          : data(-1, -1, E{})
+        explicit edge_set(const A& a)
+          : sources(a), targets(a), values(a)
         { }
 
-        edge(vertex_handle s, vertex_handle t)
-          : data(s, t, E{})
-        { }
+        bool        empty() const { return targets.empty(); }
+        std::size_t size() const  { return targets.size(); }
+
+        void reserve(std::size_t n);
+
+        memory_footprint memory_usage() const;
+        void shrink_to_fit();
 
         template<typename... Args>
-          edge(vertex_handle s, vertex_handle t, Args&&... args)
-            : data(s, t, std::forward<Args>(args)...)
-          { }
+          void emplace_back(vertex_handle s, vertex_handle t, Args&&... args);
 
-        vertex_handle& source()       { return std::get<0>(data); }
-        vertex_handle  source() const { return std::get<0>(data); }
+        rebind_vector<vertex_handle, A> sources; // Source of each edge
+        rebind_vector<vertex_handle, A> targets; // Target of each edge
+        rebind_vector<E, A>             values;  // Edge values
+      };
 
-        vertex_handle& target()       { return std::get<1>(data); }
-        vertex_handle  target() const { return std::get<1>(data); }
+    template<typename E, typename A>
+      inline void
+      edge_set<E, A>::reserve(std::size_t n)
+      {
+        sources.reserve(n);
+        targets.reserve(n);
+        values.reserve(n);
+      }
 
-        E&       value()       { return std::get<2>(data); }
-        const E& value() const { return std::get<2>(data); }
+    // Returns the footprint of the edge arrays. See [mem.usage].
+    template<typename E, typename A>
+      inline memory_footprint
+      edge_set<E, A>::memory_usage() const
+      {
+        return contiguous_footprint(sources) + contiguous_footprint(targets)
+             + contiguous_footprint(values);
+      }
 
-        std::tuple<vertex_handle, vertex_handle,  E> data;
-      };
+    template<typename E, typename A>
+      inline void
+      edge_set<E, A>::shrink_to_fit()
+      {
+        sources.shrink_to_fit();
+        targets.shrink_to_fit();
+        values.shrink_to_fit();
+      }
 
-    // An (incident) edge list is a vector of indexes.
-    using edge_list = std::vector<edge_handle>;
-  
-    // An alias for the edge pool.
-    template<typename E>
-      using edge_set = std::vector<edge<E>>;
+    // Returns the footprint of the array of edge lists vs, and of the edges
+    // stored outside the buffer of each list.
+    template<typename V>
+      inline memory_footprint
+      lists_footprint(const V& vs)
+      {
+        memory_footprint m = contiguous_footprint(vs);
+        for (const auto& l : vs)
+          m += l.memory_usage();
+        return m;
+      }
+
+    // Release the unused capacity of the array of edge lists vs, and of each
+    // list.
+    template<typename V>
+      inline void
+      shrink_lists(V& vs)
+      {
+        vs.shrink_to_fit();
+        for (auto& l : vs)
+          l.shrink_to_fit();
+      }
+
+    template<typename E, typename A>
+      template<typename... Args>
+        inline void
+        edge_set<E, A>::emplace_back(vertex_handle s, vertex_handle t,
+                                     Args&&... args)
+        {
+          sources.push_back(s);
+          targets.push_back(t);
+          values.emplace_back(std::forward<Args>(args)...);
+        }
+
+    // The number of incident edges stored inside each edge list.
+    constexpr std::size_t edge_buffer = 4;
+
+    // An (incident) edge list is a small vector of indexes, so that the
+    // edges of a vertex with at most edge_buffer incident edges are stored
+    // in the vertex arrays without a separate allocation.
+    template<typename A = std::allocator<char>>
+      using edge_list =
+        small_vector<edge_handle, edge_buffer,
+                     Rebind_allocator<A, edge_handle>>;
 
     // An alias for the edge iterator.
     template<typename E>
@@ -146,10 +324,103 @@ namespace origin
       using edge_range = bounded_range<edge_iterator<E>>;
 
     // An alias for the incident edge iterator.
-    using incidence_iterator = typename edge_list::const_iterator;
+    template<typename A = std::allocator<char>>
+      using incidence_iterator = typename edge_list<A>::const_iterator;
 
     // An alias for the icident edge range.
-    using incidence_range = bounded_range<incidence_iterator>;
+    template<typename A = std::allocator<char>>
+      using incidence_range = bounded_range<incidence_iterator<A>>;
+
+
+    // ---------------------------------------------------------------------- //
+    //                                                    [graph.adj_vec.sorted]
+    //                            Sorted Edge Lists
+    //
+    // The incident edge lists of an adjacency vector can be kept sorted by
+    // the opposite endpoint of each edge, and then by edge handle, so that
+    // the edges connecting two vertices are found by binary search and the
+    // neighbors of two vertices can be merged. The edge connecting u and v
+    // found in a sorted list is the first one added, as it is when the list
+    // is searched linearly.
+    //
+    // Calling g.enable_sorted_edges() sorts every list, and new edges are
+    // then inserted in order, galloping back from the end of the list. The
+    // bulk loader appends its edges and sorts each list that received edges
+    // out of order once.
+    //
+    // Each list has a flag that is set while the list is known to be sorted,
+    // which is tested in constant time (e.g., g.out_edges_sorted(v)).
+    // Appending an edge out of order resets it. Lists whose flag is set are
+    // searched by binary search whether or not sorting is enabled. The key
+    // of an edge e in a list is key(e).
+
+    // Returns the position after the last edge in l whose key is not greater
+    // than k. The search gallops backward from the end of l, since edges are
+    // usually added in nearly increasing order.
+    template<typename L, typename K>
+      auto
+      gallop_upper_bound(const L& l, vertex_handle k, K key)
+        -> decltype(l.begin())
+      {
+        auto less = [&key](vertex_handle k, edge_handle e) {
+          return k < key(e);
+        };
+        std::size_t hi = l.size();
+        std::size_t step = 1;
+        while (hi != 0 && k < key(l[hi - 1])) {
+          std::size_t lo = hi > step ? hi - step : 0;
+          if (!(k < key(l[lo])))
+            return std::upper_bound(l.begin() + lo + 1, l.begin() + hi - 1,
+                                    k, less);
+          hi = lo;
+          step *= 2;
+        }
+        return l.begin() + hi;
+      }
+
+    // Returns the first edge in the sorted list l whose key is k, or the
+    // invalid edge if there is none.
+    template<typename L, typename K>
+      edge_handle
+      find_sorted(const L& l, vertex_handle k, K key)
+      {
+        auto i = std::lower_bound(l.begin(), l.end(), k,
+                                  [&key](edge_handle e, vertex_handle k) {
+          return key(e) < k;
+        });
+        return i != l.end() && key(*i) == k ? *i : edge_handle();
+      }
+
+    // Sort the edges of l by key, and then by handle.
+    template<typename L, typename K>
+      void
+      sort_list(L& l, K key)
+      {
+        std::sort(l.begin(), l.end(), [&key](edge_handle a, edge_handle b) {
+          vertex_handle x = key(a);
+          vertex_handle y = key(b);
+          return x < y || (x == y && a < b);
+        });
+      }
+
+    // Add the edge e, whose key is k, to the list l of the vertex v, whose
+    // sorted flag is in flags. When sorted is true, l is kept sorted;
+    // otherwise, an edge added out of order resets its flag. Since e is the
+    // newest edge, it follows every other edge with the same key.
+    template<typename L, typename K>
+      void
+      insert_sorted(L& l, bit_vector& flags, vertex_handle v, vertex_handle k,
+                    edge_handle e, bool sorted, K key)
+      {
+        if (l.empty() || !(k < key(l.back()))) {
+          l.push_back(e);
+        } else if (sorted && flags.test(v)) {
+          l.insert(gallop_upper_bound(l, k, key), e);
+        } else {
+          l.push_back(e);
+          flags.reset(v);
+        }
+      }
 
   } // namespace adjacency_vector_impl
 
@@ -165,88 +436,81 @@ namespace origin
   // Like any [Adjacency_list], the data structure also provides efficient
   // access to all vertices, all edges, and the successors and predecessors
   // of each vertex.
+  //
+  // The topology of the graph is stored in arrays separate from the values
+  // of its vertices and edges. Traversing the out edges of a vertex and
+  // reading their targets never touches user data.
 
   namespace directed_adjacency_vector_impl
   {
     // Imports
     using adjacency_vector_impl::handle_counter;
     using adjacency_vector_impl::edge_list;
+    using adjacency_vector_impl::rebind_vector;
+    using adjacency_vector_impl::lists_footprint;
+    using adjacency_vector_impl::shrink_lists;
 
 
     // ---------------------------------------------------------------------- //
     //                        Vertex Representation
-    
-    // A vertex in adjacency list is implemented as a pair of edge lisst. An
-    // edge list is simply a vector of indexes that refer to edges in a
-    // separate edge container.
+
+    // The vertex set is stored as a structure of arrays. The out and in edge
+    // lists of each vertex are kept apart from the user data, so traversals
+    // touch only the incidence lists. A vertex handle is an index into each
+    // of the arrays.
     //
-    // Note that the class will compress the value type if it is empty.
-    template<typename V>
-      struct vertex
-      {
-        using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
-    
-        vertex()
-          : data()
+    // The arrays, and the edge lists of each vertex, are allocated by the
+    // allocator A of the graph. The sorted flags of the lists (see
+    // [graph.adj_vec.sorted]) are kept in bit vectors.
+    template<typename V, typename A = std::allocator<char>>
+      struct vertex_set
+      {
+        vertex_set() = default;
+
+        explicit vertex_set(const A& a)
+          : outs(a), ins(a), values(a)
         { }
 
+        bool        empty() const { return values.empty(); }
+        std::size_t size() const  { return values.size(); }
+
         template<typename... Args>
-          vertex(Args&&... args) 
-            : data(edge_list{}, edge_list{}, std::forward<Args>(args)...)
-          { }
-
-        // Returns the out ege list
-        edge_list&       out()       { return std::get<0>(data); }
-        const edge_list& out() const { return std::get<0>(data); }
-        
-        // Returns the in edge list
-        edge_list&       in()       { return std::get<1>(data); }
-        const edge_list& in() const { return std::get<1>(data); }
-
-        // Returns the user-supplied data object.
-        V&       value()       { return std::get<2>(data); }
-        const V& value() const { return std::get<2>(data); }
-
-        // Edge insertion
-        void insert_out(edge_handle e) { insert_edge(out(), e); }
-        void insert_in(edge_handle e) { insert_edge(in(), e); }
-
-        // Out edges
-        std::size_t out_degree() const { return out().size(); }
-
-        iterator begin_out() { return out().begin(); }
-        iterator end_out()   { return out().end(); }
-        const_iterator begin_out() const { return out().begin(); }
-        const_iterator end_out() const   { return out().end(); }
-
-        // In edges
-        std::size_t in_degree() const { return in().size(); }
-        
-        iterator begin_in() { return in().begin(); }
-        iterator end_in()   { return in().end(); }
-        const_iterator begin_in() const { return in().begin(); }
-        const_iterator end_in() const   { return in().end(); }
-
-
-        // Helper functions
-        void insert_edge(edge_list& l, edge_handle e);
-
-      public:
-        std::tuple<edge_list, edge_list, V> data;
-      };
+          void emplace_back(Args&&... args);
 
-    template<typename V>
-      inline void
-      vertex<V>::insert_edge(edge_list& l, edge_handle e)
-      {
-        l.push_back(e);
-      }
+        memory_footprint memory_usage() const
+        {
+          return lists_footprint(outs) + lists_footprint(ins)
+               + contiguous_footprint(values) + sorted_outs.memory_usage()
+               + sorted_ins.memory_usage();
+        }
 
-    // A vertex set simply a vector of vertices.
-    template<typename V>
-      using vertex_set = std::vector<vertex<V>>;
+        void shrink_to_fit()
+        {
+          shrink_lists(outs);
+          shrink_lists(ins);
+          values.shrink_to_fit();
+          sorted_outs.shrink_to_fit();
+          sorted_ins.shrink_to_fit();
+        }
+
+        rebind_vector<edge_list<A>, A> outs;   // Out edges of each vertex
+        rebind_vector<edge_list<A>, A> ins;    // In edges of each vertex
+        rebind_vector<V, A>            values; // Vertex values
+        bit_vector sorted_outs;                // Sorted out edge lists
+        bit_vector sorted_ins;                 // Sorted in edge lists
+      };
+
+    template<typename V, typename A>
+      template<typename... Args>
+        inline void
+        vertex_set<V, A>::emplace_back(Args&&... args)
+        {
+          outs.emplace_back(outs.get_allocator());
+          ins.emplace_back(ins.get_allocator());
+          values.emplace_back(std::forward<Args>(args)...);
+          sorted_outs.push_back(true);
+          sorted_ins.push_back(true);
+        }
 
     // An alias for the vertex iterator.
     template<typename V>
@@ -262,20 +526,24 @@ namespace origin
 
 
   // Implementation of a diretected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  //
+  // The allocator A allocates the vertex and edge arrays and the edge lists
+  // of each vertex; it is rebound for each of them.
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename A = std::allocator<char>>
     class directed_adjacency_vector
     {
-      using this_type = directed_adjacency_vector<V, E>;
+      static_assert(Allocator<A>(), "");
+
+      using this_type = directed_adjacency_vector<V, E, A>;
 
-      using vertex_node = directed_adjacency_vector_impl::vertex<V>;
-      using vertex_set = directed_adjacency_vector_impl::vertex_set<V>;
+      using vertex_set = directed_adjacency_vector_impl::vertex_set<V, A>;
       using vertex_iter = directed_adjacency_vector_impl::vertex_iterator<V>;
 
-      using edge_node = adjacency_vector_impl::edge<E>;
-      using edge_set = adjacency_vector_impl::edge_set<E>;
+      using edge_set = adjacency_vector_impl::edge_set<E, A>;
       using edge_iter = adjacency_vector_impl::edge_iterator<E>;
 
-      using incidence_iter = adjacency_vector_impl::incidence_iterator;
     public:
       using vertex = vertex_handle;
       using vertex_range = directed_adjacency_vector_impl::vertex_range<V>;
@@ -283,7 +551,18 @@ namespace origin
       using edge = edge_handle;
       using edge_range = adjacency_vector_impl::edge_range<E>;
 
-      using incidence_range = adjacency_vector_impl::incidence_range;
+      using incidence_range = adjacency_vector_impl::incidence_range<A>;
+
+
+      directed_adjacency_vector() = default;
+
+      // Construct an empty graph whose storage is allocated by a.
+      explicit directed_adjacency_vector(const A& a)
+        : verts_(a), edges_(a)
+      { }
+
+      // Returns the allocator of the graph.
+      A get_allocator() const { return A(edges_.values.get_allocator()); }
 
 
       // Observers
@@ -294,24 +573,27 @@ namespace origin
       std::size_t size() const  { return edges_.size(); }
 
       // Vertex observers
-      std::size_t out_degree(vertex v) const { return node(v).out_degree(); }
-      std::size_t in_degree(vertex v) const  { return node(v).in_degree(); }
+      std::size_t out_degree(vertex v) const { return outs(v).size(); }
+      std::size_t in_degree(vertex v) const  { return ins(v).size(); }
       std::size_t degree(vertex v) const { return out_degree(v) + in_degree(v); }
 
       // Edge observers
-      vertex source(edge e) const { return get_edge(e).source(); }
-      vertex target(edge e) const { return get_edge(e).target(); }
+      vertex source(edge e) const { return edges_.sources[e]; }
+      vertex target(edge e) const { return edges_.targets[e]; }
 
       // Data access
-      V&       operator()(vertex v)       { return node(v).value(); }
-      const V& operator()(vertex v) const { return node(v).value(); }
+      V&       operator()(vertex v)       { return verts_.values[v]; }
+      const V& operator()(vertex v) const { return verts_.values[v]; }
 
-      E&       operator()(edge e)       { return get_edge(e).value(); }
-      const E& operator()(edge e) const { return get_edge(e).value(); }
+      E&       operator()(edge e)       { return edges_.values[e]; }
+      const E& operator()(edge e) const { return edges_.values[e]; }
 
       // Edge relation
       edge operator()(vertex u, vertex v) const;
 
+      // Capacity
+      void reserve(std::size_t n, std::size_t m);
+
       // Vertex set
       vertex add_vertex();
       vertex add_vertex(V&& x);
@@ -328,6 +610,37 @@ namespace origin
       template<typename... Args>
         edge emplace_edge(vertex u, vertex v, Args&&...);
 
+      template<typename R>
+        void add_edges(R&& r);
+
+      edge add_unique_edge(vertex u, vertex v);
+
+      // Memory usage
+      memory_footprint memory_usage() const
+      {
+        return verts_.memory_usage() + edges_.memory_usage()
+             + filter_.memory_usage();
+      }
+
+      void shrink_to_fit()
+      {
+        verts_.shrink_to_fit();
+        edges_.shrink_to_fit();
+      }
+
+      // Edge filter
+      void enable_edge_filter()        { filter_.enable(*this); }
+      void disable_edge_filter()       { filter_.disable(); }
+      bool edge_filter_enabled() const { return filter_.enabled(); }
+
+      // Sorted edge lists
+      void enable_sorted_edges();
+      void disable_sorted_edges()       { sorted_ = false; }
+      bool sorted_edges_enabled() const { return sorted_; }
+
+      bool out_edges_sorted(vertex v) const { return verts_.sorted_outs[v]; }
+      bool in_edges_sorted(vertex v) const  { return verts_.sorted_ins[v]; }
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -335,11 +648,13 @@ namespace origin
       incidence_range in_edges(vertex v) const;
 
     private:
-      vertex_node&       node(vertex v)       { return verts_[v]; }
-      const vertex_node& node(vertex v) const { return verts_[v]; }
+      using edge_list = adjacency_vector_impl::edge_list<A>;
 
-      edge_node&       get_edge(edge e)       { return edges_[e]; }
-      const edge_node& get_edge(edge e) const { return edges_[e]; }
+      edge_list&       outs(vertex v)       { return verts_.outs[v]; }
+      const edge_list& outs(vertex v) const { return verts_.outs[v]; }
+
+      edge_list&       ins(vertex v)       { return verts_.ins[v]; }
+      const edge_list& ins(vertex v) const { return verts_.ins[v]; }
 
       // Helper functions for finding, connecting, disconnecting edges.
       edge find_out_edge(vertex u, vertex v) const;
@@ -350,43 +665,59 @@ namespace origin
 
       void link_edge(vertex u, vertex v, edge e);
 
+      void sort_lists(vertex v);
+
     private:
       vertex_set verts_;
       edge_set   edges_;
+      graph_impl::vector_edge_filter<true> filter_;
+      bool sorted_ = false;
     };
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::operator()(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, A>::
+      operator()(vertex u, vertex v) const -> edge
     {
+      if (!filter_.may_contain(u, v))
+        return edge();
       if (out_degree(u) <= in_degree(v))
         return find_out_edge(u, v);
       else
         return find_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::find_out_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, A>::
+      find_out_edge(vertex u, vertex v) const -> edge
     {
+      if (out_edges_sorted(u))
+        return adjacency_vector_impl::find_sorted(outs(u), v, [this](edge e) {
+          return target(e);
+        });
       using P = has_target<this_type>;
-      const vertex_node& n = node(u);
-      return find_edge(n.out(), P(*this, v));
+      return find_edge(outs(u), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::find_in_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, A>::
+      find_in_edge(vertex u, vertex v) const -> edge
     {
+      if (in_edges_sorted(v))
+        return adjacency_vector_impl::find_sorted(ins(v), u, [this](edge e) {
+          return source(e);
+        });
       using P = has_source<this_type>;
-      const vertex_node& n = node(v);
-      return find_edge(n.in(), P(*this, u));
+      return find_edge(ins(v), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     template<typename S, typename P>
     inline auto
-    directed_adjacency_vector<V, E>::find_edge(const S& seq, P pred) const -> edge
+    directed_adjacency_vector<V, E, A>::
+      find_edge(const S& seq, P pred) const -> edge
     {
       auto i = find_if(seq, pred);
       return i == seq.end() ? edge() : *i;
@@ -394,31 +725,32 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex() -> vertex
+    directed_adjacency_vector<V, E, A>::add_vertex() -> vertex
     {
       return emplace_vertex();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex(V&& x) -> vertex
+    directed_adjacency_vector<V, E, A>::add_vertex(V&& x) -> vertex
     {
       return emplace_vertex(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex(const V& x) -> vertex
+    directed_adjacency_vector<V, E, A>::add_vertex(const V& x) -> vertex
     {
       return emplace_vertex(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     template<typename... Args>
       inline auto
-      directed_adjacency_vector<V, E>::emplace_vertex(Args&&... args) -> vertex
+      directed_adjacency_vector<V, E, A>::
+        emplace_vertex(Args&&... args) -> vertex
       {
         vertex n = verts_.size();
         verts_.emplace_back(std::forward<Args>(args)...);
@@ -427,34 +759,35 @@ namespace origin
 
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::add_edge(vertex u, vertex v) -> edge
+    directed_adjacency_vector<V, E, A>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    directed_adjacency_vector<V, E, A>::
+      add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::
+    directed_adjacency_vector<V, E, A>::
       add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     template<typename... Args>
       inline auto
-      directed_adjacency_vector<V, E>::
+      directed_adjacency_vector<V, E, A>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.size();
@@ -463,48 +796,144 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline void
-    directed_adjacency_vector<V, E>::link_edge(vertex u, vertex v, edge e)
+    directed_adjacency_vector<V, E, A>::link_edge(vertex u, vertex v, edge e)
+    {
+      using namespace adjacency_vector_impl;
+      insert_sorted(outs(u), verts_.sorted_outs, u, v, e, sorted_,
+                    [this](edge x) { return target(x); });
+      insert_sorted(ins(v), verts_.sorted_ins, v, u, e, sorted_,
+                    [this](edge x) { return source(x); });
+      filter_.insert(u, v);
+      if (filter_.stale())
+        filter_.enable(*this);
+    }
+
+  // Reserve capacity for n vertices and m edges, so that adding them does
+  // not grow the vertex and edge arrays.
+  template<typename V, typename E, typename A>
+    void
+    directed_adjacency_vector<V, E, A>::reserve(std::size_t n,
+                                                std::size_t m)
+    {
+      verts_.outs.reserve(n);
+      verts_.ins.reserve(n);
+      verts_.values.reserve(n);
+      edges_.reserve(m);
+    }
+
+  // Add each edge described by the range r to the graph (see [graph.bulk]).
+  // The out and in edge lists of each vertex are grown at most once. When
+  // sorting is enabled, the edges are appended, and each list that receives
+  // edges out of order is sorted once at the end.
+  template<typename V, typename E, typename A>
+    template<typename R>
+      void
+      directed_adjacency_vector<V, E, A>::add_edges(R&& r)
+      {
+        std::vector<std::size_t> nout;
+        std::vector<std::size_t> nin;
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          graph_impl::count_incident(nout, std::get<0>(x));
+          graph_impl::count_incident(nin, std::get<1>(x));
+          ++m;
+        }
+
+        edges_.reserve(size() + m);
+        for (std::size_t v = 0; v != nout.size(); ++v)
+          if (nout[v])
+            outs(v).reserve(out_degree(v) + nout[v]);
+        for (std::size_t v = 0; v != nin.size(); ++v)
+          if (nin[v])
+            ins(v).reserve(in_degree(v) + nin[v]);
+
+        bool sorted = sorted_;
+        sorted_ = false;
+        for (auto&& x : r)
+          graph_impl::add_described_edge(
+            *this, graph_impl::forward_element<R>(x));
+        sorted_ = sorted;
+        if (sorted)
+          for (std::size_t v = 0; v != std::max(nout.size(), nin.size()); ++v)
+            sort_lists(v);
+      }
+
+  // Sort the edge lists of every vertex, and keep them sorted as edges are
+  // added.
+  template<typename V, typename E, typename A>
+    void
+    directed_adjacency_vector<V, E, A>::enable_sorted_edges()
+    {
+      for (vertex v : vertices())
+        sort_lists(v);
+      sorted_ = true;
+    }
+
+  // Sort the out and in edge lists of v, unless they are already sorted.
+  template<typename V, typename E, typename A>
+    void
+    directed_adjacency_vector<V, E, A>::sort_lists(vertex v)
+    {
+      using namespace adjacency_vector_impl;
+      if (!out_edges_sorted(v)) {
+        sort_list(outs(v), [this](edge x) { return target(x); });
+        verts_.sorted_outs.set(v);
+      }
+      if (!in_edges_sorted(v)) {
+        sort_list(ins(v), [this](edge x) { return source(x); });
+        verts_.sorted_ins.set(v);
+      }
+    }
+
+  // Returns the first edge connecting u to v, adding one if there is none.
+  // With an edge filter, most new edges are added without a search (see
+  // [graph.filter]).
+  template<typename V, typename E, typename A>
+    inline auto
+    directed_adjacency_vector<V, E, A>::
+      add_unique_edge(vertex u, vertex v) -> edge
     {
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      un.insert_out(e);
-      vn.insert_in(e);
+      if (edge e = (*this)(u, v))
+        return e;
+      return add_edge(u, v);
     }
 
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::vertices() const -> vertex_range
+    directed_adjacency_vector<V, E, A>::vertices() const -> vertex_range
     {
-      return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
+      return {vertex_iter(0), vertex_iter(order())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::edges() const -> edge_range
+    directed_adjacency_vector<V, E, A>::edges() const -> edge_range
     {
-      return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
+      return {edge_iter(0), edge_iter(size())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::out_edges(vertex v) const -> incidence_range
+    directed_adjacency_vector<V, E, A>::
+      out_edges(vertex v) const -> incidence_range
     {
-      const vertex_node& vn = node(v);
-      return {incidence_iter(vn.begin_out()), incidence_iter(vn.end_out())};
+      const edge_list& l = outs(v);
+      return {l.begin(), l.end()};
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    directed_adjacency_vector<V, E>::in_edges(vertex v) const -> incidence_range
+    directed_adjacency_vector<V, E, A>::
+      in_edges(vertex v) const -> incidence_range
     {
-      const vertex_node& vn = node(v);
-      return {incidence_iter(vn.begin_in()), incidence_iter(vn.end_in())};
+      const edge_list& l = ins(v);
+      return {l.begin(), l.end()};
     }
 
 
@@ -519,64 +948,66 @@ namespace origin
   {
     using origin::adjacency_vector_impl::handle_counter;
     using origin::adjacency_vector_impl::edge_list;
+    using origin::adjacency_vector_impl::rebind_vector;
+    using origin::adjacency_vector_impl::lists_footprint;
+    using origin::adjacency_vector_impl::shrink_lists;
 
     // ---------------------------------------------------------------------- //
     //                        Vertex Representation
-    
-    // A vertex in an undirected adjacency list is simply a list of incident
-    // edges. No distinction is made between in or out edges.
-    template<typename V>
-      struct vertex
-      {
-        using value_type = V;
-        using iterator = typename edge_list::iterator;
-        using const_iterator = typename edge_list::const_iterator;
-    
-        vertex()
-          : data()
+
+    // The vertex set is stored as a structure of arrays. The incident edges
+    // of each vertex are kept apart from the user data; no distinction is
+    // made between in and out edges.
+    //
+    // The arrays, and the edge list of each vertex, are allocated by the
+    // allocator A of the graph. The sorted flags of the lists (see
+    // [graph.adj_vec.sorted]) are kept in a bit vector.
+    template<typename V, typename A = std::allocator<char>>
+      struct vertex_set
+      {
+        vertex_set() = default;
+
+        explicit vertex_set(const A& a)
+          : edges(a), values(a)
         { }
 
+        bool        empty() const { return values.empty(); }
+        std::size_t size() const  { return values.size(); }
+
         template<typename... Args>
-          vertex(Args&&... args) 
-            : data(edge_list{}, std::forward<Args>(args)...)
-          { }
-
-        // Returns the out ege list
-        edge_list&       edges()       { return std::get<0>(data); }
-        const edge_list& edges() const { return std::get<0>(data); }
-        
-        // Returns the user-supplied data object.
-        V&       value()       { return std::get<1>(data); }
-        const V& value() const { return std::get<1>(data); }
-
-        // Out edges
-        std::size_t degree() const { return edges().size(); }
-
-        void insert(edge_handle e);
-
-        iterator begin() { return edges().begin(); }
-        iterator end()   { return edges().end(); }
-        const_iterator begin() const { return edges().begin(); }
-        const_iterator end() const   { return edges().end(); }
-
-      public:
-        std::tuple<edge_list, V> data;
-      };
+          void emplace_back(Args&&... args);
 
-    template<typename V>
-      inline void
-      vertex<V>::insert(edge_handle e)
-      {
-        edges().push_back(e);
-      }
+        memory_footprint memory_usage() const
+        {
+          return lists_footprint(edges) + contiguous_footprint(values)
+               + sorted.memory_usage();
+        }
 
-    // A vertex set is a vector of vertices.
-    template<typename V>
-      using vertex_set = std::vector<vertex<V>>;
+        void shrink_to_fit()
+        {
+          shrink_lists(edges);
+          values.shrink_to_fit();
+          sorted.shrink_to_fit();
+        }
+
+        rebind_vector<edge_list<A>, A> edges;  // Incident edges of each vertex
+        rebind_vector<V, A>            values; // Vertex values
+        bit_vector sorted;                     // Sorted edge lists
+      };
+
+    template<typename V, typename A>
+      template<typename... Args>
+        inline void
+        vertex_set<V, A>::emplace_back(Args&&... args)
+        {
+          edges.emplace_back(edges.get_allocator());
+          values.emplace_back(std::forward<Args>(args)...);
+          sorted.push_back(true);
+        }
 
     // An alias for the vertex iterator.
     template<typename V>
-      using vertex_iterator = handle_counter<vertex_set<V>, vertex_handle>;
+      using vertex_iterator = handle_counter<std::size_t, vertex_handle>;
 
     // An alias for the vertex range.
     template<typename V>
@@ -586,20 +1017,24 @@ namespace origin
 
 
   // Implementation of the undirected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  //
+  // The allocator A allocates the vertex and edge arrays and the edge lists
+  // of each vertex; it is rebound for each of them.
+  template<typename V = empty_t,
+           typename E = empty_t,
+           typename A = std::allocator<char>>
     class undirected_adjacency_vector
     {
-      using this_type = undirected_adjacency_vector<V, E>;
+      static_assert(Allocator<A>(), "");
 
-      using vertex_node = undirected_adjacency_vector_impl::vertex<V>;
-      using vertex_set = undirected_adjacency_vector_impl::vertex_set<V>;
+      using this_type = undirected_adjacency_vector<V, E, A>;
+
+      using vertex_set = undirected_adjacency_vector_impl::vertex_set<V, A>;
       using vertex_iter = undirected_adjacency_vector_impl::vertex_iterator<V>;
 
-      using edge_node = adjacency_vector_impl::edge<E>;
-      using edge_set = adjacency_vector_impl::edge_set<E>;
+      using edge_set = adjacency_vector_impl::edge_set<E, A>;
       using edge_iter = adjacency_vector_impl::edge_iterator<E>;
 
-      using incidence_iter = adjacency_vector_impl::incidence_iterator;
     public:
       using vertex = vertex_handle;
       using vertex_range = undirected_adjacency_vector_impl::vertex_range<V>;
@@ -607,7 +1042,18 @@ namespace origin
       using edge = edge_handle;
       using edge_range = adjacency_vector_impl::edge_range<E>;
 
-      using incidence_range = adjacency_vector_impl::incidence_range;
+      using incidence_range = adjacency_vector_impl::incidence_range<A>;
+
+
+      undirected_adjacency_vector() = default;
+
+      // Construct an empty graph whose storage is allocated by a.
+      explicit undirected_adjacency_vector(const A& a)
+        : verts_(a), edges_(a)
+      { }
+
+      // Returns the allocator of the graph.
+      A get_allocator() const { return A(edges_.values.get_allocator()); }
 
 
       // Observers
@@ -618,26 +1064,29 @@ namespace origin
       std::size_t size() const  { return edges_.size(); }
 
       // Vertex observers
-      std::size_t degree(vertex v) const { return node(v).degree(); }
+      std::size_t degree(vertex v) const { return incs(v).size(); }
 
       // Edge observers
       
       // Returns the first and second endpoints of the edge, e. If e was added
       // using g.add_edge(u, v), u is the source and v is the target. There
       // is no special meaning attributed to the order.
-      vertex source(edge e) const { return get_edge(e).source(); }
-      vertex target(edge e) const { return get_edge(e).target(); }
+      vertex source(edge e) const { return edges_.sources[e]; }
+      vertex target(edge e) const { return edges_.targets[e]; }
 
       // Data access
-      V&       operator()(vertex v)       { return node(v).value(); }
-      const V& operator()(vertex v) const { return node(v).value(); }
+      V&       operator()(vertex v)       { return verts_.values[v]; }
+      const V& operator()(vertex v) const { return verts_.values[v]; }
 
-      E&       operator()(edge e)       { return get_edge(e).value(); }
-      const E& operator()(edge e) const { return get_edge(e).value(); }
+      E&       operator()(edge e)       { return edges_.values[e]; }
+      const E& operator()(edge e) const { return edges_.values[e]; }
 
       // Relation
       edge operator()(vertex u, vertex v) const;
 
+      // Capacity
+      void reserve(std::size_t n, std::size_t m);
+
       // Vertex set
       vertex add_vertex();
       vertex add_vertex(V&& x);
@@ -654,17 +1103,46 @@ namespace origin
       template<typename... Args>
         edge emplace_edge(vertex u, vertex v, Args&&... args);
 
+      template<typename R>
+        void add_edges(R&& r);
+
+      edge add_unique_edge(vertex u, vertex v);
+
+      // Memory usage
+      memory_footprint memory_usage() const
+      {
+        return verts_.memory_usage() + edges_.memory_usage()
+             + filter_.memory_usage();
+      }
+
+      void shrink_to_fit()
+      {
+        verts_.shrink_to_fit();
+        edges_.shrink_to_fit();
+      }
+
+      // Edge filter
+      void enable_edge_filter()        { filter_.enable(*this); }
+      void disable_edge_filter()       { filter_.disable(); }
+      bool edge_filter_enabled() const { return filter_.enabled(); }
+
+      // Sorted edge lists
+      void enable_sorted_edges();
+      void disable_sorted_edges()       { sorted_ = false; }
+      bool sorted_edges_enabled() const { return sorted_; }
+
+      bool edges_sorted(vertex v) const { return verts_.sorted[v]; }
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
       incidence_range edges(vertex v) const;
 
     private:
-      vertex_node&       node(vertex v)       { return verts_[v]; }
-      const vertex_node& node(vertex v) const { return verts_[v]; }
+      using edge_list = adjacency_vector_impl::edge_list<A>;
 
-      edge_node&       get_edge(edge e)       { return edges_[e]; }
-      const edge_node& get_edge(edge e) const { return edges_[e]; }
+      edge_list&       incs(vertex v)       { return verts_.edges[v]; }
+      const edge_list& incs(vertex v) const { return verts_.edges[v]; }
 
       // Helper functions
       edge find_edge(vertex u, vertex v) const;
@@ -673,17 +1151,30 @@ namespace origin
         edge find_endpoints(const S& seq, P pred) const;
 
       void link_edge(vertex u, vertex v, edge e);
-    
+
+      void sort_list(vertex v);
+
+      // Returns the endpoint of e opposite v.
+      vertex other(edge e, vertex v) const
+      {
+        return source(e) == v ? target(e) : source(e);
+      }
+
     private:
       vertex_set verts_;
       edge_set   edges_;
+      graph_impl::vector_edge_filter<false> filter_;
+      bool sorted_ = false;
     };
 
   // Returns true if the an edge {u, v} is in the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::operator()(vertex u, vertex v) const -> edge
+    undirected_adjacency_vector<V, E, A>::
+      operator()(vertex u, vertex v) const -> edge
     {
+      if (!filter_.may_contain(u, v))
+        return edge();
       if (degree(u) <= degree(v))
         return find_edge(u, v);
       else
@@ -696,21 +1187,25 @@ namespace origin
   // Note that, if u and v are connected, then the edge was added as either
   // (u, v) or (v, u). We prefer to search the vertex with the smaller degree
   // for evidence of either construction.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::find_edge(vertex u, vertex v) const -> edge
+    undirected_adjacency_vector<V, E, A>::
+      find_edge(vertex u, vertex v) const -> edge
     {
+      if (edges_sorted(v))
+        return adjacency_vector_impl::find_sorted(incs(v), u, [&](edge e) {
+          return other(e, v);
+        });
       using P = has_endpoints<this_type>;
-      const vertex_node& n = node(v);
-      return find_endpoints(n.edges(), P(*this, u, v));
+      return find_endpoints(incs(v), P(*this, u, v));
     }
 
   // Return an edge whose endpoints satisfy the given predicate. The primary
   // function of this operation is to find endpoints with source/target pairs.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     template<typename S, typename P>
       inline auto
-      undirected_adjacency_vector<V, E>::
+      undirected_adjacency_vector<V, E, A>::
         find_endpoints(const S& seq, P pred) const -> edge
         {
           auto i = find_if(seq, pred);
@@ -720,31 +1215,32 @@ namespace origin
 
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex() -> vertex
+    undirected_adjacency_vector<V, E, A>::add_vertex() -> vertex
     {
       return emplace_vertex();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex(V&& x) -> vertex
+    undirected_adjacency_vector<V, E, A>::add_vertex(V&& x) -> vertex
     {
       return emplace_vertex(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex(const V& x) -> vertex
+    undirected_adjacency_vector<V, E, A>::add_vertex(const V& x) -> vertex
     {
       return emplace_vertex(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     template<typename... Args>
       inline auto
-      undirected_adjacency_vector<V, E>::emplace_vertex(Args&&... args) -> vertex
+      undirected_adjacency_vector<V, E, A>::
+        emplace_vertex(Args&&... args) -> vertex
       {
         vertex v = verts_.size();
         verts_.emplace_back(std::forward<Args>(args)...);
@@ -752,33 +1248,35 @@ namespace origin
       }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v) -> edge
+    undirected_adjacency_vector<V, E, A>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    undirected_adjacency_vector<V, E, A>::
+      add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    undirected_adjacency_vector<V, E, A>::
+      add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     template<typename... Args>
       inline auto
-      undirected_adjacency_vector<V, E>::
+      undirected_adjacency_vector<V, E, A>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.size();
@@ -787,39 +1285,126 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline void
-    undirected_adjacency_vector<V, E>::link_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_vector<V, E, A>::link_edge(vertex u, vertex v, edge e)
+    {
+      using namespace adjacency_vector_impl;
+      insert_sorted(incs(u), verts_.sorted, u, v, e, sorted_,
+                    [&](edge x) { return other(x, u); });
+      insert_sorted(incs(v), verts_.sorted, v, u, e, sorted_,
+                    [&](edge x) { return other(x, v); });
+      filter_.insert(u, v);
+      if (filter_.stale())
+        filter_.enable(*this);
+    }
+
+  // Reserve capacity for n vertices and m edges, so that adding them does
+  // not grow the vertex and edge arrays.
+  template<typename V, typename E, typename A>
+    void
+    undirected_adjacency_vector<V, E, A>::reserve(std::size_t n,
+                                                  std::size_t m)
+    {
+      verts_.edges.reserve(n);
+      verts_.values.reserve(n);
+      edges_.reserve(m);
+    }
+
+  // Add each edge described by the range r to the graph (see [graph.bulk]).
+  // The incident edge list of each vertex is grown at most once. When
+  // sorting is enabled, the edges are appended, and each list that receives
+  // edges out of order is sorted once at the end.
+  template<typename V, typename E, typename A>
+    template<typename R>
+      void
+      undirected_adjacency_vector<V, E, A>::add_edges(R&& r)
+      {
+        std::vector<std::size_t> counts;
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          graph_impl::count_incident(counts, std::get<0>(x));
+          graph_impl::count_incident(counts, std::get<1>(x));
+          ++m;
+        }
+
+        edges_.reserve(size() + m);
+        for (std::size_t v = 0; v != counts.size(); ++v)
+          if (counts[v])
+            incs(v).reserve(degree(v) + counts[v]);
+
+        bool sorted = sorted_;
+        sorted_ = false;
+        for (auto&& x : r)
+          graph_impl::add_described_edge(
+            *this, graph_impl::forward_element<R>(x));
+        sorted_ = sorted;
+        if (sorted)
+          for (std::size_t v = 0; v != counts.size(); ++v)
+            sort_list(v);
+      }
+
+  // Sort the edge list of every vertex, and keep them sorted as edges are
+  // added.
+  template<typename V, typename E, typename A>
+    void
+    undirected_adjacency_vector<V, E, A>::enable_sorted_edges()
     {
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      un.insert(e);
-      vn.insert(e);
+      for (vertex v : vertices())
+        sort_list(v);
+      sorted_ = true;
+    }
+
+  // Sort the edge list of v, unless it is already sorted.
+  template<typename V, typename E, typename A>
+    void
+    undirected_adjacency_vector<V, E, A>::sort_list(vertex v)
+    {
+      if (!edges_sorted(v)) {
+        adjacency_vector_impl::sort_list(incs(v), [&](edge x) {
+          return other(x, v);
+        });
+        verts_.sorted.set(v);
+      }
+    }
+
+  // Returns the first edge connecting u to v, adding one if there is none.
+  // With an edge filter, most new edges are added without a search (see
+  // [graph.filter]).
+  template<typename V, typename E, typename A>
+    inline auto
+    undirected_adjacency_vector<V, E, A>::
+      add_unique_edge(vertex u, vertex v) -> edge
+    {
+      if (edge e = (*this)(u, v))
+        return e;
+      return add_edge(u, v);
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::vertices() const -> vertex_range
+    undirected_adjacency_vector<V, E, A>::vertices() const -> vertex_range
     {
-      return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
+      return {vertex_iter(0), vertex_iter(order())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::edges() const -> edge_range
+    undirected_adjacency_vector<V, E, A>::edges() const -> edge_range
     {
-      return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
+      return {edge_iter(0), edge_iter(size())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename A>
     inline auto
-    undirected_adjacency_vector<V, E>::edges(vertex v) const -> incidence_range
+    undirected_adjacency_vector<V, E, A>::
+      edges(vertex v) const -> incidence_range
     {
-      const vertex_node& vn = node(v);
-      return {incidence_iter(vn.begin()), incidence_iter(vn.end())};
+      const edge_list& l = incs(v);
+      return {l.begin(), l.end()};
     }
 
 } // namespace origin
@@ -6,8 +6,15 @@
 // and conditions.
 
 #include <cassert>
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <tuple>
+#include <vector>
 
+#include <origin/memory/allocator.hpp>
+#include <origin/memory/arena.hpp>
+#include <origin/memory/numa.hpp>
 #include <origin/graph/adjacency_vector.hpp>
 
 #include "../graph.test/testing.hpp"
@@ -16,15 +23,269 @@ using namespace std;
 using namespace origin;
 using namespace testing;
 
+// Check that the vertex and edge ranges enumerate every handle, and that
+// topology and values stay associated with the right handles.
+template<typename G>
+  void
+  check_ranges()
+  {
+    G g = build_reflexive_clique<G>(3);
+    size_t n = 0;
+    for (Vertex<G> v : g.vertices()) {
+      assert(size_t(v) == n);
+      assert(g(v) == char('a' + n));
+      ++n;
+    }
+    assert(n == g.order());
+
+    size_t m = 0;
+    for (Edge<G> e : g.edges()) {
+      assert(size_t(e) == m);
+      g(e) = int(m);
+      ++m;
+    }
+    assert(m == g.size());
+    for (Edge<G> e : g.edges())
+      assert(g(e) == int(e));
+
+    // Vertex and edge ranges are random access.
+    auto vs = g.vertices();
+    using I = decltype(vs.begin());
+    static_assert(Same<Iterator_category<I>, random_access_iterator_tag>(), "");
+    assert(origin::size(vs) == g.order());
+    assert(origin::size(g.edges()) == g.size());
+    assert(vs.begin()[2] == 2);
+    assert(*(vs.end() - 1) == 2);
+    assert(vs.end() - vs.begin() == 3);
+    assert(vs.begin() < vs.end());
+
+    // The ranges can be searched and split without enumerating handles.
+    auto es = g.edges();
+    auto mid = es.begin() + g.size() / 2;
+    assert(*lower_bound(es.begin(), es.end(), *mid) == *mid);
+    vector<size_t> sizes;
+    for (auto i = es.begin(); i < es.end(); i += 4)
+      sizes.push_back(min<ptrdiff_t>(4, es.end() - i));
+    assert(accumulate(sizes.begin(), sizes.end(), size_t(0)) == g.size());
+  }
+
+void
+check_directed_incidence()
+{
+  using D = directed_adjacency_vector<char, int>;
+  D g = build_reflexive_bidi_clique<D>(3);
+  for (Vertex<D> v : g.vertices()) {
+    for (Edge<D> e : g.out_edges(v))
+      assert(g.source(e) == v);
+    for (Edge<D> e : g.in_edges(v))
+      assert(g.target(e) == v);
+  }
+}
+
+void
+check_undirected_incidence()
+{
+  using G = undirected_adjacency_vector<char, int>;
+  G g = build_reflexive_clique<G>(3);
+  for (Vertex<G> v : g.vertices())
+    for (Edge<G> e : g.edges(v))
+      assert(g.source(e) == v || g.target(e) == v);
+}
+
+// A graph allocated in an arena stores its arrays and edge lists there.
+template<typename G>
+  void
+  check_arena()
+  {
+    arena a;
+    arena_allocator<char> alloc(a);
+    G g(alloc);
+    assert(&g.get_allocator().arena() == &a);
+    for (int i = 0; i != 1000; ++i)
+      g.add_vertex('a' + i % 26);
+    for (int i = 0; i != 5000; ++i)
+      g.add_edge(i % 1000, (i * 7) % 1000, i);
+    assert(g.order() == 1000 && g.size() == 5000);
+    assert(a.capacity() >= 5000 * (4 * sizeof(Edge<G>) + sizeof(int)));
+    assert(g(g(3, 21)) == 3);
+
+    G h = g;
+    assert(&h.get_allocator().arena() == &a);
+    assert(h(h(3, 21)) == 3);
+  }
+
+// The footprint of a graph counts its arrays and the edge lists that grow
+// out of their buffers.
+template<typename G>
+  void
+  check_memory_usage()
+  {
+    G g;
+    assert(g.memory_usage().reserved == 0);
+    for (int i = 0; i != 100; ++i)
+      g.add_vertex('a');
+    for (int i = 0; i != 1000; ++i)
+      g.add_edge(i % 100, (i * 7) % 100, i);
+    memory_footprint m = g.memory_usage();
+    assert(m.live >= 1000 * (2 * sizeof(Vertex<G>) + sizeof(int)));
+    assert(m.dead == 0 && m.reserved >= m.live);
+
+    g.shrink_to_fit();
+    memory_footprint n = g.memory_usage();
+    assert(n.live == m.live && n.slack() <= m.slack());
+    assert(g(g(3, 21)) == 3);
+  }
+
+// The edge filter admits every connected pair as edges are added and as
+// it is rebuilt, so that unique insertion adds an edge only for pairs that
+// are not connected.
+template<typename G>
+  void
+  check_edge_filter()
+  {
+    G g;
+    G h;
+    for (int i = 0; i != 100; ++i) {
+      g.add_vertex('a');
+      h.add_vertex('a');
+    }
+    g.enable_edge_filter();
+    assert(g.edge_filter_enabled());
+    for (int i = 0; i != 3000; ++i) {
+      Edge<G> e = g.add_unique_edge(i % 100, (i * 7) % 100);
+      Edge<G> f = h.add_unique_edge(i % 100, (i * 7) % 100);
+      assert(e == f);
+    }
+    assert(g.size() == h.size());
+    for (Vertex<G> u : g.vertices())
+      for (Vertex<G> v : g.vertices())
+        assert(g(u, v) == h(u, v));
+    assert(g.memory_usage().live > h.memory_usage().live);
+
+    g.disable_edge_filter();
+    assert(!g.edge_filter_enabled());
+    assert(g(g(3, 21)) == h(h(3, 21)));
+  }
+
+// Returns true if the edges in r are sorted by their endpoint opposite v,
+// and then by handle.
+template<typename G, typename R>
+  bool
+  sorted_by_opposite(const G& g, const R& r, Vertex<G> v)
+  {
+    return is_sorted(r.begin(), r.end(), [&](Edge<G> a, Edge<G> b) {
+      Vertex<G> x = opposite(g, a, v);
+      Vertex<G> y = opposite(g, b, v);
+      return x < y || (x == y && a < b);
+    });
+  }
+
+bool
+lists_sorted(const undirected_adjacency_vector<char, int>& g, vertex_handle v)
+{
+  return g.edges_sorted(v) && sorted_by_opposite(g, g.edges(v), v);
+}
+
+bool
+lists_sorted(const directed_adjacency_vector<char, int>& g, vertex_handle v)
+{
+  return g.out_edges_sorted(v) && g.in_edges_sorted(v)
+      && sorted_by_opposite(g, g.out_edges(v), v)
+      && sorted_by_opposite(g, g.in_edges(v), v);
+}
+
+// Sorted edge lists find the same edges as unsorted ones, including
+// multiple edges and loops, whether the edges are added one at a time or in
+// bulk.
+template<typename G>
+  void
+  check_sorted_edges()
+  {
+    G g;
+    G h;
+    for (int i = 0; i != 50; ++i) {
+      g.add_vertex('a');
+      h.add_vertex('a');
+    }
+    for (int i = 0; i != 500; ++i) {
+      g.add_edge((i * 13) % 50, (i * 29) % 47, i);
+      h.add_edge((i * 13) % 50, (i * 29) % 47, i);
+    }
+    assert(!g.sorted_edges_enabled());
+    g.enable_sorted_edges();
+    assert(g.sorted_edges_enabled());
+    for (int i = 0; i != 500; ++i) {
+      g.add_edge((i * 7) % 50, (i * 11) % 50, i);
+      h.add_edge((i * 7) % 50, (i * 11) % 50, i);
+    }
+    vector<tuple<size_t, size_t, int>> es;
+    for (int i = 0; i != 500; ++i)
+      es.emplace_back((i * 17) % 50, (50 - i % 50) % 50, i);
+    g.add_edges(es);
+    h.add_edges(es);
+
+    assert(g.size() == h.size());
+    for (Vertex<G> u : g.vertices()) {
+      assert(lists_sorted(g, u));
+      for (Vertex<G> v : g.vertices())
+        assert(g(u, v) == h(u, v));
+    }
+
+    // Once disabled, edges added out of order reset the flags, and lookups
+    // are still answered.
+    g.disable_sorted_edges();
+    g.add_edge(3, 0, 0);
+    h.add_edge(3, 0, 0);
+    assert(!lists_sorted(g, 3) && lists_sorted(g, 4));
+    assert(g(3, 0) == h(3, 0));
+    assert(g(g(3, 0)) == h(h(3, 0)));
+  }
+
 int main()
 {
   using G = undirected_adjacency_vector<char, int>;
   check_default_init<G>();
   check_add_vertices<G>();
   check_add_edges<G>();
+  check_add_edges_bulk<G>();
+  check_ranges<G>();
+  check_undirected_incidence();
 
   using D = directed_adjacency_vector<char, int>;
   check_default_init<D>();
   check_add_vertices<D>();
   check_add_edges<D>();
+  check_add_edges_bulk<D>();
+  check_ranges<D>();
+  check_directed_incidence();
+
+  check_memory_usage<G>();
+  check_memory_usage<D>();
+
+  check_edge_filter<G>();
+  check_edge_filter<D>();
+
+  check_sorted_edges<G>();
+  check_sorted_edges<D>();
+
+  // Graphs take an allocator, which is rebound for each of their arrays.
+  using AG = undirected_adjacency_vector<char, int, aligned_allocator<char>>;
+  using AD = directed_adjacency_vector<char, int, aligned_allocator<char>>;
+  check_add_edges<AG>();
+  check_add_edges_bulk<AD>();
+  check_ranges<AD>();
+  check_arena<undirected_adjacency_vector<char, int, arena_allocator<char>>>();
+  check_arena<directed_adjacency_vector<char, int, arena_allocator<char>>>();
+
+  // The arrays of a graph can be placed over the memory nodes.
+  using N = numa_allocator<char>;
+  using NG = directed_adjacency_vector<char, int, N>;
+  check_add_edges_bulk<NG>();
+  NG g(N::interleaved());
+  assert(g.get_allocator().policy() == numa_policy::interleave);
+  for (int i = 0; i != 100; ++i)
+    g.add_vertex('a' + i % 26);
+  for (int i = 0; i != 100; ++i)
+    g.add_edge(i, (i + 1) % 100, i);
+  assert(g.size() == 100 && g(g(99, 0)) == 99);
 }
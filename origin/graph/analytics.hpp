@@ -0,0 +1,385 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ANALYTICS_HPP
+#define ORIGIN_GRAPH_ANALYTICS_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+#include <origin/graph/ordering.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.analytics]
+  //                            Graph Analytics
+  //
+  // The following kernels measure the cohesion of a graph:
+  //
+  //    count_triangles(g[, threads])
+  //    core_numbers(g, cores[, threads])
+  //
+  // Both kernels consider the simple undirected graph underlying g: the
+  // direction of edges is ignored, and loops and parallel edges are
+  // discarded. They first build the sorted neighbor set of each vertex in
+  // parallel, using up to threads threads, so their memory use is
+  // proportional to the number of distinct adjacent pairs. Vertex indexes
+  // are stored in 32 bits when the vertex handles of g allow it.
+  //
+  // Triangles are counted by orienting each edge from the endpoint of lower
+  // degree to the endpoint of higher degree (ties broken by index), and
+  // intersecting the oriented neighbor sets of the endpoints of each edge,
+  // in parallel over the vertices. Orientation bounds the size of each
+  // oriented set by O(sqrt(m)). Sorted sets are intersected by merging, four
+  // elements at a time with SSE2 when it is available, or by binary search
+  // when one set is much smaller than the other.
+  //
+  // The core number of a vertex v is the largest k such that v belongs to a
+  // subgraph in which every vertex has degree at least k (the k-core). Core
+  // numbers are computed by the bucket-based peeling algorithm of Batagelj
+  // and Zaversnik, which repeatedly removes a vertex of least degree, in
+  // O(n + m) time after the neighbor sets are built.
+
+
+  namespace analytics_impl
+  {
+    // The number of vertices processed by each parallel task.
+    constexpr std::size_t grain = 1024;
+
+    // The largest vertex bound for which indexes are stored in 32 bits.
+    constexpr std::size_t narrow = std::numeric_limits<std::uint32_t>::max();
+
+    // The neighbor sets of a graph, in compressed sparse row form. The
+    // neighbors of v are [begin(v), end(v)), in increasing order.
+    template<typename T>
+      struct neighbor_sets
+      {
+        std::size_t order() const { return offsets.size() - 1; }
+
+        std::size_t degree(std::size_t v) const
+        {
+          return offsets[v + 1] - offsets[v];
+        }
+
+        const T* begin(std::size_t v) const
+        {
+          return targets.data() + offsets[v];
+        }
+
+        const T* end(std::size_t v) const
+        {
+          return targets.data() + offsets[v + 1];
+        }
+
+        std::vector<std::size_t> offsets;
+        std::vector<T> targets;
+      };
+
+    // Call f(k, first, last) for each block k of vertex indexes [first,
+    // last) in [0, n), using up to threads threads.
+    template<typename F>
+      void
+      for_blocks(std::size_t n, std::size_t threads, F f)
+      {
+        std::size_t blocks = (n + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          f(k, k * grain, std::min(n, (k + 1) * grain));
+        });
+      }
+
+    // Build the neighbor sets of the simple undirected graph underlying g.
+    // Each block of vertices collects its sets separately, and the blocks
+    // are then concatenated.
+    template<typename T, typename G>
+      neighbor_sets<T>
+      make_neighbor_sets(const G& g, std::size_t threads)
+      {
+        using V = Vertex<G>;
+        std::size_t n = search_impl::vertex_bound(g);
+        std::vector<char> present(n);
+        for (V v : g.vertices())
+          present[v] = true;
+
+        std::size_t blocks = (n + grain - 1) / grain;
+        std::vector<std::vector<T>> parts(blocks);
+        neighbor_sets<T> ns;
+        ns.offsets.assign(n + 1, 0);
+        auto collect = [&](std::size_t k, std::size_t f, std::size_t l) {
+          std::vector<T>& part = parts[k];
+          for (std::size_t v = f; v != l; ++v) {
+            if (!present[v])
+              continue;
+            std::size_t first = part.size();
+            ordering_impl::for_neighbors(g, V(v), [&](V u) {
+              if (u != v)
+                part.push_back(u);
+            });
+            auto i = part.begin() + first;
+            std::sort(i, part.end());
+            part.erase(std::unique(i, part.end()), part.end());
+            ns.offsets[v + 1] = part.size() - first;
+          }
+        };
+        for_blocks(n, threads, collect);
+
+        for (std::size_t v = 0; v != n; ++v)
+          ns.offsets[v + 1] += ns.offsets[v];
+        ns.targets.resize(ns.offsets[n]);
+        for_blocks(n, threads, [&](std::size_t k, std::size_t f, std::size_t) {
+          std::copy(parts[k].begin(), parts[k].end(),
+                    ns.targets.begin() + ns.offsets[f]);
+          std::vector<T>().swap(parts[k]);
+        });
+        return ns;
+      }
+
+    // Returns the neighbor sets of ns oriented from lower to higher degree:
+    // u is an oriented neighbor of v if (deg(v), v) < (deg(u), u).
+    template<typename T>
+      neighbor_sets<T>
+      orient(const neighbor_sets<T>& ns, std::size_t threads)
+      {
+        std::size_t n = ns.order();
+        auto above = [&ns](std::size_t v, std::size_t u) {
+          std::size_t dv = ns.degree(v);
+          std::size_t du = ns.degree(u);
+          return dv < du || (dv == du && v < u);
+        };
+
+        neighbor_sets<T> os;
+        os.offsets.assign(n + 1, 0);
+        for_blocks(n, threads, [&](std::size_t, std::size_t f, std::size_t l) {
+          for (std::size_t v = f; v != l; ++v)
+            for (const T* u = ns.begin(v); u != ns.end(v); ++u)
+              os.offsets[v + 1] += above(v, *u);
+        });
+        for (std::size_t v = 0; v != n; ++v)
+          os.offsets[v + 1] += os.offsets[v];
+        os.targets.resize(os.offsets[n]);
+        for_blocks(n, threads, [&](std::size_t, std::size_t f, std::size_t l) {
+          for (std::size_t v = f; v != l; ++v)
+            std::copy_if(ns.begin(v), ns.end(v),
+                         os.targets.begin() + os.offsets[v],
+                         [&](T u) { return above(v, u); });
+        });
+        return os;
+      }
+
+
+    // Returns the number of elements of [a, a + n) found in the sorted
+    // sequence [b, b + m), by binary search.
+    template<typename T>
+      std::size_t
+      search_count(const T* a, std::size_t n, const T* b, std::size_t m)
+      {
+        std::size_t c = 0;
+        const T* last = b + m;
+        for (std::size_t i = 0; i != n && b != last; ++i) {
+          b = std::lower_bound(b, last, a[i]);
+          if (b != last && *b == a[i])
+            ++c;
+        }
+        return c;
+      }
+
+    // Returns the size of the intersection of the strictly increasing
+    // sequences [a, a + n) and [b, b + m), by merging. The merge does not
+    // branch on the comparison of elements.
+    template<typename T>
+      std::size_t
+      merge_count(const T* a, std::size_t n, const T* b, std::size_t m)
+      {
+        std::size_t c = 0;
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i != n && j != m) {
+          T x = a[i];
+          T y = b[j];
+          c += x == y;
+          i += x <= y;
+          j += y <= x;
+        }
+        return c;
+      }
+
+#if defined(__SSE2__)
+    // Merge 32-bit sequences four elements at a time. Each block of a is
+    // compared with every rotation of a block of b, and the block with the
+    // lesser last element is advanced (both when they are equal). The
+    // remaining elements are merged one at a time.
+    inline std::size_t
+    merge_count(const std::uint32_t* a, std::size_t n,
+                const std::uint32_t* b, std::size_t m)
+    {
+      std::size_t c = 0;
+      std::size_t i = 0;
+      std::size_t j = 0;
+      while (i + 4 <= n && j + 4 <= m) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i eq = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi32(x, y),
+                       _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, 0x39))),
+          _mm_or_si128(_mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, 0x4e)),
+                       _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, 0x93))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        c += (mask & 1) + (mask >> 1 & 1) + (mask >> 2 & 1) + (mask >> 3 & 1);
+        std::uint32_t p = a[i + 3];
+        std::uint32_t q = b[j + 3];
+        i += p <= q ? 4 : 0;
+        j += q <= p ? 4 : 0;
+      }
+      return c + merge_count<std::uint32_t>(a + i, n - i, b + j, m - j);
+    }
+#endif
+
+    // Returns the size of the intersection of two strictly increasing
+    // sequences, choosing between merging and binary search.
+    template<typename T>
+      inline std::size_t
+      intersection_size(const T* a, std::size_t n, const T* b, std::size_t m)
+      {
+        if (m < n) {
+          std::swap(a, b);
+          std::swap(n, m);
+        }
+        if (n * 32 < m)
+          return search_count(a, n, b, m);
+        return merge_count(a, n, b, m);
+      }
+
+    template<typename T, typename G>
+      std::size_t
+      count_triangles(const G& g, std::size_t threads)
+      {
+        neighbor_sets<T> os = orient(make_neighbor_sets<T>(g, threads),
+                                     threads);
+        std::size_t n = os.order();
+        std::vector<std::size_t> counts((n + grain - 1) / grain);
+        auto count = [&](std::size_t k, std::size_t f, std::size_t l) {
+          std::size_t c = 0;
+          for (std::size_t v = f; v != l; ++v)
+            for (const T* u = os.begin(v); u != os.end(v); ++u)
+              c += intersection_size(os.begin(v), os.degree(v),
+                                     os.begin(*u), os.degree(*u));
+          counts[k] = c;
+        };
+        for_blocks(n, threads, count);
+        std::size_t c = 0;
+        for (std::size_t x : counts)
+          c += x;
+        return c;
+      }
+
+    template<typename T, typename G>
+      std::size_t
+      core_numbers(const G& g, std::vector<std::size_t>& cores,
+                   std::size_t threads)
+      {
+        neighbor_sets<T> ns = make_neighbor_sets<T>(g, threads);
+        std::size_t n = ns.order();
+
+        // Sort the vertices by degree, recording the start of each bin.
+        std::vector<std::size_t> deg(n);
+        std::size_t max = 0;
+        for (std::size_t v = 0; v != n; ++v)
+          max = std::max(max, deg[v] = ns.degree(v));
+        std::vector<std::size_t> bins(max + 2);
+        for (std::size_t v = 0; v != n; ++v)
+          ++bins[deg[v] + 1];
+        for (std::size_t d = 1; d != bins.size(); ++d)
+          bins[d] += bins[d - 1];
+        std::vector<std::size_t> pos(n);
+        std::vector<std::size_t> verts(n);
+        {
+          std::vector<std::size_t> next(bins.begin(), bins.end() - 1);
+          for (std::size_t v = 0; v != n; ++v) {
+            pos[v] = next[deg[v]]++;
+            verts[pos[v]] = v;
+          }
+        }
+
+        // Peel the vertex of least degree, moving each neighbor of greater
+        // degree to the front of its bin and then into the bin below.
+        for (std::size_t i = 0; i != n; ++i) {
+          std::size_t v = verts[i];
+          for (const T* p = ns.begin(v); p != ns.end(v); ++p) {
+            std::size_t u = *p;
+            if (deg[u] > deg[v]) {
+              std::size_t du = deg[u];
+              std::size_t pu = pos[u];
+              std::size_t pw = bins[du];
+              std::size_t w = verts[pw];
+              if (u != w) {
+                pos[u] = pw;
+                verts[pu] = w;
+                pos[w] = pu;
+                verts[pw] = u;
+              }
+              ++bins[du];
+              --deg[u];
+            }
+          }
+        }
+
+        cores.assign(n, -1);
+        std::size_t k = 0;
+        for (Vertex<G> v : g.vertices()) {
+          cores[v] = deg[v];
+          k = std::max(k, deg[v]);
+        }
+        return k;
+      }
+
+  } // namespace analytics_impl
+
+
+  // Returns the number of triangles in the simple undirected graph
+  // underlying g.
+  template<typename G>
+    std::size_t
+    count_triangles(const G& g, std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using analytics_impl::narrow;
+      if (search_impl::vertex_bound(g) <= narrow)
+        return analytics_impl::count_triangles<std::uint32_t>(g, threads);
+      else
+        return analytics_impl::count_triangles<std::size_t>(g, threads);
+    }
+
+  // Compute the core number of each vertex in the simple undirected graph
+  // underlying g, writing them to cores, indexed by vertex handle. Returns
+  // the largest core number (the degeneracy of g). The entries of cores for
+  // handles that do not refer to vertices are size_t(-1).
+  template<typename G>
+    std::size_t
+    core_numbers(const G& g,
+                 std::vector<std::size_t>& cores,
+                 std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using analytics_impl::narrow;
+      if (search_impl::vertex_bound(g) <= narrow)
+        return analytics_impl::core_numbers<std::uint32_t>(g, cores, threads);
+      else
+        return analytics_impl::core_numbers<std::size_t>(g, cores, threads);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,165 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include <origin/graph/analytics.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the adjacency sets of the simple undirected graph underlying g.
+template<typename G>
+  vector<set<size_t>>
+  simple_graph(const G& g)
+  {
+    vector<set<size_t>> adj(search_impl::vertex_bound(g));
+    for (Edge<G> e : g.edges()) {
+      size_t u = g.source(e), v = g.target(e);
+      if (u != v) {
+        adj[u].insert(v);
+        adj[v].insert(u);
+      }
+    }
+    return adj;
+  }
+
+size_t
+brute_triangles(const vector<set<size_t>>& adj)
+{
+  size_t c = 0;
+  for (size_t u = 0; u != adj.size(); ++u)
+    for (size_t v : adj[u])
+      if (u < v)
+        for (size_t w : adj[v])
+          if (v < w && adj[u].count(w))
+            ++c;
+  return c;
+}
+
+// Returns the core number of each vertex by repeatedly removing all vertices
+// of degree less than k.
+vector<size_t>
+brute_cores(vector<set<size_t>> adj)
+{
+  vector<size_t> cores(adj.size(), 0);
+  vector<char> gone(adj.size());
+  for (size_t k = 1; ; ++k) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t v = 0; v != adj.size(); ++v)
+        if (!gone[v] && adj[v].size() < k) {
+          gone[v] = true;
+          changed = true;
+          for (size_t u : adj[v])
+            adj[u].erase(v);
+          adj[v].clear();
+        }
+    }
+    if (count(gone.begin(), gone.end(), 0) == 0)
+      return cores;
+    for (size_t v = 0; v != adj.size(); ++v)
+      if (!gone[v])
+        cores[v] = k;
+  }
+}
+
+template<typename T>
+  void
+  check_intersection()
+  {
+    minstd_rand prng(1);
+    for (size_t n : {0, 1, 3, 4, 7, 64, 500}) {
+      for (size_t m : {0, 2, 4, 9, 100, 5000}) {
+        set<T> a, b;
+        uniform_int_distribution<T> dist(0, 2 * max(n, m) + 1);
+        while (a.size() < n)
+          a.insert(dist(prng));
+        while (b.size() < m)
+          b.insert(dist(prng));
+        vector<T> x(a.begin(), a.end()), y(b.begin(), b.end());
+        vector<T> z;
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                         back_inserter(z));
+        using namespace analytics_impl;
+        assert(merge_count(x.data(), n, y.data(), m) == z.size());
+        assert(merge_count(y.data(), m, x.data(), n) == z.size());
+        assert(search_count(x.data(), n, y.data(), m) == z.size());
+        assert(intersection_size(x.data(), n, y.data(), m) == z.size());
+      }
+    }
+  }
+
+template<typename G>
+  void
+  check_clique()
+  {
+    G g = build_reflexive_clique<G>(6);
+    assert(count_triangles(g, 1) == 20);
+    vector<size_t> cores;
+    assert(core_numbers(g, cores, 1) == 5);
+    assert((cores == vector<size_t>(6, 5)));
+  }
+
+template<typename G>
+  void
+  check_random(const G& g)
+  {
+    auto adj = simple_graph(g);
+    size_t t = brute_triangles(adj);
+    assert(count_triangles(g, 1) == t);
+    assert(count_triangles(g, 4) == t);
+
+    vector<size_t> cores;
+    vector<size_t> expect = brute_cores(adj);
+    size_t k = *max_element(expect.begin(), expect.end());
+    assert(core_numbers(g, cores, 1) == k);
+    assert(cores == expect);
+    assert(core_numbers(g, cores, 4) == k);
+    assert(cores == expect);
+  }
+
+// Removed vertices have no core number.
+void
+check_removed()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_reflexive_clique<G>(4);
+  g.remove_vertex(2);
+  assert(count_triangles(g) == 1);
+  vector<size_t> cores;
+  assert(core_numbers(g, cores) == 2);
+  assert((cores == vector<size_t>{2, 2, size_t(-1), 2}));
+}
+
+int main()
+{
+  check_intersection<uint32_t>();
+  check_intersection<size_t>();
+
+  using U = undirected_adjacency_vector<char, int>;
+  using D = directed_adjacency_list<char, int>;
+  check_clique<U>();
+  check_clique<D>();
+
+  check_random(build_erdos_renyi_graph<U>(300, 3000, 1));
+  check_random(build_erdos_renyi_graph<U>(5000, 20000, 2));
+  check_random(build_erdos_renyi_graph<D>(2000, 15000, 3));
+  check_random(compressed_graph<char, int>(
+    build_erdos_renyi_graph<U>(3000, 30000, 4)));
+  check_removed();
+}
@@ -0,0 +1,489 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cerrno>
+#include <cstring>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#      define ORIGIN_HAS_IO_URING 1
+#    endif
+#  endif
+#endif
+
+#include <origin/memory/allocator.hpp>
+
+#include "async_reader.hpp"
+
+namespace origin
+{
+  namespace io
+  {
+    constexpr std::size_t async_reader::alignment;
+
+    namespace
+    {
+      [[noreturn]] void
+      fail(int err, const std::string& path)
+      {
+        throw std::system_error(err, std::system_category(), path);
+      }
+
+      // Read up to n bytes of fd at off into p, stopping at the end of the
+      // file. Returns the number of bytes read, or -errno.
+      long
+      pread_full(int fd, char* p, std::size_t n, std::size_t off)
+      {
+        std::size_t pos = 0;
+        while (pos != n) {
+          ssize_t r = ::pread(fd, p + pos, n - pos, off + pos);
+          if (r < 0 && errno == EINTR)
+            continue;
+          if (r < 0)
+            return -errno;
+          if (r == 0)
+            break;
+          pos += r;
+        }
+        return long(pos);
+      }
+    } // namespace
+
+
+    // ---------------------------------------------------------------------- //
+    //                                Engines
+    //
+    // An engine issues the read of a slot (a chunk buffer) and waits for it.
+    // Each slot has at most one read in flight.
+
+    struct async_reader::engine
+    {
+      virtual ~engine() { }
+
+      // Start reading n bytes at off into p for the slot.
+      virtual void submit(std::size_t slot, char* p, std::size_t n,
+                          std::size_t off) = 0;
+
+      // Wait for the read of the slot, returning the number of bytes read
+      // or -errno.
+      virtual long wait(std::size_t slot) = 0;
+    };
+
+
+    // Threads take the reads from a queue and perform them with pread.
+    struct async_reader::thread_engine : async_reader::engine
+    {
+      struct request
+      {
+        std::size_t slot;
+        char* p;
+        std::size_t n;
+        std::size_t off;
+      };
+
+      thread_engine(int fd, std::size_t slots)
+        : fd(fd), results(slots), done(slots, true), stop(false)
+      {
+        for (std::size_t i = 0; i != slots; ++i)
+          workers.emplace_back([this] { run(); });
+      }
+
+      ~thread_engine()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop = true;
+        }
+        ready.notify_all();
+        for (std::thread& t : workers)
+          t.join();
+      }
+
+      void submit(std::size_t slot, char* p, std::size_t n,
+                  std::size_t off) override
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          done[slot] = false;
+          queue.push_back({slot, p, n, off});
+        }
+        ready.notify_one();
+      }
+
+      long wait(std::size_t slot) override
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return bool(done[slot]); });
+        return results[slot];
+      }
+
+      void run()
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+          ready.wait(lock, [this] { return stop || !queue.empty(); });
+          if (stop)
+            return;
+          request r = queue.front();
+          queue.pop_front();
+          lock.unlock();
+          long n = pread_full(fd, r.p, r.n, r.off);
+          lock.lock();
+          results[r.slot] = n;
+          done[r.slot] = true;
+          finished.notify_all();
+        }
+      }
+
+      int fd;
+      std::vector<long> results;
+      std::vector<bool> done;
+      bool stop;
+      std::mutex mutex;
+      std::condition_variable ready;
+      std::condition_variable finished;
+      std::deque<request> queue;
+      std::vector<std::thread> workers;
+    };
+
+
+#if defined(ORIGIN_HAS_IO_URING)
+    // The io_uring interface is used through its system calls. The
+    // submission and completion rings are shared with the kernel; their
+    // head and tail indexes are read and written with acquire and release
+    // ordering. Reads use IORING_OP_READV, which has the widest kernel
+    // support.
+    struct async_reader::uring_engine : async_reader::engine
+    {
+      // Returns an engine for the file fd, or null if io_uring is not
+      // available.
+      static uring_engine* create(int fd, std::size_t slots)
+      {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        int ring = int(::syscall(__NR_io_uring_setup, unsigned(slots), &p));
+        if (ring < 0)
+          return nullptr;
+        uring_engine* e = new uring_engine(fd, ring, slots);
+        if (!e->map(p)) {
+          delete e;
+          return nullptr;
+        }
+        return e;
+      }
+
+      uring_engine(int fd, int ring, std::size_t slots)
+        : fd(fd), ring(ring), sq(MAP_FAILED), cq(MAP_FAILED),
+          sqes(static_cast<io_uring_sqe*>(MAP_FAILED)),
+          requests(slots), results(slots), done(slots, true)
+      { }
+
+      ~uring_engine()
+      {
+        // A read in flight must complete before its buffer is released.
+        for (std::size_t i = 0; i != done.size(); ++i)
+          if (!done[i])
+            wait(i);
+        if (sqes != MAP_FAILED)
+          ::munmap(sqes, sqes_len);
+        if (cq != MAP_FAILED && cq != sq)
+          ::munmap(cq, cq_len);
+        if (sq != MAP_FAILED)
+          ::munmap(sq, sq_len);
+        ::close(ring);
+      }
+
+      bool map(const io_uring_params& p)
+      {
+        sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single)
+          sq_len = cq_len = std::max(sq_len, cq_len);
+        sq = ::mmap(nullptr, sq_len, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED)
+          return false;
+        cq = single ? sq
+                    : ::mmap(nullptr, cq_len, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring,
+                             IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED)
+          return false;
+        sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+        void* s = ::mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+        if (s == MAP_FAILED)
+          return false;
+        sqes = static_cast<io_uring_sqe*>(s);
+
+        char* sb = static_cast<char*>(sq);
+        sq_tail = reinterpret_cast<unsigned*>(sb + p.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sb + p.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sb + p.sq_off.array);
+        char* cb = static_cast<char*>(cq);
+        cq_head = reinterpret_cast<unsigned*>(cb + p.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cb + p.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cb + p.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cb + p.cq_off.cqes);
+        return true;
+      }
+
+      void submit(std::size_t slot, char* p, std::size_t n,
+                  std::size_t off) override
+      {
+        requests[slot] = {slot, p, n, off};
+        iovec& v = requests[slot].iov;
+        v.iov_base = p;
+        v.iov_len = n;
+
+        unsigned tail = __atomic_load_n(sq_tail, __ATOMIC_RELAXED);
+        unsigned i = tail & sq_mask;
+        io_uring_sqe& e = sqes[i];
+        std::memset(&e, 0, sizeof(e));
+        e.opcode = IORING_OP_READV;
+        e.fd = fd;
+        e.addr = reinterpret_cast<std::uintptr_t>(&v);
+        e.len = 1;
+        e.off = off;
+        e.user_data = slot;
+        sq_array[i] = i;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        done[slot] = false;
+
+        while (::syscall(__NR_io_uring_enter, ring, 1u, 0u, 0u, nullptr, 0)
+               < 0) {
+          if (errno != EINTR && errno != EAGAIN)
+            fail(errno, "io_uring_enter");
+        }
+      }
+
+      long wait(std::size_t slot) override
+      {
+        while (!done[slot]) {
+          unsigned head = __atomic_load_n(cq_head, __ATOMIC_RELAXED);
+          unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+          if (head == tail) {
+            if (::syscall(__NR_io_uring_enter, ring, 0u, 1u,
+                          unsigned(IORING_ENTER_GETEVENTS), nullptr, 0) < 0
+                && errno != EINTR)
+              fail(errno, "io_uring_enter");
+            continue;
+          }
+          const io_uring_cqe& c = cqes[head & cq_mask];
+          std::size_t s = std::size_t(c.user_data);
+          results[s] = c.res;
+          __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+          complete(s);
+        }
+        return results[slot];
+      }
+
+      // A read that stopped short of its length, which is uncommon for
+      // regular files, is finished synchronously.
+      void complete(std::size_t s)
+      {
+        const request& r = requests[s];
+        long n = results[s];
+        if (n > 0 && std::size_t(n) < r.n) {
+          long m = pread_full(fd, r.p + n, r.n - n, r.off + n);
+          results[s] = m < 0 ? m : n + m;
+        }
+        done[s] = true;
+      }
+
+      struct request
+      {
+        std::size_t slot;
+        char* p;
+        std::size_t n;
+        std::size_t off;
+        iovec iov;
+      };
+
+      int fd;
+      int ring;
+      void* sq;
+      void* cq;
+      io_uring_sqe* sqes;
+      std::size_t sq_len;
+      std::size_t cq_len;
+      std::size_t sqes_len;
+      unsigned* sq_tail;
+      unsigned sq_mask;
+      unsigned* sq_array;
+      unsigned* cq_head;
+      unsigned* cq_tail;
+      unsigned cq_mask;
+      io_uring_cqe* cqes;
+      std::vector<request> requests;
+      std::vector<long> results;
+      std::vector<bool> done;
+    };
+#else
+    struct async_reader::uring_engine : async_reader::engine
+    {
+      static uring_engine* create(int, std::size_t) { return nullptr; }
+    };
+#endif
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Async Reader
+
+    // Direct I/O is requested when the file is opened, and is not supported
+    // by every file system, which then rejects the open with EINVAL.
+    async_reader::async_reader(const std::string& path,
+                               const read_options& opts)
+      : path_(path), fd_(-1), size_(0), direct_(opts.direct),
+        method_(read_method::threads)
+    {
+      std::size_t n = std::max<std::size_t>(opts.chunk_size, 1);
+      chunk_ = (n + alignment - 1) / alignment * alignment;
+
+      int flags = O_RDONLY;
+#if defined(O_DIRECT)
+      if (direct_) {
+        fd_ = ::open(path.c_str(), flags | O_DIRECT);
+        if (fd_ < 0 && errno != EINVAL)
+          fail(errno, path);
+      }
+#endif
+      if (fd_ < 0) {
+        direct_ = false;
+        fd_ = ::open(path.c_str(), flags);
+        if (fd_ < 0)
+          fail(errno, path);
+      }
+
+      try {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+          fail(errno, path);
+        size_ = st.st_size;
+
+        std::size_t slots = std::max<std::size_t>(opts.buffers, 1);
+        if (opts.method != read_method::threads) {
+          engine_.reset(uring_engine::create(fd_, slots));
+          if (engine_)
+            method_ = read_method::io_uring;
+          else if (opts.method == read_method::io_uring)
+            fail(ENOSYS, path + ": io_uring");
+        }
+        if (!engine_)
+          engine_.reset(new thread_engine(fd_, slots));
+
+        for (std::size_t i = 0; i != slots; ++i)
+          bufs_.push_back(static_cast<char*>(
+            aligned_allocate(chunk_, alignment)));
+      } catch (...) {
+        engine_.reset();
+        for (char* p : bufs_)
+          aligned_deallocate(p);
+        ::close(fd_);
+        throw;
+      }
+    }
+
+    async_reader::~async_reader()
+    {
+      engine_.reset();
+      for (char* p : bufs_)
+        aligned_deallocate(p);
+      ::close(fd_);
+    }
+
+    // Chunk c is read into slot c % b. When the callback for chunk c
+    // returns, its slot is refilled with chunk c + b. The length of a
+    // direct read is rounded up to the alignment, which the buffer allows.
+    void
+    async_reader::read(const std::function<void(const char*, std::size_t,
+                                                std::size_t)>& f)
+    {
+      std::size_t b = bufs_.size();
+      std::size_t chunks = (size_ + chunk_ - 1) / chunk_;
+      auto issue = [&](std::size_t c) {
+        std::size_t off = c * chunk_;
+        std::size_t n = std::min(chunk_, size_ - off);
+        if (direct_)
+          n = (n + alignment - 1) / alignment * alignment;
+        engine_->submit(c % b, bufs_[c % b], n, off);
+      };
+
+      // On an exception, the reads in flight are finished before the
+      // buffers can be reused.
+      std::size_t next = 0;
+      try {
+        for (; next != std::min(b, chunks); ++next)
+          issue(next);
+        for (std::size_t c = 0; c != chunks; ++c) {
+          std::size_t s = c % b;
+          long r = engine_->wait(s);
+          if (r < 0)
+            fail(int(-r), path_);
+          std::size_t off = c * chunk_;
+          std::size_t n = std::min(chunk_, size_ - off);
+          if (std::size_t(r) < n)
+            fail(EIO, path_);
+          f(bufs_[s], n, off);
+          if (next != chunks)
+            issue(next++);
+        }
+      } catch (...) {
+        for (std::size_t c = next >= b ? next - b : 0; c != next; ++c)
+          engine_->wait(c % b);
+        throw;
+      }
+    }
+
+    // A line that spans chunks is assembled in carry.
+    void
+    async_reader::read_lines(const std::function<void(const char*,
+                                                      const char*)>& f)
+    {
+      std::string carry;
+      read([&](const char* p, std::size_t n, std::size_t) {
+        const char* last = p + n;
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', n));
+        if (!nl) {
+          carry.append(p, n);
+          return;
+        }
+        if (!carry.empty()) {
+          carry.append(p, nl + 1);
+          f(carry.data(), carry.data() + carry.size());
+          carry.clear();
+          p = nl + 1;
+        }
+        const char* end = last;
+        while (end != p && end[-1] != '\n')
+          --end;
+        if (end != p)
+          f(p, end);
+        carry.append(end, last);
+      });
+      if (!carry.empty())
+        f(carry.data(), carry.data() + carry.size());
+    }
+
+  } // namespace io
+} // namespace origin
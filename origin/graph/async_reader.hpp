@@ -0,0 +1,159 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ASYNC_READER_HPP
+#define ORIGIN_GRAPH_ASYNC_READER_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <origin/graph/io.hpp>
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                                                          [graph.io.async]
+    //                            Asynchronous Reads
+    //
+    // An async_reader reads a file sequentially in chunks, keeping the reads
+    // of the following chunks in flight while the caller processes the
+    // current one, so that parsing overlaps I/O:
+    //
+    //    async_reader r(path);
+    //    r.read([&](const char* p, std::size_t n, std::size_t offset) {
+    //      // Process the n bytes at p, which start at offset in the file.
+    //    });
+    //
+    // The reader has a number of chunk buffers: with 2, one chunk is read
+    // while the previous is processed (double buffering), and with 3, two
+    // chunks are read ahead (triple buffering), which hides the variation
+    // in the time to read or process a chunk. The chunks are passed to the
+    // callback in the order of the file, and a chunk's buffer is reused
+    // when the callback returns.
+    //
+    // The reads are issued through io_uring on Linux when the kernel allows
+    // it, and otherwise by a pool of threads calling pread. A direct reader
+    // opens the file with O_DIRECT, bypassing the page cache, which avoids
+    // copying data through it when reading a large file once; the buffers
+    // are aligned to 4096 bytes and the chunk size is rounded up to a
+    // multiple of that. If the file system does not support direct I/O, the
+    // file is read through the page cache. A std::system_error is thrown if
+    // the file cannot be opened or read, or if io_uring is requested and
+    // cannot be used. See async_reader.cpp.
+    //
+    // The line reader, read_lines, passes the text of the file to its
+    // callback as runs of whole lines, carrying a line that spans two chunks
+    // over to the next, so that a line parser can process each run as it
+    // arrives. The edge list readers accept an async_reader in this way.
+
+    // The method by which a reader issues its reads.
+    enum class read_method
+    {
+      automatic,  // io_uring if available, otherwise threads
+      io_uring,   // The io_uring interface of Linux
+      threads     // Threads calling pread
+    };
+
+    struct read_options
+    {
+      std::size_t chunk_size = std::size_t(4) << 20;
+      std::size_t buffers = 2;
+      bool direct = false;
+      read_method method = read_method::automatic;
+    };
+
+    class async_reader
+    {
+    public:
+      // The alignment of the buffers, offsets, and lengths of direct reads.
+      static constexpr std::size_t alignment = 4096;
+
+      explicit async_reader(const std::string& path,
+                            const read_options& opts = read_options());
+
+      async_reader(const async_reader&) = delete;
+      async_reader& operator=(const async_reader&) = delete;
+
+      ~async_reader();
+
+      // Observers
+      const std::string& path() const { return path_; }
+      std::size_t size() const { return size_; }
+      std::size_t chunk_size() const { return chunk_; }
+      std::size_t buffers() const { return bufs_.size(); }
+      bool direct() const { return direct_; }
+
+      // Returns the method used, which is io_uring or threads.
+      read_method method() const { return method_; }
+
+      // Read the file, calling f(p, n, offset) for each chunk in order.
+      void read(const std::function<void(const char*, std::size_t,
+                                         std::size_t)>& f);
+
+      // Read the file, calling f(first, last) for consecutive runs of whole
+      // lines. The last line of the file need not end with a newline.
+      void read_lines(const std::function<void(const char*,
+                                               const char*)>& f);
+
+    private:
+      struct engine;
+      struct uring_engine;
+      struct thread_engine;
+
+      std::string path_;
+      int fd_;
+      std::size_t size_;
+      std::size_t chunk_;
+      bool direct_;
+      read_method method_;
+      std::vector<char*> bufs_;
+      std::unique_ptr<engine> engine_;
+    };
+
+
+    // Returns the edges described by the text read by r. The chunks of lines
+    // are parsed in parallel as they arrive.
+    template<typename T = std::pair<std::size_t, std::size_t>>
+      std::vector<T>
+      parse_edge_list(async_reader& r, std::size_t threads = search_threads())
+      {
+        std::vector<T> result;
+        r.read_lines([&](const char* first, const char* last) {
+          std::vector<T> es = parse_edge_list<T>(first, last, threads);
+          if (result.empty())
+            result = std::move(es);
+          else
+            result.insert(result.end(), es.begin(), es.end());
+        });
+        return result;
+      }
+
+    // Add the edges described by the text read by r to g.
+    template<typename G>
+      void
+      read_edge_list(G& g, async_reader& r,
+                     std::size_t threads = search_threads())
+      {
+        using T = parse_impl::Edge_description<G>;
+        std::vector<T> es = parse_edge_list<T>(r, threads);
+
+        std::size_t n = 0;
+        for (const T& x : es)
+          n = std::max({n, std::get<0>(x) + 1, std::get<1>(x) + 1});
+        while (g.order() < n)
+          g.add_vertex();
+        g.add_edges(es);
+      }
+
+  } // namespace io
+} // namespace origin
+
+#endif
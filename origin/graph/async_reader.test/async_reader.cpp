@@ -0,0 +1,147 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <origin/graph/async_reader.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::io;
+
+const string path = "origin.graph.async_reader.test.txt";
+
+// Write an edge list of about 5 MB whose lines have varying lengths.
+string
+make_file()
+{
+  string s;
+  for (size_t i = 0; s.size() < (size_t(5) << 20); ++i)
+    s += to_string(i % 100003) + ' ' + to_string(i * 7919 % 1000003) + '\n';
+  s += "17 42";  // No final newline
+  ofstream out(path, ios::binary);
+  out.write(s.data(), s.size());
+  return s;
+}
+
+// Returns the contents of the file read in chunks.
+string
+read_all(async_reader& r)
+{
+  string s;
+  r.read([&](const char* p, size_t n, size_t off) {
+    assert(off == s.size());
+    assert(n <= r.chunk_size());
+    s.append(p, n);
+  });
+  return s;
+}
+
+void
+test_read(const string& text)
+{
+  for (size_t b : {1, 2, 3}) {
+    for (bool direct : {false, true}) {
+      for (read_method m : {read_method::threads, read_method::automatic}) {
+        read_options opts;
+        opts.chunk_size = 1 << 20;
+        opts.buffers = b;
+        opts.direct = direct;
+        opts.method = m;
+        async_reader r(path, opts);
+        assert(r.size() == text.size());
+        assert(r.buffers() == b);
+        assert(r.method() != read_method::automatic);
+        if (m == read_method::threads)
+          assert(r.method() == read_method::threads);
+        assert(read_all(r) == text);
+        assert(read_all(r) == text);
+      }
+    }
+  }
+
+  // The chunk size is rounded up to the alignment.
+  read_options opts;
+  opts.chunk_size = 1000;
+  async_reader r(path, opts);
+  assert(r.chunk_size() == async_reader::alignment);
+  assert(read_all(r) == text);
+}
+
+// Lines are whole, however they fall across chunks.
+void
+test_read_lines(const string& text)
+{
+  read_options opts;
+  opts.chunk_size = 4096;
+  opts.buffers = 3;
+  async_reader r(path, opts);
+  string s;
+  size_t runs = 0;
+  r.read_lines([&](const char* first, const char* last) {
+    assert(first != last);
+    assert(s.empty() || s.back() == '\n');
+    s.append(first, last);
+    ++runs;
+  });
+  assert(s == text);
+  assert(runs > 1);
+}
+
+void
+test_edge_list(const string& text)
+{
+  read_options opts;
+  opts.chunk_size = 1 << 18;
+  async_reader r(path, opts);
+  auto es = parse_edge_list(r, 4);
+  assert(es == parse_edge_list(text.data(), text.data() + text.size(), 1));
+}
+
+void
+test_errors()
+{
+  bool thrown = false;
+  try {
+    async_reader r("origin.graph.async_reader.test.missing");
+  } catch (system_error&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  // An exception thrown by the callback leaves the reader usable.
+  read_options opts;
+  opts.chunk_size = 4096;
+  async_reader r(path, opts);
+  thrown = false;
+  try {
+    r.read([](const char*, size_t, size_t off) {
+      if (off != 0)
+        throw 1;
+    });
+  } catch (int) {
+    thrown = true;
+  }
+  assert(thrown);
+  size_t n = 0;
+  r.read([&](const char*, size_t k, size_t) { n += k; });
+  assert(n == r.size());
+}
+
+int main()
+{
+  string text = make_file();
+  test_read(text);
+  test_read_lines(text);
+  test_edge_list(text);
+  test_errors();
+  remove(path.c_str());
+}
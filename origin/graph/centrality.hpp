@@ -0,0 +1,521 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_CENTRALITY_HPP
+#define ORIGIN_GRAPH_CENTRALITY_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <origin/graph/ordering.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                               [graph.msbfs]
+  //                     Multi-Source Breadth-First Search
+  //
+  // A multi-source breadth-first search computes the hop distances from
+  // many sources at once. Each vertex holds a source set, a bit set with
+  // one bit per source in a batch, for each of the sources that have
+  // reached it, and each level of the search computes the set of sources
+  // reaching each vertex for the first time as the union of the sets of its
+  // predecessors in the last level, minus those that have already reached
+  // it. A level therefore follows each edge once for the whole batch rather
+  // than once per source, and each union is N word-wide operations; with N
+  // set to the vector width of the target, the compiler computes each union
+  // with a single SIMD operation.
+  //
+  // The following operations are provided:
+  //
+  //    multi_source_bfs<N>(g, sources, vis[, threads])
+  //    distance_histogram(g, sources[, threads])
+  //    closeness_centrality(g, closeness[, threads])
+  //    betweenness_centrality(g, centrality[, threads])
+  //
+  // The sources are searched in batches of 64 * N, and each level of a
+  // batch is computed in parallel over blocks of vertices, using up to
+  // threads threads. The vertices reached at a level are pulled through
+  // their predecessor edges (see [graph.search]), so no vertex is written by
+  // more than one thread. The search needs three source sets per vertex.
+  //
+  // The visitor of multi_source_bfs is called as vis(v, d, s, first) for
+  // each vertex v and level d at which v is first reached by some sources,
+  // where s is the source_set<N> of those sources: the bit i in s refers to
+  // sources[first + i]. Calls for the vertices of a level may be concurrent,
+  // but each vertex is visited at most once per level.
+  //
+  // The centrality measures are computed from every vertex of g. The
+  // closeness of v is the number of vertices reachable from v divided by
+  // the sum of their distances to v, or 0 if no vertex is reachable. The
+  // betweenness of v is the sum, over pairs of distinct vertices s and t
+  // other than v, of the fraction of the shortest paths from s to t that
+  // pass through v. It is computed by the algorithm of Brandes, counting the
+  // shortest paths during a multi-source search of 64 sources and
+  // accumulating their dependencies level by level in reverse; this needs
+  // two doubles per source per vertex. In an undirected graph, each
+  // unordered pair is counted once.
+
+
+  // A source set is a set of 64 * N sources, one per bit.
+  template<std::size_t N>
+    class source_set
+    {
+      static_assert(N > 0, "");
+
+    public:
+      static constexpr std::size_t size = 64 * N;
+
+      source_set()
+      {
+        for (std::size_t k = 0; k != N; ++k)
+          words_[k] = 0;
+      }
+
+      void set(std::size_t i)
+      {
+        words_[i / 64] |= std::uint64_t(1) << (i % 64);
+      }
+
+      bool test(std::size_t i) const
+      {
+        return (words_[i / 64] >> (i % 64)) & 1;
+      }
+
+      // Returns true if the set is not empty.
+      bool any() const
+      {
+        std::uint64_t x = 0;
+        for (std::size_t k = 0; k != N; ++k)
+          x |= words_[k];
+        return x != 0;
+      }
+
+      // Returns true if the set holds every source.
+      bool all() const
+      {
+        std::uint64_t x = -1;
+        for (std::size_t k = 0; k != N; ++k)
+          x &= words_[k];
+        return x == std::uint64_t(-1);
+      }
+
+      // Returns the number of sources in the set.
+      std::size_t count() const
+      {
+        std::size_t c = 0;
+        for (std::size_t k = 0; k != N; ++k)
+          c += __builtin_popcountll(words_[k]);
+        return c;
+      }
+
+      // Call f(i) for each source i in the set, in increasing order.
+      template<typename F>
+        void for_each(F f) const
+        {
+          for (std::size_t k = 0; k != N; ++k)
+            for (std::uint64_t w = words_[k]; w; w &= w - 1)
+              f(64 * k + __builtin_ctzll(w));
+        }
+
+      source_set& operator|=(const source_set& x)
+      {
+        for (std::size_t k = 0; k != N; ++k)
+          words_[k] |= x.words_[k];
+        return *this;
+      }
+
+      source_set& operator&=(const source_set& x)
+      {
+        for (std::size_t k = 0; k != N; ++k)
+          words_[k] &= x.words_[k];
+        return *this;
+      }
+
+      // Remove the sources of x from the set.
+      source_set& remove(const source_set& x)
+      {
+        for (std::size_t k = 0; k != N; ++k)
+          words_[k] &= ~x.words_[k];
+        return *this;
+      }
+
+      std::uint64_t word(std::size_t k) const { return words_[k]; }
+
+    private:
+      std::uint64_t words_[N];
+    };
+
+  template<std::size_t N>
+    constexpr std::size_t source_set<N>::size;
+
+  template<std::size_t N>
+    inline source_set<N>
+    operator&(source_set<N> a, const source_set<N>& b)
+    {
+      return a &= b;
+    }
+
+
+  namespace centrality_impl
+  {
+    // The number of vertices processed by each parallel task.
+    constexpr std::size_t grain = 1024;
+
+    // The number of words in the source sets of a search, chosen so that a
+    // source set fills a vector register.
+#if defined(__AVX512F__)
+    constexpr std::size_t default_words = 8;
+#else
+    constexpr std::size_t default_words = 4;
+#endif
+
+    // Call f(k, first, last) for each block k of vertex indexes [first,
+    // last) in [0, n), using up to threads threads.
+    template<typename F>
+      void
+      for_blocks(std::size_t n, std::size_t threads, F f)
+      {
+        std::size_t blocks = (n + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          f(k, k * grain, std::min(n, (k + 1) * grain));
+        });
+      }
+
+    // The state of a multi-source breadth-first search of a batch of
+    // sources. After start, and after each call to advance that returns
+    // true, frontier[v] is the set of sources first reaching v at the
+    // current level, and previous[v] the set that reached it at the level
+    // before.
+    template<typename G, std::size_t N>
+      struct msbfs_engine
+      {
+        using V = Vertex<G>;
+        using S = source_set<N>;
+
+        msbfs_engine(const G& g, std::size_t threads)
+          : g(g), threads(threads), n(search_impl::vertex_bound(g)),
+            present(n), seen(n), frontier(n), previous(n)
+        {
+          for (V v : g.vertices())
+            present[v] = true;
+        }
+
+        // Start a search from the sources [first, last), of which there are
+        // at most S::size.
+        template<typename I>
+          void start(I first, I last)
+          {
+            std::size_t k = last - first;
+            assert(k <= S::size);
+
+            // The unused sources of the batch are marked as having reached
+            // every vertex, so that vertices reached by all of the sources
+            // are skipped.
+            S unused;
+            for (std::size_t i = k; i != S::size; ++i)
+              unused.set(i);
+            std::fill(seen.begin(), seen.end(), unused);
+            std::fill(frontier.begin(), frontier.end(), S());
+            for (std::size_t i = 0; first != last; ++first, ++i) {
+              assert(present[*first]);
+              seen[*first].set(i);
+              frontier[*first].set(i);
+            }
+            level = 0;
+          }
+
+        // Compute the sources reaching each vertex at the next level.
+        // Returns false if there are none.
+        bool advance()
+        {
+          std::atomic<bool> found(false);
+          for_blocks(n, threads, [&](std::size_t, std::size_t f,
+                                     std::size_t l) {
+            bool any = false;
+            for (std::size_t v = f; v != l; ++v) {
+              S x;
+              if (present[v] && !seen[v].all()) {
+                for (Edge<G> e : search_impl::predecessor_edges(g, V(v)))
+                  x |= frontier[opposite(g, e, V(v))];
+                x.remove(seen[v]);
+                seen[v] |= x;
+                any |= x.any();
+              }
+              previous[v] = x;
+            }
+            if (any)
+              found.store(true, std::memory_order_relaxed);
+          });
+          frontier.swap(previous);
+          ++level;
+          return found.load();
+        }
+
+        const G& g;
+        std::size_t threads;
+        std::size_t n;
+        std::vector<char> present;
+        std::vector<S> seen;
+        std::vector<S> frontier;
+        std::vector<S> previous;
+        std::size_t level;
+      };
+
+  } // namespace centrality_impl
+
+
+  // Search g from each vertex in sources, calling vis(v, d, s, first) for
+  // each vertex v, the sources s reaching it at distance d, and the index
+  // first of the sources of the batch. N is the number of words in each
+  // source set.
+  template<std::size_t N = centrality_impl::default_words,
+           typename G,
+           typename Vis>
+    void
+    multi_source_bfs(const G& g,
+                     const std::vector<Vertex<G>>& sources,
+                     Vis vis,
+                     std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using V = Vertex<G>;
+      using S = source_set<N>;
+      centrality_impl::msbfs_engine<G, N> bfs(g, threads);
+      for (std::size_t b = 0; b < sources.size(); b += S::size) {
+        std::size_t e = std::min(sources.size(), b + S::size);
+        bfs.start(sources.begin() + b, sources.begin() + e);
+        do {
+          centrality_impl::for_blocks(bfs.n, threads,
+                                      [&](std::size_t, std::size_t f,
+                                          std::size_t l) {
+            for (std::size_t v = f; v != l; ++v)
+              if (bfs.frontier[v].any())
+                vis(V(v), bfs.level, bfs.frontier[v], b);
+          });
+        } while (bfs.advance());
+      }
+    }
+
+
+  // Returns the hop distance histogram of g from sources: the element d is
+  // the number of pairs of a source s and a vertex v such that v is at
+  // distance d from s.
+  template<typename G>
+    std::vector<std::size_t>
+    distance_histogram(const G& g,
+                       const std::vector<Vertex<G>>& sources,
+                       std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      constexpr std::size_t N = centrality_impl::default_words;
+      using S = source_set<N>;
+      std::vector<std::size_t> hist;
+      centrality_impl::msbfs_engine<G, N> bfs(g, threads);
+      for (std::size_t b = 0; b < sources.size(); b += S::size) {
+        std::size_t e = std::min(sources.size(), b + S::size);
+        bfs.start(sources.begin() + b, sources.begin() + e);
+        do {
+          std::atomic<std::size_t> count(0);
+          centrality_impl::for_blocks(bfs.n, threads,
+                                      [&](std::size_t, std::size_t f,
+                                          std::size_t l) {
+            std::size_t c = 0;
+            for (std::size_t v = f; v != l; ++v)
+              c += bfs.frontier[v].count();
+            count.fetch_add(c, std::memory_order_relaxed);
+          });
+          if (hist.size() == bfs.level)
+            hist.push_back(0);
+          hist[bfs.level] += count.load();
+        } while (bfs.advance());
+      }
+      while (!hist.empty() && hist.back() == 0)
+        hist.pop_back();
+      return hist;
+    }
+
+
+  // Compute the closeness centrality of each vertex of g, writing them to
+  // closeness, indexed by vertex handle. The entries for handles that do
+  // not refer to vertices are 0.
+  template<typename G>
+    void
+    closeness_centrality(const G& g,
+                         std::vector<double>& closeness,
+                         std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      constexpr std::size_t N = centrality_impl::default_words;
+      using V = Vertex<G>;
+      using S = source_set<N>;
+      std::vector<V> sources = ordering_impl::vertex_list(g);
+      centrality_impl::msbfs_engine<G, N> bfs(g, threads);
+      closeness.assign(bfs.n, 0.0);
+
+      // The number of vertices reached from each source of a batch, and
+      // the sum of their distances.
+      std::unique_ptr<std::atomic<std::size_t>[]> reached(
+        new std::atomic<std::size_t>[S::size]);
+      std::unique_ptr<std::atomic<std::size_t>[]> total(
+        new std::atomic<std::size_t>[S::size]);
+      for (std::size_t b = 0; b < sources.size(); b += S::size) {
+        std::size_t e = std::min(sources.size(), b + S::size);
+        for (std::size_t i = 0; i != S::size; ++i) {
+          reached[i].store(0, std::memory_order_relaxed);
+          total[i].store(0, std::memory_order_relaxed);
+        }
+        bfs.start(sources.begin() + b, sources.begin() + e);
+        while (bfs.advance()) {
+          std::size_t d = bfs.level;
+          centrality_impl::for_blocks(bfs.n, threads,
+                                      [&](std::size_t, std::size_t f,
+                                          std::size_t l) {
+            std::size_t counts[S::size] = {};
+            for (std::size_t v = f; v != l; ++v)
+              bfs.frontier[v].for_each([&](std::size_t i) { ++counts[i]; });
+            for (std::size_t i = 0; i != S::size; ++i)
+              if (counts[i]) {
+                reached[i].fetch_add(counts[i], std::memory_order_relaxed);
+                total[i].fetch_add(d * counts[i], std::memory_order_relaxed);
+              }
+          });
+        }
+        for (std::size_t i = 0; i != e - b; ++i) {
+          std::size_t t = total[i].load();
+          if (t)
+            closeness[sources[b + i]] = double(reached[i].load()) / t;
+        }
+      }
+    }
+
+
+  // Compute the betweenness centrality of each vertex of g, writing them to
+  // centrality, indexed by vertex handle. The entries for handles that do
+  // not refer to vertices are 0.
+  template<typename G>
+    void
+    betweenness_centrality(const G& g,
+                           std::vector<double>& centrality,
+                           std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using V = Vertex<G>;
+      using S = source_set<1>;
+      using centrality_impl::for_blocks;
+      constexpr std::size_t B = S::size;
+
+      std::vector<V> sources = ordering_impl::vertex_list(g);
+      centrality_impl::msbfs_engine<G, 1> bfs(g, threads);
+      std::size_t n = bfs.n;
+      centrality.assign(n, 0.0);
+
+      // The number of shortest paths from each source of the batch to each
+      // vertex, and the dependency of each source on each vertex, as
+      // sigma[B * v + i] and delta[B * v + i].
+      std::vector<double> sigma(B * n);
+      std::vector<double> delta(B * n);
+
+      // The vertices reached at each level, with their sources, and the
+      // sources reaching each vertex at the level after the one whose
+      // dependencies are being accumulated.
+      std::vector<std::vector<std::pair<V, S>>> levels;
+      std::vector<std::vector<std::pair<V, S>>> parts;
+      std::vector<S> later(n);
+
+      for (std::size_t b = 0; b < sources.size(); b += B) {
+        std::size_t e = std::min(sources.size(), b + B);
+        bfs.start(sources.begin() + b, sources.begin() + e);
+        levels.assign(1, {});
+        for (std::size_t i = 0; i != e - b; ++i) {
+          sigma[B * sources[b + i] + i] = 1;
+          levels[0].emplace_back(sources[b + i], bfs.frontier[sources[b + i]]);
+        }
+
+        // Count the shortest paths through the predecessors of each vertex
+        // in the last level.
+        while (bfs.advance()) {
+          parts.assign((n + centrality_impl::grain - 1)
+                         / centrality_impl::grain, {});
+          for_blocks(n, threads, [&](std::size_t k, std::size_t f,
+                                     std::size_t l) {
+            for (std::size_t v = f; v != l; ++v) {
+              const S& x = bfs.frontier[v];
+              if (!x.any())
+                continue;
+              double* sv = &sigma[B * v];
+              for (Edge<G> e : search_impl::predecessor_edges(g, V(v))) {
+                std::size_t u = opposite(g, e, V(v));
+                const double* su = &sigma[B * u];
+                (bfs.previous[u] & x).for_each([&](std::size_t i) {
+                  sv[i] += su[i];
+                });
+              }
+              parts[k].emplace_back(V(v), x);
+            }
+          });
+          levels.emplace_back();
+          for (std::vector<std::pair<V, S>>& p : parts)
+            levels.back().insert(levels.back().end(), p.begin(), p.end());
+        }
+
+        // Accumulate the dependencies of each level on the next, from the
+        // deepest level up. The sources themselves have no dependency.
+        for (std::size_t d = levels.size() - 1; d-- > 1; ) {
+          for (const std::pair<V, S>& x : levels[d + 1])
+            later[x.first] = x.second;
+          const std::vector<std::pair<V, S>>& level = levels[d];
+          search_impl::parallel_for((level.size() + centrality_impl::grain - 1)
+                                      / centrality_impl::grain,
+                                    threads, [&](std::size_t k) {
+            std::size_t end = std::min(level.size(),
+                                       (k + 1) * centrality_impl::grain);
+            for (std::size_t j = k * centrality_impl::grain; j != end; ++j) {
+              V v = level[j].first;
+              const S& x = level[j].second;
+              const double* sv = &sigma[B * v];
+              double* dv = &delta[B * v];
+              for (Edge<G> e : search_impl::successor_edges(g, v)) {
+                std::size_t w = opposite(g, e, v);
+                const double* sw = &sigma[B * w];
+                const double* dw = &delta[B * w];
+                (later[w] & x).for_each([&](std::size_t i) {
+                  dv[i] += sv[i] / sw[i] * (1 + dw[i]);
+                });
+              }
+              double c = 0;
+              x.for_each([&](std::size_t i) { c += dv[i]; });
+              centrality[v] += c;
+            }
+          });
+          for (const std::pair<V, S>& x : levels[d + 1])
+            later[x.first] = S();
+        }
+
+        // Clear the path counts and dependencies of the batch.
+        for (const std::vector<std::pair<V, S>>& level : levels)
+          for (const std::pair<V, S>& x : level)
+            x.second.for_each([&](std::size_t i) {
+              sigma[B * x.first + i] = 0;
+              delta[B * x.first + i] = 0;
+            });
+      }
+
+      if (Undirected_graph<G>())
+        for (double& c : centrality)
+          c /= 2;
+    }
+
+} // namespace origin
+
+#endif
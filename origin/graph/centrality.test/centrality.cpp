@@ -0,0 +1,201 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <atomic>
+#include <deque>
+
+#include <origin/graph/centrality.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// The distances from s, and the number of shortest paths, by a single
+// breadth-first search. Unreached vertices have distance size_t(-1).
+template<typename G>
+  void
+  single_source(const G& g, Vertex<G> s,
+                vector<size_t>& dist, vector<double>& paths,
+                vector<Vertex<G>>& order)
+  {
+    size_t n = search_impl::vertex_bound(g);
+    dist.assign(n, size_t(-1));
+    paths.assign(n, 0);
+    order.clear();
+    deque<Vertex<G>> q {s};
+    dist[s] = 0;
+    paths[s] = 1;
+    while (!q.empty()) {
+      Vertex<G> u = q.front();
+      q.pop_front();
+      order.push_back(u);
+      for (Edge<G> e : search_impl::successor_edges(g, u)) {
+        Vertex<G> v = opposite(g, e, u);
+        if (dist[v] == size_t(-1)) {
+          dist[v] = dist[u] + 1;
+          q.push_back(v);
+        }
+        if (dist[v] == dist[u] + 1)
+          paths[v] += paths[u];
+      }
+    }
+  }
+
+template<typename G>
+  void
+  check_graph(const G& g)
+  {
+    size_t n = search_impl::vertex_bound(g);
+    vector<Vertex<G>> vs = ordering_impl::vertex_list(g);
+
+    // The expected histogram, closeness, and betweenness.
+    vector<size_t> hist;
+    vector<double> close(n), between(n);
+    vector<size_t> dist;
+    vector<double> paths;
+    vector<Vertex<G>> order;
+    for (Vertex<G> s : vs) {
+      single_source(g, s, dist, paths, order);
+      size_t reached = 0, total = 0;
+      for (Vertex<G> v : order) {
+        if (hist.size() <= dist[v])
+          hist.resize(dist[v] + 1);
+        ++hist[dist[v]];
+        reached += v != s;
+        total += dist[v];
+      }
+      close[s] = total ? double(reached) / total : 0;
+
+      vector<double> delta(n);
+      for (size_t j = order.size(); j-- > 0; ) {
+        Vertex<G> v = order[j];
+        for (Edge<G> e : search_impl::successor_edges(g, v)) {
+          Vertex<G> w = opposite(g, e, v);
+          if (dist[w] == dist[v] + 1)
+            delta[v] += paths[v] / paths[w] * (1 + delta[w]);
+        }
+        if (v != s)
+          between[v] += delta[v];
+      }
+    }
+    if (Undirected_graph<G>())
+      for (double& c : between)
+        c /= 2;
+
+    for (size_t t : {1, 4}) {
+      assert(distance_histogram(g, vs, t) == hist);
+
+      vector<double> c;
+      closeness_centrality(g, c, t);
+      assert(c.size() == n);
+      for (size_t v = 0; v != n; ++v)
+        assert(abs(c[v] - close[v]) < 1e-12);
+
+      betweenness_centrality(g, c, t);
+      assert(c.size() == n);
+      for (size_t v = 0; v != n; ++v)
+        assert(abs(c[v] - between[v]) <= 1e-9 * max(1.0, between[v]));
+    }
+  }
+
+// The visitor is called once for each source and reached vertex, at their
+// distance, with batches of each width.
+template<size_t N, typename G>
+  void
+  check_visitor(const G& g)
+  {
+    size_t n = search_impl::vertex_bound(g);
+    vector<Vertex<G>> vs = ordering_impl::vertex_list(g);
+    vector<Vertex<G>> sources(vs.begin(), vs.begin() + min<size_t>(300, n));
+    unique_ptr<atomic<size_t>[]> sums(new atomic<size_t>[sources.size()]);
+    for (size_t i = 0; i != sources.size(); ++i)
+      sums[i] = 0;
+    multi_source_bfs<N>(g, sources, [&](Vertex<G>, size_t d,
+                                        const source_set<N>& s, size_t f) {
+      s.for_each([&](size_t i) { sums[f + i] += d; });
+    }, 4);
+
+    vector<size_t> dist;
+    vector<double> paths;
+    vector<Vertex<G>> order;
+    for (size_t i = 0; i != sources.size(); ++i) {
+      single_source(g, sources[i], dist, paths, order);
+      size_t total = 0;
+      for (Vertex<G> v : order)
+        total += dist[v];
+      assert(sums[i] == total);
+    }
+  }
+
+void
+check_source_set()
+{
+  source_set<2> s;
+  assert(!s.any() && s.count() == 0);
+  s.set(3);
+  s.set(64);
+  s.set(127);
+  assert(s.test(64) && !s.test(65));
+  assert(s.count() == 3);
+  vector<size_t> xs;
+  s.for_each([&](size_t i) { xs.push_back(i); });
+  assert((xs == vector<size_t>{3, 64, 127}));
+
+  source_set<2> t;
+  t.set(64);
+  s.remove(t);
+  assert(s.count() == 2 && !s.test(64));
+  assert(!(s & t).any());
+  for (size_t i = 0; i != 128; ++i)
+    t.set(i);
+  assert(t.all() && !s.all());
+}
+
+// A path a-c-d, with the vertex b removed: c lies on the one shortest path
+// between a and d.
+void
+check_path()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 2);
+  g.add_edge(2, 3);
+  g.remove_vertex(1);
+
+  vector<double> c;
+  betweenness_centrality(g, c);
+  assert((c == vector<double>{0, 0, 1, 0}));
+  closeness_centrality(g, c);
+  assert((c == vector<double>{2.0 / 3, 0, 1, 2.0 / 3}));
+  assert((distance_histogram(g, {0, 2, 3}) == vector<size_t>{3, 4, 2}));
+}
+
+int main()
+{
+  using U = undirected_adjacency_vector<char, int>;
+  using D = directed_adjacency_list<char, int>;
+  check_source_set();
+  check_path();
+
+  check_graph(build_erdos_renyi_graph<U>(400, 600, 1));
+  check_graph(build_erdos_renyi_graph<D>(300, 1200, 2));
+  check_graph(compressed_graph<char, int>(
+    build_erdos_renyi_graph<D>(600, 2000, 3)));
+  check_graph(build_erdos_renyi_graph<U>(1000, 3000, 4));
+
+  U g = build_erdos_renyi_graph<U>(1500, 3000, 5);
+  check_visitor<1>(g);
+  check_visitor<4>(g);
+  check_visitor<8>(g);
+}
@@ -0,0 +1,295 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COLORING_HPP
+#define ORIGIN_GRAPH_COLORING_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <origin/sequence/random.hpp>
+#include <origin/graph/ordering.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.coloring]
+  //                       Coloring and Independent Sets
+  //
+  //    greedy_coloring(g, colors)
+  //    parallel_coloring(g, colors[, threads])
+  //    maximal_independent_set(g, set[, threads])
+  //
+  // A coloring assigns a color to each vertex so that adjacent vertices have
+  // different colors; the vertices of each color are then an independent
+  // set, which can be updated in parallel without conflicts. Both coloring
+  // algorithms are first-fit: each vertex is given the least color that is
+  // not used by its neighbors, so that at most d + 1 colors are used, where
+  // d is the largest degree. Colors are written to a dense array indexed by
+  // vertex handle, and the algorithms return one more than the largest
+  // color used. The entries of handles that do not refer to vertices are
+  // size_t(-1).
+  //
+  // The greedy_coloring algorithm colors the vertices in the order in which
+  // they are enumerated by g.vertices(). The parallel_coloring algorithm is
+  // the speculative algorithm of Gebremedhin and Manne. The uncolored
+  // vertices are colored in parallel, each reading the colors of its
+  // neighbors as they are being assigned, so that some adjacent vertices
+  // get the same color. The conflicts are then found in parallel, and of
+  // each conflicting pair, the vertex with the greater handle is colored
+  // again in the next round. Conflicts are rare (the expected number is
+  // proportional to the number of threads, not the size of the graph), so
+  // few rounds are needed, and each round is a parallel loop over the
+  // remaining vertices.
+  //
+  // The maximal_independent_set algorithm is Luby's algorithm. Each vertex
+  // is given a fixed pseudo-random priority, and in each round, every
+  // undecided vertex whose priority is greater than those of its undecided
+  // neighbors joins the set, and its neighbors leave it. The expected number
+  // of rounds is O(log n). The set is written to a dense array of flags
+  // indexed by vertex handle, and the size of the set is returned. Because
+  // priorities are fixed, the set is the same for any number of threads.
+  //
+  // The algorithms color the simple undirected graph underlying g: the
+  // direction of edges is ignored, and loops are discarded. They are best
+  // suited to graphs whose incident edges are stored contiguously, such as
+  // undirected adjacency vectors and compressed graphs.
+
+
+  namespace coloring_impl
+  {
+    // The number of vertices processed by each parallel task.
+    constexpr std::size_t grain = 1024;
+
+    constexpr std::size_t uncolored = std::size_t(-1);
+
+    // Call f(first, last) for each block [first, last) of the vertices in
+    // vs, using up to threads threads.
+    template<typename V, typename F>
+      void
+      for_blocks(const std::vector<V>& vs, std::size_t threads, F f)
+      {
+        std::size_t n = vs.size();
+        std::size_t blocks = (n + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          f(vs.data() + k * grain, vs.data() + std::min(n, (k + 1) * grain));
+        });
+      }
+
+    // Returns the vertices of vs satisfying pred, in order. Each block is
+    // filtered separately, and the blocks are then copied into place in
+    // parallel.
+    template<typename V, typename P>
+      std::vector<V>
+      filter(const std::vector<V>& vs, std::size_t threads, P pred)
+      {
+        std::size_t blocks = (vs.size() + grain - 1) / grain;
+        std::vector<std::vector<V>> parts(blocks);
+        for_blocks(vs, threads, [&](const V* first, const V* last) {
+          std::vector<V>& part = parts[(first - vs.data()) / grain];
+          for (; first != last; ++first)
+            if (pred(*first))
+              part.push_back(*first);
+        });
+        std::vector<std::size_t> offsets(blocks + 1, 0);
+        for (std::size_t k = 0; k != blocks; ++k)
+          offsets[k + 1] = offsets[k] + parts[k].size();
+        std::vector<V> result(offsets[blocks]);
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::copy(parts[k].begin(), parts[k].end(),
+                    result.begin() + offsets[k]);
+        });
+        return result;
+      }
+
+    // Returns the least color not used by a neighbor of v, where color(u)
+    // returns the color of u. The colors used are marked in mark with the
+    // stamp v + 1, so that mark need not be cleared between vertices.
+    template<typename G, typename C>
+      std::size_t
+      first_fit(const G& g, Vertex<G> v, C color,
+                std::vector<std::size_t>& mark)
+      {
+        std::size_t stamp = std::size_t(v) + 1;
+        ordering_impl::for_neighbors(g, v, [&](Vertex<G> u) {
+          std::size_t c = color(u);
+          if (u != v && c != uncolored) {
+            if (c >= mark.size())
+              mark.resize(c + 1, 0);
+            mark[c] = stamp;
+          }
+        });
+        std::size_t c = 0;
+        while (c != mark.size() && mark[c] == stamp)
+          ++c;
+        return c;
+      }
+
+    // Returns the priority of v in Luby's algorithm. The mix is a
+    // bijection, so distinct vertices have distinct priorities.
+    inline std::uint64_t
+    priority(std::size_t v)
+    {
+      return random_impl::mix(v);
+    }
+
+  } // namespace coloring_impl
+
+
+  // Color the vertices of g in order, writing the color of each vertex to
+  // colors. Returns the number of colors.
+  template<typename G>
+    std::size_t
+    greedy_coloring(const G& g, std::vector<std::size_t>& colors)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using namespace coloring_impl;
+      colors.assign(search_impl::vertex_bound(g), uncolored);
+      std::vector<std::size_t> mark;
+      std::size_t k = 0;
+      for (Vertex<G> v : g.vertices()) {
+        std::size_t c = first_fit(g, v, [&](Vertex<G> u) {
+          return colors[u];
+        }, mark);
+        colors[v] = c;
+        k = std::max(k, c + 1);
+      }
+      return k;
+    }
+
+
+  // Color the vertices of g using up to threads threads, writing the color
+  // of each vertex to colors. Returns the number of colors.
+  template<typename G>
+    std::size_t
+    parallel_coloring(const G& g,
+                      std::vector<std::size_t>& colors,
+                      std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using namespace coloring_impl;
+      using V = Vertex<G>;
+
+      // Colors are read by the neighbors of a vertex while it is being
+      // colored, so they are atomic. Relaxed loads and stores are plain
+      // moves on common hardware.
+      std::size_t n = search_impl::vertex_bound(g);
+      std::unique_ptr<std::atomic<std::size_t>[]> color(
+        new std::atomic<std::size_t>[n]);
+      auto load = [&](V u) {
+        return color[u].load(std::memory_order_relaxed);
+      };
+      std::vector<V> work = ordering_impl::vertex_list(g);
+      search_impl::parallel_for((n + grain - 1) / grain, threads,
+                                [&](std::size_t k) {
+        std::size_t last = std::min(n, (k + 1) * grain);
+        for (std::size_t v = k * grain; v != last; ++v)
+          color[v].store(uncolored, std::memory_order_relaxed);
+      });
+
+      while (!work.empty()) {
+        // Color the remaining vertices speculatively.
+        for_blocks(work, threads, [&](const V* first, const V* last) {
+          std::vector<std::size_t> mark;
+          for (; first != last; ++first) {
+            std::size_t c = first_fit(g, *first, load, mark);
+            color[*first].store(c, std::memory_order_relaxed);
+          }
+        });
+
+        // Color again each vertex with the color of a lesser neighbor.
+        work = filter(work, threads, [&](V v) {
+          std::size_t c = load(v);
+          bool conflict = false;
+          ordering_impl::for_neighbors(g, v, [&](V u) {
+            if (std::size_t(u) < std::size_t(v) && load(u) == c)
+              conflict = true;
+          });
+          return conflict;
+        });
+      }
+
+      colors.assign(n, uncolored);
+      std::size_t k = 0;
+      for (V v : g.vertices()) {
+        colors[v] = load(v);
+        k = std::max(k, colors[v] + 1);
+      }
+      return k;
+    }
+
+
+  // Compute a maximal independent set of g using up to threads threads,
+  // writing true to set for each vertex in it. Returns the size of the set.
+  template<typename G>
+    std::size_t
+    maximal_independent_set(const G& g,
+                            std::vector<char>& set,
+                            std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using namespace coloring_impl;
+      using V = Vertex<G>;
+
+      // The state of each vertex is undecided, in, or out. In each round,
+      // the join flags are written from the states, and then the states
+      // from the join flags, so that no entry is read while it is written.
+      enum : char { undecided, in, out };
+      std::size_t n = search_impl::vertex_bound(g);
+      std::vector<char> state(n, undecided);
+      std::vector<char> join(n, false);
+      std::vector<V> work = ordering_impl::vertex_list(g);
+      while (!work.empty()) {
+        for_blocks(work, threads, [&](const V* first, const V* last) {
+          for (; first != last; ++first) {
+            V v = *first;
+            std::uint64_t p = priority(v);
+            bool max = true;
+            ordering_impl::for_neighbors(g, v, [&](V u) {
+              if (u != v && state[u] == undecided && priority(u) > p)
+                max = false;
+            });
+            join[v] = max;
+          }
+        });
+
+        for_blocks(work, threads, [&](const V* first, const V* last) {
+          for (; first != last; ++first) {
+            V v = *first;
+            if (join[v]) {
+              state[v] = in;
+            } else {
+              ordering_impl::for_neighbors(g, v, [&](V u) {
+                if (join[u])
+                  state[v] = out;
+              });
+            }
+          }
+        });
+
+        work = filter(work, threads, [&](V v) {
+          return state[v] == undecided;
+        });
+      }
+
+      set.assign(n, false);
+      std::size_t k = 0;
+      for (V v : g.vertices()) {
+        set[v] = state[v] == in;
+        k += set[v];
+      }
+      return k;
+    }
+
+} // namespace origin
+
+#endif
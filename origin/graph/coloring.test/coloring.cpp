@@ -0,0 +1,145 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+#include <origin/graph/coloring.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the largest number of distinct neighbors of a vertex.
+template<typename G>
+  size_t
+  max_degree(const G& g)
+  {
+    vector<vector<size_t>> adj(search_impl::vertex_bound(g));
+    for (Edge<G> e : g.edges()) {
+      size_t u = g.source(e), v = g.target(e);
+      if (u != v) {
+        adj[u].push_back(v);
+        adj[v].push_back(u);
+      }
+    }
+    size_t d = 0;
+    for (auto& a : adj) {
+      sort(a.begin(), a.end());
+      d = max<size_t>(d, unique(a.begin(), a.end()) - a.begin());
+    }
+    return d;
+  }
+
+// Adjacent vertices have different colors, and at most d + 1 colors are
+// used.
+template<typename G>
+  void
+  check_coloring(const G& g, const vector<size_t>& colors, size_t k)
+  {
+    assert(k <= max_degree(g) + 1);
+    for (Vertex<G> v : g.vertices())
+      assert(colors[v] < k);
+    for (Edge<G> e : g.edges()) {
+      Vertex<G> u = g.source(e), v = g.target(e);
+      assert(u == v || colors[u] != colors[v]);
+    }
+  }
+
+// No two vertices of the set are adjacent, and every vertex outside of it
+// has a neighbor in it.
+template<typename G>
+  void
+  check_independent(const G& g, const vector<char>& set, size_t k)
+  {
+    vector<char> covered(set);
+    for (Edge<G> e : g.edges()) {
+      Vertex<G> u = g.source(e), v = g.target(e);
+      if (u == v)
+        continue;
+      assert(!(set[u] && set[v]));
+      covered[u] |= set[v];
+      covered[v] |= set[u];
+    }
+    for (Vertex<G> v : g.vertices())
+      assert(covered[v]);
+    assert(size_t(count(set.begin(), set.end(), 1)) == k);
+  }
+
+template<typename G>
+  void
+  check_random(const G& g)
+  {
+    vector<size_t> colors;
+    check_coloring(g, colors, greedy_coloring(g, colors));
+    for (size_t threads : {1, 4, 16}) {
+      size_t k = parallel_coloring(g, colors, threads);
+      check_coloring(g, colors, k);
+    }
+
+    vector<char> set;
+    size_t k = maximal_independent_set(g, set, 1);
+    check_independent(g, set, k);
+    vector<char> set4;
+    assert(maximal_independent_set(g, set4, 4) == k);
+    assert(set4 == set);
+  }
+
+void
+check_small()
+{
+  // A clique of n vertices needs n colors, and has one vertex in a maximal
+  // independent set.
+  using U = undirected_adjacency_vector<char, int>;
+  U g = build_reflexive_clique<U>(6);
+  vector<size_t> colors;
+  assert(greedy_coloring(g, colors) == 6);
+  assert((colors == vector<size_t>{0, 1, 2, 3, 4, 5}));
+  assert(parallel_coloring(g, colors, 4) == 6);
+  vector<char> set;
+  assert(maximal_independent_set(g, set) == 1);
+
+  // An even cycle is colored with two colors in order.
+  U c = build_n_graph<U>(8);
+  for (size_t i = 0; i != 8; ++i)
+    c.add_edge(i, (i + 1) % 8);
+  assert(greedy_coloring(c, colors) == 2);
+  check_independent(c, set, maximal_independent_set(c, set));
+
+  // Removed vertices have no color, and are not in the set.
+  using L = undirected_adjacency_list<char, int>;
+  L l = build_reflexive_clique<L>(4);
+  l.remove_vertex(2);
+  assert(parallel_coloring(l, colors) == 3);
+  assert(colors[2] == size_t(-1));
+  assert(maximal_independent_set(l, set) == 1);
+  assert(!set[2]);
+
+  // The empty graph has no colors.
+  U e;
+  assert(parallel_coloring(e, colors) == 0 && colors.empty());
+  assert(maximal_independent_set(e, set) == 0);
+}
+
+int main()
+{
+  check_small();
+
+  using U = undirected_adjacency_vector<char, int>;
+  using D = directed_adjacency_list<char, int>;
+  check_random(build_erdos_renyi_graph<U>(300, 3000, 1));
+  check_random(build_erdos_renyi_graph<U>(50000, 400000, 2));
+  check_random(build_erdos_renyi_graph<D>(2000, 15000, 3));
+  check_random(compressed_graph<char, int>(
+    build_erdos_renyi_graph<U>(30000, 300000, 4)));
+}
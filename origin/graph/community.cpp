@@ -0,0 +1,487 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include <origin/data/flat_hash/flat_hash_map.hpp>
+#include <origin/instrument/instrument.hpp>
+
+#include "community.hpp"
+
+namespace origin
+{
+  namespace community_impl
+  {
+    namespace
+    {
+      // The weights of the edges from a vertex to each community.
+      using weight_map = flat_hash_map<std::size_t, double>;
+
+      // The number of vertices or communities processed by each claim of a
+      // thread.
+      constexpr std::size_t grain = 256;
+
+      // The greatest number of entries of a map that is cleared for reuse.
+      // A larger one, filled by a vertex of high degree, is released so
+      // that clearing it does not cost every later vertex.
+      constexpr std::size_t map_limit = 1024;
+
+      void
+      reset(weight_map& m)
+      {
+        if (m.size() > map_limit)
+          weight_map().swap(m);
+        else
+          m.clear();
+      }
+
+      // Call f(k, m) for each block k in [0, blocks), using up to threads
+      // threads. Each thread claims blocks from a shared counter and passes
+      // its own map m, which is empty between calls.
+      template<typename F>
+        void
+        for_blocks(std::size_t blocks,
+                   std::size_t threads,
+                   std::vector<weight_map>& maps,
+                   F f)
+        {
+          threads = std::max<std::size_t>(std::min(threads, blocks), 1);
+          if (maps.size() < threads)
+            maps.resize(threads);
+          std::atomic<std::size_t> next {0};
+          search_impl::parallel_for(threads, threads, [&](std::size_t t) {
+            weight_map& m = maps[t];
+            std::size_t k;
+            while ((k = next.fetch_add(1, std::memory_order_relaxed)) < blocks)
+              f(k, m);
+          });
+        }
+
+      std::size_t
+      block_count(std::size_t n)
+      {
+        return (n + grain - 1) / grain;
+      }
+
+      // Returns the total weight of the edges incident to each vertex of g,
+      // in which loops are counted twice.
+      std::vector<double>
+      strengths(const level_graph& g)
+      {
+        std::size_t n = g.order();
+        std::vector<double> k(n);
+        for (std::size_t v = 0; v != n; ++v) {
+          double s = 2 * g.loops[v];
+          for (std::size_t i = g.offsets[v]; i != g.offsets[v + 1]; ++i)
+            s += g.weights[i];
+          k[v] = s;
+        }
+        return k;
+      }
+
+      // Number the parts of p consecutively, in the order of their first
+      // vertices, and return the number of parts.
+      std::size_t
+      renumber(std::vector<std::size_t>& p)
+      {
+        std::vector<std::size_t> number(p.size(), -1);
+        std::size_t n = 0;
+        for (std::size_t& x : p) {
+          if (number[x] == std::size_t(-1))
+            number[x] = n++;
+          x = number[x];
+        }
+        return n;
+      }
+
+      // The state of a level: its graph, the strength of each vertex, and
+      // the strength of the graph (twice its total weight).
+      struct level
+      {
+        level(level_graph&& g)
+          : g(std::move(g)), k(strengths(this->g))
+        {
+          total = 0;
+          for (double x : k)
+            total += x;
+        }
+
+        level_graph         g;
+        std::vector<double> k;
+        double              total;
+      };
+
+      // Returns the modularity of the partition p of the graph g, whose
+      // vertices have the strengths k, which sum to total.
+      double
+      partition_modularity(const level_graph& g,
+                           const std::vector<double>& k,
+                           double total,
+                           const std::vector<std::size_t>& p,
+                           double resolution,
+                           std::size_t threads)
+      {
+        std::size_t n = g.order();
+        if (total == 0)
+          return 0;
+
+        // Sum the weights of the edges within parts, by block.
+        std::size_t blocks = block_count(n);
+        std::vector<double> inner(blocks);
+        search_impl::parallel_for(blocks, threads, [&](std::size_t b) {
+          double s = 0;
+          std::size_t last = std::min(n, (b + 1) * grain);
+          for (std::size_t v = b * grain; v != last; ++v) {
+            s += 2 * g.loops[v];
+            for (std::size_t i = g.offsets[v]; i != g.offsets[v + 1]; ++i)
+              if (p[g.targets[i]] == p[v])
+                s += g.weights[i];
+          }
+          inner[b] = s;
+        });
+
+        std::vector<double> tot(n);
+        for (std::size_t v = 0; v != n; ++v)
+          tot[p[v]] += k[v];
+        double q = 0;
+        for (double s : inner)
+          q += s;
+        q /= total;
+        for (double t : tot)
+          q -= resolution * (t / total) * (t / total);
+        return q;
+      }
+
+      // Move the vertices of the level x between the communities c until a
+      // sweep no longer improves the modularity, which is stored in q.
+      // Returns the number of sweeps.
+      std::size_t
+      move_vertices(const level& x,
+                    std::vector<std::size_t>& c,
+                    const community_options& opts,
+                    std::vector<weight_map>& maps,
+                    double& q)
+      {
+        const level_graph& g = x.g;
+        const double r = opts.resolution;
+        std::size_t n = g.order();
+        std::size_t blocks = block_count(n);
+
+        std::vector<double> tot(n);
+        std::vector<std::size_t> size(n);
+        auto tally = [&]() {
+          std::fill(tot.begin(), tot.end(), 0);
+          std::fill(size.begin(), size.end(), 0);
+          for (std::size_t v = 0; v != n; ++v) {
+            tot[c[v]] += x.k[v];
+            ++size[c[v]];
+          }
+        };
+        tally();
+        q = partition_modularity(g, x.k, x.total, c, r, opts.threads);
+
+        std::vector<std::size_t> next(n);
+        std::vector<std::size_t> moved(blocks);
+        std::size_t sweeps = 0;
+        while (sweeps < opts.max_sweeps) {
+          ++sweeps;
+          ORIGIN_COUNT("graph.community.sweeps");
+          for_blocks(blocks, opts.threads, maps,
+                     [&](std::size_t b, weight_map& m) {
+            std::size_t count = 0;
+            std::size_t last = std::min(n, (b + 1) * grain);
+            for (std::size_t v = b * grain; v != last; ++v) {
+              std::size_t a = c[v];
+              for (std::size_t i = g.offsets[v]; i != g.offsets[v + 1]; ++i)
+                m[c[g.targets[i]]] += g.weights[i];
+
+              // The gain of moving v to a community is proportional to its
+              // score less that of staying in a, from which v is removed.
+              double kv = x.k[v];
+              auto score = [&](std::size_t d, double w) {
+                return w - r * kv * (tot[d] - (d == a ? kv : 0)) / x.total;
+              };
+              auto i = m.find(a);
+              std::size_t best = a;
+              double top = score(a, i == m.end() ? 0 : i->second);
+              for (const auto& e : m) {
+                std::size_t d = e.first;
+                if (d == a || (size[a] == 1 && size[d] == 1 && d > a))
+                  continue;
+                double s = score(d, e.second);
+                if (s > top || (s == top && best != a && d < best)) {
+                  top = s;
+                  best = d;
+                }
+              }
+              next[v] = best;
+              count += best != a;
+              reset(m);
+            }
+            moved[b] = count;
+          });
+
+          std::size_t count = 0;
+          for (std::size_t k : moved)
+            count += k;
+          if (count == 0)
+            break;
+          c.swap(next);
+          tally();
+          double p =
+            partition_modularity(g, x.k, x.total, c, r, opts.threads);
+          if (p < q) {
+            c.swap(next);
+            tally();
+            break;
+          }
+          bool done = p - q <= opts.tolerance;
+          q = p;
+          if (done)
+            break;
+        }
+        return sweeps;
+      }
+
+      // Returns the refinement of the communities c of the level x, which
+      // are numbered from 0 to k - 1. Each community is split into
+      // singletons, which are visited in order and merged into the
+      // subcommunity of the same community that most increases the
+      // modularity. Only vertices and subcommunities that are well
+      // connected to the rest of their community are merged. Each part of
+      // the refinement is numbered by one of its vertices.
+      std::vector<std::size_t>
+      refine(const level& x,
+             const std::vector<std::size_t>& c,
+             std::size_t k,
+             const community_options& opts,
+             std::vector<weight_map>& maps)
+      {
+        const level_graph& g = x.g;
+        const double r = opts.resolution;
+        std::size_t n = g.order();
+
+        // The members of each community, in order.
+        std::vector<std::size_t> first(k + 1);
+        for (std::size_t v = 0; v != n; ++v)
+          ++first[c[v] + 1];
+        std::partial_sum(first.begin(), first.end(), first.begin());
+        std::vector<std::size_t> members(n);
+        std::vector<std::size_t> pos(first.begin(), first.end() - 1);
+        for (std::size_t v = 0; v != n; ++v)
+          members[pos[c[v]]++] = v;
+
+        // The subcommunity of each vertex, and the strength, size, and
+        // weight of the edges leaving each subcommunity for the rest of its
+        // community. Each community touches only the entries of its own
+        // vertices.
+        std::vector<std::size_t> sub(n);
+        std::vector<double> tot(n);
+        std::vector<std::size_t> size(n);
+        std::vector<double> out(n);
+
+        for_blocks(block_count(k), opts.threads, maps,
+                   [&](std::size_t b, weight_map& m) {
+          std::size_t last = std::min(k, (b + 1) * grain);
+          for (std::size_t d = b * grain; d != last; ++d) {
+            const std::size_t* vs = members.data() + first[d];
+            std::size_t count = first[d + 1] - first[d];
+            double all = 0;
+            for (std::size_t j = 0; j != count; ++j) {
+              std::size_t v = vs[j];
+              double w = 0;
+              for (std::size_t i = g.offsets[v]; i != g.offsets[v + 1]; ++i)
+                if (c[g.targets[i]] == d)
+                  w += g.weights[i];
+              sub[v] = v;
+              tot[v] = x.k[v];
+              size[v] = 1;
+              out[v] = w;
+              all += x.k[v];
+            }
+
+            for (std::size_t j = 0; j != count; ++j) {
+              std::size_t v = vs[j];
+              double kv = x.k[v];
+              if (size[sub[v]] != 1 || out[v] < r * kv * (all - kv) / x.total)
+                continue;
+              for (std::size_t i = g.offsets[v]; i != g.offsets[v + 1]; ++i) {
+                std::size_t u = g.targets[i];
+                if (c[u] == d)
+                  m[sub[u]] += g.weights[i];
+              }
+
+              std::size_t best = v;
+              double top = 0;
+              double link = 0;
+              for (const auto& e : m) {
+                std::size_t s = e.first;
+                if (s == v || out[s] < r * tot[s] * (all - tot[s]) / x.total)
+                  continue;
+                double gain = e.second - r * kv * tot[s] / x.total;
+                if (gain > top || (gain == top && best != v && s < best)) {
+                  top = gain;
+                  best = s;
+                  link = e.second;
+                }
+              }
+              reset(m);
+              if (best == v)
+                continue;
+              sub[v] = best;
+              tot[best] += kv;
+              ++size[best];
+              out[best] += out[v] - 2 * link;
+            }
+          }
+        });
+        return sub;
+      }
+
+      // Returns the graph of the parts p of g, of which there are k. Each
+      // part becomes a vertex, whose loops hold the weight of the edges
+      // within the part, and the edges between two parts become one edge.
+      level_graph
+      aggregate(const level_graph& g,
+                const std::vector<std::size_t>& p,
+                std::size_t k,
+                std::size_t threads,
+                std::vector<weight_map>& maps)
+      {
+        ORIGIN_TIME_SCOPE("graph.community.aggregate");
+        std::size_t n = g.order();
+        std::vector<std::size_t> first(k + 1);
+        for (std::size_t v = 0; v != n; ++v)
+          ++first[p[v] + 1];
+        std::partial_sum(first.begin(), first.end(), first.begin());
+        std::vector<std::size_t> members(n);
+        std::vector<std::size_t> pos(first.begin(), first.end() - 1);
+        for (std::size_t v = 0; v != n; ++v)
+          members[pos[p[v]]++] = v;
+
+        // Gather the edges of each part, in order of their targets.
+        using edge_list = std::vector<std::pair<std::size_t, double>>;
+        std::vector<edge_list> edges(k);
+        level_graph a;
+        a.loops.assign(k, 0);
+        std::size_t blocks = block_count(k);
+        for_blocks(blocks, threads, maps, [&](std::size_t b, weight_map& m) {
+          std::size_t last = std::min(k, (b + 1) * grain);
+          for (std::size_t d = b * grain; d != last; ++d) {
+            double loops = 0;
+            for (std::size_t j = first[d]; j != first[d + 1]; ++j) {
+              std::size_t v = members[j];
+              loops += g.loops[v];
+              for (std::size_t i = g.offsets[v]; i != g.offsets[v + 1]; ++i) {
+                std::size_t e = p[g.targets[i]];
+                if (e == d)
+                  loops += g.weights[i] / 2;  // Seen from both endpoints
+                else
+                  m[e] += g.weights[i];
+              }
+            }
+            a.loops[d] = loops;
+            edges[d].assign(m.begin(), m.end());
+            std::sort(edges[d].begin(), edges[d].end());
+            reset(m);
+          }
+        });
+
+        a.offsets.assign(k + 1, 0);
+        for (std::size_t d = 0; d != k; ++d)
+          a.offsets[d + 1] = a.offsets[d] + edges[d].size();
+        a.targets.resize(a.offsets[k]);
+        a.weights.resize(a.offsets[k]);
+        search_impl::parallel_for(blocks, threads, [&](std::size_t b) {
+          std::size_t last = std::min(k, (b + 1) * grain);
+          for (std::size_t d = b * grain; d != last; ++d) {
+            std::size_t i = a.offsets[d];
+            for (const auto& e : edges[d]) {
+              a.targets[i] = e.first;
+              a.weights[i++] = e.second;
+            }
+            edge_list().swap(edges[d]);
+          }
+        });
+        return a;
+      }
+    } // namespace
+
+
+    community_summary
+    detect(level_graph g,
+           std::vector<std::size_t>& labels,
+           const community_options& opts,
+           bool refined)
+    {
+      ORIGIN_TIME_SCOPE("graph.community");
+      std::size_t n = g.order();
+      level x(std::move(g));
+      community_summary s {n, 0, 0, 0};
+
+      // The vertex of the current level that holds each vertex of g.
+      std::vector<std::size_t> at(n);
+      std::iota(at.begin(), at.end(), 0);
+      std::vector<std::size_t> c = at;
+      if (x.total == 0) {
+        labels = c;
+        return s;
+      }
+
+      std::vector<weight_map> maps;
+      while (s.levels < opts.max_levels) {
+        ++s.levels;
+        ORIGIN_COUNT("graph.community.levels");
+        double q;
+        s.sweeps += move_vertices(x, c, opts, maps, q);
+        bool gained = q - s.modularity > opts.tolerance || s.levels == 1;
+        s.modularity = q;
+        std::size_t k = renumber(c);
+
+        // Aggregate the communities, or their refinement.
+        std::vector<std::size_t> p = c;
+        std::size_t parts = k;
+        if (refined) {
+          p = refine(x, c, k, opts, maps);
+          parts = renumber(p);
+        }
+        if (parts == x.g.order() || !gained)
+          break;
+        for (std::size_t& v : at)
+          v = p[v];
+        std::vector<std::size_t> start(parts);
+        for (std::size_t v = 0; v != x.g.order(); ++v)
+          start[p[v]] = refined ? c[v] : p[v];
+        x = level(aggregate(x.g, p, parts, opts.threads, maps));
+        c.swap(start);
+      }
+
+      labels.resize(n);
+      for (std::size_t v = 0; v != n; ++v)
+        labels[v] = c[at[v]];
+      s.communities = renumber(labels);
+      return s;
+    }
+
+    double
+    modularity(const level_graph& g,
+               const std::vector<std::size_t>& labels,
+               double resolution,
+               std::size_t threads)
+    {
+      std::vector<double> k = strengths(g);
+      double total = 0;
+      for (double x : k)
+        total += x;
+      return partition_modularity(g, k, total, labels, resolution, threads);
+    }
+
+  } // namespace community_impl
+
+} // namespace origin
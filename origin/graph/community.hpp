@@ -0,0 +1,273 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COMMUNITY_HPP
+#define ORIGIN_GRAPH_COMMUNITY_HPP
+
+#include <cassert>
+
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.community]
+  //                          Community Detection
+  //
+  // A community is a set of vertices that are more densely connected to
+  // each other than to the rest of the graph. The quality of a partition of
+  // the vertices into communities is measured by its modularity:
+  //
+  //    Q = sum over communities c of in(c) / 2m - r * (tot(c) / 2m)^2
+  //
+  // where in(c) is twice the weight of the edges within c, tot(c) is the
+  // total weight of the edges incident to the vertices of c, m is the total
+  // weight of the edges of the graph, and r is the resolution. A greater
+  // resolution yields smaller communities. The following operations are
+  // provided:
+  //
+  //    louvain(g, labels[, opts])
+  //    leiden(g, labels[, opts])
+  //    modularity(g, labels[, resolution])
+  //
+  // The weight of an edge e is its value, g(e), if that is of an arithmetic
+  // type, and 1 otherwise. Weights must be non-negative. The edges of a
+  // directed graph are considered without regard to their direction, so
+  // that a compressed graph built from an undirected graph, which holds
+  // each edge in both directions, has the communities of that graph.
+  //
+  // The communities are written into a vector labels, indexed by vertex
+  // handle, such that labels[v] is the community of v, in [0, k) for k
+  // communities. Entries for handles that do not refer to vertices are
+  // size_t(-1).
+  //
+  // The Louvain method (Blondel et al.) alternates two phases. The local
+  // moving phase sweeps over the vertices, moving each to the community of
+  // a neighbor that most increases the modularity, until a sweep no longer
+  // increases it by more than the tolerance. The aggregation phase then
+  // replaces each community by a single vertex, with a loop holding the
+  // weight of its internal edges, and the method is repeated on that graph
+  // until no vertex moves. Each level is stored in compressed sparse row
+  // form, which the aggregation phase builds in parallel over communities.
+  //
+  // The Leiden method (Traag et al.) refines the communities found by each
+  // local moving phase before aggregating them: each community is split
+  // into singletons, which are merged greedily into well-connected
+  // subcommunities. The subcommunities are aggregated, and the next level
+  // starts from the unrefined communities. The communities it finds are
+  // connected, which those of the Louvain method need not be.
+  //
+  // Both methods sweep over blocks of vertices in parallel. The gain of
+  // each move is computed from the weights of the edges between a vertex
+  // and each neighboring community, which are summed in a flat hash map
+  // (see data.flat_hash_map) owned by each thread. The vertices of a sweep
+  // choose their moves from the communities of the previous sweep, and the
+  // moves are applied together, so that the result does not depend on the
+  // number of threads. To keep pairs of vertices from swapping communities,
+  // a vertex alone in its community moves to the community of another
+  // single vertex only if that community has the lesser label. A sweep that
+  // decreases the modularity is undone and ends the local moving phase.
+
+  // The options of community detection.
+  struct community_options
+  {
+    community_options()
+      : resolution(1),
+        tolerance(1e-6),
+        max_levels(32),
+        max_sweeps(32),
+        threads(search_threads())
+    { }
+
+    double      resolution;   // The resolution of the modularity
+    double      tolerance;    // The least gain of a sweep that continues
+    std::size_t max_levels;   // The maximum number of aggregations
+    std::size_t max_sweeps;   // The maximum number of sweeps per level
+    std::size_t threads;      // The maximum number of threads
+  };
+
+  // The outcome of community detection.
+  struct community_summary
+  {
+    std::size_t communities;  // The number of communities
+    std::size_t levels;       // The number of local moving phases
+    std::size_t sweeps;       // The number of sweeps of all levels
+    double      modularity;   // The modularity of the communities
+  };
+
+
+  namespace community_impl
+  {
+    // A weighted undirected graph in compressed sparse row form. The
+    // neighbors of v are targets[offsets[v]] to targets[offsets[v + 1]],
+    // with the weights of the edges that join them; each edge is stored at
+    // both of its endpoints. The weight of the loops of v is held in
+    // loops[v] rather than in its edges.
+    struct level_graph
+    {
+      std::size_t order() const { return loops.size(); }
+
+      std::vector<std::size_t> offsets;
+      std::vector<std::size_t> targets;
+      std::vector<double>      weights;
+      std::vector<double>      loops;
+    };
+
+    // Returns the weight of the edge e: its value when that is arithmetic,
+    // and 1 otherwise.
+    template<typename G>
+      inline double
+      edge_weight(const G& g, Edge<G> e, std::true_type)
+      {
+        return g(e);
+      }
+
+    template<typename G>
+      inline double
+      edge_weight(const G&, Edge<G>, std::false_type)
+      {
+        return 1;
+      }
+
+    template<typename G>
+      using Has_weights = std::is_arithmetic<
+        Decay<decltype(std::declval<const G&>()(std::declval<Edge<G>>()))>
+      >;
+
+    // Returns the level graph of g, numbering its vertices in the order of
+    // g.vertices(). The number of each vertex handle is stored in index.
+    template<typename G>
+      level_graph
+      make_level_graph(const G& g, std::vector<std::size_t>& index)
+      {
+        index.assign(search_impl::vertex_bound(g), -1);
+        std::size_t n = 0;
+        for (Vertex<G> v : g.vertices())
+          index[v] = n++;
+
+        level_graph lg;
+        lg.offsets.assign(n + 1, 0);
+        lg.loops.assign(n, 0);
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = index[g.source(e)];
+          std::size_t v = index[g.target(e)];
+          if (u != v) {
+            ++lg.offsets[u + 1];
+            ++lg.offsets[v + 1];
+          }
+        }
+        std::partial_sum(lg.offsets.begin(), lg.offsets.end(),
+                         lg.offsets.begin());
+
+        lg.targets.resize(lg.offsets[n]);
+        lg.weights.resize(lg.offsets[n]);
+        std::vector<std::size_t> next(lg.offsets.begin(), lg.offsets.end() - 1);
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = index[g.source(e)];
+          std::size_t v = index[g.target(e)];
+          double w = edge_weight(g, e, Has_weights<G>{});
+          assert(w >= 0);
+          if (u == v) {
+            lg.loops[u] += w;
+            continue;
+          }
+          lg.targets[next[u]] = v;
+          lg.weights[next[u]++] = w;
+          lg.targets[next[v]] = u;
+          lg.weights[next[v]++] = w;
+        }
+        return lg;
+      }
+
+    // Partition the vertices of g into communities, writing the community
+    // of each into labels. The Leiden method is used if refine is true. See
+    // community.cpp.
+    community_summary detect(level_graph g,
+                             std::vector<std::size_t>& labels,
+                             const community_options& opts,
+                             bool refine);
+
+    // Returns the modularity of the partition labels of g.
+    double modularity(const level_graph& g,
+                      const std::vector<std::size_t>& labels,
+                      double resolution,
+                      std::size_t threads);
+
+    // Partition g and write the communities by vertex handle.
+    template<typename G>
+      community_summary
+      detect(const G& g,
+             std::vector<std::size_t>& labels,
+             const community_options& opts,
+             bool refine)
+      {
+        static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+        std::vector<std::size_t> index;
+        std::vector<std::size_t> found;
+        community_summary s =
+          detect(make_level_graph(g, index), found, opts, refine);
+        labels.assign(index.size(), -1);
+        for (std::size_t v = 0; v != index.size(); ++v)
+          if (index[v] != std::size_t(-1))
+            labels[v] = found[index[v]];
+        return s;
+      }
+
+  } // namespace community_impl
+
+
+  // Partition the vertices of g into communities by the Louvain method,
+  // writing the community of each vertex into labels.
+  template<typename G>
+    inline community_summary
+    louvain(const G& g,
+            std::vector<std::size_t>& labels,
+            const community_options& opts = {})
+    {
+      return community_impl::detect(g, labels, opts, false);
+    }
+
+  // Partition the vertices of g into connected communities by the Leiden
+  // method, writing the community of each vertex into labels.
+  template<typename G>
+    inline community_summary
+    leiden(const G& g,
+           std::vector<std::size_t>& labels,
+           const community_options& opts = {})
+    {
+      return community_impl::detect(g, labels, opts, true);
+    }
+
+  // Returns the modularity of the partition of the vertices of g given by
+  // labels, whose entries are less than g.order().
+  template<typename G>
+    double
+    modularity(const G& g,
+               const std::vector<std::size_t>& labels,
+               double resolution = 1)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      std::vector<std::size_t> index;
+      community_impl::level_graph lg =
+        community_impl::make_level_graph(g, index);
+      std::vector<std::size_t> parts(lg.order());
+      for (std::size_t v = 0; v != index.size(); ++v)
+        if (index[v] != std::size_t(-1)) {
+          assert(labels[v] < lg.order());
+          parts[index[v]] = labels[v];
+        }
+      return community_impl::modularity(lg, parts, resolution,
+                                        search_threads());
+    }
+
+} // namespace origin
+
+#endif
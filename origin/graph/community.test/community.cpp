@@ -0,0 +1,240 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <set>
+
+#include <origin/graph/community.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+using namespace std;
+using namespace origin;
+
+using graph = undirected_adjacency_vector<>;
+using weighted_graph = undirected_adjacency_vector<empty_t, double>;
+
+// Build a ring of k cliques of s vertices, in which consecutive cliques are
+// joined by a single edge.
+graph
+build_ring_of_cliques(size_t k, size_t s)
+{
+  graph g;
+  for (size_t i = 0; i != k * s; ++i)
+    g.add_vertex();
+  for (size_t c = 0; c != k; ++c) {
+    for (size_t i = 0; i != s; ++i)
+      for (size_t j = i + 1; j != s; ++j)
+        g.add_edge(c * s + i, c * s + j);
+    g.add_edge(c * s, ((c + 1) % k) * s + 1);
+  }
+  return g;
+}
+
+// Build a graph of n vertices in k planted groups, in which vertices of the
+// same group are adjacent with probability p and others with probability q.
+graph
+build_planted_graph(size_t n, size_t k, double p, double q, size_t seed)
+{
+  graph g;
+  for (size_t i = 0; i != n; ++i)
+    g.add_vertex();
+  minstd_rand prng(seed);
+  uniform_real_distribution<double> coin;
+  for (size_t i = 0; i != n; ++i)
+    for (size_t j = i + 1; j != n; ++j)
+      if (coin(prng) < (i % k == j % k ? p : q))
+        g.add_edge(i, j);
+  return g;
+}
+
+// Returns true if each part of labels is the set of vertices of a clique of
+// s vertices, as built above.
+bool
+finds_cliques(const vector<size_t>& labels, size_t k, size_t s)
+{
+  set<size_t> seen;
+  for (size_t c = 0; c != k; ++c) {
+    for (size_t i = 1; i != s; ++i)
+      if (labels[c * s + i] != labels[c * s])
+        return false;
+    seen.insert(labels[c * s]);
+  }
+  return seen.size() == k && *seen.rbegin() == k - 1;
+}
+
+// Returns true if the vertices of each part of labels induce a connected
+// subgraph of g.
+template<typename G>
+  bool
+  connected_parts(const G& g, const vector<size_t>& labels)
+  {
+    size_t n = g.order();
+    vector<char> seen(n);
+    set<size_t> done;
+    for (size_t s = 0; s != n; ++s) {
+      if (seen[s])
+        continue;
+      if (!done.insert(labels[s]).second)
+        return false;
+      vector<size_t> stack {s};
+      seen[s] = true;
+      while (!stack.empty()) {
+        size_t v = stack.back();
+        stack.pop_back();
+        for (Edge<G> e : g.edges(v)) {
+          size_t u = opposite(g, e, v);
+          if (!seen[u] && labels[u] == labels[v]) {
+            seen[u] = true;
+            stack.push_back(u);
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+// The modularity of a partition agrees with its definition.
+void
+check_modularity()
+{
+  // Two triangles joined by an edge: 7 edges, 3 within each triangle, and
+  // each triangle has a total degree of 7.
+  graph g;
+  for (int i = 0; i != 6; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1);
+  g.add_edge(1, 2);
+  g.add_edge(2, 0);
+  g.add_edge(3, 4);
+  g.add_edge(4, 5);
+  g.add_edge(5, 3);
+  g.add_edge(2, 3);
+
+  vector<size_t> halves {0, 0, 0, 1, 1, 1};
+  assert(abs(modularity(g, halves) - (12.0 / 14 - 0.5)) < 1e-12);
+  vector<size_t> one(6, 0);
+  assert(abs(modularity(g, one)) < 1e-12);
+  assert(abs(modularity(g, halves, 2) - (12.0 / 14 - 1)) < 1e-12);
+
+  vector<size_t> labels;
+  community_summary s = louvain(g, labels);
+  assert(labels == halves);
+  assert(s.communities == 2);
+  assert(abs(s.modularity - modularity(g, labels)) < 1e-12);
+
+  // A graph without edges has no communities larger than a vertex.
+  graph h;
+  for (int i = 0; i != 3; ++i)
+    h.add_vertex();
+  s = leiden(h, labels);
+  assert(s.communities == 3 && s.modularity == 0);
+  assert((labels == vector<size_t> {0, 1, 2}));
+}
+
+// Both methods find the cliques of a ring of cliques, in adjacency vectors
+// and compressed graphs, with any number of threads.
+void
+check_cliques()
+{
+  const size_t k = 12, s = 6;
+  graph g = build_ring_of_cliques(k, s);
+  compressed_graph<> c(g);
+  for (bool refine : {false, true}) {
+    vector<size_t> labels;
+    community_options opts;
+    opts.threads = 1;
+    community_summary x = refine ? leiden(g, labels, opts)
+                                 : louvain(g, labels, opts);
+    assert(finds_cliques(labels, k, s));
+    assert(x.communities == k);
+    assert(abs(x.modularity - modularity(g, labels)) < 1e-12);
+
+    vector<size_t> other;
+    opts.threads = 4;
+    community_summary y = refine ? leiden(c, other, opts)
+                                 : louvain(c, other, opts);
+    assert(other == labels);
+    assert(y.communities == k && abs(y.modularity - x.modularity) < 1e-12);
+  }
+}
+
+// Edge weights decide the communities of a weighted graph.
+void
+check_weights()
+{
+  weighted_graph g;
+  for (int i = 0; i != 6; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1, 10.0);
+  g.add_edge(1, 2, 0.5);
+  g.add_edge(2, 3, 10.0);
+  g.add_edge(3, 4, 0.5);
+  g.add_edge(4, 5, 10.0);
+  g.add_edge(5, 0, 0.5);
+
+  vector<size_t> labels;
+  louvain(g, labels);
+  assert((labels == vector<size_t> {0, 0, 1, 1, 2, 2}));
+
+  // Reweighting the ring pairs it the other way.
+  weighted_graph h;
+  for (int i = 0; i != 6; ++i)
+    h.add_vertex();
+  h.add_edge(0, 1, 0.5);
+  h.add_edge(1, 2, 10.0);
+  h.add_edge(2, 3, 0.5);
+  h.add_edge(3, 4, 10.0);
+  h.add_edge(4, 5, 0.5);
+  h.add_edge(5, 0, 10.0);
+  leiden(h, labels);
+  assert((labels == vector<size_t> {0, 1, 1, 2, 2, 0}));
+}
+
+// On a larger graph with planted groups, the methods aggregate over several
+// levels, find the groups, and the Leiden communities are connected.
+void
+check_planted()
+{
+  const size_t n = 3000, k = 30;
+  graph g = build_planted_graph(n, k, 0.2, 0.002, 7);
+  for (bool refine : {false, true}) {
+    vector<size_t> labels;
+    community_summary s = refine ? leiden(g, labels) : louvain(g, labels);
+    assert(labels.size() == n);
+    assert(s.levels >= 2 && s.sweeps >= s.levels);
+    assert(abs(s.modularity - modularity(g, labels)) < 1e-9);
+
+    vector<size_t> planted(n);
+    for (size_t v = 0; v != n; ++v)
+      planted[v] = v % k;
+    assert(s.modularity >= modularity(g, planted) - 1e-9);
+    assert(s.communities == k);
+    for (size_t v = 0; v != n; ++v)
+      assert(labels[v] == labels[v % k]);
+    if (refine)
+      assert(connected_parts(g, labels));
+
+    // A greater resolution yields more communities.
+    community_options opts;
+    opts.resolution = 20;
+    vector<size_t> fine;
+    community_summary t = refine ? leiden(g, fine, opts)
+                                 : louvain(g, fine, opts);
+    assert(t.communities > s.communities);
+  }
+}
+
+int main()
+{
+  check_modularity();
+  check_cliques();
+  check_weights();
+  check_planted();
+}
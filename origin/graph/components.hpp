@@ -0,0 +1,889 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COMPONENTS_HPP
+#define ORIGIN_GRAPH_COMPONENTS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.union_find]
+  //                              Disjoint Sets
+  //
+  // A disjoint set structure (or union-find) maintains a partition of the
+  // integers [0, n) into sets. Each set is identified by a representative
+  // element, which is returned by find(x) for every x in the set. Two sets
+  // are merged by unite(x, y).
+  //
+  // The disjoint_sets class uses union by rank and path halving, so that a
+  // sequence of m operations takes O(m alpha(n)) time, where alpha is the
+  // inverse of Ackermann's function. Elements can be added with grow(n).
+  //
+  // The concurrent_disjoint_sets class can be safely used by many threads at
+  // once, without locks. Its parent links are atomic, and a root is always
+  // linked below a root with a lower index, so that races between threads
+  // cannot create cycles. Concurrent finds compress paths by halving, using
+  // compare-and-swap. Because it does not use ranks, a sequence of
+  // operations takes O(m log n) time in the worst case, but in practice
+  // trees are very shallow.
+  class disjoint_sets
+  {
+  public:
+    // Initialize n singleton sets.
+    explicit disjoint_sets(std::size_t n = 0)
+      : parent_(n), rank_(n), count_(n)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        parent_[i] = i;
+    }
+
+    // Observers
+    std::size_t size() const  { return parent_.size(); }
+    std::size_t count() const { return count_; }
+
+    // Add singleton sets until there are n elements.
+    void grow(std::size_t n);
+
+    // Returns the representative of the set containing x.
+    std::size_t find(std::size_t x);
+
+    // Merge the sets containing x and y. Returns true if they were not
+    // already the same set.
+    bool unite(std::size_t x, std::size_t y);
+
+    // Returns true if x and y are in the same set.
+    bool same(std::size_t x, std::size_t y) { return find(x) == find(y); }
+
+  private:
+    std::vector<std::size_t> parent_;
+    std::vector<unsigned char> rank_;
+    std::size_t count_;  // Number of sets
+  };
+
+  inline void
+  disjoint_sets::grow(std::size_t n)
+  {
+    for (std::size_t i = parent_.size(); i < n; ++i) {
+      parent_.push_back(i);
+      rank_.push_back(0);
+      ++count_;
+    }
+  }
+
+  inline std::size_t
+  disjoint_sets::find(std::size_t x)
+  {
+    assert(x < size());
+    while (parent_[x] != x) {
+      parent_[x] = parent_[parent_[x]];
+      x = parent_[x];
+    }
+    return x;
+  }
+
+  inline bool
+  disjoint_sets::unite(std::size_t x, std::size_t y)
+  {
+    x = find(x);
+    y = find(y);
+    if (x == y)
+      return false;
+    if (rank_[x] < rank_[y])
+      std::swap(x, y);
+    parent_[y] = x;
+    if (rank_[x] == rank_[y])
+      ++rank_[x];
+    --count_;
+    return true;
+  }
+
+
+  class concurrent_disjoint_sets
+  {
+  public:
+    // Initialize n singleton sets.
+    explicit concurrent_disjoint_sets(std::size_t n)
+      : parent_(n)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        parent_[i].store(i, std::memory_order_relaxed);
+    }
+
+    // Observers
+    std::size_t size() const { return parent_.size(); }
+
+    // Returns the representative of the set containing x. If other threads
+    // are merging sets, the result is a representative at some point during
+    // the call.
+    std::size_t find(std::size_t x);
+
+    // Merge the sets containing x and y. Returns true if they were not
+    // already the same set.
+    bool unite(std::size_t x, std::size_t y);
+
+    bool same(std::size_t x, std::size_t y) { return find(x) == find(y); }
+
+  private:
+    std::vector<std::atomic<std::size_t>> parent_;
+  };
+
+  inline std::size_t
+  concurrent_disjoint_sets::find(std::size_t x)
+  {
+    assert(x < size());
+    while (true) {
+      std::size_t p = parent_[x].load(std::memory_order_relaxed);
+      if (p == x)
+        return x;
+      std::size_t q = parent_[p].load(std::memory_order_relaxed);
+      if (q != p)
+        parent_[x].compare_exchange_weak(p, q, std::memory_order_relaxed);
+      x = q;
+    }
+  }
+
+  // Link the root with the greater index below the other. If the root has
+  // been linked by another thread in the meantime, start over.
+  inline bool
+  concurrent_disjoint_sets::unite(std::size_t x, std::size_t y)
+  {
+    while (true) {
+      x = find(x);
+      y = find(y);
+      if (x == y)
+        return false;
+      if (x < y)
+        std::swap(x, y);
+      std::size_t r = x;
+      if (parent_[x].compare_exchange_strong(r, y, std::memory_order_relaxed))
+        return true;
+    }
+  }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.components]
+  //                          Connected Components
+  //
+  // The connected components of a graph are its maximal connected subgraphs.
+  // The edges of a directed graph are treated as undirected, so that its
+  // weakly connected components are computed. The following algorithms are
+  // provided:
+  //
+  //    connected_components(g, labels)
+  //    parallel_connected_components(g, labels[, threads])
+  //    incremental_components<G>
+  //
+  // Components are written to a dense label array indexed by vertex handle.
+  // Each component is labeled with an integer in [0, k), where k is the
+  // number of components, in the order in which the first vertex of each
+  // component is enumerated by g.vertices(). The labels of handles that do
+  // not refer to vertices (because vertices have been removed) are
+  // size_t(-1).
+  //
+  // The parallel algorithm is a simplified Afforest (Sutton et al.). It
+  // first links each vertex with its first few neighbors, which is enough to
+  // connect most of the largest component of a typical graph. It then finds
+  // that component by sampling, and only processes the remaining edges of
+  // vertices outside of it. Edges are linked concurrently using a
+  // concurrent_disjoint_sets. The parallel algorithm requires an undirected
+  // graph, so that each edge is reachable from both of its endpoints.
+
+
+  namespace components_impl
+  {
+    // Write the dense label of the set containing each vertex of g to
+    // labels, returning the number of components.
+    template<typename G, typename Sets>
+      std::size_t
+      number_components(const G& g, Sets& sets,
+                        std::vector<std::size_t>& labels)
+      {
+        std::size_t n = sets.size();
+        std::vector<std::size_t> index(n, -1);
+        labels.assign(n, -1);
+        std::size_t k = 0;
+        for (Vertex<G> v : g.vertices()) {
+          std::size_t r = sets.find(v);
+          if (index[r] == std::size_t(-1))
+            index[r] = k++;
+          labels[v] = index[r];
+        }
+        return k;
+      }
+
+    // The number of neighbors of each vertex linked before sampling, and
+    // the number of vertices sampled to find the largest component.
+    constexpr std::size_t afforest_rounds = 2;
+    constexpr std::size_t afforest_samples = 1024;
+
+    // The number of vertices processed by each parallel task.
+    constexpr std::size_t grain = 1024;
+
+  } // namespace components_impl
+
+
+  // Compute the connected components of g, writing the label of each vertex
+  // to labels. Returns the number of components.
+  template<typename G>
+    std::size_t
+    connected_components(const G& g, std::vector<std::size_t>& labels)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      disjoint_sets sets(search_impl::vertex_bound(g));
+      for (Edge<G> e : g.edges())
+        sets.unite(g.source(e), g.target(e));
+      return components_impl::number_components(g, sets, labels);
+    }
+
+
+  // Compute the connected components of g using up to threads threads,
+  // writing the label of each vertex to labels. Returns the number of
+  // components.
+  template<typename G>
+    std::size_t
+    parallel_connected_components(const G& g,
+                                  std::vector<std::size_t>& labels,
+                                  std::size_t threads = search_threads())
+    {
+      static_assert(Undirected_graph<G>(), "");
+      using namespace components_impl;
+      using V = Vertex<G>;
+
+      std::vector<V> verts;
+      verts.reserve(g.order());
+      for (V v : g.vertices())
+        verts.push_back(v);
+      std::size_t n = verts.size();
+      std::size_t blocks = (n + grain - 1) / grain;
+      concurrent_disjoint_sets sets(search_impl::vertex_bound(g));
+
+      // Link the vertices of each block with their neighbors in the range
+      // [first, last) of their incident edges, skipping those in the
+      // component c.
+      auto link = [&](std::size_t first, std::size_t last, std::size_t c) {
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t end = std::min(n, (k + 1) * grain);
+          for (std::size_t i = k * grain; i != end; ++i) {
+            V u = verts[i];
+            if (c != std::size_t(-1) && sets.find(u) == c)
+              continue;
+            std::size_t j = 0;
+            for (Edge<G> e : g.edges(u)) {
+              if (j >= last)
+                break;
+              if (j++ >= first)
+                sets.unite(u, opposite(g, e, u));
+            }
+          }
+        });
+      };
+
+      // Link the first few neighbors of each vertex.
+      for (std::size_t r = 0; r != afforest_rounds; ++r)
+        link(r, r + 1, -1);
+
+      // Find the most frequent representative in a sample of vertices.
+      std::size_t c = -1;
+      if (n != 0) {
+        std::minstd_rand prng(n);
+        std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+        std::vector<std::size_t> sample(afforest_samples);
+        for (std::size_t& x : sample)
+          x = sets.find(verts[dist(prng)]);
+        std::sort(sample.begin(), sample.end());
+        std::size_t best = 0;
+        for (std::size_t i = 0, j; i != sample.size(); i = j) {
+          for (j = i; j != sample.size() && sample[j] == sample[i]; ++j)
+            ;
+          if (j - i > best) {
+            best = j - i;
+            c = sample[i];
+          }
+        }
+      }
+
+      // Link the remaining neighbors of vertices outside that component.
+      link(afforest_rounds, -1, c);
+      return number_components(g, sets, labels);
+    }
+
+
+  // The incremental components class maintains the connected components of
+  // a graph while vertices and edges are added to it. Vertices and edges are
+  // added through the incremental components object, which forwards them to
+  // the graph and merges the components of the endpoints of each edge in
+  // near-constant time, so that components never need to be recomputed.
+  // The components of a graph that has been modified by some other means,
+  // or from which vertices or edges have been removed, must be recomputed
+  // by reset().
+  template<typename G>
+    class incremental_components
+    {
+    public:
+      // Initialize the components with those of g.
+      explicit incremental_components(G& g)
+        : g(g)
+      {
+        reset();
+      }
+
+      // Observers
+      const G& graph() const { return g; }
+
+      // Returns the number of components.
+      std::size_t count() const { return sets.count() - holes; }
+
+      // Returns true if u and v are in the same component.
+      bool connected(Vertex<G> u, Vertex<G> v) { return sets.same(u, v); }
+
+      // Returns the representative of the component of v. Representatives
+      // change as components are merged.
+      std::size_t component(Vertex<G> v) { return sets.find(v); }
+
+      // Write the label of each vertex to labels, returning the number of
+      // components (see [graph.components]).
+      std::size_t labels(std::vector<std::size_t>& ls)
+      {
+        return components_impl::number_components(g, sets, ls);
+      }
+
+      // Add a vertex to the graph, as if by g.add_vertex(args...).
+      template<typename... Args>
+        Vertex<G> add_vertex(Args&&... args)
+        {
+          Vertex<G> v = g.add_vertex(std::forward<Args>(args)...);
+          if (v < sets.size())
+            --holes;
+          else
+            sets.grow(std::size_t(v) + 1);
+          return v;
+        }
+
+      // Add an edge to the graph, as if by g.add_edge(u, v, args...).
+      template<typename... Args>
+        Edge<G> add_edge(Vertex<G> u, Vertex<G> v, Args&&... args)
+        {
+          Edge<G> e = g.add_edge(u, v, std::forward<Args>(args)...);
+          sets.unite(u, v);
+          return e;
+        }
+
+      // Add each edge described by the range r (see [graph.bulk]).
+      template<typename R>
+        void add_edges(const R& r)
+        {
+          g.add_edges(r);
+          for (const auto& x : r)
+            sets.unite(std::get<0>(x), std::get<1>(x));
+        }
+
+      // Recompute the components from the graph.
+      void reset();
+
+    private:
+      G& g;
+      disjoint_sets sets;
+      std::size_t holes;  // Handles that do not refer to vertices
+    };
+
+  template<typename G>
+    void
+    incremental_components<G>::reset()
+    {
+      std::size_t n = search_impl::vertex_bound(g);
+      sets = disjoint_sets(n);
+      holes = n - g.order();
+      for (Edge<G> e : g.edges())
+        sets.unite(g.source(e), g.target(e));
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                              [graph.strong]
+  //                     Strongly Connected Components
+  //
+  // The strongly connected components of a directed graph are its maximal
+  // subgraphs in which every vertex is reachable from every other. The
+  // following algorithms are provided:
+  //
+  //    strong_components(g, labels)
+  //    parallel_strong_components(g, labels[, threads])
+  //    topological_sort(g, order)
+  //
+  // Components are written to a dense label array indexed by vertex handle,
+  // as for connected components; the labels of handles that do not refer to
+  // vertices are size_t(-1). strong_components labels the components in
+  // reverse topological order: if an edge leads from a vertex labeled a to
+  // one labeled b, then a >= b. parallel_strong_components labels them in
+  // the order in which the first vertex of each component is enumerated by
+  // g.vertices(), like connected_components.
+  //
+  // The serial algorithm is Pearce's variant of Tarjan's algorithm, which
+  // stores a single index per vertex. The search is iterative: the position
+  // of the search in the out edges of each vertex on the current path is
+  // kept on an explicit stack, so that the depth of the search is not
+  // limited by the size of the call stack.
+  //
+  // The parallel algorithm follows Multistep (Slota et al.). It first trims
+  // the vertices without in or out edges (each is a component), then finds
+  // the component of a vertex of high degree, which is the largest component
+  // of a typical graph, as the intersection of the vertices reachable from
+  // it by forward and backward breadth-first searches. The remaining
+  // vertices are partitioned by coloring: each vertex takes the largest
+  // handle of the vertices that reach it, and the vertices of each color
+  // that reach the vertex of that handle are a component. Coloring is
+  // repeated on the vertices not yet in a component.
+  //
+  // The topological sort writes the vertices of an acyclic graph to order,
+  // so that the source of each edge precedes its target. It follows Kahn's
+  // algorithm, keeping the in degree of each vertex in a dense array, and
+  // returns false if the graph has a cycle. The vertices of a graph with
+  // cycles that are not reachable from a cycle are still written to order.
+
+
+  namespace components_impl
+  {
+    // Write the dense label of the representative comp[v] of each vertex of
+    // g to labels, returning the number of components.
+    template<typename G, typename C>
+      std::size_t
+      number_representatives(const G& g, const C& comp, std::size_t n,
+                             std::vector<std::size_t>& labels)
+      {
+        std::vector<std::size_t> index(n, -1);
+        labels.assign(n, -1);
+        std::size_t k = 0;
+        for (Vertex<G> v : g.vertices()) {
+          std::size_t r = comp[v];
+          if (index[r] == std::size_t(-1))
+            index[r] = k++;
+          labels[v] = index[r];
+        }
+        return k;
+      }
+
+    // Returns the targets of the out edges (if out is true) or the sources
+    // of the in edges of v, through f.
+    template<typename G, typename F>
+      inline void
+      for_adjacent(const G& g, Vertex<G> v, bool out, F f)
+      {
+        if (out) {
+          for (Edge<G> e : g.out_edges(v))
+            f(g.target(e));
+        } else {
+          for (Edge<G> e : g.in_edges(v))
+            f(g.source(e));
+        }
+      }
+
+    // The state of a parallel strong components computation. The component
+    // of each vertex is the handle of a vertex in it, or -1 if it has not
+    // been found.
+    template<typename G>
+      class strong_engine
+      {
+        using V = Vertex<G>;
+      public:
+        strong_engine(const G& g, std::size_t threads);
+
+        // Find the component of each vertex.
+        void run();
+
+        std::size_t bound() const { return n; }
+        std::size_t operator[](std::size_t v) const
+        {
+          return comp[v].load(std::memory_order_relaxed);
+        }
+
+      private:
+        bool active(V v) const { return (*this)[v] == std::size_t(-1); }
+        void assign(V v, std::size_t c)
+        {
+          comp[v].store(c, std::memory_order_relaxed);
+        }
+
+        void trim();
+        void forward_backward();
+        void color();
+        void collect();
+        void reach(V s, char bit);
+
+        // Call f(i) for each index of the active vertices, in parallel.
+        template<typename F>
+          void for_active(F f);
+
+      private:
+        const G& g;
+        std::size_t threads;
+        std::size_t n;
+        std::vector<V> verts;                        // The active vertices
+        std::unique_ptr<std::atomic<std::size_t>[]> comp;
+        std::unique_ptr<std::atomic<std::size_t>[]> colors;
+        std::unique_ptr<std::atomic<char>[]> marks;  // Search marks
+      };
+
+    template<typename G>
+      strong_engine<G>::strong_engine(const G& g, std::size_t threads)
+        : g(g), threads(threads), n(search_impl::vertex_bound(g)),
+          comp(new std::atomic<std::size_t>[n]),
+          colors(new std::atomic<std::size_t>[n]),
+          marks(new std::atomic<char>[n])
+      {
+        verts.reserve(g.order());
+        for (V v : g.vertices())
+          verts.push_back(v);
+        for (std::size_t i = 0; i != n; ++i) {
+          comp[i].store(-1, std::memory_order_relaxed);
+          marks[i].store(0, std::memory_order_relaxed);
+        }
+      }
+
+    template<typename G>
+      template<typename F>
+        void
+        strong_engine<G>::for_active(F f)
+        {
+          std::size_t m = verts.size();
+          std::size_t blocks = (m + grain - 1) / grain;
+          search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+            std::size_t end = std::min(m, (k + 1) * grain);
+            for (std::size_t i = k * grain; i != end; ++i)
+              f(verts[i]);
+          });
+        }
+
+    // Remove the vertices that have a component from the active vertices.
+    template<typename G>
+      void
+      strong_engine<G>::collect()
+      {
+        auto i = std::remove_if(verts.begin(), verts.end(), [&](V v) {
+          return !active(v);
+        });
+        verts.erase(i, verts.end());
+      }
+
+    // Make each active vertex with no active predecessors or successors
+    // (other than itself) a component, until no vertex is trimmed.
+    template<typename G>
+      void
+      strong_engine<G>::trim()
+      {
+        std::atomic<bool> changed(true);
+        while (changed.load() && !verts.empty()) {
+          changed.store(false);
+          for_active([&](V v) {
+            for (bool out : {true, false}) {
+              bool any = false;
+              for_adjacent(g, v, out, [&](V w) {
+                any = any || (w != v && active(w));
+              });
+              if (!any) {
+                assign(v, v);
+                changed.store(true, std::memory_order_relaxed);
+                return;
+              }
+            }
+          });
+          collect();
+        }
+      }
+
+    // Mark the active vertices reachable from s with bit, by a parallel
+    // level-synchronous search following out edges (if bit is 1) or in
+    // edges (if bit is 2).
+    template<typename G>
+      void
+      strong_engine<G>::reach(V s, char bit)
+      {
+        bool out = bit == 1;
+        std::vector<V> frontier {s};
+        std::vector<std::vector<V>> next(1);
+        marks[s].fetch_or(bit, std::memory_order_relaxed);
+        auto expand = [&](std::size_t k, std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i != last; ++i)
+            for_adjacent(g, frontier[i], out, [&](V w) {
+              if (active(w) &&
+                  !(marks[w].fetch_or(bit, std::memory_order_relaxed) & bit))
+                next[k].push_back(w);
+            });
+        };
+
+        // Small frontiers, which are common in graphs of high diameter, are
+        // expanded by the calling thread.
+        while (!frontier.empty()) {
+          std::size_t m = frontier.size();
+          if (m <= grain) {
+            expand(0, 0, m);
+            frontier.swap(next[0]);
+            next[0].clear();
+            continue;
+          }
+          std::size_t blocks = (m + grain - 1) / grain;
+          next.resize(blocks);
+          search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+            expand(k, k * grain, std::min(m, (k + 1) * grain));
+          });
+          frontier.clear();
+          for (std::vector<V>& x : next) {
+            frontier.insert(frontier.end(), x.begin(), x.end());
+            x.clear();
+          }
+        }
+      }
+
+    // Find the component of the active vertex with the greatest product of
+    // in and out degree.
+    template<typename G>
+      void
+      strong_engine<G>::forward_backward()
+      {
+        V pivot = verts.front();
+        std::size_t best = 0;
+        for (V v : verts) {
+          std::size_t d = g.in_degree(v) * g.out_degree(v);
+          if (d > best) {
+            best = d;
+            pivot = v;
+          }
+        }
+        reach(pivot, 1);
+        reach(pivot, 2);
+        for_active([&](V v) {
+          if (marks[v].load(std::memory_order_relaxed) == 3)
+            assign(v, pivot);
+          marks[v].store(0, std::memory_order_relaxed);
+        });
+        collect();
+      }
+
+    // Color the active vertices, and find the component of each color.
+    template<typename G>
+      void
+      strong_engine<G>::color()
+      {
+        for_active([&](V v) {
+          colors[v].store(v, std::memory_order_relaxed);
+        });
+
+        // Propagate the greatest color along the out edges until no color
+        // changes.
+        std::atomic<bool> changed(true);
+        while (changed.load()) {
+          changed.store(false);
+          for_active([&](V v) {
+            std::size_t c = colors[v].load(std::memory_order_relaxed);
+            for (Edge<G> e : g.out_edges(v)) {
+              V w = g.target(e);
+              if (!active(w))
+                continue;
+              std::size_t x = colors[w].load(std::memory_order_relaxed);
+              while (x < c) {
+                if (colors[w].compare_exchange_weak(
+                      x, c, std::memory_order_relaxed)) {
+                  changed.store(true, std::memory_order_relaxed);
+                  break;
+                }
+              }
+            }
+          });
+        }
+
+        // The component of each root is the vertices of its color that reach
+        // it. Vertices of different colors are searched independently.
+        std::vector<V> roots;
+        for (V v : verts)
+          if (colors[v].load(std::memory_order_relaxed) == v)
+            roots.push_back(v);
+        search_impl::parallel_for(roots.size(), threads, [&](std::size_t i) {
+          V r = roots[i];
+          std::vector<V> stack {r};
+          assign(r, r);
+          while (!stack.empty()) {
+            V u = stack.back();
+            stack.pop_back();
+            for (Edge<G> e : g.in_edges(u)) {
+              V w = g.source(e);
+              if (colors[w].load(std::memory_order_relaxed) == r &&
+                  active(w)) {
+                assign(w, r);
+                stack.push_back(w);
+              }
+            }
+          }
+        });
+        collect();
+      }
+
+    template<typename G>
+      void
+      strong_engine<G>::run()
+      {
+        trim();
+        if (!verts.empty())
+          forward_backward();
+        while (!verts.empty()) {
+          trim();
+          if (!verts.empty())
+            color();
+        }
+      }
+
+  } // namespace components_impl
+
+
+  // Compute the strongly connected components of the directed graph g,
+  // writing the label of each vertex to labels. Returns the number of
+  // components.
+  template<typename G>
+    std::size_t
+    strong_components(const G& g, std::vector<std::size_t>& labels)
+    {
+      static_assert(Directed_graph<G>(), "");
+      using V = Vertex<G>;
+      using Range = decltype(g.out_edges(std::declval<V>()));
+      using Iter = decltype(std::declval<Range>().begin());
+
+      // The index of each vertex is 0 until it is discovered, then its order
+      // of discovery (from 1), then the least index of a vertex reachable
+      // from it on the stack. When the component of v is found, the index
+      // of its vertices becomes c, which counts down from n - 1, so that it
+      // is greater than the index of any vertex on the stack.
+      std::size_t n = search_impl::vertex_bound(g);
+      std::vector<std::size_t> rindex(n, 0);
+      std::size_t index = 1;
+      std::size_t c = n - 1;
+
+      // A frame records the position of the search in the out edges of a
+      // vertex on the current path, and whether it is still the root of
+      // its component.
+      struct frame
+      {
+        V v;
+        Iter first;
+        Iter last;
+        bool root;
+      };
+      std::vector<frame> path;
+      std::vector<V> stack;
+
+      auto discover = [&](V v) {
+        rindex[v] = index++;
+        Range r = g.out_edges(v);
+        path.push_back(frame {v, r.begin(), r.end(), true});
+      };
+
+      for (V s : g.vertices()) {
+        if (rindex[s] != 0)
+          continue;
+        discover(s);
+        while (!path.empty()) {
+          frame& f = path.back();
+          if (f.first != f.last) {
+            // An undiscovered target is searched, and the edge examined
+            // again when the search returns to f.
+            V w = g.target(*f.first);
+            if (rindex[w] == 0) {
+              discover(w);
+              continue;
+            }
+            if (rindex[w] < rindex[f.v]) {
+              rindex[f.v] = rindex[w];
+              f.root = false;
+            }
+            ++f.first;
+            continue;
+          }
+
+          // All out edges of v have been followed.
+          V v = f.v;
+          bool root = f.root;
+          path.pop_back();
+          if (root) {
+            --index;
+            while (!stack.empty() && rindex[v] <= rindex[stack.back()]) {
+              rindex[stack.back()] = c;
+              stack.pop_back();
+              --index;
+            }
+            rindex[v] = c--;
+          } else {
+            stack.push_back(v);
+          }
+        }
+      }
+
+      labels.assign(n, -1);
+      for (V v : g.vertices())
+        labels[v] = n - 1 - rindex[v];
+      return n - 1 - c;
+    }
+
+
+  // Compute the strongly connected components of the directed graph g using
+  // up to threads threads, writing the label of each vertex to labels.
+  // Returns the number of components.
+  template<typename G>
+    std::size_t
+    parallel_strong_components(const G& g,
+                               std::vector<std::size_t>& labels,
+                               std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>(), "");
+      components_impl::strong_engine<G> e(g, threads);
+      e.run();
+      return components_impl::number_representatives(g, e, e.bound(),
+                                                      labels);
+    }
+
+
+  // Write the vertices of the directed graph g to order in topological order.
+  // Returns false if g has a cycle.
+  template<typename G>
+    bool
+    topological_sort(const G& g, std::vector<Vertex<G>>& order)
+    {
+      static_assert(Directed_graph<G>(), "");
+      using V = Vertex<G>;
+
+      // The vertices whose in degree has dropped to 0 are appended to order,
+      // which is also the queue of vertices whose out edges are followed.
+      std::vector<std::size_t> degree(search_impl::vertex_bound(g));
+      order.clear();
+      order.reserve(g.order());
+      for (V v : g.vertices()) {
+        degree[v] = g.in_degree(v);
+        if (degree[v] == 0)
+          order.push_back(v);
+      }
+      for (std::size_t i = 0; i != order.size(); ++i) {
+        for (Edge<G> e : g.out_edges(order[i])) {
+          V w = g.target(e);
+          if (--degree[w] == 0)
+            order.push_back(w);
+        }
+      }
+      return order.size() == g.order();
+    }
+
+} // namespace origin
+
+#endif
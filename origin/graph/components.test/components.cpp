@@ -0,0 +1,346 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include <origin/graph/components.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+void
+check_disjoint_sets()
+{
+  disjoint_sets s(6);
+  assert(s.count() == 6);
+  assert(s.unite(0, 1));
+  assert(s.unite(2, 3));
+  assert(!s.unite(1, 0));
+  assert(s.unite(1, 3));
+  assert(s.count() == 3);
+  assert(s.same(0, 2));
+  assert(!s.same(0, 4));
+
+  s.grow(8);
+  assert(s.size() == 8);
+  assert(s.count() == 5);
+  assert(s.unite(7, 4));
+  assert(s.same(4, 7));
+}
+
+void
+check_concurrent_disjoint_sets()
+{
+  // Threads link overlapping chains; the result is a single set.
+  const size_t n = 100000;
+  concurrent_disjoint_sets s(n);
+  vector<thread> ts;
+  for (size_t t = 0; t != 4; ++t)
+    ts.emplace_back([&s, t, n]() {
+      for (size_t i = t; i + 1 < n; i += 2)
+        s.unite(i, i + 1);
+    });
+  for (thread& t : ts)
+    t.join();
+  for (size_t i = 0; i != n; ++i)
+    assert(s.find(i) == 0);
+}
+
+template<typename G>
+  void
+  check_components()
+  {
+    // Components {a, b, c}, {d, e}, and {f}.
+    G g = build_n_graph<G>(6);
+    g.add_edge(0, 1, 0);
+    g.add_edge(2, 1, 1);
+    g.add_edge(4, 3, 2);
+
+    vector<size_t> ls;
+    assert(connected_components(g, ls) == 3);
+    assert((ls == vector<size_t>{0, 0, 0, 1, 1, 2}));
+  }
+
+// The parallel components have the same labels as the serial components.
+template<typename G>
+  void
+  check_parallel(const G& g)
+  {
+    vector<size_t> ls;
+    size_t k = connected_components(g, ls);
+
+    vector<size_t> ps;
+    assert(parallel_connected_components(g, ps, 1) == k);
+    assert(ps == ls);
+    assert(parallel_connected_components(g, ps, 4) == k);
+    assert(ps == ls);
+  }
+
+void
+check_removed()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 0);
+  g.add_edge(2, 3, 1);
+  g.remove_vertex(1);
+
+  vector<size_t> ls;
+  assert(connected_components(g, ls) == 2);
+  assert((ls == vector<size_t>{0, size_t(-1), 1, 1}));
+  assert(parallel_connected_components(g, ls, 2) == 2);
+  assert((ls == vector<size_t>{0, size_t(-1), 1, 1}));
+
+  incremental_components<G> cs(g);
+  assert(cs.count() == 2);
+
+  // The removed vertex handle is reused.
+  Vertex<G> v = cs.add_vertex('z');
+  assert(v == 1);
+  assert(cs.count() == 3);
+  cs.add_edge(v, 2, 2);
+  assert(cs.count() == 2);
+}
+
+void
+check_incremental()
+{
+  using G = undirected_adjacency_vector<char, int>;
+  G g = build_n_graph<G>(3);
+  g.add_edge(0, 1, 0);
+
+  incremental_components<G> cs(g);
+  assert(cs.count() == 2);
+  assert(cs.connected(0, 1));
+  assert(!cs.connected(1, 2));
+
+  Vertex<G> d = cs.add_vertex('d');
+  assert(cs.count() == 3);
+  cs.add_edge(2, d, 1);
+  assert(cs.count() == 2);
+  assert(g.size() == 2);
+
+  vector<tuple<size_t, size_t, int>> es {{1, 2, 2}, {3, 3, 3}};
+  cs.add_edges(es);
+  assert(cs.count() == 1);
+  assert(g.size() == 4);
+
+  vector<size_t> ls;
+  assert(cs.labels(ls) == 1);
+  vector<size_t> expect;
+  assert(connected_components(g, expect) == 1);
+  assert(ls == expect);
+}
+
+// Returns true if the labels a and b partition the vertices the same way.
+bool
+same_partition(const vector<size_t>& a, const vector<size_t>& b)
+{
+  if (a.size() != b.size())
+    return false;
+  vector<size_t> ab(a.size(), -1), ba(b.size(), -1);
+  for (size_t i = 0; i != a.size(); ++i) {
+    if ((a[i] == size_t(-1)) != (b[i] == size_t(-1)))
+      return false;
+    if (a[i] == size_t(-1))
+      continue;
+    if (ab[a[i]] == size_t(-1))
+      ab[a[i]] = b[i];
+    if (ba[b[i]] == size_t(-1))
+      ba[b[i]] = a[i];
+    if (ab[a[i]] != b[i] || ba[b[i]] != a[i])
+      return false;
+  }
+  return true;
+}
+
+template<typename G>
+  void
+  check_strong()
+  {
+    // Components {a, b, c}, {d, e}, and {f}.
+    G g = build_n_graph<G>(6);
+    g.add_edge(0, 1, 0);
+    g.add_edge(1, 2, 1);
+    g.add_edge(2, 0, 2);
+    g.add_edge(2, 3, 3);
+    g.add_edge(3, 4, 4);
+    g.add_edge(4, 3, 5);
+    g.add_edge(5, 5, 6);
+
+    // The component of {d, e}, which has no successors, is found first.
+    vector<size_t> ls;
+    assert(strong_components(g, ls) == 3);
+    assert((ls == vector<size_t>{1, 1, 1, 0, 0, 2}));
+
+    vector<size_t> ps;
+    assert(parallel_strong_components(g, ps, 2) == 3);
+    assert((ps == vector<size_t>{0, 0, 0, 1, 1, 2}));
+
+    vector<Vertex<G>> order;
+    assert(!topological_sort(g, order));
+  }
+
+// Check the strong components of g against the reachability of vertices,
+// and the parallel components against the serial components.
+template<typename G>
+  void
+  check_parallel_strong(const G& g, bool reachability)
+  {
+    vector<size_t> ls;
+    size_t k = strong_components(g, ls);
+
+    // The labels are in reverse topological order.
+    for (Edge<G> e : g.edges())
+      assert(ls[g.source(e)] >= ls[g.target(e)]);
+
+    if (reachability) {
+      size_t n = g.order();
+      vector<vector<char>> reach(n);
+      for (size_t s = 0; s != n; ++s) {
+        reach[s].assign(n, 0);
+        vector<size_t> stack {s};
+        reach[s][s] = 1;
+        while (!stack.empty()) {
+          size_t u = stack.back();
+          stack.pop_back();
+          for (Edge<G> e : g.out_edges(u))
+            if (!reach[s][g.target(e)]) {
+              reach[s][g.target(e)] = 1;
+              stack.push_back(g.target(e));
+            }
+        }
+      }
+      for (size_t u = 0; u != n; ++u)
+        for (size_t v = 0; v != n; ++v)
+          assert((ls[u] == ls[v]) == (reach[u][v] && reach[v][u]));
+    }
+
+    vector<size_t> ps;
+    assert(parallel_strong_components(g, ps, 1) == k);
+    assert(same_partition(ls, ps));
+    assert(parallel_strong_components(g, ps, 4) == k);
+    assert(same_partition(ls, ps));
+  }
+
+// A cycle of a million vertices is searched without recursion.
+void
+check_deep()
+{
+  using G = directed_adjacency_vector<char, int>;
+  const size_t n = 1000000;
+  G g = build_n_graph<G>(0);
+  for (size_t i = 0; i != n; ++i)
+    g.add_vertex('a');
+  for (size_t i = 0; i != n; ++i)
+    g.add_edge(i, (i + 1) % n, 0);
+
+  vector<size_t> ls;
+  assert(strong_components(g, ls) == 1);
+  assert(parallel_strong_components(g, ls, 4) == 1);
+
+  // Without the last edge, each vertex is its own component, and the path
+  // is sorted.
+  G p = build_n_graph<G>(0);
+  for (size_t i = 0; i != n; ++i)
+    p.add_vertex('a');
+  for (size_t i = 0; i + 1 != n; ++i)
+    p.add_edge(i, i + 1, 0);
+  assert(strong_components(p, ls) == n);
+  assert(ls[0] == n - 1 && ls[n - 1] == 0);
+  vector<Vertex<G>> order;
+  assert(topological_sort(p, order));
+  for (size_t i = 0; i != n; ++i)
+    assert(order[i] == i);
+}
+
+template<typename G>
+  void
+  check_topological()
+  {
+    minstd_rand prng(5);
+    uniform_int_distribution<size_t> dist(0, 499);
+    G g = build_n_graph<G>(0);
+    for (size_t i = 0; i != 500; ++i)
+      g.add_vertex('a');
+    for (size_t i = 0; i != 2000; ++i) {
+      size_t u = dist(prng), v = dist(prng);
+      if (u != v)
+        g.add_edge(min(u, v), max(u, v), 0);
+    }
+
+    vector<Vertex<G>> order;
+    assert(topological_sort(g, order));
+    assert(order.size() == g.order());
+    vector<size_t> pos(g.order());
+    for (size_t i = 0; i != order.size(); ++i)
+      pos[order[i]] = i;
+    for (Edge<G> e : g.edges())
+      assert(pos[g.source(e)] < pos[g.target(e)]);
+
+    // Each vertex of an acyclic graph is its own component.
+    vector<size_t> ls;
+    assert(strong_components(g, ls) == g.order());
+  }
+
+void
+check_strong_removed()
+{
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 2, 0);
+  g.add_edge(2, 0, 1);
+  g.add_edge(1, 3, 2);
+  g.remove_vertex(1);
+
+  vector<size_t> ls;
+  assert(strong_components(g, ls) == 2);
+  assert((ls == vector<size_t>{0, size_t(-1), 0, 1}));
+  assert(parallel_strong_components(g, ls, 2) == 2);
+  assert((ls == vector<size_t>{0, size_t(-1), 0, 1}));
+}
+
+int main()
+{
+  check_disjoint_sets();
+  check_concurrent_disjoint_sets();
+
+  check_components<directed_adjacency_list<char, int>>();
+  check_components<undirected_adjacency_list<char, int>>();
+  check_components<undirected_adjacency_vector<char, int>>();
+
+  using U = undirected_adjacency_list<char, int>;
+  using A = undirected_adjacency_vector<char, int>;
+  check_parallel(build_erdos_renyi_graph<U>(20000, 12000, 1));
+  check_parallel(build_erdos_renyi_graph<U>(50000, 100000, 2));
+  check_parallel(build_erdos_renyi_graph<A>(50000, 30000, 3));
+  check_parallel(build_reflexive_clique<U>(200));
+
+  check_removed();
+  check_incremental();
+
+  using D = directed_adjacency_list<char, int>;
+  using B = directed_adjacency_vector<char, int>;
+  check_strong<D>();
+  check_strong<B>();
+  check_parallel_strong(build_erdos_renyi_graph<D>(300, 450, 4), true);
+  check_parallel_strong(build_erdos_renyi_graph<B>(50000, 100000, 5), false);
+  check_parallel_strong(build_erdos_renyi_graph<D>(20000, 60000, 6), false);
+  check_parallel_strong(build_erdos_renyi_graph<B>(30000, 20000, 7), false);
+  check_deep();
+  check_topological<D>();
+  check_topological<B>();
+  check_strong_removed();
+}
@@ -0,0 +1,354 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COMPRESSED_GRAPH_HPP
+#define ORIGIN_GRAPH_COMPRESSED_GRAPH_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include <origin/type/concepts.hpp>
+#include <origin/type/empty.hpp>
+#include <origin/sequence/range.hpp>
+#include <origin/memory/usage.hpp>
+
+#include <origin/graph/handle.hpp>
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  namespace compressed_graph_impl
+  {
+    // The handle counter is an iterator over a contiguous sequence of
+    // handles [first, last). Dereferencing the iterator yields a handle of
+    // type H.
+    template<typename H>
+      struct handle_counter
+      {
+        using value_type = H;
+        using reference = H;
+        using pointer = const H*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        handle_counter(std::size_t n = 0)
+          : count(n)
+        { }
+
+        H operator*() const { return H(count); }
+
+        handle_counter& operator++();
+        handle_counter  operator++(int);
+
+        std::size_t count;
+      };
+
+    template<typename H>
+      inline handle_counter<H>&
+      handle_counter<H>::operator++()
+      {
+        ++count;
+        return *this;
+      }
+
+    template<typename H>
+      inline handle_counter<H>
+      handle_counter<H>::operator++(int)
+      {
+        handle_counter tmp = *this;
+        ++count;
+        return tmp;
+      }
+
+    // Equality
+    template<typename H>
+      inline bool
+      operator==(const handle_counter<H>& a, const handle_counter<H>& b)
+      {
+        return a.count == b.count;
+      }
+
+    template<typename H>
+      inline bool
+      operator!=(const handle_counter<H>& a, const handle_counter<H>& b)
+      {
+        return a.count != b.count;
+      }
+
+
+    // An alias for a range of consecutive handles.
+    template<typename H>
+      using handle_range = bounded_range<handle_counter<H>>;
+
+    // An alias for the in-edge range.
+    using incidence_range = bounded_range<const edge_handle*>;
+
+  } // namespace compressed_graph_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.compressed]
+  //                          Compressed Graph
+  //
+  // A compressed graph is an immutable directed graph stored in compressed
+  // sparse row (CSR) format. The out edges of each vertex are stored
+  // contiguously, so that an edge handle is simply the offset of the edge in
+  // the flat arrays that hold the source, target, and value of every edge.
+  // The in edges of each vertex are stored as a second compressed array of
+  // edge handles.
+  //
+  // A compressed graph is built from an existing graph in O(V + E) time, and
+  // cannot be modified afterwards, except for the values of its vertices and
+  // edges. This makes it well suited for algorithms that traverse a fixed
+  // snapshot of a graph many times: traversing the out edges of a vertex
+  // touches a single contiguous block of memory.
+  //
+  // The vertices of the compressed graph are numbered 0 to n - 1 in the order
+  // in which the vertices of the original graph are enumerated. When built
+  // from an undirected graph, each non-loop edge {u, v} yields a pair of edges
+  // (u, v) and (v, u) with the same value.
+  template<typename V = empty_t, typename E = empty_t>
+    class compressed_graph
+    {
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+      using edge = edge_handle;
+      using edge_range = compressed_graph_impl::handle_range<edge_handle>;
+
+      using incidence_range = compressed_graph_impl::incidence_range;
+
+
+      // Default construction
+      //
+      // Initialize an empty graph.
+      compressed_graph()
+        : out_(1, 0), in_(1, 0)
+      { }
+
+      // Graph initialization
+      //
+      // Initialize the graph with the vertices and edges of g. The values
+      // of vertices and edges in g are copied into the graph.
+      template<typename G>
+        explicit compressed_graph(const G& g);
+
+      // Array initialization
+      //
+      // Initialize the graph with the vertex values vs, and with the edges
+      // whose sources, targets, and values are given by the remaining
+      // arrays, which are moved into the graph. The edges must be ordered
+      // by source; they are numbered in that order.
+      compressed_graph(std::vector<V> vs,
+                       std::vector<vertex_handle> sources,
+                       std::vector<vertex_handle> targets,
+                       std::vector<E> values);
+
+
+      // Observers
+      bool        null() const  { return verts_.empty(); }
+      std::size_t order() const { return verts_.size(); }
+
+      bool        empty() const { return targets_.empty(); }
+      std::size_t size() const  { return targets_.size(); }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return out_[v + 1] - out_[v]; }
+      std::size_t in_degree(vertex v) const  { return in_[v + 1] - in_[v]; }
+      std::size_t degree(vertex v) const
+      {
+        return out_degree(v) + in_degree(v);
+      }
+
+      // Edge observers
+      vertex source(edge e) const { return sources_[e]; }
+      vertex target(edge e) const { return targets_[e]; }
+
+      // Data access
+      V&       operator()(vertex v)       { return verts_[v]; }
+      const V& operator()(vertex v) const { return verts_[v]; }
+
+      E&       operator()(edge e)       { return edges_[e]; }
+      const E& operator()(edge e) const { return edges_[e]; }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Returns the footprint of the arrays of the graph. See [mem.usage].
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(verts_) + contiguous_footprint(out_)
+             + contiguous_footprint(sources_) + contiguous_footprint(targets_)
+             + contiguous_footprint(edges_) + contiguous_footprint(in_)
+             + contiguous_footprint(ins_);
+      }
+
+      // Iterators
+      vertex_range    vertices() const { return {0, order()}; }
+      edge_range      edges() const    { return {0, size()}; }
+      edge_range      out_edges(vertex v) const;
+      incidence_range in_edges(vertex v) const;
+
+    private:
+      template<typename G>
+        void add_edge(std::vector<std::size_t>& next,
+                      std::size_t u, std::size_t v, const G& g, Edge<G> e);
+
+      void build_in_edges();
+
+    private:
+      std::vector<V>             verts_;   // Vertex values
+      std::vector<std::size_t>   out_;     // Out edge offsets of each vertex
+      std::vector<vertex_handle> sources_; // Source of each edge
+      std::vector<vertex_handle> targets_; // Target of each edge
+      std::vector<E>             edges_;   // Edge values
+      std::vector<std::size_t>   in_;      // In edge offsets of each vertex
+      std::vector<edge_handle>   ins_;     // In edges of each vertex
+    };
+
+
+  template<typename V, typename E>
+    template<typename G>
+      compressed_graph<V, E>::compressed_graph(const G& g)
+      {
+        constexpr bool undirected = !Directed_graph<G>();
+
+        // Number the vertices of g. Handles in g need not be consecutive
+        // since vertices may have been removed.
+        std::size_t bound = 0;
+        for (Vertex<G> v : g.vertices())
+          bound = std::max(bound, std::size_t(v) + 1);
+        std::vector<std::size_t> index(bound);
+        verts_.reserve(g.order());
+        for (Vertex<G> v : g.vertices()) {
+          index[v] = verts_.size();
+          verts_.push_back(g(v));
+        }
+
+        // Count the out edges of each vertex.
+        std::size_t n = order();
+        out_.assign(n + 1, 0);
+        std::size_t m = 0;
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = index[g.source(e)];
+          std::size_t v = index[g.target(e)];
+          ++out_[u + 1];
+          ++m;
+          if (undirected && u != v) {
+            ++out_[v + 1];
+            ++m;
+          }
+        }
+        std::partial_sum(out_.begin(), out_.end(), out_.begin());
+
+        // Place each edge in the out edge list of its source.
+        sources_.resize(m);
+        targets_.resize(m);
+        edges_.resize(m);
+        std::vector<std::size_t> next(out_.begin(), out_.end() - 1);
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = index[g.source(e)];
+          std::size_t v = index[g.target(e)];
+          add_edge(next, u, v, g, e);
+          if (undirected && u != v)
+            add_edge(next, v, u, g, e);
+        }
+
+        build_in_edges();
+      }
+
+  template<typename V, typename E>
+    compressed_graph<V, E>::compressed_graph(std::vector<V> vs,
+                                             std::vector<vertex_handle> sources,
+                                             std::vector<vertex_handle> targets,
+                                             std::vector<E> values)
+      : verts_(std::move(vs)),
+        sources_(std::move(sources)),
+        targets_(std::move(targets)),
+        edges_(std::move(values))
+    {
+      assert(sources_.size() == targets_.size());
+      assert(sources_.size() == edges_.size());
+      assert(std::is_sorted(sources_.begin(), sources_.end()));
+
+      // Count the out edges of each vertex.
+      std::size_t n = order();
+      out_.assign(n + 1, 0);
+      for (vertex_handle u : sources_) {
+        assert(u < n);
+        ++out_[u + 1];
+      }
+      std::partial_sum(out_.begin(), out_.end(), out_.begin());
+      build_in_edges();
+    }
+
+  // Build the in edge lists from the targets.
+  template<typename V, typename E>
+    void
+    compressed_graph<V, E>::build_in_edges()
+    {
+      std::size_t n = order();
+      std::size_t m = size();
+      in_.assign(n + 1, 0);
+      for (vertex_handle v : targets_)
+        ++in_[v + 1];
+      std::partial_sum(in_.begin(), in_.end(), in_.begin());
+      ins_.resize(m);
+      std::vector<std::size_t> next(in_.begin(), in_.end() - 1);
+      for (std::size_t e = 0; e != m; ++e)
+        ins_[next[targets_[e]]++] = e;
+    }
+
+  template<typename V, typename E>
+    template<typename G>
+      inline void
+      compressed_graph<V, E>::add_edge(std::vector<std::size_t>& next,
+                                       std::size_t u, std::size_t v,
+                                       const G& g, Edge<G> e)
+      {
+        std::size_t i = next[u]++;
+        sources_[i] = u;
+        targets_[i] = v;
+        edges_[i] = g(e);
+      }
+
+  // Returns the first edge (u, v), or an invalid edge handle if u and v are
+  // not adjacent.
+  template<typename V, typename E>
+    auto
+    compressed_graph<V, E>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (std::size_t i = out_[u]; i != out_[u + 1]; ++i)
+        if (targets_[i] == v)
+          return i;
+      return edge();
+    }
+
+  template<typename V, typename E>
+    inline auto
+    compressed_graph<V, E>::out_edges(vertex v) const -> edge_range
+    {
+      return {out_[v], out_[v + 1]};
+    }
+
+  template<typename V, typename E>
+    inline auto
+    compressed_graph<V, E>::in_edges(vertex v) const -> incidence_range
+    {
+      const edge_handle* p = ins_.data();
+      return {p + in_[v], p + in_[v + 1]};
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using C = compressed_graph<char, int>;
+
+static_assert(Directed_graph<C>(), "");
+
+
+// Check that every edge of the compressed graph c is listed in the out
+// edges of its source and the in edges of its target.
+void
+check_incidence(const C& c)
+{
+  size_t out = 0;
+  size_t in = 0;
+  for (Vertex<C> v : c.vertices()) {
+    for (Edge<C> e : c.out_edges(v)) {
+      assert(c.source(e) == v);
+      ++out;
+    }
+    for (Edge<C> e : c.in_edges(v)) {
+      assert(c.target(e) == v);
+      ++in;
+    }
+  }
+  assert(out == c.size());
+  assert(in == c.size());
+}
+
+void
+check_default()
+{
+  C c;
+  assert(c.null());
+  assert(c.empty());
+}
+
+template<typename G>
+  void
+  check_directed()
+  {
+    G g = build_reflexive_bidi_clique<G>(4);
+    C c(g);
+    assert(c.order() == g.order());
+    assert(c.size() == g.size());
+    check_incidence(c);
+
+    for (Vertex<G> v : g.vertices()) {
+      assert(c(v) == g(v));
+      assert(c.out_degree(v) == g.out_degree(v));
+      assert(c.in_degree(v) == g.in_degree(v));
+    }
+
+    // Each edge has the same endpoints and value as in the original graph.
+    // Note that the clique has parallel loops.
+    for (Edge<G> e : g.edges()) {
+      bool found = false;
+      for (Edge<C> f : c.out_edges(g.source(e)))
+        found |= c.target(f) == g.target(e) && c(f) == g(e);
+      assert(found);
+    }
+
+    // Values can be modified.
+    Edge<C> e = c(0, 1);
+    c(e) = 100;
+    assert(c(c(0, 1)) == 100);
+  }
+
+void
+check_removed()
+{
+  // Vertices are renumbered after removal.
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 2, 1);
+  g.add_edge(2, 3, 2);
+  g.add_edge(3, 0, 3);
+  g.remove_vertex(1);
+
+  C c(g);
+  assert(c.order() == 3);
+  assert(c.size() == 3);
+  assert(c(Vertex<C>(0)) == 'a');
+  assert(c(Vertex<C>(1)) == 'c');
+  assert(c(Vertex<C>(2)) == 'd');
+  assert(c(c(0, 1)) == 1);
+  assert(c(c(1, 2)) == 2);
+  assert(c(c(2, 0)) == 3);
+  assert(!c(0, 2));
+  check_incidence(c);
+}
+
+void
+check_undirected()
+{
+  // Each undirected edge becomes a pair of directed edges, except loops.
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_reflexive_clique<G>(3);
+  C c(g);
+  assert(c.order() == 3);
+  assert(c.size() == 9);
+  check_incidence(c);
+  for (Vertex<C> v : c.vertices()) {
+    assert(c.out_degree(v) == 3);
+    assert(c.in_degree(v) == 3);
+  }
+  assert(c(c(0, 2)) == c(c(2, 0)));
+}
+
+int main()
+{
+  check_default();
+  check_directed<directed_adjacency_list<char, int>>();
+  check_removed();
+  check_undirected();
+}
@@ -49,6 +49,17 @@ namespace origin
         using type = decltype(check(std::declval<G>(), std::declval<V>()));
       };
 
+    template<typename G>
+      class get_edge_set
+      {
+        template<typename X>
+          static auto check(const X& x) -> decltype(x.edges());
+
+        static subst_failure check(...);
+      public:
+        using type = decltype(check(std::declval<G>()));
+      };
+
   } // namsepace graph_impl
 
 
@@ -73,6 +84,13 @@ namespace origin
       return Subst_succeeded<typename graph_impl::get_inc_edges<G, V>::type>();
     }
 
+  // Returns true iff g.edges() is a valid expression.
+  template<typename G>
+    constexpr bool Has_edge_set()
+    {
+      return Subst_succeeded<typename graph_impl::get_edge_set<G>::type>();
+    }
+
 
 
   // ------------------------------------------------------------------------ //
@@ -112,6 +130,16 @@ namespace origin
       return Has_incident_edges<G, Vertex<G>>();
     }
 
+  // Returns true if G is an edge list: a graph whose edges can be
+  // enumerated, with their endpoints, but that has no incidence lists
+  // (e.g., coordinate_graph).
+  template<typename G>
+    constexpr bool Edge_list_graph()
+    {
+      return Has_edge_set<G>()
+          && !Directed_graph<G>() && !Undirected_graph<G>();
+    }
+
 } // namespace origin
 
 #endif
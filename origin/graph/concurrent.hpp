@@ -0,0 +1,267 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_CONCURRENT_HPP
+#define ORIGIN_GRAPH_CONCURRENT_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/type/traits.hpp>
+#include <origin/graph/io.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.concurrent]
+  //                          Concurrent Insertion
+  //
+  // The mutating operations of the graph data structures assume a single
+  // writer. A concurrent inserter lets any number of threads add edges to a
+  // graph at the same time, while other threads read the graph.
+  //
+  // Edges added through a concurrent inserter are staged in a segmented
+  // buffer. Each edge takes a slot of the buffer with a single atomic
+  // increment, and the segments of the buffer are never reallocated, so
+  // writers do not wait on each other. The graph itself is not modified
+  // until publish() is called, which adds the staged edges to the graph
+  // with its bulk loader (see [graph.bulk]), adding any missing vertices.
+  // Readers therefore see a consistent snapshot of the graph, as of the last
+  // publication, while writers add edges.
+  //
+  // The add_edge operations may be called concurrently with each other and
+  // with any const operation on the graph. The publish() operation modifies
+  // the graph, and must not be called concurrently with writers or readers.
+  // A typical ingest thus alternates between concurrent phases of adding
+  // edges and reading the graph, and quiescent points where the staged
+  // edges are published.
+
+
+  namespace concurrent_impl
+  {
+    // A segmented buffer is an array of objects to which objects can be
+    // appended concurrently. The buffer consists of segments of doubling
+    // size: segment k holds 2^(k + base_bits) objects. Segments are
+    // allocated when first needed, and are not released until the buffer is
+    // destroyed, so that objects never move.
+    template<typename T>
+      class segmented_buffer
+      {
+        static constexpr std::size_t base_bits = 10;
+        static constexpr std::size_t segments = 64 - base_bits;
+
+        using storage = Aligned_storage<sizeof(T), alignof(T)>;
+      public:
+        segmented_buffer();
+        ~segmented_buffer();
+
+        segmented_buffer(const segmented_buffer&) = delete;
+        segmented_buffer& operator=(const segmented_buffer&) = delete;
+
+        // Returns the number of objects in the buffer. If objects are being
+        // appended concurrently, this is the number of completed appends.
+        std::size_t size() const { return done_.load(); }
+
+        // Element access. The object at n must have been appended and the
+        // append must have completed.
+        T& operator[](std::size_t n) { return *ptr(n); }
+
+        // Construct an object at the end of the buffer, returning its index.
+        template<typename... Args>
+          std::size_t emplace(Args&&... args);
+
+        // Destroy the objects of the buffer. This must not be called
+        // concurrently with emplace().
+        void clear();
+
+      private:
+        static std::size_t segment(std::size_t n);
+        static std::size_t first(std::size_t k);
+
+        T* ptr(std::size_t n);
+        storage* get_segment(std::size_t k);
+
+      private:
+        std::atomic<std::size_t> next_; // The next free slot
+        std::atomic<std::size_t> done_; // The number of completed appends
+        std::atomic<storage*> segs_[segments];
+      };
+
+    template<typename T>
+      segmented_buffer<T>::segmented_buffer()
+        : next_(0), done_(0)
+      {
+        for (auto& s : segs_)
+          s.store(nullptr);
+      }
+
+    template<typename T>
+      segmented_buffer<T>::~segmented_buffer()
+      {
+        clear();
+        for (auto& s : segs_)
+          delete[] s.load();
+      }
+
+    // Returns the segment holding the object at n.
+    template<typename T>
+      inline std::size_t
+      segmented_buffer<T>::segment(std::size_t n)
+      {
+        std::size_t x = (n >> base_bits) + 1;
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(x);
+#else
+        std::size_t k = 0;
+        while (x >>= 1)
+          ++k;
+        return k;
+#endif
+      }
+
+    // Returns the index of the first object in segment k.
+    template<typename T>
+      inline std::size_t
+      segmented_buffer<T>::first(std::size_t k)
+      {
+        return ((std::size_t(1) << k) - 1) << base_bits;
+      }
+
+    template<typename T>
+      inline T*
+      segmented_buffer<T>::ptr(std::size_t n)
+      {
+        std::size_t k = segment(n);
+        storage* s = segs_[k].load(std::memory_order_acquire);
+        assert(s);
+        return reinterpret_cast<T*>(s + (n - first(k)));
+      }
+
+    // Returns segment k, allocating it if needed. If several threads
+    // allocate the segment at the same time, only one allocation is kept.
+    template<typename T>
+      typename segmented_buffer<T>::storage*
+      segmented_buffer<T>::get_segment(std::size_t k)
+      {
+        storage* s = segs_[k].load(std::memory_order_acquire);
+        if (s)
+          return s;
+        storage* p = new storage[std::size_t(1) << (k + base_bits)];
+        if (segs_[k].compare_exchange_strong(s, p, std::memory_order_acq_rel))
+          return p;
+        delete[] p;
+        return s;
+      }
+
+    template<typename T>
+      template<typename... Args>
+        std::size_t
+        segmented_buffer<T>::emplace(Args&&... args)
+        {
+          std::size_t n = next_.fetch_add(1, std::memory_order_relaxed);
+          std::size_t k = segment(n);
+          assert(k < segments);
+          storage* s = get_segment(k);
+          new (s + (n - first(k))) T(std::forward<Args>(args)...);
+          done_.fetch_add(1, std::memory_order_release);
+          return n;
+        }
+
+    template<typename T>
+      void
+      segmented_buffer<T>::clear()
+      {
+        assert(next_.load() == done_.load());
+        std::size_t n = done_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i != n; ++i)
+          ptr(i)->~T();
+        next_.store(0);
+        done_.store(0);
+      }
+
+  } // namespace concurrent_impl
+
+
+  // A concurrent inserter stages edges added concurrently to the graph g,
+  // and adds them to the graph when published. Edges are described by
+  // vertex indexes, which may refer to vertices not yet in the graph;
+  // missing vertices are added (with default values) when the edges are
+  // published, as by io::read_edge_list. Staged edges are published in the
+  // order in which they took their slots.
+  template<typename G>
+    class concurrent_inserter
+    {
+    public:
+      using graph_type = G;
+      using edge_value = io::parse_impl::Edge_value<G>;
+      using edge_description =
+        std::tuple<std::size_t, std::size_t, edge_value>;
+
+      explicit concurrent_inserter(G& g)
+        : g_(g)
+      { }
+
+      // Returns the graph as of the last publication.
+      const G& graph() const { return g_; }
+
+      // Returns the number of staged edges.
+      std::size_t pending() const { return buf_.size(); }
+
+      // Stage an edge from u to v. These may be called concurrently.
+      void add_edge(std::size_t u, std::size_t v)
+      {
+        buf_.emplace(u, v, edge_value());
+      }
+
+      void add_edge(std::size_t u, std::size_t v, const edge_value& x)
+      {
+        buf_.emplace(u, v, x);
+      }
+
+      void add_edge(std::size_t u, std::size_t v, edge_value&& x)
+      {
+        buf_.emplace(u, v, std::move(x));
+      }
+
+      // Add the staged edges to the graph, returning the number of edges
+      // added.
+      std::size_t publish();
+
+    private:
+      G& g_;
+      concurrent_impl::segmented_buffer<edge_description> buf_;
+    };
+
+  template<typename G>
+    std::size_t
+    concurrent_inserter<G>::publish()
+    {
+      std::size_t m = buf_.size();
+      std::vector<edge_description> es;
+      es.reserve(m);
+      std::size_t n = 0;
+      for (std::size_t i = 0; i != m; ++i) {
+        edge_description& x = buf_[i];
+        n = std::max({n, std::get<0>(x) + 1, std::get<1>(x) + 1});
+        es.push_back(std::move(x));
+      }
+      buf_.clear();
+
+      while (g_.order() < n)
+        g_.add_vertex();
+      g_.add_edges(es);
+      return m;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,116 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <origin/graph/concurrent.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+check_segmented_buffer()
+{
+  concurrent_impl::segmented_buffer<string> buf;
+  for (int i = 0; i != 5000; ++i)
+    assert(buf.emplace(to_string(i)) == size_t(i));
+  assert(buf.size() == 5000);
+  assert(buf[0] == "0");
+  assert(buf[1023] == "1023");
+  assert(buf[1024] == "1024");
+  assert(buf[4999] == "4999");
+
+  buf.clear();
+  assert(buf.size() == 0);
+  assert(buf.emplace("x") == 0);
+  assert(buf[0] == "x");
+}
+
+// Each of n writers adds m edges while a reader traverses the graph. The
+// reader must see the graph as of the last publication.
+template<typename G>
+  void
+  check_concurrent(size_t n, size_t m)
+  {
+    G g;
+    concurrent_inserter<G> ins(g);
+    for (int round = 0; round != 2; ++round) {
+      atomic<bool> done(false);
+      size_t before = g.size();
+      thread reader([&]() {
+        while (!done) {
+          const G& h = ins.graph();
+          size_t k = 0;
+          for (Vertex<G> v : h.vertices())
+            k += h.out_degree(v);
+          assert(k == before);
+        }
+      });
+
+      vector<thread> writers;
+      for (size_t t = 0; t != n; ++t)
+        writers.emplace_back([&ins, t, m, round]() {
+          for (size_t i = 0; i != m; ++i)
+            ins.add_edge(t, (t + i) % 100, int(round * 1000000 + t * m + i));
+        });
+      for (thread& t : writers)
+        t.join();
+      done = true;
+      reader.join();
+
+      assert(ins.pending() == n * m);
+      assert(ins.publish() == n * m);
+      assert(ins.pending() == 0);
+      assert(g.size() == before + n * m);
+    }
+    assert(g.order() == 100);
+
+    // Every edge is present exactly once.
+    vector<int> vals;
+    for (Edge<G> e : g.edges()) {
+      int x = g(e) % 1000000;
+      assert(g.source(e) == x / m);
+      assert(g.target(e) == (x / m + x % m) % 100);
+      vals.push_back(g(e));
+    }
+    sort(vals.begin(), vals.end());
+    assert(unique(vals.begin(), vals.end()) == vals.end());
+  }
+
+// Edges without values, and vertices added by publication.
+void
+check_default_values()
+{
+  using G = undirected_adjacency_list<char>;
+  G g;
+  g.add_vertex('a');
+  concurrent_inserter<G> ins(g);
+  ins.add_edge(0, 3);
+  ins.add_edge(3, 2);
+  assert(g.order() == 1);
+  assert(ins.publish() == 2);
+  assert(g.order() == 4);
+  assert(g.size() == 2);
+  assert(g(Vertex<G>(0)) == 'a');
+  assert(g(Vertex<G>(0), Vertex<G>(3)));
+  assert(ins.publish() == 0);
+}
+
+int main()
+{
+  check_segmented_buffer();
+  check_concurrent<directed_adjacency_list<char, int>>(16, 5000);
+  check_concurrent<directed_adjacency_vector<char, int>>(8, 3000);
+  check_default_values();
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_CONVERT_HPP
+#define ORIGIN_GRAPH_CONVERT_HPP
+
+#include <cstddef>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/type/traits.hpp>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [graph.convert]
+  //                            Graph Conversion
+  //
+  // Converting a graph g to a graph of another type G2 builds the graph
+  // with the vertices and edges of g, and their values, in O(V + E) time:
+  //
+  //    compaction_map m;
+  //    auto h = convert<adjacency_vector<V, E>>(g, m);
+  //    assert(h.source(m.edge(e)) == m.vertex(g.source(e)));
+  //
+  // The vertices of h are numbered in the order in which the vertices of g
+  // are enumerated, so that converting a graph with removed vertices packs
+  // its handles. The mapping m gives the vertex and edge of h for each
+  // vertex and edge of g, and size_t(-1) for the holes in the handles of g
+  // (see [graph.adj_list.compact]).
+  //
+  // A graph with add_vertex() and add_edges(r), such as an adjacency list
+  // or vector, is reserved for its vertices and edges and then filled by a
+  // single bulk insertion (see [graph.bulk]), so that no array or incidence
+  // list grows more than once. When g is an rvalue, its vertex and edge
+  // values are moved into h rather than copied. Any other G2 is built by its
+  // constructor from g, which copies the values. The edges of a compressed
+  // graph are mapped; for other such graphs, m.edges is empty.
+  //
+  // Converting an undirected graph to a directed graph yields the edges
+  // (u, v) and (v, u) for each non-loop edge {u, v}, both with its value;
+  // the mapping gives the edge (u, v). Converting a directed graph to an
+  // undirected graph yields the edge {u, v} for each edge (u, v).
+
+  namespace convert_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    template<typename G>
+      using Edge_value =
+        Decay<decltype(std::declval<const G&>()(std::declval<Edge<G>>()))>;
+
+    // Returns one more than the largest edge handle of g.
+    template<typename G>
+      inline std::size_t
+      edge_bound(const G& g)
+      {
+        std::size_t n = 0;
+        for (Edge<G> e : g.edges())
+          n = std::max(n, std::size_t(e) + 1);
+        return n;
+      }
+
+    // Number the vertices of g in enumeration order.
+    template<typename G>
+      inline void
+      number_vertices(const G& g, compaction_map& m)
+      {
+        m.vertices.assign(search_impl::vertex_bound(g), npos);
+        std::size_t n = 0;
+        for (Vertex<G> v : g.vertices())
+          m.vertices[v] = n++;
+      }
+
+    // Reserve h for n vertices and m edges, if it can be reserved.
+    template<typename G>
+      inline auto
+      reserve(G& h, std::size_t n, std::size_t m, int)
+        -> decltype(h.reserve(n, m))
+      {
+        h.reserve(n, m);
+      }
+
+    template<typename G>
+      inline void
+      reserve(G&, std::size_t, std::size_t, long)
+      { }
+
+    // Build a mutable graph by adding the vertices of g and then its edges
+    // in a single bulk insertion.
+    template<typename G2, typename G1>
+      auto
+      build(G1&& g, compaction_map& m, int)
+        -> decltype(std::declval<G2&>().add_vertex(), G2())
+      {
+        using G = Remove_reference<G1>;
+        using E = Edge_value<G2>;
+        constexpr bool split = !Directed_graph<G>() && Directed_graph<G2>();
+
+        std::vector<std::tuple<std::size_t, std::size_t, E>> edges;
+        edges.reserve(split ? 2 * g.size() : g.size());
+
+        G2 h;
+        reserve(h, g.order(), edges.capacity(), 0);
+        m.vertices.assign(search_impl::vertex_bound(g), npos);
+        for (Vertex<G> v : g.vertices())
+          m.vertices[v] =
+            h.add_vertex(graph_impl::forward_element<G1>(g(v)));
+
+        // Describe the edges of h, recording the index of the description
+        // of each edge of g.
+        m.edges.assign(edge_bound(g), npos);
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = m.vertices[g.source(e)];
+          std::size_t v = m.vertices[g.target(e)];
+          m.edges[e] = edges.size();
+          if (split && u != v)
+            edges.emplace_back(u, v, g(e));
+          edges.emplace_back(split ? v : u, split ? u : v,
+                             graph_impl::forward_element<G1>(g(e)));
+        }
+        h.add_edges(std::move(edges));
+
+        // The edges of h are enumerated in the order they were added.
+        std::vector<std::size_t> handles;
+        handles.reserve(h.size());
+        for (Edge<G2> e : h.edges())
+          handles.push_back(e);
+        for (std::size_t& e : m.edges)
+          if (e != npos)
+            e = handles[e];
+        return h;
+      }
+
+    // Map the edges of g to those of the compressed graph h, whose out edges
+    // are placed in the order in which the edges of g are enumerated.
+    template<typename V, typename E, typename G>
+      void
+      map_edges(const compressed_graph<V, E>& h, const G& g,
+                compaction_map& m)
+      {
+        std::vector<std::size_t> next(h.order() + 1, 0);
+        for (std::size_t v = 0; v != h.order(); ++v)
+          next[v + 1] = next[v] + h.out_degree(v);
+
+        m.edges.assign(edge_bound(g), npos);
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = m.vertices[g.source(e)];
+          std::size_t v = m.vertices[g.target(e)];
+          m.edges[e] = next[u]++;
+          if (!Directed_graph<G>() && u != v)
+            ++next[v];
+        }
+      }
+
+    template<typename H, typename G>
+      inline void
+      map_edges(const H&, const G&, compaction_map& m)
+      {
+        m.edges.clear();
+      }
+
+    // Build an immutable graph from g.
+    template<typename G2, typename G1>
+      G2
+      build(G1&& g, compaction_map& m, long)
+      {
+        G2 h(g);
+        number_vertices(g, m);
+        map_edges(h, g, m);
+        return h;
+      }
+
+  } // namespace convert_impl
+
+
+  // Returns a graph of type G2 with the vertices and edges of g, and in m,
+  // the vertex and edge of the graph for each vertex and edge of g.
+  template<typename G2, typename G1>
+    inline G2
+    convert(G1&& g, compaction_map& m)
+    {
+      return convert_impl::build<G2>(std::forward<G1>(g), m, 0);
+    }
+
+  // Returns a graph of type G2 with the vertices and edges of g.
+  template<typename G2, typename G1>
+    inline G2
+    convert(G1&& g)
+    {
+      compaction_map m;
+      return convert<G2>(std::forward<G1>(g), m);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <string>
+
+#include <origin/graph/convert.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A value that counts its copies.
+struct tracked
+{
+  tracked(int n = 0) : value(n) { }
+  tracked(const tracked& x) : value(x.value) { ++copies; }
+  tracked(tracked&& x) noexcept : value(x.value) { }
+
+  tracked& operator=(const tracked& x)
+  {
+    value = x.value;
+    ++copies;
+    return *this;
+  }
+
+  tracked& operator=(tracked&& x) noexcept
+  {
+    value = x.value;
+    return *this;
+  }
+
+  static int copies;
+  int value;
+};
+
+int tracked::copies = 0;
+
+using G = directed_adjacency_list<string, int>;
+using U = undirected_adjacency_list<string, int>;
+
+// Build a directed graph with holes in its vertex and edge handles: the
+// vertices 1 to 5 with values "1" to "5", and the edges of a path and a
+// loop, valued by their sources.
+G
+build_graph()
+{
+  G g;
+  for (int i = 0; i != 6; ++i)
+    g.add_vertex(to_string(i));
+  g.add_edge(0, 1, 0);
+  for (int i = 1; i != 5; ++i)
+    g.add_edge(i, i + 1, i);
+  g.add_edge(3, 3, 3);
+  g.remove_vertex(0);
+  return g;
+}
+
+// Check that h has the vertices and edges of g under the mapping m.
+template<typename G1, typename G2>
+  void
+  check_mapping(const G1& g, const G2& h, const compaction_map& m)
+  {
+    assert(h.order() == g.order());
+    for (auto v : g.vertices())
+      assert(h(m.vertex(v)) == g(v));
+    for (auto e : g.edges()) {
+      auto f = m.edge(e);
+      assert(h.source(f) == m.vertex(g.source(e)));
+      assert(h.target(f) == m.vertex(g.target(e)));
+      assert(h(f) == g(e));
+    }
+  }
+
+template<typename H>
+  void
+  check_directed()
+  {
+    G g = build_graph();
+    compaction_map m;
+    H h = convert<H>(g, m);
+    assert(h.size() == g.size());
+    assert(m.vertices[0] == size_t(-1));
+    assert(m.edges[0] == size_t(-1));
+    assert(m.vertices[1] == 0);
+    check_mapping(g, h, m);
+  }
+
+// An undirected graph yields a pair of directed edges for each non-loop
+// edge, and a directed graph an undirected edge for each edge.
+void
+check_direction()
+{
+  G g = build_graph();
+  compaction_map m;
+  auto u = convert<U>(g, m);
+  assert(u.size() == g.size());
+  for (auto e : g.edges())
+    assert(u(m.edge(e)) == g(e));
+
+  auto d = convert<directed_adjacency_vector<string, int>>(u, m);
+  assert(d.size() == 2 * u.size() - 1);
+  check_mapping(u, d, m);
+  for (auto v : d.vertices())
+    assert(d.out_degree(v) == d.in_degree(v));
+
+  auto c = convert<compressed_graph<string, int>>(u, m);
+  assert(c.size() == d.size());
+  check_mapping(u, c, m);
+}
+
+// Converting an rvalue moves the values of its vertices and edges.
+void
+check_move()
+{
+  directed_adjacency_list<tracked, tracked> g;
+  for (int i = 0; i != 100; ++i)
+    g.add_vertex(i);
+  for (int i = 0; i != 99; ++i)
+    g.add_edge(i, i + 1, i);
+
+  tracked::copies = 0;
+  auto h = convert<directed_adjacency_vector<tracked, tracked>>(g);
+  assert(tracked::copies == 199);
+  assert(h(h(vertex_handle(3), vertex_handle(4))).value == 3);
+
+  tracked::copies = 0;
+  auto k = convert<directed_adjacency_list<tracked, tracked>>(std::move(h));
+  assert(tracked::copies == 0);
+  assert(k.order() == 100 && k.size() == 99);
+  for (auto e : k.edges())
+    assert(k(e).value == int(k.source(e)));
+}
+
+int main()
+{
+  check_directed<directed_adjacency_list<string, int>>();
+  check_directed<directed_adjacency_vector<string, int>>();
+  check_directed<compressed_graph<string, int>>();
+  check_direction();
+  check_move();
+}
@@ -0,0 +1,346 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_COORDINATE_GRAPH_HPP
+#define ORIGIN_GRAPH_COORDINATE_GRAPH_HPP
+
+#include <cassert>
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/type/empty.hpp>
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/execution.hpp>
+#include <origin/memory/usage.hpp>
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.coordinate]
+  //                          Coordinate Graph
+  //
+  // A coordinate graph stores its edges in coordinate (COO) format: three
+  // arrays holding the source, target, and value of every edge, in the
+  // order in which the edges were added. It has no incidence lists, so that
+  // adding an edge is three appends, and the graph is well suited to
+  // ingesting edges that are written once and then converted or traversed
+  // as a whole. It is an edge list graph (see Edge_list_graph): it provides
+  // the vertex set, g.edges(), g.source(e), g.target(e), and g(e), but not
+  // the edges of a vertex.
+  //
+  // Edges are added one at a time by g.add_edge(u, v[, x]), from a range of
+  // edge descriptions by g.add_edges(r) (see [graph.bulk]), or in parallel
+  // by g.append_edges(m, f), which grows the arrays once and then calls
+  // f(i) for each i in [0, m), on several threads, to describe the i-th new
+  // edge. Their endpoints must be vertices of the graph.
+  //
+  // A coordinate graph is directed or undirected, as given on construction.
+  // The direction of edges is used by the streaming algorithms, which
+  // accept a coordinate graph in place of an edge stream (see
+  // [graph.streaming]), and by g.compress(), which returns the compressed
+  // graph (see [graph.compressed]) holding the same edges. Its edges are
+  // sorted by source with a parallel radix sort (see algo.radix), which is
+  // stable, so that the out edges of each vertex keep the order in which
+  // they were added. As when compressing an undirected graph, each non-loop
+  // edge of an undirected coordinate graph yields a pair of edges. The
+  // minimum spanning tree algorithms (see [graph.spanning_tree]) accept a
+  // coordinate graph, whose edges they treat as undirected.
+  template<typename V = empty_t, typename E = empty_t>
+    class coordinate_graph
+    {
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+      using edge = edge_handle;
+      using edge_range = compressed_graph_impl::handle_range<edge_handle>;
+
+
+      // Initialize an empty graph whose edges are directed or not.
+      explicit coordinate_graph(bool directed = true)
+        : directed_(directed)
+      { }
+
+      // Initialize a graph with n vertices, with default values, and no
+      // edges.
+      explicit coordinate_graph(std::size_t n, bool directed = true)
+        : verts_(n), directed_(directed)
+      { }
+
+
+      // Observers
+      bool        null() const  { return verts_.empty(); }
+      std::size_t order() const { return verts_.size(); }
+
+      bool        empty() const { return targets_.empty(); }
+      std::size_t size() const  { return targets_.size(); }
+
+      // Returns true if the edges of the graph are directed.
+      bool directed() const { return directed_; }
+
+      // Edge observers
+      vertex source(edge e) const { return sources_[e]; }
+      vertex target(edge e) const { return targets_[e]; }
+
+      // Data access
+      V&       operator()(vertex v)       { return verts_[v]; }
+      const V& operator()(vertex v) const { return verts_[v]; }
+
+      E&       operator()(edge e)       { return edges_[e]; }
+      const E& operator()(edge e) const { return edges_[e]; }
+
+      // Returns the footprint of the arrays of the graph. See [mem.usage].
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(verts_) + contiguous_footprint(sources_)
+             + contiguous_footprint(targets_) + contiguous_footprint(edges_);
+      }
+
+      // Capacity
+      void reserve(std::size_t n, std::size_t m);
+
+      // Vertex set
+      vertex add_vertex()           { return add_vertex(V()); }
+      vertex add_vertex(const V& x);
+      vertex add_vertex(V&& x);
+
+      // Edge set
+      edge add_edge(vertex u, vertex v) { return add_edge(u, v, E()); }
+      edge add_edge(vertex u, vertex v, const E& x);
+      edge add_edge(vertex u, vertex v, E&& x);
+
+      template<typename R>
+        void add_edges(R&& r);
+
+      template<typename F>
+        void append_edges(std::size_t m, F f,
+                          std::size_t threads = search_threads());
+
+      // Remove every vertex and edge.
+      void clear();
+
+      // Iterators
+      vertex_range vertices() const { return {0, order()}; }
+      edge_range   edges() const    { return {0, size()}; }
+
+      // Call f(u, v) for the source u and target v of each edge, in order.
+      template<typename F>
+        void for_each_edge(F f) const;
+
+      // Conversion
+      compressed_graph<V, E> compress(std::size_t threads = search_threads())
+        const;
+
+    private:
+      // Write the edge description x to the edge e.
+      template<typename T>
+        void set_edge(std::size_t e, T&& x, size_constant<2>);
+
+      template<typename T>
+        void set_edge(std::size_t e, T&& x, size_constant<3>);
+
+    private:
+      std::vector<V>             verts_;    // Vertex values
+      std::vector<vertex_handle> sources_;  // Source of each edge
+      std::vector<vertex_handle> targets_;  // Target of each edge
+      std::vector<E>             edges_;    // Edge values
+      bool                       directed_;
+    };
+
+
+  namespace coordinate_graph_impl
+  {
+    // The number of edges processed by each parallel task.
+    constexpr std::size_t grain = 4096;
+  } // namespace coordinate_graph_impl
+
+
+  // Reserve capacity for n vertices and m edges.
+  template<typename V, typename E>
+    void
+    coordinate_graph<V, E>::reserve(std::size_t n, std::size_t m)
+    {
+      verts_.reserve(n);
+      sources_.reserve(m);
+      targets_.reserve(m);
+      edges_.reserve(m);
+    }
+
+  template<typename V, typename E>
+    inline auto
+    coordinate_graph<V, E>::add_vertex(const V& x) -> vertex
+    {
+      verts_.push_back(x);
+      return order() - 1;
+    }
+
+  template<typename V, typename E>
+    inline auto
+    coordinate_graph<V, E>::add_vertex(V&& x) -> vertex
+    {
+      verts_.push_back(std::move(x));
+      return order() - 1;
+    }
+
+  template<typename V, typename E>
+    inline auto
+    coordinate_graph<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    {
+      assert(u < order() && v < order());
+      sources_.push_back(u);
+      targets_.push_back(v);
+      edges_.push_back(x);
+      return size() - 1;
+    }
+
+  template<typename V, typename E>
+    inline auto
+    coordinate_graph<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    {
+      assert(u < order() && v < order());
+      sources_.push_back(u);
+      targets_.push_back(v);
+      edges_.push_back(std::move(x));
+      return size() - 1;
+    }
+
+  // Add each edge described by the range r to the graph (see [graph.bulk]).
+  // The arrays are grown at most once.
+  template<typename V, typename E>
+    template<typename R>
+      void
+      coordinate_graph<V, E>::add_edges(R&& r)
+      {
+        std::size_t m = 0;
+        for (const auto& x : r) {
+          (void)x;
+          ++m;
+        }
+        reserve(order(), size() + m);
+        for (auto&& x : r)
+          graph_impl::add_described_edge(
+            *this, graph_impl::forward_element<R>(x));
+      }
+
+  template<typename V, typename E>
+    template<typename T>
+      inline void
+      coordinate_graph<V, E>::set_edge(std::size_t e, T&& x, size_constant<2>)
+      {
+        sources_[e] = std::get<0>(x);
+        targets_[e] = std::get<1>(x);
+        assert(sources_[e] < order() && targets_[e] < order());
+      }
+
+  template<typename V, typename E>
+    template<typename T>
+      inline void
+      coordinate_graph<V, E>::set_edge(std::size_t e, T&& x, size_constant<3>)
+      {
+        set_edge(e, x, size_constant<2>{});
+        edges_[e] = std::get<2>(std::forward<T>(x));
+      }
+
+  // Append m edges to the graph, the i-th of which is described by f(i).
+  // The calls are made in parallel, on up to threads threads, and each
+  // writes its edge directly into the arrays of the graph.
+  template<typename V, typename E>
+    template<typename F>
+      void
+      coordinate_graph<V, E>::append_edges(std::size_t m, F f,
+                                           std::size_t threads)
+      {
+        using coordinate_graph_impl::grain;
+        std::size_t first = size();
+        sources_.resize(first + m);
+        targets_.resize(first + m);
+        edges_.resize(first + m);
+        std::size_t blocks = (m + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t end = std::min(m, (k + 1) * grain);
+          for (std::size_t i = k * grain; i != end; ++i) {
+            auto x = f(i);
+            set_edge(first + i, std::move(x),
+                     graph_impl::Edge_description_size<decltype(x)>{});
+          }
+        });
+      }
+
+  template<typename V, typename E>
+    void
+    coordinate_graph<V, E>::clear()
+    {
+      verts_.clear();
+      sources_.clear();
+      targets_.clear();
+      edges_.clear();
+    }
+
+  template<typename V, typename E>
+    template<typename F>
+      inline void
+      coordinate_graph<V, E>::for_each_edge(F f) const
+      {
+        for (std::size_t e = 0; e != size(); ++e)
+          f(sources_[e], targets_[e]);
+      }
+
+  // Returns the compressed graph holding the edges of this graph. The arcs
+  // of the compressed graph are numbered 2e and 2e + 1 for the edge e and
+  // its reversal, when the graph is undirected, and e otherwise; they are
+  // sorted by their sources and then gathered, in parallel.
+  template<typename V, typename E>
+    compressed_graph<V, E>
+    coordinate_graph<V, E>::compress(std::size_t threads) const
+    {
+      using coordinate_graph_impl::grain;
+      bool both = !directed_;
+      std::vector<std::size_t> arcs;
+      arcs.reserve(both ? 2 * size() : size());
+      for (std::size_t e = 0; e != size(); ++e) {
+        if (!both) {
+          arcs.push_back(e);
+          continue;
+        }
+        arcs.push_back(2 * e);
+        if (sources_[e] != targets_[e])
+          arcs.push_back(2 * e + 1);
+      }
+      auto tail = [&](std::size_t a) -> std::size_t {
+        if (!both)
+          return sources_[a];
+        return a % 2 ? targets_[a / 2] : sources_[a / 2];
+      };
+      radix_sort(par, arcs, tail);
+
+      std::size_t m = arcs.size();
+      std::vector<vertex_handle> sources(m);
+      std::vector<vertex_handle> targets(m);
+      std::vector<E> values(m);
+      std::size_t blocks = (m + grain - 1) / grain;
+      search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+        std::size_t end = std::min(m, (k + 1) * grain);
+        for (std::size_t i = k * grain; i != end; ++i) {
+          std::size_t a = arcs[i];
+          std::size_t e = both ? a / 2 : a;
+          bool reversed = both && a % 2;
+          sources[i] = reversed ? targets_[e] : sources_[e];
+          targets[i] = reversed ? sources_[e] : targets_[e];
+          values[i] = edges_[e];
+        }
+      });
+      return {verts_, std::move(sources), std::move(targets),
+              std::move(values)};
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/coordinate_graph.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/components.hpp>
+#include <origin/graph/iterative.hpp>
+#include <origin/graph/search.hpp>
+#include <origin/graph/spanning_tree.hpp>
+#include <origin/graph/streaming.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns true if the compressed graphs a and b have the same edges, in
+// the same order.
+template<typename C>
+  bool
+  same_edges(const C& a, const C& b)
+  {
+    if (a.order() != b.order() || a.size() != b.size())
+      return false;
+    for (auto e : a.edges())
+      if (a.source(e) != b.source(e) || a.target(e) != b.target(e)
+          || a(e) != b(e))
+        return false;
+    for (auto v : a.vertices())
+      if (a.in_degree(v) != b.in_degree(v))
+        return false;
+    return true;
+  }
+
+// The edge (i * 7 + 3) % n -> (i * 13 + 5) % n, weighted by i % 10.
+tuple<size_t, size_t, int>
+describe(size_t i, size_t n)
+{
+  return make_tuple((i * 7 + 3) % n, (i * 13 + 5) % n, int(i % 10));
+}
+
+// Edges added one at a time, in bulk, and in parallel are the same.
+void
+check_append()
+{
+  const size_t n = 100, m = 20000;
+  coordinate_graph<empty_t, int> a(n);
+  for (size_t i = 0; i != m; ++i) {
+    auto x = describe(i, n);
+    a.add_edge(get<0>(x), get<1>(x), get<2>(x));
+  }
+  assert(a.order() == n && a.size() == m && a.directed());
+
+  vector<tuple<size_t, size_t, int>> xs;
+  for (size_t i = 0; i != m; ++i)
+    xs.push_back(describe(i, n));
+  coordinate_graph<empty_t, int> b(n);
+  b.add_edges(xs);
+
+  coordinate_graph<empty_t, int> c(n);
+  c.append_edges(m / 2, [](size_t i) { return describe(i, n); }, 4);
+  c.append_edges(m - m / 2, [](size_t i) { return describe(i + m / 2, n); });
+
+  for (auto e : a.edges()) {
+    assert(b.source(e) == a.source(e) && c.source(e) == a.source(e));
+    assert(b.target(e) == a.target(e) && c.target(e) == a.target(e));
+    assert(b(e) == a(e) && c(e) == a(e));
+  }
+
+  // Descriptions without values.
+  coordinate_graph<> d(3, false);
+  d.append_edges(2, [](size_t i) { return make_pair(i, i + 1); });
+  assert(!d.directed() && d.size() == 2);
+  assert(d.source(1) == 1 && d.target(1) == 2);
+
+  d.clear();
+  assert(d.null() && d.empty());
+}
+
+// Compressing a coordinate graph yields the compressed graph of a graph
+// with the same edges.
+void
+check_compress()
+{
+  const size_t n = 300, m = 5000;
+  directed_adjacency_vector<empty_t, int> dg;
+  undirected_adjacency_vector<empty_t, int> ug;
+  for (size_t v = 0; v != n; ++v) {
+    dg.add_vertex();
+    ug.add_vertex();
+  }
+  coordinate_graph<empty_t, int> dc(n);
+  coordinate_graph<empty_t, int> uc(n, false);
+  for (size_t i = 0; i != m; ++i) {
+    auto x = describe(i, n);
+    dg.add_edge(get<0>(x), get<1>(x), get<2>(x));
+    ug.add_edge(get<0>(x), get<1>(x), get<2>(x));
+    dc.add_edge(get<0>(x), get<1>(x), get<2>(x));
+    uc.add_edge(get<0>(x), get<1>(x), get<2>(x));
+  }
+
+  compressed_graph<empty_t, int> a(dg);
+  assert(same_edges(dc.compress(), a));
+  assert(same_edges(dc.compress(1), a));
+  compressed_graph<empty_t, int> b(ug);
+  assert(same_edges(uc.compress(), b));
+
+  // A loop of an undirected graph yields a single edge.
+  coordinate_graph<> l(2, false);
+  l.add_edge(0, 0);
+  l.add_edge(0, 1);
+  compressed_graph<> c = l.compress();
+  assert(c.size() == 3 && c.out_degree(0) == 2 && c.out_degree(1) == 1);
+}
+
+// Kruskal's and Boruvka's algorithms accept a coordinate graph.
+void
+check_spanning_tree()
+{
+  const size_t n = 200, m = 3000;
+  undirected_adjacency_vector<empty_t, int> g;
+  for (size_t v = 0; v != n; ++v)
+    g.add_vertex();
+  coordinate_graph<empty_t, int> c(n, false);
+  for (size_t i = 0; i != m; ++i) {
+    auto x = describe(i, n);
+    g.add_edge(get<0>(x), get<1>(x), get<2>(x));
+    c.add_edge(get<0>(x), get<1>(x), get<2>(x));
+  }
+
+  vector<Edge<decltype(g)>> gt;
+  int w = minimum_spanning_tree(g, gt);
+  vector<edge_handle> ct;
+  assert(minimum_spanning_tree(c, ct) == w);
+  assert(ct.size() == gt.size());
+  for (size_t i = 0; i != ct.size(); ++i)
+    assert(c(ct[i]) == g(gt[i]));
+
+  vector<edge_handle> pt;
+  assert(parallel_minimum_spanning_tree(c, pt, 4) == w);
+  assert(pt == ct);
+}
+
+// The streaming algorithms run directly on a coordinate graph.
+void
+check_streaming()
+{
+  for (bool directed : {true, false}) {
+    const size_t n = 16;
+    coordinate_graph<> c(n, directed);
+    directed_adjacency_vector<> dg;
+    undirected_adjacency_vector<> ug;
+    for (size_t v = 0; v != n; ++v) {
+      dg.add_vertex();
+      ug.add_vertex();
+    }
+    for (size_t i = 0; i != 9; ++i) {
+      c.add_edge(i, i + 1);
+      dg.add_edge(i, i + 1);
+      ug.add_edge(i, i + 1);
+    }
+    for (size_t i = 10; i != 14; ++i) {
+      c.add_edge(i + 1, i);
+      dg.add_edge(i + 1, i);
+      ug.add_edge(i + 1, i);
+    }
+
+    vector<size_t> ls = streaming_breadth_first_levels(c, 0);
+    if (directed)
+      assert(ls == breadth_first_levels(dg, 0, 1));
+    else
+      assert(ls == breadth_first_levels(ug, 0, 1));
+
+    vector<size_t> cs;
+    assert(streaming_connected_components(c, cs) == 3);
+    assert(cs[9] == cs[0] && cs[14] == cs[10] && cs[15] != cs[0]);
+
+    vector<double> rs;
+    vector<double> pr;
+    streaming_pagerank(c, rs);
+    if (directed)
+      pagerank(dg, pr);
+    else
+      pagerank(ug, pr);
+    for (size_t v = 0; v != n; ++v)
+      assert(abs(rs[v] - pr[v]) < 1e-6);
+  }
+}
+
+int main()
+{
+  check_append();
+  check_compress();
+  check_spanning_tree();
+  check_streaming();
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include "distributed.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                          Shared Memory Network
+
+  class shared_memory_network::endpoint_type : public transport
+  {
+  public:
+    endpoint_type(shared_memory_network& net, std::size_t r)
+      : net_(net), rank_(r)
+    { }
+
+    std::size_t rank() const { return rank_; }
+    std::size_t size() const { return net_.size(); }
+
+    void post(std::vector<message>& out);
+    void wait(std::vector<message>& in);
+    double sum(double x);
+
+  private:
+    shared_memory_network& net_;
+    std::size_t rank_;
+  };
+
+  // Each message is moved into the mailbox of its receiver, which has
+  // taken the messages of the previous exchange.
+  void
+  shared_memory_network::endpoint_type::post(std::vector<message>& out)
+  {
+    assert(out.size() == size());
+    std::lock_guard<std::mutex> lock(net_.mutex_);
+    for (std::size_t r = 0; r != size(); ++r)
+      net_.mail_[r][rank_].swap(out[r]);
+  }
+
+  // The second barrier keeps the next exchange from overwriting messages
+  // that are not yet taken.
+  void
+  shared_memory_network::endpoint_type::wait(std::vector<message>& in)
+  {
+    in.resize(size());
+    net_.barrier();
+    {
+      std::lock_guard<std::mutex> lock(net_.mutex_);
+      for (std::size_t r = 0; r != size(); ++r)
+        in[r].swap(net_.mail_[rank_][r]);
+    }
+    net_.barrier();
+  }
+
+  // The values are added in order of rank, so that every rank computes the
+  // same sum.
+  double
+  shared_memory_network::endpoint_type::sum(double x)
+  {
+    {
+      std::lock_guard<std::mutex> lock(net_.mutex_);
+      net_.values_[rank_] = x;
+    }
+    net_.barrier();
+    double s = 0;
+    {
+      std::lock_guard<std::mutex> lock(net_.mutex_);
+      for (double y : net_.values_)
+        s += y;
+    }
+    net_.barrier();
+    return s;
+  }
+
+  shared_memory_network::shared_memory_network(std::size_t k)
+    : mail_(k, std::vector<message>(k)), values_(k), arrived_(0),
+      generation_(0)
+  {
+    for (std::size_t r = 0; r != k; ++r)
+      ends_.emplace_back(new endpoint_type(*this, r));
+  }
+
+  shared_memory_network::~shared_memory_network()
+  { }
+
+  transport&
+  shared_memory_network::endpoint(std::size_t r)
+  {
+    return *ends_[r];
+  }
+
+  void
+  shared_memory_network::barrier()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::size_t gen = generation_;
+    if (++arrived_ == size()) {
+      arrived_ = 0;
+      ++generation_;
+      cond_.notify_all();
+    } else {
+      cond_.wait(lock, [&] { return generation_ != gen; });
+    }
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                             Message Encoding
+
+  namespace distributed_impl
+  {
+    void
+    encode_positions(message& m, const std::vector<std::size_t>& ps,
+                     bool compress)
+    {
+      if (!compress) {
+        for (std::size_t p : ps)
+          put(m, std::uint64_t(p));
+        return;
+      }
+      std::size_t prev = 0;
+      for (std::size_t p : ps) {
+        std::uint64_t x = p - prev;
+        prev = p;
+        while (x >= 0x80) {
+          m.push_back((unsigned char)(x | 0x80));
+          x >>= 7;
+        }
+        m.push_back((unsigned char)x);
+      }
+    }
+
+    void
+    decode_positions(const message& m, std::vector<std::size_t>& ps,
+                     bool compress)
+    {
+      const unsigned char* p = m.data();
+      const unsigned char* last = p + m.size();
+      if (!compress) {
+        while (p != last) {
+          std::uint64_t x;
+          p = get(p, x);
+          ps.push_back(x);
+        }
+        return;
+      }
+      std::size_t prev = 0;
+      while (p != last) {
+        std::uint64_t x = 0;
+        for (int shift = 0; ; shift += 7) {
+          unsigned char b = *p++;
+          x |= std::uint64_t(b & 0x7f) << shift;
+          if (!(b & 0x80))
+            break;
+        }
+        prev += x;
+        ps.push_back(prev);
+      }
+    }
+  } // namespace distributed_impl
+
+} // namespace origin
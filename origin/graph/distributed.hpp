@@ -0,0 +1,492 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_DISTRIBUTED_HPP
+#define ORIGIN_GRAPH_DISTRIBUTED_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <origin/data/flat_hash/flat_hash_map.hpp>
+#include <origin/graph/iterative.hpp>
+#include <origin/graph/partition.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.distributed]
+  //                           Distributed Graphs
+  //
+  // A distributed graph is a graph partitioned over a number of ranks
+  // (processes or machines), each of which holds one part: the subgraph of
+  // its vertices and their ghosts (see [graph.partition]). Every rank runs
+  // the same sequence of collective operations, which exchange messages
+  // with the other ranks through a transport:
+  //
+  //    auto parts = fennel_partition(g, k);
+  //    auto subs = partition_subgraphs(g, parts, k);
+  //    distributed_graph<G> dg(std::move(subs[r]), t);   // On rank r
+  //    auto levels = distributed_breadth_first_levels(dg, s);
+  //    distributed_pagerank(dg, ranks);
+  //
+  // A transport moves batches of bytes between ranks. An exchange is split
+  // in two phases, so that a rank can compute while its messages are in
+  // flight: post(out) sends out[r] to each rank r, and wait(in) blocks
+  // until the messages posted to this rank by every rank have arrived,
+  // with in[r] holding the message from r. The transport also sums a value
+  // over all ranks. A transport over MPI implements post and wait with
+  // nonblocking all-to-all operations (MPI_Ialltoallv and MPI_Wait), and
+  // sum with MPI_Allreduce; the shared memory transport runs the ranks as
+  // threads of one process, and is used for testing.
+  //
+  // The vertices of a part that are ghosts of another part are its mirrors.
+  // When a distributed graph is constructed, each rank sends the global
+  // handles of its ghosts to their owners, which record their mirrors. The
+  // ghost and mirror lists of each pair of ranks are in the same order, so
+  // later messages refer to a vertex by its position in the list instead of
+  // its handle, and values of the mirrors are sent without handles at all.
+  // Positions are sent sorted, and can be compressed as differences encoded
+  // in variable-length bytes.
+  //
+  // The algorithms are the level-synchronous search and PageRank of a
+  // single graph, run over the subgraph of each part. In each superstep, a
+  // rank first processes its boundary vertices (those with ghost
+  // neighbors), posts the updates for the ghosts it reached, and processes
+  // its interior vertices while the updates are exchanged. Values are
+  // indexed by the local vertices of the part; those of the ghosts are
+  // copies, valid only where stated.
+
+
+  // A message is a batch of bytes sent between two ranks.
+  using message = std::vector<unsigned char>;
+
+  // The interface of a transport between the ranks of a distributed graph.
+  class transport
+  {
+  public:
+    virtual ~transport() { }
+
+    // Returns this rank and the number of ranks.
+    virtual std::size_t rank() const = 0;
+    virtual std::size_t size() const = 0;
+
+    // Start sending out[r] to each rank r. The buffers in out may be
+    // exchanged for others.
+    virtual void post(std::vector<message>& out) = 0;
+
+    // Receive the messages posted to this rank, in[r] from rank r.
+    virtual void wait(std::vector<message>& in) = 0;
+
+    // Returns the sum of x over all ranks. Each rank receives the same
+    // value.
+    virtual double sum(double x) = 0;
+  };
+
+
+  // A shared memory network connects ranks that are threads of the same
+  // process. The transport of rank r is endpoint(r), which must be used
+  // only by the thread of that rank. See distributed.cpp.
+  class shared_memory_network
+  {
+    class endpoint_type;
+
+  public:
+    explicit shared_memory_network(std::size_t k);
+    ~shared_memory_network();
+
+    shared_memory_network(const shared_memory_network&) = delete;
+    shared_memory_network& operator=(const shared_memory_network&) = delete;
+
+    std::size_t size() const { return ends_.size(); }
+
+    transport& endpoint(std::size_t r);
+
+  private:
+    void barrier();
+
+  private:
+    std::vector<std::unique_ptr<endpoint_type>> ends_;
+    std::vector<std::vector<message>> mail_; // mail_[to][from]
+    std::vector<double> values_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::size_t arrived_;
+    std::size_t generation_;
+  };
+
+
+  namespace distributed_impl
+  {
+    // Append the bytes of x to m.
+    template<typename T>
+      inline void
+      put(message& m, const T& x)
+      {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&x);
+        m.insert(m.end(), p, p + sizeof(T));
+      }
+
+    // Read a T from p, returning the past-the-end of its bytes.
+    template<typename T>
+      inline const unsigned char*
+      get(const unsigned char* p, T& x)
+      {
+        std::memcpy(&x, p, sizeof(T));
+        return p + sizeof(T);
+      }
+
+    // Write the sorted positions ps to m, as 64-bit words or as differences
+    // encoded in 7-bit groups.
+    void encode_positions(message& m, const std::vector<std::size_t>& ps,
+                          bool compress);
+
+    // Append the positions in m to ps.
+    void decode_positions(const message& m, std::vector<std::size_t>& ps,
+                          bool compress);
+
+    // Call f(v) for each successor v of u in g.
+    template<typename G, typename F>
+      inline void
+      for_successors(const G& g, Vertex<G> u, F f)
+      {
+        for (Edge<G> e : search_impl::successor_edges(g, u))
+          f(opposite(g, e, u));
+      }
+
+  } // namespace distributed_impl
+
+
+  // A distributed graph is the part of a partitioned graph held by one
+  // rank. Constructing a distributed graph is a collective operation.
+  template<typename H>
+    class distributed_graph
+    {
+    public:
+      using vertex = Vertex<H>;
+
+      distributed_graph(graph_partition<H>&& p, transport& t,
+                        bool compress = false);
+
+      // Returns the subgraph of the part, and the number of its vertices
+      // that it owns.
+      const H&    graph() const { return part_.graph; }
+      std::size_t owned() const { return part_.owned; }
+
+      // Returns true if the local vertex v is owned by this rank.
+      bool is_owned(vertex v) const { return std::size_t(v) < owned(); }
+
+      // Returns true if the owned vertex v has a ghost neighbor.
+      bool is_boundary(vertex v) const { return boundary_[v]; }
+
+      // Returns the global handle of the local vertex v, and its owner.
+      std::size_t global(vertex v) const { return part_.global[v]; }
+      std::size_t owner(vertex v) const  { return part_.owner[v]; }
+
+      // Returns the number of vertices of the partitioned graph.
+      std::size_t global_order() const { return order_; }
+
+      transport& network() const { return net_; }
+      bool compressed() const { return compress_; }
+
+      // Copy the values x of the owned vertices to their ghosts on other
+      // ranks, and receive the values of the ghosts of this rank. The
+      // exchange can be split, computing between start and finish.
+      template<typename T>
+        void update_ghosts(std::vector<T>& x);
+
+      template<typename T>
+        void start_ghost_update(const std::vector<T>& x);
+
+      template<typename T>
+        void finish_ghost_update(std::vector<T>& x);
+
+      // Send the ghosts vs to their owners, and append the owned vertices
+      // sent to this rank to ws. The exchange can be split.
+      void start_ghost_send(const std::vector<vertex>& vs);
+      void finish_ghost_send(std::vector<vertex>& ws);
+
+    private:
+      graph_partition<H> part_;
+      transport& net_;
+      bool compress_;
+      std::size_t order_;
+      std::vector<std::vector<vertex>> mirrors_; // Owned, ghost on rank r
+      std::vector<std::vector<vertex>> ghosts_;  // Ghosts owned by rank r
+      std::vector<std::size_t> position_;        // Ghost position in ghosts_
+      std::vector<char> boundary_;
+      std::vector<message> out_;
+      std::vector<message> in_;
+      std::vector<std::vector<std::size_t>> pending_;
+      std::vector<std::size_t> positions_;
+    };
+
+  // Record the ghosts of each owner, and send their global handles to the
+  // owners, which record their mirrors.
+  template<typename H>
+    distributed_graph<H>::distributed_graph(graph_partition<H>&& p,
+                                            transport& t, bool compress)
+      : part_(std::move(p)), net_(t), compress_(compress),
+        out_(t.size()), in_(t.size()), pending_(t.size())
+    {
+      using namespace distributed_impl;
+      std::size_t k = t.size();
+      std::size_t n = part_.global.size();
+      mirrors_.resize(k);
+      ghosts_.resize(k);
+      position_.assign(n - owned(), 0);
+      for (std::size_t v = owned(); v != n; ++v) {
+        std::vector<vertex>& gs = ghosts_[owner(v)];
+        position_[v - owned()] = gs.size();
+        gs.push_back(vertex(v));
+        put(out_[owner(v)], std::uint64_t(global(v)));
+      }
+      net_.post(out_);
+      order_ = std::size_t(net_.sum(double(owned())));
+
+      boundary_.assign(owned(), false);
+      for (std::size_t v = 0; v != owned(); ++v)
+        for_successors(graph(), vertex(v), [&](vertex w) {
+          if (!is_owned(w))
+            boundary_[v] = true;
+        });
+
+      flat_hash_map<std::size_t, std::size_t> local;
+      for (std::size_t v = 0; v != owned(); ++v)
+        local.insert(std::make_pair(global(v), v));
+      net_.wait(in_);
+      for (std::size_t r = 0; r != k; ++r) {
+        const unsigned char* q = in_[r].data();
+        const unsigned char* last = q + in_[r].size();
+        while (q != last) {
+          std::uint64_t x;
+          q = get(q, x);
+          mirrors_[r].push_back(vertex(local.find(x)->second));
+        }
+      }
+    }
+
+  template<typename H>
+    template<typename T>
+      void
+      distributed_graph<H>::start_ghost_update(const std::vector<T>& x)
+      {
+        for (std::size_t r = 0; r != mirrors_.size(); ++r) {
+          message& m = out_[r];
+          m.clear();
+          for (vertex v : mirrors_[r])
+            distributed_impl::put(m, x[v]);
+        }
+        net_.post(out_);
+      }
+
+  template<typename H>
+    template<typename T>
+      void
+      distributed_graph<H>::finish_ghost_update(std::vector<T>& x)
+      {
+        net_.wait(in_);
+        for (std::size_t r = 0; r != ghosts_.size(); ++r) {
+          const unsigned char* q = in_[r].data();
+          for (vertex v : ghosts_[r])
+            q = distributed_impl::get(q, x[v]);
+        }
+      }
+
+  template<typename H>
+    template<typename T>
+      inline void
+      distributed_graph<H>::update_ghosts(std::vector<T>& x)
+      {
+        start_ghost_update(x);
+        finish_ghost_update(x);
+      }
+
+  template<typename H>
+    void
+    distributed_graph<H>::start_ghost_send(const std::vector<vertex>& vs)
+    {
+      for (vertex v : vs)
+        pending_[owner(v)].push_back(position_[v - owned()]);
+      for (std::size_t r = 0; r != pending_.size(); ++r) {
+        std::vector<std::size_t>& ps = pending_[r];
+        std::sort(ps.begin(), ps.end());
+        ps.erase(std::unique(ps.begin(), ps.end()), ps.end());
+        out_[r].clear();
+        distributed_impl::encode_positions(out_[r], ps, compress_);
+        ps.clear();
+      }
+      net_.post(out_);
+    }
+
+  template<typename H>
+    void
+    distributed_graph<H>::finish_ghost_send(std::vector<vertex>& ws)
+    {
+      net_.wait(in_);
+      for (std::size_t r = 0; r != in_.size(); ++r) {
+        positions_.clear();
+        distributed_impl::decode_positions(in_[r], positions_, compress_);
+        for (std::size_t i : positions_)
+          ws.push_back(mirrors_[r][i]);
+      }
+    }
+
+
+  // Returns the distance from the vertex s of the partitioned graph to each
+  // local vertex of dg, or size_t(-1) if it is unreachable. Only the
+  // distances of owned vertices are valid.
+  template<typename H>
+    std::vector<std::size_t>
+    distributed_breadth_first_levels(distributed_graph<H>& dg, std::size_t s)
+    {
+      using V = Vertex<H>;
+      constexpr std::size_t none = -1;
+      const H& g = dg.graph();
+      std::vector<std::size_t> levels(search_impl::vertex_bound(g), none);
+
+      std::vector<V> frontier;
+      for (std::size_t v = 0; v != dg.owned(); ++v) {
+        if (dg.global(V(v)) == s) {
+          levels[v] = 0;
+          frontier.push_back(V(v));
+        }
+      }
+
+      std::vector<V> next;
+      std::vector<V> reached;
+      for (std::size_t d = 0; ; ++d) {
+        auto expand = [&](V u) {
+          distributed_impl::for_successors(g, u, [&](V w) {
+            if (levels[w] == none) {
+              levels[w] = d + 1;
+              (dg.is_owned(w) ? next : reached).push_back(w);
+            }
+          });
+        };
+
+        // Boundary vertices reach ghosts, which are sent to their owners
+        // while the interior is searched.
+        for (V u : frontier)
+          if (dg.is_boundary(u))
+            expand(u);
+        dg.start_ghost_send(reached);
+        reached.clear();
+        for (V u : frontier)
+          if (!dg.is_boundary(u))
+            expand(u);
+
+        std::size_t k = next.size();
+        dg.finish_ghost_send(next);
+        for (std::size_t i = k; i != next.size(); ++i) {
+          V w = next[i];
+          if (levels[w] == none)
+            levels[w] = d + 1;
+          else
+            next[i] = V();
+        }
+        next.erase(std::remove(next.begin() + k, next.end(), V()),
+                   next.end());
+
+        if (dg.network().sum(double(next.size())) == 0)
+          break;
+        frontier.swap(next);
+        next.clear();
+      }
+      return levels;
+    }
+
+
+  // Compute the PageRank of each vertex of the partitioned graph, as by
+  // pagerank(g, ranks, opts) (see [graph.iterative]), writing the ranks of
+  // the local vertices of dg to ranks. Returns the number of iterations
+  // performed. Only the ranks of owned vertices are valid. The mode,
+  // threads and stats options are not used.
+  template<typename H>
+    std::size_t
+    distributed_pagerank(distributed_graph<H>& dg,
+                         std::vector<double>& ranks,
+                         const iteration_options& opts = {})
+    {
+      using V = Vertex<H>;
+      const H& g = dg.graph();
+      std::size_t local = search_impl::vertex_bound(g);
+      double n = dg.global_order();
+      ranks.assign(local, n ? 1.0 / n : 0);
+      if (n == 0)
+        return 0;
+
+      // Count the out edges of the owned vertices, and copy the counts to
+      // their ghosts. Each edge of an owned vertex is in its part.
+      std::vector<double> out(local);
+      for (Edge<H> e : g.edges()) {
+        V u = g.source(e);
+        V v = g.target(e);
+        if (dg.is_owned(u))
+          ++out[u];
+        if (Undirected_graph<H>() && dg.is_owned(v))
+          ++out[v];
+      }
+      dg.update_ghosts(out);
+
+      // Add the shares of the sources of edges to the sums of their owned
+      // targets; own selects the edges whose sources are owned.
+      std::vector<double> share(local);
+      std::vector<double> sums(local);
+      auto gather = [&](bool own) {
+        for (Edge<H> e : g.edges()) {
+          V u = g.source(e);
+          V v = g.target(e);
+          if (dg.is_owned(v) && dg.is_owned(u) == own)
+            sums[v] += share[u];
+          if (Undirected_graph<H>() && dg.is_owned(u) && dg.is_owned(v) == own)
+            sums[u] += share[v];
+        }
+      };
+
+      double d = opts.damping;
+      std::size_t iter = 0;
+      while (iter < opts.max_iterations) {
+        ++iter;
+        double leak = 0;
+        for (std::size_t v = 0; v != dg.owned(); ++v) {
+          if (out[v] != 0)
+            share[v] = ranks[v] / out[v];
+          else
+            leak += ranks[v];
+        }
+        dg.start_ghost_update(share);
+        gather(true);
+        dg.finish_ghost_update(share);
+        gather(false);
+        leak = dg.network().sum(leak);
+
+        double c = 0;
+        for (std::size_t v = 0; v != dg.owned(); ++v) {
+          double r = (1 - d + d * leak) / n + d * sums[v];
+          c += std::abs(r - ranks[v]);
+          ranks[v] = r;
+          sums[v] = 0;
+        }
+        if (dg.network().sum(c) <= opts.tolerance)
+          break;
+      }
+      return iter;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <origin/graph/distributed.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+template<typename G>
+  G
+  build_random(size_t n, size_t m, size_t seed)
+  {
+    G g = build_n_graph<G>(n);
+    minstd_rand prng(seed);
+    for (size_t i = 0; i != m; ++i) {
+      size_t u = prng() % n;
+      size_t v = prng() % n;
+      if (u != v)
+        g.add_edge(u, v);
+    }
+    return g;
+  }
+
+// The levels and ranks computed over k ranks, each running in its own
+// thread, are those computed for the whole graph.
+template<typename G>
+  void
+  check_distributed(const G& g, size_t k, bool compress)
+  {
+    vector<size_t> parts = fennel_partition(g, k);
+    vector<graph_partition<G>> subs = partition_subgraphs(g, parts, k);
+
+    iteration_options opts;
+    opts.tolerance = 1e-12;
+    opts.max_iterations = 200;
+    vector<double> expected;
+    size_t iters = pagerank(g, expected, opts);
+
+    vector<size_t> levels(g.order());
+    vector<double> ranks(g.order());
+    vector<size_t> counts(k);
+    vector<size_t> sources = {0, g.order() / 2, g.order() - 1};
+    vector<vector<size_t>> found(sources.size(), vector<size_t>(g.order()));
+
+    shared_memory_network net(k);
+    vector<thread> ts;
+    for (size_t r = 0; r != k; ++r) {
+      ts.emplace_back([&, r]() {
+        distributed_graph<G> dg(std::move(subs[r]), net.endpoint(r),
+                                compress);
+        assert(dg.global_order() == g.order());
+        for (size_t i = 0; i != sources.size(); ++i) {
+          vector<size_t> ls = distributed_breadth_first_levels(dg,
+                                                               sources[i]);
+          for (size_t v = 0; v != dg.owned(); ++v)
+            found[i][dg.global(v)] = ls[v];
+        }
+        vector<double> rs;
+        counts[r] = distributed_pagerank(dg, rs, opts);
+        for (size_t v = 0; v != dg.owned(); ++v)
+          ranks[dg.global(v)] = rs[v];
+      });
+    }
+    for (thread& t : ts)
+      t.join();
+
+    for (size_t i = 0; i != sources.size(); ++i)
+      assert(found[i] == breadth_first_levels(g, sources[i], 1));
+    for (size_t r = 0; r != k; ++r)
+      assert(counts[r] == counts[0]);
+    assert(counts[0] <= iters + 1 && iters <= counts[0] + 1);
+    for (Vertex<G> v : g.vertices())
+      assert(abs(ranks[v] - expected[v]) < 1e-9);
+  }
+
+int main()
+{
+  using D = directed_adjacency_vector<int>;
+  using U = undirected_adjacency_vector<int>;
+  for (size_t k : {1, 2, 4}) {
+    check_distributed(build_random<D>(300, 900, k), k, false);
+    check_distributed(build_random<D>(300, 900, k), k, true);
+    check_distributed(build_random<U>(500, 800, k), k, true);
+  }
+
+  // Positions survive compression.
+  vector<size_t> ps = {0, 1, 127, 128, 300, 1u << 20, size_t(1) << 40};
+  for (bool compress : {false, true}) {
+    message m;
+    distributed_impl::encode_positions(m, ps, compress);
+    vector<size_t> qs;
+    distributed_impl::decode_positions(m, qs, compress);
+    assert(qs == ps);
+  }
+}
@@ -0,0 +1,367 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_DYNAMIC_HPP
+#define ORIGIN_GRAPH_DYNAMIC_HPP
+
+#include <cassert>
+#include <cstddef>
+
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/search.hpp>
+#include <origin/graph/shortest_paths.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [graph.dynamic]
+  //                         Dynamic Shortest Paths
+  //
+  // A dynamic shortest paths object keeps the distance from each of a set
+  // of sources to every vertex of a graph, and the predecessor of each
+  // vertex in a shortest path tree, up to date as batches of edge updates
+  // are applied to the graph (see [graph.batch]). Rather than searching the
+  // whole graph again, the distances are repaired in time that depends on
+  // the part of the graph whose distances change:
+  //
+  //    dynamic_shortest_paths<G> d(g, {s, t});
+  //    edge_batch<G> b;
+  //    b.remove(u, v);
+  //    b.insert(v, w, 2.5);
+  //    d.apply(b);                     // Applies b to g
+  //    d.distances(1)[w];              // The distance from t to w
+  //
+  // The following are provided:
+  //
+  //    dynamic_shortest_paths<G>        -- The lengths of edges are g(e)
+  //    dynamic_breadth_first_levels<G>  -- Every edge has length 1
+  //
+  // The distance of an unreachable vertex is unreachable_distance<W>(), and
+  // its predecessor, like that of a source, is the invalid vertex handle.
+  // As with the search algorithms, directed graphs are searched along their
+  // out edges, and must also provide their in edges.
+  //
+  // The repair follows Ramalingam and Reps. The vertices whose path in the
+  // shortest path tree uses a removed edge are found by searching the tree
+  // down from the targets of the removed tree edges; their distances are
+  // reset to the shortest distance through a predecessor whose path was not
+  // broken. Each new edge that shortens the path to its target sets the
+  // distance of the target. Starting from the vertices whose distances were
+  // reset or lowered, a Dijkstra search then propagates the changes, and
+  // stops at the vertices whose distances do not change. The cost of an
+  // update is proportional to the degrees of the affected vertices, times
+  // the logarithm of their number; the distances of different sources are
+  // repaired in parallel.
+  //
+  // The graph must only be changed through apply(b) while it is maintained,
+  // except that vertices may be added. Vertices must not be removed.
+
+  namespace dynamic_impl
+  {
+    // The length of an edge is its value.
+    struct edge_length
+    {
+      template<typename T>
+        const T& operator()(const T& x) const { return x; }
+    };
+
+    // Every edge has length 1.
+    struct unit_length
+    {
+      template<typename T>
+        std::size_t operator()(const T&) const { return 1; }
+    };
+
+  } // namespace dynamic_impl
+
+
+  // The distances from a set of sources, kept up to date under batches of
+  // updates. The length of an edge e is len(g(e)).
+  template<typename G, typename L>
+    class dynamic_distances
+    {
+    public:
+      using graph_type = G;
+      using vertex = Vertex<G>;
+      using distance_type = Decay<decltype(
+        std::declval<const L&>()(std::declval<const G&>()(
+          std::declval<Edge<G>>())))>;
+
+      // Compute the distances from s, using up to threads threads.
+      dynamic_distances(G& g, vertex s,
+                        std::size_t threads = search_threads())
+        : dynamic_distances(g, std::vector<vertex> {s}, threads)
+      { }
+
+      // Compute the distances from each of the sources.
+      dynamic_distances(G& g, const std::vector<vertex>& sources,
+                        std::size_t threads = search_threads());
+
+      // Returns the sources.
+      const std::vector<vertex>& sources() const { return sources_; }
+
+      // Returns the distance from the ith source to each vertex, indexed by
+      // vertex handle.
+      const std::vector<distance_type>& distances(std::size_t i = 0) const
+      {
+        return states_[i].dist;
+      }
+
+      // Returns the predecessor of each vertex in a shortest path tree of
+      // the ith source.
+      const std::vector<vertex>& predecessors(std::size_t i = 0) const
+      {
+        return states_[i].pred;
+      }
+
+      // Returns the number of times that a distance was reset or lowered
+      // by the last update, summed over the sources.
+      std::size_t affected() const { return affected_; }
+
+      // Apply the batch b to the graph, and repair the distances.
+      void apply(const edge_batch<G>& b);
+
+    private:
+      using W = distance_type;
+      using arc = std::tuple<vertex, vertex, W>;
+
+      // The search state of a source. A vertex is marked while it is known
+      // to be affected by the removals of an update.
+      struct state
+      {
+        std::vector<W>      dist;
+        std::vector<vertex> pred;
+        std::vector<char>   mark;
+      };
+
+      // The entries of the queue are ordered by distance, least first.
+      struct later
+      {
+        bool operator()(const std::pair<W, vertex>& a,
+                        const std::pair<W, vertex>& b) const
+        {
+          return b.first < a.first;
+        }
+      };
+
+      using queue = std::priority_queue<std::pair<W, vertex>,
+                                        std::vector<std::pair<W, vertex>>,
+                                        later>;
+
+      void grow(state& s);
+      std::size_t repair(state& s, vertex src,
+                         const std::vector<std::pair<vertex, vertex>>& dead,
+                         const std::vector<arc>& added);
+      std::size_t propagate(state& s, queue& q);
+
+      W length(Edge<G> e) const { return len_(g_(e)); }
+
+    private:
+      G&                  g_;
+      L                   len_;
+      std::vector<vertex> sources_;
+      std::vector<state>  states_;
+      std::size_t         threads_;
+      std::size_t         affected_;
+    };
+
+  // The distances are computed by repairing the empty distances of each
+  // source, in which only the source is affected.
+  template<typename G, typename L>
+    dynamic_distances<G, L>::dynamic_distances(
+        G& g, const std::vector<vertex>& sources, std::size_t threads)
+      : g_(g), sources_(sources), states_(sources.size()),
+        threads_(threads), affected_(0)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      std::vector<std::size_t> counts(sources_.size());
+      search_impl::parallel_for(sources_.size(), threads_,
+                                [&](std::size_t i) {
+        state& s = states_[i];
+        grow(s);
+        s.dist[sources_[i]] = W(0);
+        queue q;
+        q.emplace(W(0), sources_[i]);
+        counts[i] = propagate(s, q);
+      });
+      for (std::size_t n : counts)
+        affected_ += n;
+    }
+
+  // The removed edges are found before the batch is applied, while their
+  // handles are valid. The edges of an undirected graph are recorded in
+  // both directions.
+  template<typename G, typename L>
+    void
+    dynamic_distances<G, L>::apply(const edge_batch<G>& b)
+    {
+      ORIGIN_TIME_SCOPE("graph.dynamic.apply");
+      std::vector<std::pair<vertex, vertex>> dead;
+      for (Edge<G> e : graph_impl::batch_removals(g_, b)) {
+        dead.emplace_back(g_.source(e), g_.target(e));
+        if (Undirected_graph<G>())
+          dead.emplace_back(g_.target(e), g_.source(e));
+      }
+      std::vector<arc> added;
+      for (const auto& x : b.insertions()) {
+        W w = len_(std::get<2>(x));
+        assert(!(w < W(0)));
+        added.emplace_back(std::get<0>(x), std::get<1>(x), w);
+        if (Undirected_graph<G>())
+          added.emplace_back(std::get<1>(x), std::get<0>(x), w);
+      }
+      g_.apply(b);
+
+      std::vector<std::size_t> counts(sources_.size());
+      search_impl::parallel_for(sources_.size(), threads_,
+                                [&](std::size_t i) {
+        counts[i] = repair(states_[i], sources_[i], dead, added);
+      });
+      affected_ = 0;
+      for (std::size_t n : counts)
+        affected_ += n;
+      ORIGIN_COUNT_N("graph.dynamic.affected", affected_);
+    }
+
+  // Extend the state of a source to the vertices added to the graph.
+  template<typename G, typename L>
+    void
+    dynamic_distances<G, L>::grow(state& s)
+    {
+      std::size_t n = search_impl::vertex_bound(g_);
+      s.dist.resize(n, unreachable_distance<W>());
+      s.pred.resize(n, vertex());
+      s.mark.resize(n, 0);
+    }
+
+  // Repair the distances from src after the removal of the edges dead and
+  // the addition of the edges added. Returns the number of vertices whose
+  // distances were reset or lowered, with each lowering counted.
+  template<typename G, typename L>
+    std::size_t
+    dynamic_distances<G, L>::repair(
+        state& s, vertex src,
+        const std::vector<std::pair<vertex, vertex>>& dead,
+        const std::vector<arc>& added)
+    {
+      const W inf = unreachable_distance<W>();
+      grow(s);
+
+      // Find the vertices whose tree paths used a removed edge: the
+      // targets of the removed tree edges, and their descendants.
+      std::vector<vertex> lost;
+      for (const auto& x : dead) {
+        vertex v = x.second;
+        if (s.pred[v] == x.first && v != src && !s.mark[v]) {
+          s.mark[v] = 1;
+          lost.push_back(v);
+        }
+      }
+      for (std::size_t i = 0; i != lost.size(); ++i) {
+        vertex u = lost[i];
+        for (Edge<G> e : search_impl::successor_edges(g_, u)) {
+          vertex v = opposite(g_, e, u);
+          if (s.pred[v] == u && !s.mark[v]) {
+            s.mark[v] = 1;
+            lost.push_back(v);
+          }
+        }
+      }
+      for (vertex v : lost) {
+        s.dist[v] = inf;
+        s.pred[v] = vertex();
+      }
+
+      // Reset each lost vertex to its shortest distance through a vertex
+      // that was not lost.
+      queue q;
+      for (vertex v : lost) {
+        for (Edge<G> e : search_impl::predecessor_edges(g_, v)) {
+          vertex u = opposite(g_, e, v);
+          if (s.mark[u] || s.dist[u] == inf)
+            continue;
+          W d = s.dist[u] + length(e);
+          if (d < s.dist[v]) {
+            s.dist[v] = d;
+            s.pred[v] = u;
+          }
+        }
+        if (s.dist[v] != inf)
+          q.emplace(s.dist[v], v);
+      }
+      for (vertex v : lost)
+        s.mark[v] = 0;
+
+      // Lower the distance of the target of each new edge that shortens
+      // its path.
+      std::size_t lowered = 0;
+      for (const arc& x : added) {
+        vertex u = std::get<0>(x);
+        vertex v = std::get<1>(x);
+        if (s.dist[u] == inf)
+          continue;
+        W d = s.dist[u] + std::get<2>(x);
+        if (d < s.dist[v]) {
+          s.dist[v] = d;
+          s.pred[v] = u;
+          q.emplace(d, v);
+          ++lowered;
+        }
+      }
+      return lost.size() + lowered + propagate(s, q);
+    }
+
+  // Propagate the distances of the vertices in q, returning the number of
+  // distances lowered. Every vertex whose distance may be too long to one of
+  // its successors is in q, so that a vertex is never settled twice; an
+  // entry whose distance was lowered after it was queued is skipped.
+  template<typename G, typename L>
+    std::size_t
+    dynamic_distances<G, L>::propagate(state& s, queue& q)
+    {
+      std::size_t lowered = 0;
+      while (!q.empty()) {
+        W d = q.top().first;
+        vertex u = q.top().second;
+        q.pop();
+        if (s.dist[u] < d)
+          continue;
+        for (Edge<G> e : search_impl::successor_edges(g_, u)) {
+          W w = length(e);
+          assert(!(w < W(0)));
+          vertex v = opposite(g_, e, u);
+          if (d + w < s.dist[v]) {
+            s.dist[v] = d + w;
+            s.pred[v] = u;
+            q.emplace(d + w, v);
+            ++lowered;
+          }
+        }
+      }
+      return lowered;
+    }
+
+
+  // The distances from a set of sources, where the length of an edge is
+  // its value.
+  template<typename G>
+    using dynamic_shortest_paths =
+      dynamic_distances<G, dynamic_impl::edge_length>;
+
+  // The number of edges on a shortest path from each of a set of sources.
+  template<typename G>
+    using dynamic_breadth_first_levels =
+      dynamic_distances<G, dynamic_impl::unit_length>;
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,165 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/dynamic.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns a random edge length. The lengths are multiples of 1/8 in [0, 8),
+// so that sums of lengths are exact.
+double
+random_length(minstd_rand& prng)
+{
+  return uniform_int_distribution<int>(0, 63)(prng) / 8.0;
+}
+
+// Returns true if pred is a shortest path tree for dist: the predecessor
+// of each reachable vertex other than s is joined to it by an edge whose
+// length is the difference of their distances.
+template<typename G, typename W, typename L>
+  bool
+  is_tree(const G& g, Vertex<G> s, const vector<W>& dist,
+          const vector<Vertex<G>>& pred, L len)
+  {
+    for (Vertex<G> v : g.vertices()) {
+      if (v == s || dist[v] == unreachable_distance<W>()) {
+        if (pred[v])
+          return false;
+        continue;
+      }
+      bool found = false;
+      for (Edge<G> e : search_impl::predecessor_edges(g, v))
+        if (opposite(g, e, v) == pred[v]
+            && dist[pred[v]] + len(g(e)) == dist[v])
+          found = true;
+      if (!found)
+        return false;
+    }
+    return true;
+  }
+
+// Random batches of removals and insertions keep the distances equal to
+// those computed from scratch.
+template<typename G>
+  void
+  check_random()
+  {
+    const size_t n = 300;
+    G g = build_erdos_renyi_graph<G>(n, 900, 7, random_length);
+    vector<Vertex<G>> srcs {Vertex<G>(0), Vertex<G>(17), Vertex<G>(150)};
+    dynamic_shortest_paths<G> d(g, srcs, 2);
+
+    minstd_rand prng(7);
+    uniform_int_distribution<size_t> vert(0, n - 1);
+    for (int round = 0; round != 20; ++round) {
+      edge_batch<G> b;
+      vector<Edge<G>> es;
+      for (Edge<G> e : g.edges())
+        es.push_back(e);
+      uniform_int_distribution<size_t> edge(0, es.size() - 1);
+      for (int i = 0; i != 20; ++i)
+        b.remove(es[edge(prng)]);
+      for (int i = 0; i != 5; ++i)
+        b.remove(vert(prng), vert(prng));
+      for (int i = 0; i != 25; ++i)
+        b.insert(vert(prng), vert(prng), random_length(prng));
+
+      // Vertices added between updates are reached by new edges.
+      if (round % 5 == 0)
+        b.insert(vert(prng), g.add_vertex('b'), 1.0);
+
+      d.apply(b);
+
+      for (size_t i = 0; i != srcs.size(); ++i) {
+        assert(d.distances(i) == dijkstra_distances(g, srcs[i]));
+        assert(is_tree(g, srcs[i], d.distances(i), d.predecessors(i),
+                       dynamic_impl::edge_length()));
+      }
+    }
+  }
+
+// The breadth-first levels are kept under updates.
+template<typename G>
+  void
+  check_levels()
+  {
+    const size_t n = 200;
+    G g = build_erdos_renyi_graph<G>(n, 500, 11, random_length);
+    dynamic_breadth_first_levels<G> l(g, Vertex<G>(3));
+
+    minstd_rand prng(11);
+    uniform_int_distribution<size_t> vert(0, n - 1);
+    for (int round = 0; round != 20; ++round) {
+      edge_batch<G> b;
+      size_t k = 0;
+      for (Edge<G> e : g.edges())
+        if (k++ % 37 == size_t(round))
+          b.remove(e);
+      for (int i = 0; i != 10; ++i)
+        b.insert(vert(prng), vert(prng), 1.0);
+      l.apply(b);
+      assert(l.distances() == breadth_first_levels(g, Vertex<G>(3), 1));
+      assert(is_tree(g, Vertex<G>(3), l.distances(), l.predecessors(),
+                     dynamic_impl::unit_length()));
+    }
+  }
+
+// An update far from the source touches only the vertices it changes.
+void
+check_local()
+{
+  using G = directed_adjacency_list<char, double>;
+  const size_t n = 10000;
+  G g;
+  for (size_t i = 0; i != n; ++i)
+    g.add_vertex('a');
+  for (size_t i = 0; i + 1 != n; ++i)
+    g.add_edge(i, i + 1, 1.0);
+  dynamic_shortest_paths<G> d(g, Vertex<G>(0));
+  assert(d.distances()[n - 1] == n - 1);
+
+  // A shortcut near the end of the path lowers the distances after it.
+  edge_batch<G> b;
+  b.insert(n - 20, n - 10, 1.0);
+  d.apply(b);
+  assert(d.affected() == 10);
+  assert(d.distances()[n - 1] == n - 10);
+
+  // Removing the shortcut restores them.
+  b.clear();
+  b.remove(n - 20, n - 10);
+  d.apply(b);
+  assert(d.affected() < 25);
+  assert(d.distances()[n - 1] == n - 1);
+  assert(d.predecessors()[n - 10] == Vertex<G>(n - 11));
+
+  // Cutting the path makes the rest unreachable.
+  b.clear();
+  b.remove(n - 3, n - 2);
+  d.apply(b);
+  assert(d.affected() == 2);
+  assert(d.distances()[n - 1] == unreachable_distance<double>());
+  assert(!d.predecessors()[n - 1]);
+}
+
+int main()
+{
+  check_random<directed_adjacency_list<char, double>>();
+  check_random<undirected_adjacency_list<char, double>>();
+  check_levels<directed_adjacency_list<char, double>>();
+  check_levels<undirected_adjacency_list<char, double>>();
+  check_local();
+}
@@ -8,399 +8,216 @@
 #ifndef ORIGIN_GRAPH_EDGE_HPP
 #define ORIGIN_GRAPH_EDGE_HPP
 
+#include <cstddef>
+
+#include <algorithm>
 #include <iterator>
-#include <functional>
+#include <utility>
+
+#include <origin/sequence/concepts.hpp>
+#include <origin/sequence/range.hpp>
 
-#include <origin/graph/handle.hpp>
-#include <origin/graph/vertex.hpp>
-#include <origin/range.hpp>
-#include <origin/graph/traits.hpp>
+#include <origin/graph/graph.hpp>
+#include <origin/graph/search.hpp>
 
 namespace origin
 {
-  // Edge handle
-  // The edge handle is an opaque reference to a edge object in a graph. 
+  // ------------------------------------------------------------------------ //
+  //                                                                [graph.edge]
+  //                            Edge Enumeration
   //
-  // Note that we explicitly subclass the handle<T> so that we don't confuse
-  // edge and vertex handles. They are incompatible types, even if they
-  // represent the same set of values.
-  template<typename T>
-    class edge_handle
-    {
-    public:
-      using value_type = Value_type<handle<T>>;
-      
-      edge_handle() : impl{} { }
-      edge_handle(value_type n) : impl{n} { }
-
-      // Equality_comparable
-      bool operator==(edge_handle v) const { return impl == v.impl; }
-      bool operator!=(edge_handle v) const { return impl != v.impl; }
-      
-      // Totally_ordered
-      bool operator<(edge_handle v) const  { return impl < v.impl; }
-      bool operator>(edge_handle v) const  { return impl > v.impl; }
-      bool operator<=(edge_handle v) const { return impl <= v.impl; }
-      bool operator>=(edge_handle v) const { return impl >= v.impl; }
-
-      // Boolean
-      explicit operator bool() const { return (bool)impl; }
-      
-      // Ordinal
-      // Only if Ordinal<T>
-      std::size_t ord() const { return impl.ord(); }
-      
-      // Hashable
-      std::size_t hash() const { return impl.hash(); }
-      
-      // Returns the underlying value.
-      value_type  value() const { return impl.value; }
-
-      // The handle implementation.
-      handle<T> impl;
-    };
-
-  
-    
-  // Edge iterator
-  // The edge iterator provides an iterator over successive vertices.
-  template<typename T>
-    using edge_iterator = handle_iterator<edge_handle<T>>;
-    
-    
-
-  // Undirected edge handle
-  // The undirected edge handle is a triple containing an edge handle, and two
-  // vertex handles: the source and target vertices, respectively. Note that 
-  // equality and inequality comparisons are predicated on the underlying edge 
-  // and do not include the end points in comparison.
-  template<typename T>
-    class undirected_edge_handle
-    {
-    public:
-      // Default constructor
-      undirected_edge_handle() : edge{}, source{}, target{} { }
-
-      // Initialize the graph over a triple of values describing the current
-      // edge handle, the source vertex, and the target vertex.
-      undirected_edge_handle(edge_handle<T> e, vertex_handle<T> s, vertex_handle<T> t)
-        : edge{e}, source{s}, target{t}
-      { }
-
-      // Equality_comparable
-      bool operator==(const undirected_edge_handle& x) const { return edge == x.edge; }
-      bool operator!=(const undirected_edge_handle& x) const { return edge != x.edge; }
-
-      // Totally_ordered
-      bool operator<(const undirected_edge_handle& x) const { return edge < x.edge; }
-      bool operator>(const undirected_edge_handle& x) const { return edge > x.edge; }
-      bool operator<=(const undirected_edge_handle& x) const { return edge <= x.edge; }
-      bool operator>=(const undirected_edge_handle& x) const { return edge >= x.edge; }
-
-      // Boolean
-      explicit operator bool() const { return (bool)edge; }
-      
-      // Ordinal
-      // Only if Ordinal<T>.
-      std::size_t ord() const { return edge.ord(); }
-      
-      // Hashable
-      std::size_t hash() const { return hash_value(edge); }
-
-      edge_handle<T> edge;
-      vertex_handle<T> source;
-      vertex_handle<T> target;
-    };
-
-    
-    
-  // Undirected edge iterator
-  // The undirected edge iterator is used to iterate over the edges in the
-  // edge set of an undirected graph.
+  // Each edge {u, v} of an undirected graph is in the incidence lists of
+  // both u and v, so enumerating the edges of a graph by traversing the
+  // incidence list of each vertex finds every edge twice. The unique edges
+  // of v are the edges in its incidence list of which v is the source, and
+  // each edge of the graph is a unique edge of exactly one vertex:
   //
-  // FIXME: This is totally broken. It needs to chain the underlying out
-  // and in edge iterators in a more natural fashion. We can generally
-  template<typename G>
-    class undirected_edge_iterator
+  //    for (auto v : g.vertices())
+  //      for (auto e : unique_edges(g, v))
+  //        ...                             // Each edge exactly once
+  //
+  // The unique edges of v are enumerated in the order of its incidence list.
+  // A loop is in the incidence list of its vertex twice, and only its last
+  // occurrence is enumerated; finding it takes time linear in the degree of
+  // v, so lists with many loops are slow to traverse. The unique edges of a
+  // vertex in a directed graph are its out edges.
+  //
+  // The edges() range of a graph enumerates each edge once, in the order in
+  // which the graph stores them. for_each_edge(g, f) calls f(e) for each
+  // edge; when the edge range is random access, as it is for adjacency
+  // vectors and compressed graphs, the range is split into blocks of
+  // parallel_edges edges, and f is called in parallel with up to threads
+  // threads (see [graph.search]). Otherwise, the calls are serial and in
+  // the order of the range. f must be safe to call concurrently for
+  // distinct edges.
+
+  namespace edge_impl
+  {
+    // The number of edges visited by each parallel task, and the least
+    // number of edges for which a sweep is parallel.
+    constexpr std::size_t grain = 1 << 14;
+    constexpr std::size_t parallel_edges = 1 << 16;
+
+    template<typename G>
+      using Incident_edge_range =
+        decltype(std::declval<const G&>().edges(std::declval<Vertex<G>>()));
+
+    template<typename G>
+      using Edge_range = decltype(std::declval<const G&>().edges());
+
+  } // namespace edge_impl
+
+
+  // The unique incidence iterator enumerates the edges in the incidence list
+  // of a vertex v of an undirected graph of which v is the source, and the
+  // last occurrence of each loop. The incidence list is traversed by the
+  // iterator I.
+  template<typename G, typename I>
+    class unique_incidence_iterator
     {
-    /*
     public:
-      using value_type = Edge_type<G>;
-      using reference = const Edge_type<G>&;
-      using pointer = const Edge_type<G>*;
+      using value_type = Edge<G>;
+      using reference = Edge<G>;
+      using pointer = const Edge<G>*;
       using difference_type = std::ptrdiff_t;
-      using iterator_category = std::random_access_iterator_tag;
+      using iterator_category = std::forward_iterator_tag;
 
-      undirected_edge_iterator()
-        : graph{nullptr}, handle{}
-      { }
-      
-      undirected_edge_iterator(G& g, const Edge_type<G>& e)
-        : graph{&g}, handle{e}
+      unique_incidence_iterator()
+        : g(nullptr), v(), cur(), last()
       { }
 
-      // Readable
-      reference operator*() const { return edge; }
-      
-      // Equality_comparable
-      bool operator==(const undirected_edge_iterator& x) const { return handle == x.handle; }
-      bool operator!=(const undirected_edge_iterator& x) const { return handle != x.handle; }
+      // Initialize the iterator to the first unique edge of v in [f, l).
+      unique_incidence_iterator(const G& g, Vertex<G> v, I f, I l)
+        : g(&g), v(v), cur(f), last(l)
+      {
+        skip();
+      }
 
-      // Totally_ordered
-      bool operator<(const undirected_edge_iterator& x) const { return handle == x.handle; }
-      bool operator>(const undirected_edge_iterator& x) const { return handle != x.handle; }
-      bool operator<=(const undirected_edge_iterator& x) const { return handle == x.handle; }
-      bool operator>=(const undirected_edge_iterator& x) const { return handle != x.handle; }
+      // Readable
+      reference operator*() const { return *cur; }
 
       // Increment
-      undirected_edge_iterator& operator++() { advance_edge(1); return *this; }
-     
-      undirected_edge_iterator operator++(int) 
+      unique_incidence_iterator& operator++()
       {
-        undirected_edge_iterator tmp{*this}; 
-        this->operator++();
-        return tmp;
+        ++cur;
+        skip();
+        return *this;
       }
 
-      // Decrement
-      undirected_edge_iterator& operator--() { advance_edge(-1); return *this; }
-
-      undirected_edge_iterator operator--(int) 
+      unique_incidence_iterator operator++(int)
       {
-        undirected_edge_iterator tmp{*this}; 
-        this->operator--();
+        unique_incidence_iterator tmp = *this;
+        operator++();
         return tmp;
       }
-      
-      // Advance
-      undirected_edge_iterator& operator+=(difference_type n) { advance_edge(n); return *this; }
-      undirected_edge_iterator& operator-=(difference_type n) { advance_edge(-n); return *this; }
-
-      friend undirected_edge_iterator operator+(undirected_edge_iterator i, difference_type n) 
-      { 
-        return i += n; 
-      }
-      
-      friend undirected_edge_iterator operator+(difference_type n, undirected_edge_iterator i) 
-      { 
-        return i += n; 
-      }
-
 
-      friend undirected_edge_iterator operator-(undirected_edge_iterator i, difference_type n)
+      // Equality_comparable
+      bool operator==(const unique_incidence_iterator& x) const
       {
-        return i -= n;
+        return cur == x.cur;
       }
 
-      // Difference
-      friend difference_type 
-      operator-(const undirected_edge_iterator& a, const undirected_edge_iterator& b) 
-      { 
-        return a.value() - b.value();
+      bool operator!=(const unique_incidence_iterator& x) const
+      {
+        return cur != x.cur;
       }
 
     private:
-      std::size_t value() const
+      // Returns true if the edge at cur is enumerated.
+      bool unique() const
       {
-        return edge.edge.value;
+        Edge<G> e = *cur;
+        if (g->source(e) != v)
+          return false;
+        if (g->target(e) != v)
+          return true;
+        return std::find(std::next(cur), last, e) == last;
       }
 
-      void advance_edge(difference_type n)
+      // Move to the next unique edge.
+      void skip()
       {
-        edge = graph->get_edge(value() + 1);
+        while (cur != last && !unique())
+          ++cur;
       }
 
     private:
-      G* graph;
-      Edge_type<G> handle;
-      */
+      const G* g;
+      Vertex<G> v;
+      I cur;
+      I last;
     };
 
-    
-  
-  // The undirected incident edge iterator abstracts the notion of a sequence
-  // of incident edges by iterating over the chained in- and out-edge ranges
-  // of an undirected graph's underlying directed implementation.
-  //
-  // Note that we don't cache the referenced edge, so we dereference a copy.
-  // This means that you can't use -> with these iterators.
-  //
-  // FIXME: This is also totally broken.
-  //
-  // NOTE: Do not static assert that G is an undirected graph. Doing so results
-  // in mutually recursive concept checks. G is an undirected graph if it has
-  // this as an iterator. This a valid iterator if F is an undirected graph.
   template<typename G>
-    class undirected_incident_edge_iterator
+    using unique_incidence_range =
+      bounded_range<unique_incidence_iterator<
+        G, Iterator_of<edge_impl::Incident_edge_range<G>>>>;
+
+  // Returns the unique edges of v in the undirected graph g.
+  template<typename G>
+    inline auto
+    unique_edges(const G& g, Vertex<G> v)
+      -> bounded_range<unique_incidence_iterator<
+           G, Iterator_of<decltype(g.edges(v))>>>
     {
-    /*
-    public:
-      using value_type = Edge_type<G>;
-      using reference = const Edge_type<G>&;
-      using pointer = const Edge_type<G>*;
-      using difference_type = std::ptrdiff_t;
-      using iterator_category = std::random_access_iterator_tag;
-      
-      undirected_incident_edge_iterator()
-        : graph(nullptr), source(), index()
-      { }
-      
-      // Initialize the iterator so that it refers to the nth incident edge
-      // of v where n < degree(g, v).
-      undirected_incident_edge_iterator(G& g, Vertex_type<G> v, Size_type<G> n)
-        : graph(&g), source(v), index(n)
-      { }
-      
-      // Readable
-      reference operator*() const { return get_edge(); }
-      pointer operator->() const { return get_edge(); }
-      
-      // Equality_comparable
-      bool operator==(const undirected_incident_edge_iterator& x) const { return index == x.index; }
-      bool operator!=(const undirected_incident_edge_iterator& x) const { return index != x.index; }
-
-      // Totally_ordered
-      bool operator<(const undirected_incident_edge_iterator& x) const { return index == x.index; }
-      bool operator>(const undirected_incident_edge_iterator& x) const { return index != x.index; }
-      bool operator<=(const undirected_incident_edge_iterator& x) const { return index == x.index; }
-      bool operator>=(const undirected_incident_edge_iterator& x) const { return index != x.index; }
-
-      // Random_access_iterator: advance
-      undirected_incident_edge_iterator& operator++() { ++index; return *this; }
-      undirected_incident_edge_iterator& operator--() { --index; return *this; }
-      
-      undirected_incident_edge_iterator operator++(int) 
-      {
-        undirected_incident_edge_iterator tmp{*this}; 
-        this->operator++();
-        return tmp;
-      }
+      auto r = g.edges(v);
+      return {{g, v, std::begin(r), std::end(r)},
+              {g, v, std::end(r), std::end(r)}};
+    }
 
-      friend undirected_incident_edge_iterator 
-      operator+(undirected_incident_edge_iterator i, difference_type n) 
-      { 
-        return i += n; 
-      }
-      
-      friend undirected_incident_edge_iterator 
-      operator+(difference_type n, undirected_incident_edge_iterator i) 
-      { 
-        return i += n; 
-      }
+  // Returns the unique edges of v in the directed graph g: its out edges.
+  template<typename G>
+    inline auto
+    unique_edges(const G& g, Vertex<G> v) -> decltype(g.out_edges(v))
+    {
+      return g.out_edges(v);
+    }
 
-      undirected_incident_edge_iterator operator--(int)
-      {
-        undirected_incident_edge_iterator tmp{*this}; 
-        this->operator--();
-        return tmp;
-      }
 
-      friend undirected_incident_edge_iterator 
-      operator-(undirected_incident_edge_iterator i, difference_type n)
+  namespace edge_impl
+  {
+    // Call f(e) for each edge e in [first, last), using up to threads
+    // threads.
+    template<typename I, typename F>
+      void
+      for_each_edge(I first, I last, F f, std::size_t threads,
+                    std::random_access_iterator_tag)
       {
-        return i -= n;
-      }
-
-      // Random_access_iterator: distance
-      friend difference_type 
-      operator-(const undirected_incident_edge_iterator& a, 
-                const undirected_incident_edge_iterator& b) 
-      { 
-        return a.value() - b.value();
-      }
-
-    private:
-      Edge_type<G> get_edge() const
+        std::size_t n = last - first;
+        if (n < parallel_edges || threads <= 1) {
+          std::for_each(first, last, f);
+          return;
+        }
+        search_impl::parallel_for((n + grain - 1) / grain, threads,
+                                  [&](std::size_t k) {
+          I i = first + k * grain;
+          std::for_each(i, i + std::min(grain, n - k * grain), f);
+        });
+      }
+
+    template<typename I, typename F>
+      void
+      for_each_edge(I first, I last, F f, std::size_t,
+                    std::forward_iterator_tag)
       {
-        return graph->get_incident_edge(source, index);
+        std::for_each(first, last, f);
       }
 
-    private:
-      G* graph;
-      Vertex_type<G> source;
-      Size_type<G> index;
-      */
-    };
+  } // namespace edge_impl
 
-    
 
-  // FIXME: What are these functions for? Where are they being used? 
-#if 0
-  // The has_target Predicate is used to evaluate whether or not an edge
-  // has a given vertex as its target.
-  template<typename G>
-    struct has_target_pred
+  // Call f(e) for each edge e of g, in parallel with up to threads threads
+  // if the edges of g are a random access range.
+  template<typename G, typename F>
+    inline void
+    for_each_edge(const G& g, F f, std::size_t threads = search_threads())
     {
-      has_target_pred(G& g, Vertex_type<G> v)
-        : graph(g), vertex{v}
-      { }
-      
-      bool operator()(Edge_type<G> e) const { return target(graph, e) == vertex; }
-      
-      G& graph;
-      Vertex_type<G> vertex;
-    };
-    
-  // Return a predicate that can be used to determine if the given graph has
-  // an edge with the specified vertex.
-  template<typename G>
-    inline has_target_pred<G> if_has_target(G& g, Vertex<G> v)
-    {
-      return {g, v};
+      using I = Iterator_of<edge_impl::Edge_range<G>>;
+      auto r = g.edges();
+      edge_impl::for_each_edge(std::begin(r), std::end(r), f, threads,
+                               Iterator_category<I>());
     }
 
-
-    
-  // The has_source Predicate is used to evaluate whether or not an edge
-  // has a given vertex as its source.
-  template<typename G>
-    struct has_source_pred
-    {
-      has_source_pred(G& g, Vertex<G> v)
-        : graph(g), vertex(v)
-      { }
-      
-      bool operator()(Edge<G> e) const { return source(graph, e) == vertex; }
-      
-      G& graph;
-      Vertex<G> vertex;
-    };
-
-  // Return a predicate that can be used to determine if the given graph has
-  // an edge with the specified vertex.
-  template<typename G>
-    inline has_source_pred<G> if_has_source(G& g, Vertex<G> v)
-    {
-      return {g, v};
-    }
-#endif
-    
 } // namespace origin
-    
-// FIXME: When are we going to have Origin::Hashable?
-// Support std::hash interoperability.
-namespace std
-{
-  // Make edge handles hashable by the standard library.
-  template<typename T>
-    struct hash<origin::edge_handle<T>>
-    {
-      std::size_t operator()(const origin::edge_handle<T>& e) const
-      { 
-        return e.hash();
-      }
-    };
-  
-  // Make undirected edge handles hashable by the standard library.
-  template<typename T>
-    struct hash<origin::undirected_edge_handle<T>>
-    {
-      std::size_t operator()(const origin::undirected_edge_handle<T>& e) const
-      {
-        return e.hash();
-      }
-    };
-    
-} // namespace std
-    
+
 #endif
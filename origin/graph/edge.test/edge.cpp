@@ -0,0 +1,153 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include <origin/graph/edge.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the number of times each edge of g is a unique edge of one of its
+// vertices, and check that the unique edges of each vertex follow the order
+// of its incidence list.
+template<typename G>
+  vector<int>
+  count_unique(const G& g)
+  {
+    size_t n = 0;
+    for (auto e : g.edges())
+      n = max(n, size_t(e) + 1);
+    vector<int> counts(n);
+    for (auto v : g.vertices()) {
+      auto r = g.edges(v);
+      auto i = begin(r);
+      for (auto e : unique_edges(g, v)) {
+        assert(is_endpoint(g, e, v));
+        while (*i != e)
+          ++i;
+        ++counts[e];
+      }
+    }
+    return counts;
+  }
+
+// Build a graph with parallel edges and interleaved loops, so that the
+// loops of a vertex are not adjacent in its incidence list.
+template<typename G>
+  void
+  check_unique()
+  {
+    G g;
+    for (int i = 0; i != 5; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 0);
+    g.add_edge(2, 2);
+    g.add_edge(2, 3);
+    g.add_edge(3, 3);
+    g.add_edge(2, 2);
+    g.add_edge(3, 2);
+    g.add_edge(4, 0);
+
+    vector<int> counts = count_unique(g);
+    for (auto e : g.edges())
+      assert(counts[e] == 1);
+    size_t n = 0;
+    for (auto v : g.vertices())
+      for (auto e : unique_edges(g, v))
+        n += bool(e);
+    assert(n == g.size());
+  }
+
+// Removing edges leaves holes in the handles of an adjacency list.
+void
+check_removed()
+{
+  undirected_adjacency_list<> g;
+  for (int i = 0; i != 4; ++i)
+    g.add_vertex();
+  auto a = g.add_edge(0, 1);
+  g.add_edge(1, 2);
+  g.add_edge(2, 2);
+  auto b = g.add_edge(2, 3);
+  g.add_edge(3, 0);
+  g.remove_edge(a);
+  g.remove_edge(b);
+
+  vector<int> counts = count_unique(g);
+  assert(counts[a] == 0 && counts[b] == 0);
+  for (auto e : g.edges())
+    assert(counts[e] == 1);
+}
+
+// The unique edges of a vertex in a directed graph are its out edges.
+void
+check_directed()
+{
+  directed_adjacency_list<> g;
+  for (int i = 0; i != 3; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1);
+  g.add_edge(1, 1);
+  g.add_edge(1, 2);
+  g.add_edge(2, 0);
+  size_t n = 0;
+  for (auto v : g.vertices())
+    for (auto e : unique_edges(g, v)) {
+      assert(g.source(e) == v);
+      ++n;
+    }
+  assert(n == g.size());
+}
+
+// Visit each edge of g once with for_each_edge, in parallel if its edges
+// are a random access range.
+template<typename G>
+  void
+  check_sweep(size_t n, size_t m)
+  {
+    G g;
+    for (size_t i = 0; i != n; ++i)
+      g.add_vertex();
+    minstd_rand prng(7);
+    for (size_t i = 0; i != m; ++i)
+      g.add_edge(prng() % n, prng() % n);
+
+    vector<char> seen(m);
+    atomic<size_t> count(0);
+    for_each_edge(g, [&](Edge<G> e) {
+      assert(!seen[e]);
+      seen[e] = 1;
+      ++count;
+    }, 4);
+    assert(count == g.size());
+    for (char c : seen)
+      assert(c);
+  }
+
+int main()
+{
+  check_unique<undirected_adjacency_list<>>();
+  check_unique<undirected_adjacency_vector<>>();
+  check_removed();
+  check_directed();
+
+  check_sweep<undirected_adjacency_vector<>>(1 << 12, 1 << 18);
+  check_sweep<directed_adjacency_vector<>>(1 << 12, 1 << 18);
+  check_sweep<undirected_adjacency_list<>>(1 << 10, 1 << 12);
+
+  compressed_graph<> c(directed_adjacency_list<>{});
+  for_each_edge(c, [](edge_handle) { assert(false); });
+}
@@ -0,0 +1,172 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_EDGE_FILTER_HPP
+#define ORIGIN_GRAPH_EDGE_FILTER_HPP
+
+#include <cstddef>
+#include <utility>
+
+#include <origin/type/hash.hpp>
+#include <origin/memory/usage.hpp>
+#include <origin/data/filter/bloom_filter.hpp>
+#include <origin/data/filter/cuckoo_filter.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                              [graph.filter]
+  //                              Edge Filters
+  //
+  // An edge filter is a Bloom or cuckoo filter (see data.bloom_filter and
+  // data.cuckoo_filter) of the pairs of vertices connected by the edges of
+  // a graph. The edge relation g(u, v) of the adjacency lists and vectors
+  // searches the incident edges of u or v; when the graph has an edge
+  // filter, the search is skipped for the pairs that the filter rules out,
+  // which are all but a small fraction of the pairs that are not connected.
+  // This makes add_unique_edge(u, v), which adds an edge only if there is
+  // none, cheap for the edges that are new.
+  //
+  // The filter is disabled by default, in which case its operations do
+  // nothing. When it is enabled, it is sized for twice the edges of the
+  // graph, and it is rebuilt from the edges of the graph when they outgrow
+  // it, so that its cost is constant amortized time per edge.
+  //
+  // The adjacency lists, in which edges can be removed, use a cuckoo filter;
+  // the adjacency vectors, in which they cannot, use a blocked Bloom
+  // filter, which is smaller and faster. A cuckoo filter cannot hold a pair
+  // more than 8 times; if a multigraph connects a pair by more parallel
+  // edges, the filter is saturated, and admits every pair, until it is next
+  // rebuilt.
+
+  namespace graph_impl
+  {
+    // Add k to the filter f, returning false if it could not be added.
+    template<typename T, typename H>
+      inline bool
+      filter_insert(blocked_bloom_filter<T, H>& f, const T& k)
+      {
+        f.insert(k);
+        return true;
+      }
+
+    template<typename T, typename H>
+      inline bool
+      filter_insert(cuckoo_filter<T, H>& f, const T& k)
+      {
+        return f.insert(k);
+      }
+
+    template<typename F, bool Directed>
+      class edge_filter
+      {
+      public:
+        edge_filter()
+          : enabled_(false), saturated_(false), count_(0), limit_(0)
+        { }
+
+        bool enabled() const { return enabled_; }
+
+        // Enable the filter, adding the endpoints of each edge in g.
+        template<typename G>
+          void enable(const G& g);
+
+        // Disable the filter, releasing its memory.
+        void disable()
+        {
+          F().swap(filter_);
+          enabled_ = false;
+          saturated_ = false;
+          count_ = limit_ = 0;
+        }
+
+        // Returns true if the edges have outgrown the filter, which must be
+        // rebuilt by enable.
+        bool stale() const { return enabled_ && count_ > limit_; }
+
+        // Remove all edges from the filter.
+        void clear()
+        {
+          filter_.clear();
+          saturated_ = false;
+          count_ = 0;
+        }
+
+        memory_footprint memory_usage() const
+        {
+          return filter_.memory_usage();
+        }
+
+        void insert(std::size_t u, std::size_t v)
+        {
+          if (!enabled_)
+            return;
+          if (!filter_insert(filter_, key(u, v)))
+            saturated_ = true;
+          ++count_;
+        }
+
+        // Erase the edge (u, v). A saturated filter may not hold it, and is
+        // not changed.
+        void erase(std::size_t u, std::size_t v)
+        {
+          if (!enabled_)
+            return;
+          if (!saturated_)
+            filter_.erase(key(u, v));
+          --count_;
+        }
+
+        // Returns false if u and v are not connected.
+        bool may_contain(std::size_t u, std::size_t v) const
+        {
+          return !enabled_ || saturated_ || filter_.contains(key(u, v));
+        }
+
+      private:
+        static std::size_t key(std::size_t u, std::size_t v)
+        {
+          if (!Directed && v < u)
+            std::swap(u, v);
+          return hash_values(u, v);
+        }
+
+      private:
+        F           filter_;
+        bool        enabled_;
+        bool        saturated_;
+        std::size_t count_; // The number of edges
+        std::size_t limit_; // The number of edges the filter is sized for
+      };
+
+    template<typename F, bool Directed>
+      template<typename G>
+        void
+        edge_filter<F, Directed>::enable(const G& g)
+        {
+          limit_ = 2 * g.size() < 64 ? 64 : 2 * g.size();
+          filter_.reset(limit_);
+          enabled_ = true;
+          saturated_ = false;
+          count_ = 0;
+          for (auto e : g.edges())
+            insert(g.source(e), g.target(e));
+        }
+
+    template<bool Directed>
+      using list_edge_filter =
+        edge_filter<cuckoo_filter<std::size_t>, Directed>;
+
+    template<bool Directed>
+      using vector_edge_filter =
+        edge_filter<blocked_bloom_filter<std::size_t>, Directed>;
+
+  } // namespace graph_impl
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,492 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_FLOW_HPP
+#define ORIGIN_GRAPH_FLOW_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/graph/shortest_paths.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [graph.flow]
+  //                          Maximum Flow and Minimum Cut
+  //
+  //    max_flow(g, s, t)
+  //    min_cut(g, s, t)
+  //
+  // The flow algorithms compute a maximum flow from a source vertex s to a
+  // sink vertex t, where the capacity of each edge e is its value, g(e).
+  // Capacities must be non-negative and of an arithmetic type. An edge of
+  // a directed graph carries flow from its source to its target; an edge of
+  // an undirected graph carries flow in either direction, and its flow is
+  // negative when it runs from the target to the source. Loops carry no
+  // flow.
+  //
+  // The max_flow algorithm returns a flow_result, holding the value of the
+  // flow, the flow on each edge in a vector indexed by edge handle, and a
+  // minimum cut: a vector indexed by vertex handle whose elements are true
+  // for the vertices on the source side of the cut. The min_cut algorithm
+  // returns just the source side of a minimum cut, which is found before
+  // the flow on each edge and so costs somewhat less to compute.
+  //
+  // Both use the highest-label push-relabel algorithm (Goldberg and Tarjan)
+  // with the gap and global relabeling heuristics, which together make it
+  // one of the fastest methods in practice, running in O(n^2 sqrt(m)) time
+  // in the worst case. The graph is first copied into a residual network in
+  // which the arcs of each vertex are stored contiguously, each arc holds
+  // the index of its paired reverse arc, and residual capacities are stored
+  // densely by arc index. A preflow is then pushed toward the sink from the
+  // active vertex of greatest height; exact heights are recomputed by a
+  // backward breadth-first search from the sink every O(n + m) units of
+  // relabeling work, and vertices above an empty height are lifted out of
+  // the search at once. The vertices that can no longer reach the sink in
+  // the residual network are the source side of a minimum cut. To find the
+  // flow on each edge, the excess left at those vertices is then returned
+  // to the source, by a FIFO push-relabel above height n.
+
+  template<typename W>
+    struct flow_result
+    {
+      W value;                       // The value of the flow
+      std::vector<W> flow;           // The flow on each edge
+      std::vector<char> source_side; // The source side of a minimum cut
+    };
+
+
+  namespace flow_impl
+  {
+    // Vertices and arcs of the residual network are numbered by 32-bit
+    // indices, which halves the size of the network.
+    using index = std::uint32_t;
+
+    constexpr index none = index(-1);
+
+
+    // The residual network of a graph, and the state of the push-relabel
+    // algorithm. The arcs of vertex u are [off[u], off[u + 1]), and the
+    // reverse of arc a is rev[a].
+    template<typename W>
+      class residual_network
+      {
+      public:
+        template<typename G>
+          residual_network(const G& g, index s, index t);
+
+        // Push a maximum preflow, and return its value.
+        W preflow();
+
+        // Set the source side of the minimum cut found by the preflow.
+        void cut(std::vector<char>& side);
+
+        // Return the excess of the preflow to the source.
+        void restore();
+
+        // Returns one more than the largest edge handle.
+        std::size_t edges() const { return arcs.size(); }
+
+        // Returns the arc of edge e, or none if e is a loop.
+        index arc_of(std::size_t e) const { return arcs[e]; }
+
+        // Returns the residual capacity of the arc a.
+        W residual(index a) const { return res[a]; }
+
+      private:
+        void push(index u, index v, index a);
+        void activate(index v);
+
+        void add_layer(index u, std::size_t h);
+        void remove_layer(index u, std::size_t h);
+
+        void discharge(index u);
+        std::size_t relabel(index u);
+        void gap(std::size_t h);
+        void global_relabel();
+
+      private:
+        std::size_t n;
+        index s, t;
+
+        // The residual network.
+        std::vector<std::size_t> off;
+        std::vector<index> head;
+        std::vector<index> rev;
+        std::vector<W> res;
+        std::vector<index> arcs;   // The forward arc of each edge
+
+        // Labels, excesses, and current arcs.
+        std::vector<std::size_t> height;
+        std::vector<W> excess;
+        std::vector<std::size_t> cur;
+
+        // The active vertices of each height, in singly linked lists, and
+        // all vertices of each height below n, in doubly linked lists.
+        std::vector<index> afirst;
+        std::vector<index> anext;
+        std::vector<index> dfirst;
+        std::vector<index> dnext;
+        std::vector<index> dprev;
+        std::size_t amax;
+        std::size_t dmax;
+
+        std::vector<index> queue;
+        std::size_t work;
+      };
+
+    template<typename W>
+      template<typename G>
+        residual_network<W>::residual_network(const G& g, index s, index t)
+          : n(search_impl::vertex_bound(g)), s(s), t(t), off(n + 1, 0)
+        {
+          if (n >= none)
+            throw std::length_error("max_flow: too many vertices");
+          std::size_t m = 0;
+          for (Edge<G> e : g.edges()) {
+            std::size_t u = g.source(e);
+            std::size_t v = g.target(e);
+            m = std::max(m, std::size_t(e) + 1);
+            if (u != v) {
+              ++off[u + 1];
+              ++off[v + 1];
+            }
+          }
+          std::partial_sum(off.begin(), off.end(), off.begin());
+          if (off[n] >= none)
+            throw std::length_error("max_flow: too many edges");
+
+          head.resize(off[n]);
+          rev.resize(off[n]);
+          res.assign(off[n], W(0));
+          arcs.assign(m, none);
+          std::vector<std::size_t> pos(off.begin(), off.end() - 1);
+          for (Edge<G> e : g.edges()) {
+            std::size_t u = g.source(e);
+            std::size_t v = g.target(e);
+            if (u == v)
+              continue;
+            assert(!(g(e) < W(0)));
+            index a = pos[u]++;
+            index b = pos[v]++;
+            head[a] = v;
+            head[b] = u;
+            rev[a] = b;
+            rev[b] = a;
+            res[a] = g(e);
+            res[b] = Undirected_graph<G>() ? g(e) : W(0);
+            arcs[e] = a;
+          }
+
+          height.resize(n);
+          excess.assign(n, W(0));
+          cur.assign(off.begin(), off.end() - 1);
+          afirst.resize(n);
+          anext.resize(n);
+          dfirst.resize(n);
+          dnext.resize(n);
+          dprev.resize(n);
+          queue.reserve(n);
+        }
+
+    template<typename W>
+      inline void
+      residual_network<W>::push(index u, index v, index a)
+      {
+        W d = std::min(excess[u], res[a]);
+        res[a] -= d;
+        res[rev[a]] += d;
+        if (excess[v] == W(0) && v != t)
+          activate(v);
+        excess[v] += d;
+        excess[u] -= d;
+      }
+
+    template<typename W>
+      inline void
+      residual_network<W>::activate(index v)
+      {
+        std::size_t h = height[v];
+        anext[v] = afirst[h];
+        afirst[h] = v;
+        amax = std::max(amax, h);
+      }
+
+    template<typename W>
+      inline void
+      residual_network<W>::add_layer(index u, std::size_t h)
+      {
+        dnext[u] = dfirst[h];
+        dprev[u] = none;
+        if (dfirst[h] != none)
+          dprev[dfirst[h]] = u;
+        dfirst[h] = u;
+        dmax = std::max(dmax, h);
+      }
+
+    template<typename W>
+      inline void
+      residual_network<W>::remove_layer(index u, std::size_t h)
+      {
+        if (dprev[u] != none)
+          dnext[dprev[u]] = dnext[u];
+        else
+          dfirst[h] = dnext[u];
+        if (dnext[u] != none)
+          dprev[dnext[u]] = dprev[u];
+      }
+
+    // Push the excess of u along admissible arcs, relabeling u when there
+    // are none, until u has no excess or cannot reach the sink.
+    template<typename W>
+      void
+      residual_network<W>::discharge(index u)
+      {
+        std::size_t h = height[u];
+        for (;;) {
+          std::size_t a = cur[u];
+          std::size_t last = off[u + 1];
+          for (; a != last; ++a) {
+            if (res[a] > W(0) && height[head[a]] + 1 == h) {
+              push(u, head[a], a);
+              if (excess[u] == W(0))
+                break;
+            }
+          }
+          if (a != last) {
+            cur[u] = a;
+            return;
+          }
+
+          remove_layer(u, h);
+          if (dfirst[h] == none) {
+            gap(h);
+            height[u] = n;
+            return;
+          }
+          h = relabel(u);
+          if (h == n)
+            return;
+          add_layer(u, h);
+        }
+      }
+
+    // Lift u to one more than its lowest residual neighbor, or to n, and
+    // returns its new height.
+    template<typename W>
+      std::size_t
+      residual_network<W>::relabel(index u)
+      {
+        work += off[u + 1] - off[u] + 12;
+        std::size_t h = n;
+        std::size_t arc = off[u];
+        for (std::size_t a = off[u]; a != off[u + 1]; ++a) {
+          if (res[a] > W(0) && height[head[a]] + 1 < h) {
+            h = height[head[a]] + 1;
+            arc = a;
+          }
+        }
+        height[u] = h;
+        cur[u] = arc;
+        return h;
+      }
+
+    // No vertex has height h, so the vertices above it cannot reach the
+    // sink; lift them to n.
+    template<typename W>
+      void
+      residual_network<W>::gap(std::size_t h)
+      {
+        for (std::size_t k = h + 1; k <= dmax; ++k) {
+          for (index v = dfirst[k]; v != none; v = dnext[v])
+            height[v] = n;
+          dfirst[k] = none;
+          afirst[k] = none;
+        }
+        dmax = h;
+        amax = std::min(amax, h);
+      }
+
+    // Set the height of each vertex to its distance to the sink in the
+    // residual network, or to n if it cannot reach the sink.
+    template<typename W>
+      void
+      residual_network<W>::global_relabel()
+      {
+        std::fill(height.begin(), height.end(), n);
+        std::fill(afirst.begin(), afirst.end(), none);
+        std::fill(dfirst.begin(), dfirst.end(), none);
+        amax = dmax = 0;
+        queue.clear();
+        height[t] = 0;
+        queue.push_back(t);
+        for (std::size_t i = 0; i != queue.size(); ++i) {
+          index u = queue[i];
+          std::size_t h = height[u] + 1;
+          for (std::size_t a = off[u]; a != off[u + 1]; ++a) {
+            index v = head[a];
+            if (height[v] == n && v != s && res[rev[a]] > W(0)) {
+              height[v] = h;
+              cur[v] = off[v];
+              queue.push_back(v);
+              add_layer(v, h);
+              if (excess[v] > W(0))
+                activate(v);
+            }
+          }
+        }
+        work = 0;
+      }
+
+    template<typename W>
+      W
+      residual_network<W>::preflow()
+      {
+        for (std::size_t a = off[s]; a != off[s + 1]; ++a) {
+          W c = res[a];
+          res[a] = W(0);
+          res[rev[a]] += c;
+          excess[head[a]] += c;
+        }
+        global_relabel();
+
+        std::size_t limit = 6 * n + off[n];
+        for (;;) {
+          while (amax != 0 && afirst[amax] == none)
+            --amax;
+          if (amax == 0)
+            break;
+          index u = afirst[amax];
+          afirst[amax] = anext[u];
+          discharge(u);
+          if (work > limit)
+            global_relabel();
+        }
+        return excess[t];
+      }
+
+    template<typename W>
+      void
+      residual_network<W>::cut(std::vector<char>& side)
+      {
+        global_relabel();
+        side.resize(n);
+        for (std::size_t v = 0; v != n; ++v)
+          side[v] = height[v] == n;
+      }
+
+    template<typename W>
+      void
+      residual_network<W>::restore()
+      {
+        // Label each vertex by n plus its distance to the source, which is
+        // finite for every vertex with excess, and discharge those vertices
+        // in FIFO order.
+        std::fill(height.begin(), height.end(), 2 * n);
+        queue.clear();
+        height[s] = n;
+        queue.push_back(s);
+        for (std::size_t i = 0; i != queue.size(); ++i) {
+          index u = queue[i];
+          for (std::size_t a = off[u]; a != off[u + 1]; ++a) {
+            index v = head[a];
+            if (height[v] == 2 * n && v != t && res[rev[a]] > W(0)) {
+              height[v] = height[u] + 1;
+              queue.push_back(v);
+            }
+          }
+        }
+
+        queue.clear();
+        for (std::size_t v = 0; v != n; ++v) {
+          cur[v] = off[v];
+          if (v != s && v != t && excess[v] > W(0))
+            queue.push_back(v);
+        }
+        for (std::size_t i = 0; i != queue.size(); ++i) {
+          index u = queue[i];
+          while (excess[u] > W(0)) {
+            std::size_t a = cur[u];
+            for (; a != off[u + 1]; ++a) {
+              index v = head[a];
+              if (res[a] > W(0) && height[u] == height[v] + 1) {
+                if (excess[v] == W(0) && v != s)
+                  queue.push_back(v);
+                W d = std::min(excess[u], res[a]);
+                res[a] -= d;
+                res[rev[a]] += d;
+                excess[v] += d;
+                excess[u] -= d;
+                if (excess[u] == W(0))
+                  break;
+              }
+            }
+            if (a != off[u + 1]) {
+              cur[u] = a;
+              break;
+            }
+            std::size_t h = std::size_t(-1);
+            for (a = off[u]; a != off[u + 1]; ++a)
+              if (res[a] > W(0))
+                h = std::min(h, height[head[a]] + 1);
+            assert(h != std::size_t(-1));
+            height[u] = h;
+            cur[u] = off[u];
+          }
+        }
+      }
+
+  } // namespace flow_impl
+
+
+  // Returns a maximum flow from s to t in g, and a minimum cut.
+  template<typename G>
+    flow_result<Edge_weight<G>>
+    max_flow(const G& g, Vertex<G> s, Vertex<G> t)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using W = Edge_weight<G>;
+      assert(s != t);
+
+      flow_impl::residual_network<W> net(g, s, t);
+      flow_result<W> r;
+      r.value = net.preflow();
+      net.cut(r.source_side);
+      net.restore();
+      r.flow.assign(net.edges(), W(0));
+      for (Edge<G> e : g.edges()) {
+        flow_impl::index a = net.arc_of(e);
+        if (a != flow_impl::none)
+          r.flow[e] = g(e) - net.residual(a);
+      }
+      return r;
+    }
+
+  // Returns the source side of a minimum cut between s and t in g.
+  template<typename G>
+    std::vector<char>
+    min_cut(const G& g, Vertex<G> s, Vertex<G> t)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      assert(s != t);
+
+      flow_impl::residual_network<Edge_weight<G>> net(g, s, t);
+      net.preflow();
+      std::vector<char> side;
+      net.cut(side);
+      return side;
+    }
+
+} // namespace origin
+
+#endif
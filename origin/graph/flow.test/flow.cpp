@@ -0,0 +1,140 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include <origin/graph/flow.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns a random capacity in [0, 100).
+int
+random_capacity(minstd_rand& prng)
+{
+  return uniform_int_distribution<int>(0, 99)(prng);
+}
+
+// Returns the capacity of the cut whose source side is side.
+template<typename G>
+  Edge_weight<G>
+  cut_capacity(const G& g, const vector<char>& side)
+  {
+    Edge_weight<G> c = 0;
+    for (Edge<G> e : g.edges()) {
+      bool u = side[g.source(e)];
+      bool v = side[g.target(e)];
+      if ((u && !v) || (!Directed_graph<G>() && v && !u))
+        c += g(e);
+    }
+    return c;
+  }
+
+// The flow respects the capacities and is conserved at each vertex but s
+// and t, and its value is the capacity of the cut, which proves both are
+// optimal.
+template<typename G>
+  Edge_weight<G>
+  check_flow(const G& g, Vertex<G> s, Vertex<G> t)
+  {
+    using W = Edge_weight<G>;
+    auto r = max_flow(g, s, t);
+    vector<W> net(g.order(), 0);
+    for (Edge<G> e : g.edges()) {
+      W f = r.flow[e];
+      assert(!(g(e) < f));
+      assert(!(f < (Directed_graph<G>() ? W(0) : -g(e))));
+      net[g.source(e)] -= f;
+      net[g.target(e)] += f;
+    }
+    for (Vertex<G> v : g.vertices())
+      assert(v == s || v == t || net[v] == W(0));
+    assert(net[t] == r.value && net[s] == -r.value);
+
+    assert(r.source_side[s] && !r.source_side[t]);
+    assert(cut_capacity(g, r.source_side) == r.value);
+    vector<char> side = min_cut(g, s, t);
+    assert(side == r.source_side);
+    return r.value;
+  }
+
+void
+check_example()
+{
+  // The network of Cormen et al., whose maximum flow is 23.
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(6);
+  g.add_edge(0, 1, 16);
+  g.add_edge(0, 2, 13);
+  g.add_edge(1, 3, 12);
+  g.add_edge(2, 1, 4);
+  g.add_edge(3, 2, 9);
+  g.add_edge(2, 4, 14);
+  g.add_edge(4, 3, 7);
+  g.add_edge(3, 5, 20);
+  g.add_edge(4, 5, 4);
+  assert(check_flow(g, 0, 5) == 23);
+  assert((min_cut(g, 0, 5) == vector<char>{1, 1, 1, 0, 1, 0}));
+
+  // Flow runs backward along none of the edges, even when they are
+  // reversed, and loops and parallel edges are allowed.
+  g.add_edge(5, 0, 100);
+  g.add_edge(1, 1, 100);
+  g.add_edge(4, 5, 1);
+  assert(check_flow(g, 0, 5) == 24);
+  assert(check_flow(g, 5, 0) == 100);
+
+  // A sink that cannot be reached has no flow.
+  g.add_vertex('g');
+  assert(check_flow(g, 0, 6) == 0);
+  assert(check_flow(g, 6, 0) == 0);
+}
+
+void
+check_undirected()
+{
+  // Edges of an undirected graph carry flow either way.
+  using G = undirected_adjacency_list<char, double>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 1.5);
+  g.add_edge(1, 2, 3);
+  g.add_edge(0, 2, 3);
+  g.add_edge(3, 1, 4);
+  g.add_edge(2, 3, 0.5);
+  auto r = max_flow(g, 0, 3);
+  assert(r.value == 4.5);
+  assert(r.flow[1] < 0);
+  assert(check_flow(g, 3, 0) == 4.5);
+}
+
+int main()
+{
+  check_example();
+  check_undirected();
+
+  using D = directed_adjacency_list<char, int>;
+  using U = undirected_adjacency_list<char, int>;
+  using A = directed_adjacency_vector<char, long>;
+  for (size_t n : {2, 10, 100, 2000}) {
+    for (size_t m : {n, 4 * n, 20 * n}) {
+      size_t seed = n + m;
+      check_flow(build_erdos_renyi_graph<D>(n, m, seed, random_capacity),
+                 0, n - 1);
+      check_flow(build_erdos_renyi_graph<U>(n, m, seed, random_capacity),
+                 0, n - 1);
+      check_flow(build_erdos_renyi_graph<A>(n, m, seed, random_capacity),
+                 1, 0);
+    }
+  }
+}
@@ -0,0 +1,324 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_GENERATORS_HPP
+#define ORIGIN_GRAPH_GENERATORS_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/random.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.generators]
+  //                             Graph Generators
+  //
+  // A graph generator describes the edges of a synthetic graph. It is a
+  // forward range of edge descriptions (pairs of vertex numbers), so it can
+  // be passed directly to the bulk loader of a graph (see [graph.bulk]),
+  // which traverses it twice without the edges ever being stored:
+  //
+  //    rmat_generator gen(20, 16 << 20, 42); // 2^20 vertices, 16M edges
+  //    directed_adjacency_list<> g;
+  //    load_generated(g, gen);               // Add gen.order() vertices,
+  //                                          // and the edges of gen
+  //
+  // The kth edge of a generator is computed by gen.edge(k) from the seed of
+  // the generator and k alone, using the kth stream of a splitmix64 engine
+  // (see [random.splitmix]). Any part of a graph can therefore be generated
+  // independently of the others: generate_edges materializes the edges in
+  // parallel, and the edges are the same for any number of threads.
+  //
+  // The generators are:
+  //
+  //    rmat_generator(scale, m, seed[, p])
+  //      m edges of an R-MAT graph on 2^scale vertices. Each edge is placed
+  //      by choosing one quadrant of the adjacency matrix scale times, with
+  //      the probabilities p (by default, the Graph500 parameters a = 0.57,
+  //      b = c = 0.19 and d = 0.05). This is the stochastic Kronecker graph
+  //      of a 2 x 2 initiator matrix. The vertex numbers are scrambled by a
+  //      bijection derived from the seed, as in Graph500, so that the hubs
+  //      of the graph are not clustered at the low vertex numbers.
+  //
+  //    barabasi_albert_generator(n, d, seed)
+  //      The n * d edges of a Barabasi-Albert graph on n vertices: vertex v
+  //      adds d edges to vertices chosen with probability proportional to
+  //      their degree among the edges added before. The endpoints of the
+  //      edges are kept in one array of 2nd vertices (Batagelj and Brandes),
+  //      in which the target of each edge is a copy of an earlier entry,
+  //      chosen at random. The target is found by following the chain of
+  //      copies back to a source, which takes two steps on average, so that
+  //      each edge is computed independently (Sanders and Schulz).
+  //
+  //    erdos_renyi_generator(n, m, seed)
+  //      m edges whose endpoints are chosen uniformly from n vertices.
+  //
+  // The graphs may contain loops and multiple edges.
+
+  namespace generators_impl
+  {
+    // Returns a number in [0, n) computed from the random number x: the
+    // upper half of the product of x and n, which is cheaper than x % n.
+    // Either reduction is biased by less than n / 2^64.
+    inline std::uint64_t
+    reduce(std::uint64_t x, std::uint64_t n)
+    {
+#if defined(__SIZEOF_INT128__)
+      return std::uint64_t((static_cast<unsigned __int128>(x) * n) >> 64);
+#else
+      return x % n;
+#endif
+    }
+
+    // An iterator over the edges of a graph generator.
+    template<typename G>
+      struct edge_iterator
+      {
+        using value_type = std::pair<std::size_t, std::size_t>;
+        using reference = value_type;
+        using pointer = const value_type*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        edge_iterator(const G* g = nullptr, std::size_t k = 0)
+          : gen(g), index(k)
+        { }
+
+        value_type operator*() const { return gen->edge(index); }
+
+        edge_iterator& operator++() { ++index; return *this; }
+
+        edge_iterator operator++(int)
+        {
+          edge_iterator tmp = *this;
+          ++index;
+          return tmp;
+        }
+
+        friend bool operator==(const edge_iterator& a, const edge_iterator& b)
+        {
+          return a.index == b.index;
+        }
+
+        friend bool operator!=(const edge_iterator& a, const edge_iterator& b)
+        {
+          return a.index != b.index;
+        }
+
+        const G* gen;
+        std::size_t index;
+      };
+
+    // The range interface common to all generators. The derived generator
+    // G provides edge(k).
+    template<typename G>
+      class generator_base
+      {
+      public:
+        using value_type = std::pair<std::size_t, std::size_t>;
+        using iterator = edge_iterator<G>;
+
+        generator_base(std::size_t n, std::size_t m, std::uint64_t seed)
+          : order_(n), size_(m), streams_(seed)
+        { }
+
+        // Returns the number of vertices of the graph.
+        std::size_t order() const { return order_; }
+
+        // Returns the number of edges of the graph.
+        std::size_t size() const { return size_; }
+
+        iterator begin() const { return {derived(), 0}; }
+        iterator end() const { return {derived(), size_}; }
+
+      protected:
+        // Returns the splitmix64 engine for the kth edge.
+        splitmix64 stream(std::uint64_t k) const { return streams_.stream(k); }
+
+      private:
+        const G* derived() const { return static_cast<const G*>(this); }
+
+        std::size_t order_;
+        std::size_t size_;
+        splitmix64 streams_;
+      };
+
+  } // namespace generators_impl
+
+
+  // The probabilities of the four quadrants of an R-MAT generator: a is
+  // that of the upper left quadrant, b the upper right, c the lower left,
+  // and d the lower right. They must sum to 1.
+  struct rmat_parameters
+  {
+    double a;
+    double b;
+    double c;
+    double d;
+  };
+
+  // The parameters of the Graph500 benchmark.
+  constexpr rmat_parameters graph500_parameters {0.57, 0.19, 0.19, 0.05};
+
+
+  class rmat_generator
+    : public generators_impl::generator_base<rmat_generator>
+  {
+    using base_type = generators_impl::generator_base<rmat_generator>;
+  public:
+    rmat_generator(std::size_t scale,
+                   std::size_t m,
+                   std::uint64_t seed,
+                   const rmat_parameters& p = graph500_parameters)
+      : base_type(std::size_t(1) << scale, m, seed),
+        scale_(scale),
+        mask_((std::uint64_t(1) << scale) - 1),
+        key_(random_impl::mix(seed ^ 0x5bd1e995u))
+    {
+      assert(scale < 64);
+      const double unit = 4294967296.0;
+      ta_ = std::uint64_t(p.a * unit);
+      tab_ = std::uint64_t((p.a + p.b) * unit);
+      tabc_ = std::uint64_t((p.a + p.b + p.c) * unit);
+    }
+
+    // Returns the kth edge. Each choice of a quadrant takes 32 bits x of a
+    // random number, scaled to [0, 1). The choices are unpredictable, so
+    // they are computed without branches: the source is in the lower half
+    // of the matrix if x >= a + b, and the target is in the right half if
+    // x is in [a, a + b) or x >= a + b + c.
+    value_type edge(std::size_t k) const
+    {
+      splitmix64 g = stream(k);
+      std::uint64_t u = 0, v = 0, r = 0;
+      for (std::size_t i = 0; i != scale_; ++i) {
+        if (i % 2 == 0)
+          r = g();
+        std::uint64_t x = r & 0xffffffffu;
+        r >>= 32;
+        std::uint64_t ab = x >= tab_;
+        u = (u << 1) | ab;
+        v = (v << 1) | ((x >= ta_) ^ ab ^ (x >= tabc_));
+      }
+      return {scramble(u), scramble(v)};
+    }
+
+  private:
+    // A bijection on the numbers of scale bits: multiplication by an odd
+    // number and addition are bijections modulo 2^scale, and so is the
+    // exclusive or of a number with its upper bits.
+    std::size_t scramble(std::uint64_t x) const
+    {
+      std::size_t s = scale_ / 2 + 1;
+      x = (x * 0x9e3779b97f4a7c15ull + key_) & mask_;
+      x ^= x >> s;
+      x = (x * 0xbf58476d1ce4e5b9ull + (key_ >> 32)) & mask_;
+      x ^= x >> s;
+      return x;
+    }
+
+    std::size_t   scale_;
+    std::uint64_t mask_;
+    std::uint64_t key_;
+    std::uint64_t ta_;
+    std::uint64_t tab_;
+    std::uint64_t tabc_;
+  };
+
+
+  class barabasi_albert_generator
+    : public generators_impl::generator_base<barabasi_albert_generator>
+  {
+    using base_type =
+      generators_impl::generator_base<barabasi_albert_generator>;
+  public:
+    barabasi_albert_generator(std::size_t n, std::size_t d,
+                              std::uint64_t seed)
+      : base_type(n, n * d, seed), degree_(d)
+    {
+      assert(d > 0);
+    }
+
+    // Returns the kth edge. Entry 2k of the array of endpoints is the
+    // source of the kth edge, and entry 2k + 1 is a copy of an entry chosen
+    // uniformly from [0, 2k].
+    value_type edge(std::size_t k) const
+    {
+      std::uint64_t i = 2 * std::uint64_t(k) + 1;
+      while (i % 2 == 1) {
+        splitmix64 g = stream(i);
+        i = generators_impl::reduce(g(), i);
+      }
+      return {k / degree_, i / 2 / degree_};
+    }
+
+  private:
+    std::size_t degree_;
+  };
+
+
+  class erdos_renyi_generator
+    : public generators_impl::generator_base<erdos_renyi_generator>
+  {
+    using base_type = generators_impl::generator_base<erdos_renyi_generator>;
+  public:
+    erdos_renyi_generator(std::size_t n, std::size_t m, std::uint64_t seed)
+      : base_type(n, m, seed)
+    {
+      assert(n > 0);
+    }
+
+    // Returns the kth edge.
+    value_type edge(std::size_t k) const
+    {
+      splitmix64 g = stream(k);
+      std::size_t u = generators_impl::reduce(g(), order());
+      return {u, std::size_t(generators_impl::reduce(g(), order()))};
+    }
+  };
+
+
+  // Returns the edges of the generator gen, computed by up to threads
+  // threads (by default, those of the parallel searches).
+  template<typename Gen>
+    std::vector<std::pair<std::size_t, std::size_t>>
+    generate_edges(const Gen& gen, std::size_t threads = search_threads())
+    {
+      constexpr std::size_t block = 1 << 16;
+      std::size_t m = gen.size();
+      std::vector<std::pair<std::size_t, std::size_t>> es(m);
+      search_impl::parallel_for((m + block - 1) / block, threads,
+                                [&](std::size_t b) {
+        std::size_t last = std::min(m, (b + 1) * block);
+        for (std::size_t k = b * block; k != last; ++k)
+          es[k] = gen.edge(k);
+      });
+      return es;
+    }
+
+  // Add vertices to g until it has gen.order() vertices, and add the edges
+  // of gen with the bulk loader of g.
+  template<typename G, typename Gen>
+    void
+    load_generated(G& g, const Gen& gen)
+    {
+      while (g.order() < gen.order())
+        g.add_vertex();
+      g.add_edges(gen);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,125 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include <origin/graph/generators.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+using edge_list = vector<pair<size_t, size_t>>;
+
+// Returns the degree of each of n vertices in the edges es.
+vector<size_t>
+degrees(size_t n, const edge_list& es)
+{
+  vector<size_t> d(n);
+  for (const auto& e : es) {
+    assert(e.first < n && e.second < n);
+    ++d[e.first];
+    ++d[e.second];
+  }
+  return d;
+}
+
+// The edges of a generator are the same for any number of threads, and
+// are those of its range.
+template<typename Gen>
+  void
+  check_deterministic(const Gen& gen)
+  {
+    edge_list es = generate_edges(gen, 1);
+    assert(es.size() == gen.size());
+    assert(generate_edges(gen, 4) == es);
+    assert(edge_list(gen.begin(), gen.end()) == es);
+    for (size_t k = 0; k < es.size(); k += 997)
+      assert(gen.edge(k) == es[k]);
+  }
+
+void
+check_rmat()
+{
+  rmat_generator gen(14, 200000, 1);
+  assert(gen.order() == 1 << 14 && gen.size() == 200000);
+  check_deterministic(gen);
+  edge_list es = generate_edges(gen);
+  assert(es != generate_edges(rmat_generator(14, 200000, 2)));
+
+  // The degrees are skewed: the largest hub has many times the mean degree.
+  vector<size_t> d = degrees(gen.order(), es);
+  double mean = 2.0 * es.size() / gen.order();
+  assert(*max_element(d.begin(), d.end()) > 20 * mean);
+
+  // The quadrants are chosen with the given probabilities. With all of
+  // the probability in a single quadrant, every edge is the same.
+  es = generate_edges(rmat_generator(8, 100, 3, {1, 0, 0, 0}));
+  assert(count(es.begin(), es.end(), es[0]) == 100);
+  assert(es[0].first == es[0].second);
+  es = generate_edges(rmat_generator(8, 100, 3, {0, 1, 0, 0}));
+  assert(count(es.begin(), es.end(), es[0]) == 100);
+  assert(es[0].first != es[0].second);
+}
+
+void
+check_barabasi_albert()
+{
+  barabasi_albert_generator gen(100000, 4, 1);
+  assert(gen.order() == 100000 && gen.size() == 400000);
+  check_deterministic(gen);
+
+  // Each vertex adds d edges to itself or to earlier vertices.
+  edge_list es = generate_edges(gen);
+  for (size_t k = 0; k != es.size(); ++k) {
+    assert(es[k].first == k / 4);
+    assert(es[k].second <= es[k].first);
+  }
+
+  // The degrees follow a power law, so the oldest vertices are hubs.
+  vector<size_t> d = degrees(gen.order(), es);
+  assert(*max_element(d.begin(), d.begin() + 10) > 100);
+  assert(size_t(count(d.begin(), d.end(), 4)) > gen.order() / 4);
+}
+
+void
+check_erdos_renyi()
+{
+  erdos_renyi_generator gen(1000, 100000, 1);
+  check_deterministic(gen);
+  vector<size_t> d = degrees(gen.order(), generate_edges(gen));
+  assert(*min_element(d.begin(), d.end()) > 100);
+  assert(*max_element(d.begin(), d.end()) < 300);
+}
+
+// A generator is passed directly to the bulk loader of a graph.
+template<typename G>
+  void
+  check_load()
+  {
+    G g;
+    rmat_generator gen(10, 5000, 1);
+    load_generated(g, gen);
+    assert(g.order() == 1024 && g.size() == 5000);
+    edge_list es = generate_edges(gen);
+    for (size_t k = 0; k < es.size(); k += 101)
+      assert(g(es[k].first, es[k].second));
+  }
+
+int main()
+{
+  check_rmat();
+  check_barabasi_albert();
+  check_erdos_renyi();
+  check_load<directed_adjacency_list<>>();
+  check_load<undirected_adjacency_list<>>();
+  check_load<directed_adjacency_vector<>>();
+}
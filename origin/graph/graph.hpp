@@ -8,6 +8,11 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include <origin/graph/concepts.hpp>
 
 namespace origin
@@ -194,6 +199,298 @@ namespace origin
       Vertex<G> v;
     };
 
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                [graph.bulk]
+  //                          Bulk Edge Insertion
+  //
+  // Graphs that support bulk insertion provide g.add_edges(r), where r is a
+  // forward range of edge descriptions. Each description is a tuple-like
+  // object (e.g., a pair or tuple) whose first two elements are the source
+  // and target vertices of the edge. If the description has a third element,
+  // it is the value of the edge. For example:
+  //
+  //    std::vector<std::tuple<int, int, double>> es {{0, 1, 0.5}, {1, 2, 1.0}};
+  //    g.add_edges(es);
+  //
+  // Bulk insertion traverses the range twice: once to count the edges
+  // incident to each vertex, so that each incidence list is reserved exactly
+  // once, and once to add the edges. When r is an rvalue, the values of its
+  // descriptions are moved into the graph.
+
+  namespace graph_impl
+  {
+    // Increment the count of edges incident to v, growing the counts as
+    // needed.
+    inline void
+    count_incident(std::vector<std::size_t>& counts, std::size_t v)
+    {
+      if (counts.size() <= v)
+        counts.resize(v + 1);
+      ++counts[v];
+    }
+
+    // Returns the number of elements in the edge description x.
+    template<typename T>
+      using Edge_description_size = size_constant<std::tuple_size<T>::value>;
+
+    // Returns x, an element of an object of type R, as an rvalue if R is
+    // not an lvalue reference.
+    template<typename R, typename T>
+      using Forwarded_element =
+        If<std::is_lvalue_reference<R>::value, T&&, Remove_reference<T>&&>;
+
+    template<typename R, typename T>
+      inline Forwarded_element<R, T>
+      forward_element(T&& x)
+      {
+        return static_cast<Forwarded_element<R, T>>(x);
+      }
+
+    // Add the edge described by the pair or triple x to g, moving the value
+    // of x if it is an rvalue.
+    template<typename G, typename T>
+      inline Edge<G>
+      add_described_edge(G& g, T&& x, size_constant<2>)
+      {
+        return g.add_edge(std::get<0>(x), std::get<1>(x));
+      }
+
+    template<typename G, typename T>
+      inline Edge<G>
+      add_described_edge(G& g, T&& x, size_constant<3>)
+      {
+        return g.add_edge(std::get<0>(x), std::get<1>(x),
+                          std::get<2>(std::forward<T>(x)));
+      }
+
+    template<typename G, typename T>
+      inline Edge<G>
+      add_described_edge(G& g, T&& x)
+      {
+        return add_described_edge(g, std::forward<T>(x),
+                                  Edge_description_size<Decay<T>>{});
+      }
+
+  } // namespace graph_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                               [graph.batch]
+  //                            Batched Updates
+  //
+  // An edge batch is a buffer of edge insertions and removals that a graph
+  // applies together with g.apply(b). Applying a batch removes its edges
+  // first and then inserts its new edges, so that a batch removing and
+  // re-adding the edges from u to v leaves the new edges. For example:
+  //
+  //    edge_batch<G> b;
+  //    b.remove(e);                        // Remove the edge e
+  //    b.remove(u, v);                     // Remove every edge from u to v
+  //    b.insert(v, w);                     // Add an edge from v to w
+  //    g.apply(b);
+  //
+  // Rather than updating the incident edge lists for each change, the
+  // removals are sorted by vertex, and each list touched by the batch is
+  // filtered once. The insertions are added by the bulk loader of the graph
+  // (see [graph.bulk]), which grows each list at most once. Applying a batch
+  // of b changes takes O(b log b) time, plus time linear in the degrees of
+  // the vertices that it touches.
+  //
+  // Removing an edge more than once, or by both its handle and its
+  // endpoints, removes it once. The handles of removed edges must be those
+  // of edges of the graph. The new edges are added in the order in which
+  // they were inserted into the batch. Applying a batch does not change it.
+  template<typename G>
+    class edge_batch
+    {
+    public:
+      using vertex = Vertex<G>;
+      using edge = Edge<G>;
+      using edge_value = Decay<decltype(std::declval<const G&>()(
+        std::declval<edge>()))>;
+
+      using insertion = std::tuple<vertex, vertex, edge_value>;
+
+      // Observers
+      bool        empty() const { return size() == 0; }
+      std::size_t size() const
+      {
+        return ins_.size() + edges_.size() + pairs_.size();
+      }
+
+      // Insert an edge from u to v whose value is x.
+      void insert(vertex u, vertex v, const edge_value& x = edge_value())
+      {
+        ins_.emplace_back(u, v, x);
+      }
+
+      // Remove the edge e.
+      void remove(edge e) { edges_.push_back(e); }
+
+      // Remove every edge from u to v.
+      void remove(vertex u, vertex v) { pairs_.emplace_back(u, v); }
+
+      // Empty the batch.
+      void clear()
+      {
+        ins_.clear();
+        edges_.clear();
+        pairs_.clear();
+      }
+
+      // Returns the descriptions of the new edges (see [graph.bulk]).
+      const std::vector<insertion>& insertions() const { return ins_; }
+
+      // Returns the handles of the edges to remove, and the sorted
+      // endpoints of the edges to remove.
+      const std::vector<edge>& removed_edges() const { return edges_; }
+      std::vector<std::pair<vertex, vertex>> removed_pairs() const
+      {
+        std::vector<std::pair<vertex, vertex>> r = pairs_;
+        std::sort(r.begin(), r.end());
+        return r;
+      }
+
+    private:
+      std::vector<insertion> ins_;
+      std::vector<edge> edges_;
+      std::vector<std::pair<vertex, vertex>> pairs_;
+    };
+
+
+  namespace graph_impl
+  {
+    // Returns the endpoint of e, an edge incident to u, that is not u. The
+    // opposite endpoint of a loop is u.
+    template<typename G>
+      inline Vertex<G>
+      other_endpoint(const G& g, Edge<G> e, Vertex<G> u)
+      {
+        return g.source(e) == u ? g.target(e) : g.source(e);
+      }
+
+    // Returns the edges incident to u that are followed to find the edges
+    // from u to v: its out edges in a directed graph, and its incident
+    // edges in an undirected graph.
+    template<typename G>
+      inline auto
+      batch_edges(const G& g, Vertex<G> u, int) -> decltype(g.out_edges(u))
+      {
+        return g.out_edges(u);
+      }
+
+    template<typename G>
+      inline auto
+      batch_edges(const G& g, Vertex<G> u, long) -> decltype(g.edges(u))
+      {
+        return g.edges(u);
+      }
+
+    // Returns the sorted handles of the edges removed by the batch b. The
+    // edges removed by their endpoints are found by a search of the edges
+    // of each source, for the targets removed from it.
+    template<typename G>
+      std::vector<Edge<G>>
+      batch_removals(const G& g, const edge_batch<G>& b)
+      {
+        using P = std::pair<Vertex<G>, Vertex<G>>;
+        std::vector<Edge<G>> dead = b.removed_edges();
+        std::vector<P> pairs = b.removed_pairs();
+        std::vector<Vertex<G>> targets;
+        for (auto i = pairs.begin(); i != pairs.end(); ) {
+          Vertex<G> u = i->first;
+          targets.clear();
+          for ( ; i != pairs.end() && i->first == u; ++i)
+            targets.push_back(i->second);
+          for (Edge<G> e : batch_edges(g, u, 0)) {
+            Vertex<G> v = other_endpoint(g, e, u);
+            if (std::binary_search(targets.begin(), targets.end(), v))
+              dead.push_back(e);
+          }
+        }
+        std::sort(dead.begin(), dead.end());
+        dead.erase(std::unique(dead.begin(), dead.end()), dead.end());
+        return dead;
+      }
+
+    // Remove the edges in the sorted list dead from the incident edge list
+    // l, returning true if any were removed.
+    template<typename L, typename H>
+      bool
+      erase_batch(L& l, const std::vector<H>& dead)
+      {
+        auto i = std::remove_if(l.begin(), l.end(), [&dead](H e) {
+          return std::binary_search(dead.begin(), dead.end(), e);
+        });
+        if (i == l.end())
+          return false;
+        l.erase(i, l.end());
+        return true;
+      }
+
+    // Remove the edges marked in dead, which is indexed by edge handle, from
+    // the incident edge list l, returning true if any were removed.
+    template<typename L>
+      bool
+      erase_marked(L& l, const std::vector<char>& dead)
+      {
+        auto i = std::remove_if(l.begin(), l.end(), [&dead](std::size_t e) {
+          return dead[e];
+        });
+        if (i == l.end())
+          return false;
+        l.erase(i, l.end());
+        return true;
+      }
+
+    // Returns the sorted, distinct vertices of the list vs.
+    template<typename V>
+      std::vector<V>
+      distinct(std::vector<V> vs)
+      {
+        std::sort(vs.begin(), vs.end());
+        vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+        return vs;
+      }
+
+  } // namespace graph_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                               [graph.prune]
+  //                            Bulk Removal
+  //
+  // Pruning a graph, such as removing its vertices of low degree or its
+  // expired edges, removes many vertices or edges at once:
+  //
+  //    remove_vertices_if(g, pred)     // Remove each v where pred(v)
+  //    remove_edges_if(g, pred)        // Remove each e where pred(e)
+  //
+  // Removing a vertex also removes its incident edges. Rather than unlinking
+  // each item from the incident edge lists of its neighbors, the graph marks
+  // the items to remove, filters each incident edge list that holds a
+  // marked edge in a single pass, and then releases the marked slots of its
+  // vertex and edge sets in one scan. Pruning a graph with n vertices and m
+  // edges takes O(n + m) time, independently of the degrees of the removed
+  // vertices. The predicate is called once for each vertex or edge, before
+  // the graph is changed. The handles of the remaining vertices and edges
+  // are unchanged.
+  template<typename G, typename P>
+    inline void
+    remove_vertices_if(G& g, P pred)
+    {
+      g.remove_vertices_if(pred);
+    }
+
+  template<typename G, typename P>
+    inline void
+    remove_edges_if(G& g, P pred)
+    {
+      g.remove_edges_if(pred);
+    }
+
 } // namespace origin
 
 
@@ -0,0 +1,23 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "workload.hpp"
+
+using namespace origin;
+using namespace graph_perf;
+
+using G = directed_adjacency_vector<>;
+
+int main(int argc, char** argv)
+{
+  return benchmark_main(argc, argv, default_sizes(),
+                        [](benchmark_suite& s, std::size_t m) {
+    add_graph_benchmarks<G>(s, m);
+  });
+}
@@ -0,0 +1,232 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_GRAPH_PERF_WORKLOAD_HPP
+#define ORIGIN_GRAPH_GRAPH_PERF_WORKLOAD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <origin/benchmark/benchmark.hpp>
+#include <origin/graph/search.hpp>
+
+#include "../graph.test/testing.hpp"
+
+// The graph benchmarks measure the operations of a graph type G on four
+// synthetic workloads of about m edges each:
+//
+//    rmat    An R-MAT graph with an average degree of 16, whose hubs have
+//            very long incidence lists
+//    er      An Erdos-Renyi graph with the same number of vertices
+//    ba      A Barabasi-Albert graph with the same number of vertices, whose
+//            degrees follow a power law
+//    grid    A square grid, whose vertices all have degree 4 or less
+//
+// Each benchmark is named workload/m/operation, so that the results of the
+// programs measuring different graph types can be compared. The operations
+// are:
+//
+//    build        Build the graph from its edge list, in bulk
+//    out_edges    Visit the out edges (or incident edges) of every vertex
+//    in_edges     Visit the in edges of every vertex (directed graphs only)
+//    bfs          Search the graph breadth first from vertex 0
+//    churn        Add an edge and remove the edge added 1024 iterations
+//                 earlier (graphs supporting removal only)
+//    remove_hubs  Remove the vertices of highest degree (graphs supporting
+//                 removal only)
+//
+// Removing a hub changes the graph, so each batch of remove_hubs works on a
+// copy of the graph, made again after every 64 removals. The time of the
+// copy is included, but shared by the removals.
+//
+// The problem sizes default to 10^5 and 10^6 edges, so that 'make perform'
+// finishes in minutes; larger sizes, up to 10^8 edges, are given as
+// --sizes=1e7,1e8.
+namespace graph_perf
+{
+  using namespace origin;
+  using testing::edge_pairs;
+
+  // A workload is a named edge list over order vertices.
+  struct workload
+  {
+    std::string name;
+    std::size_t order;
+    edge_pairs  edges;
+  };
+
+  // Returns the workloads with about m edges.
+  inline std::vector<workload>
+  make_workloads(std::size_t m)
+  {
+    std::size_t scale = std::max(1.0, std::ceil(std::log2(m / 16.0)));
+    std::size_t n = std::size_t(1) << scale;
+    std::size_t d = std::max<std::size_t>(1, m / n);
+    std::size_t side = std::max(2.0, std::sqrt(m / 2.0));
+
+    std::vector<workload> ws;
+    ws.push_back({"rmat", n, testing::rmat_edges(scale, m, m)});
+    ws.push_back({"er", n, testing::erdos_renyi_edges(n, m, m)});
+    ws.push_back({"ba", n, testing::barabasi_albert_edges(n, d, m)});
+    ws.push_back({"grid", side * side, testing::grid_edges(side, side)});
+    return ws;
+  }
+
+  // Sum the targets of the out edges of every vertex.
+  template<typename G>
+    Requires<Directed_graph<G>(), std::size_t>
+    visit_out_edges(const G& g)
+    {
+      std::size_t sum = 0;
+      for (Vertex<G> v : g.vertices())
+        for (Edge<G> e : g.out_edges(v))
+          sum += g.target(e);
+      return sum;
+    }
+
+  template<typename G>
+    Requires<Undirected_graph<G>(), std::size_t>
+    visit_out_edges(const G& g)
+    {
+      std::size_t sum = 0;
+      for (Vertex<G> v : g.vertices())
+        for (Edge<G> e : g.edges(v))
+          sum += g.target(e);
+      return sum;
+    }
+
+  // Sum the sources of the in edges of every vertex.
+  template<typename G>
+    std::size_t
+    visit_in_edges(const G& g)
+    {
+      std::size_t sum = 0;
+      for (Vertex<G> v : g.vertices())
+        for (Edge<G> e : g.in_edges(v))
+          sum += g.source(e);
+      return sum;
+    }
+
+  template<typename G>
+    Requires<Directed_graph<G>()>
+    add_in_edges(benchmark_suite& s, const std::string& name,
+                 std::shared_ptr<const G> g)
+    {
+      s.add(name + "in_edges", [g]() { do_not_optimize(visit_in_edges(*g)); });
+    }
+
+  template<typename G>
+    Requires<Undirected_graph<G>()>
+    add_in_edges(benchmark_suite&, const std::string&, std::shared_ptr<const G>)
+    { }
+
+  // Counts the vertices discovered by a search.
+  struct counting_visitor : bfs_visitor
+  {
+    template<typename G>
+      void discover_vertex(const G&, Vertex<G>) { ++count; }
+
+    std::size_t count = 0;
+  };
+
+  // Add the benchmarks supported by every graph type to the suite s.
+  template<typename G>
+    void
+    add_graph_benchmarks(benchmark_suite& s, std::size_t m)
+    {
+      for (workload& w : make_workloads(m)) {
+        auto es = std::make_shared<workload>(std::move(w));
+        auto g = std::make_shared<const G>(
+          testing::build_from_edges<G>(es->order, es->edges));
+        std::string name = es->name + "/" + std::to_string(m) + "/";
+
+        s.add(name + "build", [es]() {
+          G h = testing::build_from_edges<G>(es->order, es->edges);
+          do_not_optimize(h.size());
+        });
+        s.add(name + "out_edges", [g]() {
+          do_not_optimize(visit_out_edges(*g));
+        });
+        add_in_edges<G>(s, name, g);
+        s.add(name + "bfs", [g]() {
+          counting_visitor vis;
+          breadth_first_search(*g, Vertex<G>(0), vis);
+          do_not_optimize(vis.count);
+        });
+      }
+    }
+
+  // Add the benchmarks of graphs that support removal to the suite s.
+  template<typename G>
+    void
+    add_removal_benchmarks(benchmark_suite& s, std::size_t m)
+    {
+      for (workload& w : make_workloads(m)) {
+        auto es = std::make_shared<workload>(std::move(w));
+        auto g = std::make_shared<G>(
+          testing::build_from_edges<G>(es->order, es->edges));
+        std::string name = es->name + "/" + std::to_string(m) + "/";
+
+        // A xorshift generator chooses the endpoints of the added edges.
+        auto added = std::make_shared<std::vector<Edge<G>>>(1024);
+        auto x = std::make_shared<std::uint64_t>(88172645463325252ull);
+        std::size_t n = es->order;
+        auto next = [n](std::uint64_t& x) -> std::size_t {
+          x ^= x << 13;
+          x ^= x >> 7;
+          x ^= x << 17;
+          return x % n;
+        };
+        for (Edge<G>& e : *added)
+          e = g->add_edge(next(*x), next(*x));
+        auto i = std::make_shared<std::size_t>(0);
+        s.add(name + "churn", [g, added, x, i, next]() {
+          Edge<G>& e = (*added)[*i];
+          g->remove_edge(e);
+          e = g->add_edge(next(*x), next(*x));
+          *i = (*i + 1) % added->size();
+          do_not_optimize(e);
+        });
+
+        // The hubs are removed in decreasing order of degree.
+        auto hubs = std::make_shared<std::vector<Vertex<G>>>();
+        for (Vertex<G> v : g->vertices())
+          hubs->push_back(v);
+        std::size_t k = std::min<std::size_t>(64, hubs->size());
+        std::partial_sort(hubs->begin(), hubs->begin() + k, hubs->end(),
+                          [g](Vertex<G> a, Vertex<G> b) {
+          return g->degree(a) > g->degree(b);
+        });
+        hubs->resize(k);
+        s.add_batch(name + "remove_hubs", [g, hubs](std::size_t n) {
+          while (n) {
+            G h = *g;
+            std::size_t r = std::min(n, hubs->size());
+            for (std::size_t j = 0; j != r; ++j)
+              h.remove_vertex((*hubs)[j]);
+            do_not_optimize(h.order());
+            n -= r;
+          }
+        });
+      }
+    }
+
+  // The default problem sizes, in edges.
+  inline std::vector<std::size_t>
+  default_sizes()
+  {
+    return {100000, 1000000};
+  }
+
+} // namespace graph_perf
+
+#endif
@@ -8,12 +8,17 @@
 #ifndef GRAPH_TEST_TESTING_HPP
 #define GRAPH_TEST_TESTING_HPP
 
+#include <array>
 #include <cassert>
 #include <iostream>
+#include <random>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include <origin/graph/graph.hpp>
 #include <origin/graph/io.hpp>
+#include <origin/graph/generators.hpp>
 
 namespace testing
 {
@@ -85,6 +90,100 @@ namespace testing
     }
 
 
+  // -------------------------------------------------------------------------- //
+  //                              Workload Generation
+  //
+  // The generators return the edges of synthetic graphs as pairs of vertex
+  // numbers, so that the same workload can be built into any graph using
+  // build_from_edges. The random generators are those of [graph.generators],
+  // and are deterministic for a given seed.
+
+  using edge_pairs = vector<pair<size_t, size_t>>;
+
+  // Returns m edges of an R-MAT graph with 2^scale vertices, with the
+  // Graph500 parameters, which give a skewed degree distribution with a few
+  // large hubs.
+  inline edge_pairs
+  rmat_edges(size_t scale, size_t m, size_t seed)
+  {
+    return generate_edges(rmat_generator(scale, m, seed));
+  }
+
+  // Returns m edges whose endpoints are chosen uniformly from n vertices:
+  // the Erdos-Renyi G(n, m) graph, allowing loops and multiple edges.
+  inline edge_pairs
+  erdos_renyi_edges(size_t n, size_t m, size_t seed)
+  {
+    return generate_edges(erdos_renyi_generator(n, m, seed));
+  }
+
+  // Returns the n * d edges of a Barabasi-Albert graph on n vertices, each
+  // of which adds d edges by preferential attachment.
+  inline edge_pairs
+  barabasi_albert_edges(size_t n, size_t d, size_t seed)
+  {
+    return generate_edges(barabasi_albert_generator(n, d, seed));
+  }
+
+  // Returns the edges of a rows by cols grid, whose vertex (i, j) is
+  // numbered i * cols + j. Each vertex is joined to its right and lower
+  // neighbors.
+  inline edge_pairs
+  grid_edges(size_t rows, size_t cols)
+  {
+    edge_pairs es;
+    es.reserve(2 * rows * cols);
+    for (size_t i = 0; i != rows; ++i) {
+      for (size_t j = 0; j != cols; ++j) {
+        size_t v = i * cols + j;
+        if (j + 1 != cols)
+          es.emplace_back(v, v + 1);
+        if (i + 1 != rows)
+          es.emplace_back(v, v + cols);
+      }
+    }
+    return es;
+  }
+
+  // Returns a graph with n vertices and the edges es, added in bulk.
+  template<typename G>
+    G build_from_edges(size_t n, const edge_pairs& es)
+    {
+      G g;
+      for (size_t i = 0; i != n; ++i)
+        g.add_vertex();
+      g.add_edges(es);
+      return g;
+    }
+
+  // Returns a graph with n vertices, each with the value 'a', and the edges
+  // erdos_renyi_edges(n, m, seed), added in order.
+  template<typename G>
+    G build_erdos_renyi_graph(size_t n, size_t m, size_t seed)
+    {
+      G g;
+      for (size_t i = 0; i != n; ++i)
+        g.add_vertex('a');
+      for (const auto& e : erdos_renyi_edges(n, m, seed))
+        g.add_edge(e.first, e.second);
+      return g;
+    }
+
+  // As above, but the value of each edge is value(prng), where prng is a
+  // minstd_rand seeded with seed.
+  template<typename G, typename F>
+    G build_erdos_renyi_graph(size_t n, size_t m, size_t seed, F value)
+    {
+      G g;
+      for (size_t i = 0; i != n; ++i)
+        g.add_vertex('a');
+      minstd_rand prng(seed);
+      for (const auto& e : erdos_renyi_edges(n, m, seed))
+        g.add_edge(e.first, e.second, value(prng));
+      return g;
+    }
+
+
   // -------------------------------------------------------------------------- //
   //                              Testing Functions
 
@@ -146,6 +245,39 @@ namespace testing
     }
 
 
+  template<typename G>
+    void
+    check_add_edges_bulk()
+    {
+      cout << "*** add edges in bulk (" << typestr<G>() << ") ***\n";
+      G g = build_n_graph<G>(3);
+      g.add_edge(0, 1, 100);
+
+      vector<tuple<int, int, int>> es;
+      for (int i = 0; i < 3; ++i) {
+        for (int j = i; j < 3; ++j)
+          es.emplace_back(i, j, es.size());
+      }
+      g.add_edges(es);
+
+      assert(g.size() == 7);
+      assert(g(g(0, 0)) == 0);
+      assert(g(g(0, 1)) == 100);
+      assert(g(g(0, 2)) == 2);
+      assert(g(g(1, 1)) == 3);
+      assert(g(g(1, 2)) == 4);
+      assert(g(g(2, 2)) == 5);
+      assert(has_degrees(g, Vertex<G>(0), {4, 1, 5}));
+      assert(has_degrees(g, Vertex<G>(2), {1, 3, 4}));
+
+      // Edges without values.
+      vector<pair<int, int>> ps {{2, 0}, {2, 1}};
+      g.add_edges(ps);
+      assert(g.size() == 9);
+      assert(g(2, 0));
+    }
+
+
   template<typename G>
     void
     check_remove_specific_edge()
@@ -332,6 +464,34 @@ namespace testing
       assert(g.empty());
     }
 
+  template<typename G>
+    void
+    check_workloads()
+    {
+      cout << "*** workloads (" << typestr<G>() << ") ***\n";
+      G g = build_from_edges<G>(12, grid_edges(3, 4));
+      assert(g.order() == 12 && g.size() == 17);
+      assert(g(0, 1) && g(0, 4) && g(10, 11));
+      assert(has_degrees(g, 5, {2, 2, 4}));
+
+      // The generators are deterministic for a given seed.
+      edge_pairs es = rmat_edges(10, 5000, 1);
+      assert(es.size() == 5000 && es == rmat_edges(10, 5000, 1));
+      for (const auto& e : es)
+        assert(e.first < 1024 && e.second < 1024);
+      g = build_from_edges<G>(1024, es);
+      assert(g.size() == 5000);
+
+      es = erdos_renyi_edges(100, 300, 2);
+      assert(es.size() == 300 && es == erdos_renyi_edges(100, 300, 2));
+      assert(es != erdos_renyi_edges(100, 300, 3));
+
+      es = barabasi_albert_edges(100, 3, 4);
+      assert(es.size() == 300 && es == barabasi_albert_edges(100, 3, 4));
+      g = build_from_edges<G>(100, es);
+      assert(g.size() == 300);
+    }
+
 } // namespace testing
 
 #endif
@@ -8,8 +8,13 @@
 #ifndef ORIGIN_GRAPH_HANDLE_HPP
 #define ORIGIN_GRAPH_HANDLE_HPP
 
+#include <cassert>
 #include <cstdint>
+
 #include <functional>
+#include <tuple>
+
+#include <origin/type/hash.hpp>
 
 namespace origin 
 {
@@ -19,63 +24,98 @@ namespace origin
   //
   // A handle is an ordinal value type used to represent an object in a data
   // structure. Handles are implicitly interoperable with unsigned intger
-  // (size_t) values, and have the special property that unsigned -1 indicates
-  // an invalid object.
+  // values, and have the special property that unsigned -1 indicates an
+  // invalid object.
+  //
+  // The index type T determines the size of the handle. It defaults to
+  // size_t. Data structures holding fewer than 2^32 - 1 objects can use
+  // std::uint32_t handles, which halves the memory needed to store them.
+  // Note that an invalid handle converts to T(-1), and not size_t(-1).
+  //
+  // Handles are hashed by mixing their index (see type.hash), so that the
+  // hashes of consecutive handles differ in all of their bits.
   //
   // TODO: Disable arithmetic operations?
-  class handle
-  {
-  public:
-    static constexpr std::size_t npos = -1;
-
-    handle(std::size_t n = npos);
-
-    // Boolean
-    explicit operator bool() const;
-
-    // Integral
-    operator std::size_t() const { return value; }
-    
-    // Hashable
-    std::size_t hash() const;
-    
-    std::size_t value;
-  };
-  
-  inline
-  handle::handle(std::size_t n) : value(n) { }
-
-  inline 
-  handle::operator bool() const { return value != npos; }
-  
-  inline std::size_t 
-  handle::hash() const { return std::hash<std::size_t>{}(value); }
+  template<typename T = std::size_t>
+    class basic_handle
+    {
+    public:
+      using index_type = T;
+
+      static constexpr T npos = -1;
+
+      basic_handle(std::size_t n = npos);
+
+      // Boolean
+      explicit operator bool() const;
+
+      // Integral
+      operator T() const { return value; }
+
+      // Hashable
+      std::size_t hash() const;
+
+      T value;
+    };
+
+  template<typename T>
+    constexpr T basic_handle<T>::npos;
+
+  // Initialize the handle with the index n. The index must be representable
+  // by the index type. Both size_t(-1) and npos yield an invalid handle.
+  template<typename T>
+    inline
+    basic_handle<T>::basic_handle(std::size_t n)
+      : value(n)
+    {
+      assert(n == std::size_t(-1) || n <= std::size_t(npos));
+    }
+
+  template<typename T>
+    inline
+    basic_handle<T>::operator bool() const { return value != npos; }
+
+  template<typename T>
+    inline std::size_t
+    basic_handle<T>::hash() const { return hash_mix(value); }
 
   // Equality
-  inline bool 
-  operator==(handle a, handle b) { return a.value == b.value; }
-  
-  inline bool 
-  operator!=(handle a, handle b) { return !(a == b); }
+  template<typename T>
+    inline bool
+    operator==(basic_handle<T> a, basic_handle<T> b)
+    {
+      return a.value == b.value;
+    }
+
+  template<typename T>
+    inline bool
+    operator!=(basic_handle<T> a, basic_handle<T> b) { return !(a == b); }
 
   // Ordering
-  inline bool 
-  operator<(handle a, handle b)
-  { 
-    if (!a)
-      return bool(b);
-    else 
-      return b ? a.value < b.value : false; 
-  }
-    
-  inline bool 
-  operator>(handle a, handle b) { return b < a; }
-  
-  inline bool 
-  operator<=(handle a, handle b) { return !(b < a); }
-  
-  inline bool 
-  operator>=(handle a, handle b) { return !(a < b); }
+  template<typename T>
+    inline bool
+    operator<(basic_handle<T> a, basic_handle<T> b)
+    {
+      if (!a)
+        return bool(b);
+      else
+        return b ? a.value < b.value : false;
+    }
+
+  template<typename T>
+    inline bool
+    operator>(basic_handle<T> a, basic_handle<T> b) { return b < a; }
+
+  template<typename T>
+    inline bool
+    operator<=(basic_handle<T> a, basic_handle<T> b) { return !(b < a); }
+
+  template<typename T>
+    inline bool
+    operator>=(basic_handle<T> a, basic_handle<T> b) { return !(a < b); }
+
+  // The default handle type.
+  using handle = basic_handle<>;
 
 
   // ------------------------------------------------------------------------ //
@@ -83,10 +123,13 @@ namespace origin
   //
   // A vertex handle is a handle specifically for graph vertices. It is
   // the same as a normal handle in every way except its type.
-  struct vertex_handle : handle
-  {
-    using handle::handle;
-  };
+  template<typename T = std::size_t>
+    struct basic_vertex_handle : basic_handle<T>
+    {
+      using basic_handle<T>::basic_handle;
+    };
+
+  using vertex_handle = basic_vertex_handle<>;
 
 
   // ------------------------------------------------------------------------ //
@@ -97,10 +140,13 @@ namespace origin
   // data structures. More frequently, edge handles are source/target pairs
   // or source/target/edge triples. See simple_edge_handle and multi_edge_handle
   // for details.
-  struct edge_handle : handle
-  {
-    using handle::handle;
-  };
+  template<typename T = std::size_t>
+    struct basic_edge_handle : basic_handle<T>
+    {
+      using basic_handle<T>::basic_handle;
+    };
+
+  using edge_handle = basic_edge_handle<>;
 
 
   // ------------------------------------------------------------------------ //
@@ -118,79 +164,86 @@ namespace origin
   // A multi-edge handle is a triple, describing source and target handles,
   // along with an edge descriptor. The source and target handles are usual
   // vertex handles (i.e., indexes), but the edge component may vary based on
-  // the graph implementation. It is most often a pointer or index.
+  // the graph implementation. It is most often a pointer or index. The index
+  // type of the vertex handles is T.
   //
-  template<typename E>
+  template<typename E, typename T = std::size_t>
     struct multi_edge_handle
     {
       using handle_type = E;
+      using vertex_type = basic_vertex_handle<T>;
 
       multi_edge_handle()
-        : value(vertex_handle::npos, vertex_handle::npos, E{})
+        : value(vertex_type(), vertex_type(), E{})
       { }
 
-      multi_edge_handle(vertex_handle s, vertex_handle t, E e)
+      multi_edge_handle(vertex_type s, vertex_type t, E e)
         : value(s, t, e)
       { }
 
-      vertex_handle source() const { return std::get<0>(value); }
-      vertex_handle target() const { return std::get<1>(value); }
+      vertex_type source() const { return std::get<0>(value); }
+      vertex_type target() const { return std::get<1>(value); }
       handle_type edge() const { return std::get<2>(value); }
 
       // Hashable
       std::size_t hash() const;
 
-      std::tuple<vertex_handle, vertex_handle, E> value;
+      std::tuple<vertex_type, vertex_type, E> value;
     };
 
-  template<typename E>
+  template<typename E, typename T>
     inline std::size_t
-    multi_edge_handle<E>::hash() const
+    multi_edge_handle<E, T>::hash() const
     {
-      // FIXME: Stop using GCC internal functions for hashing.
-      return std::_Hash_bytes(&value, sizeof(value), 0);
+      return hash_values(source().value, target().value, edge());
     }
 
   // Equality
-  template<typename E>
+  template<typename E, typename T>
     inline bool
-    operator==(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator==(const multi_edge_handle<E, T>& a,
+               const multi_edge_handle<E, T>& b)
     {
       return a.value == b.value;
     }
 
-  template<typename E>
+  template<typename E, typename T>
     inline bool
-    operator!=(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator!=(const multi_edge_handle<E, T>& a,
+               const multi_edge_handle<E, T>& b)
     {
       return !(a == b);
     }
 
   // Ordering
-  template<typename E>
+  template<typename E, typename T>
     inline bool
-    operator<(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator<(const multi_edge_handle<E, T>& a,
+              const multi_edge_handle<E, T>& b)
     {
       return a.value < b.value;
     }
 
-  template<typename E>
+  template<typename E, typename T>
     inline bool
-    operator>(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator>(const multi_edge_handle<E, T>& a,
+              const multi_edge_handle<E, T>& b)
     {
       return b < a;
     }
 
-  template<typename E>
+  template<typename E, typename T>
     inline bool
-    operator<=(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator<=(const multi_edge_handle<E, T>& a,
+               const multi_edge_handle<E, T>& b)
     {
       return !(b < a);
     }
 
-  template<typename E>
+  template<typename E, typename T>
     inline bool
-    operator>=(const multi_edge_handle<E>& a, const multi_edge_handle<E>& b)
+    operator>=(const multi_edge_handle<E, T>& a,
+               const multi_edge_handle<E, T>& b)
     {
       return !(a < b);
     }
@@ -199,21 +252,31 @@ namespace origin
 } // namespace origin
 
 
-// Natively support the standard hashing protocol for vertex handles.
+// Natively support the standard hashing protocol for handles.
 namespace std 
 {
-  template<>
-    struct hash<origin::vertex_handle>
+  template<typename T>
+    struct hash<origin::basic_vertex_handle<T>>
     {
       std::size_t 
-      operator()(origin::vertex_handle x) const { return x.hash(); }
+      operator()(origin::basic_vertex_handle<T> x) const { return x.hash(); }
+    };
+
+  template<typename T>
+    struct hash<origin::basic_edge_handle<T>>
+    {
+      std::size_t
+      operator()(origin::basic_edge_handle<T> x) const { return x.hash(); }
     };
 
-  template<typename E>
-    struct hash<origin::multi_edge_handle<E>>
+  template<typename E, typename T>
+    struct hash<origin::multi_edge_handle<E, T>>
     {
       std::size_t 
-      operator()(const origin::multi_edge_handle<E>& h) { return h.hash(); }
+      operator()(const origin::multi_edge_handle<E, T>& h) const
+      {
+        return h.hash();
+      }
     };
 
 } // namespace std
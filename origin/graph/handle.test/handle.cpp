@@ -6,7 +6,10 @@
 // and conditions.
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <unordered_set>
 #include <vector>
 
 #include <origin/graph/handle.hpp>
@@ -61,6 +64,62 @@ template<typename H>
     assert(f(a) == 3);
   }
 
+// Check that handles of the index type T are compact, and that invalid
+// handles are distinct from valid ones.
+template<typename T>
+  void check_compact()
+  {
+    using V = basic_vertex_handle<T>;
+    using E = basic_edge_handle<T>;
+    static_assert(sizeof(V) == sizeof(T), "");
+    static_assert(sizeof(E) == sizeof(T), "");
+
+    V a;
+    V b = 0;
+    assert(!a);
+    assert(b);
+    assert(T(a) == T(-1));
+    assert(b < a || !a);
+
+    unordered_set<V> vs {V(0), V(1), V(1)};
+    assert(vs.size() == 2);
+    unordered_set<E> es {E(2), E(3)};
+    assert(es.count(E(3)) == 1);
+
+    using M = multi_edge_handle<E, T>;
+    static_assert(sizeof(M) == 3 * sizeof(T), "");
+    M m(V(0), V(1), E(2));
+    assert(m.source() == V(0));
+    assert(m.target() == V(1));
+    assert(m == M(V(0), V(1), E(2)));
+    assert(!M().source());
+    unordered_set<M> ms {m, m};
+    assert(ms.size() == 1);
+  }
+
+// Handles are hashed by mixing their indexes, and multi-edge handles by
+// combining the hashes of their components.
+template<typename T>
+  void check_hash()
+  {
+    using V = basic_vertex_handle<T>;
+    using E = basic_edge_handle<T>;
+    using M = multi_edge_handle<E, T>;
+    hash<V> hv;
+    assert(hv(V(1)) == hash_mix(1) && (hv(V(1)) >> 32) != (hv(V(2)) >> 32));
+    assert(hash<E>()(E(1)) == hv(V(1)));
+
+    M m(V(0), V(1), E(2));
+    assert(hash<M>()(m) == hash<M>()(M(V(0), V(1), E(2))));
+    assert(hash<M>()(m) != hash<M>()(M(V(1), V(0), E(2))));
+    assert(hash<M>()(m) != hash<M>()(M(V(0), V(1), E(3))));
+
+    vector<V> vs {V(0), V(1), V(2)};
+    vector<size_t> hs;
+    hash_each(vs, back_inserter(hs));
+    assert(hs.size() == 3 && hs[2] == hv(V(2)));
+  }
+
 // Support for testing conversions.
 void fv(vertex_handle v) { }
 void fe(edge_handle e) { }
@@ -75,6 +134,15 @@ int main()
   check_ord<vertex_handle>();
   check_interop<vertex_handle>();
 
+  check_eq<basic_vertex_handle<uint32_t>>();
+  check_ord<basic_vertex_handle<uint32_t>>();
+  check_interop<basic_vertex_handle<uint32_t>>();
+  check_conv<basic_vertex_handle<uint32_t>>();
+
+  check_compact<size_t>();
+  check_compact<uint32_t>();
+  check_hash<size_t>();
+  check_hash<uint32_t>();
 
   // I don't know if this is good or not.
   handle a = 3;
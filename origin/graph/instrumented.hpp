@@ -0,0 +1,145 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_INSTRUMENTED_HPP
+#define ORIGIN_GRAPH_INSTRUMENTED_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/instrument/histogram.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                        [graph.instrumented]
+  //                           Instrumented Graphs
+  //
+  // An instrumented graph is a graph of type G whose mutating operations
+  // record their latencies in histograms (see [instrument.histogram]), one
+  // for each kind of operation:
+  //
+  //    add_vertex      add_vertex and emplace_vertex
+  //    add_edge        add_edge and emplace_edge
+  //    remove_edge     remove_edge, of an edge or of the edge (u, v)
+  //    remove_vertex   remove_vertex, including the removal of its edges
+  //
+  // The tail of these distributions shows the costs that the mean hides:
+  // the removal of an edge from long incidence lists, and the reuse of the
+  // free indexes of the vertex and edge pools. For example:
+  //
+  //    instrumented_graph<directed_adjacency_list<>> g;
+  //    ...
+  //    write_latency_summaries(std::cout, g.latency_summaries());
+  //    write_latency_summaries(file, g.latency_summaries(),
+  //                            instrument_format::prometheus);
+  //
+  // An instrumented graph is otherwise the same as a G: every other
+  // operation, including the bulk loader and the removal of several edges
+  // at once, is that of G and is not timed. Each timed operation reads the
+  // steady clock twice, which adds some tens of nanoseconds to it, so the
+  // latencies are those of the operation and these reads.
+  struct mutation_latencies
+  {
+    latency_histogram add_vertex;
+    latency_histogram add_edge;
+    latency_histogram remove_edge;
+    latency_histogram remove_vertex;
+  };
+
+  template<typename G>
+    class instrumented_graph : public G
+    {
+    public:
+      using G::G;
+
+      instrumented_graph() = default;
+
+      // Mutation latencies
+      mutation_latencies&       latencies()       { return lat_; }
+      const mutation_latencies& latencies() const { return lat_; }
+
+      // Returns the summaries of the latencies, named prefix.add_vertex,
+      // prefix.add_edge, prefix.remove_edge and prefix.remove_vertex.
+      std::vector<latency_summary>
+      latency_summaries(const std::string& prefix = "graph") const
+      {
+        return {summarize(prefix + ".add_vertex", lat_.add_vertex),
+                summarize(prefix + ".add_edge", lat_.add_edge),
+                summarize(prefix + ".remove_edge", lat_.remove_edge),
+                summarize(prefix + ".remove_vertex", lat_.remove_vertex)};
+      }
+
+      // Remove the recorded latencies.
+      void reset_latencies()
+      {
+        lat_.add_vertex.reset();
+        lat_.add_edge.reset();
+        lat_.remove_edge.reset();
+        lat_.remove_vertex.reset();
+      }
+
+      // Vertex set
+      template<typename... Args>
+        auto add_vertex(Args&&... args)
+          -> decltype(std::declval<G&>().add_vertex(std::declval<Args>()...))
+        {
+          latency_timer t(lat_.add_vertex);
+          return G::add_vertex(std::forward<Args>(args)...);
+        }
+
+      template<typename... Args>
+        auto emplace_vertex(Args&&... args)
+          -> decltype(std::declval<G&>().emplace_vertex(
+                        std::declval<Args>()...))
+        {
+          latency_timer t(lat_.add_vertex);
+          return G::emplace_vertex(std::forward<Args>(args)...);
+        }
+
+      template<typename... Args>
+        auto remove_vertex(Args&&... args)
+          -> decltype(std::declval<G&>().remove_vertex(
+                        std::declval<Args>()...))
+        {
+          latency_timer t(lat_.remove_vertex);
+          return G::remove_vertex(std::forward<Args>(args)...);
+        }
+
+      // Edge set
+      template<typename... Args>
+        auto add_edge(Args&&... args)
+          -> decltype(std::declval<G&>().add_edge(std::declval<Args>()...))
+        {
+          latency_timer t(lat_.add_edge);
+          return G::add_edge(std::forward<Args>(args)...);
+        }
+
+      template<typename... Args>
+        auto emplace_edge(Args&&... args)
+          -> decltype(std::declval<G&>().emplace_edge(std::declval<Args>()...))
+        {
+          latency_timer t(lat_.add_edge);
+          return G::emplace_edge(std::forward<Args>(args)...);
+        }
+
+      template<typename... Args>
+        auto remove_edge(Args&&... args)
+          -> decltype(std::declval<G&>().remove_edge(std::declval<Args>()...))
+        {
+          latency_timer t(lat_.remove_edge);
+          return G::remove_edge(std::forward<Args>(args)...);
+        }
+
+    private:
+      mutation_latencies lat_;
+    };
+
+} // namespace origin
+
+#endif
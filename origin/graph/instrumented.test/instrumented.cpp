@@ -0,0 +1,64 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <origin/graph/instrumented.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+using namespace std;
+using namespace origin;
+
+template<typename G>
+  void
+  check_mutations()
+  {
+    instrumented_graph<G> g;
+    auto u = g.add_vertex();
+    auto v = g.add_vertex();
+    auto w = g.emplace_vertex();
+    auto e = g.add_edge(u, v);
+    g.add_edge(v, w);
+    g.emplace_edge(w, u);
+    g.add_edge(u, w);
+    g.remove_edge(e);
+    g.remove_edge(v, w);
+    g.remove_vertex(w);
+    assert(g.order() == 2 && g.size() == 0);
+
+    const mutation_latencies& l = g.latencies();
+    assert(l.add_vertex.count() == 3);
+    assert(l.add_edge.count() == 4);
+    assert(l.remove_edge.count() == 2);
+    assert(l.remove_vertex.count() == 1);
+
+    // The operations of G are not timed.
+    g.add_edges(vector<pair<size_t, size_t>> {{0, 1}, {1, 0}});
+    g.remove_edges();
+    assert(l.add_edge.count() == 4 && l.remove_edge.count() == 2);
+
+    vector<latency_summary> ss = g.latency_summaries("g");
+    assert(ss.size() == 4);
+    assert(ss[1].name == "g.add_edge" && ss[1].count == 4);
+    assert(ss[1].max >= ss[1].p99 && ss[1].p99 >= ss[1].p50);
+
+    ostringstream os;
+    write_latency_summaries(os, ss, instrument_format::prometheus);
+    assert(os.str().find("site=\"g.remove_vertex\"") != string::npos);
+
+    g.reset_latencies();
+    assert(g.latencies().add_vertex.count() == 0);
+  }
+
+int main()
+{
+  check_mutations<directed_adjacency_list<>>();
+  check_mutations<undirected_adjacency_list<>>();
+}
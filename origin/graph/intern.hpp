@@ -0,0 +1,394 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_INTERN_HPP
+#define ORIGIN_GRAPH_INTERN_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/data/flat_hash/flat_hash_map.hpp>
+#include <origin/sequence/random.hpp>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/handle.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                              [graph.intern]
+  //                          Vertex Interning
+  //
+  // Graphs read from external sources usually name their vertices by
+  // external ids (strings, 64-bit ids, etc.) rather than by dense indexes.
+  // A vertex interner maps each distinct id to a dense vertex handle, in
+  // the order in which the ids are first interned, and keeps the reverse
+  // mapping as a flat array of ids indexed by handle:
+  //
+  //    vertex_interner<std::string> ids;
+  //    vertex_handle u = ids.intern("alice");  // 0
+  //    vertex_handle v = ids.intern("bob");    // 1
+  //    ids.intern("alice");                    // 0 again
+  //    ids.key(v);                             // "bob"
+  //
+  // The forward mapping is split into shards, which are flat hash maps
+  // selected by the high bits of a hash of the key that is mixed
+  // differently from the hash used within each map. Bulk interning,
+  // ids.intern(first, last), interns a random-access sequence of keys in
+  // parallel and returns their handles:
+  //
+  //    1. The positions of the keys are bucketed by shard, in parallel
+  //       over blocks of the input.
+  //    2. Each shard interns its keys in order of position, in parallel
+  //       over the shards, numbering its new keys from 0.
+  //    3. A prefix sum over the numbers of new keys in each shard gives the
+  //       first handle of each shard's new keys.
+  //    4. The provisional numbers are replaced by handles, in parallel over
+  //       the shards, and the new keys are appended to the reverse mapping.
+  //
+  // The new keys of a bulk interning are numbered by shard and then by
+  // first occurrence, so their handles are dense but are not in order of
+  // first occurrence. They do not depend on the number of threads.
+  //
+  // The interner is tied to the bulk loaders (see graph.bulk) by
+  // add_interned_edges(g, ids, r), which interns the endpoints of the edge
+  // descriptions in r, whose first two elements are ids, adds a vertex to g
+  // for each new id, and adds the edges with g.add_edges.
+  //
+  // Template parameters:
+  //    K -- The key type
+  //    H -- The hash function of keys
+  //    E -- The key equality
+  //
+  // An interner is not thread-safe: calls of intern(k) must not overlap
+  // each other or a bulk interning. The parallelism of a bulk interning is
+  // internal to the call.
+
+  namespace intern_impl
+  {
+    // The number of shards of an interner is 2^shard_bits.
+    constexpr int shard_bits = 6;
+    constexpr std::size_t shard_count = std::size_t(1) << shard_bits;
+
+    // The number of keys in each block of a bulk interning.
+    constexpr std::size_t intern_grain = std::size_t(1) << 14;
+
+    // The flag marking a provisional number during a bulk interning.
+    constexpr std::size_t provisional = ~(~std::size_t(0) >> 1);
+
+    // Returns the shard of a key whose hash is h. The hash is mixed with a
+    // different constant than the hash of the maps, so that the keys of a
+    // shard are spread over the slots of its map.
+    inline std::size_t
+    shard_of(std::size_t h)
+    {
+      std::uint64_t x = random_impl::mix(h ^ 0x9e3779b97f4a7c15ull);
+      return std::size_t(x >> (64 - shard_bits));
+    }
+
+    // The number of blocks of n keys.
+    inline std::size_t
+    blocks(std::size_t n)
+    {
+      return (n + intern_grain - 1) / intern_grain;
+    }
+
+  } // namespace intern_impl
+
+
+  template<typename K,
+           typename H = std::hash<K>,
+           typename E = std::equal_to<K>>
+    class vertex_interner
+    {
+      using map_type = flat_hash_map<K, std::size_t, H, E>;
+    public:
+      using key_type = K;
+
+      vertex_interner(const H& hash = H(), const E& eq = E());
+
+      // Properties
+      std::size_t size() const { return keys_.size(); }
+      bool empty() const { return keys_.empty(); }
+
+      // Returns the handle of k, interning k if it is new.
+      vertex_handle intern(const K& k);
+
+      // Intern each key in [first, last), a random-access range, using up
+      // to threads threads, and return their handles.
+      template<typename I>
+        std::vector<std::size_t> intern(I first, I last,
+                                        std::size_t threads = search_threads());
+
+      // Intern the n keys at(0), ..., at(n - 1), using up to threads
+      // threads, and return their handles.
+      template<typename F>
+        std::vector<std::size_t> intern_indexed(std::size_t n, F at,
+                                                std::size_t threads);
+
+      // Returns the handle of k, or an invalid handle if k is not interned.
+      vertex_handle find(const K& k) const;
+
+      bool contains(const K& k) const { return bool(find(k)); }
+
+      // Returns the key of v.
+      const K& key(vertex_handle v) const { return keys_[v]; }
+
+      // Returns the keys, indexed by handle.
+      const std::vector<K>& keys() const { return keys_; }
+
+      void reserve(std::size_t n);
+      void clear();
+
+    private:
+      map_type& shard(const K& k) { return shards_[shard_index(k)]; }
+      const map_type& shard(const K& k) const
+      {
+        return shards_[shard_index(k)];
+      }
+
+      std::size_t shard_index(const K& k) const
+      {
+        return intern_impl::shard_of(hash_(k));
+      }
+
+      H hash_;
+      std::vector<map_type> shards_;
+      std::vector<K> keys_;
+    };
+
+  template<typename K, typename H, typename E>
+    vertex_interner<K, H, E>::vertex_interner(const H& hash, const E& eq)
+      : hash_(hash)
+    {
+      shards_.reserve(intern_impl::shard_count);
+      for (std::size_t s = 0; s != intern_impl::shard_count; ++s)
+        shards_.emplace_back(0, hash, eq);
+    }
+
+  template<typename K, typename H, typename E>
+    vertex_handle
+    vertex_interner<K, H, E>::intern(const K& k)
+    {
+      auto r = shard(k).try_emplace(k, keys_.size());
+      if (r.second)
+        keys_.push_back(k);
+      return r.first->second;
+    }
+
+  template<typename K, typename H, typename E>
+    vertex_handle
+    vertex_interner<K, H, E>::find(const K& k) const
+    {
+      const map_type& m = shard(k);
+      auto i = m.find(k);
+      return i == m.end() ? vertex_handle() : vertex_handle(i->second);
+    }
+
+  // Reserve space for n keys, assuming that they are spread evenly over
+  // the shards.
+  template<typename K, typename H, typename E>
+    void
+    vertex_interner<K, H, E>::reserve(std::size_t n)
+    {
+      std::size_t m = n / intern_impl::shard_count + 1;
+      for (map_type& s : shards_)
+        s.reserve(m);
+      keys_.reserve(n);
+    }
+
+  template<typename K, typename H, typename E>
+    void
+    vertex_interner<K, H, E>::clear()
+    {
+      for (map_type& s : shards_)
+        s.clear();
+      keys_.clear();
+    }
+
+  template<typename K, typename H, typename E>
+    template<typename I>
+      std::vector<std::size_t>
+      vertex_interner<K, H, E>::intern(I first, I last, std::size_t threads)
+      {
+        return intern_indexed(last - first,
+                           [first](std::size_t i) -> decltype(first[i]) {
+                             return first[i];
+                           },
+                           threads);
+      }
+
+  template<typename K, typename H, typename E>
+    template<typename F>
+      std::vector<std::size_t>
+      vertex_interner<K, H, E>::intern_indexed(std::size_t n, F at,
+                                               std::size_t threads)
+      {
+        using namespace intern_impl;
+        using search_impl::parallel_for;
+
+        // Bucket the positions by shard. Each block counts the keys of each
+        // shard, and then scatters its positions after those of the
+        // preceding blocks, so that each bucket is in order of position.
+        std::size_t b = blocks(n);
+        std::vector<unsigned char> shard(n);
+        std::vector<std::size_t> counts(b * shard_count);
+        parallel_for(b, threads, [&](std::size_t k) {
+          std::size_t* c = &counts[k * shard_count];
+          std::size_t last = std::min(n, (k + 1) * intern_grain);
+          for (std::size_t i = k * intern_grain; i != last; ++i) {
+            shard[i] = (unsigned char)shard_index(at(i));
+            ++c[shard[i]];
+          }
+        });
+        std::vector<std::size_t> bucket(shard_count + 1);
+        std::size_t sum = 0;
+        for (std::size_t s = 0; s != shard_count; ++s) {
+          bucket[s] = sum;
+          for (std::size_t k = 0; k != b; ++k) {
+            std::size_t c = counts[k * shard_count + s];
+            counts[k * shard_count + s] = sum;
+            sum += c;
+          }
+        }
+        bucket[shard_count] = sum;
+        std::vector<std::size_t> order(n);
+        parallel_for(b, threads, [&](std::size_t k) {
+          std::size_t* c = &counts[k * shard_count];
+          std::size_t last = std::min(n, (k + 1) * intern_grain);
+          for (std::size_t i = k * intern_grain; i != last; ++i)
+            order[c[shard[i]]++] = i;
+        });
+
+        // Intern the keys of each shard, numbering the new keys of the
+        // shard provisionally.
+        std::vector<std::size_t> handles(n);
+        std::vector<std::vector<std::size_t>> fresh(shard_count);
+        parallel_for(shard_count, threads, [&](std::size_t s) {
+          map_type& m = shards_[s];
+          for (std::size_t j = bucket[s]; j != bucket[s + 1]; ++j) {
+            std::size_t i = order[j];
+            std::size_t p = provisional | fresh[s].size();
+            auto r = m.try_emplace(at(i), p);
+            if (r.second)
+              fresh[s].push_back(i);
+            handles[i] = r.first->second;
+          }
+        });
+
+        // The new keys of each shard follow those of the preceding shards.
+        std::vector<std::size_t> base(shard_count);
+        sum = keys_.size();
+        for (std::size_t s = 0; s != shard_count; ++s) {
+          base[s] = sum;
+          sum += fresh[s].size();
+        }
+
+        // Replace the provisional numbers by handles.
+        parallel_for(shard_count, threads, [&](std::size_t s) {
+          map_type& m = shards_[s];
+          for (std::size_t i : fresh[s])
+            m.find(at(i))->second = base[s] + (handles[i] & ~provisional);
+          for (std::size_t j = bucket[s]; j != bucket[s + 1]; ++j) {
+            std::size_t& h = handles[order[j]];
+            if (h & provisional)
+              h = base[s] + (h & ~provisional);
+          }
+        });
+
+        keys_.reserve(sum);
+        for (std::size_t s = 0; s != shard_count; ++s)
+          for (std::size_t i : fresh[s])
+            keys_.push_back(at(i));
+        return handles;
+      }
+
+
+  namespace intern_impl
+  {
+    // Returns the description by handle of the edge from u to v described
+    // by x, an element of an object of type R, whose value is moved if R
+    // is not an lvalue reference.
+    template<typename R, typename T>
+      inline std::pair<std::size_t, std::size_t>
+      describe(T&&, std::size_t u, std::size_t v, size_constant<2>)
+      {
+        return {u, v};
+      }
+
+    template<typename R, typename T>
+      inline std::tuple<std::size_t, std::size_t,
+                        Decay<decltype(std::get<2>(std::declval<T>()))>>
+      describe(T&& x, std::size_t u, std::size_t v, size_constant<3>)
+      {
+        return std::make_tuple(
+          u, v, graph_impl::forward_element<R>(std::get<2>(x)));
+      }
+
+    // The description by handle of the elements of R.
+    template<typename R>
+      using Interned_description = decltype(describe<R>(
+        *std::begin(std::declval<R&>()), 0, 0,
+        graph_impl::Edge_description_size<
+          Decay<decltype(*std::begin(std::declval<R&>()))>>{}));
+
+  } // namespace intern_impl
+
+  // Intern the endpoints of the edge descriptions in r, a random-access
+  // range of tuple-like objects whose first two elements are keys, and
+  // return the corresponding descriptions by handle. A third element, if
+  // any, is copied into the result, or moved if r is an rvalue.
+  template<typename K, typename H, typename E, typename R>
+    std::vector<intern_impl::Interned_description<R>>
+    intern_edges(vertex_interner<K, H, E>& ids, R&& r,
+                 std::size_t threads = search_threads())
+    {
+      using D = Decay<decltype(*std::begin(r))>;
+      auto first = std::begin(r);
+      std::size_t m = std::end(r) - first;
+      std::vector<std::size_t> hs = ids.intern_indexed(
+        2 * m,
+        [first](std::size_t i) -> const K& {
+          return i % 2 ? std::get<1>(first[i / 2]) : std::get<0>(first[i / 2]);
+        },
+        threads);
+      std::vector<intern_impl::Interned_description<R>> ds;
+      ds.reserve(m);
+      for (std::size_t i = 0; i != m; ++i)
+        ds.push_back(intern_impl::describe<R>(
+          first[i], hs[2 * i], hs[2 * i + 1],
+          graph_impl::Edge_description_size<D>{}));
+      return ds;
+    }
+
+  // Intern the endpoints of the edge descriptions in r, add a vertex to g
+  // for each new key, and add the edges to g with g.add_edges. The handles
+  // of ids must be the vertices of g, so the order of g must equal the
+  // size of ids before the call.
+  template<typename G, typename K, typename H, typename E, typename R>
+    void
+    add_interned_edges(G& g, vertex_interner<K, H, E>& ids, R&& r,
+                       std::size_t threads = search_threads())
+    {
+      assert(g.order() == ids.size());
+      auto ds = intern_edges(ids, std::forward<R>(r), threads);
+      while (g.order() < ids.size())
+        g.add_vertex();
+      g.add_edges(std::move(ds));
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,117 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/intern.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns n random keys drawn from [0, range).
+vector<string>
+random_keys(size_t n, size_t range, size_t seed)
+{
+  minstd_rand gen(seed);
+  uniform_int_distribution<size_t> dist(0, range - 1);
+  vector<string> ks;
+  for (size_t i = 0; i != n; ++i)
+    ks.push_back("v" + to_string(dist(gen)));
+  return ks;
+}
+
+// Check that ids is a bijection between its keys and [0, ids.size()).
+template<typename T>
+  void
+  check_bijection(const T& ids)
+  {
+    for (size_t v = 0; v != ids.size(); ++v)
+      assert(ids.find(ids.key(v)) == v);
+  }
+
+// Check that bulk interning agrees with itself across thread counts, and
+// that the handles it returns are those of the keys.
+void
+check_bulk(size_t n, size_t range, size_t seed)
+{
+  vector<string> ks = random_keys(n, range, seed);
+  vector<string> more = random_keys(n, 2 * range, seed + 1);
+
+  vertex_interner<string> a;
+  a.intern("first");
+  vector<size_t> ha = a.intern(ks.begin(), ks.end(), 1);
+  vector<size_t> hb = a.intern(more.begin(), more.end(), 1);
+  check_bijection(a);
+  assert(a.find("first") == 0);
+  for (size_t i = 0; i != n; ++i) {
+    assert(a.key(ha[i]) == ks[i]);
+    assert(a.key(hb[i]) == more[i]);
+  }
+
+  for (size_t threads : {2, 4, 7}) {
+    vertex_interner<string> b;
+    b.intern("first");
+    assert(b.intern(ks.begin(), ks.end(), threads) == ha);
+    assert(b.intern(more.begin(), more.end(), threads) == hb);
+    assert(b.keys() == a.keys());
+  }
+
+  // Interning one key at a time yields the same sets of keys.
+  vertex_interner<string> c;
+  for (const string& k : ks)
+    c.intern(k);
+  for (const string& k : more)
+    c.intern(k);
+  assert(c.size() + 1 == a.size());
+  check_bijection(c);
+}
+
+void
+check_edges()
+{
+  using G = directed_adjacency_vector<char, int>;
+  vector<tuple<string, string, int>> es {
+    {"a", "b", 1}, {"b", "c", 2}, {"a", "c", 3}, {"c", "a", 4}
+  };
+  G g;
+  vertex_interner<string> ids;
+  add_interned_edges(g, ids, es, 2);
+  assert(g.order() == 3 && g.size() == 4);
+  for (auto e : g.edges()) {
+    auto s = ids.key(g.source(e));
+    auto t = ids.key(g.target(e));
+    bool found = false;
+    for (auto& x : es)
+      if (get<0>(x) == s && get<1>(x) == t && get<2>(x) == g(e))
+        found = true;
+    assert(found);
+  }
+
+  // The new vertices of later loads extend g.
+  vector<pair<string, string>> more {{"c", "d"}, {"d", "a"}};
+  add_interned_edges(g, ids, more);
+  assert(g.order() == 4 && g.size() == 6);
+  assert(g.out_degree(ids.find("d")) == 1);
+  assert(!ids.find("e"));
+}
+
+int main()
+{
+  for (size_t seed : {1, 2}) {
+    check_bulk(0, 10, seed);
+    check_bulk(10, 5, seed);
+    check_bulk(1000, 300, seed);
+    check_bulk(100000, 30000, seed);
+  }
+  check_edges();
+}
@@ -0,0 +1,248 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cerrno>
+#include <cstdio>
+
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <origin/memory/huge_page.hpp>
+
+#include "io.hpp"
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Mapped Files
+
+    namespace
+    {
+      // Read the n bytes of the file fd into p.
+      void
+      read_all(int fd, char* p, std::size_t n, const std::string& path)
+      {
+        std::size_t pos = 0;
+        while (pos != n) {
+          ssize_t r = ::pread(fd, p + pos, n - pos, pos);
+          if (r < 0 && errno == EINTR)
+            continue;
+          if (r <= 0)
+            throw std::system_error(r < 0 ? errno : EIO,
+                                    std::system_category(), path);
+          pos += r;
+        }
+      }
+    } // namespace
+
+    // An empty file is not mapped, since a mapping cannot have length 0.
+    // The mapping remains valid after the file is closed.
+    mapped_file::mapped_file(const std::string& path, map_mode m)
+      : data_(nullptr), size_(0), mode_(m)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+        throw std::system_error(errno, std::system_category(), path);
+
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::system_category(), path);
+      }
+
+      if (st.st_size != 0 && m == map_mode::huge_pages) {
+        std::size_t n = st.st_size;
+        char* p = static_cast<char*>(huge_allocate(n));
+        try {
+          read_all(fd, p, n, path);
+        } catch (...) {
+          huge_deallocate(p, n);
+          ::close(fd);
+          throw;
+        }
+        data_ = p;
+        size_ = n;
+      } else if (st.st_size != 0) {
+        size_ = st.st_size;
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        int err = errno;
+        if (p == MAP_FAILED) {
+          ::close(fd);
+          throw std::system_error(err, std::system_category(), path);
+        }
+        data_ = static_cast<const char*>(p);
+      }
+      ::close(fd);
+    }
+
+    mapped_file::mapped_file(mapped_file&& x)
+      : data_(x.data_), size_(x.size_), mode_(x.mode_)
+    {
+      x.data_ = nullptr;
+      x.size_ = 0;
+    }
+
+    mapped_file&
+    mapped_file::operator=(mapped_file&& x)
+    {
+      std::swap(data_, x.data_);
+      std::swap(size_, x.size_);
+      std::swap(mode_, x.mode_);
+      return *this;
+    }
+
+    mapped_file::~mapped_file()
+    {
+      if (!data_)
+        return;
+      if (mode_ == map_mode::huge_pages)
+        huge_deallocate(const_cast<char*>(data_), size_);
+      else
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+
+
+
+    // ---------------------------------------------------------------------- //
+    //                            Edge List Writers
+
+    constexpr std::size_t fd_writer::default_capacity;
+
+    fd_writer::fd_writer(int fd, std::size_t cap)
+      : fd_(fd), owned_(false), cap_(cap)
+    {
+      buf_.reserve(cap_);
+    }
+
+    fd_writer::fd_writer(const std::string& path, std::size_t cap)
+      : fd_(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666)),
+        owned_(true), cap_(cap)
+    {
+      if (fd_ < 0)
+        throw std::system_error(errno, std::system_category(), path);
+      buf_.reserve(cap_);
+    }
+
+    fd_writer::~fd_writer()
+    {
+      try {
+        flush();
+      } catch (...) { }
+      if (owned_)
+        ::close(fd_);
+    }
+
+    // Writes at least as large as the buffer bypass it.
+    void
+    fd_writer::write(const char* p, std::size_t n)
+    {
+      if (buf_.size() + n > cap_)
+        flush();
+      if (n >= cap_)
+        write_fd(p, n);
+      else
+        buf_.append(p, n);
+    }
+
+    void
+    fd_writer::flush()
+    {
+      write_fd(buf_.data(), buf_.size());
+      buf_.clear();
+    }
+
+    void
+    fd_writer::write_fd(const char* p, std::size_t n)
+    {
+      while (n != 0) {
+        ssize_t r = ::write(fd_, p, n);
+        if (r < 0 && errno == EINTR)
+          continue;
+        if (r < 0)
+          throw std::system_error(errno, std::system_category());
+        p += r;
+        n -= r;
+      }
+    }
+
+    namespace write_impl
+    {
+      const char digit_pairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+      // An ostream writes floating point values in its default format as
+      // if by printf("%.*g"), with a precision of 6.
+      void
+      put_float(std::string& s, double x)
+      {
+        char buf[32];
+        int n = std::snprintf(buf, sizeof(buf), "%g", x);
+        s.append(buf, n);
+      }
+
+      void
+      put_float(std::string& s, long double x)
+      {
+        char buf[48];
+        int n = std::snprintf(buf, sizeof(buf), "%Lg", x);
+        s.append(buf, n);
+      }
+    } // namespace write_impl
+
+
+
+    // ---------------------------------------------------------------------- //
+    //                            Edge List Readers
+
+    namespace parse_impl
+    {
+      void
+      malformed(std::size_t offset)
+      {
+        throw std::runtime_error("malformed edge list at offset "
+                                 + std::to_string(offset));
+      }
+
+      // Each boundary is moved forward to the start of the next line, so
+      // empty chunks are omitted.
+      std::vector<const char*>
+      split_lines(const char* first, const char* last, std::size_t n)
+      {
+        std::vector<const char*> bounds {first};
+        std::size_t len = last - first;
+        for (std::size_t i = 1; i < n; ++i) {
+          const char* p = first + len / n * i;
+          if (p <= bounds.back())
+            continue;
+          p = static_cast<const char*>(std::memchr(p, '\n', last - p));
+          if (!p || p + 1 == last)
+            break;
+          bounds.push_back(p + 1);
+        }
+        bounds.push_back(last);
+        return bounds;
+      }
+    } // namespace parse_impl
+
+  } // namespace io
+} // namespace origin
@@ -8,9 +8,24 @@
 #ifndef ORIGIN_GRAPH_IO_HPP
 #define ORIGIN_GRAPH_IO_HPP
 
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#include <origin/type/empty.hpp>
 #include <origin/graph/graph.hpp>
+#include <origin/graph/search.hpp>
 
 namespace origin
 {
@@ -20,7 +35,10 @@ namespace origin
     //                                                                [graph.io]
     //                              Graph I/O
     //
-    // Support for various forms of graph I/O.
+    // Support for various forms of graph I/O. The printers write graphs as
+    // text, as do the faster writers (see [graph.io.write]), and the edge
+    // list readers (see [graph.io.read]) parse them. See [graph.snapshot]
+    // for a binary format that can be loaded without parsing.
     //
     // TODO: Rewrite the operations used by this module in terms of the generic
     // graph interface.
@@ -106,6 +124,637 @@ namespace origin
         return os << g(u) << ' ' << g(v) << ' ' << g(e);
       }
 
+
+
+    // ---------------------------------------------------------------------- //
+    //                                                          [graph.io.write]
+    //                            Edge List Writers
+    //
+    // The writers produce the same text as the printers, without streams:
+    //
+    //    write_vertex_list(out, g[, threads])
+    //    write_edge_list(out, g[, threads])
+    //
+    // Values are formatted directly into large character buffers. Integers
+    // are converted two digits at a time, and floating point values are
+    // written as if by an ostream with its default precision and format.
+    // Characters and strings are copied, empty values write nothing, and
+    // values of any other type are written by their stream operator.
+    //
+    // The output out is any object with a member out.write(p, n) that writes
+    // the n characters at p, such as an ostream or an fd_writer. When the
+    // vertices or edges of g are a random access range, consecutive blocks
+    // of lines are formatted in parallel into separate buffers using up to
+    // threads threads, and the buffers are written in order; only a bounded
+    // number of blocks is formatted at a time, and their buffers are reused.
+    //
+    // An fd_writer buffers its output to a file descriptor, which it either
+    // borrows or opens from a path. The buffer is written when it reaches
+    // its capacity, when flush() is called, and when the writer is
+    // destroyed. A std::system_error is thrown if the file cannot be opened
+    // or written; errors are ignored when the writer is destroyed, so flush
+    // should be called to observe them. See io.cpp.
+
+    class fd_writer
+    {
+    public:
+      static constexpr std::size_t default_capacity = 1 << 20;
+
+      explicit fd_writer(int fd, std::size_t cap = default_capacity);
+      explicit fd_writer(const std::string& path,
+                         std::size_t cap = default_capacity);
+
+      fd_writer(const fd_writer&) = delete;
+      fd_writer& operator=(const fd_writer&) = delete;
+
+      ~fd_writer();
+
+      // Write the n characters at p.
+      void write(const char* p, std::size_t n);
+
+      // Write the buffered characters to the file.
+      void flush();
+
+      // Observers
+      int fd() const { return fd_; }
+      std::size_t capacity() const { return cap_; }
+
+    private:
+      void write_fd(const char* p, std::size_t n);
+
+    private:
+      int fd_;
+      bool owned_;
+      std::size_t cap_;
+      std::string buf_;
+    };
+
+
+    namespace write_impl
+    {
+      // The number of lines formatted into each buffer.
+      constexpr std::size_t block = 1 << 14;
+
+      // The number of buffers formatted in parallel per thread.
+      constexpr std::size_t depth = 4;
+
+      extern const char digit_pairs[201];
+
+      // Append the decimal digits of x to s.
+      inline void
+      put_digits(std::string& s, std::uint64_t x)
+      {
+        char buf[20];
+        char* p = buf + 20;
+        while (x >= 100) {
+          const char* d = digit_pairs + 2 * (x % 100);
+          x /= 100;
+          *--p = d[1];
+          *--p = d[0];
+        }
+        if (x >= 10) {
+          const char* d = digit_pairs + 2 * x;
+          *--p = d[1];
+          *--p = d[0];
+        } else {
+          *--p = char('0' + x);
+        }
+        s.append(p, buf + 20);
+      }
+
+      // Append the value of x to s, as an ostream would write it.
+      template<typename T>
+        inline Requires<Integer<T>() && Unsigned<T>()
+                        && !Same<T, unsigned char>(), void>
+        put(std::string& s, T x)
+        {
+          put_digits(s, x);
+        }
+
+      template<typename T>
+        inline Requires<Integer<T>() && Signed<T>() && !Same<T, char>()
+                        && !Same<T, signed char>(), void>
+        put(std::string& s, T x)
+        {
+          using U = Make_unsigned<T>;
+          if (x < 0) {
+            s.push_back('-');
+            put_digits(s, U(0) - U(x));
+          } else {
+            put_digits(s, U(x));
+          }
+        }
+
+      // Characters are written as characters, not as integers.
+      template<typename T>
+        inline Requires<Same<T, char>() || Same<T, signed char>()
+                        || Same<T, unsigned char>(), void>
+        put(std::string& s, T x)
+        {
+          s.push_back(char(x));
+        }
+
+      void put_float(std::string& s, double x);
+      void put_float(std::string& s, long double x);
+
+      template<typename T>
+        inline Requires<Floating_point<T>(), void>
+        put(std::string& s, T x)
+        {
+          put_float(s, x);
+        }
+
+      inline void
+      put(std::string& s, const std::string& x) { s += x; }
+
+      inline void
+      put(std::string& s, const char* x) { s += x; }
+
+      inline void
+      put(std::string&, empty_t) { }
+
+      // Values of any other type are written by their stream operator.
+      template<typename T>
+        void
+        put_stream(std::string& s, const T& x)
+        {
+          std::ostringstream os;
+          os << x;
+          s += os.str();
+        }
+
+      template<typename T>
+        inline Requires<!Integer<T>() && !Floating_point<T>()
+                        && !Same<T, std::string>() && !Same<T, empty_t>(), void>
+        put(std::string& s, const T& x)
+        {
+          put_stream(s, x);
+        }
+
+      // Append the lines written by f(s, *i) for each i in [first, last) to
+      // out. Blocks of lines are formatted in parallel if I is a random
+      // access iterator.
+      template<typename Out, typename I, typename F>
+        void
+        write_lines(Out& out, I first, I last, std::size_t threads, F f,
+                    std::random_access_iterator_tag)
+        {
+          std::size_t n = last - first;
+          std::size_t t = std::max<std::size_t>(threads, 1);
+          std::size_t blocks = (n + block - 1) / block;
+          std::vector<std::string> bufs(std::min(blocks, t * depth));
+          for (std::size_t k = 0; k < blocks; k += bufs.size()) {
+            std::size_t m = std::min(bufs.size(), blocks - k);
+            search_impl::parallel_for(m, threads, [&](std::size_t j) {
+              std::string& s = bufs[j];
+              s.clear();
+              std::size_t i = (k + j) * block;
+              I p = first + i;
+              I q = first + std::min(n, i + block);
+              for (; p != q; ++p)
+                f(s, *p);
+            });
+            for (std::size_t j = 0; j != m; ++j)
+              out.write(bufs[j].data(), bufs[j].size());
+          }
+        }
+
+      template<typename Out, typename I, typename F>
+        void
+        write_lines(Out& out, I first, I last, std::size_t, F f,
+                    std::forward_iterator_tag)
+        {
+          std::string s;
+          std::size_t i = 0;
+          for (; first != last; ++first) {
+            f(s, *first);
+            if (++i == block) {
+              out.write(s.data(), s.size());
+              s.clear();
+              i = 0;
+            }
+          }
+          out.write(s.data(), s.size());
+        }
+
+      template<typename Out, typename R, typename F>
+        inline void
+        write_lines(Out& out, const R& r, std::size_t threads, F f)
+        {
+          using I = decltype(r.begin());
+          using C = typename std::iterator_traits<I>::iterator_category;
+          write_lines(out, r.begin(), r.end(), threads, f, C{});
+        }
+
+    } // namespace write_impl
+
+
+    // Write the vertex list of g to out. Each vertex is written on a
+    // separate line.
+    template<typename Out, typename G>
+      void
+      write_vertex_list(Out& out, const G& g,
+                        std::size_t threads = search_threads())
+      {
+        write_impl::write_lines(out, g.vertices(), threads,
+                                [&g](std::string& s, Vertex<G> v) {
+          write_impl::put(s, g(v));
+          s.push_back('\n');
+        });
+      }
+
+    // Write the edge list of g to out. Each edge is written on a separate
+    // line as its source, target and value, separated by spaces.
+    template<typename Out, typename G>
+      void
+      write_edge_list(Out& out, const G& g,
+                      std::size_t threads = search_threads())
+      {
+        write_impl::write_lines(out, g.edges(), threads,
+                                [&g](std::string& s, Edge<G> e) {
+          write_impl::put(s, g(g.source(e)));
+          s.push_back(' ');
+          write_impl::put(s, g(g.target(e)));
+          s.push_back(' ');
+          write_impl::put(s, g(e));
+          s.push_back('\n');
+        });
+      }
+
+
+
+    // ---------------------------------------------------------------------- //
+    //                                                           [graph.io.file]
+    //                              Mapped Files
+    //
+    // A mapped file is a read-only memory mapping of an entire file. The
+    // contents of the file are read from disk as they are first accessed,
+    // so mapping a file is cheap regardless of its size. A std::system_error
+    // is thrown if the file cannot be opened or mapped. Mapped files can be
+    // moved but not copied. See io.cpp.
+    //
+    // A file can instead be read into memory backed by huge pages, when it
+    // will be traversed repeatedly and TLB misses outweigh the cost of
+    // reading it eagerly. See memory/huge_page.hpp.
+    enum class map_mode
+    {
+      paged,      // Pages are read from the file as they are first used
+      huge_pages  // The file is read into huge pages when it is opened
+    };
+
+    class mapped_file
+    {
+    public:
+      explicit mapped_file(const std::string& path,
+                           map_mode m = map_mode::paged);
+
+      mapped_file(mapped_file&& x);
+      mapped_file& operator=(mapped_file&& x);
+
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+
+      ~mapped_file();
+
+      // Observers
+      const char* data() const { return data_; }
+      std::size_t size() const { return size_; }
+
+      // Iterators
+      const char* begin() const { return data_; }
+      const char* end() const   { return data_ + size_; }
+
+      // Returns the way in which the file is mapped.
+      map_mode mode() const { return mode_; }
+
+    private:
+      const char* data_;
+      std::size_t size_;
+      map_mode mode_;
+    };
+
+
+
+    // ---------------------------------------------------------------------- //
+    //                                                           [graph.io.read]
+    //                            Edge List Readers
+    //
+    // An edge list is a text description of the edges of a graph, which has
+    // one edge per line. Each line holds the indexes of the source and target
+    // vertices of an edge, optionally followed by its value, separated by
+    // spaces or tabs. For example:
+    //
+    //    # A triangle
+    //    0 1 0.5
+    //    1 2 1.5
+    //    2 0 2.5
+    //
+    // Blank lines, and lines starting with '#' or '%', are ignored. Lines may
+    // end with "\r\n". This is the format written by edge_list_printer for a
+    // graph whose vertex values are their indexes.
+    //
+    // The readers are:
+    //
+    //    parse_edge_list<T>(first, last[, threads])
+    //    parse_edge_list<T>(file[, threads])
+    //    read_edge_list(g, first, last[, threads])
+    //    read_edge_list(g, file[, threads])
+    //
+    // The parse functions return a vector of edge descriptions of type T,
+    // which is either a pair of vertex indexes or a triple of vertex indexes
+    // and a value (see [graph.bulk]), in the order in which they appear in
+    // the text. The text is divided into chunks at line boundaries, and the
+    // chunks are parsed in parallel using up to threads threads. Numbers are
+    // parsed directly from the text, without streams or locales, so the
+    // input can be a mapped file. A std::runtime_error is thrown if a line
+    // cannot be parsed, or if a number is out of the range of its type.
+    //
+    // The read functions add the edges parsed from the text to g using its
+    // bulk loader, g.add_edges(r). Lines must have a value if and only if the
+    // edges of g have values. Vertexes are added to g (as if by
+    // g.add_vertex()) until every parsed index is a vertex of g, so that the
+    // vertex handles of g must be the indexes [0, g.order()).
+
+    namespace parse_impl
+    {
+      // The least number of bytes in each parsed chunk.
+      constexpr std::size_t min_chunk = 1 << 16;
+
+      // Throws an exception for malformed text at the given offset.
+      [[noreturn]] void malformed(std::size_t offset);
+
+      inline bool
+      is_blank(char c) { return c == ' ' || c == '\t'; }
+
+      inline bool
+      is_digit(char c) { return c >= '0' && c <= '9'; }
+
+      inline const char*
+      skip_blanks(const char* p, const char* last)
+      {
+        while (p != last && is_blank(*p))
+          ++p;
+        return p;
+      }
+
+      // Parse the decimal digits in [p, last) into x, accumulating in the
+      // unsigned type U. Returns the end of the digits, or nullptr if there
+      // are none or the value exceeds max.
+      template<typename U>
+        inline const char*
+        parse_digits(const char* p, const char* last, U max, U& x)
+        {
+          const char* first = p;
+          x = 0;
+          for (; p != last && is_digit(*p); ++p) {
+            U d = *p - '0';
+            if (x > (max - d) / 10)
+              return nullptr;
+            x = x * 10 + d;
+          }
+          return p == first ? nullptr : p;
+        }
+
+      // Parse an integer value from [p, last). Returns the end of the
+      // number, or nullptr if there is no number.
+      template<typename T>
+        inline Requires<Integer<T>() && Unsigned<T>(), const char*>
+        parse_field(const char* p, const char* last, T& x)
+        {
+          return parse_digits(p, last, std::numeric_limits<T>::max(), x);
+        }
+
+      template<typename T>
+        inline Requires<Integer<T>() && Signed<T>(), const char*>
+        parse_field(const char* p, const char* last, T& x)
+        {
+          using U = Make_unsigned<T>;
+          bool neg = p != last && *p == '-';
+          if (neg || (p != last && *p == '+'))
+            ++p;
+          U max = U(std::numeric_limits<T>::max()) + neg;
+          U u;
+          p = parse_digits(p, last, max, u);
+          if (p)
+            x = neg ? T(-(u - 1)) - 1 : T(u);
+          return p;
+        }
+
+      // Parse a floating point value from [p, last). Values with few
+      // significant digits and small exponents are computed directly from
+      // their digits; others are converted by strtod.
+      template<typename T>
+        Requires<Floating_point<T>(), const char*>
+        parse_field(const char* p, const char* last, T& x)
+        {
+          static const double pow10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+            1e22
+          };
+
+          // Accumulate up to 19 significant digits in m, scaled by 10^exp.
+          // Any further digits make the value inexact.
+          const char* first = p;
+          if (p != last && (*p == '-' || *p == '+'))
+            ++p;
+          std::uint64_t m = 0;
+          int digits = 0;
+          int exp = 0;
+          bool any = false;
+          bool inexact = false;
+          for (; p != last && is_digit(*p); ++p) {
+            any = true;
+            if (digits < 19) {
+              m = m * 10 + (*p - '0');
+              digits += m != 0;
+            } else {
+              ++exp;
+              inexact = true;
+            }
+          }
+          if (p != last && *p == '.') {
+            for (++p; p != last && is_digit(*p); ++p) {
+              any = true;
+              if (digits < 19) {
+                m = m * 10 + (*p - '0');
+                digits += m != 0;
+                --exp;
+              } else {
+                inexact = true;
+              }
+            }
+          }
+          if (!any)
+            return nullptr;
+          if (p != last && (*p == 'e' || *p == 'E')) {
+            int e;
+            p = parse_field(p + 1, last, e);
+            if (!p)
+              return nullptr;
+            exp += e;
+          }
+
+          // Both the significand and the power of ten are exact doubles, so
+          // their product or quotient is correctly rounded.
+          if (!inexact && m <= (std::uint64_t(1) << 53)
+              && exp >= -22 && exp <= 22) {
+            double d = double(m);
+            d = exp < 0 ? d / pow10[-exp] : d * pow10[exp];
+            x = T(*first == '-' ? -d : d);
+            return p;
+          }
+          std::string s(first, p);
+          x = T(std::strtod(s.c_str(), nullptr));
+          return p;
+        }
+
+      template<typename T>
+        inline Requires<Same<T, empty_t>(), const char*>
+        parse_field(const char* p, const char*, T&)
+        {
+          return p;
+        }
+
+      // Parse the fields of an edge description from [p, last), returning
+      // the past-the-end of the last field, or nullptr on failure.
+      template<typename T>
+        inline const char*
+        parse_fields(const char* p, const char* last, T& x, size_constant<2>)
+        {
+          p = parse_field(p, last, std::get<0>(x));
+          if (!p || p == last || !is_blank(*p))
+            return nullptr;
+          p = skip_blanks(p, last);
+          return parse_field(p, last, std::get<1>(x));
+        }
+
+      template<typename T>
+        inline const char*
+        parse_fields(const char* p, const char* last, T& x, size_constant<3>)
+        {
+          p = parse_fields(p, last, x, size_constant<2>{});
+          if (!p || p == last || !is_blank(*p))
+            return nullptr;
+          p = skip_blanks(p, last);
+          return parse_field(p, last, std::get<2>(x));
+        }
+
+      // Parse the edge descriptions in the lines of [first, last), appending
+      // them to out. The offset of first in the text is base.
+      template<typename T>
+        void
+        parse_lines(const char* first, const char* last, std::size_t base,
+                    std::vector<T>& out)
+        {
+          using Size = graph_impl::Edge_description_size<T>;
+          const char* p = first;
+          while (p != last) {
+            const char* eol = static_cast<const char*>(
+              std::memchr(p, '\n', last - p));
+            if (!eol)
+              eol = last;
+            const char* end = eol;
+            if (end != p && end[-1] == '\r')
+              --end;
+
+            const char* q = skip_blanks(p, end);
+            if (q != end && *q != '#' && *q != '%') {
+              T x;
+              q = parse_fields(q, end, x, Size{});
+              if (!q || skip_blanks(q, end) != end)
+                malformed(base + (p - first));
+              out.push_back(x);
+            }
+            p = eol == last ? last : eol + 1;
+          }
+        }
+
+      // Divide [first, last) into at most n chunks, each starting at the
+      // beginning of a line. Returns the n + 1 (or fewer) chunk boundaries.
+      std::vector<const char*>
+      split_lines(const char* first, const char* last, std::size_t n);
+
+      // Returns the type of edge descriptions read into the graph G.
+      template<typename G>
+        using Edge_value = Decay<decltype(std::declval<const G&>()(
+          std::declval<Edge<G>>()))>;
+
+      template<typename G>
+        using Edge_description = If<Same<Edge_value<G>, empty_t>(),
+          std::pair<std::size_t, std::size_t>,
+          std::tuple<std::size_t, std::size_t, Edge_value<G>>>;
+
+    } // namespace parse_impl
+
+
+    // Returns the edges described by the text in [first, last).
+    template<typename T = std::pair<std::size_t, std::size_t>>
+      std::vector<T>
+      parse_edge_list(const char* first, const char* last,
+                      std::size_t threads = search_threads())
+      {
+        std::size_t n = std::max<std::size_t>(threads, 1) * 4;
+        n = std::min(n, std::size_t(last - first) / parse_impl::min_chunk + 1);
+        std::vector<const char*> bounds =
+          parse_impl::split_lines(first, last, n);
+
+        std::vector<std::vector<T>> chunks(bounds.size() - 1);
+        search_impl::parallel_for(chunks.size(), threads, [&](std::size_t i) {
+          parse_impl::parse_lines(bounds[i], bounds[i + 1],
+                                  bounds[i] - first, chunks[i]);
+        });
+
+        if (chunks.size() == 1)
+          return std::move(chunks.front());
+        std::size_t m = 0;
+        for (const std::vector<T>& c : chunks)
+          m += c.size();
+        std::vector<T> result;
+        result.reserve(m);
+        for (std::vector<T>& c : chunks) {
+          result.insert(result.end(), c.begin(), c.end());
+          std::vector<T>().swap(c);
+        }
+        return result;
+      }
+
+    // Returns the edges described by the text of the mapped file f.
+    template<typename T = std::pair<std::size_t, std::size_t>>
+      inline std::vector<T>
+      parse_edge_list(const mapped_file& f,
+                      std::size_t threads = search_threads())
+      {
+        return parse_edge_list<T>(f.begin(), f.end(), threads);
+      }
+
+
+    // Add the edges described by the text in [first, last) to g.
+    template<typename G>
+      void
+      read_edge_list(G& g, const char* first, const char* last,
+                     std::size_t threads = search_threads())
+      {
+        using T = parse_impl::Edge_description<G>;
+        std::vector<T> es = parse_edge_list<T>(first, last, threads);
+
+        std::size_t n = 0;
+        for (const T& x : es)
+          n = std::max({n, std::get<0>(x) + 1, std::get<1>(x) + 1});
+        while (g.order() < n)
+          g.add_vertex();
+        g.add_edges(es);
+      }
+
+    // Add the edges described by the text of the mapped file f to g.
+    template<typename G>
+      inline void
+      read_edge_list(G& g, const mapped_file& f,
+                     std::size_t threads = search_threads())
+      {
+        read_edge_list(g, f.begin(), f.end(), threads);
+      }
+
   } // namespace io
 } // namespace origin
 
@@ -0,0 +1,250 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <origin/graph/io.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::io;
+
+using edge_pair = pair<size_t, size_t>;
+using weighted_edge = tuple<size_t, size_t, double>;
+
+template<typename T>
+  vector<T>
+  parse(const string& s, size_t threads = 1)
+  {
+    return parse_edge_list<T>(s.data(), s.data() + s.size(), threads);
+  }
+
+// Returns true if parsing s throws an exception.
+template<typename T>
+  bool
+  rejects(const string& s)
+  {
+    try {
+      parse<T>(s);
+    } catch (runtime_error&) {
+      return true;
+    }
+    return false;
+  }
+
+void
+check_parse()
+{
+  string s =
+    "# comment\n"
+    "0 1\n"
+    "\n"
+    "  2\t3  \r\n"
+    "% another comment\n"
+    "4 5";
+  assert((parse<edge_pair>(s) == vector<edge_pair>{{0, 1}, {2, 3}, {4, 5}}));
+  assert(parse<edge_pair>("").empty());
+
+  string w = "0 1 0.5\n1 2 -2.25\n2 0 1e3\n3 4 .125\n4 5 7\n5 6 1.5E-2\n";
+  vector<weighted_edge> es = parse<weighted_edge>(w);
+  assert(es.size() == 6);
+  assert(get<2>(es[0]) == 0.5);
+  assert(get<2>(es[1]) == -2.25);
+  assert(get<2>(es[2]) == 1000);
+  assert(get<2>(es[3]) == 0.125);
+  assert(get<2>(es[4]) == 7);
+  assert(get<2>(es[5]) == 0.015);
+
+  // Values that are not computed on the fast path.
+  es = parse<weighted_edge>("0 0 3.14159265358979323846\n0 0 1e300\n");
+  assert(get<2>(es[0]) == 3.14159265358979323846);
+  assert(get<2>(es[1]) == 1e300);
+
+  // Signed integer values.
+  using int_edge = tuple<size_t, size_t, int>;
+  vector<int_edge> is = parse<int_edge>("0 1 -2147483648\n1 2 +7\n");
+  assert(get<2>(is[0]) == -2147483647 - 1);
+  assert(get<2>(is[1]) == 7);
+
+  assert(rejects<edge_pair>("0\n"));
+  assert(rejects<edge_pair>("0 1 2\n"));
+  assert(rejects<edge_pair>("0 x\n"));
+  assert(rejects<edge_pair>("0 -1\n"));
+  assert(rejects<edge_pair>("0 99999999999999999999999\n"));
+  assert(rejects<weighted_edge>("0 1\n"));
+  assert(rejects<weighted_edge>("0 1 .\n"));
+  assert(rejects<int_edge>("0 1 2147483648\n"));
+}
+
+// Parsing in parallel yields the same edges, in the same order, as parsing
+// serially.
+void
+check_parallel()
+{
+  minstd_rand prng(42);
+  uniform_int_distribution<size_t> dist(0, 100000);
+  vector<weighted_edge> es;
+  ostringstream os;
+  os.precision(17);
+  for (int i = 0; i != 200000; ++i) {
+    weighted_edge e(dist(prng), dist(prng), dist(prng) / 4.0);
+    es.push_back(e);
+    os << get<0>(e) << ' ' << get<1>(e) << ' ' << get<2>(e) << '\n';
+    if (i % 1000 == 0)
+      os << "# checkpoint\n";
+  }
+  string s = os.str();
+  assert(parse<weighted_edge>(s, 1) == es);
+  assert(parse<weighted_edge>(s, 4) == es);
+  assert(parse<weighted_edge>(s, 7) == es);
+}
+
+// Reading the printed edge list of a graph whose vertex values are their
+// indexes yields the same graph.
+template<typename G>
+  void
+  check_read()
+  {
+    G g;
+    for (int i = 0; i != 5; ++i)
+      g.add_vertex(i);
+    g.add_edge(0, 1, 0.5);
+    g.add_edge(1, 2, 1.5);
+    g.add_edge(4, 3, 2.5);
+    g.add_edge(2, 2, 3.5);
+
+    ostringstream os;
+    os << edge_list(g);
+    string s = os.str();
+
+    G h;
+    read_edge_list(h, s.data(), s.data() + s.size(), 2);
+    assert(h.order() == 5);
+    assert(h.size() == 4);
+    for (Edge<G> e : g.edges()) {
+      Edge<G> f = h(g.source(e), g.target(e));
+      assert(f && h(f) == g(e));
+    }
+  }
+
+void
+check_mapped_file()
+{
+  const char* path = "origin.graph.io.test.txt";
+  {
+    ofstream os(path);
+    os << "0 1\n1 2\n2 0\n";
+  }
+
+  mapped_file f(path);
+  assert(f.size() == 12);
+  assert((parse_edge_list(f, 2) == vector<edge_pair>{{0, 1}, {1, 2}, {2, 0}}));
+
+  // Graphs without edge values read edge pairs.
+  directed_adjacency_list<> g;
+  read_edge_list(g, f);
+  assert(g.order() == 3);
+  assert(g.size() == 3);
+  assert(g(2, 0));
+
+  // Moving a mapped file preserves the mapping.
+  mapped_file h = std::move(f);
+  assert(h.data()[0] == '0');
+
+  // A file read into huge pages has the same contents.
+  mapped_file p(path, map_mode::huge_pages);
+  assert(p.mode() == map_mode::huge_pages);
+  assert(p.size() == h.size() && equal(p.begin(), p.end(), h.begin()));
+
+  std::remove(path);
+  try {
+    mapped_file x(path);
+    assert(false);
+  } catch (system_error&) { }
+}
+
+// The writers produce the same text as the printers, serially and in
+// parallel.
+template<typename G>
+  void
+  check_write()
+  {
+    G g;
+    minstd_rand prng(7);
+    for (int i = 0; i != 1000; ++i)
+      g.add_vertex(i - 500);
+    for (int i = 0; i != 50000; ++i)
+      g.add_edge(prng() % 1000, prng() % 1000, (int(prng() % 2001) - 1000) / 7.0);
+
+    ostringstream os;
+    os << edge_list(g);
+    string s = os.str();
+    for (size_t threads : {1, 3, 8}) {
+      ostringstream ws;
+      write_edge_list(ws, g, threads);
+      assert(ws.str() == s);
+    }
+
+    ostringstream vs, ws;
+    vs << vertex_list(g);
+    write_vertex_list(ws, g, 4);
+    assert(ws.str() == vs.str());
+  }
+
+void
+check_fd_writer()
+{
+  const char* path = "origin.graph.io.test.out";
+  directed_adjacency_vector<size_t, long> g;
+  for (size_t i = 0; i != 3; ++i)
+    g.add_vertex(i);
+  g.add_edge(0, 1, -9223372036854775807L - 1);
+  g.add_edge(1, 2, 0);
+  g.add_edge(2, 0, 1234567890123L);
+
+  // A small capacity forces writes that bypass the buffer.
+  {
+    fd_writer out(path, 8);
+    write_edge_list(out, g);
+  }
+  mapped_file f(path);
+  string s(f.begin(), f.end());
+  assert(s == "0 1 -9223372036854775808\n1 2 0\n2 0 1234567890123\n");
+
+  directed_adjacency_vector<int, long> h;
+  read_edge_list(h, f);
+  assert(h.size() == 3 && h(h(0, 1)) == g(g(0, 1)));
+  std::remove(path);
+
+  try {
+    fd_writer x("no/such/directory/file");
+    assert(false);
+  } catch (system_error&) { }
+}
+
+int main()
+{
+  check_parse();
+  check_parallel();
+  check_read<directed_adjacency_list<int, double>>();
+  check_read<undirected_adjacency_list<int, double>>();
+  check_read<directed_adjacency_vector<int, double>>();
+  check_mapped_file();
+  check_write<directed_adjacency_list<int, double>>();
+  check_write<undirected_adjacency_list<int, double>>();
+  check_write<directed_adjacency_vector<int, double>>();
+  check_write<undirected_adjacency_vector<char, float>>();
+  check_fd_writer();
+}
@@ -0,0 +1,444 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ITERATIVE_HPP
+#define ORIGIN_GRAPH_ITERATIVE_HPP
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <origin/graph/ordering.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.iterative]
+  //                          Iterative Algorithms
+  //
+  // Iterative algorithms repeatedly compute a value for each vertex from the
+  // values of its neighbors until the values converge. The following are
+  // provided:
+  //
+  //    pagerank(g, ranks[, opts])
+  //    personalized_pagerank(g, sources, ranks[, opts])
+  //    label_propagation(g, labels[, opts])
+  //
+  // Vertex values are stored in dense vectors indexed by vertex handle.
+  // Each iteration is a sweep over the vertices, in parallel over blocks of
+  // vertices, that reads the values of the previous iteration and writes
+  // those of the next. Sweeps can be performed in two modes:
+  //
+  //    - In pull mode, each vertex reads the values of the sources of its in
+  //      edges (or the neighbors of a vertex in an undirected graph). Each
+  //      value is written by a single thread.
+  //    - In push mode, each vertex adds its value to the targets of its out
+  //      edges with atomic operations. This reads the out edges, which are
+  //      often more compactly stored.
+  //
+  // All memory is allocated before the first iteration; convergence is
+  // checked by reducing the change in each block into a preallocated vector.
+  // The options of an iterative algorithm are given by an iteration_options
+  // object. If its stats member is set, the sweeps are recorded there (see
+  // [graph.traversal]): push sweeps as top-down steps, and pull sweeps as
+  // bottom-up ones.
+
+
+  // The order in which a sweep visits edges.
+  enum class sweep_mode { pull, push };
+
+  // The options of an iterative algorithm.
+  struct iteration_options
+  {
+    iteration_options()
+      : damping(0.85),
+        tolerance(1e-6),
+        max_iterations(100),
+        mode(sweep_mode::pull),
+        threads(search_threads()),
+        prefetch(search_prefetch_distance()),
+        stats(nullptr)
+    { }
+
+    double      damping;        // The PageRank damping factor
+    double      tolerance;      // The total change at convergence
+    std::size_t max_iterations; // The maximum number of sweeps
+    sweep_mode  mode;           // The order of edge traversal
+    std::size_t threads;        // The maximum number of threads
+    std::size_t prefetch;       // The prefetch distance (see [graph.prefetch])
+    traversal_stats* stats;     // The statistics of the sweeps, if any
+  };
+
+
+  namespace iterative_impl
+  {
+    // The number of vertices processed by each parallel task.
+    constexpr std::size_t grain = 1024;
+
+    // Add x to the atomic value a.
+    inline void
+    atomic_add(std::atomic<double>& a, double x)
+    {
+      double y = a.load(std::memory_order_relaxed);
+      while (!a.compare_exchange_weak(y, y + x, std::memory_order_relaxed))
+        ;
+    }
+
+    // Count a sweep over n vertices that read m edges of g in the direction
+    // d, and record it in stats if they are not null.
+    template<typename G>
+      void
+      record_sweep(const G& g, traversal_stats* stats, std::size_t n,
+                   std::uint64_t m, traversal_direction d)
+      {
+        ORIGIN_COUNT("graph.iterative.sweeps");
+        ORIGIN_COUNT_N("graph.iterative.edges", m);
+        if (!stats)
+          return;
+        stats->steps.push_back({n, m, d});
+        stats->edges += m;
+        stats->component_edges += g.size();
+        stats->vertices = n;
+      }
+
+    // The state of a PageRank computation. The teleport vector gives the
+    // probability of jumping to each vertex; it is uniform for PageRank,
+    // and concentrated on the sources for personalized PageRank.
+    template<typename G>
+      class pagerank_engine
+      {
+        using V = Vertex<G>;
+      public:
+        pagerank_engine(const G& g,
+                        std::vector<double>& ranks,
+                        std::vector<double>& teleport,
+                        const iteration_options& opts);
+
+        // Iterate until convergence, returning the number of sweeps.
+        std::size_t run();
+
+      private:
+        void pull(std::size_t k);
+        void push(std::size_t k);
+        void finish(std::size_t k);
+
+        std::size_t begin(std::size_t k) const { return k * grain; }
+        std::size_t end(std::size_t k) const
+        {
+          return std::min(verts.size(), (k + 1) * grain);
+        }
+
+      private:
+        const G& g;
+        std::vector<double>& ranks;
+        const std::vector<double>& teleport;
+        const iteration_options& opts;
+
+        std::vector<V> verts;                   // The vertices of g
+        std::vector<double> out;                // Out degree of each vertex
+        std::vector<double> share;              // Rank sent along each edge
+        std::unique_ptr<std::atomic<double>[]> sums;  // Rank received
+        std::vector<double> dangling;           // Rank of sinks, per block
+        std::vector<double> change;             // Change in rank, per block
+        std::vector<std::uint64_t> examined;    // Edges read, per block
+        double leak;                            // Total rank of sinks
+      };
+
+    template<typename G>
+      pagerank_engine<G>::pagerank_engine(const G& g,
+                                          std::vector<double>& ranks,
+                                          std::vector<double>& teleport,
+                                          const iteration_options& opts)
+        : g(g), ranks(ranks), teleport(teleport), opts(opts)
+      {
+        std::size_t n = search_impl::vertex_bound(g);
+        verts.reserve(g.order());
+        for (V v : g.vertices())
+          verts.push_back(v);
+        out.assign(n, 0);
+        for (V v : verts)
+          out[v] = search_impl::successor_degree(g, v);
+        share.assign(n, 0);
+        sums.reset(new std::atomic<double>[n]);
+        for (std::size_t i = 0; i != n; ++i)
+          sums[i].store(0, std::memory_order_relaxed);
+        std::size_t blocks = (verts.size() + grain - 1) / grain;
+        dangling.assign(blocks, 0);
+        change.assign(blocks, 0);
+        examined.assign(blocks, 0);
+
+        // Start from the teleport distribution.
+        ranks.assign(n, 0);
+        for (V v : verts)
+          ranks[v] = teleport[v];
+      }
+
+    // Compute the rank received by each vertex of block k from the sources
+    // of its in edges.
+    template<typename G>
+      void
+      pagerank_engine<G>::pull(std::size_t k)
+      {
+        using search_impl::prefetched_predecessor_edges;
+        std::uint64_t m = 0;
+        std::size_t d = opts.prefetch;
+        auto f = search_impl::prefetch_elements(share);
+        for (std::size_t i = begin(k); i != end(k); ++i) {
+          V v = verts[i];
+          double s = 0;
+          for (Edge<G> e : prefetched_predecessor_edges(g, v, d, f)) {
+            s += share[opposite(g, e, v)];
+            ++m;
+          }
+          sums[v].store(s, std::memory_order_relaxed);
+        }
+        examined[k] = m;
+      }
+
+    // Send the rank of each vertex of block k to the targets of its out
+    // edges.
+    template<typename G>
+      void
+      pagerank_engine<G>::push(std::size_t k)
+      {
+        using search_impl::prefetched_successor_edges;
+        std::uint64_t m = 0;
+        std::size_t d = opts.prefetch;
+        auto f = search_impl::prefetch_elements_for_write(sums.get());
+        for (std::size_t i = begin(k); i != end(k); ++i) {
+          V u = verts[i];
+          double x = share[u];
+          if (x != 0)
+            for (Edge<G> e : prefetched_successor_edges(g, u, d, f)) {
+              atomic_add(sums[opposite(g, e, u)], x);
+              ++m;
+            }
+        }
+        examined[k] = m;
+      }
+
+    // Compute the new ranks of the vertices of block k, and prepare their
+    // shares for the next sweep.
+    template<typename G>
+      void
+      pagerank_engine<G>::finish(std::size_t k)
+      {
+        double d = opts.damping;
+        double c = 0;
+        double z = 0;
+        for (std::size_t i = begin(k); i != end(k); ++i) {
+          V v = verts[i];
+          double s = sums[v].load(std::memory_order_relaxed);
+          double r = (1 - d + d * leak) * teleport[v] + d * s;
+          c += std::abs(r - ranks[v]);
+          ranks[v] = r;
+          sums[v].store(0, std::memory_order_relaxed);
+          if (out[v] != 0)
+            share[v] = r / out[v];
+          else
+            z += r;
+        }
+        change[k] = c;
+        dangling[k] = z;
+      }
+
+    template<typename G>
+      std::size_t
+      pagerank_engine<G>::run()
+      {
+        ORIGIN_TIME_SCOPE("graph.pagerank");
+        search_impl::stats_scope scope(opts.stats);
+        std::size_t blocks = change.size();
+        std::size_t t = opts.threads;
+        traversal_direction dir = opts.mode == sweep_mode::pull
+                                ? traversal_direction::bottom_up
+                                : traversal_direction::top_down;
+
+        // Compute the initial shares.
+        leak = 0;
+        for (V v : verts) {
+          if (out[v] != 0)
+            share[v] = ranks[v] / out[v];
+          else
+            leak += ranks[v];
+        }
+
+        std::size_t iter = 0;
+        while (iter < opts.max_iterations) {
+          ++iter;
+          if (opts.mode == sweep_mode::pull)
+            search_impl::parallel_for(blocks, t, [this](std::size_t k) {
+              pull(k);
+            });
+          else
+            search_impl::parallel_for(blocks, t, [this](std::size_t k) {
+              push(k);
+            });
+          search_impl::parallel_for(blocks, t, [this](std::size_t k) {
+            finish(k);
+          });
+
+          double c = 0;
+          std::uint64_t m = 0;
+          leak = 0;
+          for (std::size_t k = 0; k != blocks; ++k) {
+            c += change[k];
+            m += examined[k];
+            leak += dangling[k];
+          }
+          record_sweep(g, opts.stats, verts.size(), m, dir);
+          if (c <= opts.tolerance)
+            break;
+        }
+        return iter;
+      }
+
+    template<typename G>
+      std::size_t
+      pagerank(const G& g,
+               std::vector<double>& ranks,
+               std::vector<double>& teleport,
+               const iteration_options& opts)
+      {
+        static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+        if (g.null()) {
+          ranks.clear();
+          return 0;
+        }
+        pagerank_engine<G> engine(g, ranks, teleport, opts);
+        return engine.run();
+      }
+
+  } // namespace iterative_impl
+
+
+  // Compute the PageRank of each vertex of g, writing it to ranks. The
+  // ranks sum to 1. The rank of a vertex without out edges is distributed
+  // over all vertices of the graph. Returns the number of sweeps performed.
+  template<typename G>
+    std::size_t
+    pagerank(const G& g,
+             std::vector<double>& ranks,
+             const iteration_options& opts = {})
+    {
+      std::vector<double> teleport(search_impl::vertex_bound(g));
+      for (Vertex<G> v : g.vertices())
+        teleport[v] = 1.0 / g.order();
+      return iterative_impl::pagerank(g, ranks, teleport, opts);
+    }
+
+  // Compute the PageRank of each vertex of g, personalized to the vertices
+  // in the range sources: each random jump returns to one of the sources,
+  // uniformly at random. Returns the number of sweeps performed.
+  template<typename G, typename R>
+    std::size_t
+    personalized_pagerank(const G& g,
+                          const R& sources,
+                          std::vector<double>& ranks,
+                          const iteration_options& opts = {})
+    {
+      std::vector<double> teleport(search_impl::vertex_bound(g));
+      std::size_t n = 0;
+      for (Vertex<G> v : sources) {
+        teleport[v] += 1;
+        ++n;
+      }
+      assert(n != 0);
+      for (double& x : teleport)
+        x /= n;
+      return iterative_impl::pagerank(g, ranks, teleport, opts);
+    }
+
+
+  // Label each vertex of g with the label that occurs most often among
+  // itself and its neighbors (ignoring the direction of edges), writing the
+  // labels to labels. Each vertex starts with its own handle as its label,
+  // and ties are broken in favor of the least label. Labels are updated
+  // synchronously until no label changes, so that the result does not depend
+  // on the number of threads. Returns the number of sweeps performed. The
+  // tolerance, damping, and mode options are not used.
+  template<typename G>
+    std::size_t
+    label_propagation(const G& g,
+                      std::vector<std::size_t>& labels,
+                      const iteration_options& opts = {})
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using V = Vertex<G>;
+      using iterative_impl::grain;
+
+      std::vector<V> verts;
+      verts.reserve(g.order());
+      for (V v : g.vertices())
+        verts.push_back(v);
+      std::size_t bound = search_impl::vertex_bound(g);
+      labels.assign(bound, -1);
+      for (V v : verts)
+        labels[v] = v;
+      std::vector<std::size_t> next = labels;
+
+      std::size_t blocks = (verts.size() + grain - 1) / grain;
+      std::vector<std::vector<std::size_t>> scratch(blocks);
+      std::vector<char> changed(blocks);
+      std::vector<std::uint64_t> examined(blocks);
+      auto sweep = [&](std::size_t k) {
+        std::vector<std::size_t>& buf = scratch[k];
+        std::uint64_t m = 0;
+        bool c = false;
+        std::size_t end = std::min(verts.size(), (k + 1) * grain);
+        for (std::size_t i = k * grain; i != end; ++i) {
+          V v = verts[i];
+          buf.assign(1, labels[v]);
+          ordering_impl::for_neighbors(g, v, [&](V u) {
+            if (u != v)
+              buf.push_back(labels[u]);
+          });
+          m += buf.size() - 1;
+          std::sort(buf.begin(), buf.end());
+          std::size_t best = labels[v];
+          std::size_t most = 0;
+          for (std::size_t j = 0; j != buf.size(); ) {
+            std::size_t l = j;
+            while (j != buf.size() && buf[j] == buf[l])
+              ++j;
+            if (j - l > most) {
+              most = j - l;
+              best = buf[l];
+            }
+          }
+          next[v] = best;
+          c |= best != labels[v];
+        }
+        changed[k] = c;
+        examined[k] = m;
+      };
+
+      search_impl::stats_scope scope(opts.stats);
+      std::size_t iter = 0;
+      while (iter < opts.max_iterations) {
+        ++iter;
+        search_impl::parallel_for(blocks, opts.threads, sweep);
+        std::uint64_t m = 0;
+        for (std::uint64_t x : examined)
+          m += x;
+        iterative_impl::record_sweep(g, opts.stats, verts.size(), m,
+                                     traversal_direction::bottom_up);
+        labels.swap(next);
+        if (std::find(changed.begin(), changed.end(), true) == changed.end())
+          break;
+      }
+      return iter;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,182 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <set>
+
+#include <origin/graph/iterative.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the PageRank of each vertex by the definition, iterating a fixed
+// number of times.
+template<typename G>
+  vector<double>
+  reference_pagerank(const G& g, double d)
+  {
+    size_t n = g.order();
+    vector<double> r(n, 1.0 / n);
+    for (int iter = 0; iter != 200; ++iter) {
+      vector<double> s(n, 0);
+      double leak = 0;
+      for (Vertex<G> u : g.vertices()) {
+        size_t k = search_impl::successor_degree(g, u);
+        if (k == 0)
+          leak += r[u];
+        for (Edge<G> e : search_impl::successor_edges(g, u))
+          s[opposite(g, e, u)] += r[u] / k;
+      }
+      for (size_t v = 0; v != n; ++v)
+        r[v] = (1 - d) / n + d * (s[v] + leak / n);
+    }
+    return r;
+  }
+
+bool
+close(const vector<double>& a, const vector<double>& b, double eps)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i != a.size(); ++i)
+    if (abs(a[i] - b[i]) > eps)
+      return false;
+  return true;
+}
+
+template<typename G>
+  void
+  check_pagerank(const G& g)
+  {
+    vector<double> expect = reference_pagerank(g, 0.85);
+
+    iteration_options opts;
+    opts.tolerance = 1e-12;
+    opts.max_iterations = 500;
+    for (size_t t : {1, 4}) {
+      opts.threads = t;
+      vector<double> ranks;
+      opts.mode = sweep_mode::pull;
+      size_t n = pagerank(g, ranks, opts);
+      assert(n < opts.max_iterations);
+      assert(close(ranks, expect, 1e-9));
+      assert(abs(accumulate(ranks.begin(), ranks.end(), 0.0) - 1) < 1e-9);
+
+      opts.mode = sweep_mode::push;
+      pagerank(g, ranks, opts);
+      assert(close(ranks, expect, 1e-9));
+
+      // Prefetching does not change the ranks.
+      for (size_t d : {0, 1, 32}) {
+        opts.prefetch = d;
+        for (sweep_mode m : {sweep_mode::pull, sweep_mode::push}) {
+          opts.mode = m;
+          pagerank(g, ranks, opts);
+          assert(close(ranks, expect, 1e-9));
+        }
+      }
+      opts.prefetch = search_prefetch_distance();
+    }
+
+    // Each pull sweep reads the edges entering every vertex.
+    uint64_t degrees = 0;
+    for (Vertex<G> v : g.vertices())
+      degrees += search_impl::successor_degree(g, v);
+    traversal_stats st;
+    opts.stats = &st;
+    opts.mode = sweep_mode::pull;
+    vector<double> ranks;
+    size_t n = pagerank(g, ranks, opts);
+    assert(st.steps.size() == n && st.vertices == g.order());
+    assert(st.count(traversal_direction::bottom_up) == n);
+    assert(st.edges == n * degrees);
+    assert(st.component_edges == n * g.size());
+    opts.stats = nullptr;
+
+    // Iteration stops at the limit.
+    opts.max_iterations = 3;
+    assert(pagerank(g, ranks, opts) == 3);
+  }
+
+// Personalized ranks are concentrated near the sources.
+void
+check_personalized()
+{
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(6);
+  for (int i = 0; i != 5; ++i)
+    g.add_edge(i, i + 1, i);
+  g.add_edge(5, 0, 5);
+
+  vector<double> ranks;
+  vector<Vertex<G>> sources {Vertex<G>(2)};
+  iteration_options opts;
+  opts.tolerance = 1e-12;
+  opts.max_iterations = 1000;
+  personalized_pagerank(g, sources, ranks, opts);
+  assert(abs(accumulate(ranks.begin(), ranks.end(), 0.0) - 1) < 1e-9);
+  for (size_t i = 3; i != 8; ++i)
+    assert(ranks[(i - 1) % 6] > ranks[i % 6]);
+
+  vector<double> pushed;
+  opts.mode = sweep_mode::push;
+  personalized_pagerank(g, sources, pushed, opts);
+  assert(close(ranks, pushed, 1e-9));
+}
+
+// Two cliques joined by one edge are labeled with two labels.
+template<typename G>
+  void
+  check_label_propagation()
+  {
+    G g = build_n_graph<G>(12);
+    for (int i = 0; i != 6; ++i)
+      for (int j = i + 1; j != 6; ++j) {
+        g.add_edge(i, j, 0);
+        g.add_edge(i + 6, j + 6, 0);
+      }
+    g.add_edge(5, 6, 0);
+
+    vector<size_t> labels;
+    iteration_options opts;
+    opts.threads = 1;
+    size_t n = label_propagation(g, labels, opts);
+    assert(n < opts.max_iterations);
+    assert(set<size_t>(labels.begin(), labels.end()).size() == 2);
+    for (int i = 0; i != 6; ++i) {
+      assert(labels[i] == labels[0]);
+      assert(labels[i + 6] == labels[6]);
+    }
+
+    vector<size_t> parallel;
+    opts.threads = 4;
+    label_propagation(g, parallel, opts);
+    assert(parallel == labels);
+  }
+
+int main()
+{
+  using D = directed_adjacency_list<char, int>;
+  using U = undirected_adjacency_vector<char, int>;
+  check_pagerank(build_erdos_renyi_graph<D>(3000, 15000, 1));
+  check_pagerank(build_erdos_renyi_graph<U>(3000, 9000, 2));
+  check_pagerank(build_erdos_renyi_graph<directed_adjacency_vector<char, int>>(
+    2500, 2000, 3));
+  check_pagerank(compressed_graph<char, int>(
+    build_erdos_renyi_graph<D>(2000, 8000, 4)));
+  check_personalized();
+  check_label_propagation<U>();
+  check_label_propagation<D>();
+}
@@ -0,0 +1,321 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_MATCHING_HPP
+#define ORIGIN_GRAPH_MATCHING_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/coloring.hpp>
+#include <origin/graph/property.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.matching]
+  //                                Matching
+  //
+  //    bipartite_matching(g, left, mate)
+  //    parallel_maximal_matching(g, mate[, threads])
+  //
+  // A matching is a set of edges of an undirected graph, no two of which
+  // share a vertex. Matchings are written to a vertex map (see
+  // [graph.property]) holding the mate of each vertex, or the invalid
+  // vertex for a vertex that is not matched, and the algorithms return the
+  // number of matched edges. Loops are never matched.
+  //
+  // The bipartite_matching algorithm computes a maximum cardinality
+  // matching of a bipartite graph by the algorithm of Hopcroft and Karp, in
+  // O(m sqrt(n)) time. The side of each vertex is given by left, a
+  // predicate or a vertex map of bool (or char) that is true for the
+  // vertices of one side; edges between vertices of the same side are
+  // ignored. After matching greedily, each phase finds a maximal set of
+  // disjoint shortest augmenting paths: a breadth-first search from every
+  // unmatched left vertex, alternating between unmatched and matched
+  // edges, labels each left vertex by its layer, and stops at the first
+  // layer that reaches an unmatched right vertex. Augmenting paths are then
+  // followed along increasing layers by an iterative depth-first search,
+  // so that long paths do not exhaust the stack, and a vertex from which no
+  // path is found is not visited again in the phase. The layers, the
+  // search queue and the search stack are allocated once, and reused by
+  // every phase.
+  //
+  // The parallel_maximal_matching algorithm computes a maximal matching of
+  // any undirected graph, one to which no edge can be added, so that it has
+  // at least half as many edges as a maximum matching. It is meant for
+  // graphs too large for an exact matching. Each edge is given a fixed
+  // pseudo-random priority, and in each round, every unmatched vertex
+  // proposes its edge of greatest priority to an unmatched neighbor; the
+  // edges proposed by both of their endpoints are matched. The edge of
+  // greatest priority among those that remain is always matched, and in
+  // practice few rounds are needed. Because priorities are fixed, the
+  // matching is the same for any number of threads.
+
+
+  namespace matching_impl
+  {
+    constexpr std::size_t unlabeled = std::size_t(-1);
+
+    // Returns the priority of the edge between u and v.
+    inline std::uint64_t
+    priority(std::size_t u, std::size_t v)
+    {
+      if (v < u)
+        std::swap(u, v);
+      return random_impl::mix(random_impl::mix(u) ^ v);
+    }
+
+    // The state of the Hopcroft-Karp algorithm.
+    template<typename G, typename P>
+      class hopcroft_karp
+      {
+        using V = Vertex<G>;
+        using R = decltype(std::declval<const G&>().edges(std::declval<V>()));
+        using I = decltype(std::declval<R>().begin());
+
+        // A vertex of the search stack, the next of its edges to search,
+        // and the right vertex through which the path continues.
+        struct frame
+        {
+          V u;
+          I first;
+          I last;
+          V via;
+        };
+
+      public:
+        hopcroft_karp(const G& g, const P& left, vertex_map<G, V>& mate)
+          : g(g), left(left), mate(mate), layer(make_vertex_map(g, unlabeled))
+        {
+          for (V v : g.vertices())
+            if (left(v))
+              lefts.push_back(v);
+          queue.reserve(lefts.size());
+        }
+
+        std::size_t operator()();
+
+      private:
+        void greedy();
+        bool layers();
+        bool augment(V s);
+
+        // Returns the right vertex at the other end of e from u, or the
+        // invalid vertex if e does not join the sides.
+        V partner(Edge<G> e, V u) const
+        {
+          V v = opposite(g, e, u);
+          return v == u || left(v) ? V() : v;
+        }
+
+      private:
+        const G& g;
+        const P& left;
+        vertex_map<G, V>& mate;
+        vertex_map<G, std::size_t> layer;
+        std::vector<V> lefts;
+        std::vector<V> queue;
+        std::vector<frame> stack;
+        std::size_t limit;  // The layer of the shortest augmenting paths
+        std::size_t size;
+      };
+
+    // Match each left vertex with its first unmatched neighbor.
+    template<typename G, typename P>
+      void
+      hopcroft_karp<G, P>::greedy()
+      {
+        for (V u : lefts) {
+          for (Edge<G> e : g.edges(u)) {
+            V v = partner(e, u);
+            if (v && !mate[v]) {
+              mate[u] = v;
+              mate[v] = u;
+              ++size;
+              break;
+            }
+          }
+        }
+      }
+
+    // Label each left vertex by its layer in the alternating search from
+    // the unmatched left vertices. Returns true if an unmatched right vertex
+    // is reached.
+    template<typename G, typename P>
+      bool
+      hopcroft_karp<G, P>::layers()
+      {
+        layer.fill(unlabeled);
+        queue.clear();
+        for (V u : lefts) {
+          if (!mate[u]) {
+            layer[u] = 0;
+            queue.push_back(u);
+          }
+        }
+        limit = unlabeled;
+        for (std::size_t i = 0; i != queue.size(); ++i) {
+          V u = queue[i];
+          std::size_t d = layer[u] + 1;
+          if (d >= limit)
+            break;
+          for (Edge<G> e : g.edges(u)) {
+            V v = partner(e, u);
+            if (!v)
+              continue;
+            V w = mate[v];
+            if (!w) {
+              limit = d;
+            } else if (layer[w] == unlabeled) {
+              layer[w] = d;
+              queue.push_back(w);
+            }
+          }
+        }
+        return limit != unlabeled;
+      }
+
+    // Search for a shortest augmenting path from the unmatched left vertex
+    // s, and augment the matching along it. Returns true if one is found.
+    template<typename G, typename P>
+      bool
+      hopcroft_karp<G, P>::augment(V s)
+      {
+        R r = g.edges(s);
+        stack.clear();
+        stack.push_back(frame {s, r.begin(), r.end(), V()});
+        while (!stack.empty()) {
+          frame& f = stack.back();
+          if (f.first == f.last) {
+            layer[f.u] = unlabeled;
+            stack.pop_back();
+            continue;
+          }
+          V v = partner(*f.first, f.u);
+          ++f.first;
+          if (!v)
+            continue;
+          V w = mate[v];
+          std::size_t d = layer[f.u] + 1;
+          if (!w) {
+            if (d != limit)
+              continue;
+            f.via = v;
+            for (frame& x : stack) {
+              mate[x.u] = x.via;
+              mate[x.via] = x.u;
+            }
+            return true;
+          }
+          if (layer[w] == d && d < limit) {
+            f.via = v;
+            R rw = g.edges(w);
+            stack.push_back(frame {w, rw.begin(), rw.end(), V()});
+          }
+        }
+        return false;
+      }
+
+    template<typename G, typename P>
+      std::size_t
+      hopcroft_karp<G, P>::operator()()
+      {
+        size = 0;
+        greedy();
+        while (layers()) {
+          for (V u : lefts)
+            if (!mate[u] && layer[u] == 0 && augment(u))
+              ++size;
+        }
+        return size;
+      }
+
+  } // namespace matching_impl
+
+
+  // Compute a maximum matching of the bipartite graph g, whose left side is
+  // the set of vertices for which left(v) is true, writing the mate of each
+  // vertex to mate. Returns the number of matched edges.
+  template<typename G, typename P>
+    std::size_t
+    bipartite_matching(const G& g, const P& left,
+                       vertex_map<G, Vertex<G>>& mate)
+    {
+      static_assert(Undirected_graph<G>(), "");
+      mate = make_vertex_map(g, Vertex<G>());
+      matching_impl::hopcroft_karp<G, P> match(g, left, mate);
+      return match();
+    }
+
+
+  // Compute a maximal matching of g using up to threads threads, writing
+  // the mate of each vertex to mate. Returns the number of matched edges.
+  template<typename G>
+    std::size_t
+    parallel_maximal_matching(const G& g,
+                              vertex_map<G, Vertex<G>>& mate,
+                              std::size_t threads = search_threads())
+    {
+      static_assert(Undirected_graph<G>(), "");
+      using namespace coloring_impl;
+      using V = Vertex<G>;
+
+      // In each round, the proposals are written from the matching, and
+      // then the matching from the proposals, so that no entry is read
+      // while it is written.
+      mate = make_vertex_map(g, V());
+      vertex_map<G, V> proposal = make_vertex_map(g, V());
+      std::vector<V> work = ordering_impl::vertex_list(g);
+      while (!work.empty()) {
+        for_blocks(work, threads, [&](const V* first, const V* last) {
+          for (; first != last; ++first) {
+            V u = *first;
+            V best;
+            std::uint64_t p = 0;
+            for (Edge<G> e : g.edges(u)) {
+              V v = opposite(g, e, u);
+              if (v == u || mate[v])
+                continue;
+              std::uint64_t q = matching_impl::priority(u, v);
+              if (!best || p < q || (p == q && v < best)) {
+                best = v;
+                p = q;
+              }
+            }
+            proposal[u] = best;
+          }
+        });
+
+        for_blocks(work, threads, [&](const V* first, const V* last) {
+          for (; first != last; ++first) {
+            V u = *first;
+            V v = proposal[u];
+            if (v && proposal[v] == u)
+              mate[u] = v;
+          }
+        });
+
+        work = filter(work, threads, [&](V u) {
+          return !mate[u] && proposal[u];
+        });
+      }
+
+      std::size_t k = 0;
+      for (V v : g.vertices())
+        if (mate[v])
+          ++k;
+      return k / 2;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,153 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <origin/graph/matching.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using U = undirected_adjacency_vector<char, int>;
+using V = Vertex<U>;
+
+// Build a random bipartite graph with l left vertices [0, l), r right
+// vertices [l, l + r) and m edges.
+U
+build_bipartite(size_t l, size_t r, size_t m, size_t seed)
+{
+  U g = build_n_graph<U>(l + r);
+  minstd_rand prng(seed);
+  for (size_t i = 0; i != m; ++i)
+    g.add_edge(prng() % l, l + prng() % r);
+  return g;
+}
+
+// Returns the size of a maximum matching of the bipartite graph whose left
+// vertices are [0, l), found by Kuhn's augmenting path algorithm.
+size_t
+kuhn(const U& g, size_t l)
+{
+  vector<size_t> mate(g.order(), -1);
+  vector<char> seen;
+  function<bool(size_t)> augment = [&](size_t u) {
+    for (Edge<U> e : g.edges(u)) {
+      size_t v = opposite(g, e, u);
+      if (v < l || seen[v])
+        continue;
+      seen[v] = true;
+      if (mate[v] == size_t(-1) || augment(mate[v])) {
+        mate[v] = u;
+        return true;
+      }
+    }
+    return false;
+  };
+  size_t k = 0;
+  for (size_t u = 0; u != l; ++u) {
+    seen.assign(g.order(), false);
+    k += augment(u);
+  }
+  return k;
+}
+
+// The mates are symmetric and adjacent, and k edges are matched.
+template<typename G>
+  void
+  check_matching(const G& g, const vertex_map<G, Vertex<G>>& mate, size_t k)
+  {
+    size_t n = 0;
+    for (Vertex<G> v : g.vertices()) {
+      Vertex<G> u = mate[v];
+      if (!u)
+        continue;
+      ++n;
+      assert(u != v && mate[u] == v);
+      bool adjacent = false;
+      for (Edge<G> e : g.edges(v))
+        adjacent |= opposite(g, e, v) == u;
+      assert(adjacent);
+    }
+    assert(n == 2 * k);
+  }
+
+void
+check_bipartite(size_t l, size_t r, size_t m, size_t seed)
+{
+  U g = build_bipartite(l, r, m, seed);
+  vertex_map<U, V> mate;
+  size_t k = bipartite_matching(g, [l](V v) { return v < l; }, mate);
+  check_matching(g, mate, k);
+  assert(k == kuhn(g, l));
+
+  // The sides can be given by a vertex map, and swapped.
+  auto right = make_vertex_map(g, true);
+  for (size_t v = 0; v != l; ++v)
+    right[v] = false;
+  assert(bipartite_matching(g, right, mate) == k);
+  check_matching(g, mate, k);
+
+  // A maximal matching is at least half as large, and is the same for any
+  // number of threads.
+  size_t a = parallel_maximal_matching(g, mate, 1);
+  check_matching(g, mate, a);
+  assert(2 * a >= k);
+  for (Edge<U> e : g.edges())
+    assert(mate[g.source(e)] || mate[g.target(e)]);
+  vertex_map<U, V> mate4;
+  assert(parallel_maximal_matching(g, mate4, 4) == a);
+  for (V v : g.vertices())
+    assert(mate4[v] == mate[v]);
+}
+
+int main()
+{
+  for (size_t seed : {1, 2, 3}) {
+    check_bipartite(1, 1, 1, seed);
+    check_bipartite(10, 10, 15, seed);
+    check_bipartite(50, 80, 120, seed);
+    check_bipartite(300, 200, 600, seed);
+    check_bipartite(1000, 1000, 1500, seed);
+    check_bipartite(1000, 1000, 5000, seed);
+  }
+
+  // A path a - b - c - d is perfectly matched only by augmenting the
+  // greedy matching {b, c}.
+  U p = build_n_graph<U>(4);
+  p.add_edge(1, 2);
+  p.add_edge(1, 0);
+  p.add_edge(3, 2);
+  vertex_map<U, V> mate;
+  assert(bipartite_matching(p, [](V v) { return v % 2 == 1; }, mate) == 2);
+  assert(mate[0] == 1 && mate[2] == 3);
+
+  // Loops and edges within a side are never matched, and the maximal
+  // matching applies to any undirected graph, such as a triangle.
+  U t = build_n_graph<U>(3);
+  t.add_edge(0, 0);
+  t.add_edge(0, 1);
+  t.add_edge(1, 2);
+  t.add_edge(2, 0);
+  assert(bipartite_matching(t, [](V v) { return v != 2; }, mate) == 1);
+  assert(mate[2]);
+  assert(parallel_maximal_matching(t, mate) == 1);
+  check_matching(t, mate, 1);
+
+  using L = undirected_adjacency_list<char, int>;
+  L e;
+  vertex_map<L, Vertex<L>> m;
+  assert(bipartite_matching(e, [](Vertex<L>) { return true; }, m) == 0);
+  assert(parallel_maximal_matching(e, m) == 0);
+}
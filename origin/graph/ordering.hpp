@@ -0,0 +1,280 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_ORDERING_HPP
+#define ORIGIN_GRAPH_ORDERING_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.ordering]
+  //                            Vertex Orderings
+  //
+  // The vertices of a graph are numbered in the order in which they were
+  // added, so that the neighbors of a vertex are often scattered across
+  // memory. Renumbering the vertices so that adjacent vertices have nearby
+  // numbers can greatly improve the locality of graph traversals. The
+  // following operations are provided:
+  //
+  //    relabel(g, perm)
+  //    degree_ordering(g)
+  //    reverse_cuthill_mckee_ordering(g)
+  //    gorder_ordering(g[, window])
+  //
+  // A permutation is a vector p, indexed by vertex handle, such that p[v] is
+  // the new number of the vertex v. The new numbers of the vertices of g are
+  // [0, g.order()). Entries for handles that do not refer to vertices (since
+  // vertices have been removed) are size_t(-1).
+  //
+  // The ordering functions compute permutations, considering the edges of a
+  // directed graph without regard to their direction. The degree ordering
+  // numbers vertices in order of decreasing degree, which places the hubs of
+  // a skewed graph together. The reverse Cuthill-McKee ordering numbers the
+  // vertices of each component in reverse breadth-first order, visiting
+  // neighbors in order of increasing degree and starting from a vertex of
+  // least degree; it reduces the bandwidth of the adjacency matrix. The
+  // Gorder ordering (Wei et al.) greedily places next the vertex that shares
+  // the most neighbors with, or is adjacent to the most of, the last few
+  // vertices placed. It is the most expensive ordering to compute, but it
+  // gives the best locality on many real graphs.
+
+
+  namespace ordering_impl
+  {
+    // Call f(u) for each vertex adjacent to v, ignoring the direction of
+    // edges in a directed graph. A vertex adjacent through several edges
+    // is visited once for each edge.
+    template<typename G, typename F>
+      inline auto
+      for_neighbors(const G& g, Vertex<G> v, F f)
+        -> decltype(g.in_edges(v), void())
+      {
+        for (Edge<G> e : g.out_edges(v))
+          f(g.target(e));
+        for (Edge<G> e : g.in_edges(v))
+          f(g.source(e));
+      }
+
+    template<typename G, typename F>
+      inline auto
+      for_neighbors(const G& g, Vertex<G> v, F f)
+        -> decltype(g.edges(v), void())
+      {
+        for (Edge<G> e : g.edges(v))
+          f(opposite(g, e, v));
+      }
+
+    // Returns the vertices of g.
+    template<typename G>
+      std::vector<Vertex<G>>
+      vertex_list(const G& g)
+      {
+        std::vector<Vertex<G>> vs;
+        vs.reserve(g.order());
+        for (Vertex<G> v : g.vertices())
+          vs.push_back(v);
+        return vs;
+      }
+
+    // Returns the permutation that numbers the vertices in the order given
+    // by the sequence vs.
+    template<typename G>
+      std::vector<std::size_t>
+      numbering(const G& g, const std::vector<Vertex<G>>& vs)
+      {
+        std::vector<std::size_t> perm(search_impl::vertex_bound(g), -1);
+        for (std::size_t i = 0; i != vs.size(); ++i)
+          perm[vs[i]] = i;
+        return perm;
+      }
+
+  } // namespace ordering_impl
+
+
+  // Returns a copy of g in which each vertex v is numbered perm[v]. The
+  // values of vertices and edges are copied with them. The edges of the new
+  // graph are added in order of their (renumbered) source and target
+  // vertices, so that the edges of a vertex are also close together.
+  template<typename G>
+    G
+    relabel(const G& g, const std::vector<std::size_t>& perm)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using V = Vertex<G>;
+      using E = Edge<G>;
+      assert(perm.size() >= search_impl::vertex_bound(g));
+
+      std::vector<V> order(g.order());
+      for (V v : g.vertices()) {
+        assert(perm[v] < order.size());
+        order[perm[v]] = v;
+      }
+
+      std::vector<std::tuple<std::size_t, std::size_t, E>> es;
+      es.reserve(g.size());
+      for (E e : g.edges())
+        es.emplace_back(perm[g.source(e)], perm[g.target(e)], e);
+      std::stable_sort(es.begin(), es.end(),
+        [](const std::tuple<std::size_t, std::size_t, E>& a,
+           const std::tuple<std::size_t, std::size_t, E>& b)
+        {
+          return std::get<0>(a) < std::get<0>(b)
+              || (std::get<0>(a) == std::get<0>(b)
+                  && std::get<1>(a) < std::get<1>(b));
+        });
+
+      G h;
+      std::vector<V> vs;
+      vs.reserve(order.size());
+      for (V v : order)
+        vs.push_back(h.add_vertex(g(v)));
+      for (const auto& x : es)
+        h.add_edge(vs[std::get<0>(x)], vs[std::get<1>(x)], g(std::get<2>(x)));
+      return h;
+    }
+
+
+  // Returns the permutation that numbers the vertices of g in order of
+  // decreasing degree. Vertices of equal degree keep their relative order.
+  template<typename G>
+    std::vector<std::size_t>
+    degree_ordering(const G& g)
+    {
+      using V = Vertex<G>;
+      std::vector<V> vs = ordering_impl::vertex_list(g);
+      std::stable_sort(vs.begin(), vs.end(), [&g](V a, V b) {
+        return g.degree(a) > g.degree(b);
+      });
+      return ordering_impl::numbering(g, vs);
+    }
+
+
+  // Returns the reverse Cuthill-McKee permutation of the vertices of g.
+  template<typename G>
+    std::vector<std::size_t>
+    reverse_cuthill_mckee_ordering(const G& g)
+    {
+      using V = Vertex<G>;
+
+      // Start each component from its unvisited vertex of least degree.
+      std::vector<V> starts = ordering_impl::vertex_list(g);
+      std::stable_sort(starts.begin(), starts.end(), [&g](V a, V b) {
+        return g.degree(a) < g.degree(b);
+      });
+
+      std::vector<char> seen(search_impl::vertex_bound(g));
+      std::vector<V> queue;
+      queue.reserve(g.order());
+      std::vector<V> next;
+      for (V s : starts) {
+        if (seen[s])
+          continue;
+        seen[s] = true;
+        queue.push_back(s);
+        for (std::size_t i = queue.size() - 1; i != queue.size(); ++i) {
+          next.clear();
+          ordering_impl::for_neighbors(g, queue[i], [&](V v) {
+            if (!seen[v]) {
+              seen[v] = true;
+              next.push_back(v);
+            }
+          });
+          std::stable_sort(next.begin(), next.end(), [&g](V a, V b) {
+            return g.degree(a) < g.degree(b);
+          });
+          queue.insert(queue.end(), next.begin(), next.end());
+        }
+      }
+      std::reverse(queue.begin(), queue.end());
+      return ordering_impl::numbering(g, queue);
+    }
+
+
+  // Returns the Gorder permutation of the vertices of g using a window of
+  // the given size. Each vertex v placed in the window increases the score
+  // of its neighbors, and of the neighbors of its neighbors, by one for each
+  // such path; the unplaced vertex of greatest score is placed next. Scores
+  // are kept in a lazily updated priority queue. Two-hop paths through
+  // vertices of very high degree are ignored, since they relate nearly
+  // every vertex, and would make the ordering quadratic.
+  template<typename G>
+    std::vector<std::size_t>
+    gorder_ordering(const G& g, std::size_t window = 5)
+    {
+      using V = Vertex<G>;
+      std::size_t n = search_impl::vertex_bound(g);
+      std::size_t hub = std::max<std::size_t>(64, std::sqrt(double(n)));
+
+      std::vector<V> vs = ordering_impl::vertex_list(g);
+      std::vector<std::size_t> score(n);
+      std::vector<char> placed(n);
+
+      // Candidates are ordered by score, then by lower handle.
+      using entry = std::pair<std::size_t, std::size_t>;
+      auto worse = [](const entry& a, const entry& b) {
+        return a.first < b.first
+            || (a.first == b.first && a.second > b.second);
+      };
+      using entry_queue =
+        std::priority_queue<entry, std::vector<entry>, decltype(worse)>;
+      entry_queue queue(worse);
+      for (V v : vs)
+        queue.push(entry(0, v));
+
+      // Adjust the score of each vertex related to u by d.
+      auto adjust = [&](V u, int d) {
+        auto bump = [&](V v) {
+          if (!placed[v]) {
+            score[v] += d;
+            if (d > 0)
+              queue.push(entry(score[v], v));
+          }
+        };
+        ordering_impl::for_neighbors(g, u, [&](V x) {
+          bump(x);
+          if (g.degree(x) <= hub)
+            ordering_impl::for_neighbors(g, x, bump);
+        });
+      };
+
+      std::vector<V> order;
+      order.reserve(vs.size());
+      while (!queue.empty()) {
+        entry x = queue.top();
+        queue.pop();
+        V v = x.second;
+        if (placed[v])
+          continue;
+        if (x.first != score[v]) {
+          // The score has decreased since the entry was added.
+          if (x.first > score[v])
+            queue.push(entry(score[v], v));
+          continue;
+        }
+        placed[v] = true;
+        order.push_back(v);
+        adjust(v, 1);
+        if (order.size() > window)
+          adjust(order[order.size() - window - 1], -1);
+      }
+      return ordering_impl::numbering(g, order);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,176 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include <origin/graph/ordering.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns true if p numbers the vertices of g with [0, g.order()).
+template<typename G>
+  bool
+  is_numbering(const G& g, const vector<size_t>& p)
+  {
+    vector<char> used(g.order());
+    for (Vertex<G> v : g.vertices()) {
+      if (p[v] >= g.order() || used[p[v]])
+        return false;
+      used[p[v]] = true;
+    }
+    return true;
+  }
+
+// Returns the bandwidth of g: the greatest difference between the
+// endpoints of an edge.
+template<typename G>
+  size_t
+  bandwidth(const G& g)
+  {
+    size_t b = 0;
+    for (Edge<G> e : g.edges()) {
+      size_t u = g.source(e), v = g.target(e);
+      b = max(b, u < v ? v - u : u - v);
+    }
+    return b;
+  }
+
+// Returns the total difference between the endpoints of edges in g.
+template<typename G>
+  size_t
+  total_gap(const G& g)
+  {
+    size_t n = 0;
+    for (Edge<G> e : g.edges()) {
+      size_t u = g.source(e), v = g.target(e);
+      n += u < v ? v - u : u - v;
+    }
+    return n;
+  }
+
+// Returns an n by n grid whose vertices are numbered randomly.
+template<typename G>
+  G
+  build_scrambled_grid(size_t n)
+  {
+    vector<size_t> p(n * n);
+    iota(p.begin(), p.end(), 0);
+    shuffle(p.begin(), p.end(), minstd_rand(n));
+
+    G g = build_n_graph<G>(n * n);
+    for (size_t i = 0; i != n; ++i) {
+      for (size_t j = 0; j != n; ++j) {
+        if (j + 1 != n)
+          g.add_edge(p[i * n + j], p[i * n + j + 1], i);
+        if (i + 1 != n)
+          g.add_edge(p[i * n + j], p[(i + 1) * n + j], j);
+      }
+    }
+    return g;
+  }
+
+template<typename G>
+  void
+  check_relabel()
+  {
+    G g = build_n_graph<G>(4);
+    g.add_edge(0, 1, 10);
+    g.add_edge(1, 2, 20);
+    g.add_edge(3, 0, 30);
+    g.add_edge(3, 3, 40);
+
+    vector<size_t> p {2, 0, 3, 1};
+    G h = relabel(g, p);
+    assert(h.order() == 4);
+    assert(h.size() == 4);
+    for (Vertex<G> v : g.vertices())
+      assert(h(Vertex<G>(p[v])) == g(v));
+    for (Edge<G> e : g.edges()) {
+      Edge<G> f = h(Vertex<G>(p[g.source(e)]), Vertex<G>(p[g.target(e)]));
+      assert(f);
+      assert(h(f) == g(e));
+    }
+
+    // Edges are ordered by their new endpoints.
+    vector<size_t> sources;
+    for (Edge<G> e : h.edges())
+      sources.push_back(h.source(e));
+    assert(is_sorted(sources.begin(), sources.end()));
+  }
+
+template<typename G>
+  void
+  check_orderings()
+  {
+    G g = build_scrambled_grid<G>(30);
+    size_t before = bandwidth(g);
+    size_t gap = total_gap(g);
+
+    vector<size_t> p = reverse_cuthill_mckee_ordering(g);
+    assert(is_numbering(g, p));
+    G h = relabel(g, p);
+    assert(h.size() == g.size());
+    assert(bandwidth(h) <= 2 * 30);
+    assert(bandwidth(h) < before);
+
+    p = degree_ordering(g);
+    assert(is_numbering(g, p));
+    h = relabel(g, p);
+    for (size_t i = 1; i < h.order(); ++i)
+      assert(h.degree(i - 1) >= h.degree(i));
+
+    p = gorder_ordering(g);
+    assert(is_numbering(g, p));
+    h = relabel(g, p);
+    assert(h.size() == g.size());
+    assert(total_gap(h) < gap / 2);
+  }
+
+// Orderings skip the handles of removed vertices.
+void
+check_removed()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 0);
+  g.add_edge(1, 3, 1);
+  g.remove_vertex(2);
+
+  vector<size_t> p = reverse_cuthill_mckee_ordering(g);
+  assert(is_numbering(g, p));
+  assert(p[2] == size_t(-1));
+  assert(is_numbering(g, degree_ordering(g)));
+  assert(is_numbering(g, gorder_ordering(g)));
+
+  G h = relabel(g, p);
+  assert(h.order() == 3);
+  assert(h.size() == 2);
+  assert(h(Vertex<G>(p[1])) == g(Vertex<G>(1)));
+}
+
+int main()
+{
+  check_relabel<directed_adjacency_list<char, int>>();
+  check_relabel<undirected_adjacency_list<char, int>>();
+  check_relabel<directed_adjacency_vector<char, int>>();
+  check_relabel<undirected_adjacency_vector<char, int>>();
+
+  check_orderings<directed_adjacency_list<char, int>>();
+  check_orderings<undirected_adjacency_list<char, int>>();
+  check_orderings<undirected_adjacency_vector<char, int>>();
+
+  check_removed();
+}
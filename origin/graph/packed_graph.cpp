@@ -0,0 +1,319 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include "packed_graph.hpp"
+
+namespace origin
+{
+  namespace packed_graph_impl
+  {
+    void
+    encode_list(std::uint32_t v, const std::uint32_t* ns, std::size_t n,
+                std::vector<std::uint8_t>& data)
+    {
+      // Reserve the control bytes, which precede the data bytes.
+      std::size_t ctrl = data.size();
+      data.resize(ctrl + (n + 3) / 4, 0);
+
+      std::uint32_t prev = v;
+      for (std::size_t i = 0; i != n; ++i) {
+        std::uint32_t x = ns[i] - prev;
+        if (i == 0)
+          x = zigzag(std::int64_t(ns[i]) - std::int64_t(v));
+        prev = ns[i];
+
+        unsigned len = byte_length(x);
+        data[ctrl + i / 4] |= std::uint8_t((len - 1) << (2 * (i % 4)));
+        for (unsigned j = 0; j != len; ++j)
+          data.push_back(std::uint8_t(x >> (8 * j)));
+      }
+    }
+
+    void
+    packed_lists::encode(const std::vector<std::size_t>& off,
+                         const std::vector<std::uint32_t>& adj)
+    {
+      std::size_t n = off.size() - 1;
+      counts = off;
+      bytes.assign(n + 1, 0);
+      data.clear();
+      for (std::size_t v = 0; v != n; ++v) {
+        bytes[v] = data.size();
+        encode_list(v, adj.data() + off[v], off[v + 1] - off[v], data);
+      }
+      bytes[n] = data.size();
+      data.resize(data.size() + padding, 0);
+      data.shrink_to_fit();
+    }
+
+    // Entry c of the table moves the gaps of a group with control byte c
+    // into four 32-bit lanes: lane i takes the bytes of gap i, and the
+    // index Z (which has its high bit set) clears the remaining bytes.
+#define Z 0x80
+    const std::uint8_t group_shuffle[256][16] = {
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, Z, Z, Z, 3, Z, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, Z, Z, Z, 4, Z, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, Z, Z, Z, 5, Z, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, Z, Z, Z, 6, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, Z, Z, Z, 4, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, Z, Z, Z, 5, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, Z, Z, Z, 6, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, Z, Z, Z, 7, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, Z, Z, Z, 5, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, Z, Z, Z, 6, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, Z, Z, Z, 7, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, Z, Z, Z, 8, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, Z, Z, Z, 6, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, Z, Z, Z, 7, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, Z, Z, Z, 8, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, Z, Z, Z, 9, Z, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, Z, Z, 4, Z, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, Z, Z, 5, Z, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, Z, Z, 6, Z, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, Z, Z, 7, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, Z, Z, 5, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, Z, Z, 6, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, Z, Z, 7, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, Z, Z, 8, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, Z, Z, 6, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, Z, Z, 7, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, Z, Z, 8, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, Z, Z, 9, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, Z, Z, 7, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, Z, Z, 8, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, Z, Z, 9, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, Z, Z, 10, Z, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, Z, 5, Z, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, Z, 6, Z, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, Z, 7, Z, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, Z, 8, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, Z, 6, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, Z, 7, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, Z, 8, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, Z, 9, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, Z, 7, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, Z, 8, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, Z, 10, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, Z, 8, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, Z, 9, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, Z, 10, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, Z, 11, Z, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, 5, 6, Z, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, 6, 7, Z, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, 7, 8, Z, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, 8, 9, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, 6, 7, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, 7, 8, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, 8, 9, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, 9, 10, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, 7, 8, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, 8, 9, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, 9, 10, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, 10, 11, Z, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, 8, 9, Z, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, 9, 10, Z, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, 10, 11, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, Z, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, Z, Z, Z, 3, 4, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, Z, Z, Z, 4, 5, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, Z, Z, Z, 5, 6, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, Z, Z, Z, 6, 7, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, Z, Z, Z, 4, 5, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, Z, Z, Z, 5, 6, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, Z, Z, Z, 6, 7, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, Z, Z, Z, 7, 8, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, Z, Z, Z, 5, 6, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, Z, Z, Z, 6, 7, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, Z, Z, Z, 7, 8, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, Z, Z, Z, 8, 9, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, Z, Z, Z, 6, 7, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, Z, Z, Z, 7, 8, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, Z, Z, Z, 8, 9, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, Z, Z, Z, 9, 10, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, Z, Z, 4, 5, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, Z, Z, 5, 6, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, Z, Z, 6, 7, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, Z, Z, 7, 8, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, Z, Z, 5, 6, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, Z, Z, 6, 7, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, Z, Z, 7, 8, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, Z, Z, 8, 9, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, Z, Z, 6, 7, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, Z, Z, 7, 8, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, Z, Z, 8, 9, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, Z, Z, 9, 10, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, Z, Z, 7, 8, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, Z, Z, 8, 9, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, Z, Z, 9, 10, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, Z, Z, 10, 11, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, Z, 5, 6, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, Z, 6, 7, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, Z, 7, 8, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, Z, 8, 9, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, Z, 6, 7, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, Z, 7, 8, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, Z, 8, 9, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, Z, 9, 10, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, Z, 7, 8, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, Z, 8, 9, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, 10, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, Z, 10, 11, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, Z, 8, 9, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, Z, 9, 10, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, Z, 10, 11, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, Z, 11, 12, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, 5, 6, 7, Z, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, 6, 7, 8, Z, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, 7, 8, 9, Z, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, 8, 9, 10, Z, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, 6, 7, 8, Z, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, 7, 8, 9, Z, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, 8, 9, 10, Z, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, 9, 10, 11, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, 7, 8, 9, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, 8, 9, 10, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, 9, 10, 11, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, 10, 11, 12, Z, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, Z, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, Z, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, Z, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, Z, Z, Z, 3, 4, 5, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, Z, Z, Z, 4, 5, 6, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, Z, Z, Z, 5, 6, 7, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, Z, Z, Z, 6, 7, 8, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, Z, Z, Z, 4, 5, 6, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, Z, Z, Z, 5, 6, 7, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, Z, Z, Z, 6, 7, 8, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, Z, Z, Z, 7, 8, 9, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, Z, Z, Z, 5, 6, 7, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, Z, Z, Z, 6, 7, 8, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, Z, Z, Z, 7, 8, 9, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, Z, Z, Z, 8, 9, 10, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, Z, Z, Z, 6, 7, 8, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, Z, Z, Z, 7, 8, 9, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, Z, Z, Z, 8, 9, 10, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, Z, Z, Z, 9, 10, 11, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, Z, Z, 4, 5, 6, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, Z, Z, 5, 6, 7, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, Z, Z, 6, 7, 8, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, Z, Z, 7, 8, 9, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, Z, Z, 5, 6, 7, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, Z, Z, 6, 7, 8, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, Z, Z, 7, 8, 9, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, Z, Z, 8, 9, 10, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, Z, Z, 6, 7, 8, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, Z, Z, 7, 8, 9, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, Z, Z, 8, 9, 10, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, Z, Z, 9, 10, 11, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, Z, Z, 7, 8, 9, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, Z, Z, 8, 9, 10, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, Z, Z, 9, 10, 11, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, Z, Z, 10, 11, 12, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, Z, 5, 6, 7, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, Z, 6, 7, 8, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, Z, 7, 8, 9, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, Z, 8, 9, 10, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, Z, 6, 7, 8, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, Z, 7, 8, 9, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, Z, 8, 9, 10, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, Z, 9, 10, 11, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, Z, 7, 8, 9, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, Z, 8, 9, 10, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, 10, 11, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, Z, 10, 11, 12, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, Z, 8, 9, 10, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, Z, 9, 10, 11, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, Z, 10, 11, 12, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, Z, 11, 12, 13, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, 5, 6, 7, 8, Z},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, 6, 7, 8, 9, Z},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, 7, 8, 9, 10, Z},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, 8, 9, 10, 11, Z},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, 6, 7, 8, 9, Z},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, 7, 8, 9, 10, Z},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, 8, 9, 10, 11, Z},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, 9, 10, 11, 12, Z},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, 7, 8, 9, 10, Z},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, 8, 9, 10, 11, Z},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, 9, 10, 11, 12, Z},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, 10, 11, 12, 13, Z},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, Z},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, Z},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, Z},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, Z, Z, Z, 3, 4, 5, 6},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, Z, Z, Z, 4, 5, 6, 7},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, Z, Z, Z, 5, 6, 7, 8},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, Z, Z, Z, 6, 7, 8, 9},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, Z, Z, Z, 4, 5, 6, 7},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, Z, Z, Z, 5, 6, 7, 8},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, Z, Z, Z, 6, 7, 8, 9},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, Z, Z, Z, 7, 8, 9, 10},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, Z, Z, Z, 5, 6, 7, 8},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, Z, Z, Z, 6, 7, 8, 9},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, Z, Z, Z, 7, 8, 9, 10},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, Z, Z, Z, 8, 9, 10, 11},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, Z, Z, Z, 6, 7, 8, 9},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, Z, Z, Z, 7, 8, 9, 10},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, Z, Z, Z, 8, 9, 10, 11},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, Z, Z, Z, 9, 10, 11, 12},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, Z, Z, 4, 5, 6, 7},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, Z, Z, 5, 6, 7, 8},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, Z, Z, 6, 7, 8, 9},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, Z, Z, 7, 8, 9, 10},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, Z, Z, 5, 6, 7, 8},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, Z, Z, 6, 7, 8, 9},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, Z, Z, 7, 8, 9, 10},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, Z, Z, 8, 9, 10, 11},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, Z, Z, 6, 7, 8, 9},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, Z, Z, 7, 8, 9, 10},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, Z, Z, 8, 9, 10, 11},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, Z, Z, 9, 10, 11, 12},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, Z, Z, 7, 8, 9, 10},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, Z, Z, 8, 9, 10, 11},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, Z, Z, 9, 10, 11, 12},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, Z, Z, 10, 11, 12, 13},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, Z, 5, 6, 7, 8},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, Z, 6, 7, 8, 9},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, Z, 7, 8, 9, 10},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, Z, 8, 9, 10, 11},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, Z, 6, 7, 8, 9},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, Z, 7, 8, 9, 10},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, Z, 8, 9, 10, 11},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, Z, 9, 10, 11, 12},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, Z, 7, 8, 9, 10},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, Z, 8, 9, 10, 11},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, 10, 11, 12},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, Z, 10, 11, 12, 13},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, Z, 8, 9, 10, 11},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, Z, 9, 10, 11, 12},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, Z, 10, 11, 12, 13},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, Z, 11, 12, 13, 14},
+      {0, Z, Z, Z, 1, Z, Z, Z, 2, 3, 4, 5, 6, 7, 8, 9},
+      {0, 1, Z, Z, 2, Z, Z, Z, 3, 4, 5, 6, 7, 8, 9, 10},
+      {0, 1, 2, Z, 3, Z, Z, Z, 4, 5, 6, 7, 8, 9, 10, 11},
+      {0, 1, 2, 3, 4, Z, Z, Z, 5, 6, 7, 8, 9, 10, 11, 12},
+      {0, Z, Z, Z, 1, 2, Z, Z, 3, 4, 5, 6, 7, 8, 9, 10},
+      {0, 1, Z, Z, 2, 3, Z, Z, 4, 5, 6, 7, 8, 9, 10, 11},
+      {0, 1, 2, Z, 3, 4, Z, Z, 5, 6, 7, 8, 9, 10, 11, 12},
+      {0, 1, 2, 3, 4, 5, Z, Z, 6, 7, 8, 9, 10, 11, 12, 13},
+      {0, Z, Z, Z, 1, 2, 3, Z, 4, 5, 6, 7, 8, 9, 10, 11},
+      {0, 1, Z, Z, 2, 3, 4, Z, 5, 6, 7, 8, 9, 10, 11, 12},
+      {0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, 9, 10, 11, 12, 13},
+      {0, 1, 2, 3, 4, 5, 6, Z, 7, 8, 9, 10, 11, 12, 13, 14},
+      {0, Z, Z, Z, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12},
+      {0, 1, Z, Z, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13},
+      {0, 1, 2, Z, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    };
+#undef Z
+
+  } // namespace packed_graph_impl
+
+} // namespace origin
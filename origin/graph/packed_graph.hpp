@@ -0,0 +1,553 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PACKED_GRAPH_HPP
+#define ORIGIN_GRAPH_PACKED_GRAPH_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSSE3__)
+#  include <tmmintrin.h>
+#endif
+
+#include <origin/type/empty.hpp>
+#include <origin/memory/usage.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/compressed_graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                              [graph.packed]
+  //                              Packed Graph
+  //
+  // A packed graph is an immutable directed graph whose adjacency lists are
+  // compressed. The out and in neighbors of each vertex are sorted, and each
+  // list is stored as the gaps between consecutive neighbors (the first gap
+  // is the signed difference from the vertex itself, zigzag encoded), in
+  // the Stream VByte format: each group of four gaps is described by a
+  // control byte holding the length, from 1 to 4 bytes, of each gap, and
+  // the gaps are stored in the fewest bytes that hold them. The control
+  // bytes of a list precede its data bytes.
+  //
+  // Graphs with locality, whose neighbors have nearby indexes, need a
+  // little more than one byte per edge in each direction, a quarter of a
+  // 32-bit CSR; random graphs need about two. The offsets of the lists take
+  // two words per vertex and direction.
+  //
+  // The adjacency lists are decoded as they are traversed, four gaps at a
+  // time. When SSSE3 is available, the gaps of a group are unpacked with a
+  // single byte shuffle chosen by the control byte; otherwise they are read
+  // one by one. The neighbor ranges model the incidence ranges of the
+  // generic graph interface, so the searches and iterative algorithms run on
+  // a packed graph directly, and trade some decoding work for less memory
+  // traffic.
+  //
+  // Because an edge is not stored as an object, its handle is the pair of
+  // its endpoints, and edges have no values. Parallel edges are kept, and
+  // are distinct edges with equal handles. A packed graph is built from an
+  // existing graph, whose vertices are numbered as in a compressed graph
+  // (see [graph.compressed]), including the pairs of edges of an undirected
+  // graph. It holds fewer than 2^31 vertices; building a larger one throws
+  // std::length_error.
+
+
+  namespace packed_graph_impl
+  {
+    // The handle of an edge in a packed graph: its endpoints.
+    struct edge_pair
+    {
+      edge_pair()
+        : source(-1), target(-1)
+      { }
+
+      edge_pair(vertex_handle s, vertex_handle t)
+        : source(s), target(t)
+      { }
+
+      // Returns true if the handle refers to an edge.
+      explicit operator bool() const { return bool(source); }
+
+      vertex_handle source;
+      vertex_handle target;
+    };
+
+    inline bool
+    operator==(const edge_pair& a, const edge_pair& b)
+    {
+      return a.source == b.source && a.target == b.target;
+    }
+
+    inline bool
+    operator!=(const edge_pair& a, const edge_pair& b)
+    {
+      return !(a == b);
+    }
+
+    inline bool
+    operator<(const edge_pair& a, const edge_pair& b)
+    {
+      if (a.source != b.source)
+        return a.source < b.source;
+      return a.target < b.target;
+    }
+
+
+    // The number of bytes of padding after the data of a graph, so that a
+    // group can be loaded in a single 16-byte load.
+    constexpr std::size_t padding = 16;
+
+    inline std::uint32_t
+    zigzag(std::int64_t x)
+    {
+      return std::uint32_t((std::uint64_t(x) << 1) ^ std::uint64_t(x >> 63));
+    }
+
+    inline std::int32_t
+    unzigzag(std::uint32_t x)
+    {
+      return std::int32_t(x >> 1) ^ -std::int32_t(x & 1);
+    }
+
+    // Returns the number of bytes needed to store x.
+    inline unsigned
+    byte_length(std::uint32_t x)
+    {
+      return x < (1u << 8) ? 1 : x < (1u << 16) ? 2 : x < (1u << 24) ? 3 : 4;
+    }
+
+    // Returns the number of data bytes of a group with control byte c.
+    inline unsigned
+    group_length(std::uint8_t c)
+    {
+      return 4 + (c & 3) + ((c >> 2) & 3) + ((c >> 4) & 3) + (c >> 6);
+    }
+
+    // Append the encoding of the sorted list of neighbors ns of v to data.
+    void encode_list(std::uint32_t v, const std::uint32_t* ns, std::size_t n,
+                     std::vector<std::uint8_t>& data);
+
+    // The shuffle that unpacks each group, indexed by its control byte. See
+    // packed_graph.cpp.
+    extern const std::uint8_t group_shuffle[256][16];
+
+    // Decode the k gaps of the group with control byte c from p into out,
+    // returning the number of data bytes of the group.
+    inline unsigned
+    decode_group(std::uint8_t c, const std::uint8_t* p, std::size_t k,
+                 std::uint32_t* out)
+    {
+#if defined(__SSSE3__)
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      __m128i s = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(group_shuffle[c]));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                       _mm_shuffle_epi8(x, s));
+      (void)k;
+      return group_length(c);
+#else
+      const std::uint8_t* q = p;
+      for (std::size_t i = 0; i != k; ++i) {
+        unsigned len = ((c >> (2 * i)) & 3) + 1;
+        std::uint32_t x = 0;
+        for (unsigned j = 0; j != len; ++j)
+          x |= std::uint32_t(q[j]) << (8 * j);
+        out[i] = x;
+        q += len;
+      }
+      return unsigned(q - p);
+#endif
+    }
+
+
+    // The neighbor iterator decodes the adjacency list of a vertex, yielding
+    // its out edges when Out is true, and its in edges otherwise.
+    template<bool Out>
+      class neighbor_iterator
+      {
+      public:
+        using value_type = edge_pair;
+        using reference = edge_pair;
+        using pointer = const edge_pair*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        // Initialize an iterator past the end of a list.
+        neighbor_iterator()
+          : ctrl_(nullptr), data_(nullptr), left_(0), pos_(0), len_(0),
+            prev_(0)
+        { }
+
+        // Initialize an iterator to the list of the n neighbors of v, whose
+        // encoding starts at p.
+        neighbor_iterator(vertex_handle v, const std::uint8_t* p,
+                          std::size_t n)
+          : self_(v), ctrl_(p), data_(p + (n + 3) / 4), left_(n),
+            pos_(0), len_(0), prev_(std::uint32_t(v))
+        {
+          if (left_ != 0)
+            refill(true);
+        }
+
+        edge_pair operator*() const
+        {
+          vertex_handle u = buf_[pos_];
+          return Out ? edge_pair(self_, u) : edge_pair(u, self_);
+        }
+
+        neighbor_iterator& operator++()
+        {
+          if (++pos_ == len_) {
+            pos_ = len_ = 0;
+            if (left_ != 0)
+              refill(false);
+          }
+          return *this;
+        }
+
+        neighbor_iterator operator++(int)
+        {
+          neighbor_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        // Returns the number of neighbors not yet visited.
+        std::size_t remaining() const { return left_ + len_ - pos_; }
+
+      private:
+        // Decode the next group of gaps, and sum them. The first gap of a
+        // list is relative to the vertex itself, and may be negative; the
+        // sums are computed modulo 2^32.
+        void refill(bool first)
+        {
+          std::size_t k = std::min<std::size_t>(4, left_);
+          data_ += decode_group(*ctrl_++, data_, k, buf_);
+          if (first)
+            buf_[0] = std::uint32_t(unzigzag(buf_[0]));
+          std::uint32_t s = prev_;
+          for (std::size_t i = 0; i != k; ++i)
+            buf_[i] = s += buf_[i];
+          prev_ = s;
+          left_ -= k;
+          len_ = unsigned(k);
+        }
+
+      private:
+        vertex_handle self_;
+        const std::uint8_t* ctrl_;
+        const std::uint8_t* data_;
+        std::size_t left_;
+        unsigned pos_;
+        unsigned len_;
+        std::uint32_t prev_;
+        std::uint32_t buf_[4];
+      };
+
+    // Equality is determined by the number of neighbors left to visit.
+    template<bool Out>
+      inline bool
+      operator==(const neighbor_iterator<Out>& a,
+                 const neighbor_iterator<Out>& b)
+      {
+        return a.remaining() == b.remaining();
+      }
+
+    template<bool Out>
+      inline bool
+      operator!=(const neighbor_iterator<Out>& a,
+                 const neighbor_iterator<Out>& b)
+      {
+        return !(a == b);
+      }
+
+    template<bool Out>
+      using neighbor_range = bounded_range<neighbor_iterator<Out>>;
+
+
+    // The compressed adjacency lists of one direction: the number of
+    // neighbors of each vertex, as offsets, and the offsets of their
+    // encodings in the data array.
+    struct packed_lists
+    {
+      // Encode the sorted neighbor lists adj[off[v], off[v + 1]) of each
+      // vertex v.
+      void encode(const std::vector<std::size_t>& off,
+                  const std::vector<std::uint32_t>& adj);
+
+      std::size_t degree(std::size_t v) const
+      {
+        return counts[v + 1] - counts[v];
+      }
+
+      template<bool Out>
+        neighbor_range<Out> neighbors(vertex_handle v) const
+        {
+          using I = neighbor_iterator<Out>;
+          return {I(v, data.data() + bytes[v], degree(v)), I()};
+        }
+
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(counts) + contiguous_footprint(bytes)
+             + contiguous_footprint(data);
+      }
+
+      std::vector<std::size_t> counts;
+      std::vector<std::size_t> bytes;
+      std::vector<std::uint8_t> data;
+    };
+
+  } // namespace packed_graph_impl
+
+
+  template<typename V = empty_t>
+    class packed_graph
+    {
+      template<bool Out>
+        using neighbor_range = packed_graph_impl::neighbor_range<Out>;
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+      using edge = packed_graph_impl::edge_pair;
+      class edge_iterator;
+      using edge_range = bounded_range<edge_iterator>;
+
+      using out_edge_range = neighbor_range<true>;
+      using in_edge_range = neighbor_range<false>;
+
+
+      // Default construction
+      //
+      // Initialize an empty graph.
+      packed_graph()
+      {
+        std::vector<std::size_t> off(1, 0);
+        out_.encode(off, {});
+        in_.encode(off, {});
+      }
+
+      // Graph initialization
+      //
+      // Initialize the graph with the vertices and edges of g. The values
+      // of vertices in g are copied into the graph.
+      template<typename G>
+        explicit packed_graph(const G& g);
+
+
+      // Observers
+      bool        null() const  { return verts_.empty(); }
+      std::size_t order() const { return verts_.size(); }
+
+      bool        empty() const { return size() == 0; }
+      std::size_t size() const  { return out_.counts.back(); }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return out_.degree(v); }
+      std::size_t in_degree(vertex v) const  { return in_.degree(v); }
+      std::size_t degree(vertex v) const
+      {
+        return out_degree(v) + in_degree(v);
+      }
+
+      // Edge observers
+      vertex source(edge e) const { return e.source; }
+      vertex target(edge e) const { return e.target; }
+
+      // Data access
+      V&       operator()(vertex v)       { return verts_[v]; }
+      const V& operator()(vertex v) const { return verts_[v]; }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Returns the footprint of the arrays of the graph. See [mem.usage].
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(verts_) + out_.memory_usage()
+             + in_.memory_usage();
+      }
+
+      // Iterators
+      vertex_range   vertices() const { return {0, order()}; }
+      edge_range     edges() const;
+      out_edge_range out_edges(vertex v) const
+      {
+        return out_.neighbors<true>(v);
+      }
+      in_edge_range  in_edges(vertex v) const
+      {
+        return in_.neighbors<false>(v);
+      }
+
+    private:
+      std::vector<V> verts_;              // Vertex values
+      packed_graph_impl::packed_lists out_; // Out neighbors of each vertex
+      packed_graph_impl::packed_lists in_;  // In neighbors of each vertex
+    };
+
+
+  // The edge iterator of a packed graph visits the out edges of each vertex
+  // in turn.
+  template<typename V>
+    class packed_graph<V>::edge_iterator
+    {
+      using inner = packed_graph_impl::neighbor_iterator<true>;
+    public:
+      using value_type = edge;
+      using reference = edge;
+      using pointer = const edge*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::forward_iterator_tag;
+
+      edge_iterator()
+        : g_(nullptr), v_(0), left_(0)
+      { }
+
+      // Initialize an iterator to the first edge of v or a later vertex.
+      edge_iterator(const packed_graph* g, std::size_t v)
+        : g_(g), v_(v), left_(g->size() - g->out_.counts[v])
+      {
+        skip();
+      }
+
+      edge operator*() const { return *i_; }
+
+      edge_iterator& operator++()
+      {
+        --left_;
+        if ((++i_).remaining() == 0) {
+          ++v_;
+          skip();
+        }
+        return *this;
+      }
+
+      edge_iterator operator++(int)
+      {
+        edge_iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      // Equality is determined by the number of edges left to visit.
+      bool operator==(const edge_iterator& x) const
+      {
+        return left_ == x.left_;
+      }
+
+      bool operator!=(const edge_iterator& x) const { return !(*this == x); }
+
+    private:
+      // Move to the first edge of v_ or the next vertex that has one.
+      void skip()
+      {
+        if (left_ == 0)
+          return;
+        while (g_->out_degree(v_) == 0)
+          ++v_;
+        i_ = g_->out_edges(v_).begin();
+      }
+
+    private:
+      const packed_graph* g_;
+      std::size_t v_;
+      std::size_t left_;
+      inner i_;
+    };
+
+
+  template<typename V>
+    template<typename G>
+      packed_graph<V>::packed_graph(const G& g)
+      {
+        constexpr bool undirected = !Directed_graph<G>();
+        if (g.order() >= (std::size_t(1) << 31))
+          throw std::length_error("packed graph has too many vertices");
+
+        // Number the vertices of g, as in a compressed graph.
+        std::size_t bound = 0;
+        for (Vertex<G> v : g.vertices())
+          bound = std::max(bound, std::size_t(v) + 1);
+        std::vector<std::uint32_t> index(bound);
+        verts_.reserve(g.order());
+        for (Vertex<G> v : g.vertices()) {
+          index[v] = verts_.size();
+          verts_.push_back(g(v));
+        }
+
+        // Collect the edges, in both directions for an undirected graph.
+        std::size_t n = order();
+        std::vector<std::uint32_t> sources;
+        std::vector<std::uint32_t> targets;
+        for (Edge<G> e : g.edges()) {
+          std::uint32_t u = index[g.source(e)];
+          std::uint32_t v = index[g.target(e)];
+          sources.push_back(u);
+          targets.push_back(v);
+          if (undirected && u != v) {
+            sources.push_back(v);
+            targets.push_back(u);
+          }
+        }
+
+        // Sort the edges by source and then by target to build the out
+        // lists, and by target and then by source to build the in lists.
+        std::vector<std::uint64_t> keys(sources.size());
+        auto build = [&](const std::vector<std::uint32_t>& first,
+                         const std::vector<std::uint32_t>& second,
+                         packed_graph_impl::packed_lists& lists) {
+          for (std::size_t i = 0; i != keys.size(); ++i)
+            keys[i] = (std::uint64_t(first[i]) << 32) | second[i];
+          std::sort(keys.begin(), keys.end());
+          std::vector<std::size_t> off(n + 1, 0);
+          std::vector<std::uint32_t> adj(keys.size());
+          for (std::size_t i = 0; i != keys.size(); ++i) {
+            ++off[(keys[i] >> 32) + 1];
+            adj[i] = std::uint32_t(keys[i]);
+          }
+          std::partial_sum(off.begin(), off.end(), off.begin());
+          lists.encode(off, adj);
+        };
+        build(sources, targets, out_);
+        build(targets, sources, in_);
+      }
+
+  // Returns the edge (u, v), or an invalid edge handle if u and v are not
+  // adjacent.
+  template<typename V>
+    auto
+    packed_graph<V>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (edge e : out_edges(u)) {
+        if (e.target == v)
+          return e;
+        if (v < e.target)
+          break;
+      }
+      return edge();
+    }
+
+  template<typename V>
+    inline auto
+    packed_graph<V>::edges() const -> edge_range
+    {
+      return {edge_iterator(this, 0), edge_iterator(this, order())};
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,223 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+
+#include <origin/graph/packed_graph.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/generators.hpp>
+#include <origin/graph/iterative.hpp>
+#include <origin/graph/search.hpp>
+
+using namespace std;
+using namespace origin;
+
+using P = packed_graph<>;
+using C = compressed_graph<>;
+using D = directed_adjacency_list<>;
+using U = undirected_adjacency_list<>;
+
+static_assert(Directed_graph<P>(), "");
+
+
+// Returns the sorted targets of the out edges, or the sorted sources of the
+// in edges, of v in g.
+template<typename G>
+  vector<size_t>
+  out_neighbors(const G& g, Vertex<G> v)
+  {
+    vector<size_t> r;
+    for (Edge<G> e : g.out_edges(v))
+      r.push_back(g.target(e));
+    sort(r.begin(), r.end());
+    return r;
+  }
+
+template<typename G>
+  vector<size_t>
+  in_neighbors(const G& g, Vertex<G> v)
+  {
+    vector<size_t> r;
+    for (Edge<G> e : g.in_edges(v))
+      r.push_back(g.source(e));
+    sort(r.begin(), r.end());
+    return r;
+  }
+
+// Check that the packed graph p has the adjacency of the compressed graph
+// c, and that its lists are sorted.
+void
+check_same(const P& p, const C& c)
+{
+  assert(p.order() == c.order());
+  assert(p.size() == c.size());
+  for (Vertex<P> v : p.vertices()) {
+    assert(p.out_degree(v) == c.out_degree(v));
+    assert(p.in_degree(v) == c.in_degree(v));
+
+    vector<size_t> out;
+    for (Edge<P> e : p.out_edges(v)) {
+      assert(p.source(e) == v);
+      out.push_back(p.target(e));
+    }
+    assert(is_sorted(out.begin(), out.end()));
+    assert(out == out_neighbors(c, v));
+
+    vector<size_t> in;
+    for (Edge<P> e : p.in_edges(v)) {
+      assert(p.target(e) == v);
+      in.push_back(p.source(e));
+    }
+    assert(is_sorted(in.begin(), in.end()));
+    assert(in == in_neighbors(c, v));
+  }
+
+  size_t m = 0;
+  for (Edge<P> e : p.edges()) {
+    assert(p(p.source(e), p.target(e)) == e);
+    ++m;
+  }
+  assert(m == p.size());
+}
+
+void
+check_default()
+{
+  P p;
+  assert(p.null());
+  assert(p.empty());
+  assert(p.edges().begin() == p.edges().end());
+}
+
+// Self loops, parallel edges, isolated vertices, and edges to distant
+// vertices, whose gaps need several bytes.
+void
+check_small()
+{
+  D g;
+  for (int i = 0; i != 8; ++i)
+    g.add_vertex();
+  D h = g;
+  g.add_edge(0, 0);
+  g.add_edge(0, 3);
+  g.add_edge(0, 3);
+  g.add_edge(3, 0);
+  g.add_edge(5, 1);
+  g.add_edge(5, 2);
+  g.add_edge(5, 4);
+  g.add_edge(5, 6);
+  g.add_edge(5, 7);
+  g.add_edge(7, 7);
+
+  P p(g);
+  check_same(p, C(g));
+  assert(p.degree(7) == 3);
+  assert(p(0, 3));
+  assert(!p(3, 5));
+  assert(!p(1, 1));
+
+  // A graph with vertices and no edges.
+  P q(h);
+  assert(q.order() == 8);
+  assert(q.empty());
+  for (Vertex<P> v : q.vertices())
+    assert(q.out_edges(v).begin() == q.out_edges(v).end());
+}
+
+// Each edge of an undirected graph is an edge in each direction.
+void
+check_undirected()
+{
+  U g;
+  for (int i = 0; i != 5; ++i)
+    g.add_vertex();
+  for (int i = 0; i != 5; ++i)
+    for (int j = i; j != 5; ++j)
+      g.add_edge(i, j);
+  P p(g);
+  check_same(p, C(g));
+  assert(p.size() == 5 + 2 * 10);
+}
+
+// A graph whose vertices are adjacent to their k nearest vertices on a
+// ring of n vertices.
+D
+ring_lattice(size_t n, size_t k)
+{
+  D g;
+  for (size_t i = 0; i != n; ++i)
+    g.add_vertex();
+  for (size_t i = 0; i != n; ++i)
+    for (size_t j = 1; j <= k; ++j)
+      g.add_edge(i, (i + j) % n);
+  return g;
+}
+
+// The searches and PageRank run on the packed graph and compute what they
+// compute on a compressed graph.
+void
+check_algorithms(const D& g)
+{
+  C c(g);
+  P p(g);
+  check_same(p, c);
+
+  for (size_t s : {size_t(0), g.order() / 2}) {
+    assert(breadth_first_levels(p, s, 1) == breadth_first_levels(c, s, 1));
+    assert(breadth_first_levels(p, s, 4) == breadth_first_levels(c, s, 1));
+  }
+
+  for (sweep_mode mode : {sweep_mode::pull, sweep_mode::push}) {
+    iteration_options opts;
+    opts.mode = mode;
+    opts.threads = 1;
+    vector<double> a;
+    vector<double> b;
+    pagerank(p, a, opts);
+    pagerank(c, b, opts);
+    assert(a.size() == b.size());
+    for (size_t i = 0; i != a.size(); ++i)
+      assert(abs(a[i] - b[i]) < 1e-12);
+  }
+}
+
+void
+check_random()
+{
+  erdos_renyi_generator gen(3000, 20000, 7);
+  D g;
+  load_generated(g, gen);
+  check_algorithms(g);
+}
+
+// The lists of a graph with locality take at most a third of the space of
+// 32-bit compressed adjacency lists in both directions, and the graph at
+// most a third of the space of a compressed graph.
+void
+check_locality()
+{
+  D g = ring_lattice(4000, 8);
+  check_algorithms(g);
+
+  C c(g);
+  P p(g);
+  size_t n = p.order();
+  size_t offsets = 4 * (n + 1) * sizeof(size_t);
+  size_t lists = p.memory_usage().live - offsets - n * sizeof(empty_t);
+  assert(3 * lists <= 2 * 4 * p.size());
+  assert(3 * p.memory_usage().live <= c.memory_usage().live);
+}
+
+int
+main()
+{
+  check_default();
+  check_small();
+  check_undirected();
+  check_random();
+  check_locality();
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PARTITION_HPP
+#define ORIGIN_GRAPH_PARTITION_HPP
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <origin/data/flat_hash/flat_hash_map.hpp>
+#include <origin/graph/ordering.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.partition]
+  //                            Graph Partitioning
+  //
+  // A graph is distributed over k machines by partitioning its vertices into
+  // k parts of nearly equal size. The edges whose endpoints lie in different
+  // parts are cut, and each cut edge requires communication between the
+  // machines that own its endpoints. Assigning vertices by hashing their
+  // handles cuts nearly all edges; a partitioner that places adjacent
+  // vertices together cuts far fewer. The following operations are
+  // provided:
+  //
+  //    fennel_partition(g, k[, passes])
+  //    edge_cut(g, parts)
+  //    partition_subgraphs(g, parts, k)
+  //
+  // A partition is a vector p, indexed by vertex handle, such that p[v] is
+  // the part of v, in [0, k). Entries for handles that do not refer to
+  // vertices are size_t(-1). As with orderings (see [graph.ordering]), the
+  // edges of a directed graph are considered without regard to their
+  // direction.
+  //
+  // The Fennel partitioner (Tsourakakis et al.) visits the vertices once, in
+  // the order given by g.vertices(), and places each in the part that holds
+  // the most of its neighbors, less a penalty that grows with the size of
+  // the part. No part receives more than a fixed fraction over n / k
+  // vertices. Additional passes restream the vertices, moving each to the
+  // best part given the placement of all of its neighbors, which further
+  // reduces the cut.
+  //
+  // The subgraphs of a partition hold the vertices of each part, followed by
+  // ghost vertices standing for the neighbors of those vertices in other
+  // parts, and every edge incident to a vertex of the part. A cut edge
+  // therefore appears in the subgraphs of both of its endpoints.
+
+
+  namespace partition_impl
+  {
+    // The exponent of the size penalty of the Fennel objective.
+    constexpr double gamma = 1.5;
+
+    // The greatest size of a part, relative to n / k.
+    constexpr double imbalance = 1.1;
+
+  } // namespace partition_impl
+
+
+  // Returns a partition of the vertices of g into k parts computed by the
+  // Fennel streaming partitioner, making the given number of passes over
+  // the vertices.
+  template<typename G>
+    std::vector<std::size_t>
+    fennel_partition(const G& g, std::size_t k, std::size_t passes = 1)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using V = Vertex<G>;
+      using namespace partition_impl;
+      assert(k != 0);
+
+      std::vector<std::size_t> parts(search_impl::vertex_bound(g), -1);
+      double n = g.order();
+      if (n == 0)
+        return parts;
+      double alpha = g.size() * std::pow(double(k), gamma - 1)
+                   / std::pow(n, gamma);
+      std::size_t cap = std::ceil(imbalance * n / k);
+
+      std::vector<std::size_t> sizes(k);
+      std::vector<std::size_t> counts(k);
+      std::vector<std::size_t> touched;
+      std::vector<V> vs = ordering_impl::vertex_list(g);
+      auto score = [&](std::size_t p) {
+        return counts[p] - alpha * gamma * std::pow(sizes[p], gamma - 1);
+      };
+      for (std::size_t pass = 0; pass != std::max<std::size_t>(passes, 1);
+           ++pass) {
+        for (V v : vs) {
+          // Remove the vertex from its part when restreaming.
+          std::size_t old = parts[v];
+          if (old != std::size_t(-1))
+            --sizes[old];
+
+          touched.clear();
+          ordering_impl::for_neighbors(g, v, [&](V u) {
+            std::size_t p = parts[u];
+            if (u != v && p != std::size_t(-1)) {
+              if (counts[p]++ == 0)
+                touched.push_back(p);
+            }
+          });
+
+          // The best part is the one of greatest score, or the smallest part
+          // if no part holds a neighbor (all scores are then negative).
+          std::size_t best = std::min_element(sizes.begin(), sizes.end())
+                           - sizes.begin();
+          double top = score(best);
+          for (std::size_t p : touched) {
+            double s = score(p);
+            if (sizes[p] < cap && (s > top || (s == top && p < best))) {
+              top = s;
+              best = p;
+            }
+          }
+          for (std::size_t p : touched)
+            counts[p] = 0;
+
+          parts[v] = best;
+          ++sizes[best];
+        }
+      }
+      return parts;
+    }
+
+
+  // Returns the number of edges of g whose endpoints lie in different parts
+  // of the partition parts.
+  template<typename G>
+    std::size_t
+    edge_cut(const G& g, const std::vector<std::size_t>& parts)
+    {
+      std::size_t n = 0;
+      for (Edge<G> e : g.edges())
+        n += parts[g.source(e)] != parts[g.target(e)];
+      return n;
+    }
+
+
+  // A graph partition is the subgraph of one part of a partitioned graph.
+  // The local vertices [0, owned) of the subgraph are the vertices of the
+  // part, and the remaining vertices are ghosts. For each local vertex v,
+  // global[v] is the corresponding vertex of the partitioned graph, and
+  // owner[v] is the part that holds it.
+  template<typename H>
+    struct graph_partition
+    {
+      H graph;
+      std::size_t owned;
+      std::vector<std::size_t> global;
+      std::vector<std::size_t> owner;
+    };
+
+  // Returns the subgraphs of the k parts of the partition parts of g. The
+  // subgraphs have type H, which must be able to add vertices and edges,
+  // and are built by copying the values of vertices and edges of g. Local
+  // vertices appear in the order of g.vertices(), and local edges in the
+  // order of g.edges().
+  template<typename G, typename H = G>
+    std::vector<graph_partition<H>>
+    partition_subgraphs(const G& g,
+                        const std::vector<std::size_t>& parts,
+                        std::size_t k)
+    {
+      using V = Vertex<G>;
+      using W = Vertex<H>;
+
+      std::vector<graph_partition<H>> subs(k);
+      std::vector<std::size_t> local(search_impl::vertex_bound(g), -1);
+      for (V v : g.vertices()) {
+        std::size_t p = parts[v];
+        assert(p < k);
+        graph_partition<H>& s = subs[p];
+        local[v] = s.global.size();
+        s.graph.add_vertex(g(v));
+        s.global.push_back(v);
+        s.owner.push_back(p);
+      }
+      for (graph_partition<H>& s : subs)
+        s.owned = s.global.size();
+
+      // Returns the local vertex of v in the part p, adding a ghost if v is
+      // not in p.
+      std::vector<flat_hash_map<std::size_t, std::size_t>> ghosts(k);
+      auto vertex_in = [&](std::size_t p, V v) -> W {
+        if (parts[v] == p)
+          return local[v];
+        graph_partition<H>& s = subs[p];
+        auto x = ghosts[p].insert(std::make_pair(std::size_t(v),
+                                                 s.global.size()));
+        if (x.second) {
+          s.graph.add_vertex(g(v));
+          s.global.push_back(v);
+          s.owner.push_back(parts[v]);
+        }
+        return x.first->second;
+      };
+
+      for (Edge<G> e : g.edges()) {
+        V u = g.source(e);
+        V v = g.target(e);
+        std::size_t p = parts[u];
+        std::size_t q = parts[v];
+        subs[p].graph.add_edge(vertex_in(p, u), vertex_in(p, v), g(e));
+        if (q != p)
+          subs[q].graph.add_edge(vertex_in(q, u), vertex_in(q, v), g(e));
+      }
+      return subs;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,150 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/graph/partition.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Build k cliques of c vertices each, joined in a ring by single edges.
+// The vertices of the cliques are interleaved, so that vertex v belongs to
+// clique v % k.
+template<typename G>
+  G
+  build_ring_of_cliques(int k, int c)
+  {
+    G g = build_n_graph<G>(k * c);
+    for (int q = 0; q != k; ++q) {
+      for (int i = 0; i != c; ++i)
+        for (int j = i + 1; j != c; ++j)
+          g.add_edge(q + i * k, q + j * k, i + j);
+      g.add_edge(q, (q + 1) % k, -1);
+    }
+    return g;
+  }
+
+// The partition parts of g has k parts of bounded size.
+template<typename G>
+  void
+  check_balanced(const G& g, const vector<size_t>& parts, size_t k)
+  {
+    vector<size_t> sizes(k);
+    for (Vertex<G> v : g.vertices()) {
+      assert(parts[v] < k);
+      ++sizes[parts[v]];
+    }
+    for (size_t s : sizes)
+      assert(s <= 1.1 * g.order() / k + 1);
+  }
+
+// The subgraphs of the partition parts of g hold each vertex once, and each
+// edge once or, if cut, twice.
+template<typename G, typename H>
+  void
+  check_subgraphs(const G& g,
+                  const vector<size_t>& parts,
+                  const vector<graph_partition<H>>& subs)
+  {
+    size_t owned = 0;
+    size_t edges = 0;
+    for (size_t p = 0; p != subs.size(); ++p) {
+      const graph_partition<H>& s = subs[p];
+      assert(s.graph.order() == s.global.size());
+      assert(s.owner.size() == s.global.size());
+      for (size_t i = 0; i != s.global.size(); ++i) {
+        Vertex<G> v = s.global[i];
+        assert(s.owner[i] == parts[v]);
+        assert((i < s.owned) == (parts[v] == p));
+        assert(s.graph(Vertex<H>(i)) == g(v));
+      }
+      owned += s.owned;
+      edges += s.graph.size();
+
+      // Each local edge has an endpoint in the part, and corresponds to an
+      // edge of g with the same value.
+      for (Edge<H> e : s.graph.edges()) {
+        size_t u = s.graph.source(e);
+        size_t v = s.graph.target(e);
+        assert(u < s.owned || v < s.owned);
+        Edge<G> x = g(Vertex<G>(s.global[u]), Vertex<G>(s.global[v]));
+        assert(x);
+        assert(g(x) == s.graph(e));
+      }
+    }
+    assert(owned == g.order());
+    assert(edges == g.size() + edge_cut(g, parts));
+  }
+
+template<typename G>
+  void
+  check_partition()
+  {
+    G g = build_ring_of_cliques<G>(4, 8);
+
+    // Spreading the vertices of each clique over all parts cuts most edges;
+    // Fennel keeps the cliques together.
+    vector<size_t> hashed(g.order());
+    for (Vertex<G> v : g.vertices())
+      hashed[v] = (v / 4) % 4;
+    vector<size_t> parts = fennel_partition(g, 4);
+    check_balanced(g, parts, 4);
+    assert(edge_cut(g, parts) < edge_cut(g, hashed));
+
+    // Restreaming does not increase the cut.
+    vector<size_t> again = fennel_partition(g, 4, 3);
+    check_balanced(g, again, 4);
+    assert(edge_cut(g, again) <= edge_cut(g, parts));
+    assert(edge_cut(g, again) <= 4);
+
+    check_subgraphs(g, again, partition_subgraphs(g, again, 4));
+  }
+
+void
+check_compressed()
+{
+  // Compressed graphs are partitioned into mutable subgraphs.
+  using G = undirected_adjacency_vector<char, int>;
+  using C = compressed_graph<char, int>;
+  using H = directed_adjacency_vector<char, int>;
+  C c(build_ring_of_cliques<G>(3, 6));
+  vector<size_t> parts = fennel_partition(c, 3, 2);
+  check_balanced(c, parts, 3);
+  check_subgraphs(c, parts, partition_subgraphs<C, H>(c, parts, 3));
+}
+
+void
+check_holes()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_reflexive_clique<G>(5);
+  g.remove_vertex(2);
+  vector<size_t> parts = fennel_partition(g, 2);
+  assert(parts.size() == 5);
+  assert(parts[2] == size_t(-1));
+  check_balanced(g, parts, 2);
+  check_subgraphs(g, parts, partition_subgraphs(g, parts, 2));
+
+  assert(fennel_partition(G(), 3).empty());
+}
+
+int main()
+{
+  check_partition<undirected_adjacency_vector<char, int>>();
+  check_partition<undirected_adjacency_list<char, int>>();
+  check_partition<directed_adjacency_list<char, int>>();
+  check_compressed();
+  check_holes();
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PERSISTENT_HPP
+#define ORIGIN_GRAPH_PERSISTENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <origin/memory/mapped_heap.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.persistent]
+  //                             Persistent Graphs
+  //
+  // A persistent graph is a mutable adjacency list that lives in a mapped
+  // heap (see mem.mapped_heap): its vertex and edge pools and its incident
+  // edge lists are allocated in a file, which is mapped again, not read or
+  // rebuilt, when the graph is reopened. Reopening a graph takes the same
+  // time whatever its size, and its pages are read from the file as they
+  // are first used.
+  //
+  //    persistent_graph<persistent_directed_adjacency_list<>> p("g.heap", n);
+  //    auto& g = p.graph();
+  //    g.add_edge(g.add_vertex(), g.add_vertex());
+  //    p.checkpoint();
+  //
+  // The graph is changed in memory, and its changes are written to the file
+  // by checkpoint(), which is atomic; changes that are not checkpointed are
+  // discarded when the graph is closed. The vertex and edge values must be
+  // trivially copyable, or else allocate from the heap.
+  //
+  // Only the parts of an adjacency list that are allocated by its allocator
+  // can be persistent. A directed graph must use stable_incidence, since
+  // indexed_incidence keeps its positions on the global heap, and the edge
+  // index and the edge filter of the graph must not be enabled; checkpoint()
+  // throws std::logic_error if either is.
+
+  // A directed adjacency list in a mapped heap.
+  template<typename V = empty_t, typename E = empty_t,
+           typename I = std::size_t>
+    using persistent_directed_adjacency_list =
+      directed_adjacency_list<V, E, stable_incidence, I,
+                              mapped_allocator<char>>;
+
+  // An undirected adjacency list in a mapped heap.
+  template<typename V = empty_t, typename E = empty_t,
+           typename I = std::size_t>
+    using persistent_undirected_adjacency_list =
+      undirected_adjacency_list<V, E, I, mapped_allocator<char>>;
+
+
+  // A persistent graph owns a mapped heap whose root is a graph of type G,
+  // a persistent adjacency list.
+  template<typename G>
+    class persistent_graph
+    {
+    public:
+      using graph_type = G;
+
+      // Open the graph in the file at path, creating an empty graph in a
+      // heap of the given capacity, in bytes, if there is no such file.
+      persistent_graph(const std::string& path, std::size_t capacity)
+        : heap_(path, capacity),
+          graph_(&heap_.root<G>(heap_.get_allocator<char>()))
+      { }
+
+      // Open the graph in the file at path, which must exist.
+      explicit persistent_graph(const std::string& path)
+        : heap_(path), graph_(&heap_.root<G>(heap_.get_allocator<char>()))
+      { }
+
+      // Returns the graph.
+      G&       graph()       { return *graph_; }
+      const G& graph() const { return *graph_; }
+
+      // Returns the heap of the graph.
+      mapped_heap&       heap()       { return heap_; }
+      const mapped_heap& heap() const { return heap_; }
+
+      // Returns the number of checkpoints of the graph.
+      std::uint64_t version() const { return heap_.version(); }
+
+      // Write the changes made to the graph since the last checkpoint to
+      // its file.
+      void checkpoint()
+      {
+        if (graph_->edge_index_enabled() || graph_->edge_filter_enabled())
+          throw std::logic_error("persistent_graph: the edge index and "
+                                 "edge filter cannot be persistent");
+        heap_.checkpoint();
+      }
+
+    private:
+      mapped_heap heap_;
+      G*          graph_;
+    };
+
+} // namespace origin
+
+#endif
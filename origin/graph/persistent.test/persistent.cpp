@@ -0,0 +1,121 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <origin/graph/persistent.hpp>
+
+using namespace std;
+using namespace origin;
+
+const char* path = "origin.graph.persistent.test.heap";
+const size_t capacity = size_t(64) << 20;
+
+void
+remove_heap()
+{
+  std::remove(path);
+  std::remove((string(path) + ".journal").c_str());
+}
+
+// Add a cycle of n vertices, with each edge weighted by its source, to g.
+template<typename G>
+  void
+  build(G& g, size_t n)
+  {
+    for (size_t i = 0; i != n; ++i)
+      g.add_vertex(int(i));
+    for (size_t i = 0; i != n; ++i)
+      g.add_edge(i, (i + 1) % n, double(i));
+  }
+
+// Returns true if g is the cycle built by build(g, n), without the edges
+// whose source is a multiple of 3.
+template<typename G>
+  bool
+  holds(const G& g, size_t n)
+  {
+    if (g.order() != n || g.size() != n - (n + 2) / 3)
+      return false;
+    for (size_t i = 0; i != n; ++i)
+      if (g(Vertex<G>(i)) != int(i))
+        return false;
+    for (auto e : g.edges())
+      if (g.source(e) % 3 == 0 || g.target(e) != (g.source(e) + 1) % n
+          || g(e) != double(g.source(e)))
+        return false;
+    return true;
+  }
+
+// A graph is reopened as of its last checkpoint.
+template<typename G>
+  void
+  check_reopen()
+  {
+    remove_heap();
+    const size_t n = 5000;
+    {
+      persistent_graph<G> p(path, capacity);
+      G& g = p.graph();
+      assert(p.heap().created() && g.null());
+      build(g, n);
+      p.checkpoint();
+
+      // Remove the edges out of every third vertex.
+      vector<Edge<G>> es;
+      for (auto e : g.edges())
+        if (g.source(e) % 3 == 0)
+          es.push_back(e);
+      for (auto e : es)
+        g.remove_edge(e);
+      assert(holds(g, n));
+      p.checkpoint();
+      assert(p.version() == 2);
+
+      // Changes that are not checkpointed are discarded.
+      g.add_edge(0, 0, 0.0);
+      g.add_vertex(-1);
+    }
+    {
+      persistent_graph<G> p(path);
+      G& g = p.graph();
+      assert(!p.heap().created() && p.version() == 2);
+      assert(holds(g, n));
+
+      // Edges are added to the reopened graph.
+      size_t m = g.size();
+      for (size_t i = 0; i < n; i += 3)
+        g.add_edge(i, (i + 1) % n, double(i));
+      assert(g.size() == n && g.size() - m == (n + 2) / 3);
+      p.checkpoint();
+    }
+    {
+      persistent_graph<G> p(path);
+      G& g = p.graph();
+      assert(g.order() == n && g.size() == n);
+      for (auto e : g.edges())
+        assert(g.target(e) == (g.source(e) + 1) % n);
+
+      // The edge index is not persistent.
+      g.enable_edge_index();
+      try {
+        p.checkpoint();
+        assert(false);
+      } catch (logic_error&) { }
+    }
+    remove_heap();
+  }
+
+int main()
+{
+  check_reopen<persistent_directed_adjacency_list<int, double>>();
+  check_reopen<persistent_undirected_adjacency_list<int, double>>();
+}
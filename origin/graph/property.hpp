@@ -0,0 +1,270 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_PROPERTY_HPP
+#define ORIGIN_GRAPH_PROPERTY_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <vector>
+
+#include <origin/memory/usage.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.property]
+  //                          External Property Maps
+  //
+  // A property map associates a value with each vertex or each edge of a
+  // graph, outside the graph. It is a contiguous array indexed by the value
+  // of the handle, so that lookups are a single load and the values of
+  // consecutive vertices share cache lines. It is the storage to use for
+  // the scratch state of an algorithm (distances, colors, parents):
+  //
+  //    vertex_map<G, double> dist = make_vertex_map(g, inf);
+  //    dist[s] = 0;
+  //    ...
+  //    dist.fill(inf);                     // Reset for the next source
+  //
+  // A map made for a graph covers every handle below the handle capacity
+  // of the graph: for an adjacency list, the capacity of its vertex or edge
+  // pool, so that the map remains valid as vertices and edges are added
+  // until the pool next grows; for other graphs, one more than the largest
+  // handle. The slots of removed vertices and edges are holes in the pools,
+  // and their entries are allocated but ignored. When a graph outgrows a
+  // map m, fit_vertices(g, m) or fit_edges(g, m) grows the map, keeping its
+  // values. Compacting a graph renames its handles, and invalidates its
+  // maps.
+  //
+  // Filling a map, to initialize or reset it, writes every entry; maps of
+  // more than parallel_fill entries are filled in parallel with up to
+  // threads threads (see [graph.search]). Neither filling nor lookups
+  // allocate memory, so a map can be reused across the runs of an
+  // algorithm.
+  //
+  // Note that maps of bool store an entry per byte, not per bit.
+
+
+  namespace property_impl
+  {
+    // The number of entries filled by each parallel task, and the least
+    // number of entries for which a fill is parallel.
+    constexpr std::size_t grain = 1 << 14;
+    constexpr std::size_t parallel_fill = 1 << 16;
+
+    // A value stored in a property map. Values of type bool are wrapped so
+    // that the array is not a packed std::vector<bool>.
+    template<typename T>
+      struct slot
+      {
+        using type = T;
+      };
+
+    template<>
+      struct slot<bool>
+      {
+        struct type
+        {
+          type() = default;
+          type(bool b) : value(b) { }
+          bool value;
+        };
+      };
+
+    template<typename T>
+      using Slot = typename slot<T>::type;
+
+    template<typename T>
+      inline T& unwrap(T& x) { return x; }
+
+    template<typename T>
+      inline const T& unwrap(const T& x) { return x; }
+
+    inline bool& unwrap(slot<bool>::type& x) { return x.value; }
+    inline const bool& unwrap(const slot<bool>::type& x) { return x.value; }
+
+    // Returns the handle capacity of the graph: the capacity of its pools,
+    // when it has them, or one more than its largest handle.
+    template<typename G>
+      inline auto
+      vertex_capacity(const G& g, int) -> decltype(g.vertex_capacity())
+      {
+        return g.vertex_capacity();
+      }
+
+    template<typename G>
+      inline std::size_t
+      vertex_capacity(const G& g, long)
+      {
+        return search_impl::vertex_bound(g);
+      }
+
+    template<typename G>
+      inline auto
+      edge_capacity(const G& g, int) -> decltype(g.edge_capacity())
+      {
+        return g.edge_capacity();
+      }
+
+    template<typename G>
+      inline std::size_t
+      edge_capacity(const G& g, long)
+      {
+        std::size_t n = 0;
+        for (Edge<G> e : g.edges())
+          n = std::max(n, std::size_t(e) + 1);
+        return n;
+      }
+
+  } // namespace property_impl
+
+
+  // Returns the number of entries in a vertex or edge map of g.
+  template<typename G>
+    inline std::size_t
+    vertex_capacity(const G& g)
+    {
+      return property_impl::vertex_capacity(g, 0);
+    }
+
+  template<typename G>
+    inline std::size_t
+    edge_capacity(const G& g)
+    {
+      return property_impl::edge_capacity(g, 0);
+    }
+
+
+  // A property map is a dense array of values of type T indexed by handles
+  // of type H.
+  template<typename H, typename T>
+    class property_map
+    {
+      using S = property_impl::Slot<T>;
+    public:
+      using key_type = H;
+      using value_type = T;
+      using reference = T&;
+      using const_reference = const T&;
+
+      // Initialize an empty map.
+      property_map() = default;
+
+      // Initialize a map of n entries equal to x.
+      explicit property_map(std::size_t n, const T& x = T())
+        : values_(n, S(x))
+      { }
+
+      // Observers
+      std::size_t size() const { return values_.size(); }
+      bool        empty() const { return values_.empty(); }
+
+      // Returns true if h is in the range of the map.
+      bool covers(H h) const { return std::size_t(h) < size(); }
+
+      // Element access
+      T& operator[](H h)
+      {
+        assert(covers(h));
+        return property_impl::unwrap(values_[h]);
+      }
+
+      const T& operator[](H h) const
+      {
+        assert(covers(h));
+        return property_impl::unwrap(values_[h]);
+      }
+
+      T&       operator()(H h)       { return (*this)[h]; }
+      const T& operator()(H h) const { return (*this)[h]; }
+
+      // Set every entry to x, using up to threads threads.
+      void fill(const T& x, std::size_t threads = search_threads());
+
+      // Grow the map to n entries, setting the new entries to x. The map
+      // does not shrink.
+      void grow(std::size_t n, const T& x = T())
+      {
+        if (n > size())
+          values_.resize(n, S(x));
+      }
+
+      // Returns the footprint of the array. See [mem.usage].
+      memory_footprint memory_usage() const
+      {
+        return contiguous_footprint(values_);
+      }
+
+    private:
+      std::vector<S> values_;
+    };
+
+  template<typename H, typename T>
+    void
+    property_map<H, T>::fill(const T& x, std::size_t threads)
+    {
+      using property_impl::grain;
+      std::size_t n = size();
+      if (n < property_impl::parallel_fill || threads <= 1) {
+        std::fill(values_.begin(), values_.end(), S(x));
+        return;
+      }
+      S v(x);
+      search_impl::parallel_for((n + grain - 1) / grain, threads,
+                                [&](std::size_t k) {
+        auto first = values_.begin() + k * grain;
+        std::fill(first, first + std::min(grain, n - k * grain), v);
+      });
+    }
+
+
+  // The property maps of the vertices and edges of a graph.
+  template<typename G, typename T>
+    using vertex_map = property_map<Vertex<G>, T>;
+
+  template<typename G, typename T>
+    using edge_map = property_map<Edge<G>, T>;
+
+  // Returns a map of the vertices or edges of g whose entries are x.
+  template<typename G, typename T>
+    inline vertex_map<G, T>
+    make_vertex_map(const G& g, const T& x)
+    {
+      return vertex_map<G, T>(vertex_capacity(g), x);
+    }
+
+  template<typename G, typename T>
+    inline edge_map<G, T>
+    make_edge_map(const G& g, const T& x)
+    {
+      return edge_map<G, T>(edge_capacity(g), x);
+    }
+
+  // Grow the map m to cover the vertices or edges of g, setting the new
+  // entries to x.
+  template<typename G, typename T>
+    inline void
+    fit_vertices(const G& g, vertex_map<G, T>& m,
+                 const Value_type<vertex_map<G, T>>& x = T())
+    {
+      m.grow(vertex_capacity(g), x);
+    }
+
+  template<typename G, typename T>
+    inline void
+    fit_edges(const G& g, edge_map<G, T>& m,
+              const Value_type<edge_map<G, T>>& x = T())
+    {
+      m.grow(edge_capacity(g), x);
+    }
+
+} // namespace origin
+
+#endif
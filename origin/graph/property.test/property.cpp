@@ -0,0 +1,133 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <deque>
+
+#include <origin/graph/property.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+void
+check_list()
+{
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(10);
+  for (int i = 0; i != 9; ++i)
+    g.add_edge(i, i + 1, i);
+
+  vertex_map<G, int> m = make_vertex_map(g, -1);
+  assert(m.size() == g.vertex_capacity());
+  assert(m.size() >= g.order());
+  for (Vertex<G> v : g.vertices())
+    assert(m[v] == -1);
+
+  // Vertices added within the capacity of the pool are covered.
+  while (g.order() < m.size())
+    assert(m.covers(g.add_vertex('x')));
+
+  // Removed vertices leave holes, whose entries are kept.
+  g.remove_vertex(3);
+  for (Vertex<G> v : g.vertices())
+    m[v] = v;
+  assert(m[Vertex<G>(3)] == -1);
+  assert(m(Vertex<G>(4)) == 4);
+
+  // A map grows with the graph, keeping its values.
+  Vertex<G> v = g.add_vertex('y');
+  v = g.add_vertex('z');
+  fit_vertices(g, m, 7);
+  assert(m.covers(v) && m[v] == 7);
+  assert(m[Vertex<G>(4)] == 4);
+
+  edge_map<G, double> w = make_edge_map(g, 0.5);
+  assert(w.size() == g.edge_capacity());
+  for (Edge<G> e : g.edges())
+    w[e] = g(e);
+  assert(w[g(Vertex<G>(7), Vertex<G>(8))] == 7);
+  g.add_edge(0, 5, 1);
+  fit_edges(g, w);
+}
+
+void
+check_dense()
+{
+  using G = undirected_adjacency_vector<char, int>;
+  G g = build_n_graph<G>(5);
+  g.add_edge(0, 1, 0);
+  g.add_edge(1, 2, 0);
+  assert(vertex_capacity(g) == 5);
+  assert(edge_capacity(g) == 2);
+
+  compressed_graph<char, int> c(g);
+  auto m = make_edge_map(c, 'a');
+  assert(m.size() == c.size());
+
+  // Maps of bool hold a byte per entry, and can be referenced.
+  vertex_map<G, bool> seen = make_vertex_map(g, false);
+  bool& b = seen[Vertex<G>(2)];
+  b = true;
+  assert(seen[Vertex<G>(2)] && !seen[Vertex<G>(1)]);
+}
+
+void
+check_fill()
+{
+  // A map large enough to be filled in parallel.
+  property_map<vertex_handle, int> m(300001, 1);
+  m.fill(2, 4);
+  for (size_t i = 0; i != m.size(); ++i)
+    assert(m[vertex_handle(i)] == 2);
+  m.fill(3, 1);
+  assert(m[vertex_handle(300000)] == 3);
+  assert(m.memory_usage().live == 300001 * sizeof(int));
+}
+
+// A breadth-first search that reuses its property map across sources.
+void
+check_scratch()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(6);
+  for (int i = 0; i != 5; ++i)
+    g.add_edge(i, i + 1, 0);
+
+  vertex_map<G, size_t> dist = make_vertex_map(g, size_t(-1));
+  for (Vertex<G> s : g.vertices()) {
+    dist.fill(size_t(-1));
+    dist[s] = 0;
+    deque<Vertex<G>> q {s};
+    while (!q.empty()) {
+      Vertex<G> u = q.front();
+      q.pop_front();
+      for (Edge<G> e : g.edges(u)) {
+        Vertex<G> v = opposite(g, e, u);
+        if (dist[v] == size_t(-1)) {
+          dist[v] = dist[u] + 1;
+          q.push_back(v);
+        }
+      }
+    }
+    for (Vertex<G> v : g.vertices())
+      assert(dist[v] == size_t(max(int(v), int(s)) - min(int(v), int(s))));
+  }
+}
+
+int main()
+{
+  check_list();
+  check_dense();
+  check_fill();
+  check_scratch();
+}
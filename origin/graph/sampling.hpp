@@ -0,0 +1,410 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_SAMPLING_HPP
+#define ORIGIN_GRAPH_SAMPLING_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/random.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.sampling]
+  //                     Random Walks and Neighbor Sampling
+  //
+  //    random_walker<G> w(g[, weight])
+  //    w.next(v, gen)
+  //    w.walks(starts, length, out[, seed[, threads]])
+  //    w.node2vec_walks(starts, length, p, q, out[, seed[, threads]])
+  //    w.sample_neighbors(seeds, fanouts, out[, seed[, threads]])
+  //
+  // A random walker draws random walks and neighborhoods from a graph, as
+  // used to train graph embeddings (DeepWalk, node2vec) and graph neural
+  // networks (GraphSAGE). It copies the successors of each vertex (the
+  // targets of the out edges of a directed graph, or the neighbors of a
+  // vertex of an undirected graph) into compressed sparse row form, sorted
+  // by vertex handle, so that a step of a walk reads a single contiguous
+  // block of memory. Constructed with a weight function, weight(e) giving
+  // the non-negative weight of each edge, successors are drawn in
+  // proportion to their weights, using an alias table for each vertex (see
+  // [random.alias]) stored in flat arrays beside the successors, so that a
+  // weighted step takes constant time; a vertex whose successors all have
+  // zero weight is treated as having none. Otherwise, successors are drawn
+  // uniformly.
+  //
+  // The walks algorithm draws a walk of length vertices from each vertex
+  // of starts, and the node2vec_walks algorithm draws the second-order
+  // walks of node2vec (Grover and Leskovec), in which the step from v,
+  // having arrived from t, to a successor x is biased by 1/p when x is t,
+  // by 1 when x is a successor of t, and by 1/q otherwise. Second-order
+  // steps are drawn by rejection (as in KnightKing): a successor of v is
+  // drawn as in a first-order walk, and accepted with probability equal to
+  // its bias divided by the largest of the three biases, so that no
+  // per-edge tables of second-order weights are needed. Whether x is a
+  // successor of t is decided by binary search, and not at all when the
+  // draw is accepted for every bias. Walks are written to out, resized to
+  // starts.size() * length, so that the ith walk is [i * length, (i + 1) *
+  // length). A walk that reaches a vertex without successors stops, and
+  // the rest of it is filled with invalid vertex handles.
+  //
+  // The sample_neighbors algorithm draws the k-hop neighborhoods of each
+  // vertex of seeds with the given fanouts, with replacement. For fanouts
+  // {f1, f2, ..., fk}, f1 successors of the seed are drawn, then f2
+  // successors of each of those, and so on. The neighborhood of each seed
+  // is written to a block of f1 + f1 * f2 + ... + f1 * ... * fk entries of
+  // out, holding the drawn vertices layer by layer, where the successors of
+  // the jth vertex of a layer are the jth fi entries of the next layer.
+  // The successors of a vertex without successors (or of an invalid
+  // handle) are invalid handles.
+  //
+  // The walks and neighborhoods of each start vertex are drawn in parallel,
+  // using up to threads threads. The ith walk or neighborhood is drawn from
+  // the ith stream of a splitmix64 engine seeded with seed (see
+  // [random.splitmix]), so the results are the same for any number of
+  // threads.
+
+  namespace sampling_impl
+  {
+    // The number of walks drawn by each parallel task.
+    constexpr std::size_t grain = 256;
+
+    // Aliases index the successors of a vertex, in 32 bits.
+    using index = std::uint32_t;
+
+    // Build the alias table of the n weights w, with Vose's method (see
+    // [random.alias]). The weights are scaled in place. If they are all
+    // zero, the first probability is negative.
+    inline void
+    build_alias(double* w, std::size_t n, double* prob, index* alias,
+                std::vector<index>& small, std::vector<index>& large)
+    {
+      double sum = 0;
+      for (std::size_t i = 0; i != n; ++i)
+        sum += w[i];
+      small.clear();
+      large.clear();
+      for (std::size_t i = 0; i != n; ++i) {
+        prob[i] = 1.0;
+        alias[i] = i;
+        w[i] = sum > 0 ? w[i] * n / sum : 1.0;
+        (w[i] < 1.0 ? small : large).push_back(i);
+      }
+      if (!(sum > 0)) {
+        prob[0] = -1;
+        return;
+      }
+      while (!small.empty() && !large.empty()) {
+        index s = small.back();
+        index l = large.back();
+        small.pop_back();
+        prob[s] = w[s];
+        alias[s] = l;
+        w[l] -= 1.0 - w[s];
+        if (w[l] < 1.0) {
+          large.pop_back();
+          small.push_back(l);
+        }
+      }
+    }
+
+    // Returns the weight of e, or 0 for a walker without weights.
+    template<typename W, typename E>
+      inline double
+      weigh(const W& weight, E e)
+      {
+        return weight(e);
+      }
+
+    template<typename E>
+      inline double
+      weigh(std::nullptr_t, E)
+      {
+        return 0;
+      }
+
+  } // namespace sampling_impl
+
+
+  template<typename G>
+    class random_walker
+    {
+    public:
+      using vertex = Vertex<G>;
+
+      // Initialize a walker drawing successors uniformly.
+      explicit random_walker(const G& g)
+        : random_walker(g, nullptr)
+      { }
+
+      // Initialize a walker drawing successors in proportion to weight(e).
+      template<typename W>
+        random_walker(const G& g, W weight);
+
+      // Returns one more than the largest vertex handle.
+      std::size_t order() const { return off.size() - 1; }
+
+      // Returns true if successors are drawn by weight.
+      bool weighted() const { return !prob.empty(); }
+
+      // Returns a random successor of v, or an invalid vertex if v has no
+      // successors (or, when weighted, none of positive weight).
+      template<typename Gen>
+        vertex next(vertex v, Gen& gen) const;
+
+      void walks(const std::vector<vertex>& starts,
+                 std::size_t length,
+                 std::vector<vertex>& out,
+                 std::uint64_t seed = 0,
+                 std::size_t threads = search_threads()) const;
+
+      void node2vec_walks(const std::vector<vertex>& starts,
+                          std::size_t length,
+                          double p,
+                          double q,
+                          std::vector<vertex>& out,
+                          std::uint64_t seed = 0,
+                          std::size_t threads = search_threads()) const;
+
+      void sample_neighbors(const std::vector<vertex>& seeds,
+                            const std::vector<std::size_t>& fanouts,
+                            std::vector<vertex>& out,
+                            std::uint64_t seed = 0,
+                            std::size_t threads = search_threads()) const;
+
+    private:
+      // Returns true if v is a successor of u.
+      bool adjacent(vertex u, vertex v) const
+      {
+        return std::binary_search(targets.begin() + off[u],
+                                  targets.begin() + off[u + 1], v);
+      }
+
+      // Call f(i) for each i in [0, n), in blocks, using up to threads
+      // threads.
+      template<typename F>
+        static void for_each_block(std::size_t n, std::size_t threads, F f);
+
+    private:
+      std::vector<std::size_t> off;    // The successors of v are
+      std::vector<vertex> targets;     // [off[v], off[v + 1]) of targets
+      std::vector<double> prob;        // The alias table of the successors
+      std::vector<sampling_impl::index> alias;
+    };
+
+  template<typename G>
+    template<typename W>
+      random_walker<G>::random_walker(const G& g, W weight)
+        : off(search_impl::vertex_bound(g) + 1, 0)
+      {
+        using namespace sampling_impl;
+        constexpr bool weighted = !std::is_same<W, std::nullptr_t>::value;
+        std::size_t n = order();
+        std::vector<vertex> verts;
+        verts.reserve(g.order());
+        for (vertex v : g.vertices())
+          verts.push_back(v);
+        std::size_t threads = search_threads();
+        std::size_t blocks = (verts.size() + grain - 1) / grain;
+
+        // Count the successors of each vertex in parallel.
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t last = std::min(verts.size(), (k + 1) * grain);
+          for (std::size_t i = k * grain; i != last; ++i) {
+            auto edges = search_impl::successor_edges(g, verts[i]);
+            off[std::size_t(verts[i]) + 1] =
+              std::distance(edges.begin(), edges.end());
+          }
+        });
+        for (std::size_t v = 0; v != n; ++v)
+          off[v + 1] += off[v];
+        targets.resize(off[n]);
+        if (weighted) {
+          prob.resize(off[n]);
+          alias.resize(off[n]);
+        }
+
+        // Copy, sort, and weigh the successors of each vertex in parallel.
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::vector<std::pair<vertex, double>> succ;
+          std::vector<double> w;
+          std::vector<index> small, large;
+          std::size_t last = std::min(verts.size(), (k + 1) * grain);
+          for (std::size_t i = k * grain; i != last; ++i) {
+            vertex u = verts[i];
+            succ.clear();
+            for (Edge<G> e : search_impl::successor_edges(g, u))
+              succ.emplace_back(opposite(g, e, u), weigh(weight, e));
+            std::sort(succ.begin(), succ.end());
+            std::size_t first = off[u];
+            for (std::size_t j = 0; j != succ.size(); ++j)
+              targets[first + j] = succ[j].first;
+            if (weighted) {
+              w.clear();
+              for (auto& x : succ) {
+                assert(!(x.second < 0));
+                w.push_back(x.second);
+              }
+              build_alias(w.data(), w.size(), &prob[first], &alias[first],
+                          small, large);
+            }
+          }
+        });
+      }
+
+  template<typename G>
+    template<typename F>
+      void
+      random_walker<G>::for_each_block(std::size_t n, std::size_t threads, F f)
+      {
+        using sampling_impl::grain;
+        std::size_t blocks = (n + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t last = std::min(n, (k + 1) * grain);
+          for (std::size_t i = k * grain; i != last; ++i)
+            f(i);
+        });
+      }
+
+  template<typename G>
+    template<typename Gen>
+      inline auto
+      random_walker<G>::next(vertex v, Gen& gen) const -> vertex
+      {
+        std::size_t first = off[v];
+        std::size_t d = off[std::size_t(v) + 1] - first;
+        if (d == 0)
+          return vertex();
+        double x = random_impl::open_unit(gen) * d;
+        std::size_t i = std::min(std::size_t(x), d - 1);
+        if (weighted()) {
+          if (prob[first] < 0)
+            return vertex();
+          if (!(x - i < prob[first + i]))
+            i = alias[first + i];
+        }
+        return targets[first + i];
+      }
+
+  template<typename G>
+    void
+    random_walker<G>::walks(const std::vector<vertex>& starts,
+                            std::size_t length,
+                            std::vector<vertex>& out,
+                            std::uint64_t seed,
+                            std::size_t threads) const
+    {
+      out.resize(starts.size() * length);
+      if (length == 0)
+        return;
+      splitmix64 streams(seed);
+      for_each_block(starts.size(), threads, [&](std::size_t i) {
+        splitmix64 gen = streams.stream(i);
+        vertex* w = out.data() + i * length;
+        vertex v = starts[i];
+        w[0] = v;
+        for (std::size_t k = 1; k != length; ++k) {
+          if (v)
+            v = next(v, gen);
+          w[k] = v;
+        }
+      });
+    }
+
+  template<typename G>
+    void
+    random_walker<G>::node2vec_walks(const std::vector<vertex>& starts,
+                                     std::size_t length,
+                                     double p,
+                                     double q,
+                                     std::vector<vertex>& out,
+                                     std::uint64_t seed,
+                                     std::size_t threads) const
+    {
+      assert(p > 0 && q > 0);
+      out.resize(starts.size() * length);
+      if (length == 0)
+        return;
+      double back = 1 / p;
+      double away = 1 / q;
+      double upper = std::max({back, 1.0, away});
+      double lower = std::min({back, 1.0, away});
+      splitmix64 streams(seed);
+      for_each_block(starts.size(), threads, [&](std::size_t i) {
+        splitmix64 gen = streams.stream(i);
+        vertex* w = out.data() + i * length;
+        vertex t;
+        vertex v = starts[i];
+        w[0] = v;
+        for (std::size_t k = 1; k != length; ++k) {
+          if (v) {
+            vertex x;
+            for (;;) {
+              x = next(v, gen);
+              if (!x || !t)
+                break;
+              double r = random_impl::open_unit(gen) * upper;
+              if (r < lower)
+                break;
+              double bias = x == t ? back : adjacent(t, x) ? 1.0 : away;
+              if (r < bias)
+                break;
+            }
+            t = v;
+            v = x;
+          }
+          w[k] = v;
+        }
+      });
+    }
+
+  template<typename G>
+    void
+    random_walker<G>::sample_neighbors(const std::vector<vertex>& seeds,
+                                       const std::vector<std::size_t>& fanouts,
+                                       std::vector<vertex>& out,
+                                       std::uint64_t seed,
+                                       std::size_t threads) const
+    {
+      std::size_t size = 0;
+      std::size_t layer = 1;
+      for (std::size_t f : fanouts)
+        size += layer *= f;
+      out.resize(seeds.size() * size);
+      if (size == 0)
+        return;
+      splitmix64 streams(seed);
+      for_each_block(seeds.size(), threads, [&](std::size_t i) {
+        splitmix64 gen = streams.stream(i);
+        const vertex* parents = &seeds[i];
+        vertex* children = out.data() + i * size;
+        std::size_t n = 1;
+        for (std::size_t f : fanouts) {
+          for (std::size_t j = 0; j != n; ++j) {
+            vertex u = parents[j];
+            for (std::size_t c = 0; c != f; ++c)
+              children[j * f + c] = u ? next(u, gen) : vertex();
+          }
+          parents = children;
+          children += n *= f;
+        }
+      });
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,205 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/sampling.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using D = directed_adjacency_vector<char, double>;
+using V = Vertex<D>;
+
+// Returns a random edge weight in [0, 4).
+double
+random_weight(minstd_rand& prng)
+{
+  return uniform_int_distribution<int>(0, 3)(prng);
+}
+
+// Returns the edges of g as pairs of vertex indexes.
+set<pair<size_t, size_t>>
+edge_set(const D& g)
+{
+  set<pair<size_t, size_t>> es;
+  for (Edge<D> e : g.edges())
+    es.emplace(g.source(e), g.target(e));
+  return es;
+}
+
+// Returns true if v has no out edges of positive weight.
+bool
+dead_end(const D& g, V v)
+{
+  for (Edge<D> e : g.out_edges(v))
+    if (g(e) > 0)
+      return false;
+  return true;
+}
+
+// Each step of a walk follows an edge, and a walk stops only at a vertex
+// without out edges, or without weighted ones.
+void
+check_walk(const D& g, const set<pair<size_t, size_t>>& es,
+           const V* w, size_t length, bool weighted)
+{
+  for (size_t k = 1; k != length; ++k) {
+    if (!w[k - 1]) {
+      assert(!w[k]);
+    } else if (!w[k]) {
+      assert(weighted ? dead_end(g, w[k - 1]) : g.out_degree(w[k - 1]) == 0);
+    } else {
+      assert(es.count({w[k - 1], w[k]}));
+    }
+  }
+}
+
+// Walks follow the edges of the graph, and are the same for any number of
+// threads.
+void
+check_random()
+{
+  D g = build_erdos_renyi_graph<D>(2000, 8000, 1, random_weight);
+  auto es = edge_set(g);
+  random_walker<D> uniform(g);
+  random_walker<D> weighted(g, [&g](Edge<D> e) { return g(e); });
+  assert(!uniform.weighted() && weighted.weighted());
+
+  vector<V> starts;
+  for (size_t i = 0; i != 3000; ++i)
+    starts.push_back(i % 2000);
+  vector<V> w1, w4;
+  for (const random_walker<D>* r : {&uniform, &weighted}) {
+    r->walks(starts, 20, w1, 7, 1);
+    r->walks(starts, 20, w4, 7, 4);
+    assert(w1.size() == 3000 * 20 && w1 == w4);
+    for (size_t i = 0; i != starts.size(); ++i) {
+      assert(w1[i * 20] == starts[i]);
+      check_walk(g, es, &w1[i * 20], 20, r->weighted());
+    }
+    r->node2vec_walks(starts, 20, 0.5, 2.0, w1, 7, 1);
+    r->node2vec_walks(starts, 20, 0.5, 2.0, w4, 7, 4);
+    assert(w1 == w4);
+    for (size_t i = 0; i != starts.size(); ++i)
+      check_walk(g, es, &w1[i * 20], 20, r->weighted());
+  }
+
+  // Edges of zero weight are never followed.
+  weighted.walks(starts, 20, w1);
+  for (size_t i = 0; i != w1.size(); ++i)
+    if (i % 20 != 0 && w1[i]) {
+      bool positive = false;
+      for (Edge<D> e : g.out_edges(w1[i - 1]))
+        if (g.target(e) == w1[i] && g(e) > 0)
+          positive = true;
+      assert(positive);
+    }
+
+  // Each sampled vertex is a successor of its parent.
+  vector<V> s1, s4;
+  uniform.sample_neighbors(starts, {4, 3}, s1, 3, 1);
+  uniform.sample_neighbors(starts, {4, 3}, s4, 3, 4);
+  assert(s1.size() == 3000 * 16 && s1 == s4);
+  for (size_t i = 0; i != starts.size(); ++i) {
+    const V* b = &s1[i * 16];
+    for (size_t j = 0; j != 4; ++j) {
+      assert(!b[j] || es.count({starts[i], b[j]}));
+      for (size_t c = 0; c != 3; ++c) {
+        V x = b[4 + j * 3 + c];
+        assert(b[j] ? !x || es.count({b[j], x}) : !x);
+      }
+    }
+  }
+}
+
+// Successors are drawn in proportion to their weights, and node2vec steps
+// in proportion to their biases.
+void
+check_distribution()
+{
+  // 0 -> 1 (1), 0 -> 2 (3), 0 -> 3 (0), 0 -> 4 (4), and 4 has no successors.
+  D g = build_n_graph<D>(5);
+  g.add_edge(0, 4, 4);
+  g.add_edge(0, 1, 1);
+  g.add_edge(0, 3, 0);
+  g.add_edge(0, 2, 3);
+  random_walker<D> r(g, [&g](Edge<D> e) { return g(e); });
+  const size_t n = 80000;
+  vector<V> starts(n, 0);
+  vector<V> w;
+  r.walks(starts, 3, w);
+  vector<size_t> hits(5);
+  for (size_t i = 0; i != n; ++i) {
+    ++hits[w[i * 3 + 1]];
+    assert(w[i * 3 + 1] == 4 ? !w[i * 3 + 2] : true);
+  }
+  assert(hits[0] == 0 && hits[3] == 0);
+  assert(abs(double(hits[1]) / n - 0.125) < 0.01);
+  assert(abs(double(hits[2]) / n - 0.375) < 0.01);
+  assert(abs(double(hits[4]) / n - 0.5) < 0.01);
+
+  // From 1, having arrived from 0, a walk returns to 0 with bias 1/p, goes
+  // to 2, a successor of 0, with bias 1, or to 5 with bias 1/q.
+  D h = build_n_graph<D>(6);
+  h.add_edge(0, 1);
+  h.add_edge(0, 2);
+  h.add_edge(1, 0);
+  h.add_edge(1, 2);
+  h.add_edge(1, 5);
+  random_walker<D> u(h);
+  u.node2vec_walks(starts, 3, 0.5, 4.0, w, 11);
+  size_t total = 0;
+  hits.assign(6, 0);
+  for (size_t i = 0; i != n; ++i) {
+    if (w[i * 3 + 1] == 1) {
+      ++total;
+      ++hits[w[i * 3 + 2]];
+    }
+  }
+  assert(total > n / 3);
+  double sum = 2 + 1 + 0.25;
+  assert(abs(double(hits[0]) / total - 2 / sum) < 0.02);
+  assert(abs(double(hits[2]) / total - 1 / sum) < 0.02);
+  assert(abs(double(hits[5]) / total - 0.25 / sum) < 0.02);
+}
+
+int main()
+{
+  check_random();
+  check_distribution();
+
+  // Walks and samples of length zero are empty.
+  D g = build_n_graph<D>(3);
+  random_walker<D> r(g);
+  vector<V> out {0, 1};
+  r.walks({0, 1}, 0, out);
+  assert(out.empty());
+  r.sample_neighbors({0, 1}, {}, out);
+  assert(out.empty());
+  r.walks({0, 1}, 2, out);
+  assert(out[0] == 0 && !out[1] && out[2] == 1 && !out[3]);
+
+  // Undirected graphs are walked along their incident edges.
+  using U = undirected_adjacency_list<char, int>;
+  U u = build_n_graph<U>(2);
+  u.add_edge(0, 1);
+  random_walker<U> ur(u);
+  vector<Vertex<U>> uw;
+  ur.walks({1}, 4, uw);
+  assert(uw[0] == 1 && uw[1] == 0 && uw[2] == 1 && uw[3] == 0);
+}
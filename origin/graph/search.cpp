@@ -0,0 +1,115 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+#include <origin/concurrency/scheduler.hpp>
+
+#include "search.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                            Search Threads
+
+  namespace
+  {
+    // The requested number of search threads. A value of 0 indicates the
+    // number of hardware threads.
+    std::atomic<std::size_t> requested_threads {0};
+  } // namespace
+
+  std::size_t
+  search_threads()
+  {
+    std::size_t n = requested_threads.load(std::memory_order_relaxed);
+    if (n == 0)
+      n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+  }
+
+  void
+  set_search_threads(std::size_t n)
+  {
+    requested_threads.store(n, std::memory_order_relaxed);
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                           Prefetch Distance
+
+  namespace
+  {
+    std::atomic<std::size_t> prefetch_distance {8};
+  } // namespace
+
+  std::size_t
+  search_prefetch_distance()
+  {
+    return prefetch_distance.load(std::memory_order_relaxed);
+  }
+
+  void
+  set_search_prefetch_distance(std::size_t n)
+  {
+    prefetch_distance.store(n, std::memory_order_relaxed);
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Traversal Statistics
+
+  std::ostream&
+  operator<<(std::ostream& os, traversal_direction d)
+  {
+    return os << (d == traversal_direction::top_down ? "top-down"
+                                                     : "bottom-up");
+  }
+
+  std::ostream&
+  operator<<(std::ostream& os, const traversal_stats& x)
+  {
+    os << x.steps.size() << " steps ("
+       << x.count(traversal_direction::top_down) << " top-down, "
+       << x.count(traversal_direction::bottom_up) << " bottom-up), "
+       << x.vertices << " vertices, " << x.edges << " edges examined, "
+       << x.component_edges << " edges in component\n"
+       << x.seconds << " s, " << x.teps() << " TEPS\n";
+    os << std::setw(6) << "step" << std::setw(12) << "direction"
+       << std::setw(14) << "frontier" << std::setw(14) << "edges" << '\n';
+    for (std::size_t i = 0; i != x.steps.size(); ++i) {
+      const traversal_step& s = x.steps[i];
+      std::ostringstream d;
+      d << s.direction;
+      os << std::setw(6) << i << std::setw(12) << d.str()
+         << std::setw(14) << s.frontier << std::setw(14) << s.edges << '\n';
+    }
+    return os;
+  }
+
+
+  namespace search_impl
+  {
+    // The calls are made by tasks of the default scheduler, shared with the
+    // other modules, and each task claims the next call by incrementing a
+    // shared counter until the range is exhausted (see [conc.fork]). A
+    // search makes one call per level, and levels with fewer vertices than
+    // the grain of the search are expanded serially, so the cost of
+    // spawning tasks is only paid when there is enough work to amortize it.
+    void
+    parallel_for(std::size_t n,
+                 std::size_t threads,
+                 const std::function<void(std::size_t)>& f)
+    {
+      parallel_apply(default_scheduler(), n, threads, f);
+    }
+  } // namespace search_impl
+
+} // namespace origin
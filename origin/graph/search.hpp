@@ -0,0 +1,1121 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_SEARCH_HPP
+#define ORIGIN_GRAPH_SEARCH_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
+#include <vector>
+
+#include <origin/data/bit_vector/bit_vector.hpp>
+#include <origin/instrument/instrument.hpp>
+#include <origin/sequence/generator.hpp>
+#include <origin/sequence/range.hpp>
+#include <origin/graph/concepts.hpp>
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                              [graph.search]
+  //                              Graph Search
+  //
+  // The search algorithms traverse the vertices of a graph reachable from a
+  // source vertex, calling the operations of a visitor as vertices and edges
+  // are encountered. They are written against the generic graph interface,
+  // and apply to any directed graph (one with out_edges(v) and in_edges(v))
+  // or undirected graph (one with edges(v)). In an undirected graph, every
+  // incident edge of a vertex is followed.
+  //
+  // The following searches are provided:
+  //
+  //    breadth_first_search(g, s, vis)
+  //    parallel_breadth_first_search(g, s, vis[, stats][, threads])
+  //    breadth_first_levels(g, s[, stats][, threads])
+  //    depth_first_search(g, s, vis)
+  //    depth_first_search(g, vis)
+  //    breadth_first_order(g, s)
+  //    depth_first_order(g, s)
+  //
+  // Search state is stored in vectors indexed by vertex handle, so each
+  // search allocates memory proportional to the largest vertex handle in g.
+  //
+  // The order algorithms return generators (see [seq.generator]) of the
+  // vertices reachable from s, in the order in which a breadth-first or
+  // depth-first search discovers them. The search advances as the vertices
+  // are read, so that a traversal can be stopped early, or consumed by the
+  // range algorithms, without a visitor:
+  //
+  //    auto order = breadth_first_order(g, s);
+  //    auto i = find_if(order, [&](Vertex<G> v) { return is_goal(v); });
+
+
+  // Returns the maximum number of threads used by a parallel search. By
+  // default, this is the number of hardware threads available.
+  std::size_t search_threads();
+
+  // Set the maximum number of threads used by a parallel search. If n is 0,
+  // the default (the number of hardware threads) is restored. Setting n to
+  // 1 makes all searches serial.
+  void set_search_threads(std::size_t n);
+
+  // Returns the prefetch distance of the parallel search and the iterative
+  // algorithms: the number of edges ahead of the one being examined whose
+  // targets are prefetched (see [graph.prefetch]). The default is 8.
+  std::size_t search_prefetch_distance();
+
+  // Set the prefetch distance. Setting n to 0 disables prefetching.
+  void set_search_prefetch_distance(std::size_t n);
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                        [graph.traversal]
+  //                          Traversal Statistics
+  //
+  // The parallel search, the shortest path algorithms and the iterative
+  // algorithms report what they traversed into a traversal_stats object,
+  // when they are given one:
+  //
+  //    traversal_stats st;
+  //    auto levels = breadth_first_levels(g, s, st);
+  //    std::cout << st;   // Levels, directions, edges and TEPS
+  //
+  // The statistics are the number of edges examined, the number of vertices
+  // reached (or settled, or ranked), the time of the traversal, and a
+  // record of each of its steps: the levels of a search, the phases of
+  // delta-stepping (each a relaxation of the light edges leaving a bucket),
+  // or the sweeps of an iterative algorithm. A step records the size of its
+  // frontier, the edges it examined, and its direction: top-down steps
+  // follow the edges leaving the frontier (a push sweep), and bottom-up ones
+  // search the edges entering unvisited vertices (a pull sweep).
+  //
+  // The traversed edges per second (TEPS) are computed as by Graph500: the
+  // number of edges in the traversed component, each edge of an undirected
+  // graph counted once, divided by the time. A direction-optimizing search
+  // examines far fewer edges than that, which is the point; the ratio of
+  // the two shows how much work the bottom-up levels saved. Each sweep of an
+  // iterative algorithm traverses every edge of the graph.
+  //
+  // Whether or not statistics are requested, the same totals are counted at
+  // the following instrumentation sites (see instrument):
+  //
+  //    graph.bfs.top_down      A level of the parallel search, top-down
+  //    graph.bfs.bottom_up     A level of the parallel search, bottom-up
+  //    graph.bfs.edges         An edge examined by the parallel search
+  //    graph.sssp.phases       A phase of delta-stepping
+  //    graph.sssp.edges        An edge relaxed by a shortest path algorithm
+  //    graph.iterative.sweeps  A sweep of an iterative algorithm
+  //    graph.iterative.edges   An edge read by an iterative algorithm
+  //
+  // and each traversal is timed at graph.bfs, graph.dijkstra,
+  // graph.delta_stepping or graph.pagerank.
+
+
+  // The direction of a step of a traversal.
+  enum class traversal_direction { top_down, bottom_up };
+
+  // Write the name of the direction d.
+  std::ostream& operator<<(std::ostream& os, traversal_direction d);
+
+  // A step of a traversal: a level, a phase, or a sweep.
+  struct traversal_step
+  {
+    std::size_t         frontier;  // The vertices expanded
+    std::uint64_t       edges;     // The edges examined
+    traversal_direction direction;
+  };
+
+  // The statistics of a traversal.
+  struct traversal_stats
+  {
+    traversal_stats()
+      : edges(0), component_edges(0), vertices(0), seconds(0)
+    { }
+
+    // Reset the statistics.
+    void clear() { *this = traversal_stats(); }
+
+    // Returns the number of steps in the direction d.
+    std::size_t count(traversal_direction d) const
+    {
+      return std::count_if(steps.begin(), steps.end(),
+                           [d](const traversal_step& x) {
+                             return x.direction == d;
+                           });
+    }
+
+    // Returns the traversed edges per second.
+    double teps() const
+    {
+      return seconds > 0 ? double(component_edges) / seconds : 0;
+    }
+
+    std::uint64_t edges;           // Edges examined
+    std::uint64_t component_edges; // Edges of the traversed component
+    std::uint64_t vertices;        // Vertices reached
+    double        seconds;         // The time of the traversal
+    std::vector<traversal_step> steps;
+  };
+
+  // Write the totals of the statistics x, and one line per step.
+  std::ostream& operator<<(std::ostream& os, const traversal_stats& x);
+
+
+  namespace search_impl
+  {
+    // Call f(i) for each i in [0, n), using up to threads threads, including
+    // the calling thread. If any call throws an exception, one of those
+    // exceptions is rethrown after all calls complete. See search.cpp.
+    void parallel_for(std::size_t n,
+                      std::size_t threads,
+                      const std::function<void(std::size_t)>& f);
+
+
+    // Returns the edges followed from v: the out edges of a directed graph
+    // or the incident edges of an undirected graph.
+    template<typename G>
+      inline auto
+      successor_edges(const G& g, Vertex<G> v) -> decltype(g.out_edges(v))
+      {
+        return g.out_edges(v);
+      }
+
+    template<typename G>
+      inline auto
+      successor_edges(const G& g, Vertex<G> v) -> decltype(g.edges(v))
+      {
+        return g.edges(v);
+      }
+
+    // Returns the edges through which v is reached: the in edges of a
+    // directed graph or the incident edges of an undirected graph.
+    template<typename G>
+      inline auto
+      predecessor_edges(const G& g, Vertex<G> v) -> decltype(g.in_edges(v))
+      {
+        return g.in_edges(v);
+      }
+
+    template<typename G>
+      inline auto
+      predecessor_edges(const G& g, Vertex<G> v) -> decltype(g.edges(v))
+      {
+        return g.edges(v);
+      }
+
+    // Returns the number of edges followed from v.
+    template<typename G>
+      inline auto
+      successor_degree(const G& g, Vertex<G> v) -> decltype(g.out_degree(v))
+      {
+        return g.out_degree(v);
+      }
+
+    template<typename G>
+      inline auto
+      successor_degree(const G& g, Vertex<G> v)
+        -> decltype(g.edges(v), std::size_t())
+      {
+        return g.degree(v);
+      }
+
+    // ---------------------------------------------------------------------- //
+    //                                                        [graph.prefetch]
+    //                          Prefetching Traversal
+    //
+    // Following an incident edge reads the edge record, to find the vertex
+    // at its other end, and then the data of that vertex. In a large graph
+    // each is a cache miss, and the second depends on the first, so that a
+    // traversal waits on memory at every edge. A prefetched edge range
+    // looks ahead in the incident edges of a vertex: at a distance of 2d
+    // edges it prefetches the edge record, and at a distance of d, when the
+    // record has arrived, it passes the opposite vertex to a prefetcher,
+    // which prefetches what the traversal reads for that vertex: its entry
+    // in the state of the search. By the time the traversal reaches the
+    // edge, both are in cache.
+    //
+    // A graph supports prefetching of its edge records by providing
+    // g.prefetch_edge(e), as the adjacency lists do. Other graphs, whose
+    // edge records are read in order or are stored in the incident edge
+    // lists, only call the prefetcher.
+
+    // Prefetch the record of the edge e, if g supports it.
+    template<typename G>
+      inline auto
+      prefetch_edge(const G& g, Edge<G> e, int)
+        -> decltype(g.prefetch_edge(e))
+      {
+        g.prefetch_edge(e);
+      }
+
+    template<typename G>
+      inline void
+      prefetch_edge(const G&, Edge<G>, long)
+      { }
+
+    // Prefetches the element of a vector, or the word of a bit vector,
+    // indexed by a vertex. If write is true, it is prefetched for writing.
+    template<typename T, bool Write = false>
+      struct element_prefetcher
+      {
+        template<typename V>
+          void operator()(V v) const
+          {
+            __builtin_prefetch(first + std::size_t(v) / per, Write);
+          }
+
+        const T* first;
+        std::size_t per; // The number of vertices per element
+      };
+
+    template<typename T>
+      inline element_prefetcher<T>
+      prefetch_elements(const std::vector<T>& v)
+      {
+        return {v.data(), 1};
+      }
+
+    template<typename T>
+      inline element_prefetcher<T, true>
+      prefetch_elements_for_write(const T* p)
+      {
+        return {p, 1};
+      }
+
+    template<typename A>
+      inline element_prefetcher<std::uint64_t>
+      prefetch_elements(const basic_bit_vector<A>& v)
+      {
+        return {v.data(), bit_vector_impl::word_bits};
+      }
+
+    // The iterator of a prefetched edge range. It holds the current
+    // position in the incident edges of u and the two positions ahead of
+    // it, which are equal to last when prefetching is disabled or when
+    // they reach the end.
+    template<typename G, typename I, typename F>
+      class prefetch_iterator
+      {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Edge<G>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Edge<G>*;
+        using reference = Edge<G>;
+
+        // Construct an iterator at the position i.
+        prefetch_iterator(I i)
+          : g(nullptr), u(), cur(i), near(i), far(i), last(i), f()
+        { }
+
+        // Construct an iterator over [first, last), prefetching the first
+        // 2d edge records and the first d targets.
+        prefetch_iterator(const G& g, Vertex<G> u, I first, I last,
+                          std::size_t d, const F& f)
+          : g(&g), u(u), cur(first), near(last), far(last), last(last), f(f)
+        {
+          if (d == 0)
+            return;
+          far = near = first;
+          for (std::size_t i = 0; i != 2 * d && far != last; ++i)
+            prefetch_edge(g, *far++, 0);
+          for (std::size_t i = 0; i != d && near != last; ++i)
+            this->f(opposite(g, *near++, u));
+        }
+
+        Edge<G> operator*() const { return *cur; }
+
+        prefetch_iterator& operator++()
+        {
+          ++cur;
+          if (far != last)
+            prefetch_edge(*g, *far++, 0);
+          if (near != last)
+            f(opposite(*g, *near++, u));
+          return *this;
+        }
+
+        prefetch_iterator operator++(int)
+        {
+          prefetch_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        bool operator==(const prefetch_iterator& x) const
+        {
+          return cur == x.cur;
+        }
+
+        bool operator!=(const prefetch_iterator& x) const
+        {
+          return cur != x.cur;
+        }
+
+      private:
+        const G*  g;
+        Vertex<G> u;
+        I         cur;
+        I         near; // The next edge whose target is prefetched
+        I         far;  // The next edge whose record is prefetched
+        I         last;
+        F         f;
+      };
+
+    // Returns the edges of the range r, incident to u, prefetching the edge
+    // records and passing the opposite vertices to f at the distance d.
+    template<typename G, typename R, typename F>
+      inline auto
+      prefetched(const G& g, Vertex<G> u, const R& r, std::size_t d,
+                 const F& f)
+        -> bounded_range<prefetch_iterator<G, decltype(std::begin(r)), F>>
+      {
+        using Iter = prefetch_iterator<G, decltype(std::begin(r)), F>;
+        return {Iter(g, u, std::begin(r), std::end(r), d, f),
+                Iter(std::end(r))};
+      }
+
+    // Returns the successor edges of v, prefetched at the distance d.
+    template<typename G, typename F>
+      inline auto
+      prefetched_successor_edges(const G& g, Vertex<G> v, std::size_t d,
+                                 const F& f)
+        -> decltype(prefetched(g, v, successor_edges(g, v), d, f))
+      {
+        return prefetched(g, v, successor_edges(g, v), d, f);
+      }
+
+    // Returns the predecessor edges of v, prefetched at the distance d.
+    template<typename G, typename F>
+      inline auto
+      prefetched_predecessor_edges(const G& g, Vertex<G> v, std::size_t d,
+                                   const F& f)
+        -> decltype(prefetched(g, v, predecessor_edges(g, v), d, f))
+      {
+        return prefetched(g, v, predecessor_edges(g, v), d, f);
+      }
+
+
+    // Returns one more than the largest vertex handle in g. Vertex handles
+    // need not be consecutive since vertices may have been removed.
+    template<typename G>
+      std::size_t
+      vertex_bound(const G& g)
+      {
+        std::size_t n = 0;
+        for (Vertex<G> v : g.vertices())
+          n = std::max(n, std::size_t(v) + 1);
+        return n;
+      }
+
+    // Returns the number of edges of a component of g whose vertices have
+    // the given total successor degree.
+    template<typename G>
+      inline std::uint64_t
+      component_edges(const G&, std::uint64_t degrees)
+      {
+        return Undirected_graph<G>() ? degrees / 2 : degrees;
+      }
+
+    // A stats scope clears the statistics of a traversal, if they are
+    // requested, and records the time until it is destroyed.
+    class stats_scope
+    {
+      using clock = std::chrono::steady_clock;
+    public:
+      explicit stats_scope(traversal_stats* st)
+        : st(st)
+      {
+        if (st) {
+          st->clear();
+          start = clock::now();
+        }
+      }
+
+      ~stats_scope()
+      {
+        if (st)
+          st->seconds =
+            std::chrono::duration<double>(clock::now() - start).count();
+      }
+
+      stats_scope(const stats_scope&) = delete;
+      stats_scope& operator=(const stats_scope&) = delete;
+
+    private:
+      traversal_stats* st;
+      clock::time_point start;
+    };
+
+  } // namespace search_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                 [graph.bfs]
+  //                          Breadth-First Search
+  //
+  // A breadth-first search visits the vertices reachable from a source in
+  // order of their distance (in edges) from that source. The operations of a
+  // breadth-first search visitor are:
+  //
+  //    vis.discover_vertex(g, v)   v is reached for the first time
+  //    vis.examine_vertex(g, v)    the successors of v are about to be visited
+  //    vis.examine_edge(g, e)      e is followed from its examined vertex
+  //    vis.tree_edge(g, e)         e is the edge through which a vertex is
+  //                                first reached (before discover_vertex)
+  //    vis.non_tree_edge(g, e)     e leads to an already discovered vertex
+  //    vis.finish_vertex(g, v)     all successors of v have been examined
+  //    vis.start_level(g, d)       the vertices at distance d are about to
+  //                                be examined
+  //
+  // The bfs_visitor class provides empty implementations of each operation,
+  // so that a visitor only needs to define the operations it uses.
+  //
+  // The parallel search is level-synchronous: all vertices at distance d are
+  // expanded, in parallel, before any vertex at distance d + 1. Each level is
+  // expanded either top-down, by following the successor edges of the
+  // vertices at distance d, or bottom-up, by searching the predecessor edges
+  // of each undiscovered vertex for one at distance d. The search switches to
+  // bottom-up when the number of edges leaving the frontier grows beyond a
+  // fraction (1 / alpha) of the edges not yet explored, and back to top-down
+  // when the frontier shrinks below a fraction (1 / beta) of the vertices.
+  // Bottom-up levels avoid examining the many edges that lead to vertices
+  // already discovered, which dominate the middle levels of searches on
+  // low-diameter graphs.
+  //
+  // The parallel search only calls tree_edge, discover_vertex and
+  // start_level. The first two are called exactly once for each reached
+  // vertex (except that no tree edge leads to the source), possibly from
+  // several threads at once; start_level is called from the calling thread
+  // between levels. Within a level, vertices are discovered in no particular
+  // order.
+
+  struct bfs_visitor
+  {
+    template<typename G>
+      void discover_vertex(const G&, Vertex<G>) { }
+
+    template<typename G>
+      void examine_vertex(const G&, Vertex<G>) { }
+
+    template<typename G>
+      void examine_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void tree_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void non_tree_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void finish_vertex(const G&, Vertex<G>) { }
+
+    template<typename G>
+      void start_level(const G&, std::size_t) { }
+  };
+
+
+  // Visit the vertices of g reachable from s in breadth-first order.
+  template<typename G, typename Vis>
+    void
+    breadth_first_search(const G& g, Vertex<G> s, Vis&& vis)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using V = Vertex<G>;
+
+      // The queue holds every discovered vertex. Vertices in [head, end) are
+      // waiting to be examined, and those in [head, level) are at the depth
+      // currently being examined.
+      std::vector<char> seen(search_impl::vertex_bound(g));
+      std::vector<V> queue;
+      std::size_t head = 0;
+      std::size_t level = 1;
+      std::size_t depth = 0;
+      std::size_t d = search_prefetch_distance();
+      auto f = search_impl::prefetch_elements(seen);
+
+      seen[s] = true;
+      vis.discover_vertex(g, s);
+      queue.push_back(s);
+      vis.start_level(g, depth);
+      while (head != queue.size()) {
+        if (head == level) {
+          level = queue.size();
+          vis.start_level(g, ++depth);
+        }
+
+        V u = queue[head++];
+        vis.examine_vertex(g, u);
+        for (Edge<G> e : search_impl::prefetched_successor_edges(g, u, d, f)) {
+          vis.examine_edge(g, e);
+          V v = opposite(g, e, u);
+          if (!seen[v]) {
+            seen[v] = true;
+            vis.tree_edge(g, e);
+            vis.discover_vertex(g, v);
+            queue.push_back(v);
+          } else {
+            vis.non_tree_edge(g, e);
+          }
+        }
+        vis.finish_vertex(g, u);
+      }
+    }
+
+
+  namespace search_impl
+  {
+    // Tuning parameters for the direction-optimizing search. The values of
+    // alpha and beta are those suggested by Beamer et al. The grain is the
+    // number of vertices expanded by each parallel task.
+    constexpr std::size_t bfs_alpha = 14;
+    constexpr std::size_t bfs_beta = 24;
+    constexpr std::size_t bfs_grain = 1024;
+
+
+    // The level search implements the parallel breadth-first search. The
+    // frontier holds the vertices at the current depth. If stats is not
+    // null, the levels are recorded in it.
+    template<typename G, typename Vis>
+      class level_search
+      {
+        using V = Vertex<G>;
+      public:
+        level_search(const G& g, Vis& vis, std::size_t threads,
+                     traversal_stats* stats = nullptr);
+
+        void operator()(V s);
+
+      private:
+        std::size_t top_down();
+        std::size_t bottom_up(std::uint64_t& examined);
+
+        void discover(V v, Edge<G> e, std::vector<V>& next);
+        std::size_t merge(std::vector<std::vector<V>>& next);
+
+        std::size_t blocks(std::size_t n) const;
+
+      private:
+        const G& g;
+        Vis& vis;
+        std::size_t threads;
+        traversal_stats* stats;
+        std::size_t distance;    // The prefetch distance
+
+        std::vector<V> verts;    // All vertices of g
+        bit_vector seen;         // Discovered vertices
+        bit_vector current;      // Frontier membership
+        std::vector<V> frontier; // Vertices at this depth
+        std::size_t unexplored;  // Edges not yet explored
+      };
+
+    template<typename G, typename Vis>
+      level_search<G, Vis>::level_search(const G& g, Vis& vis, std::size_t n,
+                                         traversal_stats* st)
+        : g(g), vis(vis), threads(n), stats(st),
+          distance(search_prefetch_distance()), seen(vertex_bound(g)),
+          unexplored(0)
+      {
+        verts.reserve(g.order());
+        for (V v : g.vertices()) {
+          verts.push_back(v);
+          unexplored += successor_degree(g, v);
+        }
+      }
+
+    template<typename G, typename Vis>
+      void
+      level_search<G, Vis>::operator()(V s)
+      {
+        ORIGIN_TIME_SCOPE("graph.bfs");
+        stats_scope scope(stats);
+        seen.set(s);
+        vis.discover_vertex(g, s);
+        frontier.push_back(s);
+
+        // The edges examined, and the vertices reached and their degrees.
+        std::uint64_t total = 0;
+        std::uint64_t reached = 1;
+        std::uint64_t degrees = successor_degree(g, s);
+
+        std::size_t edges = degrees;
+        unexplored -= edges;
+        bool down = true;
+        for (std::size_t depth = 0; !frontier.empty(); ++depth) {
+          vis.start_level(g, depth);
+          std::size_t size = frontier.size();
+          if (down && edges > unexplored / bfs_alpha)
+            down = false;
+
+          // A top-down level examines every edge leaving the frontier.
+          std::uint64_t examined = edges;
+          if (down) {
+            ORIGIN_COUNT("graph.bfs.top_down");
+            edges = top_down();
+          } else {
+            ORIGIN_COUNT("graph.bfs.bottom_up");
+            edges = bottom_up(examined);
+          }
+          ORIGIN_COUNT_N("graph.bfs.edges", examined);
+          if (stats)
+            stats->steps.push_back({size, examined,
+                                    down ? traversal_direction::top_down
+                                         : traversal_direction::bottom_up});
+          total += examined;
+          reached += frontier.size();
+          degrees += edges;
+
+          if (!down && frontier.size() < size
+              && frontier.size() < verts.size() / bfs_beta)
+            down = true;
+          unexplored -= edges;
+        }
+        if (stats) {
+          stats->edges = total;
+          stats->component_edges = component_edges(g, degrees);
+          stats->vertices = reached;
+        }
+      }
+
+    // Record that v is reached through e.
+    template<typename G, typename Vis>
+      inline void
+      level_search<G, Vis>::discover(V v, Edge<G> e, std::vector<V>& next)
+      {
+        vis.tree_edge(g, e);
+        vis.discover_vertex(g, v);
+        next.push_back(v);
+      }
+
+    // Replace the frontier with the vertices discovered by each task,
+    // returning the number of edges leaving the new frontier.
+    template<typename G, typename Vis>
+      std::size_t
+      level_search<G, Vis>::merge(std::vector<std::vector<V>>& next)
+      {
+        frontier.clear();
+        std::size_t edges = 0;
+        for (std::vector<V>& vs : next)
+          for (V v : vs) {
+            frontier.push_back(v);
+            edges += successor_degree(g, v);
+          }
+        return edges;
+      }
+
+    template<typename G, typename Vis>
+      inline std::size_t
+      level_search<G, Vis>::blocks(std::size_t n) const
+      {
+        return (n + bfs_grain - 1) / bfs_grain;
+      }
+
+    // Follow the successor edges of each vertex in the frontier. A vertex is
+    // claimed by the first task to mark it as seen.
+    template<typename G, typename Vis>
+      std::size_t
+      level_search<G, Vis>::top_down()
+      {
+        std::size_t n = frontier.size();
+        std::vector<std::vector<V>> next(blocks(n));
+        auto f = prefetch_elements(seen);
+        parallel_for(next.size(), threads, [&](std::size_t k) {
+          std::size_t last = std::min(n, (k + 1) * bfs_grain);
+          for (std::size_t i = k * bfs_grain; i != last; ++i) {
+            V u = frontier[i];
+            for (Edge<G> e : prefetched_successor_edges(g, u, distance, f)) {
+              V v = opposite(g, e, u);
+              if (!seen.atomic_test(v) && seen.atomic_set(v))
+                discover(v, e, next[k]);
+            }
+          }
+        });
+        return merge(next);
+      }
+
+    // Search the predecessor edges of each undiscovered vertex for one in
+    // the frontier. Each vertex is only updated by the task that owns it,
+    // but the bits of vertices owned by different tasks share words, so
+    // they are still set atomically. The number of edges searched is
+    // stored in examined.
+    template<typename G, typename Vis>
+      std::size_t
+      level_search<G, Vis>::bottom_up(std::uint64_t& examined)
+      {
+        current.resize(seen.size());
+        current.reset();
+        for (V v : frontier)
+          current.set(v);
+
+        std::size_t n = verts.size();
+        std::vector<std::vector<V>> next(blocks(n));
+        std::vector<std::uint64_t> searched(next.size());
+        auto f = prefetch_elements(current);
+        parallel_for(next.size(), threads, [&](std::size_t k) {
+          std::size_t last = std::min(n, (k + 1) * bfs_grain);
+          std::uint64_t m = 0;
+          for (std::size_t i = k * bfs_grain; i != last; ++i) {
+            V v = verts[i];
+            if (seen.atomic_test(v))
+              continue;
+            for (Edge<G> e : prefetched_predecessor_edges(g, v, distance, f)) {
+              ++m;
+              if (current[opposite(g, e, v)]) {
+                seen.atomic_set(v);
+                discover(v, e, next[k]);
+                break;
+              }
+            }
+          }
+          searched[k] = m;
+        });
+        examined = 0;
+        for (std::uint64_t m : searched)
+          examined += m;
+        return merge(next);
+      }
+
+
+    // Records the distance of each discovered vertex from the source.
+    struct level_recorder : bfs_visitor
+    {
+      level_recorder(std::vector<std::size_t>& ls)
+        : levels(ls), depth(0)
+      { }
+
+      template<typename G>
+        void discover_vertex(const G&, Vertex<G> v) { levels[v] = depth; }
+
+      template<typename G>
+        void start_level(const G&, std::size_t d) { depth = d + 1; }
+
+      std::vector<std::size_t>& levels;
+      std::size_t depth;
+    };
+
+  } // namespace search_impl
+
+
+  // Visit the vertices of g reachable from s in breadth-first order, using
+  // up to threads threads (see [graph.bfs]).
+  template<typename G, typename Vis>
+    void
+    parallel_breadth_first_search(const G& g, Vertex<G> s, Vis&& vis,
+                                  std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using Search = search_impl::level_search<G, Remove_reference<Vis>>;
+      Search search(g, vis, threads);
+      search(s);
+    }
+
+  // Visit the vertices of g reachable from s in breadth-first order,
+  // recording the levels of the search in stats (see [graph.traversal]).
+  template<typename G, typename Vis>
+    void
+    parallel_breadth_first_search(const G& g, Vertex<G> s, Vis&& vis,
+                                  traversal_stats& stats,
+                                  std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      using Search = search_impl::level_search<G, Remove_reference<Vis>>;
+      Search search(g, vis, threads, &stats);
+      search(s);
+    }
+
+  // Returns the distance from s to each vertex of g, indexed by vertex
+  // handle. The distance of an unreachable vertex is size_t(-1).
+  template<typename G>
+    std::vector<std::size_t>
+    breadth_first_levels(const G& g, Vertex<G> s,
+                         std::size_t threads = search_threads())
+    {
+      std::vector<std::size_t> levels(search_impl::vertex_bound(g), -1);
+      parallel_breadth_first_search(g, s, search_impl::level_recorder(levels),
+                                    threads);
+      return levels;
+    }
+
+  template<typename G>
+    std::vector<std::size_t>
+    breadth_first_levels(const G& g, Vertex<G> s, traversal_stats& stats,
+                         std::size_t threads = search_threads())
+    {
+      std::vector<std::size_t> levels(search_impl::vertex_bound(g), -1);
+      parallel_breadth_first_search(g, s, search_impl::level_recorder(levels),
+                                    stats, threads);
+      return levels;
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                 [graph.dfs]
+  //                           Depth-First Search
+  //
+  // A depth-first search follows the successor edges of the most recently
+  // discovered vertex until it reaches a vertex with no undiscovered
+  // successors, and then backtracks. The search is iterative, so its depth
+  // is not limited by the call stack. The operations of a depth-first search
+  // visitor are:
+  //
+  //    vis.start_vertex(g, v)            v is the root of a search tree
+  //    vis.discover_vertex(g, v)         v is reached for the first time
+  //    vis.examine_edge(g, e)            e is followed from the current vertex
+  //    vis.tree_edge(g, e)               e leads to an undiscovered vertex
+  //    vis.back_edge(g, e)               e leads to an unfinished vertex
+  //    vis.forward_or_cross_edge(g, e)   e leads to a finished vertex
+  //    vis.finish_vertex(g, v)           all successors of v are finished
+  //
+  // Note that in an undirected graph, the edge through which a vertex was
+  // reached is examined again from that vertex, and is reported as a back
+  // edge.
+
+  struct dfs_visitor
+  {
+    template<typename G>
+      void start_vertex(const G&, Vertex<G>) { }
+
+    template<typename G>
+      void discover_vertex(const G&, Vertex<G>) { }
+
+    template<typename G>
+      void examine_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void tree_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void back_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void forward_or_cross_edge(const G&, Edge<G>) { }
+
+    template<typename G>
+      void finish_vertex(const G&, Vertex<G>) { }
+  };
+
+
+  namespace search_impl
+  {
+    // The color of a vertex during a depth-first search.
+    enum dfs_color : char { white, gray, black };
+
+    // Visit the vertices reachable from s that have not yet been discovered.
+    template<typename G, typename Vis>
+      void
+      depth_first_visit(const G& g, Vertex<G> s,
+                        std::vector<char>& color, Vis& vis)
+      {
+        using V = Vertex<G>;
+        using Range = decltype(successor_edges(g, s));
+        using Iter = decltype(std::declval<Range>().begin());
+
+        // A frame records the position of the search in the successor edges
+        // of a discovered vertex.
+        struct frame
+        {
+          V u;
+          Iter first;
+          Iter last;
+        };
+        std::vector<frame> stack;
+
+        auto discover = [&](V u) {
+          color[u] = gray;
+          vis.discover_vertex(g, u);
+          Range r = successor_edges(g, u);
+          stack.push_back(frame {u, r.begin(), r.end()});
+        };
+
+        discover(s);
+        while (!stack.empty()) {
+          frame& f = stack.back();
+          if (f.first == f.last) {
+            color[f.u] = black;
+            vis.finish_vertex(g, f.u);
+            stack.pop_back();
+            continue;
+          }
+
+          V u = f.u;
+          Edge<G> e = *f.first;
+          ++f.first;
+          vis.examine_edge(g, e);
+          V v = opposite(g, e, u);
+          switch (color[v]) {
+          case white:
+            vis.tree_edge(g, e);
+            discover(v);
+            break;
+          case gray:
+            vis.back_edge(g, e);
+            break;
+          default:
+            vis.forward_or_cross_edge(g, e);
+            break;
+          }
+        }
+      }
+
+  } // namespace search_impl
+
+
+  // Visit the vertices of g reachable from s in depth-first order.
+  template<typename G, typename Vis>
+    void
+    depth_first_search(const G& g, Vertex<G> s, Vis&& vis)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      std::vector<char> color(search_impl::vertex_bound(g), search_impl::white);
+      vis.start_vertex(g, s);
+      search_impl::depth_first_visit(g, s, color, vis);
+    }
+
+  // Visit every vertex of g in depth-first order. A new search is started
+  // from each vertex not discovered by a previous search, in the order in
+  // which the vertices of g are enumerated.
+  template<typename G, typename Vis>
+    void
+    depth_first_search(const G& g, Vis&& vis)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      std::vector<char> color(search_impl::vertex_bound(g), search_impl::white);
+      for (Vertex<G> v : g.vertices()) {
+        if (color[v] == search_impl::white) {
+          vis.start_vertex(g, v);
+          search_impl::depth_first_visit(g, v, color, vis);
+        }
+      }
+    }
+
+
+
+  namespace search_impl
+  {
+    // The step function of a breadth-first order generator. The successors
+    // of a vertex are discovered when it is read.
+    template<typename G>
+      struct bfs_order
+      {
+        bool operator()(Vertex<G>& x)
+        {
+          if (head == queue.size())
+            return false;
+          Vertex<G> u = queue[head++];
+          for (Edge<G> e : successor_edges(*g, u)) {
+            Vertex<G> v = opposite(*g, e, u);
+            if (!seen[v]) {
+              seen[v] = true;
+              queue.push_back(v);
+            }
+          }
+          x = u;
+          return true;
+        }
+
+        const G* g;
+        std::vector<char> seen;
+        std::vector<Vertex<G>> queue;
+        std::size_t head;
+      };
+
+    // The step function of a depth-first order generator. The stack holds
+    // the position of the search in the successor edges of each vertex on
+    // the current path, as for depth_first_visit.
+    template<typename G>
+      struct dfs_order
+      {
+        using Range = decltype(successor_edges(std::declval<const G&>(),
+                                               std::declval<Vertex<G>>()));
+        using Iter = decltype(std::declval<Range>().begin());
+
+        struct frame
+        {
+          Vertex<G> u;
+          Iter first;
+          Iter last;
+        };
+
+        bool operator()(Vertex<G>& x)
+        {
+          if (!started) {
+            started = true;
+            return discover(source, x);
+          }
+          while (!stack.empty()) {
+            frame& f = stack.back();
+            if (f.first == f.last) {
+              stack.pop_back();
+              continue;
+            }
+            Vertex<G> v = opposite(*g, *f.first, f.u);
+            ++f.first;
+            if (!seen[v])
+              return discover(v, x);
+          }
+          return false;
+        }
+
+        bool discover(Vertex<G> v, Vertex<G>& x)
+        {
+          seen[v] = true;
+          Range r = successor_edges(*g, v);
+          stack.push_back(frame {v, r.begin(), r.end()});
+          x = v;
+          return true;
+        }
+
+        const G* g;
+        std::vector<char> seen;
+        std::vector<frame> stack;
+        Vertex<G> source;
+        bool started;
+      };
+
+  } // namespace search_impl
+
+
+  // Returns a generator of the vertices of g reachable from s, in
+  // breadth-first order.
+  template<typename G>
+    generator<Vertex<G>>
+    breadth_first_order(const G& g, Vertex<G> s)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      search_impl::bfs_order<G> step {
+        &g, std::vector<char>(search_impl::vertex_bound(g)), {s}, 0
+      };
+      step.seen[s] = true;
+      return generator<Vertex<G>>(std::move(step));
+    }
+
+  // Returns a generator of the vertices of g reachable from s, in
+  // depth-first order.
+  template<typename G>
+    generator<Vertex<G>>
+    depth_first_order(const G& g, Vertex<G> s)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      search_impl::dfs_order<G> step {
+        &g, std::vector<char>(search_impl::vertex_bound(g)), {}, s, false
+      };
+      return generator<Vertex<G>>(std::move(step));
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,306 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <origin/graph/search.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Records the order of search events as a string of vertex names.
+struct trace_bfs : bfs_visitor
+{
+  template<typename G>
+    void discover_vertex(const G& g, Vertex<G> v) { out += g(v); }
+
+  template<typename G>
+    void start_level(const G&, size_t) { out += '|'; }
+
+  string out;
+};
+
+struct trace_dfs : dfs_visitor
+{
+  template<typename G>
+    void start_vertex(const G& g, Vertex<G> v) { out += '<'; }
+
+  template<typename G>
+    void discover_vertex(const G& g, Vertex<G> v) { out += g(v); }
+
+  template<typename G>
+    void back_edge(const G& g, Edge<G> e) { ++back; }
+
+  template<typename G>
+    void forward_or_cross_edge(const G& g, Edge<G> e) { ++cross; }
+
+  template<typename G>
+    void finish_vertex(const G& g, Vertex<G> v) { out += char(g(v) - 'a' + 'A'); }
+
+  string out;
+  int back = 0;
+  int cross = 0;
+};
+
+template<typename G>
+  void
+  check_bfs_order()
+  {
+    // a -> b, a -> c, b -> d, c -> d, d -> e
+    G g = build_n_graph<G>(6);
+    g.add_edge(0, 1, 0);
+    g.add_edge(0, 2, 1);
+    g.add_edge(1, 3, 2);
+    g.add_edge(2, 3, 3);
+    g.add_edge(3, 4, 4);
+
+    trace_bfs vis;
+    breadth_first_search(g, 0, vis);
+    assert(vis.out == "a|bc|d|e|");
+
+    vector<size_t> ls = breadth_first_levels(g, 0, 1);
+    assert((ls == vector<size_t>{0, 1, 1, 2, 3, size_t(-1)}));
+  }
+
+// The parallel search finds the same distances as the serial search on
+// graphs large enough to be expanded in parallel, and switches between
+// top-down and bottom-up levels.
+template<typename G>
+  void
+  check_bfs_levels(const G& g)
+  {
+    struct serial_levels : bfs_visitor
+    {
+      void discover_vertex(const G&, Vertex<G> v) { levels[v] = depth; }
+      void start_level(const G&, size_t d) { depth = d + 1; }
+
+      vector<size_t> levels;
+      size_t depth = 0;
+    } vis;
+    vis.levels.assign(g.order(), -1);
+    breadth_first_search(g, 0, vis);
+
+    assert(breadth_first_levels(g, 0, 1) == vis.levels);
+    assert(breadth_first_levels(g, 0, 4) == vis.levels);
+
+    // The statistics agree with the levels.
+    traversal_stats st;
+    assert(breadth_first_levels(g, 0, st, 4) == vis.levels);
+    size_t reached = 0, depth = 0;
+    uint64_t degrees = 0;
+    for (Vertex<G> v : g.vertices())
+      if (vis.levels[v] != size_t(-1)) {
+        ++reached;
+        depth = max(depth, vis.levels[v]);
+        degrees += search_impl::successor_degree(g, v);
+      }
+    assert(st.vertices == reached && st.steps.size() == depth + 1);
+    assert(st.component_edges == search_impl::component_edges(g, degrees));
+    uint64_t frontier = 0, edges = 0;
+    for (const traversal_step& x : st.steps) {
+      frontier += x.frontier;
+      edges += x.edges;
+    }
+    assert(frontier == reached && edges == st.edges);
+    assert(st.edges <= degrees || st.count(traversal_direction::bottom_up));
+    assert(st.seconds > 0 && st.teps() > 0);
+    ostringstream os;
+    os << st;
+    assert(os.str().find(" steps (") != string::npos);
+  }
+
+// A prefetched range has the same edges as the range it wraps, whatever
+// the distance, and the searches find the same levels with and without
+// prefetching.
+template<typename G>
+  void
+  check_prefetch(const G& g)
+  {
+    vector<char> seen(g.order());
+    auto f = search_impl::prefetch_elements(seen);
+    for (size_t d : {0, 1, 3, 64})
+      for (Vertex<G> v : g.vertices()) {
+        vector<Edge<G>> a, b;
+        for (Edge<G> e : search_impl::successor_edges(g, v))
+          a.push_back(e);
+        for (Edge<G> e : search_impl::prefetched_successor_edges(g, v, d, f))
+          b.push_back(e);
+        assert(a == b);
+      }
+
+    assert(search_prefetch_distance() == 8);
+    vector<size_t> ls = breadth_first_levels(g, 0, 4);
+    for (size_t d : {0, 1, 64}) {
+      set_search_prefetch_distance(d);
+      assert(breadth_first_levels(g, 0, 4) == ls);
+      assert(breadth_first_levels(g, 0, 1) == ls);
+    }
+    set_search_prefetch_distance(8);
+  }
+
+void
+check_bfs_tree()
+{
+  using G = directed_adjacency_list<char, int>;
+  G g = build_erdos_renyi_graph<G>(5000, 40000, 1);
+  vector<size_t> ls = breadth_first_levels(g, 0, 4);
+
+  struct tree_recorder : bfs_visitor
+  {
+    tree_recorder(const G& g)
+      : parent(g.order(), -1)
+    { }
+
+    void tree_edge(const G& g, Edge<G> e) { parent[g.target(e)] = g.source(e); }
+
+    vector<size_t> parent;
+  } vis(g);
+  parallel_breadth_first_search(g, 0, vis, 4);
+
+  for (Vertex<G> v : g.vertices()) {
+    if (v == 0 || ls[v] == size_t(-1)) {
+      assert(vis.parent[v] == size_t(-1));
+    } else {
+      assert(vis.parent[v] != size_t(-1));
+      assert(ls[vis.parent[v]] + 1 == ls[v]);
+    }
+  }
+}
+
+void
+check_bfs_removed()
+{
+  // Handles are not consecutive after removing a vertex.
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 0);
+  g.add_edge(1, 2, 1);
+  g.add_edge(2, 3, 2);
+  g.add_edge(0, 3, 3);
+  g.remove_vertex(1);
+
+  vector<size_t> ls = breadth_first_levels(g, 3, 2);
+  assert(ls.size() == 4);
+  assert(ls[0] == 1 && ls[1] == size_t(-1) && ls[2] == 1 && ls[3] == 0);
+}
+
+void
+check_dfs()
+{
+  // A directed cycle a -> b -> c -> a with a chord a -> c, and a
+  // separate vertex d with an edge to a.
+  using D = directed_adjacency_list<char, int>;
+  D g = build_n_graph<D>(4);
+  g.add_edge(0, 1, 0);
+  g.add_edge(1, 2, 1);
+  g.add_edge(2, 0, 2);
+  g.add_edge(0, 2, 3);
+  g.add_edge(3, 0, 4);
+
+  trace_dfs vis;
+  depth_first_search(g, 0, vis);
+  assert(vis.out == "<abcCBA");
+  assert(vis.back == 1);
+  assert(vis.cross == 1);
+
+  trace_dfs all;
+  depth_first_search(g, all);
+  assert(all.out == "<abcCBA<dD");
+  assert(all.cross == 2);
+
+  // In an undirected path, each tree edge is examined again from its
+  // target as a back edge.
+  using G = undirected_adjacency_list<char, int>;
+  G h = build_n_graph<G>(3);
+  h.add_edge(0, 1, 0);
+  h.add_edge(1, 2, 1);
+  trace_dfs uvis;
+  depth_first_search(h, 1, uvis);
+  assert(uvis.out == "<baAcCB");
+  assert(uvis.back == 2);
+
+  // The search is not limited by the depth of the call stack.
+  D p = build_n_graph<D>(1);
+  for (int i = 1; i != 200000; ++i) {
+    p.add_vertex('a');
+    p.add_edge(i - 1, i, i);
+  }
+  struct counter : dfs_visitor
+  {
+    void discover_vertex(const D&, Vertex<D>) { ++n; }
+    size_t n = 0;
+  } c;
+  depth_first_search(p, 0, c);
+  assert(c.n == 200000);
+}
+
+// The order generators yield the vertices in the order in which the
+// searches discover them, and can be abandoned early.
+template<typename G>
+  void
+  check_orders(const G& g)
+  {
+    struct bfs_recorder : bfs_visitor
+    {
+      void discover_vertex(const G&, Vertex<G> v) { out.push_back(v); }
+      vector<Vertex<G>> out;
+    } bfs;
+    struct dfs_recorder : dfs_visitor
+    {
+      void discover_vertex(const G&, Vertex<G> v) { out.push_back(v); }
+      vector<Vertex<G>> out;
+    } dfs;
+    breadth_first_search(g, 0, bfs);
+    depth_first_search(g, 0, dfs);
+
+    vector<Vertex<G>> v;
+    for (Vertex<G> u : breadth_first_order(g, 0))
+      v.push_back(u);
+    assert(v == bfs.out);
+    v.clear();
+    for (Vertex<G> u : depth_first_order(g, 0))
+      v.push_back(u);
+    assert(v == dfs.out);
+
+    auto order = depth_first_order(g, 0);
+    auto i = order.begin();
+    for (size_t k = 0; k != 10 && i != order.end(); ++k)
+      ++i;
+  }
+
+int main()
+{
+  check_bfs_order<directed_adjacency_list<char, int>>();
+  check_bfs_order<undirected_adjacency_list<char, int>>();
+
+  using D = directed_adjacency_list<char, int>;
+  using U = undirected_adjacency_list<char, int>;
+  check_bfs_levels(build_erdos_renyi_graph<D>(20000, 200000, 2));
+  check_bfs_levels(build_erdos_renyi_graph<U>(20000, 100000, 3));
+  check_bfs_levels(build_reflexive_clique<U>(300));
+  check_bfs_levels(compressed_graph<char, int>(
+    build_erdos_renyi_graph<D>(20000, 60000, 4)));
+
+  check_prefetch(build_erdos_renyi_graph<D>(5000, 50000, 5));
+  check_prefetch(build_erdos_renyi_graph<U>(5000, 25000, 6));
+  check_prefetch(compressed_graph<char, int>(
+    build_erdos_renyi_graph<D>(500, 5000, 7)));
+
+  check_bfs_tree();
+  check_bfs_removed();
+  check_dfs();
+  check_orders(build_erdos_renyi_graph<D>(2000, 6000, 8));
+  check_orders(build_erdos_renyi_graph<U>(2000, 3000, 9));
+}
@@ -0,0 +1,675 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_SHORTEST_PATHS_HPP
+#define ORIGIN_GRAPH_SHORTEST_PATHS_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <origin/data/heap/indexed_heap.hpp>
+#include <origin/graph/search.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                       [graph.shortest_path]
+  //                        Single-Source Shortest Paths
+  //
+  // The shortest path algorithms compute the distance from a source vertex to
+  // every vertex of a graph, where the length of each edge e is its value,
+  // g(e). Edge values must be non-negative and of an arithmetic type. As with
+  // the search algorithms, directed graphs are searched along their out
+  // edges, and every incident edge of a vertex in an undirected graph is
+  // followed. The following algorithms are provided:
+  //
+  //    dijkstra_shortest_paths(g, s, dist, pred[, stats])
+  //    dijkstra_distances(g, s)
+  //    delta_stepping_distances(g, s[, delta[, stats][, threads]])
+  //    shortest_distances(g, s[, stats][, threads])
+  //
+  // Distances are returned in vectors indexed by vertex handle. The distance
+  // to a vertex that is not reachable from s is unreachable_distance<W>():
+  // infinity when W has one, and its maximum value otherwise.
+  //
+  // Dijkstra's algorithm settles vertices in order of their distance using
+  // an indexed 4-ary heap of vertices (see data.indexed_heap), which makes
+  // it the best choice for small graphs or when the shortest path tree is
+  // needed.
+  //
+  // The delta-stepping algorithm (Meyer and Sanders) partitions vertices
+  // into buckets of width delta by their tentative distance, and settles each
+  // bucket in a number of parallel phases. Edges of length at most delta are
+  // "light" and are relaxed repeatedly, until no vertex re-enters the current
+  // bucket. "Heavy" edges can only reach later buckets, so each is relaxed
+  // just once, after the bucket is settled. A small delta makes the
+  // algorithm behave like Dijkstra's, with little parallelism in each
+  // bucket; a large one makes it behave like Bellman-Ford, with much
+  // redundant work. The default is the largest edge length divided by the
+  // average degree, which is a good choice for randomly weighted graphs.
+  //
+  // Given a traversal_stats object (see [graph.traversal]), the algorithms
+  // record the edges they relax and the vertices they settle. The phases
+  // of delta-stepping are recorded as its steps; Dijkstra's algorithm has
+  // none.
+
+
+  // The type of edge lengths in the graph G.
+  template<typename G>
+    using Edge_weight =
+      Decay<decltype(std::declval<const G&>()(std::declval<Edge<G>>()))>;
+
+  // Returns the distance of a vertex that is not reachable.
+  template<typename W>
+    constexpr W
+    unreachable_distance()
+    {
+      return std::numeric_limits<W>::has_infinity
+        ? std::numeric_limits<W>::infinity()
+        : std::numeric_limits<W>::max();
+    }
+
+
+  namespace shortest_path_impl
+  {
+    // Dijkstra's algorithm, recording its statistics in stats if it is not
+    // null.
+    template<typename G, typename W>
+      void
+      dijkstra(const G& g, Vertex<G> s,
+               std::vector<W>& dist,
+               std::vector<Vertex<G>>& pred,
+               traversal_stats* stats)
+      {
+        static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+        using V = Vertex<G>;
+
+        ORIGIN_TIME_SCOPE("graph.dijkstra");
+        search_impl::stats_scope scope(stats);
+        std::size_t n = search_impl::vertex_bound(g);
+        dist.assign(n, unreachable_distance<W>());
+        pred.assign(n, V());
+
+        // The edges relaxed, and the vertices settled.
+        std::uint64_t edges = 0;
+        std::uint64_t settled = 0;
+
+        indexed_heap<W, 4, std::less<W>, V> heap(n);
+        dist[s] = W(0);
+        heap.push(s, W(0));
+        while (!heap.empty()) {
+          V u = heap.top();
+          heap.pop();
+          ++settled;
+          W d = dist[u];
+          for (Edge<G> e : search_impl::successor_edges(g, u)) {
+            assert(!(g(e) < W(0)));
+            ++edges;
+            V v = opposite(g, e, u);
+            W x = d + g(e);
+            if (x < dist[v]) {
+              dist[v] = x;
+              pred[v] = u;
+              heap.update(v, x);
+            }
+          }
+        }
+        ORIGIN_COUNT_N("graph.sssp.edges", edges);
+        if (stats) {
+          stats->edges = edges;
+          stats->component_edges = search_impl::component_edges(g, edges);
+          stats->vertices = settled;
+        }
+      }
+  } // namespace shortest_path_impl
+
+
+  // Compute the distance from s to each vertex of g, and the predecessor of
+  // each vertex in a shortest path tree. The predecessor of s and of each
+  // unreachable vertex is the invalid vertex handle.
+  template<typename G, typename W>
+    void
+    dijkstra_shortest_paths(const G& g, Vertex<G> s,
+                            std::vector<W>& dist,
+                            std::vector<Vertex<G>>& pred)
+    {
+      shortest_path_impl::dijkstra(g, s, dist, pred, nullptr);
+    }
+
+  template<typename G, typename W>
+    void
+    dijkstra_shortest_paths(const G& g, Vertex<G> s,
+                            std::vector<W>& dist,
+                            std::vector<Vertex<G>>& pred,
+                            traversal_stats& stats)
+    {
+      shortest_path_impl::dijkstra(g, s, dist, pred, &stats);
+    }
+
+  // Returns the distance from s to each vertex of g, computed by Dijkstra's
+  // algorithm.
+  template<typename G>
+    std::vector<Edge_weight<G>>
+    dijkstra_distances(const G& g, Vertex<G> s)
+    {
+      std::vector<Edge_weight<G>> dist;
+      std::vector<Vertex<G>> pred;
+      dijkstra_shortest_paths(g, s, dist, pred);
+      return dist;
+    }
+
+
+  namespace shortest_path_impl
+  {
+    // The number of vertices relaxed by each parallel task.
+    constexpr std::size_t grain = 256;
+
+    // The delta stepping class implements the parallel search. If stats is
+    // not null, the phases are recorded in it.
+    template<typename G>
+      class delta_stepping
+      {
+        using V = Vertex<G>;
+        using W = Edge_weight<G>;
+      public:
+        delta_stepping(const G& g, W delta, std::size_t threads,
+                       traversal_stats* stats = nullptr);
+
+        std::vector<W> operator()(V s);
+
+      private:
+        std::uint64_t relax(const std::vector<V>& vs, bool light);
+        void enqueue(V v);
+
+        std::size_t bucket(W d) const { return std::size_t(d / delta); }
+
+      private:
+        const G& g;
+        W delta;
+        std::size_t threads;
+        traversal_stats* stats;
+
+        std::vector<std::atomic<W>> dist;        // Tentative distances
+        std::vector<std::size_t> slot;           // Bucket holding each vertex
+        std::vector<std::vector<V>> buckets;     // Vertices by distance
+        std::vector<std::vector<V>> updated;     // Vertices updated by a task
+        std::vector<std::uint64_t> relaxed;      // Edges relaxed by a task
+      };
+
+    template<typename G>
+      delta_stepping<G>::delta_stepping(const G& g, W d, std::size_t n,
+                                        traversal_stats* st)
+        : g(g), delta(d), threads(n), stats(st)
+        , dist(search_impl::vertex_bound(g))
+        , slot(dist.size(), -1)
+      {
+        assert(W(0) < delta);
+        for (std::atomic<W>& x : dist)
+          x.store(unreachable_distance<W>(), std::memory_order_relaxed);
+      }
+
+    template<typename G>
+      std::vector<Edge_weight<G>>
+      delta_stepping<G>::operator()(V s)
+      {
+        ORIGIN_TIME_SCOPE("graph.delta_stepping");
+        search_impl::stats_scope scope(stats);
+        dist[s].store(W(0), std::memory_order_relaxed);
+        enqueue(s);
+
+        // The edges relaxed, and the vertices settled and their degrees.
+        std::uint64_t edges = 0;
+        std::uint64_t reached = 0;
+        std::uint64_t degrees = 0;
+
+        // The vertices removed from the current bucket. Each is added once,
+        // no matter how many times it re-enters the bucket.
+        std::vector<V> settled;
+        std::vector<char> done(dist.size());
+        std::vector<V> frontier;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+          settled.clear();
+          while (!buckets[i].empty()) {
+            // Take the vertices whose distance still lies in this bucket. A
+            // vertex queued in a later bucket is skipped once its distance
+            // has decreased into an earlier one.
+            frontier.clear();
+            for (V v : buckets[i]) {
+              if (slot[v] != i)
+                continue;
+              slot[v] = -1;
+              frontier.push_back(v);
+              if (!done[v]) {
+                done[v] = true;
+                settled.push_back(v);
+                degrees += search_impl::successor_degree(g, v);
+              }
+            }
+            buckets[i].clear();
+            std::uint64_t m = relax(frontier, true);
+            ORIGIN_COUNT("graph.sssp.phases");
+            if (stats)
+              stats->steps.push_back({frontier.size(), m,
+                                      traversal_direction::top_down});
+            edges += m;
+          }
+          edges += relax(settled, false);
+          reached += settled.size();
+          std::vector<V>().swap(buckets[i]);
+        }
+        ORIGIN_COUNT_N("graph.sssp.edges", edges);
+        if (stats) {
+          stats->edges = edges;
+          stats->component_edges = search_impl::component_edges(g, degrees);
+          stats->vertices = reached;
+        }
+
+        std::vector<W> result(dist.size());
+        for (std::size_t v = 0; v != dist.size(); ++v)
+          result[v] = dist[v].load(std::memory_order_relaxed);
+        return result;
+      }
+
+    // Queue v in the bucket of its tentative distance, unless it is already
+    // there.
+    template<typename G>
+      inline void
+      delta_stepping<G>::enqueue(V v)
+      {
+        std::size_t b = bucket(dist[v].load(std::memory_order_relaxed));
+        if (slot[v] == b)
+          return;
+        if (b >= buckets.size())
+          buckets.resize(b + 1);
+        buckets[b].push_back(v);
+        slot[v] = b;
+      }
+
+    // Relax the light (or heavy) edges leaving each vertex of vs in parallel,
+    // returning the number of edges relaxed. The distance of a target is
+    // lowered with an atomic compare-and-swap, and each task records the
+    // targets that it improves. They are queued by the calling thread once
+    // all tasks have finished.
+    template<typename G>
+      std::uint64_t
+      delta_stepping<G>::relax(const std::vector<V>& vs, bool light)
+      {
+        std::size_t n = vs.size();
+        updated.resize(std::max(updated.size(), (n + grain - 1) / grain));
+        relaxed.resize(updated.size());
+        std::size_t blocks = (n + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::vector<V>& out = updated[k];
+          std::size_t last = std::min(n, (k + 1) * grain);
+          std::uint64_t m = 0;
+          for (std::size_t i = k * grain; i != last; ++i) {
+            V u = vs[i];
+            W d = dist[u].load(std::memory_order_relaxed);
+            for (Edge<G> e : search_impl::successor_edges(g, u)) {
+              W w = g(e);
+              assert(!(w < W(0)));
+              if ((w <= delta) != light)
+                continue;
+              ++m;
+              V v = opposite(g, e, u);
+              W x = d + w;
+              std::atomic<W>& y = dist[v];
+              W cur = y.load(std::memory_order_relaxed);
+              while (x < cur) {
+                if (y.compare_exchange_weak(cur, x,
+                                            std::memory_order_relaxed)) {
+                  out.push_back(v);
+                  break;
+                }
+              }
+            }
+          }
+          relaxed[k] = m;
+        });
+        std::uint64_t m = 0;
+        for (std::size_t k = 0; k != blocks; ++k) {
+          for (V v : updated[k])
+            enqueue(v);
+          updated[k].clear();
+          m += relaxed[k];
+        }
+        return m;
+      }
+
+
+    // Returns the default bucket width for g: the largest edge length
+    // divided by the average degree. If every edge has length 0, the width
+    // is 1.
+    template<typename G>
+      Edge_weight<G>
+      default_delta(const G& g)
+      {
+        using W = Edge_weight<G>;
+        W max = W(0);
+        std::size_t m = 0;
+        for (Edge<G> e : g.edges()) {
+          max = std::max(max, g(e));
+          ++m;
+        }
+        std::size_t n = std::max<std::size_t>(g.order(), 1);
+        double deg = std::max(double(m) / double(n), 1.0);
+        W delta = W(double(max) / deg);
+        return W(0) < delta ? delta : W(1);
+      }
+
+  } // namespace shortest_path_impl
+
+
+  // Returns the distance from s to each vertex of g, computed by the
+  // delta-stepping algorithm using buckets of width delta and up to threads
+  // threads (see [graph.shortest_path]).
+  template<typename G>
+    std::vector<Edge_weight<G>>
+    delta_stepping_distances(const G& g, Vertex<G> s, Edge_weight<G> delta,
+                             std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      shortest_path_impl::delta_stepping<G> search(g, delta, threads);
+      return search(s);
+    }
+
+  template<typename G>
+    std::vector<Edge_weight<G>>
+    delta_stepping_distances(const G& g, Vertex<G> s)
+    {
+      Edge_weight<G> delta = shortest_path_impl::default_delta(g);
+      return delta_stepping_distances(g, s, delta);
+    }
+
+  // Returns the distance from s to each vertex of g, computed by the
+  // delta-stepping algorithm, recording its phases in stats.
+  template<typename G>
+    std::vector<Edge_weight<G>>
+    delta_stepping_distances(const G& g, Vertex<G> s, Edge_weight<G> delta,
+                             traversal_stats& stats,
+                             std::size_t threads = search_threads())
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      shortest_path_impl::delta_stepping<G> search(g, delta, threads, &stats);
+      return search(s);
+    }
+
+  // Returns the distance from s to each vertex of g. Delta-stepping is used
+  // when more than one thread is available and the graph is large enough to
+  // benefit from it; otherwise, Dijkstra's algorithm is used.
+  template<typename G>
+    std::vector<Edge_weight<G>>
+    shortest_distances(const G& g, Vertex<G> s,
+                       std::size_t threads = search_threads())
+    {
+      if (threads > 1 && g.size() >= 64 * shortest_path_impl::grain) {
+        Edge_weight<G> delta = shortest_path_impl::default_delta(g);
+        return delta_stepping_distances(g, s, delta, threads);
+      }
+      return dijkstra_distances(g, s);
+    }
+
+  template<typename G>
+    std::vector<Edge_weight<G>>
+    shortest_distances(const G& g, Vertex<G> s, traversal_stats& stats,
+                       std::size_t threads = search_threads())
+    {
+      if (threads > 1 && g.size() >= 64 * shortest_path_impl::grain) {
+        Edge_weight<G> delta = shortest_path_impl::default_delta(g);
+        return delta_stepping_distances(g, s, delta, stats, threads);
+      }
+      std::vector<Edge_weight<G>> dist;
+      std::vector<Vertex<G>> pred;
+      dijkstra_shortest_paths(g, s, dist, pred, stats);
+      return dist;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.path_query]
+  //                       Point-to-Point Shortest Paths
+  //
+  //    path_query<G> q(g)
+  //    q.bidirectional_dijkstra(s, t)
+  //    q.astar(s, t, h)
+  //    q.path()
+  //
+  // A path query finds the distance from one vertex to another, and a
+  // shortest path between them, where the length of each edge e is g(e), as
+  // in [graph.shortest_path]. A query object holds the workspace of the
+  // searches: the tentative distances, predecessors and heaps of a forward
+  // and a backward search. It is meant to be reused for many queries, which
+  // then allocate no memory. Each entry of the workspace is stamped with the
+  // query that wrote it, so that an entry with an older stamp is known to be
+  // unset, and starting a query costs O(1) rather than O(n); the heaps are
+  // emptied in time proportional to their size. Both searches return
+  // unreachable_distance<W>() when t is not reachable from s, and path()
+  // returns the vertices of a shortest path found by the last query, from s
+  // to t, or an empty vector if there is none. A query object refers to its
+  // graph, which must not be modified while it is used, and is not safe to
+  // use from several threads at once; use one query object per thread.
+  //
+  // The bidirectional_dijkstra search runs Dijkstra's algorithm forward from
+  // s along successor edges and backward from t along predecessor edges,
+  // expanding the search with the lesser least distance, and stops once the
+  // sum of the least distances of the two searches is no less than the best
+  // path found through a vertex reached by both. It typically settles far
+  // fewer vertices than a single search from s.
+  //
+  // The astar search is the A* algorithm: a forward search ordered by the
+  // distance from s plus the estimate h(v) of the distance from v to t. The
+  // heuristic h must never overestimate that distance, and when it is
+  // consistent (h(u) <= g(e) + h(v) for each edge e from u to v) each vertex
+  // is settled at most once. A zero heuristic makes it Dijkstra's algorithm,
+  // stopped when t is settled.
+
+  namespace shortest_path_impl
+  {
+    // The workspace of one direction of a point-to-point search. The
+    // distance and predecessor of v are set when stamp[v] is the stamp of
+    // the current query.
+    template<typename G>
+      struct search_side
+      {
+        using V = Vertex<G>;
+        using W = Edge_weight<G>;
+
+        explicit search_side(std::size_t n)
+          : dist(n), pred(n), stamp(n, 0), heap(n)
+        { }
+
+        bool reached(V v, std::uint32_t now) const { return stamp[v] == now; }
+
+        // Set the distance and predecessor of v, and its key in the heap.
+        void reach(V v, W d, V p, W key, std::uint32_t now)
+        {
+          dist[v] = d;
+          pred[v] = p;
+          stamp[v] = now;
+          heap.update(v, key);
+        }
+
+        std::vector<W> dist;
+        std::vector<V> pred;
+        std::vector<std::uint32_t> stamp;
+        indexed_heap<W, 4, std::less<W>, V> heap;
+      };
+
+  } // namespace shortest_path_impl
+
+
+  template<typename G>
+    class path_query
+    {
+      using side = shortest_path_impl::search_side<G>;
+
+    public:
+      using vertex = Vertex<G>;
+      using weight = Edge_weight<G>;
+
+      // Initialize a workspace for queries on g.
+      explicit path_query(const G& g)
+        : g(g)
+        , fwd(search_impl::vertex_bound(g))
+        , bwd(search_impl::vertex_bound(g))
+        , now(0)
+      { }
+
+      // Returns the distance from s to t, found by a bidirectional search.
+      weight bidirectional_dijkstra(vertex s, vertex t);
+
+      // Returns the distance from s to t, found by an A* search with the
+      // heuristic h.
+      template<typename H>
+        weight astar(vertex s, vertex t, H h);
+
+      // Returns a shortest path from the source to the target of the last
+      // query.
+      std::vector<vertex> path() const;
+
+    private:
+      // Start a new query.
+      void start(vertex s, vertex t);
+
+      // Settle the least vertex u of a, whose edges are es, and update the
+      // best path found through a vertex reached by both a and b.
+      template<typename R>
+        void expand(side& a, const side& b, vertex u, R es, weight& best);
+
+    private:
+      const G& g;
+      side fwd;
+      side bwd;
+      std::uint32_t now;  // The stamp of the current query
+      vertex source;
+      vertex target;
+      vertex meet;        // The vertex joining the two halves of the path
+    };
+
+  template<typename G>
+    void
+    path_query<G>::start(vertex s, vertex t)
+    {
+      // Clear the stamps when they wrap around, once in 2^32 queries.
+      if (++now == 0) {
+        std::fill(fwd.stamp.begin(), fwd.stamp.end(), 0);
+        std::fill(bwd.stamp.begin(), bwd.stamp.end(), 0);
+        now = 1;
+      }
+      fwd.heap.clear();
+      bwd.heap.clear();
+      source = s;
+      target = t;
+      meet = vertex();
+    }
+
+  template<typename G>
+    template<typename R>
+      inline void
+      path_query<G>::expand(side& a, const side& b, vertex u, R es,
+                            weight& best)
+      {
+        weight d = a.dist[u];
+        for (Edge<G> e : es) {
+          assert(!(g(e) < weight(0)));
+          vertex v = opposite(g, e, u);
+          weight x = d + g(e);
+          if (!a.reached(v, now) || x < a.dist[v])
+            a.reach(v, x, u, x, now);
+          if (b.reached(v, now) && a.dist[v] + b.dist[v] < best) {
+            best = a.dist[v] + b.dist[v];
+            meet = v;
+          }
+        }
+      }
+
+  template<typename G>
+    auto
+    path_query<G>::bidirectional_dijkstra(vertex s, vertex t) -> weight
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      start(s, t);
+      fwd.reach(s, weight(0), vertex(), weight(0), now);
+      bwd.reach(t, weight(0), vertex(), weight(0), now);
+      weight best = unreachable_distance<weight>();
+      if (s == t) {
+        meet = s;
+        best = weight(0);
+      }
+      while (!fwd.heap.empty() && !bwd.heap.empty()) {
+        weight df = fwd.heap.key(fwd.heap.top());
+        weight db = bwd.heap.key(bwd.heap.top());
+        if (!(df + db < best))
+          break;
+        if (!(db < df)) {
+          vertex u = fwd.heap.top();
+          fwd.heap.pop();
+          expand(fwd, bwd, u, search_impl::successor_edges(g, u), best);
+        } else {
+          vertex u = bwd.heap.top();
+          bwd.heap.pop();
+          expand(bwd, fwd, u, search_impl::predecessor_edges(g, u), best);
+        }
+      }
+      return best;
+    }
+
+  template<typename G>
+    template<typename H>
+      auto
+      path_query<G>::astar(vertex s, vertex t, H h) -> weight
+      {
+        static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+        start(s, t);
+        fwd.reach(s, weight(0), vertex(), weight(h(s)), now);
+        while (!fwd.heap.empty()) {
+          vertex u = fwd.heap.top();
+          fwd.heap.pop();
+          if (u == t) {
+            meet = t;
+            return fwd.dist[t];
+          }
+          weight d = fwd.dist[u];
+          for (Edge<G> e : search_impl::successor_edges(g, u)) {
+            assert(!(g(e) < weight(0)));
+            vertex v = opposite(g, e, u);
+            weight x = d + g(e);
+            if (!fwd.reached(v, now) || x < fwd.dist[v])
+              fwd.reach(v, x, u, x + weight(h(v)), now);
+          }
+        }
+        return unreachable_distance<weight>();
+      }
+
+  template<typename G>
+    auto
+    path_query<G>::path() const -> std::vector<vertex>
+    {
+      std::vector<vertex> p;
+      if (!meet)
+        return p;
+      for (vertex v = meet; v != source; v = fwd.pred[v])
+        p.push_back(v);
+      p.push_back(source);
+      std::reverse(p.begin(), p.end());
+      for (vertex v = meet; v != target; ) {
+        v = bwd.pred[v];
+        p.push_back(v);
+      }
+      return p;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,250 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <cmath>
+#include <random>
+
+#include <origin/graph/shortest_paths.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns a random edge length. The lengths are multiples of 1/8 in [0, 8),
+// so that sums of lengths are exact.
+double
+random_length(minstd_rand& prng)
+{
+  return uniform_int_distribution<int>(0, 63)(prng) / 8.0;
+}
+
+// Returns the distances from s computed by the Bellman-Ford algorithm.
+template<typename G>
+  vector<Edge_weight<G>>
+  bellman_ford(const G& g, Vertex<G> s)
+  {
+    using W = Edge_weight<G>;
+    vector<W> dist(g.order(), unreachable_distance<W>());
+    dist[s] = 0;
+    for (bool changed = true; changed; ) {
+      changed = false;
+      for (Edge<G> e : g.edges()) {
+        Vertex<G> u = g.source(e);
+        Vertex<G> v = g.target(e);
+        if (dist[u] != unreachable_distance<W>() && dist[u] + g(e) < dist[v]) {
+          dist[v] = dist[u] + g(e);
+          changed = true;
+        }
+        if (!Directed_graph<G>()
+            && dist[v] != unreachable_distance<W>()
+            && dist[v] + g(e) < dist[u]) {
+          dist[u] = dist[v] + g(e);
+          changed = true;
+        }
+      }
+    }
+    return dist;
+  }
+
+void
+check_heap()
+{
+  indexed_heap<int> h(10);
+  assert(h.empty());
+  int keys[] = {5, 3, 8, 1, 9, 7, 2, 6, 4, 0};
+  for (int i = 0; i != 10; ++i)
+    h.push(i, keys[i]);
+  assert(h.size() == 10);
+  assert(h.top() == 9);
+
+  h.decrease(4, -1);
+  assert(h.top() == 4);
+  assert(!h.update(2, 20));
+  assert(h.update(2, -2));
+  assert(h.top() == 2);
+
+  h.pop();
+  assert(!h.contains(2));
+  assert(h.update(2, 100));
+
+  vector<size_t> order;
+  while (!h.empty()) {
+    order.push_back(h.top());
+    h.pop();
+  }
+  assert((order == vector<size_t>{4, 9, 3, 6, 1, 8, 0, 7, 5, 2}));
+}
+
+void
+check_dijkstra()
+{
+  // a -> b (4), a -> c (1), c -> b (2), b -> d (1), and e is unreachable.
+  using G = directed_adjacency_list<char, double>;
+  G g = build_n_graph<G>(5);
+  g.add_edge(0, 1, 4);
+  g.add_edge(0, 2, 1);
+  g.add_edge(2, 1, 2);
+  g.add_edge(1, 3, 1);
+
+  vector<double> dist;
+  vector<Vertex<G>> pred;
+  dijkstra_shortest_paths(g, 0, dist, pred);
+  assert((dist == vector<double>{0, 3, 1, 4, unreachable_distance<double>()}));
+  assert(!pred[0] && pred[1] == 2 && pred[2] == 0 && pred[3] == 1 && !pred[4]);
+
+  assert(delta_stepping_distances(g, 0, 1.0, 2) == dist);
+  assert(shortest_distances(g, 0) == dist);
+
+  // Four vertices are settled by following the four edges of the graph,
+  // and delta-stepping relaxes each edge in one phase or another.
+  traversal_stats st;
+  dijkstra_shortest_paths(g, 0, dist, pred, st);
+  assert(st.vertices == 4 && st.edges == 4 && st.component_edges == 4);
+  assert(st.steps.empty());
+  assert(delta_stepping_distances(g, 0, 1.0, st, 2) == dist);
+  assert(st.vertices == 4 && st.edges >= 4 && st.component_edges == 4);
+  assert(!st.steps.empty());
+  assert(st.count(traversal_direction::top_down) == st.steps.size());
+}
+
+// Dijkstra's algorithm and delta-stepping find the same distances as the
+// Bellman-Ford algorithm, with any bucket width and number of threads.
+template<typename G>
+  void
+  check_distances(const G& g)
+  {
+    auto dist = bellman_ford(g, 0);
+    assert(dijkstra_distances(g, 0) == dist);
+    assert(delta_stepping_distances(g, 0, 0.5, 1) == dist);
+    assert(delta_stepping_distances(g, 0, 0.5, 4) == dist);
+    assert(delta_stepping_distances(g, 0, 100.0, 4) == dist);
+    assert(delta_stepping_distances(g, 0) == dist);
+    assert(shortest_distances(g, 0, 4) == dist);
+  }
+
+void
+check_integral()
+{
+  // Integral lengths use the maximum value for unreachable vertices.
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_reflexive_clique<G>(6);
+  g.add_vertex('z');
+  auto dist = dijkstra_distances(g, 5);
+  assert((dist == vector<int>{5, 6, 7, 8, 9, 0, numeric_limits<int>::max()}));
+  assert(delta_stepping_distances(g, 5, 3, 4) == dist);
+}
+
+// The length of a path is the sum of the least edge lengths between its
+// consecutive vertices.
+template<typename G>
+  Edge_weight<G>
+  path_length(const G& g, const vector<Vertex<G>>& p)
+  {
+    using W = Edge_weight<G>;
+    W len = 0;
+    for (size_t i = 1; i < p.size(); ++i) {
+      W least = unreachable_distance<W>();
+      for (Edge<G> e : search_impl::successor_edges(g, p[i - 1]))
+        if (opposite(g, e, p[i - 1]) == p[i])
+          least = min(least, g(e));
+      assert(least != unreachable_distance<W>());
+      len += least;
+    }
+    return len;
+  }
+
+// Point-to-point queries find the distances found by Dijkstra's algorithm,
+// and paths of that length, reusing one workspace for every query.
+template<typename G>
+  void
+  check_queries(const G& g)
+  {
+    using W = Edge_weight<G>;
+    path_query<G> q(g);
+    minstd_rand prng(g.order());
+    uniform_int_distribution<size_t> vert(0, g.order() - 1);
+    for (size_t i = 0; i != 20; ++i) {
+      Vertex<G> s = vert(prng);
+      auto dist = dijkstra_distances(g, s);
+      for (size_t j = 0; j != 20; ++j) {
+        Vertex<G> t = j == 0 ? s : Vertex<G>(vert(prng));
+        W d = q.bidirectional_dijkstra(s, t);
+        assert(d == dist[t]);
+        auto p = q.path();
+        if (d == unreachable_distance<W>()) {
+          assert(p.empty());
+        } else {
+          assert(p.front() == s && p.back() == t);
+          assert(path_length(g, p) == d);
+        }
+        assert(q.astar(s, t, [](Vertex<G>) { return W(0); }) == dist[t]);
+        assert(q.path() == p || path_length(g, q.path()) == d);
+      }
+    }
+  }
+
+// A* with the Manhattan distance finds shortest paths in a grid whose edge
+// lengths are at least 1.
+void
+check_astar()
+{
+  using G = undirected_adjacency_list<char, double>;
+  const size_t w = 60, h = 40;
+  G g = build_n_graph<G>(w * h);
+  minstd_rand prng(1);
+  uniform_int_distribution<int> len(8, 31);
+  for (size_t y = 0; y != h; ++y)
+    for (size_t x = 0; x != w; ++x) {
+      if (x + 1 != w)
+        g.add_edge(y * w + x, y * w + x + 1, len(prng) / 8.0);
+      if (y + 1 != h)
+        g.add_edge(y * w + x, (y + 1) * w + x, len(prng) / 8.0);
+    }
+  path_query<G> q(g);
+  for (size_t i = 0; i != 50; ++i) {
+    size_t s = prng() % (w * h), t = prng() % (w * h);
+    auto manhattan = [&](Vertex<G> v) {
+      double dx = abs(double(v % w) - double(t % w));
+      double dy = abs(double(v / w) - double(t / w));
+      return dx + dy;
+    };
+    double d = dijkstra_distances(g, s)[t];
+    assert(q.astar(s, t, manhattan) == d);
+    assert(path_length(g, q.path()) == d);
+    assert(q.bidirectional_dijkstra(s, t) == d);
+  }
+}
+
+int main()
+{
+  check_heap();
+  check_dijkstra();
+
+  using D = directed_adjacency_list<char, double>;
+  using U = undirected_adjacency_list<char, double>;
+  using A = directed_adjacency_vector<char, double>;
+  check_distances(build_erdos_renyi_graph<D>(2000, 10000, 1, random_length));
+  check_distances(build_erdos_renyi_graph<U>(2000, 6000, 2, random_length));
+  check_distances(build_erdos_renyi_graph<A>(20000, 100000, 3, random_length));
+  check_distances(compressed_graph<char, double>(
+    build_erdos_renyi_graph<D>(20000, 80000, 4, random_length)));
+
+  check_integral();
+
+  check_queries(build_erdos_renyi_graph<D>(2000, 6000, 5, random_length));
+  check_queries(build_erdos_renyi_graph<U>(2000, 3000, 6, random_length));
+  using C = compressed_graph<char, double>;
+  check_queries(C(build_erdos_renyi_graph<D>(500, 800, 7, random_length)));
+  check_astar();
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstring>
+
+#include <ostream>
+#include <stdexcept>
+
+#include "snapshot.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                            Snapshot Header
+
+  namespace
+  {
+    const char snapshot_magic[8] = {'O', 'R', 'I', 'G', 'I', 'N', 'G', 'S'};
+
+    constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+
+    // Returns n rounded up to a multiple of 8.
+    inline std::uint64_t
+    align(std::uint64_t n)
+    {
+      return (n + 7) & ~std::uint64_t(7);
+    }
+
+    // Throws an exception indicating that the file is not a snapshot.
+    [[noreturn]] void
+    invalid_snapshot(const char* what)
+    {
+      throw std::runtime_error(std::string("invalid graph snapshot: ") + what);
+    }
+
+    // Returns true if the section [off, off + n) lies within a file of the
+    // given length, and is aligned.
+    bool
+    valid_section(std::uint64_t off, std::uint64_t n, std::uint64_t length)
+    {
+      return off % 8 == 0 && off <= length && n <= length - off;
+    }
+
+    // Check that the header describes a snapshot of the given length.
+    void
+    check_header(const snapshot_header& h, std::size_t length)
+    {
+      if (std::memcmp(h.magic, snapshot_magic, sizeof(h.magic)) != 0)
+        invalid_snapshot("bad magic number");
+      if (h.byte_order != snapshot_byte_order)
+        invalid_snapshot("byte order does not match");
+      if (h.version != snapshot_header::current_version)
+        invalid_snapshot("unsupported version");
+      if (h.length != length)
+        invalid_snapshot("truncated file");
+
+      // Guard the section lengths against overflow.
+      std::uint64_t max = std::uint64_t(-1) / 8 - 1;
+      if (h.order > max || h.size > max)
+        invalid_snapshot("bad order or size");
+      if (h.vertex_size && h.order > std::uint64_t(-1) / h.vertex_size)
+        invalid_snapshot("bad vertex size");
+      if (h.edge_size && h.size > std::uint64_t(-1) / h.edge_size)
+        invalid_snapshot("bad edge size");
+
+      std::uint64_t offsets = 8 * (h.order + 1);
+      std::uint64_t edges = 8 * h.size;
+      if (!valid_section(h.out_offsets, offsets, length)
+          || !valid_section(h.sources, edges, length)
+          || !valid_section(h.targets, edges, length)
+          || !valid_section(h.in_offsets, offsets, length)
+          || !valid_section(h.in_edges, edges, length)
+          || !valid_section(h.vertex_values, h.order * h.vertex_size, length)
+          || !valid_section(h.edge_values, h.size * h.edge_size, length))
+        invalid_snapshot("section out of bounds");
+    }
+  } // namespace
+
+  constexpr std::uint32_t snapshot_header::current_version;
+
+  snapshot_header
+  make_snapshot_header(std::size_t n,
+                       std::size_t m,
+                       std::size_t vertex_size,
+                       std::size_t edge_size)
+  {
+    snapshot_header h;
+    std::memcpy(h.magic, snapshot_magic, sizeof(h.magic));
+    h.version = snapshot_header::current_version;
+    h.byte_order = snapshot_byte_order;
+    h.order = n;
+    h.size = m;
+    h.vertex_size = vertex_size;
+    h.edge_size = edge_size;
+
+    std::uint64_t off = align(sizeof(snapshot_header));
+    auto place = [&off](std::uint64_t n) {
+      std::uint64_t x = off;
+      off = align(off + n);
+      return x;
+    };
+    h.out_offsets = place(8 * (n + 1));
+    h.sources = place(8 * m);
+    h.targets = place(8 * m);
+    h.in_offsets = place(8 * (n + 1));
+    h.in_edges = place(8 * m);
+    h.vertex_values = place(n * vertex_size);
+    h.edge_values = place(m * edge_size);
+    h.length = off;
+    return h;
+  }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                             Snapshot File
+
+  snapshot_file::snapshot_file(const std::string& path, io::map_mode m)
+    : file_(path, m)
+  {
+    if (file_.size() < sizeof(snapshot_header))
+      invalid_snapshot("truncated file");
+    check_header(header(), file_.size());
+  }
+
+  const snapshot_header&
+  snapshot_file::header() const
+  {
+    return *reinterpret_cast<const snapshot_header*>(data());
+  }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Snapshot Writer
+
+  namespace snapshot_impl
+  {
+    // The number of bytes buffered before writing to the stream.
+    constexpr std::size_t buffer_size = 1 << 16;
+
+    writer::writer(std::ostream& os)
+      : os(os), pos(0)
+    {
+      buf.reserve(buffer_size);
+    }
+
+    void
+    writer::put(const void* p, std::size_t n)
+    {
+      const char* s = static_cast<const char*>(p);
+      if (buf.size() + n > buffer_size)
+        flush();
+      if (n >= buffer_size)
+        os.write(s, n);
+      else
+        buf.insert(buf.end(), s, s + n);
+      pos += n;
+    }
+
+    void
+    writer::pad(std::uint64_t n)
+    {
+      assert(pos <= n);
+      static const char zeros[8] = { };
+      while (pos != n)
+        put(zeros, std::min<std::uint64_t>(n - pos, sizeof(zeros)));
+    }
+
+    void
+    writer::flush()
+    {
+      os.write(buf.data(), buf.size());
+      buf.clear();
+    }
+  } // namespace snapshot_impl
+
+} // namespace origin
@@ -0,0 +1,344 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_SNAPSHOT_HPP
+#define ORIGIN_GRAPH_SNAPSHOT_HPP
+
+#include <cstdint>
+
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/io.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.snapshot]
+  //                              Graph Snapshots
+  //
+  // A graph snapshot is a binary file holding a graph in compressed sparse
+  // row (CSR) format, in the same layout as a compressed graph. Snapshots
+  // are written by write_snapshot(os, g), and are loaded by memory-mapping
+  // the file into a graph_snapshot, a read-only graph whose vertices, edges,
+  // and values refer directly to the mapped file. Loading a snapshot does not
+  // parse or copy its contents; pages are read from the file as they are
+  // first used.
+  //
+  // A snapshot file consists of a header, followed by these sections:
+  //
+  //    out offsets     n + 1 words; the out edges of v are [off[v], off[v + 1])
+  //    sources         m words; the source of each edge
+  //    targets         m words; the target of each edge
+  //    in offsets      n + 1 words; offsets into the in edges section
+  //    in edges        m words; the in edges of each vertex
+  //    vertex values   n values of vertex_size bytes
+  //    edge values     m values of edge_size bytes
+  //
+  // where n is the order and m the size of the graph, and each word is an
+  // unsigned 64-bit integer. The header records the byte offset of each
+  // section, and each section is aligned to 8 bytes. Integers and values are
+  // stored in the byte order of the machine that wrote the snapshot, and a
+  // snapshot is rejected if loaded on a machine of different byte order.
+  //
+  // Vertex and edge values are stored by copying their object
+  // representation, so the value types must be trivially copyable, and a
+  // snapshot can only be loaded with value types of the same size as those
+  // with which it was written.
+
+
+  // The header of a snapshot file.
+  struct snapshot_header
+  {
+    static constexpr std::uint32_t current_version = 1;
+
+    char          magic[8];       // "ORIGINGS"
+    std::uint32_t version;        // Format version
+    std::uint32_t byte_order;     // 0x01020304, in the writer's byte order
+    std::uint64_t order;          // Number of vertices
+    std::uint64_t size;           // Number of edges
+    std::uint64_t vertex_size;    // Size of each vertex value
+    std::uint64_t edge_size;      // Size of each edge value
+    std::uint64_t out_offsets;    // Offset of each section
+    std::uint64_t sources;
+    std::uint64_t targets;
+    std::uint64_t in_offsets;
+    std::uint64_t in_edges;
+    std::uint64_t vertex_values;
+    std::uint64_t edge_values;
+    std::uint64_t length;         // Length of the file
+  };
+
+  // Returns the header of a snapshot with n vertices and m edges having
+  // values of the given sizes. See snapshot.cpp.
+  snapshot_header make_snapshot_header(std::size_t n,
+                                       std::size_t m,
+                                       std::size_t vertex_size,
+                                       std::size_t edge_size);
+
+
+  // A snapshot file is a read-only memory mapping of a snapshot. Opening a
+  // snapshot file validates its header; a std::system_error is thrown if the
+  // file cannot be mapped, and a std::runtime_error if it is not a valid
+  // snapshot. Snapshot files can be moved but not copied.
+  //
+  // When the mode is io::map_mode::huge_pages, the snapshot is read into
+  // memory backed by huge pages instead, so that traversals of very large
+  // graphs incur fewer TLB misses.
+  class snapshot_file
+  {
+  public:
+    explicit snapshot_file(const std::string& path,
+                           io::map_mode m = io::map_mode::paged);
+
+    // Observers
+    const snapshot_header& header() const;
+    const char*            data() const   { return file_.data(); }
+    std::size_t            length() const { return file_.size(); }
+
+  private:
+    io::mapped_file file_;
+  };
+
+
+  namespace snapshot_impl
+  {
+    // Buffers the bytes of a snapshot being written to an output stream.
+    class writer
+    {
+    public:
+      explicit writer(std::ostream& os);
+
+      // Write n bytes starting at p.
+      void put(const void* p, std::size_t n);
+
+      // Write a word.
+      void word(std::uint64_t w) { put(&w, sizeof(w)); }
+
+      // Write zero bytes until the length of the output is n.
+      void pad(std::uint64_t n);
+
+      // Write any buffered bytes to the stream.
+      void flush();
+
+    private:
+      std::ostream& os;
+      std::vector<char> buf;
+      std::uint64_t pos;
+    };
+
+    // Values of type T can be stored in a snapshot.
+    template<typename T>
+      constexpr bool
+      storable()
+      {
+        return std::is_trivially_copyable<T>::value && alignof(T) <= 8;
+      }
+
+  } // namespace snapshot_impl
+
+
+  // Write the graph g to os as a snapshot. Note that the data written at the
+  // start of the file depends on the final structure of the graph, so that a
+  // graph that is not already a compressed graph is first copied into one.
+  // Errors are reported through the state of os.
+  template<typename V, typename E>
+    void
+    write_snapshot(std::ostream& os, const compressed_graph<V, E>& g)
+    {
+      static_assert(snapshot_impl::storable<V>(), "");
+      static_assert(snapshot_impl::storable<E>(), "");
+
+      snapshot_header h =
+        make_snapshot_header(g.order(), g.size(), sizeof(V), sizeof(E));
+      snapshot_impl::writer out(os);
+      out.put(&h, sizeof(h));
+
+      out.pad(h.out_offsets);
+      std::uint64_t off = 0;
+      out.word(off);
+      for (vertex_handle v : g.vertices())
+        out.word(off += g.out_degree(v));
+
+      out.pad(h.sources);
+      for (edge_handle e : g.edges())
+        out.word(g.source(e));
+
+      out.pad(h.targets);
+      for (edge_handle e : g.edges())
+        out.word(g.target(e));
+
+      out.pad(h.in_offsets);
+      off = 0;
+      out.word(off);
+      for (vertex_handle v : g.vertices())
+        out.word(off += g.in_degree(v));
+
+      out.pad(h.in_edges);
+      for (vertex_handle v : g.vertices())
+        for (edge_handle e : g.in_edges(v))
+          out.word(e);
+
+      out.pad(h.vertex_values);
+      for (vertex_handle v : g.vertices())
+        out.put(&g(v), sizeof(V));
+
+      out.pad(h.edge_values);
+      for (edge_handle e : g.edges())
+        out.put(&g(e), sizeof(E));
+
+      out.pad(h.length);
+      out.flush();
+    }
+
+  template<typename G>
+    void
+    write_snapshot(std::ostream& os, const G& g)
+    {
+      using V = Decay<decltype(g(std::declval<Vertex<G>>()))>;
+      using E = Decay<decltype(g(std::declval<Edge<G>>()))>;
+      write_snapshot(os, compressed_graph<V, E>(g));
+    }
+
+
+
+  // A graph snapshot is a read-only directed graph stored in a memory-mapped
+  // snapshot file. It provides the same interface as a compressed graph,
+  // except that values cannot be modified. Note that the in edges of a
+  // vertex refer directly to the mapped words, so graph snapshots require
+  // edge handles to be 64 bits.
+  template<typename V = empty_t, typename E = empty_t>
+    class graph_snapshot
+    {
+      static_assert(snapshot_impl::storable<V>(), "");
+      static_assert(snapshot_impl::storable<E>(), "");
+      static_assert(sizeof(edge_handle) == sizeof(std::uint64_t), "");
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+      using edge = edge_handle;
+      using edge_range = compressed_graph_impl::handle_range<edge_handle>;
+
+      using incidence_range = compressed_graph_impl::incidence_range;
+
+
+      // Map the snapshot stored in the file at path, in the given mode.
+      explicit graph_snapshot(const std::string& path,
+                              io::map_mode m = io::map_mode::paged)
+        : graph_snapshot(snapshot_file(path, m))
+      { }
+
+      // Take ownership of the snapshot file f. A std::runtime_error is
+      // thrown if the sizes of its values differ from those of V and E.
+      explicit graph_snapshot(snapshot_file&& f);
+
+
+      // Observers
+      bool        null() const  { return order_ == 0; }
+      std::size_t order() const { return order_; }
+
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return out_[v + 1] - out_[v]; }
+      std::size_t in_degree(vertex v) const  { return in_[v + 1] - in_[v]; }
+      std::size_t degree(vertex v) const
+      {
+        return out_degree(v) + in_degree(v);
+      }
+
+      // Edge observers
+      vertex source(edge e) const { return sources_[e]; }
+      vertex target(edge e) const { return targets_[e]; }
+
+      // Data access
+      const V& operator()(vertex v) const { return verts_[v]; }
+      const E& operator()(edge e) const   { return edges_[e]; }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range    vertices() const { return {0, order()}; }
+      edge_range      edges() const    { return {0, size()}; }
+      edge_range      out_edges(vertex v) const;
+      incidence_range in_edges(vertex v) const;
+
+    private:
+      template<typename T>
+        const T* section(std::uint64_t off) const
+        {
+          return reinterpret_cast<const T*>(file_.data() + off);
+        }
+
+    private:
+      snapshot_file file_;
+      std::size_t order_;
+      std::size_t size_;
+      const std::uint64_t* out_;      // Out edge offsets of each vertex
+      const std::uint64_t* sources_;  // Source of each edge
+      const std::uint64_t* targets_;  // Target of each edge
+      const std::uint64_t* in_;       // In edge offsets of each vertex
+      const edge_handle*   ins_;      // In edges of each vertex
+      const V*             verts_;    // Vertex values
+      const E*             edges_;    // Edge values
+    };
+
+  template<typename V, typename E>
+    graph_snapshot<V, E>::graph_snapshot(snapshot_file&& f)
+      : file_(std::move(f))
+    {
+      const snapshot_header& h = file_.header();
+      if (h.vertex_size != sizeof(V) || h.edge_size != sizeof(E))
+        throw std::runtime_error("snapshot value sizes do not match");
+      order_ = h.order;
+      size_ = h.size;
+      out_ = section<std::uint64_t>(h.out_offsets);
+      sources_ = section<std::uint64_t>(h.sources);
+      targets_ = section<std::uint64_t>(h.targets);
+      in_ = section<std::uint64_t>(h.in_offsets);
+      ins_ = section<edge_handle>(h.in_edges);
+      verts_ = section<V>(h.vertex_values);
+      edges_ = section<E>(h.edge_values);
+    }
+
+  // Returns the first edge (u, v), or an invalid edge handle if u and v are
+  // not adjacent.
+  template<typename V, typename E>
+    auto
+    graph_snapshot<V, E>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (std::size_t i = out_[u]; i != out_[u + 1]; ++i)
+        if (targets_[i] == v)
+          return i;
+      return edge();
+    }
+
+  template<typename V, typename E>
+    inline auto
+    graph_snapshot<V, E>::out_edges(vertex v) const -> edge_range
+    {
+      return {out_[v], out_[v + 1]};
+    }
+
+  template<typename V, typename E>
+    inline auto
+    graph_snapshot<V, E>::in_edges(vertex v) const -> incidence_range
+    {
+      return {ins_ + in_[v], ins_ + in_[v + 1]};
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <origin/graph/snapshot.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/search.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+using S = graph_snapshot<char, int>;
+
+static_assert(Directed_graph<S>(), "");
+
+const char* path = "origin.graph.snapshot.test.bin";
+
+template<typename G>
+  void
+  save(const G& g)
+  {
+    ofstream os(path, ios::binary);
+    write_snapshot(os, g);
+    assert(os);
+  }
+
+// The snapshot s has the same structure and values as the compressed graph c.
+template<typename C>
+  void
+  check_equal(const C& c, const S& s)
+  {
+    assert(s.order() == c.order());
+    assert(s.size() == c.size());
+    for (Vertex<S> v : s.vertices()) {
+      assert(s(v) == c(v));
+      assert(s.out_degree(v) == c.out_degree(v));
+      assert(s.in_degree(v) == c.in_degree(v));
+      auto r = c.in_edges(v);
+      assert(equal(r.begin(), r.end(), s.in_edges(v).begin()));
+    }
+    for (Edge<S> e : s.edges()) {
+      assert(s.source(e) == c.source(e));
+      assert(s.target(e) == c.target(e));
+      assert(s(e) == c(e));
+    }
+  }
+
+void
+check_round_trip()
+{
+  using G = directed_adjacency_list<char, int>;
+  G g = build_reflexive_bidi_clique<G>(5);
+  g.remove_vertex(2);
+  save(g);
+
+  S s(path);
+  check_equal(compressed_graph<char, int>(g), s);
+  assert(s(s(0, 1)) == g(g(0, 1)));
+  assert(!s(0, 0) == !g(0, 0));
+
+  // Snapshots can be searched like any other graph.
+  vector<size_t> ls = breadth_first_levels(s, 0, 1);
+  assert((ls == vector<size_t>{0, 1, 1, 1}));
+
+  // Moving a snapshot preserves the mapping.
+  S t = std::move(s);
+  assert(t.order() == 4);
+  assert(t(Vertex<S>(3)) == 'e');
+
+  // Snapshots can be read into huge pages.
+  S h(path, io::map_mode::huge_pages);
+  check_equal(compressed_graph<char, int>(g), h);
+}
+
+void
+check_undirected()
+{
+  // An undirected graph is stored as a directed graph, with each edge in
+  // both directions.
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_reflexive_clique<G>(4);
+  save(g);
+
+  S s(path);
+  assert(s.order() == 4);
+  assert(s.size() == 16);
+  check_equal(compressed_graph<char, int>(g), s);
+}
+
+void
+check_empty()
+{
+  save(compressed_graph<char, int>());
+  S s(path);
+  assert(s.null());
+  assert(s.empty());
+}
+
+void
+check_errors()
+{
+  save(build_n_graph<directed_adjacency_list<char, int>>(3));
+
+  // Value sizes must match.
+  try {
+    graph_snapshot<char, double> s(path);
+    assert(false);
+  } catch (runtime_error&) { }
+
+  // Truncated files are rejected.
+  {
+    fstream f(path, ios::in | ios::out | ios::binary);
+    f.seekp(0);
+    f.write("X", 1);
+  }
+  try {
+    S s(path);
+    assert(false);
+  } catch (runtime_error&) { }
+
+  std::remove(path);
+  try {
+    S s(path);
+    assert(false);
+  } catch (system_error&) { }
+}
+
+int main()
+{
+  check_round_trip();
+  check_undirected();
+  check_empty();
+  check_errors();
+  std::remove(path);
+}
@@ -0,0 +1,292 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_SPANNING_TREE_HPP
+#define ORIGIN_GRAPH_SPANNING_TREE_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/graph/components.hpp>
+#include <origin/graph/shortest_paths.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                       [graph.spanning_tree]
+  //                        Minimum Spanning Forests
+  //
+  // A minimum spanning forest of an undirected graph is a set of edges of
+  // least total weight that connects the vertices of each connected
+  // component without a cycle. The weight of each edge e is its value,
+  // g(e), which must be of an arithmetic type. The following algorithms are
+  // provided:
+  //
+  //    minimum_spanning_tree(g, tree)
+  //    parallel_minimum_spanning_tree(g, tree[, threads])
+  //
+  // Each writes the handles of the edges of the forest to tree, in order of
+  // increasing weight, and returns their total weight. Edges of equal
+  // weight are ordered by their position in g.edges(), so that the forest
+  // is unique and both algorithms compute the same one. Self loops are
+  // never in a forest. Neither algorithm copies the graph: each builds an
+  // array of the edges and their weights and endpoints. Both therefore
+  // accept an edge list graph, such as a coordinate graph (see
+  // [graph.coordinate]), whose edges are taken to be undirected.
+  //
+  // Kruskal's algorithm adds edges in order of their weight, skipping those
+  // whose endpoints are already connected (see [graph.union_find]). The
+  // edges are sorted by radix sort (see algo.radix) when their weights are
+  // integers, floats or doubles, and by a stable comparison sort otherwise.
+  //
+  // The parallel algorithm is Boruvka's. In each round, every component
+  // selects its lightest edge to another component, and the selected edges
+  // are added to the forest, merging the components they connect. Each
+  // round at least halves the number of components that have edges to
+  // others. The edges of each round are scanned in parallel: the lightest
+  // edge of a component is found by atomic compare-and-swap, components
+  // are merged by a concurrent_disjoint_sets, and the edges whose endpoints
+  // are in the same component are removed before the next round.
+
+
+  namespace spanning_tree_impl
+  {
+    // The number of edges processed by each parallel task.
+    constexpr std::size_t grain = 1024;
+
+    // The edges of a graph that are not self loops, with their weights and
+    // endpoints. Edges are identified by their index in the arrays.
+    template<typename G>
+      struct edge_list
+      {
+        using W = Edge_weight<G>;
+
+        explicit edge_list(const G& g)
+        {
+          for (Edge<G> e : g.edges()) {
+            Vertex<G> u = g.source(e);
+            Vertex<G> v = g.target(e);
+            if (u == v)
+              continue;
+            edges.push_back(e);
+            weights.push_back(g(e));
+            sources.push_back(u);
+            targets.push_back(v);
+          }
+        }
+
+        std::size_t size() const { return edges.size(); }
+
+        // Returns true if the edge i precedes the edge j.
+        bool less(std::size_t i, std::size_t j) const
+        {
+          if (weights[i] < weights[j])
+            return true;
+          if (weights[j] < weights[i])
+            return false;
+          return i < j;
+        }
+
+        // Write the edges indexed by ids to tree, returning their total
+        // weight.
+        W output(const std::vector<std::size_t>& ids,
+                 std::vector<Edge<G>>& tree) const
+        {
+          W sum = W(0);
+          tree.clear();
+          tree.reserve(ids.size());
+          for (std::size_t i : ids) {
+            tree.push_back(edges[i]);
+            sum += weights[i];
+          }
+          return sum;
+        }
+
+        std::vector<Edge<G>> edges;
+        std::vector<W> weights;
+        std::vector<std::size_t> sources;
+        std::vector<std::size_t> targets;
+      };
+
+    // Returns true if the weights of type W are sorted by radix sort.
+    template<typename W>
+      constexpr bool Radix_weight()
+      {
+        return Integer<W>() || Same<W, float>() || Same<W, double>();
+      }
+
+    // Sort the edge indexes ids by weight, keeping edges of equal weight in
+    // order.
+    template<typename G>
+      inline Requires<Radix_weight<Edge_weight<G>>(), void>
+      sort_edges(const edge_list<G>& es, std::vector<std::size_t>& ids)
+      {
+        radix_sort(ids, [&es](std::size_t i) { return es.weights[i]; });
+      }
+
+    template<typename G>
+      inline Requires<!Radix_weight<Edge_weight<G>>(), void>
+      sort_edges(const edge_list<G>& es, std::vector<std::size_t>& ids)
+      {
+        std::stable_sort(ids.begin(), ids.end(),
+                         [&es](std::size_t i, std::size_t j) {
+                           return es.weights[i] < es.weights[j];
+                         });
+      }
+
+    // Call f(i, k) for each i in [0, m), in parallel blocks of grain
+    // indexes, where k is the block of i.
+    template<typename F>
+      void
+      for_blocks(std::size_t m, std::size_t threads, F f)
+      {
+        std::size_t blocks = (m + grain - 1) / grain;
+        search_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t end = std::min(m, (k + 1) * grain);
+          for (std::size_t i = k * grain; i != end; ++i)
+            f(i, k);
+        });
+      }
+
+    // An edge between two components in a round of Boruvka's algorithm,
+    // with the representatives of the components of its endpoints.
+    struct boruvka_edge
+    {
+      std::size_t id;
+      std::size_t u;
+      std::size_t v;
+    };
+
+  } // namespace spanning_tree_impl
+
+
+  // Compute the minimum spanning forest of the undirected graph g by
+  // Kruskal's algorithm, writing its edges to tree. Returns the total weight
+  // of the forest.
+  template<typename G>
+    Edge_weight<G>
+    minimum_spanning_tree(const G& g, std::vector<Edge<G>>& tree)
+    {
+      static_assert(Undirected_graph<G>() || Edge_list_graph<G>(), "");
+      using namespace spanning_tree_impl;
+
+      edge_list<G> es(g);
+      std::vector<std::size_t> ids(es.size());
+      std::iota(ids.begin(), ids.end(), 0);
+      sort_edges(es, ids);
+
+      disjoint_sets sets(search_impl::vertex_bound(g));
+      std::vector<std::size_t> forest;
+      for (std::size_t i : ids)
+        if (sets.unite(es.sources[i], es.targets[i]))
+          forest.push_back(i);
+      return es.output(forest, tree);
+    }
+
+
+  // Compute the minimum spanning forest of the undirected graph g by
+  // Boruvka's algorithm, using up to threads threads, and write its edges to
+  // tree. Returns the total weight of the forest.
+  template<typename G>
+    Edge_weight<G>
+    parallel_minimum_spanning_tree(const G& g,
+                                   std::vector<Edge<G>>& tree,
+                                   std::size_t threads = search_threads())
+    {
+      static_assert(Undirected_graph<G>() || Edge_list_graph<G>(), "");
+      using namespace spanning_tree_impl;
+      constexpr std::size_t none = -1;
+
+      edge_list<G> es(g);
+      std::size_t n = search_impl::vertex_bound(g);
+      concurrent_disjoint_sets sets(n);
+      std::unique_ptr<std::atomic<std::size_t>[]> best(
+        new std::atomic<std::size_t>[n]);
+      for (std::size_t i = 0; i != n; ++i)
+        best[i].store(none, std::memory_order_relaxed);
+
+      // Set the lightest edge of the component c to i, if it is lighter.
+      auto offer = [&](std::size_t c, std::size_t i) {
+        std::size_t j = best[c].load(std::memory_order_relaxed);
+        while (j == none || es.less(i, j))
+          if (best[c].compare_exchange_weak(j, i, std::memory_order_relaxed))
+            break;
+      };
+
+      std::vector<std::size_t> forest;
+      std::vector<boruvka_edge> live;
+      std::vector<std::size_t> ids(es.size());
+      std::iota(ids.begin(), ids.end(), 0);
+      std::vector<std::vector<boruvka_edge>> kept;
+      std::vector<std::vector<std::size_t>> chosen;
+      while (true) {
+        // Find the components of the endpoints of each edge, keeping those
+        // that connect different components.
+        std::size_t m = ids.size();
+        kept.assign((m + grain - 1) / grain, {});
+        for_blocks(m, threads, [&](std::size_t i, std::size_t k) {
+          std::size_t e = ids[i];
+          std::size_t u = sets.find(es.sources[e]);
+          std::size_t v = sets.find(es.targets[e]);
+          if (u != v)
+            kept[k].push_back(boruvka_edge {e, u, v});
+        });
+        live.clear();
+        for (const std::vector<boruvka_edge>& x : kept)
+          live.insert(live.end(), x.begin(), x.end());
+        if (live.empty())
+          break;
+
+        // Select the lightest edge of each component. An edge selected by
+        // both of its components is added once.
+        m = live.size();
+        for_blocks(m, threads, [&](std::size_t i, std::size_t) {
+          offer(live[i].u, live[i].id);
+          offer(live[i].v, live[i].id);
+        });
+        chosen.assign((m + grain - 1) / grain, {});
+        for_blocks(m, threads, [&](std::size_t i, std::size_t k) {
+          const boruvka_edge& x = live[i];
+          if (best[x.u].load(std::memory_order_relaxed) == x.id ||
+              best[x.v].load(std::memory_order_relaxed) == x.id)
+            chosen[k].push_back(x.id);
+        });
+        for_blocks(m, threads, [&](std::size_t i, std::size_t) {
+          best[live[i].u].store(none, std::memory_order_relaxed);
+          best[live[i].v].store(none, std::memory_order_relaxed);
+        });
+
+        // Merge the components connected by the selected edges, which form
+        // a forest of the components since edges are totally ordered.
+        std::size_t first = forest.size();
+        for (const std::vector<std::size_t>& x : chosen)
+          forest.insert(forest.end(), x.begin(), x.end());
+        for_blocks(forest.size() - first, threads,
+                   [&](std::size_t i, std::size_t) {
+          std::size_t e = forest[first + i];
+          sets.unite(es.sources[e], es.targets[e]);
+        });
+
+        ids.clear();
+        for (const boruvka_edge& x : live)
+          ids.push_back(x.id);
+      }
+
+      std::sort(forest.begin(), forest.end(),
+                [&es](std::size_t i, std::size_t j) { return es.less(i, j); });
+      return es.output(forest, tree);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,165 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+#include <origin/graph/spanning_tree.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Check that tree is a spanning forest of g with the given weight.
+template<typename G, typename W>
+  void
+  check_forest(const G& g, const vector<Edge<G>>& tree, W weight)
+  {
+    vector<size_t> ls;
+    size_t k = connected_components(g, ls);
+    assert(tree.size() == g.order() - k);
+
+    disjoint_sets sets(ls.size());
+    W sum = 0;
+    for (Edge<G> e : tree) {
+      assert(sets.unite(g.source(e), g.target(e)));
+      sum += g(e);
+    }
+    assert(sum == weight);
+    for (size_t i = 1; i < tree.size(); ++i)
+      assert(!(g(tree[i]) < g(tree[i - 1])));
+  }
+
+// Check the cycle property: the endpoints of each edge not in the forest are
+// connected by edges of the forest that are no heavier.
+template<typename G>
+  void
+  check_optimal(const G& g, const vector<Edge<G>>& tree)
+  {
+    for (Edge<G> e : g.edges()) {
+      if (find(tree.begin(), tree.end(), e) != tree.end())
+        continue;
+      disjoint_sets sets(g.order());
+      for (Edge<G> t : tree)
+        if (!(g(e) < g(t)))
+          sets.unite(g.source(t), g.target(t));
+      assert(sets.same(g.source(e), g.target(e)));
+    }
+  }
+
+template<typename G>
+  void
+  check_small()
+  {
+    // A 4-cycle a-b-c-d-a with a chord a-c, a self loop, and an isolated
+    // vertex e.
+    G g = build_n_graph<G>(5);
+    g.add_edge(0, 1, 4);
+    g.add_edge(1, 2, 1);
+    g.add_edge(2, 3, 3);
+    g.add_edge(3, 0, 2);
+    g.add_edge(0, 2, 2);
+    g.add_edge(1, 1, 0);
+
+    vector<Edge<G>> tree;
+    assert(minimum_spanning_tree(g, tree) == 5);
+    check_forest(g, tree, 5);
+    check_optimal(g, tree);
+
+    // The tie between d-a and a-c is broken by edge order.
+    assert(tree.size() == 3);
+    assert(g.source(tree[0]) == 1 && g.target(tree[0]) == 2);
+    assert(g.target(tree[1]) == 0);
+    assert(g.target(tree[2]) == 2);
+
+    vector<Edge<G>> ptree;
+    assert(parallel_minimum_spanning_tree(g, ptree, 2) == 5);
+    assert(ptree == tree);
+
+    // The empty graph has an empty forest.
+    G e;
+    assert(minimum_spanning_tree(e, tree) == 0 && tree.empty());
+    assert(parallel_minimum_spanning_tree(e, tree) == 0 && tree.empty());
+  }
+
+template<typename G>
+  void
+  check_random(size_t n, size_t m, int w)
+  {
+    // The weights are in [0, w), so that there are many ties.
+    auto random_weight = [w](minstd_rand& prng) { return int(prng() % w); };
+    G g = build_erdos_renyi_graph<G>(n, m, n + m, random_weight);
+    vector<Edge<G>> tree;
+    auto weight = minimum_spanning_tree(g, tree);
+    check_forest(g, tree, weight);
+    if (n <= 2000)
+      check_optimal(g, tree);
+
+    vector<Edge<G>> ptree;
+    assert(parallel_minimum_spanning_tree(g, ptree, 1) == weight);
+    assert(ptree == tree);
+    assert(parallel_minimum_spanning_tree(g, ptree, 4) == weight);
+    assert(ptree == tree);
+  }
+
+void
+check_double()
+{
+  using G = undirected_adjacency_list<char, double>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 0.5);
+  g.add_edge(1, 2, -1.25);
+  g.add_edge(2, 0, 0.25);
+  g.add_edge(2, 3, 3.0);
+
+  vector<Edge<G>> tree;
+  assert(minimum_spanning_tree(g, tree) == 2.0);
+  check_forest(g, tree, 2.0);
+  vector<Edge<G>> ptree;
+  assert(parallel_minimum_spanning_tree(g, ptree, 4) == 2.0);
+  assert(ptree == tree);
+
+  check_random<G>(3000, 12000, 1000);
+}
+
+void
+check_removed()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_n_graph<G>(4);
+  g.add_edge(0, 1, 1);
+  g.add_edge(1, 2, 1);
+  g.add_edge(0, 2, 5);
+  g.add_edge(2, 3, 2);
+  g.remove_vertex(1);
+
+  vector<Edge<G>> tree;
+  assert(minimum_spanning_tree(g, tree) == 7);
+  check_forest(g, tree, 7);
+  vector<Edge<G>> ptree;
+  assert(parallel_minimum_spanning_tree(g, ptree, 2) == 7);
+  assert(ptree == tree);
+}
+
+int
+main()
+{
+  using L = undirected_adjacency_list<char, int>;
+  using V = undirected_adjacency_vector<char, int>;
+  check_small<L>();
+  check_small<V>();
+  check_random<L>(2000, 1500, 10);
+  check_random<L>(20000, 100000, 50);
+  check_random<V>(20000, 100000, 1 << 16);
+  check_double();
+  check_removed();
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "streaming.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                           Edge Stream Header
+
+  namespace
+  {
+    const char edge_stream_magic[8] = {'O', 'R', 'I', 'G', 'I', 'N', 'E', 'S'};
+
+    constexpr std::uint32_t edge_stream_byte_order = 0x01020304;
+
+    // Throws an exception indicating that the file is not an edge stream.
+    [[noreturn]] void
+    invalid_edge_stream(const char* what)
+    {
+      throw std::runtime_error(std::string("invalid edge stream: ") + what);
+    }
+
+    // Read n bytes at the offset off of the file fd into p, returning the
+    // number of bytes read, which is less than n only at the end of the
+    // file.
+    std::size_t
+    read_at(int fd, void* p, std::size_t n, std::uint64_t off)
+    {
+      char* s = static_cast<char*>(p);
+      std::size_t k = 0;
+      while (k != n) {
+        ssize_t r = ::pread(fd, s + k, n - k, off + k);
+        if (r < 0) {
+          if (errno == EINTR)
+            continue;
+          throw std::system_error(errno, std::system_category());
+        }
+        if (r == 0)
+          break;
+        k += r;
+      }
+      return k;
+    }
+
+    // Check that the header describes an edge stream of the given length.
+    void
+    check_header(const edge_stream_header& h, std::uint64_t length)
+    {
+      if (std::memcmp(h.magic, edge_stream_magic, sizeof(h.magic)) != 0)
+        invalid_edge_stream("bad magic number");
+      if (h.byte_order != edge_stream_byte_order)
+        invalid_edge_stream("byte order does not match");
+      if (h.version != edge_stream_header::current_version)
+        invalid_edge_stream("unsupported version");
+      if (h.size > (std::uint64_t(-1) - sizeof(h)) / 16
+          || length != sizeof(h) + 16 * h.size)
+        invalid_edge_stream("truncated file");
+    }
+  } // namespace
+
+  constexpr std::uint32_t edge_stream_header::current_version;
+
+  edge_stream_header
+  make_edge_stream_header(std::size_t n, std::size_t m, bool directed)
+  {
+    edge_stream_header h;
+    std::memcpy(h.magic, edge_stream_magic, sizeof(h.magic));
+    h.version = edge_stream_header::current_version;
+    h.byte_order = edge_stream_byte_order;
+    h.order = n;
+    h.size = m;
+    h.directed = directed;
+    return h;
+  }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Edge Streams
+
+  constexpr std::size_t edge_stream::default_block;
+
+  edge_stream::edge_stream(const std::string& path, std::size_t block)
+    : fd_(-1), passes_(0), buf_(2 * std::max<std::size_t>(block, 1))
+  {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+      throw std::system_error(errno, std::system_category(), path);
+    try {
+      struct stat st;
+      if (::fstat(fd_, &st) != 0)
+        throw std::system_error(errno, std::system_category(), path);
+
+      edge_stream_header h;
+      if (read_at(fd_, &h, sizeof(h), 0) != sizeof(h))
+        invalid_edge_stream("truncated file");
+      check_header(h, st.st_size);
+      order_ = h.order;
+      size_ = h.size;
+      directed_ = h.directed;
+    } catch (...) {
+      ::close(fd_);
+      throw;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  }
+
+  edge_stream::edge_stream(edge_stream&& x)
+    : fd_(x.fd_),
+      order_(x.order_),
+      size_(x.size_),
+      directed_(x.directed_),
+      passes_(x.passes_),
+      buf_(std::move(x.buf_))
+  {
+    x.fd_ = -1;
+    x.order_ = x.size_ = 0;
+  }
+
+  edge_stream&
+  edge_stream::operator=(edge_stream&& x)
+  {
+    std::swap(fd_, x.fd_);
+    std::swap(order_, x.order_);
+    std::swap(size_, x.size_);
+    std::swap(directed_, x.directed_);
+    std::swap(passes_, x.passes_);
+    std::swap(buf_, x.buf_);
+    return *this;
+  }
+
+  edge_stream::~edge_stream()
+  {
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  // The vertices of each edge are checked as they are read, since a
+  // corrupt file could otherwise index past the vertex state.
+  std::size_t
+  edge_stream::read(std::uint64_t first, std::size_t n) const
+  {
+    n = std::min<std::uint64_t>(n, size_ - first);
+    std::size_t bytes = 16 * n;
+    std::uint64_t off = sizeof(edge_stream_header) + 16 * first;
+    if (read_at(fd_, buf_.data(), bytes, off) != bytes)
+      invalid_edge_stream("truncated file");
+    for (std::size_t i = 0; i != 2 * n; ++i)
+      if (buf_[i] >= order_)
+        invalid_edge_stream("vertex out of range");
+    return n;
+  }
+
+} // namespace origin
@@ -0,0 +1,302 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_STREAMING_HPP
+#define ORIGIN_GRAPH_STREAMING_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/components.hpp>
+#include <origin/graph/iterative.hpp>
+#include <origin/graph/snapshot.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.streaming]
+  //                              Edge Streams
+  //
+  // An edge stream is a graph whose edges are kept in a file and are only
+  // accessed by reading the whole file from start to end, so that a graph
+  // with more edges than fit in memory can be processed. Only the state of
+  // the vertices is kept in memory. This is the semi-external (or
+  // edge-centric) model of X-Stream (Roy et al.): each pass over the stream
+  // reads the edges sequentially in large blocks, and calls a function on
+  // each edge that reads and updates the state of its endpoints.
+  //
+  // Edge streams are written by write_edge_stream(os, g). An edge stream
+  // file consists of a header, followed by the source and target of each
+  // edge as unsigned 64-bit integers. Vertices are numbered [0, n) in the
+  // order given by g.vertices(). As with snapshots (see [graph.snapshot]),
+  // integers are stored in the byte order of the machine that wrote the
+  // file. The edges of an undirected graph are written once, and are
+  // traversed in both directions by the algorithms below.
+  //
+  // An edge stream provides the vertex interface of a graph (order(),
+  // size(), vertices(), and so on) and a single traversal of its edges,
+  // for_each_edge(f). The following algorithms are written as sequences of
+  // passes over the stream:
+  //
+  //    streaming_breadth_first_levels(s, v)
+  //    streaming_connected_components(s, labels)
+  //    streaming_pagerank(s, ranks[, opts])
+  //
+  // Each algorithm accepts any object s that provides s.order(),
+  // s.directed(), s.vertices(), and s.for_each_edge(f), so that they also
+  // run directly on the arrays of a coordinate graph (see
+  // [graph.coordinate]), where each pass is a scan of memory.
+  //
+  // The number of passes performed by each is bounded: finding connected
+  // components takes a single pass, a breadth-first search takes at most one
+  // more pass than the greatest distance from its source, and PageRank takes
+  // one pass per iteration plus one to compute the degree of each vertex.
+
+
+  // The header of an edge stream file.
+  struct edge_stream_header
+  {
+    static constexpr std::uint32_t current_version = 1;
+
+    char          magic[8];       // "ORIGINES"
+    std::uint32_t version;        // Format version
+    std::uint32_t byte_order;     // 0x01020304, in the writer's byte order
+    std::uint64_t order;          // Number of vertices
+    std::uint64_t size;           // Number of edges
+    std::uint64_t directed;       // 1 if the graph is directed
+  };
+
+  // Returns the header of an edge stream with n vertices and m edges. See
+  // streaming.cpp.
+  edge_stream_header make_edge_stream_header(std::size_t n,
+                                             std::size_t m,
+                                             bool directed);
+
+
+  // Write the edges of g to os as an edge stream. Errors are reported
+  // through the state of os.
+  template<typename G>
+    void
+    write_edge_stream(std::ostream& os, const G& g)
+    {
+      static_assert(Directed_graph<G>() || Undirected_graph<G>(), "");
+      std::vector<std::uint64_t> index(search_impl::vertex_bound(g));
+      std::uint64_t n = 0;
+      for (Vertex<G> v : g.vertices())
+        index[v] = n++;
+
+      edge_stream_header h =
+        make_edge_stream_header(g.order(), g.size(), Directed_graph<G>());
+      snapshot_impl::writer out(os);
+      out.put(&h, sizeof(h));
+      for (Edge<G> e : g.edges()) {
+        out.word(index[g.source(e)]);
+        out.word(index[g.target(e)]);
+      }
+      out.flush();
+    }
+
+
+  // An edge stream reads the edges of an edge stream file in sequential
+  // passes. Opening an edge stream validates its header; a std::system_error
+  // is thrown if the file cannot be opened or read, and a std::runtime_error
+  // if it is not a valid edge stream. Each pass reads the file in blocks of
+  // the given number of edges, so that the memory used by a pass does not
+  // depend on the size of the graph. Edge streams can be moved but not
+  // copied.
+  class edge_stream
+  {
+  public:
+    using vertex = vertex_handle;
+    using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+    // The default number of edges read by each block of a pass.
+    static constexpr std::size_t default_block = 1 << 16;
+
+    explicit edge_stream(const std::string& path,
+                         std::size_t block = default_block);
+
+    edge_stream(edge_stream&& x);
+    edge_stream& operator=(edge_stream&& x);
+
+    edge_stream(const edge_stream&) = delete;
+    edge_stream& operator=(const edge_stream&) = delete;
+
+    ~edge_stream();
+
+    // Observers
+    bool        null() const  { return order_ == 0; }
+    std::size_t order() const { return order_; }
+
+    bool        empty() const { return size_ == 0; }
+    std::size_t size() const  { return size_; }
+
+    // Returns true if the edges of the stream are directed.
+    bool directed() const { return directed_; }
+
+    // Returns the number of passes made over the stream.
+    std::size_t passes() const { return passes_; }
+
+    // Iterators
+    vertex_range vertices() const { return {0, order()}; }
+
+    // Call f(u, v) for the source u and target v of each edge of the
+    // stream, in the order in which they were written. This reads the entire
+    // file.
+    template<typename F>
+      void for_each_edge(F f) const;
+
+  private:
+    // Read up to n edges starting at the edge first into the buffer,
+    // returning the number read.
+    std::size_t read(std::uint64_t first, std::size_t n) const;
+
+  private:
+    int fd_;
+    std::size_t order_;
+    std::size_t size_;
+    bool directed_;
+    mutable std::size_t passes_;
+    mutable std::vector<std::uint64_t> buf_;  // The current block
+  };
+
+  template<typename F>
+    void
+    edge_stream::for_each_edge(F f) const
+    {
+      ++passes_;
+      std::size_t block = buf_.size() / 2;
+      for (std::uint64_t i = 0; i < size_; ) {
+        std::size_t n = read(i, block);
+        for (std::size_t j = 0; j != 2 * n; j += 2)
+          f(vertex(buf_[j]), vertex(buf_[j + 1]));
+        i += n;
+      }
+    }
+
+
+
+  // Returns the distance from s to each vertex of the stream. The distance
+  // of an unreachable vertex is size_t(-1). Each pass relaxes every edge,
+  // so that a vertex may be reached by a path of several edges in one pass;
+  // the search stops after the first pass that changes no distance.
+  template<typename S>
+    inline std::vector<std::size_t>
+    streaming_breadth_first_levels(const S& s, vertex_handle v)
+    {
+      assert(v < s.order());
+      std::vector<std::size_t> levels(s.order(), -1);
+      levels[v] = 0;
+      bool changed = true;
+      auto relax = [&](vertex_handle u, vertex_handle w) {
+        std::size_t d = levels[u];
+        if (d != std::size_t(-1) && d + 1 < levels[w]) {
+          levels[w] = d + 1;
+          changed = true;
+        }
+      };
+      while (changed) {
+        changed = false;
+        if (s.directed())
+          s.for_each_edge(relax);
+        else
+          s.for_each_edge([&](vertex_handle u, vertex_handle w) {
+            relax(u, w);
+            relax(w, u);
+          });
+      }
+      return levels;
+    }
+
+
+  // Compute the connected components of the stream, ignoring the direction
+  // of edges, and write the label of each vertex to labels. Returns the
+  // number of components. The components are found in a single pass.
+  template<typename S>
+    inline std::size_t
+    streaming_connected_components(const S& s,
+                                   std::vector<std::size_t>& labels)
+    {
+      disjoint_sets sets(s.order());
+      s.for_each_edge([&sets](vertex_handle u, vertex_handle v) {
+        sets.unite(u, v);
+      });
+      return components_impl::number_components(s, sets, labels);
+    }
+
+
+  // Compute the PageRank of each vertex of the stream, writing it to ranks,
+  // as by pagerank(g, ranks, opts) (see [graph.iterative]). Returns the
+  // number of iterations performed. Each iteration is one pass. The mode and
+  // threads options are not used.
+  template<typename S>
+    inline std::size_t
+    streaming_pagerank(const S& s,
+                       std::vector<double>& ranks,
+                       const iteration_options& opts = {})
+    {
+      std::size_t n = s.order();
+      ranks.assign(n, n ? 1.0 / n : 0);
+      if (n == 0)
+        return 0;
+
+      // Count the out edges of each vertex.
+      std::vector<double> out(n);
+      if (s.directed())
+        s.for_each_edge([&out](vertex_handle u, vertex_handle) { ++out[u]; });
+      else
+        s.for_each_edge([&out](vertex_handle u, vertex_handle v) {
+          ++out[u];
+          ++out[v];
+        });
+
+      std::vector<double> share(n);
+      std::vector<double> sums(n);
+      double d = opts.damping;
+      std::size_t iter = 0;
+      while (iter < opts.max_iterations) {
+        ++iter;
+        double leak = 0;
+        for (std::size_t v = 0; v != n; ++v) {
+          if (out[v] != 0)
+            share[v] = ranks[v] / out[v];
+          else
+            leak += ranks[v];
+        }
+
+        if (s.directed())
+          s.for_each_edge([&](vertex_handle u, vertex_handle v) {
+            sums[v] += share[u];
+          });
+        else
+          s.for_each_edge([&](vertex_handle u, vertex_handle v) {
+            sums[v] += share[u];
+            sums[u] += share[v];
+          });
+
+        double c = 0;
+        for (std::size_t v = 0; v != n; ++v) {
+          double r = (1 - d + d * leak) / n + d * sums[v];
+          c += std::abs(r - ranks[v]);
+          ranks[v] = r;
+          sums[v] = 0;
+        }
+        if (c <= opts.tolerance)
+          break;
+      }
+      return iter;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,174 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <origin/graph/streaming.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/components.hpp>
+#include <origin/graph/iterative.hpp>
+#include <origin/graph/search.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+const char* path = "origin.graph.streaming.test.bin";
+
+template<typename G>
+  void
+  save(const G& g)
+  {
+    ofstream os(path, ios::binary);
+    write_edge_stream(os, g);
+    assert(os);
+  }
+
+// Build a graph with two paths, 0 - 1 - ... - 9 and 10 - 11 - ... - 14,
+// and an isolated vertex 15, adding the edges of the paths in reverse.
+template<typename G>
+  G
+  build_paths()
+  {
+    G g = build_n_graph<G>(16);
+    for (int i = 8; i >= 0; --i)
+      g.add_edge(i, i + 1);
+    for (int i = 13; i >= 10; --i)
+      g.add_edge(i, i + 1);
+    g.add_edge(3, 7);
+    return g;
+  }
+
+template<typename G>
+  void
+  check_algorithms()
+  {
+    G g = build_paths<G>();
+    save(g);
+
+    // A small block forces several reads in each pass.
+    edge_stream s(path, 3);
+    assert(s.order() == g.order());
+    assert(s.size() == g.size());
+    assert(s.directed() == Directed_graph<G>());
+
+    vector<size_t> ls = streaming_breadth_first_levels(s, 0);
+    assert(ls == breadth_first_levels(g, 0, 1));
+
+    size_t p = s.passes();
+    vector<size_t> cs;
+    assert(streaming_connected_components(s, cs) == 3);
+    assert(s.passes() == p + 1);
+    vector<size_t> ref;
+    connected_components(g, ref);
+    assert(cs == ref);
+
+    p = s.passes();
+    vector<double> rs;
+    size_t iters = streaming_pagerank(s, rs);
+    assert(s.passes() == p + iters + 1);
+    vector<double> pr;
+    pagerank(g, pr);
+    double sum = 0;
+    for (size_t i = 0; i != rs.size(); ++i) {
+      assert(abs(rs[i] - pr[i]) < 1e-6);
+      sum += rs[i];
+    }
+    assert(abs(sum - 1) < 1e-9);
+  }
+
+void
+check_levels()
+{
+  // The edges are written against the direction of the path, so each pass
+  // reaches one more vertex; the search stops one pass after the last.
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(5);
+  for (int i = 3; i >= 0; --i)
+    g.add_edge(i, i + 1);
+  save(g);
+
+  edge_stream s(path);
+  vector<size_t> ls = streaming_breadth_first_levels(s, 0);
+  assert((ls == vector<size_t>{0, 1, 2, 3, 4}));
+  assert(s.passes() == 5);
+
+  // Unreachable vertices have no level.
+  ls = streaming_breadth_first_levels(s, 4);
+  assert((ls == vector<size_t>{size_t(-1), size_t(-1), size_t(-1),
+                               size_t(-1), 0}));
+}
+
+void
+check_holes()
+{
+  // Vertices are renumbered densely.
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_reflexive_clique<G>(4);
+  g.remove_vertex(1);
+  save(g);
+
+  edge_stream s(path);
+  assert(s.order() == 3);
+  assert(s.size() == g.size());
+  vector<size_t> cs;
+  assert(streaming_connected_components(s, cs) == 1);
+
+  // Moving a stream preserves the file.
+  edge_stream t = std::move(s);
+  assert(t.order() == 3);
+  assert(streaming_breadth_first_levels(t, 2)[0] == 1);
+}
+
+void
+check_errors()
+{
+  save(build_n_graph<directed_adjacency_list<char, int>>(3));
+  {
+    edge_stream s(path);
+    assert(s.order() == 3);
+    assert(s.empty());
+    vector<double> rs;
+    streaming_pagerank(s, rs);
+    assert(abs(rs[0] - 1.0 / 3) < 1e-9);
+  }
+
+  // Files with a bad header are rejected.
+  {
+    fstream f(path, ios::in | ios::out | ios::binary);
+    f.seekp(0);
+    f.write("X", 1);
+  }
+  try {
+    edge_stream s(path);
+    assert(false);
+  } catch (runtime_error&) { }
+
+  std::remove(path);
+  try {
+    edge_stream s(path);
+    assert(false);
+  } catch (system_error&) { }
+}
+
+int main()
+{
+  check_algorithms<directed_adjacency_list<char, int>>();
+  check_algorithms<undirected_adjacency_list<char, int>>();
+  check_levels();
+  check_holes();
+  check_errors();
+  std::remove(path);
+}
@@ -0,0 +1,439 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_TEMPORAL_HPP
+#define ORIGIN_GRAPH_TEMPORAL_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/type/empty.hpp>
+#include <origin/data/heap/indexed_heap.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/graph.hpp>
+#include <origin/graph/compressed_graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.temporal]
+  //                             Temporal Graphs
+  //
+  // A temporal graph is a directed graph whose edges are timestamped
+  // interactions. The out edges of each vertex are stored contiguously in
+  // order of time, as separate arrays of times, targets and values, so that
+  // the edges of a vertex within a time window are found by binary search
+  // in O(log d) time and are traversed as a contiguous block:
+  //
+  //    temporal_graph<V, E> g;
+  //    g.add_edge(u, v, t, x);             // An edge from u to v at time t
+  //    for (auto w : g.out_edges(u, t0, t1).targets())
+  //      ...                               // Edges with t0 <= t < t1
+  //    g.expire(t0);                       // Drop the edges before t0
+  //
+  // Edges are usually added in order of time, when each is appended to the
+  // arrays of its source; an edge added out of order is inserted at its
+  // position, after the edges with the same time. The bulk loader
+  // g.add_edges(r) appends the edges described by r, which are tuples of a
+  // source, target, time and optionally a value, and then sorts each list
+  // that received edges out of order once.
+  //
+  // The expiration g.expire(t) removes every edge whose time is before t,
+  // for a sliding window over a stream of interactions. The expired edges
+  // of each vertex are found by one binary search and are dropped by
+  // advancing the start of its arrays; the arrays are compacted when the
+  // expired edges make up half of them, so the cost of expiring an edge is
+  // amortized O(1).
+  //
+  // A window of edges (temporal_window) refers to the arrays of a vertex,
+  // and is invalidated by adding edges to that vertex and by expiration.
+  //
+  // The earliest_arrival algorithm is a time-respecting breadth-first
+  // search: a path is time-respecting if the times of its edges do not
+  // decrease, and a vertex is reached at the time of the last edge of a
+  // path to it. Vertices are visited in order of their arrival times, and
+  // each scans only those of its edges that are at or after its arrival.
+
+  // A window of the out edges of a vertex: the edges in contiguous ranges of
+  // its arrays, in order of time.
+  template<typename E, typename T>
+    class temporal_window
+    {
+    public:
+      temporal_window(const T* t, const vertex_handle* v, const E* x,
+                      std::size_t n)
+        : times_(t), targets_(v), values_(x), size_(n)
+      { }
+
+      // Observers
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+
+      // Returns the time, target, and value of the ith edge.
+      T             time(std::size_t i) const   { return times_[i]; }
+      vertex_handle target(std::size_t i) const { return targets_[i]; }
+      const E&      value(std::size_t i) const  { return values_[i]; }
+
+      // Returns the times or targets of the edges.
+      bounded_range<const T*> times() const
+      {
+        return {times_, times_ + size_};
+      }
+
+      bounded_range<const vertex_handle*> targets() const
+      {
+        return {targets_, targets_ + size_};
+      }
+
+    private:
+      const T*             times_;
+      const vertex_handle* targets_;
+      const E*             values_;
+      std::size_t          size_;
+    };
+
+
+  namespace temporal_impl
+  {
+    // The out edges of a vertex, in order of time. The edges before first
+    // have expired.
+    template<typename E, typename T>
+      struct edge_list
+      {
+        std::size_t size() const { return times.size() - first; }
+
+        // Returns the position of the first live edge whose time is not
+        // before t.
+        std::size_t lower_bound(T t) const
+        {
+          return std::lower_bound(times.begin() + first, times.end(), t)
+               - times.begin();
+        }
+
+        void append(vertex_handle v, T t, const E& x)
+        {
+          times.push_back(t);
+          targets.push_back(v);
+          values.push_back(x);
+        }
+
+        void insert(vertex_handle v, T t, const E& x);
+        void sort();
+        void compact();
+
+        std::size_t first = 0;
+        std::vector<T> times;
+        std::vector<vertex_handle> targets;
+        std::vector<E> values;
+      };
+
+    // Insert an edge after every live edge whose time is not after t.
+    template<typename E, typename T>
+      void
+      edge_list<E, T>::insert(vertex_handle v, T t, const E& x)
+      {
+        std::size_t i = std::upper_bound(times.begin() + first, times.end(), t)
+                      - times.begin();
+        times.insert(times.begin() + i, t);
+        targets.insert(targets.begin() + i, v);
+        values.insert(values.begin() + i, x);
+      }
+
+    // Stably sort the live edges by time.
+    template<typename E, typename T>
+      void
+      edge_list<E, T>::sort()
+      {
+        compact();
+        std::vector<std::size_t> p(times.size());
+        std::iota(p.begin(), p.end(), 0);
+        std::stable_sort(p.begin(), p.end(), [this](std::size_t a,
+                                                    std::size_t b) {
+          return times[a] < times[b];
+        });
+        std::vector<T> ts;
+        std::vector<vertex_handle> vs;
+        std::vector<E> xs;
+        ts.reserve(p.size());
+        vs.reserve(p.size());
+        xs.reserve(p.size());
+        for (std::size_t i : p) {
+          ts.push_back(times[i]);
+          vs.push_back(targets[i]);
+          xs.push_back(std::move(values[i]));
+        }
+        times.swap(ts);
+        targets.swap(vs);
+        values.swap(xs);
+      }
+
+    // Remove the expired edges from the arrays.
+    template<typename E, typename T>
+      void
+      edge_list<E, T>::compact()
+      {
+        times.erase(times.begin(), times.begin() + first);
+        targets.erase(targets.begin(), targets.begin() + first);
+        values.erase(values.begin(), values.begin() + first);
+        first = 0;
+      }
+
+  } // namespace temporal_impl
+
+
+  // A temporal graph is a directed graph of timestamped edges. Vertex
+  // handles are the indexes [0, order()).
+  template<typename V = empty_t, typename E = empty_t,
+           typename T = std::int64_t>
+    class temporal_graph
+    {
+      using edge_list = temporal_impl::edge_list<E, T>;
+
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+      using time_type = T;
+      using window = temporal_window<E, T>;
+
+      // A time after every other.
+      static constexpr T never = std::numeric_limits<T>::max();
+
+      temporal_graph()
+        : size_(0)
+      { }
+
+      // Observers
+      bool        null() const  { return lists_.empty(); }
+      std::size_t order() const { return lists_.size(); }
+
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+
+      std::size_t out_degree(vertex v) const { return lists_[v].size(); }
+
+      // Data access
+      V&       operator()(vertex v)       { return values_[v]; }
+      const V& operator()(vertex v) const { return values_[v]; }
+
+      // Vertex set
+      vertex add_vertex(const V& x = V());
+
+      // Edge set
+      void add_edge(vertex u, vertex v, T t, const E& x = E());
+
+      template<typename R>
+        void add_edges(R&& r);
+
+      // Remove every edge whose time is before t.
+      void expire(T t);
+
+      // Release the storage of expired edges and unused capacity.
+      void shrink_to_fit();
+
+      // Iterators
+      vertex_range vertices() const;
+
+      // Returns the out edges of v, or those whose times are in [t0, t1).
+      window out_edges(vertex v) const;
+      window out_edges(vertex v, T t0, T t1 = never) const;
+
+    private:
+      void append_edge(vertex u, vertex v, T t, const E& x = E());
+
+      template<typename X>
+        void append_edge(const X& x, size_constant<3>)
+        {
+          append_edge(std::get<0>(x), std::get<1>(x), std::get<2>(x));
+        }
+
+      template<typename X>
+        void append_edge(const X& x, size_constant<4>)
+        {
+          append_edge(std::get<0>(x), std::get<1>(x), std::get<2>(x),
+                      std::get<3>(x));
+        }
+
+    private:
+      std::vector<edge_list> lists_;
+      std::vector<V> values_;
+      std::vector<char> unsorted_; // Lists appended out of order in bulk
+      std::size_t size_;
+    };
+
+  template<typename V, typename E, typename T>
+    constexpr T temporal_graph<V, E, T>::never;
+
+  template<typename V, typename E, typename T>
+    inline auto
+    temporal_graph<V, E, T>::add_vertex(const V& x) -> vertex
+    {
+      vertex v = lists_.size();
+      lists_.emplace_back();
+      values_.push_back(x);
+      return v;
+    }
+
+  // Add an edge from u to v at time t.
+  template<typename V, typename E, typename T>
+    inline void
+    temporal_graph<V, E, T>::add_edge(vertex u, vertex v, T t, const E& x)
+    {
+      edge_list& l = lists_[u];
+      if (l.size() == 0 || !(t < l.times.back()))
+        l.append(v, t, x);
+      else
+        l.insert(v, t, x);
+      ++size_;
+    }
+
+  template<typename V, typename E, typename T>
+    inline void
+    temporal_graph<V, E, T>::append_edge(vertex u, vertex v, T t, const E& x)
+    {
+      edge_list& l = lists_[u];
+      if (l.size() != 0 && t < l.times.back())
+        unsorted_[u] = true;
+      l.append(v, t, x);
+      ++size_;
+    }
+
+  // Add each edge described by the range r to the graph. The lists that
+  // received edges out of order are sorted at the end.
+  template<typename V, typename E, typename T>
+    template<typename R>
+      void
+      temporal_graph<V, E, T>::add_edges(R&& r)
+      {
+        using X = Decay<decltype(*std::begin(r))>;
+        using Size = graph_impl::Edge_description_size<X>;
+        unsorted_.assign(order(), false);
+        for (const auto& x : r)
+          append_edge(x, Size{});
+        for (std::size_t v = 0; v != order(); ++v)
+          if (unsorted_[v])
+            lists_[v].sort();
+        std::vector<char>().swap(unsorted_);
+      }
+
+  // Each list is compacted once at least half of its edges have expired.
+  template<typename V, typename E, typename T>
+    void
+    temporal_graph<V, E, T>::expire(T t)
+    {
+      for (edge_list& l : lists_) {
+        std::size_t i = l.lower_bound(t);
+        size_ -= i - l.first;
+        l.first = i;
+        if (l.first != 0 && 2 * l.first >= l.times.size())
+          l.compact();
+      }
+    }
+
+  template<typename V, typename E, typename T>
+    void
+    temporal_graph<V, E, T>::shrink_to_fit()
+    {
+      for (edge_list& l : lists_) {
+        l.compact();
+        l.times.shrink_to_fit();
+        l.targets.shrink_to_fit();
+        l.values.shrink_to_fit();
+      }
+      lists_.shrink_to_fit();
+      values_.shrink_to_fit();
+    }
+
+  template<typename V, typename E, typename T>
+    inline auto
+    temporal_graph<V, E, T>::vertices() const -> vertex_range
+    {
+      using I = compressed_graph_impl::handle_counter<vertex_handle>;
+      return {I(0), I(order())};
+    }
+
+  template<typename V, typename E, typename T>
+    inline auto
+    temporal_graph<V, E, T>::out_edges(vertex v) const -> window
+    {
+      const edge_list& l = lists_[v];
+      std::size_t i = l.first;
+      return window(l.times.data() + i, l.targets.data() + i,
+                    l.values.data() + i, l.size());
+    }
+
+  template<typename V, typename E, typename T>
+    inline auto
+    temporal_graph<V, E, T>::out_edges(vertex v, T t0, T t1) const -> window
+    {
+      const edge_list& l = lists_[v];
+      std::size_t i = l.lower_bound(t0);
+      std::size_t j = t1 < t0 ? i : l.lower_bound(t1);
+      return window(l.times.data() + i, l.targets.data() + i,
+                    l.values.data() + i, j - i);
+    }
+
+
+  // Compute the earliest time at which each vertex is reached from s by a
+  // time-respecting path that departs no earlier than start and whose edges
+  // have times before end. The arrival time of s is start, and that of each
+  // unreachable vertex is never. The predecessor of each vertex is the
+  // previous vertex of such a path, or the invalid vertex for s and the
+  // unreachable vertices.
+  template<typename V, typename E, typename T>
+    void
+    earliest_arrival(const temporal_graph<V, E, T>& g, vertex_handle s,
+                     T start, T end,
+                     std::vector<T>& arrival,
+                     std::vector<vertex_handle>& pred)
+    {
+      constexpr T never = temporal_graph<V, E, T>::never;
+      arrival.assign(g.order(), never);
+      pred.assign(g.order(), vertex_handle());
+
+      indexed_heap<T, 4, std::less<T>, vertex_handle> heap(g.order());
+      arrival[s] = start;
+      heap.push(s, start);
+      while (!heap.empty()) {
+        vertex_handle u = heap.top();
+        heap.pop();
+        temporal_window<E, T> w = g.out_edges(u, arrival[u], end);
+        for (std::size_t i = 0; i != w.size(); ++i) {
+          vertex_handle v = w.target(i);
+          T t = w.time(i);
+          if (t < arrival[v]) {
+            arrival[v] = t;
+            pred[v] = u;
+            heap.update(v, t);
+          }
+        }
+      }
+    }
+
+  // Returns the earliest arrival time of each vertex from s.
+  template<typename V, typename E, typename T>
+    std::vector<T>
+    earliest_arrival(const temporal_graph<V, E, T>& g, vertex_handle s,
+                     T start, T end = temporal_graph<V, E, T>::never)
+    {
+      std::vector<T> arrival;
+      std::vector<vertex_handle> pred;
+      earliest_arrival(g, s, start, end, arrival, pred);
+      return arrival;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,141 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/temporal.hpp>
+
+using namespace std;
+using namespace origin;
+
+using G = temporal_graph<char, int, long>;
+using edge_desc = tuple<size_t, size_t, long, int>;
+
+// Returns the edges of es from u with times in [t0, t1), in order of time
+// and then of insertion.
+vector<edge_desc>
+window_of(const vector<edge_desc>& es, size_t u, long t0, long t1)
+{
+  vector<edge_desc> r;
+  for (const edge_desc& e : es)
+    if (get<0>(e) == u && get<2>(e) >= t0 && get<2>(e) < t1)
+      r.push_back(e);
+  stable_sort(r.begin(), r.end(), [](const edge_desc& a, const edge_desc& b) {
+    return get<2>(a) < get<2>(b);
+  });
+  return r;
+}
+
+void
+check_window(const G& g, const vector<edge_desc>& es, long t0, long t1)
+{
+  for (vertex_handle u : g.vertices()) {
+    vector<edge_desc> r = window_of(es, u, t0, t1);
+    G::window w = g.out_edges(u, t0, t1);
+    assert(w.size() == r.size());
+    for (size_t i = 0; i != w.size(); ++i) {
+      assert(w.target(i) == get<1>(r[i]));
+      assert(w.time(i) == get<2>(r[i]));
+      assert(w.value(i) == get<3>(r[i]));
+    }
+  }
+}
+
+// Returns the earliest arrival times from s by relaxing every edge until
+// nothing changes.
+vector<long>
+arrivals(size_t n, const vector<edge_desc>& es, size_t s, long start,
+         long end)
+{
+  vector<long> a(n, G::never);
+  a[s] = start;
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (const edge_desc& e : es) {
+      long t = get<2>(e);
+      size_t u = get<0>(e);
+      size_t v = get<1>(e);
+      if (a[u] != G::never && t >= a[u] && t < end && t < a[v]) {
+        a[v] = t;
+        changed = true;
+      }
+    }
+  }
+  return a;
+}
+
+void
+check_random(size_t n, size_t m, size_t seed)
+{
+  minstd_rand prng(seed);
+  vector<edge_desc> es;
+  for (size_t i = 0; i != m; ++i)
+    es.emplace_back(prng() % n, prng() % n, long(prng() % 1000), int(i));
+
+  // Edges are added one at a time, and in bulk.
+  G g;
+  G h;
+  for (size_t i = 0; i != n; ++i) {
+    g.add_vertex();
+    h.add_vertex();
+  }
+  for (const edge_desc& e : es)
+    g.add_edge(get<0>(e), get<1>(e), get<2>(e), get<3>(e));
+  h.add_edges(es);
+  assert(g.size() == m && h.size() == m);
+  check_window(g, es, 0, G::never);
+  check_window(h, es, 0, G::never);
+  check_window(g, es, 250, 600);
+  check_window(h, es, 600, 250);
+
+  for (size_t s = 0; s < n; s += n / 5 + 1) {
+    assert(earliest_arrival(g, s, 100L) == arrivals(n, es, s, 100, G::never));
+    assert(earliest_arrival(h, s, 0L, 500L) == arrivals(n, es, s, 0, 500));
+  }
+
+  // Expiring edges drops those before each time, and edges added after
+  // expiration are merged with those that remain.
+  for (long t : {100L, 150L, 400L, 900L}) {
+    g.expire(t);
+    es.erase(remove_if(es.begin(), es.end(), [t](const edge_desc& e) {
+      return get<2>(e) < t;
+    }), es.end());
+    assert(g.size() == es.size());
+    check_window(g, es, 0, G::never);
+    for (size_t i = 0; i != m / 10; ++i) {
+      edge_desc e(prng() % n, prng() % n, t + long(prng() % 200), -int(i));
+      es.push_back(e);
+      g.add_edge(get<0>(e), get<1>(e), get<2>(e), get<3>(e));
+    }
+    check_window(g, es, t, t + 100);
+  }
+  g.shrink_to_fit();
+  check_window(g, es, 0, G::never);
+}
+
+int main()
+{
+  check_random(1, 10, 1);
+  check_random(20, 200, 2);
+  check_random(100, 3000, 3);
+
+  // A path exists only when its times do not decrease.
+  temporal_graph<> g;
+  for (int i = 0; i != 4; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1, 5);
+  g.add_edge(1, 2, 3);
+  g.add_edge(1, 3, 5);
+  vector<int64_t> a;
+  vector<vertex_handle> p;
+  earliest_arrival(g, 0, int64_t(0), g.never, a, p);
+  assert(a[1] == 5 && a[2] == g.never && a[3] == 5);
+  assert(p[3] == 1 && !p[2] && !p[0]);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <stdexcept>
+
+#include "versioned.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                             Epoch Manager
+  //
+  // A slot holds one more than the epoch announced in it, or 0 when it is
+  // free. A reader claims a free slot, and then loads the shared data; a
+  // writer replaces the data, and then advances the epoch. All of these
+  // operations are sequentially consistent, so that a reader that loaded
+  // the replaced data had claimed its slot, with an epoch no later than the
+  // one returned by advance(), before the writer scans the slots.
+
+  epoch_manager::epoch_manager(std::size_t slots)
+    : epoch_(0), size_(slots), slots_(new std::atomic<std::uint64_t>[slots])
+  {
+    for (std::size_t i = 0; i != size_; ++i)
+      slots_[i].store(0);
+  }
+
+  std::size_t
+  epoch_manager::enter()
+  {
+    std::uint64_t e = epoch_.load();
+    for (std::size_t i = 0; i != size_; ++i) {
+      std::uint64_t free = 0;
+      if (slots_[i].load(std::memory_order_relaxed) == 0 &&
+          slots_[i].compare_exchange_strong(free, e + 1))
+        return i;
+    }
+    throw std::length_error("epoch manager has no free reader slots");
+  }
+
+  void
+  epoch_manager::exit(std::size_t s)
+  {
+    slots_[s].store(0, std::memory_order_release);
+  }
+
+  std::uint64_t
+  epoch_manager::advance()
+  {
+    return epoch_.fetch_add(1);
+  }
+
+  bool
+  epoch_manager::quiescent(std::uint64_t r) const
+  {
+    for (std::size_t i = 0; i != size_; ++i) {
+      std::uint64_t s = slots_[i].load();
+      if (s != 0 && s - 1 <= r)
+        return false;
+    }
+    return true;
+  }
+
+} // namespace origin
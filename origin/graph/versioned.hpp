@@ -0,0 +1,839 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_VERSIONED_HPP
+#define ORIGIN_GRAPH_VERSIONED_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/iterator.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/concurrent.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.versioned]
+  //                            Versioned Graphs
+  //
+  // A versioned graph is a directed graph that is read through consistent
+  // snapshots while it is being modified. Readers never wait for writers,
+  // and writers never wait for readers:
+  //
+  //    versioned_graph<V, E> g(h);         // Start from a copy of h
+  //    g.add_edge(u, v, x);                // Writers modify the graph...
+  //    auto s = g.acquire();               // ...while readers take views
+  //    pagerank(s, ranks);                 // A view is an immutable graph
+  //    g.compact();                        // Merge the changes, in any thread
+  //
+  // The graph is stored as a version: a frozen base, which is a compressed
+  // graph (see [graph.compressed]), and a delta log of the vertices and
+  // edges added and the edges removed since the base was built. Writers
+  // append to the log of the current version; a write takes a short lock,
+  // which serializes writers, and does not copy the graph. A reader
+  // acquires a view of the graph as of the last completed write: the base,
+  // and a prefix of the log. Later writes do not change what the view
+  // sees.
+  //
+  // An edge of a view is an edge of the base or of the log that had not
+  // been removed when the view was acquired. Each vertex heads a list of
+  // the log edges leaving and entering it, so that the out edges of a
+  // vertex are those of the base, less the removed ones, and those of its
+  // list. Traversals of views therefore slow down as the log grows, and
+  // compact() merges the log into a new base: it builds a compressed graph
+  // from a view of the graph, without blocking readers or writers, and then
+  // replays the writes made meanwhile onto the new version, which becomes
+  // current. Compaction may run in a background thread, concurrently with
+  // readers and writers; compactions are serialized with each other.
+  //
+  // Old versions are reclaimed by epochs. Each reader announces the epoch
+  // in which it acquired its view, and a version retired by compaction is
+  // deleted once no reader announced an epoch preceding its retirement. A
+  // graph has a fixed number of reader slots, chosen at construction;
+  // acquiring a view when every slot is taken throws std::length_error.
+  //
+  // The vertices of a view are numbered 0 to n - 1, in the order in which
+  // they were added. Edge handles are those of a version, and are valid
+  // only with views of the same version; edges are removed by their
+  // endpoints. Vertex and edge values cannot be modified once they are
+  // added. The degree of a vertex is counted in time linear in its degree.
+  // A view must be released (destroyed) before its graph.
+
+
+  // An epoch manager tracks the epochs announced by readers of shared
+  // data, so that data retired in an epoch can be deleted once no reader
+  // can refer to it. See versioned.cpp.
+  class epoch_manager
+  {
+  public:
+    // Initialize a manager with the given number of reader slots.
+    explicit epoch_manager(std::size_t slots);
+
+    // Announce the current epoch in a free slot, returning the slot. Throws
+    // std::length_error if every slot is taken.
+    std::size_t enter();
+
+    // Release the slot s.
+    void exit(std::size_t s);
+
+    // Begin a new epoch, returning the previous one. Data retired before
+    // advancing may be referred to by readers of that epoch or earlier.
+    std::uint64_t advance();
+
+    // Returns true if no reader announced the epoch r or an earlier one.
+    bool quiescent(std::uint64_t r) const;
+
+  private:
+    std::atomic<std::uint64_t> epoch_;
+    std::size_t size_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots_;
+  };
+
+
+  namespace versioned_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // The kinds of writes recorded in a delta log.
+    enum class delta_kind : unsigned char
+    {
+      vertex_added,
+      edge_added,
+      edges_removed
+    };
+
+    // A write in the delta log. The order and size are those of the graph
+    // after the write. An added edge records the positions of the previous
+    // edges added from its source and to its target, and the position of
+    // the write that removed it.
+    template<typename E>
+      struct delta
+      {
+        delta(delta_kind k, std::size_t u, std::size_t v, const E& x,
+              std::size_t n, std::size_t m, std::size_t po, std::size_t pi)
+          : kind(k), source(u), target(v), value(x), order(n), size(m),
+            prev_out(po), prev_in(pi), removed(npos)
+        { }
+
+        delta_kind kind;
+        std::size_t source;
+        std::size_t target;
+        E value;
+        std::size_t order;
+        std::size_t size;
+        std::size_t prev_out;
+        std::size_t prev_in;
+        std::atomic<std::size_t> removed;
+      };
+
+    // A version of a versioned graph: a compressed base, the position of
+    // the write that removed each of its edges, and the delta log. The
+    // values of vertices added after the base, and the last edge added
+    // from and to each vertex, are appended with the vertices.
+    template<typename V, typename E>
+      struct version
+      {
+        template<typename T>
+          using buffer = concurrent_impl::segmented_buffer<T>;
+
+        explicit version(compressed_graph<V, E>&& g)
+          : base(std::move(g)),
+            removed(new std::atomic<std::size_t>[base.size()]),
+            committed(0), order(base.order()), size(base.size())
+        {
+          for (std::size_t e = 0; e != base.size(); ++e)
+            removed[e].store(npos, std::memory_order_relaxed);
+          for (std::size_t v = 0; v != order; ++v) {
+            out_head.emplace(npos);
+            in_head.emplace(npos);
+          }
+        }
+
+        compressed_graph<V, E> base;
+        std::unique_ptr<std::atomic<std::size_t>[]> removed;
+        buffer<delta<E>> log;
+        buffer<V> values;
+        buffer<std::atomic<std::size_t>> out_head;
+        buffer<std::atomic<std::size_t>> in_head;
+        std::atomic<std::size_t> committed; // The length of the visible log
+
+        // The order and size of the graph after the last write, which are
+        // used only by writers.
+        std::size_t order;
+        std::size_t size;
+      };
+
+  } // namespace versioned_impl
+
+
+  template<typename V, typename E>
+    class versioned_graph;
+
+  // A version view is an immutable directed graph: the state of a
+  // versioned graph when the view was acquired. Views can be moved but not
+  // copied; destroying a view releases its reader slot.
+  template<typename V = empty_t, typename E = empty_t>
+    class version_view
+    {
+      using version_type = versioned_impl::version<V, E>;
+      template<bool Out>
+        class incidence_iterator;
+
+      // The predicate of the edge range.
+      struct edge_test
+      {
+        bool operator()(edge_handle e) const { return g->has_edge(e); }
+        const version_view* g;
+      };
+
+      friend class versioned_graph<V, E>;
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::handle_range<vertex_handle>;
+
+      using edge = edge_handle;
+      using edge_range = bounded_range<
+        filter_iterator<compressed_graph_impl::handle_counter<edge_handle>,
+                        edge_test>>;
+
+      using out_edge_range = bounded_range<incidence_iterator<true>>;
+      using in_edge_range = bounded_range<incidence_iterator<false>>;
+
+
+      version_view(version_view&& x);
+      version_view& operator=(version_view&& x);
+      ~version_view();
+
+      version_view(const version_view&) = delete;
+      version_view& operator=(const version_view&) = delete;
+
+
+      // Observers
+      bool        null() const  { return order_ == 0; }
+      std::size_t order() const { return order_; }
+
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+
+      // Returns the number of writes in the log seen by the view.
+      std::size_t deltas() const { return k_; }
+
+      // Returns true if e is an edge of the view.
+      bool has_edge(edge e) const;
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return count(out_edges(v)); }
+      std::size_t in_degree(vertex v) const  { return count(in_edges(v)); }
+      std::size_t degree(vertex v) const
+      {
+        return out_degree(v) + in_degree(v);
+      }
+
+      // Edge observers
+      vertex source(edge e) const;
+      vertex target(edge e) const;
+
+      // Data access
+      const V& operator()(vertex v) const;
+      const E& operator()(edge e) const;
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range   vertices() const { return {0, order_}; }
+      edge_range     edges() const;
+      out_edge_range out_edges(vertex v) const;
+      in_edge_range  in_edges(vertex v) const;
+
+    private:
+      version_view(epoch_manager& m, std::size_t slot, version_type* ver);
+
+      // Returns the distance of the log edge e from the end of the base.
+      std::size_t delta_of(edge e) const { return e - ver_->base.size(); }
+
+      template<typename R>
+        static std::size_t count(const R& r);
+
+    private:
+      epoch_manager* epochs_;
+      std::size_t slot_;
+      version_type* ver_;
+      std::size_t k_;     // The number of visible writes in the log
+      std::size_t order_;
+      std::size_t size_;
+    };
+
+
+  // The incidence iterator visits the out edges (when Out is true) or the
+  // in edges of a vertex of the base that were not removed, followed by the
+  // list of edges added by the log, newest first.
+  template<typename V, typename E>
+    template<bool Out>
+      class version_view<V, E>::incidence_iterator
+      {
+        using base_range =
+          If<Out, compressed_graph_impl::handle_range<edge_handle>,
+                  compressed_graph_impl::incidence_range>;
+        using base_iter = Iterator_of<base_range>;
+      public:
+        using value_type = edge_handle;
+        using reference = edge_handle;
+        using pointer = const edge_handle*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        incidence_iterator()
+          : g_(nullptr), rec_(versioned_impl::npos)
+        { }
+
+        // Initialize an iterator past the end of the base range r.
+        incidence_iterator(const version_view* g, base_iter last)
+          : g_(g), cur_(last), end_(last), rec_(versioned_impl::npos)
+        { }
+
+        // Initialize an iterator to the first visible edge of the base
+        // range r, or of the log list from position rec.
+        incidence_iterator(const version_view* g, base_range r,
+                           std::size_t rec)
+          : g_(g), cur_(std::begin(r)), end_(std::end(r)), rec_(rec)
+        {
+          settle_base();
+          settle_log();
+        }
+
+        edge_handle operator*() const
+        {
+          if (cur_ != end_)
+            return *cur_;
+          return g_->ver_->base.size() + rec_;
+        }
+
+        incidence_iterator& operator++()
+        {
+          if (cur_ != end_) {
+            ++cur_;
+            settle_base();
+          } else {
+            rec_ = next(rec_);
+            settle_log();
+          }
+          return *this;
+        }
+
+        incidence_iterator operator++(int)
+        {
+          incidence_iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        bool operator==(const incidence_iterator& x) const
+        {
+          return cur_ == x.cur_ && rec_ == x.rec_;
+        }
+
+        bool operator!=(const incidence_iterator& x) const
+        {
+          return !(*this == x);
+        }
+
+      private:
+        // Returns the previous edge in the log list of the vertex.
+        std::size_t next(std::size_t i) const
+        {
+          const auto& d = g_->ver_->log[i];
+          return Out ? d.prev_out : d.prev_in;
+        }
+
+        // Skip the removed edges of the base.
+        void settle_base()
+        {
+          while (cur_ != end_ && !g_->has_edge(*cur_))
+            ++cur_;
+        }
+
+        // Skip the log edges written after the view was acquired, or
+        // removed before it.
+        void settle_log()
+        {
+          while (rec_ != versioned_impl::npos &&
+                 (rec_ >= g_->k_ ||
+                  !g_->has_edge(g_->ver_->base.size() + rec_)))
+            rec_ = next(rec_);
+        }
+
+      private:
+        const version_view* g_;
+        base_iter cur_;
+        base_iter end_;
+        std::size_t rec_;
+      };
+
+
+  template<typename V, typename E>
+    version_view<V, E>::version_view(epoch_manager& m, std::size_t slot,
+                                     version_type* ver)
+      : epochs_(&m), slot_(slot), ver_(ver),
+        k_(ver->committed.load(std::memory_order_acquire))
+    {
+      if (k_ == 0) {
+        order_ = ver->base.order();
+        size_ = ver->base.size();
+      } else {
+        order_ = ver->log[k_ - 1].order;
+        size_ = ver->log[k_ - 1].size;
+      }
+    }
+
+  template<typename V, typename E>
+    version_view<V, E>::version_view(version_view&& x)
+      : epochs_(x.epochs_), slot_(x.slot_), ver_(x.ver_), k_(x.k_),
+        order_(x.order_), size_(x.size_)
+    {
+      x.epochs_ = nullptr;
+    }
+
+  template<typename V, typename E>
+    version_view<V, E>&
+    version_view<V, E>::operator=(version_view&& x)
+    {
+      if (this != &x) {
+        if (epochs_)
+          epochs_->exit(slot_);
+        epochs_ = x.epochs_;
+        slot_ = x.slot_;
+        ver_ = x.ver_;
+        k_ = x.k_;
+        order_ = x.order_;
+        size_ = x.size_;
+        x.epochs_ = nullptr;
+      }
+      return *this;
+    }
+
+  template<typename V, typename E>
+    version_view<V, E>::~version_view()
+    {
+      if (epochs_)
+        epochs_->exit(slot_);
+    }
+
+  // An edge is visible if it was added to the base or to the visible log,
+  // and was not removed by a visible write.
+  template<typename V, typename E>
+    bool
+    version_view<V, E>::has_edge(edge e) const
+    {
+      const std::size_t m = ver_->base.size();
+      if (e < m)
+        return ver_->removed[e].load(std::memory_order_relaxed) >= k_;
+      std::size_t i = e - m;
+      if (i >= k_)
+        return false;
+      const auto& d = ver_->log[i];
+      return d.kind == versioned_impl::delta_kind::edge_added
+          && d.removed.load(std::memory_order_relaxed) >= k_;
+    }
+
+  template<typename V, typename E>
+    inline auto
+    version_view<V, E>::source(edge e) const -> vertex
+    {
+      if (e < ver_->base.size())
+        return ver_->base.source(e);
+      return ver_->log[delta_of(e)].source;
+    }
+
+  template<typename V, typename E>
+    inline auto
+    version_view<V, E>::target(edge e) const -> vertex
+    {
+      if (e < ver_->base.size())
+        return ver_->base.target(e);
+      return ver_->log[delta_of(e)].target;
+    }
+
+  template<typename V, typename E>
+    inline const V&
+    version_view<V, E>::operator()(vertex v) const
+    {
+      if (v < ver_->base.order())
+        return ver_->base(v);
+      return ver_->values[v - ver_->base.order()];
+    }
+
+  template<typename V, typename E>
+    inline const E&
+    version_view<V, E>::operator()(edge e) const
+    {
+      if (e < ver_->base.size())
+        return ver_->base(e);
+      return ver_->log[delta_of(e)].value;
+    }
+
+  // Returns an edge (u, v), or an invalid edge handle if u and v are not
+  // adjacent.
+  template<typename V, typename E>
+    auto
+    version_view<V, E>::operator()(vertex u, vertex v) const -> edge
+    {
+      for (edge e : out_edges(u))
+        if (target(e) == v)
+          return e;
+      return edge();
+    }
+
+  template<typename V, typename E>
+    inline auto
+    version_view<V, E>::edges() const -> edge_range
+    {
+      return filter(compressed_graph_impl::handle_range<edge_handle>(
+                      0, ver_->base.size() + k_),
+                    edge_test {this});
+    }
+
+  template<typename V, typename E>
+    inline auto
+    version_view<V, E>::out_edges(vertex v) const -> out_edge_range
+    {
+      using I = incidence_iterator<true>;
+      const auto& b = ver_->base;
+      compressed_graph_impl::handle_range<edge_handle> r {0, 0};
+      if (v < b.order())
+        r = b.out_edges(v);
+      std::size_t h = ver_->out_head[v].load(std::memory_order_acquire);
+      return {I(this, r, h), I(this, std::end(r))};
+    }
+
+  template<typename V, typename E>
+    inline auto
+    version_view<V, E>::in_edges(vertex v) const -> in_edge_range
+    {
+      using I = incidence_iterator<false>;
+      const auto& b = ver_->base;
+      compressed_graph_impl::incidence_range r {nullptr, nullptr};
+      if (v < b.order())
+        r = b.in_edges(v);
+      std::size_t h = ver_->in_head[v].load(std::memory_order_acquire);
+      return {I(this, r, h), I(this, std::end(r))};
+    }
+
+  template<typename V, typename E>
+    template<typename R>
+      inline std::size_t
+      version_view<V, E>::count(const R& r)
+      {
+        std::size_t n = 0;
+        for (auto i = std::begin(r); i != std::end(r); ++i)
+          ++n;
+        return n;
+      }
+
+
+  // A versioned graph is a directed graph whose writers append to a delta
+  // log, and whose readers acquire views of it. The graph may be modified
+  // by several threads, whose writes are serialized.
+  template<typename V = empty_t, typename E = empty_t>
+    class versioned_graph
+    {
+      using version_type = versioned_impl::version<V, E>;
+      using delta_type = versioned_impl::delta<E>;
+    public:
+      using view_type = version_view<V, E>;
+
+      // The number of reader slots of a graph, by default.
+      static constexpr std::size_t default_readers = 64;
+
+
+      // Initialize an empty graph.
+      versioned_graph()
+        : epochs_(default_readers),
+          current_(new version_type(compressed_graph<V, E>()))
+      { }
+
+      // Initialize the graph with the vertices and edges of g, as a
+      // compressed graph, with the given number of reader slots.
+      template<typename G>
+        explicit versioned_graph(const G& g,
+                                 std::size_t readers = default_readers)
+          : epochs_(readers),
+            current_(new version_type(compressed_graph<V, E>(g)))
+        { }
+
+      versioned_graph(const versioned_graph&) = delete;
+      versioned_graph& operator=(const versioned_graph&) = delete;
+
+      ~versioned_graph();
+
+
+      // Readers
+
+      // Returns a view of the graph as of the last completed write.
+      view_type acquire();
+
+
+      // Writers
+      //
+      // Each returns when the write is visible to newly acquired views.
+
+      // Add a vertex whose value is x, returning its index.
+      std::size_t add_vertex(const V& x = V());
+
+      // Add an edge from u to v whose value is x.
+      void add_edge(std::size_t u, std::size_t v, const E& x = E());
+
+      // Remove every edge from u to v, returning the number removed.
+      std::size_t remove_edges(std::size_t u, std::size_t v);
+
+      // Returns the number of writes in the log of the current version.
+      std::size_t pending() const;
+
+
+      // Compaction and reclamation
+
+      // Merge the log into a new base, returning the number of writes
+      // merged. This may be called concurrently with readers and writers.
+      std::size_t compact();
+
+      // Delete the retired versions that no reader can see, returning the
+      // number of versions still retired.
+      std::size_t reclaim();
+
+    private:
+      // The writes, applied to the version w by a writer holding the lock.
+      static std::size_t add_vertex(version_type& w, const V& x);
+      static void add_edge(version_type& w, std::size_t u, std::size_t v,
+                           const E& x);
+      static std::size_t remove_edges(version_type& w, std::size_t u,
+                                      std::size_t v);
+
+      // Make the write at position i of the log of w visible.
+      static void commit(version_type& w, std::size_t i);
+
+      std::size_t reclaim_retired();
+
+    private:
+      epoch_manager epochs_;
+      std::atomic<version_type*> current_;
+      mutable std::mutex write_;   // Serializes writers
+      std::mutex compact_;         // Serializes compaction and reclamation
+      std::vector<std::pair<std::uint64_t, version_type*>> retired_;
+    };
+
+  template<typename V, typename E>
+    constexpr std::size_t versioned_graph<V, E>::default_readers;
+
+  template<typename V, typename E>
+    versioned_graph<V, E>::~versioned_graph()
+    {
+      delete current_.load();
+      for (auto& r : retired_)
+        delete r.second;
+    }
+
+  // The reader announces its epoch before it loads the current version, so
+  // that a version retired after the load is not deleted until the reader
+  // exits.
+  template<typename V, typename E>
+    auto
+    versioned_graph<V, E>::acquire() -> view_type
+    {
+      std::size_t s = epochs_.enter();
+      return view_type(epochs_, s, current_.load());
+    }
+
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::add_vertex(const V& x)
+    {
+      std::lock_guard<std::mutex> lock(write_);
+      return add_vertex(*current_.load(), x);
+    }
+
+  template<typename V, typename E>
+    void
+    versioned_graph<V, E>::add_edge(std::size_t u, std::size_t v, const E& x)
+    {
+      std::lock_guard<std::mutex> lock(write_);
+      add_edge(*current_.load(), u, v, x);
+    }
+
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::remove_edges(std::size_t u, std::size_t v)
+    {
+      std::lock_guard<std::mutex> lock(write_);
+      return remove_edges(*current_.load(), u, v);
+    }
+
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::pending() const
+    {
+      std::lock_guard<std::mutex> lock(write_);
+      return current_.load()->log.size();
+    }
+
+  template<typename V, typename E>
+    inline void
+    versioned_graph<V, E>::commit(version_type& w, std::size_t i)
+    {
+      const delta_type& d = w.log[i];
+      w.order = d.order;
+      w.size = d.size;
+      w.committed.store(i + 1, std::memory_order_release);
+    }
+
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::add_vertex(version_type& w, const V& x)
+    {
+      using versioned_impl::npos;
+      std::size_t v = w.order;
+      w.values.emplace(x);
+      w.out_head.emplace(npos);
+      w.in_head.emplace(npos);
+      std::size_t i = w.log.emplace(versioned_impl::delta_kind::vertex_added,
+                                    v, v, E(), v + 1, w.size, npos, npos);
+      commit(w, i);
+      return v;
+    }
+
+  // The edge is linked into the lists of its endpoints before it is made
+  // visible; readers of earlier views skip it. The heads of the lists are
+  // published after the edge is written, so that readers following them
+  // find a complete entry.
+  template<typename V, typename E>
+    void
+    versioned_graph<V, E>::add_edge(version_type& w, std::size_t u,
+                                    std::size_t v, const E& x)
+    {
+      assert(u < w.order && v < w.order);
+      std::size_t po = w.out_head[u].load(std::memory_order_relaxed);
+      std::size_t pi = w.in_head[v].load(std::memory_order_relaxed);
+      std::size_t i = w.log.emplace(versioned_impl::delta_kind::edge_added,
+                                    u, v, x, w.order, w.size + 1, po, pi);
+      w.out_head[u].store(i, std::memory_order_release);
+      w.in_head[v].store(i, std::memory_order_release);
+      commit(w, i);
+    }
+
+  // Each edge removed is marked with the position of the write, which views
+  // acquired before the write do not see.
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::remove_edges(version_type& w, std::size_t u,
+                                        std::size_t v)
+    {
+      using versioned_impl::npos;
+      assert(u < w.order && v < w.order);
+      std::size_t j = w.log.size();
+      std::size_t n = 0;
+      auto mark = [&](std::atomic<std::size_t>& r) {
+        if (r.load(std::memory_order_relaxed) == npos) {
+          r.store(j, std::memory_order_relaxed);
+          ++n;
+        }
+      };
+      if (u < w.base.order())
+        for (edge_handle e : w.base.out_edges(u))
+          if (w.base.target(e) == v)
+            mark(w.removed[e]);
+      std::size_t i = w.out_head[u].load(std::memory_order_relaxed);
+      while (i != npos) {
+        delta_type& d = w.log[i];
+        if (d.target == v)
+          mark(d.removed);
+        i = d.prev_out;
+      }
+      std::size_t k = w.log.emplace(versioned_impl::delta_kind::edges_removed,
+                                    u, v, E(), w.order, w.size - n, npos, npos);
+      commit(w, k);
+      return n;
+    }
+
+  // The new base is built from a view, while writers continue to append to
+  // the current log. The writes made since the view was acquired are then
+  // replayed onto the new version under the writer lock, so that no write
+  // is lost, and the new version replaces the current one.
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::compact()
+    {
+      using versioned_impl::delta_kind;
+      std::lock_guard<std::mutex> lock(compact_);
+      std::size_t k;
+      std::unique_ptr<version_type> next;
+      {
+        view_type s = acquire();
+        k = s.deltas();
+        next.reset(new version_type(compressed_graph<V, E>(s)));
+      }
+
+      {
+        std::lock_guard<std::mutex> write(write_);
+        version_type* old = current_.load();
+        std::size_t last = old->committed.load(std::memory_order_relaxed);
+        for (std::size_t i = k; i != last; ++i) {
+          const delta_type& d = old->log[i];
+          switch (d.kind) {
+          case delta_kind::vertex_added:
+            add_vertex(*next, old->values[d.source - old->base.order()]);
+            break;
+          case delta_kind::edge_added:
+            add_edge(*next, d.source, d.target, d.value);
+            break;
+          case delta_kind::edges_removed:
+            remove_edges(*next, d.source, d.target);
+            break;
+          }
+        }
+        current_.store(next.release());
+        retired_.emplace_back(epochs_.advance(), old);
+      }
+      reclaim_retired();
+      return k;
+    }
+
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::reclaim()
+    {
+      std::lock_guard<std::mutex> lock(compact_);
+      return reclaim_retired();
+    }
+
+  template<typename V, typename E>
+    std::size_t
+    versioned_graph<V, E>::reclaim_retired()
+    {
+      auto i = retired_.begin();
+      while (i != retired_.end()) {
+        if (epochs_.quiescent(i->first)) {
+          delete i->second;
+          i = retired_.erase(i);
+        } else {
+          ++i;
+        }
+      }
+      return retired_.size();
+    }
+
+} // namespace origin
+
+#endif
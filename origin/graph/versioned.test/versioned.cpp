@@ -0,0 +1,228 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <origin/graph/versioned.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/search.hpp>
+
+using namespace std;
+using namespace origin;
+
+using G = versioned_graph<int, int>;
+using S = version_view<int, int>;
+using D = directed_adjacency_list<int, int>;
+
+static_assert(Directed_graph<S>(), "");
+
+
+// Returns the sorted endpoints and values of the edges of g.
+template<typename X>
+  vector<tuple<size_t, size_t, int>>
+  edge_values(const X& g)
+  {
+    vector<tuple<size_t, size_t, int>> r;
+    for (Edge<X> e : g.edges())
+      r.emplace_back(g.source(e), g.target(e), g(e));
+    sort(r.begin(), r.end());
+    return r;
+  }
+
+// Returns true if the view is consistent: its size is its number of edges,
+// and each edge is listed once in the out edges of its source and the in
+// edges of its target.
+bool
+is_consistent(const S& s)
+{
+  size_t m = 0;
+  for (Edge<S> e : s.edges()) {
+    assert(s.has_edge(e));
+    ++m;
+  }
+  size_t outs = 0;
+  size_t ins = 0;
+  for (Vertex<S> v : s.vertices()) {
+    for (Edge<S> e : s.out_edges(v)) {
+      if (s.source(e) != v)
+        return false;
+      ++outs;
+    }
+    for (Edge<S> e : s.in_edges(v)) {
+      if (s.target(e) != v)
+        return false;
+      ++ins;
+    }
+  }
+  return m == s.size() && outs == m && ins == m;
+}
+
+void
+check_empty()
+{
+  G g;
+  S s = g.acquire();
+  assert(s.null());
+  assert(s.empty());
+  assert(g.add_vertex(7) == 0);
+  assert(s.null());
+
+  S t = g.acquire();
+  assert(t.order() == 1);
+  assert(t(Vertex<S>(0)) == 7);
+  assert(t.out_edges(0).begin() == t.out_edges(0).end());
+}
+
+// Views see the graph as of their acquisition, and changes to the graph
+// are those made to an adjacency list.
+void
+check_views()
+{
+  D h;
+  for (int i = 0; i != 6; ++i)
+    h.add_vertex(i);
+  for (int i = 0; i != 6; ++i) {
+    h.add_edge(i, (i + 1) % 6, i);
+    h.add_edge(i, (i + 2) % 6, 10 + i);
+  }
+  G g(h, 4);
+  S s0 = g.acquire();
+  assert(edge_values(s0) == edge_values(h));
+  assert(is_consistent(s0));
+
+  g.add_edge(0, 3, 20);
+  h.add_edge(0, 3, 20);
+  g.add_edge(0, 1, 21);
+  h.add_edge(0, 1, 21);
+  assert(g.remove_edges(0, 1) == 2);
+  h.remove_edges(0, 1);
+  assert(g.add_vertex(6) == 6);
+  h.add_vertex(6);
+  g.add_edge(6, 6, 22);
+  h.add_edge(6, 6, 22);
+  g.add_edge(5, 6, 23);
+  h.add_edge(5, 6, 23);
+  assert(g.remove_edges(2, 4) == 1);
+  h.remove_edges(2, 4);
+  assert(g.remove_edges(2, 4) == 0);
+  assert(g.pending() == 8);
+
+  S s1 = g.acquire();
+  assert(s1.order() == 7);
+  assert(s1.size() == h.size());
+  assert(edge_values(s1) == edge_values(h));
+  assert(is_consistent(s1));
+  assert(!s1(0, 1));
+  assert(s1(6, 6));
+  assert(s1.out_degree(0) == 2);
+  assert(s1.in_degree(6) == 2);
+
+  // The first view is unchanged.
+  assert(s0.order() == 6);
+  assert(s0.size() == 12);
+  assert(s0(0, 1));
+  assert(is_consistent(s0));
+
+  // Compaction merges the log, keeping the views, and retires the old
+  // version until they are released.
+  assert(g.compact() == 8);
+  assert(g.pending() == 0);
+  S s2 = g.acquire();
+  assert(s2.deltas() == 0);
+  assert(edge_values(s2) == edge_values(h));
+  assert(is_consistent(s2));
+  assert(edge_values(s1) == edge_values(h));
+  assert(g.reclaim() == 1);
+
+  // Every slot is taken.
+  S s3 = g.acquire();
+  bool full = false;
+  try {
+    g.acquire();
+  } catch (length_error&) {
+    full = true;
+  }
+  assert(full);
+
+  s0 = move(s3);
+  { S x = move(s1); }
+  assert(g.reclaim() == 0);
+
+  // Searches run on views.
+  vector<size_t> levels = breadth_first_levels(s2, 0, 1);
+  assert(levels[0] == 0);
+  assert(levels[5] == 2);
+  assert(levels[6] == 3);
+}
+
+// A writer adds and removes edges, and compacts the graph, while readers
+// check that their views are consistent.
+void
+check_concurrent()
+{
+  G g(compressed_graph<int, int>(), 16);
+  const int n = 64;
+  for (int i = 0; i != n; ++i)
+    g.add_vertex(i);
+
+  atomic<bool> done(false);
+  auto read = [&]() {
+    while (!done.load()) {
+      S s = g.acquire();
+      assert(s.order() == size_t(n));
+      assert(is_consistent(s));
+    }
+  };
+  vector<thread> readers;
+  for (int i = 0; i != 3; ++i)
+    readers.emplace_back(read);
+  thread compactor([&]() {
+    while (!done.load()) {
+      g.compact();
+      this_thread::yield();
+    }
+  });
+
+  D h;
+  for (int i = 0; i != n; ++i)
+    h.add_vertex(i);
+  for (int k = 0; k != 20000; ++k) {
+    int u = (k * 7) % n;
+    int v = (u + 1 + k % 5) % n;
+    g.add_edge(u, v, k);
+    h.add_edge(u, v, k);
+    if (k % 3 == 0) {
+      int a = (k * 13) % n;
+      int b = (a + 1 + k % 5) % n;
+      g.remove_edges(a, b);
+      h.remove_edges(a, b);
+    }
+  }
+
+  done.store(true);
+  for (thread& t : readers)
+    t.join();
+  compactor.join();
+
+  S s = g.acquire();
+  assert(edge_values(s) == edge_values(h));
+  assert(is_consistent(s));
+}
+
+int
+main()
+{
+  check_empty();
+  check_views();
+  check_concurrent();
+}
@@ -0,0 +1,384 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_GRAPH_VIEW_HPP
+#define ORIGIN_GRAPH_VIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include <origin/sequence/iterator.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [graph.view]
+  //                               Graph Views
+  //
+  // A graph view is a read-only graph whose vertices and edges are those of
+  // an underlying graph, seen through an adaptor. No vertices or edges are
+  // copied: a view holds a reference to its graph, which must outlive it,
+  // and its vertex and edge handles are those of the graph, so that the
+  // results of an algorithm on a view (such as labels indexed by vertex
+  // handle) apply directly to the graph. A view has the interface of the
+  // graphs it adapts, and so it is directed or undirected when its graph is
+  // (see graph.concepts), and every algorithm runs on it. The views are:
+  //
+  //    filtered_graph<G, VP, EP>   the vertices v of g for which vp(v), and
+  //                                the edges e between them for which ep(e)
+  //    reverse_graph<G>            the transpose of the directed graph g
+  //
+  // and they are made by:
+  //
+  //    make_filtered_graph(g, vp[, ep])
+  //    make_reverse_graph(g)
+  //
+  // The ranges of a filtered graph are filter ranges (see range.filter)
+  // over those of g, which skip the vertices and edges that do not satisfy
+  // the predicates as they are traversed. The degree of a vertex, and the
+  // order and size of the graph, are counted by traversal, in time linear in
+  // the number of incident edges, vertices, or edges of g. The predicates
+  // are called each time an element is traversed, and so must be cheap and
+  // must not change while the view is used. Changing the graph invalidates
+  // no views, but it does invalidate the iterators of their ranges.
+  //
+  // A reverse graph exchanges the out and in edges of each vertex, and the
+  // source and target of each edge, so its operations take the same time
+  // as those of g. Views compose: the reverse of a filtered graph is a
+  // filtered transpose.
+
+
+  namespace view_impl
+  {
+    template<typename G>
+      using Vertex_range = decltype(std::declval<const G&>().vertices());
+
+    template<typename G>
+      using Edge_range = decltype(std::declval<const G&>().edges());
+
+    template<typename G>
+      using Out_edge_range =
+        decltype(std::declval<const G&>().out_edges(std::declval<Vertex<G>>()));
+
+    template<typename G>
+      using In_edge_range =
+        decltype(std::declval<const G&>().in_edges(std::declval<Vertex<G>>()));
+
+    template<typename G>
+      using Incident_edge_range =
+        decltype(std::declval<const G&>().edges(std::declval<Vertex<G>>()));
+
+    template<typename G>
+      using Vertex_value =
+        decltype(std::declval<const G&>()(std::declval<Vertex<G>>()));
+
+    template<typename G>
+      using Edge_value =
+        decltype(std::declval<const G&>()(std::declval<Edge<G>>()));
+
+    // The predicate of a filtered graph that keeps every edge.
+    struct keep_all
+    {
+      template<typename T>
+        bool operator()(const T&) const { return true; }
+    };
+
+    // Returns the number of elements of the range r.
+    template<typename R>
+      inline std::size_t
+      count(const R& r)
+      {
+        std::size_t n = 0;
+        for (auto i = std::begin(r); i != std::end(r); ++i)
+          ++n;
+        return n;
+      }
+
+  } // namespace view_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.filtered]
+  //                             Filtered Graphs
+  //
+  // A filtered graph is the subgraph of g with the vertices v for which
+  // vp(v), and the edges e for which ep(e) whose endpoints are both vertices
+  // of the subgraph. For example, the subgraph induced by a set of vertices
+  // is:
+  //
+  //    auto h = make_filtered_graph(g, [&](Vertex<G> v) { return in[v]; });
+  //
+  // Vertices that are not in the subgraph are treated as removed vertices,
+  // whose handles are not in the ranges of the graph.
+  template<typename G, typename VP, typename EP = view_impl::keep_all>
+    class filtered_graph
+    {
+    public:
+      using vertex = Vertex<G>;
+      using edge = Edge<G>;
+
+    private:
+      // The predicates of the ranges of the graph.
+      struct vertex_test
+      {
+        bool operator()(vertex v) const { return g->has_vertex(v); }
+        const filtered_graph* g;
+      };
+
+      struct edge_test
+      {
+        bool operator()(edge e) const { return g->has_edge(e); }
+        const filtered_graph* g;
+      };
+
+      template<typename R, typename P>
+        using Filtered =
+          bounded_range<filter_iterator<Iterator_of<R>, P>>;
+
+    public:
+      using vertex_range = Filtered<view_impl::Vertex_range<G>, vertex_test>;
+      using edge_range = Filtered<view_impl::Edge_range<G>, edge_test>;
+
+
+      // Initialize the view of the graph g.
+      filtered_graph(const G& g, VP vp, EP ep = {})
+        : g_(g), vp_(vp), ep_(ep)
+      { }
+
+      // Returns the underlying graph.
+      const G& base() const { return g_; }
+
+      // Returns true if v is a vertex of the subgraph.
+      bool has_vertex(vertex v) const { return vp_(v); }
+
+      // Returns true if e is an edge of the subgraph.
+      bool has_edge(edge e) const
+      {
+        return ep_(e) && vp_(g_.source(e)) && vp_(g_.target(e));
+      }
+
+
+      // Observers
+      bool        null() const  { return order() == 0; }
+      std::size_t order() const { return view_impl::count(vertices()); }
+
+      bool        empty() const { return size() == 0; }
+      std::size_t size() const  { return view_impl::count(edges()); }
+
+      // Vertex observers
+      template<typename X = G>
+        auto out_degree(vertex v) const
+          -> decltype(std::declval<const X&>().out_edges(v), std::size_t())
+        {
+          return view_impl::count(out_edges(v));
+        }
+
+      template<typename X = G>
+        auto in_degree(vertex v) const
+          -> decltype(std::declval<const X&>().in_edges(v), std::size_t())
+        {
+          return view_impl::count(in_edges(v));
+        }
+
+      std::size_t degree(vertex v) const { return degree_of(g_, v); }
+
+      // Edge observers
+      vertex source(edge e) const { return g_.source(e); }
+      vertex target(edge e) const { return g_.target(e); }
+
+      // Data access
+      view_impl::Vertex_value<G> operator()(vertex v) const { return g_(v); }
+      view_impl::Edge_value<G>   operator()(edge e) const   { return g_(e); }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range vertices() const
+      {
+        return filter(g_.vertices(), vertex_test {this});
+      }
+
+      edge_range edges() const
+      {
+        return filter(g_.edges(), edge_test {this});
+      }
+
+      template<typename X = G>
+        auto out_edges(vertex v) const
+          -> Filtered<view_impl::Out_edge_range<X>, edge_test>
+        {
+          return filter(g_.out_edges(v), edge_test {this});
+        }
+
+      template<typename X = G>
+        auto in_edges(vertex v) const
+          -> Filtered<view_impl::In_edge_range<X>, edge_test>
+        {
+          return filter(g_.in_edges(v), edge_test {this});
+        }
+
+      template<typename X = G>
+        auto edges(vertex v) const
+          -> Filtered<view_impl::Incident_edge_range<X>, edge_test>
+        {
+          return filter(g_.edges(v), edge_test {this});
+        }
+
+    private:
+      // The degree of v is the number of out and in edges of a directed
+      // graph, or of incident edges of an undirected graph.
+      template<typename X>
+        auto degree_of(const X& g, vertex v) const
+          -> decltype(g.in_edges(v), std::size_t())
+        {
+          return out_degree(v) + in_degree(v);
+        }
+
+      template<typename X>
+        auto degree_of(const X& g, vertex v) const
+          -> decltype(g.edges(v), std::size_t())
+        {
+          return view_impl::count(edges(v));
+        }
+
+      // Returns the first edge from u to v, or a null edge.
+      template<typename X>
+        auto find_edge(const X& g, vertex u, vertex v) const
+          -> decltype(g.out_edges(u), edge())
+        {
+          for (edge e : out_edges(u))
+            if (target(e) == v)
+              return e;
+          return edge();
+        }
+
+      template<typename X>
+        auto find_edge(const X& g, vertex u, vertex v) const
+          -> decltype(g.edges(u), edge())
+        {
+          for (edge e : edges(u))
+            if (opposite(*this, e, u) == v)
+              return e;
+          return edge();
+        }
+
+    private:
+      const G& g_;
+      VP vp_;
+      EP ep_;
+    };
+
+  template<typename G, typename VP, typename EP>
+    inline auto
+    filtered_graph<G, VP, EP>::operator()(vertex u, vertex v) const -> edge
+    {
+      if (!has_vertex(u) || !has_vertex(v))
+        return edge();
+      return find_edge(g_, u, v);
+    }
+
+  // Returns the subgraph of g with the vertices satisfying vp, and the edges
+  // between them satisfying ep.
+  template<typename G, typename VP, typename EP>
+    inline filtered_graph<G, VP, EP>
+    make_filtered_graph(const G& g, VP vp, EP ep)
+    {
+      return {g, vp, ep};
+    }
+
+  // Returns the subgraph of g induced by the vertices satisfying vp.
+  template<typename G, typename VP>
+    inline filtered_graph<G, VP>
+    make_filtered_graph(const G& g, VP vp)
+    {
+      return {g, vp};
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                             [graph.reverse]
+  //                              Reverse Graphs
+  //
+  // The reverse graph of a directed graph g has an edge from v to u for each
+  // edge from u to v in g, with the same handle and value. Searching the
+  // reverse graph follows the in edges of g, so that, for example, the
+  // vertices reaching a vertex v in g are those reached from v in the
+  // reverse graph.
+  template<typename G>
+    class reverse_graph
+    {
+      static_assert(Directed_graph<G>(), "");
+    public:
+      using vertex = Vertex<G>;
+      using edge = Edge<G>;
+
+      using vertex_range = view_impl::Vertex_range<G>;
+      using edge_range = view_impl::Edge_range<G>;
+      using out_edge_range = view_impl::In_edge_range<G>;
+      using in_edge_range = view_impl::Out_edge_range<G>;
+
+
+      // Initialize the transpose of the graph g.
+      explicit reverse_graph(const G& g)
+        : g_(g)
+      { }
+
+      // Returns the underlying graph.
+      const G& base() const { return g_; }
+
+
+      // Observers
+      bool        null() const  { return g_.null(); }
+      std::size_t order() const { return g_.order(); }
+
+      bool        empty() const { return g_.empty(); }
+      std::size_t size() const  { return g_.size(); }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return g_.in_degree(v); }
+      std::size_t in_degree(vertex v) const  { return g_.out_degree(v); }
+      std::size_t degree(vertex v) const     { return g_.degree(v); }
+
+      // Edge observers
+      vertex source(edge e) const { return g_.target(e); }
+      vertex target(edge e) const { return g_.source(e); }
+
+      // Data access
+      view_impl::Vertex_value<G> operator()(vertex v) const { return g_(v); }
+      view_impl::Edge_value<G>   operator()(edge e) const   { return g_(e); }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const { return g_(v, u); }
+
+      // Iterators
+      vertex_range   vertices() const          { return g_.vertices(); }
+      edge_range     edges() const             { return g_.edges(); }
+      out_edge_range out_edges(vertex v) const { return g_.in_edges(v); }
+      in_edge_range  in_edges(vertex v) const  { return g_.out_edges(v); }
+
+    private:
+      const G& g_;
+    };
+
+  // Returns the reverse graph of g.
+  template<typename G>
+    inline reverse_graph<G>
+    make_reverse_graph(const G& g)
+    {
+      return reverse_graph<G>(g);
+    }
+
+} // namespace origin
+
+#endif
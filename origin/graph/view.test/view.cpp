@@ -0,0 +1,226 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+
+#include <origin/graph/view.hpp>
+#include <origin/graph/adjacency_list.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+#include <origin/graph/analytics.hpp>
+#include <origin/graph/components.hpp>
+#include <origin/graph/compressed_graph.hpp>
+#include <origin/graph/shortest_paths.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns a random edge weight in [1, 9].
+int
+random_weight(minstd_rand& prng)
+{
+  return 1 + prng() % 9;
+}
+
+// The predicates of the filtered graphs.
+struct not_third
+{
+  template<typename V>
+    bool operator()(V v) const { return v % 3 != 0; }
+};
+
+template<typename G>
+  struct not_weight
+  {
+    bool operator()(Edge<G> e) const { return (*g)(e) != w; }
+    const G* g;
+    int w;
+  };
+
+// Returns true if the labels a and b define the same partition.
+bool
+same_partition(const vector<size_t>& a, const vector<size_t>& b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i != a.size(); ++i)
+    for (size_t j = 0; j != i; ++j)
+      if ((a[i] == a[j]) != (b[i] == b[j]))
+        return false;
+  return true;
+}
+
+// Returns a copy of g without the vertices and edges that a filtered graph h
+// of g excludes.
+template<typename G, typename H>
+  G
+  materialize(const G& g, const H& h)
+  {
+    G c = g;
+    vector<Edge<G>> es;
+    for (Edge<G> e : c.edges())
+      if (!h.has_edge(e))
+        es.push_back(e);
+    for (Edge<G> e : es)
+      c.remove_edge(e);
+    vector<Vertex<G>> vs;
+    for (Vertex<G> v : c.vertices())
+      if (!h.has_vertex(v))
+        vs.push_back(v);
+    for (Vertex<G> v : vs)
+      c.remove_vertex(v);
+    return c;
+  }
+
+void
+check_directed_filter()
+{
+  using G = directed_adjacency_list<char, int>;
+  G g = build_erdos_renyi_graph<G>(300, 1200, 1, random_weight);
+  auto h = make_filtered_graph(g, not_third(), not_weight<G> {&g, 5});
+  static_assert(Directed_graph<decltype(h)>(), "");
+  static_assert(!Undirected_graph<decltype(h)>(), "");
+  G c = materialize(g, h);
+
+  assert(h.order() == c.order());
+  assert(h.size() == c.size());
+  for (Vertex<G> v : c.vertices()) {
+    assert(h.out_degree(v) == c.out_degree(v));
+    assert(h.in_degree(v) == c.in_degree(v));
+    assert(h.degree(v) == c.degree(v));
+  }
+  assert(!h.has_vertex(0) && h.has_vertex(1));
+  for (Edge<G> e : g.edges()) {
+    Edge<G> f = h(g.source(e), g.target(e));
+    if (h.has_edge(e))
+      assert(f && h.has_edge(f));
+    else if (f)
+      assert(h.has_edge(f));
+  }
+
+  // Algorithms compute the same results on the view as on the copy.
+  vector<size_t> a, b;
+  assert(strong_components(h, a) == strong_components(c, b));
+  assert(same_partition(a, b));
+  assert(breadth_first_levels(h, 1) == breadth_first_levels(c, 1));
+  assert(dijkstra_distances(h, 2) == dijkstra_distances(c, 2));
+}
+
+void
+check_undirected_filter()
+{
+  using G = undirected_adjacency_list<char, int>;
+  G g = build_erdos_renyi_graph<G>(400, 1600, 2, random_weight);
+  auto h = make_filtered_graph(g, not_third());
+  static_assert(Undirected_graph<decltype(h)>(), "");
+  G c = materialize(g, h);
+
+  assert(h.order() == c.order());
+  assert(h.size() == c.size());
+  for (Vertex<G> v : c.vertices())
+    assert(h.degree(v) == c.degree(v));
+
+  vector<size_t> a, b;
+  assert(connected_components(h, a) == connected_components(c, b));
+  assert(a == b);
+  assert(count_triangles(h) == count_triangles(c));
+  assert(core_numbers(h, a) == core_numbers(c, b));
+  assert(a == b);
+
+  // An adjacency vector, whose vertices cannot be removed, is filtered by
+  // its edges alone.
+  using U = undirected_adjacency_vector<char, int>;
+  U u = build_erdos_renyi_graph<U>(100, 300, 3, random_weight);
+  auto k = make_filtered_graph(u, [](Vertex<U>) { return true; },
+                               not_weight<U> {&u, 1});
+  size_t m = 0;
+  for (Edge<U> e : u.edges())
+    m += u(e) != 1;
+  assert(k.size() == m && k.order() == u.order());
+  for (Edge<U> e : k.edges())
+    assert(k(e) != 1);
+}
+
+template<typename G>
+  void
+  check_reverse(const G& g)
+  {
+    reverse_graph<G> r = make_reverse_graph(g);
+    static_assert(Directed_graph<reverse_graph<G>>(), "");
+
+    // The explicit transpose, with the edges in the same order.
+    using T = directed_adjacency_list<char, int>;
+    T t = build_n_graph<T>(g.order());
+    for (Edge<G> e : g.edges())
+      t.add_edge(g.target(e), g.source(e), g(e));
+
+    assert(r.order() == g.order() && r.size() == g.size());
+    for (Vertex<G> v : g.vertices()) {
+      assert(r.out_degree(v) == g.in_degree(v));
+      assert(r.in_degree(v) == g.out_degree(v));
+      for (Edge<G> e : r.out_edges(v))
+        assert(r.source(e) == v && g.target(e) == v);
+    }
+    for (Edge<G> e : g.edges())
+      assert(r(g.target(e), g.source(e)));
+
+    vector<size_t> a, b;
+    assert(strong_components(r, a) == strong_components(g, b));
+    assert(same_partition(a, b));
+    for (Vertex<G> s : {0, 5})
+      assert(dijkstra_distances(r, s) == dijkstra_distances(t, s));
+
+    // The reverse of the reverse is the graph.
+    reverse_graph<reverse_graph<G>> rr(r);
+    for (Vertex<G> v : g.vertices())
+      assert(rr.out_degree(v) == g.out_degree(v));
+
+    // A reversed filtered graph.
+    auto h = make_filtered_graph(g, not_third());
+    auto rh = make_reverse_graph(h);
+    for (Vertex<G> v : h.vertices())
+      assert(rh.out_degree(v) == h.in_degree(v));
+  }
+
+void
+check_topological()
+{
+  // The reverse of a DAG is a DAG, sorted in the opposite direction.
+  using G = directed_adjacency_list<char, int>;
+  G g = build_n_graph<G>(200);
+  minstd_rand prng(4);
+  for (size_t i = 0; i != 800; ++i) {
+    size_t u = prng() % 200, v = prng() % 200;
+    if (u != v)
+      g.add_edge(min(u, v), max(u, v), 1);
+  }
+  auto r = make_reverse_graph(g);
+  vector<Vertex<G>> order;
+  assert(topological_sort(r, order));
+  vector<size_t> pos(200);
+  for (size_t i = 0; i != order.size(); ++i)
+    pos[order[i]] = i;
+  for (Edge<G> e : g.edges())
+    assert(pos[g.target(e)] < pos[g.source(e)]);
+}
+
+int main()
+{
+  check_directed_filter();
+  check_undirected_filter();
+
+  using D = directed_adjacency_list<char, int>;
+  D d = build_erdos_renyi_graph<D>(200, 700, 5, random_weight);
+  check_reverse(d);
+  check_reverse(compressed_graph<char, int>(d));
+  check_reverse(build_erdos_renyi_graph<directed_adjacency_vector<char, int>>(
+    150, 600, 6, random_weight));
+  check_topological();
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+#include "histogram.hpp"
+
+namespace origin
+{
+  namespace
+  {
+    constexpr std::uint64_t no_min = std::numeric_limits<std::uint64_t>::max();
+    constexpr std::uint64_t exact =
+      std::uint64_t(1) << latency_histogram::precision;
+  } // namespace
+
+  latency_histogram::latency_histogram()
+    : count_(0), sum_(0), min_(no_min), max_(0)
+  {
+    for (std::atomic<std::uint64_t>& c : counts_)
+      c.store(0, std::memory_order_relaxed);
+  }
+
+  latency_histogram::latency_histogram(const latency_histogram& x)
+    : latency_histogram()
+  {
+    merge(x);
+  }
+
+  latency_histogram&
+  latency_histogram::operator=(const latency_histogram& x)
+  {
+    if (this != &x) {
+      reset();
+      merge(x);
+    }
+    return *this;
+  }
+
+  void
+  latency_histogram::merge(const latency_histogram& x)
+  {
+    for (std::size_t i = 0; i != buckets; ++i)
+      if (std::uint64_t n = x.bucket_count(i))
+        counts_[i].fetch_add(n, std::memory_order_relaxed);
+    count_.fetch_add(x.count_.load(), std::memory_order_relaxed);
+    sum_.fetch_add(x.sum_.load(), std::memory_order_relaxed);
+    update_min(x.min_.load());
+    update_max(x.max_.load());
+  }
+
+  void
+  latency_histogram::reset()
+  {
+    for (std::atomic<std::uint64_t>& c : counts_)
+      c.store(0, std::memory_order_relaxed);
+    count_ = 0;
+    sum_ = 0;
+    min_ = no_min;
+    max_ = 0;
+  }
+
+  std::uint64_t
+  latency_histogram::min() const
+  {
+    std::uint64_t m = min_.load();
+    return m == no_min ? 0 : m;
+  }
+
+  double
+  latency_histogram::mean() const
+  {
+    std::uint64_t n = count();
+    return n ? double(sum()) / n : 0;
+  }
+
+  // The rank of the quantile is the least number of values that are at
+  // least the fraction q of the values, and at least 1. The buckets are
+  // counted separately from the total, so a histogram that is being
+  // recorded may have fewer values in its buckets than its count says.
+  std::uint64_t
+  latency_histogram::value_at_quantile(double q) const
+  {
+    std::uint64_t n = count();
+    if (n == 0)
+      return 0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    std::uint64_t rank = std::max<std::uint64_t>(1, std::ceil(q * n));
+    std::uint64_t seen = 0;
+    std::size_t i = 0;
+    for (; i != buckets; ++i) {
+      seen += bucket_count(i);
+      if (seen >= rank)
+        break;
+    }
+    if (i == buckets)
+      return max();
+    return std::min(upper_bound(i), max());
+  }
+
+  std::uint64_t
+  latency_histogram::lower_bound(std::size_t i)
+  {
+    if (i < exact)
+      return i;
+    std::size_t shift = (i - exact) / (exact / 2) + 1;
+    return std::uint64_t(i - exact / 2 * shift) << shift;
+  }
+
+  std::uint64_t
+  latency_histogram::upper_bound(std::size_t i)
+  {
+    if (i < exact)
+      return i;
+    std::size_t shift = (i - exact) / (exact / 2) + 1;
+    return lower_bound(i) + ((std::uint64_t(1) << shift) - 1);
+  }
+
+
+  latency_summary
+  summarize(const std::string& name, const latency_histogram& h)
+  {
+    return {name, h.count(), h.sum(), h.min(), h.max(), h.mean(),
+            h.value_at_quantile(0.5), h.value_at_quantile(0.9),
+            h.value_at_quantile(0.99), h.value_at_quantile(0.999)};
+  }
+
+  namespace
+  {
+    void
+    write_text(std::ostream& os, const std::vector<latency_summary>& ss)
+    {
+      os << std::left << std::setw(28) << "site" << std::right
+         << std::setw(12) << "count" << std::setw(12) << "mean"
+         << std::setw(10) << "p50" << std::setw(10) << "p90"
+         << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+         << std::setw(12) << "max" << "   (ns)\n";
+      for (const latency_summary& s : ss)
+        os << std::left << std::setw(28) << s.name << std::right
+           << std::setw(12) << s.count
+           << std::setw(12) << std::fixed << std::setprecision(1) << s.mean
+           << std::defaultfloat
+           << std::setw(10) << s.p50 << std::setw(10) << s.p90
+           << std::setw(10) << s.p99 << std::setw(10) << s.p999
+           << std::setw(12) << s.max << '\n';
+    }
+
+    void
+    write_prometheus(std::ostream& os, const std::vector<latency_summary>& ss)
+    {
+      os << "# HELP origin_latency_ns "
+         << "Latency of the operations at each site, in nanoseconds.\n"
+         << "# TYPE origin_latency_ns summary\n";
+      const char* quantiles[] = {"0.5", "0.9", "0.99", "0.999"};
+      for (const latency_summary& s : ss) {
+        std::uint64_t values[] = {s.p50, s.p90, s.p99, s.p999};
+        for (std::size_t i = 0; i != 4; ++i) {
+          os << "origin_latency_ns{site=";
+          instrument_impl::write_label(os, s.name);
+          os << ",quantile=\"" << quantiles[i] << "\"} " << values[i] << '\n';
+        }
+        os << "origin_latency_ns_sum{site=";
+        instrument_impl::write_label(os, s.name);
+        os << "} " << s.sum << '\n';
+        os << "origin_latency_ns_count{site=";
+        instrument_impl::write_label(os, s.name);
+        os << "} " << s.count << '\n';
+      }
+    }
+  } // namespace
+
+  void
+  write_latency_summaries(std::ostream& os,
+                          const std::vector<latency_summary>& ss,
+                          instrument_format f)
+  {
+    if (f == instrument_format::prometheus)
+      write_prometheus(os, ss);
+    else
+      write_text(os, ss);
+  }
+
+  void
+  write_histogram_buckets(std::ostream& os, const latency_histogram& h)
+  {
+    os << "lower,upper,count\n";
+    for (std::size_t i = 0; i != latency_histogram::buckets; ++i)
+      if (std::uint64_t n = h.bucket_count(i))
+        os << latency_histogram::lower_bound(i) << ','
+           << latency_histogram::upper_bound(i) << ',' << n << '\n';
+  }
+
+} // namespace origin
@@ -0,0 +1,218 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_INSTRUMENT_HISTOGRAM_HPP
+#define ORIGIN_INSTRUMENT_HISTOGRAM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <origin/instrument/instrument.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Latency Histograms                                   instrument.histogram
+  //
+  // A latency histogram records the distribution of the durations of an
+  // operation, in nanoseconds, so that its tail (the 99th and 99.9th
+  // percentiles) can be observed as well as its mean. For example:
+  //
+  //    latency_histogram h;
+  //    for (...) {
+  //      latency_timer t(h);
+  //      insert(x);
+  //    }
+  //    std::cout << h.value_at_quantile(0.999) << " ns\n";
+  //
+  // The histogram has a fixed, log-linear layout, like that of the HDR
+  // histogram: the values less than 2^b are counted exactly, and each
+  // higher power of two [2^k, 2^(k + 1)) is divided into 2^(b - 1) buckets
+  // of equal width. With b = 7, every value up to 2^64 is recorded with a
+  // relative error of less than 1/64 (about 1.6%) in 3776 buckets. A value
+  // is recorded by a few shifts and an atomic increment, without any
+  // allocation, so recording is cheap enough to stay enabled in production
+  // code, and values may be recorded by several threads at once.
+  //
+  // The quantiles of a histogram are the upper bounds of the buckets that
+  // contain them, so they are never less than the recorded values they
+  // stand for.
+  class latency_histogram
+  {
+  public:
+    // The number of bits of precision of a bucket.
+    static constexpr std::size_t precision = 7;
+
+    // The number of buckets.
+    static constexpr std::size_t buckets =
+      (std::size_t(1) << precision)
+      + (64 - precision) * (std::size_t(1) << (precision - 1));
+
+    latency_histogram();
+
+    // The copy of a histogram that is being recorded may not include the
+    // values recorded during the copy.
+    latency_histogram(const latency_histogram& x);
+    latency_histogram& operator=(const latency_histogram& x);
+
+    // Record the value v.
+    void record(std::uint64_t v)
+    {
+      counts_[bucket(v)].fetch_add(1, std::memory_order_relaxed);
+      count_.fetch_add(1, std::memory_order_relaxed);
+      sum_.fetch_add(v, std::memory_order_relaxed);
+      update_min(v);
+      update_max(v);
+    }
+
+    // Add the values recorded by x to this histogram.
+    void merge(const latency_histogram& x);
+
+    // Remove every recorded value.
+    void reset();
+
+    // Returns the number of values recorded.
+    std::uint64_t count() const { return count_.load(); }
+
+    // Returns the sum of the values recorded.
+    std::uint64_t sum() const { return sum_.load(); }
+
+    // Returns the least and greatest values recorded, or 0 if there are
+    // none.
+    std::uint64_t min() const;
+    std::uint64_t max() const { return max_.load(); }
+
+    // Returns the mean of the values recorded, or 0 if there are none.
+    double mean() const;
+
+    // Returns the value below which at least the fraction q of the recorded
+    // values lie, for q in [0, 1]. Returns 0 if there are no values.
+    std::uint64_t value_at_quantile(double q) const;
+
+    // Returns the number of values in the bucket i.
+    std::uint64_t bucket_count(std::size_t i) const
+    {
+      return counts_[i].load(std::memory_order_relaxed);
+    }
+
+    // Returns the index of the bucket of the value v.
+    static std::size_t bucket(std::uint64_t v)
+    {
+      constexpr std::uint64_t exact = std::uint64_t(1) << precision;
+      if (v < exact)
+        return std::size_t(v);
+      std::size_t k = 63 - std::size_t(__builtin_clzll(v));
+      std::size_t shift = k - precision + 1;
+      return std::size_t(exact / 2 * shift + (v >> shift));
+    }
+
+    // Returns the least and greatest values of the bucket i.
+    static std::uint64_t lower_bound(std::size_t i);
+    static std::uint64_t upper_bound(std::size_t i);
+
+  private:
+    void update_min(std::uint64_t v)
+    {
+      std::uint64_t m = min_.load(std::memory_order_relaxed);
+      while (v < m && !min_.compare_exchange_weak(m, v,
+                                                  std::memory_order_relaxed))
+        ;
+    }
+
+    void update_max(std::uint64_t v)
+    {
+      std::uint64_t m = max_.load(std::memory_order_relaxed);
+      while (v > m && !max_.compare_exchange_weak(m, v,
+                                                  std::memory_order_relaxed))
+        ;
+    }
+
+    std::atomic<std::uint64_t> counts_[buckets];
+    std::atomic<std::uint64_t> count_;
+    std::atomic<std::uint64_t> sum_;
+    std::atomic<std::uint64_t> min_;
+    std::atomic<std::uint64_t> max_;
+  };
+
+
+  // A latency timer records the time from its construction to its
+  // destruction, in nanoseconds of the steady clock, in a histogram.
+  class latency_timer
+  {
+    using clock = std::chrono::steady_clock;
+  public:
+    explicit latency_timer(latency_histogram& h)
+      : hist(h), start(clock::now())
+    { }
+
+    ~latency_timer()
+    {
+      std::chrono::nanoseconds t = clock::now() - start;
+      hist.record(std::uint64_t(t.count()));
+    }
+
+    latency_timer(const latency_timer&) = delete;
+    latency_timer& operator=(const latency_timer&) = delete;
+
+  private:
+    latency_histogram& hist;
+    clock::time_point start;
+  };
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Latency Summaries                                      instrument.latency
+  //
+  // A latency summary describes a named histogram by its count, extremes,
+  // mean and common quantiles. Summaries are written as text, or in the
+  // Prometheus text exposition format as a summary metric:
+  //
+  //    # TYPE origin_latency_ns summary
+  //    origin_latency_ns{site="graph.add_edge",quantile="0.5"} 45
+  //    origin_latency_ns{site="graph.add_edge",quantile="0.99"} 180
+  //    origin_latency_ns{site="graph.add_edge",quantile="0.999"} 2100
+  //    origin_latency_ns_sum{site="graph.add_edge"} 5123456
+  //    origin_latency_ns_count{site="graph.add_edge"} 100000
+  //
+  // The buckets of a histogram are written as comma separated values with
+  // a header line (lower,upper,count), one line for each bucket that is not
+  // empty, so that the full distribution can be plotted or merged offline.
+  struct latency_summary
+  {
+    std::string   name;
+    std::uint64_t count;
+    std::uint64_t sum;
+    std::uint64_t min;
+    std::uint64_t max;
+    double        mean;
+    std::uint64_t p50;
+    std::uint64_t p90;
+    std::uint64_t p99;
+    std::uint64_t p999;
+  };
+
+  // Returns the summary of the histogram h, named name.
+  latency_summary summarize(const std::string& name,
+                            const latency_histogram& h);
+
+  // Write the summaries ss in the format f.
+  void write_latency_summaries(std::ostream& os,
+                               const std::vector<latency_summary>& ss,
+                               instrument_format f = instrument_format::text);
+
+  // Write the buckets of the histogram h that are not empty.
+  void write_histogram_buckets(std::ostream& os, const latency_histogram& h);
+
+} // namespace origin
+
+#endif
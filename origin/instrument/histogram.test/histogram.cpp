@@ -0,0 +1,137 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <origin/instrument/histogram.hpp>
+
+using namespace std;
+using namespace origin;
+
+using H = latency_histogram;
+
+// The buckets cover every value, in order, and each value is within 1/64
+// of the bounds of its bucket.
+void
+check_buckets()
+{
+  assert(H::bucket(0) == 0 && H::bucket(127) == 127);
+  assert(H::bucket(128) == 128 && H::bucket(UINT64_MAX) == H::buckets - 1);
+  for (size_t i = 0; i != H::buckets; ++i) {
+    uint64_t lo = H::lower_bound(i);
+    uint64_t hi = H::upper_bound(i);
+    assert(H::bucket(lo) == i && H::bucket(hi) == i);
+    if (i + 1 != H::buckets)
+      assert(H::lower_bound(i + 1) == hi + 1);
+    assert(hi - lo <= lo / 64);
+  }
+}
+
+void
+check_quantiles()
+{
+  H h;
+  assert(h.count() == 0 && h.min() == 0 && h.max() == 0);
+  assert(h.value_at_quantile(0.99) == 0);
+
+  for (uint64_t v = 1; v <= 10000; ++v)
+    h.record(v);
+  assert(h.count() == 10000 && h.min() == 1 && h.max() == 10000);
+  assert(h.mean() == 5000.5);
+  uint64_t p50 = h.value_at_quantile(0.5);
+  uint64_t p99 = h.value_at_quantile(0.99);
+  uint64_t p999 = h.value_at_quantile(0.999);
+  assert(5000 <= p50 && p50 <= 5000 + 5000 / 64);
+  assert(9900 <= p99 && p99 <= 9900 + 9900 / 64);
+  assert(9990 <= p999 && p999 <= 10000);
+  assert(h.value_at_quantile(1) == 10000);
+  assert(h.value_at_quantile(0) == 1);
+
+  // A rare spike is seen in the tail, but not in the median.
+  H s;
+  for (int i = 0; i != 9990; ++i)
+    s.record(50);
+  for (int i = 0; i != 10; ++i)
+    s.record(1000000);
+  assert(s.value_at_quantile(0.99) == 50);
+  assert(s.value_at_quantile(0.9995) >= 1000000);
+}
+
+void
+check_merge()
+{
+  H a, b;
+  a.record(10);
+  b.record(20);
+  b.record(30);
+  a.merge(b);
+  assert(a.count() == 3 && a.sum() == 60 && a.max() == 30);
+  H c = a;
+  assert(c.count() == 3 && c.min() == 10);
+  c.reset();
+  assert(c.count() == 0 && c.value_at_quantile(0.5) == 0);
+
+  // Values are recorded concurrently.
+  H t;
+  vector<thread> ts;
+  for (int i = 0; i != 4; ++i)
+    ts.emplace_back([&t]() {
+      for (int j = 0; j != 10000; ++j)
+        t.record(uint64_t(j));
+    });
+  for (thread& x : ts)
+    x.join();
+  assert(t.count() == 40000 && t.bucket_count(0) == 4);
+}
+
+void
+check_output()
+{
+  H h;
+  h.record(100);
+  h.record(1000);
+  vector<latency_summary> ss {summarize("op", h)};
+  assert(ss[0].p50 == 100 && ss[0].max == 1000);
+
+  ostringstream ts;
+  write_latency_summaries(ts, ss);
+  assert(ts.str().find("p99.9") != string::npos);
+
+  ostringstream ps;
+  write_latency_summaries(ps, ss, instrument_format::prometheus);
+  assert(ps.str().find("# TYPE origin_latency_ns summary") != string::npos);
+  assert(ps.str().find("origin_latency_ns{site=\"op\",quantile=\"0.5\"} 100")
+         != string::npos);
+  assert(ps.str().find("origin_latency_ns_count{site=\"op\"} 2")
+         != string::npos);
+
+  ostringstream bs;
+  write_histogram_buckets(bs, h);
+  assert(bs.str() == "lower,upper,count\n100,100,1\n1000,1007,1\n");
+
+  // The timer records the duration of its scope.
+  H d;
+  {
+    latency_timer t(d);
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  assert(d.count() == 1 && d.min() >= 1000000);
+}
+
+int main()
+{
+  check_buckets();
+  check_quantiles();
+  check_merge();
+  check_output();
+}
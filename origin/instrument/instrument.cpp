@@ -0,0 +1,391 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define ORIGIN_INSTRUMENT_HAS_TSC 1
+#endif
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define ORIGIN_INSTRUMENT_HAS_PERF 1
+#endif
+
+#include "instrument.hpp"
+
+namespace origin
+{
+  namespace instrument_impl
+  {
+    void
+    write_label(std::ostream& os, const std::string& s)
+    {
+      os << '"';
+      for (char c : s) {
+        if (c == '"' || c == '\\')
+          os << '\\';
+        os << c;
+      }
+      os << '"';
+    }
+  } // namespace instrument_impl
+
+  namespace
+  {
+    using instrument_impl::write_label;
+
+    struct site
+    {
+      std::string     name;
+      instrument_kind kind;
+    };
+
+    // The registry holds the sites, the blocks of the running threads, and
+    // the totals of the threads that have exited.
+    struct registry
+    {
+      registry();
+      ~registry();
+
+      std::mutex                                 lock;
+      std::vector<site>                          sites;
+      std::vector<instrument_impl::thread_block*> blocks;
+      std::uint64_t counts[instrument_impl::max_sites];
+      std::uint64_t ticks[instrument_impl::max_sites];
+    };
+
+    registry&
+    the_registry()
+    {
+      static registry r;
+      return r;
+    }
+
+    // Returns the totals of the sites of the registry r, whose lock is held.
+    std::vector<instrument_record>
+    totals(registry& r)
+    {
+      std::vector<instrument_record> rs;
+      for (std::size_t i = 0; i != r.sites.size(); ++i) {
+        instrument_record x {r.sites[i].name, r.sites[i].kind,
+                             r.counts[i], r.ticks[i]};
+        for (instrument_impl::thread_block* b : r.blocks) {
+          x.count += b->counts[i].load(std::memory_order_relaxed);
+          x.ticks += b->ticks[i].load(std::memory_order_relaxed);
+        }
+        rs.push_back(x);
+      }
+      std::sort(rs.begin(), rs.end(),
+                [](const instrument_record& a, const instrument_record& b) {
+                  return a.name < b.name;
+                });
+      return rs;
+    }
+
+    void
+    write_prometheus(std::ostream& os,
+                     const std::vector<instrument_record>& rs,
+                     instrument_clock c)
+    {
+      os << "# HELP origin_instrument_events_total "
+         << "Events counted at each site.\n"
+         << "# TYPE origin_instrument_events_total counter\n";
+      for (const instrument_record& r : rs)
+        if (r.kind == instrument_kind::counter) {
+          os << "origin_instrument_events_total{site=";
+          write_label(os, r.name);
+          os << "} " << r.count << '\n';
+        }
+
+      os << "# HELP origin_instrument_scopes_total "
+         << "Scopes timed at each site.\n"
+         << "# TYPE origin_instrument_scopes_total counter\n";
+      for (const instrument_record& r : rs)
+        if (r.kind == instrument_kind::timer) {
+          os << "origin_instrument_scopes_total{site=";
+          write_label(os, r.name);
+          os << "} " << r.count << '\n';
+        }
+
+      os << "# HELP origin_instrument_ticks_total "
+         << "Total time of the scopes timed at each site.\n"
+         << "# TYPE origin_instrument_ticks_total counter\n";
+      for (const instrument_record& r : rs)
+        if (r.kind == instrument_kind::timer) {
+          os << "origin_instrument_ticks_total{site=";
+          write_label(os, r.name);
+          os << ",unit=\"" << clock_unit(c) << "\"} " << r.ticks << '\n';
+        }
+    }
+
+    void
+    write_text(std::ostream& os,
+               const std::vector<instrument_record>& rs,
+               instrument_clock c)
+    {
+      os << std::left << std::setw(28) << "site" << std::right
+         << std::setw(16) << "count"
+         << std::setw(18) << "ticks"
+         << std::setw(14) << "per scope"
+         << "   (clock " << c << ", " << clock_unit(c) << ")\n";
+      for (const instrument_record& r : rs) {
+        os << std::left << std::setw(28) << r.name << std::right
+           << std::setw(16) << r.count;
+        if (r.kind == instrument_kind::timer) {
+          double mean = r.count ? double(r.ticks) / r.count : 0;
+          os << std::setw(18) << r.ticks
+             << std::setw(14) << std::fixed << std::setprecision(1) << mean
+             << std::defaultfloat;
+        }
+        os << '\n';
+      }
+    }
+
+    registry::registry()
+    {
+      std::fill_n(counts, instrument_impl::max_sites, 0);
+      std::fill_n(ticks, instrument_impl::max_sites, 0);
+    }
+
+    // The blocks of the threads have been merged when the registry is
+    // destroyed, so the totals are written without them.
+    registry::~registry()
+    {
+      const char* path = std::getenv("ORIGIN_INSTRUMENT_OUTPUT");
+      if (!path || sites.empty())
+        return;
+      std::ofstream f(path);
+      if (f)
+        write_prometheus(f, totals(*this), get_instrument_clock());
+      else
+        std::cerr << "error: cannot write instrument summary to "
+                  << path << '\n';
+    }
+
+
+    // Returns the clock named by the environment, or the steady clock.
+    instrument_clock
+    initial_clock()
+    {
+      const char* s = std::getenv("ORIGIN_INSTRUMENT_CLOCK");
+      if (s) {
+        if (std::strcmp(s, "tsc") == 0)
+          return instrument_clock::tsc;
+        if (std::strcmp(s, "perf") == 0)
+          return instrument_clock::perf_cycles;
+      }
+      return instrument_clock::steady;
+    }
+
+    std::atomic<int>&
+    current_clock()
+    {
+      static std::atomic<int> c {int(initial_clock())};
+      return c;
+    }
+
+    // Returns a descriptor counting the CPU cycles of the calling thread,
+    // or -1 if the counter cannot be opened.
+    int
+    open_cycles()
+    {
+#if defined(ORIGIN_INSTRUMENT_HAS_PERF)
+      perf_event_attr a;
+      std::memset(&a, 0, sizeof(a));
+      a.type = PERF_TYPE_HARDWARE;
+      a.size = sizeof(a);
+      a.config = PERF_COUNT_HW_CPU_CYCLES;
+      a.exclude_kernel = 1;
+      a.exclude_hv = 1;
+      return int(syscall(__NR_perf_event_open, &a, 0, -1, -1, 0));
+#else
+      return -1;
+#endif
+    }
+
+    std::uint64_t
+    read_cycles(instrument_impl::thread_block& b)
+    {
+#if defined(ORIGIN_INSTRUMENT_HAS_PERF)
+      if (b.perf_fd == -2)
+        b.perf_fd = open_cycles();
+      std::uint64_t n;
+      if (b.perf_fd >= 0 && read(b.perf_fd, &n, sizeof(n)) == sizeof(n))
+        return n;
+#endif
+      return 0;
+    }
+  } // namespace
+
+
+  bool
+  set_instrument_clock(instrument_clock c)
+  {
+    switch (c) {
+    case instrument_clock::tsc:
+#if !defined(ORIGIN_INSTRUMENT_HAS_TSC)
+      return false;
+#endif
+      break;
+    case instrument_clock::perf_cycles:
+      if (read_cycles(instrument_impl::local_block()) == 0)
+        return false;
+      break;
+    default:
+      break;
+    }
+    current_clock() = int(c);
+    return true;
+  }
+
+  instrument_clock
+  get_instrument_clock()
+  {
+    return instrument_clock(current_clock().load());
+  }
+
+  const char*
+  clock_unit(instrument_clock c)
+  {
+    switch (c) {
+    case instrument_clock::tsc:
+      return "ticks";
+    case instrument_clock::perf_cycles:
+      return "cycles";
+    default:
+      return "ns";
+    }
+  }
+
+  std::ostream&
+  operator<<(std::ostream& os, instrument_clock c)
+  {
+    switch (c) {
+    case instrument_clock::tsc:
+      return os << "tsc";
+    case instrument_clock::perf_cycles:
+      return os << "perf";
+    default:
+      return os << "steady";
+    }
+  }
+
+
+  namespace instrument_impl
+  {
+    thread_block::thread_block()
+      : perf_fd(-2)
+    {
+      for (std::size_t i = 0; i != max_sites; ++i) {
+        counts[i] = 0;
+        ticks[i] = 0;
+      }
+      registry& r = the_registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      r.blocks.push_back(this);
+    }
+
+    thread_block::~thread_block()
+    {
+      registry& r = the_registry();
+      {
+        std::lock_guard<std::mutex> guard(r.lock);
+        for (std::size_t i = 0; i != max_sites; ++i) {
+          r.counts[i] += counts[i].load(std::memory_order_relaxed);
+          r.ticks[i] += ticks[i].load(std::memory_order_relaxed);
+        }
+        r.blocks.erase(std::find(r.blocks.begin(), r.blocks.end(), this));
+      }
+#if defined(ORIGIN_INSTRUMENT_HAS_PERF)
+      if (perf_fd >= 0)
+        close(perf_fd);
+#endif
+    }
+
+    std::size_t
+    register_site(const char* name, instrument_kind k)
+    {
+      registry& r = the_registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      for (std::size_t i = 0; i != r.sites.size(); ++i)
+        if (r.sites[i].name == name) {
+          if (r.sites[i].kind != k)
+            throw std::logic_error(std::string("instrument site ") + name +
+                                   " registered with different kinds");
+          return i;
+        }
+      if (r.sites.size() == max_sites)
+        throw std::length_error("too many instrument sites");
+      r.sites.push_back(site {name, k});
+      return r.sites.size() - 1;
+    }
+
+    std::uint64_t
+    read_clock()
+    {
+      switch (instrument_clock(current_clock().load(std::memory_order_relaxed)))
+      {
+#if defined(ORIGIN_INSTRUMENT_HAS_TSC)
+      case instrument_clock::tsc:
+        return __rdtsc();
+#endif
+      case instrument_clock::perf_cycles:
+        return read_cycles(local_block());
+      default:
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(
+          steady_clock::now().time_since_epoch()).count();
+      }
+    }
+  } // namespace instrument_impl
+
+
+  std::vector<instrument_record>
+  instrument_summary()
+  {
+    registry& r = the_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    return totals(r);
+  }
+
+  void
+  reset_instruments()
+  {
+    registry& r = the_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    std::fill_n(r.counts, instrument_impl::max_sites, 0);
+    std::fill_n(r.ticks, instrument_impl::max_sites, 0);
+    for (instrument_impl::thread_block* b : r.blocks)
+      for (std::size_t i = 0; i != instrument_impl::max_sites; ++i) {
+        b->counts[i].store(0, std::memory_order_relaxed);
+        b->ticks[i].store(0, std::memory_order_relaxed);
+      }
+  }
+
+  void
+  write_instrument_summary(std::ostream& os, instrument_format f)
+  {
+    std::vector<instrument_record> rs = instrument_summary();
+    if (f == instrument_format::prometheus)
+      write_prometheus(os, rs, get_instrument_clock());
+    else
+      write_text(os, rs, get_instrument_clock());
+  }
+
+} // namespace origin
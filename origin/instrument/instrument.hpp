@@ -0,0 +1,276 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_INSTRUMENT_INSTRUMENT_HPP
+#define ORIGIN_INSTRUMENT_INSTRUMENT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <origin/instrument/trace.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Instrumentation                                                instrument
+  //
+  // The hot paths of the library are instrumented by hooks that count events
+  // and time scopes at named sites:
+  //
+  //    ORIGIN_COUNT(name)          Count one event at the site name
+  //    ORIGIN_COUNT_N(name, n)     Count n events at the site name
+  //    ORIGIN_TIME_SCOPE(name)     Time the rest of the enclosing scope, and
+  //                                record it in the trace while tracing
+  //
+  // The hooks are compiled only when ORIGIN_INSTRUMENT is defined (by the
+  // CMake option of the same name). Otherwise, they expand to nothing, and
+  // their arguments are not evaluated, so a disabled hook costs nothing. The
+  // macro must be defined in every translation unit or in none.
+  //
+  // When enabled, each site is registered by name the first time that its
+  // hook runs, so that the sites of different instantiations of a template
+  // with the same name are counted together. The names of sites must be
+  // string literals. The values of a site are kept
+  // per thread: a hook only loads and stores a slot of its own thread, with
+  // no locked instruction. The slots of a thread are merged into the totals
+  // of the process when the thread exits. For example:
+  //
+  //    void insert(T x)
+  //    {
+  //      ORIGIN_COUNT("mylib.insert");
+  //      ORIGIN_TIME_SCOPE("mylib.insert.time");
+  //      ...
+  //    }
+  //
+  // The sites of the library are:
+  //
+  //    graph.pool.insert      An object constructed in a pool (adjacency_list)
+  //    graph.pool.reuse       A free index of a pool reused by an insertion
+  //    graph.pool.erase       An object erased from a pool
+  //    graph.edge.link        An edge linked into the incidence lists
+  //    graph.edge.unlink      An edge erased from an adjacency list
+  //    matrix.product         The time of each matrix_product (a timer)
+  //    matrix.slice.carry     The end of a run of a non-contiguous slice
+  //                           iterator, where it carries into an outer index
+  //    graph.bfs.*, graph.sssp.*, graph.iterative.*
+  //                           The levels, phases, sweeps and edges of the
+  //                           graph traversals (see [graph.traversal])
+  //    graph.community        The time of each community detection (a
+  //                           timer), with .levels, .sweeps and .aggregate
+  //                           (see [graph.community])
+#if defined(ORIGIN_INSTRUMENT)
+  constexpr bool instrument_enabled = true;
+#else
+  constexpr bool instrument_enabled = false;
+#endif
+
+  // A site either counts events or times scopes.
+  enum class instrument_kind { counter, timer };
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Timer Clocks                                             instrument.clock
+  //
+  // Timers read one of the following clocks:
+  //
+  //    steady        std::chrono::steady_clock, in nanoseconds (the default)
+  //    tsc           The time stamp counter of x86 processors, in ticks
+  //    perf_cycles   The CPU cycles of the thread, counted by the Linux
+  //                  perf_event interface
+  //
+  // The time stamp counter is cheaper to read than the steady clock, and
+  // the perf_event counter excludes the time that the thread is not running,
+  // but it is read by a system call. The clock may also be selected by the
+  // environment variable ORIGIN_INSTRUMENT_CLOCK (steady, tsc or perf). It
+  // should be selected before any scope is timed, since the ticks of
+  // different clocks are not comparable.
+  enum class instrument_clock { steady, tsc, perf_cycles };
+
+  // Select the clock of the timers. Returns false, leaving the clock
+  // unchanged, if the clock c is not available on this machine. If the
+  // perf_event counter cannot be opened by a thread that is timed later,
+  // the scopes of that thread are counted but not timed.
+  bool set_instrument_clock(instrument_clock c);
+
+  // Returns the clock of the timers.
+  instrument_clock get_instrument_clock();
+
+  // Returns the unit of the ticks of the clock c: "ns", "ticks" or "cycles".
+  const char* clock_unit(instrument_clock c);
+
+  // Write the name of the clock c.
+  std::ostream& operator<<(std::ostream& os, instrument_clock c);
+
+
+  namespace instrument_impl
+  {
+    // The maximum number of sites in a program.
+    constexpr std::size_t max_sites = 128;
+
+    // The values of the sites of one thread. Each slot is written only by
+    // its thread, and read by threads writing a summary.
+    struct thread_block
+    {
+      thread_block();
+      ~thread_block();
+
+      thread_block(const thread_block&) = delete;
+      thread_block& operator=(const thread_block&) = delete;
+
+      std::atomic<std::uint64_t> counts[max_sites];
+      std::atomic<std::uint64_t> ticks[max_sites];
+      int perf_fd;
+    };
+
+    // Returns the block of the calling thread.
+    inline thread_block&
+    local_block()
+    {
+      static thread_local thread_block block;
+      return block;
+    }
+
+    // Add n to the slot x, which is written only by this thread.
+    inline void
+    add(std::atomic<std::uint64_t>& x, std::uint64_t n)
+    {
+      x.store(x.load(std::memory_order_relaxed) + n,
+              std::memory_order_relaxed);
+    }
+
+    // Returns the index of the site with the given name, registering it if
+    // needed. Throws std::logic_error if the site was registered with a
+    // different kind, and std::length_error if there are max_sites sites.
+    std::size_t register_site(const char* name, instrument_kind k);
+
+    // Returns the current reading of the clock of the timers.
+    std::uint64_t read_clock();
+
+    // Write the Prometheus label value s, escaping quotes and backslashes.
+    void write_label(std::ostream& os, const std::string& s);
+  } // namespace instrument_impl
+
+
+  // Count n events at the site with index id.
+  inline void
+  count_event(std::size_t id, std::uint64_t n = 1)
+  {
+    instrument_impl::add(instrument_impl::local_block().counts[id], n);
+  }
+
+  // A scoped timer adds the time from its construction to its destruction
+  // to the timer site with index id, and counts one timed scope. If it is
+  // given the name of the site, the scope is also recorded as a span of the
+  // trace while tracing (see instrument.trace).
+  class scoped_timer
+  {
+  public:
+    explicit scoped_timer(std::size_t id, const char* name = nullptr)
+      : id(id), traced(name && tracing() ? name : nullptr)
+    {
+      if (traced)
+        trace_impl::record(trace_phase::begin, traced, 0);
+      start = instrument_impl::read_clock();
+    }
+
+    ~scoped_timer()
+    {
+      std::uint64_t stop = instrument_impl::read_clock();
+      instrument_impl::thread_block& b = instrument_impl::local_block();
+      instrument_impl::add(b.counts[id], 1);
+      instrument_impl::add(b.ticks[id], stop - start);
+      if (traced)
+        trace_impl::record(trace_phase::end, traced, 0);
+    }
+
+    scoped_timer(const scoped_timer&) = delete;
+    scoped_timer& operator=(const scoped_timer&) = delete;
+
+  private:
+    std::size_t   id;
+    const char*   traced;
+    std::uint64_t start;
+  };
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Summaries                                              instrument.summary
+  //
+  // A summary holds the totals of each registered site over every thread,
+  // sorted by name. The count of a counter is its number of events, and the
+  // count of a timer is its number of timed scopes, whose total time is
+  // given in the ticks of the timer clock.
+  //
+  // A summary is written as text, for people, or in the Prometheus text
+  // exposition format, to be scraped into a metrics system (or written to
+  // the directory of a node exporter's textfile collector):
+  //
+  //    # TYPE origin_instrument_events_total counter
+  //    origin_instrument_events_total{site="graph.pool.insert"} 1000
+  //    # TYPE origin_instrument_scopes_total counter
+  //    origin_instrument_scopes_total{site="matrix.product"} 10
+  //    # TYPE origin_instrument_ticks_total counter
+  //    origin_instrument_ticks_total{site="matrix.product",unit="ns"} 123456
+  //
+  // If the environment variable ORIGIN_INSTRUMENT_OUTPUT names a file, the
+  // summary is written to it in the Prometheus format when the program
+  // exits, provided that some site was registered.
+  struct instrument_record
+  {
+    std::string     name;
+    instrument_kind kind;
+    std::uint64_t   count;
+    std::uint64_t   ticks;
+  };
+
+  // Returns the totals of the registered sites.
+  std::vector<instrument_record> instrument_summary();
+
+  // Reset the totals of every site to 0. The events counted by other threads
+  // while the totals are reset may be lost.
+  void reset_instruments();
+
+  enum class instrument_format { text, prometheus };
+
+  // Write the summary of the registered sites in the format f.
+  void write_instrument_summary(std::ostream& os,
+                                instrument_format f = instrument_format::text);
+
+} // namespace origin
+
+
+#define ORIGIN_INSTRUMENT_CAT_(a, b) a##b
+#define ORIGIN_INSTRUMENT_CAT(a, b) ORIGIN_INSTRUMENT_CAT_(a, b)
+
+#if defined(ORIGIN_INSTRUMENT)
+#  define ORIGIN_COUNT_N(name, n)                                            \
+     do {                                                                    \
+       static const std::size_t origin_site_ =                               \
+         ::origin::instrument_impl::register_site(                           \
+           name, ::origin::instrument_kind::counter);                        \
+       ::origin::count_event(origin_site_, n);                               \
+     } while (false)
+
+#  define ORIGIN_TIME_SCOPE(name)                                            \
+     static const std::size_t ORIGIN_INSTRUMENT_CAT(origin_site_, __LINE__) = \
+       ::origin::instrument_impl::register_site(                             \
+         name, ::origin::instrument_kind::timer);                            \
+     ::origin::scoped_timer ORIGIN_INSTRUMENT_CAT(origin_timer_, __LINE__)(  \
+       ORIGIN_INSTRUMENT_CAT(origin_site_, __LINE__), name)
+#else
+#  define ORIGIN_COUNT_N(name, n) ((void)0)
+#  define ORIGIN_TIME_SCOPE(name) ((void)0)
+#endif
+
+#define ORIGIN_COUNT(name) ORIGIN_COUNT_N(name, 1)
+
+#endif
@@ -0,0 +1,137 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <origin/instrument/instrument.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the record of the named site, or an empty record.
+instrument_record
+find_record(const string& name)
+{
+  for (const instrument_record& r : instrument_summary())
+    if (r.name == name)
+      return r;
+  return {name, instrument_kind::counter, 0, 0};
+}
+
+void
+count_twice()
+{
+  ORIGIN_COUNT("test.hook");
+  ORIGIN_COUNT_N("test.hook", 1);
+}
+
+// The hooks count only when enabled, and their sites are shared by name.
+void
+check_hooks()
+{
+  count_twice();
+  {
+    ORIGIN_TIME_SCOPE("test.scope");
+  }
+  uint64_t n = instrument_enabled ? 2 : 0;
+  assert(find_record("test.hook").count == n);
+  assert(find_record("test.scope").count == n / 2);
+}
+
+// The events of each thread are counted while it runs, and after it exits.
+void
+check_threads()
+{
+  size_t id = instrument_impl::register_site("test.threads",
+                                             instrument_kind::counter);
+  assert(id == instrument_impl::register_site("test.threads",
+                                              instrument_kind::counter));
+  vector<thread> ts;
+  for (int i = 0; i != 4; ++i)
+    ts.emplace_back([id]() {
+      for (int j = 0; j != 1000; ++j)
+        count_event(id);
+    });
+  for (thread& t : ts)
+    t.join();
+  count_event(id, 5);
+  assert(find_record("test.threads").count == 4005);
+
+  reset_instruments();
+  assert(find_record("test.threads").count == 0);
+  count_event(id);
+  assert(find_record("test.threads").count == 1);
+
+  try {
+    instrument_impl::register_site("test.threads", instrument_kind::timer);
+    assert(false);
+  } catch (logic_error&) { }
+}
+
+// Timers accumulate ticks, and the summary is written in both formats.
+void
+check_summary()
+{
+  size_t id = instrument_impl::register_site("test.timer",
+                                             instrument_kind::timer);
+  {
+    scoped_timer t(id);
+    this_thread::sleep_for(chrono::milliseconds(2));
+  }
+  instrument_record r = find_record("test.timer");
+  assert(r.kind == instrument_kind::timer && r.count == 1);
+  if (get_instrument_clock() == instrument_clock::steady)
+    assert(r.ticks >= 2000000);
+
+  ostringstream text;
+  write_instrument_summary(text);
+  assert(text.str().find("test.timer") != string::npos);
+
+  ostringstream prom;
+  write_instrument_summary(prom, instrument_format::prometheus);
+  string s = prom.str();
+  assert(s.find("# TYPE origin_instrument_events_total counter") !=
+         string::npos);
+  assert(s.find("origin_instrument_events_total{site=\"test.threads\"} 1\n")
+         != string::npos);
+  assert(s.find("origin_instrument_scopes_total{site=\"test.timer\"} 1\n")
+         != string::npos);
+  assert(s.find("origin_instrument_ticks_total{site=\"test.timer\",unit=")
+         != string::npos);
+}
+
+// The steady clock is always available, and the others may be.
+void
+check_clocks()
+{
+  assert(set_instrument_clock(instrument_clock::steady));
+  if (set_instrument_clock(instrument_clock::tsc)) {
+    uint64_t a = instrument_impl::read_clock();
+    uint64_t b = instrument_impl::read_clock();
+    assert(a <= b);
+  }
+  if (set_instrument_clock(instrument_clock::perf_cycles))
+    assert(instrument_impl::read_clock() != 0);
+  set_instrument_clock(instrument_clock::steady);
+
+  ostringstream ss;
+  ss << instrument_clock::tsc << ' ' << clock_unit(instrument_clock::steady);
+  assert(ss.str() == "tsc ns");
+}
+
+int main()
+{
+  check_hooks();
+  check_threads();
+  check_summary();
+  check_clocks();
+}
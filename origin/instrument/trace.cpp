@@ -0,0 +1,283 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+#include "trace.hpp"
+
+namespace origin
+{
+  namespace trace_impl
+  {
+    std::atomic<bool> active {false};
+  } // namespace trace_impl
+
+  namespace
+  {
+    // The buffer of a thread. Its events are written only by its thread,
+    // which publishes them by storing the size, and read by threads taking
+    // a snapshot. The buffer is reset, and reallocated if the capacity has
+    // changed, by its thread when it records the first event of a trace.
+    struct buffer
+    {
+      std::uint64_t                  id;
+      std::string                    name;
+      std::uint64_t                  generation;  // The trace of the events
+      bool                           exited;
+      std::unique_ptr<trace_event[]> events;
+      std::size_t                    capacity;
+      std::atomic<std::size_t>       size;
+    };
+
+    // The registry owns the buffers. The generation is advanced by each new
+    // trace, so that a thread finds out that its buffer is stale by loading
+    // it, without taking the lock.
+    struct registry
+    {
+      std::mutex                           lock;
+      std::vector<std::unique_ptr<buffer>> buffers;
+      std::size_t                          capacity = default_trace_capacity;
+      std::uint64_t                        next_id = 1;
+      std::atomic<std::uint64_t>           start {0};
+      std::atomic<std::uint64_t>           generation {1};
+      std::atomic<std::uint64_t>           dropped {0};
+    };
+
+    // The registry is never destroyed, since threads may record events, or
+    // exit, while static objects are destroyed.
+    registry&
+    the_registry()
+    {
+      static registry* r = new registry;
+      return *r;
+    }
+
+    // The buffer and name of a thread. When the thread exits, its buffer is
+    // kept until the next trace starts.
+    struct thread_state
+    {
+      ~thread_state()
+      {
+        if (!b)
+          return;
+        registry& r = the_registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        b->exited = true;
+      }
+
+      buffer*     b = nullptr;
+      std::string name;
+    };
+
+    thread_state&
+    local_state()
+    {
+      static thread_local thread_state s;
+      return s;
+    }
+
+    std::uint64_t
+    now()
+    {
+      using namespace std::chrono;
+      return duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Returns the buffer of the thread with the state s for the current
+    // trace, creating or resetting it.
+    buffer*
+    acquire(thread_state& s)
+    {
+      registry& r = the_registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      buffer* b = s.b;
+      if (!b) {
+        r.buffers.emplace_back(new buffer());
+        b = r.buffers.back().get();
+        b->id = r.next_id++;
+        b->exited = false;
+        b->capacity = 0;
+        s.b = b;
+      }
+      if (b->capacity != r.capacity) {
+        b->events.reset(new trace_event[r.capacity]);
+        b->capacity = r.capacity;
+      }
+      b->name = s.name;
+      b->size.store(0, std::memory_order_relaxed);
+      b->generation = r.generation.load(std::memory_order_relaxed);
+      return b;
+    }
+
+    // Discard the events of the registry r, whose lock is held. The buffers
+    // of running threads are left to be reset by their threads.
+    void
+    discard(registry& r)
+    {
+      r.generation.fetch_add(1, std::memory_order_relaxed);
+      r.dropped.store(0, std::memory_order_relaxed);
+      r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+                                     [](const std::unique_ptr<buffer>& b) {
+                                       return b->exited;
+                                     }),
+                      r.buffers.end());
+    }
+
+    // Write s as a JSON string.
+    void
+    write_string(std::ostream& os, const char* s)
+    {
+      static const char digits[] = "0123456789abcdef";
+      os << '"';
+      for (; *s; ++s) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (c < 0x20)
+          os << "\\u00" << digits[c >> 4] << digits[c & 15];
+        else
+          os << c;
+      }
+      os << '"';
+    }
+
+    // Write the time t, in nanoseconds, as microseconds.
+    void
+    write_time(std::ostream& os, std::uint64_t t)
+    {
+      std::uint64_t f = t % 1000;
+      os << t / 1000 << '.' << char('0' + f / 100)
+         << char('0' + f / 10 % 10) << char('0' + f % 10);
+    }
+  } // namespace
+
+
+  namespace trace_impl
+  {
+    void
+    record(trace_phase p, const char* name, std::uint64_t arg)
+    {
+      registry& r = the_registry();
+      thread_state& s = local_state();
+      buffer* b = s.b;
+      if (!b || b->generation != r.generation.load(std::memory_order_relaxed))
+        b = acquire(s);
+      std::size_t n = b->size.load(std::memory_order_relaxed);
+      if (n == b->capacity) {
+        r.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      b->events[n] = trace_event {now(), name, arg, p};
+      b->size.store(n + 1, std::memory_order_release);
+    }
+  } // namespace trace_impl
+
+
+  void
+  start_trace(std::size_t capacity)
+  {
+    registry& r = the_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    discard(r);
+    r.capacity = std::max<std::size_t>(capacity, 1);
+    r.start.store(now(), std::memory_order_relaxed);
+    trace_impl::active.store(true, std::memory_order_release);
+  }
+
+  void
+  stop_trace()
+  {
+    trace_impl::active.store(false, std::memory_order_release);
+  }
+
+  void
+  clear_trace()
+  {
+    registry& r = the_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    discard(r);
+    r.start.store(now(), std::memory_order_relaxed);
+  }
+
+  std::uint64_t
+  trace_dropped()
+  {
+    return the_registry().dropped.load(std::memory_order_relaxed);
+  }
+
+  void
+  set_trace_thread_name(const std::string& name)
+  {
+    thread_state& s = local_state();
+    s.name = name;
+    if (s.b) {
+      registry& r = the_registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      s.b->name = name;
+    }
+  }
+
+  std::vector<trace_thread>
+  trace_snapshot()
+  {
+    registry& r = the_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    std::uint64_t g = r.generation.load(std::memory_order_relaxed);
+    std::uint64_t start = r.start.load(std::memory_order_relaxed);
+    std::vector<trace_thread> ts;
+    for (const std::unique_ptr<buffer>& b : r.buffers) {
+      if (b->generation != g)
+        continue;
+      std::size_t n = b->size.load(std::memory_order_acquire);
+      trace_thread t {b->id, b->name, {b->events.get(), b->events.get() + n}};
+      for (trace_event& e : t.events)
+        e.time = e.time > start ? e.time - start : 0;
+      ts.push_back(std::move(t));
+    }
+    return ts;
+  }
+
+  // Spans are written as pairs of begin and end events, rather than as
+  // complete events, so that a span whose end was dropped is still shown.
+  void
+  write_trace(std::ostream& os)
+  {
+    std::vector<trace_thread> ts = trace_snapshot();
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const trace_thread& t : ts) {
+      if (!t.name.empty()) {
+        os << (first ? "\n" : ",\n")
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << t.id << ",\"args\":{\"name\":";
+        write_string(os, t.name.c_str());
+        os << "}}";
+        first = false;
+      }
+      for (const trace_event& e : t.events) {
+        os << (first ? "\n" : ",\n") << "{\"name\":";
+        write_string(os, e.name);
+        os << ",\"ph\":\"" << char(e.phase) << "\",\"ts\":";
+        write_time(os, e.time);
+        os << ",\"pid\":1,\"tid\":" << t.id;
+        if (e.phase == trace_phase::instant)
+          os << ",\"s\":\"t\"";
+        if (e.phase != trace_phase::end)
+          os << ",\"args\":{\"arg\":" << e.arg << '}';
+        os << '}';
+        first = false;
+      }
+    }
+    os << "\n]}\n";
+  }
+
+} // namespace origin
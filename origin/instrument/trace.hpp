@@ -0,0 +1,172 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_INSTRUMENT_TRACE_HPP
+#define ORIGIN_INSTRUMENT_TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Timeline Tracing                                         instrument.trace
+  //
+  // A trace records when events happen on each thread, rather than how many
+  // times they happen (see instrument). It is written in the Chrome trace
+  // event format, which is read by Perfetto (ui.perfetto.dev) and by
+  // chrome://tracing, and shows the work of each thread on a timeline:
+  //
+  //    start_trace();
+  //    run();
+  //    stop_trace();
+  //    std::ofstream f("run.json");
+  //    write_trace(f);
+  //
+  // While tracing, events are recorded by:
+  //
+  //    task_scheduler          "task" around each task run by a thread,
+  //                            "steal" when a task is stolen from the deque
+  //                            of another worker (whose index is its
+  //                            argument), and "idle" while a worker sleeps
+  //    ORIGIN_TIME_SCOPE       The scope, under the name of its site, when
+  //                            ORIGIN_INSTRUMENT is defined
+  //    trace_scope             A scope of the program
+  //
+  // Tracing is enabled at run time. When it is not, each hook costs a
+  // relaxed load of a flag. When it is, an event is a read of the steady
+  // clock and a store to a buffer of the calling thread, with no locked
+  // instruction. The buffer of a thread is allocated by its first event,
+  // and holds a fixed number of events; once it is full, the later events
+  // of the thread are dropped (and counted by trace_dropped()), so that the
+  // trace holds the beginning of the run rather than a mix of the two. The
+  // buffers of threads that exit are kept until the next trace starts.
+  //
+  // The names of events must be string literals, or otherwise outlive the
+  // trace; only their addresses are recorded.
+  enum class trace_phase : char
+  {
+    begin = 'B',   // The beginning of a span
+    end = 'E',     // The end of the last span begun on the thread
+    instant = 'i'  // An instant
+  };
+
+  struct trace_event
+  {
+    std::uint64_t time;   // Nanoseconds since the start of the trace
+    const char*   name;
+    std::uint64_t arg;
+    trace_phase   phase;
+  };
+
+  // The events recorded by one thread, in order.
+  struct trace_thread
+  {
+    std::uint64_t            id;
+    std::string              name;
+    std::vector<trace_event> events;
+  };
+
+  // The default number of events per thread (2 MB of buffer).
+  constexpr std::size_t default_trace_capacity = std::size_t(1) << 16;
+
+  namespace trace_impl
+  {
+    extern std::atomic<bool> active;
+
+    // Record an event on the calling thread.
+    void record(trace_phase p, const char* name, std::uint64_t arg);
+  } // namespace trace_impl
+
+  // Returns true if events are being recorded.
+  inline bool
+  tracing()
+  {
+    return trace_impl::active.load(std::memory_order_relaxed);
+  }
+
+  // Start a new trace, in which each thread records at most capacity
+  // events. The events of the previous trace are discarded.
+  void start_trace(std::size_t capacity = default_trace_capacity);
+
+  // Stop recording events. The events of the trace are kept until the next
+  // one starts or clear_trace() is called.
+  void stop_trace();
+
+  // Discard the recorded events.
+  void clear_trace();
+
+  // Returns the number of events dropped from the trace because the buffer
+  // of their thread was full.
+  std::uint64_t trace_dropped();
+
+  // Name the calling thread in the traces that follow.
+  void set_trace_thread_name(const std::string& name);
+
+  // Returns the events of the trace, by thread. Threads that are recording
+  // events may have recorded more by the time this returns.
+  std::vector<trace_thread> trace_snapshot();
+
+  // Write the trace in the Chrome trace event format (JSON).
+  void write_trace(std::ostream& os);
+
+
+  // Record the beginning of a span, the end of the last span begun on the
+  // thread, or an instant.
+  inline void
+  trace_begin(const char* name, std::uint64_t arg = 0)
+  {
+    if (tracing())
+      trace_impl::record(trace_phase::begin, name, arg);
+  }
+
+  inline void
+  trace_end(const char* name)
+  {
+    if (tracing())
+      trace_impl::record(trace_phase::end, name, 0);
+  }
+
+  inline void
+  trace_instant(const char* name, std::uint64_t arg = 0)
+  {
+    if (tracing())
+      trace_impl::record(trace_phase::instant, name, arg);
+  }
+
+  // A trace scope records a span from its construction to its destruction.
+  // A span begun while tracing is ended even if tracing stops meanwhile.
+  class trace_scope
+  {
+  public:
+    explicit trace_scope(const char* name, std::uint64_t arg = 0)
+      : name(tracing() ? name : nullptr)
+    {
+      if (this->name)
+        trace_impl::record(trace_phase::begin, name, arg);
+    }
+
+    ~trace_scope()
+    {
+      if (name)
+        trace_impl::record(trace_phase::end, name, 0);
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+  private:
+    const char* name;
+  };
+
+} // namespace origin
+
+#endif
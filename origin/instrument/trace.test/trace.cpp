@@ -0,0 +1,141 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <origin/instrument/instrument.hpp>
+#include <origin/instrument/trace.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the events of the calling thread's buffer, the only one written
+// by the current test unless it starts threads.
+vector<trace_event>
+events(const vector<trace_thread>& ts, const string& name)
+{
+  for (const trace_thread& t : ts)
+    if (t.name == name)
+      return t.events;
+  return {};
+}
+
+void
+timed()
+{
+  ORIGIN_TIME_SCOPE("test.trace.timed");
+}
+
+// Events are recorded only while tracing, in order, and spans balance.
+void
+check_events()
+{
+  set_trace_thread_name("main");
+  trace_instant("before");
+  assert(!tracing() && trace_snapshot().empty());
+
+  start_trace();
+  assert(tracing());
+  {
+    trace_scope s("outer", 7);
+    trace_instant("mark", 42);
+    timed();
+  }
+  stop_trace();
+  trace_instant("after");
+  trace_scope late("late");
+
+  vector<trace_event> es = events(trace_snapshot(), "main");
+  size_t n = instrument_enabled ? 5 : 3;
+  assert(es.size() == n);
+  assert(strcmp(es[0].name, "outer") == 0);
+  assert(es[0].phase == trace_phase::begin && es[0].arg == 7);
+  assert(es[1].phase == trace_phase::instant && es[1].arg == 42);
+  if (instrument_enabled) {
+    assert(strcmp(es[2].name, "test.trace.timed") == 0);
+    assert(es[2].phase == trace_phase::begin);
+    assert(es[3].phase == trace_phase::end);
+  }
+  assert(es[n - 1].phase == trace_phase::end);
+  for (size_t i = 1; i != n; ++i)
+    assert(es[i - 1].time <= es[i].time);
+
+  clear_trace();
+  assert(trace_snapshot().empty());
+}
+
+// Each thread records into its own buffer, which is kept after the thread
+// exits, and full buffers drop their later events.
+void
+check_threads()
+{
+  start_trace(100);
+  vector<thread> ts;
+  for (int i = 0; i != 4; ++i)
+    ts.emplace_back([i]() {
+      set_trace_thread_name("thread " + to_string(i));
+      for (int j = 0; j != 60; ++j)
+        trace_scope s("work", j);
+    });
+  for (thread& t : ts)
+    t.join();
+  stop_trace();
+
+  vector<trace_thread> tr = trace_snapshot();
+  assert(tr.size() == 4);
+  for (int i = 0; i != 4; ++i) {
+    vector<trace_event> es = events(tr, "thread " + to_string(i));
+    assert(es.size() == 100);
+    for (size_t j = 0; j != es.size(); ++j)
+      assert(es[j].phase == (j % 2 ? trace_phase::end : trace_phase::begin));
+  }
+  assert(trace_dropped() == 4 * 20);
+
+  // A new trace discards the buffers of exited threads.
+  start_trace();
+  trace_instant("again");
+  stop_trace();
+  tr = trace_snapshot();
+  assert(tr.size() == 1 && tr[0].name == "main" && tr[0].events.size() == 1);
+  assert(trace_dropped() == 0);
+}
+
+// The trace is written as Chrome trace event JSON.
+void
+check_write()
+{
+  start_trace();
+  trace_begin("a \"quoted\"\\name", 3);
+  trace_end("a \"quoted\"\\name");
+  trace_instant("tab\t", 5);
+  stop_trace();
+
+  ostringstream ss;
+  write_trace(ss);
+  string s = ss.str();
+  assert(s.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0);
+  assert(s.find("\"ph\":\"M\"") != string::npos);
+  assert(s.find("\"args\":{\"name\":\"main\"}") != string::npos);
+  assert(s.find("\"name\":\"a \\\"quoted\\\"\\\\name\",\"ph\":\"B\"")
+         != string::npos);
+  assert(s.find("\"ph\":\"E\"") != string::npos);
+  assert(s.find("\"name\":\"tab\\u0009\",\"ph\":\"i\"") != string::npos);
+  assert(s.find("\"s\":\"t\",\"args\":{\"arg\":5}") != string::npos);
+  assert(s.rfind("]}\n") == s.size() - 3);
+}
+
+int main()
+{
+  check_events();
+  check_threads();
+  check_write();
+}
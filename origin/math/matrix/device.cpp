@@ -0,0 +1,410 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <thread>
+
+#include "device.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                          Staged Transfers
+
+  constexpr std::size_t matrix_device::staging_size;
+
+  matrix_device::~matrix_device()
+  {
+    assert(!staging_[0] && !staging_[1]);
+  }
+
+  // The staging buffers are allocated on first use, so that a device that
+  // is never used for transfers does not pin memory.
+  void
+  matrix_device::reserve_staging()
+  {
+    for (void*& p : staging_)
+      if (!p)
+        p = allocate_staging(staging_size);
+  }
+
+  // The chunks alternate between the two staging buffers. Before a buffer
+  // is refilled, the transfer that last read it must complete, which is
+  // the event recorded after it. The events persist between uploads, so
+  // that a second upload does not overwrite a buffer still being read.
+  void
+  matrix_device::upload(void* dst, const void* src, std::size_t n)
+  {
+    std::lock_guard<std::mutex> lock(staging_mutex_);
+    reserve_staging();
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    for (std::size_t i = 0, off = 0; off < n; ++i, off += staging_size) {
+      std::size_t b = i % 2;
+      std::size_t len = std::min(staging_size, n - off);
+      wait(staging_events_[b]);
+      std::memcpy(staging_[b], s + off, len);
+      copy_to_device(d + off, staging_[b], len);
+      staging_events_[b] = record();
+    }
+  }
+
+  // The transfer of each chunk is queued before the host copies the
+  // previous one out of the other buffer.
+  void
+  matrix_device::download(void* dst, const void* src, std::size_t n)
+  {
+    std::lock_guard<std::mutex> lock(staging_mutex_);
+    reserve_staging();
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    std::size_t prev = 0;
+    for (std::size_t i = 0, off = 0; off < n; ++i, off += staging_size) {
+      std::size_t b = i % 2;
+      std::size_t len = std::min(staging_size, n - off);
+      wait(staging_events_[b]);
+      copy_to_host(staging_[b], s + off, len);
+      staging_events_[b] = record();
+      if (i != 0) {
+        std::size_t p = 1 - b;
+        wait(staging_events_[p]);
+        std::memcpy(d + prev, staging_[p], staging_size);
+      }
+      prev = off;
+    }
+    if (n != 0) {
+      std::size_t last = (n - 1) / staging_size;
+      std::size_t b = last % 2;
+      wait(staging_events_[b]);
+      std::memcpy(d + prev, staging_[b], n - prev);
+    }
+  }
+
+
+  void
+  matrix_device::release_staging()
+  {
+    for (void*& p : staging_)
+      if (p) {
+        deallocate_staging(p, staging_size);
+        p = nullptr;
+      }
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Host Device
+  //
+  // The stream is a worker thread that runs the queued operations in order.
+  // Each operation has a sequence number, starting at 1, and an event is
+  // the number of the last operation queued before it. The event 0 is
+  // always complete.
+
+  struct host_device::stream
+  {
+    stream()
+      : queued(0), done(0), stop(false), worker([this] { run(); })
+    { }
+
+    ~stream()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      ready.notify_one();
+      worker.join();
+    }
+
+    void run()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        ready.wait(lock, [this] { return stop || !ops.empty(); });
+        if (ops.empty())
+          return;
+        std::function<void()> f = std::move(ops.front());
+        ops.pop_front();
+        lock.unlock();
+        f();
+        lock.lock();
+        ++done;
+        finished.notify_all();
+      }
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable finished;
+    std::deque<std::function<void()>> ops;
+    std::size_t queued;
+    std::size_t done;
+    bool stop;
+    std::thread worker;
+  };
+
+  host_device::host_device()
+    : stream_(new stream())
+  { }
+
+  // The stream is drained and stopped before the staging buffers are freed.
+  host_device::~host_device()
+  {
+    synchronize();
+    stream_.reset();
+    release_staging();
+  }
+
+  void
+  host_device::enqueue(std::function<void()> f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(stream_->mutex);
+      stream_->ops.push_back(std::move(f));
+      ++stream_->queued;
+    }
+    stream_->ready.notify_one();
+  }
+
+  std::size_t
+  host_device::queued() const
+  {
+    std::lock_guard<std::mutex> lock(stream_->mutex);
+    return stream_->queued;
+  }
+
+  void*
+  host_device::allocate(std::size_t n)
+  {
+    return ::operator new(n);
+  }
+
+  void
+  host_device::deallocate(void* p, std::size_t)
+  {
+    ::operator delete(p);
+  }
+
+  // Host memory needs no pinning to be read by the host device.
+  void*
+  host_device::allocate_staging(std::size_t n)
+  {
+    return ::operator new(n);
+  }
+
+  void
+  host_device::deallocate_staging(void* p, std::size_t)
+  {
+    ::operator delete(p);
+  }
+
+  void
+  host_device::copy_to_device(void* dst, const void* src, std::size_t n)
+  {
+    enqueue([=] { std::memcpy(dst, src, n); });
+  }
+
+  void
+  host_device::copy_to_host(void* dst, const void* src, std::size_t n)
+  {
+    enqueue([=] { std::memcpy(dst, src, n); });
+  }
+
+  void
+  host_device::copy_on_device(void* dst, const void* src, std::size_t n)
+  {
+    enqueue([=] { std::memmove(dst, src, n); });
+  }
+
+  void
+  host_device::fill_zero(void* p, std::size_t n)
+  {
+    enqueue([=] { std::memset(p, 0, n); });
+  }
+
+  std::size_t
+  host_device::record()
+  {
+    std::lock_guard<std::mutex> lock(stream_->mutex);
+    return stream_->queued;
+  }
+
+  void
+  host_device::wait(std::size_t e)
+  {
+    std::unique_lock<std::mutex> lock(stream_->mutex);
+    stream_->finished.wait(lock, [&] { return stream_->done >= e; });
+  }
+
+  void
+  host_device::synchronize()
+  {
+    wait(record());
+  }
+
+
+  namespace
+  {
+    template <typename T>
+      void
+      host_gemm(std::size_t m, std::size_t n, std::size_t k,
+                const T* a, std::size_t lda,
+                const T* b, std::size_t ldb,
+                T* c, std::size_t ldc)
+      {
+        matrix_impl::dispatch_gemm(m, n, k, a, lda, b, ldb, c, ldc);
+      }
+
+    template <typename T>
+      void
+      host_hadamard(std::size_t n, const T* a, const T* b, T* c)
+      {
+        for (std::size_t i = 0; i != n; ++i)
+          c[i] = a[i] * b[i];
+      }
+
+    template <typename T>
+      void
+      host_spmv(std::size_t m, const std::size_t* off, const std::size_t* col,
+                const T* val, const T* x, T* y)
+      {
+        for (std::size_t i = 0; i != m; ++i) {
+          T sum = T(0);
+          for (std::size_t k = off[i]; k != off[i + 1]; ++k)
+            sum += val[k] * x[col[k]];
+          y[i] = sum;
+        }
+      }
+  } // namespace
+
+  void
+  host_device::gemm(std::size_t m, std::size_t n, std::size_t k,
+                    const float* a, std::size_t lda,
+                    const float* b, std::size_t ldb,
+                    float* c, std::size_t ldc)
+  {
+    enqueue([=] { host_gemm(m, n, k, a, lda, b, ldb, c, ldc); });
+  }
+
+  void
+  host_device::gemm(std::size_t m, std::size_t n, std::size_t k,
+                    const double* a, std::size_t lda,
+                    const double* b, std::size_t ldb,
+                    double* c, std::size_t ldc)
+  {
+    enqueue([=] { host_gemm(m, n, k, a, lda, b, ldb, c, ldc); });
+  }
+
+  void
+  host_device::hadamard(std::size_t n, const float* a, const float* b,
+                        float* c)
+  {
+    enqueue([=] { host_hadamard(n, a, b, c); });
+  }
+
+  void
+  host_device::hadamard(std::size_t n, const double* a, const double* b,
+                        double* c)
+  {
+    enqueue([=] { host_hadamard(n, a, b, c); });
+  }
+
+  void
+  host_device::axpy(std::size_t n, float a, const float* x, float* y)
+  {
+    enqueue([=] { matrix_impl::axpy_n(a, x, y, n); });
+  }
+
+  void
+  host_device::axpy(std::size_t n, double a, const double* x, double* y)
+  {
+    enqueue([=] { matrix_impl::axpy_n(a, x, y, n); });
+  }
+
+  // The result is written by the stream, which the host then waits for.
+  float
+  host_device::dot(std::size_t n, const float* x, const float* y)
+  {
+    float r = 0;
+    float* p = &r;
+    enqueue([=] { *p = matrix_impl::dot_n(x, y, n); });
+    synchronize();
+    return r;
+  }
+
+  double
+  host_device::dot(std::size_t n, const double* x, const double* y)
+  {
+    double r = 0;
+    double* p = &r;
+    enqueue([=] { *p = matrix_impl::dot_n(x, y, n); });
+    synchronize();
+    return r;
+  }
+
+  void
+  host_device::gemv(std::size_t m, std::size_t n,
+                    const float* a, std::size_t lda,
+                    const float* x, float* y)
+  {
+    enqueue([=] { matrix_impl::gemv(m, n, a, lda, 1, x, 1, y, 1); });
+  }
+
+  void
+  host_device::gemv(std::size_t m, std::size_t n,
+                    const double* a, std::size_t lda,
+                    const double* x, double* y)
+  {
+    enqueue([=] { matrix_impl::gemv(m, n, a, lda, 1, x, 1, y, 1); });
+  }
+
+  void
+  host_device::spmv(std::size_t m, const std::size_t* offsets,
+                    const std::size_t* indices, const float* values,
+                    const float* x, float* y)
+  {
+    enqueue([=] { host_spmv(m, offsets, indices, values, x, y); });
+  }
+
+  void
+  host_device::spmv(std::size_t m, const std::size_t* offsets,
+                    const std::size_t* indices, const double* values,
+                    const double* x, double* y)
+  {
+    enqueue([=] { host_spmv(m, offsets, indices, values, x, y); });
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Default Device
+
+  namespace
+  {
+    std::atomic<matrix_device*> selected_device {nullptr};
+  } // namespace
+
+  matrix_device&
+  default_matrix_device()
+  {
+    static host_device host;
+    matrix_device* d = selected_device.load(std::memory_order_acquire);
+    return d ? *d : host;
+  }
+
+  void
+  set_default_matrix_device(matrix_device* d)
+  {
+    selected_device.store(d, std::memory_order_release);
+  }
+
+} // namespace origin
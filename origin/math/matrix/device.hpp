@@ -0,0 +1,605 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_DEVICE_HPP
+#define ORIGIN_MATH_MATRIX_DEVICE_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <origin/math/matrix/sparse.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Device matrices                                               [device.decl]
+  //
+  // A matrix device is an accelerator with its own memory, such as a GPU,
+  // that runs matrix kernels. A device_matrix holds its elements in the
+  // memory of a device, and the matrix operations applied to device
+  // matrices run on that device:
+  //
+  //    device_matrix<double, 2> a(x), b(y);   // Upload the host matrices
+  //    device_matrix<double, 2> c(n, n);      // Zeros, on the device
+  //    matrix_product(a, b, c);               // Runs on the device
+  //    matrix<double, 2> z = c.to_host();     // Download the result
+  //
+  // The device operations have the names and semantics of the host
+  // operations: matrix_product, hadamard_product, axpy, dot and gemv, and
+  // spmv for a device_csr_matrix. Code written against the host operations
+  // runs on a device by changing the types of its operands.
+  //
+  // A device executes its operations in order, asynchronously with the host,
+  // as a CUDA or HIP stream does: an operation returns when it is queued,
+  // and the host waits for the queued operations by synchronize(). The
+  // operations that return values to the host (dot, and downloads) wait for
+  // the queue. A program that uses several threads must give each its own
+  // device.
+  //
+  // Transfers between the host and the device go through staging buffers
+  // of pinned (page-locked) host memory, which the device can read and
+  // write directly. An upload copies the elements into one staging buffer
+  // while the device transfers the previous one, so that the host copy and
+  // the transfer overlap (double buffering), and returns when the last
+  // chunk is queued. The host matrix may be modified as soon as upload
+  // returns. A download overlaps the transfer of each chunk with the host
+  // copy of the previous one.
+  //
+  // A backend implements the matrix_device interface for one kind of device.
+  // Each operation of the interface maps to a stream operation: allocate to
+  // cudaMalloc, allocate_staging to cudaMallocHost, copy_to_device to
+  // cudaMemcpyAsync, record and wait to cudaEventRecord and
+  // cudaEventSynchronize, and gemm and gemv to cuBLAS. The host_device
+  // backend, which is always available, runs the kernels of the host on a
+  // worker thread that plays the role of the stream, with device memory
+  // allocated from the host. It is the default device, and the reference
+  // for other backends. A program selects another backend with
+  // set_default_matrix_device, or by constructing device matrices with it.
+
+
+  // The interface of a device backend. The memory operations refer to
+  // bytes, and the kernels to elements of float or double, with row-major
+  // matrices of the given leading dimensions. Operations other than
+  // allocation and dot are queued.
+  class matrix_device
+  {
+  public:
+    matrix_device() = default;
+    matrix_device(const matrix_device&) = delete;
+    matrix_device& operator=(const matrix_device&) = delete;
+
+    virtual ~matrix_device();
+
+    // Returns the name of the backend.
+    virtual const char* name() const = 0;
+
+    // Device memory
+    virtual void* allocate(std::size_t n) = 0;
+    virtual void deallocate(void* p, std::size_t n) = 0;
+
+    // Pinned host memory
+    virtual void* allocate_staging(std::size_t n) = 0;
+    virtual void deallocate_staging(void* p, std::size_t n) = 0;
+
+    // Transfers. The source must not be modified until the transfer
+    // completes.
+    virtual void copy_to_device(void* dst, const void* src, std::size_t n) = 0;
+    virtual void copy_to_host(void* dst, const void* src, std::size_t n) = 0;
+    virtual void copy_on_device(void* dst, const void* src, std::size_t n) = 0;
+    virtual void fill_zero(void* p, std::size_t n) = 0;
+
+    // Synchronization
+    //
+    // record() returns an event that completes when the operations queued
+    // before it complete, and wait(e) blocks until e completes.
+    // synchronize() waits for every queued operation.
+    virtual std::size_t record() = 0;
+    virtual void wait(std::size_t e) = 0;
+    virtual void synchronize() = 0;
+
+    // Kernels
+    //
+    // gemm: c += a * b, where a is m x k, b is k x n, and c is m x n.
+    // hadamard: c[i] = a[i] * b[i].
+    // axpy: y[i] += a * x[i].
+    // dot: returns the sum of x[i] * y[i], waiting for the queue.
+    // gemv: y += a * x, where a is m x n.
+    // spmv: y = a * x, where a is an m-row CSR matrix.
+    virtual void gemm(std::size_t m, std::size_t n, std::size_t k,
+                      const float* a, std::size_t lda,
+                      const float* b, std::size_t ldb,
+                      float* c, std::size_t ldc) = 0;
+    virtual void gemm(std::size_t m, std::size_t n, std::size_t k,
+                      const double* a, std::size_t lda,
+                      const double* b, std::size_t ldb,
+                      double* c, std::size_t ldc) = 0;
+
+    virtual void hadamard(std::size_t n, const float* a, const float* b,
+                          float* c) = 0;
+    virtual void hadamard(std::size_t n, const double* a, const double* b,
+                          double* c) = 0;
+
+    virtual void axpy(std::size_t n, float a, const float* x, float* y) = 0;
+    virtual void axpy(std::size_t n, double a, const double* x,
+                      double* y) = 0;
+
+    virtual float dot(std::size_t n, const float* x, const float* y) = 0;
+    virtual double dot(std::size_t n, const double* x, const double* y) = 0;
+
+    virtual void gemv(std::size_t m, std::size_t n,
+                      const float* a, std::size_t lda,
+                      const float* x, float* y) = 0;
+    virtual void gemv(std::size_t m, std::size_t n,
+                      const double* a, std::size_t lda,
+                      const double* x, double* y) = 0;
+
+    virtual void spmv(std::size_t m, const std::size_t* offsets,
+                      const std::size_t* indices, const float* values,
+                      const float* x, float* y) = 0;
+    virtual void spmv(std::size_t m, const std::size_t* offsets,
+                      const std::size_t* indices, const double* values,
+                      const double* x, double* y) = 0;
+
+
+    // Staged transfers
+    //
+    // Upload or download n bytes between the host memory src and the device
+    // memory dst, through the staging buffers of the device.
+    void upload(void* dst, const void* src, std::size_t n);
+    void download(void* dst, const void* src, std::size_t n);
+
+    // The size of a staging buffer.
+    static constexpr std::size_t staging_size = std::size_t(4) << 20;
+
+  protected:
+    // Free the staging buffers. The destructor of a backend calls this
+    // after its queue is drained, while deallocate_staging can be called.
+    void release_staging();
+
+  private:
+    // Allocate the staging buffers, if they have not been.
+    void reserve_staging();
+
+  private:
+    std::mutex staging_mutex_;
+    void* staging_[2] = {nullptr, nullptr};
+    std::size_t staging_events_[2] = {0, 0};
+  };
+
+
+  // The host backend. The kernels run on a worker thread, in the order in
+  // which they are queued, and use the threads of matrix_product.
+  class host_device : public matrix_device
+  {
+  public:
+    host_device();
+    ~host_device();
+
+    const char* name() const override { return "host"; }
+
+    void* allocate(std::size_t n) override;
+    void deallocate(void* p, std::size_t n) override;
+    void* allocate_staging(std::size_t n) override;
+    void deallocate_staging(void* p, std::size_t n) override;
+
+    void copy_to_device(void* dst, const void* src, std::size_t n) override;
+    void copy_to_host(void* dst, const void* src, std::size_t n) override;
+    void copy_on_device(void* dst, const void* src, std::size_t n) override;
+    void fill_zero(void* p, std::size_t n) override;
+
+    std::size_t record() override;
+    void wait(std::size_t e) override;
+    void synchronize() override;
+
+    void gemm(std::size_t m, std::size_t n, std::size_t k,
+              const float* a, std::size_t lda,
+              const float* b, std::size_t ldb,
+              float* c, std::size_t ldc) override;
+    void gemm(std::size_t m, std::size_t n, std::size_t k,
+              const double* a, std::size_t lda,
+              const double* b, std::size_t ldb,
+              double* c, std::size_t ldc) override;
+
+    void hadamard(std::size_t n, const float* a, const float* b,
+                  float* c) override;
+    void hadamard(std::size_t n, const double* a, const double* b,
+                  double* c) override;
+
+    void axpy(std::size_t n, float a, const float* x, float* y) override;
+    void axpy(std::size_t n, double a, const double* x, double* y) override;
+
+    float dot(std::size_t n, const float* x, const float* y) override;
+    double dot(std::size_t n, const double* x, const double* y) override;
+
+    void gemv(std::size_t m, std::size_t n,
+              const float* a, std::size_t lda,
+              const float* x, float* y) override;
+    void gemv(std::size_t m, std::size_t n,
+              const double* a, std::size_t lda,
+              const double* x, double* y) override;
+
+    void spmv(std::size_t m, const std::size_t* offsets,
+              const std::size_t* indices, const float* values,
+              const float* x, float* y) override;
+    void spmv(std::size_t m, const std::size_t* offsets,
+              const std::size_t* indices, const double* values,
+              const double* x, double* y) override;
+
+    // Returns the number of operations that have been queued.
+    std::size_t queued() const;
+
+  private:
+    struct stream;
+
+    // Queue the operation f.
+    void enqueue(std::function<void()> f);
+
+  private:
+    std::unique_ptr<stream> stream_;
+  };
+
+
+  // Returns the default device, which is a host_device unless another has
+  // been set.
+  matrix_device& default_matrix_device();
+
+  // Set the default device to d, or to the host device if d is null. The
+  // device must outlive its use as the default.
+  void set_default_matrix_device(matrix_device* d);
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Device matrix                                               [device.matrix]
+  //
+  // A device_matrix is an N-dimensional matrix of T (float or double) whose
+  // elements are stored, densely in row-major order, in the memory of a
+  // device. It is move-only, and its elements are accessed by transfers.
+  template <typename T, std::size_t N>
+    class device_matrix
+    {
+      static_assert(Same<T, float>() || Same<T, double>(),
+                    "device matrices hold float or double");
+    public:
+      static constexpr std::size_t order = N;
+
+      using value_type = T;
+
+      // Construct an empty matrix on the default device.
+      device_matrix()
+        : dev_(&default_matrix_device()), data_(nullptr)
+      { }
+
+      // Construct a matrix of zeros with the given extents on the default
+      // device.
+      template <typename... Dims,
+                typename = Requires<All(Convertible<Dims, std::size_t>()...)>>
+        explicit device_matrix(Dims... dims)
+          : device_matrix(default_matrix_device(), dims...)
+        { }
+
+      template <typename... Dims>
+        device_matrix(matrix_device& d, Dims... dims);
+
+      // Construct a matrix with the elements of the host matrix m.
+      template <typename A>
+        explicit device_matrix(const matrix<T, N, A>& m,
+                               matrix_device& d = default_matrix_device());
+
+      device_matrix(device_matrix&& x);
+      device_matrix& operator=(device_matrix&& x);
+
+      ~device_matrix() { release(); }
+
+      // Properties
+      matrix_device& device() const { return *dev_; }
+      const matrix_slice<N>& descriptor() const { return desc_; }
+      std::size_t extent(std::size_t n) const { return desc_.extents[n]; }
+      std::size_t rows() const { return extent(0); }
+      std::size_t cols() const { return extent(1); }
+      std::size_t size() const { return desc_.size; }
+
+      // Returns the address of the elements in device memory.
+      T* data() { return data_; }
+      const T* data() const { return data_; }
+
+      // Transfers
+      //
+      // Upload the elements of m, which has the same extents, or download
+      // the elements to m, which is resized if its extents differ.
+      template <typename A>
+        void upload(const matrix<T, N, A>& m);
+
+      template <typename A>
+        void download(matrix<T, N, A>& m) const;
+
+      // Returns the elements as a host matrix.
+      matrix<T, N> to_host() const
+      {
+        matrix<T, N> m;
+        download(m);
+        return m;
+      }
+
+      // Set every element to 0.
+      void zero() { dev_->fill_zero(data_, size() * sizeof(T)); }
+
+    private:
+      void release();
+
+    private:
+      matrix_device* dev_;
+      matrix_slice<N> desc_;
+      T* data_;
+    };
+
+  template <typename T, std::size_t N>
+    template <typename... Dims>
+      device_matrix<T, N>::device_matrix(matrix_device& d, Dims... dims)
+        : dev_(&d), desc_(0, {std::size_t(dims)...}), data_(nullptr)
+      {
+        static_assert(sizeof...(Dims) == N, "");
+        if (size() != 0) {
+          data_ = static_cast<T*>(dev_->allocate(size() * sizeof(T)));
+          zero();
+        }
+      }
+
+  template <typename T, std::size_t N>
+    template <typename A>
+      device_matrix<T, N>::device_matrix(const matrix<T, N, A>& m,
+                                         matrix_device& d)
+        : dev_(&d), desc_(m.descriptor()), data_(nullptr)
+      {
+        if (size() != 0)
+          data_ = static_cast<T*>(dev_->allocate(size() * sizeof(T)));
+        upload(m);
+      }
+
+  template <typename T, std::size_t N>
+    device_matrix<T, N>::device_matrix(device_matrix&& x)
+      : dev_(x.dev_), desc_(x.desc_), data_(x.data_)
+    {
+      x.desc_ = matrix_slice<N>();
+      x.data_ = nullptr;
+    }
+
+  template <typename T, std::size_t N>
+    device_matrix<T, N>&
+    device_matrix<T, N>::operator=(device_matrix&& x)
+    {
+      if (this != &x) {
+        release();
+        dev_ = x.dev_;
+        desc_ = x.desc_;
+        data_ = x.data_;
+        x.desc_ = matrix_slice<N>();
+        x.data_ = nullptr;
+      }
+      return *this;
+    }
+
+  // The memory is freed after the queued operations that may use it.
+  template <typename T, std::size_t N>
+    void
+    device_matrix<T, N>::release()
+    {
+      if (data_) {
+        dev_->synchronize();
+        dev_->deallocate(data_, size() * sizeof(T));
+        data_ = nullptr;
+      }
+    }
+
+  template <typename T, std::size_t N>
+    template <typename A>
+      void
+      device_matrix<T, N>::upload(const matrix<T, N, A>& m)
+      {
+        assert(same_extents(desc_, m.descriptor()));
+        dev_->upload(data_, m.data(), size() * sizeof(T));
+      }
+
+  template <typename T, std::size_t N>
+    template <typename A>
+      void
+      device_matrix<T, N>::download(matrix<T, N, A>& m) const
+      {
+        if (!same_extents(desc_, m.descriptor()))
+          m = matrix<T, N, A>(uninitialized, desc_);
+        dev_->download(m.data(), data_, size() * sizeof(T));
+      }
+
+
+  namespace device_impl
+  {
+    // A device allocation of n objects of T, freed after the queued
+    // operations that may use it.
+    template <typename T>
+      class buffer
+      {
+      public:
+        buffer(matrix_device& d, std::size_t n)
+          : dev_(&d), size_(n),
+            data_(n ? static_cast<T*>(d.allocate(n * sizeof(T))) : nullptr)
+        { }
+
+        buffer(buffer&& x)
+          : dev_(x.dev_), size_(x.size_), data_(x.data_)
+        {
+          x.size_ = 0;
+          x.data_ = nullptr;
+        }
+
+        buffer& operator=(buffer&&) = delete;
+
+        ~buffer()
+        {
+          if (data_) {
+            dev_->synchronize();
+            dev_->deallocate(data_, size_ * sizeof(T));
+          }
+        }
+
+        matrix_device& device() const { return *dev_; }
+        std::size_t size() const { return size_; }
+        T* data() const { return data_; }
+
+        // Upload the elements of v, which has the size of the buffer.
+        void upload(const std::vector<T>& v)
+        {
+          assert(v.size() == size_);
+          if (size_)
+            dev_->upload(data_, v.data(), size_ * sizeof(T));
+        }
+
+      private:
+        matrix_device* dev_;
+        std::size_t size_;
+        T* data_;
+      };
+
+  } // namespace device_impl
+
+
+  // A CSR matrix in the memory of a device. It is move-only.
+  template <typename T>
+    class device_csr_matrix
+    {
+      static_assert(Same<T, float>() || Same<T, double>(),
+                    "device matrices hold float or double");
+    public:
+      using value_type = T;
+
+      explicit device_csr_matrix(const csr_matrix<T>& a,
+                                 matrix_device& d = default_matrix_device())
+        : rows_(a.rows()), cols_(a.cols()),
+          offsets_(d, a.row_offsets().size()),
+          indices_(d, a.col_indices().size()),
+          values_(d, a.values().size())
+      {
+        offsets_.upload(a.row_offsets());
+        indices_.upload(a.col_indices());
+        values_.upload(a.values());
+      }
+
+      matrix_device& device() const { return offsets_.device(); }
+      std::size_t rows() const { return rows_; }
+      std::size_t cols() const { return cols_; }
+      std::size_t nonzeros() const { return values_.size(); }
+
+      // Returns the addresses of the compressed arrays in device memory.
+      const std::size_t* offsets() const { return offsets_.data(); }
+      const std::size_t* indices() const { return indices_.data(); }
+      const T* values() const { return values_.data(); }
+
+    private:
+      std::size_t rows_;
+      std::size_t cols_;
+      device_impl::buffer<std::size_t> offsets_;
+      device_impl::buffer<std::size_t> indices_;
+      device_impl::buffer<T> values_;
+    };
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Device operations                                              [device.ops]
+  //
+  // The operands of a device operation must be on the same device.
+
+  namespace device_impl
+  {
+    template <typename M1, typename M2>
+      inline matrix_device&
+      common_device(const M1& a, const M2& b)
+      {
+        assert(&a.device() == &b.device());
+        return a.device();
+      }
+
+  } // namespace device_impl
+
+
+  // Compute out += a * b.
+  template <typename T>
+    void
+    matrix_product(const device_matrix<T, 2>& a,
+                   const device_matrix<T, 2>& b,
+                   device_matrix<T, 2>& out)
+    {
+      assert(a.cols() == b.rows());
+      assert(a.rows() == out.rows() && b.cols() == out.cols());
+      matrix_device& d = device_impl::common_device(a, b);
+      assert(&d == &out.device());
+      if (a.rows() && b.cols() && a.cols())
+        d.gemm(a.rows(), b.cols(), a.cols(), a.data(), a.cols(),
+               b.data(), b.cols(), out.data(), out.cols());
+    }
+
+  // Compute out(i...) = a(i...) * b(i...).
+  template <typename T, std::size_t N>
+    void
+    hadamard_product(const device_matrix<T, N>& a,
+                     const device_matrix<T, N>& b,
+                     device_matrix<T, N>& out)
+    {
+      assert(same_extents(a.descriptor(), b.descriptor()));
+      assert(same_extents(a.descriptor(), out.descriptor()));
+      matrix_device& d = device_impl::common_device(a, b);
+      assert(&d == &out.device());
+      d.hadamard(a.size(), a.data(), b.data(), out.data());
+    }
+
+  // Compute y += a * x.
+  template <typename T>
+    void
+    axpy(const T& a, const device_matrix<T, 1>& x, device_matrix<T, 1>& y)
+    {
+      assert(x.size() == y.size());
+      device_impl::common_device(x, y).axpy(x.size(), a, x.data(), y.data());
+    }
+
+  // Returns the dot product of x and y.
+  template <typename T>
+    T
+    dot(const device_matrix<T, 1>& x, const device_matrix<T, 1>& y)
+    {
+      assert(x.size() == y.size());
+      return device_impl::common_device(x, y).dot(x.size(), x.data(),
+                                                  y.data());
+    }
+
+  // Compute y += a * x.
+  template <typename T>
+    void
+    gemv(const device_matrix<T, 2>& a, const device_matrix<T, 1>& x,
+         device_matrix<T, 1>& y)
+    {
+      assert(a.cols() == x.size() && a.rows() == y.size());
+      matrix_device& d = device_impl::common_device(a, x);
+      assert(&d == &y.device());
+      d.gemv(a.rows(), a.cols(), a.data(), a.cols(), x.data(), y.data());
+    }
+
+  // Compute y = a * x.
+  template <typename T>
+    void
+    spmv(const device_csr_matrix<T>& a, const device_matrix<T, 1>& x,
+         device_matrix<T, 1>& y)
+    {
+      assert(a.cols() == x.size() && a.rows() == y.size());
+      matrix_device& d = device_impl::common_device(a, x);
+      assert(&d == &y.device());
+      d.spmv(a.rows(), a.offsets(), a.indices(), a.values(),
+             x.data(), y.data());
+    }
+
+} // namespace origin
+
+#endif
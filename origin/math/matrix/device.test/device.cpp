@@ -0,0 +1,127 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/device.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename T>
+  matrix<T, 2>
+  fill(size_t m, size_t n, int seed)
+  {
+    matrix<T, 2> x(m, n);
+    for (size_t i = 0; i != m; ++i)
+      for (size_t j = 0; j != n; ++j)
+        x(i, j) = T(int(i * 7 + j * 3 + seed) % 11 - 5);
+    return x;
+  }
+
+// Transfers that span several staging buffers, and one that is smaller than
+// a buffer, return the elements that were uploaded.
+void
+test_transfer()
+{
+  host_device d;
+  assert(string(d.name()) == "host");
+
+  // 3 x 700000 doubles is 16 MiB, or four staging buffers and a partial one.
+  matrix<double, 2> x = fill<double>(3, 700001, 1);
+  device_matrix<double, 2> a(x, d);
+  assert(a.rows() == 3 && a.cols() == 700001 && &a.device() == &d);
+
+  // The host matrix may be modified after the upload returns.
+  x(2, 700000) = 100;
+  matrix<double, 2> y = a.to_host();
+  assert(y(2, 700000) != 100);
+  x(2, 700000) = y(2, 700000);
+  assert(x == y);
+
+  a.upload(fill<double>(3, 700001, 2));
+  a.download(y);
+  assert(y == fill<double>(3, 700001, 2));
+
+  device_matrix<float, 1> z(d, 5);
+  matrix<float, 1> h = z.to_host();
+  assert(h.size() == 5 && h(4) == 0);
+
+  // Moving transfers ownership of the device memory.
+  device_matrix<double, 2> b = move(a);
+  assert(a.size() == 0 && b.to_host() == y);
+}
+
+void
+test_operations()
+{
+  host_device d;
+
+  matrix<double, 2> a = fill<double>(70, 50, 1);
+  matrix<double, 2> b = fill<double>(50, 40, 2);
+  matrix<double, 2> c = fill<double>(70, 40, 3);
+  device_matrix<double, 2> da(a, d), db(b, d), dc(c, d);
+  size_t before = d.queued();
+  matrix_product(da, db, dc);
+  assert(d.queued() == before + 1);
+  matrix_product(a, b, c);
+  assert(dc.to_host() == c);
+
+  device_matrix<double, 2> dh(d, 70, 40);
+  hadamard_product(dc, dc, dh);
+  matrix<double, 2> h = dh.to_host();
+  for (size_t i = 0; i != 70; ++i)
+    for (size_t j = 0; j != 40; ++j)
+      assert(h(i, j) == c(i, j) * c(i, j));
+
+  matrix<float, 1> x {1.0f, 2.0f, 3.0f, 4.0f};
+  matrix<float, 1> y {4.0f, 3.0f, 2.0f, 1.0f};
+  device_matrix<float, 1> dx(x, d), dy(y, d);
+  assert(dot(dx, dy) == 20);
+  axpy(2.0f, dx, dy);
+  assert((dy.to_host() == matrix<float, 1>{6.0f, 7.0f, 8.0f, 9.0f}));
+
+  matrix<float, 2> m {{1, 2, 3, 4}, {0, 1, 0, 1}};
+  device_matrix<float, 2> dm(m, d);
+  device_matrix<float, 1> dr(d, 2);
+  gemv(dm, dx, dr);
+  assert((dr.to_host() == matrix<float, 1>{30.0f, 6.0f}));
+
+  csr_matrix<double> s(4, 5, {0, 2, 3, 3, 5}, {0, 4, 2, 1, 3},
+                       {1, 2, 3, 4, 5});
+  device_csr_matrix<double> ds(s, d);
+  assert(ds.nonzeros() == 5);
+  matrix<double, 1> v {1.0, 1.0, 1.0, 1.0, 1.0};
+  device_matrix<double, 1> dv(v, d);
+  device_matrix<double, 1> dw(d, 4);
+  spmv(ds, dv, dw);
+  assert((dw.to_host() == matrix<double, 1>{3.0, 3.0, 0.0, 9.0}));
+}
+
+// Device matrices constructed without a device use the default device.
+void
+test_default()
+{
+  host_device d;
+  assert(string(default_matrix_device().name()) == "host");
+  set_default_matrix_device(&d);
+  {
+    device_matrix<double, 2> a(3, 3);
+    assert(&a.device() == &d);
+  }
+  set_default_matrix_device(nullptr);
+  assert(&default_matrix_device() != &d);
+}
+
+int main()
+{
+  test_transfer();
+  test_operations();
+  test_default();
+}
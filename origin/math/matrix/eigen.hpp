@@ -0,0 +1,880 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_EIGEN_HPP
+#define ORIGIN_MATH_MATRIX_EIGEN_HPP
+
+#include <random>
+
+#include <origin/math/matrix/krylov.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Symmetric eigenproblems                                        [eigen.decl]
+  //
+  // The eigensolvers compute eigenvalues and eigenvectors of real symmetric
+  // matrices and operators. The eigenvalues are returned in ascending order
+  // as a vector, and the eigenvectors as the rows of a matrix, so that the
+  // ith row of the vectors is the unit eigenvector of the ith value:
+  //
+  //    symmetric_eigen(a, w, v)  -- All eigenpairs of the dense matrix a
+  //    lanczos_solver<T>         -- Some eigenpairs of an operator, by the
+  //                                 thick-restart Lanczos method
+  //    lobpcg_solver<T>          -- Some eigenpairs of an operator, by the
+  //                                 locally optimal block preconditioned
+  //                                 conjugate gradient method
+  //
+  // The dense solver reduces a to tridiagonal form by Householder
+  // reflections, and then diagonalizes the tridiagonal matrix by the
+  // implicit QL method, in O(n^3) time. It suits small and medium matrices,
+  // and the projected problems of the iterative solvers.
+  //
+  // The iterative solvers compute the k smallest (or largest) eigenpairs of
+  // a symmetric operator from its products with vectors, so that the
+  // operator need not be stored: operators are those of the Krylov solvers
+  // (see [krylov.operator]), including sparse matrices and the Laplacians of
+  // undirected graphs. For example, the spectral embedding of a graph:
+  //
+  //    auto l = laplacian_operator<double>(g);
+  //    lanczos_solver<double> s;
+  //    matrix<double, 1> w;
+  //    matrix<double, 2> v;
+  //    s.smallest(l, 3, w, v);   // v.row(1) is the Fiedler vector
+  //
+  // Lanczos builds an orthonormal basis of m vectors (the subspace size) by
+  // extending a Krylov subspace, with full reorthogonalization, and then
+  // extracts Ritz pairs from the basis. When the wanted pairs have not
+  // converged, the basis is restarted from the best Ritz vectors (a thick
+  // restart), so that the information they carry is kept. LOBPCG iterates
+  // on a block of k vectors, minimizing the Rayleigh quotient over the span
+  // of the block, its preconditioned residuals, and its previous update. It
+  // converges in fewer products than Lanczos when a good preconditioner is
+  // available, such as the Jacobi preconditioner of a Laplacian.
+  //
+  // A solver owns its workspace (the basis, the projected matrix, and the
+  // blocks of vectors), which is allocated by its first solve of a given
+  // size and reused across restarts and by later solves. The solvers stop
+  // when the residual norm of every wanted pair, relative to the largest
+  // magnitude of the Ritz values, is at most the tolerance of their
+  // options, or when the number of operator products reaches the limit.
+
+
+  // The options of an iterative eigensolver.
+  struct eigen_options
+  {
+    eigen_options()
+      : tolerance(1e-8), max_iterations(100000), subspace(0), seed(1)
+    { }
+
+    double        tolerance;      // The relative residual at convergence
+    std::size_t   max_iterations; // The maximum number of products with A
+    std::size_t   subspace;       // The Lanczos basis size, or 0 to choose
+    std::uint64_t seed;           // The seed of the random start vectors
+  };
+
+  // The result of an iterative eigensolve.
+  struct eigen_result
+  {
+    std::size_t iterations; // The number of products with A
+    std::size_t restarts;   // The number of restarts or block iterations
+    double      residual;   // The largest relative residual of the pairs
+    bool        converged;  // True if the tolerance was reached
+  };
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Dense symmetric eigensolver                                   [eigen.dense]
+
+  namespace eigen_impl
+  {
+    // Reduce the symmetric matrix stored in v to tridiagonal form, storing
+    // its diagonal in d and its subdiagonal in e[1, n), and replace v by the
+    // orthogonal matrix of the reduction (by columns). This is the tred2
+    // procedure of the EISPACK library.
+    template <typename T>
+      void
+      tridiagonalize(matrix<T, 2>& v, T* d, T* e)
+      {
+        const std::size_t n = v.rows();
+        for (std::size_t j = 0; j != n; ++j)
+          d[j] = v(n - 1, j);
+
+        // Householder reduction, from the last row up.
+        for (std::size_t i = n - 1; i != 0; --i) {
+          T scale = 0;
+          T h = 0;
+          for (std::size_t k = 0; k != i; ++k)
+            scale += std::abs(d[k]);
+          if (scale == T(0)) {
+            e[i] = d[i - 1];
+            for (std::size_t j = 0; j != i; ++j) {
+              d[j] = v(i - 1, j);
+              v(i, j) = 0;
+              v(j, i) = 0;
+            }
+          } else {
+            // Generate the Householder vector.
+            for (std::size_t k = 0; k != i; ++k) {
+              d[k] /= scale;
+              h += d[k] * d[k];
+            }
+            T f = d[i - 1];
+            T g = std::sqrt(h);
+            if (f > 0)
+              g = -g;
+            e[i] = scale * g;
+            h -= f * g;
+            d[i - 1] = f - g;
+            for (std::size_t j = 0; j != i; ++j)
+              e[j] = 0;
+
+            // Apply the similarity transformation to the remaining columns.
+            for (std::size_t j = 0; j != i; ++j) {
+              f = d[j];
+              v(j, i) = f;
+              g = e[j] + v(j, j) * f;
+              for (std::size_t k = j + 1; k != i; ++k) {
+                g += v(k, j) * d[k];
+                e[k] += v(k, j) * f;
+              }
+              e[j] = g;
+            }
+            f = 0;
+            for (std::size_t j = 0; j != i; ++j) {
+              e[j] /= h;
+              f += e[j] * d[j];
+            }
+            T hh = f / (h + h);
+            for (std::size_t j = 0; j != i; ++j)
+              e[j] -= hh * d[j];
+            for (std::size_t j = 0; j != i; ++j) {
+              f = d[j];
+              g = e[j];
+              for (std::size_t k = j; k != i; ++k)
+                v(k, j) -= f * e[k] + g * d[k];
+              d[j] = v(i - 1, j);
+              v(i, j) = 0;
+            }
+          }
+          d[i] = h;
+        }
+
+        // Accumulate the transformations.
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+          v(n - 1, i) = v(i, i);
+          v(i, i) = 1;
+          T h = d[i + 1];
+          if (h != T(0)) {
+            for (std::size_t k = 0; k <= i; ++k)
+              d[k] = v(k, i + 1) / h;
+            for (std::size_t j = 0; j <= i; ++j) {
+              T g = 0;
+              for (std::size_t k = 0; k <= i; ++k)
+                g += v(k, i + 1) * v(k, j);
+              for (std::size_t k = 0; k <= i; ++k)
+                v(k, j) -= g * d[k];
+            }
+          }
+          for (std::size_t k = 0; k <= i; ++k)
+            v(k, i + 1) = 0;
+        }
+        for (std::size_t j = 0; j != n; ++j) {
+          d[j] = v(n - 1, j);
+          v(n - 1, j) = 0;
+        }
+        v(n - 1, n - 1) = 1;
+        e[0] = 0;
+      }
+
+    // Diagonalize the symmetric tridiagonal matrix with diagonal d and
+    // subdiagonal e[1, n), applying the rotations to the rows of z, so that
+    // if z holds the transpose of the reduction, its rows become the
+    // eigenvectors. The eigenvalues are stored in d, unordered. This is the
+    // tql2 procedure of the EISPACK library, with the rotations applied to
+    // rows, which are contiguous. Returns false if an eigenvalue does not
+    // converge in 30 iterations.
+    template <typename T>
+      bool
+      diagonalize(std::size_t n, T* d, T* e, matrix<T, 2>& z)
+      {
+        const T eps = std::numeric_limits<T>::epsilon();
+        for (std::size_t i = 1; i < n; ++i)
+          e[i - 1] = e[i];
+        e[n - 1] = 0;
+
+        T f = 0;
+        T tst1 = 0;
+        for (std::size_t l = 0; l != n; ++l) {
+          // Find a small subdiagonal element.
+          tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+          std::size_t m = l;
+          while (m != n - 1 && std::abs(e[m]) > eps * tst1)
+            ++m;
+
+          // If m == l, d[l] is an eigenvalue; otherwise, iterate.
+          for (int iter = 0; m > l; ++iter) {
+            if (iter == 30)
+              return false;
+
+            // Compute the implicit shift.
+            T g = d[l];
+            T p = (d[l + 1] - g) / (2 * e[l]);
+            T r = std::hypot(p, T(1));
+            if (p < 0)
+              r = -r;
+            d[l] = e[l] / (p + r);
+            d[l + 1] = e[l] * (p + r);
+            T dl1 = d[l + 1];
+            T h = g - d[l];
+            for (std::size_t i = l + 2; i < n; ++i)
+              d[i] -= h;
+            f += h;
+
+            // Implicit QL transformation.
+            p = d[m];
+            T c = 1, c2 = 1, c3 = 1;
+            T el1 = e[l + 1];
+            T s = 0, s2 = 0;
+            for (std::size_t i = m; i-- != l; ) {
+              c3 = c2;
+              c2 = c;
+              s2 = s;
+              g = c * e[i];
+              h = c * p;
+              r = std::hypot(p, e[i]);
+              e[i + 1] = s * r;
+              s = e[i] / r;
+              c = p / r;
+              p = c * d[i] - s * g;
+              d[i + 1] = h + s * (c * g + s * d[i]);
+
+              // Accumulate the rotation in rows i and i + 1.
+              T* zi = z.data() + i * n;
+              T* zj = zi + n;
+              for (std::size_t k = 0; k != n; ++k) {
+                T t = zj[k];
+                zj[k] = s * zi[k] + c * t;
+                zi[k] = c * zi[k] - s * t;
+              }
+            }
+            p = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+            if (std::abs(e[l]) <= eps * tst1)
+              break;
+          }
+          d[l] += f;
+          e[l] = 0;
+        }
+        return true;
+      }
+
+    // Sort the eigenvalues d in ascending order, and the rows of z with
+    // them.
+    template <typename T>
+      void
+      sort_pairs(std::size_t n, T* d, matrix<T, 2>& z)
+      {
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+          std::size_t k = i;
+          for (std::size_t j = i + 1; j != n; ++j)
+            if (d[j] < d[k])
+              k = j;
+          if (k != i) {
+            std::swap(d[i], d[k]);
+            std::swap_ranges(z.data() + i * n, z.data() + (i + 1) * n,
+                             z.data() + k * n);
+          }
+        }
+      }
+
+  } // namespace eigen_impl
+
+
+  // Compute the eigenvalues w and eigenvectors v of the n x n symmetric
+  // matrix a, whose upper triangle is not read. On return, w has n elements
+  // in ascending order, and v is n x n, with v.row(i) the unit eigenvector
+  // of w(i). Returns false if the QL iteration fails to converge, which
+  // does not happen in practice.
+  template <typename M, typename T>
+    bool
+    symmetric_eigen(const M& a, matrix<T, 1>& w, matrix<T, 2>& v)
+    {
+      static_assert(M::order == 2, "");
+      assert(a.rows() == a.cols());
+      const std::size_t n = a.rows();
+      if (w.size() != n)
+        w = matrix<T, 1>(n);
+      if (n == 0) {
+        v = matrix<T, 2>(0, 0);
+        return true;
+      }
+
+      // Reduce the lower triangle of a, mirrored, and transpose the
+      // reduction so that the rotations of the QL method apply to rows.
+      matrix<T, 2> q(n, n);
+      for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j <= i; ++j)
+          q(i, j) = q(j, i) = a(i, j);
+      matrix_impl::scratch_buffer<T> e(n);
+      eigen_impl::tridiagonalize(q, w.data(), e.data());
+      if (v.rows() != n || v.cols() != n)
+        v = matrix<T, 2>(uninitialized, n, n);
+      transpose_into(q, v);
+      bool ok = eigen_impl::diagonalize(n, w.data(), e.data(), v);
+      eigen_impl::sort_pairs(n, w.data(), v);
+      return ok;
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Iterative eigensolvers                                    [eigen.iterative]
+
+  namespace eigen_impl
+  {
+    // Resize the workspace matrix m to r x c, if it has other extents.
+    template <typename T>
+      inline void
+      reserve(matrix<T, 2>& m, std::size_t r, std::size_t c)
+      {
+        if (m.rows() != r || m.cols() != c)
+          m = matrix<T, 2>(r, c);
+      }
+
+    // Returns a pointer to the ith row of the matrix m.
+    template <typename T>
+      inline T*
+      row_of(matrix<T, 2>& m, std::size_t i)
+      {
+        return m.data() + i * m.cols();
+      }
+
+    template <typename T>
+      inline const T*
+      row_of(const matrix<T, 2>& m, std::size_t i)
+      {
+        return m.data() + i * m.cols();
+      }
+
+    // Compute y = A * x, where x and y are rows of length n, through the
+    // workspace vectors vx and vy.
+    template <typename Op, typename T>
+      inline void
+      apply(const Op& a, const T* x, T* y,
+            matrix<T, 1>& vx, matrix<T, 1>& vy)
+      {
+        std::copy_n(x, vx.size(), vx.data());
+        spmv(a, vx, vy);
+        std::copy_n(vy.data(), vy.size(), y);
+      }
+
+    // Fill the row x of length n with uniformly distributed values.
+    template <typename T>
+      void
+      randomize(T* x, std::size_t n, std::mt19937_64& gen)
+      {
+        std::uniform_real_distribution<T> dist(-1, 1);
+        for (std::size_t i = 0; i != n; ++i)
+          x[i] = dist(gen);
+      }
+
+    // Orthogonalize the row x of length n against the first k rows of b,
+    // by two passes of classical Gram-Schmidt, and return its norm. The
+    // same combination is applied to the row ax and the first k rows of ab,
+    // if ab is not null, so that if ab holds the products of A with b, ax
+    // remains the product of A with x. The coefficients are added to h, if
+    // it is not null.
+    template <typename T>
+      T
+      orthogonalize(T* x, std::size_t n,
+                    const matrix<T, 2>& b, std::size_t k,
+                    T* ax, const matrix<T, 2>* ab, T* h)
+      {
+        for (int pass = 0; pass != 2; ++pass) {
+          for (std::size_t i = 0; i != k; ++i) {
+            T c = matrix_impl::dot_n(row_of(b, i), x, n);
+            matrix_impl::axpy_n(-c, row_of(b, i), x, n);
+            if (ab)
+              matrix_impl::axpy_n(-c, row_of(*ab, i), ax, n);
+            if (h)
+              h[i] += c;
+          }
+        }
+        return std::sqrt(matrix_impl::dot_n(x, x, n));
+      }
+
+    template <typename T>
+      inline T
+      orthogonalize(T* x, std::size_t n,
+                    const matrix<T, 2>& b, std::size_t k, T* h)
+      {
+        return orthogonalize(x, n, b, k, x,
+                             static_cast<const matrix<T, 2>*>(nullptr), h);
+      }
+
+    // Scale the row x of length n (and ax, if not null) by s.
+    template <typename T>
+      inline void
+      scale(T* x, T* ax, std::size_t n, T s)
+      {
+        for (std::size_t i = 0; i != n; ++i)
+          x[i] *= s;
+        if (ax)
+          for (std::size_t i = 0; i != n; ++i)
+            ax[i] *= s;
+      }
+
+    // Returns the index of the ith wanted of the m ascending Ritz values.
+    inline std::size_t
+    wanted(std::size_t i, std::size_t m, bool largest)
+    {
+      return largest ? m - 1 - i : i;
+    }
+
+    // Returns the largest magnitude of the m ascending values w, or 1 if
+    // they are all zero, by which residuals are divided.
+    template <typename T>
+      inline T
+      spectral_scale(const T* w, std::size_t m)
+      {
+        T s = std::max(std::abs(w[0]), std::abs(w[m - 1]));
+        return s == T(0) ? T(1) : s;
+      }
+
+    // Compute out = c * b, where c is the r x m matrix c and b holds at
+    // least m rows. The output has r rows.
+    template <typename C, typename T>
+      void
+      combine(const C& c, const matrix<T, 2>& b,
+              std::size_t first, matrix<T, 2>& out)
+      {
+        std::size_t m = c.cols();
+        matrix_ref<const T, 2> rows = b(slice(first, m), slice::all);
+        matrix_ref<T, 2> o = out(slice(0, c.rows()), slice::all);
+        o = T(0);
+        matrix_product(c, rows, o);
+      }
+
+  } // namespace eigen_impl
+
+
+  // The thick-restart Lanczos method, with full reorthogonalization.
+  template <typename T>
+    class lanczos_solver
+    {
+    public:
+      lanczos_solver() = default;
+
+      // Compute the k smallest or largest eigenpairs of the symmetric
+      // operator a. On return, values has k elements, ascending for the
+      // smallest and descending for the largest, and vectors is k x n, with
+      // vectors.row(i) the unit eigenvector of values(i).
+      template <typename Op>
+        eigen_result smallest(const Op& a, std::size_t k,
+                              matrix<T, 1>& values, matrix<T, 2>& vectors,
+                              const eigen_options& opts = eigen_options())
+        {
+          return solve(a, k, values, vectors, opts, false);
+        }
+
+      template <typename Op>
+        eigen_result largest(const Op& a, std::size_t k,
+                             matrix<T, 1>& values, matrix<T, 2>& vectors,
+                             const eigen_options& opts = eigen_options())
+        {
+          return solve(a, k, values, vectors, opts, true);
+        }
+
+    private:
+      template <typename Op>
+        eigen_result solve(const Op& a, std::size_t k,
+                           matrix<T, 1>& values, matrix<T, 2>& vectors,
+                           const eigen_options& opts, bool largest);
+
+      void reserve(std::size_t n, std::size_t m);
+
+      // Extend the basis with a random unit vector orthogonal to its first
+      // j rows, storing it in row j.
+      void restart_vector(std::size_t n, std::size_t j, std::mt19937_64& gen);
+
+      matrix<T, 2> basis;   // The basis, V, and the residual in row m
+      matrix<T, 2> h;       // The projected matrix, V' * A * V
+      matrix<T, 1> theta;   // The Ritz values
+      matrix<T, 2> y;       // The Ritz vectors of h, by rows
+      matrix<T, 2> ritz;    // The Ritz vectors of A, by rows
+      std::vector<T> coef;  // The orthogonalization coefficients
+      matrix<T, 1> vx, vy;  // The operands of the operator
+    };
+
+  template <typename T>
+    void
+    lanczos_solver<T>::reserve(std::size_t n, std::size_t m)
+    {
+      eigen_impl::reserve(basis, m + 1, n);
+      eigen_impl::reserve(h, m, m);
+      eigen_impl::reserve(ritz, m, n);
+      krylov_impl::reserve(vx, n);
+      krylov_impl::reserve(vy, n);
+      coef.resize(m);
+    }
+
+  template <typename T>
+    void
+    lanczos_solver<T>::restart_vector(std::size_t n, std::size_t j,
+                                      std::mt19937_64& gen)
+    {
+      using namespace eigen_impl;
+      T* v = row_of(basis, j);
+      T norm = 0;
+      while (norm <= T(0.5)) {
+        randomize(v, n, gen);
+        T before = std::sqrt(matrix_impl::dot_n(v, v, n));
+        norm = orthogonalize(v, n, basis, j, (T*)nullptr) / before;
+      }
+      scale(v, (T*)nullptr, n, T(1) / std::sqrt(matrix_impl::dot_n(v, v, n)));
+    }
+
+  template <typename T>
+    template <typename Op>
+      eigen_result
+      lanczos_solver<T>::solve(const Op& a, std::size_t k,
+                               matrix<T, 1>& values, matrix<T, 2>& vectors,
+                               const eigen_options& opts, bool largest)
+      {
+        using namespace eigen_impl;
+        assert(a.rows() == a.cols());
+        const std::size_t n = a.rows();
+        assert(k <= n);
+        if (values.size() != k)
+          values = matrix<T, 1>(k);
+        if (vectors.rows() != k || vectors.cols() != n)
+          vectors = matrix<T, 2>(k, n);
+        if (k == 0)
+          return {0, 0, 0, true};
+
+        std::size_t m = opts.subspace ? opts.subspace
+                                      : std::max(2 * k + 1, k + 20);
+        m = std::min(std::max(m, k + 1), n);
+        reserve(n, m);
+        std::mt19937_64 gen(opts.seed);
+        restart_vector(n, 0, gen);
+
+        const T eps = std::numeric_limits<T>::epsilon();
+        std::size_t products = 0;
+        std::size_t restarts = 0;
+        std::size_t first = 0;  // The number of kept Ritz vectors
+        T res = 0;
+        h = T(0);
+        while (true) {
+          // Extend the basis to m vectors. The projections of each product
+          // onto the basis form a column of h.
+          T beta = 0;
+          for (std::size_t j = first; j != m; ++j) {
+            T* w = row_of(basis, j + 1);
+            apply(a, row_of(basis, j), w, vx, vy);
+            ++products;
+            std::fill(coef.begin(), coef.begin() + j + 1, T(0));
+            T before = std::sqrt(matrix_impl::dot_n(w, w, n));
+            beta = orthogonalize(w, n, basis, j + 1, coef.data());
+            for (std::size_t i = 0; i <= j; ++i)
+              h(i, j) = h(j, i) = coef[i];
+
+            // If the product lies in the span of the basis, the subspace is
+            // invariant; continue from a random vector.
+            if (beta <= eps * before || beta == T(0)) {
+              beta = 0;
+              if (j + 1 != m)
+                restart_vector(n, j + 1, gen);
+              else
+                std::fill_n(w, n, T(0));
+            } else {
+              scale(w, (T*)nullptr, n, T(1) / beta);
+            }
+          }
+
+          // Extract the Ritz pairs. The residual norm of the ith pair is
+          // beta times the last element of its vector.
+          symmetric_eigen(h, theta, y);
+          T spread = spectral_scale(theta.data(), m);
+          res = 0;
+          for (std::size_t i = 0; i != k; ++i) {
+            std::size_t r = wanted(i, m, largest);
+            res = std::max(res, std::abs(beta * y(r, m - 1)) / spread);
+          }
+          bool done = res <= opts.tolerance
+                   || products >= opts.max_iterations
+                   || m == n;
+
+          // Keep the k wanted Ritz vectors, or on a restart, those and half
+          // of the remaining ones.
+          std::size_t p = done ? k : std::min(m - 1, k + (m - k) / 2);
+          for (std::size_t i = 0; i != p; ++i) {
+            std::size_t r = wanted(i, m, largest);
+            std::copy_n(row_of(y, r), m, row_of(h, i));
+          }
+          combine(h(slice(0, p), slice::all), basis, 0, ritz);
+          if (done) {
+            for (std::size_t i = 0; i != k; ++i)
+              values(i) = theta(wanted(i, m, largest));
+            std::copy_n(ritz.data(), k * n, vectors.data());
+            return {products, restarts, double(res), res <= opts.tolerance};
+          }
+
+          // Restart from the kept Ritz vectors and the residual, which is
+          // orthogonal to them.
+          for (std::size_t i = 0; i != p; ++i)
+            std::copy_n(row_of(ritz, i), n, row_of(basis, i));
+          std::copy_n(row_of(basis, m), n, row_of(basis, p));
+          if (beta == T(0))
+            restart_vector(n, p, gen);
+          h = T(0);
+          for (std::size_t i = 0; i != p; ++i)
+            h(i, i) = theta(wanted(i, m, largest));
+          first = p;
+          ++restarts;
+        }
+      }
+
+
+  // The locally optimal block preconditioned conjugate gradient method.
+  template <typename T>
+    class lobpcg_solver
+    {
+    public:
+      lobpcg_solver() = default;
+
+      // Compute the k smallest or largest eigenpairs of the symmetric
+      // operator a, using the symmetric positive definite preconditioner
+      // p, as for lanczos_solver. If vectors is k x n on entry, its rows
+      // are the initial approximations of the eigenvectors, which must be
+      // linearly independent; otherwise, random vectors are used.
+      template <typename Op, typename P>
+        eigen_result smallest(const Op& a, std::size_t k,
+                              matrix<T, 1>& values, matrix<T, 2>& vectors,
+                              const P& p,
+                              const eigen_options& opts = eigen_options())
+        {
+          return solve(a, k, values, vectors, p, opts, false);
+        }
+
+      template <typename Op>
+        eigen_result smallest(const Op& a, std::size_t k,
+                              matrix<T, 1>& values, matrix<T, 2>& vectors,
+                              const eigen_options& opts = eigen_options())
+        {
+          return solve(a, k, values, vectors, identity_preconditioner{},
+                       opts, false);
+        }
+
+      template <typename Op, typename P>
+        eigen_result largest(const Op& a, std::size_t k,
+                             matrix<T, 1>& values, matrix<T, 2>& vectors,
+                             const P& p,
+                             const eigen_options& opts = eigen_options())
+        {
+          return solve(a, k, values, vectors, p, opts, true);
+        }
+
+      template <typename Op>
+        eigen_result largest(const Op& a, std::size_t k,
+                             matrix<T, 1>& values, matrix<T, 2>& vectors,
+                             const eigen_options& opts = eigen_options())
+        {
+          return solve(a, k, values, vectors, identity_preconditioner{},
+                       opts, true);
+        }
+
+    private:
+      template <typename Op, typename P>
+        eigen_result solve(const Op& a, std::size_t k,
+                           matrix<T, 1>& values, matrix<T, 2>& vectors,
+                           const P& p, const eigen_options& opts,
+                           bool largest);
+
+      void reserve(std::size_t n, std::size_t k);
+
+      // Orthonormalize rows [first, s) of the basis against the preceding
+      // rows, dropping those that are nearly dependent on them, and return
+      // the number of remaining rows.
+      std::size_t orthonormalize(std::size_t first, std::size_t s);
+
+      // Compute the Rayleigh-Ritz projection onto the first s rows of the
+      // basis, replace its first k rows by the wanted Ritz vectors, and
+      // update the directions if s > k. Returns the spectral scale.
+      T rayleigh_ritz(std::size_t s, std::size_t k, bool largest);
+
+      matrix<T, 2> basis;     // The search space [X; W; P], by rows
+      matrix<T, 2> images;    // The products of A with the basis
+      matrix<T, 2> dirs;      // The directions P and their products AP
+      matrix<T, 2> next;      // The updated block
+      matrix<T, 2> h;         // The projected matrix
+      matrix<T, 1> theta;     // The Ritz values
+      matrix<T, 2> y;         // The Ritz vectors of h, by rows
+      matrix<T, 2> c;         // The coefficients of the wanted Ritz vectors
+      matrix<T, 1> vx, vy;    // The operands of the operator
+      bool has_dirs = false;
+    };
+
+  template <typename T>
+    void
+    lobpcg_solver<T>::reserve(std::size_t n, std::size_t k)
+    {
+      eigen_impl::reserve(basis, 3 * k, n);
+      eigen_impl::reserve(images, 3 * k, n);
+      eigen_impl::reserve(dirs, 2 * k, n);
+      eigen_impl::reserve(next, k, n);
+      krylov_impl::reserve(vx, n);
+      krylov_impl::reserve(vy, n);
+    }
+
+  template <typename T>
+    std::size_t
+    lobpcg_solver<T>::orthonormalize(std::size_t first, std::size_t s)
+    {
+      using namespace eigen_impl;
+      const std::size_t n = basis.cols();
+      const T drop = std::sqrt(std::numeric_limits<T>::epsilon());
+      std::size_t r = first;
+      for (std::size_t i = first; i != s; ++i) {
+        T* x = row_of(basis, i);
+        T* ax = row_of(images, i);
+        T before = std::sqrt(matrix_impl::dot_n(x, x, n));
+        if (before == T(0))
+          continue;
+        T norm = orthogonalize(x, n, basis, r, ax, &images, (T*)nullptr);
+        if (norm <= drop * before)
+          continue;
+        scale(x, ax, n, T(1) / norm);
+        if (r != i) {
+          std::copy_n(x, n, row_of(basis, r));
+          std::copy_n(ax, n, row_of(images, r));
+        }
+        ++r;
+      }
+      return r;
+    }
+
+  template <typename T>
+    T
+    lobpcg_solver<T>::rayleigh_ritz(std::size_t s, std::size_t k,
+                                    bool largest)
+    {
+      using namespace eigen_impl;
+      const std::size_t n = basis.cols();
+      eigen_impl::reserve(h, s, s);
+      for (std::size_t i = 0; i != s; ++i)
+        for (std::size_t j = 0; j <= i; ++j) {
+          T x = matrix_impl::dot_n(row_of(basis, i), row_of(images, j), n);
+          T z = matrix_impl::dot_n(row_of(basis, j), row_of(images, i), n);
+          h(i, j) = h(j, i) = (x + z) / 2;
+        }
+      symmetric_eigen(h, theta, y);
+      eigen_impl::reserve(c, k, s);
+      for (std::size_t i = 0; i != k; ++i)
+        std::copy_n(row_of(y, wanted(i, s, largest)), s, row_of(c, i));
+
+      // The directions are the parts of the update outside the block.
+      if (s > k) {
+        combine(c(slice::all, slice(k, s - k)), basis, k, next);
+        std::copy_n(next.data(), k * n, dirs.data());
+        combine(c(slice::all, slice(k, s - k)), images, k, next);
+        std::copy_n(next.data(), k * n, row_of(dirs, k));
+        has_dirs = true;
+      }
+      combine(c, basis, 0, next);
+      std::copy_n(next.data(), k * n, basis.data());
+      combine(c, images, 0, next);
+      std::copy_n(next.data(), k * n, images.data());
+      return spectral_scale(theta.data(), s);
+    }
+
+  template <typename T>
+    template <typename Op, typename P>
+      eigen_result
+      lobpcg_solver<T>::solve(const Op& a, std::size_t k,
+                              matrix<T, 1>& values, matrix<T, 2>& vectors,
+                              const P& p, const eigen_options& opts,
+                              bool largest)
+      {
+        using namespace eigen_impl;
+        assert(a.rows() == a.cols());
+        const std::size_t n = a.rows();
+        assert(3 * k <= n);
+        if (values.size() != k)
+          values = matrix<T, 1>(k);
+        bool guess = vectors.rows() == k && vectors.cols() == n;
+        if (!guess)
+          vectors = matrix<T, 2>(k, n);
+        if (k == 0)
+          return {0, 0, 0, true};
+        reserve(n, k);
+        has_dirs = false;
+
+        // Orthonormalize the initial block and project onto it.
+        std::mt19937_64 gen(opts.seed);
+        if (guess)
+          std::copy_n(vectors.data(), k * n, basis.data());
+        else
+          for (std::size_t i = 0; i != k; ++i)
+            randomize(row_of(basis, i), n, gen);
+        std::size_t s = orthonormalize(0, k);
+        while (s != k) {
+          randomize(row_of(basis, s), n, gen);
+          s = orthonormalize(s, s + 1);
+        }
+        std::size_t products = 0;
+        for (std::size_t i = 0; i != k; ++i)
+          apply(a, row_of(basis, i), row_of(images, i), vx, vy);
+        products += k;
+        T spread = rayleigh_ritz(k, k, largest);
+
+        std::size_t iters = 0;
+        T res = 0;
+        while (true) {
+          // Compute the residuals of the block and precondition them.
+          res = 0;
+          s = k;
+          for (std::size_t i = 0; i != k; ++i) {
+            T t = theta(wanted(i, theta.size(), largest));
+            const T* x = row_of(basis, i);
+            const T* ax = row_of(images, i);
+            for (std::size_t j = 0; j != n; ++j)
+              vx(j) = ax[j] - t * x[j];
+            res = std::max(res, nrm2(vx) / spread);
+            p.apply(vx, vy);
+            std::copy_n(vy.data(), n, row_of(basis, s++));
+          }
+          if (res <= opts.tolerance || products >= opts.max_iterations)
+            break;
+
+          // Extend the block by the residuals and the directions, and
+          // minimize over their span.
+          for (std::size_t i = k; i != 2 * k; ++i)
+            apply(a, row_of(basis, i), row_of(images, i), vx, vy);
+          products += k;
+          if (has_dirs) {
+            std::copy_n(dirs.data(), k * n, row_of(basis, s));
+            std::copy_n(row_of(dirs, k), k * n, row_of(images, s));
+            s += k;
+          }
+          s = orthonormalize(k, s);
+          spread = rayleigh_ritz(s, k, largest);
+          ++iters;
+        }
+
+        for (std::size_t i = 0; i != k; ++i)
+          values(i) = theta(wanted(i, theta.size(), largest));
+        std::copy_n(basis.data(), k * n, vectors.data());
+        return {products, iters, double(res), res <= opts.tolerance};
+      }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,212 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/eigen.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Vec = matrix<double, 1>;
+using Mat = matrix<double, 2>;
+
+const double pi = 3.14159265358979323846;
+
+// Returns a symmetric n x n matrix with pseudo-random elements.
+Mat
+random_symmetric(size_t n, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Mat a(n, n);
+  for (size_t i = 0; i != n; ++i)
+    for (size_t j = 0; j <= i; ++j)
+      a(i, j) = a(j, i) = dist(gen);
+  return a;
+}
+
+// Returns the largest of |A * v_i - w_i * v_i| over the rows of v.
+template <typename Op>
+  double
+  max_residual(const Op& a, const Vec& w, const Mat& v)
+  {
+    size_t n = v.cols();
+    double r = 0;
+    Vec x(n), y(n);
+    for (size_t i = 0; i != v.rows(); ++i) {
+      for (size_t j = 0; j != n; ++j)
+        x(j) = v(i, j);
+      spmv(a, x, y);
+      for (size_t j = 0; j != n; ++j)
+        y(j) -= w(i) * x(j);
+      r = max(r, nrm2(y));
+    }
+    return r;
+  }
+
+// Returns the largest deviation of v * v' from the identity.
+double
+orthonormality(const Mat& v)
+{
+  size_t n = v.cols();
+  double e = 0;
+  for (size_t i = 0; i != v.rows(); ++i)
+    for (size_t j = 0; j != v.rows(); ++j) {
+      double d = 0;
+      for (size_t k = 0; k != n; ++k)
+        d += v(i, k) * v(j, k);
+      e = max(e, abs(d - (i == j ? 1.0 : 0.0)));
+    }
+  return e;
+}
+
+// Returns the path graph of n vertices, whose Laplacian has the eigenvalues
+// 2 - 2 cos(pi * j / n).
+undirected_adjacency_vector<>
+path(size_t n)
+{
+  undirected_adjacency_vector<> g;
+  for (size_t i = 0; i != n; ++i)
+    g.add_vertex();
+  for (size_t i = 0; i + 1 < n; ++i)
+    g.add_edge(vertex_handle(i), vertex_handle(i + 1));
+  return g;
+}
+
+double
+path_eigenvalue(size_t n, size_t j)
+{
+  return 2 - 2 * cos(pi * double(j) / double(n));
+}
+
+void
+test_dense()
+{
+  for (size_t n : {1, 2, 5, 40, 97}) {
+    Mat a = random_symmetric(n, unsigned(n));
+    Vec w;
+    Mat v;
+    assert(symmetric_eigen(a, w, v));
+    assert(w.size() == n);
+    assert(v.rows() == n && v.cols() == n);
+    for (size_t i = 0; i + 1 < n; ++i)
+      assert(w(i) <= w(i + 1));
+    assert(max_residual(a, w, v) < 1e-10 * n);
+    assert(orthonormality(v) < 1e-12 * n);
+  }
+
+  // A diagonal matrix with repeated values.
+  Mat d(4, 4);
+  d(0, 0) = 3;
+  d(1, 1) = 1;
+  d(2, 2) = 3;
+  d(3, 3) = -2;
+  Vec w;
+  Mat v;
+  assert(symmetric_eigen(d, w, v));
+  assert(w(0) == -2 && w(1) == 1 && w(2) == 3 && w(3) == 3);
+  assert(max_residual(d, w, v) < 1e-14);
+}
+
+void
+test_lanczos()
+{
+  // The smallest eigenvalues of a path Laplacian are clustered, which
+  // requires restarts.
+  const size_t n = 400;
+  auto g = path(n);
+  auto l = laplacian_operator<double>(g);
+
+  lanczos_solver<double> s;
+  Vec w;
+  Mat v;
+  eigen_options opts;
+  opts.tolerance = 1e-10;
+  eigen_result r = s.smallest(l, 4, w, v, opts);
+  assert(r.converged);
+  assert(r.restarts > 0);
+  for (size_t j = 0; j != 4; ++j)
+    assert(abs(w(j) - path_eigenvalue(n, j)) < 1e-8);
+  assert(max_residual(l, w, v) < 1e-8);
+  assert(orthonormality(v) < 1e-10);
+
+  // The largest eigenvalues of a dense matrix agree with the dense solver.
+  Mat a = random_symmetric(150, 7);
+  Vec wd;
+  Mat vd;
+  symmetric_eigen(a, wd, vd);
+  Vec wl;
+  Mat vl;
+  r = s.largest(a, 3, wl, vl, opts);
+  assert(r.converged);
+  for (size_t j = 0; j != 3; ++j)
+    assert(abs(wl(j) - wd(149 - j)) < 1e-8);
+  assert(max_residual(a, wl, vl) < 1e-7);
+
+  // A basis as large as the matrix computes the pairs exactly.
+  opts.subspace = 150;
+  r = s.smallest(a, 2, wl, vl, opts);
+  assert(r.converged && r.restarts == 0);
+  assert(abs(wl(0) - wd(0)) < 1e-9);
+
+  // The number of products is limited.
+  opts.subspace = 0;
+  opts.max_iterations = 30;
+  r = s.smallest(l, 4, w, v, opts);
+  assert(!r.converged);
+  assert(r.iterations <= 30 + 20);
+}
+
+void
+test_lobpcg()
+{
+  const size_t n = 300;
+  auto g = path(n);
+  auto l = laplacian_operator<double>(g);
+
+  lobpcg_solver<double> s;
+  Vec w;
+  Mat v;
+  eigen_options opts;
+  opts.tolerance = 1e-8;
+  jacobi_preconditioner<double> jacobi(l);
+  eigen_result r = s.smallest(l, 3, w, v, jacobi, opts);
+  assert(r.converged);
+  for (size_t j = 0; j != 3; ++j)
+    assert(abs(w(j) - path_eigenvalue(n, j)) < 1e-8);
+  assert(max_residual(l, w, v) < 1e-6);
+  assert(orthonormality(v) < 1e-10);
+
+  // Starting from the solution converges in a few iterations.
+  size_t cold = r.iterations;
+  r = s.smallest(l, 3, w, v, jacobi, opts);
+  assert(r.converged);
+  assert(r.iterations < cold / 10);
+
+  // The largest eigenvalues of a dense matrix.
+  Mat a = random_symmetric(60, 3);
+  Vec wd;
+  Mat vd;
+  symmetric_eigen(a, wd, vd);
+  Vec wl;
+  Mat vl;
+  r = s.largest(a, 2, wl, vl, opts);
+  assert(r.converged);
+  assert(abs(wl(0) - wd(59)) < 1e-8);
+  assert(abs(wl(1) - wd(58)) < 1e-8);
+}
+
+int main()
+{
+  test_dense();
+  test_lanczos();
+  test_lobpcg();
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_GENERATORS_HPP
+#define ORIGIN_MATH_MATRIX_GENERATORS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include <origin/math/matrix/matrix.hpp>
+#include <origin/sequence/random.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Random Matrices                                           [matrix.random]
+  //
+  // The random matrix generators return matrices of floating point values
+  // for tests and benchmarks:
+  //
+  //    random_matrix<T>(m, n, seed[, lo, hi])
+  //      An m x n matrix of values uniformly distributed in [lo, hi), by
+  //      default [-1, 1).
+  //
+  //    random_banded_matrix<T>(n, p, q, seed[, lo, hi])
+  //      An n x n matrix whose elements on the diagonal, the p diagonals
+  //      below it and the q diagonals above it are uniformly distributed in
+  //      [lo, hi). The other elements are 0.
+  //
+  //    random_spd_matrix<T>(n, seed[, p])
+  //      A symmetric positive definite n x n matrix with p diagonals on each
+  //      side of the diagonal (by default, all of them). The elements off
+  //      the diagonal are uniformly distributed in [-1, 1), and each element
+  //      of the diagonal is 1 more than the sum of the magnitudes of the
+  //      other elements of its row. A symmetric matrix that is strictly
+  //      diagonally dominant with a positive diagonal is positive definite.
+  //
+  // The elements of row i are drawn in order from the ith stream of a
+  // splitmix64 engine seeded with seed (see [random.splitmix]), so the rows
+  // are generated in parallel, using the threads of matrix_product (see
+  // product_threads()), and the matrix is the same for any number of
+  // threads. Each row is written by the thread that generates it, which
+  // places its pages near that thread on NUMA machines.
+
+  namespace matrix_impl
+  {
+    // The least number of elements for which a matrix is generated in
+    // parallel.
+    constexpr std::size_t parallel_generate = 1 << 16;
+
+    // Returns a number uniformly distributed in [lo, hi) computed from the
+    // upper 53 bits of the random number x.
+    template <typename T>
+      inline T
+      uniform_value(std::uint64_t x, T lo, T hi)
+      {
+        return lo + (hi - lo) * T((x >> 11) * (1.0 / 9007199254740992.0));
+      }
+
+    // Call f(i, g) for each row i of an m x n matrix, where g is the ith
+    // stream of a splitmix64 engine seeded with seed.
+    template <typename F>
+      void
+      generate_rows(std::size_t m, std::size_t n, std::uint64_t seed, F f)
+      {
+        splitmix64 streams(seed);
+        std::size_t threads = m * n < parallel_generate ? 1 : product_threads();
+        parallel_for(m, threads, [&](std::size_t i) {
+          splitmix64 g = streams.stream(i);
+          f(i, g);
+        });
+      }
+
+  } // namespace matrix_impl
+
+
+  template <typename T = double>
+    matrix<T, 2>
+    random_matrix(std::size_t m, std::size_t n, std::uint64_t seed,
+                  T lo = T(-1), T hi = T(1))
+    {
+      static_assert(std::is_floating_point<T>::value, "");
+      matrix<T, 2> a(uninitialized, m, n);
+      T* p = a.data();
+      matrix_impl::generate_rows(m, n, seed, [=](std::size_t i,
+                                                 splitmix64& g) {
+        T* row = p + i * n;
+        for (std::size_t j = 0; j != n; ++j)
+          row[j] = matrix_impl::uniform_value(g(), lo, hi);
+      });
+      return a;
+    }
+
+  template <typename T = double>
+    matrix<T, 2>
+    random_banded_matrix(std::size_t n, std::size_t p, std::size_t q,
+                         std::uint64_t seed, T lo = T(-1), T hi = T(1))
+    {
+      static_assert(std::is_floating_point<T>::value, "");
+      matrix<T, 2> a(uninitialized, n, n);
+      T* s = a.data();
+      matrix_impl::generate_rows(n, n, seed, [=](std::size_t i,
+                                                 splitmix64& g) {
+        T* row = s + i * n;
+        std::size_t first = i < p ? 0 : i - p;
+        std::size_t last = std::min(n, i + q + 1);
+        std::fill(row, row + first, T(0));
+        for (std::size_t j = first; j != last; ++j)
+          row[j] = matrix_impl::uniform_value(g(), lo, hi);
+        std::fill(row + last, row + n, T(0));
+      });
+      return a;
+    }
+
+  // The elements below the diagonal are generated first, row by row, and
+  // then copied above the diagonal, so that the matrix is symmetric.
+  template <typename T = double>
+    matrix<T, 2>
+    random_spd_matrix(std::size_t n, std::uint64_t seed,
+                      std::size_t p = std::size_t(-1))
+    {
+      static_assert(std::is_floating_point<T>::value, "");
+      p = std::min(p, n ? n - 1 : 0);
+      matrix<T, 2> a(uninitialized, n, n);
+      T* s = a.data();
+      matrix_impl::generate_rows(n, n, seed, [=](std::size_t i,
+                                                 splitmix64& g) {
+        T* row = s + i * n;
+        std::size_t first = i - std::min(i, p);
+        std::fill(row, row + first, T(0));
+        for (std::size_t j = first; j != i; ++j)
+          row[j] = matrix_impl::uniform_value(g(), T(-1), T(1));
+      });
+      std::size_t threads = n * n < matrix_impl::parallel_generate
+                          ? 1 : product_threads();
+      matrix_impl::parallel_for(n, threads, [=](std::size_t i) {
+        T* row = s + i * n;
+        std::size_t last = std::min(n, i + p + 1);
+        for (std::size_t j = i + 1; j != last; ++j)
+          row[j] = s[j * n + i];
+        std::fill(row + last, row + n, T(0));
+        T sum = 1;
+        for (std::size_t j = i - std::min(i, p); j != last; ++j)
+          if (j != i)
+            sum += std::abs(row[j]);
+        row[i] = sum;
+      });
+      return a;
+    }
+
+} // namespace origin
+
+#endif
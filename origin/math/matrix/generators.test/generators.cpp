@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/generators.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+
+// Returns true if the Cholesky factorization of the symmetric matrix a
+// succeeds, which is the case when a is positive definite.
+bool
+cholesky(Mat a)
+{
+  size_t n = a.rows();
+  for (size_t j = 0; j != n; ++j) {
+    double d = a(j, j);
+    for (size_t k = 0; k != j; ++k)
+      d -= a(j, k) * a(j, k);
+    if (d <= 0)
+      return false;
+    a(j, j) = sqrt(d);
+    for (size_t i = j + 1; i != n; ++i) {
+      double x = a(i, j);
+      for (size_t k = 0; k != j; ++k)
+        x -= a(i, k) * a(j, k);
+      a(i, j) = x / a(j, j);
+    }
+  }
+  return true;
+}
+
+// The matrices are the same for any number of threads, and differ from
+// seed to seed.
+void
+check_deterministic()
+{
+  set_product_threads(1);
+  Mat a = random_matrix(300, 400, 1);
+  Mat b = random_banded_matrix(300, 2, 5, 1);
+  Mat c = random_spd_matrix(300, 1);
+  set_product_threads(4);
+  assert(random_matrix(300, 400, 1) == a);
+  assert(random_banded_matrix(300, 2, 5, 1) == b);
+  assert(random_spd_matrix(300, 1) == c);
+  assert(random_matrix(300, 400, 2) != a);
+  set_product_threads(0);
+}
+
+void
+check_dense()
+{
+  Mat a = random_matrix(200, 100, 7, 2.0, 3.0);
+  assert(a.rows() == 200 && a.cols() == 100);
+  double sum = 0;
+  for (double x : a) {
+    assert(2 <= x && x < 3);
+    sum += x;
+  }
+  assert(abs(sum / a.size() - 2.5) < 0.01);
+
+  matrix<float, 2> f = random_matrix<float>(10, 10, 7);
+  for (float x : f)
+    assert(-1 <= x && x < 1);
+}
+
+void
+check_banded()
+{
+  Mat a = random_banded_matrix(50, 3, 1, 9);
+  for (size_t i = 0; i != 50; ++i)
+    for (size_t j = 0; j != 50; ++j) {
+      bool band = j + 3 >= i && j <= i + 1;
+      assert(band == (a(i, j) != 0));
+    }
+}
+
+void
+check_spd()
+{
+  for (size_t p : {size_t(-1), size_t(4)}) {
+    Mat a = random_spd_matrix(100, 3, p);
+    for (size_t i = 0; i != 100; ++i) {
+      double off = 0;
+      for (size_t j = 0; j != 100; ++j) {
+        assert(a(i, j) == a(j, i));
+        if ((i > j ? i - j : j - i) > p)
+          assert(a(i, j) == 0);
+        if (j != i)
+          off += abs(a(i, j));
+      }
+      assert(a(i, i) > off);
+    }
+    assert(cholesky(a));
+  }
+  assert(random_spd_matrix(1, 3)(0, 0) == 1);
+}
+
+int main()
+{
+  check_deterministic();
+  check_dense();
+  check_banded();
+  check_spd();
+}
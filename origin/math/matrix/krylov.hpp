@@ -0,0 +1,743 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_KRYLOV_HPP
+#define ORIGIN_MATH_MATRIX_KRYLOV_HPP
+
+#include <origin/math/matrix/sparse.hpp>
+#include <origin/graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Krylov solvers                                                [krylov.decl]
+  //
+  // The Krylov solvers compute an approximate solution x of A * x = b from
+  // products of A with vectors. The following solvers are provided:
+  //
+  //    cg_solver<T>        -- Conjugate gradient, for symmetric positive
+  //                           definite A
+  //    bicgstab_solver<T>  -- Stabilized biconjugate gradient, for general A
+  //    gmres_solver<T>     -- Restarted GMRES, for general A
+  //
+  // The operator A is any object a for which spmv(a, x, y) computes y = A * x
+  // for vectors (matrix<T, 1>) x and y, and for which a.rows() and a.cols()
+  // are its extents. The sparse matrices (see [sparse.decl]), dense 2D
+  // matrices and matrix_refs, and graph Laplacians computed from the edges
+  // of a graph (graph_laplacian) are operators. Other operators are defined
+  // by overloading spmv in their namespace.
+  //
+  // A preconditioner is an object p for which p.apply(r, z) computes
+  // z = inv(M) * r, where M approximates A. The identity_preconditioner,
+  // jacobi_preconditioner, and ilu0_preconditioner are provided. CG uses
+  // the preconditioner on both sides; BiCGSTAB and GMRES on the right, so
+  // that their residuals are those of the original system.
+  //
+  // A solver owns its workspace vectors, which are allocated by the first
+  // solve of a system of a given size and reused by later solves, so that
+  // repeated solves do not allocate. A solver can be constructed with the
+  // size of its systems to allocate them in advance. Each solve starts from
+  // the initial value of x and iterates until the norm of the residual,
+  // relative to the norm of b, is at most the tolerance of its options.
+
+
+  // The options of a Krylov solver.
+  struct krylov_options
+  {
+    krylov_options()
+      : tolerance(1e-8), max_iterations(1000), restart(30)
+    { }
+
+    double      tolerance;      // The relative residual at convergence
+    std::size_t max_iterations; // The maximum number of products with A
+    std::size_t restart;        // The dimension of the GMRES subspace
+  };
+
+  // The result of a Krylov solve.
+  struct krylov_result
+  {
+    std::size_t iterations; // The number of iterations performed
+    double      residual;   // The final relative residual
+    bool        converged;  // True if the tolerance was reached
+  };
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Operators                                                 [krylov.operator]
+  //
+  // Compute y = A * x.
+
+  template <typename T>
+    inline void
+    spmv(const csr_matrix<T>& a, const matrix<T, 1>& x, matrix<T, 1>& y)
+    {
+      y = T(0);
+      sparse_product(a, x, y);
+    }
+
+  template <typename T>
+    inline void
+    spmv(const csc_matrix<T>& a, const matrix<T, 1>& x, matrix<T, 1>& y)
+    {
+      y = T(0);
+      sparse_product(a, x, y);
+    }
+
+  template <typename M, typename T>
+    inline Requires<matrix_impl::Strided_matrix<M>() && M::order == 2, void>
+    spmv(const M& a, const matrix<T, 1>& x, matrix<T, 1>& y)
+    {
+      y = T(0);
+      gemv(a, x, y);
+    }
+
+
+  // The Laplacian L = D - A of an undirected graph g (see [sparse.graph]),
+  // computed from the edges of g in each product, so that it is not stored.
+  // Only the weighted degrees of the vertices are stored. The graph must
+  // not be modified while the operator is used.
+  //
+  // Template Parameters:
+  //    G -- The undirected graph type
+  //    T -- The element type of the operator
+  //    W -- The edge weight function
+  template <typename G, typename T, typename W>
+    class graph_laplacian
+    {
+      static_assert(!Directed_graph<G>(), "");
+    public:
+      using value_type = T;
+
+      graph_laplacian(const G& g, W w);
+
+      // Returns the extents of the operator.
+      std::size_t rows() const { return g.order(); }
+      std::size_t cols() const { return g.order(); }
+
+      // Returns the weighted degrees of the vertices.
+      const std::vector<T>& degrees() const { return deg; }
+
+      // Compute y = L * x.
+      void apply(const matrix<T, 1>& x, matrix<T, 1>& y) const;
+
+    private:
+      void apply(const matrix<T, 1>& x, matrix<T, 1>& y,
+                 std::size_t first, std::size_t last) const;
+
+      const G& g;
+      W w;
+      std::vector<T> deg;
+    };
+
+  template <typename G, typename T, typename W>
+    graph_laplacian<G, T, W>::graph_laplacian(const G& g, W w)
+      : g(g), w(w), deg(g.order(), T(0))
+    {
+      for (Edge<G> e : g.edges()) {
+        std::size_t u = g.source(e);
+        std::size_t v = g.target(e);
+        if (u == v)
+          continue;
+        T x = w(e);
+        deg[u] += x;
+        deg[v] += x;
+      }
+    }
+
+  template <typename G, typename T, typename W>
+    void
+    graph_laplacian<G, T, W>::apply(const matrix<T, 1>& x, matrix<T, 1>& y,
+                                    std::size_t first, std::size_t last) const
+    {
+      for (std::size_t i = first; i != last; ++i) {
+        Vertex<G> v(i);
+        T s = deg[i] * x(i);
+        for (Edge<G> e : g.edges(v)) {
+          std::size_t u = opposite(g, e, v);
+          if (u != i)
+            s -= w(e) * x(u);
+        }
+        y(i) = s;
+      }
+    }
+
+  // Vertices are independent, so blocks of vertices are computed
+  // concurrently, as the rows of a CSR product.
+  template <typename G, typename T, typename W>
+    void
+    graph_laplacian<G, T, W>::apply(const matrix<T, 1>& x,
+                                    matrix<T, 1>& y) const
+    {
+      assert(x.size() == rows() && y.size() == rows());
+      std::size_t n = rows();
+      std::size_t threads = product_threads();
+      if (threads > 1 && 2 * g.size() >= sparse_impl::parallel_nonzeros) {
+        std::size_t blocks = threads * 4;
+        std::size_t step = (n + blocks - 1) / blocks;
+        matrix_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t first = std::min(n, k * step);
+          apply(x, y, first, std::min(n, first + step));
+        });
+      } else {
+        apply(x, y, 0, n);
+      }
+    }
+
+  template <typename G, typename T, typename W>
+    inline void
+    spmv(const graph_laplacian<G, T, W>& a,
+         const matrix<T, 1>& x,
+         matrix<T, 1>& y)
+    {
+      a.apply(x, y);
+    }
+
+  // Returns the Laplacian operator of g, whose edge weights are given by w,
+  // or are 1 when omitted.
+  template <typename T, typename G, typename W>
+    inline graph_laplacian<G, T, W>
+    laplacian_operator(const G& g, W w)
+    {
+      return {g, w};
+    }
+
+  template <typename T, typename G>
+    inline graph_laplacian<G, T, sparse_impl::unit_weight<T>>
+    laplacian_operator(const G& g)
+    {
+      return {g, sparse_impl::unit_weight<T>{}};
+    }
+
+
+  // Returns the diagonal of an operator.
+  template <typename T>
+    std::vector<T>
+    diagonal_of(const csr_matrix<T>& a)
+    {
+      std::vector<T> d(std::min(a.rows(), a.cols()));
+      for (std::size_t i = 0; i != d.size(); ++i)
+        d[i] = a(i, i);
+      return d;
+    }
+
+  template <typename M>
+    Requires<
+      matrix_impl::Strided_matrix<M>() && M::order == 2,
+      std::vector<Remove_const<Value_type<M>>>
+    >
+    diagonal_of(const M& a)
+    {
+      using T = Remove_const<Value_type<M>>;
+      std::vector<T> d(std::min(a.rows(), a.cols()));
+      for (std::size_t i = 0; i != d.size(); ++i)
+        d[i] = a(i, i);
+      return d;
+    }
+
+  template <typename G, typename T, typename W>
+    inline std::vector<T>
+    diagonal_of(const graph_laplacian<G, T, W>& a)
+    {
+      return a.degrees();
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Preconditioners                                            [krylov.precond]
+
+  // The identity preconditioner M = I.
+  struct identity_preconditioner
+  {
+    template <typename T>
+      void apply(const matrix<T, 1>& r, matrix<T, 1>& z) const
+      {
+        z = r;
+      }
+  };
+
+
+  // The Jacobi preconditioner M = diag(A). Zeros on the diagonal of A are
+  // treated as ones.
+  template <typename T>
+    class jacobi_preconditioner
+    {
+    public:
+      // Construct the preconditioner from the diagonal of the operator a.
+      template <typename Op>
+        explicit jacobi_preconditioner(const Op& a);
+
+      void apply(const matrix<T, 1>& r, matrix<T, 1>& z) const
+      {
+        assert(r.size() == inv.size() && z.size() == inv.size());
+        for (std::size_t i = 0; i != inv.size(); ++i)
+          z(i) = inv[i] * r(i);
+      }
+
+    private:
+      std::vector<T> inv; // The reciprocals of the diagonal
+    };
+
+  template <typename T>
+    template <typename Op>
+      jacobi_preconditioner<T>::jacobi_preconditioner(const Op& a)
+        : inv(diagonal_of(a))
+      {
+        for (T& x : inv)
+          x = x == T(0) ? T(1) : T(1) / x;
+      }
+
+
+  // The incomplete LU factorization with no fill, M = L * U, where L and U
+  // have the sparsity pattern of the lower and upper triangles of the CSR
+  // matrix A, and L has a unit diagonal. Every diagonal element of A must be
+  // stored and nonzero, and must remain nonzero in U. The preconditioner
+  // refers to the structure of A, which must outlive it.
+  template <typename T>
+    class ilu0_preconditioner
+    {
+    public:
+      explicit ilu0_preconditioner(const csr_matrix<T>& a);
+
+      void apply(const matrix<T, 1>& r, matrix<T, 1>& z) const;
+
+    private:
+      const std::size_t* off; // The structure of A
+      const std::size_t* col;
+      std::vector<T> lu;             // The values of L and U, as in A
+      std::vector<std::size_t> diag; // The position of each diagonal element
+    };
+
+  // The factorization is the IKJ variant of Gaussian elimination, restricted
+  // to the stored elements of each row.
+  template <typename T>
+    ilu0_preconditioner<T>::ilu0_preconditioner(const csr_matrix<T>& a)
+      : off(a.row_offsets().data()),
+        col(a.col_indices().data()),
+        lu(a.values()),
+        diag(a.rows())
+    {
+      assert(a.rows() == a.cols());
+      std::size_t n = a.rows();
+      for (std::size_t i = 0; i != n; ++i) {
+        const std::size_t* p = std::lower_bound(col + off[i],
+                                                col + off[i + 1], i);
+        assert(p != col + off[i + 1] && *p == i);
+        diag[i] = p - col;
+      }
+
+      // The position in row i of each column, or npos.
+      constexpr std::size_t npos = -1;
+      std::vector<std::size_t> pos(n, npos);
+      for (std::size_t i = 0; i != n; ++i) {
+        for (std::size_t k = off[i]; k != off[i + 1]; ++k)
+          pos[col[k]] = k;
+        for (std::size_t k = off[i]; k != diag[i]; ++k) {
+          std::size_t c = col[k];
+          assert(lu[diag[c]] != T(0));
+          T l = lu[k] /= lu[diag[c]];
+          for (std::size_t j = diag[c] + 1; j != off[c + 1]; ++j)
+            if (pos[col[j]] != npos)
+              lu[pos[col[j]]] -= l * lu[j];
+        }
+        for (std::size_t k = off[i]; k != off[i + 1]; ++k)
+          pos[col[k]] = npos;
+      }
+    }
+
+  template <typename T>
+    void
+    ilu0_preconditioner<T>::apply(const matrix<T, 1>& r, matrix<T, 1>& z) const
+    {
+      std::size_t n = diag.size();
+      assert(r.size() == n && z.size() == n);
+
+      // Solve L * y = r, then U * z = y.
+      for (std::size_t i = 0; i != n; ++i) {
+        T s = r(i);
+        for (std::size_t k = off[i]; k != diag[i]; ++k)
+          s -= lu[k] * z(col[k]);
+        z(i) = s;
+      }
+      for (std::size_t i = n; i-- != 0; ) {
+        T s = z(i);
+        for (std::size_t k = diag[i] + 1; k != off[i + 1]; ++k)
+          s -= lu[k] * z(col[k]);
+        z(i) = s / lu[diag[i]];
+      }
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Solvers                                                    [krylov.solvers]
+
+  namespace krylov_impl
+  {
+    // Resize the workspace vector v to n elements, if it has another size.
+    template <typename T>
+      inline void
+      reserve(matrix<T, 1>& v, std::size_t n)
+      {
+        if (v.size() != n)
+          v = matrix<T, 1>(n);
+      }
+
+    // Compute r = b - A * x.
+    template <typename Op, typename T>
+      inline void
+      residual(const Op& a, const matrix<T, 1>& b, const matrix<T, 1>& x,
+               matrix<T, 1>& r)
+      {
+        spmv(a, x, r);
+        r *= T(-1);
+        r += b;
+      }
+
+    // Returns the norm of b, or 1 if b is zero, by which residuals are
+    // divided.
+    template <typename T>
+      inline T
+      rhs_norm(const matrix<T, 1>& b)
+      {
+        T n = nrm2(b);
+        return n == T(0) ? T(1) : n;
+      }
+
+  } // namespace krylov_impl
+
+
+  // The preconditioned conjugate gradient method.
+  template <typename T>
+    class cg_solver
+    {
+    public:
+      cg_solver() = default;
+
+      // Allocate the workspace for systems of n equations.
+      explicit cg_solver(std::size_t n) { reserve(n); }
+
+      // Solve A * x = b, where A is symmetric positive definite, and so is
+      // the preconditioner p.
+      template <typename Op, typename P>
+        krylov_result solve(const Op& a,
+                            const matrix<T, 1>& b,
+                            matrix<T, 1>& x,
+                            const P& p,
+                            const krylov_options& opts = krylov_options());
+
+      template <typename Op>
+        krylov_result solve(const Op& a,
+                            const matrix<T, 1>& b,
+                            matrix<T, 1>& x,
+                            const krylov_options& opts = krylov_options())
+        {
+          return solve(a, b, x, identity_preconditioner{}, opts);
+        }
+
+    private:
+      void reserve(std::size_t n)
+      {
+        krylov_impl::reserve(r, n);
+        krylov_impl::reserve(z, n);
+        krylov_impl::reserve(d, n);
+        krylov_impl::reserve(q, n);
+      }
+
+      matrix<T, 1> r, z, d, q;
+    };
+
+  template <typename T>
+    template <typename Op, typename P>
+      krylov_result
+      cg_solver<T>::solve(const Op& a,
+                          const matrix<T, 1>& b,
+                          matrix<T, 1>& x,
+                          const P& p,
+                          const krylov_options& opts)
+      {
+        assert(a.rows() == a.cols());
+        assert(b.size() == a.rows() && x.size() == a.rows());
+        reserve(b.size());
+
+        const T bn = krylov_impl::rhs_norm(b);
+        krylov_impl::residual(a, b, x, r);
+        T res = nrm2(r) / bn;
+        p.apply(r, z);
+        d = z;
+        T rz = dot(r, z);
+
+        std::size_t k = 0;
+        for ( ; k != opts.max_iterations && res > opts.tolerance; ++k) {
+          spmv(a, d, q);
+          T alpha = rz / dot(d, q);
+          axpy(alpha, d, x);
+          axpy(-alpha, q, r);
+          res = nrm2(r) / bn;
+          p.apply(r, z);
+          T next = dot(r, z);
+          d *= next / rz;
+          d += z;
+          rz = next;
+        }
+        return {k, double(res), res <= opts.tolerance};
+      }
+
+
+  // The stabilized biconjugate gradient method, with right preconditioning.
+  template <typename T>
+    class bicgstab_solver
+    {
+    public:
+      bicgstab_solver() = default;
+
+      // Allocate the workspace for systems of n equations.
+      explicit bicgstab_solver(std::size_t n) { reserve(n); }
+
+      // Solve A * x = b. The solve stops early, without converging, if the
+      // method breaks down.
+      template <typename Op, typename P>
+        krylov_result solve(const Op& a,
+                            const matrix<T, 1>& b,
+                            matrix<T, 1>& x,
+                            const P& p,
+                            const krylov_options& opts = krylov_options());
+
+      template <typename Op>
+        krylov_result solve(const Op& a,
+                            const matrix<T, 1>& b,
+                            matrix<T, 1>& x,
+                            const krylov_options& opts = krylov_options())
+        {
+          return solve(a, b, x, identity_preconditioner{}, opts);
+        }
+
+    private:
+      void reserve(std::size_t n)
+      {
+        krylov_impl::reserve(r, n);
+        krylov_impl::reserve(r0, n);
+        krylov_impl::reserve(d, n);
+        krylov_impl::reserve(v, n);
+        krylov_impl::reserve(s, n);
+        krylov_impl::reserve(t, n);
+        krylov_impl::reserve(y, n);
+        krylov_impl::reserve(z, n);
+      }
+
+      matrix<T, 1> r, r0, d, v, s, t, y, z;
+    };
+
+  template <typename T>
+    template <typename Op, typename P>
+      krylov_result
+      bicgstab_solver<T>::solve(const Op& a,
+                                const matrix<T, 1>& b,
+                                matrix<T, 1>& x,
+                                const P& p,
+                                const krylov_options& opts)
+      {
+        assert(a.rows() == a.cols());
+        assert(b.size() == a.rows() && x.size() == a.rows());
+        reserve(b.size());
+
+        const T bn = krylov_impl::rhs_norm(b);
+        krylov_impl::residual(a, b, x, r);
+        T res = nrm2(r) / bn;
+        r0 = r;
+        d = T(0);
+        v = T(0);
+        T rho = 1, alpha = 1, omega = 1;
+
+        std::size_t k = 0;
+        for ( ; k != opts.max_iterations && res > opts.tolerance; ++k) {
+          T next = dot(r0, r);
+          if (next == T(0) || omega == T(0))
+            break;
+
+          // d = r + beta * (d - omega * v)
+          T beta = (next / rho) * (alpha / omega);
+          axpy(-omega, v, d);
+          d *= beta;
+          d += r;
+          p.apply(d, y);
+          spmv(a, y, v);
+          alpha = next / dot(r0, v);
+
+          // s = r - alpha * v
+          s = r;
+          axpy(-alpha, v, s);
+          axpy(alpha, y, x);
+          res = nrm2(s) / bn;
+          if (res <= opts.tolerance) {
+            ++k;
+            break;
+          }
+
+          p.apply(s, z);
+          spmv(a, z, t);
+          T tt = dot(t, t);
+          omega = tt == T(0) ? T(0) : dot(t, s) / tt;
+          axpy(omega, z, x);
+
+          // r = s - omega * t
+          r = s;
+          axpy(-omega, t, r);
+          res = nrm2(r) / bn;
+          rho = next;
+        }
+        return {k, double(res), res <= opts.tolerance};
+      }
+
+
+  // The restarted generalized minimal residual method, with right
+  // preconditioning. The Arnoldi basis is orthogonalized by the modified
+  // Gram-Schmidt method, and the least squares problem is solved by Givens
+  // rotations.
+  template <typename T>
+    class gmres_solver
+    {
+    public:
+      gmres_solver() = default;
+
+      // Allocate the workspace for systems of n equations and a subspace of
+      // dimension m.
+      gmres_solver(std::size_t n, std::size_t m) { reserve(n, m); }
+
+      // Solve A * x = b.
+      template <typename Op, typename P>
+        krylov_result solve(const Op& a,
+                            const matrix<T, 1>& b,
+                            matrix<T, 1>& x,
+                            const P& p,
+                            const krylov_options& opts = krylov_options());
+
+      template <typename Op>
+        krylov_result solve(const Op& a,
+                            const matrix<T, 1>& b,
+                            matrix<T, 1>& x,
+                            const krylov_options& opts = krylov_options())
+        {
+          return solve(a, b, x, identity_preconditioner{}, opts);
+        }
+
+    private:
+      void reserve(std::size_t n, std::size_t m);
+
+      std::vector<matrix<T, 1>> basis; // The Arnoldi basis, V
+      matrix<T, 2> h;                  // The Hessenberg matrix, H
+      std::vector<T> cs, sn, g;        // The rotations and rotated residual
+      matrix<T, 1> w, z;
+    };
+
+  template <typename T>
+    void
+    gmres_solver<T>::reserve(std::size_t n, std::size_t m)
+    {
+      if (basis.size() != m + 1 || (m && basis[0].size() != n)) {
+        basis.resize(m + 1);
+        for (matrix<T, 1>& v : basis)
+          krylov_impl::reserve(v, n);
+      }
+      if (h.rows() != m + 1 || h.cols() != m)
+        h = matrix<T, 2>(m + 1, m);
+      cs.resize(m);
+      sn.resize(m);
+      g.resize(m + 1);
+      krylov_impl::reserve(w, n);
+      krylov_impl::reserve(z, n);
+    }
+
+  template <typename T>
+    template <typename Op, typename P>
+      krylov_result
+      gmres_solver<T>::solve(const Op& a,
+                             const matrix<T, 1>& b,
+                             matrix<T, 1>& x,
+                             const P& p,
+                             const krylov_options& opts)
+      {
+        assert(a.rows() == a.cols());
+        assert(b.size() == a.rows() && x.size() == a.rows());
+        assert(opts.restart != 0);
+        const std::size_t m = opts.restart;
+        reserve(b.size(), m);
+
+        const T bn = krylov_impl::rhs_norm(b);
+        std::size_t k = 0;
+        T res = 0;
+        while (true) {
+          krylov_impl::residual(a, b, x, basis[0]);
+          T beta = nrm2(basis[0]);
+          res = beta / bn;
+          if (k == opts.max_iterations || res <= opts.tolerance)
+            break;
+          basis[0] *= T(1) / beta;
+          std::fill(g.begin(), g.end(), T(0));
+          g[0] = beta;
+
+          // Extend the basis until it has m vectors, the residual is small
+          // enough, or the iterations are exhausted.
+          std::size_t j = 0;
+          while (j != m && k != opts.max_iterations) {
+            p.apply(basis[j], z);
+            spmv(a, z, w);
+            for (std::size_t i = 0; i <= j; ++i) {
+              h(i, j) = dot(w, basis[i]);
+              axpy(-h(i, j), basis[i], w);
+            }
+            T norm = nrm2(w);
+            h(j + 1, j) = norm;
+            if (norm != T(0)) {
+              basis[j + 1] = w;
+              basis[j + 1] *= T(1) / norm;
+            }
+
+            // Apply the previous rotations to the new column of H, and
+            // eliminate its subdiagonal element by a new rotation.
+            for (std::size_t i = 0; i != j; ++i) {
+              T u = h(i, j);
+              T v = h(i + 1, j);
+              h(i, j) = cs[i] * u + sn[i] * v;
+              h(i + 1, j) = cs[i] * v - sn[i] * u;
+            }
+            T u = h(j, j);
+            T v = h(j + 1, j);
+            T r = std::hypot(u, v);
+            cs[j] = u / r;
+            sn[j] = v / r;
+            h(j, j) = r;
+            h(j + 1, j) = 0;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] = cs[j] * g[j];
+
+            ++j;
+            ++k;
+            res = std::abs(g[j]) / bn;
+            if (res <= opts.tolerance || norm == T(0))
+              break;
+          }
+
+          // Solve H * y = g, storing y in g, and compute x += inv(M) * V * y.
+          for (std::size_t i = j; i-- != 0; ) {
+            for (std::size_t c = i + 1; c != j; ++c)
+              g[i] -= h(i, c) * g[c];
+            g[i] /= h(i, i);
+          }
+          w = T(0);
+          for (std::size_t i = 0; i != j; ++i)
+            axpy(g[i], basis[i], w);
+          p.apply(w, z);
+          x += z;
+        }
+        return {k, double(res), res <= opts.tolerance};
+      }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,217 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/krylov.hpp>
+#include <origin/graph/adjacency_vector.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Vec = matrix<double, 1>;
+
+// Returns the 2D Poisson matrix of a k x k grid, which is symmetric positive
+// definite. If c is not 0, a convection term makes it nonsymmetric.
+csr_matrix<double>
+poisson(size_t k, double c = 0)
+{
+  size_t n = k * k;
+  vector<sparse_entry<double>> entries;
+  for (size_t i = 0; i != k; ++i) {
+    for (size_t j = 0; j != k; ++j) {
+      size_t r = i * k + j;
+      entries.push_back({r, r, 4.0});
+      if (i > 0)
+        entries.push_back({r, r - k, -1.0 - c});
+      if (i + 1 < k)
+        entries.push_back({r, r + k, -1.0 + c});
+      if (j > 0)
+        entries.push_back({r, r - 1, -1.0 - c});
+      if (j + 1 < k)
+        entries.push_back({r, r + 1, -1.0 + c});
+    }
+  }
+  return {n, n, entries};
+}
+
+// Returns the relative residual |b - A * x| / |b|.
+template <typename Op>
+  double
+  residual(const Op& a, const Vec& b, const Vec& x)
+  {
+    Vec r(b.size());
+    spmv(a, x, r);
+    r -= b;
+    return nrm2(r) / nrm2(b);
+  }
+
+// Returns a right-hand side with varying elements.
+Vec
+rhs(size_t n)
+{
+  Vec b(n);
+  for (size_t i = 0; i != n; ++i)
+    b(i) = 1 + double(i % 7) - 3 * double(i % 3);
+  return b;
+}
+
+void
+test_cg()
+{
+  csr_matrix<double> a = poisson(30);
+  size_t n = a.rows();
+  Vec b = rhs(n);
+
+  cg_solver<double> cg(n);
+  Vec x(n);
+  krylov_result r = cg.solve(a, b, x);
+  assert(r.converged);
+  assert(residual(a, b, x) < 1e-7);
+
+  // The preconditioners reduce the number of iterations.
+  jacobi_preconditioner<double> jacobi(a);
+  Vec y(n);
+  krylov_result rj = cg.solve(a, b, y, jacobi);
+  assert(rj.converged);
+  assert(residual(a, b, y) < 1e-7);
+
+  ilu0_preconditioner<double> ilu(a);
+  Vec z(n);
+  krylov_result ri = cg.solve(a, b, z, ilu);
+  assert(ri.converged);
+  assert(ri.iterations < r.iterations);
+  assert(residual(a, b, z) < 1e-7);
+
+  // Solving from the solution converges immediately.
+  krylov_result again = cg.solve(a, b, z, ilu);
+  assert(again.converged);
+  assert(again.iterations == 0);
+
+  // The iterations are limited.
+  krylov_options opts;
+  opts.max_iterations = 3;
+  Vec w(n);
+  krylov_result rl = cg.solve(a, b, w, opts);
+  assert(!rl.converged);
+  assert(rl.iterations == 3);
+
+  // A zero right-hand side has the solution zero.
+  Vec zero(n);
+  Vec u(n);
+  assert(cg.solve(a, zero, u).converged);
+  assert(nrm2(u) == 0);
+}
+
+void
+test_nonsymmetric()
+{
+  csr_matrix<double> a = poisson(25, 0.4);
+  size_t n = a.rows();
+  Vec b = rhs(n);
+  ilu0_preconditioner<double> ilu(a);
+
+  bicgstab_solver<double> bicg;
+  Vec x(n);
+  krylov_result r1 = bicg.solve(a, b, x);
+  assert(r1.converged);
+  assert(residual(a, b, x) < 1e-7);
+  Vec y(n);
+  krylov_result r2 = bicg.solve(a, b, y, ilu);
+  assert(r2.converged);
+  assert(r2.iterations < r1.iterations);
+  assert(residual(a, b, y) < 1e-7);
+
+  gmres_solver<double> gmres;
+  krylov_options opts;
+  opts.restart = 20;
+  Vec u(n);
+  krylov_result r3 = gmres.solve(a, b, u, opts);
+  assert(r3.converged);
+  assert(residual(a, b, u) < 1e-7);
+  Vec v(n);
+  krylov_result r4 = gmres.solve(a, b, v, ilu, opts);
+  assert(r4.converged);
+  assert(r4.iterations < r3.iterations);
+  assert(residual(a, b, v) < 1e-7);
+
+  // Without restarts, GMRES terminates in at most n iterations.
+  csr_matrix<double> s = poisson(4, 0.3);
+  opts.restart = 16;
+  Vec bs = rhs(16);
+  Vec xs(16);
+  krylov_result r5 = gmres.solve(s, bs, xs, opts);
+  assert(r5.converged);
+  assert(r5.iterations <= 16);
+}
+
+void
+test_operators()
+{
+  // Dense matrices and CSC matrices are operators.
+  csr_matrix<double> a = poisson(8, 0.2);
+  size_t n = a.rows();
+  matrix<double, 2> d(n, n);
+  for (size_t i = 0; i != n; ++i)
+    for (size_t j = 0; j != n; ++j)
+      d(i, j) = a(i, j);
+  csc_matrix<double> c(a);
+  Vec b = rhs(n);
+
+  gmres_solver<double> gmres(n, 30);
+  Vec x(n), y(n);
+  jacobi_preconditioner<double> jacobi(d);
+  assert(gmres.solve(d, b, x, jacobi).converged);
+  assert(residual(a, b, x) < 1e-7);
+  assert(gmres.solve(c, b, y).converged);
+  assert(residual(a, b, y) < 1e-7);
+
+  // The Laplacian of a graph is computed from its edges: a ring of 200
+  // vertices with chords.
+  undirected_adjacency_vector<> g;
+  const size_t m = 200;
+  for (size_t i = 0; i != m; ++i)
+    g.add_vertex();
+  for (size_t i = 0; i != m; ++i) {
+    g.add_edge(vertex_handle(i), vertex_handle((i + 1) % m));
+    if (i % 5 == 0)
+      g.add_edge(vertex_handle(i), vertex_handle((i + 17) % m));
+  }
+  g.add_edge(vertex_handle(3), vertex_handle(3));
+
+  auto l = laplacian_operator<double>(g);
+  csr_matrix<double> lm = laplacian_matrix<double>(g);
+  Vec v(m);
+  for (size_t i = 0; i != m; ++i)
+    v(i) = double(i % 11);
+  Vec p(m), q(m);
+  spmv(l, v, p);
+  spmv(lm, v, q);
+  p -= q;
+  assert(nrm2(p) < 1e-12);
+
+  // The Laplacian is singular, but positive semidefinite, and L * x = b is
+  // consistent when the elements of b sum to zero.
+  Vec bl(m);
+  for (size_t i = 0; i != m; ++i)
+    bl(i) = (i % 2 ? 1.0 : -1.0);
+  cg_solver<double> cg;
+  jacobi_preconditioner<double> lj(l);
+  Vec xl(m);
+  krylov_result r = cg.solve(l, bl, xl, lj);
+  assert(r.converged);
+  assert(residual(l, bl, xl) < 1e-7);
+}
+
+int main()
+{
+  test_cg();
+  test_nonsymmetric();
+  test_operators();
+}
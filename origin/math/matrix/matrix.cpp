@@ -5,10 +5,424 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <atomic>
+#include <cassert>
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+#include <origin/concurrency/scheduler.hpp>
+
 #include "matrix.hpp"
+#include "tuning.hpp"
 
 namespace origin
 {
   slice slice::all {0, std::size_t(-1), 1};
-}
 
+
+  // ------------------------------------------------------------------------ //
+  //                          Product Threads
+
+  namespace
+  {
+    // The requested number of product threads. A value of 0 indicates the
+    // number of hardware threads.
+    std::atomic<std::size_t> requested_threads {0};
+  } // namespace
+
+  std::size_t
+  product_threads()
+  {
+    std::size_t n = requested_threads.load(std::memory_order_relaxed);
+    if (n == 0)
+      n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+  }
+
+  void
+  set_product_threads(std::size_t n)
+  {
+    requested_threads.store(n, std::memory_order_relaxed);
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Product Tuning
+
+  bool
+  operator==(const product_tuning& a, const product_tuning& b)
+  {
+    return a.mr == b.mr && a.nr == b.nr
+        && a.mc == b.mc && a.kc == b.kc && a.nc == b.nc
+        && a.transpose_block == b.transpose_block;
+  }
+
+  bool
+  operator!=(const product_tuning& a, const product_tuning& b)
+  {
+    return !(a == b);
+  }
+
+  std::ostream&
+  operator<<(std::ostream& os, const product_tuning& p)
+  {
+    return os << "mr=" << p.mr << " nr=" << p.nr << " mc=" << p.mc
+              << " kc=" << p.kc << " nc=" << p.nc
+              << " transpose=" << p.transpose_block;
+  }
+
+  namespace
+  {
+    // The parameters of the tuned value types, stored field by field. Each
+    // tuning is initialized the first time that it is used.
+    struct tuning_slot
+    {
+      std::atomic<std::size_t> fields[6];
+      std::atomic<bool>        ready;
+      std::once_flag           once;
+    };
+
+    tuning_slot tunings[2];
+
+    void
+    store_tuning(tuning_slot& s, const product_tuning& p)
+    {
+      const std::size_t xs[] = {p.mr, p.nr, p.mc, p.kc, p.nc,
+                                p.transpose_block};
+      for (std::size_t i = 0; i != 6; ++i)
+        s.fields[i].store(xs[i], std::memory_order_relaxed);
+    }
+  } // namespace
+
+  namespace matrix_impl
+  {
+    // The slot is given the default parameters before the initial tuning
+    // is read or measured, so that the products measured by the initial
+    // tuning use them.
+    product_tuning
+    get_tuning(int i)
+    {
+      if (i < 0)
+        return default_product_tuning;
+      tuning_slot& s = tunings[i];
+      if (!s.ready.load(std::memory_order_acquire))
+        std::call_once(s.once, [&s, i]() {
+          store_tuning(s, default_product_tuning);
+          s.ready.store(true, std::memory_order_release);
+          initial_tuning(i);
+        });
+      return {s.fields[0].load(std::memory_order_relaxed),
+              s.fields[1].load(std::memory_order_relaxed),
+              s.fields[2].load(std::memory_order_relaxed),
+              s.fields[3].load(std::memory_order_relaxed),
+              s.fields[4].load(std::memory_order_relaxed),
+              s.fields[5].load(std::memory_order_relaxed)};
+    }
+
+    void
+    set_tuning(int i, const product_tuning& p)
+    {
+      if ((p.mr != 4 && p.mr != 8) || (p.nr != 4 && p.nr != 8))
+        throw std::invalid_argument("unsupported register tile");
+      if (p.mc == 0 || p.kc == 0 || p.nc == 0 || p.transpose_block == 0)
+        throw std::invalid_argument("invalid product block");
+      // Parameters that are set before they are first used replace the
+      // initial tuning.
+      tuning_slot& s = tunings[i];
+      if (!s.ready.load(std::memory_order_acquire))
+        std::call_once(s.once, [&s]() {
+          s.ready.store(true, std::memory_order_release);
+        });
+      store_tuning(s, p);
+    }
+  } // namespace matrix_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Parallel Calls
+
+  namespace matrix_impl
+  {
+    // The calls are made by tasks of the default scheduler, which is shared
+    // with the other modules, so that a product computed within a parallel
+    // algorithm does not start threads of its own (see [conc.fork]).
+    void
+    parallel_for(std::size_t n,
+                 std::size_t threads,
+                 const std::function<void(std::size_t)>& f)
+    {
+      parallel_apply(default_scheduler(), n, threads, f);
+    }
+
+    // The parts are rounded to a whole number of pages, so that no page is
+    // touched by two threads.
+    void
+    parallel_zero(void* p, std::size_t n)
+    {
+      constexpr std::size_t page = 4096;
+      std::size_t threads = product_threads();
+      std::size_t step = ((n + threads - 1) / threads + page - 1) / page * page;
+      std::size_t parts = (n + step - 1) / step;
+      char* first = static_cast<char*>(p);
+      parallel_for(parts, threads, [=](std::size_t t) {
+        std::size_t i = t * step;
+        std::memset(first + i, 0, std::min(step, n - i));
+      });
+    }
+
+    // A copy is bound by memory bandwidth, which a single thread does not
+    // saturate, but small copies are not worth dispatching.
+    void
+    parallel_copy(void* dst, const void* src, std::size_t n)
+    {
+      constexpr std::size_t page = 4096;
+      bool stream = n >= algorithm_impl::stream_threshold;
+      std::size_t threads = product_threads();
+      if (threads < 2 || n < parallel_elements * sizeof(double)) {
+        algorithm_impl::stream_memcpy(dst, src, n, stream);
+        return;
+      }
+      std::size_t step = ((n + threads - 1) / threads + page - 1) / page * page;
+      std::size_t parts = (n + step - 1) / step;
+      char* d = static_cast<char*>(dst);
+      const char* s = static_cast<const char*>(src);
+      parallel_for(parts, threads, [=](std::size_t t) {
+        std::size_t i = t * step;
+        algorithm_impl::stream_memcpy(d + i, s + i, std::min(step, n - i),
+                                      stream);
+      });
+    }
+
+    void
+    parallel_rows(std::size_t n, std::size_t elements,
+                  const std::function<void(std::size_t, std::size_t)>& f)
+    {
+      std::size_t threads = product_threads();
+      if (threads < 2 || n < 2 || elements < parallel_elements) {
+        f(0, n);
+        return;
+      }
+      std::size_t step = (n + threads - 1) / threads;
+      std::size_t blocks = (n + step - 1) / step;
+      parallel_for(blocks, threads, [&](std::size_t b) {
+        std::size_t i = b * step;
+        f(i, std::min(i + step, n));
+      });
+    }
+  } // namespace matrix_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Matrix Workspace
+
+  namespace
+  {
+    thread_local matrix_workspace* current_workspace = nullptr;
+  } // namespace
+
+  constexpr std::size_t matrix_workspace::default_limit;
+
+  matrix_workspace::matrix_workspace(std::size_t limit)
+    : limit_(limit), prev_(current_workspace)
+  {
+    current_workspace = this;
+  }
+
+  matrix_workspace::~matrix_workspace()
+  {
+    assert(current_workspace == this);
+    current_workspace = prev_;
+    release();
+  }
+
+  matrix_workspace*
+  matrix_workspace::current()
+  {
+    return current_workspace;
+  }
+
+  // The most recently released array of the requested size is reused, so
+  // that it is likely to still be in cache.
+  void*
+  matrix_workspace::allocate(std::size_t n, std::size_t align)
+  {
+    for (std::size_t i = blocks_.size(); i != 0; --i) {
+      block& b = blocks_[i - 1];
+      if (b.size == n && b.align == align) {
+        void* p = b.ptr;
+        blocks_.erase(blocks_.begin() + (i - 1));
+        cached_ -= n;
+        ++hits_;
+        return p;
+      }
+    }
+    ++misses_;
+    return aligned_allocate(n, align);
+  }
+
+  void
+  matrix_workspace::deallocate(void* p, std::size_t n, std::size_t align)
+  {
+    if (cached_ + n > limit_) {
+      aligned_deallocate(p);
+      return;
+    }
+    blocks_.push_back({p, n, align});
+    cached_ += n;
+  }
+
+  void
+  matrix_workspace::release()
+  {
+    for (block& b : blocks_)
+      aligned_deallocate(b.ptr);
+    blocks_.clear();
+    cached_ = 0;
+  }
+
+  namespace matrix_impl
+  {
+    void*
+    workspace_allocate(std::size_t n, std::size_t align)
+    {
+      if (matrix_workspace* ws = current_workspace)
+        return ws->allocate(n, align);
+      return aligned_allocate(n, align);
+    }
+
+    void
+    workspace_deallocate(void* p, std::size_t n, std::size_t align)
+    {
+      if (matrix_workspace* ws = current_workspace)
+        ws->deallocate(p, n, align);
+      else
+        aligned_deallocate(p);
+    }
+  } // namespace matrix_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Tensor Contraction
+
+  namespace matrix_impl
+  {
+    namespace
+    {
+      [[noreturn]] void
+      invalid_contraction(const std::string& spec, const char* what)
+      {
+        throw std::invalid_argument("contract: '" + spec + "': " + what);
+      }
+    } // namespace
+
+    contraction_spec
+    parse_contraction(const char* spec, std::size_t n)
+    {
+      std::string s;
+      for (const char* p = spec; *p; ++p)
+        if (*p != ' ')
+          s += *p;
+
+      contraction_spec r;
+      std::size_t arrow = s.find("->");
+      std::string in = s.substr(0, arrow);
+      for (std::size_t i = 0; ; ) {
+        std::size_t j = in.find(',', i);
+        r.operands.push_back(in.substr(i, j - i));
+        if (j == std::string::npos)
+          break;
+        i = j + 1;
+      }
+      if (r.operands.size() != n)
+        invalid_contraction(s, "wrong number of operands");
+
+      // Count the occurrences of each label.
+      std::size_t count[128] = { };
+      for (const std::string& x : r.operands)
+        for (char c : x) {
+          if (!std::isalpha(static_cast<unsigned char>(c)))
+            invalid_contraction(s, "labels must be letters");
+          ++count[label_index(c)];
+        }
+
+      if (arrow == std::string::npos) {
+        for (char c = 'A'; c <= 'z'; ++c)
+          if (std::isalpha(c) && count[label_index(c)] == 1)
+            r.result += c;
+      } else {
+        r.result = s.substr(arrow + 2);
+        for (std::size_t i = 0; i != r.result.size(); ++i) {
+          char c = r.result[i];
+          if (!std::isalpha(static_cast<unsigned char>(c))
+              || count[label_index(c)] == 0)
+            invalid_contraction(s, "the result has a label of no operand");
+          if (r.result.find(c, i + 1) != std::string::npos)
+            invalid_contraction(s, "the result repeats a label");
+        }
+      }
+      return r;
+    }
+  } // namespace matrix_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                      Row and Column Permutations
+
+  namespace matrix_impl
+  {
+    void
+    check_permutation(const std::vector<std::size_t>& p, std::size_t n)
+    {
+      if (p.size() != n)
+        throw std::invalid_argument("permutation has the wrong size");
+      std::vector<char> seen(n, 0);
+      for (std::size_t x : p) {
+        if (x >= n || seen[x])
+          throw std::invalid_argument("invalid permutation");
+        seen[x] = 1;
+      }
+    }
+  } // namespace matrix_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                        Prebuilt Instantiations
+  //
+  // The instantiations declared in matrix.impl/instantiations.hpp.
+
+  template void
+  matrix_product(const matrix<double, 2>&, const matrix<double, 2>&,
+                 matrix<double, 2>&, plus_times);
+  template void
+  matrix_product(const matrix_ref<double, 2>&, const matrix_ref<double, 2>&,
+                 matrix<double, 2>&, plus_times);
+  template void
+  matrix_product(const matrix<float, 2>&, const matrix<float, 2>&,
+                 matrix<float, 2>&, plus_times);
+
+  template void
+  hadamard_product(const matrix<double, 2>&, const matrix<double, 2>&,
+                   matrix<double, 2>&);
+  template void
+  hadamard_product(const matrix<float, 2>&, const matrix<float, 2>&,
+                   matrix<float, 2>&);
+
+  namespace matrix_impl
+  {
+    template void
+    gemm(const product_tuning&, std::size_t, std::size_t, std::size_t,
+         const double*, std::size_t, const double*, std::size_t,
+         double*, std::size_t, plus_times);
+    template void
+    gemm(const product_tuning&, std::size_t, std::size_t, std::size_t,
+         const float*, std::size_t, const float*, std::size_t,
+         float*, std::size_t, plus_times);
+  } // namespace matrix_impl
+
+
+} // namespace origin
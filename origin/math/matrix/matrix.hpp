@@ -10,21 +10,51 @@
 
 
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <algorithm>
 #include <array>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#endif
 
 #include <origin/type/concepts.hpp>
+#include <origin/instrument/instrument.hpp>
 #include <origin/type/typestr.hpp>
 #include <origin/sequence/algorithm.hpp>
+#include <origin/memory/allocator.hpp>
+#include <origin/memory/usage.hpp>
 
 namespace origin
 {
   // Declarations
   struct slice;
   template <std::size_t N> class matrix_slice;
-  template <typename T, std::size_t N> class matrix;
+  template <typename T, std::size_t N, typename A = aligned_allocator<T>>
+    class matrix;
   template <typename T, std::size_t N> class matrix_ref;
+  template <typename T, std::size_t N> class dense_ref;
+  template <typename Op, typename L, typename R> class matrix_expr;
+  template <typename T, std::size_t R, std::size_t C> class small_matrix;
+  template <typename T, typename A = aligned_allocator<T>>
+    class column_major_matrix;
+  template <typename T, std::size_t B = 64, typename A = aligned_allocator<T>>
+    class tiled_matrix;
+  template <typename T, std::size_t N, typename A = aligned_allocator<T>>
+    class shared_matrix;
 
 
 // Type traits implementations
@@ -63,13 +93,66 @@ namespace origin
 #include "matrix.impl/iterator.hpp"
 #include "matrix.impl/support.hpp"
 
+// Element-wise kernels
+#include "matrix.impl/simd.hpp"
+#include "matrix.impl/kernels.hpp"
+
 // Matrix classes
+#include "matrix.impl/storage.hpp"
 #include "matrix.impl/matrix.hpp"
 #include "matrix.impl/matrix_ref.hpp"
 
+// Matrix expressions
+#include "matrix.impl/expression.hpp"
+
+// Column-major and tiled storage
+#include "matrix.impl/layout.hpp"
+
+// Copy-on-write shared storage
+#include "matrix.impl/shared.hpp"
+
+// Reduced precision element types
+#include "matrix.impl/precision.hpp"
+
+// Fixed-size matrices
+#include "matrix.impl/small_matrix.hpp"
+
+// Semirings of the matrix product
+#include "matrix.impl/semiring.hpp"
+
+// Blocked matrix product
+#include "matrix.impl/product.hpp"
+
 // Arithmetic and linear operations
 #include "matrix.impl/operations.hpp"
 
+// Row and column permutations
+#include "matrix.impl/permute.hpp"
+
+// Vector and matrix-vector kernels
+#include "matrix.impl/blas.hpp"
+
+// Reductions and broadcasting
+#include "matrix.impl/reduce.hpp"
+
+// Tensor contraction
+#include "matrix.impl/contract.hpp"
+
+// Stencils
+#include "matrix.impl/stencil.hpp"
+
+// Linear solvers
+#include "matrix.impl/lu.hpp"
+#include "matrix.impl/triangular.hpp"
+#include "matrix.impl/cholesky.hpp"
+#include "matrix.impl/qr.hpp"
+
+// Batches of small matrices
+#include "matrix.impl/batched.hpp"
+
+// Prebuilt instantiations
+#include "matrix.impl/instantiations.hpp"
+
 
 } // namespace origin
 
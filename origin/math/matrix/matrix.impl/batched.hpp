@@ -0,0 +1,466 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Batched matrices                                               [matrix.batch]
+//
+// A batched_matrix is a batch of many small matrices with the same extents,
+// such as the local systems of the vertices of a graph, stored in a single
+// block of memory. The batched operations apply the same operation to each
+// matrix of a batch:
+//
+//    batched_gemm(a, b, c)         -- Compute C[k] += A[k] * B[k]
+//    batched_lu_factor(a, piv)     -- Factor each A[k] in place
+//    batched_lu_solve(lu, piv, b)  -- Solve A[k] * X[k] = B[k] for each k
+//
+// The matrices are interleaved in groups of batch_lanes: element (i, j) of
+// the matrices of each group is stored contiguously. The operations process
+// a whole group at a time, so that each lane of a vector register (see
+// [matrix.simd]) computes a different matrix, and the loops over rows and
+// columns have no dependence on the extents. The last group is padded with
+// identity matrices, which are never visible, but keep the operations on
+// the padding finite. Large batches are processed in parallel by groups,
+// using up to product_threads() threads.
+//
+// Each matrix is factored with partial pivoting, as by lu_factor (see
+// [matrix.lu]). Since each lane selects its own pivots, the rows are
+// exchanged lane by lane; the elimination is vectorized. The pivots of
+// matrix k are stored in piv[k * n, (k + 1) * n) for n x n matrices.
+
+namespace matrix_impl
+{
+  // The number of matrices in each group of a batch. This is a multiple of
+  // the vector width of float and double on every target.
+  constexpr std::size_t batch_lanes = 8;
+
+  // The minimum number of elements in a batch that is processed in
+  // parallel.
+  constexpr std::size_t parallel_batch = 1 << 16;
+
+} // namespace matrix_impl
+
+
+// The batched matrix class.
+//
+// Template Parameters:
+//    T -- The element type stored by the matrices
+template <typename T>
+  class batched_matrix
+  {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr std::size_t lanes = matrix_impl::batch_lanes;
+
+    // Default construction
+    //
+    // Initialize an empty batch.
+    batched_matrix() : count_(0), rows_(0), cols_(0) { }
+
+    // Extent initialization
+    //
+    // Initialize a batch of n matrices of r x c zeros.
+    batched_matrix(std::size_t n, std::size_t r, std::size_t c);
+
+
+    // Properties
+
+    // Returns the number of matrices in the batch.
+    std::size_t size() const { return count_; }
+
+    // Returns the extents of each matrix.
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+
+    // Returns the number of groups of matrices.
+    std::size_t groups() const { return (count_ + lanes - 1) / lanes; }
+
+    // Returns the footprint of the elements, including the padding of the
+    // last group, which is slack. See [mem.usage].
+    memory_footprint memory_usage() const
+    {
+      return {count_ * rows_ * cols_ * sizeof(T), elems_.size() * sizeof(T)};
+    }
+
+
+    // Element access
+    //
+    // Returns the element (i, j) of the kth matrix.
+    T& operator()(std::size_t k, std::size_t i, std::size_t j)
+    {
+      return elems_[offset(k, i, j)];
+    }
+
+    const T& operator()(std::size_t k, std::size_t i, std::size_t j) const
+    {
+      return elems_[offset(k, i, j)];
+    }
+
+    // Copy the 2D matrix m into the kth matrix.
+    template <typename M>
+      void assign(std::size_t k, const M& m);
+
+    // Returns a copy of the kth matrix.
+    matrix<T, 2> get(std::size_t k) const;
+
+
+    // Data access
+    //
+    // Returns a pointer to the elements of the gth group. Element (i, j) of
+    // the matrix in lane l is at (i * cols() + j) * lanes + l.
+    T* group(std::size_t g) { return elems_.data() + g * group_size(); }
+    const T* group(std::size_t g) const
+    {
+      return elems_.data() + g * group_size();
+    }
+
+  private:
+    std::size_t group_size() const { return rows_ * cols_ * lanes; }
+
+    std::size_t offset(std::size_t k, std::size_t i, std::size_t j) const
+    {
+      assert(k < count_ && i < rows_ && j < cols_);
+      return (k / lanes) * group_size() + (i * cols_ + j) * lanes + k % lanes;
+    }
+
+  private:
+    std::size_t count_;
+    std::size_t rows_;
+    std::size_t cols_;
+    std::vector<T> elems_;
+  };
+
+template <typename T>
+  constexpr std::size_t batched_matrix<T>::lanes;
+
+template <typename T>
+  batched_matrix<T>::batched_matrix(std::size_t n, std::size_t r,
+                                    std::size_t c)
+    : count_(n), rows_(r), cols_(c), elems_(groups() * r * c * lanes, T(0))
+  {
+    // Pad the last group with identity matrices.
+    if (n % lanes != 0) {
+      T* p = group(groups() - 1);
+      for (std::size_t i = 0; i < std::min(r, c); ++i)
+        for (std::size_t l = n % lanes; l != lanes; ++l)
+          p[(i * c + i) * lanes + l] = T(1);
+    }
+  }
+
+template <typename T>
+  template <typename M>
+    void
+    batched_matrix<T>::assign(std::size_t k, const M& m)
+    {
+      assert(m.rows() == rows_ && m.cols() == cols_);
+      for (std::size_t i = 0; i != rows_; ++i)
+        for (std::size_t j = 0; j != cols_; ++j)
+          (*this)(k, i, j) = m(i, j);
+    }
+
+template <typename T>
+  matrix<T, 2>
+  batched_matrix<T>::get(std::size_t k) const
+  {
+    matrix<T, 2> m(rows_, cols_);
+    for (std::size_t i = 0; i != rows_; ++i)
+      for (std::size_t j = 0; j != cols_; ++j)
+        m(i, j) = (*this)(k, i, j);
+    return m;
+  }
+
+
+namespace matrix_impl
+{
+  // Lane operations
+  //
+  // Each operation applies to the batch_lanes lanes of its operands, which
+  // are contiguous.
+
+  // Compute c -= a * b.
+  template <typename T>
+    inline Requires<Simd_type<T>(), void>
+    lanes_sub_mul(const T* a, const T* b, T* c)
+    {
+      using V = simd_traits<T>;
+      static_assert(batch_lanes % V::width == 0, "");
+      for (std::size_t l = 0; l != batch_lanes; l += V::width) {
+        typename V::type x = V::mul(V::load(a + l), V::load(b + l));
+        V::store(c + l, V::sub(V::load(c + l), x));
+      }
+    }
+
+  template <typename T>
+    inline Requires<!Simd_type<T>(), void>
+    lanes_sub_mul(const T* a, const T* b, T* c)
+    {
+      for (std::size_t l = 0; l != batch_lanes; ++l)
+        c[l] -= a[l] * b[l];
+    }
+
+  // Compute a *= b.
+  template <typename T>
+    inline Requires<Simd_type<T>(), void>
+    lanes_mul(T* a, const T* b)
+    {
+      using V = simd_traits<T>;
+      static_assert(batch_lanes % V::width == 0, "");
+      for (std::size_t l = 0; l != batch_lanes; l += V::width)
+        V::store(a + l, V::mul(V::load(a + l), V::load(b + l)));
+    }
+
+  template <typename T>
+    inline Requires<!Simd_type<T>(), void>
+    lanes_mul(T* a, const T* b)
+    {
+      for (std::size_t l = 0; l != batch_lanes; ++l)
+        a[l] *= b[l];
+    }
+
+
+  // Compute C += A * B for a group of m x k matrices A and k x n matrices
+  // B. Each element of C is accumulated in registers.
+  template <typename T>
+    Requires<Simd_type<T>(), void>
+    batch_gemm_group(std::size_t m, std::size_t n, std::size_t k,
+                     const T* a, const T* b, T* c)
+    {
+      using V = simd_traits<T>;
+      static_assert(batch_lanes % V::width == 0, "");
+      constexpr std::size_t R = batch_lanes / V::width;
+      constexpr std::size_t L = batch_lanes;
+      typename V::type acc[R];
+      for (std::size_t i = 0; i != m; ++i) {
+        for (std::size_t j = 0; j != n; ++j) {
+          T* cij = c + (i * n + j) * L;
+          for (std::size_t r = 0; r != R; ++r)
+            acc[r] = V::load(cij + r * V::width);
+          for (std::size_t p = 0; p != k; ++p) {
+            const T* aip = a + (i * k + p) * L;
+            const T* bpj = b + (p * n + j) * L;
+            for (std::size_t r = 0; r != R; ++r)
+              acc[r] = V::madd(V::load(aip + r * V::width),
+                               V::load(bpj + r * V::width), acc[r]);
+          }
+          for (std::size_t r = 0; r != R; ++r)
+            V::store(cij + r * V::width, acc[r]);
+        }
+      }
+    }
+
+  template <typename T>
+    Requires<!Simd_type<T>(), void>
+    batch_gemm_group(std::size_t m, std::size_t n, std::size_t k,
+                     const T* a, const T* b, T* c)
+    {
+      constexpr std::size_t L = batch_lanes;
+      for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t p = 0; p != k; ++p)
+          for (std::size_t j = 0; j != n; ++j)
+            for (std::size_t l = 0; l != L; ++l)
+              c[(i * n + j) * L + l] += a[(i * k + p) * L + l]
+                                      * b[(p * n + j) * L + l];
+    }
+
+
+  // Factor a group of n x n matrices in place, storing the pivots of lane
+  // l in piv[l * n, (l + 1) * n). Returns the lanes whose matrices are
+  // singular as a bit mask.
+  template <typename T>
+    unsigned
+    batch_lu_group(std::size_t n, T* a, std::size_t* piv)
+    {
+      constexpr std::size_t L = batch_lanes;
+      unsigned singular = 0;
+      T f[L];
+      T inv[L];
+      for (std::size_t c = 0; c != n; ++c) {
+        // Select the pivot of each lane, and exchange its rows.
+        for (std::size_t l = 0; l != L; ++l) {
+          std::size_t p = c;
+          T big = std::abs(a[(c * n + c) * L + l]);
+          for (std::size_t r = c + 1; r != n; ++r) {
+            T x = std::abs(a[(r * n + c) * L + l]);
+            if (big < x) {
+              big = x;
+              p = r;
+            }
+          }
+          piv[l * n + c] = p;
+          if (p != c)
+            for (std::size_t j = 0; j != n; ++j)
+              std::swap(a[(c * n + j) * L + l], a[(p * n + j) * L + l]);
+
+          // A zero pivot leaves its column uneliminated.
+          T d = a[(c * n + c) * L + l];
+          if (d == T(0)) {
+            singular |= 1u << l;
+            inv[l] = T(0);
+          } else {
+            inv[l] = T(1) / d;
+          }
+        }
+
+        // Eliminate the column below the diagonal in every lane.
+        const T* u = a + c * n * L;
+        for (std::size_t r = c + 1; r != n; ++r) {
+          T* x = a + r * n * L;
+          lanes_mul(x + c * L, inv);
+          for (std::size_t l = 0; l != L; ++l)
+            f[l] = x[c * L + l];
+          for (std::size_t j = c + 1; j != n; ++j)
+            lanes_sub_mul(f, u + j * L, x + j * L);
+        }
+      }
+      return singular;
+    }
+
+  // Solve A * X = B for a group of factored n x n matrices A and n x m
+  // right-hand sides B, which are overwritten by X.
+  template <typename T>
+    void
+    batch_solve_group(std::size_t n, const T* lu, const std::size_t* piv,
+                      std::size_t m, T* b, std::size_t lanes)
+    {
+      constexpr std::size_t L = batch_lanes;
+
+      // Apply the row exchanges of each lane.
+      for (std::size_t l = 0; l != lanes; ++l)
+        for (std::size_t c = 0; c != n; ++c)
+          if (piv[l * n + c] != c)
+            for (std::size_t j = 0; j != m; ++j)
+              std::swap(b[(c * m + j) * L + l],
+                        b[(piv[l * n + c] * m + j) * L + l]);
+
+      // Solve L * Y = B, where L has a unit diagonal.
+      for (std::size_t i = 1; i < n; ++i)
+        for (std::size_t k = 0; k != i; ++k)
+          for (std::size_t j = 0; j != m; ++j)
+            lanes_sub_mul(lu + (i * n + k) * L, b + (k * m + j) * L,
+                          b + (i * m + j) * L);
+
+      // Solve U * X = Y.
+      T inv[L];
+      for (std::size_t i = n; i-- != 0; ) {
+        for (std::size_t k = i + 1; k != n; ++k)
+          for (std::size_t j = 0; j != m; ++j)
+            lanes_sub_mul(lu + (i * n + k) * L, b + (k * m + j) * L,
+                          b + (i * m + j) * L);
+        for (std::size_t l = 0; l != L; ++l)
+          inv[l] = T(1) / lu[(i * n + i) * L + l];
+        for (std::size_t j = 0; j != m; ++j)
+          lanes_mul(b + (i * m + j) * L, inv);
+      }
+    }
+
+  // Call f(g) for each of the groups of a batch whose matrices have the
+  // given number of elements, in parallel if the batch is large.
+  template <typename F>
+    void
+    for_each_group(std::size_t groups, std::size_t elems, F f)
+    {
+      std::size_t threads = product_threads();
+      if (threads > 1 && groups * batch_lanes * elems >= parallel_batch) {
+        std::size_t blocks = std::min(groups, threads * 4);
+        std::size_t step = (groups + blocks - 1) / blocks;
+        parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t last = std::min(groups, (k + 1) * step);
+          for (std::size_t g = k * step; g < last; ++g)
+            f(g);
+        });
+      } else {
+        for (std::size_t g = 0; g != groups; ++g)
+          f(g);
+      }
+    }
+
+} // namespace matrix_impl
+
+
+// Compute c[k] += a[k] * b[k] for each matrix of the batches, which have
+// the same size.
+template <typename T>
+  void
+  batched_gemm(const batched_matrix<T>& a,
+               const batched_matrix<T>& b,
+               batched_matrix<T>& c)
+  {
+    assert(a.size() == b.size() && a.size() == c.size());
+    assert(a.cols() == b.rows());
+    assert(a.rows() == c.rows() && b.cols() == c.cols());
+    ORIGIN_TIME_SCOPE("matrix.batched_gemm");
+
+    std::size_t m = a.rows(), n = b.cols(), k = a.cols();
+    matrix_impl::for_each_group(a.groups(), m * n * k, [&](std::size_t g) {
+      matrix_impl::batch_gemm_group(m, n, k, a.group(g), b.group(g),
+                                    c.group(g));
+    });
+  }
+
+
+// Factor each square matrix of the batch a in place, storing the row
+// exchanges of the kth matrix in piv[k * n, (k + 1) * n), where n is the
+// order of the matrices. Returns false if any matrix is singular; the other
+// matrices are factored regardless.
+template <typename T>
+  bool
+  batched_lu_factor(batched_matrix<T>& a, std::vector<std::size_t>& piv)
+  {
+    static_assert(std::is_floating_point<T>::value, "");
+    assert(a.rows() == a.cols());
+    ORIGIN_TIME_SCOPE("matrix.batched_lu");
+
+    constexpr std::size_t L = matrix_impl::batch_lanes;
+    std::size_t n = a.rows();
+    std::size_t groups = a.groups();
+    piv.resize(groups * L * n);
+    std::vector<unsigned> singular(groups);
+    matrix_impl::for_each_group(groups, n * n * n, [&](std::size_t g) {
+      singular[g] = matrix_impl::batch_lu_group(n, a.group(g),
+                                                piv.data() + g * L * n);
+    });
+    piv.resize(a.size() * n);
+
+    // The padding of the last group is not a matrix of the batch.
+    if (a.size() % L != 0)
+      singular.back() &= (1u << (a.size() % L)) - 1;
+    for (unsigned s : singular)
+      if (s)
+        return false;
+    return true;
+  }
+
+
+// Solve A[k] * X[k] = B[k] for each matrix of the batch b, given the
+// factors lu and pivots piv computed by batched_lu_factor. The batch b is
+// overwritten by the solutions, and may have any number of columns.
+template <typename T>
+  void
+  batched_lu_solve(const batched_matrix<T>& lu,
+                   const std::vector<std::size_t>& piv,
+                   batched_matrix<T>& b)
+  {
+    assert(lu.rows() == lu.cols());
+    assert(lu.size() == b.size() && lu.rows() == b.rows());
+    assert(piv.size() == lu.size() * lu.rows());
+    ORIGIN_TIME_SCOPE("matrix.batched_solve");
+
+    constexpr std::size_t L = matrix_impl::batch_lanes;
+    std::size_t n = lu.rows();
+    std::size_t m = b.cols();
+    std::size_t count = lu.size();
+    matrix_impl::for_each_group(lu.groups(), n * n * m, [&](std::size_t g) {
+      std::size_t lanes = std::min(L, count - g * L);
+      matrix_impl::batch_solve_group(n, lu.group(g), piv.data() + g * L * n,
+                                     m, b.group(g), lanes);
+    });
+  }
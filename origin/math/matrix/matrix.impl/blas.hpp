@@ -0,0 +1,487 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Vector kernels                                                  [matrix.blas]
+//
+// The following operations are the level 1 and level 2 kernels of the BLAS,
+// the building blocks of iterative methods such as conjugate gradient and
+// power iteration. Vectors are 1D matrices or matrix_refs (e.g., the rows
+// and columns of a 2D matrix), and may have any stride.
+//
+//    dot(x, y)       -- Returns the sum of x(i) * y(i)
+//    axpy(a, x, y)   -- Compute y += a * x
+//    nrm2(x)         -- Returns the Euclidean norm of x
+//    asum(x)         -- Returns the sum of |x(i)|
+//    iamax(x)        -- Returns the index of the first largest |x(i)|
+//    gemv(a, x, y)   -- Compute y += a * x, for a 2D matrix a
+//
+// Like matrix_product, gemv accumulates into its output; zero y first to
+// compute the product alone. The output of axpy and gemv must not overlap
+// their other operands.
+//
+// When the elements of a vector are contiguous and its value type has
+// vector support (see [matrix.simd]), the kernels process it with vector
+// instructions, using fused multiply-adds where the target has them. The
+// sums are accumulated in several registers, so that they may differ from
+// a sequential sum by rounding.
+//
+// A gemv whose matrix has contiguous rows computes each element of y as the
+// dot product of a row and x; one whose matrix has contiguous columns (such
+// as the transpose of a matrix) adds each column, scaled by an element of
+// x, to y. Large products are divided into blocks of rows that are computed
+// in parallel by up to product_threads() threads.
+//
+// nrm2 sums the squares of the elements directly. If that sum overflows or
+// underflows, the norm is recomputed from the elements scaled by the
+// largest of them.
+
+namespace matrix_impl
+{
+  // The minimum number of elements of the matrix of a matrix-vector product
+  // that is computed in parallel.
+  constexpr std::size_t parallel_gemv = 512 * 512;
+
+
+  // Returns the sum of the lanes of the register v.
+  template <typename T>
+    inline T
+    reduce_add(typename simd_traits<T>::type v)
+    {
+      using V = simd_traits<T>;
+      T lanes[V::width];
+      V::store(lanes, v);
+      T s = 0;
+      for (std::size_t i = 0; i != V::width; ++i)
+        s += lanes[i];
+      return s;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Dot Product
+  //
+  // Returns the sum of x[i] * y[i] for the n elements of arrays x and y.
+
+  template <typename T>
+    inline Requires<!Simd_type<T>(), Accumulator_type<T>>
+    dot_n(const T* x, const T* y, std::size_t n)
+    {
+      using R = Accumulator_type<T>;
+      R s = 0;
+      for (std::size_t i = 0; i != n; ++i)
+        s += R(x[i]) * R(y[i]);
+      return s;
+    }
+
+  template <typename T>
+    inline Requires<Simd_type<T>(), T>
+    dot_n(const T* x, const T* y, std::size_t n)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      Reg a = V::broadcast(0);
+      Reg b = V::broadcast(0);
+      std::size_t i = 0;
+      for ( ; i + 2 * W <= n; i += 2 * W) {
+        a = V::madd(V::load(x + i), V::load(y + i), a);
+        b = V::madd(V::load(x + i + W), V::load(y + i + W), b);
+      }
+      for ( ; i + W <= n; i += W)
+        a = V::madd(V::load(x + i), V::load(y + i), a);
+      T s = reduce_add<T>(V::add(a, b));
+      for ( ; i != n; ++i)
+        s += x[i] * y[i];
+      return s;
+    }
+
+  // The elements of half and bfloat16 arrays are converted to float in
+  // blocks, whose dot products are computed with vector instructions.
+  template <typename T>
+    inline float
+    reduced_dot_n(const T* x, const T* y, std::size_t n)
+    {
+      float a[convert_block];
+      float b[convert_block];
+      float s = 0;
+      for (std::size_t i = 0; i < n; i += convert_block) {
+        std::size_t m = std::min(convert_block, n - i);
+        convert_n(x + i, a, m);
+        convert_n(y + i, b, m);
+        s += dot_n(a, b, m);
+      }
+      return s;
+    }
+
+  inline float
+  dot_n(const half* x, const half* y, std::size_t n)
+  {
+    return reduced_dot_n(x, y, n);
+  }
+
+  inline float
+  dot_n(const bfloat16* x, const bfloat16* y, std::size_t n)
+  {
+    return reduced_dot_n(x, y, n);
+  }
+
+  // Returns the dot product of the n elements of x and y, which have the
+  // strides incx and incy.
+  template <typename T>
+    inline Accumulator_type<T>
+    dot_n(const T* x, std::size_t incx, const T* y, std::size_t incy,
+          std::size_t n)
+    {
+      using R = Accumulator_type<T>;
+      if (incx == 1 && incy == 1)
+        return dot_n(x, y, n);
+      R s = 0;
+      for (std::size_t i = 0; i != n; ++i)
+        s += R(x[i * incx]) * R(y[i * incy]);
+      return s;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Scaled Addition
+  //
+  // Compute y[i] += a * x[i] for the n elements of the arrays x and y.
+
+  template <typename T>
+    inline Requires<!Simd_type<T>(), void>
+    axpy_n(const T& a, const T* x, T* y, std::size_t n)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        y[i] += a * x[i];
+    }
+
+  template <typename T>
+    inline Requires<Simd_type<T>(), void>
+    axpy_n(const T& a, const T* x, T* y, std::size_t n)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      Reg s = V::broadcast(a);
+      std::size_t i = 0;
+      for ( ; i + 2 * W <= n; i += 2 * W) {
+        Reg c = V::madd(s, V::load(x + i), V::load(y + i));
+        Reg d = V::madd(s, V::load(x + i + W), V::load(y + i + W));
+        V::store(y + i, c);
+        V::store(y + i + W, d);
+      }
+      for ( ; i + W <= n; i += W)
+        V::store(y + i, V::madd(s, V::load(x + i), V::load(y + i)));
+      for ( ; i != n; ++i)
+        y[i] += a * x[i];
+    }
+
+  template <typename T>
+    inline void
+    axpy_n(const T& a, const T* x, std::size_t incx, T* y, std::size_t incy,
+           std::size_t n)
+    {
+      if (incx == 1 && incy == 1)
+        return axpy_n(a, x, y, n);
+      for (std::size_t i = 0; i != n; ++i)
+        y[i * incy] += a * x[i * incx];
+    }
+
+  // Compute y += a * x, where the elements of x have a reduced precision and
+  // those of y its accumulator type. Contiguous elements are converted in
+  // blocks, which are added with the kernel of T.
+  template <typename S, typename T>
+    inline Requires<!Same<S, T>(), void>
+    axpy_n(const T& a, const S* x, std::size_t incx, T* y, std::size_t incy,
+           std::size_t n)
+    {
+      if (incx == 1 && incy == 1) {
+        T b[convert_block];
+        for (std::size_t i = 0; i < n; i += convert_block) {
+          std::size_t m = std::min(convert_block, n - i);
+          convert_n(x + i, b, m);
+          axpy_n(a, b, y + i, m);
+        }
+        return;
+      }
+      for (std::size_t i = 0; i != n; ++i)
+        y[i * incy] += a * T(x[i * incx]);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Absolute Values
+  //
+  // Returns the sum of |x[i]| for the n elements of the array x.
+
+  template <typename T>
+    inline T
+    abs_value(const T& x)
+    {
+      return x < T(0) ? -x : x;
+    }
+
+  template <typename T>
+    inline Requires<!Simd_type<T>(), T>
+    asum_n(const T* x, std::size_t n)
+    {
+      T s = 0;
+      for (std::size_t i = 0; i != n; ++i)
+        s += abs_value(x[i]);
+      return s;
+    }
+
+  template <typename T>
+    inline Requires<Simd_type<T>(), T>
+    asum_n(const T* x, std::size_t n)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      Reg a = V::broadcast(0);
+      Reg b = V::broadcast(0);
+      std::size_t i = 0;
+      for ( ; i + 2 * W <= n; i += 2 * W) {
+        a = V::add(a, V::abs(V::load(x + i)));
+        b = V::add(b, V::abs(V::load(x + i + W)));
+      }
+      for ( ; i + W <= n; i += W)
+        a = V::add(a, V::abs(V::load(x + i)));
+      T s = reduce_add<T>(V::add(a, b));
+      for ( ; i != n; ++i)
+        s += abs_value(x[i]);
+      return s;
+    }
+
+  template <typename T>
+    inline T
+    asum_n(const T* x, std::size_t incx, std::size_t n)
+    {
+      if (incx == 1)
+        return asum_n(x, n);
+      T s = 0;
+      for (std::size_t i = 0; i != n; ++i)
+        s += abs_value(x[i * incx]);
+      return s;
+    }
+
+  // Returns the index of the first of the n elements of x, with stride incx,
+  // whose absolute value is greatest, or 0 if n is 0.
+  template <typename T>
+    std::size_t
+    iamax_n(const T* x, std::size_t incx, std::size_t n)
+    {
+      std::size_t k = 0;
+      T m = n ? abs_value(x[0]) : T(0);
+      for (std::size_t i = 1; i < n; ++i) {
+        T a = abs_value(x[i * incx]);
+        if (m < a) {
+          m = a;
+          k = i;
+        }
+      }
+      return k;
+    }
+
+  // Returns the Euclidean norm of the n elements of x, with stride incx.
+  template <typename T>
+    T
+    nrm2_n(const T* x, std::size_t incx, std::size_t n)
+    {
+      static_assert(Floating_point<T>(), "");
+      T s = dot_n(x, incx, x, incx, n);
+      if (s >= std::numeric_limits<T>::min() &&
+          s <= std::numeric_limits<T>::max())
+        return std::sqrt(s);
+
+      // The sum is 0, infinite, not a number, or denormal. Scale the
+      // elements by the largest of them.
+      T scale = n ? abs_value(x[iamax_n(x, incx, n) * incx]) : T(0);
+      if (scale == T(0) || !(scale <= std::numeric_limits<T>::max()))
+        return scale;
+      s = 0;
+      for (std::size_t i = 0; i != n; ++i) {
+        T y = x[i * incx] / scale;
+        s += y * y;
+      }
+      return scale * std::sqrt(s);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                         Matrix-Vector Product
+  //
+  // Compute the rows [first, last) of y += a * x, where a is m x n with row
+  // and column strides (rs, cs), and x and y have the strides incx and incy.
+  // The elements of y have the type of a and x or its accumulator type.
+
+  template <typename S, typename T>
+    void
+    gemv_rows(std::size_t first, std::size_t last, std::size_t n,
+              const S* a, std::size_t rs, std::size_t cs,
+              const S* x, std::size_t incx,
+              T* y, std::size_t incy)
+    {
+      if (cs == 1 || rs != 1) {
+        // The rows are contiguous, or neither rows nor columns are.
+        for (std::size_t i = first; i != last; ++i)
+          y[i * incy] += dot_n(a + i * rs, cs, x, incx, n);
+      } else {
+        // The columns are contiguous.
+        std::size_t m = last - first;
+        for (std::size_t j = 0; j != n; ++j)
+          axpy_n(T(x[j * incx]), a + first + j * cs, 1,
+                 y + first * incy, incy, m);
+      }
+    }
+
+  template <typename S, typename T>
+    void
+    gemv(std::size_t m, std::size_t n,
+         const S* a, std::size_t rs, std::size_t cs,
+         const S* x, std::size_t incx,
+         T* y, std::size_t incy)
+    {
+      std::size_t threads = product_threads();
+      if (threads < 2 || m < 2 || m * n < parallel_gemv) {
+        gemv_rows(0, m, n, a, rs, cs, x, incx, y, incy);
+        return;
+      }
+      std::size_t step = (m + threads - 1) / threads;
+      std::size_t blocks = (m + step - 1) / step;
+      parallel_for(blocks, threads, [=](std::size_t b) {
+        std::size_t i = b * step;
+        gemv_rows(i, std::min(i + step, m), n, a, rs, cs, x, incx, y, incy);
+      });
+    }
+
+
+  // Returns the first element of the strided matrix m.
+  template <typename M>
+    inline auto
+    first_element(M& m) -> decltype(m.data())
+    {
+      return m.data() + m.descriptor().start;
+    }
+
+  // Returns true if M1 and M2 are strided vectors with the same value type.
+  template <typename M1, typename M2>
+    constexpr bool Strided_vectors()
+    {
+      return Strided_matrix<M1>() && Strided_matrix<M2>()
+          && M1::order == 1 && M2::order == 1
+          && Same<Value_type<M1>, Value_type<M2>>();
+    }
+
+  // Returns true if M1 and M2 are strided vectors, and the value type of M2
+  // is that of M1 or its accumulator type.
+  template <typename M1, typename M2>
+    constexpr bool Accumulating_vectors()
+    {
+      return Strided_matrix<M1>() && Strided_matrix<M2>()
+          && M1::order == 1 && M2::order == 1
+          && Accumulates_to<Value_type<M1>, Value_type<M2>>();
+    }
+
+} // namespace matrix_impl
+
+
+// Returns the dot product of the vectors x and y, which have the same size.
+// The sum is computed in the accumulator type of their value type (see
+// [matrix.precision]).
+template <typename M1, typename M2>
+  inline Requires<
+    matrix_impl::Strided_vectors<M1, M2>(), Accumulator_type<Value_type<M1>>
+  >
+  dot(const M1& x, const M2& y)
+  {
+    assert(x.size() == y.size());
+    return matrix_impl::dot_n(matrix_impl::first_element(x),
+                              x.descriptor().strides[0],
+                              matrix_impl::first_element(y),
+                              y.descriptor().strides[0],
+                              x.size());
+  }
+
+// Compute y += a * x, where x and y have the same size. Note that y may be
+// a matrix_ref, which is passed by value.
+template <typename M1, typename M2>
+  inline Requires<
+    matrix_impl::Strided_vectors<M1, Remove_reference<M2>>(), void
+  >
+  axpy(const Value_type<M1>& a, const M1& x, M2&& y)
+  {
+    assert(x.size() == y.size());
+    matrix_impl::axpy_n(a, matrix_impl::first_element(x),
+                        x.descriptor().strides[0],
+                        matrix_impl::first_element(y),
+                        y.descriptor().strides[0],
+                        x.size());
+  }
+
+// Returns the Euclidean norm of the vector x, whose value type is a floating
+// point type.
+template <typename M>
+  inline Requires<matrix_impl::Strided_vectors<M, M>(), Value_type<M>>
+  nrm2(const M& x)
+  {
+    return matrix_impl::nrm2_n(matrix_impl::first_element(x),
+                               x.descriptor().strides[0], x.size());
+  }
+
+// Returns the sum of the absolute values of the elements of x.
+template <typename M>
+  inline Requires<matrix_impl::Strided_vectors<M, M>(), Value_type<M>>
+  asum(const M& x)
+  {
+    return matrix_impl::asum_n(matrix_impl::first_element(x),
+                               x.descriptor().strides[0], x.size());
+  }
+
+// Returns the index of the first element of x with the greatest absolute
+// value, or 0 if x is empty.
+template <typename M>
+  inline Requires<matrix_impl::Strided_vectors<M, M>(), std::size_t>
+  iamax(const M& x)
+  {
+    return matrix_impl::iamax_n(matrix_impl::first_element(x),
+                                x.descriptor().strides[0], x.size());
+  }
+
+// Compute y += a * x, where a is an m x n matrix, x has n elements, and y
+// has m elements. The value type of y is that of a and x, or its
+// accumulator type.
+template <typename M1, typename M2, typename M3>
+  Requires<
+    matrix_impl::Accumulating_vectors<M2, Remove_reference<M3>>(), void
+  >
+  gemv(const M1& a, const M2& x, M3&& y)
+  {
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(Same<Value_type<M1>, Value_type<M2>>(), "");
+    assert(a.extent(1) == x.size());
+    assert(a.extent(0) == y.size());
+    ORIGIN_TIME_SCOPE("matrix.gemv");
+
+    const matrix_slice<2>& s = a.descriptor();
+    matrix_impl::gemv(s.extents[0], s.extents[1],
+                      matrix_impl::first_element(a),
+                      s.strides[0], s.strides[1],
+                      matrix_impl::first_element(x),
+                      x.descriptor().strides[0],
+                      matrix_impl::first_element(y),
+                      y.descriptor().strides[0]);
+  }
@@ -0,0 +1,139 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Cholesky factorization                                      [matrix.cholesky]
+//
+// The Cholesky factorization of a symmetric positive definite matrix A is
+// A = L * L^T, where L is lower triangular with a positive diagonal. Only
+// the lower triangle of A is read. The factorization is computed in place:
+//
+//    if (cholesky_factor(a))     // a = L
+//      cholesky_solve(a, b);     // b = inv(A) * b
+//
+// The factorization is blocked and right-looking, like that of LU (see
+// [matrix.lu]). Each panel of columns is factored, and the trailing lower
+// triangle is updated by A22 -= L21 * L21^T. The update is computed in row
+// blocks by the blocked (and possibly parallel) product kernel, so that
+// little of the upper triangle is computed.
+
+namespace matrix_impl
+{
+  // The number of rows in each block of the trailing update.
+  constexpr std::size_t cholesky_rows = 4 * lu_block;
+
+  // Factor the panel of columns [j, j + jb) of the n x n matrix a, whose
+  // columns to the left have already been applied. Returns false if the
+  // matrix is not positive definite.
+  template <typename T>
+    bool
+    cholesky_panel(std::size_t n, T* a, std::size_t rs, std::size_t cs,
+                   std::size_t j, std::size_t jb)
+    {
+      for (std::size_t c = j; c != j + jb; ++c) {
+        T* lc = a + c * rs + j * cs;
+        T d = a[c * rs + c * cs] - dot_n(lc, cs, lc, cs, c - j);
+        if (!(d > T(0)))
+          return false;
+        d = std::sqrt(d);
+        a[c * rs + c * cs] = d;
+        for (std::size_t r = c + 1; r != n; ++r) {
+          T* lr = a + r * rs + j * cs;
+          lr[(c - j) * cs] = (lr[(c - j) * cs] - dot_n(lr, cs, lc, cs, c - j))
+                           / d;
+        }
+      }
+      return true;
+    }
+
+  // Compute the lower triangle of A22 -= L21 * L21^T, where L21 is the
+  // n2 x jb block below the panel [j, j + jb) of a.
+  template <typename T>
+    void
+    cholesky_update(std::size_t n, T* a, std::size_t rs, std::size_t cs,
+                    std::size_t j, std::size_t jb)
+    {
+      std::size_t j2 = j + jb;
+      std::size_t n2 = n - j2;
+      const T* l21 = a + j2 * rs + j * cs;
+      T* a22 = a + j2 * rs + j2 * cs;
+
+      // Copy L21^T once, so that each row block of the update reads its
+      // right operand from contiguous rows.
+      scratch_buffer<T> t(jb * n2);
+      for (std::size_t r = 0; r != n2; ++r)
+        for (std::size_t k = 0; k != jb; ++k)
+          t[k * n2 + r] = l21[r * rs + k * cs];
+
+      for (std::size_t r = 0; r < n2; r += cholesky_rows) {
+        std::size_t rb = std::min(cholesky_rows, n2 - r);
+        gemm_minus(rb, r + rb, jb, l21 + r * rs, rs, cs,
+                   t.data(), n2, std::size_t(1), a22 + r * rs, rs, cs);
+      }
+    }
+
+  // Factor the n x n matrix a in place. Returns false if a is not positive
+  // definite.
+  template <typename T>
+    bool
+    cholesky_factor(std::size_t n, T* a, std::size_t rs, std::size_t cs)
+    {
+      for (std::size_t j = 0; j < n; j += lu_block) {
+        std::size_t jb = std::min(lu_block, n - j);
+        if (!cholesky_panel(n, a, rs, cs, j, jb))
+          return false;
+        cholesky_update(n, a, rs, cs, j, jb);
+      }
+
+      // The update overwrites parts of the upper triangle; clear it.
+      for (std::size_t r = 0; r != n; ++r)
+        for (std::size_t c = r + 1; c != n; ++c)
+          a[r * rs + c * cs] = T(0);
+      return true;
+    }
+
+} // namespace matrix_impl
+
+
+// Factor the symmetric positive definite matrix a in place, so that a holds
+// the lower triangular factor L, and its strict upper triangle is zero.
+// Returns false if a is not positive definite, in which case the contents
+// of a are unspecified.
+//
+// The matrix a must be a matrix or matrix_ref of order 2 with a floating
+// point value type.
+template <typename M>
+  bool
+  cholesky_factor(M& a)
+  {
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    static_assert(M::order == 2, "");
+    static_assert(std::is_floating_point<Value_type<M>>::value, "");
+    assert(a.rows() == a.cols());
+    ORIGIN_TIME_SCOPE("matrix.cholesky");
+
+    const matrix_slice<2>& d = a.descriptor();
+    return matrix_impl::cholesky_factor(a.rows(), a.data() + d.start,
+                                        d.strides[0], d.strides[1]);
+  }
+
+
+// Solve the system A * x = b for x given the factor l of A computed by
+// cholesky_factor. The right-hand side b is overwritten by the solution. If
+// b is a matrix, each of its columns is a separate right-hand side.
+template <typename M1, typename M2>
+  void
+  cholesky_solve(const M1& l, M2& b)
+  {
+    static_assert(M1::order == 2, "");
+    trsm(l, triangle::lower, b);
+    trsm(transpose(l), triangle::upper, b);
+  }
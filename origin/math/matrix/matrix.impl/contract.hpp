@@ -0,0 +1,522 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Tensor contraction                                          [matrix.contract]
+//
+// A contraction multiplies matrices of any order, summing over the indexes
+// that they share. It is described in the notation of Einstein summation,
+// as by numpy.einsum: each operand is labeled by a letter for each of its
+// dimensions, and the result by the labels that it keeps.
+//
+//    contract<2>("ij,jk->ik", a, b)     -- The matrix product
+//    contract<3>("bij,bjk->bik", a, b)  -- A batch of matrix products
+//    contract<2>("ijk,jkl->il", a, b)   -- Summing over j and k
+//    contract<2>("ij,jk,kl->il", a, b, c)
+//    contract<0>("ii", a)               -- The trace of a
+//    contract<2>("ij->ji", a)           -- The transpose of a
+//
+// The result is a matrix of the order given as the template argument,
+// which must be the number of labels of the result. If the arrow and the
+// result are omitted, the result has the labels that occur once, in
+// alphabetical order. A label repeated in an operand selects its diagonal,
+// and a label of one operand that the result does not keep is summed.
+// Each operand is a matrix or matrix_ref, and all have the same value type.
+// If the notation is malformed, does not match the orders of the operands,
+// or gives a label different extents, std::invalid_argument is thrown.
+//
+// Each pair of operands is contracted by the blocked product (see
+// [matrix.product]): their labels are grouped into the batch labels, which
+// both operands and the result have; the free labels of each operand,
+// which the result keeps; and the summed labels. Each group becomes one
+// dimension of a matrix, so that for each index of the batch, the pair is
+// the product of an m x k and a k x n matrix. The grouping is a view when
+// the strides of an operand allow it, as they do for the dimensions of a
+// matrix taken in order, and otherwise the operand is copied into that
+// order. The result is written directly to its matrix when the labels of
+// the result are in the order of the groups, as they are in a batched
+// product.
+//
+// A contraction of more than two operands is computed as a sequence of
+// pairwise contractions. The pair contracted next is the one whose result
+// is smallest, which is usually also the one with the least work, and
+// which keeps the intermediate results small.
+
+namespace matrix_impl
+{
+  // The labels of the operands and the result of a contraction.
+  struct contraction_spec
+  {
+    std::vector<std::string> operands;
+    std::string result;
+  };
+
+  // Parse the notation of a contraction of n operands, throwing
+  // std::invalid_argument if it is malformed. See matrix.cpp.
+  contraction_spec parse_contraction(const char* spec, std::size_t n);
+
+
+  // A tensor is an operand of a contraction: a view of a matrix or of an
+  // intermediate result, with a label, an extent and a stride for each
+  // dimension. An intermediate result owns its elements.
+  template <typename T>
+    struct tensor
+    {
+      std::size_t size() const
+      {
+        std::size_t n = 1;
+        for (std::size_t e : extents)
+          n *= e;
+        return n;
+      }
+
+      // Returns the dimension with label c, or npos.
+      std::size_t dim(char c) const { return labels.find(c); }
+
+      std::string              labels;
+      std::vector<std::size_t> extents;
+      std::vector<std::size_t> strides;
+      const T*                 data;
+      std::vector<T>           elems;
+    };
+
+  // Returns the index of the label c in a table of extents.
+  inline std::size_t
+  label_index(char c)
+  {
+    return static_cast<unsigned char>(c);
+  }
+
+  // Returns a dense tensor with the given labels and extents, whose
+  // elements are zero.
+  template <typename T>
+    tensor<T>
+    dense_tensor(const std::string& labels, const std::size_t* extents)
+    {
+      tensor<T> t;
+      t.labels = labels;
+      t.extents.resize(labels.size());
+      t.strides.resize(labels.size());
+      std::size_t n = 1;
+      for (std::size_t d = labels.size(); d-- != 0; ) {
+        t.extents[d] = extents[label_index(labels[d])];
+        t.strides[d] = n;
+        n *= t.extents[d];
+      }
+      t.elems.assign(n, T());
+      t.data = t.elems.data();
+      return t;
+    }
+
+  // Add the elements of t to out, a dense array whose dimensions have the
+  // given labels, which are labels of t. The dimensions of t that are not
+  // labeled in out are summed. The elements of t are read in the order of
+  // its dimensions.
+  template <typename T>
+    void
+    add_to(const tensor<T>& t, const std::string& labels, T* out)
+    {
+      std::size_t n = t.labels.size();
+      if (t.size() == 0)
+        return;
+      if (n == 0) {
+        *out += *t.data;
+        return;
+      }
+
+      // The stride of each dimension of t in out.
+      std::vector<std::size_t> os(n, 0);
+      std::size_t m = 1;
+      for (std::size_t i = labels.size(); i-- != 0; ) {
+        std::size_t d = t.dim(labels[i]);
+        os[d] = m;
+        m *= t.extents[d];
+      }
+
+      std::vector<std::size_t> idx(n, 0);
+      const T* p = t.data;
+      std::size_t inner = t.extents[n - 1];
+      std::size_t ps = t.strides[n - 1];
+      std::size_t qs = os[n - 1];
+      for (;;) {
+        for (std::size_t j = 0; j != inner; ++j)
+          out[j * qs] += p[j * ps];
+        std::size_t d = n - 1;
+        for (;;) {
+          if (d == 0)
+            return;
+          --d;
+          p += t.strides[d];
+          out += os[d];
+          if (++idx[d] != t.extents[d])
+            break;
+          p -= t.strides[d] * t.extents[d];
+          out -= os[d] * t.extents[d];
+          idx[d] = 0;
+        }
+      }
+    }
+
+  // Returns the dense tensor with the given labels, of the elements of t,
+  // summed over the labels of t that it does not have.
+  template <typename T>
+    tensor<T>
+    rearrange(const tensor<T>& t, const std::string& labels,
+              const std::size_t* extents)
+    {
+      tensor<T> r = dense_tensor<T>(labels, extents);
+      add_to(t, labels, r.elems.data());
+      return r;
+    }
+
+  // Find the extent and stride of the labels of t taken as one dimension,
+  // returning false if their strides do not allow it. The extent of no
+  // labels is 1.
+  template <typename T>
+    bool
+    merge_dims(const tensor<T>& t, const std::string& labels,
+               std::size_t& extent, std::size_t& stride)
+    {
+      extent = 1;
+      stride = 0;
+      for (std::size_t i = labels.size(); i-- != 0; ) {
+        std::size_t d = t.dim(labels[i]);
+        if (t.extents[d] == 1)
+          continue;
+        if (extent != 1 && t.strides[d] != stride * extent)
+          return false;
+        if (extent == 1)
+          stride = t.strides[d];
+        extent *= t.extents[d];
+      }
+      return true;
+    }
+
+  // Returns the labels of x in the order of their positions in y.
+  inline std::string
+  order_by(std::string x, const std::string& y)
+  {
+    std::sort(x.begin(), x.end(), [&y](char a, char b) {
+      return y.find(a) < y.find(b);
+    });
+    return x;
+  }
+
+  // Add the contraction of a and b to out, a dense array whose dimensions
+  // have the given labels. The labels of a and b that out does not have
+  // are summed.
+  template <typename T>
+    void
+    contract_pair(const tensor<T>& a, const tensor<T>& b,
+                  const std::string& labels, const std::size_t* extents,
+                  T* out)
+    {
+      // Sum the labels of each operand that neither the other nor the
+      // result has.
+      auto lonely = [&](const tensor<T>& x, const tensor<T>& y) {
+        std::string keep;
+        for (char c : x.labels)
+          if (y.dim(c) != std::string::npos
+              || labels.find(c) != std::string::npos)
+            keep += c;
+        return keep;
+      };
+      std::string ka = lonely(a, b);
+      std::string kb = lonely(b, a);
+      if (ka.size() != a.labels.size()) {
+        tensor<T> r = rearrange(a, ka, extents);
+        return contract_pair(r, b, labels, extents, out);
+      }
+      if (kb.size() != b.labels.size()) {
+        tensor<T> r = rearrange(b, kb, extents);
+        return contract_pair(a, r, labels, extents, out);
+      }
+
+      // Group the labels. The summed labels are taken in the order of
+      // their strides in a, largest first, so that a matrix is summed in
+      // the order it is stored.
+      std::string batch, rows, cols, sums;
+      for (char c : a.labels) {
+        bool in_b = b.dim(c) != std::string::npos;
+        bool kept = labels.find(c) != std::string::npos;
+        if (in_b && kept)
+          batch += c;
+        else if (kept)
+          rows += c;
+        else
+          sums += c;
+      }
+      for (char c : b.labels)
+        if (a.dim(c) == std::string::npos)
+          cols += c;
+      batch = order_by(batch, labels);
+      rows = order_by(rows, labels);
+      cols = order_by(cols, labels);
+      std::stable_sort(sums.begin(), sums.end(), [&a](char x, char y) {
+        return a.strides[a.dim(x)] > a.strides[a.dim(y)];
+      });
+
+      // Group the dimensions of a as batch x m x k and those of b as
+      // batch x k x n, copying either if its strides do not allow it.
+      std::size_t m, k, n, ms, ks, ns, kn, kbs;
+      tensor<T> ca, cb;
+      const tensor<T>* pa = &a;
+      const tensor<T>* pb = &b;
+      if (!merge_dims(a, rows, m, ms) || !merge_dims(a, sums, k, ks)
+          || (k > 1 && ks != 1)) {
+        ca = rearrange(a, batch + rows + sums, extents);
+        pa = &ca;
+        merge_dims(ca, rows, m, ms);
+        merge_dims(ca, sums, k, ks);
+      }
+      if (!merge_dims(b, sums, kn, kbs) || !merge_dims(b, cols, n, ns)
+          || (n > 1 && ns != 1)) {
+        cb = rearrange(b, batch + sums + cols, extents);
+        pb = &cb;
+        merge_dims(cb, sums, kn, kbs);
+        merge_dims(cb, cols, n, ns);
+      }
+      if (m == 0 || n == 0 || k == 0)
+        return;
+
+      // Compute the products into out if its labels are in the order of
+      // the groups, and otherwise into a temporary.
+      std::string natural = batch + rows + cols;
+      tensor<T> c;
+      T* pc = out;
+      if (natural != labels) {
+        c = dense_tensor<T>(natural, extents);
+        pc = c.elems.data();
+      }
+
+      std::size_t nb = batch.size();
+      std::size_t count = 1;
+      std::vector<std::size_t> be(nb), as(nb), bs(nb), idx(nb, 0);
+      for (std::size_t i = 0; i != nb; ++i) {
+        be[i] = extents[label_index(batch[i])];
+        as[i] = pa->strides[pa->dim(batch[i])];
+        bs[i] = pb->strides[pb->dim(batch[i])];
+        count *= be[i];
+      }
+      const T* x = pa->data;
+      const T* y = pb->data;
+      for (std::size_t t = 0; t != count; ++t) {
+        dispatch_gemm(m, n, k, x, m > 1 ? ms : k, y, k > 1 ? kbs : n,
+                      pc, n);
+        pc += m * n;
+        for (std::size_t d = nb; d-- != 0; ) {
+          x += as[d];
+          y += bs[d];
+          if (++idx[d] != be[d])
+            break;
+          x -= as[d] * be[d];
+          y -= bs[d] * be[d];
+          idx[d] = 0;
+        }
+      }
+      if (natural != labels)
+        add_to(c, labels, out);
+    }
+
+
+  // The state of a contraction: the operands, and the extent of each
+  // label.
+  template <typename T>
+    class contraction
+    {
+    public:
+      contraction(const char* spec, std::size_t n)
+        : spec(parse_contraction(spec, n))
+      {
+        std::fill(extents, extents + 128, std::size_t(-1));
+        operands.reserve(n);
+      }
+
+      // Add the next operand, whose value type is T.
+      template <typename M>
+        void add(const M& m);
+
+      // Compute the contraction into a matrix of order N.
+      template <std::size_t N>
+        matrix<T, N> run();
+
+    private:
+      void compute(T* out);
+
+      template <std::size_t N>
+        matrix<T, N> result(std::false_type);
+
+      template <std::size_t N>
+        matrix<T, N> result(std::true_type);
+
+      [[noreturn]] void fail(const std::string& what) const
+      {
+        throw std::invalid_argument("contract: " + what);
+      }
+
+    private:
+      contraction_spec spec;
+      std::vector<tensor<T>> operands;
+      std::size_t extents[128];
+    };
+
+  template <typename T>
+    template <typename M>
+      void
+      contraction<T>::add(const M& m)
+      {
+        static_assert(Same<Remove_const<Value_type<M>>, T>(),
+                      "the operands of a contraction have one value type");
+        const std::string& ls = spec.operands[operands.size()];
+        const auto& desc = m.descriptor();
+        if (ls.size() != M::order)
+          fail("the labels '" + ls + "' do not match an operand of order "
+               + std::to_string(M::order));
+
+        // A repeated label selects a diagonal, whose stride is the sum of
+        // the strides of its dimensions.
+        tensor<T> t;
+        t.data = m.data() + desc.start;
+        for (std::size_t i = 0; i != ls.size(); ++i) {
+          char c = ls[i];
+          std::size_t e = desc.extents[i];
+          std::size_t& x = extents[label_index(c)];
+          if (x != std::size_t(-1) && x != e)
+            fail(std::string("label '") + c + "' has different extents");
+          x = e;
+          std::size_t d = t.dim(c);
+          if (d == std::string::npos) {
+            t.labels += c;
+            t.extents.push_back(e);
+            t.strides.push_back(desc.strides[i]);
+          } else {
+            t.strides[d] += desc.strides[i];
+          }
+        }
+        operands.push_back(std::move(t));
+      }
+
+  // Contract the operands into out, which is zero. The pair contracted at
+  // each step is the one whose result is smallest, and then the one with
+  // the least work.
+  template <typename T>
+    void
+    contraction<T>::compute(T* out)
+    {
+      if (operands.size() == 1)
+        return add_to(operands[0], spec.result, out);
+
+      while (operands.size() > 2) {
+        std::size_t bi = 0, bj = 1;
+        std::size_t best = std::size_t(-1), work = std::size_t(-1);
+        std::string keep;
+        for (std::size_t i = 0; i != operands.size(); ++i)
+          for (std::size_t j = i + 1; j != operands.size(); ++j) {
+            const tensor<T>& a = operands[i];
+            const tensor<T>& b = operands[j];
+
+            // The labels kept by the pair are those of the result and of
+            // the other operands, in the order of the groups of the pair.
+            std::string batch, rows, cols;
+            std::size_t size = 1, cost = 1;
+            auto needed = [&](char c) {
+              if (spec.result.find(c) != std::string::npos)
+                return true;
+              for (std::size_t k = 0; k != operands.size(); ++k)
+                if (k != i && k != j
+                    && operands[k].dim(c) != std::string::npos)
+                  return true;
+              return false;
+            };
+            for (char c : a.labels) {
+              cost *= extents[label_index(c)];
+              if (!needed(c))
+                continue;
+              size *= extents[label_index(c)];
+              (b.dim(c) != std::string::npos ? batch : rows) += c;
+            }
+            for (char c : b.labels)
+              if (a.dim(c) == std::string::npos) {
+                cost *= extents[label_index(c)];
+                if (needed(c)) {
+                  size *= extents[label_index(c)];
+                  cols += c;
+                }
+              }
+            if (size < best || (size == best && cost < work)) {
+              best = size;
+              work = cost;
+              bi = i;
+              bj = j;
+              keep = batch + rows + cols;
+            }
+          }
+
+        tensor<T> r = dense_tensor<T>(keep, extents);
+        contract_pair(operands[bi], operands[bj], keep, extents,
+                      r.elems.data());
+        operands.erase(operands.begin() + bj);
+        operands[bi] = std::move(r);
+      }
+      contract_pair(operands[0], operands[1], spec.result, extents, out);
+    }
+
+  template <typename T>
+    template <std::size_t N>
+      inline matrix<T, N>
+      contraction<T>::run()
+      {
+        if (spec.result.size() != N)
+          fail("the result '" + spec.result + "' does not have order "
+               + std::to_string(N));
+        return result<N>(std::integral_constant<bool, N == 0>());
+      }
+
+  template <typename T>
+    template <std::size_t N>
+      matrix<T, N>
+      contraction<T>::result(std::false_type)
+      {
+        std::array<std::size_t, N> exts;
+        for (std::size_t i = 0; i != N; ++i)
+          exts[i] = extents[label_index(spec.result[i])];
+        matrix<T, N> r(matrix_slice<N>(0, exts));
+        compute(r.data());
+        return r;
+      }
+
+  template <typename T>
+    template <std::size_t N>
+      matrix<T, N>
+      contraction<T>::result(std::true_type)
+      {
+        T x = T();
+        compute(&x);
+        return matrix<T, N>(x);
+      }
+
+} // namespace matrix_impl
+
+
+// Returns the contraction of the operands described by spec, a matrix of
+// order N (see [matrix.contract]).
+template <std::size_t N, typename M, typename... Ms>
+  matrix<Remove_const<Value_type<M>>, N>
+  contract(const char* spec, const M& a, const Ms&... ms)
+  {
+    using T = Remove_const<Value_type<M>>;
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    matrix_impl::contraction<T> c(spec, 1 + sizeof...(Ms));
+    c.add(a);
+    using expand = int[];
+    (void)expand{0, (c.add(ms), 0)...};
+    return c.template run<N>();
+  }
@@ -0,0 +1,334 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Matrix expressions                                              [matrix.expr]
+//
+// The element-wise arithmetic operators (+, -, and the scalar operators *, /,
+// and %) do not compute their results immediately. Instead, they return a
+// matrix_expr describing the computation. The computation is performed when
+// the expression is assigned to (or used to initialize) a matrix or
+// matrix_ref. The entire expression is evaluated in a single pass over the
+// elements of the destination, and no temporary matrices are created. For
+// example:
+//
+//    matrix<double, 2> r = a + b * 2.0 - c;
+//
+// computes each element r(i, j) as a(i, j) + b(i, j) * 2.0 - c(i, j).
+//
+// An expression refers to the matrices in it; it does not copy them. An
+// expression must not outlive its operands, so storing an expression with
+// "auto" is generally a mistake.
+//
+// Element-wise evaluation reads each element of an operand only at the
+// position being written, so assigning an expression to one of its own
+// operands (e.g., a = a + b) is well-defined. Assigning to a matrix_ref that
+// partially overlaps an operand at a different position is not.
+//
+// Expressions model the Matrix concept. They can be compared, and iterated
+// over, but their elements are computed on each access.
+
+namespace matrix_impl
+{
+  // The matrix_leaf class is an expression operand referring to the elements
+  // of a matrix or matrix_ref.
+  template <typename T, std::size_t N>
+    struct matrix_leaf
+    {
+      static constexpr std::size_t order = N;
+
+      using value_type = T;
+
+      // A row cursor accesses the elements of a single row of the leaf.
+      struct cursor
+      {
+        const T& operator[](std::size_t j) const { return ptr[j * stride]; }
+
+        const T* ptr;
+        std::size_t stride;
+      };
+
+      matrix_leaf(const matrix_slice<N>& s, const T* p)
+        : desc(s), ptr(p)
+      { }
+
+      const matrix_slice<N>& descriptor() const { return desc; }
+
+      // Returns a cursor over the row whose leading indexes (all but the
+      // last) are given by idx.
+      cursor row(const std::size_t* idx) const
+      {
+        std::size_t off = desc.start;
+        for (std::size_t d = 0; d != N - 1; ++d)
+          off += idx[d] * desc.strides[d];
+        return {ptr + off, desc.strides[N - 1]};
+      }
+
+      // Returns the ith element in row-major order.
+      const T& at(std::size_t i) const
+      {
+        std::size_t off = desc.start;
+        for (std::size_t d = N; d != 0; --d) {
+          off += (i % desc.extents[d - 1]) * desc.strides[d - 1];
+          i /= desc.extents[d - 1];
+        }
+        return ptr[off];
+      }
+
+      matrix_slice<N> desc;
+      const T* ptr;
+    };
+
+
+  // The scalar_leaf class is an expression operand that has the same value
+  // at every position.
+  template <typename T>
+    struct scalar_leaf
+    {
+      static constexpr std::size_t order = 0;
+
+      using value_type = T;
+
+      struct cursor
+      {
+        const T& operator[](std::size_t) const { return value; }
+
+        T value;
+      };
+
+      explicit scalar_leaf(const T& x) : value(x) { }
+
+      cursor row(const std::size_t*) const { return {value}; }
+
+      const T& at(std::size_t) const { return value; }
+
+      T value;
+    };
+
+
+  // The operand trait maps each kind of expression operand onto the type
+  // used to store it in an expression.
+  template <typename M>
+    struct operand_type
+    {
+      using type = subst_failure;
+    };
+
+  template <typename T, std::size_t N, typename A>
+    struct operand_type<matrix<T, N, A>>
+    {
+      using type = matrix_leaf<T, N>;
+    };
+
+  template <typename T, std::size_t N>
+    struct operand_type<matrix_ref<T, N>>
+    {
+      using type = matrix_leaf<Remove_const<T>, N>;
+    };
+
+  template <typename Op, typename L, typename R>
+    struct operand_type<matrix_expr<Op, L, R>>
+    {
+      using type = matrix_expr<Op, L, R>;
+    };
+
+  template <typename M>
+    using Operand_type = typename operand_type<M>::type;
+
+  // Returns true if M can be used as a matrix operand in an expression.
+  template <typename M>
+    constexpr bool Matrix_operand()
+    {
+      return Subst_succeeded<Operand_type<M>>();
+    }
+
+  // Returns true if M1 and M2 can be combined element-wise in an expression.
+  // They must be have the same order and value type.
+  template <typename M1, 
+            typename M2, 
+            bool = Matrix_operand<M1>() && Matrix_operand<M2>()>
+    struct are_matrix_operands : std::false_type { };
+
+  template <typename M1, typename M2>
+    struct are_matrix_operands<M1, M2, true>
+      : std::integral_constant<
+          bool, 
+          M1::order == M2::order && Same<Value_type<M1>, Value_type<M2>>()
+        >
+    { };
+
+  template <typename M1, typename M2>
+    constexpr bool Matrix_operands()
+    {
+      return are_matrix_operands<M1, M2>::value;
+    }
+
+
+  // Construct the expression operand for the matrix, matrix_ref, or
+  // expression m.
+  template <typename T, std::size_t N, typename A>
+    inline matrix_leaf<T, N>
+    make_operand(const matrix<T, N, A>& m)
+    {
+      return {m.descriptor(), m.data()};
+    }
+
+  template <typename T, std::size_t N>
+    inline matrix_leaf<Remove_const<T>, N>
+    make_operand(const matrix_ref<T, N>& m)
+    {
+      return {m.descriptor(), m.data()};
+    }
+
+  template <typename Op, typename L, typename R>
+    inline const matrix_expr<Op, L, R>&
+    make_operand(const matrix_expr<Op, L, R>& e)
+    {
+      return e;
+    }
+
+} // namespace matrix_impl
+
+
+// The matrix_expr class represents the element-wise application of the
+// binary operation Op to the operands L and R. At least one of the operands
+// is a matrix operand (a leaf or another expression); the other may be a
+// scalar_leaf.
+//
+// Template parameters:
+//    Op -- A binary function object computing each element.
+//    L  -- The left operand.
+//    R  -- The right operand.
+template <typename Op, typename L, typename R>
+  class matrix_expr
+  {
+    using left_cursor = typename L::cursor;
+    using right_cursor = typename R::cursor;
+
+  public:
+    using value_type = Remove_cv<Result_of<Op(const Value_type<L>&,
+                                              const Value_type<R>&)>>;
+
+    // A row cursor evaluates the elements of a single row.
+    struct cursor
+    {
+      value_type operator[](std::size_t j) const { return op(l[j], r[j]); }
+
+      left_cursor l;
+      right_cursor r;
+      Op op;
+    };
+
+    // The iterator class is a forward iterator over the elements of an
+    // expression in row-major order. Each dereference evaluates the element
+    // independently; use assignment to evaluate an entire expression.
+    class iterator
+    {
+    public:
+      using value_type = typename matrix_expr::value_type;
+      using reference = value_type;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::forward_iterator_tag;
+
+      iterator(const matrix_expr& e, std::size_t i) : expr(&e), index(i) { }
+
+      value_type operator*() const { return expr->at(index); }
+
+      iterator& operator++() { ++index; return *this; }
+      iterator operator++(int) { iterator x = *this; ++index; return x; }
+
+      bool operator==(const iterator& x) const { return index == x.index; }
+      bool operator!=(const iterator& x) const { return index != x.index; }
+
+    private:
+      const matrix_expr* expr;
+      std::size_t index;
+    };
+
+    using const_iterator = iterator;
+
+
+    static constexpr std::size_t order = L::order ? L::order : R::order;
+
+    matrix_expr(const L& l, const R& r, Op op = Op{});
+
+    // Properties
+
+    // Returns a slice describing a row-major matrix with the same extents
+    // as this expression.
+    const matrix_slice<order>& descriptor() const { return desc; }
+
+    // Returns the extent of the expression in the nth dimension.
+    std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+
+    // Returns the number of rows (0th extent) in the expression.
+    std::size_t rows() const { return extent(0); }
+
+    // Returns the number of columns (1st extent) in the expression.
+    std::size_t cols() const { return extent(1); }
+
+    // Returns the total number of elements in the expression.
+    std::size_t size() const { return desc.size; }
+
+
+    // Evaluation
+
+    // Returns a cursor over the row whose leading indexes are given by idx.
+    cursor row(const std::size_t* idx) const
+    {
+      return {left.row(idx), right.row(idx), op};
+    }
+
+    // Returns the value of the ith element in row-major order.
+    value_type at(std::size_t i) const { return op(left.at(i), right.at(i)); }
+
+
+    // Iterators
+    iterator begin() const { return {*this, 0}; }
+    iterator end() const   { return {*this, size()}; }
+
+  private:
+    L left;
+    R right;
+    Op op;
+    matrix_slice<order> desc;
+  };
+
+
+namespace matrix_impl
+{
+  // The descriptor of an expression is taken from its matrix operand. These
+  // operations select that operand.
+  template <typename L, typename R>
+    inline auto
+    expr_descriptor(const L& l, const R& r) -> decltype(l.descriptor())
+    {
+      return l.descriptor();
+    }
+
+  template <typename L, typename T>
+    inline auto
+    expr_descriptor(const scalar_leaf<T>& l, const L& r)
+      -> decltype(r.descriptor())
+    {
+      return r.descriptor();
+    }
+
+} // namespace matrix_impl
+
+
+template <typename Op, typename L, typename R>
+  inline
+  matrix_expr<Op, L, R>::matrix_expr(const L& l, const R& r, Op f)
+    : left(l), right(r), op(f),
+      desc(0, matrix_impl::expr_descriptor(l, r).extents)
+  { }
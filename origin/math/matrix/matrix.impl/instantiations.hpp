@@ -0,0 +1,56 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Prebuilt instantiations                                  [matrix.instantiate]
+//
+// The products of matrices of double and float, and the blocked product
+// kernels of those types, are instantiated once, in matrix.cpp, which is
+// compiled with optimization even when the program that uses it is not. A
+// translation unit that uses them does not compile them again, which saves
+// build time and keeps a single copy of the kernels in the program.
+//
+// The matrix classes themselves are not instantiated: an explicit
+// instantiation would define every member, including those that do not
+// apply to the value type or order (operator%= of double, row() of a
+// vector), and their members are inline in any case.
+//
+// The library must be built with the same configuration (ORIGIN_INSTRUMENT
+// and NDEBUG) as the program, since the instantiations are shared.
+
+extern template void
+matrix_product(const matrix<double, 2>&, const matrix<double, 2>&,
+               matrix<double, 2>&, plus_times);
+extern template void
+matrix_product(const matrix_ref<double, 2>&, const matrix_ref<double, 2>&,
+               matrix<double, 2>&, plus_times);
+extern template void
+matrix_product(const matrix<float, 2>&, const matrix<float, 2>&,
+               matrix<float, 2>&, plus_times);
+
+extern template void
+hadamard_product(const matrix<double, 2>&, const matrix<double, 2>&,
+                 matrix<double, 2>&);
+extern template void
+hadamard_product(const matrix<float, 2>&, const matrix<float, 2>&,
+                 matrix<float, 2>&);
+
+namespace matrix_impl
+{
+  extern template void
+  gemm(const product_tuning&, std::size_t, std::size_t, std::size_t,
+       const double*, std::size_t, const double*, std::size_t,
+       double*, std::size_t, plus_times);
+  extern template void
+  gemm(const product_tuning&, std::size_t, std::size_t, std::size_t,
+       const float*, std::size_t, const float*, std::size_t,
+       float*, std::size_t, plus_times);
+} // namespace matrix_impl
@@ -18,6 +18,15 @@
 //
 // A slice iterator is a forward iterator. Note that it may be possible to make
 // this bidirectional or random access, but we reserve that for future work.
+//
+// When constructed, the iterator collapses the innermost dimensions of the
+// slice that can be traversed with a single stride into one run. This is 
+// the case when the stride of a dimension is the stride of the next
+// dimension multiplied by its extent. Incrementing within a run only adds
+// the stride to a pointer. The general index carry logic is only needed at
+// the end of a run. A contiguous slice, a row or column, or any other slice
+// with a single stride is traversed as a single run, so iterating over it is
+// as efficient as iterating over a pointer.
 template <typename T, std::size_t N>
   struct slice_iterator
   {
@@ -30,7 +39,11 @@ template <typename T, std::size_t N>
     slice_iterator(const matrix_slice<N>& s, T* base, bool limit = false);
 
     // Returns the iterators describing slice.
-    const matrix_slice<N>& descriptor() const { return desc; }
+    const matrix_slice<N>& descriptor() const { return *desc; }
+
+    // Returns the index of the current element in the outermost dimension.
+    // The limit of a slice has the index of its extent.
+    std::size_t outer_index() const { return indexes[0]; }
 
     // Readable
     T& operator*() const { return *ptr; }
@@ -42,11 +55,16 @@ template <typename T, std::size_t N>
 
   private:
     void increment();
+    void carry();
 
   private:
-    const matrix_slice<N>& desc; // Describes the iterator range
-    std::size_t indexes[N];       // Counting indexes
-    T* ptr;                       // The current element
+    const matrix_slice<N>* desc; // Describes the iterator range
+    std::size_t indexes[N];      // Counting indexes for outer dimensions
+    std::size_t outer;           // The number of outer dimensions
+    std::size_t step;            // The stride of the innermost run
+    std::size_t run;             // The number of elements in a run
+    std::size_t left;            // Elements remaining in the current run
+    T* ptr;                      // The current element
   };
 
 
@@ -54,12 +72,28 @@ template <typename T, std::size_t N>
   slice_iterator<T, N>::slice_iterator(const matrix_slice<N>& s, 
                                        T* base, 
                                        bool limit)
-    : desc(s)
+    : desc(&s)
   {
+    // Collapse the inner dimensions into a single run.
+    std::size_t d = N - 1;
+    step = s.strides[d];
+    run = s.extents[d];
+    while (d != 0 && s.strides[d - 1] == s.strides[d] * s.extents[d]) {
+      --d;
+      run *= s.extents[d];
+    }
+    outer = d;
+    left = run;
+
+    // When the slice is not a single run, the limit is distinguished by its
+    // outer index, since its address may be that of an element (e.g., in a
+    // transposed slice, whose rows are not stored in order).
     std::fill_n(indexes, N, 0);
-    if (limit) {
-      indexes[0] = desc.extents[0];
-      ptr = base + desc.offset(indexes);
+    if (limit && s.size != 0) {
+      indexes[0] = s.extents[0];
+      ptr = base + s.offset(indexes);
+      if (outer == 0)
+        indexes[0] = 0;
     } else {
       ptr = base + s.start;
     }
@@ -85,24 +119,44 @@ template <typename T, std::size_t N>
 
 // Move to the next element in the range.
 template <typename T, std::size_t N>
-  void
+  inline void
   slice_iterator<T, N>::increment()
   {
-    std::size_t d = N - 1;
+    ptr += step;
+    if (--left == 0)
+      carry();
+  }
+
+// Move from the end of a run to the start of the next. If the slice has been
+// traversed entirely, the pointer is left past the end of the slice.
+template <typename T, std::size_t N>
+  void
+  slice_iterator<T, N>::carry()
+  {
+    // If the entire slice is a single run, then the pointer is already at
+    // the limit of the slice.
+    if (outer == 0)
+      return;
+
+    ORIGIN_COUNT("matrix.slice.carry");
+    left = run;
+    ptr -= step * run;
+
+    std::size_t d = outer - 1;
     while (true) {
-      ptr += desc.strides[d];
+      ptr += desc->strides[d];
       ++indexes[d];
 
       // If have not yet counted to the extent of the current dimension, then
       // we will continue to do so in the next iteration.
-      if (indexes[d] != desc.extents[d])
+      if (indexes[d] != desc->extents[d])
         break;
 
       // Otherwise, if we have not counted to the extent in the outermost
       // dimension, move to the next dimension and try again. If d is 0, then
       // we have counted through the entire slice.
       if (d != 0) {
-        ptr -= desc.strides[d] * desc.extents[d];
+        ptr -= desc->strides[d] * desc->extents[d];
         indexes[d] = 0;
         --d;
       } else {
@@ -124,7 +178,7 @@ template <typename T, std::size_t N>
   operator==(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
   {
     assert(a.descriptor() == b.descriptor());
-    return &*a == &*b;
+    return &*a == &*b && a.outer_index() == b.outer_index();
   }
 
 template <typename T, std::size_t N>
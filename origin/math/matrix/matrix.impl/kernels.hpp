@@ -0,0 +1,666 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Element-wise kernels                                         [matrix.kernels]
+//
+// The apply operations of matrix and matrix_ref are implemented in terms of
+// the kernels in this file. A kernel visits the elements described by a
+// slice, choosing the cheapest traversal that the slice allows:
+//
+//    - If the slice is contiguous, the elements are visited as a single
+//      array.
+//    - If the slice has a unit stride in the last dimension, each row (the
+//      innermost dimension) is visited as an array.
+//    - Otherwise, the elements are visited by a slice iterator.
+//
+// When the elements are visited as arrays, the operation is one of the
+// arithmetic operations below, and the value type has vector support (see
+// simd.hpp), the array is processed with vector instructions.
+//
+// When the operation is one of the arithmetic operations below and the
+// slice has at least parallel_elements elements, the outermost extent is
+// divided into blocks of rows that are traversed as above by the product
+// threads. Other operations, which may have side effects, are applied by
+// the calling thread in row-major order.
+
+namespace matrix_impl
+{
+  // Call f(first, last) for the blocks of rows [first, last) partitioning
+  // [0, n), distributing them over the product threads if the rows hold at
+  // least parallel_elements elements in total. See matrix.cpp.
+  constexpr std::size_t parallel_elements = 1 << 16;
+
+  void parallel_rows(std::size_t n, std::size_t elements,
+                     const std::function<void(std::size_t, std::size_t)>& f);
+
+
+  // The vector_op class is a base class of operations that can be applied
+  // to vector registers as well as scalars. A vector op provides a static
+  // member function template vec such that Op::vec<V>(a, b) computes the
+  // operation on the registers a and b using the simd_traits V.
+  struct vector_op { };
+
+  // Assignment: a = b
+  struct assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a = b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return b; }
+  };
+
+  // Addition: a += b
+  struct plus_assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a += b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::add(a, b); }
+  };
+
+  // Subtraction: a -= b
+  struct minus_assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a -= b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::sub(a, b); }
+  };
+
+  // Reverse subtraction: a = b - a
+  struct subtract_from_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a = b - a; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::sub(b, a); }
+  };
+
+  // Multiplication: a *= b
+  struct multiplies_assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a *= b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::mul(a, b); }
+  };
+
+  // Division: a /= b
+  struct divides_assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a /= b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::div(a, b); }
+  };
+
+  // Remainder: a %= b. There is no vector form of this operation.
+  struct modulus_assign_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a %= b; }
+  };
+
+
+  // The scalar_op class binds a scalar value to the right operand of one
+  // of the operations above, resulting in a unary operation.
+  template <typename Op, typename T>
+    struct scalar_op : Op
+    {
+      explicit scalar_op(const T& x) : value(x) { }
+
+      template <typename U>
+        void operator()(U& x) const { Op::operator()(x, value); }
+
+      T value;
+    };
+
+  template <typename F>
+    struct is_scalar_op : std::false_type { };
+
+  template <typename Op, typename T>
+    struct is_scalar_op<scalar_op<Op, T>> : std::true_type { };
+
+
+  // Returns true if the unary operation F can be applied to arrays of T
+  // using vector instructions.
+  template <typename T, typename F>
+    constexpr bool Vector_unary_op()
+    {
+      return Simd_type<T>()
+          && is_scalar_op<F>::value
+          && Derived<F, vector_op>();
+    }
+
+  // Returns true if the binary operation F can be applied to arrays of T
+  // and arrays of U using vector instructions.
+  template <typename T, typename U, typename F>
+    constexpr bool Vector_binary_op()
+    {
+      return Simd_type<T>() && Same<T, U>() && Derived<F, vector_op>();
+    }
+
+
+  // Returns true if F is one of the operations above, which may be applied
+  // to different elements concurrently.
+  template <typename F>
+    constexpr bool Parallel_op()
+    {
+      return Derived<F, vector_op>() || Derived<F, modulus_assign_op>();
+    }
+
+  template <typename F>
+    using Parallel_tag = std::integral_constant<bool, Parallel_op<F>()>;
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Array Kernels
+  //
+  // Apply an operation to n elements starting at p (and q).
+
+  template <typename T, typename F>
+    inline Requires<!Vector_unary_op<T, F>(), void>
+    apply_n(T* p, std::size_t n, F f)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        f(p[i]);
+    }
+
+  template <typename T, typename F>
+    inline Requires<Vector_unary_op<T, F>(), void>
+    apply_n(T* p, std::size_t n, F f)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      Reg x = V::broadcast(f.value);
+      std::size_t i = 0;
+      for ( ; i + 2 * W <= n; i += 2 * W) {
+        Reg a = V::load(p + i);
+        Reg b = V::load(p + i + W);
+        V::store(p + i, F::template vec<V>(a, x));
+        V::store(p + i + W, F::template vec<V>(b, x));
+      }
+      for ( ; i + W <= n; i += W)
+        V::store(p + i, F::template vec<V>(V::load(p + i), x));
+      for ( ; i != n; ++i)
+        f(p[i]);
+    }
+
+  template <typename T, typename U, typename F>
+    inline Requires<!Vector_binary_op<T, U, F>(), void>
+    apply_n(T* p, const U* q, std::size_t n, F f)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        f(p[i], q[i]);
+    }
+
+  template <typename T, typename U, typename F>
+    inline Requires<Vector_binary_op<T, U, F>(), void>
+    apply_n(T* p, const U* q, std::size_t n, F f)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      std::size_t i = 0;
+      for ( ; i + 2 * W <= n; i += 2 * W) {
+        Reg a = V::load(p + i);
+        Reg b = V::load(p + i + W);
+        Reg c = V::load(q + i);
+        Reg d = V::load(q + i + W);
+        V::store(p + i, F::template vec<V>(a, c));
+        V::store(p + i + W, F::template vec<V>(b, d));
+      }
+      for ( ; i + W <= n; i += W)
+        V::store(p + i, F::template vec<V>(V::load(p + i), V::load(q + i)));
+      for ( ; i != n; ++i)
+        f(p[i], q[i]);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Row Traversal
+
+  // Returns true when the elements described by the slice s occupy a single
+  // contiguous block of memory in row-major order.
+  template <std::size_t N>
+    inline bool
+    is_contiguous(const matrix_slice<N>& s)
+    {
+      std::size_t n = 1;
+      for (std::size_t i = N; i != 0; --i) {
+        if (s.extents[i - 1] != 1 && s.strides[i - 1] != n)
+          return false;
+        n *= s.extents[i - 1];
+      }
+      return true;
+    }
+
+  // Returns true when the innermost dimension of the slice s has unit stride.
+  // Each row of such a slice is a contiguous array.
+  template <std::size_t N>
+    inline bool
+    has_unit_stride(const matrix_slice<N>& s)
+    {
+      return s.strides[N - 1] == 1 || s.extents[N - 1] <= 1;
+    }
+
+  // Call f(idx, off) for each row of the slice s, where idx is the array of
+  // leading indexes (all but the last) of the row and off is the offset of
+  // its first element. Rows are visited in row-major order.
+  template <std::size_t N, typename F>
+    void
+    for_each_row(const matrix_slice<N>& s, F f)
+    {
+      if (s.size == 0)
+        return;
+      std::size_t indexes[N] {};
+      std::size_t off = s.start;
+      while (true) {
+        f(static_cast<const std::size_t*>(indexes), off);
+        std::size_t d = N - 1;
+        while (true) {
+          if (d == 0)
+            return;
+          --d;
+          off += s.strides[d];
+          if (++indexes[d] != s.extents[d])
+            break;
+          off -= s.strides[d] * s.extents[d];
+          indexes[d] = 0;
+        }
+      }
+    }
+
+  // Call f(off1, off2) for the offsets of the first elements in corresponding
+  // rows of the slices s1 and s2, which must have the same extents.
+  template <std::size_t N, typename F>
+    void
+    for_each_row(const matrix_slice<N>& s1, const matrix_slice<N>& s2, F f)
+    {
+      if (s1.size == 0)
+        return;
+      std::size_t indexes[N] {};
+      std::size_t off1 = s1.start;
+      std::size_t off2 = s2.start;
+      while (true) {
+        f(off1, off2);
+        std::size_t d = N - 1;
+        while (true) {
+          if (d == 0)
+            return;
+          --d;
+          off1 += s1.strides[d];
+          off2 += s2.strides[d];
+          if (++indexes[d] != s1.extents[d])
+            break;
+          off1 -= s1.strides[d] * s1.extents[d];
+          off2 -= s2.strides[d] * s2.extents[d];
+          indexes[d] = 0;
+        }
+      }
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Slice Kernels
+  //
+  // Apply an operation to the elements of memory at p described by the
+  // slice s. The binary form applies the operation to corresponding
+  // elements of two slices with the same extents.
+
+  template <std::size_t N, typename T, typename F>
+    void
+    apply_slice_serial(const matrix_slice<N>& s, T* p, F f)
+    {
+      if (is_contiguous(s)) {
+        apply_n(p + s.start, s.size, f);
+      } else if (has_unit_stride(s)) {
+        std::size_t n = s.extents[N - 1];
+        for_each_row(s, [&](const std::size_t*, std::size_t off) {
+          apply_n(p + off, n, f);
+        });
+      } else {
+        slice_iterator<T, N> first(s, p);
+        slice_iterator<T, N> last(s, p, true);
+        for ( ; first != last; ++first)
+          f(*first);
+      }
+    }
+
+  template <std::size_t N, typename T, typename U, typename F>
+    void
+    apply_slice_serial(const matrix_slice<N>& s1, T* p,
+                       const matrix_slice<N>& s2, const U* q,
+                       F f)
+    {
+      if (is_contiguous(s1) && is_contiguous(s2)) {
+        apply_n(p + s1.start, q + s2.start, s1.size, f);
+      } else if (has_unit_stride(s1) && has_unit_stride(s2)) {
+        std::size_t n = s1.extents[N - 1];
+        for_each_row(s1, s2, [&](std::size_t i, std::size_t j) {
+          apply_n(p + i, q + j, n, f);
+        });
+      } else {
+        slice_iterator<T, N> i(s1, p);
+        slice_iterator<T, N> last(s1, p, true);
+        slice_iterator<const U, N> j(s2, q);
+        for ( ; i != last; ++i, ++j)
+          f(*i, *j);
+      }
+    }
+
+
+  // Returns the slice of the rows [first, last) of the outermost extent of
+  // the nonempty slice s.
+  template <std::size_t N>
+    inline matrix_slice<N>
+    row_block(const matrix_slice<N>& s, std::size_t first, std::size_t last)
+    {
+      matrix_slice<N> r = s;
+      r.start += first * s.strides[0];
+      r.extents[0] = last - first;
+      r.size = s.size / s.extents[0] * (last - first);
+      return r;
+    }
+
+  template <std::size_t N, typename T, typename F>
+    inline void
+    apply_slice(const matrix_slice<N>& s, T* p, F f, std::false_type)
+    {
+      apply_slice_serial(s, p, f);
+    }
+
+  template <std::size_t N, typename T, typename F>
+    void
+    apply_slice(const matrix_slice<N>& s, T* p, F f, std::true_type)
+    {
+      if (s.size < parallel_elements) {
+        apply_slice_serial(s, p, f);
+        return;
+      }
+      parallel_rows(s.extents[0], s.size,
+        [&](std::size_t first, std::size_t last) {
+          apply_slice_serial(row_block(s, first, last), p, f);
+        });
+    }
+
+  template <std::size_t N, typename T, typename F>
+    inline void
+    apply_slice(const matrix_slice<N>& s, T* p, F f)
+    {
+      apply_slice(s, p, f, Parallel_tag<F>{});
+    }
+
+  template <std::size_t N, typename T, typename U, typename F>
+    inline void
+    apply_slice(const matrix_slice<N>& s1, T* p,
+                const matrix_slice<N>& s2, const U* q,
+                F f, std::false_type)
+    {
+      apply_slice_serial(s1, p, s2, q, f);
+    }
+
+  template <std::size_t N, typename T, typename U, typename F>
+    void
+    apply_slice(const matrix_slice<N>& s1, T* p,
+                const matrix_slice<N>& s2, const U* q,
+                F f, std::true_type)
+    {
+      if (s1.size < parallel_elements) {
+        apply_slice_serial(s1, p, s2, q, f);
+        return;
+      }
+      parallel_rows(s1.extents[0], s1.size,
+        [&](std::size_t first, std::size_t last) {
+          apply_slice_serial(row_block(s1, first, last), p,
+                             row_block(s2, first, last), q, f);
+        });
+    }
+
+  template <std::size_t N, typename T, typename U, typename F>
+    inline void
+    apply_slice(const matrix_slice<N>& s1, T* p,
+                const matrix_slice<N>& s2, const U* q,
+                F f)
+    {
+      apply_slice(s1, p, s2, q, f, Parallel_tag<F>{});
+    }
+
+
+  // Returns true when the matrix type M is a matrix or matrix_ref. These
+  // types expose their elements through data() and descriptor(), which
+  // allows kernels to operate on the underlying memory.
+  template <typename M>
+    struct is_strided_matrix : std::false_type { };
+
+  template <typename T, std::size_t N, typename A>
+    struct is_strided_matrix<matrix<T, N, A>> : std::true_type { };
+
+  template <typename T, std::size_t N>
+    struct is_strided_matrix<matrix_ref<T, N>> : std::true_type { };
+
+  template <typename M>
+    constexpr bool Strided_matrix()
+    {
+      return is_strided_matrix<Remove_const<M>>::value;
+    }
+
+
+  // Returns true when M is a matrix expression.
+  template <typename M>
+    struct is_matrix_expr : std::false_type { };
+
+  template <typename Op, typename L, typename R>
+    struct is_matrix_expr<matrix_expr<Op, L, R>> : std::true_type { };
+
+  template <typename M>
+    constexpr bool Matrix_expression()
+    {
+      return is_matrix_expr<Remove_const<M>>::value;
+    }
+
+
+  // Apply the binary operation f to the elements described by the slice s
+  // (at p) and the corresponding elements of the expression e. The
+  // expression is evaluated one row at a time, so that every operand is
+  // traversed once, and no temporaries are created.
+  //
+  // The slice may be a block of rows of the expression's extents, whose
+  // first row is row first of the expression.
+  template <std::size_t N, typename T, typename E, typename F>
+    void
+    apply_expr_serial(const matrix_slice<N>& s, T* p, const E& e, F f,
+                      std::size_t first = 0)
+    {
+      std::size_t n = s.extents[N - 1];
+      std::size_t stride = s.strides[N - 1];
+      std::size_t at[N] {};
+      for_each_row(s, [&](const std::size_t* idx, std::size_t off) {
+        std::copy(idx, idx + N, at);
+        at[0] += first;
+        auto row = e.row(at);
+        T* q = p + off;
+        if (stride == 1) {
+          for (std::size_t j = 0; j != n; ++j)
+            f(q[j], row[j]);
+        } else {
+          for (std::size_t j = 0; j != n; ++j)
+            f(q[j * stride], row[j]);
+        }
+      });
+    }
+
+  // Matrices are divided into blocks of rows. The rows of a vector are its
+  // elements, which an expression cursor cannot be offset to, so vectors
+  // are evaluated serially.
+  template <std::size_t N, typename T, typename E, typename F>
+    inline void
+    apply_expr(const matrix_slice<N>& s, T* p, const E& e, F f,
+               std::false_type)
+    {
+      apply_expr_serial(s, p, e, f);
+    }
+
+  template <std::size_t N, typename T, typename E, typename F>
+    void
+    apply_expr(const matrix_slice<N>& s, T* p, const E& e, F f,
+               std::true_type)
+    {
+      if (N == 1 || s.size < parallel_elements) {
+        apply_expr_serial(s, p, e, f);
+        return;
+      }
+      parallel_rows(s.extents[0], s.size,
+        [&](std::size_t first, std::size_t last) {
+          apply_expr_serial(row_block(s, first, last), p, e, f, first);
+        });
+    }
+
+  template <std::size_t N, typename T, typename E, typename F>
+    inline void
+    apply_expr(const matrix_slice<N>& s, T* p, const E& e, F f)
+    {
+      apply_expr(s, p, e, f, Parallel_tag<F>{});
+    }
+
+
+  // Tags used to select the traversal of the apply_matrix operations.
+  struct strided_tag { };
+  struct expression_tag { };
+  struct iterator_tag { };
+
+  template <typename M>
+    using Apply_tag = If<Strided_matrix<M>(), strided_tag,
+                      If<Matrix_expression<M>(), expression_tag,
+                         iterator_tag>>;
+
+  // Apply the binary operation f to the elements described by s (at p) and
+  // the corresponding elements of the matrix m. If m is a matrix or
+  // matrix_ref, the slice kernel is used. If m is an expression, it is
+  // evaluated in place. Otherwise, the elements of m are visited through its
+  // iterators.
+  template <std::size_t N, typename T, typename M, typename F>
+    inline void
+    apply_matrix(const matrix_slice<N>& s, T* p, const M& m, F f,
+                 strided_tag)
+    {
+      apply_slice(s, p, m.descriptor(), m.data(), f);
+    }
+
+  template <std::size_t N, typename T, typename M, typename F>
+    inline void
+    apply_matrix(const matrix_slice<N>& s, T* p, const M& m, F f,
+                 expression_tag)
+    {
+      apply_expr(s, p, m, f);
+    }
+
+  template <std::size_t N, typename T, typename M, typename F>
+    inline void
+    apply_matrix(const matrix_slice<N>& s, T* p, const M& m, F f,
+                 iterator_tag)
+    {
+      slice_iterator<T, N> i(s, p);
+      slice_iterator<T, N> last(s, p, true);
+      auto j = m.begin();
+      for ( ; i != last; ++i, ++j)
+        f(*i, *j);
+    }
+
+  template <std::size_t N, typename T, typename M, typename F>
+    inline void
+    apply_matrix(const matrix_slice<N>& s, T* p, const M& m, F f)
+    {
+      apply_matrix(s, p, m, f, Apply_tag<M>{});
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Exchange Kernels
+  //
+  // Exchange the elements of two arrays, or of two slices with the same
+  // extents and strides, such as two rows of a matrix. Contiguous arrays
+  // are exchanged with vector loads and stores when the value type has
+  // vector support.
+
+  template <typename T>
+    inline Requires<!Simd_type<T>(), void>
+    swap_n(T* p, T* q, std::size_t n)
+    {
+      std::swap_ranges(p, p + n, q);
+    }
+
+  template <typename T>
+    inline Requires<Simd_type<T>(), void>
+    swap_n(T* p, T* q, std::size_t n)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      std::size_t i = 0;
+      for ( ; i + 2 * W <= n; i += 2 * W) {
+        Reg a = V::load(p + i);
+        Reg b = V::load(p + i + W);
+        Reg c = V::load(q + i);
+        Reg d = V::load(q + i + W);
+        V::store(q + i, a);
+        V::store(q + i + W, b);
+        V::store(p + i, c);
+        V::store(p + i + W, d);
+      }
+      for ( ; i != n; ++i)
+        std::swap(p[i], q[i]);
+    }
+
+  // Exchange the n elements at p and q, which are spaced by the stride s.
+  template <typename T>
+    inline void
+    swap_n(T* p, T* q, std::size_t n, std::size_t s)
+    {
+      if (s == 1 || n <= 1)
+        return swap_n(p, q, n);
+      for (std::size_t i = 0; i != n; ++i)
+        std::swap(p[i * s], q[i * s]);
+    }
+
+  // Exchange the elements of the slices s1 and s2 of the memory at p, which
+  // have the same extents and strides.
+  template <std::size_t N, typename T>
+    void
+    swap_slice(const matrix_slice<N>& s1, const matrix_slice<N>& s2, T* p)
+    {
+      std::size_t n = s1.extents[N - 1];
+      std::size_t s = s1.strides[N - 1];
+      if (is_contiguous(s1))
+        return swap_n(p + s1.start, p + s2.start, s1.size);
+      for_each_row(s1, s2, [=](std::size_t i, std::size_t j) {
+        swap_n(p + i, p + j, n, s);
+      });
+    }
+
+} // namespace matrix_impl
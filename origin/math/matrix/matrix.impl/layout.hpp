@@ -0,0 +1,995 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Storage layouts                                               [matrix.layout]
+//
+// The elements of a matrix are stored in row-major order, which suits access
+// along rows. Two other layouts are provided for 2D matrices:
+//
+//    column_major_matrix<T>     Columns are contiguous
+//    tiled_matrix<T, B>         B x B tiles are contiguous
+//
+// A column-major matrix is described by a slice whose strides are those of
+// the transpose, so it is a strided matrix: its rows, columns and slices are
+// matrix_refs, and it can be used wherever a matrix or matrix_ref can (in
+// expressions, products, and the BLAS, reduction and solver operations).
+//
+// A tiled matrix stores its elements in tiles of B x B elements, which are
+// laid out in row-major order, each tile being stored in row-major order.
+// The tiles on the lower and right edges are padded to B x B. Each tile is
+// a matrix_ref, and a full tile is contiguous, so blocked algorithms can
+// operate on tiles with the same kernels as on a small matrix:
+//
+//    tiled_matrix<double> t(1000, 1000);
+//    for (std::size_t i = 0; i != t.tile_rows(); ++i)
+//      for (std::size_t j = 0; j != t.tile_cols(); ++j)
+//        t.tile(i, j) *= 2.0;
+//
+// The rows and columns of a tiled matrix cross tiles, so they are not
+// strided, and are not matrix_refs. Instead, elements are accessed by
+// index, or in row-major order through its iterators. Tiled matrices can be
+// operands of expressions, compared, and converted to and from matrices of
+// any layout.
+
+namespace matrix_impl
+{
+  // Returns the number of tiles of extent b needed to cover n elements.
+  inline std::size_t
+  tile_count(std::size_t n, std::size_t b)
+  {
+    return (n + b - 1) / b;
+  }
+
+  // Returns the offset of the element (i, j) of a tiled matrix whose rows
+  // of tiles each hold n elements.
+  template <std::size_t B>
+    inline std::size_t
+    tiled_offset(std::size_t i, std::size_t j, std::size_t n)
+    {
+      return (i / B) * n + (j / B) * (B * B) + (i % B) * B + (j % B);
+    }
+
+  // The tiled_iterator class is a forward iterator over the elements of a
+  // tiled matrix in row-major order.
+  template <typename T, std::size_t B>
+    class tiled_iterator
+    {
+    public:
+      using value_type = Remove_const<T>;
+      using reference = T&;
+      using pointer = T*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::forward_iterator_tag;
+
+      tiled_iterator(T* p, std::size_t n, std::size_t w, std::size_t i)
+        : base(p), cols(n), width(w), row(i), col(0)
+      { }
+
+      T& operator*() const
+      {
+        return base[tiled_offset<B>(row, col, width)];
+      }
+      T* operator->() const { return &**this; }
+
+      tiled_iterator& operator++()
+      {
+        if (++col == cols) {
+          col = 0;
+          ++row;
+        }
+        return *this;
+      }
+
+      tiled_iterator operator++(int)
+      {
+        tiled_iterator x = *this;
+        ++*this;
+        return x;
+      }
+
+      bool operator==(const tiled_iterator& x) const
+      {
+        return row == x.row && col == x.col;
+      }
+
+      bool operator!=(const tiled_iterator& x) const { return !(*this == x); }
+
+    private:
+      T* base;
+      std::size_t cols;  // The number of columns
+      std::size_t width; // The number of elements in a row of tiles
+      std::size_t row;
+      std::size_t col;
+    };
+
+
+  // A column-major matrix exposes its elements through data() and
+  // descriptor(), like a matrix_ref.
+  template <typename T, typename A>
+    struct is_strided_matrix<column_major_matrix<T, A>> : std::true_type { };
+
+  template <typename T, typename A>
+    struct operand_type<column_major_matrix<T, A>>
+    {
+      using type = matrix_leaf<T, 2>;
+    };
+
+  template <typename T, typename A>
+    inline matrix_leaf<T, 2>
+    make_operand(const column_major_matrix<T, A>& m)
+    {
+      return {m.descriptor(), m.data()};
+    }
+
+
+  // The tiled_leaf class is an expression operand referring to the elements
+  // of a tiled matrix.
+  template <typename T, std::size_t B>
+    struct tiled_leaf
+    {
+      static constexpr std::size_t order = 2;
+
+      using value_type = T;
+
+      // A row cursor refers to the first element of a row in the first
+      // tile of its row of tiles.
+      struct cursor
+      {
+        const T& operator[](std::size_t j) const
+        {
+          return ptr[(j / B) * (B * B) + j % B];
+        }
+
+        const T* ptr;
+      };
+
+      const matrix_slice<2>& descriptor() const { return desc; }
+
+      cursor row(const std::size_t* idx) const
+      {
+        return {ptr + tiled_offset<B>(idx[0], 0, width)};
+      }
+
+      const T& at(std::size_t i) const
+      {
+        std::size_t n = desc.extents[1];
+        return ptr[tiled_offset<B>(i / n, i % n, width)];
+      }
+
+      matrix_slice<2> desc;
+      const T* ptr;
+      std::size_t width;
+    };
+
+  template <typename T, std::size_t B, typename A>
+    struct operand_type<tiled_matrix<T, B, A>>
+    {
+      using type = tiled_leaf<T, B>;
+    };
+
+  template <typename T, std::size_t B, typename A>
+    inline tiled_leaf<T, B>
+    make_operand(const tiled_matrix<T, B, A>& m)
+    {
+      return {m.descriptor(), m.data(), m.tile_cols() * B * B};
+    }
+
+} // namespace matrix_impl
+
+
+// -------------------------------------------------------------------------- //
+// Column-major matrix
+//
+// The column_major_matrix class is a 2D matrix whose elements are stored in
+// column-major order. Its interface is that of a matrix of order 2.
+//
+// Template Parameters:
+//    T -- The element type stored by the matrix
+//    A -- The allocator used to obtain storage for elements
+template <typename T, typename A>
+  class column_major_matrix
+  {
+  public:
+    static constexpr std::size_t order = 2;
+
+    using value_type     = T;
+    using allocator_type = A;
+    using iterator       = slice_iterator<T, 2>;
+    using const_iterator = slice_iterator<const T, 2>;
+
+
+    // Default construction
+    column_major_matrix() = default;
+
+    // Move semantics
+    column_major_matrix(column_major_matrix&&) = default;
+    column_major_matrix& operator=(column_major_matrix&&) = default;
+
+    // Copy semantics
+    column_major_matrix(const column_major_matrix&) = default;
+    column_major_matrix& operator=(const column_major_matrix&) = default;
+
+
+    // Matrix assignment
+    //
+    // Initialize or assign this matrix by copying the elements of the 2D
+    // matrix, matrix_ref, or expression x.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      column_major_matrix(const M& x);
+
+    template <typename M, typename = Requires<Matrix<M>()>>
+      column_major_matrix& operator=(const M& x);
+
+
+    // Extent initialization
+    //
+    // Initialize the matrix with m rows and n columns. The elements are
+    // value initialized, or default initialized if uninitialized is given.
+    column_major_matrix(std::size_t m, std::size_t n, const A& a = A());
+    column_major_matrix(uninitialized_t, std::size_t m, std::size_t n,
+                        const A& a = A());
+
+
+    // Value initialization
+    //
+    // Initialize the matrix over a nesting of initializer lists, which give
+    // the elements in row-major order.
+    column_major_matrix(matrix_initializer<T, 2> init);
+
+
+    // Properties
+
+    A get_allocator() const { return elems.get_allocator(); }
+
+    // Returns the slice describing the matrix. Its strides are 1 and the
+    // number of rows.
+    const matrix_slice<2>& descriptor() const { return desc; }
+
+    std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+    std::size_t rows() const { return extent(0); }
+    std::size_t cols() const { return extent(1); }
+    std::size_t size() const { return desc.size; }
+
+    memory_footprint memory_usage() const
+    {
+      return {elems.size() * sizeof(T), elems.size() * sizeof(T)};
+    }
+
+
+    // Subscripting
+    T&       operator()(std::size_t i, std::size_t j);
+    const T& operator()(std::size_t i, std::size_t j) const;
+
+    template <typename... Args>
+      Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, 2>>
+      operator()(const Args&... args);
+
+    template <typename... Args>
+      Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<const T, 2>>
+      operator()(const Args&... args) const;
+
+    matrix_ref<T, 1>       operator[](std::size_t n)       { return row(n); }
+    matrix_ref<const T, 1> operator[](std::size_t n) const { return row(n); }
+
+    // Row
+    //
+    // Returns a matrix_ref referring to the nth row, whose stride is the
+    // number of rows.
+    matrix_ref<T, 1>       row(std::size_t n);
+    matrix_ref<const T, 1> row(std::size_t n) const;
+
+    // Column
+    //
+    // Returns a matrix_ref referring to the nth column, which is contiguous.
+    matrix_ref<T, 1>       col(std::size_t n);
+    matrix_ref<const T, 1> col(std::size_t n) const;
+
+
+    // Data access
+    //
+    // Returns a pointer to the elements, which are stored column by column.
+    T*       data()       { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+
+    // Apply
+    template <typename F>
+      column_major_matrix& apply(F f);
+
+    template <typename M, typename F>
+      column_major_matrix& apply(const M& m, F f);
+
+    // Scalar arithmetic
+    column_major_matrix& operator=(const T& x);
+    column_major_matrix& operator+=(const T& x);
+    column_major_matrix& operator-=(const T& x);
+    column_major_matrix& operator*=(const T& x);
+    column_major_matrix& operator/=(const T& x);
+
+    // Matrix arithmetic
+    template <typename M>
+      column_major_matrix& operator+=(const M& m);
+
+    template <typename M>
+      column_major_matrix& operator-=(const M& m);
+
+
+    // Iterators
+    //
+    // The iterators visit the elements in row-major order, as for every
+    // other matrix.
+    iterator begin() { return {desc, data()}; }
+    iterator end()   { return {desc, data(), true}; }
+
+    const_iterator begin() const { return {desc, data()}; }
+    const_iterator end() const   { return {desc, data(), true}; }
+
+
+    void swap(column_major_matrix& x);
+
+  private:
+    static matrix_slice<2> make_slice(std::size_t m, std::size_t n);
+
+    template <typename M>
+      void assign(const M& m, std::true_type);
+
+    template <typename M>
+      void assign(const M& m, std::false_type);
+
+  private:
+    matrix_slice<2> desc = make_slice(0, 0);
+    matrix_impl::matrix_storage<T, A> elems;
+  };
+
+
+template <typename T, typename A>
+  inline matrix_slice<2>
+  column_major_matrix<T, A>::make_slice(std::size_t m, std::size_t n)
+  {
+    return {0, {m, n}, {1, m}};
+  }
+
+template <typename T, typename A>
+  template <typename M, typename X>
+    inline
+    column_major_matrix<T, A>::column_major_matrix(const M& x)
+      : desc(make_slice(x.extent(0), x.extent(1))),
+        elems(desc.size, uninitialized)
+    {
+      static_assert(M::order == 2, "");
+      static_assert(Convertible<Value_type<M>, T>(), "");
+      using Fast = std::integral_constant<
+        bool, matrix_impl::Strided_matrix<M>() && Same<Value_type<M>, T>()
+      >;
+      assign(x, Fast{});
+    }
+
+template <typename T, typename A>
+  template <typename M, typename X>
+    inline column_major_matrix<T, A>&
+    column_major_matrix<T, A>::operator=(const M& x)
+    {
+      if (same_extents(desc, x.descriptor())) {
+        apply(x, matrix_impl::assign_op{});
+      } else {
+        column_major_matrix tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+// The elements of a strided matrix are copied by the transpose kernel,
+// since the elements of this matrix are those of the row-major transpose.
+template <typename T, typename A>
+  template <typename M>
+    inline void
+    column_major_matrix<T, A>::assign(const M& m, std::true_type)
+    {
+      matrix_ref<T, 2> t(matrix_slice<2>(0, {cols(), rows()}), data());
+      transpose_into(m, t);
+    }
+
+template <typename T, typename A>
+  template <typename M>
+    inline void
+    column_major_matrix<T, A>::assign(const M& m, std::false_type)
+    {
+      apply(m, matrix_impl::assign_op{});
+    }
+
+template <typename T, typename A>
+  inline
+  column_major_matrix<T, A>::column_major_matrix(std::size_t m,
+                                                 std::size_t n,
+                                                 const A& a)
+    : desc(make_slice(m, n)), elems(desc.size, a)
+  { }
+
+template <typename T, typename A>
+  inline
+  column_major_matrix<T, A>::column_major_matrix(uninitialized_t,
+                                                 std::size_t m,
+                                                 std::size_t n,
+                                                 const A& a)
+    : desc(make_slice(m, n)), elems(desc.size, uninitialized, a)
+  { }
+
+template <typename T, typename A>
+  inline
+  column_major_matrix<T, A>::column_major_matrix(matrix_initializer<T, 2> init)
+    : column_major_matrix(matrix<T, 2>(init))
+  { }
+
+
+// Subscripting
+
+template <typename T, typename A>
+  inline T&
+  column_major_matrix<T, A>::operator()(std::size_t i, std::size_t j)
+  {
+    assert(i < rows() && j < cols());
+    return data()[i + j * rows()];
+  }
+
+template <typename T, typename A>
+  inline const T&
+  column_major_matrix<T, A>::operator()(std::size_t i, std::size_t j) const
+  {
+    assert(i < rows() && j < cols());
+    return data()[i + j * rows()];
+  }
+
+template <typename T, typename A>
+  template <typename... Args>
+    inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, 2>>
+    column_major_matrix<T, A>::operator()(const Args&... args)
+    {
+      matrix_slice<2> d {desc, args...};
+      return {d, data()};
+    }
+
+template <typename T, typename A>
+  template <typename... Args>
+    inline Requires<matrix_impl::Slice_sequence<Args...>(),
+                    matrix_ref<const T, 2>>
+    column_major_matrix<T, A>::operator()(const Args&... args) const
+    {
+      matrix_slice<2> d {desc, args...};
+      return {d, data()};
+    }
+
+template <typename T, typename A>
+  inline matrix_ref<T, 1>
+  column_major_matrix<T, A>::row(std::size_t n)
+  {
+    assert(n < rows());
+    matrix_slice<1> row(desc, size_constant<0>(), n);
+    return {row, data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 1>
+  column_major_matrix<T, A>::row(std::size_t n) const
+  {
+    assert(n < rows());
+    matrix_slice<1> row(desc, size_constant<0>(), n);
+    return {row, data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<T, 1>
+  column_major_matrix<T, A>::col(std::size_t n)
+  {
+    assert(n < cols());
+    matrix_slice<1> col(desc, size_constant<1>(), n);
+    return {col, data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 1>
+  column_major_matrix<T, A>::col(std::size_t n) const
+  {
+    assert(n < cols());
+    matrix_slice<1> col(desc, size_constant<1>(), n);
+    return {col, data()};
+  }
+
+
+// Application
+//
+// The elements are contiguous, so scalar operations, and operations with
+// another column-major matrix, are applied directly to the underlying
+// arrays.
+template <typename T, typename A>
+  template <typename F>
+    inline column_major_matrix<T, A>&
+    column_major_matrix<T, A>::apply(F f)
+    {
+      matrix_impl::apply_n(data(), size(), f);
+      return *this;
+    }
+
+template <typename T, typename A>
+  template <typename M, typename F>
+    inline column_major_matrix<T, A>&
+    column_major_matrix<T, A>::apply(const M& m, F f)
+    {
+      assert(same_extents(desc, m.descriptor()));
+      matrix_impl::apply_matrix(desc, data(), m, f);
+      return *this;
+    }
+
+template <typename T, typename A>
+  inline column_major_matrix<T, A>&
+  column_major_matrix<T, A>::operator=(const T& x)
+  {
+    return apply(matrix_impl::scalar_op<matrix_impl::assign_op, T>(x));
+  }
+
+template <typename T, typename A>
+  inline column_major_matrix<T, A>&
+  column_major_matrix<T, A>::operator+=(const T& x)
+  {
+    return apply(matrix_impl::scalar_op<matrix_impl::plus_assign_op, T>(x));
+  }
+
+template <typename T, typename A>
+  inline column_major_matrix<T, A>&
+  column_major_matrix<T, A>::operator-=(const T& x)
+  {
+    return apply(matrix_impl::scalar_op<matrix_impl::minus_assign_op, T>(x));
+  }
+
+template <typename T, typename A>
+  inline column_major_matrix<T, A>&
+  column_major_matrix<T, A>::operator*=(const T& x)
+  {
+    using Op = matrix_impl::multiplies_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
+  }
+
+template <typename T, typename A>
+  inline column_major_matrix<T, A>&
+  column_major_matrix<T, A>::operator/=(const T& x)
+  {
+    using Op = matrix_impl::divides_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
+  }
+
+template <typename T, typename A>
+  template <typename M>
+    inline column_major_matrix<T, A>&
+    column_major_matrix<T, A>::operator+=(const M& m)
+    {
+      return apply(m, matrix_impl::plus_assign_op{});
+    }
+
+template <typename T, typename A>
+  template <typename M>
+    inline column_major_matrix<T, A>&
+    column_major_matrix<T, A>::operator-=(const M& m)
+    {
+      return apply(m, matrix_impl::minus_assign_op{});
+    }
+
+template <typename T, typename A>
+  inline void
+  column_major_matrix<T, A>::swap(column_major_matrix& x)
+  {
+    using std::swap;
+    swap(desc, x.desc);
+    elems.swap(x.elems);
+  }
+
+
+// Transpose
+//
+// The transpose of a column-major matrix is a contiguous row-major view.
+template <typename T, typename A>
+  inline matrix_ref<T, 2>
+  transpose(column_major_matrix<T, A>& m)
+  {
+    return {matrix_slice<2>(0, {m.cols(), m.rows()}), m.data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 2>
+  transpose(const column_major_matrix<T, A>& m)
+  {
+    return {matrix_slice<2>(0, {m.cols(), m.rows()}), m.data()};
+  }
+
+
+// -------------------------------------------------------------------------- //
+// Tiled matrix
+//
+// The tiled_matrix class is a 2D matrix whose elements are stored in
+// contiguous B x B tiles.
+//
+// Template Parameters:
+//    T -- The element type stored by the matrix
+//    B -- The extent of each tile
+//    A -- The allocator used to obtain storage for elements
+
+
+
+template <typename T, std::size_t B, typename A>
+  class tiled_matrix
+  {
+    static_assert(B != 0, "");
+
+  public:
+    static constexpr std::size_t order = 2;
+    static constexpr std::size_t tile_extent = B;
+
+    using value_type     = T;
+    using allocator_type = A;
+    using iterator       = matrix_impl::tiled_iterator<T, B>;
+    using const_iterator = matrix_impl::tiled_iterator<const T, B>;
+
+
+    // Default construction
+    tiled_matrix() = default;
+
+    // Move semantics
+    tiled_matrix(tiled_matrix&&) = default;
+    tiled_matrix& operator=(tiled_matrix&&) = default;
+
+    // Copy semantics
+    tiled_matrix(const tiled_matrix&) = default;
+    tiled_matrix& operator=(const tiled_matrix&) = default;
+
+
+    // Matrix assignment
+    //
+    // Initialize or assign this matrix by copying the elements of the 2D
+    // matrix, matrix_ref, or expression x.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      tiled_matrix(const M& x);
+
+    template <typename M, typename = Requires<Matrix<M>()>>
+      tiled_matrix& operator=(const M& x);
+
+
+    // Extent initialization
+    //
+    // Initialize the matrix with m rows and n columns. The elements,
+    // including the padding of the edge tiles, are value initialized, or
+    // default initialized if uninitialized is given.
+    tiled_matrix(std::size_t m, std::size_t n, const A& a = A());
+    tiled_matrix(uninitialized_t, std::size_t m, std::size_t n,
+                 const A& a = A());
+
+
+    // Value initialization
+    //
+    // Initialize the matrix over a nesting of initializer lists.
+    tiled_matrix(matrix_initializer<T, 2> init);
+
+
+    // Properties
+
+    A get_allocator() const { return elems.get_allocator(); }
+
+    // Returns a row-major slice with the extents of the matrix. The strides
+    // of the slice do not describe the storage of the elements.
+    const matrix_slice<2>& descriptor() const { return desc; }
+
+    std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+    std::size_t rows() const { return extent(0); }
+    std::size_t cols() const { return extent(1); }
+    std::size_t size() const { return desc.size; }
+
+    // Returns the number of rows and columns of tiles.
+    std::size_t tile_rows() const;
+    std::size_t tile_cols() const;
+
+    // Returns the footprint of the elements. The padding of the edge tiles
+    // is reserved but not live.
+    memory_footprint memory_usage() const
+    {
+      return {size() * sizeof(T), elems.size() * sizeof(T)};
+    }
+
+
+    // Subscripting
+    T&       operator()(std::size_t i, std::size_t j);
+    const T& operator()(std::size_t i, std::size_t j) const;
+
+
+    // Tiles
+    //
+    // Returns a matrix_ref referring to the tile in the ith row and jth
+    // column of tiles. A full tile is B x B and contiguous; the tiles on
+    // the edges have fewer rows or columns.
+    matrix_ref<T, 2>       tile(std::size_t i, std::size_t j);
+    matrix_ref<const T, 2> tile(std::size_t i, std::size_t j) const;
+
+
+    // Data access
+    //
+    // Returns a pointer to the first tile. The tiles are stored in
+    // row-major order, with B * B elements each.
+    T*       data()       { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+
+    // Apply
+    template <typename F>
+      tiled_matrix& apply(F f);
+
+    template <typename M, typename F>
+      tiled_matrix& apply(const M& m, F f);
+
+    // Scalar arithmetic
+    tiled_matrix& operator=(const T& x);
+    tiled_matrix& operator+=(const T& x);
+    tiled_matrix& operator-=(const T& x);
+    tiled_matrix& operator*=(const T& x);
+    tiled_matrix& operator/=(const T& x);
+
+    // Matrix arithmetic
+    template <typename M>
+      tiled_matrix& operator+=(const M& m);
+
+    template <typename M>
+      tiled_matrix& operator-=(const M& m);
+
+
+    // Iterators
+    //
+    // The iterators visit the elements in row-major order.
+    iterator begin() { return {data(), cols(), width(), 0}; }
+    iterator end()   { return {data(), cols(), width(), end_row()}; }
+
+    const_iterator begin() const { return {data(), cols(), width(), 0}; }
+    const_iterator end() const
+    {
+      return {data(), cols(), width(), end_row()};
+    }
+
+
+    void swap(tiled_matrix& x);
+
+  private:
+    // Returns the number of elements in a row of tiles.
+    std::size_t width() const { return tile_cols() * B * B; }
+
+    // Returns the row of the end iterator. An empty matrix has no rows.
+    std::size_t end_row() const { return cols() ? rows() : 0; }
+
+    static std::size_t reserve(std::size_t m, std::size_t n);
+
+    matrix_slice<2> tile_slice(std::size_t i, std::size_t j) const;
+
+  private:
+    matrix_slice<2> desc;
+    matrix_impl::matrix_storage<T, A> elems;
+  };
+
+
+template <typename T, std::size_t B, typename A>
+  inline std::size_t
+  tiled_matrix<T, B, A>::reserve(std::size_t m, std::size_t n)
+  {
+    return matrix_impl::tile_count(m, B) * matrix_impl::tile_count(n, B)
+         * B * B;
+  }
+
+template <typename T, std::size_t B, typename A>
+  template <typename M, typename X>
+    inline
+    tiled_matrix<T, B, A>::tiled_matrix(const M& x)
+      : desc(0, x.descriptor().extents),
+        elems(reserve(x.extent(0), x.extent(1)))
+    {
+      static_assert(M::order == 2, "");
+      static_assert(Convertible<Value_type<M>, T>(), "");
+      apply(x, matrix_impl::assign_op{});
+    }
+
+template <typename T, std::size_t B, typename A>
+  template <typename M, typename X>
+    inline tiled_matrix<T, B, A>&
+    tiled_matrix<T, B, A>::operator=(const M& x)
+    {
+      if (same_extents(desc, x.descriptor())) {
+        apply(x, matrix_impl::assign_op{});
+      } else {
+        tiled_matrix tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+template <typename T, std::size_t B, typename A>
+  inline
+  tiled_matrix<T, B, A>::tiled_matrix(std::size_t m, std::size_t n,
+                                      const A& a)
+    : desc(0, {m, n}), elems(reserve(m, n), a)
+  { }
+
+template <typename T, std::size_t B, typename A>
+  inline
+  tiled_matrix<T, B, A>::tiled_matrix(uninitialized_t,
+                                      std::size_t m, std::size_t n,
+                                      const A& a)
+    : desc(0, {m, n}), elems(reserve(m, n), uninitialized, a)
+  { }
+
+template <typename T, std::size_t B, typename A>
+  inline
+  tiled_matrix<T, B, A>::tiled_matrix(matrix_initializer<T, 2> init)
+    : tiled_matrix(matrix<T, 2>(init))
+  { }
+
+template <typename T, std::size_t B, typename A>
+  inline std::size_t
+  tiled_matrix<T, B, A>::tile_rows() const
+  {
+    return matrix_impl::tile_count(rows(), B);
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline std::size_t
+  tiled_matrix<T, B, A>::tile_cols() const
+  {
+    return matrix_impl::tile_count(cols(), B);
+  }
+
+
+// Subscripting
+
+template <typename T, std::size_t B, typename A>
+  inline T&
+  tiled_matrix<T, B, A>::operator()(std::size_t i, std::size_t j)
+  {
+    assert(i < rows() && j < cols());
+    return data()[matrix_impl::tiled_offset<B>(i, j, width())];
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline const T&
+  tiled_matrix<T, B, A>::operator()(std::size_t i, std::size_t j) const
+  {
+    assert(i < rows() && j < cols());
+    return data()[matrix_impl::tiled_offset<B>(i, j, width())];
+  }
+
+
+// Tiles
+
+template <typename T, std::size_t B, typename A>
+  inline matrix_slice<2>
+  tiled_matrix<T, B, A>::tile_slice(std::size_t i, std::size_t j) const
+  {
+    assert(i < tile_rows() && j < tile_cols());
+    std::size_t m = std::min(B, rows() - i * B);
+    std::size_t n = std::min(B, cols() - j * B);
+    return {i * width() + j * B * B, {m, n}, {B, 1}};
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline matrix_ref<T, 2>
+  tiled_matrix<T, B, A>::tile(std::size_t i, std::size_t j)
+  {
+    return {tile_slice(i, j), data()};
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline matrix_ref<const T, 2>
+  tiled_matrix<T, B, A>::tile(std::size_t i, std::size_t j) const
+  {
+    return {tile_slice(i, j), data()};
+  }
+
+
+// Application
+//
+// Scalar operations are applied to the whole array, including the padding.
+// Operations with another matrix are applied tile by tile, reading each
+// row of the other matrix through the row cursor of its expression operand
+// (see matrix.impl/expression.hpp), so that a strided operand is read along
+// its rows, and an expression is evaluated in place.
+template <typename T, std::size_t B, typename A>
+  template <typename F>
+    inline tiled_matrix<T, B, A>&
+    tiled_matrix<T, B, A>::apply(F f)
+    {
+      matrix_impl::apply_n(data(), elems.size(), f);
+      return *this;
+    }
+
+template <typename T, std::size_t B, typename A>
+  template <typename M, typename F>
+    tiled_matrix<T, B, A>&
+    tiled_matrix<T, B, A>::apply(const M& m, F f)
+    {
+      static_assert(matrix_impl::Matrix_operand<M>(), "");
+      assert(same_extents(desc, m.descriptor()));
+      const auto& e = matrix_impl::make_operand(m);
+      for (std::size_t ti = 0; ti != tile_rows(); ++ti) {
+        for (std::size_t tj = 0; tj != tile_cols(); ++tj) {
+          matrix_slice<2> s = tile_slice(ti, tj);
+          for (std::size_t r = 0; r != s.extents[0]; ++r) {
+            std::size_t i = ti * B + r;
+            auto row = e.row(&i);
+            T* p = data() + s.start + r * B;
+            for (std::size_t c = 0; c != s.extents[1]; ++c)
+              f(p[c], row[tj * B + c]);
+          }
+        }
+      }
+      return *this;
+    }
+
+template <typename T, std::size_t B, typename A>
+  inline tiled_matrix<T, B, A>&
+  tiled_matrix<T, B, A>::operator=(const T& x)
+  {
+    return apply(matrix_impl::scalar_op<matrix_impl::assign_op, T>(x));
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline tiled_matrix<T, B, A>&
+  tiled_matrix<T, B, A>::operator+=(const T& x)
+  {
+    return apply(matrix_impl::scalar_op<matrix_impl::plus_assign_op, T>(x));
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline tiled_matrix<T, B, A>&
+  tiled_matrix<T, B, A>::operator-=(const T& x)
+  {
+    return apply(matrix_impl::scalar_op<matrix_impl::minus_assign_op, T>(x));
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline tiled_matrix<T, B, A>&
+  tiled_matrix<T, B, A>::operator*=(const T& x)
+  {
+    using Op = matrix_impl::multiplies_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
+  }
+
+template <typename T, std::size_t B, typename A>
+  inline tiled_matrix<T, B, A>&
+  tiled_matrix<T, B, A>::operator/=(const T& x)
+  {
+    using Op = matrix_impl::divides_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
+  }
+
+template <typename T, std::size_t B, typename A>
+  template <typename M>
+    inline tiled_matrix<T, B, A>&
+    tiled_matrix<T, B, A>::operator+=(const M& m)
+    {
+      return apply(m, matrix_impl::plus_assign_op{});
+    }
+
+template <typename T, std::size_t B, typename A>
+  template <typename M>
+    inline tiled_matrix<T, B, A>&
+    tiled_matrix<T, B, A>::operator-=(const M& m)
+    {
+      return apply(m, matrix_impl::minus_assign_op{});
+    }
+
+template <typename T, std::size_t B, typename A>
+  inline void
+  tiled_matrix<T, B, A>::swap(tiled_matrix& x)
+  {
+    using std::swap;
+    swap(desc, x.desc);
+    elems.swap(x.elems);
+  }
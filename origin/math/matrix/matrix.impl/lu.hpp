@@ -0,0 +1,245 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// LU factorization                                                  [matrix.lu]
+//
+// The lu_factor operation computes the factorization P * A = L * U of a
+// square matrix A with partial (row) pivoting, where P is a permutation
+// matrix, L is unit lower triangular, and U is upper triangular. The
+// factorization is performed in place: on return, the strict lower triangle
+// of A holds L (its unit diagonal is not stored), and the upper triangle
+// holds U. The permutation is returned as a sequence of pivots: in step i,
+// row i was exchanged with row piv[i].
+//
+// A factored matrix can be used to solve any number of systems A * x = b by
+// calling lu_solve with the factors and pivots. For example:
+//
+//    std::vector<std::size_t> piv;
+//    lu_factor(a, piv);
+//    lu_solve(a, piv, b1);  // b1 is replaced by the solution
+//    lu_solve(a, piv, b2);
+//
+// The matrix is factored in blocks of columns. Each panel of columns is
+// factored with the classical algorithm, and the remaining (trailing)
+// submatrix is updated by a matrix product, which is computed by the blocked
+// (and possibly parallel) product kernel when the rows of A are contiguous.
+
+namespace matrix_impl
+{
+  // The number of columns in each panel of the blocked factorization. It is
+  // not tuned: the trailing update, where the time is spent, is blocked by
+  // the tuned product, and an inner dimension of 64 is enough for the
+  // product to run near its peak.
+  constexpr std::size_t lu_block = 64;
+
+
+  // Compute x -= c * y for the n elements of the rows x and y, which have
+  // the column stride cs.
+  template <typename T>
+    inline void
+    lu_axpy(std::size_t n, const T& c, const T* y, T* x, std::size_t cs)
+    {
+      if (cs == 1) {
+        for (std::size_t j = 0; j != n; ++j)
+          x[j] -= c * y[j];
+      } else {
+        for (std::size_t j = 0; j != n; ++j)
+          x[j * cs] -= c * y[j * cs];
+      }
+    }
+
+  // Factor the jb columns of the n x n matrix a starting at column j, using
+  // the classical algorithm with partial pivoting. Row exchanges are applied
+  // to entire rows of a. Returns false if a zero pivot was found.
+  template <typename T>
+    bool
+    lu_panel(std::size_t n, std::size_t j, std::size_t jb,
+             T* a, std::size_t rs, std::size_t cs, std::size_t* piv)
+    {
+      bool ok = true;
+      for (std::size_t c = j; c != j + jb; ++c) {
+        // Find the pivot: the element of largest magnitude in column c.
+        std::size_t p = c;
+        for (std::size_t r = c + 1; r < n; ++r)
+          if (std::abs(a[r * rs + c * cs]) > std::abs(a[p * rs + c * cs]))
+            p = r;
+        piv[c] = p;
+        if (p != c)
+          swap_n(a + c * rs, a + p * rs, n, cs);
+
+        const T pivot = a[c * rs + c * cs];
+        if (pivot == T(0)) {
+          ok = false;
+          continue;
+        }
+
+        // Compute the multipliers and eliminate below the pivot within the
+        // panel.
+        const T* u = a + c * rs + (c + 1) * cs;
+        for (std::size_t r = c + 1; r < n; ++r) {
+          T& l = a[r * rs + c * cs];
+          l /= pivot;
+          lu_axpy(j + jb - c - 1, l, u, a + r * rs + (c + 1) * cs, cs);
+        }
+      }
+      return ok;
+    }
+
+  // Update the rows of the factored panel (columns [j, j + jb)) to the right
+  // of the panel and then update the trailing submatrix. The rows of the
+  // panel are solved against the unit lower triangle of the diagonal block,
+  // and the trailing submatrix is updated by A22 -= L21 * U12.
+  template <typename T>
+    void
+    lu_update(std::size_t n, std::size_t j, std::size_t jb,
+              T* a, std::size_t rs, std::size_t cs)
+    {
+      std::size_t j2 = j + jb;
+      std::size_t n2 = n - j2;
+      if (n2 == 0)
+        return;
+
+      // U12 = inv(L11) * A12
+      for (std::size_t r = j + 1; r != j2; ++r)
+        for (std::size_t k = j; k != r; ++k)
+          lu_axpy(n2, a[r * rs + k * cs],
+                  a + k * rs + j2 * cs, a + r * rs + j2 * cs, cs);
+
+      // A22 -= L21 * U12
+      T* l21 = a + j2 * rs + j * cs;
+      T* u12 = a + j * rs + j2 * cs;
+      T* a22 = a + j2 * rs + j2 * cs;
+      if (cs == 1) {
+        // The product kernel accumulates C += A * B, so negate a copy of
+        // the (narrow) panel L21.
+        scratch_buffer<T> neg(n2 * jb);
+        for (std::size_t r = 0; r != n2; ++r)
+          for (std::size_t k = 0; k != jb; ++k)
+            neg[r * jb + k] = -l21[r * rs + k];
+        dispatch_gemm(n2, n2, jb, neg.data(), jb, u12, rs, a22, rs);
+      } else {
+        for (std::size_t r = 0; r != n2; ++r)
+          for (std::size_t k = 0; k != jb; ++k)
+            lu_axpy(n2, l21[r * rs + k * cs],
+                    u12 + k * rs, a22 + r * rs, cs);
+      }
+    }
+
+  // Factor the n x n matrix a with row stride rs and column stride cs.
+  template <typename T>
+    bool
+    lu_factor(std::size_t n, T* a, std::size_t rs, std::size_t cs,
+              std::size_t* piv)
+    {
+      bool ok = true;
+      for (std::size_t j = 0; j < n; j += lu_block) {
+        std::size_t jb = std::min(lu_block, n - j);
+        ok &= lu_panel(n, j, jb, a, rs, cs, piv);
+        lu_update(n, j, jb, a, rs, cs);
+      }
+      return ok;
+    }
+
+  // Solve A * X = B for the m columns of B, given the factors and pivots of
+  // the n x n matrix A. B is overwritten by the solution X.
+  template <typename T>
+    void
+    lu_solve(std::size_t n, const T* a, std::size_t rs, std::size_t cs,
+             const std::size_t* piv,
+             std::size_t m, T* b, std::size_t brs, std::size_t bcs)
+    {
+      // B = P * B
+      for (std::size_t i = 0; i != n; ++i)
+        if (piv[i] != i)
+          swap_n(b + i * brs, b + piv[i] * brs, m, bcs);
+
+      // B = inv(L) * B
+      for (std::size_t i = 1; i < n; ++i)
+        for (std::size_t k = 0; k != i; ++k)
+          lu_axpy(m, a[i * rs + k * cs], b + k * brs, b + i * brs, bcs);
+
+      // B = inv(U) * B
+      for (std::size_t i = n; i-- != 0; ) {
+        T* x = b + i * brs;
+        for (std::size_t k = i + 1; k < n; ++k)
+          lu_axpy(m, a[i * rs + k * cs], b + k * brs, x, bcs);
+        const T d = a[i * rs + i * cs];
+        for (std::size_t j = 0; j != m; ++j)
+          x[j * bcs] /= d;
+      }
+    }
+
+
+  // Returns the number of columns of the right-hand side described by s,
+  // which is either a vector or a matrix.
+  inline std::size_t
+  rhs_cols(const matrix_slice<1>& s) { return 1; }
+
+  inline std::size_t
+  rhs_cols(const matrix_slice<2>& s) { return s.extents[1]; }
+
+  // Returns the column stride of the right-hand side described by s.
+  inline std::size_t
+  rhs_stride(const matrix_slice<1>& s) { return 1; }
+
+  inline std::size_t
+  rhs_stride(const matrix_slice<2>& s) { return s.strides[1]; }
+
+} // namespace matrix_impl
+
+
+// Factor the square matrix a in place, storing the row exchanges in piv.
+// Returns false if a is singular, in which case the factorization is
+// completed, but U has a zero on its diagonal and cannot be used to solve
+// a system of equations.
+//
+// The matrix a must be a matrix or matrix_ref of order 2 with a floating
+// point value type.
+template <typename M>
+  bool
+  lu_factor(M& a, std::vector<std::size_t>& piv)
+  {
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    static_assert(M::order == 2, "");
+    static_assert(std::is_floating_point<Value_type<M>>::value, "");
+    assert(a.rows() == a.cols());
+
+    const matrix_slice<2>& d = a.descriptor();
+    piv.resize(a.rows());
+    return matrix_impl::lu_factor(a.rows(), a.data() + d.start,
+                                  d.strides[0], d.strides[1], piv.data());
+  }
+
+
+// Solve the system A * x = b for x given the factors lu and pivots piv of
+// A computed by lu_factor. The right-hand side b is overwritten by the
+// solution. If b is a matrix, each of its columns is a separate right-hand
+// side.
+template <typename M1, typename M2>
+  void
+  lu_solve(const M1& lu, const std::vector<std::size_t>& piv, M2& b)
+  {
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(matrix_impl::Strided_matrix<M2>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 1 || M2::order == 2, "");
+    assert(lu.rows() == lu.cols());
+    assert(lu.rows() == b.extent(0));
+    assert(lu.rows() == piv.size());
+
+    const matrix_slice<2>& d = lu.descriptor();
+    const matrix_slice<M2::order>& e = b.descriptor();
+    matrix_impl::lu_solve(lu.rows(), lu.data() + d.start,
+                          d.strides[0], d.strides[1], piv.data(),
+                          matrix_impl::rhs_cols(e), b.data() + e.start,
+                          e.strides[0], matrix_impl::rhs_stride(e));
+  }
@@ -20,23 +20,24 @@
 // Note that matrix<T, 0> is a valid type, but it is not a matrix. It contains
 // a single scalar of type T.
 //
-// TODO: Don't use vector<T> as the underlying store; just use a dynamically
-// allocated array. Certain operations will become faster (with fewer
-// assignments) and the class will take less space (2 pointers less). This
-// would also allow us to write an interesting version of reserve().
+// The elements are stored in a single array obtained from the allocator A.
+// The default allocator aligns the array on a 64-byte boundary. See
+// matrix.impl/storage.hpp.
 //
 // Template Parameters:
 //    T -- The eleemnt type stored by the matrix
 //    N -- The matrix order (number of extents).
-template <typename T, std::size_t N>
+//    A -- The allocator used to obtain storage for elements
+template <typename T, std::size_t N, typename A>
   class matrix
   {
   public:
     static constexpr std::size_t order = N;
 
     using value_type     = T;
-    using iterator       = typename std::vector<T>::iterator;
-    using const_iterator = typename std::vector<T>::const_iterator;
+    using allocator_type = A;
+    using iterator       = T*;
+    using const_iterator = const T*;
 
 
     // Default construction
@@ -54,11 +55,22 @@ template <typename T, std::size_t N>
     ~matrix() = default;
 
 
+    // Allocator initialization
+    //
+    // Initialize an empty matrix that allocates its elements using a copy of
+    // the allocator a.
+    explicit matrix(const A& a);
+
+
     // Matrix assignment.
     //
     // Initialize or assign this matrix by copying the matrix x. In the
     // case of assignment, the original matrix is destroyed and replaced by
-    // the copy.
+    // the copy. If x has the same extents as this matrix, its elements are
+    // assigned in place.
+    //
+    // If x is a matrix expression, it is evaluated directly into the
+    // elements of this matrix.
     //
     // The order of the two matrices must be the same, and the value type of
     // M must be convertible to this matrix's value type.
@@ -74,7 +86,7 @@ template <typename T, std::size_t N>
     // Initialize the matrix so that it has the same extents as the given
     // slice. Note that the strides are not copied. The resulting matrix
     // indexes it's elements in row-major order.
-    explicit matrix(const matrix_slice<N>& slice);
+    explicit matrix(const matrix_slice<N>& slice, const A& a = A());
 
 
     // Extent initialization
@@ -89,10 +101,62 @@ template <typename T, std::size_t N>
     // TODO: Create overloads that allow the specification of a default
     // value as the last argument and one that allows the specification of
     // a default value and an allocator as the last pairs of arguments.
-    template <typename... Dims>
+    template <typename... Dims,
+              typename = Requires<All(Convertible<Dims, std::size_t>()...)>>
       explicit
       matrix(Dims... dims);
 
+    // Uninitialized extent initialization
+    //
+    // Initialize the matrix with the given dimensions, but default initialize
+    // the elements. For arithmetic types, their values are indeterminate.
+    // This avoids writing memory that will be immediately overwritten. For
+    // example:
+    //
+    //    matrix<double, 2> m(uninitialized, 100, 100);
+    template <typename... Dims>
+      explicit
+      matrix(uninitialized_t, Dims... dims);
+
+    matrix(uninitialized_t, const matrix_slice<N>& slice, const A& a = A());
+
+    // First touch extent initialization
+    //
+    // Initialize the matrix with the given dimensions, zeroing the elements
+    // in parallel so that, with a NUMA allocator using the first touch
+    // policy, the pages of each block of rows are placed near a thread that
+    // will process them. The second form gives the extents by a slice and
+    // takes an allocator. For example:
+    //
+    //    using A = numa_allocator<double>;
+    //    matrix<double, 2, A> m(first_touch, 4096, 4096);
+    template <typename... Dims>
+      explicit
+      matrix(first_touch_t, Dims... dims);
+
+    matrix(first_touch_t, const matrix_slice<N>& slice, const A& a = A());
+
+
+    // Element buffer initialization
+    //
+    // Initialize the matrix with the given dimensions from the elements of
+    // a buffer p in row-major order, by copying them or by taking ownership
+    // of p, or from the values f(i, j, ...) computed for each element in
+    // parallel (see [matrix.storage]). For example:
+    //
+    //    matrix<double, 2> a(copy_elements, v.data(), 1000, 1000);
+    //    matrix<double, 2> h(generate_elements, [](size_t i, size_t j) {
+    //      return 1.0 / (i + j + 1);
+    //    }, 1000, 1000);
+    template <typename... Dims>
+      matrix(copy_elements_t, const T* p, Dims... dims);
+
+    template <typename... Dims>
+      matrix(adopt_elements_t, T* p, Dims... dims);
+
+    template <typename F, typename... Dims>
+      matrix(generate_elements_t, F f, Dims... dims);
+
 
     // Value initialization
     //
@@ -110,6 +174,9 @@ template <typename T, std::size_t N>
 
     // Properties
 
+    // Returns a copy of the allocator used to obtain storage for elements.
+    A get_allocator() const { return elems.get_allocator(); }
+
     // Return the slice describing the matrix.
     const matrix_slice<N>& descriptor() const { return desc; }
 
@@ -125,11 +192,21 @@ template <typename T, std::size_t N>
     // Returns the total number of elements contained in the matrix.
     std::size_t size() const { return desc.size; }
 
+    // Returns the footprint of the elements of the matrix. The storage of a
+    // matrix holds exactly its elements, so it has no slack. See
+    // [mem.usage].
+    memory_footprint memory_usage() const
+    {
+      return {elems.size() * sizeof(T), elems.size() * sizeof(T)};
+    }
+
 
     // Subscripting
     //
     // Returns a reference to the element at the index given by the sequence
-    // of indexes, args.
+    // of indexes, args. The elements are stored in row-major order from the
+    // start of the array, so the offset of an element is computed without
+    // the start or the innermost stride (see matrix.impl/slice.hpp).
 
     template <typename... Args>
       Requires<matrix_impl::Index_sequence<Args...>(), T&>
@@ -204,11 +281,11 @@ template <typename T, std::size_t N>
     // data in the matrix. It is not structured.
     //
     // TODO: Write iterators over rows and columns.
-    iterator begin() { return elems.begin(); }
-    iterator end()   { return elems.end(); }
+    iterator begin() { return data(); }
+    iterator end()   { return data() + size(); }
 
-    const_iterator begin() const { return elems.begin(); }
-    const_iterator end() const   { return elems.end(); }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const   { return data() + size(); }
 
 
     // Mutators
@@ -223,59 +300,162 @@ template <typename T, std::size_t N>
     void make_slice(matrix_slice<N>&, std::size_t, std::size_t, std::size_t);
 
   private:
-    matrix_slice<N> desc; // Describing slice
-    std::vector<T> elems; // Underlying elements
+    matrix_slice<N> desc;                    // Describing slice
+    matrix_impl::matrix_storage<T, A> elems; // Underlying elements
   };
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename X>
   inline
-  matrix<T, N>::matrix(const M& x)
-    : desc(x.descriptor()), elems(x.begin(), x.end())
+  matrix<T, N, A>::matrix(const M& x)
+    : desc(0, x.descriptor().extents), elems(desc.size, uninitialized)
   {
     static_assert(Convertible<Value_type<M>, T>(), "");
+    apply(x, matrix_impl::assign_op{});
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename X>
-  inline matrix<T, N>&
-  matrix<T, N>::operator=(const M& x)
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(const M& x)
   {
-    desc = x.descriptor();
-    elems.assign(x.begin(), x.end());
-    return*this;
+    if (same_extents(desc, x.descriptor())) {
+      apply(x, matrix_impl::assign_op{});
+    } else {
+      matrix tmp(x);
+      swap(tmp);
+    }
+    return *this;
   }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  inline
+  matrix<T, N, A>::matrix(const A& a)
+    : desc(), elems(a)
+  { }
+
+template <typename T, std::size_t N, typename A>
   inline
-  matrix<T, N>::matrix(const matrix_slice<N>& slice)
-    : desc(0, slice.extents), elems(desc.size)
+  matrix<T, N, A>::matrix(const matrix_slice<N>& slice, const A& a)
+    : desc(0, slice.extents), elems(desc.size, a)
   { }
 
 
-template <typename T, std::size_t N>
-  template <typename... Dims>
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims, typename X>
     inline
-    matrix<T, N>::matrix(Dims... dims)
+    matrix<T, N, A>::matrix(Dims... dims)
       : desc(0, {std::size_t(dims)...}), elems(desc.size)
     { }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    matrix<T, N, A>::matrix(uninitialized_t, Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, uninitialized)
+    { }
+
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    matrix<T, N, A>::matrix(first_touch_t, Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, first_touch)
+    { }
+
+template <typename T, std::size_t N, typename A>
+  inline
+  matrix<T, N, A>::matrix(first_touch_t,
+                          const matrix_slice<N>& slice,
+                          const A& a)
+    : desc(0, slice.extents), elems(desc.size, first_touch, a)
+  { }
+
+template <typename T, std::size_t N, typename A>
+  inline
+  matrix<T, N, A>::matrix(uninitialized_t,
+                          const matrix_slice<N>& slice,
+                          const A& a)
+    : desc(0, slice.extents), elems(desc.size, uninitialized, a)
+  { }
+
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    matrix<T, N, A>::matrix(copy_elements_t, const T* p, Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, copy_elements, p)
+    { }
+
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    matrix<T, N, A>::matrix(adopt_elements_t, T* p, Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, adopt_elements, p)
+    { }
+
+
+namespace matrix_impl
+{
+  // Assign f(i..., j) to the elements of the submatrix at out whose
+  // outermost D indexes are i..., for each index j of extent D, and so on
+  // until all N indexes are given. Returns the end of the submatrix.
+  template <std::size_t D, std::size_t N, bool = (D == N)>
+    struct generate_loop
+    {
+      template <typename T, typename F, typename... I>
+        static T* run(const std::size_t* ext, T* out, F& f, I... i)
+        {
+          for (std::size_t j = 0; j != ext[D]; ++j)
+            out = generate_loop<D + 1, N>::run(ext, out, f, i..., j);
+          return out;
+        }
+    };
+
+  template <std::size_t D, std::size_t N>
+    struct generate_loop<D, N, true>
+    {
+      template <typename T, typename F, typename... I>
+        static T* run(const std::size_t*, T* out, F& f, I... i)
+        {
+          *out = f(i...);
+          return out + 1;
+        }
+    };
+
+} // namespace matrix_impl
+
+// Each block of rows is generated by one thread, directly into place.
+template <typename T, std::size_t N, typename A>
+  template <typename F, typename... Dims>
+    matrix<T, N, A>::matrix(generate_elements_t, F f, Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, uninitialized)
+    {
+      static_assert(sizeof...(Dims) == N, "");
+      const std::size_t* ext = desc.extents;
+      const std::size_t stride = desc.strides[0];
+      T* base = data();
+      matrix_impl::parallel_rows(rows(), size(),
+        [ext, stride, base, &f](std::size_t first, std::size_t last) {
+          T* out = base + first * stride;
+          for (std::size_t i = first; i != last; ++i)
+            out = matrix_impl::generate_loop<1, N>::run(ext, out, f, i);
+        });
+    }
+
+template <typename T, std::size_t N, typename A>
   inline
-  matrix<T, N>::matrix(matrix_initializer<T, N> init)
-    : desc(0, matrix_impl::derive_extents<N>(init))
+  matrix<T, N, A>::matrix(matrix_initializer<T, N> init)
+    : desc(0, matrix_impl::derive_extents<N>(init)),
+      elems(desc.size, uninitialized)
   {
-    // matrix_impl::derive_extents(desc.extents, init);
-    elems.reserve(desc.size);
-    matrix_impl::insert_flattened(init, elems);
-    assert(elems.size() == desc.size);
+    T* last = matrix_impl::copy_flattened(init, data());
+    assert(last == data() + size());
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>&
-  matrix<T, N>::operator=(matrix_initializer<T, N> init)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(matrix_initializer<T, N> init)
   {
     matrix tmp(init);
     swap(tmp);
@@ -285,37 +465,39 @@ template <typename T, std::size_t N>
 
 // Subscripting
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Index_sequence<Args...>(), T&>
-    matrix<T, N>::operator()(Args... args)
+    matrix<T, N, A>::operator()(Args... args)
     {
       assert(matrix_impl::check_bounds(desc, args...));
-      return *(data() + desc(args...));
+      using matrix_impl::unit_offset;
+      return data()[unit_offset<0>(desc.strides, std::size_t(args)...)];
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Index_sequence<Args...>(), const T&>
-    matrix<T, N>::operator()(Args... args) const
+    matrix<T, N, A>::operator()(Args... args) const
     {
       assert(matrix_impl::check_bounds(desc, args...));
-      return *(data() + desc(args...));
+      using matrix_impl::unit_offset;
+      return data()[unit_offset<0>(desc.strides, std::size_t(args)...)];
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, N>>
-    matrix<T, N>::operator()(const Args&... args)
+    matrix<T, N, A>::operator()(const Args&... args)
     {
       matrix_slice<N> d {desc, args...};
       return {d, data()};
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<const T, N>>
-    matrix<T, N>::operator()(const Args&... args) const
+    matrix<T, N, A>::operator()(const Args&... args) const
     {
       matrix_slice<N> d {desc, args...};
       return {d, data()};
@@ -323,18 +505,18 @@ template <typename T, std::size_t N>
 
 // Row
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<T, N-1>
-  matrix<T, N>::row(std::size_t n)
+  matrix<T, N, A>::row(std::size_t n)
   {
     assert(n < rows());
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
     return {row, data()};
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<const T, N-1>
-  matrix<T, N>::row(std::size_t n) const
+  matrix<T, N, A>::row(std::size_t n) const
   {
     assert(n < rows());
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
@@ -343,18 +525,18 @@ template <typename T, std::size_t N>
 
 // Column
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<T, N-1>
-  matrix<T, N>::col(std::size_t n)
+  matrix<T, N, A>::col(std::size_t n)
   {
     assert(n < cols());
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
     return {col, data()};
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<const T, N-1>
-  matrix<T, N>::col(std::size_t n) const
+  matrix<T, N, A>::col(std::size_t n) const
   {
     assert(n < cols());
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
@@ -363,78 +545,77 @@ template <typename T, std::size_t N>
 
 
 // Scalar applicateion
-template <typename T, std::size_t N>
+//
+// Since the elements of a matrix are contiguous, the operation is applied
+// directly to the underlying array. See matrix.impl/kernels.hpp.
+template <typename T, std::size_t N, typename A>
   template <typename F>
-    inline matrix<T, N>&
-    matrix<T, N>::apply(F f)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::apply(F f)
     {
-      for (auto& x : elems)
-        f(x);
+      matrix_impl::apply_slice(desc, data(), f);
       return *this;
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename F>
-    inline matrix<T, N>&
-    matrix<T, N>::apply(const M& m, F f)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::apply(const M& m, F f)
     {
       assert(same_extents(desc, m.descriptor()));
-      auto i = begin();
-      auto j = m.begin();
-      while (i != end()) {
-        f(*i, *j);
-        ++i;
-        ++j;
-      }
+      matrix_impl::apply_matrix(desc, data(), m, f);
       return *this;
     }
 
 // Scalar assignment
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator=(const T& x) 
   { 
-    return apply([&](T& x) { x = x; });
+    return apply(matrix_impl::scalar_op<matrix_impl::assign_op, T>(x));
   }
 
 // Scalar addition
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator+=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator+=(const T& x) 
   { 
-    return apply([&](T& y) { y += x; });
+    return apply(matrix_impl::scalar_op<matrix_impl::plus_assign_op, T>(x));
   }
 
 // Scalar subtraction      
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator-=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator-=(const T& x) 
   {
-    return apply([&](T& y) { y -= x; });
+    return apply(matrix_impl::scalar_op<matrix_impl::minus_assign_op, T>(x));
   }
 
 // Scalar multiplication
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator*=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator*=(const T& x) 
   { 
-    return apply([&](T& y) { y *= x; });
+    using Op = matrix_impl::multiplies_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
   }
 
 // Scalar division
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator/=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator/=(const T& x) 
   { 
-    return apply([&](T& y) { y /= x; });
+    using Op = matrix_impl::divides_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
   }
 
 // Scalar remainder    
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator%=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator%=(const T& x) 
   { 
-    return apply([&](T& y) { y %= x; });
+    using Op = matrix_impl::modulus_assign_op;
+    return apply(matrix_impl::scalar_op<Op, T>(x));
   }
 
 // NOTE: Matrix addition and subtraction require the arguments to have the
@@ -442,41 +623,38 @@ template <typename T, std::size_t N>
 // have the same dimensions, then they have the same size.
 
 // Matrix addition
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M>
-    inline matrix<T, N>&
-    matrix<T, N>::operator+=(const M& m)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::operator+=(const M& m)
     {
-      using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t += u; });
+      return apply(m, matrix_impl::plus_assign_op{});
     }
 
 // Matrix subtraction
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M>
-    inline matrix<T, N>&
-    matrix<T, N>::operator-=(const M& m)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::operator-=(const M& m)
     {
-      using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t -= u; });
+      return apply(m, matrix_impl::minus_assign_op{});
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline void
-  matrix<T, N>::swap(matrix& x)
+  matrix<T, N, A>::swap(matrix& x)
   {
     using std::swap;
     swap(desc, x.desc);
     elems.swap(x.elems);
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline void
-  matrix<T, N>::swap_rows(std::size_t m, std::size_t n)
+  matrix<T, N, A>::swap_rows(std::size_t m, std::size_t n)
   {
-    auto a = (*this)[m];
-    auto b = (*this)[n];
-    std::swap_ranges(a.begin(), a.end(), b.begin());
+    std::size_t k = desc.strides[0];
+    matrix_impl::swap_n(data() + m * k, data() + n * k, k);
   }
 
 
@@ -486,8 +664,8 @@ template <typename T, std::size_t N>
 // The type matrix<T, 0> is not really a matrix. It stores a single scalar
 // of type T and can only be converted to a reference to that type.
 
-template <typename T>
-  class matrix<T, 0>
+template <typename T, typename A>
+  class matrix<T, 0, A>
   {
   public:
     matrix() = default;
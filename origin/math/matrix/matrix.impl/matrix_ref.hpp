@@ -58,11 +58,17 @@ template <typename T, std::size_t N>
     // is a recipe for leaking memory.
     //
     // Assigning from a sub-matrix copies the values from x.
-    matrix_ref(matrix<value_type, N>& x);
-    matrix_ref(const matrix<value_type, N>& x);
-    matrix_ref(matrix<value_type, N>&&) = delete;
+    template <typename A>
+      matrix_ref(matrix<value_type, N, A>& x);
 
-    matrix_ref& operator=(const matrix<value_type, N>& x);
+    template <typename A>
+      matrix_ref(const matrix<value_type, N, A>& x);
+
+    template <typename A>
+      matrix_ref(matrix<value_type, N, A>&&) = delete;
+
+    template <typename A>
+      matrix_ref& operator=(const matrix<value_type, N, A>& x);
 
 
     // Submatrix conversion
@@ -76,6 +82,14 @@ template <typename T, std::size_t N>
       matrix_ref& operator=(const matrix_ref<U, N>& x);
 
 
+    // Expression assignment
+    //
+    // Evaluate the matrix expression x directly into the elements of this
+    // sub-matrix.
+    template <typename Op, typename L, typename R>
+      matrix_ref& operator=(const matrix_expr<Op, L, R>& x);
+
+
     // Destruction
     ~matrix_ref() = default;
 
@@ -224,27 +238,30 @@ template <typename T, std::size_t N>
 
 
 template <typename T, std::size_t N>
-  inline
-  matrix_ref<T, N>::matrix_ref(matrix<value_type, N>& x)
-    : desc(x.descriptor()), ptr(x.data())
-  { }
+  template <typename A>
+    inline
+    matrix_ref<T, N>::matrix_ref(matrix<value_type, N, A>& x)
+      : desc(x.descriptor()), ptr(x.data())
+    { }
 
 template <typename T, std::size_t N>
-  inline
-  matrix_ref<T, N>::matrix_ref(const matrix<value_type, N>& x)
-    : desc(x.descriptor()), ptr(x.data())
-  { }
+  template <typename A>
+    inline
+    matrix_ref<T, N>::matrix_ref(const matrix<value_type, N, A>& x)
+      : desc(x.descriptor()), ptr(x.data())
+    { }
 
 template <typename T, std::size_t N>
-  inline matrix_ref<T, N>&
-  matrix_ref<T, N>::operator=(const matrix<value_type, N>& x)
-  {
-      // FIXME: Is this right? Should we just assign values or resize the
-      // vector based o what x is?
-    assert(same_extents(desc, x.descriptor()));
-    apply(x, [](T& a, const T& b) { a = b; });
-    return *this;
-  }
+  template <typename A>
+    inline matrix_ref<T, N>&
+    matrix_ref<T, N>::operator=(const matrix<value_type, N, A>& x)
+    {
+        // FIXME: Is this right? Should we just assign values or resize the
+        // vector based o what x is?
+      assert(same_extents(desc, x.descriptor()));
+      apply(x, matrix_impl::assign_op{});
+      return *this;
+    }
 
 template <typename T, std::size_t N>
   template <typename U>
@@ -261,7 +278,18 @@ template <typename T, std::size_t N>
       // FIXME: Is this right? Should we just assign values or resize the
       // vector based o what x is?
       assert(same_extents(desc, x.descriptor()));
-      apply(x, [](T& a, const U& b) { a = b; });
+      apply(x, matrix_impl::assign_op{});
+      return *this;
+    }
+
+
+template <typename T, std::size_t N>
+  template <typename Op, typename L, typename R>
+    inline matrix_ref<T, N>&
+    matrix_ref<T, N>::operator=(const matrix_expr<Op, L, R>& x)
+    {
+      assert(same_extents(desc, x.descriptor()));
+      apply(x, matrix_impl::assign_op{});
       return *this;
     }
 
@@ -345,13 +373,16 @@ template <typename T, std::size_t N>
 
 
 
+// Apply
+//
+// The operation is applied using the kernels in matrix.impl/kernels.hpp, which
+// select a traversal based on the layout of the slice.
 template <typename T, std::size_t N>
   template <typename F>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::apply(F f)
     {
-      for (auto i = begin(); i != end(); ++i)
-        f(*i);
+      matrix_impl::apply_slice(desc, ptr, f);
       return *this;
     }
 
@@ -361,13 +392,7 @@ template <typename T, std::size_t N>
     matrix_ref<T, N>::apply(const M& m, F f)
     {
       assert(same_extents(desc, m.descriptor()));
-      auto i = begin();
-      auto j = m.begin();
-      while (i != end()) {
-        f(*i, *j);
-        ++i;
-        ++j;
-      }
+      matrix_impl::apply_matrix(desc, ptr, m, f);
       return *this;
     }
 
@@ -377,7 +402,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator=(const value_type& value)  
   {
-    return apply([&](T& x) { x = value; });
+    using Op = matrix_impl::assign_op;
+    return apply(matrix_impl::scalar_op<Op, value_type>(value));
   }
     
 // Scalar addition.
@@ -385,7 +411,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator+=(const value_type& value) 
   { 
-    return apply([&](T& x) { x += value; });
+    using Op = matrix_impl::plus_assign_op;
+    return apply(matrix_impl::scalar_op<Op, value_type>(value));
   }
 
 // Scalar subtraction
@@ -393,7 +420,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator-=(value_type const& value) 
   { 
-    return apply([&](T& x) { x -= value; });
+    using Op = matrix_impl::minus_assign_op;
+    return apply(matrix_impl::scalar_op<Op, value_type>(value));
   }
 
 // Scalar multiplication
@@ -401,7 +429,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator*=(value_type const& value) 
   { 
-    return apply([&](T& x) { x *= value; });
+    using Op = matrix_impl::multiplies_assign_op;
+    return apply(matrix_impl::scalar_op<Op, value_type>(value));
   }
 
 // Scalar division
@@ -409,7 +438,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator/=(value_type const& value) 
   { 
-    return apply([&](T& x) { x /= value; });
+    using Op = matrix_impl::divides_assign_op;
+    return apply(matrix_impl::scalar_op<Op, value_type>(value));
   }
 
 // Scalar modulus
@@ -418,7 +448,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator%=(value_type const& value) 
   { 
-    return apply([&](T& x) { x %= value; });
+    using Op = matrix_impl::modulus_assign_op;
+    return apply(matrix_impl::scalar_op<Op, value_type>(value));
   }
 
 // Matrix addition
@@ -427,8 +458,7 @@ template <typename T, std::size_t N>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::operator+=(const M& m)
     {
-      using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t += u; });
+      return apply(m, matrix_impl::plus_assign_op{});
     }
 
 // Matrix subtraction
@@ -437,8 +467,7 @@ template <typename T, std::size_t N>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::operator-=(const M& m)
     {
-      using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t -= u; });
+      return apply(m, matrix_impl::minus_assign_op{});
     }
 
 
@@ -457,9 +486,8 @@ template <typename T, std::size_t N>
     inline void
     matrix_ref<T, N>::swap_rows(std::size_t m, std::size_t n)
     {
-      auto a = (*this)[m];
-      auto b = (*this)[n];
-      std::swap_ranges(a.begin(). a.end(), b.begin());
+      matrix_impl::swap_slice(matrix_impl::row_block(desc, m, m + 1),
+                              matrix_impl::row_block(desc, n, n + 1), ptr);
     }
 
 
@@ -488,3 +516,206 @@ template <typename T, std::size_t N>
     private:
       T* ptr;
     };
+
+
+// -------------------------------------------------------------------------- //
+// Dense reference                                            [matrix.dense_ref]
+//
+// A dense_ref is a reference to elements of a matrix whose innermost stride
+// is 1, which is known statically. Its elements are accessed by computing
+// the offset i * s0 + ... + k from the outer strides alone, so that in a
+// loop such as
+//
+//    auto a = dense(m);
+//    for (std::size_t k = 0; k != n; ++k)
+//      a(i, k) += x * b(j, k);
+//
+// the offset of a(i, k) is base + i * ld + k, the row offset is hoisted out
+// of the loop, and the loop is vectorized. Matrices and the rows and row
+// slices of matrices have unit innermost stride; a column of a row-major
+// matrix does not, and cannot be referred to by a dense_ref.
+//
+// A dense_ref is a lightweight view, like a pointer: it is cheap to copy,
+// and accessing its elements through a const dense_ref yields references
+// to T. It converts to a matrix_ref for use with the other operations.
+//
+// Template parameters:
+//    T -- The underlying value type of the matrix, possibly const.
+//    N -- The order of the matrix (number of extents).
+template <typename T, std::size_t N>
+  class dense_ref
+  {
+  public:
+    static constexpr std::size_t order = N;
+
+    using value_type = Remove_const<T>;
+
+    // Slice initialization
+    //
+    // Initialize the dense_ref over the slice s of the elements pointed to
+    // by p. The innermost stride of s must be 1.
+    dense_ref(const matrix_slice<N>& s, T* p);
+
+    template <typename A>
+      dense_ref(matrix<value_type, N, A>& x);
+
+    template <typename A>
+      dense_ref(const matrix<value_type, N, A>& x);
+
+    template <typename U>
+      dense_ref(matrix_ref<U, N> x);
+
+    template <typename U>
+      dense_ref(const dense_ref<U, N>& x);
+
+
+    // Properties
+    std::size_t extent(std::size_t n) const { return extents[n]; }
+    std::size_t rows() const { return extent(0); }
+    std::size_t cols() const { return extent(1); }
+    std::size_t size() const;
+
+    // Returns the stride of the nth dimension. The innermost stride is 1.
+    std::size_t stride(std::size_t n) const { return strides[n]; }
+
+    // Returns the slice describing the elements, relative to data().
+    matrix_slice<N> descriptor() const;
+
+
+    // Subscripting
+    template <typename... Args>
+      Requires<matrix_impl::Index_sequence<Args...>(), T&>
+      operator()(Args... args) const;
+
+    // Returns a dense_ref referring to the nth row.
+    dense_ref<T, N-1> row(std::size_t n) const;
+    dense_ref<T, N-1> operator[](std::size_t n) const { return row(n); }
+
+
+    // Data access
+    T* data() const { return ptr; }
+
+
+    // Conversion
+    operator matrix_ref<T, N>() const { return {descriptor(), ptr}; }
+
+  private:
+    template <typename U, std::size_t M> friend class dense_ref;
+
+    dense_ref(T* p, const std::size_t* exts, const std::size_t* strs);
+
+    T* ptr;                  // Points to the first element
+    std::size_t extents[N];
+    std::size_t strides[N];  // The innermost stride is always 1
+  };
+
+
+template <typename T, std::size_t N>
+  inline
+  dense_ref<T, N>::dense_ref(const matrix_slice<N>& s, T* p)
+    : dense_ref(p + s.start, s.extents, s.strides)
+  {
+    assert(s.strides[N - 1] == 1);
+  }
+
+template <typename T, std::size_t N>
+  template <typename A>
+    inline
+    dense_ref<T, N>::dense_ref(matrix<value_type, N, A>& x)
+      : dense_ref(x.descriptor(), x.data())
+    { }
+
+template <typename T, std::size_t N>
+  template <typename A>
+    inline
+    dense_ref<T, N>::dense_ref(const matrix<value_type, N, A>& x)
+      : dense_ref(x.descriptor(), x.data())
+    { }
+
+template <typename T, std::size_t N>
+  template <typename U>
+    inline
+    dense_ref<T, N>::dense_ref(matrix_ref<U, N> x)
+      : dense_ref(x.descriptor(), x.data())
+    { }
+
+template <typename T, std::size_t N>
+  template <typename U>
+    inline
+    dense_ref<T, N>::dense_ref(const dense_ref<U, N>& x)
+      : dense_ref(x.ptr, x.extents, x.strides)
+    { }
+
+template <typename T, std::size_t N>
+  inline
+  dense_ref<T, N>::dense_ref(T* p, 
+                             const std::size_t* exts, 
+                             const std::size_t* strs)
+    : ptr(p)
+  {
+    std::copy_n(exts, N, extents);
+    std::copy_n(strs, N, strides);
+  }
+
+template <typename T, std::size_t N>
+  inline std::size_t
+  dense_ref<T, N>::size() const
+  {
+    std::multiplies<std::size_t> mul;
+    return std::accumulate(extents, extents + N, std::size_t(1), mul);
+  }
+
+template <typename T, std::size_t N>
+  inline matrix_slice<N>
+  dense_ref<T, N>::descriptor() const
+  {
+    matrix_slice<N> s;
+    s.start = 0;
+    s.size = size();
+    std::copy_n(extents, N, s.extents);
+    std::copy_n(strides, N, s.strides);
+    return s;
+  }
+
+template <typename T, std::size_t N>
+  template <typename... Args>
+    inline Requires<matrix_impl::Index_sequence<Args...>(), T&>
+    dense_ref<T, N>::operator()(Args... args) const
+    {
+      static_assert(sizeof...(Args) == N, "");
+      assert(matrix_impl::check_bounds(descriptor(), args...));
+      return ptr[matrix_impl::unit_offset<0>(strides, std::size_t(args)...)];
+    }
+
+template <typename T, std::size_t N>
+  inline dense_ref<T, N-1>
+  dense_ref<T, N>::row(std::size_t n) const
+  {
+    static_assert(N > 1, "");
+    assert(n < extents[0]);
+    return {ptr + n * strides[0], extents + 1, strides + 1};
+  }
+
+
+// Returns a dense_ref referring to the elements of the matrix or matrix_ref
+// m, whose innermost stride must be 1.
+template <typename T, std::size_t N, typename A>
+  inline dense_ref<T, N>
+  dense(matrix<T, N, A>& m)
+  {
+    return m;
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline dense_ref<const T, N>
+  dense(const matrix<T, N, A>& m)
+  {
+    return m;
+  }
+
+template <typename T, std::size_t N>
+  inline dense_ref<T, N>
+  dense(matrix_ref<T, N> m)
+  {
+    return m;
+  }
@@ -62,65 +62,81 @@ template <typename M1, typename M2>
   }
 
 
-// NOTE: This operation is kind of funny because it is heterogeneous in its
-// result type. If we try to concept check Matrix<R, R> (where R is a matrix
-// ref type), we would normally be asking for an operation a homogeneous
-// operator+(R,R)->R. That's not what we have.
+// NOTE: The element-wise operations below are heterogeneous in their result
+// type. They do not return matrices; they return matrix expressions (see
+// matrix.impl/expression.hpp) that are evaluated when assigned to a matrix
+// or matrix_ref. If we try to concept check Matrix<R, R> (where R is a
+// matrix ref type), we would normally be asking for an operation a
+// homogeneous operator+(R,R)->R. That's not what we have.
 //
 // In order to check this concept, we have to weaken the result type. The
 // C++0x concepts required that the result be convertible to the argument
-// types. That doesn't work here because matrix is not convertible to matrix
-// ref. It's the other way around.
+// types. That doesn't work here because an expression is not convertible to
+// matrix ref. It's the other way around.
 //
 // The correct way to check this is to say that the result type must share
 // a common type with the domain type. That is, if U is the result type of the
 // expression t + t (with t having type T), then Common<T, U> must be true.
 //
-// NOTE: We may be able to generalize and differentiate the addition of 
-// matrices vs. matrix references in the the future. A fully general matrix
-// slice would have the same properties as matrix_ref w.r.t. to addition
-// and subtraction.
+// Every operand may be a matrix, a matrix_ref, or a matrix expression. Matrix
+// operands must have the same order and value type.
+
+namespace matrix_impl
+{
+  // The type of expression computing Op over the operands M1 and M2.
+  template <typename Op, typename M1, typename M2>
+    using Binary_expr = matrix_expr<Op, Operand_type<M1>, Operand_type<M2>>;
+
+  // The type of expression computing Op over the operand M and a scalar.
+  template <typename Op, typename M>
+    using Scalar_right_expr = 
+      matrix_expr<Op, Operand_type<M>, scalar_leaf<Value_type<M>>>;
+
+  // The type of expression computing Op over a scalar and the operand M.
+  template <typename Op, typename M>
+    using Scalar_left_expr = 
+      matrix_expr<Op, scalar_leaf<Value_type<M>>, Operand_type<M>>;
+
+  template <template <typename> class Op, typename M1, typename M2>
+    inline Binary_expr<Op<Value_type<M1>>, M1, M2>
+    make_expr(const M1& a, const M2& b)
+    {
+      return {make_operand(a), make_operand(b)};
+    }
+
+  template <template <typename> class Op, typename M>
+    inline Scalar_right_expr<Op<Value_type<M>>, M>
+    make_scalar_expr(const M& a, const Value_type<M>& n)
+    {
+      using S = scalar_leaf<Value_type<M>>;
+      return {make_operand(a), S(n)};
+    }
+
+  template <template <typename> class Op, typename M>
+    inline Scalar_left_expr<Op<Value_type<M>>, M>
+    make_scalar_expr(const Value_type<M>& n, const M& a)
+    {
+      using S = scalar_leaf<Value_type<M>>;
+      return {S(n), make_operand(a)};
+    }
+
+} // namespace matrix_impl
 
 
+//////////////////////////////////////////////////////////////////////////////
 // Matrix addition
 //
 // Adding two matrices with the same shape adds corresponding elements in
 // each operatand.
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix<T, N>& a, const matrix<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& a, const matrix<T, N>& b)
+template <typename M1, typename M2>
+  inline Requires<
+    matrix_impl::Matrix_operands<M1, M2>(),
+    matrix_impl::Binary_expr<std::plus<Value_type<M1>>, M1, M2>
+  >
+  operator+(const M1& a, const M2& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
+    return matrix_impl::make_expr<std::plus>(a, b);
   }
 
 
@@ -129,41 +145,15 @@ template <typename T, std::size_t N>
 //
 // Subtracting one matrix from another with the same shape subtracts
 // corresponding elements in each operatand.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix<T, N>& a, const matrix<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return a -= b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
-  }
-
-// Cross-type subtraction
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& a, const matrix<T, N>& b)
+template <typename M1, typename M2>
+  inline Requires<
+    matrix_impl::Matrix_operands<M1, M2>(),
+    matrix_impl::Binary_expr<std::minus<Value_type<M1>>, M1, M2>
+  >
+  operator-(const M1& a, const M2& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
+    return matrix_impl::make_expr<std::minus>(a, b);
   }
 
 
@@ -176,36 +166,24 @@ template <typename T, std::size_t N>
 //
 //    a + n
 //    n + a
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator+(const matrix<T, N>& x, const T& n)
-  {
-    matrix<T, N> result = x;
-    return result += n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator+(const T& n, const matrix<T, N>& x)
-  {
-    matrix<T, N> result = x;
-    return result += n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_right_expr<std::plus<Value_type<M>>, M>
+  >
+  operator+(const M& x, const Value_type<M>& n)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    return matrix_impl::make_scalar_expr<std::plus>(x, n);
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const T& n, const matrix_ref<T, N>& x)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_left_expr<std::plus<Value_type<M>>, M>
+  >
+  operator+(const Value_type<M>& n, const M& x)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    return matrix_impl::make_scalar_expr<std::plus>(n, x);
   }
 
 
@@ -218,20 +196,14 @@ template <typename T, std::size_t N>
 //    a - n <=> a + -n;
 //
 // It is not possible to subtract a matrix from a scalar.
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator-(const matrix<T, N>& x, const T& n)
-  {
-    matrix<T, N> result = x;
-    return result += n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_right_expr<std::minus<Value_type<M>>, M>
+  >
+  operator-(const M& x, const Value_type<M>& n)
   {
-    matrix<T, N> result = x;
-    return result -= n;
+    return matrix_impl::make_scalar_expr<std::minus>(x, n);
   }
 
 
@@ -245,36 +217,24 @@ template <typename T, std::size_t N>
 //    a * n
 //    n * a
 //
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const matrix<T, N>& x, const T& n)
-  {
-    matrix<T, N> result = x;
-    return result *= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const T& n, const matrix<T, N>& x)
-  {
-    matrix<T, N> result = x;
-    return result *= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_right_expr<std::multiplies<Value_type<M>>, M>
+  >
+  operator*(const M& x, const Value_type<M>& n)
   {
-    matrix<T, N> result = x;
-    return result *= n;
+    return matrix_impl::make_scalar_expr<std::multiplies>(x, n);
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const T& n, const matrix_ref<T, N>& x)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_left_expr<std::multiplies<Value_type<M>>, M>
+  >
+  operator*(const Value_type<M>& n, const M& x)
   {
-    matrix<T, N> result = x;
-    return result *= n;
+    return matrix_impl::make_scalar_expr<std::multiplies>(n, x);
   }
 
 
@@ -287,20 +247,14 @@ template <typename T, std::size_t N>
 //    a / n <=> a * 1/n
 //
 // It is not possible to divide a scalar by a matrix.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator/(const matrix<T, N>& a, const T& n)
-  {
-    matrix<T, N> result = a;
-    return result /= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator/(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_right_expr<std::divides<Value_type<M>>, M>
+  >
+  operator/(const M& x, const Value_type<M>& n)
   {
-    matrix<T, N> result = x;
-    return result /= n;
+    return matrix_impl::make_scalar_expr<std::divides>(x, n);
   }
 
 
@@ -312,20 +266,149 @@ template <typename T, std::size_t N>
 // given scalar value.
 //
 // This operation is only available when T is an Integer type.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator%(const matrix<T, N>& a, const T& n)
+template <typename M>
+  inline Requires<
+    matrix_impl::Matrix_operand<M>(),
+    matrix_impl::Scalar_right_expr<std::modulus<Value_type<M>>, M>
+  >
+  operator%(const M& x, const Value_type<M>& n)
   {
-    matrix<T, N> result = a;
-    return result %= n;
+    return matrix_impl::make_scalar_expr<std::modulus>(x, n);
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator%(const matrix_ref<T, N>& x, const T& n)
+
+//////////////////////////////////////////////////////////////////////////////
+// Rvalue operands
+//
+// When an operand of an element-wise operation is a matrix that is about to
+// expire, the operation is computed in place, in the elements of that
+// operand, which is then moved into the result. For example:
+//
+//    matrix<double, 2> r = f(x) + b * 2.0;
+//
+// adds b * 2.0 to the result of f(x) and moves it into r, allocating no
+// elements. Likewise, std::move(a) - b reuses the elements of a, and
+// a - std::move(b) those of b. These overloads return matrices, not
+// expressions.
+//
+// The other operand is read at the position being written, as when an
+// expression is assigned to one of its operands.
+template <typename T, std::size_t N, typename A, typename M>
+  inline Requires<
+    matrix_impl::Matrix_operands<matrix<T, N, A>, M>(), matrix<T, N, A>
+  >
+  operator+(matrix<T, N, A>&& a, const M& b)
+  {
+    assert(same_extents(a, b));
+    a += b;
+    return std::move(a);
+  }
+
+template <typename M, typename T, std::size_t N, typename A>
+  inline Requires<
+    matrix_impl::Matrix_operands<M, matrix<T, N, A>>(), matrix<T, N, A>
+  >
+  operator+(const M& a, matrix<T, N, A>&& b)
+  {
+    assert(same_extents(a, b));
+    b += a;
+    return std::move(b);
+  }
+
+template <typename T, std::size_t N, typename A1, typename A2>
+  inline matrix<T, N, A1>
+  operator+(matrix<T, N, A1>&& a, matrix<T, N, A2>&& b)
+  {
+    assert(same_extents(a, b));
+    a += b;
+    return std::move(a);
+  }
+
+template <typename T, std::size_t N, typename A, typename M>
+  inline Requires<
+    matrix_impl::Matrix_operands<matrix<T, N, A>, M>(), matrix<T, N, A>
+  >
+  operator-(matrix<T, N, A>&& a, const M& b)
+  {
+    assert(same_extents(a, b));
+    a -= b;
+    return std::move(a);
+  }
+
+template <typename M, typename T, std::size_t N, typename A>
+  inline Requires<
+    matrix_impl::Matrix_operands<M, matrix<T, N, A>>(), matrix<T, N, A>
+  >
+  operator-(const M& a, matrix<T, N, A>&& b)
+  {
+    assert(same_extents(a, b));
+    b.apply(a, matrix_impl::subtract_from_op{});
+    return std::move(b);
+  }
+
+template <typename T, std::size_t N, typename A1, typename A2>
+  inline matrix<T, N, A1>
+  operator-(matrix<T, N, A1>&& a, matrix<T, N, A2>&& b)
+  {
+    assert(same_extents(a, b));
+    a -= b;
+    return std::move(a);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator+(matrix<T, N, A>&& x, const Identity<T>& n)
+  {
+    x += n;
+    return std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator+(const Identity<T>& n, matrix<T, N, A>&& x)
+  {
+    x += n;
+    return std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator-(matrix<T, N, A>&& x, const Identity<T>& n)
+  {
+    x -= n;
+    return std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator*(matrix<T, N, A>&& x, const Identity<T>& n)
+  {
+    x *= n;
+    return std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator*(const Identity<T>& n, matrix<T, N, A>&& x)
+  {
+    x *= n;
+    return std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator/(matrix<T, N, A>&& x, const Identity<T>& n)
+  {
+    x /= n;
+    return std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator%(matrix<T, N, A>&& x, const Identity<T>& n)
   {
-    matrix<T, N> result = x;
-    return result %= n;
+    x %= n;
+    return std::move(x);
   }
 
 
@@ -333,6 +416,9 @@ template <typename T, std::size_t N>
 template <typename M1, typename M2, typename M3>
   void matrix_product(const M1&, const M2&, M3&);
 
+template <typename M1, typename M2, typename M3, typename R>
+  void matrix_product(const M1&, const M2&, M3&, R);
+
 template <typename M1, typename M2, typename M3>
   void hadamard_product(const M1&, const M2&, M3&);
 
@@ -344,11 +430,11 @@ template <typename M1, typename M2, typename M3>
 // Two 2D matrices a (m x p) and b (p x n) can be multiplied, resulting in a
 // matrix c (m x n). Note that the "inner" dimension of the operands must
 // be the same.
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix<T, 2>& a, const matrix<T, 2>& b) 
+template <typename T, typename A>
+  inline matrix<T, 2, A>
+  operator*(const matrix<T, 2, A>& a, const matrix<T, 2, A>& b) 
   {
-    matrix<T, 2> result (a.rows(), b.cols());
+    matrix<T, 2, A> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
@@ -357,26 +443,26 @@ template <typename T>
   inline matrix<T, 2>
   operator*(const matrix_ref<T, 2>& a, const matrix_ref<T, 2>& b) 
   {
-    matrix<T, 2> result (a.dims());
+    matrix<T, 2> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
 
 // Cross product multiplication.
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix<T, 2>& a, const matrix_ref<T, 2>& b) 
+template <typename T, typename A>
+  inline matrix<T, 2, A>
+  operator*(const matrix<T, 2, A>& a, const matrix_ref<T, 2>& b) 
   {
-    matrix<T, 2> result (a.dims());
+    matrix<T, 2, A> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
 
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix_ref<T, 2>& a, const matrix<T, 2>& b) 
+template <typename T, typename A>
+  inline matrix<T, 2, A>
+  operator*(const matrix_ref<T, 2>& a, const matrix<T, 2, A>& b) 
   {
-    matrix<T, 2> result (a.dims());
+    matrix<T, 2, A> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
@@ -386,16 +472,34 @@ template <typename T>
 //////////////////////////////////////////////////////////////////////////////
 // Matrix Product
 //
-// The usual meaning of the operation.
+// Compute out += a * b, where a is m x p, b is p x n, and out is m x n.
+//
+// When the operands are matrices or matrix_refs with contiguous rows, the
+// product is computed by a cache-blocked, register-tiled kernel operating
+// directly on the underlying memory (see matrix.impl/product.hpp). Otherwise,
+// the product is computed element by element.
+//
+// Given a semiring r (see [matrix.semiring]), compute out = out (+) a (*) b
+// instead, with the same kernels. For example, one step of the shortest
+// path lengths of a graph with edge weights w:
+//
+//    // d2(i, j) = min over k of d(i, k) + w(k, j)
+//    matrix_product(d, w, d2, min_plus{});
 //
-// FIXME: This is not terribly efficient. Implement a more efficient algorithm
-// than this brute force version.
+// where d2 is initialized to the zero of the semiring (infinity).
 //
 // FIXME: I'm not at all sure that this generalizes to n dimensions. It might
 // be the case that we want all M's to be 2 dimensions (as they are now!).
 template <typename M1, typename M2, typename M3>
-  void 
+  inline void
   matrix_product(const M1& a, const M2& b, M3& out)
+  {
+    matrix_product(a, b, out, plus_times{});
+  }
+
+template <typename M1, typename M2, typename M3, typename R>
+  void
+  matrix_product(const M1& a, const M2& b, M3& out, R r)
   {
     static_assert(M1::order == 2, "");
     static_assert(M2::order == 2, "");
@@ -403,15 +507,46 @@ template <typename M1, typename M2, typename M3>
     assert(cols(a) == rows(b));
     assert(rows(a) == rows(out));
     assert(cols(b) == cols(out));
+    ORIGIN_TIME_SCOPE("matrix.product");
 
-    using Size = Size_type<M3>;
+    using Fast = std::integral_constant<
+      bool, matrix_impl::Blocked_product<M1, M2, M3>()
+    >;
+    matrix_impl::product(a, b, out, r, Fast{});
+  }
 
-    for (Size i = 0; i != rows(a); ++i) {
-      for (Size j = 0; j < cols(b); ++j) {
-        for (Size k = 0; k < rows(b); ++k)
-          out(i, j) += a(i, k) * b(k, j);
-      }
+
+//////////////////////////////////////////////////////////////////////////////
+// Semiring Closure
+//
+// Returns the closure of the square matrix a over the semiring r: the sum
+// (+) of the powers I, A, A^2, ..., where I has the semiring's one on its
+// diagonal and zero elsewhere. The closure is computed by squaring I (+) A
+// until it no longer changes, which takes at most ceil(log2(n)) products.
+// Over min_plus, with the edge weights of a graph in a (and infinity for
+// absent edges), this is the matrix of all pairs shortest path lengths; over
+// or_and, it is the reflexive transitive closure. The semiring must be
+// idempotent (its plus satisfies x (+) x == x), and over min_plus the graph
+// must have no negative cycles.
+template <typename T, typename A, typename R>
+  matrix<T, 2, A>
+  semiring_closure(const matrix<T, 2, A>& a, R r)
+  {
+    assert(a.rows() == a.cols());
+    const std::size_t n = a.rows();
+    matrix<T, 2, A> c = a;
+    for (std::size_t i = 0; i != n; ++i)
+      c(i, i) = R::plus(c(i, i), R::template one<T>());
+
+    matrix<T, 2, A> p(n, n);
+    for (std::size_t len = 1; len + 1 < n; len *= 2) {
+      p = R::template zero<T>();
+      matrix_product(c, c, p, r);
+      if (p == c)
+        break;
+      c.swap(p);
     }
+    return c;
   }
 
 
@@ -421,15 +556,433 @@ template <typename M1, typename M2, typename M3>
 // The hadamard product can be easly generalized to N-dimensional matrices 
 // since the operation is performed elementwise. The operands only need the
 // same shape.
+//
+// When the operands are matrices or matrix_refs of one value type, the
+// product is computed over their memory: contiguous operands as arrays,
+// with vector instructions if the value type has them, and others through
+// slice iterators. Large products are divided into blocks of rows that
+// are computed by the product threads (see [matrix.kernels]). The output
+// may be one of the operands.
+
+namespace matrix_impl
+{
+  // Compute c[i] = a[i] * b[i] for the n elements of the arrays.
+  template <typename T>
+    inline Requires<!Simd_type<T>(), void>
+    hadamard_n(const T* a, const T* b, T* c, std::size_t n)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        c[i] = a[i] * b[i];
+    }
+
+  template <typename T>
+    inline Requires<Simd_type<T>(), void>
+    hadamard_n(const T* a, const T* b, T* c, std::size_t n)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      std::size_t i = 0;
+      for ( ; i + W <= n; i += W)
+        V::store(c + i, V::mul(V::load(a + i), V::load(b + i)));
+      for ( ; i != n; ++i)
+        c[i] = a[i] * b[i];
+    }
+
+  // Compute the product over the rows of the slices sa, sb and sc.
+  template <std::size_t N, typename T>
+    void
+    hadamard_slice(const matrix_slice<N>& sa, const T* a,
+                   const matrix_slice<N>& sb, const T* b,
+                   const matrix_slice<N>& sc, T* c)
+    {
+      if (is_contiguous(sa) && is_contiguous(sb) && is_contiguous(sc)) {
+        hadamard_n(a + sa.start, b + sb.start, c + sc.start, sc.size);
+      } else {
+        slice_iterator<const T, N> i(sa, a);
+        slice_iterator<const T, N> j(sb, b);
+        slice_iterator<T, N> k(sc, c);
+        slice_iterator<T, N> last(sc, c, true);
+        for ( ; k != last; ++i, ++j, ++k)
+          *k = *i * *j;
+      }
+    }
+
+  template <typename M1, typename M2, typename M3>
+    void
+    hadamard_product(const M1& a, const M2& b, M3& out, std::true_type)
+    {
+      const auto& sa = a.descriptor();
+      const auto& sb = b.descriptor();
+      const auto& sc = out.descriptor();
+      if (sc.size == 0)
+        return;
+      if (sc.size < parallel_elements) {
+        hadamard_slice(sa, a.data(), sb, b.data(), sc, out.data());
+        return;
+      }
+      parallel_rows(sc.extents[0], sc.size,
+        [&](std::size_t first, std::size_t last) {
+          hadamard_slice(row_block(sa, first, last), a.data(),
+                         row_block(sb, first, last), b.data(),
+                         row_block(sc, first, last), out.data());
+        });
+    }
+
+  template <typename M1, typename M2, typename M3>
+    void
+    hadamard_product(const M1& a, const M2& b, M3& out, std::false_type)
+    {
+      using Mul = std::multiplies<Value_type<M1>>;
+      std::transform(a.begin(), a.end(), b.begin(), out.begin(), Mul{});
+    }
+
+  template <typename M1, typename M2, typename M3>
+    constexpr bool Strided_hadamard()
+    {
+      return Strided_matrix<M1>() && Strided_matrix<M2>()
+          && Strided_matrix<M3>()
+          && Same<Value_type<M1>, Value_type<M3>>()
+          && Same<Value_type<M2>, Value_type<M3>>();
+    }
+
+} // namespace matrix_impl
+
 template <typename M1, typename M2, typename M3>
   void
   hadamard_product(const M1& a, const M2& b, M3& out)
   {
-    assert(a.shape() == b.shape());
-    assert(a.shape() == out.shape());
+    assert(same_extents(a.descriptor(), b.descriptor()));
+    assert(same_extents(a.descriptor(), out.descriptor()));
+
+    using Strided = std::integral_constant<
+      bool, matrix_impl::Strided_hadamard<M1, M2, M3>()
+    >;
+    matrix_impl::hadamard_product(a, b, out, Strided{});
+  }
 
-    using Mul = std::multiplies<Value_type<M1>>;
-    std::transform(a.begin(), a.end(), b.begin(), out.begin(), Mul{});
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Transpose
+//
+// The transpose operation returns a matrix_ref that views the elements of a
+// 2D matrix with its extents and strides exchanged. No elements are copied,
+// so the view refers to the original matrix and is invalidated with it.
+// Element access through the view is strided, so traversing a large view
+// row by row touches a different cache line with every element.
+//
+// When the transposed elements are needed contiguously, transpose_into
+// copies the transpose of a into out. The copy is computed by a
+// cache-oblivious kernel that recursively halves the larger dimension of the
+// operands until both fit in a small tile (the transpose block of the
+// product tuning), so that reads and writes are local at every level of the
+// memory hierarchy. For example:
+//
+//    matrix<double, 2> m(1000, 2000);
+//    auto t = transpose(m);           // A 2000 x 1000 view of m
+//    matrix<double, 2> u(2000, 1000);
+//    transpose_into(m, u);            // u(j, i) == m(i, j)
+//
+// The operands of transpose_into must not overlap.
+
+namespace matrix_impl
+{
+  // Returns the descriptor of the transpose of the 2D slice s.
+  inline matrix_slice<2>
+  transpose_slice(const matrix_slice<2>& s)
+  {
+    matrix_slice<2> t(s.start,
+                      {s.extents[1], s.extents[0]},
+                      {s.strides[1], s.strides[0]});
+    t.size = s.size;
+    return t;
+  }
+
+  // Copy the transpose of the m x n matrix a into the n x m matrix b, where
+  // (ars, acs) and (brs, bcs) are the row and column strides of a and b.
+  // The kernel stops subdividing when both extents are at most block.
+  template <typename T>
+    void
+    transpose_kernel(std::size_t m, std::size_t n,
+                     const T* a, std::size_t ars, std::size_t acs,
+                     T* b, std::size_t brs, std::size_t bcs,
+                     std::size_t block)
+    {
+      // Split the larger dimension in half, transposing the first half
+      // recursively and the second half by iteration.
+      while (m > block || n > block) {
+        if (m >= n) {
+          std::size_t h = m / 2;
+          transpose_kernel(h, n, a, ars, acs, b, brs, bcs, block);
+          a += h * ars;
+          b += h * bcs;
+          m -= h;
+        } else {
+          std::size_t h = n / 2;
+          transpose_kernel(m, h, a, ars, acs, b, brs, bcs, block);
+          a += h * acs;
+          b += h * brs;
+          n -= h;
+        }
+      }
+
+      for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+          b[j * brs + i * bcs] = a[i * ars + j * acs];
+    }
+
+} // namespace matrix_impl
+
+
+template <typename T, typename A>
+  inline matrix_ref<T, 2>
+  transpose(matrix<T, 2, A>& m)
+  {
+    return {matrix_impl::transpose_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 2>
+  transpose(const matrix<T, 2, A>& m)
+  {
+    return {matrix_impl::transpose_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T>
+  inline matrix_ref<T, 2>
+  transpose(matrix_ref<T, 2> m)
+  {
+    return {matrix_impl::transpose_slice(m.descriptor()), m.data()};
+  }
+
+
+// Copy the transpose of the 2D matrix a into out. The extents of out must
+// be the reverse of the extents of a.
+template <typename M1, typename M2>
+  void
+  transpose_into(const M1& a, M2& out)
+  {
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(matrix_impl::Strided_matrix<M2>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 2, "");
+    assert(a.rows() == out.cols());
+    assert(a.cols() == out.rows());
+
+    const matrix_slice<2>& s = a.descriptor();
+    const matrix_slice<2>& t = out.descriptor();
+    matrix_impl::transpose_kernel(a.rows(), a.cols(),
+                                  a.data() + s.start,
+                                  s.strides[0], s.strides[1],
+                                  out.data() + t.start,
+                                  t.strides[0], t.strides[1],
+                                  get_product_tuning<Value_type<M1>>()
+                                    .transpose_block);
+  }
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Reshape, permute and diagonal
+//
+// These operations return a matrix_ref that views the elements of a matrix
+// in another shape. Like the transpose, the view is computed from the
+// descriptor of the matrix, in time proportional to its order, and refers
+// to the original elements.
+//
+//    matrix<double, 3> m(4, 5, 6);
+//    auto r = reshape<2>(m, 20, 6);      // 20 x 6: r(i * 5 + j, k)
+//    auto p = permute_axes(m, 2, 0, 1);  // 6 x 4 x 5: p(k, i, j)
+//    auto d = diag(m);                   // The 4 elements m(i, i, i)
+//
+// reshape<M>(m, dims...) views the elements of m, taken in row-major order,
+// as a matrix of order M with the extents dims, whose product must be the
+// size of m. A matrix can always be reshaped, and so can a contiguous view.
+// A strided view can be reshaped when the dimensions that are merged into
+// one are contiguous with respect to each other: the rows of a column slice
+// cannot be merged, but any of its dimensions can be split.
+//
+// permute_axes(m, order...) views m with its dimensions reordered, so that
+// dimension i of the view is dimension order[i] of m; permute_axes(m, 1, 0)
+// is the transpose of a 2D matrix. diag(m) views the elements whose
+// indexes are all equal, in a matrix of any order, as a vector.
+//
+// If the extents of a reshape do not have the size of m or its strides do
+// not allow it, or if the order of a permutation is not a permutation of
+// the dimensions of m, std::invalid_argument is thrown.
+
+namespace matrix_impl
+{
+  // Returns the descriptor of the reshape of s to the extents dims.
+  template <std::size_t M, std::size_t N>
+    matrix_slice<M>
+    reshape_slice(const matrix_slice<N>& s,
+                  const std::array<std::size_t, M>& dims)
+    {
+      matrix_slice<M> r;
+      r.start = s.start;
+      r.size = s.size;
+      std::size_t size = 1;
+      for (std::size_t i = 0; i != M; ++i)
+        size *= r.extents[i] = dims[i];
+      if (size != s.size)
+        throw std::invalid_argument("reshape: the extents do not have the "
+                                    "size of the matrix");
+
+      // Dimensions of extent 1 have no bearing on the layout.
+      std::size_t es[N + 1], ss[N + 1], n = 0;
+      for (std::size_t i = 0; i != N; ++i)
+        if (s.extents[i] != 1) {
+          es[n] = s.extents[i];
+          ss[n++] = s.strides[i];
+        }
+      std::fill(r.strides, r.strides + M, std::size_t(1));
+      if (size == 0)
+        return r;
+
+      // Match each run of new dimensions to the run of old dimensions with
+      // the same size. The old run must be contiguous, and the strides of
+      // the new run are those of a row-major run ending in the stride of
+      // its last old dimension.
+      std::size_t i = 0, j = 0;
+      while (i != M && j != n) {
+        std::size_t ni = i + 1, nj = j + 1;
+        std::size_t a = r.extents[i], b = es[j];
+        while (a != b) {
+          if (a < b)
+            a *= r.extents[ni++];
+          else
+            b *= es[nj++];
+        }
+        for (std::size_t k = j; k + 1 != nj; ++k)
+          if (ss[k] != es[k + 1] * ss[k + 1])
+            throw std::invalid_argument("reshape: the strides of the "
+                                        "matrix do not allow the shape");
+        r.strides[ni - 1] = ss[nj - 1];
+        for (std::size_t k = ni - 1; k != i; --k)
+          r.strides[k - 1] = r.strides[k] * r.extents[k];
+        i = ni;
+        j = nj;
+      }
+      return r;
+    }
+
+  // Returns the descriptor of s with its dimensions in the given order.
+  template <std::size_t N>
+    matrix_slice<N>
+    permute_slice(const matrix_slice<N>& s,
+                  const std::array<std::size_t, N>& order)
+    {
+      matrix_slice<N> r;
+      r.start = s.start;
+      r.size = s.size;
+      bool seen[N] = { };
+      for (std::size_t i = 0; i != N; ++i) {
+        std::size_t d = order[i];
+        if (d >= N || seen[d])
+          throw std::invalid_argument("permute_axes: the order is not a "
+                                      "permutation of the dimensions");
+        seen[d] = true;
+        r.extents[i] = s.extents[d];
+        r.strides[i] = s.strides[d];
+      }
+      return r;
+    }
+
+  // Returns the descriptor of the diagonal of s.
+  template <std::size_t N>
+    matrix_slice<1>
+    diagonal_slice(const matrix_slice<N>& s)
+    {
+      matrix_slice<1> r;
+      r.start = s.start;
+      r.extents[0] = *std::min_element(s.extents, s.extents + N);
+      r.strides[0] = std::accumulate(s.strides, s.strides + N,
+                                     std::size_t(0));
+      r.size = r.extents[0];
+      return r;
+    }
+
+} // namespace matrix_impl
+
+
+template <std::size_t M, typename T, std::size_t N, typename A,
+          typename... Dims>
+  inline matrix_ref<T, M>
+  reshape(matrix<T, N, A>& m, Dims... dims)
+  {
+    static_assert(sizeof...(Dims) == M, "");
+    std::array<std::size_t, M> x {{std::size_t(dims)...}};
+    return {matrix_impl::reshape_slice<M>(m.descriptor(), x), m.data()};
+  }
+
+template <std::size_t M, typename T, std::size_t N, typename A,
+          typename... Dims>
+  inline matrix_ref<const T, M>
+  reshape(const matrix<T, N, A>& m, Dims... dims)
+  {
+    static_assert(sizeof...(Dims) == M, "");
+    std::array<std::size_t, M> x {{std::size_t(dims)...}};
+    return {matrix_impl::reshape_slice<M>(m.descriptor(), x), m.data()};
+  }
+
+template <std::size_t M, typename T, std::size_t N, typename... Dims>
+  inline matrix_ref<T, M>
+  reshape(matrix_ref<T, N> m, Dims... dims)
+  {
+    static_assert(sizeof...(Dims) == M, "");
+    std::array<std::size_t, M> x {{std::size_t(dims)...}};
+    return {matrix_impl::reshape_slice<M>(m.descriptor(), x), m.data()};
+  }
+
+
+template <typename T, std::size_t N, typename A, typename... Dims>
+  inline matrix_ref<T, N>
+  permute_axes(matrix<T, N, A>& m, Dims... order)
+  {
+    static_assert(sizeof...(Dims) == N, "");
+    std::array<std::size_t, N> x {{std::size_t(order)...}};
+    return {matrix_impl::permute_slice<N>(m.descriptor(), x), m.data()};
+  }
+
+template <typename T, std::size_t N, typename A, typename... Dims>
+  inline matrix_ref<const T, N>
+  permute_axes(const matrix<T, N, A>& m, Dims... order)
+  {
+    static_assert(sizeof...(Dims) == N, "");
+    std::array<std::size_t, N> x {{std::size_t(order)...}};
+    return {matrix_impl::permute_slice<N>(m.descriptor(), x), m.data()};
+  }
+
+template <typename T, std::size_t N, typename... Dims>
+  inline matrix_ref<T, N>
+  permute_axes(matrix_ref<T, N> m, Dims... order)
+  {
+    static_assert(sizeof...(Dims) == N, "");
+    std::array<std::size_t, N> x {{std::size_t(order)...}};
+    return {matrix_impl::permute_slice<N>(m.descriptor(), x), m.data()};
+  }
+
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<T, 1>
+  diag(matrix<T, N, A>& m)
+  {
+    return {matrix_impl::diagonal_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<const T, 1>
+  diag(const matrix<T, N, A>& m)
+  {
+    return {matrix_impl::diagonal_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T, std::size_t N>
+  inline matrix_ref<T, 1>
+  diag(matrix_ref<T, N> m)
+  {
+    return {matrix_impl::diagonal_slice(m.descriptor()), m.data()};
   }
 
 
@@ -0,0 +1,132 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Row and column permutations                                 [matrix.permute]
+//
+// swap_rows(m, i, j) exchanges rows i and j of a matrix, and swap_cols(m, i,
+// j) exchanges columns i and j of a 2D matrix, in place. The rows of a
+// matrix are contiguous, and are exchanged as blocks with vector loads and
+// stores (see [matrix.kernels]); the elements of a column are exchanged one
+// per row.
+//
+// permute_rows(m, p) moves row i of m to row p[i], and permute_cols(m, p)
+// moves column i of a 2D matrix to column p[i], in place. This is the
+// convention of the vertex orderings of the graph library (see
+// graph.ordering): when the vertices of a graph g are numbered [0, n), a
+// matrix whose rows and columns are indexed by vertex, such as an adjacency
+// matrix, is reordered to match relabel(g, p) by
+//
+//    auto p = reverse_cuthill_mckee_ordering(g);
+//    permute_rows(m, p);
+//    permute_cols(m, p);
+//
+// The rows are permuted by following the cycles of p: each row of a cycle
+// is exchanged with the first row of the cycle, which ends up holding the
+// row that moves to it. No row is copied to temporary memory, and the only
+// other memory used is a mark for each row. The columns are permuted one
+// row at a time, through a buffer that holds one row, so that each row is
+// read and written once; the rows are divided among the product threads
+// when the matrix is large.
+//
+// If p does not hold a permutation of the indexes of the rows (or columns)
+// of m, std::invalid_argument is thrown and m is not changed.
+
+namespace matrix_impl
+{
+  // Throws std::invalid_argument if p is not a permutation of [0, n). See
+  // matrix.cpp.
+  void check_permutation(const std::vector<std::size_t>& p, std::size_t n);
+
+} // namespace matrix_impl
+
+
+// Exchange rows i and j of m.
+template <typename M>
+  void
+  swap_rows(M&& m, std::size_t i, std::size_t j)
+  {
+    static_assert(matrix_impl::Strided_matrix<Decay<M>>(), "");
+    const auto& s = m.descriptor();
+    assert(i < s.extents[0] && j < s.extents[0]);
+    if (i != j)
+      matrix_impl::swap_slice(matrix_impl::row_block(s, i, i + 1),
+                              matrix_impl::row_block(s, j, j + 1), m.data());
+  }
+
+// Exchange columns i and j of the 2D matrix m.
+template <typename M>
+  void
+  swap_cols(M&& m, std::size_t i, std::size_t j)
+  {
+    static_assert(matrix_impl::Strided_matrix<Decay<M>>(), "");
+    static_assert(Decay<M>::order == 2, "");
+    const auto& s = m.descriptor();
+    assert(i < s.extents[1] && j < s.extents[1]);
+    if (i != j) {
+      auto* p = m.data() + s.start;
+      matrix_impl::swap_n(p + i * s.strides[1], p + j * s.strides[1],
+                          s.extents[0], s.strides[0]);
+    }
+  }
+
+
+// Move row i of m to row p[i], for each row.
+template <typename M>
+  void
+  permute_rows(M&& m, const std::vector<std::size_t>& p)
+  {
+    static_assert(matrix_impl::Strided_matrix<Decay<M>>(), "");
+    const auto& s = m.descriptor();
+    std::size_t n = s.extents[0];
+    matrix_impl::check_permutation(p, n);
+
+    std::vector<char> done(n, 0);
+    for (std::size_t i = 0; i != n; ++i) {
+      if (done[i])
+        continue;
+      done[i] = 1;
+      auto first = matrix_impl::row_block(s, i, i + 1);
+      for (std::size_t j = p[i]; j != i; j = p[j]) {
+        matrix_impl::swap_slice(first, matrix_impl::row_block(s, j, j + 1),
+                                m.data());
+        done[j] = 1;
+      }
+    }
+  }
+
+// Move column i of the 2D matrix m to column p[i], for each column.
+template <typename M>
+  void
+  permute_cols(M&& m, const std::vector<std::size_t>& p)
+  {
+    using T = Value_type<Decay<M>>;
+    static_assert(matrix_impl::Strided_matrix<Decay<M>>(), "");
+    static_assert(Decay<M>::order == 2, "");
+    const auto& s = m.descriptor();
+    std::size_t n = s.extents[1];
+    matrix_impl::check_permutation(p, n);
+
+    T* a = m.data() + s.start;
+    std::size_t rs = s.strides[0];
+    std::size_t cs = s.strides[1];
+    matrix_impl::parallel_rows(s.extents[0], s.size,
+                               [&](std::size_t first, std::size_t last) {
+      matrix_impl::scratch_buffer<Remove_const<T>> buf(n);
+      for (std::size_t r = first; r != last; ++r) {
+        T* row = a + r * rs;
+        for (std::size_t j = 0; j != n; ++j)
+          buf[j] = row[j * cs];
+        for (std::size_t j = 0; j != n; ++j)
+          row[p[j] * cs] = buf[j];
+      }
+    });
+  }
@@ -0,0 +1,336 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Reduced precision                                          [matrix.precision]
+//
+// The half and bfloat16 classes are 16-bit floating point types for storing
+// the elements of large matrices in half the memory of float. half is the
+// IEEE 754 binary16 format (5 exponent bits and 10 fraction bits), and
+// bfloat16 has the exponent of float with 7 fraction bits. Neither type has
+// arithmetic of its own: each converts implicitly to float, where it is
+// computed, and a value is rounded to the nearest (even) 16-bit value when
+// it is stored. For example:
+//
+//    matrix<half, 2> w = convert<half>(weights);    // From matrix<float, 2>
+//    matrix<float, 2> y(w.rows(), x.cols());
+//    matrix_product(w, x16, y);                     // Accumulated in float
+//
+// The kernels of the library accumulate the products of reduced precision
+// elements in a wider type, the accumulator type of the element type:
+//
+//    Element type           Accumulator type
+//    half, bfloat16         float
+//    std::int8_t            std::int32_t
+//    std::uint8_t           std::uint32_t
+//    Any other type T       T
+//
+// dot returns its sum in the accumulator type; the output of gemv and of
+// matrix_product may have either the element type of their inputs or its
+// accumulator type. When it is the accumulator type, the blocked product
+// converts the elements of each operand as it packs them, so that the
+// micro-kernel computes in the accumulator type while the operands are read
+// from memory at their reduced size. Element-wise operations on matrices of
+// half or bfloat16 compute in float and round the result.
+//
+// convert_into(x, out) converts the elements of x to the value type of out,
+// and convert<T>(x) returns a matrix<T, N> of the elements of x. When the
+// elements are contiguous, floats are converted to and from half with the
+// conversion instructions of the target (F16C on x86 or NEON on AArch64),
+// if it has them.
+
+// The half class is an IEEE 754 binary16 floating point number.
+class half
+{
+public:
+  half() = default;
+
+  half(float x)
+    : bits(from_float(x))
+  { }
+
+  operator float() const { return to_float(bits); }
+
+  half& operator+=(float x) { return *this = float(*this) + x; }
+  half& operator-=(float x) { return *this = float(*this) - x; }
+  half& operator*=(float x) { return *this = float(*this) * x; }
+  half& operator/=(float x) { return *this = float(*this) / x; }
+
+  // Returns the half with the given representation.
+  static half from_bits(std::uint16_t b)
+  {
+    half h;
+    h.bits = b;
+    return h;
+  }
+
+  // Returns the representation of the half.
+  std::uint16_t to_bits() const { return bits; }
+
+  static std::uint16_t from_float(float x);
+  static float to_float(std::uint16_t h);
+
+private:
+  std::uint16_t bits;
+};
+
+// Returns the binary16 representation of x, rounded to the nearest even.
+// Values whose magnitude is at least 65520 become infinities, and those
+// less than 2^-14 become subnormals.
+inline std::uint16_t
+half::from_float(float x)
+{
+  std::uint32_t f;
+  std::memcpy(&f, &x, sizeof(f));
+  std::uint32_t sign = (f >> 16) & 0x8000;
+  f &= 0x7fffffff;
+
+  // Infinities and NaNs, whose payloads are replaced by a quiet NaN.
+  if (f >= 0x7f800000)
+    return std::uint16_t(sign | 0x7c00 | (f > 0x7f800000 ? 0x200 : 0));
+  if (f >= 0x477ff000)
+    return std::uint16_t(sign | 0x7c00);
+
+  // Subnormals are rounded by adding 0.5, whose last bit has the weight of
+  // the last bit of a subnormal half (2^-24).
+  if (f < 0x38800000) {
+    float y;
+    std::memcpy(&y, &f, sizeof(y));
+    y += 0.5f;
+    std::memcpy(&f, &y, sizeof(f));
+    return std::uint16_t(sign | (f - 0x3f000000));
+  }
+
+  // Rebias the exponent (from 127 to 15) and round the fraction.
+  std::uint32_t odd = (f >> 13) & 1;
+  f += 0xc8000fff + odd;
+  return std::uint16_t(sign | (f >> 13));
+}
+
+// Returns the float equal to the binary16 number h.
+inline float
+half::to_float(std::uint16_t h)
+{
+  std::uint32_t sign = std::uint32_t(h & 0x8000) << 16;
+  std::uint32_t exp = (h >> 10) & 0x1f;
+  std::uint32_t frac = h & 0x3ff;
+  std::uint32_t f;
+  if (exp == 0x1f) {
+    f = sign | 0x7f800000 | (frac << 13);
+  } else if (exp == 0) {
+    // Zeros and subnormals (frac * 2^-24).
+    float y = float(frac) * 5.9604645e-8f;
+    std::memcpy(&f, &y, sizeof(f));
+    f |= sign;
+  } else {
+    f = sign | ((exp + 112) << 23) | (frac << 13);
+  }
+  float x;
+  std::memcpy(&x, &f, sizeof(x));
+  return x;
+}
+
+
+// The bfloat16 class is a floating point number with the sign and exponent
+// of a float and the 7 leading bits of its fraction.
+class bfloat16
+{
+public:
+  bfloat16() = default;
+
+  bfloat16(float x)
+    : bits(from_float(x))
+  { }
+
+  operator float() const { return to_float(bits); }
+
+  bfloat16& operator+=(float x) { return *this = float(*this) + x; }
+  bfloat16& operator-=(float x) { return *this = float(*this) - x; }
+  bfloat16& operator*=(float x) { return *this = float(*this) * x; }
+  bfloat16& operator/=(float x) { return *this = float(*this) / x; }
+
+  // Returns the bfloat16 with the given representation.
+  static bfloat16 from_bits(std::uint16_t b)
+  {
+    bfloat16 h;
+    h.bits = b;
+    return h;
+  }
+
+  // Returns the representation of the bfloat16.
+  std::uint16_t to_bits() const { return bits; }
+
+  // Returns the representation of x, rounded to the nearest even. The
+  // rounding has no branches, so that loops of conversions are vectorized.
+  static std::uint16_t from_float(float x)
+  {
+    std::uint32_t f;
+    std::memcpy(&f, &x, sizeof(f));
+    std::uint32_t r = (f + 0x7fff + ((f >> 16) & 1)) >> 16;
+    bool nan = (f & 0x7fffffff) > 0x7f800000;
+    return std::uint16_t(nan ? (f >> 16) | 0x40 : r);
+  }
+
+  // Returns the float equal to the bfloat16 number h.
+  static float to_float(std::uint16_t h)
+  {
+    std::uint32_t f = std::uint32_t(h) << 16;
+    float x;
+    std::memcpy(&x, &f, sizeof(x));
+    return x;
+  }
+
+private:
+  std::uint16_t bits;
+};
+
+
+// The accumulator type of T is the type in which sums of products of T are
+// computed.
+template <typename T>
+  struct accumulator_type
+  {
+    using type = T;
+  };
+
+template <>
+  struct accumulator_type<half>
+  {
+    using type = float;
+  };
+
+template <>
+  struct accumulator_type<bfloat16>
+  {
+    using type = float;
+  };
+
+template <>
+  struct accumulator_type<std::int8_t>
+  {
+    using type = std::int32_t;
+  };
+
+template <>
+  struct accumulator_type<std::uint8_t>
+  {
+    using type = std::uint32_t;
+  };
+
+template <typename T>
+  using Accumulator_type = typename accumulator_type<T>::type;
+
+
+namespace matrix_impl
+{
+  // Returns true if the results of kernels on elements of type T can be
+  // stored in elements of type U: U is T or the accumulator type of T.
+  template <typename T, typename U>
+    constexpr bool Accumulates_to()
+    {
+      return Same<T, U>() || Same<Accumulator_type<T>, U>();
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Conversion
+  //
+  // Convert the n elements of the array x to the value type of the array y.
+
+  template <typename T, typename U>
+    inline void
+    convert_n(const T* x, U* y, std::size_t n)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        y[i] = U(x[i]);
+    }
+
+  inline void
+  convert_n(const float* x, half* y, std::size_t n)
+  {
+    std::size_t i = 0;
+#if defined(__F16C__)
+    for ( ; i + 8 <= n; i += 8) {
+      __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(x + i), 0);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), h);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for ( ; i + 4 <= n; i += 4) {
+      float16x4_t h = vcvt_f16_f32(vld1q_f32(x + i));
+      vst1_u16(reinterpret_cast<std::uint16_t*>(y + i),
+               vreinterpret_u16_f16(h));
+    }
+#endif
+    for ( ; i != n; ++i)
+      y[i] = half(x[i]);
+  }
+
+  inline void
+  convert_n(const half* x, float* y, std::size_t n)
+  {
+    std::size_t i = 0;
+#if defined(__F16C__)
+    for ( ; i + 8 <= n; i += 8) {
+      __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+      _mm256_storeu_ps(y + i, _mm256_cvtph_ps(h));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for ( ; i + 4 <= n; i += 4) {
+      uint16x4_t h = vld1_u16(reinterpret_cast<const std::uint16_t*>(x + i));
+      vst1q_f32(y + i, vcvt_f32_f16(vreinterpret_f16_u16(h)));
+    }
+#endif
+    for ( ; i != n; ++i)
+      y[i] = float(x[i]);
+  }
+
+  // The number of reduced precision elements converted at a time by the
+  // kernels that compute in the accumulator type.
+  constexpr std::size_t convert_block = 256;
+
+} // namespace matrix_impl
+
+
+// Convert the elements of the matrix x to the value type of out, which has
+// the same extents. Note that out may be a matrix_ref, which is passed by
+// value.
+template <typename M1, typename M2>
+  void
+  convert_into(const M1& x, M2&& out)
+  {
+    using M = Remove_reference<M2>;
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    static_assert(M1::order == M::order, "");
+    assert(same_extents(x.descriptor(), out.descriptor()));
+
+    const auto& dx = x.descriptor();
+    const auto& dy = out.descriptor();
+    if (matrix_impl::is_contiguous(dx) && matrix_impl::is_contiguous(dy)) {
+      matrix_impl::convert_n(x.data() + dx.start, out.data() + dy.start,
+                             x.size());
+    } else {
+      using T = Value_type<M>;
+      auto i = out.begin();
+      for (const auto& v : x)
+        *i++ = T(v);
+    }
+  }
+
+// Returns a matrix of the elements of x, converted to T.
+template <typename T, typename M>
+  inline matrix<T, M::order>
+  convert(const M& x)
+  {
+    matrix<T, M::order> out(x.descriptor());
+    convert_into(x, out);
+    return out;
+  }
@@ -0,0 +1,504 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Blocked matrix product                                       [matrix.product]
+//
+// The following facilities implement a cache-blocked, register-tiled
+// algorithm for computing C += A * B when all three operands are stored in
+// row-major order with contiguous rows (i.e., a stride of 1 in the last
+// dimension). The algorithm follows the usual decomposition:
+//
+//    - The columns of B (and C) are partitioned into panels of NC columns.
+//    - The inner dimension is partitioned into KC elements. A KC x NC panel of
+//      B is packed into contiguous memory so that it stays resident in the
+//      L2 (or L3) cache.
+//    - The rows of A (and C) are partitioned into blocks of MC rows. An
+//      MC x KC block of A is packed so that it stays resident in L2 cache.
+//    - The packed blocks are multiplied by a micro-kernel that computes an
+//      MR x NR tile of C in registers.
+//
+// Packed A is stored as a sequence of MR-row slivers and packed B as a
+// sequence of NR-column slivers. Each sliver is stored so that the
+// micro-kernel reads it with unit stride. Slivers at the edges of the
+// matrix are padded with zeros so that the micro-kernel never branches.
+//
+// Large products are computed in parallel. The output matrix is partitioned
+// into tiles along its longer dimension, and each tile is computed by a
+// task of the default scheduler (see [conc.sched]) using the blocked
+// algorithm above. Each tile is computed independently, so no
+// synchronization is needed beyond waiting for all of the tiles to finish.
+// Products whose work (m * n * k) is below a threshold are computed
+// serially since the cost of dispatching tasks would dominate.
+//
+// Every level of the product is parameterized by a semiring (see
+// [matrix.semiring]), so that products over min_plus or or_and use the
+// same blocking, packing and threads as the arithmetic product. The
+// semiring's zero pads the packed slivers and initializes the accumulator,
+// and its plus and times replace += and * in the micro-kernel.
+
+
+// Returns the maximum number of threads used to compute a matrix product.
+// By default, this is the number of hardware threads available.
+std::size_t product_threads();
+
+// Set the maximum number of threads used to compute a matrix product. If n
+// is 0, the default (the number of hardware threads) is restored. Setting
+// n to 1 computes all products serially.
+void set_product_threads(std::size_t n);
+
+// -------------------------------------------------------------------------- //
+// Product tuning                                                [matrix.tuning]
+//
+// The blocking parameters of the product are chosen at run time, so that
+// they can be matched to the caches of the machine (see tuning.hpp, which
+// measures them). The register tile (mr x nr) determines the micro-kernel,
+// and is 4 or 8 in each dimension; a kernel is compiled for each of the four
+// tiles. The cache blocks (mc, kc, nc) are chosen so that a packed block of
+// A fits comfortably in L2 and a sliver of B (kc x nr) fits in L1. The
+// transpose block is the extent below which the transpose kernel stops
+// subdividing (see [matrix.transpose]).
+//
+// The parameters are kept separately for the float and double products.
+// The products of other value types use the default parameters, which are
+// reasonable for current x86 processors. Each parameter is an independently
+// valid value, so a product computed while the parameters are changed uses
+// a valid, if mixed, set of them.
+struct product_tuning
+{
+  std::size_t mr;
+  std::size_t nr;
+  std::size_t mc;
+  std::size_t kc;
+  std::size_t nc;
+  std::size_t transpose_block;
+};
+
+constexpr product_tuning default_product_tuning {4, 8, 128, 256, 4096, 32};
+
+bool operator==(const product_tuning& a, const product_tuning& b);
+bool operator!=(const product_tuning& a, const product_tuning& b);
+
+// Write the parameters p, e.g., "mr=4 nr=8 mc=128 kc=256 nc=4096
+// transpose=32".
+std::ostream& operator<<(std::ostream& os, const product_tuning& p);
+
+namespace matrix_impl
+{
+  // Returns the index of the tuning of the value type T, or -1 if the
+  // products of T use the default parameters.
+  template <typename T>
+    constexpr int
+    tuning_index()
+    {
+      return Same<T, float>() ? 0 : Same<T, double>() ? 1 : -1;
+    }
+
+  // Get and set the tuning with index i. See matrix.cpp.
+  product_tuning get_tuning(int i);
+  void set_tuning(int i, const product_tuning& p);
+
+  // The minimum amount of work (m * n * k) for which a product is computed
+  // in parallel.
+  constexpr std::size_t parallel_product = 128 * 128 * 128;
+
+
+  // Call f(i) for each i in [0, n), distributing the calls over at most
+  // threads threads, including the calling thread. This returns when all
+  // calls have completed. If any call throws an exception, one of those
+  // exceptions is rethrown. See matrix.cpp.
+  void parallel_for(std::size_t n,
+                    std::size_t threads,
+                    const std::function<void(std::size_t)>& f);
+} // namespace matrix_impl
+
+
+// Returns the parameters of the products of matrices of T. The first time
+// the parameters of float or double are used, they are read from the
+// tuning file named by the environment variable ORIGIN_MATRIX_TUNING, if
+// it is set; if the file has no parameters for this machine, they are
+// measured and saved to it (see tuning.hpp).
+template <typename T>
+  inline product_tuning
+  get_product_tuning()
+  {
+    return matrix_impl::get_tuning(matrix_impl::tuning_index<T>());
+  }
+
+// Set the parameters of the products of matrices of T, which must be float
+// or double. Throws std::invalid_argument if the register tile is not
+// supported or a block is 0.
+template <typename T>
+  inline void
+  set_product_tuning(const product_tuning& p)
+  {
+    static_assert(matrix_impl::tuning_index<T>() >= 0,
+                  "only float and double products are tuned");
+    matrix_impl::set_tuning(matrix_impl::tuning_index<T>(), p);
+  }
+
+
+namespace matrix_impl
+{
+  // Pack an mc x kc block of A (with leading dimension lda) into buf as a
+  // sequence of MR-row slivers. Each sliver stores its MR elements of a
+  // column contiguously. Rows past mc are filled with the zero of the
+  // semiring R. The elements are converted to the value type of buf, which
+  // is the accumulator type of the products of A.
+  template <std::size_t MR, typename S, typename T, typename R>
+    void
+    gemm_pack_a(std::size_t mc, std::size_t kc,
+                const S* a, std::size_t lda, T* buf, R)
+    {
+      const T zero = R::template zero<T>();
+      for (std::size_t i = 0; i < mc; i += MR) {
+        std::size_t m = std::min(MR, mc - i);
+        for (std::size_t p = 0; p < kc; ++p) {
+          std::size_t r = 0;
+          for ( ; r < m; ++r)
+            *buf++ = T(a[(i + r) * lda + p]);
+          for ( ; r < MR; ++r)
+            *buf++ = zero;
+        }
+      }
+    }
+
+  // Pack a kc x nc panel of B (with leading dimension ldb) into buf as a
+  // sequence of NR-column slivers. Each sliver stores its NR elements of a
+  // row contiguously. Columns past nc are filled with the zero of R, and
+  // the elements are converted as they are for A.
+  template <std::size_t NR, typename S, typename T, typename R>
+    void
+    gemm_pack_b(std::size_t kc, std::size_t nc,
+                const S* b, std::size_t ldb, T* buf, R)
+    {
+      const T zero = R::template zero<T>();
+      for (std::size_t j = 0; j < nc; j += NR) {
+        std::size_t n = std::min(NR, nc - j);
+        for (std::size_t p = 0; p < kc; ++p) {
+          const S* row = b + p * ldb + j;
+          std::size_t c = 0;
+          for ( ; c < n; ++c)
+            *buf++ = T(row[c]);
+          for ( ; c < NR; ++c)
+            *buf++ = zero;
+        }
+      }
+    }
+
+  // Compute the MR x NR tile C += A * B where A is a packed MR-row sliver
+  // and B is a packed NR-column sliver, both of length kc. Only the leading
+  // m x n elements of the tile are written back to C.
+  //
+  // The accumulator is a fixed-size array so that the compiler can keep it
+  // in (vector) registers and fully unroll the inner loops.
+  template <std::size_t MR, std::size_t NR, typename T>
+    inline void
+    gemm_micro_kernel(std::size_t kc, const T* a, const T* b,
+                      T* c, std::size_t ldc, std::size_t m, std::size_t n,
+                      plus_times)
+    {
+      T ab[MR][NR] = {};
+      for (std::size_t p = 0; p < kc; ++p) {
+        for (std::size_t i = 0; i < MR; ++i)
+          for (std::size_t j = 0; j < NR; ++j)
+            ab[i][j] += a[i] * b[j];
+        a += MR;
+        b += NR;
+      }
+
+      for (std::size_t i = 0; i < m; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          c[i * ldc + j] += ab[i][j];
+    }
+
+  // Compute the tile C = C (+) A (*) B over the semiring R.
+  template <std::size_t MR, std::size_t NR, typename T, typename R>
+    inline void
+    gemm_micro_kernel(std::size_t kc, const T* a, const T* b,
+                      T* c, std::size_t ldc, std::size_t m, std::size_t n,
+                      R)
+    {
+      T ab[MR][NR];
+      for (std::size_t i = 0; i < MR; ++i)
+        for (std::size_t j = 0; j < NR; ++j)
+          ab[i][j] = R::template zero<T>();
+      for (std::size_t p = 0; p < kc; ++p) {
+        for (std::size_t i = 0; i < MR; ++i)
+          for (std::size_t j = 0; j < NR; ++j)
+            ab[i][j] = R::plus(ab[i][j], R::times(a[i], b[j]));
+        a += MR;
+        b += NR;
+      }
+
+      for (std::size_t i = 0; i < m; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          c[i * ldc + j] = R::plus(c[i * ldc + j], ab[i][j]);
+    }
+
+  // Multiply the packed mc x kc block of A by the packed kc x nc panel of B,
+  // accumulating into C.
+  template <std::size_t MR, std::size_t NR, typename T, typename R>
+    void
+    gemm_macro_kernel(std::size_t mc, std::size_t nc, std::size_t kc,
+                      const T* a, const T* b, T* c, std::size_t ldc, R r)
+    {
+      for (std::size_t j = 0; j < nc; j += NR) {
+        std::size_t n = std::min(NR, nc - j);
+        for (std::size_t i = 0; i < mc; i += MR) {
+          std::size_t m = std::min(MR, mc - i);
+          gemm_micro_kernel<MR, NR>(kc, a + i * kc, b + j * kc,
+                                    c + i * ldc + j, ldc, m, n, r);
+        }
+      }
+    }
+
+
+  // Compute C += A * B with the MR x NR register tile and the cache blocks
+  // of the parameters t. The elements of A and B have the type S, and are
+  // packed (and multiplied) in the type T of C, over the semiring R.
+  template <std::size_t MR, std::size_t NR, typename S, typename T,
+            typename R>
+    void
+    gemm_blocked(const product_tuning& t,
+                 std::size_t m, std::size_t n, std::size_t k,
+                 const S* a, std::size_t lda,
+                 const S* b, std::size_t ldb,
+                 T* c, std::size_t ldc, R r)
+    {
+      const std::size_t MC = t.mc;
+      const std::size_t KC = t.kc;
+      const std::size_t NC = t.nc;
+
+      // Buffers for the packed blocks, rounded up to whole slivers.
+      std::size_t kb = std::min(KC, k);
+      std::size_t mb = (std::min(MC, m) + MR - 1) / MR * MR;
+      std::size_t nb = (std::min(NC, n) + NR - 1) / NR * NR;
+      scratch_buffer<T> pa(mb * kb);
+      scratch_buffer<T> pb(kb * nb);
+
+      for (std::size_t jc = 0; jc < n; jc += NC) {
+        std::size_t nc = std::min(NC, n - jc);
+        for (std::size_t pc = 0; pc < k; pc += KC) {
+          std::size_t kc = std::min(KC, k - pc);
+          gemm_pack_b<NR>(kc, nc, b + pc * ldb + jc, ldb, pb.data(), r);
+          for (std::size_t ic = 0; ic < m; ic += MC) {
+            std::size_t mc = std::min(MC, m - ic);
+            gemm_pack_a<MR>(mc, kc, a + ic * lda + pc, lda, pa.data(), r);
+            gemm_macro_kernel<MR, NR>(mc, nc, kc, pa.data(), pb.data(),
+                                      c + ic * ldc + jc, ldc, r);
+          }
+        }
+      }
+    }
+
+  // Compute C += A * B where A is m x k, B is k x n, and C is m x n, using
+  // the parameters t. Each matrix is stored in row-major order with the
+  // given leading dimension (the distance between the first elements of
+  // subsequent rows). The value type T of C is the value type S of A and B
+  // or its accumulator type (see [matrix.precision]). The product is over
+  // the semiring r.
+  template <typename S, typename T, typename R = plus_times>
+    void
+    gemm(const product_tuning& t,
+         std::size_t m, std::size_t n, std::size_t k,
+         const S* a, std::size_t lda,
+         const S* b, std::size_t ldb,
+         T* c, std::size_t ldc, R r = R())
+    {
+      switch ((t.mr == 8) * 2 + (t.nr == 8)) {
+      case 0:
+        gemm_blocked<4, 4>(t, m, n, k, a, lda, b, ldb, c, ldc, r);
+        break;
+      case 1:
+        gemm_blocked<4, 8>(t, m, n, k, a, lda, b, ldb, c, ldc, r);
+        break;
+      case 2:
+        gemm_blocked<8, 4>(t, m, n, k, a, lda, b, ldb, c, ldc, r);
+        break;
+      default:
+        gemm_blocked<8, 8>(t, m, n, k, a, lda, b, ldb, c, ldc, r);
+        break;
+      }
+    }
+
+  // Compute C += A * B with the current parameters of T.
+  template <typename S, typename T, typename R = plus_times>
+    inline void
+    gemm(std::size_t m, std::size_t n, std::size_t k,
+         const S* a, std::size_t lda,
+         const S* b, std::size_t ldb,
+         T* c, std::size_t ldc, R r = R())
+    {
+      gemm(get_product_tuning<T>(), m, n, k, a, lda, b, ldb, c, ldc, r);
+    }
+
+
+  // Compute C += A * B as gemm does, but divide the output into tiles that
+  // are computed by up to threads threads. The output is partitioned along
+  // its longer dimension, and tiles are rounded to a multiple of the
+  // register tile so that only the last tile has a partial sliver.
+  template <typename S, typename T, typename R = plus_times>
+    void
+    parallel_gemm(std::size_t m, std::size_t n, std::size_t k,
+                  const S* a, std::size_t lda,
+                  const S* b, std::size_t ldb,
+                  T* c, std::size_t ldc,
+                  std::size_t threads, R r = R())
+    {
+      const product_tuning t = get_product_tuning<T>();
+      const std::size_t MR = t.mr;
+      const std::size_t NR = t.nr;
+
+      if (m >= n) {
+        std::size_t step = ((m + threads - 1) / threads + MR - 1) / MR * MR;
+        std::size_t tiles = (m + step - 1) / step;
+        parallel_for(tiles, threads, [=](std::size_t x) {
+          std::size_t i = x * step;
+          gemm(t, std::min(step, m - i), n, k,
+               a + i * lda, lda, b, ldb, c + i * ldc, ldc, r);
+        });
+      } else {
+        std::size_t step = ((n + threads - 1) / threads + NR - 1) / NR * NR;
+        std::size_t tiles = (n + step - 1) / step;
+        parallel_for(tiles, threads, [=](std::size_t x) {
+          std::size_t j = x * step;
+          gemm(t, m, std::min(step, n - j), k,
+               a, lda, b + j, ldb, c + j, ldc, r);
+        });
+      }
+    }
+
+  // Compute C += A * B, in parallel if the product is large enough and more
+  // than one thread is allowed.
+  template <typename S, typename T, typename R = plus_times>
+    void
+    dispatch_gemm(std::size_t m, std::size_t n, std::size_t k,
+                  const S* a, std::size_t lda,
+                  const S* b, std::size_t ldb,
+                  T* c, std::size_t ldc, R r = R())
+    {
+      std::size_t threads = product_threads();
+      if (threads > 1 && m * n * k >= parallel_product)
+        parallel_gemm(m, n, k, a, lda, b, ldb, c, ldc, threads, r);
+      else
+        gemm(m, n, k, a, lda, b, ldb, c, ldc, r);
+    }
+
+
+  // Returns true when the blocked product can be used to compute the
+  // product of matrices with types M1, M2, and M3. All three must provide
+  // access to their underlying memory. The operands share a value type, and
+  // the output has that type or its accumulator type, which is arithmetic.
+  template <typename M1, typename M2, typename M3>
+    constexpr bool Blocked_product()
+    {
+      return Strided_matrix<M1>()
+          && Strided_matrix<M2>()
+          && Strided_matrix<M3>()
+          && Same<Value_type<M1>, Value_type<M2>>()
+          && Accumulates_to<Value_type<M1>, Value_type<M3>>()
+          && Arithmetic<Value_type<M3>>();
+    }
+
+  // Returns true when the rows of the 2D slice are contiguous in memory.
+  inline bool
+  is_row_major(const matrix_slice<2>& s)
+  {
+    return s.strides[1] == 1;
+  }
+
+
+  // Returns a dense_ref referring to the elements of the strided matrix m,
+  // whose innermost stride must be 1.
+  template <typename M>
+    inline dense_ref<Remove_reference<decltype(*std::declval<M&>().data())>, 
+                     M::order>
+    dense_operand(M& m)
+    {
+      return {m.descriptor(), m.data()};
+    }
+
+  // Compute out += a * b by iterating over the elements of each matrix. The
+  // loops are ordered i-k-j so that the innermost loop moves along rows of
+  // b and out.
+  template <typename M1, typename M2, typename M3>
+    void
+    product_elementwise(const M1& a, const M2& b, M3& out, plus_times)
+    {
+      using Size = Size_type<M3>;
+      for (Size i = 0; i != a.extent(0); ++i) {
+        for (Size k = 0; k != a.extent(1); ++k) {
+          const auto& x = a(i, k);
+          for (Size j = 0; j != b.extent(1); ++j)
+            out(i, j) += x * b(k, j);
+        }
+      }
+    }
+
+  // Compute out = out (+) a (*) b over the semiring R, in the same order.
+  template <typename M1, typename M2, typename M3, typename R>
+    void
+    product_elementwise(const M1& a, const M2& b, M3& out, R)
+    {
+      using Size = Size_type<M3>;
+      for (Size i = 0; i != a.extent(0); ++i) {
+        for (Size k = 0; k != a.extent(1); ++k) {
+          const auto& x = a(i, k);
+          for (Size j = 0; j != b.extent(1); ++j)
+            out(i, j) = R::plus(out(i, j), R::times(x, b(k, j)));
+        }
+      }
+    }
+
+  // Dispatch for operands that do not provide access to their memory.
+  template <typename M1, typename M2, typename M3, typename R>
+    inline void
+    product(const M1& a, const M2& b, M3& out, R r, std::false_type)
+    {
+      product_elementwise(a, b, out, r);
+    }
+
+  // Dispatch for matrices and matrix references. The blocked product is
+  // used only when all three operands have contiguous rows and the problem
+  // is large enough to amortize the cost of packing. Small products of
+  // operands with contiguous rows are computed through dense_refs, whose
+  // inner loop is vectorized.
+  template <typename M1, typename M2, typename M3, typename R>
+    inline void
+    product(const M1& a, const M2& b, M3& out, R r, std::true_type)
+    {
+      const matrix_slice<2>& da = a.descriptor();
+      const matrix_slice<2>& db = b.descriptor();
+      const matrix_slice<2>& dc = out.descriptor();
+
+      std::size_t m = da.extents[0];
+      std::size_t n = db.extents[1];
+      std::size_t k = da.extents[1];
+      if (m == 0 || n == 0 || k == 0)
+        return;
+
+      constexpr std::size_t small = 16;
+      bool contiguous = is_row_major(da) && is_row_major(db)
+                     && is_row_major(dc);
+      if (contiguous && (m > small || n > small || k > small))
+        dispatch_gemm(m, n, k,
+                      a.data() + da.start, da.strides[0],
+                      b.data() + db.start, db.strides[0],
+                      out.data() + dc.start, dc.strides[0], r);
+      else if (contiguous) {
+        auto c = dense_operand(out);
+        product_elementwise(dense_operand(a), dense_operand(b), c, r);
+      } else
+        product_elementwise(a, b, out, r);
+    }
+
+} // namespace matrix_impl
@@ -0,0 +1,226 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// QR factorization                                                  [matrix.qr]
+//
+// The QR factorization of an m x n matrix A, with m >= n, is A = Q * R,
+// where Q is an m x m orthogonal matrix and R is m x n and upper triangular.
+// Q is the product H(0) * H(1) * ... * H(n - 1) of Householder reflectors
+// H(k) = I - tau(k) * v(k) * v(k)^T, where v(k) is zero above row k and 1 in
+// row k. The factorization is computed in place: R is stored in the upper
+// triangle of a, and each v(k) below the diagonal of column k, as in LAPACK.
+//
+//    std::vector<double> tau;
+//    qr_factor(a, tau);          // a = R and V
+//    qr_solve(a, tau, b);        // b[0:n) = argmin_x |A * x - b|
+//
+// The factorization is blocked and right-looking. The reflectors of each
+// panel of columns are computed and accumulated in the compact WY form
+// I - V * T * V^T, where T is upper triangular, so that the trailing matrix
+// is updated, A2 -= V * (T^T * (V^T * A2)), by two matrix products.
+
+namespace matrix_impl
+{
+  // Compute the reflectors of the panel of columns [j, j + jb) of the
+  // m x n matrix a, storing their scalars in tau, and apply them to the
+  // rest of the panel.
+  template <typename T>
+    void
+    qr_panel(std::size_t m, T* a, std::size_t rs, std::size_t cs,
+             std::size_t j, std::size_t jb, T* tau)
+    {
+      for (std::size_t c = j; c != j + jb; ++c) {
+        T* x = a + c * rs + c * cs;
+        T alpha = x[0];
+        T sigma = dot_n(x + rs, rs, x + rs, rs, m - c - 1);
+        if (sigma == T(0)) {
+          tau[c] = T(0);
+          continue;
+        }
+
+        // Choose the sign of beta so that alpha - beta does not cancel.
+        T beta = std::sqrt(alpha * alpha + sigma);
+        if (alpha > T(0))
+          beta = -beta;
+        tau[c] = (beta - alpha) / beta;
+        T s = T(1) / (alpha - beta);
+        for (std::size_t r = 1; r != m - c; ++r)
+          x[r * rs] *= s;
+        x[0] = beta;
+
+        // Apply H(c) to the columns (c, j + jb) of the panel.
+        for (std::size_t k = c + 1; k != j + jb; ++k) {
+          T* y = a + c * rs + k * cs;
+          T w = y[0] + dot_n(x + rs, rs, y + rs, rs, m - c - 1);
+          w *= tau[c];
+          y[0] -= w;
+          for (std::size_t r = 1; r != m - c; ++r)
+            y[r * rs] -= w * x[r * rs];
+        }
+      }
+    }
+
+  // Apply the transpose of the block reflector of the panel [j, j + jb) to
+  // the columns [j + jb, n) of the m x n matrix a.
+  template <typename T>
+    void
+    qr_update(std::size_t m, std::size_t n, T* a, std::size_t rs,
+              std::size_t cs, std::size_t j, std::size_t jb, const T* tau)
+    {
+      std::size_t mv = m - j;
+      std::size_t n2 = n - j - jb;
+      T* a2 = a + j * rs + (j + jb) * cs;
+
+      // Copy V^T, with its unit diagonal and zeros, to contiguous rows.
+      scratch_buffer<T> vt(jb * mv);
+      for (std::size_t k = 0; k != jb; ++k) {
+        vt[k * mv + k] = T(1);
+        for (std::size_t r = k + 1; r != mv; ++r)
+          vt[k * mv + r] = a[(j + r) * rs + (j + k) * cs];
+      }
+
+      // Form the upper triangular T of the compact WY form column by
+      // column: T(0:k, k) = -tau(k) * T(0:k, 0:k) * V(:, 0:k)^T * v(k).
+      scratch_buffer<T> t(jb * jb);
+      scratch_buffer<T> z(jb);
+      for (std::size_t k = 0; k != jb; ++k) {
+        const T* vk = vt.data() + k * mv;
+        for (std::size_t i = 0; i != k; ++i)
+          z[i] = dot_n(vt.data() + i * mv + k, vk + k, mv - k);
+        for (std::size_t i = 0; i != k; ++i) {
+          T s = 0;
+          for (std::size_t p = i; p != k; ++p)
+            s += t[i * jb + p] * z[p];
+          t[i * jb + k] = -tau[j + k] * s;
+        }
+        t[k * jb + k] = tau[j + k];
+      }
+
+      // W = V^T * A2
+      scratch_buffer<T> w(jb * n2);
+      if (cs == 1) {
+        dispatch_gemm(jb, n2, mv, vt.data(), mv, a2, rs, w.data(), n2);
+      } else {
+        for (std::size_t k = 0; k != jb; ++k)
+          for (std::size_t c = 0; c != n2; ++c)
+            w[k * n2 + c] = dot_n(vt.data() + k * mv, std::size_t(1),
+                                  a2 + c * cs, rs, mv);
+      }
+
+      // W = T^T * W, from the last row up, since T^T is lower triangular.
+      for (std::size_t i = jb; i-- != 0; ) {
+        T* wi = w.data() + i * n2;
+        for (std::size_t c = 0; c != n2; ++c)
+          wi[c] *= t[i * jb + i];
+        for (std::size_t p = 0; p != i; ++p)
+          lu_axpy(n2, -t[p * jb + i], w.data() + p * n2, wi, std::size_t(1));
+      }
+
+      // A2 -= V * W
+      gemm_minus(mv, n2, jb, vt.data(), std::size_t(1), mv,
+                 w.data(), n2, std::size_t(1), a2, rs, cs);
+    }
+
+  // Factor the m x n matrix a in place, storing the scalars of the
+  // reflectors in tau.
+  template <typename T>
+    void
+    qr_factor(std::size_t m, std::size_t n, T* a, std::size_t rs,
+              std::size_t cs, T* tau)
+    {
+      for (std::size_t j = 0; j < n; j += lu_block) {
+        std::size_t jb = std::min(lu_block, n - j);
+        qr_panel(m, a, rs, cs, j, jb, tau);
+        if (j + jb < n)
+          qr_update(m, n, a, rs, cs, j, jb, tau);
+      }
+    }
+
+  // Compute B = Q^T * B for the m x nb matrix b, given the factorization of
+  // the m x n matrix a.
+  template <typename T>
+    void
+    qr_apply_qt(std::size_t m, std::size_t n,
+                const T* a, std::size_t rs, std::size_t cs, const T* tau,
+                std::size_t nb, T* b, std::size_t brs, std::size_t bcs)
+    {
+      for (std::size_t k = 0; k != n; ++k) {
+        if (tau[k] == T(0))
+          continue;
+        const T* v = a + k * rs + k * cs;
+        for (std::size_t c = 0; c != nb; ++c) {
+          T* y = b + k * brs + c * bcs;
+          T w = y[0] + dot_n(v + rs, rs, y + brs, brs, m - k - 1);
+          w *= tau[k];
+          y[0] -= w;
+          for (std::size_t r = 1; r != m - k; ++r)
+            y[r * brs] -= w * v[r * rs];
+        }
+      }
+    }
+
+} // namespace matrix_impl
+
+
+// Factor the m x n matrix a, with m >= n, in place, storing R in its upper
+// triangle, the Householder vectors below its diagonal, and their scalars
+// in tau.
+//
+// The matrix a must be a matrix or matrix_ref of order 2 with a floating
+// point value type.
+template <typename M>
+  void
+  qr_factor(M& a, std::vector<Value_type<M>>& tau)
+  {
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    static_assert(M::order == 2, "");
+    static_assert(std::is_floating_point<Value_type<M>>::value, "");
+    assert(a.rows() >= a.cols());
+    ORIGIN_TIME_SCOPE("matrix.qr");
+
+    const matrix_slice<2>& d = a.descriptor();
+    tau.resize(a.cols());
+    matrix_impl::qr_factor(a.rows(), a.cols(), a.data() + d.start,
+                           d.strides[0], d.strides[1], tau.data());
+  }
+
+
+// Solve the least squares problem min |A * x - b| for x given the
+// factorization qr and tau of A computed by qr_factor. A must have full
+// column rank. The right-hand side b, with as many rows as A, is
+// overwritten: its first n rows hold the solution, where n is the number
+// of columns of A, and the norm of its remaining rows is the norm of the
+// residual. If b is a matrix, each of its columns is a separate right-hand
+// side.
+template <typename M1, typename M2>
+  void
+  qr_solve(const M1& qr, const std::vector<Value_type<M2>>& tau, M2& b)
+  {
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(matrix_impl::Strided_matrix<M2>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 1 || M2::order == 2, "");
+    assert(qr.rows() == b.extent(0));
+    assert(qr.cols() == tau.size());
+
+    const matrix_slice<2>& d = qr.descriptor();
+    const matrix_slice<M2::order>& e = b.descriptor();
+    std::size_t n = qr.cols();
+    matrix_impl::qr_apply_qt(qr.rows(), n, qr.data() + d.start,
+                             d.strides[0], d.strides[1], tau.data(),
+                             matrix_impl::rhs_cols(e), b.data() + e.start,
+                             e.strides[0], matrix_impl::rhs_stride(e));
+    matrix_impl::trsm(triangle::upper, false, n,
+                      qr.data() + d.start, d.strides[0], d.strides[1],
+                      matrix_impl::rhs_cols(e), b.data() + e.start,
+                      e.strides[0], matrix_impl::rhs_stride(e));
+  }
@@ -0,0 +1,327 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Axis reductions                                               [matrix.reduce]
+//
+// A reduction along an axis of an N dimensional matrix combines the elements
+// that differ only in their index in that dimension, resulting in a matrix
+// of order N - 1. For a 2D matrix m:
+//
+//    sum(m, axis(0))    -- The sums of the columns of m
+//    max(m, axis(1))    -- The maximum of each row of m
+//
+// The following reductions are defined for matrices and matrix_refs of
+// order 2 or more:
+//
+//    reduce(m, axis(k), op)  -- Fold the elements along k by op
+//    sum(m, axis(k))         -- The sums along k
+//    min(m, axis(k))         -- The minima along k
+//    max(m, axis(k))         -- The maxima along k
+//    mean(m, axis(k))        -- The sums along k, divided by extent(k)
+//
+// The fold of each set of elements begins with the element whose index
+// along k is 0, so that the extent of m along k must not be 0 unless m is
+// empty. The mean is computed in the value type of m. The reductions over
+// all elements of a matrix are the range algorithms reduce, min and max
+// (see [seq.algo]).
+//
+// The elements are read once, in the order they are stored. A reduction
+// along the last axis combines the elements of each row; one along another
+// axis combines each row into a row of the result, so that the innermost
+// loop always moves along contiguous rows. When the rows are contiguous,
+// the value type has vector support (see [matrix.simd]), and the operation
+// is std::plus or the minimum or maximum, that loop uses vector
+// instructions.
+//
+// NOTE: The minimum and maximum of elements that include a NaN are
+// unspecified.
+
+// An axis names a dimension of a matrix in a reduction.
+struct axis
+{
+  explicit constexpr axis(std::size_t n) : value(n) { }
+
+  std::size_t value;
+};
+
+
+namespace matrix_impl
+{
+  // Minimum: a = min(a, b)
+  struct min_assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { if (b < a) a = b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::min(b, a); }
+  };
+
+  // Maximum: a = max(a, b)
+  struct max_assign_op : vector_op
+  {
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { if (a < b) a = b; }
+
+    template <typename V>
+      static typename V::type
+      vec(typename V::type a, typename V::type b) { return V::max(b, a); }
+  };
+
+  // Fold: a = op(a, b), for a user-defined operation op.
+  template <typename Op>
+    struct fold_op
+    {
+      template <typename T, typename U>
+        void operator()(T& a, const U& b) const { a = op(a, b); }
+
+      Op op;
+    };
+
+  // Returns the kernel operation that folds elements by op.
+  template <typename Op>
+    inline fold_op<Op>
+    fold_kernel(Op op)
+    {
+      return {op};
+    }
+
+  template <typename T>
+    inline plus_assign_op
+    fold_kernel(std::plus<T>)
+    {
+      return {};
+    }
+
+  inline min_assign_op fold_kernel(min_assign_op f) { return f; }
+  inline max_assign_op fold_kernel(max_assign_op f) { return f; }
+
+
+  // Returns the fold of the n elements of p, with the stride inc, by the
+  // kernel operation f. The fold begins with p[0], and n is not 0.
+  template <typename T, typename F>
+    inline Requires<!Vector_binary_op<T, T, F>(), T>
+    fold_n(const T* p, std::size_t inc, std::size_t n, F f)
+    {
+      T x = p[0];
+      for (std::size_t i = 1; i != n; ++i)
+        f(x, p[i * inc]);
+      return x;
+    }
+
+  template <typename T, typename F>
+    inline Requires<Vector_binary_op<T, T, F>(), T>
+    fold_n(const T* p, std::size_t inc, std::size_t n, F f)
+    {
+      using V = simd_traits<T>;
+      constexpr std::size_t W = V::width;
+      using Reg = typename V::type;
+
+      T x = p[0];
+      if (inc != 1 || n < 2 * W) {
+        for (std::size_t i = 1; i != n; ++i)
+          f(x, p[i * inc]);
+        return x;
+      }
+
+      // Fold W lanes of elements, then the lanes and the remainder.
+      Reg a = V::load(p);
+      std::size_t i = W;
+      for ( ; i + W <= n; i += W)
+        a = F::template vec<V>(a, V::load(p + i));
+      T lanes[W];
+      V::store(lanes, a);
+      x = lanes[0];
+      for (std::size_t j = 1; j != W; ++j)
+        f(x, lanes[j]);
+      for ( ; i != n; ++i)
+        f(x, p[i]);
+      return x;
+    }
+
+
+  // Reduce the elements of the slice s (at p) along the axis k by the
+  // kernel operation f, writing the results to the row-major array out.
+  template <std::size_t N, typename T, typename F>
+    void
+    reduce_axis(const matrix_slice<N>& s, const T* p, std::size_t k,
+                T* out, F f)
+    {
+      static_assert(N >= 2, "");
+      std::size_t n = s.extents[N - 1];
+      std::size_t inc = s.strides[N - 1];
+
+      // Along the last axis, each row is folded into one element of the
+      // result, in order.
+      if (k == N - 1) {
+        for_each_row(s, [&](const std::size_t*, std::size_t off) {
+          *out++ = fold_n(p + off, inc, n, f);
+        });
+        return;
+      }
+
+      // Otherwise, each row of s is folded into the row of the result that
+      // omits its index along k. The first row along k is copied.
+      std::size_t exts[N - 1];
+      std::size_t strides[N - 1];
+      for (std::size_t d = 0, e = 0; d != N; ++d)
+        if (d != k)
+          exts[e++] = s.extents[d];
+      strides[N - 2] = 1;
+      for (std::size_t e = N - 2; e != 0; --e)
+        strides[e - 1] = strides[e] * exts[e];
+      for_each_row(s, [&](const std::size_t* idx, std::size_t off) {
+        std::size_t r = 0;
+        for (std::size_t d = 0; d != N - 1; ++d)
+          if (d != k)
+            r += idx[d] * strides[d < k ? d : d - 1];
+        T* q = out + r;
+        const T* row = p + off;
+        if (idx[k] == 0) {
+          for (std::size_t j = 0; j != n; ++j)
+            q[j] = row[j * inc];
+        } else if (inc == 1) {
+          apply_n(q, row, n, f);
+        } else {
+          for (std::size_t j = 0; j != n; ++j)
+            f(q[j], row[j * inc]);
+        }
+      });
+    }
+
+  // Returns the descriptor of the result of a reduction of s along k.
+  template <std::size_t N>
+    inline matrix_slice<N - 1>
+    reduced_slice(const matrix_slice<N>& s, std::size_t k)
+    {
+      std::array<std::size_t, N - 1> exts;
+      for (std::size_t d = 0, e = 0; d != N; ++d)
+        if (d != k)
+          exts[e++] = s.extents[d];
+      return matrix_slice<N - 1>(0, exts);
+    }
+
+} // namespace matrix_impl
+
+
+// Returns the fold of the elements of m along the axis a by the binary
+// operation op.
+template <typename M, typename Op>
+  Requires<
+    matrix_impl::Strided_matrix<M>(), matrix<Value_type<M>, M::order - 1>
+  >
+  reduce(const M& m, axis a, Op op)
+  {
+    static_assert(M::order >= 2, "");
+    const auto& s = m.descriptor();
+    assert(a.value < M::order);
+    assert(s.extents[a.value] != 0 || s.size == 0);
+    ORIGIN_TIME_SCOPE("matrix.reduce");
+
+    matrix<Value_type<M>, M::order - 1> r(
+      matrix_impl::reduced_slice(s, a.value));
+    if (s.size != 0)
+      matrix_impl::reduce_axis(s, m.data(), a.value, r.data(),
+                               matrix_impl::fold_kernel(op));
+    return r;
+  }
+
+template <typename M>
+  inline Requires<
+    matrix_impl::Strided_matrix<M>(), matrix<Value_type<M>, M::order - 1>
+  >
+  sum(const M& m, axis a)
+  {
+    return reduce(m, a, std::plus<Value_type<M>>());
+  }
+
+template <typename M>
+  inline Requires<
+    matrix_impl::Strided_matrix<M>(), matrix<Value_type<M>, M::order - 1>
+  >
+  mean(const M& m, axis a)
+  {
+    auto r = sum(m, a);
+    r /= Value_type<M>(m.extent(a.value));
+    return r;
+  }
+
+// NOTE: The matrix is taken by forwarding reference so that these overloads
+// are preferred to the range algorithms min(range, comp) and max(range,
+// comp) for non-const matrices.
+template <typename M>
+  inline Requires<
+    matrix_impl::Strided_matrix<Remove_reference<M>>(),
+    matrix<Value_type<Remove_reference<M>>, Remove_reference<M>::order - 1>
+  >
+  min(M&& m, axis a)
+  {
+    return reduce(m, a, matrix_impl::min_assign_op{});
+  }
+
+template <typename M>
+  inline Requires<
+    matrix_impl::Strided_matrix<Remove_reference<M>>(),
+    matrix<Value_type<Remove_reference<M>>, Remove_reference<M>::order - 1>
+  >
+  max(M&& m, axis a)
+  {
+    return reduce(m, a, matrix_impl::max_assign_op{});
+  }
+
+
+// -------------------------------------------------------------------------- //
+// Broadcasting                                               [matrix.broadcast]
+//
+// The broadcast operation returns a view of a matrix x with the extents of
+// a matrix m of the same or higher order, in which the elements of x are
+// repeated along the leading dimensions that x lacks, and along its
+// dimensions of extent 1; its other extents must equal the trailing extents
+// of m. This is the broadcasting rule of NumPy. The view can be used as an
+// operand of the element-wise operations with m. For example, to center the
+// columns of a 2D matrix m:
+//
+//    matrix<double, 2> c = m - broadcast(mean(m, axis(0)), m);
+//
+// The repeated dimensions of the view have a stride of 0, so that nothing
+// is copied; like any matrix_ref, the view must not outlive x. It is read
+// only, since its repeated elements alias each other.
+
+template <typename M1, typename M2>
+  Requires<
+    matrix_impl::Strided_matrix<M1>() && matrix_impl::Strided_matrix<M2>(),
+    matrix_ref<const Value_type<M1>, M2::order>
+  >
+  broadcast(const M1& x, const M2& m)
+  {
+    constexpr std::size_t N = M2::order;
+    constexpr std::size_t K = M1::order;
+    static_assert(K <= N, "");
+
+    const matrix_slice<K>& xs = x.descriptor();
+    const matrix_slice<N>& ms = m.descriptor();
+    matrix_slice<N> s;
+    s.start = xs.start;
+    s.size = ms.size;
+    for (std::size_t d = 0; d != N; ++d) {
+      s.extents[d] = ms.extents[d];
+      s.strides[d] = 0;
+      if (d >= N - K) {
+        std::size_t j = d - (N - K);
+        assert(xs.extents[j] == ms.extents[d] || xs.extents[j] == 1);
+        if (xs.extents[j] == ms.extents[d])
+          s.strides[d] = xs.strides[j];
+      }
+    }
+    return {s, x.data()};
+  }
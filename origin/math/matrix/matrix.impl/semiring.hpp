@@ -0,0 +1,179 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Semirings                                                   [matrix.semiring]
+//
+// A semiring replaces the addition and multiplication of a matrix product,
+// so that the same blocked product computes the steps of algebraic graph
+// algorithms. The product of a and b over the semiring r is
+//
+//    out(i, j) = out(i, j) (+) a(i, 0) (*) b(0, j) (+) a(i, 1) (*) b(1, j) ...
+//
+// where (+) is r.plus and (*) is r.times. The semiring's zero is the
+// identity of plus and annihilates times: it is the value of an absent edge,
+// with which the blocked product pads its packed blocks. Its one is the
+// identity of times. The semirings are:
+//
+//    plus_times  -- The arithmetic product (the default)
+//    min_plus    -- Shortest paths: zero is infinity, and one is 0
+//    max_plus    -- Longest (critical) paths: zero is -infinity
+//    max_times   -- Most reliable paths, over nonnegative values
+//    or_and      -- Reachability, over bool or 0/1 values
+//
+// For integer elements, the infinities of min_plus and max_plus are the
+// largest and least values of the type, and adding them saturates.
+//
+// A semiring is a stateless class with the static member templates zero<T>(),
+// one<T>(), plus(a, b) and times(a, b). The blocked product inlines them in
+// its micro-kernel, whose fixed-size accumulator the compiler vectorizes for
+// min and max as it does for addition.
+
+
+struct plus_times
+{
+  template <typename T>
+    static T zero() { return T(0); }
+
+  template <typename T>
+    static T one() { return T(1); }
+
+  template <typename T, typename U>
+    static auto plus(const T& a, const U& b) -> decltype(a + b)
+    {
+      return a + b;
+    }
+
+  template <typename T, typename U>
+    static auto times(const T& a, const U& b) -> decltype(a * b)
+    {
+      return a * b;
+    }
+};
+
+
+namespace matrix_impl
+{
+  // Returns the greatest value of T, which is infinity if T has one.
+  template <typename T>
+    inline T
+    semiring_infinity()
+    {
+      using L = std::numeric_limits<T>;
+      return L::has_infinity ? L::infinity() : L::max();
+    }
+
+  // Returns the least value of T, which is -infinity if T has one.
+  template <typename T>
+    inline T
+    semiring_negative_infinity()
+    {
+      using L = std::numeric_limits<T>;
+      return L::has_infinity ? -L::infinity() : L::lowest();
+    }
+
+  // Returns a + b, where an infinite operand (inf or -inf) yields that
+  // operand. Floating point addition already does this.
+  template <typename T>
+    inline T
+    saturating_add(const T& a, const T& b, T, std::true_type)
+    {
+      return a + b;
+    }
+
+  template <typename T>
+    inline T
+    saturating_add(const T& a, const T& b, T inf, std::false_type)
+    {
+      return (a == inf || b == inf) ? inf : T(a + b);
+    }
+
+  template <typename T>
+    inline T
+    saturating_add(const T& a, const T& b, T inf)
+    {
+      using Float = std::integral_constant<
+        bool, std::numeric_limits<T>::has_infinity
+      >;
+      return saturating_add(a, b, inf, Float{});
+    }
+
+} // namespace matrix_impl
+
+
+struct min_plus
+{
+  template <typename T>
+    static T zero() { return matrix_impl::semiring_infinity<T>(); }
+
+  template <typename T>
+    static T one() { return T(0); }
+
+  template <typename T>
+    static T plus(const T& a, const T& b) { return b < a ? b : a; }
+
+  template <typename T>
+    static T times(const T& a, const T& b)
+    {
+      return matrix_impl::saturating_add(a, b, zero<T>());
+    }
+};
+
+
+struct max_plus
+{
+  template <typename T>
+    static T zero() { return matrix_impl::semiring_negative_infinity<T>(); }
+
+  template <typename T>
+    static T one() { return T(0); }
+
+  template <typename T>
+    static T plus(const T& a, const T& b) { return a < b ? b : a; }
+
+  template <typename T>
+    static T times(const T& a, const T& b)
+    {
+      return matrix_impl::saturating_add(a, b, zero<T>());
+    }
+};
+
+
+struct max_times
+{
+  template <typename T>
+    static T zero() { return T(0); }
+
+  template <typename T>
+    static T one() { return T(1); }
+
+  template <typename T>
+    static T plus(const T& a, const T& b) { return a < b ? b : a; }
+
+  template <typename T>
+    static T times(const T& a, const T& b) { return a * b; }
+};
+
+
+struct or_and
+{
+  template <typename T>
+    static T zero() { return T(0); }
+
+  template <typename T>
+    static T one() { return T(1); }
+
+  template <typename T>
+    static T plus(const T& a, const T& b) { return T(a || b); }
+
+  template <typename T>
+    static T times(const T& a, const T& b) { return T(a && b); }
+};
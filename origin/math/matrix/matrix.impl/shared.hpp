@@ -0,0 +1,359 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Shared matrix                                                 [matrix.shared]
+//
+// A shared_matrix is a matrix whose elements are held in a reference-counted
+// buffer that is shared by its copies. Copying a shared_matrix is O(1), and
+// the elements are copied only when a copy is modified while it shares its
+// buffer (copy on write). This makes it cheap to hand snapshots of a large
+// matrix to readers, for example to other threads:
+//
+//    shared_matrix<double, 2> m(std::move(big));  // Takes the elements
+//    std::thread t(reader, m);                    // O(1), shares the buffer
+//    m(0, 0) = 1.0;                               // Copies, then writes
+//
+// The buffer is detached (copied, if it is shared) by every non-const
+// operation that can modify elements: non-const subscripting, slicing, row
+// and column access, data(), apply, the arithmetic assignment operators and
+// the non-const iterators. Const operations never copy, so readers should
+// access a snapshot through a const shared_matrix, or through get().
+//
+// As for any copy-on-write container, a reference, pointer, iterator or
+// matrix_ref obtained from a non-const operation refers to the buffer as it
+// was detached. If the shared_matrix is copied while such a reference is
+// live, writes through the reference are visible in the copy. Obtain
+// references for writing after taking snapshots, not before.
+//
+// The reference count is atomic, so copies can be made, read and destroyed
+// concurrently by different threads. A single shared_matrix object must not
+// be modified concurrently with any other access to that object.
+//
+// Template Parameters:
+//    T -- The element type stored by the matrix
+//    N -- The matrix order (number of extents).
+//    A -- The allocator used to obtain storage for elements
+template <typename T, std::size_t N, typename A>
+  class shared_matrix
+  {
+    using matrix_type = matrix<T, N, A>;
+  public:
+    static constexpr std::size_t order = N;
+
+    using value_type     = T;
+    using allocator_type = A;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+
+    // Default construction
+    shared_matrix();
+
+    // Copy semantics
+    //
+    // Copies share the buffer. Since a copy is O(1), moving a shared_matrix
+    // copies it, so that a shared_matrix never lacks a buffer.
+    shared_matrix(const shared_matrix&) = default;
+    shared_matrix& operator=(const shared_matrix&) = default;
+
+
+    // Matrix initialization
+    //
+    // Initialize the shared_matrix with the elements of m. The elements of
+    // an rvalue matrix are moved into the buffer, and not copied.
+    shared_matrix(matrix_type&& m);
+    shared_matrix(const matrix_type& m);
+
+    // Initialize the shared_matrix with the elements of the matrix,
+    // matrix_ref or expression x.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      explicit shared_matrix(const M& x);
+
+    // Extent initialization
+    template <typename... Dims>
+      explicit shared_matrix(Dims... dims);
+
+
+    // Properties
+
+    A get_allocator() const { return get().get_allocator(); }
+
+    const matrix_slice<N>& descriptor() const { return get().descriptor(); }
+
+    std::size_t extent(std::size_t n) const { return get().extent(n); }
+    std::size_t rows() const { return extent(0); }
+    std::size_t cols() const { return extent(1); }
+    std::size_t size() const { return get().size(); }
+
+    // Returns the footprint of the buffer, which is shared by the copies of
+    // the matrix.
+    memory_footprint memory_usage() const { return get().memory_usage(); }
+
+    // Returns true if the buffer is shared with another shared_matrix.
+    bool shared() const { return elems.use_count() > 1; }
+
+    // Returns the number of shared_matrix objects sharing the buffer.
+    long use_count() const { return elems.use_count(); }
+
+
+    // Snapshots
+    //
+    // Returns the matrix in the buffer. The reference remains valid until
+    // this shared_matrix is modified, assigned or destroyed.
+    const matrix_type& get() const { return *elems; }
+
+    // Returns a copy of this shared_matrix, which shares its buffer. This is
+    // the same as copying, but names the intent.
+    shared_matrix snapshot() const { return *this; }
+
+    // Returns the elements as a matrix, moving them out of the buffer if it
+    // is not shared, and copying them otherwise. This shared_matrix is left
+    // empty.
+    matrix_type release();
+
+
+    // Subscripting
+    template <typename... Args>
+      Requires<matrix_impl::Index_sequence<Args...>(), T&>
+      operator()(Args... args) { return detach()(args...); }
+
+    template <typename... Args>
+      Requires<matrix_impl::Index_sequence<Args...>(), const T&>
+      operator()(Args... args) const { return get()(args...); }
+
+    template <typename... Args>
+      Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, N>>
+      operator()(const Args&... args) { return detach()(args...); }
+
+    template <typename... Args>
+      Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<const T, N>>
+      operator()(const Args&... args) const { return get()(args...); }
+
+    matrix_ref<T, N-1>       operator[](std::size_t n)       { return row(n); }
+    matrix_ref<const T, N-1> operator[](std::size_t n) const { return row(n); }
+
+    matrix_ref<T, N-1> row(std::size_t n) { return detach().row(n); }
+    matrix_ref<const T, N-1> row(std::size_t n) const { return get().row(n); }
+
+    matrix_ref<T, N-1> col(std::size_t n) { return detach().col(n); }
+    matrix_ref<const T, N-1> col(std::size_t n) const { return get().col(n); }
+
+
+    // Data access
+    T*       data()       { return detach().data(); }
+    const T* data() const { return get().data(); }
+
+
+    // Apply
+    template <typename F>
+      shared_matrix& apply(F f);
+
+    template <typename M, typename F>
+      shared_matrix& apply(const M& m, F f);
+
+    // Scalar arithmetic
+    shared_matrix& operator=(const T& x);
+    shared_matrix& operator+=(const T& x);
+    shared_matrix& operator-=(const T& x);
+    shared_matrix& operator*=(const T& x);
+    shared_matrix& operator/=(const T& x);
+
+    // Matrix arithmetic
+    template <typename M>
+      shared_matrix& operator+=(const M& m);
+
+    template <typename M>
+      shared_matrix& operator-=(const M& m);
+
+
+    // Iterators
+    iterator begin() { return detach().begin(); }
+    iterator end()   { return detach().end(); }
+
+    const_iterator begin() const { return get().begin(); }
+    const_iterator end() const   { return get().end(); }
+
+
+    void swap(shared_matrix& x) { elems.swap(x.elems); }
+
+  private:
+    // Returns the matrix in the buffer, first copying the buffer if it is
+    // shared.
+    matrix_type& detach();
+
+  private:
+    std::shared_ptr<matrix_type> elems;
+  };
+
+
+template <typename T, std::size_t N, typename A>
+  inline
+  shared_matrix<T, N, A>::shared_matrix()
+    : elems(std::make_shared<matrix_type>())
+  { }
+
+template <typename T, std::size_t N, typename A>
+  inline
+  shared_matrix<T, N, A>::shared_matrix(matrix_type&& m)
+    : elems(std::make_shared<matrix_type>(std::move(m)))
+  { }
+
+template <typename T, std::size_t N, typename A>
+  inline
+  shared_matrix<T, N, A>::shared_matrix(const matrix_type& m)
+    : elems(std::make_shared<matrix_type>(m))
+  { }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename X>
+    inline
+    shared_matrix<T, N, A>::shared_matrix(const M& x)
+      : elems(std::make_shared<matrix_type>(x))
+    { }
+
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    shared_matrix<T, N, A>::shared_matrix(Dims... dims)
+      : elems(std::make_shared<matrix_type>(dims...))
+    { }
+
+template <typename T, std::size_t N, typename A>
+  auto
+  shared_matrix<T, N, A>::release() -> matrix_type
+  {
+    matrix_type m;
+    if (shared())
+      m = *elems;
+    else
+      m = std::move(*elems);
+    elems = std::make_shared<matrix_type>();
+    return m;
+  }
+
+// The use count is only decreased by other copies, so if it is 1, no other
+// copy can observe the buffer, and it is safe to modify.
+template <typename T, std::size_t N, typename A>
+  inline auto
+  shared_matrix<T, N, A>::detach() -> matrix_type&
+  {
+    if (shared())
+      elems = std::make_shared<matrix_type>(*elems);
+    return *elems;
+  }
+
+template <typename T, std::size_t N, typename A>
+  template <typename F>
+    inline shared_matrix<T, N, A>&
+    shared_matrix<T, N, A>::apply(F f)
+    {
+      detach().apply(f);
+      return *this;
+    }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename F>
+    inline shared_matrix<T, N, A>&
+    shared_matrix<T, N, A>::apply(const M& m, F f)
+    {
+      detach().apply(m, f);
+      return *this;
+    }
+
+template <typename T, std::size_t N, typename A>
+  inline shared_matrix<T, N, A>&
+  shared_matrix<T, N, A>::operator=(const T& x)
+  {
+    detach() = x;
+    return *this;
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline shared_matrix<T, N, A>&
+  shared_matrix<T, N, A>::operator+=(const T& x)
+  {
+    detach() += x;
+    return *this;
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline shared_matrix<T, N, A>&
+  shared_matrix<T, N, A>::operator-=(const T& x)
+  {
+    detach() -= x;
+    return *this;
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline shared_matrix<T, N, A>&
+  shared_matrix<T, N, A>::operator*=(const T& x)
+  {
+    detach() *= x;
+    return *this;
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline shared_matrix<T, N, A>&
+  shared_matrix<T, N, A>::operator/=(const T& x)
+  {
+    detach() /= x;
+    return *this;
+  }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M>
+    inline shared_matrix<T, N, A>&
+    shared_matrix<T, N, A>::operator+=(const M& m)
+    {
+      detach() += m;
+      return *this;
+    }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M>
+    inline shared_matrix<T, N, A>&
+    shared_matrix<T, N, A>::operator-=(const M& m)
+    {
+      detach() -= m;
+      return *this;
+    }
+
+template <typename T, std::size_t N, typename A>
+  inline void
+  swap(shared_matrix<T, N, A>& a, shared_matrix<T, N, A>& b)
+  {
+    a.swap(b);
+  }
+
+
+namespace matrix_impl
+{
+  // A shared matrix exposes its elements through data() and descriptor(),
+  // like a matrix. Reading them through a const shared_matrix does not
+  // detach its buffer.
+  template <typename T, std::size_t N, typename A>
+    struct is_strided_matrix<shared_matrix<T, N, A>> : std::true_type { };
+
+  template <typename T, std::size_t N, typename A>
+    struct operand_type<shared_matrix<T, N, A>>
+    {
+      using type = matrix_leaf<T, N>;
+    };
+
+  template <typename T, std::size_t N, typename A>
+    inline matrix_leaf<T, N>
+    make_operand(const shared_matrix<T, N, A>& m)
+    {
+      return {m.descriptor(), m.data()};
+    }
+
+} // namespace matrix_impl
@@ -0,0 +1,226 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// SIMD support                                                    [matrix.simd]
+//
+// The simd_traits class describes the vector registers available for a
+// scalar type T on the target architecture. When a vector type is available,
+// the traits class provides:
+//
+//    simd_traits<T>::type            -- The vector register type
+//    simd_traits<T>::width           -- The number of T's in a register
+//    simd_traits<T>::load(p)         -- Unaligned load from p
+//    simd_traits<T>::store(p, v)     -- Unaligned store to p
+//    simd_traits<T>::broadcast(x)    -- A register with each lane equal to x
+//    simd_traits<T>::add(a, b)       -- Lane-wise a + b
+//    simd_traits<T>::sub(a, b)       -- Lane-wise a - b
+//    simd_traits<T>::mul(a, b)       -- Lane-wise a * b
+//    simd_traits<T>::div(a, b)       -- Lane-wise a / b
+//    simd_traits<T>::madd(a, b, c)   -- Lane-wise a * b + c
+//    simd_traits<T>::abs(a)          -- Lane-wise |a|
+//    simd_traits<T>::min(a, b)       -- Lane-wise minimum of a and b
+//    simd_traits<T>::max(a, b)       -- Lane-wise maximum of a and b
+//
+// The multiply-add is fused when the target supports it (FMA on x86, and
+// always on AArch64), and is a multiplication and an addition otherwise.
+//
+// The instruction set is selected by the compiler's target macros, so it
+// follows whatever -m flags the library is built with: AVX if available,
+// otherwise SSE2 (which is always available on x86-64), or NEON on ARM.
+//
+// The primary template describes types for which there is no vector support.
+
+namespace matrix_impl
+{
+  template <typename T>
+    struct simd_traits
+    {
+      static constexpr bool enabled = false;
+    };
+
+  // Returns true if there is vector support for the type T.
+  template <typename T>
+    constexpr bool Simd_type()
+    {
+      return simd_traits<T>::enabled;
+    }
+
+
+#if defined(__AVX__)
+  template <>
+    struct simd_traits<double>
+    {
+      static constexpr bool enabled = true;
+      static constexpr std::size_t width = 4;
+      using type = __m256d;
+
+      static type load(const double* p) { return _mm256_loadu_pd(p); }
+      static void store(double* p, type v) { _mm256_storeu_pd(p, v); }
+      static type broadcast(double x) { return _mm256_set1_pd(x); }
+
+      static type add(type a, type b) { return _mm256_add_pd(a, b); }
+      static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+      static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+      static type div(type a, type b) { return _mm256_div_pd(a, b); }
+
+      static type madd(type a, type b, type c)
+      {
+#if defined(__FMA__)
+        return _mm256_fmadd_pd(a, b, c);
+#else
+        return add(mul(a, b), c);
+#endif
+      }
+
+      static type abs(type a) { return _mm256_andnot_pd(broadcast(-0.0), a); }
+      static type min(type a, type b) { return _mm256_min_pd(a, b); }
+      static type max(type a, type b) { return _mm256_max_pd(a, b); }
+    };
+
+  template <>
+    struct simd_traits<float>
+    {
+      static constexpr bool enabled = true;
+      static constexpr std::size_t width = 8;
+      using type = __m256;
+
+      static type load(const float* p) { return _mm256_loadu_ps(p); }
+      static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+      static type broadcast(float x) { return _mm256_set1_ps(x); }
+
+      static type add(type a, type b) { return _mm256_add_ps(a, b); }
+      static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+      static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+      static type div(type a, type b) { return _mm256_div_ps(a, b); }
+
+      static type madd(type a, type b, type c)
+      {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return add(mul(a, b), c);
+#endif
+      }
+
+      static type abs(type a) { return _mm256_andnot_ps(broadcast(-0.0f), a); }
+      static type min(type a, type b) { return _mm256_min_ps(a, b); }
+      static type max(type a, type b) { return _mm256_max_ps(a, b); }
+    };
+
+#elif defined(__SSE2__)
+  template <>
+    struct simd_traits<double>
+    {
+      static constexpr bool enabled = true;
+      static constexpr std::size_t width = 2;
+      using type = __m128d;
+
+      static type load(const double* p) { return _mm_loadu_pd(p); }
+      static void store(double* p, type v) { _mm_storeu_pd(p, v); }
+      static type broadcast(double x) { return _mm_set1_pd(x); }
+
+      static type add(type a, type b) { return _mm_add_pd(a, b); }
+      static type sub(type a, type b) { return _mm_sub_pd(a, b); }
+      static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+      static type div(type a, type b) { return _mm_div_pd(a, b); }
+
+      static type madd(type a, type b, type c)
+      {
+        return add(mul(a, b), c);
+      }
+
+      static type abs(type a) { return _mm_andnot_pd(broadcast(-0.0), a); }
+      static type min(type a, type b) { return _mm_min_pd(a, b); }
+      static type max(type a, type b) { return _mm_max_pd(a, b); }
+    };
+
+  template <>
+    struct simd_traits<float>
+    {
+      static constexpr bool enabled = true;
+      static constexpr std::size_t width = 4;
+      using type = __m128;
+
+      static type load(const float* p) { return _mm_loadu_ps(p); }
+      static void store(float* p, type v) { _mm_storeu_ps(p, v); }
+      static type broadcast(float x) { return _mm_set1_ps(x); }
+
+      static type add(type a, type b) { return _mm_add_ps(a, b); }
+      static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+      static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+      static type div(type a, type b) { return _mm_div_ps(a, b); }
+
+      static type madd(type a, type b, type c)
+      {
+        return add(mul(a, b), c);
+      }
+
+      static type abs(type a) { return _mm_andnot_ps(broadcast(-0.0f), a); }
+      static type min(type a, type b) { return _mm_min_ps(a, b); }
+      static type max(type a, type b) { return _mm_max_ps(a, b); }
+    };
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  template <>
+    struct simd_traits<double>
+    {
+      static constexpr bool enabled = true;
+      static constexpr std::size_t width = 2;
+      using type = float64x2_t;
+
+      static type load(const double* p) { return vld1q_f64(p); }
+      static void store(double* p, type v) { vst1q_f64(p, v); }
+      static type broadcast(double x) { return vdupq_n_f64(x); }
+
+      static type add(type a, type b) { return vaddq_f64(a, b); }
+      static type sub(type a, type b) { return vsubq_f64(a, b); }
+      static type mul(type a, type b) { return vmulq_f64(a, b); }
+      static type div(type a, type b) { return vdivq_f64(a, b); }
+
+      static type madd(type a, type b, type c)
+      {
+        return vfmaq_f64(c, a, b);
+      }
+
+      static type abs(type a) { return vabsq_f64(a); }
+      static type min(type a, type b) { return vminq_f64(a, b); }
+      static type max(type a, type b) { return vmaxq_f64(a, b); }
+    };
+
+  template <>
+    struct simd_traits<float>
+    {
+      static constexpr bool enabled = true;
+      static constexpr std::size_t width = 4;
+      using type = float32x4_t;
+
+      static type load(const float* p) { return vld1q_f32(p); }
+      static void store(float* p, type v) { vst1q_f32(p, v); }
+      static type broadcast(float x) { return vdupq_n_f32(x); }
+
+      static type add(type a, type b) { return vaddq_f32(a, b); }
+      static type sub(type a, type b) { return vsubq_f32(a, b); }
+      static type mul(type a, type b) { return vmulq_f32(a, b); }
+      static type div(type a, type b) { return vdivq_f32(a, b); }
+
+      static type madd(type a, type b, type c)
+      {
+        return vfmaq_f32(c, a, b);
+      }
+
+      static type abs(type a) { return vabsq_f32(a); }
+      static type min(type a, type b) { return vminq_f32(a, b); }
+      static type max(type a, type b) { return vmaxq_f32(a, b); }
+    };
+#endif
+
+} // namespace matrix_impl
@@ -51,6 +51,56 @@ template<typename C, typename T>
 
 
 
+// -------------------------------------------------------------------------- //
+//                              Offset Computation
+//
+// The offset of an element is the sum of the products of its indexes and the
+// strides of the slice. The sums are computed by recursion over the indexes,
+// which the compiler unrolls, so that m(i, j) compiles to start + i * s0 +
+// j * s1 with no loop and no array of indexes.
+//
+// When the innermost stride is known to be 1, as it is for a matrix and a
+// dense_ref, unit_offset omits the last multiplication, so that a(i, k)
+// compiles to i * s0 + k. The compiler can then hoist i * s0 out of a loop
+// over k and vectorize the loop.
+
+namespace matrix_impl
+{
+  // Returns the sum of s[D + k] * i_k over the indexes i_k.
+  template <std::size_t D>
+    inline std::size_t
+    strided_offset(const std::size_t*)
+    {
+      return 0;
+    }
+
+  template <std::size_t D, typename... Args>
+    inline std::size_t
+    strided_offset(const std::size_t* s, std::size_t i, Args... args)
+    {
+      return s[D] * i + strided_offset<D + 1>(s, args...);
+    }
+
+  // Returns the sum of s[D + k] * i_k over the indexes i_k, except that the
+  // last index is not multiplied by its stride, which is assumed to be 1.
+  template <std::size_t D>
+    inline std::size_t
+    unit_offset(const std::size_t*, std::size_t i)
+    {
+      return i;
+    }
+
+  template <std::size_t D, typename... Args>
+    inline std::size_t
+    unit_offset(const std::size_t* s, std::size_t i, std::size_t j, 
+                Args... args)
+    {
+      return s[D] * i + unit_offset<D + 1>(s, j, args...);
+    }
+
+} // namespace matrix_impl
+
+
 // -------------------------------------------------------------------------- //
 //                                Matrix Slice
 //
@@ -192,7 +242,8 @@ template<std::size_t N>
     assert(strs.size() == N);
     std::copy(exts.begin(), exts.end(), extents);
     std::copy(strs.begin(), strs.end(), strides);
-    size = extents[0] * strides[0];
+    std::multiplies<std::size_t> mul;
+    size = std::accumulate(extents, extents + N, std::size_t(1), mul);
   }
 
 template<std::size_t N>
@@ -211,8 +262,8 @@ template<std::size_t N>
     matrix_slice<N>::operator()(Args... args) const
     {
       static_assert(sizeof...(Args) == N, "");
-      std::size_t indexes[N] {std::size_t(args)...};
-      return offset(indexes);
+      using matrix_impl::strided_offset;
+      return start + strided_offset<0>(strides, std::size_t(args)...);
     }
 
 template<std::size_t N>
@@ -0,0 +1,476 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Small matrix                                                   [matrix.small]
+//
+// The small_matrix template is an R x C matrix whose extents are fixed at
+// compile time. Its elements are stored inline (in row-major order), so
+// creating one does not allocate memory, and it does not store a
+// descriptor. Small matrices are intended for small, fixed-size problems
+// like 3x3 and 4x4 transforms.
+//
+// A small matrix is a literal type. Its arithmetic operations (+, -, scalar
+// * and /, and the matrix product) are constexpr, and each expands to a
+// fixed sequence of element operations with no loops. For example:
+//
+//    constexpr small_matrix<double, 2, 2> r {0, -1, 1, 0};
+//    constexpr auto r2 = r * r;
+//    static_assert(r2(0, 0) == -1, "");
+//
+// Small matrices model the Matrix concept and can be used with the generic
+// matrix operations (e.g., rows(), cols(), ==, and <<). They can also be
+// used to initialize or assign a matrix<T, 2>. However, they do not
+// participate in matrix expressions; arithmetic on small matrices always
+// produces a small_matrix.
+
+namespace matrix_impl
+{
+  // An index sequence is a compile-time list of indexes used to expand an
+  // operation over each element of a small matrix.
+  template <std::size_t... I>
+    struct index_sequence { };
+
+  template <std::size_t N, std::size_t... I>
+    struct make_index_sequence_impl
+      : make_index_sequence_impl<N - 1, N - 1, I...>
+    { };
+
+  template <std::size_t... I>
+    struct make_index_sequence_impl<0, I...>
+    {
+      using type = index_sequence<I...>;
+    };
+
+  // The sequence of indexes 0, 1, ..., N - 1.
+  template <std::size_t N>
+    using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+  // Returns true if each type in Args can be converted to T.
+  template <typename T, typename... Args>
+    constexpr bool Element_sequence()
+    {
+      return All(Convertible<Args, T>()...);
+    }
+
+} // namespace matrix_impl
+
+
+// The small_matrix class.
+//
+// Template Parameters:
+//    T -- The element type stored by the matrix
+//    R -- The number of rows
+//    C -- The number of columns
+template <typename T, std::size_t R, std::size_t C>
+  class small_matrix
+  {
+    static_assert(R != 0 && C != 0, "small matrix has no elements");
+  public:
+    static constexpr std::size_t order = 2;
+
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+
+    // Default construction
+    //
+    // All elements are value initialized.
+    constexpr small_matrix() : elems{} { }
+
+
+    // Element initialization
+    //
+    // Initialize the elements of the matrix from the R * C arguments in
+    // row-major order. For example:
+    //
+    //    small_matrix<int, 2, 2> m {1, 2,
+    //                               3, 4};
+    template <typename... Args,
+              typename = Requires<sizeof...(Args) == R * C
+                               && matrix_impl::Element_sequence<T, Args...>()>>
+      constexpr small_matrix(Args... args) : elems{T(args)...} { }
+
+
+    // Value initialization
+    //
+    // Initialize the matrix over a nesting of initializer lists. The number
+    // of rows and columns must be the same as those of the matrix.
+    small_matrix(matrix_initializer<T, 2> init);
+
+
+    // Properties
+
+    // Returns a slice describing the matrix.
+    matrix_slice<2> descriptor() const { return {0, {R, C}}; }
+
+    // Returns the extent of the matrix in the nth dimension.
+    constexpr std::size_t extent(std::size_t n) const { return n ? C : R; }
+
+    // Returns the number of rows in the matrix.
+    constexpr std::size_t rows() const { return R; }
+
+    // Returns the number of columns in the matrix.
+    constexpr std::size_t cols() const { return C; }
+
+    // Returns the total number of elements in the matrix.
+    constexpr std::size_t size() const { return R * C; }
+
+
+    // Subscripting
+    //
+    // Returns a reference to the element in the ith row and jth column.
+    T& operator()(std::size_t i, std::size_t j)
+    {
+      assert(i < R && j < C);
+      return elems[i * C + j];
+    }
+
+    constexpr const T& operator()(std::size_t i, std::size_t j) const
+    {
+      return elems[i * C + j];
+    }
+
+
+    // Row subscripting
+    //
+    // Returns a reference to the nth row of the matrix.
+    matrix_ref<T, 1>       operator[](std::size_t n)       { return row(n); }
+    matrix_ref<const T, 1> operator[](std::size_t n) const { return row(n); }
+
+    // Row
+    //
+    // Returns a matrix_ref referring to the nth row of the matrix.
+    matrix_ref<T, 1>       row(std::size_t n);
+    matrix_ref<const T, 1> row(std::size_t n) const;
+
+    // Column
+    //
+    // Returns a matrix_ref referring to the nth column of the matrix.
+    matrix_ref<T, 1>       col(std::size_t n);
+    matrix_ref<const T, 1> col(std::size_t n) const;
+
+
+    // Data access
+    //
+    // Returns a pointer to the underlying data.
+    T*       data()       { return elems; }
+    const T* data() const { return elems; }
+
+
+    // Scalar arithmetic
+    small_matrix& operator=(const T& x);
+    small_matrix& operator+=(const T& x);
+    small_matrix& operator-=(const T& x);
+    small_matrix& operator*=(const T& x);
+    small_matrix& operator/=(const T& x);
+
+    // Matrix arithmetic
+    small_matrix& operator+=(const small_matrix& x);
+    small_matrix& operator-=(const small_matrix& x);
+
+
+    // Iterators
+    iterator begin() { return elems; }
+    iterator end()   { return elems + R * C; }
+
+    const_iterator begin() const { return elems; }
+    const_iterator end() const   { return elems + R * C; }
+
+  private:
+    T elems[R * C];
+  };
+
+
+template <typename T, std::size_t R, std::size_t C>
+  inline
+  small_matrix<T, R, C>::small_matrix(matrix_initializer<T, 2> init)
+    : elems{}
+  {
+    assert(init.size() == R);
+    T* p = elems;
+    for (const auto& r : init) {
+      assert(r.size() == C);
+      p = std::copy(r.begin(), r.end(), p);
+    }
+  }
+
+
+// Row
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<T, 1>
+  small_matrix<T, R, C>::row(std::size_t n)
+  {
+    assert(n < R);
+    matrix_slice<1> row(descriptor(), size_constant<0>(), n);
+    return {row, data()};
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<const T, 1>
+  small_matrix<T, R, C>::row(std::size_t n) const
+  {
+    assert(n < R);
+    matrix_slice<1> row(descriptor(), size_constant<0>(), n);
+    return {row, data()};
+  }
+
+// Column
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<T, 1>
+  small_matrix<T, R, C>::col(std::size_t n)
+  {
+    assert(n < C);
+    matrix_slice<1> col(descriptor(), size_constant<1>(), n);
+    return {col, data()};
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<const T, 1>
+  small_matrix<T, R, C>::col(std::size_t n) const
+  {
+    assert(n < C);
+    matrix_slice<1> col(descriptor(), size_constant<1>(), n);
+    return {col, data()};
+  }
+
+
+// Scalar arithmetic
+//
+// The number of elements is known at compile time, so these loops are
+// trivially unrolled by the compiler.
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator=(const T& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] = x;
+    return *this;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator+=(const T& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] += x;
+    return *this;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator-=(const T& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] -= x;
+    return *this;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator*=(const T& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] *= x;
+    return *this;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator/=(const T& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] /= x;
+    return *this;
+  }
+
+// Matrix arithmetic
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator+=(const small_matrix& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] += x.elems[i];
+    return *this;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline small_matrix<T, R, C>&
+  small_matrix<T, R, C>::operator-=(const small_matrix& x)
+  {
+    for (std::size_t i = 0; i != R * C; ++i)
+      elems[i] -= x.elems[i];
+    return *this;
+  }
+
+
+namespace matrix_impl
+{
+  // Small matrices expose their elements, so the element-wise kernels can
+  // operate on them directly.
+  template <typename T, std::size_t R, std::size_t C>
+    struct is_strided_matrix<small_matrix<T, R, C>> : std::true_type { };
+
+
+  // The following functions implement the constexpr arithmetic operations
+  // of small matrices. Each expands the operation over the index sequence
+  // of elements, with I / C and I % C giving the row and column of the Ith
+  // element.
+
+  template <typename T, std::size_t R, std::size_t C, std::size_t... I>
+    constexpr small_matrix<T, R, C>
+    small_add(const small_matrix<T, R, C>& a,
+              const small_matrix<T, R, C>& b,
+              index_sequence<I...>)
+    {
+      return {(a(I / C, I % C) + b(I / C, I % C))...};
+    }
+
+  template <typename T, std::size_t R, std::size_t C, std::size_t... I>
+    constexpr small_matrix<T, R, C>
+    small_sub(const small_matrix<T, R, C>& a,
+              const small_matrix<T, R, C>& b,
+              index_sequence<I...>)
+    {
+      return {(a(I / C, I % C) - b(I / C, I % C))...};
+    }
+
+  template <typename T, std::size_t R, std::size_t C, std::size_t... I>
+    constexpr small_matrix<T, R, C>
+    small_neg(const small_matrix<T, R, C>& a, index_sequence<I...>)
+    {
+      return {(-a(I / C, I % C))...};
+    }
+
+  template <typename T, std::size_t R, std::size_t C, std::size_t... I>
+    constexpr small_matrix<T, R, C>
+    small_mul(const small_matrix<T, R, C>& a,
+              const T& n,
+              index_sequence<I...>)
+    {
+      return {(a(I / C, I % C) * n)...};
+    }
+
+  template <typename T, std::size_t R, std::size_t C, std::size_t... I>
+    constexpr small_matrix<T, R, C>
+    small_div(const small_matrix<T, R, C>& a,
+              const T& n,
+              index_sequence<I...>)
+    {
+      return {(a(I / C, I % C) / n)...};
+    }
+
+  // Returns the sum of a(i, k) * b(k, j) for k in [0, K).
+  template <typename T, std::size_t R, std::size_t K, std::size_t C>
+    constexpr T
+    small_dot(const small_matrix<T, R, K>& a,
+              const small_matrix<T, K, C>& b,
+              std::size_t i, std::size_t j,
+              size_constant<1>)
+    {
+      return a(i, 0) * b(0, j);
+    }
+
+  template <typename T,
+            std::size_t R, std::size_t K, std::size_t C,
+            std::size_t N>
+    constexpr T
+    small_dot(const small_matrix<T, R, K>& a,
+              const small_matrix<T, K, C>& b,
+              std::size_t i, std::size_t j,
+              size_constant<N>)
+    {
+      return small_dot(a, b, i, j, size_constant<N - 1>())
+           + a(i, N - 1) * b(N - 1, j);
+    }
+
+  template <typename T,
+            std::size_t R, std::size_t K, std::size_t C,
+            std::size_t... I>
+    constexpr small_matrix<T, R, C>
+    small_product(const small_matrix<T, R, K>& a,
+                  const small_matrix<T, K, C>& b,
+                  index_sequence<I...>)
+    {
+      return {small_dot(a, b, I / C, I % C, size_constant<K>())...};
+    }
+
+} // namespace matrix_impl
+
+
+// Small matrix addition
+template <typename T, std::size_t R, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator+(const small_matrix<T, R, C>& a, const small_matrix<T, R, C>& b)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_add(a, b, Seq());
+  }
+
+// Small matrix subtraction
+template <typename T, std::size_t R, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator-(const small_matrix<T, R, C>& a, const small_matrix<T, R, C>& b)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_sub(a, b, Seq());
+  }
+
+// Small matrix negation
+template <typename T, std::size_t R, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator-(const small_matrix<T, R, C>& a)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_neg(a, Seq());
+  }
+
+// Small matrix scalar multiplication
+template <typename T, std::size_t R, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator*(const small_matrix<T, R, C>& a, const Identity<T>& n)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_mul(a, n, Seq());
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator*(const Identity<T>& n, const small_matrix<T, R, C>& a)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_mul(a, n, Seq());
+  }
+
+// Small matrix scalar division
+template <typename T, std::size_t R, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator/(const small_matrix<T, R, C>& a, const Identity<T>& n)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_div(a, n, Seq());
+  }
+
+// Small matrix multiplication
+//
+// The product of an R x K and a K x C small matrix is an R x C small matrix.
+template <typename T, std::size_t R, std::size_t K, std::size_t C>
+  constexpr small_matrix<T, R, C>
+  operator*(const small_matrix<T, R, K>& a, const small_matrix<T, K, C>& b)
+  {
+    using Seq = matrix_impl::make_index_sequence<R * C>;
+    return matrix_impl::small_product(a, b, Seq());
+  }
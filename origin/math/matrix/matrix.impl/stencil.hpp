@@ -0,0 +1,490 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Stencils                                                     [matrix.stencil]
+//
+// A stencil computes each element of a matrix as a weighted sum of the
+// elements at fixed offsets from it. For example, one step of the explicit
+// heat equation on a 2D grid is:
+//
+//    stencil<float, 2> s {
+//      {{0, 0}, 0.6f},
+//      {{-1, 0}, 0.1f}, {{1, 0}, 0.1f}, {{0, -1}, 0.1f}, {{0, 1}, 0.1f}
+//    };
+//    apply_stencil(s, in, out);      // One step, from in to out
+//    run_stencil(s, grid, 100);      // 100 steps of grid, in place
+//
+// The operands are matrices or contiguous matrix_refs of order 2 or more.
+// Offsets that fall outside the matrix read its boundary, which is chosen
+// by the options:
+//
+//    boundary::zero       The elements outside the matrix are 0
+//    boundary::clamp      The nearest element of the matrix is read
+//    boundary::periodic   The indexes wrap around each extent
+//
+// The offsets of a stencil are converted to distances in memory once, so
+// that an element whose neighbors are all in the matrix is computed by
+// adding each shifted row, scaled by its weight, with the vector kernel of
+// axpy (see [matrix.blas]). Only the elements within the radius of the
+// stencil from the boundary take the general path. stencil_interior(m, s)
+// is a matrix_ref of the elements whose neighbors are all in m.
+//
+// The matrix is divided into tiles of consecutive planes (indexes in the
+// first dimension), which are computed in parallel. With temporal blocking,
+// each tile is copied with a halo of neighboring planes to a local buffer,
+// where time_block steps are computed before the tile is written back; the
+// planes of the halo are recomputed by each neighboring tile, so that the
+// tiles do not exchange planes between steps, and the matrix is traversed
+// once every time_block steps.
+
+// The boundary condition of a stencil.
+enum class boundary { zero, clamp, periodic };
+
+
+// The stencil_options class controls the application of a stencil.
+struct stencil_options
+{
+  stencil_options()
+    : edge(boundary::zero), time_block(4)
+  { }
+
+  boundary edge;          // The boundary condition
+  std::size_t time_block; // The number of steps computed per traversal
+};
+
+
+// The stencil class is a set of offsets and their weights.
+//
+// Template Parameters:
+//    T -- The type of the weights
+//    N -- The order of the matrices the stencil is applied to
+template <typename T, std::size_t N>
+  class stencil
+  {
+  public:
+    using offset_type = std::array<std::ptrdiff_t, N>;
+
+    struct entry
+    {
+      offset_type offset;
+      T weight;
+    };
+
+    using const_iterator = typename std::vector<entry>::const_iterator;
+
+
+    // Default construction
+    //
+    // Initialize an empty stencil.
+    stencil() : radii() { }
+
+    // Value initialization
+    //
+    // Initialize the stencil with the given offsets and weights.
+    stencil(std::initializer_list<entry> list);
+
+
+    // Add the weight w at the offset off.
+    void add(const offset_type& off, const T& w);
+
+    // Returns the number of offsets.
+    std::size_t size() const { return entries.size(); }
+
+    // Returns the greatest distance of an offset in the dth dimension.
+    std::size_t radius(std::size_t d) const { return radii[d]; }
+
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const   { return entries.end(); }
+
+  private:
+    std::vector<entry> entries;
+    std::size_t radii[N];
+  };
+
+
+template <typename T, std::size_t N>
+  stencil<T, N>::stencil(std::initializer_list<entry> list)
+    : radii()
+  {
+    for (const entry& e : list)
+      add(e.offset, e.weight);
+  }
+
+template <typename T, std::size_t N>
+  void
+  stencil<T, N>::add(const offset_type& off, const T& w)
+  {
+    for (std::size_t d = 0; d != N; ++d) {
+      std::size_t r = off[d] < 0 ? std::size_t(-off[d]) : std::size_t(off[d]);
+      radii[d] = std::max(radii[d], r);
+    }
+    entries.push_back({off, w});
+  }
+
+
+// Returns the 2N + 1 point discrete Laplacian: -2N at the center and 1 at
+// each adjacent element.
+template <typename T, std::size_t N>
+  stencil<T, N>
+  laplacian_stencil()
+  {
+    stencil<T, N> s;
+    typename stencil<T, N>::offset_type off {};
+    s.add(off, -T(2 * N));
+    for (std::size_t d = 0; d != N; ++d) {
+      off[d] = -1;
+      s.add(off, T(1));
+      off[d] = 1;
+      s.add(off, T(1));
+      off[d] = 0;
+    }
+    return s;
+  }
+
+
+namespace matrix_impl
+{
+  // Returns the slice of the elements of d that are at least the radius of
+  // the stencil s from each boundary.
+  template <typename T, std::size_t N>
+    matrix_slice<N>
+    interior_slice(matrix_slice<N> d, const stencil<T, N>& s)
+    {
+      d.size = 1;
+      for (std::size_t k = 0; k != N; ++k) {
+        std::size_t r = s.radius(k);
+        std::size_t e = d.extents[k] > 2 * r ? d.extents[k] - 2 * r : 0;
+        d.start += r * d.strides[k];
+        d.extents[k] = e;
+        d.size *= e;
+      }
+      return d;
+    }
+
+} // namespace matrix_impl
+
+
+// Returns a matrix_ref referring to the elements of m whose neighbors under
+// the stencil s are all in m. No elements are copied.
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<T, N>
+  stencil_interior(matrix<T, N, A>& m, const stencil<T, N>& s)
+  {
+    return {matrix_impl::interior_slice(m.descriptor(), s), m.data()};
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<const T, N>
+  stencil_interior(const matrix<T, N, A>& m, const stencil<T, N>& s)
+  {
+    return {matrix_impl::interior_slice(m.descriptor(), s), m.data()};
+  }
+
+template <typename T, std::size_t N>
+  inline matrix_ref<T, N>
+  stencil_interior(matrix_ref<T, N> m, const stencil<Remove_const<T>, N>& s)
+  {
+    return {matrix_impl::interior_slice(m.descriptor(), s), m.data()};
+  }
+
+
+namespace matrix_impl
+{
+  // The minimum number of elements of a matrix for which a stencil is
+  // applied in parallel.
+  constexpr std::size_t parallel_stencil = 1 << 15;
+
+  // The minimum number of elements in a tile.
+  constexpr std::size_t stencil_tile_size = 1 << 14;
+
+  // Returns i wrapped into [0, n).
+  inline std::size_t
+  wrap_index(std::ptrdiff_t i, std::size_t n)
+  {
+    std::ptrdiff_t m = std::ptrdiff_t(n);
+    std::ptrdiff_t r = i % m;
+    return std::size_t(r < 0 ? r + m : r);
+  }
+
+  // The stencil_plan class describes the application of a stencil to a
+  // row-major matrix with the given extents: the distance in memory of each
+  // offset, and the extents and strides of the matrix. Offsets in the first
+  // dimension are distances between planes of a buffer, which has the
+  // same plane size as the matrix.
+  template <typename T, std::size_t N>
+    struct stencil_plan
+    {
+      stencil_plan(const stencil<T, N>& s, const std::size_t* exts,
+                   boundary b)
+        : edge(b), offsets(s.size() * N), weights(s.size()),
+          deltas(s.size())
+      {
+        std::copy(exts, exts + N, extents);
+        strides[N - 1] = 1;
+        for (std::size_t d = N - 1; d != 0; --d)
+          strides[d - 1] = strides[d] * extents[d];
+        plane = strides[0];
+        for (std::size_t d = 0; d != N; ++d)
+          radii[d] = s.radius(d);
+
+        std::size_t k = 0;
+        for (const auto& e : s) {
+          std::ptrdiff_t delta = 0;
+          for (std::size_t d = 0; d != N; ++d) {
+            offsets[k * N + d] = e.offset[d];
+            delta += e.offset[d] * std::ptrdiff_t(strides[d]);
+          }
+          weights[k] = e.weight;
+          deltas[k] = delta;
+          ++k;
+        }
+      }
+
+      std::size_t count() const { return weights.size(); }
+
+      // Returns the value at the element (p, idx), where p is a plane of the
+      // buffer src and idx the remaining indexes, reading the boundary for
+      // offsets outside the matrix.
+      T edge_point(const T* src, std::size_t p, const std::size_t* idx) const
+      {
+        T sum = T(0);
+        for (std::size_t k = 0; k != count(); ++k) {
+          const std::ptrdiff_t* off = &offsets[k * N];
+          std::size_t at = (p + off[0]) * plane;
+          bool inside = true;
+          for (std::size_t d = 1; d != N; ++d) {
+            std::ptrdiff_t i = std::ptrdiff_t(idx[d]) + off[d];
+            std::ptrdiff_t e = std::ptrdiff_t(extents[d]);
+            if (i < 0 || i >= e) {
+              if (edge == boundary::zero) {
+                inside = false;
+                break;
+              }
+              i = edge == boundary::clamp ? (i < 0 ? 0 : e - 1)
+                                          : std::ptrdiff_t(wrap_index(i, e));
+            }
+            at += std::size_t(i) * strides[d];
+          }
+          if (inside)
+            sum += weights[k] * src[at];
+        }
+        return sum;
+      }
+
+      boundary edge;
+      std::size_t extents[N];
+      std::size_t strides[N];
+      std::size_t radii[N];
+      std::size_t plane;
+      std::vector<std::ptrdiff_t> offsets;
+      std::vector<T> weights;
+      std::vector<std::ptrdiff_t> deltas;
+    };
+
+  // Compute the planes [first, last) of dst from src, which are buffers of
+  // planes laid out like the matrix, and whose planes first - r and
+  // last + r - 1 are present, where r is the radius in the first dimension.
+  template <typename T, std::size_t N>
+    void
+    stencil_planes(const stencil_plan<T, N>& sp, const T* src, T* dst,
+                   std::size_t first, std::size_t last)
+    {
+      std::size_t n = sp.extents[N - 1];
+      std::size_t r = sp.radii[N - 1];
+      std::size_t rows = sp.plane / std::max<std::size_t>(n, 1);
+      std::size_t idx[N] = {};
+      for (std::size_t p = first; p != last; ++p) {
+        for (std::size_t row = 0; row != rows; ++row) {
+          // Compute the indexes of the row, and whether its neighbors in the
+          // middle dimensions are all in the matrix.
+          bool inner = true;
+          for (std::size_t d = N - 1, k = row; d-- > 1; ) {
+            idx[d] = k % sp.extents[d];
+            k /= sp.extents[d];
+            inner = inner && idx[d] >= sp.radii[d]
+                          && idx[d] + sp.radii[d] < sp.extents[d];
+          }
+          std::size_t base = p * sp.plane + row * n;
+          T* out = dst + base;
+          std::size_t lo = n, hi = n;
+          if (inner && n > 2 * r) {
+            lo = r;
+            hi = n - r;
+            std::fill(out + lo, out + hi, T(0));
+            for (std::size_t k = 0; k != sp.count(); ++k)
+              axpy_n(sp.weights[k], src + (base + lo + sp.deltas[k]),
+                     out + lo, hi - lo);
+          }
+          for (std::size_t j = 0; j != n; ++j) {
+            if (j == lo)
+              j = hi;
+            if (j == n)
+              break;
+            idx[N - 1] = j;
+            out[j] = sp.edge_point(src, p, idx);
+          }
+        }
+      }
+    }
+
+  // Compute steps applications of the stencil to the planes [t0, t1) of the
+  // matrix src, writing them to dst. The planes are copied with a halo of
+  // steps * r planes on each side to a local buffer, where the steps are
+  // computed on a shrinking range of planes.
+  template <typename T, std::size_t N>
+    void
+    stencil_tile(const stencil_plan<T, N>& sp, const T* src, T* dst,
+                 std::size_t t0, std::size_t t1, std::size_t steps)
+    {
+      std::ptrdiff_t rows = std::ptrdiff_t(sp.extents[0]);
+      std::ptrdiff_t r = std::ptrdiff_t(sp.radii[0]);
+      std::ptrdiff_t h = std::ptrdiff_t(steps) * r;
+      bool periodic = sp.edge == boundary::periodic;
+
+      // When the halo crosses the first or last plane, it is replaced by r
+      // planes of the boundary, which are recomputed after each step.
+      std::ptrdiff_t g0 = std::ptrdiff_t(t0) - h;
+      std::ptrdiff_t g1 = std::ptrdiff_t(t1) + h;
+      bool low = !periodic && g0 < 0;
+      bool high = !periodic && g1 > rows;
+      if (low)
+        g0 = -r;
+      if (high)
+        g1 = rows + r;
+
+      std::size_t p = sp.plane;
+      std::size_t nb = std::size_t(g1 - g0);
+      std::vector<T> a(nb * p, T(0));
+      std::vector<T> b(nb * p, T(0));
+
+      // Returns the plane of the matrix read for the plane g of the buffer.
+      auto source = [&](std::ptrdiff_t g) -> std::ptrdiff_t {
+        if (periodic)
+          return std::ptrdiff_t(wrap_index(g, std::size_t(rows)));
+        if (g < 0)
+          return sp.edge == boundary::clamp ? 0 : -1;
+        if (g >= rows)
+          return sp.edge == boundary::clamp ? rows - 1 : -1;
+        return g;
+      };
+      for (std::ptrdiff_t g = g0; g != g1; ++g) {
+        std::ptrdiff_t s = source(g);
+        if (s >= 0)
+          std::copy_n(src + std::size_t(s) * p, p,
+                      a.data() + std::size_t(g - g0) * p);
+      }
+
+      T* cur = a.data();
+      T* next = b.data();
+      for (std::size_t s = 1; s <= steps; ++s) {
+        std::ptrdiff_t c0 = low ? 0 : g0 + std::ptrdiff_t(s) * r;
+        std::ptrdiff_t c1 = high ? rows : g1 - std::ptrdiff_t(s) * r;
+        stencil_planes(sp, cur, next, std::size_t(c0 - g0),
+                       std::size_t(c1 - g0));
+
+        // The clamped boundary planes are copies of the first and last.
+        if (sp.edge == boundary::clamp) {
+          for (std::ptrdiff_t g = g0; g < 0; ++g)
+            std::copy_n(next + std::size_t(-g0) * p, p,
+                        next + std::size_t(g - g0) * p);
+          for (std::ptrdiff_t g = rows; g < g1 && high; ++g)
+            std::copy_n(next + std::size_t(rows - 1 - g0) * p, p,
+                        next + std::size_t(g - g0) * p);
+        }
+        std::swap(cur, next);
+      }
+
+      std::copy_n(cur + std::size_t(std::ptrdiff_t(t0) - g0) * p,
+                  (t1 - t0) * p, dst + t0 * p);
+    }
+
+  // Compute steps applications of the stencil to the matrix src, writing
+  // them to dst, which must not overlap src.
+  template <typename T, std::size_t N>
+    void
+    stencil_steps(const stencil_plan<T, N>& sp, const T* src, T* dst,
+                  std::size_t steps)
+    {
+      std::size_t rows = sp.extents[0];
+      std::size_t size = rows * sp.plane;
+      if (size == 0)
+        return;
+
+      std::size_t threads = size < parallel_stencil ? 1 : product_threads();
+      std::size_t h = steps * sp.radii[0];
+      std::size_t th = std::max(stencil_tile_size / std::max<std::size_t>(
+                                  sp.plane, 1), 2 * h);
+      th = std::max<std::size_t>(std::min(th, (rows + threads - 1) / threads),
+                                 1);
+      std::size_t tiles = (rows + th - 1) / th;
+      parallel_for(tiles, threads, [&](std::size_t k) {
+        std::size_t t0 = k * th;
+        stencil_tile(sp, src, dst, t0, std::min(rows, t0 + th), steps);
+      });
+    }
+
+  template <typename M>
+    inline void
+    check_stencil_operand(const M& m)
+    {
+      static_assert(Strided_matrix<M>(), "");
+      static_assert(M::order >= 2, "");
+      assert(is_contiguous(m.descriptor()));
+    }
+
+} // namespace matrix_impl
+
+
+// Apply the stencil s once to the matrix in, writing the result to out,
+// which has the same extents and does not overlap in. Both must be matrices
+// or contiguous matrix_refs.
+template <typename T, typename M1, typename M2>
+  void
+  apply_stencil(const stencil<T, M1::order>& s, const M1& in, M2&& out,
+                const stencil_options& opts = stencil_options())
+  {
+    using M = Remove_reference<M2>;
+    matrix_impl::check_stencil_operand(in);
+    matrix_impl::check_stencil_operand(out);
+    static_assert(Same<Remove_const<Value_type<M1>>, T>(), "");
+    static_assert(Same<Value_type<M>, T>(), "");
+    assert(same_extents(in.descriptor(), out.descriptor()));
+    ORIGIN_TIME_SCOPE("matrix.stencil");
+
+    const matrix_slice<M1::order>& d = in.descriptor();
+    matrix_impl::stencil_plan<T, M1::order> sp(s, d.extents, opts.edge);
+    matrix_impl::stencil_steps(sp, in.data() + d.start,
+                               out.data() + out.descriptor().start, 1);
+  }
+
+
+// Apply the stencil s to the matrix m steps times, in place. A temporary
+// matrix of the extents of m is allocated, and the matrix is traversed once
+// for each time_block steps of the options.
+template <typename T, std::size_t N, typename A>
+  void
+  run_stencil(const stencil<T, N>& s, matrix<T, N, A>& m, std::size_t steps,
+              const stencil_options& opts = stencil_options())
+  {
+    static_assert(N >= 2, "");
+    ORIGIN_TIME_SCOPE("matrix.stencil");
+
+    matrix_impl::stencil_plan<T, N> sp(s, m.descriptor().extents, opts.edge);
+    matrix<T, N, A> tmp(first_touch, m.descriptor(), m.get_allocator());
+    std::size_t block = std::max<std::size_t>(opts.time_block, 1);
+    while (steps != 0) {
+      std::size_t n = std::min(steps, block);
+      matrix_impl::stencil_steps(sp, m.data(), tmp.data(), n);
+      m.swap(tmp);
+      steps -= n;
+    }
+  }
@@ -0,0 +1,499 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Matrix storage                                               [matrix.storage]
+//
+// The elements of a matrix are stored in a single dynamically allocated
+// array obtained from an allocator. By default, matrices use the
+// aligned_allocator, which places the first element on a 64-byte boundary.
+// This guarantees that rows of the vectorized kernels and the packed panels
+// of the blocked product start on a cache line.
+
+
+// The uninitialized tag requests that the elements of a matrix are default
+// initialized rather than value initialized. For arithmetic types, this
+// leaves the elements with indeterminate values, avoiding a pass over memory
+// when every element will be overwritten anyway. For example:
+//
+//    matrix<double, 2> m(uninitialized, 1024, 1024);
+//    fill_random(m);
+struct uninitialized_t { };
+
+constexpr uninitialized_t uninitialized { };
+
+
+// The first touch tag requests that the elements of a matrix are zero
+// initialized in parallel, by the threads that compute matrix products. On
+// NUMA systems using the first touch placement policy, this places each
+// block of rows on the node of a thread that will later process it. For
+// example:
+//
+//    matrix<double, 2, numa_allocator<double>> m(first_touch, 4096, 4096);
+//
+// Only matrices of arithmetic type can be initialized this way.
+struct first_touch_t { };
+
+constexpr first_touch_t first_touch { };
+
+
+// The element buffer tags construct a matrix from elements that already
+// exist in memory, or from a function computing each element, writing each
+// element once:
+//
+//    matrix<double, 2> a(copy_elements, p, m, n);     // Copy m * n from p
+//    matrix<double, 2> b(adopt_elements, q, m, n);    // Take ownership of q
+//    matrix<double, 2> c(generate_elements, f, m, n); // c(i, j) = f(i, j)
+//
+// A copied buffer holds the elements in row-major order. A buffer of
+// trivially copyable elements is copied by memcpy, in parallel parts when
+// it is large. An adopted buffer must have been obtained from the matrix's
+// allocator, A().allocate(m * n), and its elements constructed; the matrix
+// releases it as its own. A generator is called once for each element with
+// its indexes, concurrently for different rows of a large matrix, so it
+// must be safe to call from several threads.
+struct copy_elements_t { };
+struct adopt_elements_t { };
+struct generate_elements_t { };
+
+constexpr copy_elements_t copy_elements { };
+constexpr adopt_elements_t adopt_elements { };
+constexpr generate_elements_t generate_elements { };
+
+
+// -------------------------------------------------------------------------- //
+// Matrix workspace                                           [matrix.workspace]
+//
+// A matrix workspace is a cache of released element arrays that new
+// matrices and the scratch buffers of the solvers draw from. A steady-state
+// loop evaluates the same expressions in every iteration, so it allocates
+// and releases arrays of the same sizes; within a workspace, those arrays
+// are recycled and the loop performs no heap allocations after its first
+// iteration:
+//
+//    matrix_workspace ws;                  // Active until the end of scope
+//    for (int i = 0; i != iters; ++i) {
+//      matrix<double, 2> r = a + b * s;    // Drawn from ws after the first
+//      lu_solve(lu, piv, r);               // iteration
+//    }
+//
+// A workspace is active on the thread that creates it, from its creation
+// until its destruction, and workspaces nest: a workspace created while
+// another is active replaces it until the inner one is destroyed. A
+// workspace must be destroyed by the thread that created it, in the reverse
+// order of creation, which is guaranteed for scoped objects.
+//
+// Only matrices using aligned_allocator, the default, draw from the
+// workspace. Their arrays are aligned memory, so an array may outlive the
+// workspace it came from, or be released on another thread. When an array
+// is released, it is cached by the active workspace of the releasing
+// thread, if any, unless the cache would exceed the workspace's limit. An
+// array is reused only for a request of exactly the same size and
+// alignment. The cached arrays are freed when the workspace is destroyed.
+class matrix_workspace
+{
+public:
+  static constexpr std::size_t default_limit = std::size_t(256) << 20;
+
+  // Create a workspace caching at most limit bytes, and make it the active
+  // workspace of this thread.
+  explicit matrix_workspace(std::size_t limit = default_limit);
+
+  matrix_workspace(const matrix_workspace&) = delete;
+  matrix_workspace& operator=(const matrix_workspace&) = delete;
+
+  // Free the cached arrays, and reactivate the previously active workspace.
+  ~matrix_workspace();
+
+  // Returns the active workspace of this thread, or nullptr if none.
+  static matrix_workspace* current();
+
+  // Returns the number of bytes that the cache may hold.
+  std::size_t limit() const { return limit_; }
+
+  // Returns the number of bytes of the cached arrays.
+  std::size_t cached() const { return cached_; }
+
+  // Returns the number of requests satisfied from the cache, and the number
+  // that allocated memory.
+  std::size_t hits() const { return hits_; }
+  std::size_t misses() const { return misses_; }
+
+  // Returns an array of n bytes aligned on an align-byte boundary, taken
+  // from the cache if possible.
+  void* allocate(std::size_t n, std::size_t align);
+
+  // Release the array p of n bytes aligned on an align-byte boundary, which
+  // was obtained from aligned_allocate, caching it if possible.
+  void deallocate(void* p, std::size_t n, std::size_t align);
+
+  // Free the cached arrays.
+  void release();
+
+private:
+  struct block
+  {
+    void* ptr;
+    std::size_t size;
+    std::size_t align;
+  };
+
+  std::vector<block> blocks_;
+  std::size_t limit_;
+  std::size_t cached_ = 0;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+  matrix_workspace* prev_;
+};
+
+
+namespace matrix_impl
+{
+  // Zero the n bytes pointed to by p, dividing them into contiguous parts
+  // that are written by the product threads. See matrix.cpp.
+  void parallel_zero(void* p, std::size_t n);
+
+  // Copy the n bytes pointed to by src to dst, dividing them into parts
+  // that are copied by the product threads if n is large, and writing them
+  // with non-temporal stores if n is larger still (see [algo.stream]). See
+  // matrix.cpp.
+  void parallel_copy(void* dst, const void* src, std::size_t n);
+
+
+  // Allocate or release n bytes aligned on an align-byte boundary through
+  // the active workspace, or directly if there is none. See matrix.cpp.
+  void* workspace_allocate(std::size_t n, std::size_t align);
+  void workspace_deallocate(void* p, std::size_t n, std::size_t align);
+
+  // Returns true if arrays obtained from the allocator A are recycled by the
+  // active workspace.
+  template <typename A>
+    struct uses_workspace : std::false_type { };
+
+  template <typename T, std::size_t Align>
+    struct uses_workspace<aligned_allocator<T, Align>> : std::true_type { };
+
+
+  // The matrix_storage class owns a dynamically allocated array of n
+  // elements of type T. The allocator is stored as a base class so that
+  // stateless allocators take no space.
+  //
+  // NOTE: Copy and move assignment exchange allocators along with their
+  // arrays. This is correct for allocators that always compare equal, which
+  // includes both std::allocator and aligned_allocator.
+  template <typename T, typename A>
+    class matrix_storage : private A
+    {
+      using traits = std::allocator_traits<A>;
+    public:
+      using allocator_type = A;
+
+      explicit matrix_storage(const A& a = A());
+
+      // Allocate and value initialize n elements.
+      matrix_storage(std::size_t n, const A& a = A());
+
+      // Allocate and default initialize n elements.
+      matrix_storage(std::size_t n, uninitialized_t, const A& a = A());
+
+      // Allocate n elements and zero them in parallel.
+      matrix_storage(std::size_t n, first_touch_t, const A& a = A());
+
+      // Allocate n elements and copy them from p.
+      matrix_storage(std::size_t n, copy_elements_t, const T* p,
+                     const A& a = A());
+
+      // Take ownership of the n elements of p.
+      matrix_storage(std::size_t n, adopt_elements_t, T* p, const A& a = A());
+
+      // Move semantics
+      matrix_storage(matrix_storage&& x);
+      matrix_storage& operator=(matrix_storage&& x);
+
+      // Copy semantics
+      matrix_storage(const matrix_storage& x);
+      matrix_storage& operator=(const matrix_storage& x);
+
+      // Destruction
+      ~matrix_storage();
+
+      // Returns a copy of the allocator.
+      A get_allocator() const { return *this; }
+
+      T*       data()       { return first; }
+      const T* data() const { return first; }
+
+      std::size_t size() const { return count; }
+
+      void swap(matrix_storage& x);
+
+    private:
+      A& alloc() { return *this; }
+
+      T* allocate(std::size_t n);
+      T* allocate(std::size_t n, std::true_type);
+      T* allocate(std::size_t n, std::false_type);
+      void deallocate(T* p, std::size_t n);
+      void deallocate(T* p, std::size_t n, std::true_type);
+      void deallocate(T* p, std::size_t n, std::false_type);
+      void destroy();
+
+      template <typename F>
+        void construct(std::size_t n, F init);
+
+      void copy_construct(const T* p, std::size_t n, std::true_type);
+      void copy_construct(const T* p, std::size_t n, std::false_type);
+
+    private:
+      T* first;
+      std::size_t count;
+    };
+
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(const A& a)
+      : A(a), first(nullptr), count(0)
+    { }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(std::size_t n, const A& a)
+      : A(a), first(nullptr), count(0)
+    {
+      construct(n, [this](T* p) { traits::construct(alloc(), p); });
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(std::size_t n,
+                                         uninitialized_t,
+                                         const A& a)
+      : A(a), first(nullptr), count(0)
+    {
+      construct(n, [](T* p) { ::new (static_cast<void*>(p)) T; });
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(std::size_t n,
+                                         first_touch_t,
+                                         const A& a)
+      : A(a), first(allocate(n)), count(n)
+    {
+      static_assert(std::is_arithmetic<T>::value,
+                    "first touch initialization requires an arithmetic type");
+      if (n)
+        parallel_zero(first, n * sizeof(T));
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(std::size_t n,
+                                         copy_elements_t,
+                                         const T* p,
+                                         const A& a)
+      : A(a), first(nullptr), count(0)
+    {
+      copy_construct(p, n, std::is_trivially_copyable<T>{});
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(std::size_t n,
+                                         adopt_elements_t,
+                                         T* p,
+                                         const A& a)
+      : A(a), first(p), count(n)
+    {
+      assert(p || n == 0);
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(matrix_storage&& x)
+      : A(std::move(x.alloc())), first(x.first), count(x.count)
+    {
+      x.first = nullptr;
+      x.count = 0;
+    }
+
+  template <typename T, typename A>
+    inline matrix_storage<T, A>&
+    matrix_storage<T, A>::operator=(matrix_storage&& x)
+    {
+      swap(x);
+      return *this;
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::matrix_storage(const matrix_storage& x)
+      : A(traits::select_on_container_copy_construction(x.get_allocator())),
+        first(nullptr), count(0)
+    {
+      copy_construct(x.first, x.count, std::is_trivially_copyable<T>{});
+    }
+
+  template <typename T, typename A>
+    inline matrix_storage<T, A>&
+    matrix_storage<T, A>::operator=(const matrix_storage& x)
+    {
+      if (count == x.count) {
+        std::copy(x.first, x.first + count, first);
+      } else {
+        matrix_storage tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+  template <typename T, typename A>
+    inline
+    matrix_storage<T, A>::~matrix_storage()
+    {
+      destroy();
+    }
+
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::copy_construct(const T* p, std::size_t n,
+                                         std::true_type)
+    {
+      first = allocate(n);
+      count = n;
+      if (n)
+        parallel_copy(first, p, n * sizeof(T));
+    }
+
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::copy_construct(const T* p, std::size_t n,
+                                         std::false_type)
+    {
+      construct(n, [this, &p](T* q) { traits::construct(alloc(), q, *p++); });
+    }
+
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::swap(matrix_storage& x)
+    {
+      using std::swap;
+      swap(alloc(), x.alloc());
+      swap(first, x.first);
+      swap(count, x.count);
+    }
+
+  template <typename T, typename A>
+    inline T*
+    matrix_storage<T, A>::allocate(std::size_t n)
+    {
+      return n ? allocate(n, uses_workspace<A>{}) : nullptr;
+    }
+
+  template <typename T, typename A>
+    inline T*
+    matrix_storage<T, A>::allocate(std::size_t n, std::true_type)
+    {
+      constexpr std::size_t align = A::alignment < sizeof(void*) 
+                                  ? sizeof(void*) : A::alignment;
+      return static_cast<T*>(workspace_allocate(n * sizeof(T), align));
+    }
+
+  template <typename T, typename A>
+    inline T*
+    matrix_storage<T, A>::allocate(std::size_t n, std::false_type)
+    {
+      return traits::allocate(alloc(), n);
+    }
+
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::deallocate(T* p, std::size_t n)
+    {
+      deallocate(p, n, uses_workspace<A>{});
+    }
+
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::deallocate(T* p, std::size_t n, std::true_type)
+    {
+      constexpr std::size_t align = A::alignment < sizeof(void*) 
+                                  ? sizeof(void*) : A::alignment;
+      workspace_deallocate(p, n * sizeof(T), align);
+    }
+
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::deallocate(T* p, std::size_t n, std::false_type)
+    {
+      traits::deallocate(alloc(), p, n);
+    }
+
+  // Destroy the elements and release the array.
+  template <typename T, typename A>
+    inline void
+    matrix_storage<T, A>::destroy()
+    {
+      if (!first)
+        return;
+      for (std::size_t i = 0; i != count; ++i)
+        traits::destroy(alloc(), first + i);
+      deallocate(first, count);
+      first = nullptr;
+      count = 0;
+    }
+
+  // Allocate n elements and initialize each by calling init(p). If an
+  // initialization throws, the previously constructed elements are destroyed
+  // and the array is released before the exception is propagated.
+  template <typename T, typename A>
+    template <typename F>
+      inline void
+      matrix_storage<T, A>::construct(std::size_t n, F init)
+      {
+        first = allocate(n);
+        try {
+          for ( ; count != n; ++count)
+            init(first + count);
+        } catch (...) {
+          while (count != 0)
+            traits::destroy(alloc(), first + --count);
+          deallocate(first, n);
+          first = nullptr;
+          throw;
+        }
+      }
+
+
+
+  // A scratch buffer is an array of n value-initialized elements used as
+  // the workspace of a solver or kernel. It is drawn from the active
+  // workspace, if any.
+  template <typename T>
+    class scratch_buffer
+    {
+    public:
+      explicit scratch_buffer(std::size_t n) : elems(n) { }
+
+      T& operator[](std::size_t i) { return elems.data()[i]; }
+      const T& operator[](std::size_t i) const { return elems.data()[i]; }
+
+      T*       data()       { return elems.data(); }
+      const T* data() const { return elems.data(); }
+
+      std::size_t size() const { return elems.size(); }
+
+    private:
+      matrix_storage<T, aligned_allocator<T>> elems;
+    };
+
+} // namespace matrix_impl
@@ -15,45 +15,46 @@ namespace matrix_impl
 {
 
   // ------------------------------------------------------------------------ //
-  //                          Insert Flattened
+  //                          Copy Flattened
   //
-  // Insert the elements of a initializer list nesting into a vector such that
-  // each subsequent set of "leaf" values are copied into a contiguous memory.
+  // Copy the elements of a initializer list nesting into contiguous memory
+  // such that each subsequent set of "leaf" values are copied into adjacent
+  // elements. The output must have room for all of the leaf values.
 
   // TODO: This algorithm could be generalized to flatten an arbitrary
   // initializer list structure.
 
-  // For iterators over the leaf nodes, insert elements into the back of the
-  // vector. We generally assume that the vector has sufficient capacity for
-  // all such insertions, but insert guarantees that it will resize if needed.
-  template <typename T, typename Vec>
-    inline void 
-    insert_flattened(const T* first, const T* last, Vec& vec)
+  // For iterators over the leaf nodes, copy the elements into the output
+  // and return an iterator past the last element written.
+  template <typename T, typename Out>
+    inline Out
+    copy_flattened(const T* first, const T* last, Out out)
     {
-      vec.insert(vec.end(), first, last);
+      return std::copy(first, last, out);
     }
 
-  // For iterators into nested initializer lists, recursively intiailize each
-  // sub-initializeer.
-  template <typename T, typename Vec>
-    inline void 
-    insert_flattened(const std::initializer_list<T>* first,
-                    const std::initializer_list<T>* last,
-                    Vec& vec)
+  // For iterators into nested initializer lists, recursively copy each
+  // sub-initializer.
+  template <typename T, typename Out>
+    inline Out
+    copy_flattened(const std::initializer_list<T>* first,
+                   const std::initializer_list<T>* last,
+                   Out out)
     {
       while (first != last) {
-        insert_flattened(first->begin(), first->end(), vec);
+        out = copy_flattened(first->begin(), first->end(), out);
         ++first;
       }
+      return out;
     }
 
   // Copy the elements from the initializer list nesting into contiguous
-  // elements in the vector.
-  template <typename T, typename Vec>
-    inline void 
-    insert_flattened(const std::initializer_list<T>& list, Vec& vec)
+  // elements starting at out.
+  template <typename T, typename Out>
+    inline Out
+    copy_flattened(const std::initializer_list<T>& list, Out out)
     {
-      insert_flattened(list.begin(), list.end(), vec);
+      return copy_flattened(list.begin(), list.end(), out);
     }
 
 
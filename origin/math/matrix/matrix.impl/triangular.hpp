@@ -0,0 +1,187 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Triangular solves                                               [matrix.trsm]
+//
+// The trsm and trsv operations solve T * X = B for X, where T is the lower
+// or upper triangle of a square matrix a, and B is a matrix (trsm) or a
+// vector (trsv) that is overwritten by the solution. The other triangle of
+// a is not read. If the diagonal is unit, the diagonal of a is not read
+// either, and is taken to be 1. For example:
+//
+//    trsm(l, triangle::lower, b);                  // b = inv(L) * b
+//    trsv(lu, triangle::lower, x, diagonal::unit); // x = inv(L) * x
+//
+// To solve with the transpose of a triangle, pass the transpose of a (see
+// [matrix.transpose]), which is a view, not a copy.
+//
+// The solves are blocked: the rows of B are divided into blocks of the
+// size of the panels of the factorizations, each block is solved against
+// the diagonal block of T, and the rows that remain are updated by a matrix
+// product, which is computed by the blocked (and possibly parallel) product
+// kernel when the rows of B are contiguous.
+
+enum class triangle { lower, upper };
+enum class diagonal { non_unit, unit };
+
+namespace matrix_impl
+{
+  // Compute C -= A * B, where A is m x k, B is k x n, and C is m x n, and
+  // each operand has a row and column stride. When the rows of C are
+  // contiguous, A is copied (negated) and, unless its rows are contiguous,
+  // B is copied, so that the product can be computed by the blocked kernel.
+  template <typename T>
+    void
+    gemm_minus(std::size_t m, std::size_t n, std::size_t k,
+               const T* a, std::size_t ars, std::size_t acs,
+               const T* b, std::size_t brs, std::size_t bcs,
+               T* c, std::size_t crs, std::size_t ccs)
+    {
+      if (m == 0 || n == 0 || k == 0)
+        return;
+
+      if (n == 1) {
+        for (std::size_t i = 0; i != m; ++i)
+          c[i * crs] -= dot_n(a + i * ars, acs, b, brs, k);
+      } else if (ccs == 1) {
+        scratch_buffer<T> neg(m * k);
+        for (std::size_t i = 0; i != m; ++i)
+          for (std::size_t p = 0; p != k; ++p)
+            neg[i * k + p] = -a[i * ars + p * acs];
+        if (bcs == 1) {
+          dispatch_gemm(m, n, k, neg.data(), k, b, brs, c, crs);
+        } else {
+          scratch_buffer<T> copy(k * n);
+          for (std::size_t p = 0; p != k; ++p)
+            for (std::size_t j = 0; j != n; ++j)
+              copy[p * n + j] = b[p * brs + j * bcs];
+          dispatch_gemm(m, n, k, neg.data(), k, copy.data(), n, c, crs);
+        }
+      } else {
+        for (std::size_t i = 0; i != m; ++i)
+          for (std::size_t p = 0; p != k; ++p) {
+            const T x = a[i * ars + p * acs];
+            for (std::size_t j = 0; j != n; ++j)
+              c[i * crs + j * ccs] -= x * b[p * brs + j * bcs];
+          }
+      }
+    }
+
+  // Solve the rows [j, j + jb) of T * X = B against the diagonal block of
+  // the lower triangle of a, where B has m columns.
+  template <typename T>
+    void
+    trsm_lower_block(std::size_t j, std::size_t jb, bool unit,
+                     const T* a, std::size_t ars, std::size_t acs,
+                     std::size_t m, T* b, std::size_t brs, std::size_t bcs)
+    {
+      for (std::size_t i = j; i != j + jb; ++i) {
+        T* x = b + i * brs;
+        for (std::size_t k = j; k != i; ++k)
+          lu_axpy(m, a[i * ars + k * acs], b + k * brs, x, bcs);
+        if (!unit) {
+          const T d = a[i * ars + i * acs];
+          for (std::size_t c = 0; c != m; ++c)
+            x[c * bcs] /= d;
+        }
+      }
+    }
+
+  // Solve the rows [j, j + jb) of T * X = B against the diagonal block of
+  // the upper triangle of a, where B has m columns.
+  template <typename T>
+    void
+    trsm_upper_block(std::size_t j, std::size_t jb, bool unit,
+                     const T* a, std::size_t ars, std::size_t acs,
+                     std::size_t m, T* b, std::size_t brs, std::size_t bcs)
+    {
+      for (std::size_t i = j + jb; i-- != j; ) {
+        T* x = b + i * brs;
+        for (std::size_t k = i + 1; k != j + jb; ++k)
+          lu_axpy(m, a[i * ars + k * acs], b + k * brs, x, bcs);
+        if (!unit) {
+          const T d = a[i * ars + i * acs];
+          for (std::size_t c = 0; c != m; ++c)
+            x[c * bcs] /= d;
+        }
+      }
+    }
+
+  // Solve T * X = B for the n x m matrix B, where T is the lower or upper
+  // triangle of the n x n matrix a.
+  template <typename T>
+    void
+    trsm(triangle t, bool unit, std::size_t n,
+         const T* a, std::size_t ars, std::size_t acs,
+         std::size_t m, T* b, std::size_t brs, std::size_t bcs)
+    {
+      if (t == triangle::lower) {
+        for (std::size_t j = 0; j < n; j += lu_block) {
+          std::size_t jb = std::min(lu_block, n - j);
+          std::size_t j2 = j + jb;
+          trsm_lower_block(j, jb, unit, a, ars, acs, m, b, brs, bcs);
+
+          // B2 -= L21 * X1
+          gemm_minus(n - j2, m, jb, a + j2 * ars + j * acs, ars, acs,
+                     b + j * brs, brs, bcs, b + j2 * brs, brs, bcs);
+        }
+      } else {
+        for (std::size_t j2 = n; j2 != 0; ) {
+          std::size_t jb = std::min(lu_block, j2);
+          std::size_t j = j2 - jb;
+          trsm_upper_block(j, jb, unit, a, ars, acs, m, b, brs, bcs);
+
+          // B0 -= U01 * X1
+          gemm_minus(j, m, jb, a + j * acs, ars, acs,
+                     b + j * brs, brs, bcs, b, brs, bcs);
+          j2 = j;
+        }
+      }
+    }
+
+} // namespace matrix_impl
+
+
+// Solve T * X = B for X, where T is the triangle t of the square matrix a,
+// and b, with as many rows as a, is overwritten by X. Note that b may be a
+// matrix_ref, which is passed by value.
+template <typename M1, typename M2>
+  void
+  trsm(const M1& a, triangle t, M2&& b, diagonal d = diagonal::non_unit)
+  {
+    using M = Remove_reference<M2>;
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(M::order == 1 || M::order == 2, "");
+    static_assert(std::is_floating_point<Value_type<M>>::value, "");
+    assert(a.rows() == a.cols());
+    assert(a.rows() == b.extent(0));
+    ORIGIN_TIME_SCOPE("matrix.trsm");
+
+    const matrix_slice<2>& s = a.descriptor();
+    const matrix_slice<M::order>& e = b.descriptor();
+    matrix_impl::trsm(t, d == diagonal::unit, a.rows(),
+                      a.data() + s.start, s.strides[0], s.strides[1],
+                      matrix_impl::rhs_cols(e), b.data() + e.start,
+                      e.strides[0], matrix_impl::rhs_stride(e));
+  }
+
+// Solve T * x = b for x, where T is the triangle t of the square matrix a,
+// and the vector b is overwritten by x.
+template <typename M1, typename M2>
+  inline void
+  trsv(const M1& a, triangle t, M2&& b, diagonal d = diagonal::non_unit)
+  {
+    static_assert(Remove_reference<M2>::order == 1, "");
+    trsm(a, t, b, d);
+  }
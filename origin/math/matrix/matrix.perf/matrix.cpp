@@ -0,0 +1,142 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+// The matrix benchmarks measure the operations of n x n matrices of
+// doubles, and report their rates as fractions of the peak rates of the
+// machine. Each benchmark is named operation/n. The work of each operation
+// is its nominal count of floating point operations and the bytes it must
+// read and write at least once:
+//
+//    product      matrix_product(a, b, c)        2n^3 flops, 24n^2 bytes
+//    hadamard     hadamard_product(a, b, c)      n^2 flops, 24n^2 bytes
+//    add, sub     c = a + b, c = a - b           n^2 flops, 24n^2 bytes
+//    scalar_add   c = a + x                      n^2 flops, 16n^2 bytes
+//    scalar_mul   c = a * x                      n^2 flops, 16n^2 bytes
+//    rows, cols   Sum a row by row, column by    n^2 flops, 8n^2 bytes
+//                 column, through matrix_refs
+//    slice        Sum the n/2 x n/2 slice at the center of a
+//    gauss        Solve ax = y by Gaussian       2n^3/3 flops, 8n^2 bytes
+//                 elimination (matrix.test/solver.hpp)
+//
+// The peak bandwidth is that of memory, so operations on matrices that fit
+// in the caches may exceed 100% of it. The product is computed by one
+// thread, since the peak rates are those of one thread.
+//
+// The sizes default to 8, 64, 512 and 1024; sizes up to 8192 are given as
+// --sizes=2048,4096,8192, but note that a product of 8192 x 8192 matrices
+// is a teraflop of work, and its operands take 1.5 GB.
+
+#include <memory>
+#include <string>
+
+#include <origin/benchmark/benchmark.hpp>
+#include <origin/math/matrix/matrix.hpp>
+
+#include "../matrix.test/solver.hpp"
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+// Fill the matrix with small values. A diagonal larger than the sum of each
+// row makes the matrix diagonally dominant, so that elimination is stable.
+void
+fill(Mat& m, int seed)
+{
+  int k = seed;
+  for (auto& x : m) {
+    x = (k % 7 - 3) / 8.0;
+    k = (k * 31 + 11) % 1009;
+  }
+  for (size_t i = 0; i != m.rows(); ++i)
+    m(i, i) = m.rows();
+}
+
+// Sum the elements of the range r.
+template <typename R>
+  double
+  sum(const R& r)
+  {
+    double s = 0;
+    for (double x : r)
+      s += x;
+    return s;
+  }
+
+void
+add_matrix_benchmarks(benchmark_suite& s, size_t n)
+{
+  auto a = make_shared<Mat>(n, n);
+  auto b = make_shared<Mat>(n, n);
+  auto c = make_shared<Mat>(n, n);
+  fill(*a, 1);
+  fill(*b, 2);
+
+  const double m = double(n) * n;
+  const double w = sizeof(double) * m;
+  string size = "/" + to_string(n);
+
+  s.add("product" + size, [a, b, c]() {
+    matrix_product(*a, *b, *c);
+    clobber_memory();
+  }, {2 * m * n, 3 * w});
+  s.add("hadamard" + size, [a, b, c]() {
+    hadamard_product(*a, *b, *c);
+    clobber_memory();
+  }, {m, 3 * w});
+  s.add("add" + size, [a, b, c]() {
+    *c = *a + *b;
+    clobber_memory();
+  }, {m, 3 * w});
+  s.add("sub" + size, [a, b, c]() {
+    *c = *a - *b;
+    clobber_memory();
+  }, {m, 3 * w});
+  s.add("scalar_add" + size, [a, c]() {
+    *c = *a + 2.0;
+    clobber_memory();
+  }, {m, 2 * w});
+  s.add("scalar_mul" + size, [a, c]() {
+    *c = *a * 2.0;
+    clobber_memory();
+  }, {m, 2 * w});
+
+  s.add("rows" + size, [a]() {
+    double x = 0;
+    for (size_t i = 0; i != a->rows(); ++i)
+      x += sum(a->row(i));
+    do_not_optimize(x);
+  }, {m, w});
+  s.add("cols" + size, [a]() {
+    double x = 0;
+    for (size_t j = 0; j != a->cols(); ++j)
+      x += sum(a->col(j));
+    do_not_optimize(x);
+  }, {m, w});
+  s.add("slice" + size, [a, n]() {
+    const Mat& r = *a;
+    do_not_optimize(sum(r(slice(n / 4, n / 2), slice(n / 4, n / 2))));
+  }, {m / 4, w / 4});
+
+  // The elimination takes its operands by value, so a copy of the matrix is
+  // included in the time.
+  auto y = make_shared<Vec>(n);
+  for (size_t i = 0; i != n; ++i)
+    (*y)(i) = i % 5;
+  s.add("gauss" + size, [a, y]() {
+    do_not_optimize(solver::classical_guassian_elimination(*a, *y));
+  }, {2 * m * n / 3, w});
+}
+
+int main(int argc, char** argv)
+{
+  set_product_threads(1);
+  return benchmark_main(argc, argv, {8, 64, 512, 1024},
+                        add_matrix_benchmarks);
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/memory/testing.hpp>
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// The elements of a matrix are allocated by aligned_allocate, which does not
+// use operator new, so they are counted by giving the matrix a counting
+// allocator over its default allocator.
+using Alloc = counting_allocator<double, aligned_allocator<double>>;
+using M = matrix<double, 2, Alloc>;
+
+// Element-wise expressions are evaluated without temporaries: a new matrix
+// allocates only its elements, and assignment to a matrix of the same
+// shape does not allocate.
+int main()
+{
+  context cxt;
+
+  M a(100, 100);
+  M b(100, 100);
+  M c(100, 100);
+
+  check_allocations(1, [&]() {
+    M d = a + b * 2.0;
+    assert(d.rows() == 100 && d(0, 0) == 0);
+  });
+  check_allocations(1, [&]() {
+    M d = (a - b) * 3.0 + c / 2.0;
+    assert(d.size() == 10000 && d(99, 99) == 0);
+  });
+  check_allocations(0, [&]() { c = a + b; });
+  check_allocations(0, [&]() { c += a * 2.0; });
+  check_allocations(1, [&]() { c = M(10, 10); });
+
+  // An expiring operand holds the result of an element-wise operation.
+  check_allocations(1, [&]() {
+    M d = M(100, 100) + b * 2.0;
+    M e = a - std::move(d);
+    M f = std::move(e) * 2.0 / 4.0 - 1.0;
+    assert(f.size() == 10000 && f(0, 0) == -1);
+  });
+
+  assert(cxt.failures() == 0);
+}
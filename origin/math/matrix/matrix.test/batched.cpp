@@ -0,0 +1,137 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+
+default_random_engine eng;
+uniform_real_distribution<> dist(-1, 1);
+
+// Fill each matrix of the batch with random elements.
+template <typename T>
+  void randomize(batched_matrix<T>& b)
+  {
+    for (size_t k = 0; k < b.size(); ++k)
+      for (size_t i = 0; i < b.rows(); ++i)
+        for (size_t j = 0; j < b.cols(); ++j)
+          b(k, i, j) = dist(eng);
+  }
+
+// Returns the largest absolute difference between elements of a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    auto i = b.begin();
+    for (double x : a)
+      e = max(e, double(abs(x - *i++)));
+    return e;
+  }
+
+// Check the batched product of count m x k and k x n matrices against the
+// product of each pair.
+template <typename T>
+  void check_gemm(size_t count, size_t m, size_t n, size_t k, double eps)
+  {
+    batched_matrix<T> a(count, m, k), b(count, k, n), c(count, m, n);
+    randomize(a);
+    randomize(b);
+    randomize(c);
+    batched_matrix<T> c0 = c;
+    batched_gemm(a, b, c);
+    for (size_t q = 0; q < count; ++q) {
+      matrix<T, 2> r = a.get(q) * b.get(q);
+      r += c0.get(q);
+      assert(max_error(r, c.get(q)) < eps);
+    }
+  }
+
+// Factor count random n x n matrices, and check that the solutions of
+// A * X = B, for m right-hand sides, reproduce X.
+void check_solve(size_t count, size_t n, size_t m)
+{
+  batched_matrix<double> a(count, n, n), x(count, n, m), b(count, n, m);
+  randomize(a);
+  randomize(x);
+  batched_gemm(a, x, b);
+
+  batched_matrix<double> lu = a;
+  vector<size_t> piv;
+  assert(batched_lu_factor(lu, piv));
+  assert(piv.size() == count * n);
+
+  // The factors are those of lu_factor.
+  for (size_t k = 0; k < count; k += 5) {
+    Mat f = a.get(k);
+    vector<size_t> p;
+    lu_factor(f, p);
+    assert(max_error(f, lu.get(k)) < 1e-12);
+    assert(equal(p.begin(), p.end(), piv.begin() + k * n));
+  }
+
+  batched_lu_solve(lu, piv, b);
+  for (size_t k = 0; k < count; ++k)
+    assert(max_error(x.get(k), b.get(k)) < 1e-8);
+}
+
+int main()
+{
+  // Batches smaller than, equal to, and larger than a group.
+  check_gemm<double>(1, 4, 4, 4, 1e-12);
+  check_gemm<double>(8, 3, 5, 7, 1e-12);
+  check_gemm<double>(13, 16, 16, 16, 1e-12);
+  check_gemm<float>(20, 6, 4, 5, 1e-5);
+  check_gemm<long double>(9, 3, 3, 3, 1e-12);
+
+  check_solve(1, 4, 1);
+  check_solve(13, 7, 3);
+  check_solve(30, 32, 2);
+
+  // A large batch is processed in parallel.
+  check_solve(5000, 4, 1);
+
+  // The elements of a batch are stored in groups.
+  {
+    batched_matrix<double> a(10, 2, 3);
+    assert(a.size() == 10);
+    assert(a.groups() == 2);
+    a(9, 1, 2) = 5;
+    assert(a.group(1)[(1 * 3 + 2) * a.lanes + 1] == 5);
+    Mat m {{1, 2, 3}, {4, 5, 6}};
+    a.assign(3, m);
+    assert(a.get(3) == m);
+    assert(a.memory_usage().live == 10 * 6 * sizeof(double));
+    assert(a.memory_usage().reserved == 16 * 6 * sizeof(double));
+  }
+
+  // Singular matrices are detected, and do not affect the others.
+  {
+    batched_matrix<double> a(3, 2, 2);
+    Mat s {{1, 2}, {2, 4}};
+    Mat r {{2, 1}, {1, 3}};
+    a.assign(0, r);
+    a.assign(1, s);
+    a.assign(2, r);
+    vector<size_t> piv;
+    assert(!batched_lu_factor(a, piv));
+
+    batched_matrix<double> b(3, 2, 1);
+    b(2, 0, 0) = 3;
+    b(2, 1, 0) = 4;
+    batched_lu_solve(a, piv, b);
+    assert(abs(b(2, 0, 0) - 1) < 1e-12 && abs(b(2, 1, 0) - 1) < 1e-12);
+  }
+}
@@ -0,0 +1,166 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+bool
+close(double a, double b)
+{
+  return abs(a - b) <= 1e-9 * (1 + abs(a) + abs(b));
+}
+
+void
+check_level1()
+{
+  // Sizes that exercise the vector loops and the scalar tails.
+  for (size_t n : {0, 1, 3, 8, 17, 100}) {
+    matrix<double, 1> x(n);
+    matrix<double, 1> y(n);
+    double d = 0, s = 0, q = 0;
+    for (size_t i = 0; i != n; ++i) {
+      x(i) = (i % 2 ? -1.0 : 1.0) * i;
+      y(i) = i + 0.5;
+      d += x(i) * y(i);
+      s += abs(x(i));
+      q += x(i) * x(i);
+    }
+    assert(close(dot(x, y), d));
+    assert(close(asum(x), s));
+    assert(close(nrm2(x), sqrt(q)));
+    assert(iamax(x) == (n ? n - 1 : 0));
+
+    axpy(2.0, x, y);
+    for (size_t i = 0; i != n; ++i)
+      assert(y(i) == i + 0.5 + 2 * x(i));
+  }
+
+  // The rows and columns of a matrix are vectors.
+  matrix<float, 2> m {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+  assert(dot(m.row(0), m.row(1)) == 32);
+  assert(dot(m.col(0), m.col(2)) == 90);
+  assert(dot(m.row(2), m.col(1)) == 126);
+  assert(asum(m.col(1)) == 15 && iamax(m.row(1)) == 2);
+  axpy(1.0f, m.row(0), m.col(0));
+  assert(m(0, 0) == 2 && m(1, 0) == 6 && m(2, 0) == 10);
+
+  // Integers use the scalar kernels.
+  matrix<int, 1> a {1, -5, 3};
+  matrix<int, 1> b {2, 2, 2};
+  assert(dot(a, b) == -2 && asum(a) == 9 && iamax(a) == 1);
+
+  // The norm does not overflow or underflow.
+  matrix<double, 1> big {1e200, 1e200};
+  assert(close(nrm2(big), sqrt(2.0) * 1e200));
+  matrix<double, 1> tiny {3e-200, 4e-200};
+  assert(close(nrm2(tiny) * 1e200, 5.0));
+}
+
+void
+check_gemv(size_t m, size_t n)
+{
+  matrix<double, 2> a(m, n);
+  matrix<double, 1> x(n);
+  for (size_t i = 0; i != m; ++i)
+    for (size_t j = 0; j != n; ++j)
+      a(i, j) = double((i * 7 + j * 3) % 11) - 5;
+  for (size_t j = 0; j != n; ++j)
+    x(j) = double(j % 5) - 2;
+
+  matrix<double, 1> y(m);
+  gemv(a, x, y);
+  for (size_t i = 0; i != m; ++i) {
+    double s = 0;
+    for (size_t j = 0; j != n; ++j)
+      s += a(i, j) * x(j);
+    assert(y(i) == s);
+  }
+
+  // The transpose has contiguous columns.
+  matrix<double, 2> t(n, m);
+  transpose_into(a, t);
+  matrix<double, 1> z(m);
+  gemv(transpose(t), x, z);
+  assert(z == y);
+
+  // gemv accumulates.
+  gemv(a, x, z);
+  assert(z == y * 2.0);
+}
+
+// Solve a x = b for a symmetric positive definite a by conjugate gradient.
+matrix<double, 1>
+conjugate_gradient(const matrix<double, 2>& a, const matrix<double, 1>& b)
+{
+  size_t n = b.size();
+  matrix<double, 1> x(n);
+  matrix<double, 1> r = b;
+  matrix<double, 1> p = b;
+  matrix<double, 1> q(n);
+  double rr = dot(r, r);
+  for (size_t k = 0; k != n && sqrt(rr) > 1e-12; ++k) {
+    q = 0.0;
+    gemv(a, p, q);
+    double alpha = rr / dot(p, q);
+    axpy(alpha, p, x);
+    axpy(-alpha, q, r);
+    double next = dot(r, r);
+    p = r + p * (next / rr);
+    rr = next;
+  }
+  return x;
+}
+
+void
+check_solvers()
+{
+  // A tridiagonal system.
+  size_t n = 50;
+  matrix<double, 2> a(n, n);
+  for (size_t i = 0; i != n; ++i) {
+    a(i, i) = 4;
+    if (i)
+      a(i, i - 1) = a(i - 1, i) = -1;
+  }
+  matrix<double, 1> b(n);
+  for (size_t i = 0; i != n; ++i)
+    b(i) = i + 1.0;
+  matrix<double, 1> x = conjugate_gradient(a, b);
+  matrix<double, 1> y(n);
+  gemv(a, x, y);
+  axpy(-1.0, b, y);
+  assert(nrm2(y) < 1e-9);
+
+  // The dominant eigenvalue of [[2, 1], [1, 2]] is 3, by power iteration.
+  matrix<double, 2> c {{2, 1}, {1, 2}};
+  matrix<double, 1> v {1.0, 0.0};
+  matrix<double, 1> w(2);
+  double lambda = 0;
+  for (int k = 0; k != 100; ++k) {
+    w = 0.0;
+    gemv(c, v, w);
+    lambda = dot(v, w);
+    v = w / nrm2(w);
+  }
+  assert(close(lambda, 3));
+}
+
+int main()
+{
+  check_level1();
+  check_gemv(3, 5);
+  check_gemv(37, 21);
+  check_gemv(700, 600);  // In parallel
+  check_solvers();
+}
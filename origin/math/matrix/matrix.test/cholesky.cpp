@@ -0,0 +1,122 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+default_random_engine eng;
+uniform_real_distribution<> dist(-1, 1);
+
+template <typename M>
+  void randomize(M& m)
+  {
+    for (auto& x : m)
+      x = dist(eng);
+  }
+
+// Returns the largest absolute difference between elements of a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    auto i = b.begin();
+    for (double x : a)
+      e = max(e, abs(x - *i++));
+    return e;
+  }
+
+// Returns a random n x n symmetric positive definite matrix.
+Mat spd(size_t n)
+{
+  Mat g(n, n);
+  randomize(g);
+  Mat gt(n, n);
+  transpose_into(g, gt);
+  Mat a = g * gt;
+  for (size_t i = 0; i < n; ++i)
+    a(i, i) += n;
+  return a;
+}
+
+// Factor a random n x n matrix, check that L * L^T reproduces it, and that
+// the solution of A * X = B reproduces X.
+void check_factor(size_t n)
+{
+  Mat a = spd(n);
+
+  // The upper triangle is not read.
+  Mat l = a;
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = i + 1; j < n; ++j)
+      l(i, j) = 1e6;
+  bool ok = cholesky_factor(l);
+  assert(ok);
+  for (size_t i = 0; i < n; ++i) {
+    assert(l(i, i) > 0);
+    for (size_t j = i + 1; j < n; ++j)
+      assert(l(i, j) == 0);
+  }
+  Mat lt(n, n);
+  transpose_into(l, lt);
+  assert(max_error(l * lt, a) < 1e-8 * n);
+
+  Mat x(n, 3);
+  randomize(x);
+  Mat b = a * x;
+  cholesky_solve(l, b);
+  assert(max_error(x, b) < 1e-8);
+}
+
+int main()
+{
+  // Sizes smaller than, equal to, and spanning several panels and row
+  // blocks of the update.
+  check_factor(1);
+  check_factor(5);
+  check_factor(64);
+  check_factor(150);
+  check_factor(600);
+
+  // Factor a sub-matrix in place, and solve for a vector.
+  {
+    size_t n = 100;
+    Mat a = spd(n);
+    Mat m(n + 10, n + 20);
+    auto r = m(slice(5, n), slice(10, n));
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        r(i, j) = a(i, j);
+    assert(cholesky_factor(r));
+
+    Vec x(n);
+    randomize(x);
+    Vec b(n);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        b(i) += a(i, j) * x(j);
+    cholesky_solve(r, b);
+    assert(max_error(x, b) < 1e-8);
+  }
+
+  // Matrices that are not positive definite are detected.
+  {
+    Mat a {{1, 2}, {2, 1}};
+    assert(!cholesky_factor(a));
+    Mat z {{0, 0}, {0, 1}};
+    assert(!cholesky_factor(z));
+  }
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <stdexcept>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Fill m with small integers, so that the sums are exact.
+template <typename M>
+  void
+  fill(M& m, int seed)
+  {
+    int k = seed;
+    for (double& x : m) {
+      x = double(k % 7) - 3;
+      k = k * 5 + 3;
+    }
+  }
+
+void
+check_product()
+{
+  matrix<double, 2> a(37, 21), b(21, 45);
+  fill(a, 1);
+  fill(b, 2);
+
+  matrix<double, 2> c = contract<2>("ij,jk->ik", a, b);
+  matrix<double, 2> t = contract<2>("ij,jk->ki", a, b);
+  assert(c.extent(0) == 37 && c.extent(1) == 45);
+  for (size_t i = 0; i != 37; ++i)
+    for (size_t k = 0; k != 45; ++k) {
+      double s = 0;
+      for (size_t j = 0; j != 21; ++j)
+        s += a(i, j) * b(j, k);
+      assert(c(i, k) == s && t(k, i) == s);
+    }
+
+  // A transposed operand is copied.
+  matrix<double, 2> bt = contract<2>("ij->ji", b);
+  assert(contract<2>("ij,kj->ik", a, bt) == c);
+
+  // Implicit mode keeps the labels that occur once.
+  assert(contract<2>("ij,jk", a, b) == c);
+
+  // Views of the operands.
+  auto av = a(slice(1, 10), slice(0, 21));
+  auto bv = b(slice(0, 21), slice(3, 20));
+  matrix<double, 2> v = contract<2>("ij,jk->ik", av, bv);
+  for (size_t i = 0; i != 10; ++i)
+    for (size_t k = 0; k != 20; ++k)
+      assert(v(i, k) == c(i + 1, k + 3));
+}
+
+void
+check_batched()
+{
+  matrix<double, 3> a(4, 9, 7), b(4, 7, 5);
+  fill(a, 3);
+  fill(b, 4);
+
+  matrix<double, 3> c = contract<3>("bij,bjk->bik", a, b);
+  for (size_t n = 0; n != 4; ++n)
+    for (size_t i = 0; i != 9; ++i)
+      for (size_t k = 0; k != 5; ++k) {
+        double s = 0;
+        for (size_t j = 0; j != 7; ++j)
+          s += a(n, i, j) * b(n, j, k);
+        assert(c(n, i, k) == s);
+      }
+
+  // Summing over a batch label.
+  matrix<double, 2> f = contract<2>("bij,bjk->ik", a, b);
+  for (size_t i = 0; i != 9; ++i)
+    for (size_t k = 0; k != 5; ++k) {
+      double s = 0;
+      for (size_t n = 0; n != 4; ++n)
+        s += c(n, i, k);
+      assert(f(i, k) == s);
+    }
+}
+
+void
+check_sums()
+{
+  matrix<double, 3> a(4, 6, 5), b(6, 5, 8);
+  fill(a, 6);
+  fill(b, 7);
+  matrix<double, 2> c = contract<2>("ijk,jkl->il", a, b);
+  for (size_t i = 0; i != 4; ++i)
+    for (size_t l = 0; l != 8; ++l) {
+      double s = 0;
+      for (size_t j = 0; j != 6; ++j)
+        for (size_t k = 0; k != 5; ++k)
+          s += a(i, j, k) * b(j, k, l);
+      assert(c(i, l) == s);
+    }
+
+  // The summed labels in another order, which is copied.
+  matrix<double, 3> bt = contract<3>("jkl->kjl", b);
+  assert(contract<2>("ikj,jkl->il", a, bt) == c);
+}
+
+void
+check_chain()
+{
+  matrix<double, 2> a(3, 40), b(40, 30), c(30, 2);
+  fill(a, 8);
+  fill(b, 9);
+  fill(c, 10);
+  matrix<double, 2> ab = contract<2>("ij,jk->ik", a, b);
+  matrix<double, 2> abc = contract<2>("ij,jk->ik", ab, c);
+  assert(contract<2>("ij,jk,kl->il", a, b, c) == abc);
+
+  // An outer product, and a sum of all the elements.
+  matrix<double, 1> x {1.0, 2.0, 3.0}, y {4.0, 5.0};
+  assert((contract<2>("i,j->ij", x, y)
+          == matrix<double, 2> {{4.0, 5.0}, {8.0, 10.0}, {12.0, 15.0}}));
+  assert(contract<0>("i,j->", x, y)() == 54);
+}
+
+void
+check_diagonal()
+{
+  matrix<double, 2> a {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}, {7.0, 8.0, 9.0}};
+  assert(contract<0>("ii", a)() == 15);
+  assert((contract<1>("ii->i", a) == matrix<double, 1> {1.0, 5.0, 9.0}));
+  assert((contract<1>("ij->j", a) == matrix<double, 1> {12.0, 15.0, 18.0}));
+  assert((contract<2>("ij->ji", a)
+          == matrix<double, 2> {{1.0, 4.0, 7.0},
+                                {2.0, 5.0, 8.0},
+                                {3.0, 6.0, 9.0}}));
+}
+
+void
+check_errors()
+{
+  matrix<double, 2> a(3, 4), b(5, 6);
+  auto fails = [](void (*f)(const matrix<double, 2>&,
+                            const matrix<double, 2>&),
+                  const matrix<double, 2>& x, const matrix<double, 2>& y) {
+    try {
+      f(x, y);
+      return false;
+    } catch (invalid_argument&) {
+      return true;
+    }
+  };
+  using M = const matrix<double, 2>&;
+  assert(fails([](M x, M y) { contract<2>("ij,jk->ik", x, y); }, a, b));
+  assert(fails([](M x, M y) { contract<2>("ijk,jk->ik", x, y); }, a, b));
+  assert(fails([](M x, M y) { contract<2>("ij->ik", x, y); }, a, b));
+  assert(fails([](M x, M y) { contract<2>("ij,kl->ii", x, y); }, a, b));
+  assert(fails([](M x, M y) { contract<2>("i1,kl->ik", x, y); }, a, b));
+  assert(fails([](M x, M y) { contract<3>("ij,kl->ik", x, y); }, a, b));
+}
+
+int main()
+{
+  check_product();
+  check_batched();
+  check_sums();
+  check_chain();
+  check_diagonal();
+  check_errors();
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+int main()
+{
+  using M = matrix<int, 2>;
+
+  M a {{1, 2, 3}, {4, 5, 6}};
+  M b {{6, 5, 4}, {3, 2, 1}};
+  M c {{1, 1, 1}, {1, 1, 1}};
+
+  // Element-wise operations result in expressions, not matrices.
+  static_assert(!Same<decltype(a + b), M>(), "");
+  static_assert(Matrix<decltype(a + b)>(), "");
+  static_assert(Same<Value_type<decltype(a + b)>, int>(), "");
+
+  // Fused evaluation.
+  {
+    M r = a + b * 2 - c;
+    M x {{12, 11, 10}, {9, 8, 7}};
+    assert(r == x);
+    assert(r.rows() == 2 && r.cols() == 3);
+  }
+
+  // Scalar operands on both sides.
+  {
+    M r = 2 * a + 1;
+    M x {{3, 5, 7}, {9, 11, 13}};
+    assert(r == x);
+
+    r = (r - 1) / 2 % 4;
+    M y {{1, 2, 3}, {0, 1, 2}};
+    assert(r == y);
+  }
+
+  // Expressions compare equal to matrices, and can be iterated over.
+  {
+    M x {{7, 7, 7}, {7, 7, 7}};
+    assert(a + b == x);
+    assert(x == a + b);
+    for (int n : a + b)
+      assert(n == 7);
+  }
+
+  // Assigning to one of the operands is well-defined.
+  {
+    M r = a;
+    r = r + r * 2;
+    assert(r == a * 3);
+  }
+
+  // Assigning to a matrix with a different shape replaces it.
+  {
+    M r(5, 5);
+    r = a - c;
+    assert(r.rows() == 2 && r.cols() == 3);
+    assert(r(1, 2) == 5);
+  }
+
+  // Compound assignment.
+  {
+    M r = a;
+    r += b - c;
+    M x {{6, 6, 6}, {6, 6, 6}};
+    assert(r == x);
+    r -= a + b;
+    M y {{-1, -1, -1}, {-1, -1, -1}};
+    assert(r == y);
+  }
+
+  // Sub-matrix operands and destinations.
+  {
+    M m(4, 6);
+    matrix<int, 2> z = m;
+    int n = 0;
+    for (auto& x : m)
+      x = n++;
+
+    // A contiguous block and a strided block of the same shape.
+    auto p = m(slice(0, 2), slice(0, 3));
+    auto q = m(slice(2, 2), slice(0, 3, 2));
+    M r = p + q;
+    for (size_t i = 0; i < 2; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        assert(r(i, j) == m(i, j) + m(i + 2, j * 2));
+
+    // Write an expression into a strided destination.
+    auto d = z(slice(1, 2), slice(1, 3, 2));
+    d = p * 10 + a;
+    for (size_t i = 0; i < 2; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        assert(z(i + 1, j * 2 + 1) == m(i, j) * 10 + a(i, j));
+    assert(z(0, 0) == 0 && z(1, 0) == 0 && z(3, 5) == 0);
+  }
+
+  // Expiring matrix operands are computed in place, and result in matrices.
+  {
+    static_assert(Same<decltype(M(a) + b), M>(), "");
+    static_assert(Same<decltype(a - M(b)), M>(), "");
+    static_assert(Same<decltype(2 * M(a)), M>(), "");
+
+    M r = M(a) + b * 2 - c;
+    M x {{12, 11, 10}, {9, 8, 7}};
+    assert(r == x);
+    M s = a - std::move(r);
+    M y {{-11, -9, -7}, {-5, -3, -1}};
+    assert(s == y);
+    M t = M(a) + M(b);
+    assert(t == a + b);
+    t = 2 * (std::move(t) % 4) - 1;
+    M z {{5, 5, 5}, {5, 5, 5}};
+    assert(t == z);
+    matrix<double, 1> v {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0};
+    matrix<double, 1> w = v - (matrix<double, 1>(v) * 2.0 + 1.0) / 2.0;
+    for (auto e : w)
+      assert(e == -0.5);
+  }
+
+  // Expressions over vectors.
+  {
+    matrix<double, 1> x {1.0, 2.0, 3.0, 4.0};
+    matrix<double, 1> y {4.0, 3.0, 2.0, 1.0};
+    matrix<double, 1> r = x * 0.5 + y * 0.5;
+    for (auto v : r)
+      assert(v == 2.5);
+  }
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Check that iterating over the 2D reference r visits the same elements
+// as indexing in row-major order.
+template <typename R>
+  void check_order_2(const R& r)
+  {
+    vector<int> v;
+    for (size_t i = 0; i < r.rows(); ++i)
+      for (size_t j = 0; j < r.cols(); ++j)
+        v.push_back(r(i, j));
+    assert(v.size() == r.size());
+    assert(equal(v.begin(), v.end(), r.begin()));
+
+    size_t n = 0;
+    for (auto i = r.begin(); i != r.end(); ++i)
+      ++n;
+    assert(n == r.size());
+  }
+
+int main()
+{
+  matrix<int, 2> m(6, 8);
+  int n = 0;
+  for (auto& x : m)
+    x = n++;
+
+  // Contiguous, row-blocked, and strided slices, rows, and columns.
+  check_order_2(m(slice(0, 6), slice(0, 8)));
+  check_order_2(m(slice(2, 3), slice(0, 8)));
+  check_order_2(m(slice(1, 3), slice(2, 4)));
+  check_order_2(m(slice(0, 3, 2), slice(1, 4, 2)));
+  check_order_2(m(slice(0, 6), slice(3, 1)));
+  check_order_2(m(slice(4, 1), slice(0, 8)));
+
+  // Rows and columns of a matrix.
+  {
+    auto r = m.row(2);
+    assert(equal(r.begin(), r.end(), m.begin() + 16));
+
+    auto c = m.col(3);
+    vector<int> v {3, 11, 19, 27, 35, 43};
+    assert(equal(c.begin(), c.end(), v.begin()));
+  }
+
+  // Three dimensional slices.
+  {
+    matrix<int, 3> t(3, 4, 5);
+    int k = 0;
+    for (auto& x : t)
+      x = k++;
+
+    auto s = t(slice(0, 3), slice(1, 2), slice(0, 5));
+    vector<int> v;
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 1; j < 3; ++j)
+        for (size_t l = 0; l < 5; ++l)
+          v.push_back(t(i, j, l));
+    assert(equal(v.begin(), v.end(), s.begin()));
+
+    auto u = t(slice(1, 2), slice(0, 4), slice(1, 3));
+    v.clear();
+    for (size_t i = 1; i < 3; ++i)
+      for (size_t j = 0; j < 4; ++j)
+        for (size_t l = 1; l < 4; ++l)
+          v.push_back(t(i, j, l));
+    assert(equal(v.begin(), v.end(), u.begin()));
+  }
+
+  // Iterators are assignable.
+  {
+    auto r = m(slice(1, 2), slice(1, 2));
+    auto i = r.begin();
+    i = r.end();
+    assert(i == r.end());
+  }
+}
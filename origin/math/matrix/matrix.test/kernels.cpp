@@ -0,0 +1,121 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Fill the matrix with increasing values.
+template <typename M>
+  void iota_fill(M& m)
+  {
+    Value_type<M> n = 1;
+    for (auto& x : m)
+      x = n++;
+  }
+
+// Check the compound arithmetic operators on sub-matrix x of the matrix m.
+// Elements of m outside of x must not be modified.
+template <typename T, typename F>
+  void check_submatrix(F get)
+  {
+    matrix<T, 2> m(9, 13);
+    iota_fill(m);
+    matrix<T, 2> orig = m;
+
+    auto x = get(m);
+    matrix<T, 2> y = x;
+
+    x += T(2);
+    x *= T(3);
+    x -= T(1);
+    x /= T(2);
+    for (size_t i = 0; i < x.rows(); ++i)
+      for (size_t j = 0; j < x.cols(); ++j)
+        assert(x(i, j) == ((y(i, j) + T(2)) * T(3) - T(1)) / T(2));
+
+    x = y;
+    assert(x == y);
+
+    x += y;
+    for (size_t i = 0; i < x.rows(); ++i)
+      for (size_t j = 0; j < x.cols(); ++j)
+        assert(x(i, j) == y(i, j) + y(i, j));
+
+    x -= y;
+    assert(x == y);
+
+    // Nothing outside the sub-matrix changed.
+    assert(m == orig);
+  }
+
+template <typename T>
+  void check_kernels()
+  {
+    // Contiguous matrices of sizes that leave remainders on each path.
+    for (size_t n = 1; n < 40; n += 3) {
+      matrix<T, 2> a(n, 3);
+      iota_fill(a);
+      matrix<T, 2> b = a;
+
+      a += T(1);
+      a *= T(2);
+      for (size_t i = 0; i < a.size(); ++i)
+        assert(a.data()[i] == (b.data()[i] + T(1)) * T(2));
+
+      a -= b;
+      a -= b;
+      a -= T(2);
+      for (auto x : a)
+        assert(x == T(0));
+
+      a = T(5);
+      for (auto x : a)
+        assert(x == T(5));
+    }
+
+    // The whole matrix, as a matrix_ref.
+    check_submatrix<T>([](matrix<T, 2>& m) {
+      return m(slice::all, slice::all);
+    });
+
+    // Rows are contiguous, but the sub-matrix is not.
+    check_submatrix<T>([](matrix<T, 2>& m) {
+      return m(slice(2, 5), slice(1, 11));
+    });
+
+    // A strided sub-matrix.
+    check_submatrix<T>([](matrix<T, 2>& m) {
+      return m(slice(1, 4, 2), slice(0, 6, 2));
+    });
+  }
+
+int main()
+{
+  check_kernels<double>();
+  check_kernels<float>();
+  check_kernels<int>();
+
+  // Mixed value types use the scalar kernels.
+  {
+    matrix<double, 2> a {{1, 2, 3}, {4, 5, 6}};
+    matrix<int, 2> b {{1, 1, 1}, {2, 2, 2}};
+    a += b;
+    assert(a(0, 0) == 2 && a(1, 2) == 8);
+  }
+
+  // Remainders are not vectorized.
+  {
+    matrix<int, 1> a {5, 6, 7, 8, 9};
+    a %= 3;
+    assert(a(0) == 2 && a(4) == 0);
+  }
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns an m x n matrix with distinct elements.
+matrix<double, 2>
+make_matrix(size_t m, size_t n)
+{
+  matrix<double, 2> a(m, n);
+  for (size_t i = 0; i != m; ++i)
+    for (size_t j = 0; j != n; ++j)
+      a(i, j) = double(i * n + j) / 8;
+  return a;
+}
+
+template <typename M1, typename M2>
+  bool
+  same_elements(const M1& a, const M2& b)
+  {
+    if (a.rows() != b.rows() || a.cols() != b.cols())
+      return false;
+    for (size_t i = 0; i != a.rows(); ++i)
+      for (size_t j = 0; j != a.cols(); ++j)
+        if (a(i, j) != b(i, j))
+          return false;
+    return true;
+  }
+
+void
+test_column_major()
+{
+  column_major_matrix<int> c {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  assert(c.rows() == 2 && c.cols() == 3);
+  assert(c(1, 0) == 4);
+
+  // The columns are contiguous.
+  const int elems[] {1, 4, 2, 5, 3, 6};
+  assert(equal(elems, elems + 6, c.data()));
+  assert(c.col(1).descriptor().strides[0] == 1);
+  assert(c.row(1).descriptor().strides[0] == 2);
+
+  // Iteration is in row-major order, as for a matrix.
+  matrix<int, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  assert(c == m);
+  assert(equal(c.row(1).begin(), c.row(1).end(), m.row(1).begin()));
+  assert(c.col(2)(1) == 6);
+  c.col(2)(1) = 7;
+  assert(c(1, 2) == 7);
+  c(1, 2) = 6;
+
+  // Slices are matrix_refs.
+  auto s = c(slice(0, 2), slice(1, 2));
+  assert(s(1, 1) == 6);
+  s = 0;
+  assert(c(0, 0) == 1 && c(0, 1) == 0 && c(1, 2) == 0);
+  c = m;
+  assert(c == m);
+
+  // The transpose of a column-major matrix is row-major.
+  auto t = transpose(c);
+  assert(t.descriptor().strides[1] == 1);
+  assert(t(2, 1) == 6);
+
+  // Conversions between layouts.
+  matrix<double, 2> a = make_matrix(70, 45);
+  column_major_matrix<double> ca = a;
+  assert(same_elements(a, ca));
+  matrix<double, 2> b = ca;
+  assert(b == a);
+  column_major_matrix<double> cs = a(slice(3, 40), slice(5, 30));
+  assert(same_elements(cs, a(slice(3, 40), slice(5, 30))));
+
+  // Arithmetic across layouts.
+  matrix<double, 2> r = ca + a * 2.0;
+  assert(same_elements(r, matrix<double, 2>(a * 3.0)));
+  ca += a;
+  ca *= 0.5;
+  assert(ca == a);
+  column_major_matrix<double> cb(uninitialized, 70, 45);
+  cb = ca - a;
+  assert(*max_element(cb.begin(), cb.end()) == 0);
+
+  // The product and the BLAS kernels operate on the strides.
+  matrix<double, 2> p = make_matrix(45, 30);
+  matrix<double, 2> want(70, 30);
+  matrix_product(a, p, want);
+  column_major_matrix<double> cp = p;
+  column_major_matrix<double> got(70, 30);
+  matrix_product(ca, cp, got);
+  assert(same_elements(got, want));
+
+  matrix<double, 1> x(45), y(70), z(70);
+  for (size_t i = 0; i != 45; ++i)
+    x(i) = double(i % 5);
+  gemv(a, x, y);
+  gemv(ca, x, z);
+  assert(y == z);
+
+  assert(ca.memory_usage().live == 70 * 45 * sizeof(double));
+}
+
+void
+test_tiled()
+{
+  // The matrix is 3 x 2 tiles; the edge tiles are partial.
+  matrix<double, 2> a = make_matrix(20, 13);
+  tiled_matrix<double, 8> t = a;
+  assert(t.rows() == 20 && t.cols() == 13);
+  assert(t.tile_rows() == 3 && t.tile_cols() == 2);
+  assert(same_elements(t, a));
+  assert(t == a);
+
+  // The tiles are contiguous matrix_refs.
+  auto f = t.tile(1, 0);
+  assert(f.rows() == 8 && f.cols() == 8);
+  assert(f(2, 3) == a(10, 3));
+  assert(&f(7, 7) - &f(0, 0) == 63);
+  auto e = t.tile(2, 1);
+  assert(e.rows() == 4 && e.cols() == 5);
+  assert(e(3, 4) == a(19, 12));
+  assert(&e(0, 0) - t.data() == 5 * 64);
+
+  // Operations on tiles modify the matrix.
+  for (size_t i = 0; i != t.tile_rows(); ++i)
+    for (size_t j = 0; j != t.tile_cols(); ++j)
+      t.tile(i, j) *= 2.0;
+  matrix<double, 2> b = t;
+  assert(same_elements(b, matrix<double, 2>(a * 2.0)));
+
+  // Arithmetic and expressions across layouts.
+  t -= a;
+  assert(t == a);
+  tiled_matrix<double, 8> u = t + a;
+  assert(same_elements(u, matrix<double, 2>(a * 2.0)));
+  u = u * 0.5 - t;
+  assert(*max_element(u.begin(), u.end()) == 0 &&
+         *min_element(u.begin(), u.end()) == 0);
+  column_major_matrix<double> c = t;
+  assert(same_elements(c, a));
+  tiled_matrix<double, 8> v = transpose(a);
+  assert(v.rows() == 13 && v(12, 19) == a(19, 12));
+
+  // Scalar operations, and the padding.
+  tiled_matrix<int, 4> w(5, 5);
+  w += 3;
+  assert(w(4, 4) == 3 && w.tile(1, 1).size() == 1);
+  memory_footprint fp = w.memory_usage();
+  assert(fp.live == 25 * sizeof(int));
+  assert(fp.reserved == 64 * sizeof(int));
+
+  tiled_matrix<int> d {
+    {1, 2},
+    {3, 4}
+  };
+  assert(d(1, 0) == 3);
+  assert(d.tile(0, 0).cols() == 2);
+
+  tiled_matrix<int> empty(0, 4);
+  assert(empty.begin() == empty.end());
+}
+
+int main()
+{
+  test_column_major();
+  test_tiled();
+}
@@ -0,0 +1,152 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+default_random_engine eng;
+uniform_real_distribution<> dist(-1, 1);
+
+template <typename M>
+  void randomize(M& m)
+  {
+    for (auto& x : m)
+      x = dist(eng);
+  }
+
+// Returns the largest absolute difference between elements of a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    auto i = b.begin();
+    for (double x : a)
+      e = max(e, abs(x - *i++));
+    return e;
+  }
+
+// Compute A * x for a vector x.
+Vec multiply(const Mat& a, const Vec& x)
+{
+  Vec r(a.rows());
+  for (size_t i = 0; i < a.rows(); ++i)
+    for (size_t j = 0; j < a.cols(); ++j)
+      r(i) += a(i, j) * x(j);
+  return r;
+}
+
+// Factor a random n x n matrix and check that the solution of A * x = b
+// reproduces b.
+void check_solve(size_t n)
+{
+  Mat a(n, n);
+  Vec x(n);
+  randomize(a);
+  randomize(x);
+  Vec b = multiply(a, x);
+
+  Mat lu = a;
+  vector<size_t> piv;
+  bool ok = lu_factor(lu, piv);
+  assert(ok);
+  assert(piv.size() == n);
+
+  Vec y = b;
+  lu_solve(lu, piv, y);
+  assert(max_error(x, y) < 1e-8);
+}
+
+int main()
+{
+  // Sizes smaller than, equal to, and spanning several panels.
+  check_solve(1);
+  check_solve(5);
+  check_solve(64);
+  check_solve(150);
+
+  // The factors reproduce the permuted matrix.
+  {
+    Mat a {{0, 2, 1}, {1, 1, 1}, {4, 2, 0}};
+    Mat lu = a;
+    vector<size_t> piv;
+    assert(lu_factor(lu, piv));
+
+    // The largest element of the first column is selected as the pivot.
+    assert(piv[0] == 2);
+
+    Mat l(3, 3), u(3, 3);
+    for (size_t i = 0; i < 3; ++i) {
+      l(i, i) = 1;
+      for (size_t j = 0; j < 3; ++j) {
+        if (j < i)
+          l(i, j) = lu(i, j);
+        else
+          u(i, j) = lu(i, j);
+      }
+    }
+    Mat pa = a;
+    for (size_t i = 0; i < 3; ++i)
+      pa.swap_rows(i, piv[i]);
+    assert(max_error(l * u, pa) < 1e-12);
+  }
+
+  // Many right-hand sides reuse one factorization.
+  {
+    size_t n = 100;
+    Mat a(n, n);
+    Mat x(n, 7);
+    randomize(a);
+    randomize(x);
+    Mat b = a * x;
+
+    vector<size_t> piv;
+    Mat lu = a;
+    lu_factor(lu, piv);
+    lu_solve(lu, piv, b);
+    assert(max_error(x, b) < 1e-8);
+
+    // Solve for a single column through a strided reference.
+    Mat c = a * x;
+    auto col = c.col(3);
+    lu_solve(lu, piv, col);
+    for (size_t i = 0; i < n; ++i)
+      assert(abs(c(i, 3) - x(i, 3)) < 1e-8);
+  }
+
+  // Factor a sub-matrix in place.
+  {
+    Mat m(80, 90);
+    randomize(m);
+    Mat a = m(slice(5, 70), slice(10, 70));
+    auto r = m(slice(5, 70), slice(10, 70));
+    vector<size_t> piv;
+    assert(lu_factor(r, piv));
+
+    Vec x(70);
+    randomize(x);
+    Vec b = multiply(a, x);
+    lu_solve(r, piv, b);
+    assert(max_error(x, b) < 1e-8);
+  }
+
+  // Singular matrices are detected.
+  {
+    Mat a {{1, 2}, {2, 4}};
+    vector<size_t> piv;
+    assert(!lu_factor(a, piv));
+  }
+}
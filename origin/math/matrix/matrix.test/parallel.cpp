@@ -0,0 +1,125 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Fill the matrix with small integer values so that the products are exact,
+// even for floating point types.
+template <typename M>
+  void fill(M& m, int seed)
+  {
+    int n = seed;
+    for (auto& x : m) {
+      x = n % 7 - 3;
+      n = (n * 31 + 11) % 1009;
+    }
+  }
+
+// Check that the parallel product of an m x k and k x n matrix computed
+// with the given number of threads matches the serial product.
+void check_product(size_t m, size_t k, size_t n, size_t threads)
+{
+  matrix<double, 2> a(m, k);
+  matrix<double, 2> b(k, n);
+  fill(a, 1);
+  fill(b, 2);
+
+  set_product_threads(1);
+  matrix<double, 2> serial = a * b;
+
+  set_product_threads(threads);
+  assert(product_threads() == threads);
+  assert(a * b == serial);
+}
+
+// Element-wise operations on a matrix large enough to be divided among the
+// threads agree with the serial operations, for contiguous operands,
+// strided references, and expressions.
+void check_elementwise(size_t threads)
+{
+  matrix<double, 2> a(300, 400);
+  matrix<double, 2> b(300, 400);
+  fill(a, 4);
+  fill(b, 5);
+
+  set_product_threads(1);
+  matrix<double, 2> s1 = a;
+  s1 += b;
+  s1 *= 2.0;
+  matrix<double, 2> s2 = a + b * 3.0;
+  matrix<double, 2> s3(300, 400);
+  hadamard_product(a, b, s3);
+  matrix<double, 2> s4 = a;
+  s4(slice::all, slice(0, 200, 2)) += b(slice::all, slice(1, 200, 2));
+
+  set_product_threads(threads);
+  matrix<double, 2> p1 = a;
+  p1 += b;
+  p1 *= 2.0;
+  assert(p1 == s1);
+  matrix<double, 2> p2 = a + b * 3.0;
+  assert(p2 == s2);
+  matrix<double, 2> p3(300, 400);
+  hadamard_product(a, b, p3);
+  assert(p3 == s3);
+  matrix<double, 2> p4 = a;
+  p4(slice::all, slice(0, 200, 2)) += b(slice::all, slice(1, 200, 2));
+  assert(p4 == s4);
+
+  for (size_t i = 0; i != 300; ++i)
+    for (size_t j = 0; j != 400; ++j)
+      assert(s3(i, j) == a(i, j) * b(i, j));
+
+  // The output may be an operand, and may be strided.
+  hadamard_product(a, b, a);
+  assert(a == s3);
+  matrix<double, 2> t(400, 300);
+  auto tt = transpose(t);
+  hadamard_product(b, b, tt);
+  for (size_t i = 0; i != 300; ++i)
+    for (size_t j = 0; j != 400; ++j)
+      assert(t(j, i) == b(i, j) * b(i, j));
+}
+
+int main()
+{
+  assert(product_threads() >= 1);
+
+  // Tall and wide products are partitioned along different dimensions.
+  // Some of these have fewer rows than threads.
+  check_product(200, 150, 130, 4);
+  check_product(130, 150, 200, 4);
+  check_product(37, 300, 300, 3);
+  check_product(300, 300, 5, 64);
+
+  // Concurrent products share the thread pool.
+  {
+    set_product_threads(4);
+    matrix<double, 2> a(160, 160);
+    fill(a, 3);
+    matrix<double, 2> r1, r2;
+    thread t1([&]() { r1 = a * a; });
+    thread t2([&]() { r2 = a * a; });
+    t1.join();
+    t2.join();
+    assert(r1 == r2);
+  }
+
+  check_elementwise(4);
+  check_elementwise(7);
+
+  // Restore the default.
+  set_product_threads(0);
+  assert(product_threads() == max(thread::hardware_concurrency(), 1u));
+}
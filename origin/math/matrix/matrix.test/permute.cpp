@@ -0,0 +1,127 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename M>
+  void
+  iota(M& m)
+  {
+    double k = 0;
+    for (double& x : m)
+      x = k++;
+  }
+
+// Returns a random permutation of [0, n).
+vector<size_t>
+random_permutation(size_t n, unsigned seed)
+{
+  vector<size_t> p(n);
+  for (size_t i = 0; i != n; ++i)
+    p[i] = i;
+  shuffle(p.begin(), p.end(), minstd_rand(seed));
+  return p;
+}
+
+void
+check_swap()
+{
+  matrix<double, 2> m(5, 37);
+  iota(m);
+  matrix<double, 2> a = m;
+
+  swap_rows(m, 1, 3);
+  swap_cols(m, 0, 36);
+  for (size_t i = 0; i != 5; ++i)
+    for (size_t j = 0; j != 37; ++j) {
+      size_t r = i == 1 ? 3 : i == 3 ? 1 : i;
+      size_t c = j == 0 ? 36 : j == 36 ? 0 : j;
+      assert(m(i, j) == a(r, c));
+    }
+
+  // The members exchange rows of matrices and views.
+  m.swap_rows(1, 3);
+  swap_cols(m, 0, 36);
+  assert(m == a);
+  auto v = m(slice(1, 3), slice(2, 30));
+  v.swap_rows(0, 2);
+  assert(m(1, 2) == a(3, 2) && m(3, 31) == a(1, 31) && m(1, 1) == a(1, 1));
+
+  // Swapping the rows of a transposed view swaps columns.
+  swap_rows(transpose(m), 4, 5);
+  assert(m(0, 4) == a(0, 5) && m(0, 5) == a(0, 4));
+
+  // The rows of a 3D matrix.
+  matrix<double, 3> t(3, 4, 5);
+  iota(t);
+  swap_rows(t, 0, 2);
+  assert(t(0, 3, 4) == 59 && t(2, 0, 0) == 0);
+}
+
+void
+check_permute()
+{
+  const size_t rows = 300, cols = 301;
+  matrix<double, 2> m(rows, cols);
+  iota(m);
+  matrix<double, 2> a = m;
+  vector<size_t> p = random_permutation(rows, 1);
+  vector<size_t> q = random_permutation(cols, 2);
+
+  permute_rows(m, p);
+  permute_cols(m, q);
+  for (size_t i = 0; i != rows; ++i)
+    for (size_t j = 0; j != cols; ++j)
+      assert(m(p[i], q[j]) == a(i, j));
+
+  // The inverse permutations restore the matrix.
+  vector<size_t> pi(rows), qi(cols);
+  for (size_t i = 0; i != rows; ++i)
+    pi[p[i]] = i;
+  for (size_t j = 0; j != cols; ++j)
+    qi[q[j]] = j;
+  permute_cols(m, qi);
+  permute_rows(m, pi);
+  assert(m == a);
+
+  // A view, whose columns are strided.
+  auto v = transpose(m)(slice(0, 10), slice(5, 20));
+  matrix<double, 2> b = v;
+  vector<size_t> r = random_permutation(10, 3);
+  vector<size_t> c = random_permutation(20, 4);
+  permute_rows(v, r);
+  permute_cols(v, c);
+  for (size_t i = 0; i != 10; ++i)
+    for (size_t j = 0; j != 20; ++j)
+      assert(v(r[i], c[j]) == b(i, j));
+
+  // An invalid permutation leaves the matrix unchanged.
+  matrix<double, 2> x = m;
+  try {
+    permute_rows(m, vector<size_t>(rows, 0));
+    assert(false);
+  } catch (invalid_argument&) { }
+  try {
+    permute_cols(m, p);
+    assert(false);
+  } catch (invalid_argument&) { }
+  assert(m == x);
+}
+
+int main()
+{
+  check_swap();
+  check_permute();
+}
@@ -0,0 +1,218 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+check_half()
+{
+  assert(half(1.0f).to_bits() == 0x3c00);
+  assert(half(-2.0f).to_bits() == 0xc000);
+  assert(half(0.5f).to_bits() == 0x3800);
+  assert(half(65504.0f).to_bits() == 0x7bff);
+  assert(float(half(0.1f)) == 0.0999755859375f);
+
+  // Rounding to the nearest even, overflow, and subnormals.
+  assert(half(1.0f + ldexp(1.0f, -11)).to_bits() == 0x3c00);
+  assert(half(1.0f + 3 * ldexp(1.0f, -11)).to_bits() == 0x3c02);
+  assert(half(65519.0f).to_bits() == 0x7bff);
+  assert(half(65520.0f).to_bits() == 0x7c00);
+  assert(half(ldexp(1.0f, -24)).to_bits() == 0x0001);
+  assert(half(ldexp(1.0f, -25)).to_bits() == 0x0000);
+  assert(half(3 * ldexp(1.0f, -25)).to_bits() == 0x0002);
+  assert(half(-0.0f).to_bits() == 0x8000);
+  assert(float(half::from_bits(0x0001)) == ldexp(1.0f, -24));
+  assert(std::isinf(float(half(1e10f))));
+  assert(std::isnan(float(half(numeric_limits<float>::quiet_NaN()))));
+
+  // Every half, except NaN, is converted to a float and back exactly.
+  for (uint32_t b = 0; b != 0x10000; ++b) {
+    half h = half::from_bits(uint16_t(b));
+    if (std::isnan(float(h)))
+      continue;
+    assert(half(float(h)).to_bits() == b);
+  }
+
+  // Arithmetic is computed in float.
+  half x = 1.5f;
+  x += 2;
+  x *= x;
+  assert(x == 12.25f);
+}
+
+void
+check_bfloat16()
+{
+  assert(bfloat16(1.0f).to_bits() == 0x3f80);
+  assert(bfloat16(-2.0f).to_bits() == 0xc000);
+  assert(bfloat16(1.0f + ldexp(1.0f, -8)).to_bits() == 0x3f80);
+  assert(bfloat16(1.0f + 3 * ldexp(1.0f, -8)).to_bits() == 0x3f82);
+  assert(float(bfloat16(3e38f)) > 2.9e38f);
+  assert(std::isnan(float(bfloat16(numeric_limits<float>::quiet_NaN()))));
+
+  for (uint32_t b = 0; b != 0x10000; ++b) {
+    bfloat16 h = bfloat16::from_bits(uint16_t(b));
+    if (std::isnan(float(h)))
+      continue;
+    assert(bfloat16(float(h)).to_bits() == b);
+  }
+}
+
+template <typename T>
+  void
+  check_convert()
+  {
+    // Values across the range of half, including subnormals.
+    minstd_rand gen(7);
+    uniform_real_distribution<float> exp(-26.0f, 16.0f);
+    matrix<float, 1> f(1003);
+    for (float& x : f)
+      x = (gen() % 2 ? 1 : -1) * exp2(exp(gen));
+
+    matrix<T, 1> h = convert<T>(f);
+    for (size_t i = 0; i != f.size(); ++i)
+      assert(h(i).to_bits() == T(f(i)).to_bits());
+
+    matrix<float, 1> g = convert<float>(h);
+    for (size_t i = 0; i != f.size(); ++i)
+      assert(g(i) == float(h(i)));
+
+    // A strided view is converted element by element.
+    matrix<float, 2> m {{1, 2, 3}, {4, 5, 6}};
+    matrix<T, 1> c(2);
+    convert_into(m.col(1), c);
+    assert(c(0) == 2.0f && c(1) == 5.0f);
+  }
+
+template <typename T>
+  void
+  check_product()
+  {
+    minstd_rand gen(11);
+    uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    matrix<float, 2> fa(37, 41);
+    matrix<float, 2> fb(41, 29);
+    for (float& x : fa)
+      x = dist(gen);
+    for (float& x : fb)
+      x = dist(gen);
+    matrix<T, 2> a = convert<T>(fa);
+    matrix<T, 2> b = convert<T>(fb);
+
+    // The product of the reduced matrices is that of their values in float.
+    matrix<float, 2> c(37, 29);
+    matrix_product(a, b, c);
+    matrix<float, 2> e(37, 29);
+    matrix_product(convert<float>(a), convert<float>(b), e);
+    assert(c == e);
+
+    // A small product is computed element by element.
+    auto sa = a(slice(0, 3), slice(0, 4));
+    auto sb = b(slice(0, 4), slice(0, 2));
+    matrix<float, 2> sc(3, 2);
+    matrix_product(sa, sb, sc);
+    for (size_t i = 0; i != 3; ++i)
+      for (size_t j = 0; j != 2; ++j) {
+        float s = 0;
+        for (size_t k = 0; k != 4; ++k)
+          s += float(a(i, k)) * float(b(k, j));
+        assert(abs(sc(i, j) - s) < 1e-5f);
+      }
+
+    // The products of a matrix and a vector, with contiguous rows and with
+    // contiguous columns.
+    matrix<T, 1> x = convert<T>(fa.row(0));
+    matrix<float, 1> y(29);
+    gemv(transpose(b), x, y);
+    matrix<float, 1> z(37);
+    gemv(a, x, z);
+    for (size_t i = 0; i != 37; ++i) {
+      float s = 0;
+      for (size_t k = 0; k != 41; ++k)
+        s += float(a(i, k)) * float(x(k));
+      assert(abs(z(i) - s) < 1e-5f);
+    }
+    for (size_t j = 0; j != 29; ++j) {
+      float s = 0;
+      for (size_t k = 0; k != 41; ++k)
+        s += float(b(k, j)) * float(x(k));
+      assert(abs(y(j) - s) < 1e-5f);
+    }
+
+    // The dot product is accumulated in float.
+    static_assert(Same<decltype(dot(x, x)), float>(), "");
+    float d = 0;
+    for (size_t k = 0; k != x.size(); ++k)
+      d += float(x(k)) * float(x(k));
+    assert(abs(dot(x, x) - d) < 1e-4f);
+
+    // Element-wise operations are computed in float.
+    matrix<T, 2> w = a;
+    w += a;
+    w *= 0.5f;
+    assert(w == a);
+  }
+
+void
+check_int8()
+{
+  minstd_rand gen(3);
+  matrix<int8_t, 2> a(40, 100);
+  matrix<int8_t, 2> b(100, 24);
+  for (int8_t& x : a)
+    x = int8_t(int(gen() % 255) - 127);
+  for (int8_t& x : b)
+    x = int8_t(int(gen() % 255) - 127);
+
+  matrix<int32_t, 2> c(40, 24);
+  matrix_product(a, b, c);
+  for (size_t i = 0; i != 40; ++i)
+    for (size_t j = 0; j != 24; ++j) {
+      int32_t s = 0;
+      for (size_t k = 0; k != 100; ++k)
+        s += int32_t(a(i, k)) * int32_t(b(k, j));
+      assert(c(i, j) == s);
+    }
+
+  // The dot product does not overflow int8_t.
+  matrix<int8_t, 1> v(100);
+  for (int8_t& x : v)
+    x = 100;
+  static_assert(Same<decltype(dot(v, v)), int32_t>(), "");
+  assert(dot(v, v) == 1000000);
+
+  matrix<int32_t, 1> y(40);
+  gemv(a, v, y);
+  for (size_t i = 0; i != 40; ++i) {
+    int32_t s = 0;
+    for (size_t k = 0; k != 100; ++k)
+      s += int32_t(a(i, k)) * 100;
+    assert(y(i) == s);
+  }
+}
+
+int
+main()
+{
+  check_half();
+  check_bfloat16();
+  check_convert<half>();
+  check_convert<bfloat16>();
+  check_product<half>();
+  check_product<bfloat16>();
+  check_int8();
+}
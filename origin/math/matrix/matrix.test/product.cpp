@@ -0,0 +1,89 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Fill the matrix with small integer values so that the products are exact,
+// even for floating point types.
+template <typename M>
+  void fill(M& m, int seed)
+  {
+    int n = seed;
+    for (auto& x : m) {
+      x = n % 7 - 3;
+      n = (n * 31 + 11) % 1009;
+    }
+  }
+
+// Compute the product of a and b using the textbook algorithm.
+template <typename M1, typename M2>
+  matrix<Value_type<M1>, 2>
+  reference_product(const M1& a, const M2& b)
+  {
+    matrix<Value_type<M1>, 2> r(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i)
+      for (size_t j = 0; j < b.cols(); ++j)
+        for (size_t k = 0; k < a.cols(); ++k)
+          r(i, j) += a(i, k) * b(k, j);
+    return r;
+  }
+
+template <typename T>
+  void check_product(size_t m, size_t k, size_t n)
+  {
+    matrix<T, 2> a(m, k);
+    matrix<T, 2> b(k, n);
+    fill(a, 1);
+    fill(b, 2);
+    assert(a * b == reference_product(a, b));
+  }
+
+int main()
+{
+  // Sizes that exercise the small path, partial register tiles, and
+  // partial cache blocks.
+  check_product<double>(3, 3, 3);
+  check_product<double>(17, 5, 9);
+  check_product<double>(65, 130, 33);
+  check_product<double>(129, 300, 70);
+  check_product<int>(40, 41, 42);
+  check_product<float>(1, 100, 1);
+
+  // Products of contiguous sub-matrices.
+  {
+    matrix<double, 2> a(40, 50);
+    matrix<double, 2> b(60, 30);
+    fill(a, 3);
+    fill(b, 4);
+    auto x = a(slice(5, 20), slice(3, 25));
+    auto y = b(slice(10, 25), slice(2, 19));
+    assert(x * y == reference_product(x, y));
+  }
+
+  // Products of strided sub-matrices use the elementwise algorithm.
+  {
+    matrix<double, 2> a(40, 40);
+    fill(a, 5);
+    auto x = a(slice(0, 20, 2), slice(0, 20, 2));
+    assert(x * x == reference_product(x, x));
+  }
+
+  // The product accumulates into the output matrix.
+  {
+    matrix<double, 2> a(20, 20);
+    fill(a, 6);
+    matrix<double, 2> c = a;
+    matrix_product(a, a, c);
+    assert(c == a + reference_product(a, a));
+  }
+}
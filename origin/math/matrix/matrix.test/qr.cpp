@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+default_random_engine eng;
+uniform_real_distribution<> dist(-1, 1);
+
+template <typename M>
+  void randomize(M& m)
+  {
+    for (auto& x : m)
+      x = dist(eng);
+  }
+
+// Returns the largest absolute difference between elements of a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    auto i = b.begin();
+    for (double x : a)
+      e = max(e, abs(x - *i++));
+    return e;
+  }
+
+// Factor a random m x n matrix, and check that R is reproduced by the
+// reflectors, and that a consistent system is solved exactly.
+void check_factor(size_t m, size_t n)
+{
+  Mat a(m, n);
+  randomize(a);
+  Mat qr = a;
+  vector<double> tau;
+  qr_factor(qr, tau);
+  assert(tau.size() == n);
+
+  // Q^T * A = R.
+  Mat r = a;
+  matrix_impl::qr_apply_qt(m, n, qr.data(), n, size_t(1), tau.data(),
+                           n, r.data(), n, size_t(1));
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      assert(abs(r(i, j) - (j >= i ? qr(i, j) : 0.0)) < 1e-10 * m);
+
+  Mat x(n, 2);
+  randomize(x);
+  Mat b = a * x;
+  qr_solve(qr, tau, b);
+  Mat y = b(slice(0, n), slice(0, 2));
+  assert(max_error(x, y) < 1e-8);
+}
+
+int main()
+{
+  // Sizes smaller than, equal to, and spanning several panels.
+  check_factor(1, 1);
+  check_factor(5, 3);
+  check_factor(64, 64);
+  check_factor(150, 150);
+  check_factor(300, 140);
+
+  // A least squares fit of a line to noisy points.
+  {
+    size_t m = 50;
+    Mat a(m, 2);
+    Vec b(m);
+    for (size_t i = 0; i < m; ++i) {
+      a(i, 0) = 1;
+      a(i, 1) = i;
+      b(i) = 3 + 2 * double(i) + (i % 2 ? 0.1 : -0.1);
+    }
+    vector<double> tau;
+    qr_factor(a, tau);
+    qr_solve(a, tau, b);
+    assert(abs(b(0) - 3) < 0.1);
+    assert(abs(b(1) - 2) < 0.01);
+  }
+
+  // Factor a sub-matrix in place.
+  {
+    Mat m(90, 80);
+    randomize(m);
+    Mat a = m(slice(5, 80), slice(10, 70));
+    auto r = m(slice(5, 80), slice(10, 70));
+    vector<double> tau;
+    qr_factor(r, tau);
+
+    Vec x(70);
+    randomize(x);
+    Vec b(80);
+    for (size_t i = 0; i < 80; ++i)
+      for (size_t j = 0; j < 70; ++j)
+        b(i) += a(i, j) * x(j);
+    qr_solve(r, tau, b);
+    for (size_t i = 0; i < 70; ++i)
+      assert(abs(b(i) - x(i)) < 1e-8);
+  }
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+check_2d()
+{
+  matrix<int, 2> m {{1, 2, 3}, {4, 5, 6}};
+
+  matrix<int, 1> c = sum(m, axis(0));
+  assert((c == matrix<int, 1> {5, 7, 9}));
+  matrix<int, 1> r = sum(m, axis(1));
+  assert((r == matrix<int, 1> {6, 15}));
+  assert((max(m, axis(0)) == matrix<int, 1> {4, 5, 6}));
+  assert((min(m, axis(1)) == matrix<int, 1> {1, 4}));
+  assert((mean(m, axis(1)) == matrix<int, 1> {2, 5}));
+
+  // A user-defined operation.
+  auto mul = [](int a, int b) { return a * b; };
+  assert((reduce(m, axis(0), mul) == matrix<int, 1> {4, 10, 18}));
+
+  // The columns of a strided view.
+  auto v = m(slice(0, 2), slice(0, 2, 2));
+  assert((sum(v, axis(0)) == matrix<int, 1> {5, 9}));
+  assert((sum(v, axis(1)) == matrix<int, 1> {4, 10}));
+
+  // A const matrix, and the whole-matrix range algorithms.
+  const matrix<int, 2>& k = m;
+  assert((max(k, axis(1)) == matrix<int, 1> {3, 6}));
+  assert(max(m) == 6 && reduce(m, 0) == 21);
+}
+
+void
+check_vector()
+{
+  // Rows long enough for the vector loops, with a remainder.
+  size_t rows = 5, cols = 37;
+  matrix<double, 2> m(rows, cols);
+  for (size_t i = 0; i != rows; ++i)
+    for (size_t j = 0; j != cols; ++j)
+      m(i, j) = double((i * 13 + j * 7) % 17) - 8;
+
+  matrix<double, 1> s0 = sum(m, axis(0));
+  matrix<double, 1> s1 = sum(m, axis(1));
+  matrix<double, 1> lo = min(m, axis(1));
+  matrix<double, 1> hi = max(m, axis(0));
+  for (size_t j = 0; j != cols; ++j) {
+    double s = 0, h = m(0, j);
+    for (size_t i = 0; i != rows; ++i) {
+      s += m(i, j);
+      h = std::max(h, m(i, j));
+    }
+    assert(s0(j) == s && hi(j) == h);
+  }
+  for (size_t i = 0; i != rows; ++i) {
+    double s = 0, l = m(i, 0);
+    for (size_t j = 0; j != cols; ++j) {
+      s += m(i, j);
+      l = std::min(l, m(i, j));
+    }
+    assert(s1(i) == s && lo(i) == l);
+  }
+}
+
+void
+check_3d()
+{
+  matrix<int, 3> m(2, 3, 4);
+  int n = 0;
+  for (auto& x : m)
+    x = n++;
+
+  matrix<int, 2> a = sum(m, axis(0));
+  matrix<int, 2> b = sum(m, axis(1));
+  matrix<int, 2> c = sum(m, axis(2));
+  assert(a.extent(0) == 3 && a.extent(1) == 4);
+  assert(b.extent(0) == 2 && b.extent(1) == 4);
+  assert(c.extent(0) == 2 && c.extent(1) == 3);
+  for (size_t i = 0; i != 2; ++i)
+    for (size_t j = 0; j != 3; ++j)
+      for (size_t k = 0; k != 4; ++k) {
+        assert(a(j, k) == m(0, j, k) + m(1, j, k));
+        assert(b(i, k) == m(i, 0, k) + m(i, 1, k) + m(i, 2, k));
+      }
+  assert(c(1, 2) == 20 + 21 + 22 + 23);
+}
+
+void
+check_broadcast()
+{
+  matrix<double, 2> m {{1, 2, 3}, {5, 6, 7}};
+  matrix<double, 1> mu = mean(m, axis(0));
+  assert((mu == matrix<double, 1> {3.0, 4.0, 5.0}));
+
+  // Center the columns.
+  matrix<double, 2> c = m - broadcast(mu, m);
+  matrix<double, 2> x {{-2, -2, -2}, {2, 2, 2}};
+  assert(c == x);
+
+  // An extent of 1 is repeated: subtract the mean of each row.
+  matrix<double, 2> r(2, 1);
+  r(0, 0) = 2;
+  r(1, 0) = 6;
+  matrix<double, 2> d = m - broadcast(r, m);
+  matrix<double, 2> y {{-1, 0, 1}, {-1, 0, 1}};
+  assert(d == y);
+
+  // Broadcasting across a 3D matrix, and into compound assignment.
+  matrix<int, 3> t(2, 2, 3);
+  matrix<int, 1> v {1, 2, 3};
+  t += broadcast(v, t);
+  assert(t(1, 1, 2) == 3 && t(0, 1, 0) == 1);
+  assert(sum(sum(t, axis(0)), axis(0))(2) == 12);
+}
+
+int main()
+{
+  check_2d();
+  check_vector();
+  check_3d();
+  check_broadcast();
+}
@@ -5,9 +5,57 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <cassert>
+
 #include <origin/math/matrix/matrix.hpp>
 
+using namespace std;
+using namespace origin;
+
+// Check that a dense_ref and a matrix_ref over the same 2D elements refer
+// to the same elements.
+template <typename D, typename R>
+  void check_same(const D& d, const R& r)
+  {
+    assert(d.rows() == r.rows() && d.cols() == r.cols());
+    for (size_t i = 0; i != r.rows(); ++i)
+      for (size_t j = 0; j != r.cols(); ++j)
+        assert(&d(i, j) == &r(i, j));
+  }
 
 int main()
 {
-}
\ No newline at end of file
+  matrix<double, 2> m(5, 7);
+  for (size_t i = 0; i != m.size(); ++i)
+    m.data()[i] = i;
+
+  // A matrix.
+  auto d = dense(m);
+  check_same(d, m);
+  d(2, 3) = -1;
+  assert(m(2, 3) == -1);
+  assert(d.stride(0) == 7 && d.stride(1) == 1);
+
+  // A row slice of a matrix.
+  matrix_ref<double, 2> r = m(slice(1, 3), slice(2, 4));
+  check_same(dense(r), r);
+  for (size_t j = 0; j != r.cols(); ++j)
+    assert(&dense(r)[1](j) == &r(1, j));
+
+  // A const matrix, and conversion back to a matrix_ref.
+  const matrix<double, 2>& c = m;
+  dense_ref<const double, 2> cd = dense(c);
+  matrix_ref<const double, 2> cr = cd;
+  check_same(cd, cr);
+  assert(cr == c);
+
+  // Higher orders.
+  matrix<int, 3> t(3, 4, 5);
+  dense_ref<int, 3> dt = t;
+  for (size_t i = 0; i != 3; ++i)
+    for (size_t j = 0; j != 4; ++j)
+      for (size_t k = 0; k != 5; ++k) {
+        assert(&dt(i, j, k) == &t(i, j, k));
+        assert(&dt[i](j, k) == &t(i, j, k));
+      }
+}
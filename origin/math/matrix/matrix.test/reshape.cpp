@@ -0,0 +1,130 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <stdexcept>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename M>
+  void
+  iota(M& m)
+  {
+    int k = 0;
+    for (int& x : m)
+      x = k++;
+  }
+
+void
+check_reshape()
+{
+  matrix<int, 3> m(4, 5, 6);
+  iota(m);
+
+  auto r = reshape<2>(m, 20, 6);
+  assert(r.extent(0) == 20 && r.extent(1) == 6);
+  for (size_t i = 0; i != 4; ++i)
+    for (size_t j = 0; j != 5; ++j)
+      for (size_t k = 0; k != 6; ++k)
+        assert(&r(i * 5 + j, k) == &m(i, j, k));
+
+  // The view refers to the original elements.
+  r(19, 5) = -1;
+  assert(m(3, 4, 5) == -1);
+
+  // Splitting, with dimensions of extent 1.
+  auto v = reshape<1>(m, 120);
+  auto s = reshape<4>(v, 2, 1, 60, 1);
+  assert(s(1, 0, 59, 0) == -1 && s(1, 0, 0, 0) == 60);
+
+  const matrix<int, 3>& c = m;
+  matrix_ref<const int, 2> cr = reshape<2>(c, 4, 30);
+  assert(cr(1, 0) == 30);
+
+  // The columns of a slice are contiguous, but its rows are not.
+  matrix<int, 2> a(6, 8);
+  iota(a);
+  auto b = a(slice(1, 4), slice(2, 6));
+  auto split = reshape<3>(b, 4, 2, 3);
+  assert(&split(3, 1, 2) == &a(4, 7));
+  auto rows = reshape<3>(b, 2, 2, 6);
+  assert(&rows(1, 1, 5) == &a(4, 7) && &rows(0, 1, 0) == &a(2, 2));
+  try {
+    reshape<1>(b, 24);
+    assert(false);
+  } catch (invalid_argument&) { }
+  try {
+    reshape<2>(m, 7, 7);
+    assert(false);
+  } catch (invalid_argument&) { }
+
+  // The transpose cannot be flattened.
+  try {
+    reshape<1>(transpose(a), 48);
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+void
+check_permute()
+{
+  matrix<int, 3> m(4, 5, 6);
+  iota(m);
+
+  auto p = permute_axes(m, 2, 0, 1);
+  assert(p.extent(0) == 6 && p.extent(1) == 4 && p.extent(2) == 5);
+  for (size_t i = 0; i != 4; ++i)
+    for (size_t j = 0; j != 5; ++j)
+      for (size_t k = 0; k != 6; ++k)
+        assert(&p(k, i, j) == &m(i, j, k));
+
+  // Permuting back.
+  auto q = permute_axes(p, 1, 2, 0);
+  assert(q == m);
+
+  matrix<int, 2> a(3, 4);
+  iota(a);
+  assert(permute_axes(a, 1, 0) == transpose(a));
+
+  try {
+    permute_axes(m, 0, 1, 1);
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+void
+check_diagonal()
+{
+  matrix<int, 2> a(4, 6);
+  iota(a);
+  auto d = diag(a);
+  assert((d == matrix<int, 1> {0, 7, 14, 21}));
+  d(2) = -1;
+  assert(a(2, 2) == -1);
+
+  matrix<int, 3> m(3, 3, 3);
+  iota(m);
+  assert((diag(m) == matrix<int, 1> {0, 13, 26}));
+
+  // The diagonal of a slice.
+  auto b = a(slice(1, 3), slice(2, 3));
+  assert((diag(b) == matrix<int, 1> {8, 15, 22}));
+
+  const matrix<int, 2>& c = a;
+  matrix_ref<const int, 1> cd = diag(c);
+  assert(cd(2) == -1);
+}
+
+int main()
+{
+  check_reshape();
+  check_permute();
+  check_diagonal();
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <limits>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Compute out (+) a (*) b over the semiring r using the textbook algorithm.
+template <typename T, typename R>
+  matrix<T, 2>
+  reference_product(const matrix<T, 2>& a, const matrix<T, 2>& b,
+                    matrix<T, 2> out, R)
+  {
+    for (size_t i = 0; i < a.rows(); ++i)
+      for (size_t j = 0; j < b.cols(); ++j)
+        for (size_t k = 0; k < a.cols(); ++k)
+          out(i, j) = R::plus(out(i, j), R::times(a(i, k), b(k, j)));
+    return out;
+  }
+
+// Returns an m x n matrix of small values, with the semiring zero wherever
+// (i * 7 + j * 3 + seed) % d == 0.
+template <typename T, typename R>
+  matrix<T, 2>
+  sparse_fill(size_t m, size_t n, int seed, int d, R)
+  {
+    matrix<T, 2> x(m, n);
+    for (size_t i = 0; i != m; ++i)
+      for (size_t j = 0; j != n; ++j) {
+        int h = int(i * 7 + j * 3) + seed;
+        x(i, j) = h % d == 0 ? R::template zero<T>() : T(h % 5 + 1);
+      }
+    return x;
+  }
+
+// The blocked product (large), the dense product (small) and the strided
+// product (a column slice) agree with the textbook product.
+template <typename T, typename R>
+  void
+  check_semiring(R r)
+  {
+    for (size_t n : {5, 17, 100, 150}) {
+      matrix<T, 2> a = sparse_fill<T>(n, n + 3, 1, 4, r);
+      matrix<T, 2> b = sparse_fill<T>(n + 3, n - 2, 2, 3, r);
+      matrix<T, 2> c = sparse_fill<T>(n, n - 2, 3, 2, r);
+      matrix<T, 2> expect = reference_product(a, b, c, r);
+      matrix_product(a, b, c, r);
+      assert(c == expect);
+    }
+
+    matrix<T, 2> a = sparse_fill<T>(9, 9, 4, 3, r);
+    matrix<T, 2> b = sparse_fill<T>(9, 9, 5, 3, r);
+    auto as = a(slice(0, 9), slice(0, 5, 2));
+    auto bs = b(slice(0, 5, 2), slice::all);
+    matrix<T, 2> c(9, 9);
+    c = R::template zero<T>();
+    matrix<T, 2> expect = reference_product(matrix<T, 2>(as),
+                                            matrix<T, 2>(bs), c, r);
+    matrix_product(as, bs, c, r);
+    assert(c == expect);
+  }
+
+void
+test_products()
+{
+  check_semiring<double>(min_plus{});
+  check_semiring<float>(max_plus{});
+  check_semiring<int>(min_plus{});
+  check_semiring<double>(max_times{});
+  check_semiring<int>(or_and{});
+
+  // The default semiring is the arithmetic product.
+  matrix<double, 2> a {{1, 2}, {3, 4}};
+  matrix<double, 2> c(2, 2);
+  matrix_product(a, a, c, plus_times{});
+  assert((c == matrix<double, 2>{{7, 10}, {15, 22}}));
+}
+
+void
+test_closure()
+{
+  // All pairs shortest paths of a directed ring of 40 vertices with one
+  // shortcut, with unit weights.
+  const size_t n = 40;
+  const double inf = numeric_limits<double>::infinity();
+  matrix<double, 2> w(n, n);
+  w = inf;
+  for (size_t i = 0; i != n; ++i)
+    w(i, (i + 1) % n) = 1;
+  w(0, 20) = 3;
+  matrix<double, 2> d = semiring_closure(w, min_plus{});
+  for (size_t i = 0; i != n; ++i)
+    for (size_t j = 0; j != n; ++j) {
+      double ring = double((j + n - i) % n);
+      double cut = double((n - i) % n) + 3 + double((j + n - 20) % n);
+      assert(d(i, j) == min(ring, cut));
+    }
+
+  // The reflexive transitive closure of two disjoint cycles.
+  matrix<int, 2> g(6, 6);
+  g(0, 1) = g(1, 2) = g(2, 0) = 1;
+  g(3, 4) = g(4, 3) = 1;
+  matrix<int, 2> t = semiring_closure(g, or_and{});
+  for (size_t i = 0; i != 6; ++i)
+    for (size_t j = 0; j != 6; ++j)
+      assert(t(i, j) == ((i < 3 && j < 3) || (i >= 3 && i < 5 && j >= 3
+                                                && j < 5) || i == j));
+}
+
+int main()
+{
+  test_products();
+  test_closure();
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using M = matrix<double, 2>;
+using S = shared_matrix<double, 2>;
+
+// Returns the sum of the elements of m, read through a const reference so
+// that the buffer is not detached.
+double
+sum(const S& m)
+{
+  double s = 0;
+  for (double x : m)
+    s += x;
+  return s;
+}
+
+int main()
+{
+  M m(100, 50);
+  for (size_t i = 0; i != m.size(); ++i)
+    m.data()[i] = i;
+  const double* p = m.data();
+
+  // The elements of an rvalue matrix are moved into the buffer.
+  S a(move(m));
+  assert(a.get().data() == p);
+  assert(!a.shared());
+
+  // Copies share the buffer until one of them is modified.
+  S b = a;
+  const S& cb = b;
+  assert(a.shared() && b.use_count() == 2);
+  assert(cb.data() == p);
+  assert(cb(3, 4) == 154);
+  b(3, 4) = -1;
+  assert(!a.shared() && !b.shared());
+  assert(a(3, 4) == 154 && b(3, 4) == -1);
+  assert(a.get().data() == p && b.get().data() != p);
+
+  // A modification of an unshared buffer does not copy.
+  const double* q = b.get().data();
+  b *= 2.0;
+  b.row(0) = 0.0;
+  assert(b.get().data() == q);
+  assert(b(1, 0) == 100);
+
+  // Arithmetic through a snapshot leaves the original unchanged.
+  S c = a.snapshot();
+  c += a;
+  assert(c(3, 4) == 308 && a(3, 4) == 154);
+
+  // Shared matrices are operands of expressions and products.
+  M d = a + a;
+  assert(d == c.get());
+  matrix<double, 2> e(50, 3);
+  e = 1.0;
+  M f = a.get() * e;
+  M g(100, 3);
+  matrix_product(a, e, g);
+  assert(f == g);
+
+  // Readers in other threads see the snapshot, while the writer copies.
+  double expected = sum(a);
+  vector<thread> readers;
+  vector<double> sums(4);
+  for (size_t i = 0; i != sums.size(); ++i) {
+    S snap = a.snapshot();
+    readers.emplace_back([snap, &sums, i]() { sums[i] = sum(snap); });
+  }
+  a = 0.0;
+  for (thread& t : readers)
+    t.join();
+  for (double s : sums)
+    assert(s == expected);
+  assert(sum(a) == 0);
+
+  // Releasing an unshared buffer moves the elements out.
+  const double* r = a.get().data();
+  M h = a.release();
+  assert(h.data() == r && a.size() == 0);
+}
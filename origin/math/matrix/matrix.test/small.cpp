@@ -0,0 +1,78 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using M2 = small_matrix<int, 2, 2>;
+using M3 = small_matrix<double, 3, 3>;
+
+int main()
+{
+  static_assert(Matrix<M2>(), "");
+  static_assert(Same<Value_type<M2>, int>(), "");
+  static_assert(sizeof(M3) == 9 * sizeof(double), "");
+
+  // Constexpr arithmetic.
+  {
+    constexpr M2 r {0, -1,
+                    1,  0};
+    constexpr M2 r2 = r * r;
+    static_assert(r2(0, 0) == -1 && r2(0, 1) == 0, "");
+    static_assert(r2(1, 0) == 0 && r2(1, 1) == -1, "");
+
+    constexpr M2 s = r + r2 * 2 - M2{1, 1, 1, 1};
+    static_assert(s(0, 0) == -3 && s(0, 1) == -2, "");
+    static_assert(s(1, 0) == 0 && s(1, 1) == -3, "");
+
+    constexpr M2 t = -(2 * s) / 2;
+    static_assert(t(0, 0) == 3 && t(1, 1) == 3, "");
+
+    constexpr M2 z;
+    static_assert(z(1, 1) == 0, "");
+  }
+
+  // Non-square products.
+  {
+    constexpr small_matrix<int, 2, 3> a {1, 2, 3,
+                                         4, 5, 6};
+    constexpr small_matrix<int, 3, 1> b {1, 0, -1};
+    constexpr small_matrix<int, 2, 1> c = a * b;
+    static_assert(c(0, 0) == -2 && c(1, 0) == -2, "");
+  }
+
+  // Generic matrix operations.
+  {
+    M3 a {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    assert(rows(a) == 3 && cols(a) == 3);
+    assert(a(2, 1) == 8);
+    assert(a[1](2) == 6);
+    assert(a.col(0)(2) == 7);
+
+    M3 b = a;
+    b *= 2.0;
+    b -= a;
+    assert(a == b);
+
+    stringstream ss;
+    ss << a;
+    assert(ss.str() == "[[1,2,3],[4,5,6],[7,8,9]]");
+
+    // Conversion to a dynamically sized matrix.
+    matrix<double, 2> m = a;
+    assert(m.rows() == 3 && m.cols() == 3);
+    assert(m == a);
+    m = a * a;
+    assert(m(0, 0) == 30 && m(2, 2) == 150);
+  }
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef MATRIX_TEST_SOLVER_HPP
+#define MATRIX_TEST_SOLVER_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include <origin/math/matrix/matrix.hpp>
+
+// Gaussian elimination, written in terms of the matrix operations. The
+// solver is shared by the solver test and the matrix benchmarks.
+namespace solver
+{
+  using namespace std;
+  using namespace origin;
+
+  using Mat = matrix<double, 2>;
+  using Vec = matrix<double, 1>;
+
+  template <typename M1, typename T, typename M2>
+    inline matrix<T, M1::order>
+    scale_and_add(const M1& a, const T& c, const M2& b)
+    {
+      assert(same_extents(a.descriptor(), b.descriptor()));
+
+      matrix<T, M1::order> r(a.descriptor());
+      transform(a.begin(), a.end(), b.begin(), r.begin(), [&](T x, T y) { 
+        return x * c + y; 
+      });
+      return r;
+    }
+
+  // This is intended to wrok for vectors, not matrices.
+  template <typename M1, typename M2>
+  inline double
+  dot_product(const M1& a, const M2& b)
+  {
+    return inner_product(a.begin(), a.end(), b.begin(), 0.0);
+  }
+
+  inline Vec 
+  multiply(const Mat& A, const Vec& x)
+  {
+    const size_t n = A.rows();
+    Vec r(n);
+    for (size_t i = 0; i < n; ++i)
+      r(i) = dot_product(A[i], x);
+    return r;
+  }
+
+
+  inline void
+  eliminate_row(Mat& A, Vec& b, size_t j)
+  {
+    const size_t n = A.rows();
+
+    // Pick the pivot. Make sure it's not 0.
+    double pivot = A(j, j);
+    if (pivot == 0)
+      throw runtime_error("elimination error");
+
+    // Fill zeros into each element under the ith row.
+    for (size_t i = j + 1; i < n; ++i) {
+      double m = A(i, j) / pivot;
+      A[i](slice(j)) = scale_and_add(A[j](slice(j)), -m, A[i](slice(j)));
+      b(i) -= m * b(j);
+    }
+  }
+
+
+  inline void
+  choose_row(Mat& A, Vec& b, size_t j)
+  {
+    const size_t n = A.rows();
+    size_t r = j;
+
+    // Look for a suitable pivot.
+    for (size_t k = j + 1; k < n; ++k) {
+      if (abs(A(k, j)) > abs(A(r, j)))
+        r = j;
+    }
+
+    // Swap rows if we found a better one
+    if (r != j) {
+      A.swap_rows(j, r);
+      swap(b(j), b(r));
+    }
+  }
+
+  inline void
+  classical_elimination(Mat& A, Vec& b)
+  {
+    const size_t n = A.rows();
+    for (size_t j = 0; j < n - 1; ++j)
+      eliminate_row(A, b, j);
+  }
+
+
+  inline void
+  partial_pivoting(Mat& A, Vec& b)
+  {
+    const size_t n = A.rows();
+    for (size_t j = 0; j < n; ++j) {
+      choose_row(A, b, j);
+      eliminate_row(A, b, j);
+    }
+  }
+
+  inline Vec 
+  back_substitution(const Mat& A, const Vec& b)
+  {
+    const size_t n = A.rows();
+    Vec x(n);
+    for (size_t i = n - 1; i < n; --i) {
+      double s = b(i) - dot_product(A[i](slice(i + 1)), x(slice(i + 1)));
+      if (double m = A(i, i))
+        x(i) = s / m;
+      else
+        throw runtime_error("back substitution failure");
+    }
+    return x;
+  }
+
+  inline Vec 
+  classical_guassian_elimination(Mat A, Vec b)
+  {
+    // classical_elimination(A, b);
+    partial_pivoting(A, b);
+    return back_substitution(A, b);
+  }
+
+} // namespace solver
+
+#endif
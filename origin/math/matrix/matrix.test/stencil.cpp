@@ -0,0 +1,171 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <numeric>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the index i of an extent n under the boundary b, or -1 if the
+// element is 0.
+ptrdiff_t
+map_index(ptrdiff_t i, ptrdiff_t n, boundary b)
+{
+  if (i >= 0 && i < n)
+    return i;
+  if (b == boundary::zero)
+    return -1;
+  if (b == boundary::clamp)
+    return i < 0 ? 0 : n - 1;
+  return ((i % n) + n) % n;
+}
+
+// One step of the stencil, computed directly.
+matrix<double, 2>
+naive_step(const stencil<double, 2>& s, const matrix<double, 2>& m,
+           boundary b)
+{
+  ptrdiff_t r = m.rows(), c = m.cols();
+  matrix<double, 2> out(r, c);
+  for (ptrdiff_t i = 0; i != r; ++i)
+    for (ptrdiff_t j = 0; j != c; ++j)
+      for (const auto& e : s) {
+        ptrdiff_t x = map_index(i + e.offset[0], r, b);
+        ptrdiff_t y = map_index(j + e.offset[1], c, b);
+        if (x >= 0 && y >= 0)
+          out(i, j) += e.weight * m(x, y);
+      }
+  return out;
+}
+
+matrix<double, 3>
+naive_step(const stencil<double, 3>& s, const matrix<double, 3>& m,
+           boundary b)
+{
+  ptrdiff_t n0 = m.extent(0), n1 = m.extent(1), n2 = m.extent(2);
+  matrix<double, 3> out(n0, n1, n2);
+  for (ptrdiff_t i = 0; i != n0; ++i)
+    for (ptrdiff_t j = 0; j != n1; ++j)
+      for (ptrdiff_t k = 0; k != n2; ++k)
+        for (const auto& e : s) {
+          ptrdiff_t x = map_index(i + e.offset[0], n0, b);
+          ptrdiff_t y = map_index(j + e.offset[1], n1, b);
+          ptrdiff_t z = map_index(k + e.offset[2], n2, b);
+          if (x >= 0 && y >= 0 && z >= 0)
+            out(i, j, k) += e.weight * m(x, y, z);
+        }
+  return out;
+}
+
+// Fill m with small integers, so that the sums are exact.
+template <typename M>
+  void
+  fill(M& m)
+  {
+    int k = 0;
+    for (double& x : m)
+      x = (k++ * 7) % 5 - 2;
+  }
+
+template <size_t N>
+  void
+  check_steps(const stencil<double, N>& s, const matrix<double, N>& m,
+              size_t steps)
+  {
+    for (boundary b : {boundary::zero, boundary::clamp, boundary::periodic}) {
+      matrix<double, N> expect = m;
+      for (size_t i = 0; i != steps; ++i)
+        expect = naive_step(s, expect, b);
+
+      for (size_t tb : {1, 2, 4}) {
+        stencil_options opts;
+        opts.edge = b;
+        opts.time_block = tb;
+        matrix<double, N> x = m;
+        run_stencil(s, x, steps, opts);
+        assert(x == expect);
+      }
+
+      stencil_options opts;
+      opts.edge = b;
+      matrix<double, N> out(m.descriptor());
+      apply_stencil(s, m, out, opts);
+      assert(out == naive_step(s, m, b));
+    }
+  }
+
+void
+check_2d()
+{
+  stencil<double, 2> s = laplacian_stencil<double, 2>();
+  assert(s.size() == 5);
+  assert(s.radius(0) == 1 && s.radius(1) == 1);
+
+  matrix<double, 2> m(13, 21);
+  fill(m);
+  check_steps(s, m, 5);
+
+  // An asymmetric stencil with a larger radius.
+  stencil<double, 2> a {
+    {{0, 0}, 1}, {{-2, 1}, 2}, {{1, -3}, -1}, {{0, 2}, 1}
+  };
+  assert(a.radius(0) == 2 && a.radius(1) == 3);
+  check_steps(a, m, 3);
+
+  // A matrix narrower than the stencil.
+  matrix<double, 2> t(9, 3);
+  fill(t);
+  check_steps(a, t, 2);
+
+  // A matrix large enough to be computed in parallel tiles.
+  matrix<double, 2> big(300, 200);
+  fill(big);
+  check_steps(s, big, 6);
+}
+
+void
+check_3d()
+{
+  stencil<double, 3> s = laplacian_stencil<double, 3>();
+  assert(s.size() == 7);
+  matrix<double, 3> m(6, 7, 9);
+  fill(m);
+  check_steps(s, m, 4);
+}
+
+void
+check_interior()
+{
+  matrix<double, 2> m(5, 6);
+  stencil<double, 2> s {{{0, 0}, 1}, {{1, 0}, 1}, {{0, -2}, 1}};
+  auto in = stencil_interior(m, s);
+  assert(in.extent(0) == 3 && in.extent(1) == 2);
+  assert(in.size() == 6);
+  assert(&in(0, 0) == &m(1, 2));
+  in = 1;
+  assert(accumulate(m.begin(), m.end(), 0.0) == 6);
+
+  const matrix<double, 2>& c = m;
+  auto ci = stencil_interior(c, s);
+  assert(&ci(2, 1) == &m(3, 3));
+
+  // The interior of a matrix smaller than the stencil is empty.
+  matrix<double, 2> e(2, 6);
+  assert(stencil_interior(e, s).size() == 0);
+}
+
+int
+main()
+{
+  check_2d();
+  check_3d();
+  check_interior();
+}
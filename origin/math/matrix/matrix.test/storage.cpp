@@ -0,0 +1,177 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <origin/memory/numa.hpp>
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename T>
+  bool is_aligned(const T* p)
+  {
+    return reinterpret_cast<std::uintptr_t>(p) % 64 == 0;
+  }
+
+int main()
+{
+  // Elements are aligned on a cache line by default.
+  {
+    for (size_t n = 1; n < 20; ++n) {
+      matrix<double, 2> m(n, n + 1);
+      assert(is_aligned(m.data()));
+      for (double x : m)
+        assert(x == 0);
+
+      matrix<char, 1> v(n);
+      assert(is_aligned(v.data()));
+    }
+  }
+
+  // Copies, moves, and initializer lists preserve alignment.
+  {
+    matrix<float, 2> a {{1, 2, 3}, {4, 5, 6}};
+    assert(is_aligned(a.data()));
+    assert(a(1, 2) == 6);
+
+    matrix<float, 2> b = a;
+    assert(is_aligned(b.data()));
+    assert(b == a);
+
+    matrix<float, 2> c = std::move(b);
+    assert(is_aligned(c.data()));
+    assert(c == a);
+
+    matrix<float, 2> d = a(slice(1), slice(1, 2));
+    assert(is_aligned(d.data()));
+    assert(d.rows() == 1 && d.cols() == 2);
+    assert(d(0, 0) == 5 && d(0, 1) == 6);
+  }
+
+  // Uninitialized construction.
+  {
+    matrix<int, 2> m(uninitialized, 3, 4);
+    assert(m.rows() == 3 && m.cols() == 4);
+    assert(is_aligned(m.data()));
+    m = 7;
+    for (int x : m)
+      assert(x == 7);
+  }
+
+  // Construction from element buffers.
+  {
+    set_product_threads(4);
+    vector<double> v(600 * 500);
+    for (size_t i = 0; i != v.size(); ++i)
+      v[i] = double(i);
+    matrix<double, 2> a(copy_elements, v.data(), 600, 500);
+    assert(is_aligned(a.data()));
+    assert(a(0, 1) == 1 && a(599, 499) == double(v.size() - 1));
+
+    // A copy of more than 8 MiB is written with non-temporal stores.
+    matrix<double, 2> big(generate_elements, [](size_t i, size_t j) {
+      return double(i * 1000 + j);
+    }, 1100, 1000);
+    matrix<double, 2> copy = big;
+    assert(copy.data() != big.data() && copy == big);
+
+    matrix<string, 1> s(copy_elements, vector<string>{"a", "b"}.data(), 2);
+    assert(s(1) == "b");
+
+    double* p = aligned_allocator<double>().allocate(6);
+    for (size_t i = 0; i != 6; ++i)
+      p[i] = double(i);
+    matrix<double, 2> b(adopt_elements, p, 2, 3);
+    assert(b.data() == p && b(1, 2) == 5);
+
+    // Large matrices are generated in parallel, small ones serially.
+    matrix<double, 3> c(generate_elements, [](size_t i, size_t j, size_t k) {
+      return double(i * 10000 + j * 100 + k);
+    }, 40, 50, 60);
+    assert(is_aligned(c.data()));
+    for (size_t i = 0; i != 40; ++i)
+      for (size_t j = 0; j != 50; ++j)
+        for (size_t k = 0; k != 60; ++k)
+          assert(c(i, j, k) == double(i * 10000 + j * 100 + k));
+
+    matrix<int, 1> d(generate_elements, [](size_t i) { return int(i * i); }, 5);
+    assert((d == matrix<int, 1>{0, 1, 4, 9, 16}));
+
+    matrix<int, 2> e(uninitialized, matrix_slice<2>(0, {3, 2}));
+    assert(e.rows() == 3 && e.cols() == 2);
+    set_product_threads(0);
+  }
+
+  // Using a different allocator.
+  {
+    using A = std::allocator<int>;
+    using M = matrix<int, 2, A>;
+    static_assert(Same<M::allocator_type, A>(), "");
+
+    M a {{1, 2}, {3, 4}};
+    M b(2, 2);
+    b = a + a;
+    assert(b(1, 1) == 8);
+
+    // Matrices with different allocators can be combined.
+    matrix<int, 2> c = b - a;
+    assert(c == a);
+
+    M d(A{});
+    assert(d.size() == 0);
+    d = c;
+    assert(d == a);
+  }
+
+  // First touch initialization zeroes the elements in parallel.
+  {
+    set_product_threads(4);
+    matrix<double, 2> m(first_touch, 300, 700);
+    assert(m.rows() == 300 && m.cols() == 700);
+    assert(is_aligned(m.data()));
+    for (double x : m)
+      assert(x == 0);
+
+    matrix<float, 1> e(first_touch, 0);
+    assert(e.size() == 0);
+    set_product_threads(0);
+  }
+
+  // Matrices can be placed over the memory nodes.
+  {
+    using A = numa_allocator<double>;
+    using M = matrix<double, 2, A>;
+    M a(first_touch, 500, 500);
+    assert(a.get_allocator().policy() == numa_policy::first_touch);
+    for (double x : a)
+      assert(x == 0);
+
+    M b(first_touch, matrix_slice<2>(0, {20, 30}), A::interleaved());
+    assert(b.get_allocator().policy() == numa_policy::interleave);
+    assert(b.rows() == 20 && b(19, 29) == 0);
+
+    M c(matrix_slice<2>(0, {2, 2}), A::bound(numa_nodes() - 1));
+    c = 3;
+    M d = c + c;
+    assert(d(1, 1) == 6);
+  }
+
+  // Matrices hold exactly their elements.
+  {
+    matrix<double, 2> m(30, 40);
+    memory_footprint f = m.memory_usage();
+    assert(f.live == 1200 * sizeof(double) && f.slack() == 0);
+    matrix<int, 2> e;
+    assert(e.memory_usage().reserved == 0);
+  }
+}
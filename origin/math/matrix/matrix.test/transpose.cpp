@@ -0,0 +1,106 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename M1, typename M2>
+  bool is_transpose(const M1& a, const M2& b)
+  {
+    if (a.rows() != b.cols() || a.cols() != b.rows())
+      return false;
+    for (size_t i = 0; i != a.rows(); ++i)
+      for (size_t j = 0; j != a.cols(); ++j)
+        if (a(i, j) != b(j, i))
+          return false;
+    return true;
+  }
+
+void
+test_view()
+{
+  matrix<int, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+
+  auto t = transpose(m);
+  assert(t.rows() == 3);
+  assert(t.cols() == 2);
+  assert(t.size() == 6);
+  assert(is_transpose(m, t));
+
+  // The view refers to the original elements.
+  t(2, 0) = 10;
+  assert(m(0, 2) == 10);
+
+  // Iteration visits the transposed elements in row-major order. The limit
+  // of the view is not the address of any element.
+  assert(distance(t.begin(), t.end()) == 6);
+  matrix<int, 2> u {
+    {1, 4},
+    {2, 5},
+    {10, 6}
+  };
+  assert(t == u);
+
+  // The transpose of a const matrix is read-only.
+  const matrix<int, 2>& c = m;
+  matrix_ref<const int, 2> ct = transpose(c);
+  assert(ct == u);
+
+  // Transposing a view twice yields the original.
+  assert(transpose(t) == m);
+
+  // Transposing a submatrix.
+  auto s = transpose(m(slice(0, 2), slice(1, 2)));
+  assert(s.rows() == 2);
+  assert(s.cols() == 2);
+  assert(s(0, 0) == 2 && s(0, 1) == 5);
+  assert(s(1, 0) == 10 && s(1, 1) == 6);
+}
+
+void
+test_copy(size_t m, size_t n)
+{
+  matrix<int, 2> a(m, n);
+  int k = 0;
+  for (int& x : a)
+    x = k++;
+
+  matrix<int, 2> b(n, m);
+  transpose_into(a, b);
+  assert(is_transpose(a, b));
+
+  // Copying from a transposed view restores the original.
+  matrix<int, 2> c(m, n);
+  transpose_into(transpose(a), c);
+  assert(c == a);
+
+  // Copying into a submatrix.
+  matrix<int, 2> d(n + 2, m + 2);
+  auto r = d(slice(1, n), slice(1, m));
+  transpose_into(a, r);
+  assert(is_transpose(a, r));
+  assert(d(0, 0) == 0 && d(n + 1, m + 1) == 0);
+}
+
+int main()
+{
+  test_view();
+
+  test_copy(1, 1);
+  test_copy(3, 7);
+  test_copy(64, 64);
+  test_copy(100, 33);
+  test_copy(257, 513);
+}
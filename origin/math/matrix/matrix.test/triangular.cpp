@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+default_random_engine eng;
+uniform_real_distribution<> dist(-1, 1);
+
+template <typename M>
+  void randomize(M& m)
+  {
+    for (auto& x : m)
+      x = dist(eng);
+  }
+
+// Returns the largest absolute difference between elements of a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    auto i = b.begin();
+    for (double x : a)
+      e = max(e, abs(x - *i++));
+    return e;
+  }
+
+// Returns a random n x n matrix whose triangle t, with a dominant diagonal,
+// is copied to tri. The other triangle, and the diagonal if it is a unit
+// diagonal, hold values that the solves must not read.
+Mat triangular(size_t n, triangle t, bool unit, Mat& tri)
+{
+  Mat a(n, n);
+  randomize(a);
+  tri = Mat(n, n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      if (t == triangle::lower ? j < i : j > i) {
+        a(i, j) /= n;
+        tri(i, j) = a(i, j);
+      }
+    }
+    a(i, i) = unit ? 100 : 2 + dist(eng) / 2;
+    tri(i, i) = unit ? 1 : a(i, i);
+  }
+  return a;
+}
+
+// Solve T * X = B for a random X with m columns, and check that the
+// solution is reproduced.
+void check_trsm(size_t n, size_t m, triangle t, bool unit)
+{
+  Mat tri;
+  Mat a = triangular(n, t, unit, tri);
+  Mat x(n, m);
+  randomize(x);
+  Mat b = tri * x;
+  trsm(a, t, b, unit ? diagonal::unit : diagonal::non_unit);
+  assert(max_error(x, b) < 1e-10);
+}
+
+int main()
+{
+  // Sizes smaller than, equal to, and spanning several blocks.
+  for (size_t n : {1, 5, 64, 150, 300}) {
+    check_trsm(n, 1, triangle::lower, false);
+    check_trsm(n, 9, triangle::lower, false);
+    check_trsm(n, 9, triangle::lower, true);
+    check_trsm(n, 1, triangle::upper, false);
+    check_trsm(n, 9, triangle::upper, false);
+    check_trsm(n, 9, triangle::upper, true);
+  }
+
+  // A vector, a strided column, and the transpose of the triangle.
+  {
+    size_t n = 200;
+    Mat tri;
+    Mat a = triangular(n, triangle::upper, false, tri);
+    Vec x(n);
+    randomize(x);
+
+    Vec b(n);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        b(i) += tri(i, j) * x(j);
+    trsv(a, triangle::upper, b);
+    assert(max_error(x, b) < 1e-10);
+
+    Mat c(n, 3);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        c(i, 1) += tri(i, j) * x(j);
+    trsv(a, triangle::upper, c.col(1));
+    for (size_t i = 0; i < n; ++i)
+      assert(abs(c(i, 1) - x(i)) < 1e-10);
+
+    // The transpose of an upper triangle is lower triangular.
+    Mat y(n, 4);
+    randomize(y);
+    Mat tt(n, n);
+    transpose_into(tri, tt);
+    Mat d = tt * y;
+    trsm(transpose(a), triangle::lower, d);
+    assert(max_error(y, d) < 1e-10);
+
+    // A right-hand side whose rows are not contiguous.
+    Mat e = tt * y;
+    Mat et(4, n);
+    transpose_into(e, et);
+    trsm(transpose(a), triangle::lower, transpose(et));
+    Mat f(n, 4);
+    transpose_into(et, f);
+    assert(max_error(y, f) < 1e-10);
+  }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+
+// One iteration of a steady-state loop: element-wise arithmetic, a row
+// copy, a product and an LU solve.
+double
+step(const Mat& a, const Mat& b)
+{
+  Mat c = a + b * 2.0;
+  matrix<double, 1> r = c.row(1);
+  Mat p(a.rows(), b.cols());
+  matrix_product(a, c, p);
+  Mat lu = p;
+  for (size_t i = 0; i != lu.rows(); ++i)
+    lu(i, i) += 100.0;
+  vector<size_t> piv;
+  lu_factor(lu, piv);
+  Mat x = c;
+  lu_solve(lu, piv, x);
+  return r(0) + x(0, 0);
+}
+
+int main()
+{
+  assert(!matrix_workspace::current());
+
+  Mat a(80, 80);
+  Mat b(80, 80);
+  for (size_t i = 0; i != a.size(); ++i) {
+    a.data()[i] = double(i % 13) / 13;
+    b.data()[i] = double(i % 7) / 7;
+  }
+  double expected = step(a, b);
+
+  {
+    matrix_workspace ws;
+    assert(matrix_workspace::current() == &ws);
+
+    // After the first iteration, every array is drawn from the cache.
+    assert(step(a, b) == expected);
+    size_t misses = ws.misses();
+    assert(misses != 0 && ws.cached() != 0);
+    for (int i = 0; i != 5; ++i)
+      assert(step(a, b) == expected);
+    assert(ws.misses() == misses);
+    assert(ws.hits() != 0);
+
+    // Nested workspaces replace the outer one until they are destroyed.
+    {
+      matrix_workspace inner(0);
+      assert(matrix_workspace::current() == &inner);
+      assert(step(a, b) == expected);
+      assert(inner.cached() == 0);
+    }
+    assert(matrix_workspace::current() == &ws);
+
+    // A matrix may outlive the workspace from which it was drawn.
+    Mat* escaped = new Mat(a);
+    ws.release();
+    assert(ws.cached() == 0);
+    assert(*escaped == a);
+    delete escaped;
+    assert(ws.cached() == a.size() * sizeof(double));
+  }
+  assert(!matrix_workspace::current());
+}
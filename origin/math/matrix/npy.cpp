@@ -0,0 +1,290 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cctype>
+
+#include <istream>
+
+#include "npy.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                              NumPy Header
+
+  namespace
+  {
+    const char npy_magic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+    // The length of the magic string and the version, which are followed by
+    // the length of the header.
+    constexpr std::size_t npy_preamble = 8;
+
+    // The elements are aligned to this many bytes.
+    constexpr std::size_t npy_alignment = 64;
+
+    // Throws an exception indicating that the file is not a .npy file.
+    [[noreturn]] void
+    invalid_npy(const char* what)
+    {
+      throw std::runtime_error(std::string("npy: invalid header: ") + what);
+    }
+
+    // Returns the little endian integer of n bytes at p.
+    inline std::size_t
+    read_le(const char* p, std::size_t n)
+    {
+      std::size_t x = 0;
+      for (std::size_t i = n; i-- != 0; )
+        x = (x << 8) | static_cast<unsigned char>(p[i]);
+      return x;
+    }
+
+    // Returns the length in bytes of the header length of the version.
+    std::size_t
+    length_size(const char* p)
+    {
+      if (std::memcmp(p, npy_magic, sizeof(npy_magic)) != 0)
+        invalid_npy("bad magic string");
+      if (p[6] == 1)
+        return 2;
+      if (p[6] == 2 || p[6] == 3)
+        return 4;
+      invalid_npy("unsupported version");
+    }
+
+    // A parser of the dictionary literal of the header, e.g.:
+    //
+    //    {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+    struct dict_parser
+    {
+      dict_parser(const char* f, const char* l)
+        : first(f), last(l)
+      { }
+
+      bool
+      is(int (*f)(int)) const
+      {
+        return first != last && f(static_cast<unsigned char>(*first));
+      }
+
+      void
+      space()
+      {
+        while (is(std::isspace))
+          ++first;
+      }
+
+      // Consume c, if it is the next character.
+      bool
+      accept(char c)
+      {
+        space();
+        if (first != last && *first == c) {
+          ++first;
+          return true;
+        }
+        return false;
+      }
+
+      void
+      expect(char c)
+      {
+        if (!accept(c))
+          invalid_npy("malformed dictionary");
+      }
+
+      std::string
+      string()
+      {
+        space();
+        if (first == last || (*first != '\'' && *first != '"'))
+          invalid_npy("expected a string");
+        char q = *first++;
+        const char* p = first;
+        while (first != last && *first != q)
+          ++first;
+        if (first == last)
+          invalid_npy("unterminated string");
+        return std::string(p, first++);
+      }
+
+      bool
+      boolean()
+      {
+        space();
+        std::size_t n = last - first;
+        if (n >= 4 && std::memcmp(first, "True", 4) == 0) {
+          first += 4;
+          return true;
+        }
+        if (n >= 5 && std::memcmp(first, "False", 5) == 0) {
+          first += 5;
+          return false;
+        }
+        invalid_npy("expected True or False");
+      }
+
+      std::size_t
+      integer()
+      {
+        space();
+        if (!is(std::isdigit))
+          invalid_npy("expected an extent");
+        std::size_t x = 0;
+        while (is(std::isdigit))
+          x = x * 10 + std::size_t(*first++ - '0');
+        accept('L');
+        return x;
+      }
+
+      std::vector<std::size_t>
+      tuple()
+      {
+        std::vector<std::size_t> t;
+        expect('(');
+        while (!accept(')')) {
+          t.push_back(integer());
+          if (!accept(',')) {
+            expect(')');
+            break;
+          }
+        }
+        return t;
+      }
+
+      const char* first;
+      const char* last;
+    };
+
+    // Returns the product of the extents, or throws if it overflows.
+    std::size_t
+    count(const std::vector<std::size_t>& shape)
+    {
+      std::size_t n = 1;
+      for (std::size_t x : shape) {
+        if (x != 0 && n > std::size_t(-1) / x)
+          invalid_npy("the shape is too large");
+        n *= x;
+      }
+      return n;
+    }
+
+  } // namespace
+
+
+  npy_header
+  parse_npy_header(const char* p, std::size_t n)
+  {
+    if (n < npy_preamble + 2)
+      invalid_npy("truncated header");
+    std::size_t k = length_size(p);
+    std::size_t len = read_le(p + npy_preamble, k);
+    std::size_t off = npy_preamble + k;
+    if (n - off < len)
+      invalid_npy("truncated header");
+
+    npy_header h;
+    h.fortran_order = false;
+    h.offset = off + len;
+    bool descr = false, order = false, shape = false;
+    dict_parser d(p + off, p + off + len);
+    d.expect('{');
+    while (!d.accept('}')) {
+      std::string key = d.string();
+      d.expect(':');
+      if (key == "descr") {
+        h.descr = d.string();
+        descr = true;
+      } else if (key == "fortran_order") {
+        h.fortran_order = d.boolean();
+        order = true;
+      } else if (key == "shape") {
+        h.shape = d.tuple();
+        shape = true;
+      } else {
+        invalid_npy("unknown key");
+      }
+      if (!d.accept(',')) {
+        d.expect('}');
+        break;
+      }
+    }
+    if (!descr || !order || !shape)
+      invalid_npy("missing key");
+    count(h.shape);
+    return h;
+  }
+
+  npy_header
+  read_npy_header(std::istream& is)
+  {
+    char pre[npy_preamble + 4];
+    is.read(pre, npy_preamble + 2);
+    npy_impl::check_stream(is, "truncated header");
+    std::size_t k = length_size(pre);
+    if (k == 4) {
+      is.read(pre + npy_preamble + 2, 2);
+      npy_impl::check_stream(is, "truncated header");
+    }
+    std::size_t len = read_le(pre + npy_preamble, k);
+    std::string buf(pre, pre + npy_preamble + k);
+    buf.resize(buf.size() + len);
+    is.read(&buf[npy_preamble + k], len);
+    npy_impl::check_stream(is, "truncated header");
+    return parse_npy_header(buf.data(), buf.size());
+  }
+
+  std::string
+  make_npy_header(const std::string& descr,
+                  const std::vector<std::size_t>& shape)
+  {
+    std::string dict = "{'descr': '" + descr + "', 'fortran_order': False, "
+                       "'shape': (";
+    for (std::size_t i = 0; i != shape.size(); ++i) {
+      if (i != 0)
+        dict += ' ';
+      dict += std::to_string(shape[i]) + ',';
+    }
+    if (shape.size() > 1)
+      dict.pop_back();
+    dict += "), }";
+
+    // The dictionary is padded with spaces and ends in a newline. Version 1
+    // is used unless the length does not fit in 16 bits.
+    std::size_t k = 2;
+    std::size_t total = npy_preamble + k + dict.size() + 1;
+    total = (total + npy_alignment - 1) / npy_alignment * npy_alignment;
+    if (total - npy_preamble - k > 0xffff) {
+      k = 4;
+      total = npy_preamble + k + dict.size() + 1;
+      total = (total + npy_alignment - 1) / npy_alignment * npy_alignment;
+    }
+    std::size_t len = total - npy_preamble - k;
+
+    std::string h(npy_magic, sizeof(npy_magic));
+    h += char(k == 2 ? 1 : 2);
+    h += char(0);
+    for (std::size_t i = 0; i != k; ++i)
+      h += char((len >> (8 * i)) & 0xff);
+    h += dict;
+    h.append(total - h.size() - 1, ' ');
+    h += '\n';
+    return h;
+  }
+
+  namespace npy_impl
+  {
+    void
+    check_stream(const std::ios& s, const char* what)
+    {
+      if (!s)
+        throw std::runtime_error(std::string("npy: ") + what);
+    }
+  } // namespace npy_impl
+
+} // namespace origin
@@ -0,0 +1,322 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_NPY_HPP
+#define ORIGIN_MATH_MATRIX_NPY_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+#include <origin/graph/io.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // NumPy files                                                      [npy.decl]
+  //
+  // Matrices are saved and loaded in the binary .npy format of NumPy, so
+  // that they can be exchanged with NumPy (numpy.save and numpy.load) and
+  // other tools that read it. A .npy file consists of a short header, which
+  // describes the element type (the dtype), the extents (the shape), and
+  // the order of the elements, followed by the elements:
+  //
+  //    write_npy(os, m)          Write the matrix m to the stream os
+  //    read_npy<T, N>(is)        Read a matrix<T, N> from the stream is
+  //    save_npy(path, m)         Write the matrix m to the file path
+  //    load_npy<T, N>(path)      Read a matrix<T, N> from the file path
+  //    npy_file<T, N> f(path)    Map the file path; f.view() is a
+  //                              matrix_ref<const T, N> of its elements
+  //
+  // Matrices are written in row-major (C) order, in the byte order of the
+  // machine. The element type must be an arithmetic type; its dtype is
+  // determined by its kind and size (e.g., '<f8' for double on a little
+  // endian machine). Reading a file requires that its dtype has the kind
+  // and size of T and that its shape has N extents. Files written in the
+  // other byte order are byte-swapped, and files in column-major (Fortran)
+  // order are reordered, as they are read.
+  //
+  // An npy_file maps the file into memory (see [graph.io.file]), so that
+  // opening it takes the same (short) time for any size of file, and the
+  // elements are read from disk as they are first used. The view refers
+  // directly to the mapping, so the file must have the dtype of T exactly,
+  // in row-major order, with its elements aligned for T. An npy_file can be
+  // moved but not copied; its views must not outlive it.
+  //
+  // A std::runtime_error is thrown if a file or stream is not a valid .npy
+  // file of the requested type, if a stream cannot be read or written, and
+  // if a file cannot be created. A std::system_error is thrown if a file
+  // cannot be mapped.
+
+
+  // The header of a .npy file.
+  struct npy_header
+  {
+    std::string              descr;         // The dtype, e.g., "<f8"
+    bool                     fortran_order; // True for column-major order
+    std::vector<std::size_t> shape;         // The extents
+    std::size_t              offset;        // The offset of the elements
+  };
+
+  // Returns the header parsed from the n bytes at p, which start with the
+  // magic string of a .npy file, and must contain the whole header. Throws
+  // std::runtime_error if the header is invalid. See npy.cpp.
+  npy_header parse_npy_header(const char* p, std::size_t n);
+
+  // Read the header of a .npy file from is. See npy.cpp.
+  npy_header read_npy_header(std::istream& is);
+
+  // Returns the bytes of the header of a .npy file with the given dtype and
+  // shape, in row-major order, padded so that the elements are aligned to
+  // 64 bytes. See npy.cpp.
+  std::string make_npy_header(const std::string& descr,
+                              const std::vector<std::size_t>& shape);
+
+
+  namespace npy_impl
+  {
+    // Returns true if the machine is little endian.
+    inline bool
+    little_endian()
+    {
+      const std::uint16_t x = 1;
+      char c;
+      std::memcpy(&c, &x, 1);
+      return c == 1;
+    }
+
+    // Returns the kind of the dtype of T.
+    template <typename T>
+      constexpr char
+      kind()
+      {
+        return std::is_same<T, bool>::value ? 'b'
+             : std::is_floating_point<T>::value ? 'f'
+             : std::is_signed<T>::value ? 'i' : 'u';
+      }
+
+    // Returns the native dtype of T.
+    template <typename T>
+      std::string
+      descr()
+      {
+        static_assert(std::is_arithmetic<T>::value, "");
+        char order = sizeof(T) == 1 ? '|' : little_endian() ? '<' : '>';
+        return order + (kind<T>() + std::to_string(sizeof(T)));
+      }
+
+    // Returns true if the elements described by the dtype d are Ts, and
+    // sets swap if their bytes are not in the order of the machine.
+    template <typename T>
+      bool
+      compatible(const std::string& d, bool& swap)
+      {
+        if (d.empty() || d.substr(1) != descr<T>().substr(1))
+          return false;
+        switch (d[0]) {
+        case '<': swap = sizeof(T) != 1 && !little_endian(); return true;
+        case '>': swap = sizeof(T) != 1 && little_endian(); return true;
+        case '=': case '|': swap = false; return true;
+        default: return false;
+        }
+      }
+
+    // Reverse the bytes of each of the n elements at p.
+    template <typename T>
+      void
+      swap_bytes(T* p, std::size_t n)
+      {
+        for (std::size_t i = 0; i != n; ++i) {
+          char* b = reinterpret_cast<char*>(p + i);
+          std::reverse(b, b + sizeof(T));
+        }
+      }
+
+    // Returns the slice of a row-major matrix with the extents of the shape.
+    template <std::size_t N>
+      matrix_slice<N>
+      shape_slice(const std::vector<std::size_t>& shape)
+      {
+        if (shape.size() != N)
+          throw std::runtime_error("npy: the file has " +
+                                   std::to_string(shape.size()) +
+                                   " extents, expected " + std::to_string(N));
+        return matrix_slice<N>(0, shape);
+      }
+
+    // Copy the n elements at p, which are in column-major order, into the
+    // row-major matrix with the slice s at q.
+    template <typename T, std::size_t N>
+      void
+      from_column_major(const T* p, std::size_t n, const matrix_slice<N>& s,
+                        T* q)
+      {
+        std::size_t idx[N] = {};
+        for (std::size_t k = 0; k != n; ++k) {
+          std::size_t off = 0;
+          for (std::size_t d = 0; d != N; ++d)
+            off += idx[d] * s.strides[d];
+          q[off] = p[k];
+          for (std::size_t d = 0; d != N && ++idx[d] == s.extents[d]; ++d)
+            idx[d] = 0;
+        }
+      }
+
+    // The number of elements buffered when writing a matrix_ref.
+    constexpr std::size_t buffer_size = 1 << 16;
+
+    // Throws std::runtime_error if the stream s has failed.
+    void check_stream(const std::ios& s, const char* what);
+
+  } // namespace npy_impl
+
+
+  // Write the matrix or matrix_ref m to os in the .npy format. Throws
+  // std::runtime_error if os cannot be written.
+  template <typename M>
+    void
+    write_npy(std::ostream& os, const M& m)
+    {
+      using T = Remove_const<Value_type<M>>;
+      static_assert(matrix_impl::Strided_matrix<M>(), "");
+      const matrix_slice<M::order>& s = m.descriptor();
+      std::vector<std::size_t> shape(s.extents, s.extents + M::order);
+      std::string h = make_npy_header(npy_impl::descr<T>(), shape);
+      os.write(h.data(), h.size());
+
+      // The elements of a matrix (and of some matrix_refs) are contiguous,
+      // and are written directly. Those of other matrix_refs are buffered.
+      if (matrix_impl::is_contiguous(s)) {
+        os.write(reinterpret_cast<const char*>(m.data() + s.start),
+                 m.size() * sizeof(T));
+      } else {
+        std::vector<T> buf;
+        buf.reserve(std::min<std::size_t>(m.size(), npy_impl::buffer_size));
+        for (const T& x : m) {
+          buf.push_back(x);
+          if (buf.size() == buf.capacity()) {
+            os.write(reinterpret_cast<const char*>(buf.data()),
+                     buf.size() * sizeof(T));
+            buf.clear();
+          }
+        }
+        os.write(reinterpret_cast<const char*>(buf.data()),
+                 buf.size() * sizeof(T));
+      }
+      npy_impl::check_stream(os, "cannot write the matrix");
+    }
+
+
+  // Read a matrix<T, N> from is in the .npy format.
+  template <typename T, std::size_t N>
+    matrix<T, N>
+    read_npy(std::istream& is)
+    {
+      npy_header h = read_npy_header(is);
+      bool swap;
+      if (!npy_impl::compatible<T>(h.descr, swap))
+        throw std::runtime_error("npy: the file has the dtype " + h.descr +
+                                 ", expected " + npy_impl::descr<T>());
+      matrix_slice<N> s = npy_impl::shape_slice<N>(h.shape);
+      matrix<T, N> m(s);
+      if (!h.fortran_order || N == 1) {
+        is.read(reinterpret_cast<char*>(m.data()), s.size * sizeof(T));
+      } else {
+        std::vector<T> buf(s.size);
+        is.read(reinterpret_cast<char*>(buf.data()), s.size * sizeof(T));
+        npy_impl::from_column_major(buf.data(), s.size, s, m.data());
+      }
+      npy_impl::check_stream(is, "the file is truncated");
+      if (swap)
+        npy_impl::swap_bytes(m.data(), s.size);
+      return m;
+    }
+
+
+  // A read-only memory mapping of a .npy file of elements of type T and
+  // order N.
+  template <typename T, std::size_t N>
+    class npy_file
+    {
+    public:
+      explicit npy_file(const std::string& path,
+                        io::map_mode m = io::map_mode::paged);
+
+      // Observers
+      const npy_header& header() const { return header_; }
+
+      // Returns the extents of the matrix.
+      std::size_t extent(std::size_t d) const { return slice_.extents[d]; }
+      std::size_t size() const { return slice_.size; }
+
+      // Returns a view of the elements of the file.
+      matrix_ref<const T, N> view() const { return {slice_, data()}; }
+
+      // Returns a pointer to the first element.
+      const T* data() const
+      {
+        return reinterpret_cast<const T*>(file_.data() + header_.offset);
+      }
+
+    private:
+      io::mapped_file file_;
+      npy_header header_;
+      matrix_slice<N> slice_;
+    };
+
+  template <typename T, std::size_t N>
+    npy_file<T, N>::npy_file(const std::string& path, io::map_mode m)
+      : file_(path, m), header_(parse_npy_header(file_.data(), file_.size()))
+    {
+      bool swap;
+      if (!npy_impl::compatible<T>(header_.descr, swap) || swap)
+        throw std::runtime_error("npy: the file has the dtype " +
+                                 header_.descr + ", expected " +
+                                 npy_impl::descr<T>());
+      if (header_.fortran_order && N != 1)
+        throw std::runtime_error("npy: cannot map a file in Fortran order");
+      if (header_.offset % alignof(T) != 0)
+        throw std::runtime_error("npy: the elements are not aligned");
+      slice_ = npy_impl::shape_slice<N>(header_.shape);
+      if ((file_.size() - header_.offset) / sizeof(T) < slice_.size)
+        throw std::runtime_error("npy: the file is truncated");
+    }
+
+
+  // Write the matrix or matrix_ref m to the file at path, replacing it.
+  template <typename M>
+    void
+    save_npy(const std::string& path, const M& m)
+    {
+      std::ofstream os(path, std::ios::binary | std::ios::trunc);
+      if (!os)
+        throw std::runtime_error("npy: cannot create " + path);
+      write_npy(os, m);
+    }
+
+  // Read a matrix<T, N> from the file at path.
+  template <typename T, std::size_t N>
+    matrix<T, N>
+    load_npy(const std::string& path)
+    {
+      std::ifstream is(path, std::ios::binary);
+      if (!is)
+        throw std::runtime_error("npy: cannot open " + path);
+      return read_npy<T, N>(is);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,194 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/npy.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns true if f throws a std::runtime_error.
+template <typename F>
+  bool
+  throws(F f)
+  {
+    try {
+      f();
+    } catch (std::runtime_error&) {
+      return true;
+    }
+    return false;
+  }
+
+template <typename T, size_t N, typename M>
+  void
+  check_round_trip(const M& m)
+  {
+    stringstream ss;
+    write_npy(ss, m);
+    string s = ss.str();
+
+    // The elements are aligned to 64 bytes.
+    npy_header h = parse_npy_header(s.data(), s.size());
+    assert(h.offset % 64 == 0);
+    assert(s[h.offset - 1] == '\n');
+    assert(s.size() == h.offset + m.size() * sizeof(T));
+    assert(!h.fortran_order);
+    assert(h.shape.size() == N);
+
+    matrix<T, N> r = read_npy<T, N>(ss);
+    for (size_t d = 0; d != N; ++d)
+      assert(r.extent(d) == m.extent(d));
+    assert(equal(r.begin(), r.end(), m.begin()));
+  }
+
+void
+test_round_trip()
+{
+  matrix<double, 2> a {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  check_round_trip<double, 2>(a);
+
+  // A column of a matrix is not contiguous.
+  check_round_trip<double, 1>(a.col(1));
+  check_round_trip<double, 1>(a.row(1));
+
+  matrix<int, 3> b(2, 3, 4);
+  iota(b.begin(), b.end(), -5);
+  check_round_trip<int, 3>(b);
+  check_round_trip<int, 2>(b[1]);
+
+  matrix<unsigned char, 1> c(3);
+  c(0) = 1;
+  c(2) = 255;
+  check_round_trip<unsigned char, 1>(c);
+
+  matrix<float, 2> e(0, 3);
+  check_round_trip<float, 2>(e);
+
+  // The header describes the type.
+  stringstream ss;
+  write_npy(ss, a);
+  string s = ss.str();
+  assert(s.compare(0, 6, "\x93NUMPY") == 0);
+  assert(s.find("'shape': (2, 3)") != string::npos);
+  assert(s.find("f8', 'fortran_order': False") != string::npos);
+  stringstream sc;
+  write_npy(sc, c);
+  assert(sc.str().find("'descr': '|u1'") != string::npos);
+}
+
+// Returns the bytes of a .npy file with the given header dictionary and
+// elements.
+string
+make_file(string dict, const string& elems)
+{
+  while ((10 + dict.size() + 1) % 16 != 0)
+    dict += ' ';
+  dict += '\n';
+  string s = "\x93NUMPY";
+  s += char(1);
+  s += char(0);
+  s += char(dict.size() & 0xff);
+  s += char(dict.size() >> 8);
+  return s + dict + elems;
+}
+
+void
+test_read()
+{
+  // Elements in the other byte order are swapped. Elements in Fortran order
+  // are reordered.
+  string elems;
+  for (int i = 0; i != 6; ++i) {
+    elems += char(0);
+    elems += char(i + 1);
+  }
+  bool le = npy_impl::little_endian();
+  string other = le ? "'>i2'" : "'<i2'";
+  stringstream f1(make_file("{'descr': " + other + ", 'fortran_order': True"
+                            ", 'shape': (2, 3), }", elems));
+  matrix<short, 2> m = read_npy<short, 2>(f1);
+  assert(m.rows() == 2 && m.cols() == 3);
+  assert(m(0, 0) == 1 && m(1, 0) == 2 && m(0, 1) == 3 && m(1, 2) == 6);
+
+  // The keys may appear in any order.
+  stringstream f2(make_file("{\"shape\": (3,), \"fortran_order\": False, "
+                            "\"descr\": " + other + "}", elems.substr(0, 6)));
+  matrix<short, 1> v = read_npy<short, 1>(f2);
+  assert(v.size() == 3 && v(2) == 3);
+
+  // Invalid files are rejected.
+  assert(throws([]() {
+    stringstream s("not a npy file at all");
+    read_npy<double, 1>(s);
+  }));
+  assert(throws([&]() {
+    stringstream s(make_file("{'descr': '<f4', 'fortran_order': False, "
+                             "'shape': (1,), }", string(4, 0)));
+    read_npy<double, 1>(s);
+  }));
+  assert(throws([&]() {
+    stringstream s(make_file("{'descr': '<i2', 'fortran_order': False, "
+                             "'shape': (1, 1), }", string(2, 0)));
+    read_npy<short, 1>(s);
+  }));
+  assert(throws([&]() {
+    stringstream s(make_file("{'descr': '<i2', 'fortran_order': False, "
+                             "'shape': (4,), }", string(2, 0)));
+    read_npy<short, 1>(s);
+  }));
+  assert(throws([&]() {
+    stringstream s(make_file("{'descr': '<i2', 'shape': (4,), }", ""));
+    read_npy<short, 1>(s);
+  }));
+}
+
+void
+test_files()
+{
+  const string path = "origin.math.matrix.npy.test.npy";
+  matrix<double, 2> a(100, 70);
+  for (size_t i = 0; i != a.rows(); ++i)
+    for (size_t j = 0; j != a.cols(); ++j)
+      a(i, j) = double(i) - 0.5 * double(j);
+  save_npy(path, a);
+  matrix<double, 2> b = load_npy<double, 2>(path);
+  assert(b == a);
+
+  // The mapped file is a view of the elements.
+  {
+    npy_file<double, 2> f(path);
+    assert(f.extent(0) == 100 && f.extent(1) == 70);
+    matrix_ref<const double, 2> v = f.view();
+    assert(v.rows() == 100 && v.cols() == 70);
+    assert(v(7, 3) == a(7, 3));
+    assert(equal(v.begin(), v.end(), a.begin()));
+
+    npy_file<double, 2> g(std::move(f));
+    assert(g.view()(99, 69) == a(99, 69));
+  }
+
+  // The type and order of the mapped file must match.
+  assert(throws([&]() { npy_file<float, 2> f(path); }));
+  assert(throws([&]() { npy_file<double, 1> f(path); }));
+  assert(throws([]() { load_npy<double, 2>("no/such/file.npy"); }));
+  remove(path.c_str());
+}
+
+int main()
+{
+  test_round_trip();
+  test_read();
+  test_files();
+}
@@ -0,0 +1,866 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_SPARSE_HPP
+#define ORIGIN_MATH_MATRIX_SPARSE_HPP
+
+#include <origin/math/matrix/matrix.hpp>
+#include <origin/graph/concepts.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Sparse matrices                                               [sparse.decl]
+  //
+  // The csr_matrix and csc_matrix classes store 2D matrices in compressed
+  // sparse row and compressed sparse column formats. Only the nonzero
+  // elements of the matrix are stored. In the CSR format, the elements of
+  // each row are stored contiguously and sorted by column; the offsets of
+  // row i are [offsets[i], offsets[i + 1]). The CSC format is the same, but
+  // with the roles of rows and columns exchanged.
+  //
+  // Sparse matrices are built from a sequence of (row, column, value)
+  // entries, from a dense matrix, or from the edges of a graph (see
+  // adjacency_matrix and laplacian_matrix). Duplicate entries are summed.
+  //
+  // Sparse matrices can be multiplied by dense vectors (matrix<T, 1>) and
+  // dense matrices (matrix<T, 2>), or any matrix_ref of the same order. The
+  // product of a large CSR matrix with a dense operand is computed in
+  // parallel, over blocks of rows, using the same threads as matrix_product
+  // (see product_threads()). Two CSR matrices are multiplied by spgemm, over
+  // any semiring of the dense product (see [matrix.semiring]).
+  //
+  // NOTE: Sparse matrices do not model the Matrix concept since they cannot
+  // be iterated over like a dense matrix.
+
+  template <typename T> class csr_matrix;
+  template <typename T> class csc_matrix;
+
+
+  // A sparse entry describes a single element of a sparse matrix.
+  template <typename T>
+    struct sparse_entry
+    {
+      std::size_t row;
+      std::size_t col;
+      T value;
+    };
+
+
+  namespace sparse_impl
+  {
+    // The compressed class stores an m x n sparse matrix compressed along
+    // its major dimension (m). For CSR, the major dimension is rows; for
+    // CSC, it is columns.
+    template <typename T>
+      struct compressed
+      {
+        compressed() : major(0), minor(0), offsets(1, 0) { }
+
+        compressed(std::size_t m, std::size_t n)
+          : major(m), minor(n), offsets(m + 1, 0)
+        { }
+
+        // Returns a pointer to the element at (i, j), or nullptr if there is
+        // no such element.
+        const T* find(std::size_t i, std::size_t j) const;
+
+        // Returns the footprint of the compressed arrays.
+        memory_footprint memory_usage() const
+        {
+          return contiguous_footprint(offsets) + contiguous_footprint(indices)
+               + contiguous_footprint(values);
+        }
+
+        void shrink_to_fit()
+        {
+          offsets.shrink_to_fit();
+          indices.shrink_to_fit();
+          values.shrink_to_fit();
+        }
+
+        std::size_t major;
+        std::size_t minor;
+        std::vector<std::size_t> offsets; // Offsets of each major segment
+        std::vector<std::size_t> indices; // Minor index of each element
+        std::vector<T> values;            // The value of each element
+      };
+
+    template <typename T>
+      const T*
+      compressed<T>::find(std::size_t i, std::size_t j) const
+      {
+        auto first = indices.begin() + offsets[i];
+        auto last = indices.begin() + offsets[i + 1];
+        auto iter = std::lower_bound(first, last, j);
+        if (iter == last || *iter != j)
+          return nullptr;
+        return &values[iter - indices.begin()];
+      }
+
+
+    // Compress the entries of an m x n matrix. The major and minor functions
+    // select the major and minor index of each entry. Entries are bucketed
+    // by their major index, each segment is sorted by minor index, and
+    // duplicate entries are summed.
+    template <typename T, typename Major, typename Minor>
+      compressed<T>
+      compress(std::size_t m, std::size_t n,
+               const std::vector<sparse_entry<T>>& entries,
+               Major major, Minor minor)
+      {
+        compressed<T> c(m, n);
+
+        // Count the elements in each major segment.
+        for (const sparse_entry<T>& e : entries) {
+          assert(major(e) < m && minor(e) < n);
+          ++c.offsets[major(e) + 1];
+        }
+        std::partial_sum(c.offsets.begin(), c.offsets.end(), c.offsets.begin());
+
+        // Place each entry in its segment.
+        std::vector<std::pair<std::size_t, T>> elems(entries.size());
+        std::vector<std::size_t> next(c.offsets.begin(), c.offsets.end() - 1);
+        for (const sparse_entry<T>& e : entries)
+          elems[next[major(e)]++] = {minor(e), e.value};
+
+        // Sort each segment and sum its duplicates.
+        using Elem = std::pair<std::size_t, T>;
+        auto less = [](const Elem& a, const Elem& b) {
+          return a.first < b.first;
+        };
+        c.indices.reserve(elems.size());
+        c.values.reserve(elems.size());
+        std::size_t first = 0;
+        for (std::size_t i = 0; i != m; ++i) {
+          std::size_t last = c.offsets[i + 1];
+          std::sort(elems.begin() + first, elems.begin() + last, less);
+          c.offsets[i] = c.indices.size();
+          for (std::size_t k = first; k != last; ++k) {
+            if (k != first && elems[k].first == c.indices.back())
+              c.values.back() += elems[k].second;
+            else {
+              c.indices.push_back(elems[k].first);
+              c.values.push_back(elems[k].second);
+            }
+          }
+          first = last;
+        }
+        c.offsets[m] = c.indices.size();
+        return c;
+      }
+
+    // Returns the compressed form of the transpose of c. When applied to a
+    // CSR matrix, this yields the CSC form of the same matrix, and vice
+    // versa. The minor indexes of the result are sorted.
+    template <typename T>
+      compressed<T>
+      transpose(const compressed<T>& c)
+      {
+        compressed<T> t(c.minor, c.major);
+        for (std::size_t j : c.indices)
+          ++t.offsets[j + 1];
+        std::partial_sum(t.offsets.begin(), t.offsets.end(), t.offsets.begin());
+
+        t.indices.resize(c.indices.size());
+        t.values.resize(c.values.size());
+        std::vector<std::size_t> next(t.offsets.begin(), t.offsets.end() - 1);
+        for (std::size_t i = 0; i != c.major; ++i) {
+          for (std::size_t k = c.offsets[i]; k != c.offsets[i + 1]; ++k) {
+            std::size_t p = next[c.indices[k]]++;
+            t.indices[p] = i;
+            t.values[p] = c.values[k];
+          }
+        }
+        return t;
+      }
+
+    // Collect the nonzero elements of the dense matrix m as entries.
+    template <typename M>
+      std::vector<sparse_entry<Value_type<M>>>
+      nonzero_entries(const M& m)
+      {
+        using T = Value_type<M>;
+        static_assert(M::order == 2, "");
+        std::vector<sparse_entry<T>> entries;
+        for (std::size_t i = 0; i != m.rows(); ++i)
+          for (std::size_t j = 0; j != m.cols(); ++j)
+            if (m(i, j) != T(0))
+              entries.push_back({i, j, m(i, j)});
+        return entries;
+      }
+
+    // Selectors for the row and column of an entry.
+    struct row_of
+    {
+      template <typename T>
+        std::size_t operator()(const sparse_entry<T>& e) const { return e.row; }
+    };
+
+    struct col_of
+    {
+      template <typename T>
+        std::size_t operator()(const sparse_entry<T>& e) const { return e.col; }
+    };
+
+  } // namespace sparse_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Compressed sparse row matrix                                   [sparse.csr]
+  //
+  // Template Parameters:
+  //    T -- The element type stored by the matrix
+  template <typename T>
+    class csr_matrix
+    {
+    public:
+      using value_type = T;
+      using index_vector = std::vector<std::size_t>;
+
+      // Default construction
+      //
+      // Initialize an empty (0 x 0) matrix.
+      csr_matrix() = default;
+
+      // Extent initialization
+      //
+      // Initialize an m x n matrix with no nonzero elements.
+      csr_matrix(std::size_t m, std::size_t n) : data(m, n) { }
+
+      // Entry initialization
+      //
+      // Initialize an m x n matrix from a sequence of entries. Duplicate
+      // entries are summed.
+      csr_matrix(std::size_t m,
+                 std::size_t n,
+                 const std::vector<sparse_entry<T>>& entries);
+
+      // Dense initialization
+      //
+      // Initialize the matrix from the nonzero elements of the 2D dense
+      // matrix m.
+      template <typename M, typename = Requires<Matrix<M>()>>
+        explicit csr_matrix(const M& m);
+
+      // Format conversion
+      explicit csr_matrix(const csc_matrix<T>& x);
+
+      // Compressed initialization
+      //
+      // Initialize an m x n matrix from its row offsets (m + 1 of them),
+      // column indexes and values. The column indexes of each row must be
+      // sorted and unique.
+      csr_matrix(std::size_t m,
+                 std::size_t n,
+                 index_vector offsets,
+                 index_vector indices,
+                 std::vector<T> values);
+
+
+      // Properties
+
+      // Returns the number of rows in the matrix.
+      std::size_t rows() const { return data.major; }
+
+      // Returns the number of columns in the matrix.
+      std::size_t cols() const { return data.minor; }
+
+      // Returns the extent of the matrix in the nth dimension.
+      std::size_t extent(std::size_t n) const { return n ? cols() : rows(); }
+
+      // Returns the number of stored elements.
+      std::size_t nonzeros() const { return data.values.size(); }
+
+      // Returns the footprint of the compressed arrays. See [mem.usage].
+      memory_footprint memory_usage() const { return data.memory_usage(); }
+
+      // Release the unused capacity of the compressed arrays.
+      void shrink_to_fit() { data.shrink_to_fit(); }
+
+
+      // Element access
+      //
+      // Returns the value of the element at (i, j), which is 0 if no element
+      // is stored there.
+      T operator()(std::size_t i, std::size_t j) const;
+
+
+      // Compressed data
+      //
+      // Returns the row offsets, column indexes, and values of the stored
+      // elements.
+      const index_vector& row_offsets() const { return data.offsets; }
+      const index_vector& col_indices() const { return data.indices; }
+      const std::vector<T>& values() const { return data.values; }
+
+      // Returns the values of the stored elements. Assigning a value does not
+      // change the structure of the matrix.
+      std::vector<T>& values() { return data.values; }
+
+    private:
+      friend class csc_matrix<T>;
+
+      sparse_impl::compressed<T> data;
+    };
+
+
+  template <typename T>
+    inline
+    csr_matrix<T>::csr_matrix(std::size_t m,
+                              std::size_t n,
+                              const std::vector<sparse_entry<T>>& entries)
+      : data(sparse_impl::compress(m, n, entries,
+                                   sparse_impl::row_of{},
+                                   sparse_impl::col_of{}))
+    { }
+
+  template <typename T>
+    template <typename M, typename X>
+      inline
+      csr_matrix<T>::csr_matrix(const M& m)
+        : csr_matrix(m.rows(), m.cols(), sparse_impl::nonzero_entries(m))
+      { }
+
+  template <typename T>
+    inline
+    csr_matrix<T>::csr_matrix(const csc_matrix<T>& x)
+      : data(sparse_impl::transpose(x.data))
+    { }
+
+  template <typename T>
+    inline
+    csr_matrix<T>::csr_matrix(std::size_t m,
+                              std::size_t n,
+                              index_vector offsets,
+                              index_vector indices,
+                              std::vector<T> values)
+      : data(m, n)
+    {
+      assert(offsets.size() == m + 1);
+      assert(offsets.back() == indices.size());
+      assert(indices.size() == values.size());
+      data.offsets = std::move(offsets);
+      data.indices = std::move(indices);
+      data.values = std::move(values);
+    }
+
+  template <typename T>
+    inline T
+    csr_matrix<T>::operator()(std::size_t i, std::size_t j) const
+    {
+      assert(i < rows() && j < cols());
+      const T* p = data.find(i, j);
+      return p ? *p : T(0);
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Compressed sparse column matrix                                [sparse.csc]
+  //
+  // Template Parameters:
+  //    T -- The element type stored by the matrix
+  template <typename T>
+    class csc_matrix
+    {
+    public:
+      using value_type = T;
+      using index_vector = std::vector<std::size_t>;
+
+      // Default construction
+      //
+      // Initialize an empty (0 x 0) matrix.
+      csc_matrix() = default;
+
+      // Extent initialization
+      //
+      // Initialize an m x n matrix with no nonzero elements.
+      csc_matrix(std::size_t m, std::size_t n) : data(n, m) { }
+
+      // Entry initialization
+      //
+      // Initialize an m x n matrix from a sequence of entries. Duplicate
+      // entries are summed.
+      csc_matrix(std::size_t m,
+                 std::size_t n,
+                 const std::vector<sparse_entry<T>>& entries);
+
+      // Dense initialization
+      //
+      // Initialize the matrix from the nonzero elements of the 2D dense
+      // matrix m.
+      template <typename M, typename = Requires<Matrix<M>()>>
+        explicit csc_matrix(const M& m);
+
+      // Format conversion
+      explicit csc_matrix(const csr_matrix<T>& x);
+
+
+      // Properties
+
+      // Returns the number of rows in the matrix.
+      std::size_t rows() const { return data.minor; }
+
+      // Returns the number of columns in the matrix.
+      std::size_t cols() const { return data.major; }
+
+      // Returns the extent of the matrix in the nth dimension.
+      std::size_t extent(std::size_t n) const { return n ? cols() : rows(); }
+
+      // Returns the number of stored elements.
+      std::size_t nonzeros() const { return data.values.size(); }
+
+      // Returns the footprint of the compressed arrays. See [mem.usage].
+      memory_footprint memory_usage() const { return data.memory_usage(); }
+
+      // Release the unused capacity of the compressed arrays.
+      void shrink_to_fit() { data.shrink_to_fit(); }
+
+
+      // Element access
+      //
+      // Returns the value of the element at (i, j), which is 0 if no element
+      // is stored there.
+      T operator()(std::size_t i, std::size_t j) const;
+
+
+      // Compressed data
+      //
+      // Returns the column offsets, row indexes, and values of the stored
+      // elements.
+      const index_vector& col_offsets() const { return data.offsets; }
+      const index_vector& row_indices() const { return data.indices; }
+      const std::vector<T>& values() const { return data.values; }
+
+      // Returns the values of the stored elements. Assigning a value does not
+      // change the structure of the matrix.
+      std::vector<T>& values() { return data.values; }
+
+    private:
+      friend class csr_matrix<T>;
+
+      sparse_impl::compressed<T> data;
+    };
+
+
+  template <typename T>
+    inline
+    csc_matrix<T>::csc_matrix(std::size_t m,
+                              std::size_t n,
+                              const std::vector<sparse_entry<T>>& entries)
+      : data(sparse_impl::compress(n, m, entries,
+                                   sparse_impl::col_of{},
+                                   sparse_impl::row_of{}))
+    { }
+
+  template <typename T>
+    template <typename M, typename X>
+      inline
+      csc_matrix<T>::csc_matrix(const M& m)
+        : csc_matrix(m.rows(), m.cols(), sparse_impl::nonzero_entries(m))
+      { }
+
+  template <typename T>
+    inline
+    csc_matrix<T>::csc_matrix(const csr_matrix<T>& x)
+      : data(sparse_impl::transpose(x.data))
+    { }
+
+  template <typename T>
+    inline T
+    csc_matrix<T>::operator()(std::size_t i, std::size_t j) const
+    {
+      assert(i < rows() && j < cols());
+      const T* p = data.find(j, i);
+      return p ? *p : T(0);
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Sparse products                                            [sparse.product]
+  //
+  // Compute out += a * b, where a is a sparse m x p matrix, b is a dense
+  // p x n matrix or p-vector, and out is a dense m x n matrix or m-vector.
+
+  namespace sparse_impl
+  {
+    // The minimum number of stored elements for which a CSR product is
+    // computed in parallel.
+    constexpr std::size_t parallel_nonzeros = 1 << 16;
+
+    // Accumulate rows [first, last) of the CSR product into out.
+    template <typename T, typename M1, typename M2>
+      void
+      csr_rows(const csr_matrix<T>& a, const M1& b, M2& out,
+               std::size_t first, std::size_t last, size_constant<1>)
+      {
+        const std::size_t* off = a.row_offsets().data();
+        const std::size_t* col = a.col_indices().data();
+        const T* val = a.values().data();
+        for (std::size_t i = first; i != last; ++i) {
+          T sum = T(0);
+          for (std::size_t k = off[i]; k != off[i + 1]; ++k)
+            sum += val[k] * b(col[k]);
+          out(i) += sum;
+        }
+      }
+
+    template <typename T, typename M1, typename M2>
+      void
+      csr_rows(const csr_matrix<T>& a, const M1& b, M2& out,
+               std::size_t first, std::size_t last, size_constant<2>)
+      {
+        const std::size_t* off = a.row_offsets().data();
+        const std::size_t* col = a.col_indices().data();
+        const T* val = a.values().data();
+        const std::size_t n = out.cols();
+        for (std::size_t i = first; i != last; ++i) {
+          for (std::size_t k = off[i]; k != off[i + 1]; ++k) {
+            const T x = val[k];
+            for (std::size_t j = 0; j != n; ++j)
+              out(i, j) += x * b(col[k], j);
+          }
+        }
+      }
+
+    // Accumulate the columns of the CSC product into out.
+    template <typename T, typename M1, typename M2>
+      void
+      csc_cols(const csc_matrix<T>& a, const M1& b, M2& out, size_constant<1>)
+      {
+        const std::size_t* off = a.col_offsets().data();
+        const std::size_t* row = a.row_indices().data();
+        const T* val = a.values().data();
+        for (std::size_t j = 0; j != a.cols(); ++j) {
+          const T x = b(j);
+          for (std::size_t k = off[j]; k != off[j + 1]; ++k)
+            out(row[k]) += val[k] * x;
+        }
+      }
+
+    template <typename T, typename M1, typename M2>
+      void
+      csc_cols(const csc_matrix<T>& a, const M1& b, M2& out, size_constant<2>)
+      {
+        const std::size_t* off = a.col_offsets().data();
+        const std::size_t* row = a.row_indices().data();
+        const T* val = a.values().data();
+        const std::size_t n = out.cols();
+        for (std::size_t j = 0; j != a.cols(); ++j) {
+          for (std::size_t k = off[j]; k != off[j + 1]; ++k) {
+            const T x = val[k];
+            for (std::size_t c = 0; c != n; ++c)
+              out(row[k], c) += x * b(j, c);
+          }
+        }
+      }
+
+    // Check the extents of the operands of a sparse product.
+    template <typename A, typename M1, typename M2>
+      inline bool
+      check_product(const A& a, const M1& b, const M2& out)
+      {
+        static_assert(M1::order == 1 || M1::order == 2, "");
+        static_assert(M1::order == M2::order, "");
+        return a.cols() == b.extent(0)
+            && a.rows() == out.extent(0)
+            && (M1::order == 1 || b.extent(1) == out.extent(1));
+      }
+
+  } // namespace sparse_impl
+
+
+  template <typename T, typename M1, typename M2>
+    void
+    sparse_product(const csr_matrix<T>& a, const M1& b, M2& out)
+    {
+      assert(sparse_impl::check_product(a, b, out));
+      using Order = size_constant<M1::order>;
+
+      // Rows of the product are independent, so blocks of rows can be
+      // computed concurrently.
+      std::size_t threads = product_threads();
+      if (threads > 1 && a.nonzeros() >= sparse_impl::parallel_nonzeros) {
+        std::size_t m = a.rows();
+        std::size_t blocks = threads * 4;
+        std::size_t step = (m + blocks - 1) / blocks;
+        matrix_impl::parallel_for(blocks, threads, [&](std::size_t k) {
+          std::size_t first = std::min(m, k * step);
+          std::size_t last = std::min(m, first + step);
+          sparse_impl::csr_rows(a, b, out, first, last, Order{});
+        });
+      } else {
+        sparse_impl::csr_rows(a, b, out, 0, a.rows(), Order{});
+      }
+    }
+
+  template <typename T, typename M1, typename M2>
+    void
+    sparse_product(const csc_matrix<T>& a, const M1& b, M2& out)
+    {
+      assert(sparse_impl::check_product(a, b, out));
+      sparse_impl::csc_cols(a, b, out, size_constant<M1::order>{});
+    }
+
+
+  namespace sparse_impl
+  {
+    // The rows [first, last) of a sparse product, with offsets relative to
+    // the first row.
+    template <typename T>
+      struct product_rows
+      {
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> indices;
+        std::vector<T> values;
+      };
+
+    // Compute the rows [first, last) of a * b over the semiring R, by
+    // Gustavson's algorithm: each row of a scales and merges the rows of b
+    // selected by its columns in a dense accumulator, whose touched columns
+    // are then sorted.
+    template <typename T, typename R>
+      product_rows<T>
+      spgemm_rows(const csr_matrix<T>& a, const csr_matrix<T>& b,
+                  std::size_t first, std::size_t last)
+      {
+        const std::size_t npos = -1;
+        const std::size_t* aoff = a.row_offsets().data();
+        const std::size_t* acol = a.col_indices().data();
+        const T* aval = a.values().data();
+        const std::size_t* boff = b.row_offsets().data();
+        const std::size_t* bcol = b.col_indices().data();
+        const T* bval = b.values().data();
+
+        product_rows<T> p;
+        p.offsets.reserve(last - first + 1);
+        p.offsets.push_back(0);
+        std::vector<T> acc(b.cols());
+        std::vector<std::size_t> owner(b.cols(), npos);
+        std::vector<std::size_t> touched;
+        for (std::size_t i = first; i != last; ++i) {
+          touched.clear();
+          for (std::size_t k = aoff[i]; k != aoff[i + 1]; ++k) {
+            const T x = aval[k];
+            const std::size_t r = acol[k];
+            for (std::size_t l = boff[r]; l != boff[r + 1]; ++l) {
+              std::size_t j = bcol[l];
+              T y = R::times(x, bval[l]);
+              if (owner[j] != i) {
+                owner[j] = i;
+                acc[j] = y;
+                touched.push_back(j);
+              } else {
+                acc[j] = R::plus(acc[j], y);
+              }
+            }
+          }
+          std::sort(touched.begin(), touched.end());
+          for (std::size_t j : touched) {
+            p.indices.push_back(j);
+            p.values.push_back(acc[j]);
+          }
+          p.offsets.push_back(p.indices.size());
+        }
+        return p;
+      }
+
+  } // namespace sparse_impl
+
+
+  // Sparse-sparse multiplication
+  //
+  // Returns the product of the CSR matrices a and b over the semiring r,
+  // which is the arithmetic product by default. The absent elements of a and
+  // b are the zero of the semiring, and an element of the product is stored
+  // if any term contributes to it, even if its value is zero. The rows of a
+  // large product are computed in parallel, in blocks, using the threads of
+  // matrix_product. For example, the vertices reachable in two steps of a
+  // graph with the adjacency matrix g (of 0/1 values) are spgemm(g, g,
+  // or_and{}).
+  template <typename T, typename R = plus_times>
+    csr_matrix<T>
+    spgemm(const csr_matrix<T>& a, const csr_matrix<T>& b, R = R())
+    {
+      assert(a.cols() == b.rows());
+      const std::size_t m = a.rows();
+      std::size_t threads = product_threads();
+      std::size_t blocks = 1;
+      if (threads > 1 && a.nonzeros() >= sparse_impl::parallel_nonzeros)
+        blocks = threads * 4;
+      std::size_t step = (m + blocks - 1) / blocks;
+
+      std::vector<sparse_impl::product_rows<T>> parts(blocks);
+      auto part = [&](std::size_t k) {
+        std::size_t first = std::min(m, k * step);
+        std::size_t last = std::min(m, first + step);
+        parts[k] = sparse_impl::spgemm_rows<T, R>(a, b, first, last);
+      };
+      if (blocks > 1)
+        matrix_impl::parallel_for(blocks, threads, part);
+      else
+        part(0);
+
+      // Concatenate the blocks of rows.
+      std::vector<std::size_t> offsets(1, 0);
+      std::vector<std::size_t> indices;
+      std::vector<T> values;
+      offsets.reserve(m + 1);
+      for (sparse_impl::product_rows<T>& p : parts) {
+        std::size_t base = indices.size();
+        for (std::size_t i = 1; i < p.offsets.size(); ++i)
+          offsets.push_back(base + p.offsets[i]);
+        indices.insert(indices.end(), p.indices.begin(), p.indices.end());
+        values.insert(values.end(), p.values.begin(), p.values.end());
+      }
+      return {m, b.cols(), std::move(offsets), std::move(indices),
+              std::move(values)};
+    }
+
+
+  // Sparse-dense multiplication
+  //
+  // Returns the product of a sparse matrix and a dense vector or matrix.
+  template <typename T, typename M>
+    inline Requires<Matrix<M>() && M::order == 1, matrix<T, 1>>
+    operator*(const csr_matrix<T>& a, const M& x)
+    {
+      matrix<T, 1> r(a.rows());
+      sparse_product(a, x, r);
+      return r;
+    }
+
+  template <typename T, typename M>
+    inline Requires<Matrix<M>() && M::order == 2, matrix<T, 2>>
+    operator*(const csr_matrix<T>& a, const M& x)
+    {
+      matrix<T, 2> r(a.rows(), x.cols());
+      sparse_product(a, x, r);
+      return r;
+    }
+
+  template <typename T, typename M>
+    inline Requires<Matrix<M>() && M::order == 1, matrix<T, 1>>
+    operator*(const csc_matrix<T>& a, const M& x)
+    {
+      matrix<T, 1> r(a.rows());
+      sparse_product(a, x, r);
+      return r;
+    }
+
+  template <typename T, typename M>
+    inline Requires<Matrix<M>() && M::order == 2, matrix<T, 2>>
+    operator*(const csc_matrix<T>& a, const M& x)
+    {
+      matrix<T, 2> r(a.rows(), x.cols());
+      sparse_product(a, x, r);
+      return r;
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Graph matrices                                               [sparse.graph]
+  //
+  // The adjacency matrix of a graph g with n vertices is the n x n matrix A
+  // where A(u, v) is the weight of the edge (u, v). For an undirected graph,
+  // each edge contributes to both A(u, v) and A(v, u). Parallel edges are
+  // summed.
+  //
+  // The Laplacian of an undirected graph is L = D - A, where D is the
+  // diagonal matrix of weighted vertex degrees. Loops do not contribute to
+  // the Laplacian.
+  //
+  // The weight function w maps each edge of g to its weight. When omitted,
+  // each edge has weight 1.
+  //
+  // The graph must be one of Origin's adjacency structures whose vertices
+  // are numbered [0, g.order()).
+
+  namespace sparse_impl
+  {
+    // The default edge weight.
+    template <typename T>
+      struct unit_weight
+      {
+        template <typename E>
+          T operator()(const E&) const { return T(1); }
+      };
+
+    template <typename T, typename G, typename W>
+      std::vector<sparse_entry<T>>
+      edge_entries(const G& g, W w)
+      {
+        std::vector<sparse_entry<T>> entries;
+        for (Edge<G> e : g.edges()) {
+          std::size_t u = g.source(e);
+          std::size_t v = g.target(e);
+          T x = w(e);
+          entries.push_back({u, v, x});
+          if (!Directed_graph<G>() && u != v)
+            entries.push_back({v, u, x});
+        }
+        return entries;
+      }
+
+  } // namespace sparse_impl
+
+
+  template <typename T, typename G, typename W>
+    csr_matrix<T>
+    adjacency_matrix(const G& g, W w)
+    {
+      std::size_t n = g.order();
+      return {n, n, sparse_impl::edge_entries<T>(g, w)};
+    }
+
+  template <typename T, typename G>
+    inline csr_matrix<T>
+    adjacency_matrix(const G& g)
+    {
+      return adjacency_matrix<T>(g, sparse_impl::unit_weight<T>{});
+    }
+
+
+  template <typename T, typename G, typename W>
+    csr_matrix<T>
+    laplacian_matrix(const G& g, W w)
+    {
+      static_assert(!Directed_graph<G>(), "");
+      std::size_t n = g.order();
+      std::vector<sparse_entry<T>> entries;
+      entries.reserve(4 * g.size() + n);
+      std::vector<T> degree(n, T(0));
+      for (Edge<G> e : g.edges()) {
+        std::size_t u = g.source(e);
+        std::size_t v = g.target(e);
+        if (u == v)
+          continue;
+        T x = w(e);
+        entries.push_back({u, v, -x});
+        entries.push_back({v, u, -x});
+        degree[u] += x;
+        degree[v] += x;
+      }
+      for (std::size_t v = 0; v != n; ++v)
+        entries.push_back({v, v, degree[v]});
+      return {n, n, entries};
+    }
+
+  template <typename T, typename G>
+    inline csr_matrix<T>
+    laplacian_matrix(const G& g)
+    {
+      return laplacian_matrix<T>(g, sparse_impl::unit_weight<T>{});
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,223 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/sparse.hpp>
+#include <origin/graph/adjacency_list.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+test_construct()
+{
+  // Entries are sorted and duplicates are summed.
+  csr_matrix<int> a(3, 4, {
+    {2, 3, 5}, {0, 1, 1}, {2, 0, 4}, {0, 1, 2}, {1, 2, 3}
+  });
+  assert(a.rows() == 3);
+  assert(a.cols() == 4);
+  assert(a.nonzeros() == 4);
+  assert(a(0, 1) == 3);
+  assert(a(1, 2) == 3);
+  assert(a(2, 0) == 4);
+  assert(a(2, 3) == 5);
+  assert(a(0, 0) == 0);
+  assert(a(1, 3) == 0);
+  assert((a.row_offsets() == vector<size_t>{0, 1, 2, 4}));
+  assert((a.col_indices() == vector<size_t>{1, 2, 0, 3}));
+
+  // Conversions preserve elements.
+  csc_matrix<int> b(a);
+  assert(b.rows() == 3);
+  assert(b.cols() == 4);
+  assert(b.nonzeros() == 4);
+  assert((b.col_offsets() == vector<size_t>{0, 1, 2, 3, 4}));
+  assert((b.row_indices() == vector<size_t>{2, 0, 1, 2}));
+  csr_matrix<int> c(b);
+  c.shrink_to_fit();
+  assert(c.memory_usage().slack() == 0);
+  assert(c.memory_usage().live == 8 * sizeof(size_t) + 4 * sizeof(int));
+  assert(c.row_offsets() == a.row_offsets());
+  assert(c.col_indices() == a.col_indices());
+  assert(c.values() == a.values());
+
+  // Dense matrices drop zeros.
+  matrix<int, 2> m {
+    {1, 0, 0},
+    {0, 0, 2},
+    {3, 0, 4}
+  };
+  csr_matrix<int> d(m);
+  csc_matrix<int> e(m);
+  assert(d.nonzeros() == 4);
+  assert(e.nonzeros() == 4);
+  for (size_t i = 0; i != 3; ++i)
+    for (size_t j = 0; j != 3; ++j)
+      assert(d(i, j) == m(i, j) && e(i, j) == m(i, j));
+}
+
+void
+test_product()
+{
+  matrix<double, 2> m {
+    {1, 0, 2, 0},
+    {0, 0, 0, 0},
+    {0, 3, 0, 4},
+  };
+  csr_matrix<double> a(m);
+  csc_matrix<double> b(m);
+
+  matrix<double, 1> x {1.0, 2.0, 3.0, 4.0};
+  matrix<double, 1> y {7.0, 0.0, 22.0};
+  assert(a * x == y);
+  assert(b * x == y);
+
+  matrix<double, 2> n {
+    {1, 2},
+    {3, 4},
+    {5, 6},
+    {7, 8},
+  };
+  matrix<double, 2> p = m * n;
+  assert(a * n == p);
+  assert(b * n == p);
+
+  // Products accumulate into the result.
+  matrix<double, 1> z(3);
+  sparse_product(a, x, z);
+  sparse_product(b, x, z);
+  assert(z == y * 2.0);
+}
+
+// A large banded matrix uses the parallel product.
+void
+test_parallel()
+{
+  const size_t n = 1 << 15;
+  vector<sparse_entry<double>> entries;
+  for (size_t i = 0; i != n; ++i) {
+    entries.push_back({i, i, 2.0});
+    if (i > 0)
+      entries.push_back({i, i - 1, -1.0});
+    if (i + 1 < n)
+      entries.push_back({i, i + 1, -1.0});
+  }
+  csr_matrix<double> a(n, n, entries);
+  csc_matrix<double> b(a);
+
+  matrix<double, 1> x(n);
+  for (size_t i = 0; i != n; ++i)
+    x(i) = i % 7;
+
+  matrix<double, 1> y = a * x;
+  assert(y == b * x);
+  for (size_t i = 1; i + 1 < n; ++i)
+    assert(y(i) == 2 * x(i) - x(i - 1) - x(i + 1));
+}
+
+void
+test_graph()
+{
+  // A path 0 - 1 - 2 with a chord 0 - 2 and a loop on 3.
+  undirected_adjacency_list<> g;
+  auto v0 = g.add_vertex();
+  auto v1 = g.add_vertex();
+  auto v2 = g.add_vertex();
+  auto v3 = g.add_vertex();
+  g.add_edge(v0, v1);
+  g.add_edge(v1, v2);
+  g.add_edge(v0, v2);
+  g.add_edge(v3, v3);
+
+  csr_matrix<int> a = adjacency_matrix<int>(g);
+  matrix<int, 2> da {
+    {0, 1, 1, 0},
+    {1, 0, 1, 0},
+    {1, 1, 0, 0},
+    {0, 0, 0, 1},
+  };
+  for (size_t i = 0; i != 4; ++i)
+    for (size_t j = 0; j != 4; ++j)
+      assert(a(i, j) == da(i, j));
+
+  csr_matrix<int> l = laplacian_matrix<int>(g);
+  matrix<int, 2> dl {
+    { 2, -1, -1, 0},
+    {-1,  2, -1, 0},
+    {-1, -1,  2, 0},
+    { 0,  0,  0, 0},
+  };
+  for (size_t i = 0; i != 4; ++i)
+    for (size_t j = 0; j != 4; ++j)
+      assert(l(i, j) == dl(i, j));
+
+  // The Laplacian annihilates constant vectors.
+  matrix<int, 1> ones {1, 1, 1, 1};
+  assert((l * ones == matrix<int, 1>(4)));
+}
+
+void
+test_spgemm()
+{
+  // The sparse product agrees with the dense product.
+  matrix<int, 2> da {
+    {1, 0, 2, 0},
+    {0, 0, 0, 3},
+    {4, 5, 0, 0},
+  };
+  matrix<int, 2> db {
+    {0, 1},
+    {2, 0},
+    {0, 0},
+    {1, -1},
+  };
+  csr_matrix<int> a(da), b(db);
+  csr_matrix<int> c = spgemm(a, b);
+  matrix<int, 2> dc = da * db;
+  assert(c.rows() == 3 && c.cols() == 2);
+  for (size_t i = 0; i != 3; ++i)
+    for (size_t j = 0; j != 2; ++j)
+      assert(c(i, j) == dc(i, j));
+
+  // Over min_plus, squaring the weights of a path gives the lengths of the
+  // shortest paths of at most two edges. Absent elements are infinite.
+  const size_t n = 1 << 15;
+  vector<sparse_entry<double>> entries;
+  for (size_t i = 0; i != n; ++i) {
+    entries.push_back({i, i, 0.0});
+    if (i + 1 < n)
+      entries.push_back({i, i + 1, double(i % 3 + 1)});
+  }
+  csr_matrix<double> w(n, n, entries);
+  csr_matrix<double> w2 = spgemm(w, w, min_plus{});
+  assert(w2.nonzeros() == 3 * n - 3);
+  for (size_t i = 0; i + 2 < n; ++i) {
+    assert(w2(i, i) == 0);
+    assert(w2(i, i + 1) == double(i % 3 + 1));
+    assert(w2(i, i + 2) == double(i % 3 + (i + 1) % 3 + 2));
+  }
+
+  // The parallel and serial products agree.
+  set_product_threads(1);
+  csr_matrix<double> s2 = spgemm(w, w, min_plus{});
+  set_product_threads(0);
+  assert(s2.row_offsets() == w2.row_offsets());
+  assert(s2.col_indices() == w2.col_indices());
+  assert(s2.values() == w2.values());
+}
+
+int main()
+{
+  test_construct();
+  test_product();
+  test_parallel();
+  test_graph();
+  test_spgemm();
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdio>
+
+#include "text.hpp"
+
+namespace origin
+{
+  namespace text_impl
+  {
+    // The value is formatted with the shorter precision, and with the
+    // longer one if it does not read back as the same value. The longer
+    // precision (max_digits10) always does.
+    namespace
+    {
+      template <typename T, typename R>
+        void
+        put_exact(std::string& s, T x, int shorter, int longer,
+                  const char* format, R read)
+        {
+          char buf[64];
+          int n = std::snprintf(buf, sizeof(buf), format, shorter, x);
+          if (read(buf) != x && x == x)
+            n = std::snprintf(buf, sizeof(buf), format, longer, x);
+          s.append(buf, n);
+        }
+    } // namespace
+
+    void
+    put_exact(std::string& s, float x)
+    {
+      put_exact(s, x, 6, 9, "%.*g", [](const char* p) {
+        return std::strtof(p, nullptr);
+      });
+    }
+
+    void
+    put_exact(std::string& s, double x)
+    {
+      put_exact(s, x, 15, 17, "%.*g", [](const char* p) {
+        return std::strtod(p, nullptr);
+      });
+    }
+
+    void
+    put_exact(std::string& s, long double x)
+    {
+      put_exact(s, x, 18, 21, "%.*Lg", [](const char* p) {
+        return std::strtold(p, nullptr);
+      });
+    }
+
+    void
+    malformed(std::size_t offset, const char* what)
+    {
+      throw std::runtime_error("matrix text: " + std::string(what) +
+                               " in the line at offset " +
+                               std::to_string(offset));
+    }
+  } // namespace text_impl
+
+} // namespace origin
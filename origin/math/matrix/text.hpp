@@ -0,0 +1,349 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_TEXT_HPP
+#define ORIGIN_MATH_MATRIX_TEXT_HPP
+
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+#include <origin/graph/io.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Matrix text                                                     [text.decl]
+  //
+  // A 2D matrix is written as text with one row per line and its elements
+  // separated by a delimiter, which is a space by default or a comma for
+  // CSV. For example:
+  //
+  //    1 2.5 3
+  //    4 5 -6e-20
+  //
+  // The functions are:
+  //
+  //    write_matrix_text(out, m[, delim, threads])  Write m to out
+  //    save_matrix_text(path, m[, delim, threads])  Write m to the file path
+  //    parse_matrix_text<T>(first, last[, threads]) Read a matrix<T, 2>
+  //    load_matrix_text<T>(path[, threads])         Read the file path
+  //
+  // The output is any object with a member write(p, n), such as an ostream
+  // or an io::fd_writer (see [graph.io.write]). Elements are formatted
+  // directly into large buffers, without streams or locales, and blocks of
+  // rows are formatted in parallel. Integers are written exactly. Floating
+  // point values are written with the fewest of 15 or 17 significant digits
+  // (6 or 9 for float) that read back as the same value, so that a matrix
+  // survives saving and loading.
+  //
+  // The reader accepts elements separated by spaces, tabs or commas, with
+  // optional spaces around commas, and lines ending with "\n" or "\r\n".
+  // Blank lines, and lines starting with '#' or '%', are ignored. Every
+  // line must have the same number of elements. Floating point elements
+  // may be "inf", "nan", and so on, as read by strtod.
+  //
+  // The text is divided into chunks at line boundaries. The rows of each
+  // chunk are counted in parallel, the matrix is allocated uninitialized,
+  // and the chunks are then parsed in parallel directly into their rows.
+  // Loading a file maps it (see [graph.io.file]). A std::runtime_error is
+  // thrown if the text cannot be parsed, giving the offset of the line.
+
+
+  namespace text_impl
+  {
+    // The number of rows formatted into each buffer.
+    constexpr std::size_t block = 1 << 10;
+
+    // Append x to s with the fewest significant digits that read back as
+    // x. See text.cpp.
+    void put_exact(std::string& s, float x);
+    void put_exact(std::string& s, double x);
+    void put_exact(std::string& s, long double x);
+
+    template <typename T>
+      inline Requires<Floating_point<T>(), void>
+      put(std::string& s, T x)
+      {
+        put_exact(s, x);
+      }
+
+    template <typename T>
+      inline Requires<!Floating_point<T>(), void>
+      put(std::string& s, T x)
+      {
+        io::write_impl::put(s, x);
+      }
+
+    // Bool and character elements are written as numbers.
+    inline void
+    put(std::string& s, bool x) { s.push_back(x ? '1' : '0'); }
+
+    inline void
+    put(std::string& s, char x) { io::write_impl::put(s, int(x)); }
+
+    inline void
+    put(std::string& s, signed char x) { io::write_impl::put(s, int(x)); }
+
+    inline void
+    put(std::string& s, unsigned char x) { io::write_impl::put(s, int(x)); }
+
+
+    // Throws std::runtime_error for malformed text at the given offset.
+    [[noreturn]] void malformed(std::size_t offset, const char* what);
+
+    // Returns true if the line [p, last) has no elements.
+    inline bool
+    skipped(const char* p, const char* last)
+    {
+      p = io::parse_impl::skip_blanks(p, last);
+      return p == last || *p == '#' || *p == '%';
+    }
+
+    // Returns the end of the line [p, last), excluding "\n" or "\r\n", and
+    // sets next to the start of the next line.
+    inline const char*
+    line_end(const char* p, const char* last, const char*& next)
+    {
+      const char* eol =
+        static_cast<const char*>(std::memchr(p, '\n', last - p));
+      next = eol ? eol + 1 : last;
+      const char* end = eol ? eol : last;
+      if (end != p && end[-1] == '\r')
+        --end;
+      return end;
+    }
+
+    // Skip the separator between two elements. Returns nullptr if there is
+    // none.
+    inline const char*
+    skip_separator(const char* p, const char* last)
+    {
+      const char* q = io::parse_impl::skip_blanks(p, last);
+      if (q != last && *q == ',')
+        return io::parse_impl::skip_blanks(q + 1, last);
+      return q == p ? nullptr : q;
+    }
+
+    // Parse an element from [p, last). Floating point values that are not
+    // numerals (inf, nan), and all long doubles, are converted by strtold.
+    template <typename T>
+      inline Requires<!Floating_point<T>() && !Same<T, bool>(), const char*>
+      parse_element(const char* p, const char* last, T& x)
+      {
+        return io::parse_impl::parse_field(p, last, x);
+      }
+
+    template <typename T>
+      inline Requires<Same<T, bool>(), const char*>
+      parse_element(const char* p, const char* last, T& x)
+      {
+        unsigned v;
+        p = io::parse_impl::parse_field(p, last, v);
+        if (!p || v > 1)
+          return nullptr;
+        x = v != 0;
+        return p;
+      }
+
+    template <typename T>
+      Requires<Floating_point<T>(), const char*>
+      parse_element(const char* p, const char* last, T& x)
+      {
+        if (!Same<T, long double>()) {
+          if (const char* q = io::parse_impl::parse_field(p, last, x))
+            return q;
+        }
+        const char* end = p;
+        while (end != last && !io::parse_impl::is_blank(*end) && *end != ',')
+          ++end;
+        std::string s(p, end);
+        char* stop;
+        long double v = std::strtold(s.c_str(), &stop);
+        if (s.empty() || stop != s.c_str() + s.size())
+          return nullptr;
+        x = T(v);
+        return end;
+      }
+
+    // Returns the number of elements in the line [p, last), which is not
+    // skipped, or throws if it cannot be parsed. The offset of p in the
+    // text is base.
+    template <typename T>
+      std::size_t
+      count_elements(const char* p, const char* last, std::size_t base)
+      {
+        std::size_t n = 0;
+        p = io::parse_impl::skip_blanks(p, last);
+        while (true) {
+          T x;
+          p = parse_element(p, last, x);
+          if (!p)
+            malformed(base, "invalid element");
+          ++n;
+          if (io::parse_impl::skip_blanks(p, last) == last)
+            return n;
+          p = skip_separator(p, last);
+          if (!p || p == last)
+            malformed(base, "invalid separator");
+        }
+      }
+
+    // Returns the number of rows in the lines of [first, last).
+    inline std::size_t
+    count_rows(const char* first, const char* last)
+    {
+      std::size_t n = 0;
+      for (const char* p = first; p != last; ) {
+        const char* next;
+        const char* end = line_end(p, last, next);
+        n += !skipped(p, end);
+        p = next;
+      }
+      return n;
+    }
+
+    // Parse the lines of [first, last), which have cols elements each, into
+    // the rows at out. The offset of first in the text is base.
+    template <typename T>
+      void
+      parse_rows(const char* first, const char* last, std::size_t base,
+                 std::size_t cols, T* out)
+      {
+        for (const char* p = first; p != last; ) {
+          const char* next;
+          const char* end = line_end(p, last, next);
+          if (!skipped(p, end)) {
+            std::size_t off = base + (p - first);
+            const char* q = io::parse_impl::skip_blanks(p, end);
+            for (std::size_t j = 0; j != cols; ++j) {
+              if (j != 0) {
+                q = skip_separator(q, end);
+                if (!q || q == end)
+                  malformed(off, "too few elements");
+              }
+              q = parse_element(q, end, out[j]);
+              if (!q)
+                malformed(off, "invalid element");
+            }
+            if (io::parse_impl::skip_blanks(q, end) != end)
+              malformed(off, "too many elements");
+            out += cols;
+          }
+          p = next;
+        }
+      }
+
+  } // namespace text_impl
+
+
+  // Write the 2D matrix or matrix_ref m to out, one row per line, with the
+  // elements of each row separated by delim.
+  template <typename Out, typename M>
+    void
+    write_matrix_text(Out& out, const M& m, char delim = ' ',
+                      std::size_t threads = product_threads())
+    {
+      static_assert(M::order == 2, "");
+      std::size_t rows = m.rows();
+      std::size_t cols = m.cols();
+      std::size_t t = std::max<std::size_t>(threads, 1);
+      std::size_t blocks = (rows + text_impl::block - 1) / text_impl::block;
+      std::vector<std::string> bufs(std::min(blocks, t * 4));
+      for (std::size_t k = 0; k < blocks; k += bufs.size()) {
+        std::size_t n = std::min(bufs.size(), blocks - k);
+        matrix_impl::parallel_for(n, t, [&](std::size_t b) {
+          std::string& s = bufs[b];
+          s.clear();
+          std::size_t first = (k + b) * text_impl::block;
+          std::size_t last = std::min(rows, first + text_impl::block);
+          for (std::size_t i = first; i != last; ++i) {
+            for (std::size_t j = 0; j != cols; ++j) {
+              if (j != 0)
+                s.push_back(delim);
+              text_impl::put(s, m(i, j));
+            }
+            s.push_back('\n');
+          }
+        });
+        for (std::size_t b = 0; b != n; ++b)
+          out.write(bufs[b].data(), bufs[b].size());
+      }
+    }
+
+  // Write the matrix or matrix_ref m to the file path.
+  template <typename M>
+    void
+    save_matrix_text(const std::string& path, const M& m, char delim = ' ',
+                     std::size_t threads = product_threads())
+    {
+      io::fd_writer out(path);
+      write_matrix_text(out, m, delim, threads);
+      out.flush();
+    }
+
+
+  // Returns the matrix described by the text in [first, last).
+  template <typename T>
+    matrix<T, 2>
+    parse_matrix_text(const char* first, const char* last,
+                      std::size_t threads = product_threads())
+    {
+      std::size_t t = std::max<std::size_t>(threads, 1);
+      std::size_t n = std::min(t * 4, std::size_t(last - first)
+                                      / io::parse_impl::min_chunk + 1);
+      std::vector<const char*> bounds =
+        io::parse_impl::split_lines(first, last, n);
+      std::size_t chunks = bounds.size() - 1;
+
+      // The first row determines the number of columns.
+      std::size_t cols = 0;
+      for (const char* p = first; p != last; ) {
+        const char* next;
+        const char* end = text_impl::line_end(p, last, next);
+        if (!text_impl::skipped(p, end)) {
+          cols = text_impl::count_elements<T>(p, end, p - first);
+          break;
+        }
+        p = next;
+      }
+
+      // The first row of each chunk is the number of rows before it.
+      std::vector<std::size_t> rows(chunks + 1);
+      matrix_impl::parallel_for(chunks, t, [&](std::size_t i) {
+        rows[i + 1] = text_impl::count_rows(bounds[i], bounds[i + 1]);
+      });
+      for (std::size_t i = 0; i != chunks; ++i)
+        rows[i + 1] += rows[i];
+
+      matrix<T, 2> m(uninitialized, rows.back(), cols);
+      T* data = m.data();
+      matrix_impl::parallel_for(chunks, t, [&](std::size_t i) {
+        text_impl::parse_rows(bounds[i], bounds[i + 1], bounds[i] - first,
+                              cols, data + rows[i] * cols);
+      });
+      return m;
+    }
+
+  // Returns the matrix described by the text of the file path.
+  template <typename T>
+    matrix<T, 2>
+    load_matrix_text(const std::string& path,
+                     std::size_t threads = product_threads())
+    {
+      io::mapped_file f(path);
+      return parse_matrix_text<T>(f.begin(), f.end(), threads);
+    }
+
+} // namespace origin
+
+#endif
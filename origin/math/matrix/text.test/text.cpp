@@ -0,0 +1,123 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+#include <origin/math/matrix/text.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns true if f throws a std::runtime_error.
+template <typename F>
+  bool
+  throws(F f)
+  {
+    try {
+      f();
+    } catch (std::runtime_error&) {
+      return true;
+    }
+    return false;
+  }
+
+template <typename T>
+  matrix<T, 2>
+  parse(const string& s, size_t threads = 4)
+  {
+    return parse_matrix_text<T>(s.data(), s.data() + s.size(), threads);
+  }
+
+template <typename T, typename M>
+  string
+  format(const M& m, char delim = ' ', size_t threads = 4)
+  {
+    ostringstream os;
+    write_matrix_text(os, m, delim, threads);
+    return os.str();
+  }
+
+void
+test_format()
+{
+  matrix<int, 2> a {{1, -20, 300}, {0, 5, -6}};
+  assert(format<int>(a) == "1 -20 300\n0 5 -6\n");
+  assert(format<int>(a, ',') == "1,-20,300\n0,5,-6\n");
+  assert(format<int>(a(slice::all, slice(1, 2))) == "-20 300\n5 -6\n");
+
+  matrix<double, 2> b {{0.1, 2.5, -1e-300}};
+  assert(format<double>(b) == "0.1 2.5 -1e-300\n");
+  matrix<float, 2> c {{0.1f, 1.0f / 3}};
+  assert(format<float>(c) == "0.1 0.333333343\n");
+}
+
+void
+test_parse()
+{
+  matrix<double, 2> a = parse<double>("# comment\n"
+                                      "1 2.5\t3\r\n"
+                                      "\n"
+                                      "  4,5 , -6e-2 \n"
+                                      "% another\n"
+                                      "inf -inf nan");
+  assert(a.rows() == 3 && a.cols() == 3);
+  assert(a(0, 1) == 2.5 && a(1, 0) == 4 && a(1, 2) == -6e-2);
+  assert(isinf(a(2, 0)) && a(2, 1) < 0 && isnan(a(2, 2)));
+
+  matrix<int, 2> b = parse<int>("1,2\n3,4\n");
+  assert((b == matrix<int, 2>{{1, 2}, {3, 4}}));
+
+  matrix<float, 2> e = parse<float>("");
+  assert(e.rows() == 0 && e.cols() == 0);
+
+  assert(throws([] { parse<int>("1 2\n3\n"); }));
+  assert(throws([] { parse<int>("1 2\n3 4 5\n"); }));
+  assert(throws([] { parse<int>("1 x\n"); }));
+  assert(throws([] { parse<int>("1,,2\n"); }));
+  assert(throws([] { parse<int>("1,2,\n"); }));
+  assert(throws([] { parse<unsigned char>("256\n"); }));
+}
+
+// Large matrices are divided into chunks and blocks, whose results agree
+// with those of a single thread, and survive formatting and parsing.
+void
+test_round_trip()
+{
+  matrix<double, 2> a(3000, 37);
+  for (size_t i = 0; i != a.rows(); ++i)
+    for (size_t j = 0; j != a.cols(); ++j)
+      a(i, j) = (double(i) - 1000.5) / (double(j) + 3) * pow(10.0, j % 9);
+  a(7, 7) = numeric_limits<double>::infinity();
+
+  string s = format<double>(a);
+  assert(s == format<double>(a, ' ', 1));
+  matrix<double, 2> b = parse<double>(s);
+  assert(b == a);
+  assert(parse<double>(s, 1) == a);
+
+  matrix<long, 2> c(2500, 3);
+  for (size_t i = 0; i != c.rows(); ++i)
+    for (size_t j = 0; j != c.cols(); ++j)
+      c(i, j) = long(i * i * 977) - long(j * 1000000007);
+  assert(parse<long>(format<long>(c, ',')) == c);
+
+  const string path = "origin.math.matrix.text.test.csv";
+  save_matrix_text(path, a, ',');
+  assert(load_matrix_text<double>(path) == a);
+  remove(path.c_str());
+}
+
+int main()
+{
+  test_format();
+  test_parse();
+  test_round_trip();
+}
@@ -0,0 +1,283 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <origin/benchmark/benchmark.hpp>
+
+#include "tuning.hpp"
+
+namespace origin
+{
+  tuning_options::tuning_options()
+    : size(256), samples(5), min_sample_time(0.01)
+  { }
+
+  namespace
+  {
+    // The names of the tuned value types, by index.
+    const char* type_names[] = {"float", "double"};
+
+    // Returns the median time of the batch function f with the options o.
+    double
+    median_time(const batch_function& f, const tuning_options& o)
+    {
+      benchmark_options bo;
+      bo.samples = o.samples;
+      bo.min_sample_time = o.min_sample_time;
+      bo.warmup_time = o.min_sample_time;
+      return run_benchmark("tune", f, bo).time.median;
+    }
+
+    // Set the field x of p to the candidate of xs for which time(p) is
+    // least.
+    template <typename F>
+      void
+      choose(product_tuning& p, std::size_t product_tuning::* x,
+             std::initializer_list<std::size_t> xs, F time)
+      {
+        double best = -1;
+        std::size_t arg = p.*x;
+        for (std::size_t v : xs) {
+          p.*x = v;
+          double t = time(p);
+          if (best < 0 || t < best) {
+            best = t;
+            arg = v;
+          }
+        }
+        p.*x = arg;
+      }
+
+    template <typename T>
+      product_tuning
+      tune_type(const tuning_options& o)
+      {
+        std::size_t n = o.size;
+        matrix<T, 2> a(n, n), b(n, n), c(n, n);
+        for (std::size_t i = 0; i != n; ++i)
+          for (std::size_t j = 0; j != n; ++j) {
+            a(i, j) = T((i + j) % 7) / 8;
+            b(i, j) = T((i * j) % 5) / 8;
+          }
+
+        auto product = [&](const product_tuning& p) {
+          return median_time([&](std::size_t k) {
+            for (std::size_t r = 0; r != k; ++r) {
+              matrix_impl::gemm(p, n, n, n, a.data(), n, b.data(), n,
+                                c.data(), n);
+              clobber_memory();
+            }
+          }, o);
+        };
+
+        product_tuning p = default_product_tuning;
+        double best = -1;
+        product_tuning arg = p;
+        for (std::size_t mr : {4, 8})
+          for (std::size_t nr : {4, 8}) {
+            p.mr = mr;
+            p.nr = nr;
+            double t = product(p);
+            if (best < 0 || t < best) {
+              best = t;
+              arg = p;
+            }
+          }
+        p = arg;
+        choose(p, &product_tuning::kc, {128, 192, 256, 384, 512}, product);
+        choose(p, &product_tuning::mc, {64, 96, 128, 192, 256}, product);
+
+        std::size_t m = 4 * n;
+        matrix<T, 2> s(m, m), t(m, m);
+        choose(p, &product_tuning::transpose_block, {8, 16, 32, 64, 128},
+               [&](const product_tuning& q) {
+          return median_time([&](std::size_t k) {
+            for (std::size_t r = 0; r != k; ++r) {
+              matrix_impl::transpose_kernel(m, m, s.data(), m, 1,
+                                            t.data(), m, 1,
+                                            q.transpose_block);
+              clobber_memory();
+            }
+          }, o);
+        });
+        return p;
+      }
+
+
+    // A tuning file entry.
+    struct entry
+    {
+      std::string    type;
+      product_tuning tuning;
+      std::string    machine;
+    };
+
+    // Parse the entry of the line s. Returns false if it is malformed.
+    bool
+    parse_entry(const std::string& s, entry& e)
+    {
+      std::istringstream ss(s);
+      product_tuning& p = e.tuning;
+      if (!(ss >> e.type >> p.mr >> p.nr >> p.mc >> p.kc >> p.nc
+               >> p.transpose_block))
+        return false;
+      ss >> std::ws;
+      std::getline(ss, e.machine);
+      return !e.machine.empty();
+    }
+
+    // Write the entry e.
+    void
+    write_entry(std::ostream& os, const entry& e)
+    {
+      const product_tuning& p = e.tuning;
+      os << e.type << ' ' << p.mr << ' ' << p.nr << ' ' << p.mc << ' '
+         << p.kc << ' ' << p.nc << ' ' << p.transpose_block << ' '
+         << e.machine << '\n';
+    }
+
+    // Returns the lines of the file path, or none if it cannot be read.
+    std::vector<std::string>
+    read_lines(const std::string& path)
+    {
+      std::vector<std::string> ls;
+      std::ifstream f(path);
+      std::string s;
+      while (std::getline(f, s))
+        ls.push_back(s);
+      return ls;
+    }
+
+    // Replace the entries of the file path that have the type and machine
+    // of an entry of es, keeping the others. The file is written to a
+    // temporary file and renamed, so that other processes reading it never
+    // see a partial file.
+    bool
+    save_entries(const std::string& path, const std::vector<entry>& es)
+    {
+      std::vector<std::string> ls = read_lines(path);
+      std::string tmp = path + ".tmp";
+      {
+        std::ofstream f(tmp);
+        for (const std::string& s : ls) {
+          entry x;
+          bool replaced = false;
+          if (parse_entry(s, x))
+            for (const entry& e : es)
+              replaced |= x.type == e.type && x.machine == e.machine;
+          if (!replaced)
+            f << s << '\n';
+        }
+        for (const entry& e : es)
+          write_entry(f, e);
+        if (!f)
+          return false;
+      }
+      return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    // Find the tuning of type index i for this machine in the file path.
+    bool
+    find_tuning(const std::string& path, int i, product_tuning& p)
+    {
+      std::string machine = tuning_machine();
+      for (const std::string& s : read_lines(path)) {
+        entry e;
+        if (parse_entry(s, e) && e.type == type_names[i]
+            && e.machine == machine) {
+          p = e.tuning;
+          return true;
+        }
+      }
+      return false;
+    }
+  } // namespace
+
+
+  namespace matrix_impl
+  {
+    product_tuning
+    tune(int i, const tuning_options& o)
+    {
+      product_tuning p = i == 0 ? tune_type<float>(o) : tune_type<double>(o);
+      set_tuning(i, p);
+      return p;
+    }
+
+    // Parameters that cannot be set are treated as missing, and measured.
+    void
+    initial_tuning(int i)
+    {
+      const char* path = std::getenv("ORIGIN_MATRIX_TUNING");
+      if (!path || !*path)
+        return;
+      product_tuning p;
+      if (find_tuning(path, i, p)) {
+        try {
+          set_tuning(i, p);
+          return;
+        } catch (std::invalid_argument&) { }
+      }
+      p = tune(i, tuning_options());
+      save_entries(path, {{type_names[i], p, tuning_machine()}});
+    }
+  } // namespace matrix_impl
+
+
+  std::string
+  tuning_machine()
+  {
+    std::ifstream f("/proc/cpuinfo");
+    std::string s;
+    while (std::getline(f, s)) {
+      if (s.compare(0, 10, "model name") == 0) {
+        std::size_t p = s.find(':');
+        if (p != std::string::npos) {
+          p = s.find_first_not_of(" \t", p + 1);
+          if (p != std::string::npos)
+            return s.substr(p);
+        }
+      }
+    }
+    return "unknown";
+  }
+
+  std::size_t
+  load_product_tuning(const std::string& path)
+  {
+    std::size_t n = 0;
+    for (int i = 0; i != 2; ++i) {
+      product_tuning p;
+      if (find_tuning(path, i, p)) {
+        try {
+          matrix_impl::set_tuning(i, p);
+          ++n;
+        } catch (std::invalid_argument&) { }
+      }
+    }
+    return n;
+  }
+
+  bool
+  save_product_tuning(const std::string& path)
+  {
+    std::string machine = tuning_machine();
+    return save_entries(path, {
+      {type_names[0], get_product_tuning<float>(), machine},
+      {type_names[1], get_product_tuning<double>(), machine}
+    });
+  }
+
+} // namespace origin
@@ -0,0 +1,94 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_TUNING_HPP
+#define ORIGIN_MATH_MATRIX_TUNING_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <origin/math/matrix/matrix.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  // Tuning the product                                     [matrix.autotune]
+  //
+  // The best blocking parameters of the matrix product and transpose (see
+  // [matrix.tuning]) depend on the caches of the machine. They are measured
+  // by tune_product, which times the serial product of two n x n matrices,
+  // and transpose_into of a 4n x 4n matrix, with the benchmark harness (see
+  // [bench.benchmark]). The parameters are chosen one at a time, each as
+  // the fastest of a few candidates with the others fixed: the register
+  // tile, then kc, then mc, and last the transpose block. The nc block
+  // only matters once a matrix has more than nc columns, and is not
+  // measured. For example:
+  //
+  //    product_tuning p = tune_product<double>();
+  //    save_product_tuning("/var/cache/origin/matrix.tuning");
+  //
+  // The parameters are saved in a tuning file, with one line for each value
+  // type and machine, where the machine is named by the model of its
+  // processor:
+  //
+  //    double 4 8 128 256 4096 32 Intel(R) Xeon(R) Gold 6148 CPU @ 2.40GHz
+  //
+  // Saving the parameters replaces those of the same type and machine,
+  // keeping the others, so one file serves machines of several processor
+  // generations. If the environment variable ORIGIN_MATRIX_TUNING names a
+  // tuning file, the parameters of a value type are read from it the first
+  // time they are used; if the file has no parameters for the machine, they
+  // are measured and saved to it. Otherwise, the default parameters are
+  // used until they are set.
+  //
+  // The measurement of the parameters of one type takes a few seconds with
+  // the default options.
+  struct tuning_options
+  {
+    tuning_options();
+
+    std::size_t size;            // The extent n of the product (256)
+    std::size_t samples;         // The samples of each candidate (5)
+    double      min_sample_time; // The minimum time of a sample (0.01)
+  };
+
+  namespace matrix_impl
+  {
+    // Measure, set and return the tuning with index i. See tuning.cpp.
+    product_tuning tune(int i, const tuning_options& o);
+
+    // Read or measure the tuning with index i, the first time it is used.
+    void initial_tuning(int i);
+  } // namespace matrix_impl
+
+  // Measure the parameters of the products of matrices of T, which must be
+  // float or double, with the options o. The parameters are set, and
+  // returned.
+  template <typename T>
+    inline product_tuning
+    tune_product(const tuning_options& o = {})
+    {
+      static_assert(matrix_impl::tuning_index<T>() >= 0,
+                    "only float and double products are tuned");
+      return matrix_impl::tune(matrix_impl::tuning_index<T>(), o);
+    }
+
+  // Returns the name of this machine in a tuning file.
+  std::string tuning_machine();
+
+  // Set the parameters of float and double read from the tuning file path
+  // for this machine. Returns the number of value types set. Lines that are
+  // malformed, or that give invalid parameters, are ignored.
+  std::size_t load_product_tuning(const std::string& path);
+
+  // Save the current parameters of float and double to the tuning file
+  // path for this machine. Returns false if the file cannot be written.
+  bool save_product_tuning(const std::string& path);
+
+} // namespace origin
+
+#endif
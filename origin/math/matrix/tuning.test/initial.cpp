@@ -0,0 +1,34 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <origin/math/matrix/tuning.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The parameters of this machine are read from the tuning file named by
+// ORIGIN_MATRIX_TUNING the first time they are used.
+int main()
+{
+  const char* path = "initial.test.tmp";
+  {
+    ofstream f(path);
+    f << "double 8 4 64 128 1024 16 " << tuning_machine() << '\n';
+  }
+  setenv("ORIGIN_MATRIX_TUNING", path, 1);
+
+  matrix<double, 2> a(40, 40), b(40, 40), c(40, 40);
+  matrix_product(a, b, c);
+  assert(get_product_tuning<double>()
+         == product_tuning({8, 4, 64, 128, 1024, 16}));
+  remove(path);
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <origin/math/matrix/tuning.hpp>
+
+using namespace std;
+using namespace origin;
+
+using Mat = matrix<double, 2>;
+
+// Returns the product of a and b computed element by element.
+Mat
+naive_product(const Mat& a, const Mat& b)
+{
+  Mat c(a.rows(), b.cols());
+  for (size_t i = 0; i != a.rows(); ++i)
+    for (size_t k = 0; k != a.cols(); ++k)
+      for (size_t j = 0; j != b.cols(); ++j)
+        c(i, j) += a(i, k) * b(k, j);
+  return c;
+}
+
+// The product and transpose are the same for every register tile and
+// block size.
+void
+check_parameters()
+{
+  assert(get_product_tuning<double>() == default_product_tuning);
+  assert(get_product_tuning<int>() == default_product_tuning);
+
+  Mat a(67, 45), b(45, 83);
+  for (size_t i = 0; i != a.size(); ++i)
+    a.data()[i] = double(i % 11) - 5;
+  for (size_t i = 0; i != b.size(); ++i)
+    b.data()[i] = double(i % 7) - 3;
+  Mat x = naive_product(a, b);
+  for (size_t mr : {4, 8})
+    for (size_t nr : {4, 8}) {
+      set_product_tuning<double>({mr, nr, 16, 8, 24, 4});
+      Mat c(67, 83);
+      matrix_product(a, b, c);
+      assert(c == x);
+
+      Mat t(45, 67);
+      transpose_into(a, t);
+      assert(t == transpose(a));
+    }
+
+  try {
+    set_product_tuning<double>({5, 8, 128, 256, 4096, 32});
+    assert(false);
+  } catch (invalid_argument&) { }
+  try {
+    set_product_tuning<float>({4, 8, 0, 256, 4096, 32});
+    assert(false);
+  } catch (invalid_argument&) { }
+
+  ostringstream ss;
+  ss << default_product_tuning;
+  assert(ss.str() == "mr=4 nr=8 mc=128 kc=256 nc=4096 transpose=32");
+  set_product_tuning<double>(default_product_tuning);
+}
+
+// The measured parameters are valid and set.
+void
+check_tune()
+{
+  tuning_options o;
+  o.size = 48;
+  o.samples = 1;
+  o.min_sample_time = 0.0005;
+  product_tuning p = tune_product<float>(o);
+  assert(get_product_tuning<float>() == p);
+  assert(p.mr == 4 || p.mr == 8);
+  assert(p.kc >= 128 && p.mc >= 64 && p.transpose_block >= 8);
+  set_product_tuning<float>(default_product_tuning);
+}
+
+// Saving replaces the entries of this machine, and keeps the others.
+void
+check_file()
+{
+  string path = "tuning.test.tmp";
+  {
+    ofstream f(path);
+    f << "double 8 8 64 512 2048 16 Some Other Processor\n"
+      << "double 4 4 1 1 1 1 " << tuning_machine() << '\n'
+      << "malformed\n";
+  }
+  assert(load_product_tuning(path) == 1);
+  assert(get_product_tuning<double>() == product_tuning({4, 4, 1, 1, 1, 1}));
+
+  set_product_tuning<double>({8, 4, 96, 192, 4096, 64});
+  assert(save_product_tuning(path));
+  set_product_tuning<double>(default_product_tuning);
+  assert(load_product_tuning(path) == 2);
+  assert(get_product_tuning<double>()
+         == product_tuning({8, 4, 96, 192, 4096, 64}));
+
+  ifstream f(path);
+  string s, text;
+  while (getline(f, s))
+    text += s + '\n';
+  assert(text.find("Some Other Processor") != string::npos);
+  assert(text.find("double 4 4 1 1 1 1") == string::npos);
+  remove(path.c_str());
+
+  assert(load_product_tuning("no/such/file") == 0);
+  set_product_tuning<double>(default_product_tuning);
+  set_product_tuning<float>(default_product_tuning);
+}
+
+int main()
+{
+  check_parameters();
+  check_tune();
+  check_file();
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#endif
+
+#include "allocator.hpp"
+
+namespace origin
+{
+  void* aligned_allocate(std::size_t n, std::size_t align)
+  {
+    // Never request 0 bytes; the result could be a null pointer.
+    if (n == 0)
+      n = align;
+#if defined(_WIN32)
+    void* p = _aligned_malloc(n, align);
+    if (!p)
+      throw std::bad_alloc();
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align, n) != 0)
+      throw std::bad_alloc();
+#endif
+    return p;
+  }
+
+  void aligned_deallocate(void* p)
+  {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+  }
+
+} // namespace origin
@@ -0,0 +1,105 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_ALLOCATOR_HPP
+#define ORIGIN_MEMORY_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <origin/memory/concepts.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Aligned allocation                                     mem.aligned_allocate
+  //
+  // Allocate n bytes of memory whose address is a multiple of align, which
+  // must be a power of 2 and a multiple of sizeof(void*). If the memory
+  // cannot be allocated, std::bad_alloc is thrown. Memory allocated by this
+  // function must be released by aligned_deallocate.
+  void* aligned_allocate(std::size_t n, std::size_t align);
+
+  // Release memory allocated by aligned_allocate.
+  void aligned_deallocate(void* p);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Aligned allocator                                     mem.aligned_allocator
+  //
+  // The aligned allocator allocates storage for objects of type T such that
+  // the first object is aligned on an Align-byte boundary. The default
+  // alignment of 64 bytes is the size of a cache line on most current
+  // processors, and is sufficient for the widest vector loads.
+  //
+  // All aligned allocators of the same alignment are interchangeable;
+  // memory allocated by one can be deallocated by any other.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  //    Align -- The alignment of allocated memory, in bytes
+  template <typename T, std::size_t Align = 64>
+    class aligned_allocator
+    {
+      static_assert((Align & (Align - 1)) == 0,
+                    "alignment is not a power of 2");
+      static_assert(Align >= alignof(T), "alignment is too small for T");
+    public:
+      static constexpr std::size_t alignment = Align;
+
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = aligned_allocator<U, Align>; };
+
+      aligned_allocator() = default;
+
+      template <typename U>
+        aligned_allocator(const aligned_allocator<U, Align>&) { }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        std::size_t a = Align < sizeof(void*) ? sizeof(void*) : Align;
+        return static_cast<T*>(aligned_allocate(n * sizeof(T), a));
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        aligned_deallocate(p);
+      }
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U, std::size_t Align>
+    inline bool
+    operator==(const aligned_allocator<T, Align>&,
+               const aligned_allocator<U, Align>&)
+    {
+      return true;
+    }
+
+  template <typename T, typename U, std::size_t Align>
+    inline bool
+    operator!=(const aligned_allocator<T, Align>&,
+               const aligned_allocator<U, Align>&)
+    {
+      return false;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,50 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <origin/memory/allocator.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <std::size_t Align, typename T>
+  bool is_aligned(const T* p)
+  {
+    return reinterpret_cast<std::uintptr_t>(p) % Align == 0;
+  }
+
+int main()
+{
+  using A = aligned_allocator<double>;
+  static_assert(Allocator<A>(), "");
+  static_assert(A::alignment == 64, "");
+
+  A a;
+  for (std::size_t n = 1; n < 100; n += 7) {
+    double* p = a.allocate(n);
+    assert(is_aligned<64>(p));
+    for (std::size_t i = 0; i < n; ++i)
+      p[i] = i;
+    a.deallocate(p, n);
+  }
+
+  // Allocators of different types with the same alignment are equal.
+  aligned_allocator<int> b = a;
+  assert(a == b);
+
+  // Rebinding preserves the alignment.
+  using B = std::allocator_traits<aligned_allocator<char, 128>>;
+  using C = B::rebind_alloc<int>;
+  static_assert(Same<C, aligned_allocator<int, 128>>(), "");
+
+  // Usable as a standard allocator.
+  vector<float, aligned_allocator<float, 32>> v(37, 1.0f);
+  assert(is_aligned<32>(v.data()));
+}
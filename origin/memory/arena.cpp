@@ -0,0 +1,89 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+
+#include "arena.hpp"
+
+namespace origin
+{
+  constexpr std::size_t arena::default_chunk;
+  constexpr std::size_t arena::max_chunk;
+
+  arena::arena(std::size_t chunk)
+    : head(nullptr), current(nullptr), cur(nullptr), last(nullptr),
+      next_size(std::max(chunk, sizeof(arena::chunk) * 2)), total(0)
+  { }
+
+  arena::~arena()
+  {
+    release();
+  }
+
+  void
+  arena::enter(chunk* c)
+  {
+    current = c;
+    cur = reinterpret_cast<char*>(c) + sizeof(chunk);
+    last = reinterpret_cast<char*>(c) + c->size;
+  }
+
+  void*
+  arena::grow(std::size_t n, std::size_t align)
+  {
+    // Use the retained chunks that follow the current one, skipping those
+    // that are too small.
+    while (current && current->next) {
+      enter(current->next);
+      std::uintptr_t p = reinterpret_cast<std::uintptr_t>(cur);
+      std::uintptr_t e = reinterpret_cast<std::uintptr_t>(last);
+      p = (p + align - 1) & ~std::uintptr_t(align - 1);
+      if (p <= e && n <= e - p) {
+        cur = reinterpret_cast<char*>(p + n);
+        return reinterpret_cast<void*>(p);
+      }
+    }
+
+    // Chain a new chunk after the current one. Chunks are aligned to cache
+    // lines, and the header preserves the alignment of max_align_t.
+    std::size_t size = std::max(next_size, sizeof(chunk) + n + align);
+    chunk* c = static_cast<chunk*>(aligned_allocate(size, 64));
+    c->size = size;
+    total += size;
+    if (current) {
+      c->next = current->next;
+      current->next = c;
+    } else {
+      c->next = head;
+      head = c;
+    }
+    next_size = std::min(max_chunk, std::max(next_size, size / 2) * 2);
+    enter(c);
+    return allocate(n, align);
+  }
+
+  void
+  arena::reset()
+  {
+    if (head)
+      enter(head);
+  }
+
+  void
+  arena::release()
+  {
+    while (head) {
+      chunk* c = head;
+      head = head->next;
+      aligned_deallocate(c);
+    }
+    current = nullptr;
+    cur = last = nullptr;
+    total = 0;
+  }
+
+} // namespace origin
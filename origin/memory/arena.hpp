@@ -0,0 +1,169 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_ARENA_HPP
+#define ORIGIN_MEMORY_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <origin/memory/allocator.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Arena                                                           mem.arena
+  //
+  // An arena is a monotonic (or bump) allocator: memory is allocated by
+  // advancing a pointer through a chunk of memory, and individual
+  // allocations are never released. When a chunk is exhausted, a new chunk
+  // is chained to it, each twice the size of the last, up to a limit;
+  // requests larger than the next chunk get a chunk of their own.
+  //
+  // All the memory allocated from an arena is released at once, in constant
+  // time, by reset(). The chunks are retained and reused by subsequent
+  // allocations, so that an arena used for the scratch data of repeated
+  // computations stops allocating memory from the system once it has grown
+  // to the size of the largest computation. The chunks are returned to the
+  // system by release(), or when the arena is destroyed.
+  //
+  // An arena is not thread-safe; each thread should use its own.
+  class arena
+  {
+  public:
+    // The default size of the first chunk, and the greatest size of the
+    // chunks allocated as the arena grows.
+    static constexpr std::size_t default_chunk = 1 << 16;
+    static constexpr std::size_t max_chunk = 1 << 24;
+
+    // Create an arena whose first chunk has at least the given size. No
+    // memory is allocated until the first allocation.
+    explicit arena(std::size_t chunk = default_chunk);
+    ~arena();
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    // Allocate n bytes aligned to align, which must be a power of 2.
+    void* allocate(std::size_t n,
+                   std::size_t align = alignof(std::max_align_t))
+    {
+      std::uintptr_t p = reinterpret_cast<std::uintptr_t>(cur);
+      std::uintptr_t e = reinterpret_cast<std::uintptr_t>(last);
+      p = (p + align - 1) & ~std::uintptr_t(align - 1);
+      if (cur && p <= e && n <= e - p) {
+        cur = reinterpret_cast<char*>(p + n);
+        return reinterpret_cast<void*>(p);
+      }
+      return grow(n, align);
+    }
+
+    // Deallocation has no effect; memory is released by reset().
+    void deallocate(void*, std::size_t) { }
+
+    // Release all allocated memory, retaining the chunks for reuse.
+    void reset();
+
+    // Release all allocated memory, and return the chunks to the system.
+    void release();
+
+    // Returns the total size of the chunks held by the arena.
+    std::size_t capacity() const { return total; }
+
+  private:
+    // A chunk header precedes the memory of each chunk.
+    struct chunk
+    {
+      chunk* next;
+      std::size_t size;   // The size of the chunk, including the header
+    };
+
+    void* grow(std::size_t n, std::size_t align);
+    void enter(chunk* c);
+
+  private:
+    chunk* head;          // The first chunk
+    chunk* current;       // The chunk being allocated from
+    char* cur;            // The next free byte in the current chunk
+    char* last;           // The end of the current chunk
+    std::size_t next_size;
+    std::size_t total;
+  };
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Arena allocator                                       mem.arena_allocator
+  //
+  // The arena allocator allocates storage for objects of type T from an
+  // arena. Deallocation has no effect; the storage is released when the
+  // arena is reset. Arena allocators are equal when they allocate from the
+  // same arena; the arena must outlive the allocators and the containers
+  // using them.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  template <typename T>
+    class arena_allocator
+    {
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = arena_allocator<U>; };
+
+      arena_allocator(origin::arena& a)
+        : a(&a)
+      { }
+
+      template <typename U>
+        arena_allocator(const arena_allocator<U>& x)
+          : a(&x.arena())
+        { }
+
+      // Returns the arena from which memory is allocated.
+      origin::arena& arena() const { return *a; }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        return static_cast<T*>(a->allocate(n * sizeof(T), alignof(T)));
+      }
+
+      // Deallocation has no effect.
+      void deallocate(T*, std::size_t) { }
+
+    private:
+      origin::arena* a;
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U>
+    inline bool
+    operator==(const arena_allocator<T>& a, const arena_allocator<U>& b)
+    {
+      return &a.arena() == &b.arena();
+    }
+
+  template <typename T, typename U>
+    inline bool
+    operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b)
+    {
+      return !(a == b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,97 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <origin/memory/arena.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename T>
+  bool is_aligned(const T* p, std::size_t align)
+  {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+  }
+
+void
+check_arena()
+{
+  arena a(1024);
+  assert(a.capacity() == 0);
+
+  // Allocations are aligned and disjoint, across many chunks.
+  vector<char*> ps;
+  for (std::size_t i = 0; i != 1000; ++i) {
+    std::size_t align = std::size_t(1) << (i % 7);
+    char* p = static_cast<char*>(a.allocate(i % 100 + 1, align));
+    assert(is_aligned(p, align));
+    memset(p, int(i), i % 100 + 1);
+    ps.push_back(p);
+  }
+  for (std::size_t i = 0; i != 1000; ++i)
+    assert(ps[i][i % 100] == char(i));
+  assert(a.capacity() > 1024);
+
+  // Large allocations get chunks of their own.
+  char* big = static_cast<char*>(a.allocate(1 << 20, 64));
+  assert(is_aligned(big, 64));
+  memset(big, 0, 1 << 20);
+  std::size_t cap = a.capacity();
+
+  // Resetting reuses the retained chunks.
+  a.reset();
+  void* p = a.allocate(8);
+  assert(p == ps[0]);
+  for (std::size_t i = 0; i != 1000; ++i)
+    a.allocate(i % 100 + 1, std::size_t(1) << (i % 7));
+  a.allocate(1 << 20, 64);
+  assert(a.capacity() == cap);
+
+  a.release();
+  assert(a.capacity() == 0);
+  assert(a.allocate(0) != nullptr);
+}
+
+void
+check_allocator()
+{
+  using A = arena_allocator<double>;
+  static_assert(Allocator<A>(), "");
+  using B = std::allocator_traits<arena_allocator<char>>::rebind_alloc<int>;
+  static_assert(Same<B, arena_allocator<int>>(), "");
+
+  arena a;
+  arena b;
+  A x(a);
+  arena_allocator<int> y = x;
+  assert(x == y);
+  assert(x != A(b));
+
+  // Usable with standard containers.
+  vector<int, arena_allocator<int>> v(a);
+  for (int i = 0; i != 10000; ++i)
+    v.push_back(i);
+  assert(v[9999] == 9999);
+  list<int, arena_allocator<int>> l(a);
+  l.assign(100, 7);
+  map<int, int, less<int>, arena_allocator<pair<const int, int>>> m(a);
+  for (int i = 0; i != 100; ++i)
+    m[i] = i * i;
+  assert(m[9] == 81);
+}
+
+int main()
+{
+  check_arena();
+  check_allocator();
+}
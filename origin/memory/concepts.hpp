@@ -100,6 +100,14 @@ namespace origin
     }
 
 
+  // An alias for the allocator A rebound to allocate objects of type T. An
+  // allocating type that stores several kinds of objects takes a single
+  // allocator and rebinds it for each of its containers.
+  template <typename A, typename T>
+    using Rebind_allocator =
+      typename std::allocator_traits<A>::template rebind_alloc<T>;
+
+
   // Returns true iff T can be allocator-constructed over args...
   template <typename T, typename... Args>
     constexpr bool Allocator_constructible()
@@ -0,0 +1,126 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+#include "allocator.hpp"
+#include "huge_page.hpp"
+
+namespace origin
+{
+  namespace
+  {
+    // Returns n rounded up to a multiple of the page size.
+    inline std::size_t
+    page_round(std::size_t n, std::size_t page)
+    {
+      return (n + page - 1) / page * page;
+    }
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    // Map len bytes of explicit huge pages of the given size, returning
+    // null if none are available.
+    void*
+    map_explicit(std::size_t len, std::size_t page)
+    {
+      int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#  if defined(MAP_HUGE_SHIFT)
+      flags |= (page == huge_page_1gb ? 30 : 21) << MAP_HUGE_SHIFT;
+#  endif
+      void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+      return p == MAP_FAILED ? nullptr : p;
+    }
+#endif
+
+#if defined(__linux__)
+    // Map len bytes of ordinary memory aligned on a page boundary. The
+    // mapping is over-allocated by one page, and the unaligned ends are
+    // returned to the system.
+    void*
+    map_aligned(std::size_t len, std::size_t page)
+    {
+      void* p = ::mmap(nullptr, len + page, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+        throw std::bad_alloc();
+      char* first = static_cast<char*>(p);
+      char* last = first + len + page;
+      std::uintptr_t a = reinterpret_cast<std::uintptr_t>(first);
+      char* q = first + (page_round(a, page) - a);
+      if (q != first)
+        ::munmap(first, q - first);
+      if (q + len != last)
+        ::munmap(q + len, last - (q + len));
+      return q;
+    }
+#endif
+  } // namespace
+
+  void*
+  huge_allocate(std::size_t n, std::size_t page)
+  {
+    if (page != huge_page_2mb && page != huge_page_1gb)
+      throw std::invalid_argument("huge_allocate: invalid page size");
+    if (n < huge_page_2mb)
+      return aligned_allocate(n, 64);
+#if defined(__linux__)
+    std::size_t len = page_round(n, page);
+#  if defined(MAP_HUGETLB)
+    // A length that is a multiple of 1 GB is also a multiple of 2 MB, so
+    // 2 MB pages can stand in for 1 GB pages.
+    if (void* p = map_explicit(len, page))
+      return p;
+    if (page == huge_page_1gb)
+      if (void* p = map_explicit(len, huge_page_2mb))
+        return p;
+#  endif
+    void* p = map_aligned(len, page);
+    advise_huge_pages(p, len);
+    return p;
+#else
+    return aligned_allocate(n, huge_page_2mb);
+#endif
+  }
+
+  void
+  huge_deallocate(void* p, std::size_t n, std::size_t page)
+  {
+    if (!p)
+      return;
+    if (n < huge_page_2mb) {
+      aligned_deallocate(p);
+      return;
+    }
+#if defined(__linux__)
+    ::munmap(p, page_round(n, page));
+#else
+    aligned_deallocate(p);
+#endif
+  }
+
+  bool
+  advise_huge_pages(const void* p, std::size_t n)
+  {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(p);
+    std::uintptr_t last = (first + n) / huge_page_2mb * huge_page_2mb;
+    first = page_round(first, huge_page_2mb);
+    if (first >= last)
+      return false;
+    void* q = reinterpret_cast<void*>(first);
+    return ::madvise(q, last - first, MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+  }
+
+} // namespace origin
@@ -0,0 +1,137 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_HUGE_PAGE_HPP
+#define ORIGIN_MEMORY_HUGE_PAGE_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <origin/memory/concepts.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Huge page allocation                                        mem.huge_page
+  //
+  // Arrays of many gigabytes span millions of ordinary 4 KB pages, so
+  // traversing them misses the translation lookaside buffer (TLB) on almost
+  // every page. Backing them with 2 MB or 1 GB pages reduces the number of
+  // TLB entries needed by a factor of 512 or more.
+  //
+  // Huge pages are obtained in one of two ways. Explicit huge pages are
+  // taken from a pool reserved by the administrator, and are mapped with
+  // MAP_HUGETLB. Transparent huge pages are assembled by the kernel from
+  // ordinary memory, for mappings aligned on a huge page boundary that have
+  // been advised with MADV_HUGEPAGE.
+  constexpr std::size_t huge_page_2mb = std::size_t(1) << 21;
+  constexpr std::size_t huge_page_1gb = std::size_t(1) << 30;
+
+  // Allocate n bytes of memory backed by huge pages of the given size,
+  // which must be huge_page_2mb or huge_page_1gb. Explicit huge pages are
+  // used if they are available. Otherwise, the memory is aligned on a page
+  // boundary and advised for transparent huge pages, and if those are not
+  // supported either, the memory is backed by ordinary pages. Requests
+  // smaller than 2 MB are always served from ordinary memory. If the memory
+  // cannot be allocated, std::bad_alloc is thrown.
+  //
+  // Memory allocated by this function must be released by huge_deallocate,
+  // with the same size and page size.
+  void* huge_allocate(std::size_t n, std::size_t page = huge_page_2mb);
+
+  // Release the n bytes of memory pointed to by p, which were allocated by
+  // huge_allocate with the given page size.
+  void huge_deallocate(void* p, std::size_t n,
+                       std::size_t page = huge_page_2mb);
+
+  // Advise the system that the n bytes starting at p should be backed by
+  // transparent huge pages. Only the huge pages wholly within the range are
+  // affected. Returns false if the advice was not accepted.
+  bool advise_huge_pages(const void* p, std::size_t n);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Huge page allocator                                   mem.huge_allocator
+  //
+  // The huge page allocator allocates storage for objects of type T backed
+  // by huge pages of a given size. Every allocation of 2 MB or more is
+  // rounded up to a whole number of huge pages, so this allocator is
+  // intended for large arrays, such as the elements of a matrix or the
+  // vertex and edge lists of a large graph. For example:
+  //
+  //    using A = huge_page_allocator<double>;
+  //    matrix<double, 2, A> m(matrix_slice<2>(0, {n, n}), A(huge_page_1gb));
+  //
+  // Huge page allocators compare equal when they use the same page size.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  template <typename T>
+    class huge_page_allocator
+    {
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = huge_page_allocator<U>; };
+
+      // Construct an allocator using huge pages of the given size.
+      explicit
+      huge_page_allocator(std::size_t page = huge_page_2mb)
+        : page(page)
+      { }
+
+      template <typename U>
+        huge_page_allocator(const huge_page_allocator<U>& x)
+          : page(x.page_size())
+        { }
+
+      // Returns the size of the huge pages requested by the allocator.
+      std::size_t page_size() const { return page; }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        return static_cast<T*>(huge_allocate(n * sizeof(T), page));
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        huge_deallocate(p, n * sizeof(T), page);
+      }
+
+    private:
+      std::size_t page;
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U>
+    inline bool
+    operator==(const huge_page_allocator<T>& a, const huge_page_allocator<U>& b)
+    {
+      return a.page_size() == b.page_size();
+    }
+
+  template <typename T, typename U>
+    inline bool
+    operator!=(const huge_page_allocator<T>& a, const huge_page_allocator<U>& b)
+    {
+      return !(a == b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,71 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/memory/huge_page.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <std::size_t Align>
+  bool is_aligned(const void* p)
+  {
+    return reinterpret_cast<std::uintptr_t>(p) % Align == 0;
+  }
+
+// Allocate, write, and release arrays of several sizes using huge pages of
+// the given size.
+void check_allocate(size_t page)
+{
+  for (size_t n : {size_t(0), size_t(100), huge_page_2mb - 1, huge_page_2mb,
+                   3 * huge_page_2mb + 5}) {
+    char* p = static_cast<char*>(huge_allocate(n, page));
+    assert(is_aligned<64>(p));
+    if (n >= huge_page_2mb)
+      assert(is_aligned<huge_page_2mb>(p));
+    for (size_t i = 0; i < n; i += 512)
+      p[i] = char(i);
+    for (size_t i = 0; i < n; i += 512)
+      assert(p[i] == char(i));
+    huge_deallocate(p, n, page);
+  }
+}
+
+int main()
+{
+  check_allocate(huge_page_2mb);
+  check_allocate(huge_page_1gb);
+
+  // Only 2 MB and 1 GB pages are supported.
+  try {
+    huge_allocate(huge_page_2mb, 4096);
+    assert(false);
+  } catch (invalid_argument&) { }
+
+  // Advice covers only whole huge pages.
+  assert(!advise_huge_pages(nullptr, huge_page_2mb - 1));
+
+  using A = huge_page_allocator<double>;
+  static_assert(Allocator<A>(), "");
+  A a;
+  assert(a.page_size() == huge_page_2mb);
+  huge_page_allocator<int> b = a;
+  A c(huge_page_1gb);
+  assert(a == b && a != c);
+
+  // Containers grow through the allocator, from ordinary memory into huge
+  // pages.
+  vector<double, A> v(a);
+  for (int i = 0; i != 1000000; ++i)
+    v.push_back(i);
+  assert(v[999999] == 999999);
+  assert(is_aligned<huge_page_2mb>(v.data()));
+}
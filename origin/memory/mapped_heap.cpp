@@ -0,0 +1,584 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_heap.hpp"
+
+// Older C libraries do not define the flag. Kernels that do not support it
+// treat the address as a hint, which is checked after mapping.
+#if defined(__linux__) && !defined(MAP_FIXED_NOREPLACE)
+#  define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+namespace origin
+{
+  namespace mapped_heap_impl
+  {
+    // The smallest block and the page, which is the smallest chunk.
+    constexpr std::size_t min_block = 16;
+    constexpr std::size_t page = 4096;
+
+    // The greatest number of chunks of a heap.
+    constexpr std::size_t max_chunks = 16384;
+
+    // Returns the size class of a block of n bytes: blocks of class k have
+    // 2^k bytes.
+    inline std::size_t
+    size_class(std::size_t n)
+    {
+      std::size_t k = 4;
+      while ((std::size_t(1) << k) < n)
+        ++k;
+      return k;
+    }
+
+    inline std::size_t
+    round_up(std::size_t n, std::size_t a)
+    {
+      return (n + a - 1) / a * a;
+    }
+
+    void*
+    allocate(header* h, std::size_t n, std::size_t align)
+    {
+      char* base = reinterpret_cast<char*>(h);
+      std::size_t k = size_class(std::max(std::max(n, align), min_block));
+      std::size_t size = std::size_t(1) << k;
+      if (k >= 64)
+        throw std::bad_alloc();
+
+      // Blocks are aligned to their size, or to a page, so a free block
+      // serves any alignment up to a page.
+      if (h->free[k] != 0 && align <= page) {
+        std::uint64_t off = h->free[k];
+        std::memcpy(&h->free[k], base + off, sizeof(std::uint64_t));
+        return base + off;
+      }
+      std::size_t a = std::max(align, std::min(size, page));
+      std::size_t off = round_up(h->top, a);
+      if (off > h->capacity || h->capacity - off < size)
+        throw std::bad_alloc();
+      h->top = off + size;
+      return base + off;
+    }
+
+    void
+    deallocate(header* h, void* p, std::size_t n, std::size_t align)
+    {
+      if (!p)
+        return;
+      char* base = reinterpret_cast<char*>(h);
+      std::size_t k = size_class(std::max(std::max(n, align), min_block));
+      std::memcpy(p, &h->free[k], sizeof(std::uint64_t));
+      h->free[k] = static_cast<char*>(p) - base;
+    }
+
+
+    // A region is the mapping of a heap, divided into chunks of 2^shift
+    // bytes, with one bit for each chunk that has been written since the
+    // last checkpoint. The bits are set by the fault handler.
+    struct region
+    {
+      char*                       first;
+      std::size_t                 length;
+      std::size_t                 shift;
+      std::size_t                 chunks;
+      std::atomic<std::uint64_t>* changed;
+    };
+
+    namespace
+    {
+      // The regions of the open heaps. A slot is set when a heap is opened
+      // and cleared when it is closed; the fault handler reads them.
+      constexpr std::size_t max_regions = 64;
+      std::atomic<region*> regions[max_regions];
+      std::mutex regions_mutex;
+
+      struct sigaction previous;
+      bool installed = false;
+
+      // Restore the previous handler, so that the faulting instruction,
+      // when it is retried, is handled as if no heap were open.
+      void
+      fall_through(int sig, siginfo_t* info, void* context)
+      {
+        if (previous.sa_flags & SA_SIGINFO) {
+          if (previous.sa_sigaction) {
+            previous.sa_sigaction(sig, info, context);
+            return;
+          }
+        } else if (previous.sa_handler != SIG_DFL
+                   && previous.sa_handler != SIG_IGN) {
+          previous.sa_handler(sig);
+          return;
+        }
+        ::sigaction(sig, &previous, nullptr);
+      }
+
+      // Record the chunk written by a faulting instruction, and allow
+      // writes to it.
+      void
+      on_fault(int sig, siginfo_t* info, void* context)
+      {
+        char* p = static_cast<char*>(info->si_addr);
+        for (std::atomic<region*>& slot : regions) {
+          region* r = slot.load(std::memory_order_acquire);
+          if (!r || p < r->first || p >= r->first + r->length)
+            continue;
+          std::size_t c = (p - r->first) >> r->shift;
+          r->changed[c / 64].fetch_or(std::uint64_t(1) << (c % 64));
+          char* q = r->first + (c << r->shift);
+          std::size_t n = std::min(std::size_t(1) << r->shift,
+                                   r->length - (q - r->first));
+          if (::mprotect(q, n, PROT_READ | PROT_WRITE) != 0)
+            fall_through(sig, info, context);
+          return;
+        }
+        fall_through(sig, info, context);
+      }
+
+      void
+      add_region(region* r)
+      {
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        if (!installed) {
+          struct sigaction act;
+          std::memset(&act, 0, sizeof(act));
+          act.sa_sigaction = on_fault;
+          act.sa_flags = SA_SIGINFO;
+          sigemptyset(&act.sa_mask);
+          if (::sigaction(SIGSEGV, &act, &previous) != 0)
+            throw std::system_error(errno, std::system_category(),
+                                    "mapped_heap");
+          installed = true;
+        }
+        for (std::atomic<region*>& slot : regions) {
+          if (!slot.load(std::memory_order_relaxed)) {
+            slot.store(r, std::memory_order_release);
+            return;
+          }
+        }
+        throw std::runtime_error("mapped_heap: too many open heaps");
+      }
+
+      void
+      remove_region(region* r)
+      {
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        for (std::atomic<region*>& slot : regions)
+          if (slot.load(std::memory_order_relaxed) == r)
+            slot.store(nullptr, std::memory_order_release);
+      }
+
+
+      // The journal of a checkpoint is a header followed by records, each
+      // the offset and length of a run of changed chunks and their bytes.
+      // The header is written last, so that a journal whose header is
+      // missing or whose records do not match its checksum is discarded.
+      struct journal_header
+      {
+        char          magic[8]; // "ORIGINMJ"
+        std::uint64_t version;  // The version of the checkpoint
+        std::uint64_t records;  // The number of records
+        std::uint64_t checksum; // The checksum of the records
+      };
+
+      // Update the checksum h with the n bytes at p, n being a multiple of
+      // 8.
+      std::uint64_t
+      checksum(std::uint64_t h, const char* p, std::size_t n)
+      {
+        for (std::size_t i = 0; i != n; i += 8) {
+          std::uint64_t w;
+          std::memcpy(&w, p + i, 8);
+          h = (h ^ w) * 0x100000001b3ull;
+          h ^= h >> 29;
+        }
+        return h;
+      }
+
+      constexpr std::uint64_t checksum_seed = 0xcbf29ce484222325ull;
+
+      [[noreturn]] void
+      fail(const std::string& path)
+      {
+        throw std::system_error(errno, std::system_category(), path);
+      }
+
+      void
+      write_all(int fd, const char* p, std::size_t n, std::size_t off,
+                const std::string& path)
+      {
+        while (n != 0) {
+          ssize_t r = ::pwrite(fd, p, n, off);
+          if (r < 0 && errno == EINTR)
+            continue;
+          if (r < 0)
+            fail(path);
+          p += r;
+          n -= r;
+          off += r;
+        }
+      }
+
+      // Read n bytes at off into p, returning false if the file ends
+      // first.
+      bool
+      read_all(int fd, char* p, std::size_t n, std::size_t off,
+               const std::string& path)
+      {
+        while (n != 0) {
+          ssize_t r = ::pread(fd, p, n, off);
+          if (r < 0 && errno == EINTR)
+            continue;
+          if (r < 0)
+            fail(path);
+          if (r == 0)
+            return false;
+          p += r;
+          n -= r;
+          off += r;
+        }
+        return true;
+      }
+
+      void
+      sync(int fd, const std::string& path)
+      {
+        if (::fsync(fd) != 0)
+          fail(path);
+      }
+
+      // Returns a random address at which to map a new heap of n bytes,
+      // in the 64 TB above 16 TB, where there are usually no mappings.
+      std::uintptr_t
+      random_address(std::size_t n)
+      {
+        const std::uintptr_t first = std::uintptr_t(1) << 44;
+        const std::uintptr_t span = std::uintptr_t(1) << 46;
+        const std::uintptr_t step = std::uintptr_t(1) << 30;
+        if (sizeof(void*) < 8 || n >= span)
+          return 0;
+        std::random_device rd;
+        std::uint64_t r = (std::uint64_t(rd()) << 32) | rd();
+        return first + r % ((span - n) / step) * step;
+      }
+    } // namespace
+  } // namespace mapped_heap_impl
+
+
+  using namespace mapped_heap_impl;
+
+  mapped_heap::mapped_heap(const std::string& path, std::size_t capacity)
+    : path_(path), fd_(-1), base_(nullptr), capacity_(0), created_(false),
+      region_(nullptr)
+  {
+    open(capacity, true);
+  }
+
+  mapped_heap::mapped_heap(const std::string& path)
+    : path_(path), fd_(-1), base_(nullptr), capacity_(0), created_(false),
+      region_(nullptr)
+  {
+    open(0, false);
+  }
+
+  mapped_heap::~mapped_heap()
+  {
+    if (region_) {
+      remove_region(region_);
+      ::munmap(region_->changed, (region_->chunks + 63) / 64 * 8);
+      delete region_;
+    }
+    if (base_)
+      ::munmap(base_, capacity_);
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  // Open or create the heap. A file whose header was never written, as
+  // when the system fails while the heap is created, is created again, and
+  // the journal of a checkpoint that did not complete is applied to the
+  // file before it is mapped.
+  void
+  mapped_heap::open(std::size_t capacity, bool create)
+  {
+    fd_ = ::open(path_.c_str(), create ? O_RDWR | O_CREAT : O_RDWR, 0644);
+    if (fd_ < 0)
+      fail(path_);
+    try {
+      mapped_heap_impl::header h;
+      std::memset(&h, 0, sizeof(h));
+      read_all(fd_, reinterpret_cast<char*>(&h), sizeof(h), 0, path_);
+      if (h.magic[0] == 0) {
+        if (!create)
+          throw std::runtime_error(path_ + ": not a mapped heap");
+        create_heap(capacity);
+      } else {
+        recover();
+        read_all(fd_, reinterpret_cast<char*>(&h), sizeof(h), 0, path_);
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+          fail(path_);
+        if (std::memcmp(h.magic, "ORIGINMH", 8) != 0
+            || h.format != mapped_heap_impl::header::current_format
+            || h.capacity != std::uint64_t(st.st_size))
+          throw std::runtime_error(path_ + ": not a mapped heap");
+        capacity_ = h.capacity;
+        if (!map(h.base))
+          throw std::runtime_error(path_ + ": heap address in use");
+      }
+      track();
+    } catch (...) {
+      if (base_)
+        ::munmap(base_, capacity_);
+      base_ = nullptr;
+      ::close(fd_);
+      fd_ = -1;
+      throw;
+    }
+  }
+
+  // Initialize the file as an empty heap of the given capacity, mapped at a
+  // random address, and write its header.
+  void
+  mapped_heap::create_heap(std::size_t capacity)
+  {
+    ::unlink((path_ + ".journal").c_str());
+    capacity_ = round_up(std::max(capacity, 2 * page), page);
+    if (::ftruncate(fd_, 0) != 0 || ::ftruncate(fd_, capacity_) != 0)
+      fail(path_);
+    for (int i = 0; i != 8 && !base_; ++i)
+      map(random_address(capacity_));
+    if (!base_ && !map(0))
+      fail(path_);
+
+    mapped_heap_impl::header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "ORIGINMH", 8);
+    h.format = mapped_heap_impl::header::current_format;
+    h.base = reinterpret_cast<std::uintptr_t>(base_);
+    h.capacity = capacity_;
+    h.top = page;
+    write_all(fd_, reinterpret_cast<char*>(&h), sizeof(h), 0, path_);
+    sync(fd_, path_);
+    created_ = true;
+  }
+
+  // Map the file privately and read-only at the given address, or, if it
+  // is 0, wherever the system chooses. Returns false if the address is in
+  // use.
+  bool
+  mapped_heap::map(std::uintptr_t address)
+  {
+    int flags = MAP_PRIVATE;
+#if defined(__linux__)
+    if (address)
+      flags |= MAP_FIXED_NOREPLACE;
+#endif
+    void* p = ::mmap(reinterpret_cast<void*>(address), capacity_, PROT_READ,
+                     flags, fd_, 0);
+    if (p == MAP_FAILED) {
+      if (errno == EEXIST)
+        return false;
+      fail(path_);
+    }
+    if (address && reinterpret_cast<std::uintptr_t>(p) != address) {
+      ::munmap(p, capacity_);
+      return false;
+    }
+    base_ = static_cast<char*>(p);
+    return true;
+  }
+
+  // Register the mapping with the fault handler. The mapping is read-only,
+  // so the first write to each chunk is recorded.
+  void
+  mapped_heap::track()
+  {
+    std::size_t shift = 12;
+    while ((capacity_ >> shift) > max_chunks)
+      ++shift;
+    std::size_t chunks = (capacity_ + (std::size_t(1) << shift) - 1) >> shift;
+    std::size_t bytes = (chunks + 63) / 64 * 8;
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      throw std::bad_alloc();
+    region* r = new region {base_, capacity_, shift, chunks,
+                            static_cast<std::atomic<std::uint64_t>*>(p)};
+    try {
+      add_region(r);
+    } catch (...) {
+      ::munmap(p, bytes);
+      delete r;
+      throw;
+    }
+    region_ = r;
+  }
+
+  std::size_t
+  mapped_heap::changed() const
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i != (region_->chunks + 63) / 64; ++i)
+      for (std::uint64_t w = region_->changed[i].load(); w; w &= w - 1)
+        ++n;
+    return n;
+  }
+
+  // Write the changed chunks to the journal, in runs of adjacent chunks,
+  // and synchronize it; then write them to the file, synchronize it, and
+  // remove the journal. The version is incremented first, so that the
+  // header is among the changed chunks.
+  void
+  mapped_heap::checkpoint()
+  {
+    mapped_heap_impl::header* h = header();
+    std::uint64_t v = h->version;
+    h->version = v + 1;
+
+    std::vector<std::pair<std::size_t, std::size_t>> runs;
+    std::size_t chunk = std::size_t(1) << region_->shift;
+    for (std::size_t c = 0; c != region_->chunks; ++c) {
+      if (!(region_->changed[c / 64].load() & (std::uint64_t(1) << c % 64)))
+        continue;
+      std::size_t off = c * chunk;
+      std::size_t len = std::min(chunk, capacity_ - off);
+      if (!runs.empty() && runs.back().first + runs.back().second == off)
+        runs.back().second += len;
+      else
+        runs.emplace_back(off, len);
+    }
+
+    std::string jpath = path_ + ".journal";
+    try {
+      int j = ::open(jpath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (j < 0)
+        fail(jpath);
+      try {
+        journal_header jh;
+        std::size_t pos = sizeof(jh);
+        std::uint64_t sum = checksum_seed;
+        for (const auto& x : runs) {
+          std::uint64_t rec[2] = {x.first, x.second};
+          const char* r = reinterpret_cast<const char*>(rec);
+          write_all(j, r, sizeof(rec), pos, jpath);
+          write_all(j, base_ + x.first, x.second, pos + sizeof(rec), jpath);
+          pos += sizeof(rec) + x.second;
+          sum = checksum(sum, r, sizeof(rec));
+          sum = checksum(sum, base_ + x.first, x.second);
+        }
+        sync(j, jpath);
+        std::memcpy(jh.magic, "ORIGINMJ", 8);
+        jh.version = v + 1;
+        jh.records = runs.size();
+        jh.checksum = sum;
+        write_all(j, reinterpret_cast<char*>(&jh), sizeof(jh), 0, jpath);
+        sync(j, jpath);
+      } catch (...) {
+        ::close(j);
+        throw;
+      }
+      ::close(j);
+    } catch (...) {
+      ::unlink(jpath.c_str());
+      h->version = v;
+      throw;
+    }
+
+    // The checkpoint is committed. If it cannot be copied into the file, it
+    // is copied when the heap is next opened.
+    for (const auto& x : runs)
+      write_all(fd_, base_ + x.first, x.second, x.first, path_);
+    sync(fd_, path_);
+    ::unlink(jpath.c_str());
+
+    // Drop the private copies of the chunks, which are now read from the
+    // file, and protect them again.
+    for (const auto& x : runs) {
+      ::mprotect(base_ + x.first, x.second, PROT_READ);
+#if defined(MADV_DONTNEED)
+      ::madvise(base_ + x.first, x.second, MADV_DONTNEED);
+#endif
+    }
+    for (std::size_t i = 0; i != (region_->chunks + 63) / 64; ++i)
+      region_->changed[i].store(0);
+  }
+
+  // Apply the journal of a checkpoint to the file, if the journal is
+  // complete, and remove it. The records are verified before any of them
+  // is applied.
+  void
+  mapped_heap::recover()
+  {
+    std::string jpath = path_ + ".journal";
+    int j = ::open(jpath.c_str(), O_RDONLY);
+    if (j < 0) {
+      if (errno == ENOENT)
+        return;
+      fail(jpath);
+    }
+    try {
+      std::vector<char> buf(std::size_t(1) << 20);
+      journal_header jh;
+      bool valid = read_all(j, reinterpret_cast<char*>(&jh), sizeof(jh), 0,
+                            jpath)
+                && std::memcmp(jh.magic, "ORIGINMJ", 8) == 0;
+
+      // Scan the records, checking their sum on the first pass and
+      // applying them on the second.
+      for (int pass = 0; valid && pass != 2; ++pass) {
+        std::size_t pos = sizeof(jh);
+        std::uint64_t sum = checksum_seed;
+        for (std::uint64_t i = 0; valid && i != jh.records; ++i) {
+          std::uint64_t rec[2];
+          char* r = reinterpret_cast<char*>(rec);
+          valid = read_all(j, r, sizeof(rec), pos, jpath)
+               && rec[1] % 8 == 0;
+          sum = checksum(sum, r, sizeof(rec));
+          pos += sizeof(rec);
+          for (std::size_t k = 0; valid && k != rec[1]; ) {
+            std::size_t n = std::min<std::size_t>(buf.size(), rec[1] - k);
+            valid = read_all(j, buf.data(), n, pos, jpath);
+            if (pass == 0)
+              sum = checksum(sum, buf.data(), n);
+            else
+              write_all(fd_, buf.data(), n, rec[0] + k, path_);
+            pos += n;
+            k += n;
+          }
+        }
+        if (pass == 0)
+          valid = valid && sum == jh.checksum;
+      }
+      if (valid)
+        sync(fd_, path_);
+    } catch (...) {
+      ::close(j);
+      throw;
+    }
+    ::close(j);
+    ::unlink(jpath.c_str());
+  }
+
+} // namespace origin
@@ -0,0 +1,311 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_MAPPED_HEAP_HPP
+#define ORIGIN_MEMORY_MAPPED_HEAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <origin/memory/concepts.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Mapped heap                                               mem.mapped_heap
+  //
+  // A mapped heap is a heap whose memory is a file, mapped into the address
+  // space of the process, so that the data structures allocated in it
+  // outlive the process. Reopening the file maps it again without reading
+  // it; pages are read from the file as they are first used, so that a heap
+  // of any size is reopened in constant time. Containers allocate from the
+  // heap through a mapped allocator (see below):
+  //
+  //    mapped_heap h("graph.heap", std::size_t(1) << 40);
+  //    using G = undirected_adjacency_list<empty_t, int, std::size_t,
+  //                                        mapped_allocator<char>>;
+  //    G& g = h.root<G>(h.get_allocator<char>());
+  //    g.add_vertex();
+  //    h.checkpoint();
+  //
+  // The heap is always mapped at the same address, recorded in its file,
+  // so that the pointers stored in it remain valid when it is reopened. An
+  // address is chosen when the heap is created; if the address is in use
+  // when the heap is reopened, std::runtime_error is thrown. The objects
+  // in the heap must not refer to memory outside of it: their allocations
+  // must come from the heap, and they must not have virtual functions.
+  //
+  // One object of the heap, its root, is found by name when the heap is
+  // reopened: h.root<T>(args...) returns the root, constructing it from
+  // args if the heap has none. The root records only its size, which must
+  // be that of T when the heap is reopened.
+  //
+  // Checkpoints
+  // The file is changed only by checkpoints. Writes to the heap are made to
+  // a private copy of the mapping, and h.checkpoint() writes the parts of
+  // the heap changed since the last checkpoint to the file. A checkpoint
+  // is atomic: it is first written to a journal beside the file (its path
+  // with ".journal" appended), which is synchronized and then copied into
+  // the file, so that if the process or the system fails during a
+  // checkpoint, the heap is reopened either as of that checkpoint or as of
+  // the one before. Changes that have not been checkpointed are discarded
+  // when the heap is closed. The header of the heap records the number of
+  // checkpoints, its version.
+  //
+  // The changes are tracked in chunks of at least 4 KB, chosen so that a
+  // heap has at most 16384 chunks (16 MB for a heap of 256 GB). Every chunk
+  // is write-protected after a checkpoint, and the first write to a chunk
+  // is caught by a handler of SIGSEGV, which records the chunk and removes
+  // its protection; other faults are passed to the previous handler. A
+  // checkpoint writes the changed chunks whole, and then returns the
+  // memory of their private copies to the system.
+  //
+  // Allocation rounds each request up to a power of two, of at least 16
+  // bytes, and reuses freed blocks of the same size. A checkpoint may not
+  // be concurrent with writes, allocations, or other checkpoints, and
+  // allocations may not be concurrent with each other; the heap is meant
+  // for the bulk storage of large data structures, such as the pools and
+  // edge lists of a graph. If the heap is full, std::bad_alloc is thrown.
+  // A std::system_error is thrown if the file cannot be opened, mapped,
+  // or written, and a std::runtime_error if it is not a valid heap.
+  namespace mapped_heap_impl
+  {
+    // The header of a heap, at the start of its file and its mapping. The
+    // offsets are relative to the start of the heap.
+    struct header
+    {
+      static constexpr std::uint64_t current_format = 1;
+
+      char          magic[8];  // "ORIGINMH"
+      std::uint64_t format;    // Format version
+      std::uint64_t version;   // The number of checkpoints
+      std::uint64_t base;      // The address of the mapping
+      std::uint64_t capacity;  // The length of the file and the mapping
+      std::uint64_t top;       // The offset of the first unallocated byte
+      std::uint64_t root;      // The offset of the root object, or 0
+      std::uint64_t root_size; // The size of the root object
+      std::uint64_t free[64];  // The first free block of each size
+    };
+
+    // Allocate n bytes aligned to align from the heap whose header is h,
+    // which must not be null.
+    void* allocate(header* h, std::size_t n, std::size_t align);
+
+    // Return the n bytes at p, aligned to align, to the heap.
+    void deallocate(header* h, void* p, std::size_t n, std::size_t align);
+
+    // The mapping of a heap, as seen by the fault handler.
+    struct region;
+  } // namespace mapped_heap_impl
+
+
+  template <typename T>
+    class mapped_allocator;
+
+
+  class mapped_heap
+  {
+  public:
+    // Open the heap in the file at path, creating a heap of the given
+    // capacity, in bytes, if there is no such file.
+    mapped_heap(const std::string& path, std::size_t capacity);
+
+    // Open the heap in the file at path, which must exist.
+    explicit mapped_heap(const std::string& path);
+
+    mapped_heap(const mapped_heap&) = delete;
+    mapped_heap& operator=(const mapped_heap&) = delete;
+
+    // Unmap the heap, discarding the changes made since the last
+    // checkpoint.
+    ~mapped_heap();
+
+    // Observers
+    const std::string& path() const { return path_; }
+
+    // Returns true if the heap was created when it was opened.
+    bool created() const { return created_; }
+
+    // Returns the number of checkpoints of the heap.
+    std::uint64_t version() const { return header()->version; }
+
+    std::size_t capacity() const { return capacity_; }
+
+    // Returns the number of bytes allocated from the end of the heap,
+    // including its header and the free blocks.
+    std::size_t used() const { return header()->top; }
+
+    // Returns the number of chunks changed since the last checkpoint.
+    std::size_t changed() const;
+
+    // Allocation
+    void* allocate(std::size_t n,
+                   std::size_t align = alignof(std::max_align_t))
+    {
+      return mapped_heap_impl::allocate(header(), n, align);
+    }
+
+    void deallocate(void* p, std::size_t n,
+                    std::size_t align = alignof(std::max_align_t))
+    {
+      mapped_heap_impl::deallocate(header(), p, n, align);
+    }
+
+    // Returns an allocator of objects of type T in the heap.
+    template <typename T>
+      mapped_allocator<T> get_allocator() const;
+
+    // Returns the root object, constructing it from args if the heap has
+    // none.
+    template <typename T, typename... Args>
+      T& root(Args&&... args);
+
+    // Write the changes made since the last checkpoint to the file.
+    void checkpoint();
+
+  private:
+    mapped_heap_impl::header* header() const
+    {
+      return reinterpret_cast<mapped_heap_impl::header*>(base_);
+    }
+
+    void open(std::size_t capacity, bool create);
+    void create_heap(std::size_t capacity);
+    bool map(std::uintptr_t address);
+    void track();
+    void recover();
+
+  private:
+    std::string path_;
+    int         fd_;
+    char*       base_;
+    std::size_t capacity_;
+    bool        created_;
+
+    // The chunks changed since the last checkpoint, as seen by the fault
+    // handler.
+    mapped_heap_impl::region* region_;
+  };
+
+
+  template <typename T, typename... Args>
+    T&
+    mapped_heap::root(Args&&... args)
+    {
+      mapped_heap_impl::header* h = header();
+      if (h->root != 0) {
+        if (h->root_size != sizeof(T))
+          throw std::runtime_error("mapped_heap: wrong type of root");
+        return *reinterpret_cast<T*>(base_ + h->root);
+      }
+      void* p = allocate(sizeof(T), alignof(T));
+      try {
+        ::new (p) T(std::forward<Args>(args)...);
+      } catch (...) {
+        deallocate(p, sizeof(T), alignof(T));
+        throw;
+      }
+      h->root = static_cast<char*>(p) - base_;
+      h->root_size = sizeof(T);
+      return *static_cast<T*>(p);
+    }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Mapped allocator                                     mem.mapped_allocator
+  //
+  // The mapped allocator allocates storage for objects of type T from a
+  // mapped heap (see above). It refers to the heap by the address of its
+  // header, which is stored in the heap, so that containers allocated in a
+  // heap remain usable when it is reopened. A default constructed allocator
+  // refers to no heap, and throws std::bad_alloc if it allocates. Mapped
+  // allocators are equal when they refer to the same heap.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  template <typename T>
+    class mapped_allocator
+    {
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = mapped_allocator<U>; };
+
+      mapped_allocator()
+        : h(nullptr)
+      { }
+
+      explicit mapped_allocator(mapped_heap_impl::header* h)
+        : h(h)
+      { }
+
+      template <typename U>
+        mapped_allocator(const mapped_allocator<U>& x)
+          : h(x.heap_header())
+        { }
+
+      // Returns the header of the heap.
+      mapped_heap_impl::header* heap_header() const { return h; }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        if (!h)
+          throw std::bad_alloc();
+        return static_cast<T*>(
+          mapped_heap_impl::allocate(h, n * sizeof(T), alignof(T)));
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        mapped_heap_impl::deallocate(h, p, n * sizeof(T), alignof(T));
+      }
+
+    private:
+      mapped_heap_impl::header* h;
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U>
+    inline bool
+    operator==(const mapped_allocator<T>& a, const mapped_allocator<U>& b)
+    {
+      return a.heap_header() == b.heap_header();
+    }
+
+  template <typename T, typename U>
+    inline bool
+    operator!=(const mapped_allocator<T>& a, const mapped_allocator<U>& b)
+    {
+      return !(a == b);
+    }
+
+
+  template <typename T>
+    inline mapped_allocator<T>
+    mapped_heap::get_allocator() const
+    {
+      return mapped_allocator<T>(header());
+    }
+
+} // namespace origin
+
+#endif
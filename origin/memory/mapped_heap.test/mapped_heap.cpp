@@ -0,0 +1,245 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <origin/memory/mapped_heap.hpp>
+
+using namespace std;
+using namespace origin;
+
+const char* path = "origin.memory.mapped_heap.test.heap";
+const string journal = string(path) + ".journal";
+const size_t capacity = size_t(64) << 20;
+
+// The root of the test heap: an array of n words allocated in the heap.
+struct root_type
+{
+  root_type(const mapped_allocator<uint64_t>& a = {})
+    : alloc(a), data(nullptr), n(0)
+  { }
+
+  mapped_allocator<uint64_t> alloc;
+  uint64_t* data;
+  size_t n;
+};
+
+void
+remove_heap()
+{
+  std::remove(path);
+  std::remove(journal.c_str());
+}
+
+// Returns true if the words of the root are 0, 1, ..., n - 1, plus k.
+bool
+holds(const root_type& r, size_t n, uint64_t k)
+{
+  if (r.n != n)
+    return false;
+  for (size_t i = 0; i != n; ++i)
+    if (r.data[i] != i + k)
+      return false;
+  return true;
+}
+
+// Run f in a child process, which exits without closing the heap.
+template <typename F>
+  void
+  in_child(F f)
+  {
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+      f();
+      _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+// Blocks are rounded up to powers of two and reused.
+void
+check_allocate()
+{
+  remove_heap();
+  mapped_heap h(path, capacity);
+  assert(h.created() && h.version() == 0 && h.capacity() == capacity);
+  void* p = h.allocate(100);
+  assert(reinterpret_cast<uintptr_t>(p) % 128 == 0);
+  void* q = h.allocate(5000, 64);
+  assert(reinterpret_cast<uintptr_t>(q) % 4096 == 0);
+  h.deallocate(p, 100);
+  assert(h.allocate(128) == p);
+  try {
+    h.allocate(capacity);
+    assert(false);
+  } catch (bad_alloc&) { }
+
+  // A default allocator refers to no heap.
+  try {
+    mapped_allocator<int>().allocate(1);
+    assert(false);
+  } catch (bad_alloc&) { }
+}
+
+// The heap is reopened as of its last checkpoint, at the same address.
+void
+check_checkpoint()
+{
+  remove_heap();
+  const size_t n = 100000;
+  uint64_t* data;
+  {
+    mapped_heap h(path, capacity);
+    root_type& r = h.root<root_type>(h.get_allocator<uint64_t>());
+    r.data = data = r.alloc.allocate(n);
+    for (size_t i = 0; i != n; ++i)
+      r.data[i] = i;
+    r.n = n;
+    assert(h.changed() != 0);
+    h.checkpoint();
+    assert(h.version() == 1 && h.changed() == 0);
+
+    // Changes after the last checkpoint are discarded.
+    r.data[5] = 0;
+    r.n = 1;
+    assert(h.changed() == 2);
+  }
+  {
+    mapped_heap h(path);
+    assert(!h.created() && h.version() == 1);
+    root_type& r = h.root<root_type>();
+    assert(r.data == data && holds(r, n, 0));
+    for (size_t i = 0; i != n; ++i)
+      ++r.data[i];
+    h.checkpoint();
+    assert(holds(r, n, 1));
+  }
+  {
+    mapped_heap h(path);
+    assert(h.version() == 2 && holds(h.root<root_type>(), n, 1));
+
+    // The root has a fixed size.
+    try {
+      h.root<double>();
+      assert(false);
+    } catch (runtime_error&) { }
+
+    // The address of an open heap cannot be used by another.
+    try {
+      mapped_heap g(path);
+      assert(false);
+    } catch (runtime_error&) { }
+  }
+}
+
+// A process that fails between checkpoints, or while writing a journal,
+// leaves the heap as of its last checkpoint. A process that fails while
+// copying a complete journal into the heap leaves the heap as of that
+// checkpoint.
+void
+check_recovery()
+{
+  remove_heap();
+  const size_t n = capacity / 16;
+  {
+    mapped_heap h(path, capacity);
+    root_type& r = h.root<root_type>(h.get_allocator<uint64_t>());
+    r.data = r.alloc.allocate(n);
+    for (size_t i = 0; i != n; ++i)
+      r.data[i] = i;
+    r.n = n;
+    h.checkpoint();
+  }
+
+  in_child([] {
+    mapped_heap h(path);
+    root_type& r = h.root<root_type>();
+    for (size_t i = 0; i != r.n; ++i)
+      r.data[i] += 7;
+  });
+  {
+    mapped_heap h(path);
+    assert(h.version() == 1 && holds(h.root<root_type>(), n, 0));
+  }
+
+  // A journal that was not completed is discarded.
+  {
+    ofstream f(journal, ios::binary);
+    f << "ORIGINMJ and then some";
+  }
+  {
+    mapped_heap h(path);
+    assert(h.version() == 1 && holds(h.root<root_type>(), n, 0));
+  }
+  assert(!ifstream(journal));
+
+  // Limit the size of the files written by the child, so that the journal
+  // of its checkpoint, which holds the header and the last chunk, is
+  // written, but the last chunk cannot be copied into the heap.
+  in_child([] {
+    mapped_heap h(path);
+    root_type& r = h.root<root_type>();
+    r.data[r.n - 1] = 0;
+    signal(SIGXFSZ, SIG_IGN);
+    rlimit lim = {capacity / 2, capacity / 2};
+    setrlimit(RLIMIT_FSIZE, &lim);
+    try {
+      h.checkpoint();
+      _exit(1);
+    } catch (system_error&) { }
+  });
+  assert(ifstream(journal));
+  {
+    mapped_heap h(path);
+    root_type& r = h.root<root_type>();
+    assert(h.version() == 2 && r.data[n - 1] == 0 && r.data[n - 2] == n - 2);
+  }
+  assert(!ifstream(journal));
+}
+
+// Opening a file that is not a heap fails.
+void
+check_errors()
+{
+  remove_heap();
+  try {
+    mapped_heap h(path);
+    assert(false);
+  } catch (system_error&) { }
+
+  {
+    ofstream f(path, ios::binary);
+    f << "not a heap";
+  }
+  try {
+    mapped_heap h(path);
+    assert(false);
+  } catch (runtime_error&) { }
+  remove_heap();
+}
+
+int main()
+{
+  check_allocate();
+  check_checkpoint();
+  check_recovery();
+  check_errors();
+}
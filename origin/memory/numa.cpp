@@ -0,0 +1,150 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#include "allocator.hpp"
+#include "numa.hpp"
+
+namespace origin
+{
+  namespace
+  {
+    // Returns the number of nodes listed in the online node file, which
+    // holds a list of ranges such as "0-3" or "0,2-5".
+    std::size_t
+    read_nodes()
+    {
+#if defined(__linux__)
+      std::ifstream f("/sys/devices/system/node/online");
+      std::string s;
+      if (!(f >> s))
+        return 1;
+      std::size_t n = 0;
+      std::size_t x = 0;
+      for (char c : s) {
+        if (c >= '0' && c <= '9') {
+          x = x * 10 + (c - '0');
+        } else {
+          n = std::max(n, x + 1);
+          x = 0;
+        }
+      }
+      return std::max(n, x + 1);
+#else
+      return 1;
+#endif
+    }
+
+#if defined(__linux__)
+    // The memory policy modes of mbind.
+    constexpr int mpol_bind = 2;
+    constexpr int mpol_interleave = 3;
+
+    // Returns the size of a page.
+    inline std::size_t
+    page_size()
+    {
+      static const std::size_t n = sysconf(_SC_PAGESIZE);
+      return n;
+    }
+
+    // Returns n rounded up to a whole number of pages, and at least one.
+    inline std::size_t
+    page_round(std::size_t n)
+    {
+      std::size_t p = page_size();
+      return n ? (n + p - 1) / p * p : p;
+    }
+
+    // Apply the placement policy p to the n bytes at addr. The call is made
+    // directly so that libnuma is not required. Failures are ignored, since
+    // the memory is still usable with the default policy.
+    void
+    place(void* addr, std::size_t n, numa_policy p, std::size_t node)
+    {
+#  if defined(SYS_mbind)
+      if (p == numa_policy::first_touch)
+        return;
+      constexpr std::size_t bits = 8 * sizeof(unsigned long);
+      std::size_t nodes = numa_nodes();
+      std::vector<unsigned long> mask(nodes / bits + 1);
+      int mode;
+      if (p == numa_policy::interleave) {
+        mode = mpol_interleave;
+        for (std::size_t i = 0; i != nodes; ++i)
+          mask[i / bits] |= 1ul << (i % bits);
+      } else {
+        mode = mpol_bind;
+        mask[node / bits] |= 1ul << (node % bits);
+      }
+      syscall(SYS_mbind, addr, n, mode, mask.data(), nodes + 1, 0);
+#  endif
+    }
+#endif
+  } // namespace
+
+  std::size_t
+  numa_nodes()
+  {
+    static const std::size_t n = read_nodes();
+    return n;
+  }
+
+  std::size_t
+  numa_node()
+  {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && node < numa_nodes())
+      return node;
+#endif
+    return 0;
+  }
+
+  void*
+  numa_allocate(std::size_t n, numa_policy p, std::size_t node)
+  {
+    if (p == numa_policy::bind && node >= numa_nodes())
+      throw std::invalid_argument("numa_allocate: invalid node");
+#if defined(__linux__)
+    std::size_t len = page_round(n);
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+      throw std::bad_alloc();
+    place(addr, len, p, node);
+    return addr;
+#else
+    return aligned_allocate(n, 4096);
+#endif
+  }
+
+  void
+  numa_deallocate(void* p, std::size_t n)
+  {
+    if (!p)
+      return;
+#if defined(__linux__)
+    munmap(p, page_round(n));
+#else
+    aligned_deallocate(p);
+#endif
+  }
+
+} // namespace origin
@@ -0,0 +1,172 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_NUMA_HPP
+#define ORIGIN_MEMORY_NUMA_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <origin/memory/concepts.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // NUMA topology                                                    mem.numa
+  //
+  // On a non-uniform memory access (NUMA) machine, memory is divided into
+  // nodes, each attached to a group of processors. Accessing memory on a
+  // remote node is slower than accessing local memory, so large arrays that
+  // are processed in parallel should be placed near the threads that use
+  // them.
+  //
+  // Returns the number of memory nodes of the system. This is 1 on machines
+  // that are not NUMA, or when the topology cannot be determined.
+  std::size_t numa_nodes();
+
+  // Returns the memory node local to the processor running the calling
+  // thread, or 0 when it cannot be determined.
+  std::size_t numa_node();
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // NUMA placement                                            mem.numa_policy
+  //
+  // A placement policy determines the node on which each page of allocated
+  // memory is placed.
+  //
+  //    first_touch -- Each page is placed on the node of the thread that
+  //                   first writes to it. Initializing an array in parallel,
+  //                   with the partitioning later used to process it, places
+  //                   each part near its thread.
+  //    interleave  -- Pages are distributed round-robin over all nodes. This
+  //                   balances bandwidth for data shared by every thread.
+  //    bind        -- Pages are placed on a single, given node.
+  enum class numa_policy
+  {
+    first_touch,
+    interleave,
+    bind
+  };
+
+  // Allocate n bytes of page-aligned memory placed according to the policy
+  // p. The node argument is used only by the bind policy, and must be less
+  // than numa_nodes(), or std::invalid_argument is thrown. If the memory
+  // cannot be allocated, std::bad_alloc is thrown.
+  //
+  // Placement is a hint: when the system does not support memory policies,
+  // the memory is allocated with the default (first touch) placement.
+  void* numa_allocate(std::size_t n, numa_policy p, std::size_t node = 0);
+
+  // Release the n bytes of memory pointed to by p, which must have been
+  // allocated by numa_allocate.
+  void numa_deallocate(void* p, std::size_t n);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // NUMA allocator                                         mem.numa_allocator
+  //
+  // The NUMA allocator allocates storage for objects of type T, placing its
+  // pages according to a placement policy. Every allocation is mapped
+  // directly from the system and rounded up to a whole number of pages, so
+  // this allocator is intended for large arrays such as the elements of a
+  // matrix or the vertex and edge lists of a graph, not for node-based
+  // containers. For example:
+  //
+  //    using A = numa_allocator<double>;
+  //    matrix<double, 2, A> m(matrix_slice<2>(0, {n, n}), A::interleaved());
+  //
+  // Memory allocated by any NUMA allocator can be deallocated by any other,
+  // so all NUMA allocators compare equal. The policy only affects where
+  // newly allocated pages are placed.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  template <typename T>
+    class numa_allocator
+    {
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = numa_allocator<U>; };
+
+      // Construct an allocator with the placement policy p. The node is
+      // used only by the bind policy.
+      explicit
+      numa_allocator(numa_policy p = numa_policy::first_touch,
+                     std::size_t node = 0)
+        : pol(p), nd(node)
+      { }
+
+      template <typename U>
+        numa_allocator(const numa_allocator<U>& x)
+          : pol(x.policy()), nd(x.node())
+        { }
+
+      // Returns an allocator that interleaves pages over all nodes.
+      static numa_allocator interleaved()
+      {
+        return numa_allocator(numa_policy::interleave);
+      }
+
+      // Returns an allocator that places pages on the given node.
+      static numa_allocator bound(std::size_t node)
+      {
+        return numa_allocator(numa_policy::bind, node);
+      }
+
+      // Returns the placement policy.
+      numa_policy policy() const { return pol; }
+
+      // Returns the node used by the bind policy.
+      std::size_t node() const { return nd; }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        return static_cast<T*>(numa_allocate(n * sizeof(T), pol, nd));
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        numa_deallocate(p, n * sizeof(T));
+      }
+
+    private:
+      numa_policy pol;
+      std::size_t nd;
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U>
+    inline bool
+    operator==(const numa_allocator<T>&, const numa_allocator<U>&)
+    {
+      return true;
+    }
+
+  template <typename T, typename U>
+    inline bool
+    operator!=(const numa_allocator<T>&, const numa_allocator<U>&)
+    {
+      return false;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,89 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <origin/memory/numa.hpp>
+
+using namespace std;
+using namespace origin;
+
+bool is_page_aligned(const void* p)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % 4096 == 0;
+}
+
+// Allocate, write, and release arrays of several sizes with the policy p.
+void check_policy(numa_policy p, size_t node = 0)
+{
+  for (size_t n : {0, 1, 4095, 4096, 1 << 20}) {
+    char* q = static_cast<char*>(numa_allocate(n, p, node));
+    assert(is_page_aligned(q));
+    for (size_t i = 0; i < n; ++i)
+      q[i] = char(i);
+    for (size_t i = 0; i < n; ++i)
+      assert(q[i] == char(i));
+    numa_deallocate(q, n);
+  }
+}
+
+int main()
+{
+  size_t nodes = numa_nodes();
+  assert(nodes >= 1);
+  assert(numa_node() < nodes);
+
+  check_policy(numa_policy::first_touch);
+  check_policy(numa_policy::interleave);
+  for (size_t i = 0; i != nodes; ++i)
+    check_policy(numa_policy::bind, i);
+
+  // Binding to a node that does not exist is an error.
+  try {
+    numa_allocate(1, numa_policy::bind, nodes);
+    assert(false);
+  } catch (invalid_argument&) { }
+
+  using A = numa_allocator<double>;
+  static_assert(Allocator<A>(), "");
+  A a;
+  assert(a.policy() == numa_policy::first_touch);
+  A b = A::bound(nodes - 1);
+  assert(b.policy() == numa_policy::bind && b.node() == nodes - 1);
+
+  // Rebinding preserves the policy, and all allocators are interchangeable.
+  numa_allocator<int> c = A::interleaved();
+  assert(c.policy() == numa_policy::interleave);
+  assert(a == b && a == c);
+  double* p = b.allocate(1000);
+  a.deallocate(p, 1000);
+
+  // Containers grow through the allocator.
+  vector<int, numa_allocator<int>> v(c);
+  for (int i = 0; i != 100000; ++i)
+    v.push_back(i);
+  assert(v.back() == 99999 && is_page_aligned(v.data()));
+
+  // Pages of a first touch array are written by several threads.
+  vector<thread> ts;
+  size_t n = 1 << 22;
+  char* q = static_cast<char*>(numa_allocate(n, numa_policy::first_touch));
+  for (size_t t = 0; t != 4; ++t)
+    ts.emplace_back([=]() {
+      for (size_t i = t * n / 4; i != (t + 1) * n / 4; ++i)
+        q[i] = 1;
+    });
+  for (thread& t : ts)
+    t.join();
+  for (size_t i = 0; i != n; i += 4096)
+    assert(q[i] == 1);
+  numa_deallocate(q, n);
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <mutex>
+
+#include "pool.hpp"
+
+namespace origin
+{
+  namespace
+  {
+    // The block sizes of each size class.
+    constexpr std::size_t classes = 14;
+    constexpr std::size_t sizes[classes] = {
+      16, 32, 48, 64, 80, 96, 112, 128, 192, 256, 384, 512, 768, 1024
+    };
+
+    // The number of blocks in a batch, and the size of a slab.
+    constexpr std::size_t batch = 32;
+    constexpr std::size_t slab_size = 1 << 16;
+
+    // Returns the size class of a request for n bytes, 0 < n <= 1024.
+    inline std::size_t
+    size_class(std::size_t n)
+    {
+      if (n <= 128)
+        return (n - 1) / 16;
+      std::size_t c = 8;
+      while (sizes[c] < n)
+        ++c;
+      return c;
+    }
+
+    // A free block. Blocks are chained into batches by next, and the first
+    // block of each batch in the depot links to the next batch.
+    struct block
+    {
+      block* next;
+      block* batch;
+    };
+
+    // The depot holds batches of free blocks of each size class, and the
+    // slabs from which blocks are carved. The slabs are chained through
+    // their first word, ahead of their blocks.
+    struct depot
+    {
+      std::mutex m[classes];
+      block* batches[classes];
+      std::mutex slab_m;
+      void* slabs;
+
+      // Take a batch of blocks of class c, or null if there is none.
+      block* pop(std::size_t c)
+      {
+        std::lock_guard<std::mutex> lock(m[c]);
+        block* b = batches[c];
+        if (b)
+          batches[c] = b->batch;
+        return b;
+      }
+
+      // Add a batch of blocks of class c.
+      void push(std::size_t c, block* b)
+      {
+        std::lock_guard<std::mutex> lock(m[c]);
+        b->batch = batches[c];
+        batches[c] = b;
+      }
+
+      // Carve a new slab into a chain of blocks of class c.
+      block* carve(std::size_t c)
+      {
+        char* s = static_cast<char*>(aligned_allocate(slab_size, 64));
+        {
+          std::lock_guard<std::mutex> lock(slab_m);
+          *reinterpret_cast<void**>(s) = slabs;
+          slabs = s;
+        }
+        std::size_t n = (slab_size - 64) / sizes[c];
+        char* p = s + 64;
+        block* first = reinterpret_cast<block*>(p);
+        for (std::size_t i = 1; i != n; ++i, p += sizes[c])
+          reinterpret_cast<block*>(p)->next
+            = reinterpret_cast<block*>(p + sizes[c]);
+        reinterpret_cast<block*>(p)->next = nullptr;
+        return first;
+      }
+    };
+
+    // The depot is never destroyed, so that it outlives the magazines of
+    // every thread.
+    depot&
+    the_depot()
+    {
+      static depot* d = new depot();
+      return *d;
+    }
+
+    // The magazines of a thread hold up to two batches of the free blocks
+    // of each size class.
+    struct thread_cache
+    {
+      thread_cache()
+        : d(the_depot()), count()
+      { }
+
+      ~thread_cache()
+      {
+        for (std::size_t c = 0; c != classes; ++c)
+          while (count[c] != 0)
+            flush(c, std::min(count[c], batch));
+        dead = true;
+      }
+
+      void* allocate(std::size_t c)
+      {
+        if (count[c] == 0)
+          refill(c);
+        return items[c][--count[c]];
+      }
+
+      void deallocate(std::size_t c, void* p)
+      {
+        if (count[c] == 2 * batch)
+          flush(c, batch);
+        items[c][count[c]++] = p;
+      }
+
+      // Move a batch from the depot, or a new slab, to the magazine.
+      void refill(std::size_t c)
+      {
+        block* b = d.pop(c);
+        if (!b)
+          b = d.carve(c);
+        while (b && count[c] != batch) {
+          items[c][count[c]++] = b;
+          b = b->next;
+        }
+        if (b)
+          d.push(c, b);
+      }
+
+      // Return n blocks from the magazine to the depot.
+      void flush(std::size_t c, std::size_t n)
+      {
+        block* b = nullptr;
+        for (; n != 0; --n) {
+          block* x = static_cast<block*>(items[c][--count[c]]);
+          x->next = b;
+          b = x;
+        }
+        d.push(c, b);
+      }
+
+      static thread_local bool dead;
+
+      depot& d;
+      std::size_t count[classes];
+      void* items[classes][2 * batch];
+    };
+
+    thread_local bool thread_cache::dead = false;
+
+    thread_local thread_cache cache;
+  } // namespace
+
+
+  void*
+  pool_allocate(std::size_t n)
+  {
+    if (n > pool_max_size)
+      return ::operator new(n);
+    std::size_t c = size_class(n == 0 ? 1 : n);
+    if (thread_cache::dead) {
+      // The thread is exiting; take a block directly from the depot.
+      depot& d = the_depot();
+      block* b = d.pop(c);
+      if (!b)
+        b = d.carve(c);
+      if (b->next)
+        d.push(c, b->next);
+      return b;
+    }
+    return cache.allocate(c);
+  }
+
+  void
+  pool_deallocate(void* p, std::size_t n)
+  {
+    if (n > pool_max_size) {
+      ::operator delete(p);
+      return;
+    }
+    std::size_t c = size_class(n == 0 ? 1 : n);
+    if (thread_cache::dead) {
+      block* b = static_cast<block*>(p);
+      b->next = nullptr;
+      the_depot().push(c, b);
+      return;
+    }
+    cache.deallocate(c, p);
+  }
+
+} // namespace origin
@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_POOL_HPP
+#define ORIGIN_MEMORY_POOL_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <origin/memory/allocator.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Pool allocation                                                  mem.pool
+  //
+  // Pool allocation serves small requests from blocks of a fixed set of size
+  // classes: multiples of 16 bytes up to 128, then 192, 256, 384, 512, 768
+  // and 1024 bytes. Larger requests are served by operator new. Blocks are
+  // aligned to pool_alignment bytes.
+  //
+  // Each thread caches the free blocks of each size class (its magazine),
+  // so that most allocations and deallocations take no locks. When a
+  // thread's magazine is empty, it takes a batch of blocks from a shared
+  // depot, which carves new blocks from 64 KiB slabs as needed; when the
+  // magazine is full, it returns a batch of blocks to the depot. The
+  // magazine holds up to two batches, so that a thread alternating between
+  // allocation and deallocation does not repeatedly visit the depot.
+  // Blocks freed by a thread other than the one that allocated them are
+  // cached by the freeing thread. When a thread exits, its magazines are
+  // returned to the depot. Slabs are never returned to the system.
+  //
+  // The size passed to pool_deallocate must be the size passed to the
+  // pool_allocate call that returned the block.
+  constexpr std::size_t pool_alignment = 16;
+  constexpr std::size_t pool_max_size = 1024;
+
+  // Allocate n bytes from the pool.
+  void* pool_allocate(std::size_t n);
+
+  // Release the n bytes pointed to by p to the pool.
+  void pool_deallocate(void* p, std::size_t n);
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Pool allocator                                          mem.pool_allocator
+  //
+  // The pool allocator allocates storage for objects of type T by pool
+  // allocation. It is suited to node-based containers and to the many small
+  // vectors of adjacency structures. All pool allocators are
+  // interchangeable; memory allocated by one can be deallocated by any
+  // other, on any thread.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  template <typename T>
+    class pool_allocator
+    {
+      static_assert(alignof(T) <= pool_alignment,
+                    "alignment is too large for pool allocation");
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = pool_allocator<U>; };
+
+      pool_allocator() = default;
+
+      template <typename U>
+        pool_allocator(const pool_allocator<U>&) { }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        return static_cast<T*>(pool_allocate(n * sizeof(T)));
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        pool_deallocate(p, n * sizeof(T));
+      }
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U>
+    inline bool
+    operator==(const pool_allocator<T>&, const pool_allocator<U>&)
+    {
+      return true;
+    }
+
+  template <typename T, typename U>
+    inline bool
+    operator!=(const pool_allocator<T>&, const pool_allocator<U>&)
+    {
+      return false;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,130 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <origin/memory/pool.hpp>
+
+using namespace std;
+using namespace origin;
+
+bool is_aligned(const void* p)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % pool_alignment == 0;
+}
+
+void
+check_pool()
+{
+  // Blocks are aligned and disjoint for every size class, and for large
+  // requests.
+  vector<pair<char*, size_t>> ps;
+  for (size_t n = 0; n <= 2 * pool_max_size; n += 3) {
+    char* p = static_cast<char*>(pool_allocate(n));
+    assert(is_aligned(p));
+    memset(p, int(n), n);
+    ps.push_back(make_pair(p, n));
+  }
+  for (auto x : ps) {
+    for (size_t i = 0; i != x.second; ++i)
+      assert(x.first[i] == char(x.second));
+    pool_deallocate(x.first, x.second);
+  }
+
+  // Freed blocks are reused.
+  void* p = pool_allocate(40);
+  pool_deallocate(p, 40);
+  assert(pool_allocate(48) == p);
+  pool_deallocate(p, 48);
+
+  // Many blocks of one size class come from several slabs.
+  set<void*> s;
+  vector<void*> v;
+  for (int i = 0; i != 20000; ++i) {
+    v.push_back(pool_allocate(64));
+    s.insert(v.back());
+  }
+  assert(s.size() == v.size());
+  for (void* x : v)
+    pool_deallocate(x, 64);
+}
+
+void
+check_allocator()
+{
+  using A = pool_allocator<double>;
+  static_assert(Allocator<A>(), "");
+  using B = std::allocator_traits<pool_allocator<char>>::rebind_alloc<int>;
+  static_assert(Same<B, pool_allocator<int>>(), "");
+  assert(A() == pool_allocator<int>());
+
+  list<int, pool_allocator<int>> l(1000, 3);
+  map<int, int, less<int>, pool_allocator<pair<const int, int>>> m;
+  for (int i = 0; i != 1000; ++i)
+    m[i] = i;
+  assert(m.size() == 1000 && m[7] == 7);
+  vector<vector<int, pool_allocator<int>>> vs(100);
+  for (int i = 0; i != 100; ++i)
+    vs[i].assign(i, i);
+  assert(vs[99].size() == 99 && vs[99][0] == 99);
+}
+
+// Blocks allocated by one thread can be freed by another, and each thread
+// returns its magazines when it exits.
+void
+check_threads()
+{
+  const int n = 4;
+  vector<vector<int*>> out(n);
+  vector<thread> ts;
+  for (int t = 0; t != n; ++t)
+    ts.emplace_back([&out, t]() {
+      for (int i = 0; i != 10000; ++i) {
+        int* p = static_cast<int*>(pool_allocate(sizeof(int) * (i % 8 + 1)));
+        *p = t * 10000 + i;
+        if (i % 3 == 0)
+          pool_deallocate(p, sizeof(int) * (i % 8 + 1));
+        else
+          out[t].push_back(p);
+      }
+    });
+  for (thread& t : ts)
+    t.join();
+  ts.clear();
+
+  // Each thread frees the blocks of another.
+  for (int t = 0; t != n; ++t)
+    ts.emplace_back([&out, t, n]() {
+      vector<int*>& v = out[(t + 1) % n];
+      int u = (t + 1) % n;
+      int k = 0;
+      for (int i = 0; i != 10000; ++i) {
+        if (i % 3 == 0)
+          continue;
+        int* p = v[k++];
+        assert(*p == u * 10000 + i);
+        pool_deallocate(p, sizeof(int) * (i % 8 + 1));
+      }
+    });
+  for (thread& t : ts)
+    t.join();
+}
+
+int main()
+{
+  check_pool();
+  check_allocator();
+  check_threads();
+}
@@ -0,0 +1,176 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+
+#include "resource.hpp"
+#include "pool.hpp"
+
+namespace origin
+{
+  memory_resource::~memory_resource()
+  { }
+
+  namespace
+  {
+    // Allocations aligned to more than max_align_t, or to more than the
+    // alignment of a strategy, are served by aligned_allocate, whose
+    // alignment must be at least that of a pointer.
+    void*
+    over_aligned_allocate(std::size_t n, std::size_t align)
+    {
+      return aligned_allocate(n, align < sizeof(void*) ? sizeof(void*) : align);
+    }
+
+    class new_delete : public memory_resource
+    {
+      void* do_allocate(std::size_t n, std::size_t align) override
+      {
+        if (align <= alignof(std::max_align_t))
+          return ::operator new(n);
+        return over_aligned_allocate(n, align);
+      }
+
+      void do_deallocate(void* p, std::size_t, std::size_t align) override
+      {
+        if (align <= alignof(std::max_align_t))
+          ::operator delete(p);
+        else
+          aligned_deallocate(p);
+      }
+
+      bool do_is_equal(const memory_resource& x) const override
+      {
+        return dynamic_cast<const new_delete*>(&x);
+      }
+    };
+
+    new_delete default_new_delete;
+
+    std::atomic<memory_resource*> default_resource(&default_new_delete);
+  } // namespace
+
+  memory_resource*
+  new_delete_resource()
+  {
+    return &default_new_delete;
+  }
+
+  memory_resource*
+  get_default_resource()
+  {
+    return default_resource.load();
+  }
+
+  memory_resource*
+  set_default_resource(memory_resource* r)
+  {
+    return default_resource.exchange(r ? r : new_delete_resource());
+  }
+
+
+  // Arena resource
+  void*
+  arena_resource::do_allocate(std::size_t n, std::size_t align)
+  {
+    return arena_.allocate(n, align);
+  }
+
+  void
+  arena_resource::do_deallocate(void*, std::size_t, std::size_t)
+  { }
+
+  bool
+  arena_resource::do_is_equal(const memory_resource&) const
+  {
+    return false;
+  }
+
+
+  // Pool resource
+  void*
+  pool_resource::do_allocate(std::size_t n, std::size_t align)
+  {
+    if (align <= pool_alignment)
+      return pool_allocate(n);
+    return over_aligned_allocate(n, align);
+  }
+
+  void
+  pool_resource::do_deallocate(void* p, std::size_t n, std::size_t align)
+  {
+    if (align <= pool_alignment)
+      pool_deallocate(p, n);
+    else
+      aligned_deallocate(p);
+  }
+
+  bool
+  pool_resource::do_is_equal(const memory_resource& x) const
+  {
+    return dynamic_cast<const pool_resource*>(&x);
+  }
+
+
+  // Huge page resource. Requests smaller than a huge page are aligned to
+  // 64 bytes by huge_allocate, and larger ones to a page.
+  namespace
+  {
+    inline bool
+    huge_aligned(std::size_t n, std::size_t align)
+    {
+      return align <= 64 || (n >= huge_page_2mb && align <= huge_page_2mb);
+    }
+  } // namespace
+
+  void*
+  huge_page_resource::do_allocate(std::size_t n, std::size_t align)
+  {
+    if (huge_aligned(n, align))
+      return huge_allocate(n, page_);
+    return over_aligned_allocate(n, align);
+  }
+
+  void
+  huge_page_resource::do_deallocate(void* p, std::size_t n, std::size_t align)
+  {
+    if (huge_aligned(n, align))
+      huge_deallocate(p, n, page_);
+    else
+      aligned_deallocate(p);
+  }
+
+  bool
+  huge_page_resource::do_is_equal(const memory_resource& x) const
+  {
+    const huge_page_resource* r = dynamic_cast<const huge_page_resource*>(&x);
+    return r && r->page_ == page_;
+  }
+
+
+  // NUMA resource. The memory is aligned to at least 4096 bytes.
+  void*
+  numa_resource::do_allocate(std::size_t n, std::size_t align)
+  {
+    if (align > 4096)
+      throw std::bad_alloc();
+    return numa_allocate(n, policy_, node_);
+  }
+
+  void
+  numa_resource::do_deallocate(void* p, std::size_t n, std::size_t)
+  {
+    numa_deallocate(p, n);
+  }
+
+  bool
+  numa_resource::do_is_equal(const memory_resource& x) const
+  {
+    return dynamic_cast<const numa_resource*>(&x);
+  }
+
+} // namespace origin
@@ -0,0 +1,274 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_RESOURCE_HPP
+#define ORIGIN_MEMORY_RESOURCE_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <origin/memory/arena.hpp>
+#include <origin/memory/huge_page.hpp>
+#include <origin/memory/numa.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Memory resources                                            mem.resource
+  //
+  // A memory resource is an allocation strategy behind a virtual interface,
+  // so that the strategy is chosen at run time rather than by a template
+  // argument. A container whose allocator is a polymorphic_allocator (see
+  // below) has the same type whichever resource backs it:
+  //
+  //    arena_resource scratch;
+  //    numa_resource shared(numa_policy::interleave);
+  //    polymorphic_allocator<char> a(&scratch), b(&shared);
+  //    using G = undirected_adjacency_list<char, int, std::size_t,
+  //                                        polymorphic_allocator<char>>;
+  //    G g(a);   // Allocates from the arena
+  //    G h(b);   // Allocates interleaved pages
+  //
+  // The interface is that of std::pmr::memory_resource (C++17):
+  // allocate(n, align), deallocate(p, n, align) and is_equal(r), the last
+  // being true when memory allocated by one resource can be deallocated by
+  // the other. The resources are:
+  //
+  //    new_delete_resource()   operator new, or aligned_allocate for
+  //                            alignments beyond that of max_align_t
+  //    arena_resource          An arena (see mem.arena), which it owns
+  //    pool_resource           The pool allocator (see mem.pool)
+  //    huge_page_resource      Memory backed by huge pages (see
+  //                            mem.huge_page)
+  //    numa_resource           Memory placed by a NUMA policy (see
+  //                            mem.numa_policy)
+  //
+  // The default resource, used by default constructed polymorphic
+  // allocators, is new_delete_resource() unless it is replaced by
+  // set_default_resource(). The resources, other than arenas, are
+  // thread-safe.
+  //
+  // A virtual call per allocation suits containers that allocate in bulk,
+  // such as the pools and edge lists of graphs and the elements of
+  // matrices, rather than node-based containers with small allocations.
+  class memory_resource
+  {
+  public:
+    virtual ~memory_resource();
+
+    // Allocate n bytes aligned to align, which must be a power of 2.
+    void* allocate(std::size_t n,
+                   std::size_t align = alignof(std::max_align_t))
+    {
+      return do_allocate(n, align);
+    }
+
+    // Release the n bytes at p, allocated with the alignment align.
+    void deallocate(void* p, std::size_t n,
+                    std::size_t align = alignof(std::max_align_t))
+    {
+      do_deallocate(p, n, align);
+    }
+
+    // Returns true if memory allocated by either resource can be
+    // deallocated by the other.
+    bool is_equal(const memory_resource& x) const
+    {
+      return this == &x || do_is_equal(x);
+    }
+
+  private:
+    virtual void* do_allocate(std::size_t n, std::size_t align) = 0;
+    virtual void do_deallocate(void* p, std::size_t n, std::size_t align) = 0;
+    virtual bool do_is_equal(const memory_resource& x) const = 0;
+  };
+
+  inline bool
+  operator==(const memory_resource& a, const memory_resource& b)
+  {
+    return a.is_equal(b);
+  }
+
+  inline bool
+  operator!=(const memory_resource& a, const memory_resource& b)
+  {
+    return !a.is_equal(b);
+  }
+
+
+  // Returns the resource that allocates with operator new.
+  memory_resource* new_delete_resource();
+
+  // Returns the default resource.
+  memory_resource* get_default_resource();
+
+  // Replace the default resource by r, or by new_delete_resource() if r is
+  // null, returning the previous one.
+  memory_resource* set_default_resource(memory_resource* r);
+
+
+  // An arena resource allocates from an arena that it owns. Deallocation
+  // has no effect; the memory is released by reset() or release(), or when
+  // the resource is destroyed.
+  class arena_resource : public memory_resource
+  {
+  public:
+    explicit arena_resource(std::size_t chunk = arena::default_chunk)
+      : arena_(chunk)
+    { }
+
+    // Returns the arena.
+    origin::arena& arena() { return arena_; }
+
+    void reset() { arena_.reset(); }
+    void release() { arena_.release(); }
+
+  private:
+    void* do_allocate(std::size_t n, std::size_t align) override;
+    void do_deallocate(void* p, std::size_t n, std::size_t align) override;
+    bool do_is_equal(const memory_resource& x) const override;
+
+    origin::arena arena_;
+  };
+
+
+  // A pool resource allocates from the pool allocator. Requests aligned to
+  // more than pool_alignment use aligned_allocate. All pool resources are
+  // equal.
+  class pool_resource : public memory_resource
+  {
+  private:
+    void* do_allocate(std::size_t n, std::size_t align) override;
+    void do_deallocate(void* p, std::size_t n, std::size_t align) override;
+    bool do_is_equal(const memory_resource& x) const override;
+  };
+
+
+  // A huge page resource allocates memory backed by huge pages of a given
+  // size. Huge page resources of the same page size are equal.
+  class huge_page_resource : public memory_resource
+  {
+  public:
+    explicit huge_page_resource(std::size_t page = huge_page_2mb)
+      : page_(page)
+    { }
+
+    std::size_t page_size() const { return page_; }
+
+  private:
+    void* do_allocate(std::size_t n, std::size_t align) override;
+    void do_deallocate(void* p, std::size_t n, std::size_t align) override;
+    bool do_is_equal(const memory_resource& x) const override;
+
+    std::size_t page_;
+  };
+
+
+  // A NUMA resource allocates pages placed by a policy. Its memory is page
+  // aligned; a request aligned to more than 4096 bytes throws
+  // std::bad_alloc. All NUMA resources are equal.
+  class numa_resource : public memory_resource
+  {
+  public:
+    explicit numa_resource(numa_policy p = numa_policy::first_touch,
+                           std::size_t node = 0)
+      : policy_(p), node_(node)
+    { }
+
+    numa_policy policy() const { return policy_; }
+    std::size_t node() const { return node_; }
+
+  private:
+    void* do_allocate(std::size_t n, std::size_t align) override;
+    void do_deallocate(void* p, std::size_t n, std::size_t align) override;
+    bool do_is_equal(const memory_resource& x) const override;
+
+    numa_policy policy_;
+    std::size_t node_;
+  };
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Polymorphic allocator                           mem.polymorphic_allocator
+  //
+  // The polymorphic allocator allocates storage for objects of type T from
+  // a memory resource. Polymorphic allocators are equal when their
+  // resources are. The resource must outlive the allocators and the
+  // containers using them. Copies of a container use the same resource.
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  template <typename T>
+    class polymorphic_allocator
+    {
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind { using other = polymorphic_allocator<U>; };
+
+      // Construct an allocator using the default resource.
+      polymorphic_allocator()
+        : r(get_default_resource())
+      { }
+
+      polymorphic_allocator(memory_resource* r)
+        : r(r)
+      { }
+
+      template <typename U>
+        polymorphic_allocator(const polymorphic_allocator<U>& x)
+          : r(x.resource())
+        { }
+
+      // Returns the resource from which memory is allocated.
+      memory_resource* resource() const { return r; }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        return static_cast<T*>(r->allocate(n * sizeof(T), alignof(T)));
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        r->deallocate(p, n * sizeof(T), alignof(T));
+      }
+
+    private:
+      memory_resource* r;
+    };
+
+
+  // Equality comparable
+  template <typename T, typename U>
+    inline bool
+    operator==(const polymorphic_allocator<T>& a,
+               const polymorphic_allocator<U>& b)
+    {
+      return *a.resource() == *b.resource();
+    }
+
+  template <typename T, typename U>
+    inline bool
+    operator!=(const polymorphic_allocator<T>& a,
+               const polymorphic_allocator<U>& b)
+    {
+      return !(a == b);
+    }
+
+} // namespace origin
+
+#endif
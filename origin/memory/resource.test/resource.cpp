@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <vector>
+
+#include <origin/memory/resource.hpp>
+
+using namespace std;
+using namespace origin;
+
+static_assert(Allocator<polymorphic_allocator<int>>(), "");
+
+template <typename T>
+  bool is_aligned(const T* p, std::size_t align)
+  {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+  }
+
+// Allocations of various sizes and alignments are aligned and writable,
+// and are released by the same resource.
+void
+check_resource(memory_resource& r)
+{
+  for (size_t align : {1, 8, 16, 64, 4096}) {
+    for (size_t n : {1, 24, 1000, 100000}) {
+      void* p = r.allocate(n, align);
+      assert(is_aligned(p, align));
+      memset(p, 0x5a, n);
+      r.deallocate(p, n, align);
+    }
+  }
+  assert(r == r);
+}
+
+// One container type is backed by different resources.
+void
+check_allocator()
+{
+  using A = polymorphic_allocator<int>;
+  arena_resource a;
+  pool_resource p;
+  numa_resource n(numa_policy::interleave);
+
+  A aa(&a), pa(&p), na(&n);
+  vector<int, A> x(aa);
+  vector<int, A> y(pa);
+  vector<int, A> z(na);
+  for (int i = 0; i != 10000; ++i) {
+    x.push_back(i);
+    y.push_back(i);
+    z.push_back(i);
+  }
+  assert(x.get_allocator().resource() == &a);
+  assert(a.arena().capacity() >= 10000 * sizeof(int));
+  assert(equal(x.begin(), x.end(), y.begin()));
+  assert(equal(y.begin(), y.end(), z.begin()));
+  assert(x.get_allocator() != y.get_allocator());
+  assert(y.get_allocator() == pa);
+
+  // Copies keep the resource, and rebinding keeps it too.
+  vector<int, A> w = x;
+  assert(w.get_allocator().resource() == &a);
+  list<int, A> l(pa);
+  l.assign(x.begin(), x.end());
+  assert(l.size() == 10000 && l.back() == 9999);
+  polymorphic_allocator<double> d = x.get_allocator();
+  assert(d.resource() == &a);
+
+  // Equality of resources.
+  pool_resource p2;
+  numa_resource n2;
+  huge_page_resource h2(huge_page_2mb), h1(huge_page_1gb);
+  assert(p == p2 && n == n2 && p != n);
+  assert(huge_page_resource() == h2 && h1 != h2);
+  arena_resource a2;
+  assert(a != a2);
+}
+
+void
+check_default()
+{
+  assert(get_default_resource() == new_delete_resource());
+  assert(polymorphic_allocator<int>().resource() == new_delete_resource());
+  pool_resource p;
+  assert(set_default_resource(&p) == new_delete_resource());
+  assert(polymorphic_allocator<int>().resource() == &p);
+  assert(set_default_resource(nullptr) == &p);
+  assert(get_default_resource() == new_delete_resource());
+}
+
+int main()
+{
+  check_resource(*new_delete_resource());
+  pool_resource p;
+  check_resource(p);
+  arena_resource a;
+  check_resource(a);
+  huge_page_resource h;
+  check_resource(h);
+  numa_resource n;
+  check_resource(n);
+
+  check_allocator();
+  check_default();
+}
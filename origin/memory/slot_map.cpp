@@ -0,0 +1,13 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include "slot_map.hpp"
+
+namespace origin
+{
+  constexpr std::uint32_t slot_handle::npos;
+} // namespace origin
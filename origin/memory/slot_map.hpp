@@ -0,0 +1,368 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_SLOT_MAP_HPP
+#define ORIGIN_MEMORY_SLOT_MAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <origin/memory/concepts.hpp>
+#include <origin/memory/usage.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Slot Map                                                     mem.slot_map
+  //
+  // A slot map stores objects under handles that detect their erasure. A
+  // handle names a slot and the generation of the slot when the object was
+  // inserted, 32 bits each. Erasing the object advances the generation of
+  // its slot, so that a stale handle no longer matches, even after the slot
+  // is reused for another object: looking it up fails rather than finding
+  // the new object.
+  //
+  //    slot_map<std::string> m;
+  //    slot_handle h = m.insert("a");
+  //    m.erase(h);
+  //    slot_handle k = m.insert("b");    // Reuses the slot of h
+  //    assert(!m.contains(h) && m.find(h) == nullptr);
+  //
+  // The objects are stored densely in an array, in no particular order, so
+  // that iterating over them reads contiguous memory. The slots map handles
+  // to positions in that array, and a parallel array maps each position
+  // back to its slot. Erasure moves the last object into the position of
+  // the erased one and updates its slot, so that insertion, erasure and
+  // lookup take constant time. Erasure invalidates pointers and iterators to
+  // the last object and to the erased one; insertion may invalidate all of
+  // them, as for std::vector. Handles are invalidated only by erasing their
+  // object.
+  //
+  // Free slots are reused most recently freed first. A slot whose 32 bit
+  // generation is exhausted is retired instead, so that a handle never
+  // matches an object other than its own. A map holds fewer than 2^32 - 1
+  // slots; an insertion that needs more throws std::length_error.
+  //
+  // Template Parameters:
+  //    T -- The type of the stored objects
+  //    A -- The allocator, rebound for the slot and index arrays
+
+
+  // A handle to an object in a slot map. A default handle is null and
+  // matches no object.
+  class slot_handle
+  {
+  public:
+    static constexpr std::uint32_t npos = -1;
+
+    slot_handle()
+      : index_(npos), generation_(0)
+    { }
+
+    slot_handle(std::uint32_t index, std::uint32_t generation)
+      : index_(index), generation_(generation)
+    { }
+
+    // Returns the index of the slot.
+    std::uint32_t index() const { return index_; }
+
+    // Returns the generation of the slot when the handle was made.
+    std::uint32_t generation() const { return generation_; }
+
+    // Returns the handle as a single integer, and a handle from one.
+    std::uint64_t value() const
+    {
+      return (std::uint64_t(generation_) << 32) | index_;
+    }
+
+    static slot_handle from_value(std::uint64_t x)
+    {
+      return slot_handle(std::uint32_t(x), std::uint32_t(x >> 32));
+    }
+
+    // Returns true if the handle is not null.
+    explicit operator bool() const { return index_ != npos; }
+
+    bool operator==(const slot_handle& x) const
+    {
+      return index_ == x.index_ && generation_ == x.generation_;
+    }
+
+    bool operator!=(const slot_handle& x) const { return !(*this == x); }
+
+    bool operator<(const slot_handle& x) const { return value() < x.value(); }
+
+  private:
+    std::uint32_t index_;
+    std::uint32_t generation_;
+  };
+
+
+  template <typename T, typename A = std::allocator<T>>
+    class slot_map
+    {
+      static_assert(Allocator<A>(), "");
+
+      // A slot holds the position of its object when its generation is odd
+      // (live), and the next free slot when it is even (free).
+      struct slot
+      {
+        std::uint32_t link;
+        std::uint32_t generation;
+      };
+
+      using slot_allocator = Rebind_allocator<A, slot>;
+      using index_allocator = Rebind_allocator<A, std::uint32_t>;
+    public:
+      using value_type = T;
+      using allocator_type = A;
+      using size_type = std::size_t;
+      using handle_type = slot_handle;
+      using iterator = typename std::vector<T, A>::iterator;
+      using const_iterator = typename std::vector<T, A>::const_iterator;
+
+      static constexpr std::uint32_t npos = slot_handle::npos;
+
+      explicit slot_map(const A& a = A())
+        : values_(a), owners_(index_allocator(a)), slots_(slot_allocator(a)),
+          free_(npos)
+      { }
+
+      // Size and capacity
+      size_type size() const { return values_.size(); }
+      bool empty() const { return values_.empty(); }
+
+      // Returns the number of slots, live or free.
+      size_type slot_count() const { return slots_.size(); }
+
+      void reserve(size_type n)
+      {
+        values_.reserve(n);
+        owners_.reserve(n);
+        slots_.reserve(n);
+      }
+
+      // Returns the memory footprint of the map. Free slots are dead.
+      memory_footprint memory_usage() const
+      {
+        memory_footprint f = contiguous_footprint(values_)
+                           + contiguous_footprint(owners_)
+                           + contiguous_footprint(slots_);
+        f.dead = (slots_.size() - values_.size()) * sizeof(slot);
+        return f;
+      }
+
+      allocator_type get_allocator() const { return values_.get_allocator(); }
+
+      // Insertion
+      slot_handle insert(const T& x) { return emplace(x); }
+      slot_handle insert(T&& x) { return emplace(std::move(x)); }
+
+      template <typename... Args>
+        slot_handle emplace(Args&&... args);
+
+      // Erase the object of h, returning false if h does not match one.
+      bool erase(slot_handle h);
+
+      // Erase every object. Every handle becomes stale.
+      void clear();
+
+      // Lookup
+      bool contains(slot_handle h) const { return position(h) != npos; }
+
+      // Returns a pointer to the object of h, or nullptr.
+      T* find(slot_handle h)
+      {
+        std::uint32_t p = position(h);
+        return p == npos ? nullptr : &values_[p];
+      }
+
+      const T* find(slot_handle h) const
+      {
+        std::uint32_t p = position(h);
+        return p == npos ? nullptr : &values_[p];
+      }
+
+      // Returns the object of h, which must match one.
+      T& operator[](slot_handle h)
+      {
+        assert(contains(h));
+        return values_[slots_[h.index()].link];
+      }
+
+      const T& operator[](slot_handle h) const
+      {
+        assert(contains(h));
+        return values_[slots_[h.index()].link];
+      }
+
+      // Returns the object of h, or throws std::out_of_range.
+      T& at(slot_handle h);
+      const T& at(slot_handle h) const;
+
+      // Dense access
+      T* data() { return values_.data(); }
+      const T* data() const { return values_.data(); }
+
+      iterator begin() { return values_.begin(); }
+      iterator end() { return values_.end(); }
+      const_iterator begin() const { return values_.begin(); }
+      const_iterator end() const { return values_.end(); }
+
+      // Returns the handle of the object at position n of the dense array.
+      slot_handle handle(size_type n) const
+      {
+        assert(n < size());
+        std::uint32_t s = owners_[n];
+        return slot_handle(s, slots_[s].generation);
+      }
+
+      slot_handle handle(const_iterator i) const
+      {
+        return handle(size_type(i - begin()));
+      }
+
+      void swap(slot_map& x)
+      {
+        values_.swap(x.values_);
+        owners_.swap(x.owners_);
+        slots_.swap(x.slots_);
+        std::swap(free_, x.free_);
+      }
+
+    private:
+      // Returns the position of the object of h, or npos.
+      std::uint32_t position(slot_handle h) const
+      {
+        if (h.index() >= slots_.size())
+          return npos;
+        const slot& s = slots_[h.index()];
+        return (s.generation == h.generation() && (s.generation & 1))
+             ? s.link : npos;
+      }
+
+      // Advance the generation of the live slot s and free it, or retire it
+      // if its generation is exhausted.
+      void release(std::uint32_t s);
+
+      std::vector<T, A> values_;                           // The objects
+      std::vector<std::uint32_t, index_allocator> owners_; // Their slots
+      std::vector<slot, slot_allocator> slots_;            // The slots
+      std::uint32_t free_;                                 // First free slot
+    };
+
+  template <typename T, typename A>
+    constexpr std::uint32_t slot_map<T, A>::npos;
+
+  template <typename T, typename A>
+    template <typename... Args>
+      slot_handle
+      slot_map<T, A>::emplace(Args&&... args)
+      {
+        if (free_ == npos) {
+          if (slots_.size() >= std::size_t(npos) - 1)
+            throw std::length_error("slot_map: too many slots");
+          slots_.push_back({npos, 0});
+          free_ = std::uint32_t(slots_.size() - 1);
+        }
+        std::uint32_t s = free_;
+        values_.emplace_back(std::forward<Args>(args)...);
+        try {
+          owners_.push_back(s);
+        } catch (...) {
+          values_.pop_back();
+          throw;
+        }
+        slot& x = slots_[s];
+        free_ = x.link;
+        x.link = std::uint32_t(values_.size() - 1);
+        ++x.generation;
+        return slot_handle(s, x.generation);
+      }
+
+  template <typename T, typename A>
+    void
+    slot_map<T, A>::release(std::uint32_t s)
+    {
+      slot& x = slots_[s];
+      if (++x.generation == 0) {
+        x.link = npos;
+        return;
+      }
+      x.link = free_;
+      free_ = s;
+    }
+
+  template <typename T, typename A>
+    bool
+    slot_map<T, A>::erase(slot_handle h)
+    {
+      std::uint32_t p = position(h);
+      if (p == npos)
+        return false;
+      std::uint32_t last = std::uint32_t(values_.size() - 1);
+      if (p != last) {
+        values_[p] = std::move(values_[last]);
+        owners_[p] = owners_[last];
+        slots_[owners_[p]].link = p;
+      }
+      values_.pop_back();
+      owners_.pop_back();
+      release(h.index());
+      return true;
+    }
+
+  template <typename T, typename A>
+    void
+    slot_map<T, A>::clear()
+    {
+      for (std::uint32_t s : owners_)
+        release(s);
+      values_.clear();
+      owners_.clear();
+    }
+
+  template <typename T, typename A>
+    T&
+    slot_map<T, A>::at(slot_handle h)
+    {
+      if (T* p = find(h))
+        return *p;
+      throw std::out_of_range("slot_map: stale or invalid handle");
+    }
+
+  template <typename T, typename A>
+    const T&
+    slot_map<T, A>::at(slot_handle h) const
+    {
+      if (const T* p = find(h))
+        return *p;
+      throw std::out_of_range("slot_map: stale or invalid handle");
+    }
+
+} // namespace origin
+
+
+namespace std
+{
+  template <>
+    struct hash<origin::slot_handle>
+    {
+      std::size_t operator()(const origin::slot_handle& h) const
+      {
+        return hash<std::uint64_t>()(h.value());
+      }
+    };
+} // namespace std
+
+#endif
@@ -0,0 +1,101 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#include <origin/memory/slot_map.hpp>
+#include <origin/memory/pool.hpp>
+
+using namespace std;
+using namespace origin;
+
+void
+check_handles()
+{
+  slot_map<string> m;
+  assert(m.empty());
+  assert(!slot_handle() && !m.contains(slot_handle()));
+
+  slot_handle a = m.insert("a");
+  slot_handle b = m.emplace(3, 'b');
+  assert(m.size() == 2 && m[a] == "a" && m[b] == "bbb");
+
+  // A stale handle does not match the object that reuses its slot.
+  assert(m.erase(a));
+  assert(!m.erase(a));
+  slot_handle c = m.insert("c");
+  assert(c.index() == a.index() && c != a);
+  assert(!m.contains(a) && m.find(a) == nullptr);
+  assert(*m.find(c) == "c" && m.at(b) == "bbb");
+  bool thrown = false;
+  try {
+    m.at(a);
+  } catch (out_of_range&) {
+    thrown = true;
+  }
+  assert(thrown);
+
+  assert(slot_handle::from_value(c.value()) == c);
+  unordered_set<slot_handle> hs {a, b, c};
+  assert(hs.size() == 3);
+
+  m.clear();
+  assert(m.empty() && !m.contains(b) && !m.contains(c));
+  assert(m.slot_count() == 2);
+}
+
+// Random insertions and erasures agree with a map, and the dense array
+// holds exactly the live objects.
+void
+check_random()
+{
+  slot_map<int, pool_allocator<int>> m;
+  map<slot_handle, int> ref;
+  vector<slot_handle> dead;
+  minstd_rand gen(42);
+  for (int i = 0; i != 20000; ++i) {
+    if (ref.empty() || gen() % 3 != 0) {
+      slot_handle h = m.insert(i);
+      assert(ref.count(h) == 0);
+      ref[h] = i;
+    } else {
+      auto j = ref.begin();
+      advance(j, gen() % ref.size());
+      assert(m.erase(j->first));
+      dead.push_back(j->first);
+      ref.erase(j);
+    }
+  }
+  assert(m.size() == ref.size());
+  for (auto& x : ref)
+    assert(m[x.first] == x.second);
+  for (slot_handle h : dead)
+    assert(!m.contains(h));
+
+  long sum = 0, expect = 0;
+  for (int x : m)
+    sum += x;
+  for (auto& x : ref)
+    expect += x.second;
+  assert(sum == expect);
+  for (size_t n = 0; n != m.size(); ++n)
+    assert(m[m.handle(n)] == m.data()[n]);
+
+  memory_footprint f = m.memory_usage();
+  assert(f.dead == (m.slot_count() - m.size()) * 2 * sizeof(uint32_t));
+}
+
+int main()
+{
+  check_handles();
+  check_random();
+}
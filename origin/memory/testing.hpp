@@ -0,0 +1,63 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_TESTING_HPP
+#define ORIGIN_MEMORY_TESTING_HPP
+
+#include <origin/type/testing.hpp>
+
+#include "tracking.hpp"
+
+namespace origin
+{
+  namespace testing
+  {
+    ////////////////////////////////////////////////////////////////////////////
+    // Allocation Properties                                        mem.test
+    //
+    // An allocation property asserts the number of allocations made by an
+    // operation, as counted by an allocation counter (see [mem.tracking]).
+    // The allocations of containers are counted by giving them a counting
+    // allocator, and those of any code by installing the global new hook in
+    // the test program. For example, a test asserts that evaluating a matrix
+    // expression allocates only the result, when the matrices have a
+    // counting allocator:
+    //
+    //    check_allocations(1, [&]() { matrix<double, 2> c = a + b * 2.0; });
+    //
+    // A failure is logged with the counts of the operation.
+    ////////////////////////////////////////////////////////////////////////////
+
+
+    // The predicate checked by check_allocations.
+    struct allocations_are
+    {
+      bool operator()(const allocation_counts& c) const
+      {
+        return c.allocations == count;
+      }
+
+      std::size_t count;
+    };
+
+    // Check that f() makes exactly n allocations, as counted by the counter
+    // c (by default, the counter of the global new hook).
+    template <typename F>
+      inline void
+      check_allocations(std::size_t n, F f,
+                        allocation_counter& c = default_allocation_counter())
+      {
+        allocation_scope s(c);
+        f();
+        context::instance().check(allocations_are {n}, s.counts());
+      }
+
+  } // namespace testing
+
+} // namespace origin
+
+#endif
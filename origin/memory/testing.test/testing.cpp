@@ -0,0 +1,36 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <origin/memory/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+int main()
+{
+  context cxt;
+  ostringstream os;
+  cxt.error_stream(os);
+
+  allocation_counter c;
+  using Alloc = counting_allocator<int>;
+  vector<int, Alloc> v{Alloc(c)};
+  check_allocations(1, [&]() { v.reserve(10); }, c);
+  check_allocations(0, [&]() { v.assign(10, 1); }, c);
+  assert(cxt.failures() == 0);
+
+  // A failure is logged with the counts.
+  check_allocations(0, [&]() { v.reserve(100); }, c);
+  assert(cxt.failures() == 1);
+  assert(os.str().find("1 allocations") != string::npos);
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdlib>
+#include <ostream>
+
+#include "tracking.hpp"
+
+namespace origin
+{
+  allocation_counts
+  operator-(const allocation_counts& a, const allocation_counts& b)
+  {
+    return {a.allocations - b.allocations,
+            a.deallocations - b.deallocations,
+            a.bytes_allocated - b.bytes_allocated,
+            a.bytes_deallocated - b.bytes_deallocated};
+  }
+
+  bool
+  operator==(const allocation_counts& a, const allocation_counts& b)
+  {
+    return a.allocations == b.allocations
+        && a.deallocations == b.deallocations
+        && a.bytes_allocated == b.bytes_allocated
+        && a.bytes_deallocated == b.bytes_deallocated;
+  }
+
+  bool
+  operator!=(const allocation_counts& a, const allocation_counts& b)
+  {
+    return !(a == b);
+  }
+
+  std::ostream&
+  operator<<(std::ostream& os, const allocation_counts& c)
+  {
+    return os << c.allocations << " allocations (" << c.bytes_allocated
+              << " bytes), " << c.deallocations << " deallocations ("
+              << c.bytes_deallocated << " bytes)";
+  }
+
+
+  allocation_counter::allocation_counter()
+    : allocs_(0), deallocs_(0), allocated_(0), deallocated_(0),
+      live_(0), peak_(0)
+  { }
+
+  void
+  allocation_counter::allocate(std::size_t n)
+  {
+    allocs_.fetch_add(1, std::memory_order_relaxed);
+    allocated_.fetch_add(n, std::memory_order_relaxed);
+    std::ptrdiff_t live = live_.fetch_add(n, std::memory_order_relaxed) + n;
+    if (live > 0) {
+      std::size_t peak = peak_.load(std::memory_order_relaxed);
+      while (std::size_t(live) > peak
+             && !peak_.compare_exchange_weak(peak, live,
+                                             std::memory_order_relaxed))
+        ;
+    }
+  }
+
+  void
+  allocation_counter::deallocate(std::size_t n)
+  {
+    deallocs_.fetch_add(1, std::memory_order_relaxed);
+    deallocated_.fetch_add(n, std::memory_order_relaxed);
+    live_.fetch_sub(n, std::memory_order_relaxed);
+  }
+
+  allocation_counts
+  allocation_counter::counts() const
+  {
+    return {allocs_.load(), deallocs_.load(),
+            allocated_.load(), deallocated_.load()};
+  }
+
+  void
+  allocation_counter::reset()
+  {
+    allocs_ = 0;
+    deallocs_ = 0;
+    allocated_ = 0;
+    deallocated_ = 0;
+    live_ = 0;
+    peak_ = 0;
+  }
+
+  // The counter has a trivial destructor, so it may be used by the
+  // allocations made while static objects are destroyed.
+  allocation_counter&
+  default_allocation_counter()
+  {
+    static allocation_counter c;
+    return c;
+  }
+
+
+  namespace memory_impl
+  {
+    namespace
+    {
+      thread_local bool suspended = false;
+      std::atomic<bool> installed(false);
+
+      // The header of an allocation of the global new hook. Its size is a
+      // multiple of the fundamental alignment, so that the allocation that
+      // follows it is aligned.
+      struct hook_info
+      {
+        std::size_t size;
+        bool counted;
+      };
+
+      union hook_header
+      {
+        hook_info info;
+        std::max_align_t align;
+      };
+    } // namespace
+
+    suspend_new_hook::suspend_new_hook()
+      : saved(suspended)
+    {
+      suspended = true;
+    }
+
+    suspend_new_hook::~suspend_new_hook()
+    {
+      suspended = saved;
+    }
+
+    void*
+    hooked_allocate(std::size_t n) noexcept
+    {
+      void* p = std::malloc(sizeof(hook_header) + n);
+      if (!p)
+        return nullptr;
+      hook_header* h = static_cast<hook_header*>(p);
+      h->info.size = n;
+      h->info.counted = !suspended;
+      if (h->info.counted)
+        default_allocation_counter().allocate(n);
+      return h + 1;
+    }
+
+    void
+    hooked_deallocate(void* p) noexcept
+    {
+      if (!p)
+        return;
+      hook_header* h = static_cast<hook_header*>(p) - 1;
+      if (h->info.counted)
+        default_allocation_counter().deallocate(h->info.size);
+      std::free(h);
+    }
+
+    bool
+    install_new_hook()
+    {
+      installed = true;
+      return true;
+    }
+
+  } // namespace memory_impl
+
+  bool
+  global_new_tracked()
+  {
+    return memory_impl::installed;
+  }
+
+} // namespace origin
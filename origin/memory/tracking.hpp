@@ -0,0 +1,281 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_TRACKING_HPP
+#define ORIGIN_MEMORY_TRACKING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+
+#include <origin/memory/concepts.hpp>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Allocation counts                                            mem.tracking
+  //
+  // Allocation tracking counts the dynamic allocations made by a program, so
+  // that tests and benchmarks can verify that an operation allocates no more
+  // than it should. For example, a test asserts that evaluating a matrix
+  // expression into a new matrix allocates exactly once:
+  //
+  //    using A = counting_allocator<double, aligned_allocator<double>>;
+  //    matrix<double, 2, A> a(n, n), b(n, n);
+  //    allocation_scope s;
+  //    matrix<double, 2, A> c = a + b * 2.0;
+  //    assert(s.counts().allocations == 1);
+  //
+  // Allocations are recorded by an allocation counter in two ways:
+  //
+  //    - A counting allocator records the allocations of the containers that
+  //      use it, and forwards them to an underlying allocator.
+  //    - The global new hook replaces the global operator new and delete, so
+  //      that every allocation of the program is recorded. The hook is
+  //      opt-in: it is defined in exactly one translation unit of the
+  //      program by defining ORIGIN_TRACK_GLOBAL_NEW before including this
+  //      file:
+  //
+  //        #define ORIGIN_TRACK_GLOBAL_NEW
+  //        #include <origin/memory/tracking.hpp>
+  //
+  // The hook does not see memory obtained by other means, such as the
+  // aligned_allocate function used by aligned allocators (see
+  // [mem.aligned_allocator]). The containers using such allocators are
+  // given a counting allocator instead.
+  //
+  // An allocation made by a counting allocator is not recorded again by the
+  // global new hook, so that each allocation is counted once. Both record
+  // into the default allocation counter unless a counting allocator is given
+  // another counter.
+  //
+  // The counters are atomic, so allocations made by any thread are counted,
+  // and an allocation scope counts those made by every thread during its
+  // lifetime.
+  struct allocation_counts
+  {
+    std::size_t allocations;
+    std::size_t deallocations;
+    std::size_t bytes_allocated;
+    std::size_t bytes_deallocated;
+
+    // Returns the number of bytes allocated but not yet deallocated.
+    std::ptrdiff_t live_bytes() const
+    {
+      return std::ptrdiff_t(bytes_allocated - bytes_deallocated);
+    }
+  };
+
+  // Returns the counts of a less the counts of b.
+  allocation_counts operator-(const allocation_counts& a,
+                              const allocation_counts& b);
+
+  // Equality comparable
+  bool operator==(const allocation_counts& a, const allocation_counts& b);
+  bool operator!=(const allocation_counts& a, const allocation_counts& b);
+
+  // Write the counts c, e.g., "2 allocations (48 bytes), 1 deallocation
+  // (16 bytes)".
+  std::ostream& operator<<(std::ostream& os, const allocation_counts& c);
+
+
+  // An allocation counter records allocations and deallocations, and the
+  // greatest number of live bytes.
+  class allocation_counter
+  {
+  public:
+    allocation_counter();
+
+    allocation_counter(const allocation_counter&) = delete;
+    allocation_counter& operator=(const allocation_counter&) = delete;
+
+    // Record the allocation or deallocation of n bytes.
+    void allocate(std::size_t n);
+    void deallocate(std::size_t n);
+
+    // Returns the counts recorded so far.
+    allocation_counts counts() const;
+
+    // Returns the greatest number of live bytes since the counter was
+    // created or reset.
+    std::size_t peak_bytes() const { return peak_.load(); }
+
+    // Reset the counts, and the peak, to 0.
+    void reset();
+
+  private:
+    std::atomic<std::size_t> allocs_;
+    std::atomic<std::size_t> deallocs_;
+    std::atomic<std::size_t> allocated_;
+    std::atomic<std::size_t> deallocated_;
+    std::atomic<std::ptrdiff_t> live_;
+    std::atomic<std::size_t> peak_;
+  };
+
+  // Returns the counter of the global new hook, and of counting allocators
+  // that are not given a counter.
+  allocation_counter& default_allocation_counter();
+
+  // Returns true if the global new hook is installed in this program.
+  bool global_new_tracked();
+
+
+  // An allocation scope counts the allocations recorded by a counter during
+  // its lifetime.
+  class allocation_scope
+  {
+  public:
+    explicit allocation_scope(
+      allocation_counter& c = default_allocation_counter())
+      : counter(c), start(c.counts())
+    { }
+
+    // Returns the counts recorded since the scope was entered.
+    allocation_counts counts() const { return counter.counts() - start; }
+
+  private:
+    allocation_counter& counter;
+    allocation_counts start;
+  };
+
+
+  namespace memory_impl
+  {
+    // While a counting allocator allocates from its underlying allocator,
+    // the global new hook of the calling thread is suspended.
+    struct suspend_new_hook
+    {
+      suspend_new_hook();
+      ~suspend_new_hook();
+
+      suspend_new_hook(const suspend_new_hook&) = delete;
+      suspend_new_hook& operator=(const suspend_new_hook&) = delete;
+
+      bool saved;
+    };
+
+    // The allocation functions of the global new hook. Each allocation is
+    // prefixed by a header that records its size, and whether it was
+    // counted, so that its deallocation is counted alike. Returns nullptr if
+    // no memory is available.
+    void* hooked_allocate(std::size_t n) noexcept;
+    void hooked_deallocate(void* p) noexcept;
+
+    // Record that the global new hook is installed.
+    bool install_new_hook();
+
+  } // namespace memory_impl
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Counting allocator                                  mem.counting_allocator
+  //
+  // The counting allocator records each allocation and deallocation of
+  // objects of type T with an allocation counter, and forwards it to an
+  // allocator of type A. Two counting allocators are equal when they record
+  // with the same counter and their underlying allocators are equal. For
+  // example:
+  //
+  //    allocation_counter c;
+  //    std::vector<int, counting_allocator<int>> v(counting_allocator<int>(c));
+  //    v.reserve(100);
+  //    assert(c.counts().allocations == 1);
+  //
+  // Template Parameters:
+  //    T -- The type of object being allocated
+  //    A -- The underlying allocator
+  template <typename T, typename A = std::allocator<T>>
+    class counting_allocator
+    {
+      using traits = std::allocator_traits<A>;
+
+      template <typename U, typename B> friend class counting_allocator;
+    public:
+      using value_type      = T;
+      using pointer         = T*;
+      using const_pointer   = const T*;
+      using reference       = T&;
+      using const_reference = const T&;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      template <typename U>
+        struct rebind
+        {
+          using other = counting_allocator<U, Rebind_allocator<A, U>>;
+        };
+
+      counting_allocator()
+        : counter(&default_allocation_counter()), alloc()
+      { }
+
+      explicit counting_allocator(allocation_counter& c, const A& a = A())
+        : counter(&c), alloc(a)
+      { }
+
+      template <typename U, typename B>
+        counting_allocator(const counting_allocator<U, B>& x)
+          : counter(x.counter), alloc(x.alloc)
+        { }
+
+      // Returns the counter of this allocator.
+      allocation_counter& get_counter() const { return *counter; }
+
+      // Returns the underlying allocator.
+      const A& underlying() const { return alloc; }
+
+      // Allocate storage for n objects of type T.
+      T* allocate(std::size_t n)
+      {
+        T* p;
+        {
+          memory_impl::suspend_new_hook guard;
+          p = traits::allocate(alloc, n);
+        }
+        counter->allocate(n * sizeof(T));
+        return p;
+      }
+
+      // Release the storage for the n objects pointed to by p.
+      void deallocate(T* p, std::size_t n)
+      {
+        {
+          memory_impl::suspend_new_hook guard;
+          traits::deallocate(alloc, p, n);
+        }
+        counter->deallocate(n * sizeof(T));
+      }
+
+      template <typename U, typename B>
+        bool operator==(const counting_allocator<U, B>& x) const
+        {
+          return counter == x.counter && alloc == x.alloc;
+        }
+
+      template <typename U, typename B>
+        bool operator!=(const counting_allocator<U, B>& x) const
+        {
+          return !(*this == x);
+        }
+
+    private:
+      allocation_counter* counter;
+      A alloc;
+    };
+
+  static_assert(Allocator<counting_allocator<int>>(), "");
+
+} // namespace origin
+
+// The definitions of the global new hook.
+#if defined(ORIGIN_TRACK_GLOBAL_NEW)
+#  include "tracking.impl/new_hook.hpp"
+#endif
+
+#endif
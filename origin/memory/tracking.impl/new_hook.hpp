@@ -0,0 +1,117 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_TRACKING_HPP
+#  error This file cannot be included directly. Include memory/tracking.hpp.
+#endif
+
+#include <new>
+
+// The replacements of the global operator new and delete. These are not
+// inline, so this file is included by exactly one translation unit of a
+// program. Like the standard operator new, the allocating forms call the
+// new handler until the allocation succeeds, and throw std::bad_alloc if
+// there is no new handler.
+
+namespace origin
+{
+  namespace memory_impl
+  {
+    namespace
+    {
+      const bool new_hook_installed = install_new_hook();
+
+      void*
+      hooked_new(std::size_t n)
+      {
+        for (;;) {
+          if (void* p = hooked_allocate(n))
+            return p;
+          std::new_handler h = std::get_new_handler();
+          if (!h)
+            throw std::bad_alloc();
+          h();
+        }
+      }
+
+      void*
+      hooked_new(std::size_t n, const std::nothrow_t&) noexcept
+      {
+        try {
+          return hooked_new(n);
+        } catch (...) {
+          return nullptr;
+        }
+      }
+    } // namespace
+
+  } // namespace memory_impl
+
+} // namespace origin
+
+
+void*
+operator new(std::size_t n)
+{
+  return origin::memory_impl::hooked_new(n);
+}
+
+void*
+operator new[](std::size_t n)
+{
+  return origin::memory_impl::hooked_new(n);
+}
+
+void*
+operator new(std::size_t n, const std::nothrow_t& t) noexcept
+{
+  return origin::memory_impl::hooked_new(n, t);
+}
+
+void*
+operator new[](std::size_t n, const std::nothrow_t& t) noexcept
+{
+  return origin::memory_impl::hooked_new(n, t);
+}
+
+void
+operator delete(void* p) noexcept
+{
+  origin::memory_impl::hooked_deallocate(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+  origin::memory_impl::hooked_deallocate(p);
+}
+
+void
+operator delete(void* p, const std::nothrow_t&) noexcept
+{
+  origin::memory_impl::hooked_deallocate(p);
+}
+
+void
+operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+  origin::memory_impl::hooked_deallocate(p);
+}
+
+#if defined(__cpp_sized_deallocation)
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  origin::memory_impl::hooked_deallocate(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+  origin::memory_impl::hooked_deallocate(p);
+}
+#endif
@@ -0,0 +1,99 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <list>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#define ORIGIN_TRACK_GLOBAL_NEW
+#include <origin/memory/tracking.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A counting allocator records the allocations of a container with its
+// counter.
+void
+check_counting_allocator()
+{
+  allocation_counter c;
+  {
+    using Alloc = counting_allocator<int>;
+    vector<int, Alloc> v{Alloc(c)};
+    v.reserve(100);
+    assert(c.counts().allocations == 1);
+    assert(c.counts().bytes_allocated == 100 * sizeof(int));
+    v.resize(100);
+    assert(c.counts().allocations == 1);
+    assert(c.peak_bytes() == 100 * sizeof(int));
+  }
+  allocation_counts n = c.counts();
+  assert(n.deallocations == 1 && n.live_bytes() == 0);
+
+  // Rebound allocators record with the same counter.
+  c.reset();
+  {
+    list<int, counting_allocator<int>> l{counting_allocator<int>(c)};
+    l.push_back(1);
+    l.push_back(2);
+    assert(c.counts().allocations == 2);
+  }
+  assert(c.counts().deallocations == 2);
+
+  counting_allocator<int> a(c);
+  counting_allocator<double> b(a);
+  assert(a == b && &b.get_counter() == &c);
+  assert(a != counting_allocator<int>());
+}
+
+// The global new hook counts every allocation made by new, but not again
+// those made by a counting allocator.
+void
+check_global_hook()
+{
+  assert(global_new_tracked());
+  allocation_scope s;
+  int* p = new int(3);
+  delete p;
+  {
+    vector<char> v(1000);
+  }
+  allocation_counts n = s.counts();
+  assert(n.allocations == 2 && n.deallocations == 2);
+  assert(n.bytes_allocated == sizeof(int) + 1000);
+  assert(n.live_bytes() == 0);
+
+  allocation_counter c;
+  allocation_scope t;
+  {
+    vector<int, counting_allocator<int>> v(10, 0, counting_allocator<int>(c));
+  }
+  assert(t.counts().allocations == 0 && c.counts().allocations == 1);
+
+  // The allocations of other threads are counted.
+  allocation_scope u;
+  thread th([]() { delete new int; });
+  th.join();
+  assert(u.counts().allocations >= 1);
+}
+
+void
+check_output()
+{
+  ostringstream ss;
+  ss << allocation_counts {2, 1, 48, 16};
+  assert(ss.str() == "2 allocations (48 bytes), 1 deallocations (16 bytes)");
+}
+
+int main()
+{
+  check_counting_allocator();
+  check_global_hook();
+  check_output();
+}
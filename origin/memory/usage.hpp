@@ -0,0 +1,91 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_USAGE_HPP
+#define ORIGIN_MEMORY_USAGE_HPP
+
+#include <cstddef>
+
+namespace origin
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Memory footprint                                                mem.usage
+  //
+  // A memory footprint describes the dynamic memory held by a data
+  // structure. Containers report their footprint through a memory_usage()
+  // member function, summing the footprints of the containers that they are
+  // built from. There are three measures:
+  //
+  //    - live is the number of bytes occupied by the objects contained in
+  //      the data structure,
+  //    - reserved is the number of bytes allocated, including live bytes,
+  //      and
+  //    - dead is the number of slots that held objects that have been
+  //      erased, but whose storage has not been reclaimed (see compact()
+  //      for the adjacency lists).
+  //
+  // The difference between the reserved and live bytes is the slack of the
+  // data structure, which is released by its shrink_to_fit() operation, if
+  // it has one. Only memory owned by the data structure is counted, not the
+  // dynamic memory owned by its elements, or the bookkeeping overhead of
+  // the allocator.
+  struct memory_footprint
+  {
+    memory_footprint(std::size_t live = 0, std::size_t reserved = 0,
+                     std::size_t dead = 0)
+      : live(live), reserved(reserved), dead(dead)
+    { }
+
+    // Returns the number of reserved bytes not occupied by objects.
+    std::size_t slack() const { return reserved - live; }
+
+    memory_footprint& operator+=(const memory_footprint& x)
+    {
+      live += x.live;
+      reserved += x.reserved;
+      dead += x.dead;
+      return *this;
+    }
+
+    std::size_t live;
+    std::size_t reserved;
+    std::size_t dead;
+  };
+
+  inline memory_footprint
+  operator+(memory_footprint a, const memory_footprint& b)
+  {
+    return a += b;
+  }
+
+  // Equality comparable
+  inline bool
+  operator==(const memory_footprint& a, const memory_footprint& b)
+  {
+    return a.live == b.live && a.reserved == b.reserved && a.dead == b.dead;
+  }
+
+  inline bool
+  operator!=(const memory_footprint& a, const memory_footprint& b)
+  {
+    return !(a == b);
+  }
+
+
+  // Returns the footprint of the elements of the contiguous container c,
+  // which has size() and capacity() operations, like std::vector.
+  template <typename C>
+    inline memory_footprint
+    contiguous_footprint(const C& c)
+    {
+      using T = typename C::value_type;
+      return {c.size() * sizeof(T), c.capacity() * sizeof(T)};
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,35 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <vector>
+
+#include <origin/memory/usage.hpp>
+
+using namespace std;
+using namespace origin;
+
+int main()
+{
+  memory_footprint a;
+  assert(a.live == 0 && a.reserved == 0 && a.dead == 0);
+
+  memory_footprint b(10, 30, 2);
+  assert(b.slack() == 20);
+  a += b;
+  assert(a == b);
+  assert(a + b == memory_footprint(20, 60, 4));
+
+  vector<double> v;
+  v.reserve(100);
+  v.resize(10);
+  memory_footprint f = contiguous_footprint(v);
+  assert(f.live == 10 * sizeof(double));
+  assert(f.reserved == v.capacity() * sizeof(double));
+  v.shrink_to_fit();
+  assert(contiguous_footprint(v).slack() == 0);
+}
@@ -9,11 +9,36 @@
 #define ORIGIN_SEQUENCE_ALGORITHM_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#if defined(__AVX512F__)
+#  include <immintrin.h>
+#endif
 
 #include "concepts.hpp"
+#include "execution.hpp"
+#include "random.hpp"
 
 namespace origin
 {
+#include "algorithm.impl/simd.hpp"
+#include "algorithm.impl/sort.hpp"
+
   // ------------------------------------------------------------------------ //
   //                                                                [algo.quant]
   //                              Quantifiers
@@ -21,6 +46,10 @@ namespace origin
   // The quantifier algorithms evaluate a range of elements to determine if
   // all elements in that range posess that property, some (or any) do, or
   // if none do. The property is defined by a predicate function.
+  //
+  // The match algorithms that compare the elements of a contiguous range
+  // (see [algo.simd]) with a value of its arithmetic value type use vector
+  // instructions, as do find, count, range_mismatch and range_equal.
 
 
   // ------------------------------------------------------------------------ //
@@ -56,9 +85,9 @@ namespace origin
     inline Requires<Input_iterator<I>(), bool>
     all_match(I first, I last, const T& value)
     {
-      while (first != last && *first == value)
-        ++first;
-      return first == last;
+      using Simd = algorithm_impl::Simd_iterator_search<I, T>;
+      return algorithm_impl::find_match(first, last, value, false, Simd())
+          == last;
     }
 
   // Returns true iff comp(x, value) for all x in [first, last).
@@ -78,7 +107,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return all_match(begin(range), end(range), value);
+      using Simd = algorithm_impl::Simd_range_search<const R&, T>;
+      return algorithm_impl::find_match(begin(range), end(range), value,
+                                        false, Simd())
+          == end(range);
     }
 
   template<typename R, typename T, typename C>
@@ -120,9 +152,9 @@ namespace origin
     inline Requires<Input_iterator<I>(), bool>
     any_match(I first, I last, const T& value)
     {
-      while (first != last && *first != value)
-        ++first;
-      return first != last;
+      using Simd = algorithm_impl::Simd_iterator_search<I, T>;
+      return algorithm_impl::find_match(first, last, value, true, Simd())
+          != last;
     }
 
   // Returns true if comp(x, value) is true for some x in [first, last).
@@ -142,7 +174,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return any_match(begin(range), end(range), value);
+      using Simd = algorithm_impl::Simd_range_search<const R&, T>;
+      return algorithm_impl::find_match(begin(range), end(range), value,
+                                        true, Simd())
+          != end(range);
     }
 
   template<typename R, typename T, typename C>
@@ -185,9 +220,9 @@ namespace origin
     inline Requires<Input_iterator<I>(), bool>
     none_match(I first, I last, const T& value)
     {
-      while (first != last && *first != value)
-        ++first;
-      return first == last;
+      using Simd = algorithm_impl::Simd_iterator_search<I, T>;
+      return algorithm_impl::find_match(first, last, value, true, Simd())
+          == last;
     }
 
   template<typename I, typename T, typename C>
@@ -205,7 +240,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return none_match(begin(range), end(range), value);
+      using Simd = algorithm_impl::Simd_range_search<const R&, T>;
+      return algorithm_impl::find_match(begin(range), end(range), value,
+                                        true, Simd())
+          == end(range);
     }
 
   template<typename R, typename T, typename C>
@@ -237,7 +275,22 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      std::for_each(begin(range), end(range), f);
+      return std::for_each(begin(range), end(range), f);
+    }
+
+  // The for_each_index algorithm calls f(i, x) for each element x of range,
+  // where i is the index of x in range, and returns f. This is convenient
+  // when the elements index another sequence, or are indexed by it:
+  //
+  //    for_each_index(x, [&](std::size_t i, double& xi) { xi += a * y[i]; });
+  template <typename R, typename F>
+    inline F
+    for_each_index(R&& range, F f)
+    {
+      std::size_t i = 0;
+      for (auto&& x : range)
+        f(i++, x);
+      return f;
     }
 
 
@@ -254,7 +307,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::find(begin(range), end(range), value);
+      using Simd = algorithm_impl::Simd_range_search<R, T>;
+      return algorithm_impl::find_match(begin(range), end(range), value,
+                                        true, Simd());
     }
 
 
@@ -394,7 +449,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::count(begin(range), end(range), value);
+      using Simd = algorithm_impl::Simd_range_search<const R&, T>;
+      return algorithm_impl::count_match(begin(range), end(range), value,
+                                         Simd());
     }
 
   template <typename R, typename P>
@@ -418,7 +475,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::mismatch(begin(range1), end(range1), begin(range2));
+      using Simd = algorithm_impl::Simd_range_mismatch<R1, R2>;
+      return algorithm_impl::mismatch_match(begin(range1), end(range1),
+                                            begin(range2), Simd());
     }
 
   template <typename R1, typename R2, typename C>
@@ -443,7 +502,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::equal(begin(range1), end(range1), begin(range2));
+      using Simd = algorithm_impl::Simd_range_mismatch<const R1&, const R2&>;
+      return algorithm_impl::mismatch_match(begin(range1), end(range1),
+                                            begin(range2), Simd()).first
+          == end(range1);
     }
 
   template <typename R1, typename R2, typename C>
@@ -459,6 +521,76 @@ namespace origin
   //////////////////////////////////////////////////////////////////////////////
   // Is Permutation
   //
+  // Deciding whether the elements of range1 are a permutation of the first
+  // elements of range2 takes quadratic time in the worst case when only
+  // their equality is known. When the ranges have the same value type and
+  // it is hashable (by std::hash), the occurrences of the values of range1
+  // are counted in a hash table, and those of range2 are subtracted from
+  // them, in expected linear time. Otherwise, when the value type is
+  // totally ordered, copies of the ranges are sorted and compared, in
+  // O(n log n) time. The common prefix of the ranges is skipped first.
+  // An equivalence relation comp is only known to be an equality, so the
+  // overload taking comp uses std::is_permutation.
+
+  namespace algorithm_impl
+  {
+    // Safely deduce the result of the expression std::hash<T>()(x).
+    template <typename T>
+      struct get_hash_result
+      {
+      private:
+        template <typename X>
+          static auto check(const X& x) -> decltype(std::hash<X>()(x));
+        static subst_failure check(...);
+      public:
+        using type = decltype(check(std::declval<T>()));
+      };
+
+    // Returns true if values of type T can be hashed by std::hash.
+    template <typename T>
+      constexpr bool Hashable()
+      {
+        return Same<typename get_hash_result<T>::type, std::size_t>();
+      }
+
+    // Returns true if [f1, l1) is a permutation of the sequence beginning
+    // at f2, by counting the occurrences of values.
+    template <typename I1, typename I2, typename Ordered>
+      bool
+      is_permutation(I1 f1, I1 l1, I2 f2, std::true_type, Ordered)
+      {
+        std::unordered_map<Value_type<I1>, std::size_t> counts;
+        std::size_t n = 0;
+        for (; f1 != l1; ++f1, ++n)
+          ++counts[*f1];
+        for (; n != 0; ++f2, --n) {
+          auto i = counts.find(*f2);
+          if (i == counts.end() || i->second == 0)
+            return false;
+          --i->second;
+        }
+        return true;
+      }
+
+    // By sorting copies of the sequences.
+    template <typename I1, typename I2>
+      bool
+      is_permutation(I1 f1, I1 l1, I2 f2, std::false_type, std::true_type)
+      {
+        std::vector<Value_type<I1>> a(f1, l1);
+        std::vector<Value_type<I1>> b(f2, std::next(f2, a.size()));
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        return a == b;
+      }
+
+    template <typename I1, typename I2>
+      inline bool
+      is_permutation(I1 f1, I1 l1, I2 f2, std::false_type, std::false_type)
+      {
+        return std::is_permutation(f1, l1, f2);
+      }
+  } // namespace algorithm_impl
 
   template <typename R1, typename R2>
     inline bool 
@@ -466,7 +598,14 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::is_permutation(begin(range1), end(range1), begin(range2));
+      using T = Value_type<Iterator_of<const R1>>;
+      constexpr bool same = Same<T, Value_type<Iterator_of<const R2>>>();
+      using Hash = std::integral_constant<
+        bool, same && algorithm_impl::Hashable<T>()>;
+      using Order = std::integral_constant<bool, same && Totally_ordered<T>()>;
+      auto p = std::mismatch(begin(range1), end(range1), begin(range2));
+      return algorithm_impl::is_permutation(p.first, end(range1), p.second,
+                                            Hash(), Order());
     }
 
   template <typename R1, typename R2, typename C>
@@ -481,17 +620,316 @@ namespace origin
     }
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                               [algo.search]
+  //                               Searchers
+  //
+  // A searcher holds a pattern of integers of type T, preprocessed for
+  // searching. Calling s(first, last) returns the first position in the
+  // random access range [first, last) at which the pattern occurs, or last
+  // (first if the pattern is empty), and search(range, s) searches a range:
+  //
+  //    horspool_searcher<T>(pattern)   Boyer-Moore-Horspool
+  //    two_way_searcher<T>(pattern)    Crochemore-Perrin two-way
+  //    filter_searcher<T>(pattern)     First and last element filtering
+  //
+  // The Horspool search compares the last element of each window with that
+  // of the pattern, and shifts the window by the distance from the end of
+  // the pattern to the last earlier occurrence of its last element, in a
+  // table indexed by the low byte of the element. Long patterns are usually
+  // found after examining a small fraction of the text, but the worst case
+  // takes O(nm) time. The two-way search takes O(n + m) time and constant
+  // space in all cases, by splitting the pattern at a critical point and
+  // matching its right part and then its left part. The filter search finds
+  // the positions at which the first and last elements of the pattern occur,
+  // comparing a register of positions at a time (see [algo.simd]), and
+  // compares the rest of the pattern only at those positions; it is the
+  // fastest for short patterns. Its text must be contiguous.
+  //
+  // When the text and pattern of search(range1, range2) are contiguous
+  // ranges of the same integer type, patterns of at most 32 elements are
+  // found by the filter search, and longer ones by the Horspool search.
+
+
+  namespace algorithm_impl
+  {
+    // The Horspool shift of each value of the low byte of an element.
+    template <typename T>
+      void
+      horspool_table(const T* q, std::size_t m, std::size_t* shift)
+      {
+        std::fill(shift, shift + 256, m);
+        for (std::size_t i = 0; i + 1 < m; ++i)
+          shift[static_cast<unsigned char>(q[i])] = m - 1 - i;
+      }
+
+    // Returns the first position in [first, last) of the m > 0 elements at
+    // q, whose Horspool shifts are in shift.
+    template <typename I, typename T>
+      I
+      horspool_search(I first, I last, const T* q, std::size_t m,
+                      const std::size_t* shift)
+      {
+        std::size_t n = last - first;
+        const T z = q[m - 1];
+        for (std::size_t i = 0; n - i >= m; ) {
+          const T x = first[i + m - 1];
+          if (x == z && std::equal(q, q + m - 1, first + i))
+            return first + i;
+          i += shift[static_cast<unsigned char>(x)];
+        }
+        return last;
+      }
+
+    // Returns the start of the maximal suffix of the m elements at q under
+    // the order of the elements, or the reverse order, and sets p to its
+    // period.
+    template <typename T>
+      std::ptrdiff_t
+      maximal_suffix(const T* q, std::ptrdiff_t m, bool reversed,
+                     std::ptrdiff_t& p)
+      {
+        std::ptrdiff_t s = -1, j = 0, k = 1;
+        p = 1;
+        while (j + k < m) {
+          T a = q[j + k];
+          T b = q[s + k];
+          if (reversed ? b < a : a < b) {
+            j += k;
+            k = 1;
+            p = j - s;
+          } else if (a == b) {
+            if (k != p) {
+              ++k;
+            } else {
+              j += p;
+              k = 1;
+            }
+          } else {
+            s = j;
+            j = s + 1;
+            k = p = 1;
+          }
+        }
+        return s;
+      }
+
+    // Search the text of Fast_search ranges by the length of the pattern.
+    template <typename R1, typename R2>
+      constexpr bool
+      Fast_search()
+      {
+        using T = Value_type<Iterator_of<R1>>;
+        return Contiguous_range<R1>() && Contiguous_range<R2>()
+            && Same<Value_type<Iterator_of<R2>>, T>() && Integer<T>();
+      }
+
+    // The first and last element filter uses vector instructions for the
+    // types that can be compared in registers.
+    template <typename T>
+      inline const T*
+      filter_search(const T* first, const T* last, const T* q, std::size_t m,
+                    std::false_type)
+      {
+        return filter_search(first, last, q, m);
+      }
+
+#if defined(__SSE2__)
+    template <typename T>
+      inline const T*
+      filter_search(const T* first, const T* last, const T* q, std::size_t m,
+                    std::true_type)
+      {
+        return simd_search(first, last, q, m);
+      }
+#endif
+
+    // Returns the first position in the contiguous range [first, last) of
+    // the m > 0 elements at q.
+    template <typename I, typename T>
+      inline I
+      contiguous_search(I first, I last, const T* q, std::size_t m)
+      {
+        if (first == last)
+          return last;
+        using Simd = std::integral_constant<bool, Simd_comparable<T>()>;
+        const T* p = std::addressof(*first);
+        return first + (filter_search(p, p + (last - first), q, m, Simd())
+                        - p);
+      }
+
+    template <typename I, typename J>
+      inline I
+      search(I first, I last, J pfirst, J plast, std::false_type)
+      {
+        return std::search(first, last, pfirst, plast);
+      }
+
+    template <typename I, typename J>
+      I
+      search(I first, I last, J pfirst, J plast, std::true_type)
+      {
+        using T = Value_type<I>;
+        std::size_t m = plast - pfirst;
+        if (m == 0)
+          return first;
+        const T* q = std::addressof(*pfirst);
+        if (m <= 32)
+          return contiguous_search(first, last, q, m);
+        std::size_t shift[256];
+        horspool_table(q, m, shift);
+        return horspool_search(first, last, q, m, shift);
+      }
+  } // namespace algorithm_impl
+
+
+  template <typename T>
+    class horspool_searcher
+    {
+      static_assert(Integer<T>(), "");
+    public:
+      template <typename R>
+        explicit horspool_searcher(const R& pattern)
+          : pat_(std::begin(pattern), std::end(pattern))
+        {
+          algorithm_impl::horspool_table(pat_.data(), pat_.size(), shift_);
+        }
+
+      template <typename I>
+        I operator()(I first, I last) const
+        {
+          if (pat_.empty())
+            return first;
+          return algorithm_impl::horspool_search(first, last, pat_.data(),
+                                                 pat_.size(), shift_);
+        }
+
+    private:
+      std::vector<T> pat_;
+      std::size_t shift_[256];
+    };
+
+
+  // The pattern is split at the start l + 1 of the greater of its maximal
+  // suffixes under the order and the reverse order, which is a critical
+  // factorization. If the left part is a suffix of the right part, the
+  // pattern has period p, and the elements known to match after a shift by
+  // p are remembered; otherwise the shift after a match of the right part
+  // is at least max(l + 1, m - l - 1) + 1.
+  template <typename T>
+    class two_way_searcher
+    {
+      static_assert(Integer<T>(), "");
+    public:
+      template <typename R>
+        explicit two_way_searcher(const R& pattern)
+          : pat_(std::begin(pattern), std::end(pattern))
+        {
+          std::ptrdiff_t m = pat_.size();
+          if (m == 0)
+            return;
+          const T* q = pat_.data();
+          std::ptrdiff_t p1, p2;
+          std::ptrdiff_t s1 = algorithm_impl::maximal_suffix(q, m, false, p1);
+          std::ptrdiff_t s2 = algorithm_impl::maximal_suffix(q, m, true, p2);
+          l_ = s1 > s2 ? s1 : s2;
+          p_ = s1 > s2 ? p1 : p2;
+          periodic_ = p_ + l_ + 1 <= m && std::equal(q, q + l_ + 1, q + p_);
+          if (!periodic_)
+            p_ = std::max(l_ + 1, m - l_ - 1) + 1;
+        }
+
+      template <typename I>
+        I operator()(I first, I last) const
+        {
+          std::ptrdiff_t m = pat_.size();
+          std::ptrdiff_t n = last - first;
+          if (m == 0)
+            return first;
+          const T* q = pat_.data();
+          std::ptrdiff_t mem = -1;
+          for (std::ptrdiff_t j = 0; j <= n - m; ) {
+            // Match the right part, after what is known to match.
+            std::ptrdiff_t i = std::max(l_, mem) + 1;
+            while (i < m && q[i] == first[i + j])
+              ++i;
+            if (i < m) {
+              j += i - l_;
+              mem = -1;
+              continue;
+            }
+            // Match the left part, before what is known to match.
+            i = l_;
+            while (i > mem && q[i] == first[i + j])
+              --i;
+            if (i <= mem)
+              return first + j;
+            j += p_;
+            mem = periodic_ ? m - p_ - 1 : -1;
+          }
+          return last;
+        }
+
+    private:
+      std::vector<T> pat_;
+      std::ptrdiff_t l_ = -1;           // The end of the left part
+      std::ptrdiff_t p_ = 1;            // The shift after a match
+      bool periodic_ = false;
+    };
+
+
+  template <typename T>
+    class filter_searcher
+    {
+      static_assert(Integer<T>(), "");
+    public:
+      template <typename R>
+        explicit filter_searcher(const R& pattern)
+          : pat_(std::begin(pattern), std::end(pattern))
+        { }
+
+      // The range [first, last) must be contiguous.
+      template <typename I>
+        I operator()(I first, I last) const
+        {
+          if (pat_.empty())
+            return first;
+          return algorithm_impl::contiguous_search(first, last, pat_.data(),
+                                                   pat_.size());
+        }
+
+    private:
+      std::vector<T> pat_;
+    };
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Search
   //
+  // The search for the elements of range2 in range1 chooses an algorithm
+  // when both are contiguous ranges of the same integer type (see
+  // [algo.search]); otherwise, it uses std::search.
   template <typename R1, typename R2>
-    inline Iterator_of<R1>
+    inline Requires<Input_range<const R2>(), Iterator_of<R1>>
     search(R1&& range1, const R2& range2)
     {
       using std::begin;
       using std::end;
-      return std::search(begin(range1), end(range1), 
-                         begin(range2), end(range2)); 
+      using Fast = std::integral_constant<
+        bool, algorithm_impl::Fast_search<R1, const R2&>()>;
+      return algorithm_impl::search(begin(range1), end(range1),
+                                    begin(range2), end(range2), Fast());
+    }
+
+  // Search range for the pattern of the searcher s, returning s(first,
+  // last) for the bounds of range.
+  template <typename R, typename S>
+    inline Requires<!Input_range<const S>(), Iterator_of<R>>
+    search(R&& range, const S& s)
+    {
+      using std::begin;
+      using std::end;
+      return s(begin(range), end(range));
     }
 
   template <typename R1, typename R2, typename C>
@@ -528,6 +966,180 @@ namespace origin
     }
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                               [algo.stream]
+  //                             Streaming Stores
+  //
+  // The copy, move, fill and generate algorithms write ranges of at least
+  // stream_threshold bytes with non-temporal stores (see [algo.simd]) when
+  // the ranges are contiguous, their values are trivially copyable, and
+  // those of a copy or move have the same type and do not overlap. The
+  // stores go to memory without first reading the lines they write, and
+  // without evicting the working set of the program from the cache, which
+  // a copy of many gigabytes would otherwise replace with lines that are
+  // not read again soon. Below the threshold, or when the values will be
+  // read at once, ordinary stores are faster. A fill also requires the size
+  // of the values to divide 16.
+  //
+  // The parallel copy, move and fill algorithms (see [algo.par]) divide the
+  // ranges into blocks, and write each block with non-temporal stores on
+  // the same conditions, so that each thread streams to memory.
+  //
+  // The copy constructor of a matrix of trivially copyable values and the
+  // relocation of the slot array of an adjacency list pool stream their
+  // buffers on the same threshold (see algorithm_impl::stream_memcpy).
+
+  namespace algorithm_impl
+  {
+    // The least number of bytes written with non-temporal stores.
+    constexpr std::size_t stream_threshold = std::size_t(1) << 23;
+
+    // Returns true if the n values at p and at q overlap.
+    template<typename T>
+      inline bool
+      overlapping(const T* p, const T* q, std::size_t n)
+      {
+        std::uintptr_t a = reinterpret_cast<std::uintptr_t>(p);
+        std::uintptr_t b = reinterpret_cast<std::uintptr_t>(q);
+        return a < b + n * sizeof(T) && b < a + n * sizeof(T);
+      }
+
+    // A copy or move from R1 to R2 can be streamed if both are contiguous
+    // ranges of the same trivially copyable type.
+    template<typename R1, typename R2, typename T = Value_type<Iterator_of<R1>>>
+      using Stream_copy
+        = std::integral_constant<bool, Contiguous_range<R1>()
+                                       && Contiguous_range<R2>()
+                                       && Same<Value_type<Iterator_of<R2>>, T>()
+                                       && Simd_streamable<T>()>;
+
+    // A fill of R with a value of type U can be streamed if R is contiguous,
+    // its values are trivially copyable and their size divides 16, and U is
+    // the same type, or both are arithmetic types.
+    template<typename R, typename U, typename T = Value_type<Iterator_of<R>>>
+      using Stream_fill
+        = std::integral_constant<bool, Contiguous_range<R>()
+                                       && Simd_streamable<T>()
+                                       && 16 % sizeof(T) == 0
+                                       && (Same<Decay<U>, T>()
+                                           || (Arithmetic<Decay<U>>()
+                                               && Arithmetic<T>()))>;
+
+    template<typename R, typename T = Value_type<Iterator_of<R>>>
+      using Stream_generate
+        = std::integral_constant<bool, Contiguous_range<R>()
+                                       && Simd_streamable<T>()>;
+
+    // Returns true if writing n values of type T is streamed.
+    template<typename T>
+      inline bool
+      streamed(std::size_t n)
+      {
+        return n * sizeof(T) >= stream_threshold;
+      }
+
+    // Copy the n bytes at src to dst, which do not overlap, as by memcpy.
+    // If stream is true, the bytes are written with non-temporal stores
+    // where they are available. Containers that copy or relocate buffers of
+    // trivially copyable values use this for their own bulk copies.
+    inline void
+    stream_memcpy(void* dst, const void* src, std::size_t n, bool stream)
+    {
+#if defined(__SSE2__)
+      if (stream) {
+        simd_stream_copy(static_cast<const char*>(src),
+                         static_cast<char*>(dst), n);
+        return;
+      }
+#endif
+      std::memcpy(dst, src, n);
+    }
+
+    template<typename I, typename O>
+      inline O
+      stream_copy(I first, I last, O out, std::false_type)
+      {
+        return std::copy(first, last, out);
+      }
+
+    template<typename I, typename O>
+      inline O
+      stream_move(I first, I last, O out, std::false_type)
+      {
+        return std::move(first, last, out);
+      }
+
+    template<typename I, typename T>
+      inline void
+      stream_fill(I first, I last, const T& value, std::false_type)
+      {
+        std::fill(first, last, value);
+      }
+
+    template<typename I, typename Gen>
+      inline void
+      stream_generate(I first, I last, Gen& gen, std::false_type)
+      {
+        std::generate(first, last, gen);
+      }
+
+#if defined(__SSE2__)
+    // The contiguous iterators are converted to pointers to stream. A move
+    // of trivially copyable values is a copy.
+    template<typename I, typename O>
+      O
+      stream_copy(I first, I last, O out, std::true_type)
+      {
+        using T = Value_type<I>;
+        std::size_t n = last - first;
+        if (!streamed<T>(n))
+          return std::copy(first, last, out);
+        const T* p = std::addressof(*first);
+        T* q = std::addressof(*out);
+        if (overlapping(p, q, n))
+          return std::copy(first, last, out);
+        simd_stream_copy(reinterpret_cast<const char*>(p),
+                         reinterpret_cast<char*>(q), n * sizeof(T));
+        return out + n;
+      }
+
+    template<typename I, typename O>
+      inline O
+      stream_move(I first, I last, O out, std::true_type)
+      {
+        return stream_copy(first, last, out, std::true_type());
+      }
+
+    template<typename I, typename T>
+      void
+      stream_fill(I first, I last, const T& value, std::true_type)
+      {
+        std::size_t n = last - first;
+        if (!streamed<Value_type<I>>(n)) {
+          std::fill(first, last, value);
+          return;
+        }
+        Value_type<I>* p = std::addressof(*first);
+        simd_stream_fill(p, p + n, Value_type<I>(value));
+      }
+
+    template<typename I, typename Gen>
+      void
+      stream_generate(I first, I last, Gen& gen, std::true_type)
+      {
+        std::size_t n = last - first;
+        if (!streamed<Value_type<I>>(n)) {
+          std::generate(first, last, gen);
+          return;
+        }
+        Value_type<I>* p = std::addressof(*first);
+        simd_stream_generate(p, p + n, gen);
+      }
+#endif
+
+  } // namespace algorithm_impl
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Copy
   //
@@ -538,7 +1150,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::copy(begin(range1), end(range1), begin(range2));
+      return algorithm_impl::stream_copy(
+        begin(range1), end(range1), begin(range2),
+        algorithm_impl::Stream_copy<const R1&, R2>());
     }
 
   template <typename R1, typename R2, typename P>
@@ -561,7 +1175,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::move(begin(range1), end(range1), begin(range2));
+      return algorithm_impl::stream_move(
+        begin(range1), end(range1), begin(range2),
+        algorithm_impl::Stream_copy<const R1&, R2>());
     }
 
 
@@ -576,7 +1192,8 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      std::fill(begin(range), end(range), value);
+      algorithm_impl::stream_fill(begin(range), end(range), value,
+                                  algorithm_impl::Stream_fill<R, T>());
     }
 
 
@@ -591,7 +1208,8 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      std::generate(begin(range), end(range), gen);
+      algorithm_impl::stream_generate(begin(range), end(range), gen,
+                                      algorithm_impl::Stream_generate<R>());
       return gen;
     }
 
@@ -679,7 +1297,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::remove(begin(range), end(range), value);
+      using Simd = algorithm_impl::Simd_range_search<R, T>;
+      return algorithm_impl::remove_match(begin(range), end(range), value,
+                                          Simd());
     }
 
   template <typename R, typename P>
@@ -697,7 +1317,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::remove_copy(begin(range1), end(range1), begin(range2), value);
+      using Simd = algorithm_impl::Simd_range_remove<const R1&, R2, T>;
+      return algorithm_impl::remove_copy_match(begin(range1), end(range1),
+                                               begin(range2), value, Simd());
     }
 
   template <typename R1, typename R2, typename P>
@@ -757,6 +1379,303 @@ namespace origin
     }
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                                  [algo.rle]
+  //                           Run-Length Encoding
+  //
+  //    run_length_encode(range, values, counts[, eq])
+  //
+  // The run_length_encode algorithm writes the first value of each run of
+  // equal adjacent elements of range to values, and the length of the run
+  // to the corresponding element of counts, and returns the ends of the
+  // values and counts written. Elements are compared by eq, which must be
+  // an equivalence relation (by default, ==). For example, the degrees of
+  // the vertices of a sorted list of edge sources are:
+  //
+  //    vector<int> src {0, 0, 0, 2, 2, 3};
+  //    vector<int> v(src.size());
+  //    vector<size_t> deg(src.size());
+  //    auto ends = run_length_encode(src, v, deg);
+  //    // v is {0, 2, 3, ...}, deg is {3, 2, 1, ...}
+  //
+  // The values are those that unique(range) leaves. When the range is
+  // contiguous and its values are integers compared by ==, the end of each
+  // run is found by comparing adjacent elements in vector registers (see
+  // [algo.simd]). The parallel run_length_encode (see [algo.par]) counts
+  // the runs that begin in each block of the range, and then writes them
+  // at the offsets of their blocks; the last run of a block is followed
+  // into the next blocks, so that runs crossing block boundaries are
+  // written once, by the block in which they begin.
+
+  namespace algorithm_impl
+  {
+    // Returns true if a == b.
+    struct equal_values
+    {
+      template<typename T, typename U>
+        bool operator()(const T& a, const U& b) const { return a == b; }
+    };
+
+    // Returns the end of the run beginning at first: the first element of
+    // [first, last) that is not equivalent to *first, or last. The vector
+    // version compares adjacent elements.
+    template<typename I, typename E>
+      inline I
+      run_end(I first, I last, E eq, std::false_type)
+      {
+        I i = first;
+        while (++i != last && eq(*first, *i))
+          continue;
+        return i;
+      }
+
+    template<typename I, typename E>
+      inline I
+      run_end(I first, I last, E, std::true_type)
+      {
+        if (last - first < 2)
+          return last;
+        return mismatch_match(first, last - 1, first + 1,
+                              std::true_type()).first + 1;
+      }
+
+    template<typename I, typename O1, typename O2, typename E, typename S>
+      std::pair<O1, O2>
+      run_length_encode(I first, I last, O1 values, O2 counts, E eq, S simd)
+      {
+        while (first != last) {
+          I i = run_end(first, last, eq, simd);
+          *values = *first;
+          *counts = std::distance(first, i);
+          ++values;
+          ++counts;
+          first = i;
+        }
+        return {values, counts};
+      }
+
+    // Runs of the range R are found with vector instructions if it is
+    // contiguous and its values compare equal in vector registers.
+    template<typename R, typename T = Value_type<Iterator_of<R>>>
+      using Simd_range_runs
+        = std::integral_constant<bool, Contiguous_range<R>()
+                                       && Simd_comparable<T>()>;
+
+  } // namespace algorithm_impl
+
+
+  template <typename R1, typename R2, typename R3, typename E>
+    inline Requires<Input_range<const R1>(),
+                    std::pair<Iterator_of<R2>, Iterator_of<R3>>>
+    run_length_encode(const R1& range, R2&& values, R3&& counts, E eq)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::run_length_encode(begin(range), end(range),
+                                               begin(values), begin(counts),
+                                               eq, std::false_type());
+    }
+
+  template <typename R1, typename R2, typename R3>
+    inline Requires<Input_range<const R1>(),
+                    std::pair<Iterator_of<R2>, Iterator_of<R3>>>
+    run_length_encode(const R1& range, R2&& values, R3&& counts)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::run_length_encode(
+        begin(range), end(range), begin(values), begin(counts),
+        algorithm_impl::equal_values(),
+        algorithm_impl::Simd_range_runs<const R1&>());
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                             [algo.distinct]
+  //                             Distinct Values
+  //
+  //    hash_unique(range[, hash])
+  //    distinct(range1, range2[, hash])
+  //
+  // The hash_unique algorithm removes every element of range that is equal
+  // to an earlier element, whether or not they are adjacent, and returns the
+  // end of the distinct values that remain, in the order of their first
+  // occurrences. The distinct algorithm copies the first occurrence of each
+  // value of range1 to range2, and returns the end of the copy. For example:
+  //
+  //    vector<pair<int, int>> edges {{1, 2}, {0, 1}, {1, 2}, {2, 0}};
+  //    edges.erase(hash_unique(edges), edges.end());
+  //    // edges is {{1, 2}, {0, 1}, {2, 0}}
+  //
+  // Values are hashed by hash (by default, std::hash, and the combination of
+  // the hashes of the members of pairs), and the first occurrences are
+  // recorded in an open addressing hash table with linear probing, whose
+  // size is doubled when it is half full. The hashes are mixed by the
+  // splitmix64 finalizer, so that hashes that are the values themselves,
+  // such as those of integers, are spread over the table. The table holds
+  // the hashes and positions of the values, not copies of them. The
+  // expected time is linear in the size of the range.
+
+
+  namespace algorithm_impl
+  {
+    // The default hash of a value: std::hash, or the combination of the
+    // hashes of the members of a pair.
+    struct hash_value
+    {
+      template <typename T>
+        std::size_t operator()(const T& x) const { return std::hash<T>()(x); }
+
+      template <typename T, typename U>
+        std::size_t operator()(const std::pair<T, U>& x) const
+        {
+          std::uint64_t h = (*this)(x.first);
+          return std::size_t(random_impl::mix(h) ^ (*this)(x.second));
+        }
+    };
+
+    // An open addressing set of keys identifying values, with linear
+    // probing. The keys are positions in a range, and eq(a, b) returns
+    // true if the values at a and b are equal.
+    template <typename K, typename E>
+      class distinct_set
+      {
+        struct slot
+        {
+          std::uint64_t hash;
+          K key;
+          bool full;
+        };
+
+      public:
+        explicit distinct_set(E eq)
+          : eq_(eq), slots_(16, slot {0, K(), false}), size_(0)
+        { }
+
+        // Insert the key k of a value whose (mixed) hash is h, unless the
+        // set has a key of an equal value. Returns the inserted key, which
+        // may be changed to a key of an equal value, or null.
+        K* insert(K k, std::uint64_t h)
+        {
+          if (2 * (size_ + 1) > slots_.size())
+            grow();
+          std::size_t mask = slots_.size() - 1;
+          for (std::size_t i = h & mask; ; i = (i + 1) & mask) {
+            slot& s = slots_[i];
+            if (!s.full) {
+              s = slot {h, k, true};
+              ++size_;
+              return &s.key;
+            }
+            if (s.hash == h && eq_(s.key, k))
+              return nullptr;
+          }
+        }
+
+      private:
+        void grow()
+        {
+          std::vector<slot> old(2 * slots_.size(), slot {0, K(), false});
+          old.swap(slots_);
+          std::size_t mask = slots_.size() - 1;
+          for (const slot& s : old) {
+            if (!s.full)
+              continue;
+            std::size_t i = s.hash & mask;
+            while (slots_[i].full)
+              i = (i + 1) & mask;
+            slots_[i] = s;
+          }
+        }
+
+      private:
+        E eq_;
+        std::vector<slot> slots_;
+        std::size_t size_;
+      };
+
+    template <typename K, typename E>
+      inline distinct_set<K, E>
+      make_distinct_set(E eq)
+      {
+        return distinct_set<K, E>(eq);
+      }
+
+    // Returns true if the values at the iterators a and b are equal.
+    struct equal_at
+    {
+      template <typename I>
+        bool operator()(I a, I b) const { return *a == *b; }
+    };
+
+    template <typename I, typename H>
+      I
+      hash_unique(I first, I last, H hash)
+      {
+        auto set = make_distinct_set<I>(equal_at());
+        I out = first;
+        for (; first != last; ++first) {
+          std::uint64_t h = random_impl::mix(hash(*first));
+          if (I* p = set.insert(first, h)) {
+            if (out != first)
+              *out = std::move(*first);
+            *p = out;
+            ++out;
+          }
+        }
+        return out;
+      }
+
+    template <typename I, typename O, typename H>
+      O
+      distinct(I first, I last, O out, H hash)
+      {
+        auto set = make_distinct_set<I>(equal_at());
+        for (; first != last; ++first)
+          if (set.insert(first, random_impl::mix(hash(*first)))) {
+            *out = *first;
+            ++out;
+          }
+        return out;
+      }
+  } // namespace algorithm_impl
+
+
+  template <typename R, typename H>
+    inline Requires<Forward_range<R>(), Iterator_of<R>>
+    hash_unique(R&& range, H hash)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::hash_unique(begin(range), end(range), hash);
+    }
+
+  template <typename R>
+    inline Requires<Forward_range<R>(), Iterator_of<R>>
+    hash_unique(R&& range)
+    {
+      return hash_unique(std::forward<R>(range), algorithm_impl::hash_value());
+    }
+
+  template <typename R1, typename R2, typename H>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    distinct(const R1& range1, R2&& range2, H hash)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::distinct(begin(range1), end(range1),
+                                      begin(range2), hash);
+    }
+
+  template <typename R1, typename R2>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    distinct(const R1& range1, R2&& range2)
+    {
+      return distinct(range1, std::forward<R2>(range2),
+                      algorithm_impl::hash_value());
+    }
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Reverse
   //
@@ -783,9 +1702,21 @@ namespace origin
   //////////////////////////////////////////////////////////////////////////////
   // Shuffle
   //
-  //
-  // NOTE: It would be nice to get rid of the original random_shuffle algoriths
-  // and just focus on the new random framework.
+  // The shuffle algorithms randomly permute a range. The random_shuffle
+  // algorithms are implemented here, since their standard counterparts are
+  // deprecated. Without a generator, random_shuffle uses an xoshiro256ss
+  // engine local to the calling thread. With a generator, gen(n) must
+  // return a random integer in [0, n).
+
+  namespace algorithm_impl
+  {
+    inline xoshiro256ss&
+    shuffle_engine()
+    {
+      static thread_local xoshiro256ss prng;
+      return prng;
+    }
+  } // namespace algorithm_impl
 
   template <typename R>
     inline void
@@ -793,7 +1724,7 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::random_shuffle(begin(range), end(range));
+      std::shuffle(begin(range), end(range), algorithm_impl::shuffle_engine());
     }
 
   template <typename R, typename Gen>
@@ -802,8 +1733,16 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::random_shuffle(begin(range), end(range), 
-                                 std::forward<Gen>(gen));
+      static_assert(Random_access_range<R>(), "");
+      using I = Iterator_of<R>;
+      using D = Difference_type<I>;
+      I first = begin(range);
+      D n = end(range) - first;
+      for (D i = 1; i < n; ++i) {
+        D j = gen(i + 1);
+        if (j != i)
+          std::iter_swap(first + i, first + j);
+      }
     }
 
   template <typename R, typename Gen>
@@ -816,6 +1755,67 @@ namespace origin
     }
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Sample
+  //
+  // The sample algorithms return a random sample of k elements of a range,
+  // without replacement, in a single pass, so that the range may be an input
+  // range. If the range has fewer than k elements, all of them are returned.
+  //
+  //    sample(range, k, gen)
+  //    weighted_sample(range, k, weight, gen)
+  //
+  // The sample algorithm uses reservoir sampling by Li's Algorithm L: after
+  // the first k elements, the number of elements skipped before the next
+  // replacement is drawn directly (it is geometrically distributed), so
+  // that O(k log(n/k)) random numbers are drawn for n elements. The
+  // weighted_sample algorithm samples each element x with probability
+  // proportional to weight(x), using a reservoir (see [random.reservoir]).
+  // Elements with no positive weight are never sampled. To sample with
+  // replacement, use an alias_distribution (see [random.alias]).
+
+  template <typename R, typename Gen>
+    std::vector<Value_type<Iterator_of<R>>>
+    sample(R&& range, std::size_t k, Gen&& gen)
+    {
+      using std::begin;
+      using std::end;
+      using random_impl::open_unit;
+      auto first = begin(range);
+      auto last = end(range);
+      std::vector<Value_type<Iterator_of<R>>> v;
+      v.reserve(k);
+      for (; first != last && v.size() != k; ++first)
+        v.push_back(*first);
+      if (first == last || k == 0)
+        return v;
+
+      std::uniform_int_distribution<std::size_t> slot(0, k - 1);
+      double w = std::exp(std::log(open_unit(gen)) / k);
+      while (true) {
+        double s = std::floor(std::log(open_unit(gen)) / std::log1p(-w));
+        for (; s > 0 && first != last; --s)
+          ++first;
+        if (first == last)
+          break;
+        v[slot(gen)] = *first;
+        ++first;
+        w *= std::exp(std::log(open_unit(gen)) / k);
+      }
+      return v;
+    }
+
+  template <typename R, typename W, typename Gen>
+    std::vector<Value_type<Iterator_of<R>>>
+    weighted_sample(R&& range, std::size_t k, W weight, Gen&& gen)
+    {
+      reservoir<Value_type<Iterator_of<R>>> r(k);
+      for (auto&& x : range)
+        r.push(x, gen, weight(x));
+      return r.values();
+    }
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Partitions
 
@@ -868,626 +1868,5155 @@ namespace origin
     }
 
 
-  //////////////////////////////////////////////////////////////////////////////
-  // Sorting
+  // ------------------------------------------------------------------------ //
+  //                                                                 [algo.scan]
+  //                              Prefix Scans
   //
-  //////////////////////////////////////////////////////////////////////////////
-
+  //    inclusive_scan(range1, range2[, op])
+  //    exclusive_scan(range1, range2, init[, op])
+  //    segmented_scan(range1, heads, range2[, op])
+  //
+  // The scans write the running totals of the elements of range1 under an
+  // associative operation op (by default, std::plus) to range2, and return
+  // the iterator past the last total written. The ith total of an inclusive
+  // scan combines the first i + 1 elements, and that of an exclusive scan
+  // combines init and the first i elements. A segmented scan is an inclusive
+  // scan that starts again at each element whose corresponding value in the
+  // range heads is true, and at the first element. For example:
+  //
+  //    vector<int> degree {2, 0, 3, 1};
+  //    vector<int> offset(5);
+  //    exclusive_scan(degree, offset, 0);   // offset is {0, 2, 2, 5, 0}
+  //    offset[4] = offset[3] + degree[3];   // the CSR offsets of 4 vertices
+  //
+  // The totals have the value type of range1. Range2 may be range1, so
+  // that a range can be scanned in place. The sums of contiguous ranges of
+  // 4- and 8-byte integers are computed in vector registers (see
+  // [algo.simd]).
+
+
+  namespace algorithm_impl
+  {
+    // The scans of contiguous ranges of an integer type T under std::plus
+    // use vector instructions.
+    template<typename R1, typename R2, typename Op>
+      constexpr bool
+      Simd_scan()
+      {
+        using T = Value_type<Iterator_of<R1>>;
+        return Contiguous_range<R1>() && Contiguous_range<R2>()
+            && Same<T, Value_type<Iterator_of<R2>>>()
+            && Same<Op, std::plus<T>>() && Simd_scannable<T>();
+      }
+
+    // Write the totals of [first, last), combined with carry, to out, and
+    // return the last total, or carry if the range is empty. The totals are
+    // inclusive, or exclusive if inclusive is false.
+    template<typename I, typename O, typename Op, typename T>
+      T
+      scan_from(I first, I last, O out, Op op, T carry, bool inclusive,
+                std::false_type)
+      {
+        for (; first != last; ++first, ++out) {
+          T x = *first;
+          if (!inclusive)
+            *out = carry;
+          carry = op(carry, x);
+          if (inclusive)
+            *out = carry;
+        }
+        return carry;
+      }
+
+#if defined(__SSE2__)
+    template<typename I, typename O, typename Op, typename T>
+      inline T
+      scan_from(I first, I last, O out, Op, T carry, bool inclusive,
+                std::true_type)
+      {
+        if (first == last)
+          return carry;
+        const T* p = std::addressof(*first);
+        return simd_scan(p, p + (last - first), std::addressof(*out), carry,
+                         inclusive);
+      }
+#endif
 
-  template <typename R>
-    inline void
-    sort(R&& range)
+    // Write the inclusive totals of [first, last) to out.
+    template<typename I, typename O, typename Op, typename Simd>
+      inline O
+      inclusive_scan(I first, I last, O out, Op op, Simd simd)
+      {
+        if (first == last)
+          return out;
+        Value_type<I> x = *first;
+        *out = x;
+        std::size_t n = std::distance(first, last);
+        scan_from(std::next(first), last, std::next(out), op, x, true, simd);
+        return std::next(out, n);
+      }
+
+    // Write the totals of [first, last) to out, where h is the corresponding
+    // head flag of each element. The first totals continue the segment
+    // whose total is carry, if there is one. Returns the total of the last
+    // segment, and sets there to true if there is one.
+    template<typename I, typename H, typename O, typename Op, typename T>
+      T
+      segmented_scan_from(I first, I last, H h, O out, Op op,
+                          T carry, bool& there)
+      {
+        for (; first != last; ++first, ++h, ++out) {
+          if (*h || !there) {
+            carry = *first;
+            there = true;
+          } else {
+            carry = op(carry, *first);
+          }
+          *out = carry;
+        }
+        return carry;
+      }
+  } // namespace algorithm_impl
+
+
+  template<typename R1, typename R2, typename Op>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    inclusive_scan(const R1& range1, R2&& range2, Op op)
     {
       using std::begin;
       using std::end;
-      std::sort(begin(range), end(range));
+      using S = std::integral_constant<
+        bool, algorithm_impl::Simd_scan<const R1&, R2, Op>()>;
+      return algorithm_impl::inclusive_scan(begin(range1), end(range1),
+                                            begin(range2), op, S());
     }
 
-  // NOTE: This avoids overlaod collision because the argument types are
-  // different (std::sort takes two iterators). If we relax the requirement
-  // that iterators must the same, then this won't work without a lot of
-  // enable-if'ing.
-  template <typename R, typename C>
-    inline void
-    sort(R&& range, C comp)
+  template<typename R1, typename R2>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    inclusive_scan(const R1& range1, R2&& range2)
     {
-      using std::begin;
-      using std::end;
-      std::sort(begin(range), end(range), comp);
+      return inclusive_scan(range1, std::forward<R2>(range2),
+                            std::plus<Value_type<Iterator_of<const R1>>>());
     }
 
-  template <typename R>
-    inline void 
-    stable_sort(R&& range)
+  template<typename R1, typename R2, typename T, typename Op>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    exclusive_scan(const R1& range1, R2&& range2, const T& init, Op op)
     {
       using std::begin;
       using std::end;
-      std::stable_sort(begin(range), end(range));
+      using V = Value_type<Iterator_of<const R1>>;
+      using S = std::integral_constant<
+        bool, algorithm_impl::Simd_scan<const R1&, R2, Op>()>;
+      auto out = begin(range2);
+      algorithm_impl::scan_from(begin(range1), end(range1), out, op, V(init),
+                                false, S());
+      return std::next(out, std::distance(begin(range1), end(range1)));
     }
 
-  template <typename R, typename C>
-    inline void
-    stable_sort(R&& range, C comp)
+  template<typename R1, typename R2, typename T>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    exclusive_scan(const R1& range1, R2&& range2, const T& init)
     {
-      using std::begin;
-      using std::end;
-      std::stable_sort(begin(range), end(range), comp);
+      return exclusive_scan(range1, std::forward<R2>(range2), init,
+                            std::plus<Value_type<Iterator_of<const R1>>>());
     }
 
-
-  // NOTE: We don't provide a range-based partial_sort for the same reason that
-  // we don't provide a range-based rotate: a middle iterator.
-
-  template <typename R1, typename R2>
-    inline Iterator_of<R2>
-    partial_sort_copy(const R1& range1, R2&& range2)
+  template<typename R1, typename H, typename R2, typename Op>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    segmented_scan(const R1& range1, const H& heads, R2&& range2, Op op)
     {
       using std::begin;
       using std::end;
-      return std::partial_sort_copy(begin(range1), end(range1), 
-                                    begin(range2), end(range2));
+      using V = Value_type<Iterator_of<const R1>>;
+      auto out = begin(range2);
+      bool there = false;
+      algorithm_impl::segmented_scan_from(begin(range1), end(range1),
+                                          begin(heads), out, op, V(), there);
+      return std::next(out, std::distance(begin(range1), end(range1)));
     }
 
-
-  template <typename R1, typename R2, typename C>
-    inline Iterator_of<R2>
-    partial_sort_copy(const R1& range1, R2&& range2, C comp)
+  template<typename R1, typename H, typename R2>
+    inline Requires<Input_range<const R1>(), Iterator_of<R2>>
+    segmented_scan(const R1& range1, const H& heads, R2&& range2)
     {
-      using std::begin;
-      using std::end;
-      return std::partial_sort_copy(begin(range1), end(range1), 
-                                    begin(range2), end(range2),
-                                    comp);
+      return segmented_scan(range1, heads, std::forward<R2>(range2),
+                            std::plus<Value_type<Iterator_of<const R1>>>());
     }
 
-  template <typename R>
-    inline bool
-    is_sorted(const R& range)
+
+  // ------------------------------------------------------------------------ //
+  //                                                               [algo.reduce]
+  //                               Reductions
+  //
+  //    reduce(range, init[, op])
+  //    transform_reduce(range, init, op, f)
+  //    transform_reduce(range1, range2, init[, op1, op2])
+  //
+  // A reduction combines init and the elements of a range under an
+  // associative and commutative operation op (by default, std::plus), in
+  // an unspecified grouping. The transform reductions combine the values
+  // f(x) of the elements x of range, or the values op2(x, y) of the
+  // corresponding elements x and y of range1 and range2 (by default, their
+  // products), so that the inner product of two vectors is:
+  //
+  //    double dot = transform_reduce(a, b, 0.0);
+  //
+  // The result has the type T of init. When op is std::plus<T> and T is an
+  // arithmetic type, the values are added into four partial sums, the jth
+  // of which adds every fourth value starting from the jth; the partial sums
+  // are then added in pairs, and the remaining values added in order. The
+  // independent additions can be overlapped by the processor, and the sums
+  // of contiguous ranges of floats, doubles, and 4- and 8-byte integers are
+  // computed in vector registers (see [algo.simd]). The grouping, and so the
+  // rounding of floating point sums, is the same with and without vector
+  // instructions.
+
+
+  namespace algorithm_impl
+  {
+    // The partial sums of lane reductions are used when op is std::plus<T>
+    // for an arithmetic type T.
+    template<typename T, typename Op>
+      constexpr bool
+      Lane_reduce()
+      {
+        return Arithmetic<T>() && !Same<T, bool>()
+            && Same<Op, std::plus<T>>();
+      }
+
+    // A lane reduction of the contiguous range R uses vector instructions.
+    template<typename R, typename T, typename Op>
+      constexpr bool
+      Simd_reduce()
+      {
+        return Lane_reduce<T, Op>() && Contiguous_range<R>()
+            && Same<Value_type<Iterator_of<R>>, T>() && Simd_summable<T>();
+      }
+
+    // Returns the combination of n > 0 values, each returned by a call to
+    // next(), folded in order.
+    template<typename T, typename Op, typename G>
+      T
+      reduce_values(std::size_t n, Op op, G next, std::false_type)
+      {
+        T x = next();
+        while (--n != 0)
+          x = op(x, next());
+        return x;
+      }
+
+    // Returns the sum of n > 0 values, each returned by a call to next(),
+    // using four partial sums.
+    template<typename T, typename Op, typename G>
+      T
+      reduce_values(std::size_t n, Op, G next, std::true_type)
+      {
+        T a[4] = {T(0), T(0), T(0), T(0)};
+        for (; n >= 4; n -= 4)
+          for (std::size_t j = 0; j != 4; ++j)
+            a[j] = T(a[j] + next());
+        T x = T(T(a[0] + a[1]) + T(a[2] + a[3]));
+        for (; n != 0; --n)
+          x = T(x + next());
+        return x;
+      }
+
+    // Returns the combination of the n > 0 elements of the range beginning
+    // at first.
+    template<typename T, typename I, typename Op, typename Lanes>
+      inline T
+      reduce_block(I first, std::size_t n, Op op, Lanes lanes, std::false_type)
+      {
+        return reduce_values<T>(n, op, [&first]() { return *first++; }, lanes);
+      }
+
+#if defined(__SSE2__)
+    // The partial sums of contiguous elements are computed in vector
+    // registers, in the same order as by reduce_values.
+    template<typename T, typename I, typename Op>
+      inline T
+      reduce_block(I first, std::size_t n, Op, std::true_type,
+                   std::true_type)
+      {
+        const T* p = std::addressof(*first);
+        T a[4];
+        simd_lane_sums(p, n / 4, a);
+        T x = T(T(a[0] + a[1]) + T(a[2] + a[3]));
+        for (p += n / 4 * 4; n % 4 != 0; --n)
+          x = T(x + *p++);
+        return x;
+      }
+#endif
+
+    template<typename T, typename I, typename Op, typename Lanes,
+             typename Simd>
+      inline T
+      reduce(I first, I last, T init, Op op, Lanes lanes, Simd simd)
+      {
+        std::size_t n = std::distance(first, last);
+        if (n == 0)
+          return init;
+        return op(init, reduce_block<T>(first, n, op, lanes, simd));
+      }
+  } // namespace algorithm_impl
+
+
+  template<typename R, typename T, typename Op>
+    inline Requires<Forward_range<const R>(), T>
+    reduce(const R& range, T init, Op op)
     {
       using std::begin;
       using std::end;
-      return std::is_sorted(begin(range), end(range));
+      using L = std::integral_constant<
+        bool, algorithm_impl::Lane_reduce<T, Op>()>;
+      using S = std::integral_constant<
+        bool, algorithm_impl::Simd_reduce<const R&, T, Op>()>;
+      return algorithm_impl::reduce(begin(range), end(range), init, op,
+                                    L(), S());
     }
 
-  template <typename R, typename C>
-    inline bool
-    is_sorted(const R& range, C comp)
+  template<typename R, typename T>
+    inline Requires<Forward_range<const R>(), T>
+    reduce(const R& range, T init)
     {
-      using std::begin;
-      using std::end;
-      return std::is_sorted(begin(range), end(range), comp);
+      return reduce(range, init, std::plus<T>());
     }
 
-  template <typename R>
-    inline Iterator_of<R>
-    is_sorted_until(R&& range)
+  template<typename R, typename T, typename Op, typename F>
+    inline Requires<Forward_range<const R>(), T>
+    transform_reduce(const R& range, T init, Op op, F f)
     {
       using std::begin;
       using std::end;
-      return std::is_sorted_until(begin(range), end(range));
+      using L = std::integral_constant<
+        bool, algorithm_impl::Lane_reduce<T, Op>()>;
+      auto i = begin(range);
+      std::size_t n = std::distance(i, end(range));
+      if (n == 0)
+        return init;
+      return op(init, algorithm_impl::reduce_values<T>(
+        n, op, [&]() { return f(*i++); }, L()));
     }
 
-  template <typename R, typename C>
-    inline Iterator_of<R>
-    is_sorted_until(R&& range, C comp)
+  template<typename R1, typename R2, typename T, typename Op1, typename Op2>
+    inline Requires<Forward_range<const R1>(), T>
+    transform_reduce(const R1& range1, const R2& range2, T init, Op1 op1,
+                     Op2 op2)
     {
       using std::begin;
       using std::end;
-      return std::is_sorted_until(begin(range), end(range), comp);
+      using L = std::integral_constant<
+        bool, algorithm_impl::Lane_reduce<T, Op1>()>;
+      auto i = begin(range1);
+      auto j = begin(range2);
+      std::size_t n = std::distance(i, end(range1));
+      if (n == 0)
+        return init;
+      return op1(init, algorithm_impl::reduce_values<T>(
+        n, op1, [&]() { return op2(*i++, *j++); }, L()));
     }
 
+  template<typename R1, typename R2, typename T>
+    inline Requires<Forward_range<const R1>(), T>
+    transform_reduce(const R1& range1, const R2& range2, T init)
+    {
+      return transform_reduce(range1, range2, init, std::plus<T>(),
+                              std::multiplies<T>());
+    }
 
 
-  //////////////////////////////////////////////////////////////////////////////
-  // Binary Search
+  // ------------------------------------------------------------------------ //
+  //                                                                [algo.radix]
+  //                               Radix Sort
+  //
+  //    radix_sort(range)
+  //    radix_sort(range, key)
+  //
+  // Sort the elements of a random access range by their radix keys: the
+  // elements themselves, or the values of key(x). A radix key is an integer,
+  // float or double. Keys are ordered as if by operator<, except that
+  // negative zero is ordered before positive zero, and NaNs are ordered
+  // before or after all other keys, depending on their sign. The sort is
+  // stable, so that, for example, pairs can be sorted by their first
+  // elements without reordering equal keys.
+  //
+  // The sort is a least significant digit radix sort on the bytes of the
+  // keys. The occurrences of each byte value are counted in a single pass,
+  // and the range is then sorted by each byte on which the keys differ,
+  // moving the elements between the range and a buffer of (default
+  // constructed) values. Sorting keys of b bytes takes at most b + 1 passes
+  // over the range, and usually fewer: the bytes that are the same in all
+  // keys, such as the high bytes of small integers, are skipped.
+  //
+  // The sort algorithms use radix_sort when the value type of a range is a
+  // radix key, the elements are ordered by operator< or std::less, and the
+  // range is not small. A range that begins with a sorted run of at least
+  // half of its elements is instead merged (see [algo.pdqsort]). The
+  // stable_sort algorithms use radix_sort for integer values, whose equal
+  // values are indistinguishable.
+
+
+  namespace algorithm_impl
+  {
+    // The default ordering of the sorting and set algorithms.
+    struct less_than
+    {
+      template<typename T, typename U>
+        bool operator()(const T& a, const U& b) const { return a < b; }
+    };
 
-  template <typename R, typename T>
-    inline Iterator_of<R>
-    lower_bound(R&& range, const T& value)
+    // A key function returning its argument.
+    struct radix_identity
     {
-      using std::begin;
-      using std::end;
-      return std::lower_bound(begin(range), end(range), value);
+      template<typename T>
+        const T& operator()(const T& x) const { return x; }
+    };
+
+    // Returns true if T is a radix key.
+    template<typename T>
+      constexpr bool Radix_key()
+      {
+        return Integer<T>() || Same<T, float>() || Same<T, double>();
+      }
+
+    // Returns an unsigned integer whose order is that of the key x.
+    template<typename T>
+      inline Requires<Unsigned<T>(), T>
+      radix_bits(T x) { return x; }
+
+    template<typename T>
+      inline Requires<Integer<T>() && Signed<T>(), Make_unsigned<T>>
+      radix_bits(T x)
+      {
+        using U = Make_unsigned<T>;
+        return U(x) ^ U(U(1) << (8 * sizeof(U) - 1));
+      }
+
+    // The bits of a negative float are inverted, so that larger magnitudes
+    // are ordered first, and the sign bit of a positive float is set.
+    inline std::uint32_t
+    radix_bits(float x)
+    {
+      static_assert(sizeof(float) == 4, "unsupported float");
+      std::uint32_t u;
+      std::memcpy(&u, &x, sizeof(u));
+      return u & 0x80000000u ? ~u : u | 0x80000000u;
     }
 
-  template <typename R, typename T, typename C>
-    inline Iterator_of<R>
-    lower_bound(R&& range, const T& value, C comp)
+    inline std::uint64_t
+    radix_bits(double x)
     {
-      using std::begin;
-      using std::end;
-      return std::lower_bound(begin(range), end(range), value, comp);
+      static_assert(sizeof(double) == 8, "unsupported double");
+      std::uint64_t u;
+      std::memcpy(&u, &x, sizeof(u));
+      return u & 0x8000000000000000ull ? ~u : u | 0x8000000000000000ull;
     }
 
-  template <typename R, typename T>
-    inline Iterator_of<R>
-    upper_bound(R&& range, const T& value)
+    // The number of values of a digit, one byte of a key.
+    constexpr std::size_t radix = 256;
+
+    // The smallest range that is sorted by radix sort when a sort algorithm
+    // chooses between radix and comparison sorts.
+    constexpr std::size_t radix_threshold = 1 << 11;
+
+    // Returns the digit d of the bits u of a key.
+    template<typename U>
+      inline std::size_t
+      radix_digit(U u, std::size_t d)
+      {
+        return std::size_t(u >> (8 * d)) & (radix - 1);
+      }
+
+    // Add the occurrences of each value of each digit of the keys of
+    // [first, last) to counts, which holds radix counts for each digit.
+    template<typename I, typename K>
+      void
+      radix_count(I first, I last, K key, std::size_t* counts)
+      {
+        using U = decltype(radix_bits(key(*first)));
+        for (; first != last; ++first) {
+          U u = radix_bits(key(*first));
+          for (std::size_t d = 0; d != sizeof(U); ++d)
+            ++counts[d * radix + radix_digit(u, d)];
+        }
+      }
+
+    // Add the occurrences of each value of the digit d of the keys of
+    // [first, last) to counts.
+    template<typename I, typename K>
+      void
+      radix_count_digit(I first, I last, K key, std::size_t d,
+                        std::size_t* counts)
+      {
+        for (; first != last; ++first)
+          ++counts[radix_digit(radix_bits(key(*first)), d)];
+      }
+
+    // Returns true if the digit counted by counts is the same in all n keys.
+    inline bool
+    radix_trivial(const std::size_t* counts, std::size_t n)
     {
-      using std::begin;
-      using std::end;
-      return std::upper_bound(begin(range), end(range), value);
+      return std::find(counts, counts + radix, n) != counts + radix;
     }
 
-  template <typename R, typename T, typename C>
-    inline Iterator_of<R>
-    upper_bound(R&& range, const T& value, C comp)
+    // Move the elements of [first, last) to out, where offsets holds the
+    // position of the next element having each value of the digit d.
+    template<typename I, typename O, typename K>
+      void
+      radix_scatter(I first, I last, O out, K key, std::size_t d,
+                    std::size_t* offsets)
+      {
+        for (; first != last; ++first) {
+          std::size_t x = radix_digit(radix_bits(key(*first)), d);
+          out[offsets[x]++] = std::move(*first);
+        }
+      }
+
+    // Sort [first, last) by the keys key(x).
+    template<typename I, typename K>
+      void
+      lsd_radix_sort(I first, I last, K key)
+      {
+        using T = Value_type<I>;
+        using U = decltype(radix_bits(key(*first)));
+        std::size_t n = last - first;
+        if (n < 2)
+          return;
+
+        std::size_t counts[sizeof(U) * radix] = { };
+        radix_count(first, last, key, counts);
+        std::unique_ptr<T[]> buf;
+        bool in_buf = false;
+        for (std::size_t d = 0; d != sizeof(U); ++d) {
+          std::size_t* c = counts + d * radix;
+          if (radix_trivial(c, n))
+            continue;
+          if (!buf)
+            buf.reset(new T[n]);
+
+          // Convert the counts to the offsets of each digit value.
+          std::size_t sum = 0;
+          for (std::size_t x = 0; x != radix; ++x) {
+            std::size_t m = c[x];
+            c[x] = sum;
+            sum += m;
+          }
+          T* p = buf.get();
+          if (in_buf)
+            radix_scatter(p, p + n, first, key, d, c);
+          else
+            radix_scatter(first, last, p, key, d, c);
+          in_buf = !in_buf;
+        }
+        if (in_buf)
+          std::move(buf.get(), buf.get() + n, first);
+      }
+
+    // The comparison C is the default ordering of values of type T if it
+    // is less_than or std::less<T>.
+    template<typename C, typename T>
+      struct default_order : std::false_type { };
+
+    template<typename T>
+      struct default_order<std::less<T>, T> : std::true_type { };
+
+    template<typename T>
+      struct default_order<less_than, T> : std::true_type { };
+
+    // The comparison C orders values of type T by radix sort if it is the
+    // default ordering of T and T is a radix key.
+    template<typename C, typename T>
+      using radix_order
+        = std::integral_constant<bool, default_order<C, T>::value
+                                       && Radix_key<T>()>;
+
+    // Sort [first, last) by pattern-defeating quicksort (see
+    // [algo.pdqsort]), or by radix sort if the order is a radix order and
+    // the range is neither small nor mostly a sorted run.
+    template<typename I, typename C>
+      inline void
+      sort_dispatch(I first, I last, C comp, std::false_type)
+      {
+        comparison_sort(first, last, comp);
+      }
+
+    template<typename I, typename C>
+      inline void
+      sort_dispatch(I first, I last, C comp, std::true_type)
+      {
+        std::size_t n = last - first;
+        if (n < radix_threshold) {
+          comparison_sort(first, last, comp);
+          return;
+        }
+        using T = Value_type<I>;
+        I run = pdq_run(first, last, comp);
+        if (std::size_t(run - first) >= n / 2)
+          pdq_sort<Branchless_sortable<T>::value>(first, run, last, comp);
+        else
+          lsd_radix_sort(first, last, radix_identity());
+      }
+
+    template<typename I, typename C>
+      inline void
+      stable_sort_dispatch(I first, I last, C comp, std::false_type)
+      {
+        std::stable_sort(first, last, comp);
+      }
+
+    template<typename I, typename C>
+      inline void
+      stable_sort_dispatch(I first, I last, C comp, std::true_type)
+      {
+        if (std::size_t(last - first) < radix_threshold)
+          std::stable_sort(first, last, comp);
+        else
+          lsd_radix_sort(first, last, radix_identity());
+      }
+
+    template<typename I, typename C>
+      using Radix_sortable = radix_order<C, Value_type<I>>;
+
+    template<typename I, typename C>
+      using Radix_stable_sortable
+        = std::integral_constant<bool, radix_order<C, Value_type<I>>::value
+                                       && Integer<Value_type<I>>()>;
+
+  } // namespace algorithm_impl
+
+
+  template<typename R>
+    inline void
+    radix_sort(R&& range)
     {
+      static_assert(Random_access_range<R>(), "");
+      static_assert(algorithm_impl::Radix_key<Value_type<Iterator_of<R>>>(),
+                    "the values of the range are not radix keys");
       using std::begin;
       using std::end;
-      return std::upper_bound(begin(range), end(range), value, comp);
+      algorithm_impl::lsd_radix_sort(begin(range), end(range),
+                                     algorithm_impl::radix_identity());
     }
 
-  template <typename R, typename T>
-    inline std::pair<Iterator_of<R>, Iterator_of<R>>
-    equal_range(R&& range, const T& value)
+  template<typename R, typename K>
+    inline void
+    radix_sort(R&& range, K key)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::equal_range(begin(range), end(range), value);
+      using Key = Decay<decltype(key(*begin(range)))>;
+      static_assert(algorithm_impl::Radix_key<Key>(),
+                    "the key function does not return radix keys");
+      algorithm_impl::lsd_radix_sort(begin(range), end(range), key);
     }
 
-  template <typename R, typename T, typename C>
-    inline std::pair<Iterator_of<R>, Iterator_of<R>>
-    equal_range(R&& range, const T& value, C comp)
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Sorting
+  //
+  //////////////////////////////////////////////////////////////////////////////
+
+
+  template <typename R>
+    inline void
+    sort(R&& range)
     {
       using std::begin;
       using std::end;
-      return std::equal_range(begin(range), end(range), value, comp);
+      using I = Iterator_of<R>;
+      using C = algorithm_impl::less_than;
+      algorithm_impl::sort_dispatch(begin(range), end(range), C(),
+                                    algorithm_impl::Radix_sortable<I, C>());
     }
 
-  template <typename R, typename T>
-    inline bool
-    binary_search(const R& range, const T& value)
+  // NOTE: This avoids overlaod collision because the argument types are
+  // different (std::sort takes two iterators). If we relax the requirement
+  // that iterators must the same, then this won't work without a lot of
+  // enable-if'ing.
+  template <typename R, typename C>
+    inline void
+    sort(R&& range, C comp)
     {
       using std::begin;
       using std::end;
-      return std::binary_search(begin(range), end(range), value);
+      using I = Iterator_of<R>;
+      algorithm_impl::sort_dispatch(begin(range), end(range), comp,
+                                    algorithm_impl::Radix_sortable<I, C>());
     }
 
-  template <typename R, typename T, typename C>
-    inline bool
-    binary_search(const R& range, const T& value, C comp)
+  template <typename R>
+    inline void 
+    stable_sort(R&& range)
     {
       using std::begin;
       using std::end;
-      return std::binary_search(begin(range), end(range), value, comp);
+      using I = Iterator_of<R>;
+      using C = algorithm_impl::less_than;
+      algorithm_impl::stable_sort_dispatch(
+        begin(range), end(range), C(),
+        algorithm_impl::Radix_stable_sortable<I, C>());
     }
 
+  template <typename R, typename C>
+    inline void
+    stable_sort(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      algorithm_impl::stable_sort_dispatch(
+        begin(range), end(range), comp,
+        algorithm_impl::Radix_stable_sortable<I, C>());
+    }
 
+  // ------------------------------------------------------------------------ //
+  //                                                               [algo.sort_n]
+  //                           Fixed-Size Sorting
+  //
+  //    sort_n<N>(first[, comp])
+  //    sort_n(array[, comp])
+  //
+  // Sort the N elements starting at the random access iterator first, or
+  // the elements of a built-in array or std::array of N elements, by the
+  // sorting network for N elements (see [algo.network]). The sequence of
+  // compare-exchanges is generated at compile time, and those of arithmetic
+  // values and pointers are branchless, which makes these the fastest way
+  // to sort small keys, such as windows of neighbors, whose size is known.
+  // The sort is not stable. Large networks take long to compile; N should
+  // be at most a few dozen.
+  template<std::size_t N, typename I, typename C>
+    inline void
+    sort_n(I first, C comp)
+    {
+      static_assert(Random_access_iterator<I>(), "");
+      using B = algorithm_impl::Branchless_sortable<Value_type<I>>;
+      algorithm_impl::sorting_network<N>::apply(first, comp, B());
+    }
 
-  //////////////////////////////////////////////////////////////////////////////
-  // Merge
+  template<std::size_t N, typename I>
+    inline void
+    sort_n(I first)
+    {
+      sort_n<N>(first, algorithm_impl::less_than());
+    }
 
-  template <typename R1, typename R2, typename R3>
-    inline Iterator_of<R3>
-    merge(const R1& range1, const R2& range2, R3&& range3)
+  template<typename T, std::size_t N, typename C>
+    inline void
+    sort_n(T (&array)[N], C comp)
+    {
+      sort_n<N>(&array[0], comp);
+    }
+
+  template<typename T, std::size_t N>
+    inline void
+    sort_n(T (&array)[N])
+    {
+      sort_n<N>(&array[0]);
+    }
+
+  template<typename T, std::size_t N, typename C>
+    inline void
+    sort_n(std::array<T, N>& array, C comp)
+    {
+      sort_n<N>(array.begin(), comp);
+    }
+
+  template<typename T, std::size_t N>
+    inline void
+    sort_n(std::array<T, N>& array)
+    {
+      sort_n<N>(array.begin());
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [algo.sort_by_key]
+  //                            Key-Value Sorting
+  //
+  //    sort_by_key(keys, values[, comp])
+  //
+  // Sort the random access range keys, and permute the random access range
+  // values in lockstep, so that each value stays with the key at the same
+  // position. The values range must have at least as many elements as the
+  // keys. The sort is stable. No range of pairs is built: the sort is a
+  // merge sort that moves each key and its value together, insertion
+  // sorting short runs of both ranges and then merging runs of doubling
+  // length between the ranges and buffers of (default constructed) keys
+  // and values. A zip range of several arrays is sorted in the same way by
+  // sorting a range of their positions (see iota) as the values, and
+  // gathering each array through it.
+  //
+  // The parallel sort_by_key (see [algo.par]) sorts blocks of the ranges in
+  // parallel, and merges them as the parallel stable_sort does.
+
+  namespace algorithm_impl
+  {
+    // The length of the runs insertion sorted by sort_by_key.
+    constexpr std::size_t key_run = 32;
+
+    // Insertion sort [first, last), moving the values at vals in lockstep.
+    template<typename K, typename V, typename C>
+      void
+      key_insertion_sort(K first, K last, V vals, C comp)
+      {
+        if (first == last)
+          return;
+        V vi = vals;
+        for (K i = std::next(first); i != last; ++i) {
+          ++vi;
+          if (!comp(*i, *std::prev(i)))
+            continue;
+          Value_type<K> k = std::move(*i);
+          Value_type<V> v = std::move(*vi);
+          K j = i;
+          V vj = vi;
+          do {
+            *j = std::move(*std::prev(j));
+            *vj = std::move(*std::prev(vj));
+            --j;
+            --vj;
+          } while (j != first && comp(k, *std::prev(j)));
+          *j = std::move(k);
+          *vj = std::move(v);
+        }
+      }
+
+    // Merge the keys [f1, l1) and [f2, l2) and their values at v1 and v2,
+    // moving them to ko and vo. The merge is stable.
+    template<typename K1, typename V1, typename K2, typename V2, typename C>
+      void
+      key_merge(K1 f1, K1 l1, V1 v1, K1 f2, K1 l2, V1 v2, K2 ko, V2 vo,
+                C comp)
+      {
+        for (; f1 != l1 && f2 != l2; ++ko, ++vo) {
+          if (comp(*f2, *f1)) {
+            *ko = std::move(*f2++);
+            *vo = std::move(*v2++);
+          } else {
+            *ko = std::move(*f1++);
+            *vo = std::move(*v1++);
+          }
+        }
+        vo = std::move(v1, std::next(v1, l1 - f1), vo);
+        std::move(v2, std::next(v2, l2 - f2), vo);
+        ko = std::move(f1, l1, ko);
+        std::move(f2, l2, ko);
+      }
+
+    // Sort the n keys at first and their values at vals, using the buffers
+    // kb and vb of n keys and values.
+    template<typename K, typename V, typename C>
+      void
+      key_sort(K first, V vals, std::size_t n,
+               Value_type<K>* kb, Value_type<V>* vb, C comp)
+      {
+        for (std::size_t lo = 0; lo < n; lo += key_run) {
+          std::size_t hi = std::min(n, lo + key_run);
+          key_insertion_sort(std::next(first, lo), std::next(first, hi),
+                             std::next(vals, lo), comp);
+        }
+        bool in_buf = false;
+        for (std::size_t w = key_run; w < n; w *= 2) {
+          for (std::size_t lo = 0; lo < n; lo += 2 * w) {
+            std::size_t mid = std::min(n, lo + w);
+            std::size_t hi = std::min(n, lo + 2 * w);
+            if (in_buf)
+              key_merge(kb + lo, kb + mid, vb + lo, kb + mid, kb + hi,
+                        vb + mid, std::next(first, lo), std::next(vals, lo),
+                        comp);
+            else
+              key_merge(std::next(first, lo), std::next(first, mid),
+                        std::next(vals, lo), std::next(first, mid),
+                        std::next(first, hi), std::next(vals, mid),
+                        kb + lo, vb + lo, comp);
+          }
+          in_buf = !in_buf;
+        }
+        if (in_buf) {
+          std::move(kb, kb + n, first);
+          std::move(vb, vb + n, vals);
+        }
+      }
+
+    template<typename K, typename V, typename C>
+      void
+      sort_by_key(K first, K last, V vals, C comp)
+      {
+        std::size_t n = last - first;
+        if (n <= key_run) {
+          key_insertion_sort(first, last, vals, comp);
+          return;
+        }
+        std::unique_ptr<Value_type<K>[]> kb(new Value_type<K>[n]);
+        std::unique_ptr<Value_type<V>[]> vb(new Value_type<V>[n]);
+        key_sort(first, vals, n, kb.get(), vb.get(), comp);
+      }
+
+  } // namespace algorithm_impl
+
+
+  template<typename R1, typename R2, typename C>
+    inline void
+    sort_by_key(R1&& keys, R2&& values, C comp)
     {
+      static_assert(Random_access_range<R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
       using std::begin;
       using std::end;
-      return std::merge(begin(range1), end(range1),
-                        begin(range2), end(range2),
-                        begin(range3));
+      algorithm_impl::sort_by_key(begin(keys), end(keys), begin(values),
+                                  comp);
     }
 
-  template <typename R1, typename R2, typename R3, typename C>
-    inline Iterator_of<R3>
-    merge(const R1& range1, const R2& range2, R3&& range3, C comp)
+  template<typename R1, typename R2>
+    inline void
+    sort_by_key(R1&& keys, R2&& values)
+    {
+      sort_by_key(std::forward<R1>(keys), std::forward<R2>(values),
+                  algorithm_impl::less_than());
+    }
+
+
+
+  // The partial_sort and nth_element algorithms take a middle iterator into
+  // the range, following the range.
+  template <typename R, typename C>
+    inline void
+    partial_sort(R&& range, Iterator_of<R> middle, C comp)
     {
       using std::begin;
       using std::end;
-      return std::merge(begin(range1), end(range1),
-                        begin(range2), end(range2),
-                        begin(range3),
-                        comp);
+      std::partial_sort(begin(range), middle, end(range), comp);
+    }
+
+  template <typename R>
+    inline void
+    partial_sort(R&& range, Iterator_of<R> middle)
+    {
+      using std::begin;
+      using std::end;
+      std::partial_sort(begin(range), middle, end(range));
     }
 
+  template <typename R, typename C>
+    inline void
+    nth_element(R&& range, Iterator_of<R> nth, C comp)
+    {
+      using std::begin;
+      using std::end;
+      std::nth_element(begin(range), nth, end(range), comp);
+    }
 
-  //////////////////////////////////////////////////////////////////////////////
-  // Set Operations
+  template <typename R>
+    inline void
+    nth_element(R&& range, Iterator_of<R> nth)
+    {
+      using std::begin;
+      using std::end;
+      std::nth_element(begin(range), nth, end(range));
+    }
 
   template <typename R1, typename R2>
-    inline bool
-    includes(const R1& range1, const R2& range2)
+    inline Iterator_of<R2>
+    partial_sort_copy(const R1& range1, R2&& range2)
     {
       using std::begin;
       using std::end;
-      return std::includes(begin(range1), end(range1), 
-                           begin(range2), end(range2));
+      return std::partial_sort_copy(begin(range1), end(range1), 
+                                    begin(range2), end(range2));
     }
 
+
   template <typename R1, typename R2, typename C>
+    inline Iterator_of<R2>
+    partial_sort_copy(const R1& range1, R2&& range2, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::partial_sort_copy(begin(range1), end(range1), 
+                                    begin(range2), end(range2),
+                                    comp);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                [algo.top_k]
+  //                             Top-k Selection
+  //
+  //    top_k(range, k[, comp])
+  //
+  // Returns a vector of the first k elements of the range in the order comp,
+  // sorted, or of all of its elements if it has fewer than k. The range is
+  // traversed once, and may be an input range. For example,
+  // top_k(scores, 1000, std::greater<double>()) returns the 1000 highest
+  // scores, highest first. Equal elements are not selected in any
+  // particular order.
+  //
+  // The selected elements are kept in a heap of at most k elements, whose
+  // front is the last of them in the order comp. An element that precedes
+  // the front replaces it, and any other element is rejected by a single
+  // comparison. When the range is contiguous, its values are 4-byte
+  // integers, floats or doubles, and comp is less or greater (less_than,
+  // std::less or std::greater), the elements are compared with the front a
+  // register at a time (see [algo.simd]), so only those that enter the heap
+  // are compared one at a time. Of n values in random order, about
+  // k log(n / k) enter the heap.
+  //
+  // The parallel top_k (see [algo.par]) selects the first k elements of
+  // each task's blocks into a heap of its own, and then the first k
+  // elements of those heaps.
+
+  namespace algorithm_impl
+  {
+    // The comparison C is the reverse of the default ordering of values of
+    // type T if it is std::greater<T>.
+    template<typename C, typename T>
+      struct reverse_order : std::false_type { };
+
+    template<typename T>
+      struct reverse_order<std::greater<T>, T> : std::true_type { };
+
+    // The first k values of a sequence in the order comp, in a heap whose
+    // front is the last of them.
+    template<typename T, typename C>
+      class top_k_heap
+      {
+      public:
+        top_k_heap(std::size_t k, C comp)
+          : k_(k), comp_(comp)
+        { }
+
+        bool full() const { return h_.size() == k_; }
+
+        // Returns the last selected value. The heap must not be empty.
+        const T& bound() const { return h_.front(); }
+
+        // Select x if it is among the first k values seen.
+        void push(const T& x)
+        {
+          if (h_.size() < k_) {
+            h_.push_back(x);
+            std::push_heap(h_.begin(), h_.end(), comp_);
+          } else if (k_ != 0 && comp_(x, h_.front())) {
+            replace_front(x);
+          }
+        }
+
+        // Returns the selected values, in no particular order.
+        std::vector<T>& values() { return h_; }
+
+        // Returns the selected values in the order comp.
+        std::vector<T> sorted()
+        {
+          std::sort_heap(h_.begin(), h_.end(), comp_);
+          return std::move(h_);
+        }
+
+      private:
+        // Replace the front of the full heap by x, which precedes it, and
+        // sift x down.
+        void replace_front(const T& x)
+        {
+          std::size_t n = h_.size();
+          std::size_t i = 0;
+          for (std::size_t c = 1; c < n; c = 2 * i + 1) {
+            if (c + 1 < n && comp_(h_[c], h_[c + 1]))
+              ++c;
+            if (!comp_(x, h_[c]))
+              break;
+            h_[i] = std::move(h_[c]);
+            i = c;
+          }
+          h_[i] = x;
+        }
+
+        std::size_t k_;
+        C comp_;
+        std::vector<T> h_;
+      };
+
+    // Select the first values of [first, last) into h.
+    template<typename I, typename T, typename C>
+      inline void
+      top_k_scan(I first, I last, top_k_heap<T, C>& h, std::false_type)
+      {
+        for (; first != last; ++first)
+          h.push(*first);
+      }
+
+#if defined(__SSE2__)
+    // Once the heap is full, the contiguous values are skipped up to the
+    // next one that precedes its front. The heap must not select zero
+    // values.
+    template<typename I, typename T, typename C>
+      void
+      top_k_scan(I first, I last, top_k_heap<T, C>& h, std::true_type)
+      {
+        if (first == last)
+          return;
+        const T* p = std::addressof(*first);
+        const T* l = p + (last - first);
+        for (; p != l && !h.full(); ++p)
+          h.push(*p);
+        while (p != l) {
+          p = simd_find_before<reverse_order<C, T>::value>(p, l, h.bound());
+          if (p == l)
+            break;
+          h.push(*p++);
+        }
+      }
+#endif
+
+    // Selecting the first values of [first, last) by C uses vector
+    // instructions if I is a pointer to a type orderable in vector
+    // registers, and C is its default or reverse order.
+    template<typename I, typename C, typename T = Value_type<I>>
+      using Simd_iterator_select
+        = std::integral_constant<bool, Pointer<I>() && Simd_orderable<T>()
+                                       && (default_order<C, T>::value
+                                           || reverse_order<C, T>::value)>;
+
+    template<typename R, typename C, typename T = Value_type<Iterator_of<R>>>
+      using Simd_range_select
+        = std::integral_constant<bool, Contiguous_range<R>()
+                                       && Simd_orderable<T>()
+                                       && (default_order<C, T>::value
+                                           || reverse_order<C, T>::value)>;
+
+  } // namespace algorithm_impl
+
+
+  template<typename R, typename C>
+    std::vector<Value_type<Iterator_of<R>>>
+    top_k(R&& range, std::size_t k, C comp)
+    {
+      static_assert(Input_range<R>(), "");
+      using std::begin;
+      using std::end;
+      using T = Value_type<Iterator_of<R>>;
+      algorithm_impl::top_k_heap<T, C> h(k, comp);
+      if (k != 0)
+        algorithm_impl::top_k_scan(
+          begin(range), end(range), h,
+          algorithm_impl::Simd_range_select<R, C>());
+      return h.sorted();
+    }
+
+  template<typename R>
+    inline std::vector<Value_type<Iterator_of<R>>>
+    top_k(R&& range, std::size_t k)
+    {
+      return top_k(std::forward<R>(range), k, algorithm_impl::less_than());
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                            [algo.histogram]
+  //                        Histograms and Counting Sorts
+  //
+  //    histogram(range, bins[, key])
+  //    counting_sort(range, bins[, key])
+  //    bucket_sort(range, bins, key[, comp])
+  //
+  // The histogram algorithm returns a vector of bins counts, in which the
+  // count of bin b is the number of elements x of the range for which
+  // key(x) is b. By default, the key of an integer is its value. The keys
+  // must be less than bins. The range may be an input range. For example,
+  // the out degrees of the vertices of a graph are the histogram of the
+  // sources of its edges:
+  //
+  //    auto src = [](const edge& e) { return e.source; };
+  //    vector<size_t> degree = histogram(edges, n, src);
+  //
+  // The counting sort algorithm stably sorts a random access range by the
+  // keys of its elements, and returns the bins + 1 offsets of the bins in
+  // the sorted range: the elements of bin b are at [offset[b],
+  // offset[b + 1]). Sorting the edges of a graph by their sources gives
+  // the offsets of their out edge lists. The histogram of the keys is
+  // scanned to find the offsets (see [algo.scan]), and the elements are
+  // moved to their offsets in a buffer of (default constructed) values,
+  // and then moved back. The sort takes linear time, and is meant for key
+  // domains that are small compared to the range.
+  //
+  // The bucket sort algorithm sorts the range by counting sort, and then
+  // sorts each bin by comp (by default, operator<; see [algo.pdqsort]). If
+  // comp orders every element of a bin before those of the later bins, the
+  // range is sorted by comp. It returns the offsets of the bins.
+  //
+  // The parallel overloads (see [algo.par]) count the keys of each task's
+  // part of the range in bins of its own, so that no counts are shared, and
+  // then sum the bins of the tasks in parallel. The tasks are limited so
+  // that their bins have about as many counts as the range has elements.
+  // The counting sort scans the counts of each task's bins, so that each
+  // task moves its part of the range to the offsets of its elements, and
+  // the parallel bucket sort sorts the bins in parallel.
+
+  namespace algorithm_impl
+  {
+    // Count the keys of [first, last) in the bins at c.
+    template<typename I, typename K>
+      inline void
+      histogram_count(I first, I last, K key, std::size_t* c)
+      {
+        for (; first != last; ++first)
+          ++c[key(*first)];
+      }
+
+    // Move the elements of [first, last) to out, at the offsets of their
+    // keys in off, advancing the offsets.
+    template<typename I, typename O, typename K>
+      inline void
+      histogram_scatter(I first, I last, O out, K key, std::size_t* off)
+      {
+        for (; first != last; ++first)
+          out[off[key(*first)]++] = std::move(*first);
+      }
+
+    template<typename I, typename K>
+      std::vector<std::size_t>
+      counting_sort(I first, I last, std::size_t bins, K key)
+      {
+        using T = Value_type<I>;
+        std::size_t n = last - first;
+        std::vector<std::size_t> off(bins + 1);
+        histogram_count(first, last, key, off.data() + 1);
+        origin::inclusive_scan(off, off);
+        std::vector<std::size_t> next(off.begin(), off.end() - 1);
+        std::unique_ptr<T[]> buf(new T[n]);
+        histogram_scatter(first, last, buf.get(), key, next.data());
+        std::move(buf.get(), buf.get() + n, first);
+        return off;
+      }
+
+    // Sort each bin of [first, last), whose offsets are off, by comp.
+    template<typename I, typename C>
+      void
+      sort_bins(I first, const std::vector<std::size_t>& off,
+                std::size_t b, std::size_t e, C comp)
+      {
+        for (; b != e; ++b)
+          comparison_sort(first + off[b], first + off[b + 1], comp);
+      }
+
+  } // namespace algorithm_impl
+
+
+  template<typename R, typename K>
+    std::vector<std::size_t>
+    histogram(R&& range, std::size_t bins, K key)
+    {
+      static_assert(Input_range<R>(), "");
+      using std::begin;
+      using std::end;
+      std::vector<std::size_t> c(bins);
+      algorithm_impl::histogram_count(begin(range), end(range), key,
+                                      c.data());
+      return c;
+    }
+
+  template<typename R>
+    inline std::vector<std::size_t>
+    histogram(R&& range, std::size_t bins)
+    {
+      return histogram(std::forward<R>(range), bins,
+                       algorithm_impl::radix_identity());
+    }
+
+  template<typename R, typename K>
+    inline std::vector<std::size_t>
+    counting_sort(R&& range, std::size_t bins, K key)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::counting_sort(begin(range), end(range), bins,
+                                           key);
+    }
+
+  template<typename R>
+    inline std::vector<std::size_t>
+    counting_sort(R&& range, std::size_t bins)
+    {
+      return counting_sort(std::forward<R>(range), bins,
+                           algorithm_impl::radix_identity());
+    }
+
+  template<typename R, typename K, typename C>
+    std::vector<std::size_t>
+    bucket_sort(R&& range, std::size_t bins, K key, C comp)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      auto off = algorithm_impl::counting_sort(begin(range), end(range),
+                                               bins, key);
+      algorithm_impl::sort_bins(begin(range), off, 0, bins, comp);
+      return off;
+    }
+
+  template<typename R, typename K>
+    inline std::vector<std::size_t>
+    bucket_sort(R&& range, std::size_t bins, K key)
+    {
+      return bucket_sort(std::forward<R>(range), bins, key,
+                         algorithm_impl::less_than());
+    }
+
+  template <typename R>
     inline bool
-    includes(const R1& range1, const R2& range2, C comp)
+    is_sorted(const R& range)
     {
       using std::begin;
       using std::end;
-      return std::includes(begin(range1), end(range1), 
-                           begin(range2), end(range2),
-                           comp);
+      return std::is_sorted(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline bool
+    is_sorted(const R& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_sorted(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline Iterator_of<R>
+    is_sorted_until(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_sorted_until(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline Iterator_of<R>
+    is_sorted_until(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_sorted_until(begin(range), end(range), comp);
+    }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Binary Search
+
+  template <typename R, typename T>
+    inline Iterator_of<R>
+    lower_bound(R&& range, const T& value)
+    {
+      using std::begin;
+      using std::end;
+      return std::lower_bound(begin(range), end(range), value);
+    }
+
+  template <typename R, typename T, typename C>
+    inline Iterator_of<R>
+    lower_bound(R&& range, const T& value, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::lower_bound(begin(range), end(range), value, comp);
+    }
+
+  template <typename R, typename T>
+    inline Iterator_of<R>
+    upper_bound(R&& range, const T& value)
+    {
+      using std::begin;
+      using std::end;
+      return std::upper_bound(begin(range), end(range), value);
+    }
+
+  template <typename R, typename T, typename C>
+    inline Iterator_of<R>
+    upper_bound(R&& range, const T& value, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::upper_bound(begin(range), end(range), value, comp);
+    }
+
+  template <typename R, typename T>
+    inline std::pair<Iterator_of<R>, Iterator_of<R>>
+    equal_range(R&& range, const T& value)
+    {
+      using std::begin;
+      using std::end;
+      return std::equal_range(begin(range), end(range), value);
+    }
+
+  template <typename R, typename T, typename C>
+    inline std::pair<Iterator_of<R>, Iterator_of<R>>
+    equal_range(R&& range, const T& value, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::equal_range(begin(range), end(range), value, comp);
+    }
+
+  template <typename R, typename T>
+    inline bool
+    binary_search(const R& range, const T& value)
+    {
+      using std::begin;
+      using std::end;
+      return std::binary_search(begin(range), end(range), value);
+    }
+
+  template <typename R, typename T, typename C>
+    inline bool
+    binary_search(const R& range, const T& value, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::binary_search(begin(range), end(range), value, comp);
+    }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Merge
+
+  template <typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    merge(const R1& range1, const R2& range2, R3&& range3)
+    {
+      using std::begin;
+      using std::end;
+      return std::merge(begin(range1), end(range1),
+                        begin(range2), end(range2),
+                        begin(range3));
+    }
+
+  template <typename R1, typename R2, typename R3, typename C>
+    inline Requires<Input_range<R1>(), Iterator_of<R3>>
+    merge(const R1& range1, const R2& range2, R3&& range3, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::merge(begin(range1), end(range1),
+                        begin(range2), end(range2),
+                        begin(range3),
+                        comp);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                               [algo.kmerge]
+  //                               K-way Merge
+  //
+  //    k_way_merge(runs, range)
+  //    k_way_merge(runs, range, comp)
+  //
+  // Merge the sorted ranges in runs, a range of ranges, into range, and
+  // return the end of the merged elements. The merge is stable: equal
+  // elements are copied in the order of their runs. The runs may be input
+  // ranges, and need not have the same size.
+  //
+  // The merge selects each element with a loser tree: a tournament tree
+  // whose leaves are the runs, and whose internal nodes each hold the run
+  // that lost the match at that node. The winner is output, and the next
+  // element of its run replays the matches on the path to the root, so each
+  // element is selected with about log k comparisons, for k runs. Exhausted
+  // runs lose every match.
+
+  namespace algorithm_impl
+  {
+    template<typename I, typename O, typename C>
+      O
+      loser_tree_merge(std::vector<I>& first, const std::vector<I>& last,
+                       O out, C comp)
+      {
+        std::size_t k = first.size();
+        if (k == 0)
+          return out;
+
+        // Returns true if the run a precedes the run b: it is not
+        // exhausted and its element is less than that of b, or equal to it
+        // and a is before b.
+        auto beats = [&](std::size_t a, std::size_t b) {
+          if (first[a] == last[a])
+            return false;
+          if (first[b] == last[b])
+            return true;
+          if (comp(*first[a], *first[b]))
+            return true;
+          return !comp(*first[b], *first[a]) && a < b;
+        };
+
+        // The leaves of the tree are k ... 2k - 1, and node n is the parent
+        // of nodes 2n and 2n + 1. The losers of the nodes 1 ... k - 1 are
+        // stored in tree, with the overall winner in tree[0].
+        std::vector<std::size_t> tree(k);
+        std::vector<std::size_t> win(2 * k);
+        for (std::size_t i = 0; i != k; ++i)
+          win[k + i] = i;
+        for (std::size_t n = k - 1; n != 0; --n) {
+          std::size_t a = win[2 * n];
+          std::size_t b = win[2 * n + 1];
+          if (beats(b, a))
+            std::swap(a, b);
+          win[n] = a;
+          tree[n] = b;
+        }
+        tree[0] = win[1];
+
+        while (true) {
+          std::size_t w = tree[0];
+          if (first[w] == last[w])
+            return out;
+          *out = *first[w];
+          ++out;
+          ++first[w];
+          for (std::size_t n = (w + k) / 2; n != 0; n /= 2)
+            if (beats(tree[n], w))
+              std::swap(tree[n], w);
+          tree[0] = w;
+        }
+      }
+
+    template<typename R, typename O, typename C>
+      inline O
+      k_way_merge(const R& runs, O out, C comp)
+      {
+        using std::begin;
+        using std::end;
+        using I = Iterator_of<const Value_type<Iterator_of<const R&>>&>;
+        std::vector<I> first;
+        std::vector<I> last;
+        for (const auto& r : runs) {
+          first.push_back(begin(r));
+          last.push_back(end(r));
+        }
+        return loser_tree_merge(first, last, out, comp);
+      }
+
+  } // namespace algorithm_impl
+
+
+  template<typename R1, typename R2>
+    inline Iterator_of<R2>
+    k_way_merge(const R1& runs, R2&& range)
+    {
+      using std::begin;
+      return algorithm_impl::k_way_merge(runs, begin(range),
+                                         algorithm_impl::less_than());
+    }
+
+  template<typename R1, typename R2, typename C>
+    inline Iterator_of<R2>
+    k_way_merge(const R1& runs, R2&& range, C comp)
+    {
+      using std::begin;
+      return algorithm_impl::k_way_merge(runs, begin(range), comp);
+    }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Set Operations
+
+  template <typename R1, typename R2>
+    inline bool
+    includes(const R1& range1, const R2& range2)
+    {
+      using std::begin;
+      using std::end;
+      return std::includes(begin(range1), end(range1), 
+                           begin(range2), end(range2));
+    }
+
+  template <typename R1, typename R2, typename C>
+    inline bool
+    includes(const R1& range1, const R2& range2, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::includes(begin(range1), end(range1), 
+                           begin(range2), end(range2),
+                           comp);
+    }
+
+
+  template <typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_union(const R1& range1, const R2& range2, R3&& result)
+    {
+      using std::begin;
+      using std::end;
+      return std::set_union(begin(range1), end(range1), 
+                            begin(range2), end(range2),
+                            begin(result));
+    }
+
+  template <typename R1, typename R2, typename R3, typename C>
+    inline Requires<Input_range<R1>(), Iterator_of<R3>>
+    set_union(const R1& range1, const R2& range2, R3&& result, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::set_union(begin(range1), end(range1), 
+                            begin(range2), end(range2),
+                            begin(result),
+                            comp);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                           [algo.set.inter]
+  //                          Intersection Sizes
+  //
+  //    set_intersection_size(range1, range2)
+  //    set_intersection_size(range1, range2, comp)
+  //    strict_set_intersection(range1, range2, result)
+  //    strict_set_intersection_size(range1, range2)
+  //
+  // The set_intersection_size algorithms return the number of elements that
+  // set_intersection would write, without writing them.
+  //
+  // When both ranges are random access and one is much smaller than the
+  // other, the intersection algorithms (including set_intersection) search
+  // the larger range for each element of the smaller by galloping: probing
+  // at doubling distances from the last match, and then by binary search.
+  // Otherwise, the ranges are merged.
+  //
+  // The strict algorithms intersect strictly increasing ranges, such as
+  // lists of ids, ordered by operator<. When both ranges are contiguous
+  // ranges of the same 4-byte integer type, they are intersected four
+  // elements at a time using vector instructions (see [algo.simd]).
+  // Otherwise, they are equivalent to set_intersection and
+  // set_intersection_size. The behavior is undefined if a range has equal
+  // elements.
+
+  namespace algorithm_impl
+  {
+    // An output iterator that counts the values assigned through it.
+    struct counting_output
+      : std::iterator<std::output_iterator_tag, void, void, void, void>
+    {
+      explicit counting_output(std::size_t& n)
+        : n(&n)
+      { }
+
+      counting_output& operator*() { return *this; }
+
+      template<typename T>
+        counting_output& operator=(const T&)
+        {
+          ++*n;
+          return *this;
+        }
+
+      counting_output& operator++()   { return *this; }
+      counting_output operator++(int) { return *this; }
+
+      std::size_t* n;
+    };
+
+    // A range is searched by galloping when it is gallop_ratio times larger
+    // than the other.
+    constexpr std::size_t gallop_ratio = 32;
+
+    inline bool
+    skewed(std::size_t n, std::size_t m)
+    {
+      return std::min(n, m) * gallop_ratio < std::max(n, m);
+    }
+
+    // Returns the first iterator i in [first, last) such that
+    // !comp(*i, value), probing first[0], first[1], first[3], first[7], ...
+    // before a binary search.
+    template<typename I, typename T, typename C>
+      I
+      gallop(I first, I last, const T& value, C comp)
+      {
+        Difference_type<I> n = last - first;
+        Difference_type<I> k = 1;
+        while (k <= n && comp(first[k - 1], value))
+          k *= 2;
+        return std::lower_bound(first + k / 2, first + std::min(k, n),
+                                value, comp);
+      }
+
+    // Intersect [f1, l1) and [f2, l2) by searching the larger range for
+    // each element of the smaller one. The elements of the first range are
+    // copied, as by std::set_intersection.
+    template<typename I1, typename I2, typename O, typename C>
+      O
+      gallop_intersection(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp)
+      {
+        if (l1 - f1 <= l2 - f2) {
+          for (; f1 != l1 && f2 != l2; ++f1) {
+            f2 = gallop(f2, l2, *f1, comp);
+            if (f2 != l2 && !comp(*f1, *f2)) {
+              *out = *f1;
+              ++out;
+              ++f2;
+            }
+          }
+        } else {
+          for (; f1 != l1 && f2 != l2; ++f2) {
+            f1 = gallop(f1, l1, *f2, comp);
+            if (f1 != l1 && !comp(*f2, *f1)) {
+              *out = *f1;
+              ++out;
+              ++f1;
+            }
+          }
+        }
+        return out;
+      }
+
+    // Returns the size of the intersection of [f1, l1) and [f2, l2), by
+    // merging.
+    template<typename I1, typename I2, typename C>
+      std::size_t
+      merge_intersection_size(I1 f1, I1 l1, I2 f2, I2 l2, C comp)
+      {
+        std::size_t n = 0;
+        while (f1 != l1 && f2 != l2) {
+          bool lt = comp(*f1, *f2);
+          bool gt = comp(*f2, *f1);
+          n += !lt && !gt;
+          if (!gt)
+            ++f1;
+          if (!lt)
+            ++f2;
+        }
+        return n;
+      }
+
+    template<typename I1, typename I2>
+      using Random_access_pair
+        = std::integral_constant<bool, Random_access_iterator<I1>()
+                                       && Random_access_iterator<I2>()>;
+
+    // Intersect [f1, l1) and [f2, l2), galloping if the ranges are random
+    // access and their sizes are skewed.
+    template<typename I1, typename I2, typename O, typename C>
+      inline O
+      intersection(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp,
+                   std::false_type)
+      {
+        return std::set_intersection(f1, l1, f2, l2, out, comp);
+      }
+
+    template<typename I1, typename I2, typename O, typename C>
+      inline O
+      intersection(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp,
+                   std::true_type)
+      {
+        if (skewed(l1 - f1, l2 - f2))
+          return gallop_intersection(f1, l1, f2, l2, out, comp);
+        return std::set_intersection(f1, l1, f2, l2, out, comp);
+      }
+
+    template<typename I1, typename I2, typename C>
+      inline std::size_t
+      intersection_size(I1 f1, I1 l1, I2 f2, I2 l2, C comp, std::false_type)
+      {
+        return merge_intersection_size(f1, l1, f2, l2, comp);
+      }
+
+    template<typename I1, typename I2, typename C>
+      inline std::size_t
+      intersection_size(I1 f1, I1 l1, I2 f2, I2 l2, C comp, std::true_type)
+      {
+        if (skewed(l1 - f1, l2 - f2)) {
+          std::size_t n = 0;
+          gallop_intersection(f1, l1, f2, l2, counting_output(n), comp);
+          return n;
+        }
+        return merge_intersection_size(f1, l1, f2, l2, comp);
+      }
+
+    // The strict intersection of R1 and R2 uses vector instructions if they
+    // are contiguous ranges of the same 4-byte integer type. The type of
+    // the tag selects the vector algorithm, and its value whether the
+    // ranges are random access.
+    template<typename R1, typename R2>
+      constexpr bool
+      Simd_intersection()
+      {
+        using T = Value_type<Iterator_of<R1>>;
+        return Contiguous_range<R1>() && Contiguous_range<R2>()
+            && Same<T, Value_type<Iterator_of<R2>>>()
+            && Integer<T>() && sizeof(T) == 4 && Simd_comparable<T>();
+      }
+
+    template<typename I1, typename I2, typename O>
+      inline O
+      strict_intersection(I1 f1, I1 l1, I2 f2, I2 l2, O out, std::false_type)
+      {
+        return intersection(f1, l1, f2, l2, out, less_than(),
+                            Random_access_pair<I1, I2>());
+      }
+
+    template<typename I1, typename I2>
+      inline std::size_t
+      strict_intersection_size(I1 f1, I1 l1, I2 f2, I2 l2, std::false_type)
+      {
+        return intersection_size(f1, l1, f2, l2, less_than(),
+                                 Random_access_pair<I1, I2>());
+      }
+
+#if defined(__SSE2__)
+    template<typename I1, typename I2, typename O>
+      O
+      strict_intersection(I1 f1, I1 l1, I2 f2, I2 l2, O out, std::true_type)
+      {
+        using T = Value_type<I1>;
+        if (f1 == l1 || f2 == l2)
+          return out;
+        if (skewed(l1 - f1, l2 - f2))
+          return gallop_intersection(f1, l1, f2, l2, out, less_than());
+        const T* a = std::addressof(*f1);
+        const T* la = a + (l1 - f1);
+        const T* b = std::addressof(*f2);
+        const T* lb = b + (l2 - f2);
+        simd_intersect(a, la, b, lb, [&out](const T* p, int mask) {
+          for (int i = 0; i != 4; ++i)
+            if (mask >> i & 1) {
+              *out = p[i];
+              ++out;
+            }
+        });
+        return std::set_intersection(a, la, b, lb, out);
+      }
+
+    template<typename I1, typename I2>
+      std::size_t
+      strict_intersection_size(I1 f1, I1 l1, I2 f2, I2 l2, std::true_type)
+      {
+        using T = Value_type<I1>;
+        if (f1 == l1 || f2 == l2)
+          return 0;
+        if (skewed(l1 - f1, l2 - f2))
+          return intersection_size(f1, l1, f2, l2, less_than(),
+                                   std::true_type());
+        const T* a = std::addressof(*f1);
+        const T* la = a + (l1 - f1);
+        const T* b = std::addressof(*f2);
+        const T* lb = b + (l2 - f2);
+        std::size_t n = 0;
+        simd_intersect(a, la, b, lb, [&n](const T*, int mask) {
+          n += (mask & 1) + (mask >> 1 & 1) + (mask >> 2 & 1) + (mask >> 3);
+        });
+        return n + merge_intersection_size(a, la, b, lb, less_than());
+      }
+#endif
+
+  } // namespace algorithm_impl
+
+
+  template<typename R1, typename R2>
+    inline std::size_t
+    set_intersection_size(const R1& range1, const R2& range2)
+    {
+      using std::begin;
+      using std::end;
+      using Random = algorithm_impl::Random_access_pair<
+        Iterator_of<const R1&>, Iterator_of<const R2&>
+      >;
+      return algorithm_impl::intersection_size(begin(range1), end(range1),
+                                               begin(range2), end(range2),
+                                               algorithm_impl::less_than(),
+                                               Random());
+    }
+
+  template<typename R1, typename R2, typename C>
+    inline std::size_t
+    set_intersection_size(const R1& range1, const R2& range2, C comp)
+    {
+      using std::begin;
+      using std::end;
+      using Random = algorithm_impl::Random_access_pair<
+        Iterator_of<const R1&>, Iterator_of<const R2&>
+      >;
+      return algorithm_impl::intersection_size(begin(range1), end(range1),
+                                               begin(range2), end(range2),
+                                               comp, Random());
+    }
+
+  template<typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    strict_set_intersection(const R1& range1, const R2& range2, R3&& result)
+    {
+      using std::begin;
+      using std::end;
+      using Simd = std::integral_constant<
+        bool, algorithm_impl::Simd_intersection<const R1&, const R2&>()
+      >;
+      return algorithm_impl::strict_intersection(begin(range1), end(range1),
+                                                 begin(range2), end(range2),
+                                                 begin(result), Simd());
+    }
+
+  template<typename R1, typename R2>
+    inline std::size_t
+    strict_set_intersection_size(const R1& range1, const R2& range2)
+    {
+      using std::begin;
+      using std::end;
+      using Simd = std::integral_constant<
+        bool, algorithm_impl::Simd_intersection<const R1&, const R2&>()
+      >;
+      return algorithm_impl::strict_intersection_size(
+        begin(range1), end(range1), begin(range2), end(range2), Simd());
+    }
+
+
+  template <typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_intersection(const R1& range1, const R2& range2, R3&& result)
+    {
+      using std::begin;
+      using std::end;
+      using Random = algorithm_impl::Random_access_pair<
+        Iterator_of<const R1&>, Iterator_of<const R2&>
+      >;
+      return algorithm_impl::intersection(begin(range1), end(range1), 
+                                          begin(range2), end(range2),
+                                          begin(result),
+                                          algorithm_impl::less_than(),
+                                          Random());
+    }
+
+  template <typename R1, typename R2, typename R3, typename C>
+    inline Requires<Input_range<R1>(), Iterator_of<R3>>
+    set_intersection(const R1& range1, const R2& range2, R3&& result, C comp)
+    {
+      using std::begin;
+      using std::end;
+      using Random = algorithm_impl::Random_access_pair<
+        Iterator_of<const R1&>, Iterator_of<const R2&>
+      >;
+      return algorithm_impl::intersection(begin(range1), end(range1), 
+                                          begin(range2), end(range2),
+                                          begin(result),
+                                          comp, Random());
+    }
+
+
+  template <typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_difference(const R1& range1, const R2& range2, R3&& result)
+    {
+      using std::begin;
+      using std::end;
+      return std::set_difference(begin(range1), end(range1), 
+                                 begin(range2), end(range2),
+                                 begin(result));
+    }
+
+  template <typename R1, typename R2, typename R3, typename C>
+    inline Requires<Input_range<R1>(), Iterator_of<R3>>
+    set_difference(const R1& range1, const R2& range2, R3&& result, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::set_difference(begin(range1), end(range1), 
+                                 begin(range2), end(range2),
+                                 begin(result),
+                                 comp);
+    }
+
+  template <typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_symmetric_difference(const R1& range1, const R2& range2, R3&& result)
+    {
+      using std::begin;
+      using std::end;
+      return std::set_symmetric_difference(begin(range1), end(range1), 
+                                           begin(range2), end(range2),
+                                           begin(result));
+    }
+
+  template <typename R1, typename R2, typename R3, typename C>
+    inline Requires<Input_range<R1>(), Iterator_of<R3>>
+    set_symmetric_difference(const R1& range1, const R2& range2, R3&& result, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::set_symmetric_difference(begin(range1), end(range1), 
+                                           begin(range2), end(range2),
+                                           begin(result),
+                                           comp);
+    }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Heap Operations
+
+  template <typename R>
+    inline void 
+    push_heap(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      std::push_heap(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline void
+    push_heap(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      std::push_heap(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline void
+    pop_heap(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      std::pop_heap(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline void
+    pop_heap(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      std::pop_heap(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline void
+    make_heap(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      std::make_heap(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline void
+    make_heap(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      std::make_heap(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline void
+    sort_heap(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      std::sort_heap(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline void
+    sort_heap(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      std::sort_heap(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline bool
+    is_heap(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_heap(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline bool
+    is_heap(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_heap(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline Iterator_of<R>
+    is_heap_until(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_heap_until(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline Iterator_of<R>
+    is_heap_until(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::is_heap_until(begin(range), end(range), comp);
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                               [algo.minmax]
+  //                              Min and Max
+  //
+  //    min_element(range[, comp])
+  //    max_element(range[, comp])
+  //    minmax_element(range[, comp])
+  //    min(range[, comp])
+  //    max(range[, comp])
+  //    minmax(range[, comp])
+  //
+  // The element algorithms return the first least element, the first
+  // greatest element, or the first least and the last greatest elements of
+  // a range, as the std algorithms do, and the value algorithms return
+  // those elements. When the values of the range are arithmetic and comp is
+  // the default order, NaNs are ignored: they are neither least nor
+  // greatest, unless every element is NaN, in which case the first element
+  // is returned. (Comparisons with NaN are false, so the std algorithms
+  // return an element that depends on where the NaNs are.)
+  //
+  // When the range is also contiguous and its values are 4-byte integers,
+  // floats or doubles, the extremes are found in vector registers, a block
+  // at a time (see [algo.simd]). The minmax_element algorithm then makes
+  // two passes over the range. The parallel min_element, max_element and
+  // minmax_element algorithms (see [algo.par]) find the extremes of each
+  // block in the same way.
+
+  namespace algorithm_impl
+  {
+    // Returns true if x is a NaN when Nan is true: x is not equal to
+    // itself.
+    template<typename T>
+      inline bool
+      unordered(const T& x, std::true_type)
+      {
+        return !(x == x);
+      }
+
+    template<typename T>
+      inline bool
+      unordered(const T&, std::false_type)
+      {
+        return false;
+      }
+
+    // Returns the first least element of [first, last), the first greatest
+    // if Max, or the last greatest if Max and Last, ignoring NaNs.
+    template<bool Max, bool Last, typename I>
+      I
+      arithmetic_extreme(I first, I last, std::false_type)
+      {
+        using Nan = std::integral_constant<bool,
+                                           Floating_point<Value_type<I>>()>;
+        I p = first;
+        while (p != last && unordered(*p, Nan()))
+          ++p;
+        if (p == last)
+          return first;
+        I best = p;
+        for (++p; p != last; ++p) {
+          if (Max ? *best < *p : *p < *best)
+            best = p;
+          else if (Last && *p == *best)
+            best = p;
+        }
+        return best;
+      }
+
+#if defined(__SSE2__)
+    template<bool Max, bool Last, typename I>
+      inline I
+      arithmetic_extreme(I first, I last, std::true_type)
+      {
+        if (first == last)
+          return first;
+        const Value_type<I>* p = std::addressof(*first);
+        return first + (simd_extreme<Max, Last>(p, p + (last - first)) - p);
+      }
+#endif
+
+    // Finding the extremes of [first, last) by C ignores NaNs if C is the
+    // default order of an arithmetic type. Finding those of a range uses
+    // vector instructions if it is also contiguous and its values can be
+    // ordered in vector registers.
+    template<typename I, typename C, typename T = Value_type<I>>
+      using Arithmetic_extreme
+        = std::integral_constant<bool, default_order<C, T>::value
+                                       && Arithmetic<T>()>;
+
+    template<typename R, typename C, typename T = Value_type<Iterator_of<R>>>
+      using Simd_range_extreme
+        = std::integral_constant<bool, default_order<C, T>::value
+                                       && Contiguous_range<R>()
+                                       && Simd_orderable<T>()>;
+
+    template<bool Max, bool Last, typename I, typename C, typename S>
+      inline I
+      extreme(I first, I last, C, std::true_type, S simd)
+      {
+        return arithmetic_extreme<Max, Last>(first, last, simd);
+      }
+
+    template<bool Max, bool Last, typename I, typename C, typename S>
+      inline I
+      extreme(I first, I last, C comp, std::false_type, S)
+      {
+        if (!Max)
+          return std::min_element(first, last, comp);
+        if (!Last)
+          return std::max_element(first, last, comp);
+        return std::minmax_element(first, last, comp).second;
+      }
+
+    // Returns the extreme of the range R by C.
+    template<bool Max, bool Last, typename R, typename C>
+      inline Iterator_of<R>
+      range_extreme(R&& range, C comp)
+      {
+        using std::begin;
+        using std::end;
+        using I = Iterator_of<R>;
+        return extreme<Max, Last>(begin(range), end(range), comp,
+                                  Arithmetic_extreme<I, C>(),
+                                  Simd_range_extreme<R, C>());
+      }
+
+  } // namespace algorithm_impl
+
+
+  template <typename R>
+    inline Iterator_of<R>
+    min_element(R&& range)
+    {
+      return algorithm_impl::range_extreme<false, false>(
+        range, algorithm_impl::less_than());
+    }
+
+  template <typename R, typename C>
+    inline Iterator_of<R>
+    min_element(R&& range, C comp)
+    {
+      return algorithm_impl::range_extreme<false, false>(range, comp);
+    }
+
+  template <typename R>
+    inline Iterator_of<R>
+    max_element(R&& range)
+    {
+      return algorithm_impl::range_extreme<true, false>(
+        range, algorithm_impl::less_than());
+    }
+
+  template <typename R, typename C>
+    inline Iterator_of<R>
+    max_element(R&& range, C comp)
+    {
+      return algorithm_impl::range_extreme<true, false>(range, comp);
+    }
+
+  template <typename R, typename C>
+    inline std::pair<Iterator_of<R>, Iterator_of<R>>
+    minmax_element(R&& range, C comp)
+    {
+      using I = Iterator_of<R>;
+      if (!algorithm_impl::Arithmetic_extreme<I, C>()) {
+        using std::begin;
+        using std::end;
+        return std::minmax_element(begin(range), end(range), comp);
+      }
+      return {algorithm_impl::range_extreme<false, false>(range, comp),
+              algorithm_impl::range_extreme<true, true>(range, comp)};
+    }
+
+  template <typename R>
+    inline std::pair<Iterator_of<R>, Iterator_of<R>>
+    minmax_element(R&& range)
+    {
+      return minmax_element(range, algorithm_impl::less_than());
+    }
+
+
+  // NOTE: These versions of min and max are slightly different than those
+  // in the standard library. The standard min/max algorithms require that the
+  // result type is const T& (although T& should be fine, too). We relax the
+  // strict reference requirement so that the result is simply that of
+  // dereferencing the iterator. This makes these algorithms work with 
+  // vector<bool>, for example.
+
+  template <typename R>
+    inline auto
+    min(R&& range) -> decltype(*min_element(range))
+    {
+      return *min_element(range);
+    }
+
+  template <typename R, typename C>
+    inline auto
+    min(R&& range, C comp) -> decltype(*min_element(range, comp))
+    {
+      return *min_element(range, comp);
+    }
+
+  template <typename R>
+    inline auto
+    max(R&& range) -> decltype(*max_element(range))
+    {
+      return *max_element(range);
+    }
+
+  template <typename R, typename C>
+    inline auto
+    max(R&& range, C comp) -> decltype(*max_element(range, comp))
+    {
+      return *max_element(range, comp);
+    }
+
+  template <typename R>
+    inline std::pair<Reference_of<R>, Reference_of<R>>
+    minmax(R&& range)
+    {
+      auto p = minmax_element(range);
+      return {*p.first, *p.second};
+    }
+
+  template <typename R, typename C>
+    inline std::pair<Reference_of<R>, Reference_of<R>>
+    minmax(R&& range, C comp)
+    {
+      auto p = minmax_element(range, comp);
+      return {*p.first, *p.second};
+    }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Lexicographical comparison
+
+  template <typename R1, typename R2>
+    inline bool
+    lexicographical_compare(const R1& range1, const R2& range2)
+    {
+      using std::begin;
+      using std::end;
+      return std::lexicographical_compare(begin(range1), end(range1),
+                                          begin(range2), end(range2));
+    }
+
+  template <typename R1, typename R2, typename C>
+    inline bool
+    lexicographical_compare(const R1& range1, const R2& range2, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::lexicographical_compare(begin(range1), end(range1),
+                                          begin(range2), end(range2),
+                                          comp);
+    }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Permutation Generators
+
+  template <typename R>
+    inline bool
+    next_permutation(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      return std::next_permutation(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline bool
+    next_permutation(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::next_permutation(begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline bool
+    prev_permutation(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      return std::prev_permutation(begin(range), end(range));
+    }
+
+  template <typename R, typename C>
+    inline bool
+    prev_permutation(R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      return std::prev_permutation(begin(range), end(range), comp);
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                  [algo.par]
+  //                           Parallel Algorithms
+  //
+  // The following algorithms have parallel overloads, which take the
+  // execution policy par (see [exec.policy]) as their first argument:
+  //
+  //    all_of(par, range, pred)
+  //    any_of(par, range, pred)
+  //    none_of(par, range, pred)
+  //    for_each(par, range, f)
+  //    for_each_index(par, range, f)
+  //    find(par, range, value)
+  //    find_if(par, range, pred)
+  //    find_if_not(par, range, pred)
+  //    count(par, range, value)
+  //    count_if(par, range, pred)
+  //    copy(par, range1, range2)
+  //    move(par, range1, range2)
+  //    copy_if(par, range1, range2, pred)
+  //    remove(par, range, value)
+  //    remove_if(par, range, pred)
+  //    remove_copy(par, range1, range2, value)
+  //    remove_copy_if(par, range1, range2, pred)
+  //    run_length_encode(par, range, values, counts[, eq])
+  //    hash_unique(par, range[, hash])
+  //    distinct(par, range1, range2[, hash])
+  //    fill(par, range, value)
+  //    range_transform(par, range1, range2, op)
+  //    range_transform(par, range1, range2, range3, op)
+  //    inclusive_scan(par, range1, range2[, op])
+  //    exclusive_scan(par, range1, range2, init[, op])
+  //    segmented_scan(par, range1, heads, range2[, op])
+  //    reduce(par, range, init[, op])
+  //    transform_reduce(par, range, init, op, f)
+  //    transform_reduce(par, range1, range2, init[, op1, op2])
+  //    sort(par, range[, comp])
+  //    stable_sort(par, range[, comp])
+  //    sort_by_key(par, keys, values[, comp])
+  //    radix_sort(par, range[, key])
+  //    partial_sort(par, range, middle[, comp])
+  //    nth_element(par, range, nth[, comp])
+  //    top_k(par, range, k[, comp])
+  //    histogram(par, range, bins[, key])
+  //    counting_sort(par, range, bins[, key])
+  //    bucket_sort(par, range, bins, key[, comp])
+  //    partition(par, range, pred)
+  //    stable_partition(par, range, pred)
+  //    shuffle(par, range, gen)
+  //    sample(par, range, k, gen)
+  //    weighted_sample(par, range, k, weight, gen)
+  //    merge(par, range1, range2, range3[, comp])
+  //    includes(par, range1, range2[, comp])
+  //    set_union(par, range1, range2, result[, comp])
+  //    set_intersection(par, range1, range2, result[, comp])
+  //    set_difference(par, range1, range2, result[, comp])
+  //    set_symmetric_difference(par, range1, range2, result[, comp])
+  //    min_element(par, range[, comp])
+  //    max_element(par, range[, comp])
+  //    minmax_element(par, range[, comp])
+  //
+  // A parallel algorithm computes the same result as the corresponding
+  // serial algorithm, dividing its ranges into blocks that are processed by
+  // the tasks of the policy's scheduler. The ranges must be random access
+  // ranges, and the functions passed to the algorithm must be safe to call
+  // concurrently on different elements. The parallel for_each and
+  // for_each_index return f without having called it; the calls are made
+  // on copies. The for_each, for_each_index and range_transform algorithms
+  // divide their ranges into blocks of the policy's size when it is
+  // chunked (see [exec.policy]).
+  //
+  // The sort algorithm is a sample sort: splitters are drawn from a sorted
+  // sample of the range, each block of the range counts its elements
+  // between each pair of splitters, the elements are scattered by bucket
+  // into a buffer of (default constructed) values, and the buckets are
+  // sorted in parallel and moved back (see [algo.pdqsort]). A value that
+  // fills a large part of the range fills a bucket, which one task sorts.
+  // The stable sort algorithm first sorts blocks of the range, and then
+  // merges adjacent runs of doubling length, alternating between the range
+  // and a buffer. Each merge is itself divided into blocks of equal output
+  // size by co-ranking (a binary search along the merge path), as is the
+  // parallel merge algorithm, so that the work is balanced and the
+  // stability of std::merge is preserved. The set
+  // operations divide both input ranges before the same values, so that
+  // equal elements are processed by the same task. The number of elements
+  // output for each block is counted first, and then each block is written
+  // at its offset in the result.
+  //
+  // The filtering algorithms (copy_if and the remove algorithms) compact
+  // the range by a count, a scan and a scatter: the elements kept in each
+  // block are counted, the counts are scanned into the offsets of the
+  // blocks in the result, and then each block writes its elements at its
+  // offset. Each element is tested twice. The remove algorithms compact
+  // into a buffer and move the result back. The distinct value algorithms
+  // first distribute the positions of the elements over shards by their
+  // hashes, so that equal values are in the same shard, and find the first
+  // occurrences in each shard in a table of its own; the first occurrences
+  // are then compacted in the same way.
+  //
+  // The scans make two passes over blocks of the range. The first computes
+  // the total of each block, and, for a segmented scan, whether the block
+  // has a head. The totals of the blocks are then scanned serially, and the
+  // second pass scans each block, starting from the total of the blocks
+  // before it. The scans of floating point values may therefore round
+  // differently from the serial scans.
+  //
+  // The reductions combine each block as the serial reductions do, and then
+  // combine the results of the blocks in a balanced tree, pairing adjacent
+  // blocks. With a deterministic policy (see [exec.policy]), the blocks,
+  // and so the grouping of all the operations, depend only on the size of
+  // the range, so a floating point sum has the same value for any number of
+  // threads, on any machine that rounds in the same way. The same is true of
+  // the scans. (A compiler that contracts multiplications and additions, as
+  // GCC may with -ffp-contract=fast, can still round an inner product
+  // differently on targets with fused multiply-add instructions.)
+  //
+  // The parallel shuffle draws a single seed from its generator, and its
+  // result depends only on that seed and the size of the range, not on the
+  // number of threads (see [random.splitmix]). The same is true of the
+  // parallel sample algorithms, which merge the reservoirs of each block
+  // (see [random.reservoir]); their samples have the same distribution as,
+  // but differ from, those of the serial algorithms.
+
+
+  namespace algorithm_impl
+  {
+    using execution_impl::grain;
+    using execution_impl::parallel_for;
+
+    // Returns the iterator n elements after i.
+    template<typename I>
+      inline I
+      nth(I i, std::size_t n)
+      {
+        return i + Difference_type<I>(n);
+      }
+
+    // A predicate that compares elements with a value.
+    template<typename T>
+      struct equal_to_value
+      {
+        template<typename U>
+          bool operator()(const U& x) const { return x == value; }
+
+        const T& value;
+      };
+
+    // The negation of a predicate.
+    template<typename P>
+      struct not_pred
+      {
+        template<typename T>
+          bool operator()(const T& x) const { return !pred(x); }
+
+        P pred;
+      };
+
+
+    // Returns true if pred(x) for some x in [first, last). Blocks are
+    // skipped once a match has been found.
+    template<typename I, typename P>
+      bool
+      parallel_any_of(const parallel_policy& pol, I first, I last, P pred)
+      {
+        std::atomic<bool> found(false);
+        parallel_for(pol.scheduler(), last - first,
+          [&](std::size_t b, std::size_t e) {
+            if (!found.load(std::memory_order_relaxed)
+                && std::any_of(nth(first, b), nth(first, e), pred))
+              found.store(true, std::memory_order_relaxed);
+          });
+        return found.load();
+      }
+
+    // Returns the first iterator i in [first, last) such that pred(*i).
+    // Blocks after the first match found so far are skipped.
+    template<typename I, typename P>
+      I
+      parallel_find_if(const parallel_policy& pol, I first, I last, P pred)
+      {
+        std::size_t n = last - first;
+        std::atomic<std::size_t> best(n);
+        parallel_for(pol.scheduler(), n, [&](std::size_t b, std::size_t e) {
+          if (b >= best.load(std::memory_order_relaxed))
+            return;
+          std::size_t k = std::find_if(nth(first, b), nth(first, e), pred)
+                        - first;
+          if (k == e)
+            return;
+          std::size_t x = best.load(std::memory_order_relaxed);
+          while (k < x && !best.compare_exchange_weak(x, k))
+            ;
+        });
+        return nth(first, best.load());
+      }
+
+    template<typename I, typename P>
+      std::size_t
+      parallel_count_if(const parallel_policy& pol, I first, I last, P pred)
+      {
+        std::atomic<std::size_t> total(0);
+        parallel_for(pol.scheduler(), last - first,
+          [&](std::size_t b, std::size_t e) {
+            total.fetch_add(std::count_if(nth(first, b), nth(first, e), pred),
+                            std::memory_order_relaxed);
+          });
+        return total.load();
+      }
+
+    // Returns true if the extreme i of a block is a better extreme of
+    // a range than best, another block's extreme: NaNs are worse than any
+    // number when Nan is true, and ties go to later elements when Last.
+    template<bool Max, bool Last, typename I, typename C, typename Nan>
+      bool
+      better_extreme(I i, I best, C comp, Nan nan)
+      {
+        if (unordered(*best, nan))
+          return !unordered(*i, nan) || i < best;
+        if (unordered(*i, nan))
+          return false;
+        if (Max ? comp(*best, *i) : comp(*i, *best))
+          return true;
+        if (Max ? comp(*i, *best) : comp(*best, *i))
+          return false;
+        return Last ? best < i : i < best;
+      }
+
+    // Returns the extreme of [first, last) by comp, as extreme() does.
+    template<bool Max, bool Last, typename I, typename C, typename A,
+             typename S>
+      I
+      parallel_extreme(const parallel_policy& pol,
+                       I first, I last, C comp, A arith, S simd)
+      {
+        using Nan = std::integral_constant<bool, A::value
+                                           && Floating_point<Value_type<I>>()>;
+        std::mutex m;
+        I best = last;
+        parallel_for(pol.scheduler(), last - first,
+          [&](std::size_t b, std::size_t e) {
+            I i = extreme<Max, Last>(nth(first, b), nth(first, e), comp,
+                                     arith, simd);
+            std::lock_guard<std::mutex> lock(m);
+            if (best == last
+                || better_extreme<Max, Last>(i, best, comp, Nan()))
+              best = i;
+          });
+        return best;
+      }
+
+
+    // Merges the leaves of a parallel merge by copying or moving elements.
+    struct copy_merge
+    {
+      template<typename I1, typename I2, typename O, typename C>
+        void operator()(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp) const
+        {
+          std::merge(f1, l1, f2, l2, out, comp);
+        }
+    };
+
+    struct move_merge
+    {
+      template<typename I1, typename I2, typename O, typename C>
+        void operator()(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp) const
+        {
+          std::merge(std::make_move_iterator(f1), std::make_move_iterator(l1),
+                     std::make_move_iterator(f2), std::make_move_iterator(l2),
+                     out, comp);
+        }
+    };
+
+    // Returns the number of elements of [f1, f1 + n1) among the first k
+    // elements of the stable merge of [f1, f1 + n1) and [f2, f2 + n2) (the
+    // co-rank of k). The result is the least i such that the ith element of
+    // the first range is less than the (k - i)th of the second, found by
+    // binary search on the diagonal k of the merge path.
+    template<typename I1, typename I2, typename C>
+      std::size_t
+      co_rank(std::size_t k, I1 f1, std::size_t n1, I2 f2, std::size_t n2,
+              C comp)
+      {
+        std::size_t lo = k > n2 ? k - n2 : 0;
+        std::size_t hi = std::min(k, n1);
+        while (lo < hi) {
+          std::size_t i = lo + (hi - lo) / 2;
+          if (!comp(f2[k - i - 1], f1[i]))
+            lo = i + 1;
+          else
+            hi = i;
+        }
+        return lo;
+      }
+
+    // Merge [f1, l1) and [f2, l2) into out as tasks of the group g. The
+    // merge is divided at the middle of its output, by co-ranking, so the
+    // tasks merge equal numbers of elements however the values of the
+    // ranges are distributed.
+    template<typename I1, typename I2, typename O, typename C, typename L>
+      void
+      merge_blocks(task_group& g, std::size_t grain,
+                   I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp, L leaf)
+      {
+        std::size_t n1 = l1 - f1;
+        std::size_t n2 = l2 - f2;
+        while (n1 + n2 > grain) {
+          std::size_t k = (n1 + n2) / 2;
+          std::size_t i = co_rank(k, f1, n1, f2, n2, comp);
+          I1 m1 = nth(f1, i);
+          I2 m2 = nth(f2, k - i);
+          O mo = nth(out, k);
+          g.run([=, &g]() {
+            merge_blocks(g, grain, m1, l1, m2, l2, mo, comp, leaf);
+          });
+          l1 = m1;
+          l2 = m2;
+          n1 = i;
+          n2 = k - i;
+        }
+        leaf(f1, l1, f2, l2, out, comp);
+      }
+
+    template<typename I1, typename I2, typename O, typename C>
+      O
+      parallel_merge(const parallel_policy& pol,
+                     I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = (l1 - f1) + (l2 - f2);
+        task_group g(s);
+        merge_blocks(g, grain(s, n), f1, l1, f2, l2, out, comp, copy_merge());
+        g.wait();
+        return nth(out, n);
+      }
+
+    // The number of samples drawn for each bucket of a sample sort.
+    constexpr std::size_t oversampling = 16;
+
+    // Sort [first, last) by distributing its elements into buckets between
+    // splitters drawn from a sample, and sorting the buckets in parallel.
+    template<typename I, typename C>
+      void
+      parallel_sample_sort(task_scheduler& s, I first, I last, C comp,
+                           std::size_t k)
+      {
+        using T = Value_type<I>;
+        std::size_t n = last - first;
+
+        // Swap a sample of evenly spaced elements to the front of the range
+        // and sort it. The splitters are every oversampling-th element of
+        // the sample, and stay in place until the elements are classified.
+        std::size_t m = std::min<std::size_t>(n / k, 8 * s.size());
+        m = std::max<std::size_t>(2, std::min<std::size_t>(m, 1 << 12));
+        std::size_t ns = m * oversampling;
+        for (std::size_t i = 0; i != ns; ++i)
+          std::iter_swap(nth(first, i), nth(first, i * (n / ns)));
+        comparison_sort(first, nth(first, ns), comp);
+        auto splitter = [&](std::size_t j) -> const T& {
+          return *nth(first, (j + 1) * oversampling);
+        };
+
+        // Classify the elements of each block by the number of splitters
+        // not greater than them, counting the elements of the block in each
+        // bucket.
+        std::size_t blocks = (n + k - 1) / k;
+        std::vector<std::uint16_t> bucket(n);
+        std::vector<std::size_t> counts(blocks * m);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j) {
+            std::size_t* c = &counts[j * m];
+            std::size_t hi = std::min(n, j * k + k);
+            for (std::size_t i = j * k; i != hi; ++i) {
+              const T& x = *nth(first, i);
+              std::size_t lo = 0;
+              std::size_t up = m - 1;
+              while (lo < up) {
+                std::size_t mid = lo + (up - lo) / 2;
+                if (comp(x, splitter(mid)))
+                  up = mid;
+                else
+                  lo = mid + 1;
+              }
+              bucket[i] = lo;
+              ++c[lo];
+            }
+          }
+        });
+
+        // The elements of each block in a bucket follow those of the
+        // previous blocks.
+        std::vector<std::size_t> bounds(m + 1);
+        std::size_t sum = 0;
+        for (std::size_t x = 0; x != m; ++x) {
+          bounds[x] = sum;
+          for (std::size_t j = 0; j != blocks; ++j) {
+            std::size_t c = counts[j * m + x];
+            counts[j * m + x] = sum;
+            sum += c;
+          }
+        }
+        bounds[m] = n;
+
+        std::unique_ptr<T[]> buf(new T[n]);
+        T* p = buf.get();
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j) {
+            std::size_t* c = &counts[j * m];
+            std::size_t hi = std::min(n, j * k + k);
+            for (std::size_t i = j * k; i != hi; ++i)
+              p[c[bucket[i]]++] = std::move(*nth(first, i));
+          }
+        });
+
+        // Sort each bucket, and move it back.
+        parallel_for(s, m, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t x = b; x != e; ++x) {
+            comparison_sort(p + bounds[x], p + bounds[x + 1], comp);
+            std::move(p + bounds[x], p + bounds[x + 1],
+                      nth(first, bounds[x]));
+          }
+        });
+      }
+
+    // Sort [first, last): by sample sort if it need not be stable, and
+    // otherwise by merging sorted blocks.
+    template<typename I, typename C>
+      void
+      parallel_sort(const parallel_policy& pol,
+                    I first, I last, C comp, bool stable)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t k = grain(s, n);
+        auto sort_block = [&](I b, I e) {
+          if (stable)
+            std::stable_sort(b, e, comp);
+          else
+            comparison_sort(b, e, comp);
+        };
+        if (n <= k || s.size() == 1) {
+          sort_block(first, last);
+          return;
+        }
+        if (!stable) {
+          parallel_sample_sort(s, first, last, comp, k);
+          return;
+        }
+
+        parallel_for(s, (n + k - 1) / k, 1,
+          [&](std::size_t b, std::size_t e) {
+            for (std::size_t j = b; j != e; ++j)
+              sort_block(nth(first, j * k), nth(first, std::min(n, j * k + k)));
+          });
+
+        std::unique_ptr<T[]> buf(new T[n]);
+        T* p = buf.get();
+        bool in_buf = false;
+        for (std::size_t w = k; w < n; w *= 2) {
+          task_group g(s);
+          for (std::size_t lo = 0; lo < n; lo += 2 * w) {
+            std::size_t mid = std::min(n, lo + w);
+            std::size_t hi = std::min(n, lo + 2 * w);
+            g.run([=, &g]() {
+              if (in_buf)
+                merge_blocks(g, k, p + lo, p + mid, p + mid, p + hi,
+                             nth(first, lo), comp, move_merge());
+              else
+                merge_blocks(g, k, nth(first, lo), nth(first, mid),
+                             nth(first, mid), nth(first, hi),
+                             p + lo, comp, move_merge());
+            });
+          }
+          g.wait();
+          in_buf = !in_buf;
+        }
+        if (in_buf)
+          parallel_for(s, n, [&](std::size_t b, std::size_t e) {
+            std::move(p + b, p + e, nth(first, b));
+          });
+      }
+
+    // Merge the keys [f1, f1 + n1) and [f2, f2 + n2) and their values at v1
+    // and v2 into ko and vo as tasks of the group g, dividing the merge as
+    // merge_blocks does.
+    template<typename K1, typename V1, typename K2, typename V2, typename C>
+      void
+      key_merge_blocks(task_group& g, std::size_t grain,
+                       K1 f1, V1 v1, std::size_t n1,
+                       K1 f2, V1 v2, std::size_t n2,
+                       K2 ko, V2 vo, C comp)
+      {
+        while (n1 + n2 > grain) {
+          std::size_t k = (n1 + n2) / 2;
+          std::size_t i = co_rank(k, f1, n1, f2, n2, comp);
+          K1 m1 = nth(f1, i);
+          V1 w1 = nth(v1, i);
+          K1 m2 = nth(f2, k - i);
+          V1 w2 = nth(v2, k - i);
+          K2 mk = nth(ko, k);
+          V2 mv = nth(vo, k);
+          std::size_t r1 = n1 - i;
+          std::size_t r2 = n2 - (k - i);
+          g.run([=, &g]() {
+            key_merge_blocks(g, grain, m1, w1, r1, m2, w2, r2, mk, mv, comp);
+          });
+          n1 = i;
+          n2 = k - i;
+        }
+        key_merge(f1, nth(f1, n1), v1, f2, nth(f2, n2), v2, ko, vo, comp);
+      }
+
+    // Sort the keys [first, last) and their values at vals by sorting
+    // blocks in parallel and merging them, as parallel_sort does for a
+    // stable sort.
+    template<typename K, typename V, typename C>
+      void
+      parallel_sort_by_key(const parallel_policy& pol,
+                           K first, K last, V vals, C comp)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t k = grain(s, n);
+        if (n <= k || s.size() == 1) {
+          sort_by_key(first, last, vals, comp);
+          return;
+        }
+
+        std::unique_ptr<Value_type<K>[]> kbuf(new Value_type<K>[n]);
+        std::unique_ptr<Value_type<V>[]> vbuf(new Value_type<V>[n]);
+        Value_type<K>* kb = kbuf.get();
+        Value_type<V>* vb = vbuf.get();
+        parallel_for(s, (n + k - 1) / k, 1,
+          [&](std::size_t b, std::size_t e) {
+            for (std::size_t j = b; j != e; ++j) {
+              std::size_t lo = j * k;
+              key_sort(nth(first, lo), nth(vals, lo), std::min(k, n - lo),
+                       kb + lo, vb + lo, comp);
+            }
+          });
+
+        bool in_buf = false;
+        for (std::size_t w = k; w < n; w *= 2) {
+          task_group g(s);
+          for (std::size_t lo = 0; lo < n; lo += 2 * w) {
+            std::size_t mid = std::min(n, lo + w);
+            std::size_t hi = std::min(n, lo + 2 * w);
+            g.run([=, &g]() {
+              if (in_buf)
+                key_merge_blocks(g, k, kb + lo, vb + lo, mid - lo,
+                                 kb + mid, vb + mid, hi - mid,
+                                 nth(first, lo), nth(vals, lo), comp);
+              else
+                key_merge_blocks(g, k, nth(first, lo), nth(vals, lo),
+                                 mid - lo, nth(first, mid), nth(vals, mid),
+                                 hi - mid, kb + lo, vb + lo, comp);
+            });
+          }
+          g.wait();
+          in_buf = !in_buf;
+        }
+        if (in_buf)
+          parallel_for(s, n, [&](std::size_t b, std::size_t e) {
+            std::move(kb + b, kb + e, nth(first, b));
+            std::move(vb + b, vb + e, nth(vals, b));
+          });
+      }
+
+    // Select the first k values of [first, last) by comp. Each task keeps
+    // a heap of the values of its blocks, and the heaps are selected from
+    // at the end.
+    template<typename I, typename C>
+      std::vector<Value_type<I>>
+      parallel_top_k(const parallel_policy& pol, I first, I last,
+                     std::size_t k, C comp)
+      {
+        using T = Value_type<I>;
+        using Simd = Simd_iterator_select<I, C>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t g = grain(s, n);
+        top_k_heap<T, C> h(k, comp);
+        if (k == 0)
+          return h.sorted();
+        if (n <= g || s.size() == 1) {
+          top_k_scan(first, last, h, Simd());
+          return h.sorted();
+        }
+
+        std::size_t blocks = (n + g - 1) / g;
+        std::vector<std::vector<T>> heaps(blocks);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          top_k_heap<T, C> t(k, comp);
+          for (std::size_t j = b; j != e; ++j)
+            top_k_scan(nth(first, j * g), nth(first, std::min(n, j * g + g)),
+                       t, Simd());
+          heaps[b] = std::move(t.values());
+        });
+        for (const std::vector<T>& v : heaps)
+          for (const T& x : v)
+            h.push(x);
+        return h.sorted();
+      }
+
+    // Returns the number of tasks that count the n keys of a range in bins
+    // bins of their own: at most one for every bins keys.
+    inline std::size_t
+    histogram_tasks(task_scheduler& s, std::size_t n, std::size_t bins)
+    {
+      std::size_t k = grain(s, n);
+      std::size_t t = std::min((n + k - 1) / k, s.size());
+      return std::min(t, n / std::max<std::size_t>(1, bins));
+    }
+
+    template<typename I, typename K>
+      std::vector<std::size_t>
+      parallel_histogram(const parallel_policy& pol, I first, I last,
+                         std::size_t bins, K key)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t t = histogram_tasks(s, n, bins);
+        std::vector<std::size_t> c(bins);
+        if (t <= 1) {
+          histogram_count(first, last, key, c.data());
+          return c;
+        }
+
+        std::vector<std::size_t> local(t * bins);
+        parallel_for(s, t, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            histogram_count(nth(first, j * n / t), nth(first, (j + 1) * n / t),
+                            key, &local[j * bins]);
+        });
+        parallel_for(s, bins, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = 0; j != t; ++j)
+            for (std::size_t x = b; x != e; ++x)
+              c[x] += local[j * bins + x];
+        });
+        return c;
+      }
+
+    template<typename I, typename K>
+      std::vector<std::size_t>
+      parallel_counting_sort(const parallel_policy& pol, I first, I last,
+                             std::size_t bins, K key)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t t = histogram_tasks(s, n, bins);
+        if (t <= 1)
+          return counting_sort(first, last, bins, key);
+
+        // Count the keys of each task's part, and scan the counts so that
+        // the elements of each bin follow those of the same bin in the
+        // previous parts.
+        std::vector<std::size_t> local(t * bins);
+        auto part = [&](std::size_t j) { return nth(first, j * n / t); };
+        parallel_for(s, t, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            histogram_count(part(j), part(j + 1), key, &local[j * bins]);
+        });
+        std::vector<std::size_t> off(bins + 1);
+        std::size_t sum = 0;
+        for (std::size_t x = 0; x != bins; ++x) {
+          off[x] = sum;
+          for (std::size_t j = 0; j != t; ++j) {
+            std::size_t c = local[j * bins + x];
+            local[j * bins + x] = sum;
+            sum += c;
+          }
+        }
+        off[bins] = n;
+
+        std::unique_ptr<T[]> buf(new T[n]);
+        T* p = buf.get();
+        parallel_for(s, t, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            histogram_scatter(part(j), part(j + 1), p, key, &local[j * bins]);
+        });
+        parallel_for(s, n, [&](std::size_t b, std::size_t e) {
+          std::move(p + b, p + e, nth(first, b));
+        });
+        return off;
+      }
+
+    // Copy, move or fill [first, last) in parallel blocks, streaming the
+    // blocks if the range is streamed (see [algo.stream]).
+    template<typename I, typename O>
+      O
+      parallel_copy(const parallel_policy& pol, I first, I last, O out,
+                    std::false_type)
+      {
+        std::size_t n = last - first;
+        parallel_for(pol.scheduler(), n, [&](std::size_t b, std::size_t e) {
+          std::copy(nth(first, b), nth(first, e), nth(out, b));
+        });
+        return nth(out, n);
+      }
+
+    template<typename I, typename O>
+      O
+      parallel_move(const parallel_policy& pol, I first, I last, O out,
+                    std::false_type)
+      {
+        std::size_t n = last - first;
+        parallel_for(pol.scheduler(), n, [&](std::size_t b, std::size_t e) {
+          std::move(nth(first, b), nth(first, e), nth(out, b));
+        });
+        return nth(out, n);
+      }
+
+    template<typename I, typename T>
+      void
+      parallel_fill(const parallel_policy& pol, I first, I last,
+                    const T& value, std::false_type)
+      {
+        parallel_for(pol.scheduler(), last - first,
+          [&](std::size_t b, std::size_t e) {
+            std::fill(nth(first, b), nth(first, e), value);
+          });
+      }
+
+#if defined(__SSE2__)
+    template<typename I, typename O>
+      O
+      parallel_copy(const parallel_policy& pol, I first, I last, O out,
+                    std::true_type)
+      {
+        using T = Value_type<I>;
+        std::size_t n = last - first;
+        if (!streamed<T>(n) || overlapping(std::addressof(*first),
+                                           std::addressof(*out), n))
+          return parallel_copy(pol, first, last, out, std::false_type());
+        const char* p = reinterpret_cast<const char*>(std::addressof(*first));
+        char* q = reinterpret_cast<char*>(std::addressof(*out));
+        parallel_for(pol.scheduler(), n, [&](std::size_t b, std::size_t e) {
+          simd_stream_copy(p + b * sizeof(T), q + b * sizeof(T),
+                           (e - b) * sizeof(T));
+        });
+        return nth(out, n);
+      }
+
+    template<typename I, typename O>
+      inline O
+      parallel_move(const parallel_policy& pol, I first, I last, O out,
+                    std::true_type)
+      {
+        return parallel_copy(pol, first, last, out, std::true_type());
+      }
+
+    template<typename I, typename T>
+      void
+      parallel_fill(const parallel_policy& pol, I first, I last,
+                    const T& value, std::true_type)
+      {
+        using V = Value_type<I>;
+        std::size_t n = last - first;
+        if (!streamed<V>(n)) {
+          parallel_fill(pol, first, last, value, std::false_type());
+          return;
+        }
+        V* p = std::addressof(*first);
+        V x = value;
+        parallel_for(pol.scheduler(), n, [&](std::size_t b, std::size_t e) {
+          simd_stream_fill(p + b, p + e, x);
+        });
+      }
+#endif
+
+    // Sort the digit d of the keys of the n elements at src into dst, in
+    // blocks of k elements. The counts of the digit values in each block
+    // are stored in counts, radix values per block, and are computed first
+    // unless known.
+    template<typename I, typename O, typename K>
+      void
+      radix_pass(task_scheduler& s, I src, std::size_t n, std::size_t k,
+                 O dst, K key, std::size_t d,
+                 std::vector<std::size_t>& counts, bool counted)
+      {
+        std::size_t blocks = (n + k - 1) / k;
+        if (!counted)
+          parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t j = b; j != e; ++j) {
+              std::size_t* c = &counts[j * radix];
+              std::fill(c, c + radix, 0);
+              radix_count_digit(nth(src, j * k),
+                                nth(src, std::min(n, j * k + k)),
+                                key, d, c);
+            }
+          });
+
+        // The elements of each block having a digit value follow those of
+        // the previous blocks.
+        std::size_t sum = 0;
+        for (std::size_t x = 0; x != radix; ++x)
+          for (std::size_t j = 0; j != blocks; ++j) {
+            std::size_t m = counts[j * radix + x];
+            counts[j * radix + x] = sum;
+            sum += m;
+          }
+
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            radix_scatter(nth(src, j * k), nth(src, std::min(n, j * k + k)),
+                          dst, key, d, &counts[j * radix]);
+        });
+      }
+
+    // Sort [first, last) by the keys key(x). The occurrences of each digit
+    // value are counted in each block of the range, and the blocks are then
+    // scattered concurrently, each to its own positions.
+    template<typename I, typename K>
+      void
+      parallel_radix_sort(const parallel_policy& pol, I first, I last, K key)
+      {
+        using T = Value_type<I>;
+        using U = decltype(radix_bits(key(*first)));
+        constexpr std::size_t digits = sizeof(U);
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t k = grain(s, n);
+        if (n <= k || s.size() == 1) {
+          lsd_radix_sort(first, last, key);
+          return;
+        }
+
+        // Count every digit of every block, and sum the counts to find the
+        // digits that are the same in all keys.
+        std::size_t blocks = (n + k - 1) / k;
+        std::vector<std::size_t> all(blocks * digits * radix);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            radix_count(nth(first, j * k), nth(first, std::min(n, j * k + k)),
+                        key, &all[j * digits * radix]);
+        });
+        std::size_t totals[digits * radix] = { };
+        for (std::size_t j = 0; j != blocks; ++j)
+          for (std::size_t x = 0; x != digits * radix; ++x)
+            totals[x] += all[j * digits * radix + x];
+
+        std::unique_ptr<T[]> buf;
+        std::vector<std::size_t> counts(blocks * radix);
+        bool in_buf = false;
+        bool counted = true;
+        for (std::size_t d = 0; d != digits; ++d) {
+          if (radix_trivial(totals + d * radix, n))
+            continue;
+          if (!buf)
+            buf.reset(new T[n]);
+
+          // The counts of the first pass are those of the unsorted range.
+          if (counted)
+            for (std::size_t j = 0; j != blocks; ++j)
+              std::copy_n(&all[(j * digits + d) * radix], radix,
+                          &counts[j * radix]);
+          T* p = buf.get();
+          if (in_buf)
+            radix_pass(s, p, n, k, first, key, d, counts, counted);
+          else
+            radix_pass(s, first, n, k, p, key, d, counts, counted);
+          in_buf = !in_buf;
+          counted = false;
+        }
+        if (in_buf) {
+          T* p = buf.get();
+          parallel_for(s, n, [&](std::size_t b, std::size_t e) {
+            std::move(p + b, p + e, nth(first, b));
+          });
+        }
+      }
+
+    // Sort [first, last), using radix sort if the order is a radix order
+    // and the range is not small.
+    template<typename I, typename C>
+      inline void
+      parallel_sort_dispatch(const parallel_policy& pol,
+                             I first, I last, C comp, bool stable,
+                             std::false_type)
+      {
+        parallel_sort(pol, first, last, comp, stable);
+      }
+
+    template<typename I, typename C>
+      inline void
+      parallel_sort_dispatch(const parallel_policy& pol,
+                             I first, I last, C comp, bool stable,
+                             std::true_type)
+      {
+        if (std::size_t(last - first) < radix_threshold)
+          parallel_sort(pol, first, last, comp, stable);
+        else
+          parallel_radix_sort(pol, first, last, radix_identity());
+      }
+
+    // Partition [first, last) in place. Each block is partitioned, and then
+    // the false elements before the partition point are swapped with the
+    // true elements after it. Both are listed as intervals of positions,
+    // which are paired in order.
+    template<typename I, typename P>
+      I
+      parallel_partition(const parallel_policy& pol, I first, I last, P pred)
+      {
+        using interval = std::pair<std::size_t, std::size_t>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t k = grain(s, n);
+        if (n <= k || s.size() == 1)
+          return std::partition(first, last, pred);
+
+        std::size_t blocks = (n + k - 1) / k;
+        std::vector<std::size_t> trues(blocks);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j) {
+            I f = nth(first, j * k);
+            I l = nth(first, std::min(n, j * k + k));
+            trues[j] = std::partition(f, l, pred) - f;
+          }
+        });
+        std::size_t t = 0;
+        for (std::size_t x : trues)
+          t += x;
+
+        // The intervals of misplaced elements, and the number of misplaced
+        // elements before each interval.
+        std::vector<interval> fs;
+        std::vector<interval> ts;
+        std::vector<std::size_t> fp;
+        std::vector<std::size_t> tp;
+        std::size_t nf = 0;
+        std::size_t nt = 0;  // Equal to nf
+        for (std::size_t j = 0; j != blocks; ++j) {
+          std::size_t lo = j * k;
+          std::size_t mid = lo + trues[j];
+          std::size_t hi = std::min(n, lo + k);
+          if (mid < t && mid != hi) {
+            fs.push_back(interval(mid, std::min(hi, t)));
+            fp.push_back(nf);
+            nf += fs.back().second - fs.back().first;
+          }
+          if (mid > t && lo != mid) {
+            ts.push_back(interval(std::max(lo, t), mid));
+            tp.push_back(nt);
+            nt += ts.back().second - ts.back().first;
+          }
+        }
+
+        parallel_for(s, nf, [&](std::size_t b, std::size_t e) {
+          std::size_t i = std::upper_bound(fp.begin(), fp.end(), b)
+                        - fp.begin() - 1;
+          std::size_t j = std::upper_bound(tp.begin(), tp.end(), b)
+                        - tp.begin() - 1;
+          std::size_t x = fs[i].first + (b - fp[i]);
+          std::size_t y = ts[j].first + (b - tp[j]);
+          for (; b != e; ++b) {
+            using std::swap;
+            swap(first[x], first[y]);
+            if (++x == fs[i].second && ++i != fs.size())
+              x = fs[i].first;
+            if (++y == ts[j].second && ++j != ts.size())
+              y = ts[j].first;
+          }
+        });
+        return nth(first, t);
+      }
+
+    // Stably partition [first, last) into a buffer. The true and false
+    // elements of each block are counted, and then the elements of each
+    // block are moved to their offsets in the buffer, and back.
+    template<typename I, typename P>
+      I
+      parallel_stable_partition(const parallel_policy& pol,
+                                I first, I last, P pred)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t k = grain(s, n);
+        if (n <= k || s.size() == 1)
+          return std::stable_partition(first, last, pred);
+
+        std::size_t blocks = (n + k - 1) / k;
+        std::vector<std::size_t> trues(blocks);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            trues[j] = std::count_if(nth(first, j * k),
+                                     nth(first, std::min(n, j * k + k)),
+                                     pred);
+        });
+        std::vector<std::size_t> to(blocks);
+        std::vector<std::size_t> fo(blocks);
+        std::size_t t = 0;
+        for (std::size_t j = 0; j != blocks; ++j) {
+          to[j] = t;
+          t += trues[j];
+        }
+        for (std::size_t j = 0, f = t; j != blocks; ++j) {
+          fo[j] = f;
+          f += std::min(n, j * k + k) - j * k - trues[j];
+        }
+
+        std::unique_ptr<T[]> buf(new T[n]);
+        T* p = buf.get();
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j) {
+            I l = nth(first, std::min(n, j * k + k));
+            for (I i = nth(first, j * k); i != l; ++i)
+              p[pred(*i) ? to[j]++ : fo[j]++] = std::move(*i);
+          }
+        });
+        parallel_for(s, n, [&](std::size_t b, std::size_t e) {
+          std::move(p + b, p + e, nth(first, b));
+        });
+        return nth(first, t);
+      }
+
+    // Copy the kept elements of [first, first + n) to out, in order, and
+    // return the number copied. The kept elements of each block [i, j) are
+    // counted by count(i, j), the counts are scanned, and then copy(i, j, o)
+    // writes the kept elements of each block at its offset o in out,
+    // returning the end of the elements written. Each element is therefore
+    // tested twice.
+    template<typename I, typename O, typename C, typename K>
+      std::size_t
+      parallel_compact(const parallel_policy& pol, I first, std::size_t n,
+                       O out, C count, K copy)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t g = grain(pol, n);
+        std::size_t blocks = (n + g - 1) / g;
+        if (blocks <= 1 || s.size() == 1)
+          return copy(first, nth(first, n), out) - out;
+
+        std::vector<std::size_t> offsets(blocks + 1);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b)
+            offsets[b + 1] = count(nth(first, b * g),
+                                   nth(first, std::min(n, (b + 1) * g)));
+        });
+        for (std::size_t b = 0; b != blocks; ++b)
+          offsets[b + 1] += offsets[b];
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b)
+            copy(nth(first, b * g), nth(first, std::min(n, (b + 1) * g)),
+                 nth(out, offsets[b]));
+        });
+        return offsets[blocks];
+      }
+
+    // Remove the elements of [first, last) that are not kept, returning the
+    // end of the elements that remain. The kept elements are compacted into
+    // a buffer, by count and copy as for parallel_compact, and moved back.
+    // A range that is not divided is removed by remove(first, last).
+    template<typename I, typename C, typename K, typename F>
+      I
+      parallel_remove(const parallel_policy& pol, I first, I last, C count,
+                      K copy, F remove)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        if (n <= grain(pol, n) || s.size() == 1)
+          return remove(first, last);
+
+        std::unique_ptr<T[]> buf(new T[n]);
+        T* p = buf.get();
+        std::size_t k = parallel_compact(pol, first, n, p, count, copy);
+        parallel_for(s, k, [&](std::size_t b, std::size_t e) {
+          std::move(p + b, p + e, nth(first, b));
+        });
+        return nth(first, k);
+      }
+
+    // Returns the first run head in [first + b, first + e): the first
+    // element that is not equivalent to the one before it. The runs of the
+    // range [first, first + n) are followed past e to their ends.
+    template<typename I, typename E, typename S>
+      inline std::size_t
+      first_run_head(I first, std::size_t b, std::size_t e, E eq, S simd)
+      {
+        if (b == 0)
+          return 0;
+        return run_end(nth(first, b - 1), nth(first, e), eq, simd) - first;
+      }
+
+    // Write the runs of [first, first + n) to values and counts, as
+    // run_length_encode does, and return the number of runs. The runs
+    // beginning in each block are counted, the counts are scanned, and then
+    // each block writes its runs at its offset.
+    template<typename I, typename O1, typename O2, typename E, typename S>
+      std::size_t
+      parallel_run_length_encode(const parallel_policy& pol, I first,
+                                 std::size_t n, O1 values, O2 counts, E eq,
+                                 S simd)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t g = grain(pol, n);
+        std::size_t blocks = (n + g - 1) / g;
+        I last = nth(first, n);
+        if (blocks <= 1 || s.size() == 1)
+          return run_length_encode(first, last, values, counts, eq, simd)
+                   .first - values;
+
+        std::vector<std::size_t> offsets(blocks + 1);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            std::size_t j = std::min(n, (b + 1) * g);
+            std::size_t k = 0;
+            I i = nth(first, first_run_head(first, b * g, j, eq, simd));
+            for (I l = nth(first, j); i < l; ++k)
+              i = run_end(i, last, eq, simd);
+            offsets[b + 1] = k;
+          }
+        });
+        for (std::size_t b = 0; b != blocks; ++b)
+          offsets[b + 1] += offsets[b];
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            std::size_t j = std::min(n, (b + 1) * g);
+            O1 v = nth(values, offsets[b]);
+            O2 c = nth(counts, offsets[b]);
+            I i = nth(first, first_run_head(first, b * g, j, eq, simd));
+            for (I l = nth(first, j); i < l; ++v, ++c) {
+              I r = run_end(i, last, eq, simd);
+              *v = *i;
+              *c = r - i;
+              i = r;
+            }
+          }
+        });
+        return offsets[blocks];
+      }
+
+    // Move the elements x of [first, last) such that !pred(x) to out, and
+    // return the end of the elements moved.
+    template<typename I, typename O, typename P>
+      O
+      remove_move_if(I first, I last, O out, P pred)
+      {
+        for (; first != last; ++first)
+          if (!pred(*first)) {
+            *out = std::move(*first);
+            ++out;
+          }
+        return out;
+      }
+
+    // Move the elements of [first, last) that are not equal to value to out,
+    // using vector instructions if simd is true.
+    template<typename I, typename O, typename T>
+      inline O
+      remove_move(I first, I last, O out, const T& value, std::false_type)
+      {
+        return remove_move_if(first, last, out, equal_to_value<T> {value});
+      }
+
+    template<typename I, typename O, typename T>
+      inline O
+      remove_move(I first, I last, O out, const T& value, std::true_type simd)
+      {
+        return remove_copy_match(first, last, out, value, simd);
+      }
+
+    // Returns a flag for each element of [first, first + n) that is true if
+    // it is the first occurrence of its value. The positions of the
+    // elements are distributed over shards by the high bits of their
+    // hashes, in the order of the range, and the first occurrences in each
+    // shard are then found in its own table.
+    template<typename I, typename H>
+      std::vector<char>
+      parallel_first_occurrences(const parallel_policy& pol, I first,
+                                 std::size_t n, H hash)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t g = grain(pol, n);
+        std::size_t blocks = (n + g - 1) / g;
+        int bits = 1;
+        while ((std::size_t(1) << bits) < 8 * s.size())
+          ++bits;
+        std::size_t shards = std::size_t(1) << bits;
+        auto shard = [&](std::size_t i) {
+          return std::size_t(random_impl::mix(hash(*nth(first, i)))
+                             >> (64 - bits));
+        };
+
+        // Count the elements of each block in each shard, and compute the
+        // offset of each block in each shard, shard by shard.
+        std::vector<std::size_t> offsets(blocks * shards);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b)
+            for (std::size_t i = b * g; i != std::min(n, (b + 1) * g); ++i)
+              ++offsets[b * shards + shard(i)];
+        });
+        std::vector<std::size_t> starts(shards + 1);
+        std::size_t total = 0;
+        for (std::size_t k = 0; k != shards; ++k) {
+          starts[k] = total;
+          for (std::size_t b = 0; b != blocks; ++b) {
+            std::size_t c = offsets[b * shards + k];
+            offsets[b * shards + k] = total;
+            total += c;
+          }
+        }
+        starts[shards] = total;
+
+        std::vector<std::size_t> positions(n);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b)
+            for (std::size_t i = b * g; i != std::min(n, (b + 1) * g); ++i)
+              positions[offsets[b * shards + shard(i)]++] = i;
+        });
+
+        std::vector<char> firsts(n);
+        auto eq = [first](std::size_t a, std::size_t b) {
+          return *nth(first, a) == *nth(first, b);
+        };
+        parallel_for(s, shards, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            auto set = make_distinct_set<std::size_t>(eq);
+            for (std::size_t j = starts[b]; j != starts[b + 1]; ++j) {
+              std::size_t i = positions[j];
+              if (set.insert(i, random_impl::mix(hash(*nth(first, i)))))
+                firsts[i] = true;
+            }
+          }
+        });
+        return firsts;
+      }
+
+    // Partially sort [first, last) so that nth holds the element that
+    // would be there if the range were sorted, by introselect. The range
+    // is divided by the median of a sample of its elements, into elements
+    // less than, equal to and greater than it, until the part containing
+    // nth is small, or until too many rounds have not made it small.
+    template<typename I, typename C>
+      void
+      parallel_nth_element(const parallel_policy& pol,
+                           I first, I nth, I last, C comp)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        constexpr std::size_t samples = 127;
+        std::size_t rounds = 2;
+        for (std::size_t n = last - first; n > 1; n /= 2)
+          ++rounds;
+        while (nth != last && rounds-- != 0) {
+          std::size_t n = last - first;
+          if (n <= execution_impl::min_grain * s.size())
+            break;
+          std::vector<T> sample;
+          sample.reserve(samples);
+          for (std::size_t i = 0; i != samples; ++i)
+            sample.push_back(first[i * (n / samples)]);
+          std::nth_element(sample.begin(), sample.begin() + samples / 2,
+                           sample.end(), comp);
+          const T pivot = sample[samples / 2];
+
+          I lt = parallel_partition(pol, first, last, [&](const T& x) {
+            return comp(x, pivot);
+          });
+          if (nth < lt) {
+            last = lt;
+            continue;
+          }
+          I eq = parallel_partition(pol, lt, last, [&](const T& x) {
+            return !comp(pivot, x);
+          });
+          if (nth < eq)
+            return;
+          first = eq;
+        }
+        std::nth_element(first, nth, last, comp);
+      }
+
+    // The number of elements in each chunk of a parallel shuffle, and the
+    // greatest number of bits in the bucket index of an element.
+    constexpr std::size_t shuffle_chunk = 1 << 14;
+    constexpr unsigned shuffle_bits = 10;
+
+    // Randomly permute [first, last) using the streams of a splitmix64
+    // engine seeded with seed. Each element is assigned to a random bucket,
+    // the elements are scattered into a buffer by bucket, and each bucket is
+    // shuffled. The streams are indexed by chunk and by bucket, whose sizes
+    // depend only on the size of the range, so that the permutation is the
+    // same for any number of threads.
+    template<typename I>
+      void
+      parallel_shuffle(const parallel_policy& pol, I first, I last,
+                       std::uint64_t seed)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        splitmix64 streams(seed);
+        unsigned bits = 0;
+        while (bits != shuffle_bits && (shuffle_chunk << bits) < n)
+          ++bits;
+        if (bits == 0) {
+          splitmix64 g = streams.stream(0);
+          std::shuffle(first, last, g);
+          return;
+        }
+
+        std::size_t buckets = std::size_t(1) << bits;
+        std::size_t chunks = (n + shuffle_chunk - 1) / shuffle_chunk;
+        std::unique_ptr<std::uint16_t[]> ids(new std::uint16_t[n]);
+        std::vector<std::size_t> counts(chunks * buckets);
+        parallel_for(s, chunks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t c = b; c != e; ++c) {
+            splitmix64 g = streams.stream(c);
+            std::size_t* cnt = &counts[c * buckets];
+            std::size_t l = std::min(n, c * shuffle_chunk + shuffle_chunk);
+            for (std::size_t i = c * shuffle_chunk; i != l; ++i)
+              ++cnt[ids[i] = std::uint16_t(g() >> (64 - bits))];
+          }
+        });
+
+        // The offset of each bucket and of the elements of each chunk in
+        // each bucket.
+        std::vector<std::size_t> starts(buckets + 1);
+        std::size_t sum = 0;
+        for (std::size_t j = 0; j != buckets; ++j) {
+          starts[j] = sum;
+          for (std::size_t c = 0; c != chunks; ++c) {
+            std::size_t x = counts[c * buckets + j];
+            counts[c * buckets + j] = sum;
+            sum += x;
+          }
+        }
+        starts[buckets] = n;
+
+        std::unique_ptr<T[]> buf(new T[n]);
+        T* p = buf.get();
+        parallel_for(s, chunks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t c = b; c != e; ++c) {
+            std::size_t* off = &counts[c * buckets];
+            std::size_t l = std::min(n, c * shuffle_chunk + shuffle_chunk);
+            for (std::size_t i = c * shuffle_chunk; i != l; ++i)
+              p[off[ids[i]]++] = std::move(first[i]);
+          }
+        });
+        parallel_for(s, buckets, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j) {
+            splitmix64 g = streams.stream(chunks + j);
+            std::shuffle(p + starts[j], p + starts[j + 1], g);
+            std::move(p + starts[j], p + starts[j + 1], nth(first, starts[j]));
+          }
+        });
+      }
+
+
+    // The number of elements in each block of a parallel sample.
+    constexpr std::size_t sample_chunk = 1 << 14;
+
+    // The weight of each element of an unweighted sample.
+    struct unit_weight
+    {
+      template<typename T>
+        double operator()(const T&) const { return 1.0; }
+    };
+
+    // Sample k elements of [first, last) into a reservoir for each block,
+    // using the streams of a splitmix64 engine seeded with seed, and merge
+    // the reservoirs. The blocks depend only on the size of the range, so
+    // that the sample is the same for any number of threads.
+    template<typename I, typename W>
+      std::vector<Value_type<I>>
+      parallel_sample(const parallel_policy& pol, I first, I last,
+                      std::size_t k, W weight, std::uint64_t seed)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = last - first;
+        std::size_t chunks = (n + sample_chunk - 1) / sample_chunk;
+        splitmix64 streams(seed);
+        std::vector<reservoir<T>> rs(chunks,
+                                     reservoir<T>(std::min(k, sample_chunk)));
+        parallel_for(s, chunks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t c = b; c != e; ++c) {
+            splitmix64 g = streams.stream(c);
+            I l = nth(first, std::min(n, c * sample_chunk + sample_chunk));
+            for (I i = nth(first, c * sample_chunk); i != l; ++i)
+              rs[c].push(*i, g, weight(*i));
+          }
+        });
+        reservoir<T> r(k);
+        for (const reservoir<T>& x : rs)
+          r.merge(x);
+        return r.values();
+      }
+
+
+    // The serial set operations.
+    struct union_op
+    {
+      template<typename I1, typename I2, typename O, typename C>
+        O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp) const
+        {
+          return std::set_union(f1, l1, f2, l2, out, comp);
+        }
+    };
+
+    struct intersection_op
+    {
+      template<typename I1, typename I2, typename O, typename C>
+        O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp) const
+        {
+          return std::set_intersection(f1, l1, f2, l2, out, comp);
+        }
+    };
+
+    struct difference_op
+    {
+      template<typename I1, typename I2, typename O, typename C>
+        O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp) const
+        {
+          return std::set_difference(f1, l1, f2, l2, out, comp);
+        }
+    };
+
+    struct symmetric_difference_op
+    {
+      template<typename I1, typename I2, typename O, typename C>
+        O operator()(I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp) const
+        {
+          return std::set_symmetric_difference(f1, l1, f2, l2, out, comp);
+        }
+    };
+
+    // Divide the sorted ranges [f1, l1) and [f2, l2) into the given number
+    // of blocks, such that block j of each range is [p1[j], p1[j + 1]) and
+    // [p2[j], p2[j + 1]). Both ranges are divided before the same values,
+    // taken at even intervals from the larger range.
+    template<typename I1, typename I2, typename C>
+      void
+      divide_sets(std::size_t blocks, I1 f1, I1 l1, I2 f2, I2 l2, C comp,
+                  std::vector<std::size_t>& p1, std::vector<std::size_t>& p2)
+      {
+        std::size_t n1 = l1 - f1;
+        std::size_t n2 = l2 - f2;
+        p1.assign(1, 0);
+        p2.assign(1, 0);
+        for (std::size_t j = 1; j < blocks; ++j) {
+          I1 m1;
+          I2 m2;
+          if (n1 >= n2) {
+            m1 = std::lower_bound(f1, l1, *nth(f1, j * n1 / blocks), comp);
+            m2 = std::lower_bound(f2, l2, *m1, comp);
+          } else {
+            m2 = std::lower_bound(f2, l2, *nth(f2, j * n2 / blocks), comp);
+            m1 = std::lower_bound(f1, l1, *m2, comp);
+          }
+          p1.push_back(m1 - f1);
+          p2.push_back(m2 - f2);
+        }
+        p1.push_back(n1);
+        p2.push_back(n2);
+      }
+
+    template<typename Op, typename I1, typename I2, typename O, typename C>
+      O
+      parallel_set_op(const parallel_policy& pol, Op op,
+                      I1 f1, I1 l1, I2 f2, I2 l2, O out, C comp)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = (l1 - f1) + (l2 - f2);
+        std::size_t blocks = std::max<std::size_t>(1, n / grain(s, n));
+        std::vector<std::size_t> p1, p2;
+        divide_sets(blocks, f1, l1, f2, l2, comp, p1, p2);
+
+        // Count the output of each block, and compute their offsets.
+        std::vector<std::size_t> offs(blocks + 1);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            op(nth(f1, p1[j]), nth(f1, p1[j + 1]),
+               nth(f2, p2[j]), nth(f2, p2[j + 1]),
+               counting_output(offs[j + 1]), comp);
+        });
+        for (std::size_t j = 0; j != blocks; ++j)
+          offs[j + 1] += offs[j];
+
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            op(nth(f1, p1[j]), nth(f1, p1[j + 1]),
+               nth(f2, p2[j]), nth(f2, p2[j + 1]),
+               nth(out, offs[j]), comp);
+        });
+        return nth(out, offs[blocks]);
+      }
+
+    template<typename I1, typename I2, typename C>
+      bool
+      parallel_includes(const parallel_policy& pol,
+                        I1 f1, I1 l1, I2 f2, I2 l2, C comp)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t n = (l1 - f1) + (l2 - f2);
+        std::size_t blocks = std::max<std::size_t>(1, n / grain(s, n));
+        std::vector<std::size_t> p1, p2;
+        divide_sets(blocks, f1, l1, f2, l2, comp, p1, p2);
+
+        std::atomic<bool> result(true);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (std::size_t j = b; j != e; ++j)
+            if (result.load(std::memory_order_relaxed)
+                && !std::includes(nth(f1, p1[j]), nth(f1, p1[j + 1]),
+                                  nth(f2, p2[j]), nth(f2, p2[j + 1]), comp))
+              result.store(false, std::memory_order_relaxed);
+        });
+        return result.load();
+      }
+
+  } // namespace algorithm_impl
+
+
+  // Quantifiers
+  template<typename R, typename P>
+    inline bool
+    all_of(parallel_policy pol, const R& range, P pred)
+    {
+      static_assert(Random_access_range<const R>(), "");
+      using std::begin;
+      using std::end;
+      algorithm_impl::not_pred<P> not_pred{pred};
+      return !algorithm_impl::parallel_any_of(pol, begin(range), end(range),
+                                              not_pred);
+    }
+
+  template<typename R, typename P>
+    inline bool
+    any_of(parallel_policy pol, const R& range, P pred)
+    {
+      static_assert(Random_access_range<const R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_any_of(pol, begin(range), end(range),
+                                             pred);
+    }
+
+  template<typename R, typename P>
+    inline bool
+    none_of(parallel_policy pol, const R& range, P pred)
+    {
+      return !any_of(pol, range, pred);
+    }
+
+  // For each
+  template<typename R, typename F>
+    inline F
+    for_each(parallel_policy pol, R&& range, F f)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      std::size_t n = end(range) - first;
+      execution_impl::parallel_for(pol.scheduler(), n,
+                                   algorithm_impl::grain(pol, n),
+        [&](std::size_t b, std::size_t e) {
+          std::for_each(algorithm_impl::nth(first, b),
+                        algorithm_impl::nth(first, e), f);
+        });
+      return f;
+    }
+
+  template<typename R, typename F>
+    inline F
+    for_each_index(parallel_policy pol, R&& range, F f)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      std::size_t n = end(range) - first;
+      execution_impl::parallel_for(pol.scheduler(), n,
+                                   algorithm_impl::grain(pol, n),
+        [&](std::size_t b, std::size_t e) {
+          F g = f;
+          auto i = algorithm_impl::nth(first, b);
+          for (; b != e; ++b, ++i)
+            g(b, *i);
+        });
+      return f;
+    }
+
+  // Find
+  template<typename R, typename T>
+    inline Iterator_of<R>
+    find(parallel_policy pol, R&& range, const T& value)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_find_if(pol, begin(range), end(range),
+               algorithm_impl::equal_to_value<T>{value});
+    }
+
+  template<typename R, typename P>
+    inline Iterator_of<R>
+    find_if(parallel_policy pol, R&& range, P pred)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_find_if(pol, begin(range), end(range),
+                                              pred);
+    }
+
+  template<typename R, typename P>
+    inline Iterator_of<R>
+    find_if_not(parallel_policy pol, R&& range, P pred)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_find_if(pol, begin(range), end(range),
+               algorithm_impl::not_pred<P>{pred});
+    }
+
+  // Count
+  template<typename R, typename T>
+    inline Difference_type<R>
+    count(parallel_policy pol, const R& range, const T& value)
+    {
+      static_assert(Random_access_range<const R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_count_if(pol, begin(range), end(range),
+               algorithm_impl::equal_to_value<T>{value});
+    }
+
+  template<typename R, typename P>
+    inline Difference_type<R>
+    count_if(parallel_policy pol, const R& range, P pred)
+    {
+      static_assert(Random_access_range<const R>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_count_if(pol, begin(range), end(range),
+                                               pred);
+    }
+
+  // Copy
+  template<typename R1, typename R2>
+    inline Iterator_of<R2>
+    copy(parallel_policy pol, const R1& range1, R2&& range2)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_copy(
+        pol, begin(range1), end(range1), begin(range2),
+        algorithm_impl::Stream_copy<const R1&, R2>());
+    }
+
+  // Move
+  template<typename R1, typename R2>
+    inline Iterator_of<R2>
+    move(parallel_policy pol, R1&& range1, R2&& range2)
+    {
+      static_assert(Random_access_range<R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      return algorithm_impl::parallel_move(
+        pol, begin(range1), end(range1), begin(range2),
+        algorithm_impl::Stream_copy<R1, R2>());
+    }
+
+  template<typename R1, typename R2, typename P>
+    inline Iterator_of<R2>
+    copy_if(parallel_policy pol, const R1& range1, R2&& range2, P pred)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using O = Iterator_of<R2>;
+      auto first = begin(range1);
+      auto out = begin(range2);
+      std::size_t k = algorithm_impl::parallel_compact(
+        pol, first, std::size_t(end(range1) - first), out,
+        [&](I i, I j) { return std::count_if(i, j, pred); },
+        [&](I i, I j, O o) { return std::copy_if(i, j, o, pred); });
+      return algorithm_impl::nth(out, k);
+    }
+
+  // Remove
+  template<typename R, typename T>
+    inline Iterator_of<R>
+    remove(parallel_policy pol, R&& range, const T& value)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      using V = Value_type<I>;
+      using Simd = algorithm_impl::Simd_range_search<R, T>;
+      return algorithm_impl::parallel_remove(pol, begin(range), end(range),
+        [&](I i, I j) {
+          return (j - i) - algorithm_impl::count_match(i, j, value, Simd());
+        },
+        [&](I i, I j, V* o) {
+          return algorithm_impl::remove_move(i, j, o, value, Simd());
+        },
+        [&](I i, I j) {
+          return algorithm_impl::remove_match(i, j, value, Simd());
+        });
+    }
+
+  template<typename R, typename P>
+    inline Iterator_of<R>
+    remove_if(parallel_policy pol, R&& range, P pred)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      using V = Value_type<I>;
+      return algorithm_impl::parallel_remove(pol, begin(range), end(range),
+        [&](I i, I j) { return (j - i) - std::count_if(i, j, pred); },
+        [&](I i, I j, V* o) {
+          return algorithm_impl::remove_move_if(i, j, o, pred);
+        },
+        [&](I i, I j) { return std::remove_if(i, j, pred); });
+    }
+
+  template<typename R1, typename R2, typename T>
+    inline Iterator_of<R2>
+    remove_copy(parallel_policy pol, const R1& range1, R2&& range2,
+                const T& value)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using O = Iterator_of<R2>;
+      using Search = algorithm_impl::Simd_range_search<const R1&, T>;
+      using Simd = algorithm_impl::Simd_range_remove<const R1&, R2, T>;
+      auto first = begin(range1);
+      auto out = begin(range2);
+      std::size_t k = algorithm_impl::parallel_compact(
+        pol, first, std::size_t(end(range1) - first), out,
+        [&](I i, I j) {
+          return (j - i) - algorithm_impl::count_match(i, j, value, Search());
+        },
+        [&](I i, I j, O o) {
+          return algorithm_impl::remove_copy_match(i, j, o, value, Simd());
+        });
+      return algorithm_impl::nth(out, k);
+    }
+
+  template<typename R1, typename R2, typename P>
+    inline Iterator_of<R2>
+    remove_copy_if(parallel_policy pol, const R1& range1, R2&& range2,
+                   P pred)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using O = Iterator_of<R2>;
+      auto first = begin(range1);
+      auto out = begin(range2);
+      std::size_t k = algorithm_impl::parallel_compact(
+        pol, first, std::size_t(end(range1) - first), out,
+        [&](I i, I j) { return (j - i) - std::count_if(i, j, pred); },
+        [&](I i, I j, O o) {
+          return std::remove_copy_if(i, j, o, pred);
+        });
+      return algorithm_impl::nth(out, k);
+    }
+
+  // Run-length encoding
+  template<typename R1, typename R2, typename R3, typename E>
+    inline std::pair<Iterator_of<R2>, Iterator_of<R3>>
+    run_length_encode(parallel_policy pol, const R1& range, R2&& values,
+                      R3&& counts, E eq)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      std::size_t k = algorithm_impl::parallel_run_length_encode(
+        pol, first, std::size_t(end(range) - first), begin(values),
+        begin(counts), eq, std::false_type());
+      return {algorithm_impl::nth(begin(values), k),
+              algorithm_impl::nth(begin(counts), k)};
+    }
+
+  template<typename R1, typename R2, typename R3>
+    inline std::pair<Iterator_of<R2>, Iterator_of<R3>>
+    run_length_encode(parallel_policy pol, const R1& range, R2&& values,
+                      R3&& counts)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      std::size_t k = algorithm_impl::parallel_run_length_encode(
+        pol, first, std::size_t(end(range) - first), begin(values),
+        begin(counts), algorithm_impl::equal_values(),
+        algorithm_impl::Simd_range_runs<const R1&>());
+      return {algorithm_impl::nth(begin(values), k),
+              algorithm_impl::nth(begin(counts), k)};
+    }
+
+  // Distinct values
+  template<typename R, typename H>
+    inline Iterator_of<R>
+    hash_unique(parallel_policy pol, R&& range, H hash)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      using V = Value_type<I>;
+      I first = begin(range);
+      I last = end(range);
+      std::size_t n = last - first;
+      if (n <= algorithm_impl::grain(pol, n) || pol.scheduler().size() == 1)
+        return algorithm_impl::hash_unique(first, last, hash);
+      std::vector<char> keep =
+        algorithm_impl::parallel_first_occurrences(pol, first, n, hash);
+      return algorithm_impl::parallel_remove(pol, first, last,
+        [&](I i, I j) {
+          return std::count(keep.data() + (i - first),
+                            keep.data() + (j - first), true);
+        },
+        [&](I i, I j, V* o) {
+          for (; i != j; ++i)
+            if (keep[i - first])
+              *o++ = std::move(*i);
+          return o;
+        },
+        [&](I i, I j) { return algorithm_impl::hash_unique(i, j, hash); });
+    }
+
+  template<typename R>
+    inline Iterator_of<R>
+    hash_unique(parallel_policy pol, R&& range)
+    {
+      return hash_unique(pol, std::forward<R>(range),
+                         algorithm_impl::hash_value());
+    }
+
+  template<typename R1, typename R2, typename H>
+    inline Iterator_of<R2>
+    distinct(parallel_policy pol, const R1& range1, R2&& range2, H hash)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using O = Iterator_of<R2>;
+      I first = begin(range1);
+      O out = begin(range2);
+      std::size_t n = end(range1) - first;
+      if (n <= algorithm_impl::grain(pol, n) || pol.scheduler().size() == 1)
+        return algorithm_impl::distinct(first, end(range1), out, hash);
+      std::vector<char> keep =
+        algorithm_impl::parallel_first_occurrences(pol, first, n, hash);
+      std::size_t k = algorithm_impl::parallel_compact(pol, first, n, out,
+        [&](I i, I j) {
+          return std::count(keep.data() + (i - first),
+                            keep.data() + (j - first), true);
+        },
+        [&](I i, I j, O o) {
+          for (; i != j; ++i)
+            if (keep[i - first]) {
+              *o = *i;
+              ++o;
+            }
+          return o;
+        });
+      return algorithm_impl::nth(out, k);
+    }
+
+  template<typename R1, typename R2>
+    inline Iterator_of<R2>
+    distinct(parallel_policy pol, const R1& range1, R2&& range2)
+    {
+      return distinct(pol, range1, std::forward<R2>(range2),
+                      algorithm_impl::hash_value());
+    }
+
+  // Fill
+  template<typename R, typename T>
+    inline void
+    fill(parallel_policy pol, R&& range, const T& value)
+    {
+      static_assert(Random_access_range<R>(), "");
+      using std::begin;
+      using std::end;
+      algorithm_impl::parallel_fill(pol, begin(range), end(range), value,
+                                    algorithm_impl::Stream_fill<R, T>());
+    }
+
+  // Transform
+  template<typename R1, typename R2, typename Op>
+    inline Iterator_of<R2>
+    range_transform(parallel_policy pol,
+                    const R1& range1, R2&& range2, Op op)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using algorithm_impl::nth;
+      auto first = begin(range1);
+      auto out = begin(range2);
+      std::size_t n = end(range1) - first;
+      execution_impl::parallel_for(pol.scheduler(), n,
+                                   algorithm_impl::grain(pol, n),
+        [&](std::size_t b, std::size_t e) {
+          std::transform(nth(first, b), nth(first, e), nth(out, b), op);
+        });
+      return nth(out, n);
+    }
+
+  template<typename R1, typename R2, typename R3, typename Op>
+    inline Iterator_of<R3>
+    range_transform(parallel_policy pol,
+                    const R1& range1, const R2& range2, R3&& range3, Op op)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
+      using std::begin;
+      using std::end;
+      using algorithm_impl::nth;
+      auto first1 = begin(range1);
+      auto first2 = begin(range2);
+      auto out = begin(range3);
+      std::size_t n = end(range1) - first1;
+      execution_impl::parallel_for(pol.scheduler(), n,
+                                   algorithm_impl::grain(pol, n),
+        [&](std::size_t b, std::size_t e) {
+          std::transform(nth(first1, b), nth(first1, e), nth(first2, b),
+                         nth(out, b), op);
+        });
+      return nth(out, n);
+    }
+
+  namespace algorithm_impl
+  {
+    // Write the totals of [first, first + n) to out, inclusive or
+    // exclusive of each element, starting from the total init if there is
+    // one.
+    template<typename I, typename O, typename Op, typename T, typename Simd>
+      void
+      parallel_scan(const parallel_policy& pol, I first, std::size_t n, O out,
+                    Op op, const T* init, bool inclusive, Simd simd)
+      {
+        task_scheduler& s = pol.scheduler();
+        std::size_t g = grain(pol, n);
+        std::size_t blocks = (n + g - 1) / g;
+        if (blocks <= 1) {
+          if (init)
+            scan_from(first, nth(first, n), out, op, *init, inclusive, simd);
+          else
+            inclusive_scan(first, nth(first, n), out, op, simd);
+          return;
+        }
+
+        std::vector<T> sums(blocks);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            I i = nth(first, b * g);
+            I j = nth(first, std::min(n, (b + 1) * g));
+            sums[b] = std::accumulate(std::next(i), j, T(*i), op);
+          }
+        });
+
+        // The carry into each block is the total of the blocks before it.
+        std::vector<T> carries(blocks);
+        T total = init ? *init : sums[0];
+        for (std::size_t b = init ? 0 : 1; b != blocks; ++b) {
+          carries[b] = total;
+          total = op(total, sums[b]);
+        }
+
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            I i = nth(first, b * g);
+            I j = nth(first, std::min(n, (b + 1) * g));
+            if (b == 0 && !init)
+              inclusive_scan(i, j, out, op, simd);
+            else
+              scan_from(i, j, nth(out, b * g), op, carries[b], inclusive,
+                        simd);
+          }
+        });
+      }
+
+    template<typename I, typename H, typename O, typename Op>
+      void
+      parallel_segmented_scan(const parallel_policy& pol, I first,
+                              std::size_t n, H heads, O out, Op op)
+      {
+        using T = Value_type<I>;
+        task_scheduler& s = pol.scheduler();
+        std::size_t g = grain(pol, n);
+        std::size_t blocks = (n + g - 1) / g;
+
+        // The total of the last segment of each block, and whether the
+        // block has a head.
+        std::vector<T> sums(blocks);
+        std::vector<char> headed(blocks);
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            std::size_t i = b * g;
+            std::size_t j = std::min(n, (b + 1) * g);
+            T x = *nth(first, i);
+            bool h = *nth(heads, i);
+            for (std::size_t k = i + 1; k != j; ++k) {
+              if (*nth(heads, k)) {
+                x = *nth(first, k);
+                h = true;
+              } else {
+                x = op(x, *nth(first, k));
+              }
+            }
+            sums[b] = x;
+            headed[b] = h;
+          }
+        });
+
+        std::vector<T> carries(blocks);
+        T total = sums[0];
+        for (std::size_t b = 1; b != blocks; ++b) {
+          carries[b] = total;
+          total = headed[b] ? sums[b] : op(total, sums[b]);
+        }
+
+        parallel_for(s, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b) {
+            std::size_t i = b * g;
+            std::size_t j = std::min(n, (b + 1) * g);
+            bool there = b != 0;
+            segmented_scan_from(nth(first, i), nth(first, j), nth(heads, i),
+                                nth(out, i), op, carries[b], there);
+          }
+        });
+      }
+
+    // Returns the combination of the n > 0 values of v by a balanced tree of
+    // calls to op, combining adjacent values.
+    template<typename T, typename Op>
+      T
+      reduce_tree(std::vector<T>& v, Op op)
+      {
+        std::size_t n = v.size();
+        while (n > 1) {
+          std::size_t k = 0;
+          for (std::size_t i = 0; i + 1 < n; i += 2)
+            v[k++] = op(v[i], v[i + 1]);
+          if (n % 2 != 0)
+            v[k++] = v[n - 1];
+          n = k;
+        }
+        return v[0];
+      }
+
+    // Returns the combination of init and the n values whose subranges
+    // [b, e) are combined by block(b, e).
+    template<typename T, typename Op, typename B>
+      T
+      parallel_reduce(const parallel_policy& pol, std::size_t n, T init,
+                      Op op, B block)
+      {
+        if (n == 0)
+          return init;
+        task_scheduler& s = pol.scheduler();
+        std::size_t g = grain(pol, n);
+        std::size_t blocks = (n + g - 1) / g;
+        std::vector<T> sums(blocks);
+        std::size_t k = std::max<std::size_t>(1, blocks / (8 * s.size()));
+        parallel_for(s, blocks, k, [&](std::size_t b, std::size_t e) {
+          for (; b != e; ++b)
+            sums[b] = block(b * g, std::min(n, (b + 1) * g));
+        });
+        return op(init, reduce_tree(sums, op));
+      }
+  } // namespace algorithm_impl
+
+  // Scans
+  template<typename R1, typename R2, typename Op>
+    inline Iterator_of<R2>
+    inclusive_scan(parallel_policy pol, const R1& range1, R2&& range2, Op op)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using T = Value_type<Iterator_of<const R1>>;
+      using S = std::integral_constant<
+        bool, algorithm_impl::Simd_scan<const R1&, R2, Op>()>;
+      auto first = begin(range1);
+      std::size_t n = end(range1) - first;
+      auto out = begin(range2);
+      if (n != 0)
+        algorithm_impl::parallel_scan(pol, first, n, out, op,
+                                      static_cast<const T*>(nullptr), true,
+                                      S());
+      return algorithm_impl::nth(out, n);
+    }
+
+  template<typename R1, typename R2>
+    inline Iterator_of<R2>
+    inclusive_scan(parallel_policy pol, const R1& range1, R2&& range2)
+    {
+      return inclusive_scan(pol, range1, std::forward<R2>(range2),
+                            std::plus<Value_type<Iterator_of<const R1>>>());
+    }
+
+  template<typename R1, typename R2, typename T, typename Op>
+    inline Iterator_of<R2>
+    exclusive_scan(parallel_policy pol, const R1& range1, R2&& range2,
+                   const T& init, Op op)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      using V = Value_type<Iterator_of<const R1>>;
+      using S = std::integral_constant<
+        bool, algorithm_impl::Simd_scan<const R1&, R2, Op>()>;
+      auto first = begin(range1);
+      std::size_t n = end(range1) - first;
+      auto out = begin(range2);
+      V x(init);
+      if (n != 0)
+        algorithm_impl::parallel_scan(pol, first, n, out, op, &x, false, S());
+      return algorithm_impl::nth(out, n);
+    }
+
+  template<typename R1, typename R2, typename T>
+    inline Iterator_of<R2>
+    exclusive_scan(parallel_policy pol, const R1& range1, R2&& range2,
+                   const T& init)
+    {
+      return exclusive_scan(pol, range1, std::forward<R2>(range2), init,
+                            std::plus<Value_type<Iterator_of<const R1>>>());
+    }
+
+  template<typename R1, typename H, typename R2, typename Op>
+    inline Iterator_of<R2>
+    segmented_scan(parallel_policy pol, const R1& range1, const H& heads,
+                   R2&& range2, Op op)
+    {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const H>(), "");
+      static_assert(Random_access_range<R2>(), "");
+      using std::begin;
+      using std::end;
+      auto first = begin(range1);
+      std::size_t n = end(range1) - first;
+      auto out = begin(range2);
+      if (n != 0)
+        algorithm_impl::parallel_segmented_scan(pol, first, n, begin(heads),
+                                                out, op);
+      return algorithm_impl::nth(out, n);
+    }
+
+  template<typename R1, typename H, typename R2>
+    inline Iterator_of<R2>
+    segmented_scan(parallel_policy pol, const R1& range1, const H& heads,
+                   R2&& range2)
+    {
+      return segmented_scan(pol, range1, heads, std::forward<R2>(range2),
+                            std::plus<Value_type<Iterator_of<const R1>>>());
+    }
+
+  // Reductions
+  template<typename R, typename T, typename Op>
+    inline T
+    reduce(parallel_policy pol, const R& range, T init, Op op)
+    {
+      static_assert(Random_access_range<const R>(), "");
+      using std::begin;
+      using std::end;
+      using L = std::integral_constant<
+        bool, algorithm_impl::Lane_reduce<T, Op>()>;
+      using S = std::integral_constant<
+        bool, algorithm_impl::Simd_reduce<const R&, T, Op>()>;
+      auto first = begin(range);
+      std::size_t n = end(range) - first;
+      return algorithm_impl::parallel_reduce(pol, n, init, op,
+        [&](std::size_t b, std::size_t e) {
+          return algorithm_impl::reduce_block<T>(algorithm_impl::nth(first, b),
+                                                 e - b, op, L(), S());
+        });
+    }
+
+  template<typename R, typename T>
+    inline T
+    reduce(parallel_policy pol, const R& range, T init)
+    {
+      return reduce(pol, range, init, std::plus<T>());
     }
 
-
-  template <typename R1, typename R2, typename R3>
-    inline Iterator_of<R3>
-    set_union(const R1& range1, const R2& range2, R3&& result)
+  template<typename R, typename T, typename Op, typename F>
+    inline T
+    transform_reduce(parallel_policy pol, const R& range, T init, Op op, F f)
     {
+      static_assert(Random_access_range<const R>(), "");
       using std::begin;
       using std::end;
-      return std::set_union(begin(range1), end(range1), 
-                            begin(range2), end(range2),
-                            begin(result));
+      using L = std::integral_constant<
+        bool, algorithm_impl::Lane_reduce<T, Op>()>;
+      auto first = begin(range);
+      std::size_t n = end(range) - first;
+      return algorithm_impl::parallel_reduce(pol, n, init, op,
+        [&](std::size_t b, std::size_t e) {
+          auto i = algorithm_impl::nth(first, b);
+          return algorithm_impl::reduce_values<T>(
+            e - b, op, [&]() { return f(*i++); }, L());
+        });
     }
 
-  template <typename R1, typename R2, typename R3, typename C>
-    inline Iterator_of<R3>
-    set_union(const R1& range1, const R2& range2, R3&& result, C comp)
+  template<typename R1, typename R2, typename T, typename Op1, typename Op2>
+    inline T
+    transform_reduce(parallel_policy pol, const R1& range1, const R2& range2,
+                     T init, Op1 op1, Op2 op2)
     {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
       using std::begin;
       using std::end;
-      return std::set_union(begin(range1), end(range1), 
-                            begin(range2), end(range2),
-                            begin(result),
-                            comp);
+      using L = std::integral_constant<
+        bool, algorithm_impl::Lane_reduce<T, Op1>()>;
+      auto first1 = begin(range1);
+      auto first2 = begin(range2);
+      std::size_t n = end(range1) - first1;
+      return algorithm_impl::parallel_reduce(pol, n, init, op1,
+        [&](std::size_t b, std::size_t e) {
+          auto i = algorithm_impl::nth(first1, b);
+          auto j = algorithm_impl::nth(first2, b);
+          return algorithm_impl::reduce_values<T>(
+            e - b, op1, [&]() { return op2(*i++, *j++); }, L());
+        });
     }
 
+  template<typename R1, typename R2, typename T>
+    inline T
+    transform_reduce(parallel_policy pol, const R1& range1, const R2& range2,
+                     T init)
+    {
+      return transform_reduce(pol, range1, range2, init, std::plus<T>(),
+                              std::multiplies<T>());
+    }
 
-  template <typename R1, typename R2, typename R3>
-    inline Iterator_of<R3>
-    set_intersection(const R1& range1, const R2& range2, R3&& result)
+  // Sorting
+  template<typename R, typename C>
+    inline void
+    sort(parallel_policy pol, R&& range, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::set_intersection(begin(range1), end(range1), 
-                                   begin(range2), end(range2),
-                                   begin(result));
+      using I = Iterator_of<R>;
+      algorithm_impl::parallel_sort_dispatch(
+        pol, begin(range), end(range), comp, false,
+        algorithm_impl::Radix_sortable<I, C>());
     }
 
-  template <typename R1, typename R2, typename R3, typename C>
-    inline Iterator_of<R3>
-    set_intersection(const R1& range1, const R2& range2, R3&& result, C comp)
+  template<typename R>
+    inline void
+    sort(parallel_policy pol, R&& range)
+    {
+      sort(pol, std::forward<R>(range), algorithm_impl::less_than());
+    }
+
+  template<typename R, typename C>
+    inline void
+    stable_sort(parallel_policy pol, R&& range, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::set_intersection(begin(range1), end(range1), 
-                                   begin(range2), end(range2),
-                                   begin(result),
-                                   comp);
+      using I = Iterator_of<R>;
+      algorithm_impl::parallel_sort_dispatch(
+        pol, begin(range), end(range), comp, true,
+        algorithm_impl::Radix_stable_sortable<I, C>());
     }
 
+  template<typename R>
+    inline void
+    stable_sort(parallel_policy pol, R&& range)
+    {
+      stable_sort(pol, std::forward<R>(range), algorithm_impl::less_than());
+    }
 
-  template <typename R1, typename R2, typename R3>
-    inline Iterator_of<R3>
-    set_difference(const R1& range1, const R2& range2, R3&& result)
+  template<typename R1, typename R2, typename C>
+    inline void
+    sort_by_key(parallel_policy pol, R1&& keys, R2&& values, C comp)
     {
+      static_assert(Random_access_range<R1>(), "");
+      static_assert(Random_access_range<R2>(), "");
       using std::begin;
       using std::end;
-      return std::set_difference(begin(range1), end(range1), 
-                                 begin(range2), end(range2),
-                                 begin(result));
+      algorithm_impl::parallel_sort_by_key(pol, begin(keys), end(keys),
+                                           begin(values), comp);
     }
 
-  template <typename R1, typename R2, typename R3, typename C>
-    inline Iterator_of<R3>
-    set_difference(const R1& range1, const R2& range2, R3&& result, C comp)
+  template<typename R1, typename R2>
+    inline void
+    sort_by_key(parallel_policy pol, R1&& keys, R2&& values)
     {
-      using std::begin;
-      using std::end;
-      return std::set_difference(begin(range1), end(range1), 
-                                 begin(range2), end(range2),
-                                 begin(result),
-                                 comp);
+      sort_by_key(pol, std::forward<R1>(keys), std::forward<R2>(values),
+                  algorithm_impl::less_than());
     }
 
-  template <typename R1, typename R2, typename R3>
-    inline Iterator_of<R3>
-    set_symmetric_difference(const R1& range1, const R2& range2, R3&& result)
+  template<typename R, typename C>
+    inline std::vector<Value_type<Iterator_of<R>>>
+    top_k(parallel_policy pol, const R& range, std::size_t k, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::set_difference(begin(range1), end(range1), 
-                                 begin(range2), end(range2),
-                                 begin(result));
+      return algorithm_impl::parallel_top_k(pol, begin(range), end(range), k,
+                                            comp);
     }
 
-  template <typename R1, typename R2, typename R3, typename C>
-    inline Iterator_of<R3>
-    set_symmetric_difference(const R1& range1, const R2& range2, R3&& result, C comp)
+  template<typename R>
+    inline std::vector<Value_type<Iterator_of<R>>>
+    top_k(parallel_policy pol, const R& range, std::size_t k)
+    {
+      return top_k(pol, range, k, algorithm_impl::less_than());
+    }
+
+  template<typename R, typename K>
+    inline std::vector<std::size_t>
+    histogram(parallel_policy pol, const R& range, std::size_t bins, K key)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::set_symmetric_difference(begin(range1), end(range1), 
-                                           begin(range2), end(range2),
-                                           begin(result),
-                                           comp);
+      return algorithm_impl::parallel_histogram(pol, begin(range), end(range),
+                                                bins, key);
     }
 
-  //////////////////////////////////////////////////////////////////////////////
-  // Heap Operations
+  template<typename R>
+    inline std::vector<std::size_t>
+    histogram(parallel_policy pol, const R& range, std::size_t bins)
+    {
+      return histogram(pol, range, bins, algorithm_impl::radix_identity());
+    }
 
-  template <typename R>
-    inline void 
-    push_heap(R&& range)
+  template<typename R, typename K>
+    inline std::vector<std::size_t>
+    counting_sort(parallel_policy pol, R&& range, std::size_t bins, K key)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      std::push_heap(begin(range), end(range));
+      return algorithm_impl::parallel_counting_sort(pol, begin(range),
+                                                    end(range), bins, key);
     }
 
-  template <typename R, typename C>
-    inline void
-    push_heap(R&& range, C comp)
+  template<typename R>
+    inline std::vector<std::size_t>
+    counting_sort(parallel_policy pol, R&& range, std::size_t bins)
     {
-      using std::begin;
-      using std::end;
-      std::push_heap(begin(range), end(range), comp);
+      return counting_sort(pol, std::forward<R>(range), bins,
+                           algorithm_impl::radix_identity());
     }
 
-  template <typename R>
-    inline void
-    pop_heap(R&& range)
+  template<typename R, typename K, typename C>
+    std::vector<std::size_t>
+    bucket_sort(parallel_policy pol, R&& range, std::size_t bins, K key,
+                C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      std::pop_heap(begin(range), end(range));
+      auto first = begin(range);
+      auto off = algorithm_impl::parallel_counting_sort(pol, first,
+                                                        end(range), bins, key);
+      execution_impl::parallel_for(pol.scheduler(), bins, 1,
+        [&](std::size_t b, std::size_t e) {
+          algorithm_impl::sort_bins(first, off, b, e, comp);
+        });
+      return off;
     }
 
-  template <typename R, typename C>
-    inline void
-    pop_heap(R&& range, C comp)
+  template<typename R, typename K>
+    inline std::vector<std::size_t>
+    bucket_sort(parallel_policy pol, R&& range, std::size_t bins, K key)
     {
-      using std::begin;
-      using std::end;
-      std::pop_heap(begin(range), end(range), comp);
+      return bucket_sort(pol, std::forward<R>(range), bins, key,
+                         algorithm_impl::less_than());
     }
 
-  template <typename R>
+  template<typename R>
     inline void
-    make_heap(R&& range)
+    radix_sort(parallel_policy pol, R&& range)
     {
+      static_assert(Random_access_range<R>(), "");
+      static_assert(algorithm_impl::Radix_key<Value_type<Iterator_of<R>>>(),
+                    "the values of the range are not radix keys");
       using std::begin;
       using std::end;
-      std::make_heap(begin(range), end(range));
+      algorithm_impl::parallel_radix_sort(pol, begin(range), end(range),
+                                          algorithm_impl::radix_identity());
     }
 
-  template <typename R, typename C>
+  template<typename R, typename K>
     inline void
-    make_heap(R&& range, C comp)
+    radix_sort(parallel_policy pol, R&& range, K key)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      std::make_heap(begin(range), end(range), comp);
+      using Key = Decay<decltype(key(*begin(range)))>;
+      static_assert(algorithm_impl::Radix_key<Key>(),
+                    "the key function does not return radix keys");
+      algorithm_impl::parallel_radix_sort(pol, begin(range), end(range), key);
     }
 
-  template <typename R>
+  template<typename R, typename C>
     inline void
-    sort_heap(R&& range)
+    partial_sort(parallel_policy pol, R&& range, Iterator_of<R> middle,
+                 C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      std::sort_heap(begin(range), end(range));
+      using I = Iterator_of<R>;
+      algorithm_impl::parallel_nth_element(pol, begin(range), middle,
+                                           end(range), comp);
+      algorithm_impl::parallel_sort_dispatch(
+        pol, begin(range), middle, comp, false,
+        algorithm_impl::Radix_sortable<I, C>());
     }
 
-  template <typename R, typename C>
+  template<typename R>
     inline void
-    sort_heap(R&& range, C comp)
+    partial_sort(parallel_policy pol, R&& range, Iterator_of<R> middle)
     {
-      using std::begin;
-      using std::end;
-      std::sort_heap(begin(range), end(range), comp);
+      partial_sort(pol, std::forward<R>(range), middle,
+                   algorithm_impl::less_than());
     }
 
-  template <typename R>
-    inline bool
-    is_heap(R&& range)
+  template<typename R, typename C>
+    inline void
+    nth_element(parallel_policy pol, R&& range, Iterator_of<R> nth, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::is_heap(begin(range), end(range));
+      algorithm_impl::parallel_nth_element(pol, begin(range), nth,
+                                           end(range), comp);
     }
 
-  template <typename R, typename C>
-    inline bool
-    is_heap(R&& range, C comp)
+  template<typename R>
+    inline void
+    nth_element(parallel_policy pol, R&& range, Iterator_of<R> nth)
     {
-      using std::begin;
-      using std::end;
-      return std::is_heap(begin(range), end(range), comp);
+      nth_element(pol, std::forward<R>(range), nth,
+                  algorithm_impl::less_than());
     }
 
-  template <typename R>
+  // Partitions
+  template<typename R, typename P>
     inline Iterator_of<R>
-    is_heap_until(R&& range)
+    partition(parallel_policy pol, R&& range, P pred)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::is_heap_until(begin(range), end(range));
+      return algorithm_impl::parallel_partition(pol, begin(range), end(range),
+                                                pred);
     }
 
-  template <typename R, typename C>
+  template<typename R, typename P>
     inline Iterator_of<R>
-    is_heap_until(R&& range, C comp)
+    stable_partition(parallel_policy pol, R&& range, P pred)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::is_heap_until(begin(range), end(range), comp);
+      return algorithm_impl::parallel_stable_partition(pol, begin(range),
+                                                       end(range), pred);
     }
 
-
-
-  //////////////////////////////////////////////////////////////////////////////
-  // Min and Max
-
-  template <typename R>
-    inline Iterator_of<R>
-    min_element(R&& range)
+  // Shuffle
+  template<typename R, typename Gen>
+    inline void
+    shuffle(parallel_policy pol, R&& range, Gen&& gen)
     {
+      static_assert(Random_access_range<R>(), "");
+      static_assert(Uniform_random_number_generator<Gen>(), "");
       using std::begin;
       using std::end;
-      return std::min_element(begin(range), end(range));
+      algorithm_impl::parallel_shuffle(pol, begin(range), end(range),
+                                       random_impl::random_bits(gen));
     }
 
-  template <typename R, typename C>
-    inline Iterator_of<R>
-    min_element(R&& range, C comp)
+  // Sample
+  template<typename R, typename Gen>
+    inline std::vector<Value_type<Iterator_of<R>>>
+    sample(parallel_policy pol, R&& range, std::size_t k, Gen&& gen)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::min_element(begin(range), end(range), comp);
+      return algorithm_impl::parallel_sample(pol, begin(range), end(range), k,
+                                             algorithm_impl::unit_weight(),
+                                             random_impl::random_bits(gen));
     }
 
-  template <typename R>
-    inline Iterator_of<R>
-    max_element(R&& range)
+  template<typename R, typename W, typename Gen>
+    inline std::vector<Value_type<Iterator_of<R>>>
+    weighted_sample(parallel_policy pol, R&& range, std::size_t k, W weight,
+                    Gen&& gen)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::max_element(begin(range), end(range));
+      return algorithm_impl::parallel_sample(pol, begin(range), end(range), k,
+                                             weight,
+                                             random_impl::random_bits(gen));
     }
 
-  template <typename R, typename C>
-    inline Iterator_of<R>
-    max_element(R&& range, C comp)
+  // Merge
+  template<typename R1, typename R2, typename R3, typename C>
+    inline Iterator_of<R3>
+    merge(parallel_policy pol,
+          const R1& range1, const R2& range2, R3&& range3, C comp)
     {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
       using std::begin;
       using std::end;
-      return std::max_element(begin(range), end(range), comp);
+      return algorithm_impl::parallel_merge(pol, begin(range1), end(range1),
+                                            begin(range2), end(range2),
+                                            begin(range3), comp);
     }
 
-  template <typename R>
-    inline std::pair<Iterator_of<R>, Iterator_of<R>>
-    minmax_element(R&& range)
+  template<typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    merge(parallel_policy pol,
+          const R1& range1, const R2& range2, R3&& range3)
     {
-      using std::begin;
-      using std::end;
-      return std::minmax_element(begin(range), end(range));
+      return merge(pol, range1, range2, std::forward<R3>(range3),
+                   algorithm_impl::less_than());
     }
 
-  template <typename R, typename C>
-    inline std::pair<Iterator_of<R>, Iterator_of<R>>
-    minmax_element(R&& range, C comp)
+  // Set operations
+  template<typename R1, typename R2, typename C>
+    inline bool
+    includes(parallel_policy pol,
+             const R1& range1, const R2& range2, C comp)
     {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
       using std::begin;
       using std::end;
-      return std::minmax_element(begin(range), end(range), comp);
+      return algorithm_impl::parallel_includes(pol, begin(range1), end(range1),
+                                               begin(range2), end(range2),
+                                               comp);
     }
 
-
-  // NOTE: These versions of min and max are slightly different than those
-  // in the standard library. The standard min/max algorithms require that the
-  // result type is const T& (although T& should be fine, too). We relax the
-  // strict reference requirement so that the result is simply that of
-  // dereferencing the iterator. This makes these algorithms work with 
-  // vector<bool>, for example.
-
-  template <typename R>
-    inline auto
-    min(R&& range) -> decltype(*min_element(range))
+  template<typename R1, typename R2>
+    inline bool
+    includes(parallel_policy pol, const R1& range1, const R2& range2)
     {
-      return *min_element(range);
+      return includes(pol, range1, range2, algorithm_impl::less_than());
     }
 
-  template <typename R, typename C>
-    inline auto
-    min(R&& range, C comp) -> decltype(*min_element(range, comp))
+  template<typename R1, typename R2, typename R3, typename C>
+    inline Iterator_of<R3>
+    set_union(parallel_policy pol,
+              const R1& range1, const R2& range2, R3&& result, C comp)
     {
-      return *min_element(range, comp);
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
+      using std::begin;
+      using std::end;
+      algorithm_impl::union_op op;
+      return algorithm_impl::parallel_set_op(pol, op,
+                                             begin(range1), end(range1),
+                                             begin(range2), end(range2),
+                                             begin(result), comp);
     }
 
-  template <typename R>
-    inline auto
-    max(R&& range) -> decltype(*max_element(range))
+  template<typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_union(parallel_policy pol,
+              const R1& range1, const R2& range2, R3&& result)
     {
-      return *max_element(range);
+      return set_union(pol, range1, range2, std::forward<R3>(result),
+                       algorithm_impl::less_than());
     }
 
-  template <typename R, typename C>
-    inline auto
-    max(R&& range, C comp) -> decltype(*max_element(range, comp))
+  template<typename R1, typename R2, typename R3, typename C>
+    inline Iterator_of<R3>
+    set_intersection(parallel_policy pol,
+                     const R1& range1, const R2& range2, R3&& result, C comp)
     {
-      return *max_element(range);
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
+      using std::begin;
+      using std::end;
+      algorithm_impl::intersection_op op;
+      return algorithm_impl::parallel_set_op(pol, op,
+                                             begin(range1), end(range1),
+                                             begin(range2), end(range2),
+                                             begin(result), comp);
     }
 
-  template <typename R>
-    inline std::pair<Reference_of<R>, Reference_of<R>>
-    minmax(R&& range)
+  template<typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_intersection(parallel_policy pol,
+                     const R1& range1, const R2& range2, R3&& result)
     {
-      auto p = minmax_element(range);
-      return {*p.first, *p.second};
+      return set_intersection(pol, range1, range2, std::forward<R3>(result),
+                              algorithm_impl::less_than());
     }
 
-  template <typename R, typename C>
-    inline std::pair<Reference_of<R>, Reference_of<R>>
-    minmax(R&& range, C comp)
+  template<typename R1, typename R2, typename R3, typename C>
+    inline Iterator_of<R3>
+    set_difference(parallel_policy pol,
+                   const R1& range1, const R2& range2, R3&& result, C comp)
     {
-      auto p = minmax_element(range);
-      return {*p.first, *p.second};
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
+      using std::begin;
+      using std::end;
+      algorithm_impl::difference_op op;
+      return algorithm_impl::parallel_set_op(pol, op,
+                                             begin(range1), end(range1),
+                                             begin(range2), end(range2),
+                                             begin(result), comp);
     }
 
+  template<typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_difference(parallel_policy pol,
+                   const R1& range1, const R2& range2, R3&& result)
+    {
+      return set_difference(pol, range1, range2, std::forward<R3>(result),
+                            algorithm_impl::less_than());
+    }
 
-
-  //////////////////////////////////////////////////////////////////////////////
-  // Lexicographical comparison
-
-  template <typename R1, typename R2>
-    inline bool
-    lexicographical_compare(const R1& range1, const R2& range2)
+  template<typename R1, typename R2, typename R3, typename C>
+    inline Iterator_of<R3>
+    set_symmetric_difference(parallel_policy pol,
+                             const R1& range1, const R2& range2, R3&& result,
+                             C comp)
     {
+      static_assert(Random_access_range<const R1>(), "");
+      static_assert(Random_access_range<const R2>(), "");
+      static_assert(Random_access_range<R3>(), "");
       using std::begin;
       using std::end;
-      return std::lexicographical_compare(begin(range1), end(range1),
-                                          begin(range2), end(range2));
+      algorithm_impl::symmetric_difference_op op;
+      return algorithm_impl::parallel_set_op(pol, op,
+                                             begin(range1), end(range1),
+                                             begin(range2), end(range2),
+                                             begin(result), comp);
     }
 
-  template <typename R1, typename R2, typename C>
-    inline bool
-    lexicographical_compare(const R1& range1, const R2& range2, C comp)
+  template<typename R1, typename R2, typename R3>
+    inline Iterator_of<R3>
+    set_symmetric_difference(parallel_policy pol,
+                             const R1& range1, const R2& range2, R3&& result)
+    {
+      return set_symmetric_difference(pol, range1, range2,
+                                      std::forward<R3>(result),
+                                      algorithm_impl::less_than());
+    }
+
+  // Min and max
+  template<typename R, typename C>
+    inline Iterator_of<R>
+    min_element(parallel_policy pol, R&& range, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::lexicographical_compare(begin(range1), end(range1),
-                                          begin(range2), end(range2),
-                                          comp);
+      using I = Iterator_of<R>;
+      return algorithm_impl::parallel_extreme<false, false>(
+        pol, begin(range), end(range), comp,
+        algorithm_impl::Arithmetic_extreme<I, C>(),
+        algorithm_impl::Simd_range_extreme<R, C>());
     }
 
+  template<typename R>
+    inline Iterator_of<R>
+    min_element(parallel_policy pol, R&& range)
+    {
+      return min_element(pol, std::forward<R>(range),
+                         algorithm_impl::less_than());
+    }
 
-
-  //////////////////////////////////////////////////////////////////////////////
-  // Permutation Generators
-
-  template <typename R>
-    inline bool
-    next_permutation(R&& range)
+  template<typename R, typename C>
+    inline Iterator_of<R>
+    max_element(parallel_policy pol, R&& range, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::next_permutation(begin(range), end(range));
+      using I = Iterator_of<R>;
+      return algorithm_impl::parallel_extreme<true, false>(
+        pol, begin(range), end(range), comp,
+        algorithm_impl::Arithmetic_extreme<I, C>(),
+        algorithm_impl::Simd_range_extreme<R, C>());
     }
 
-  template <typename R, typename C>
-    inline bool
-    next_permutation(R&& range, C comp)
+  template<typename R>
+    inline Iterator_of<R>
+    max_element(parallel_policy pol, R&& range)
     {
-      using std::begin;
-      using std::end;
-      return std::next_permutation(begin(range), end(range), comp);
+      return max_element(pol, std::forward<R>(range),
+                         algorithm_impl::less_than());
     }
 
-  template <typename R>
-    inline bool
-    prev_permutation(R&& range)
+  template<typename R, typename C>
+    inline std::pair<Iterator_of<R>, Iterator_of<R>>
+    minmax_element(parallel_policy pol, R&& range, C comp)
     {
+      static_assert(Random_access_range<R>(), "");
       using std::begin;
       using std::end;
-      return std::prev_permutation(begin(range), end(range));
+      using I = Iterator_of<R>;
+      algorithm_impl::Arithmetic_extreme<I, C> arith;
+      algorithm_impl::Simd_range_extreme<R, C> simd;
+      return {algorithm_impl::parallel_extreme<false, false>(
+                pol, begin(range), end(range), comp, arith, simd),
+              algorithm_impl::parallel_extreme<true, true>(
+                pol, begin(range), end(range), comp, arith, simd)};
     }
 
-  template <typename R, typename C>
-    inline bool
-    prev_permutation(R&& range, C comp)
+  template<typename R>
+    inline std::pair<Iterator_of<R>, Iterator_of<R>>
+    minmax_element(parallel_policy pol, R&& range)
     {
-      using std::begin;
-      using std::end;
-      return std::prev_permutation(begin(range), end(range), comp);
+      return minmax_element(pol, std::forward<R>(range),
+                            algorithm_impl::less_than());
     }
 
 } // namespace origin
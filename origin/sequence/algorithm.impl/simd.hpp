@@ -0,0 +1,1003 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// SIMD searching                                                  [algo.simd]
+//
+// The simd_equal class describes the vector comparison of values of a scalar
+// type T on the target architecture. When vector comparison is available,
+// the traits class provides:
+//
+//    simd_equal<T>::broadcast(x)    -- A register with each lane equal to x
+//    simd_equal<T>::equal(a, b)     -- Lane-wise a == b, as a lane mask
+//
+// Registers hold 16 bytes. The lanes of integers are compared bitwise, and
+// those of floats and doubles as by operator==, so that NaN is not equal to
+// itself and negative zero is equal to positive zero. The instruction set is
+// selected by the compiler's target macros: SSE2, which is always available
+// on x86-64. Other targets use the generic algorithms.
+//
+// The search kernels below scan a contiguous sequence a register at a time,
+// computing a bit mask with one bit for each byte of a block of elements,
+// set when the element containing the byte compares equal. The first match
+// in a block is found from the lowest set bit of its mask. Scanning for the
+// first match handles four registers per iteration. Matches are counted in
+// vector registers, without computing masks.
+//
+// Removing the values equal to x copies each block that has no match with a
+// single store. When the target has AVX-512, blocks of 64 bytes of 4- and
+// 8-byte elements are compared into a lane mask, and the elements that are
+// not equal are written by a compress store, without branches.
+//
+// Streaming copies, fills and generation write large contiguous ranges of
+// trivially copyable values with non-temporal stores, which go to memory
+// without reading the written lines into the cache or evicting the lines
+// in it (see [algo.stream]).
+//
+// The simd_less class orders the lanes of 4-byte integers, floats and
+// doubles, as by operator<. The first element of a sequence that is ordered
+// before (or after) a value is found in the same way as the first match,
+// which lets top_k reject most elements a register at a time (see
+// [algo.top_k]).
+//
+// The least and greatest elements of a sequence of these types are found
+// a block of registers at a time, with NaNs ignored (see [algo.minmax]).
+//
+// The primary template describes types for which there is no vector support.
+
+namespace algorithm_impl
+{
+  template<typename T, std::size_t N = Integer<T>() ? sizeof(T) : 0>
+    struct simd_equal
+    {
+      static constexpr bool enabled = false;
+    };
+
+  // Returns true if there is vector support for comparing values of type T.
+  template<typename T>
+    constexpr bool Simd_comparable()
+    {
+      return simd_equal<T>::enabled;
+    }
+
+  // The simd_less class describes the vector ordering of values of type T,
+  // providing broadcast(x), and less(a, b) and equal(a, b), the lane-wise
+  // a < b and a == b as lane masks, when it is enabled.
+  template<typename T>
+    struct simd_less
+    {
+      static constexpr bool enabled = false;
+    };
+
+  // Returns true if there is vector support for ordering values of type T.
+  template<typename T>
+    constexpr bool Simd_orderable()
+    {
+      return simd_less<T>::enabled;
+    }
+
+  // Returns true if there is vector support for the prefix sums of values
+  // of type T: 4- and 8-byte integers.
+  template<typename T>
+    constexpr bool Simd_scannable()
+    {
+#if defined(__SSE2__)
+      return Integer<T>() && (sizeof(T) == 4 || sizeof(T) == 8);
+#else
+      return false;
+#endif
+    }
+
+  // Returns true if large ranges of values of type T can be written with
+  // non-temporal stores: T is trivially copyable.
+  template<typename T>
+    constexpr bool Simd_streamable()
+    {
+#if defined(__SSE2__)
+      return Trivially_copyable<T>();
+#else
+      return false;
+#endif
+    }
+
+  // Returns true if there is vector support for the sums of values of type
+  // T: floats, doubles, and 4- and 8-byte integers.
+  template<typename T>
+    constexpr bool Simd_summable()
+    {
+#if defined(__SSE2__)
+      return Simd_scannable<T>() || Same<T, float>() || Same<T, double>();
+#else
+      return false;
+#endif
+    }
+
+
+  // Returns the first pointer p in [first, last) at which the m > 0
+  // elements at q occur, or last. The first and last elements of the
+  // pattern are compared before the others.
+  template<typename T>
+    const T*
+    filter_search(const T* first, const T* last, const T* q, std::size_t m)
+    {
+      for (; std::size_t(last - first) >= m; ++first)
+        if (first[0] == q[0] && first[m - 1] == q[m - 1]
+            && (m < 3 || std::equal(q + 1, q + m - 1, first + 1)))
+          return first;
+      return last;
+    }
+
+
+#if defined(__SSE2__)
+  // The number of bytes in a register.
+  constexpr std::size_t simd_bytes = 16;
+
+  template<typename T>
+    struct simd_equal<T, 1>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(T x) { return _mm_set1_epi8(char(x)); }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_cmpeq_epi8(a, b);
+      }
+    };
+
+  template<typename T>
+    struct simd_equal<T, 2>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(T x) { return _mm_set1_epi16(short(x)); }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_cmpeq_epi16(a, b);
+      }
+    };
+
+  template<typename T>
+    struct simd_equal<T, 4>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(T x) { return _mm_set1_epi32(int(x)); }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_cmpeq_epi32(a, b);
+      }
+    };
+
+  // SSE2 has no 64-bit comparison. A lane is equal when both of its 32-bit
+  // halves are.
+  template<typename T>
+    struct simd_equal<T, 8>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(T x) { return _mm_set1_epi64x((long long)x); }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        __m128i e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, 0xb1));
+      }
+    };
+
+  template<>
+    struct simd_equal<float, 0>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(float x)
+      {
+        return _mm_castps_si128(_mm_set1_ps(x));
+      }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a),
+                                             _mm_castsi128_ps(b)));
+      }
+    };
+
+  template<>
+    struct simd_equal<double, 0>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(double x)
+      {
+        return _mm_castpd_si128(_mm_set1_pd(x));
+      }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a),
+                                             _mm_castsi128_pd(b)));
+      }
+    };
+
+  // SSE2 compares signed 32-bit lanes. Unsigned lanes are compared by
+  // flipping their sign bits. There is no 64-bit integer ordering before
+  // SSE4.2, so 8-byte integers are not ordered in vector registers.
+  template<>
+    struct simd_less<int>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(int x) { return _mm_set1_epi32(x); }
+      static __m128i less(__m128i a, __m128i b)
+      {
+        return _mm_cmplt_epi32(a, b);
+      }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_cmpeq_epi32(a, b);
+      }
+    };
+
+  template<>
+    struct simd_less<unsigned>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(unsigned x) { return _mm_set1_epi32(int(x)); }
+      static __m128i less(__m128i a, __m128i b)
+      {
+        const __m128i sign = _mm_set1_epi32(int(0x80000000u));
+        return _mm_cmplt_epi32(_mm_xor_si128(a, sign),
+                               _mm_xor_si128(b, sign));
+      }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_cmpeq_epi32(a, b);
+      }
+    };
+
+  template<>
+    struct simd_less<float>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(float x)
+      {
+        return _mm_castps_si128(_mm_set1_ps(x));
+      }
+      static __m128i less(__m128i a, __m128i b)
+      {
+        return _mm_castps_si128(_mm_cmplt_ps(_mm_castsi128_ps(a),
+                                             _mm_castsi128_ps(b)));
+      }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a),
+                                             _mm_castsi128_ps(b)));
+      }
+    };
+
+  template<>
+    struct simd_less<double>
+    {
+      static constexpr bool enabled = true;
+
+      static __m128i broadcast(double x)
+      {
+        return _mm_castpd_si128(_mm_set1_pd(x));
+      }
+      static __m128i less(__m128i a, __m128i b)
+      {
+        return _mm_castpd_si128(_mm_cmplt_pd(_mm_castsi128_pd(a),
+                                             _mm_castsi128_pd(b)));
+      }
+      static __m128i equal(__m128i a, __m128i b)
+      {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a),
+                                             _mm_castsi128_pd(b)));
+      }
+    };
+
+  template<typename T>
+    inline __m128i
+    simd_load(const T* p)
+    {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+  // Returns the byte mask of the elements of the block at p equal to the
+  // lanes of x.
+  template<typename T>
+    inline int
+    simd_mask(const T* p, __m128i x)
+    {
+      return _mm_movemask_epi8(simd_equal<T>::equal(simd_load(p), x));
+    }
+
+  // Returns the first pointer p in [first, last) such that (*p == x) is
+  // equal, or last if there is none.
+  template<typename T>
+    const T*
+    simd_find(const T* first, const T* last, T x, bool equal)
+    {
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      const int flip = equal ? 0 : 0xffff;
+      const __m128i v = simd_equal<T>::broadcast(x);
+      while (std::size_t(last - first) >= 4 * w) {
+        int m0 = simd_mask(first, v) ^ flip;
+        int m1 = simd_mask(first + w, v) ^ flip;
+        int m2 = simd_mask(first + 2 * w, v) ^ flip;
+        int m3 = simd_mask(first + 3 * w, v) ^ flip;
+        if (m0 | m1 | m2 | m3) {
+          if (!m0) {
+            first += w;
+            m0 = m1;
+            if (!m0) {
+              first += w;
+              m0 = m2;
+              if (!m0) {
+                first += w;
+                m0 = m3;
+              }
+            }
+          }
+          return first + __builtin_ctz(m0) / sizeof(T);
+        }
+        first += 4 * w;
+      }
+      while (std::size_t(last - first) >= w) {
+        if (int m = simd_mask(first, v) ^ flip)
+          return first + __builtin_ctz(m) / sizeof(T);
+        first += w;
+      }
+      while (first != last && (*first == x) != equal)
+        ++first;
+      return first;
+    }
+
+  // Returns the first pointer p in [first, last) such that *p < x, or
+  // x < *p if Greater, or last if there is none. Like NaN, the lanes that
+  // are unordered with x do not match.
+  template<bool Greater, typename T>
+    const T*
+    simd_find_before(const T* first, const T* last, T x)
+    {
+      using S = simd_less<T>;
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      const __m128i v = S::broadcast(x);
+      auto mask = [v](const T* p) {
+        __m128i a = simd_load(p);
+        return _mm_movemask_epi8(Greater ? S::less(v, a) : S::less(a, v));
+      };
+      while (std::size_t(last - first) >= 4 * w) {
+        if (mask(first) | mask(first + w) | mask(first + 2 * w)
+            | mask(first + 3 * w))
+          break;
+        first += 4 * w;
+      }
+      while (std::size_t(last - first) >= w) {
+        if (int m = mask(first))
+          return first + __builtin_ctz(m) / sizeof(T);
+        first += w;
+      }
+      while (first != last && !(Greater ? x < *first : *first < x))
+        ++first;
+      return first;
+    }
+
+  // Returns the first least element of [first, last), or the first
+  // greatest if Max, or the last greatest if Max and Last, ignoring NaNs.
+  // Returns first if every element is NaN. The extreme of each block of
+  // 16 registers is found in vector registers, and compared with the
+  // extreme so far; the block that first contains the result is then
+  // searched for it.
+  template<bool Max, bool Last, typename T>
+    const T*
+    simd_extreme(const T* first, const T* last)
+    {
+      using S = simd_less<T>;
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      constexpr std::size_t block = 16 * w;
+      auto better = [](const T& a, const T& b) {
+        return Max ? b < a : a < b;
+      };
+      const T* p = first;
+      while (p != last && !(*p == *p))
+        ++p;
+      if (p == last)
+        return first;
+      T best = *p;
+      const T* from = p;
+      for (++p; std::size_t(last - p) >= block; p += block) {
+        const __m128i v = S::broadcast(best);
+        __m128i acc = v;
+        __m128i tie = _mm_setzero_si128();
+        for (std::size_t i = 0; i != block; i += w) {
+          __m128i x = simd_load(p + i);
+          __m128i m = Max ? S::less(acc, x) : S::less(x, acc);
+          acc = _mm_or_si128(_mm_and_si128(m, x), _mm_andnot_si128(m, acc));
+          if (Last)
+            tie = _mm_or_si128(tie, S::equal(x, v));
+        }
+        alignas(16) T lanes[w];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        T m = lanes[0];
+        for (std::size_t i = 1; i != w; ++i)
+          if (better(lanes[i], m))
+            m = lanes[i];
+        if (better(m, best) || (Last && _mm_movemask_epi8(tie))) {
+          best = m;
+          from = p;
+        }
+      }
+      for (; p != last; ++p)
+        if (better(*p, best) || (Last && *p == best)) {
+          best = *p;
+          from = p;
+        }
+      if (!Last) {
+        while (!(*from == best))
+          ++from;
+        return from;
+      }
+      const T* to = std::min(last, from + block);
+      while (!(*--to == best))
+        continue;
+      return to;
+    }
+
+  // Returns the number of elements in [first, last) equal to x. Each byte
+  // of an equal element is counted in a byte of an accumulator, and the
+  // bytes are summed before they can overflow.
+  template<typename T>
+    std::size_t
+    simd_count(const T* first, const T* last, T x)
+    {
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      const __m128i v = simd_equal<T>::broadcast(x);
+      const __m128i zero = _mm_setzero_si128();
+      std::size_t bytes = 0;
+      while (std::size_t(last - first) >= w) {
+        __m128i acc = zero;
+        for (int i = 0; i != 255 && std::size_t(last - first) >= w; ++i) {
+          acc = _mm_sub_epi8(acc, simd_equal<T>::equal(simd_load(first), v));
+          first += w;
+        }
+        __m128i sums = _mm_sad_epu8(acc, zero);
+        bytes += _mm_cvtsi128_si32(sums)
+               + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+      }
+      std::size_t n = bytes / sizeof(T);
+      for (; first != last; ++first)
+        n += *first == x;
+      return n;
+    }
+
+  // Returns the first pointer p in [first1, last1) such that *p is not
+  // equal to the corresponding element of [first2, ...), or last1.
+  template<typename T>
+    const T*
+    simd_mismatch(const T* first1, const T* last1, const T* first2)
+    {
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      for (; std::size_t(last1 - first1) >= w; first1 += w, first2 += w) {
+        int m = _mm_movemask_epi8(
+          simd_equal<T>::equal(simd_load(first1), simd_load(first2)));
+        if (m != 0xffff)
+          return first1 + __builtin_ctz(~m) / sizeof(T);
+      }
+      while (first1 != last1 && *first1 == *first2) {
+        ++first1;
+        ++first2;
+      }
+      return first1;
+    }
+
+  // Returns the first pointer p in [first, last) at which the m > 0
+  // elements at q occur, or last. The positions at which the first and the
+  // last elements of the pattern both occur are found a register at a time,
+  // by comparing the blocks at p and p + m - 1 with them (the method of
+  // Mula), and only those positions are compared with the whole pattern.
+  template<typename T>
+    const T*
+    simd_search(const T* first, const T* last, const T* q, std::size_t m)
+    {
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      // The mask bits of the first byte of each lane.
+      constexpr int lanes = sizeof(T) == 1 ? 0xffff
+                          : sizeof(T) == 2 ? 0x5555
+                          : sizeof(T) == 4 ? 0x1111 : 0x0101;
+      const __m128i a = simd_equal<T>::broadcast(q[0]);
+      const __m128i b = simd_equal<T>::broadcast(q[m - 1]);
+      for (; std::size_t(last - first) >= m - 1 + w; first += w) {
+        __m128i x = simd_equal<T>::equal(simd_load(first), a);
+        __m128i y = simd_equal<T>::equal(simd_load(first + m - 1), b);
+        int mask = _mm_movemask_epi8(_mm_and_si128(x, y)) & lanes;
+        for (; mask != 0; mask &= mask - 1) {
+          const T* p = first + __builtin_ctz(mask) / sizeof(T);
+          if (m < 3 || std::equal(q + 1, q + m - 1, p + 1))
+            return p;
+        }
+      }
+      return filter_search(first, last, q, m);
+    }
+
+#if defined(__AVX512F__)
+  // Store the elements of the 64 bytes at p that are not equal to x to out,
+  // and return the number stored.
+  template<typename T>
+    inline Requires<Integer<T>() && sizeof(T) == 4, std::size_t>
+    simd_compress(const T* p, T x, T* out)
+    {
+      __m512i v = _mm512_loadu_si512(p);
+      __mmask16 m = _mm512_cmpneq_epi32_mask(v, _mm512_set1_epi32(int(x)));
+      _mm512_mask_compressstoreu_epi32(out, m, v);
+      return __builtin_popcount(m);
+    }
+
+  template<typename T>
+    inline Requires<Integer<T>() && sizeof(T) == 8, std::size_t>
+    simd_compress(const T* p, T x, T* out)
+    {
+      __m512i v = _mm512_loadu_si512(p);
+      __mmask8 m = _mm512_cmpneq_epi64_mask(
+        v, _mm512_set1_epi64(static_cast<long long>(x)));
+      _mm512_mask_compressstoreu_epi64(out, m, v);
+      return __builtin_popcount(m);
+    }
+
+  inline std::size_t
+  simd_compress(const float* p, float x, float* out)
+  {
+    __m512 v = _mm512_loadu_ps(p);
+    __mmask16 m = _mm512_cmp_ps_mask(v, _mm512_set1_ps(x), _CMP_NEQ_UQ);
+    _mm512_mask_compressstoreu_ps(out, m, v);
+    return __builtin_popcount(m);
+  }
+
+  inline std::size_t
+  simd_compress(const double* p, double x, double* out)
+  {
+    __m512d v = _mm512_loadu_pd(p);
+    __mmask8 m = _mm512_cmp_pd_mask(v, _mm512_set1_pd(x), _CMP_NEQ_UQ);
+    _mm512_mask_compressstoreu_pd(out, m, v);
+    return __builtin_popcount(m);
+  }
+
+  // Compress the whole blocks of 64 bytes of [first, last) to out, if the
+  // elements have 4 or 8 bytes.
+  template<typename T>
+    inline void
+    simd_compress_blocks(const T*& first, const T* last, T*& out, T x,
+                         std::true_type)
+    {
+      constexpr std::size_t w = 64 / sizeof(T);
+      for (; std::size_t(last - first) >= w; first += w)
+        out += simd_compress(first, x, out);
+    }
+
+  template<typename T>
+    inline void
+    simd_compress_blocks(const T*&, const T*, T*&, T, std::false_type)
+    { }
+#endif
+
+  // Copy the elements of [first, last) that are not equal to x to the
+  // sequence beginning at out, and return the end of the copy. The output
+  // may be the input, or begin before it.
+  template<typename T>
+    T*
+    simd_remove_copy(const T* first, const T* last, T* out, T x)
+    {
+#if defined(__AVX512F__)
+      using Compress = std::integral_constant<
+        bool, sizeof(T) == 4 || sizeof(T) == 8>;
+      simd_compress_blocks(first, last, out, x, Compress());
+#endif
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      const __m128i v = simd_equal<T>::broadcast(x);
+      for (; std::size_t(last - first) >= w; first += w) {
+        __m128i y = simd_load(first);
+        if (_mm_movemask_epi8(simd_equal<T>::equal(y, v)) == 0) {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out), y);
+          out += w;
+        } else {
+          for (std::size_t i = 0; i != w; ++i)
+            if (!(first[i] == x))
+              *out++ = first[i];
+        }
+      }
+      for (; first != last; ++first)
+        if (!(*first == x))
+          *out++ = *first;
+      return out;
+    }
+
+  // Intersect the strictly increasing sequences [a, la) and [b, lb) of
+  // 4-byte integers, four elements at a time, calling f(p, mask) for each
+  // block p of a, where the ith bit of mask is set if p[i] is in b. Each
+  // block of a is compared with every rotation of a block of b, and the
+  // block with the lesser last element is advanced (both when they are
+  // equal). On return, a and b point to the elements not yet compared.
+  template<typename T, typename F>
+    void
+    simd_intersect(const T*& a, const T* la, const T*& b, const T* lb, F f)
+    {
+      static_assert(sizeof(T) == 4, "");
+      while (la - a >= 4 && lb - b >= 4) {
+        __m128i x = simd_load(a);
+        __m128i y = simd_load(b);
+        __m128i eq = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi32(x, y),
+                       _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, 0x39))),
+          _mm_or_si128(_mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, 0x4e)),
+                       _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, 0x93))));
+        if (int mask = _mm_movemask_ps(_mm_castsi128_ps(eq)))
+          f(a, mask);
+        T p = a[3];
+        T q = b[3];
+        a += p <= q ? 4 : 0;
+        b += q <= p ? 4 : 0;
+      }
+    }
+
+  // Returns the register x shifted up by N lanes of T, filling with zeros.
+  template<typename T, int N>
+    inline __m128i
+    simd_shift_lanes(__m128i x)
+    {
+      return _mm_slli_si128(x, N * int(sizeof(T)));
+    }
+
+  inline __m128i simd_add(__m128i a, __m128i b, std::integral_constant<int, 4>)
+  {
+    return _mm_add_epi32(a, b);
+  }
+
+  inline __m128i simd_add(__m128i a, __m128i b, std::integral_constant<int, 8>)
+  {
+    return _mm_add_epi64(a, b);
+  }
+
+  inline __m128i simd_sub(__m128i a, __m128i b, std::integral_constant<int, 4>)
+  {
+    return _mm_sub_epi32(a, b);
+  }
+
+  inline __m128i simd_sub(__m128i a, __m128i b, std::integral_constant<int, 8>)
+  {
+    return _mm_sub_epi64(a, b);
+  }
+
+  // Returns the inclusive prefix sums of the lanes of the register x.
+  template<typename T>
+    inline __m128i
+    simd_prefix(__m128i x)
+    {
+      using N = std::integral_constant<int, int(sizeof(T))>;
+      x = simd_add(x, simd_shift_lanes<T, 1>(x), N());
+      if (sizeof(T) == 4)
+        x = simd_add(x, simd_shift_lanes<T, 2>(x), N());
+      return x;
+    }
+
+  // Write the prefix sums of [first, last), added to carry, to the sequence
+  // beginning at out, and return the last of them, or carry if the sequence
+  // is empty. The sums are inclusive, or exclusive if inclusive is false.
+  // The prefix sums of a register are computed by adding it to itself
+  // shifted by one lane and then by two, and the sum of the previous
+  // registers is broadcast to all lanes and added. The output may be the
+  // input.
+  template<typename T>
+    T
+    simd_scan(const T* first, const T* last, T* out, T carry, bool inclusive)
+    {
+      using N = std::integral_constant<int, int(sizeof(T))>;
+      constexpr std::size_t w = simd_bytes / sizeof(T);
+      alignas(16) T lanes[w];
+      for (std::size_t i = 0; i != w; ++i)
+        lanes[i] = carry;
+      __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+      for (; std::size_t(last - first) >= w; first += w, out += w) {
+        __m128i x = simd_load(first);
+        __m128i y = simd_add(simd_prefix<T>(x), c, N());
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         inclusive ? y : simd_sub(y, x, N()));
+        c = sizeof(T) == 4 ? _mm_shuffle_epi32(y, 0xff)
+                           : _mm_shuffle_epi32(y, 0xee);
+      }
+      _mm_store_si128(reinterpret_cast<__m128i*>(lanes), c);
+      carry = lanes[0];
+      for (; first != last; ++first, ++out) {
+        T x = *first;
+        carry = T(carry + x);
+        *out = inclusive ? carry : T(carry - x);
+      }
+      return carry;
+    }
+
+  // Store to lanes the four sums of the elements of the k blocks of four
+  // elements at p, where the jth sum is that of the jth element of each
+  // block, added in order. Elements of 8 bytes are summed in two registers.
+  inline void
+  simd_lane_sums(const float* p, std::size_t k, float* lanes)
+  {
+    __m128 a = _mm_setzero_ps();
+    for (; k != 0; --k, p += 4)
+      a = _mm_add_ps(a, _mm_loadu_ps(p));
+    _mm_storeu_ps(lanes, a);
+  }
+
+  inline void
+  simd_lane_sums(const double* p, std::size_t k, double* lanes)
+  {
+    __m128d a = _mm_setzero_pd();
+    __m128d b = _mm_setzero_pd();
+    for (; k != 0; --k, p += 4) {
+      a = _mm_add_pd(a, _mm_loadu_pd(p));
+      b = _mm_add_pd(b, _mm_loadu_pd(p + 2));
+    }
+    _mm_storeu_pd(lanes, a);
+    _mm_storeu_pd(lanes + 2, b);
+  }
+
+  template<typename T>
+    inline Requires<Integer<T>()>
+    simd_lane_sums(const T* p, std::size_t k, T* lanes)
+    {
+      using N = std::integral_constant<int, int(sizeof(T))>;
+      __m128i a = _mm_setzero_si128();
+      __m128i b = _mm_setzero_si128();
+      for (; k != 0; --k, p += 4) {
+        a = simd_add(a, simd_load(p), N());
+        if (sizeof(T) == 8)
+          b = simd_add(b, simd_load(p + 2), N());
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), a);
+      if (sizeof(T) == 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 2), b);
+    }
+
+  // Copy the n bytes at src to dst, writing the aligned blocks of dst with
+  // non-temporal stores, which bypass the cache. The bytes must not
+  // overlap. The stores are fenced, so they are ordered before any later
+  // store.
+  inline void
+  simd_stream_copy(const char* src, char* dst, std::size_t n)
+  {
+    std::size_t head = (16 - (reinterpret_cast<std::uintptr_t>(dst) & 15)) & 15;
+    head = std::min(head, n);
+    std::memcpy(dst, src, head);
+    src += head;
+    dst += head;
+    n -= head;
+    for (; n >= 64; n -= 64, src += 64, dst += 64) {
+      __m128i a = simd_load(src);
+      __m128i b = simd_load(src + 16);
+      __m128i c = simd_load(src + 32);
+      __m128i d = simd_load(src + 48);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+    }
+    for (; n >= 16; n -= 16, src += 16, dst += 16)
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst), simd_load(src));
+    std::memcpy(dst, src, n);
+    _mm_sfence();
+  }
+
+  // Assign x to the elements of [first, last) with non-temporal stores of a
+  // register holding 16 / sizeof(T) copies of x. T is trivially copyable,
+  // and its size divides 16. Unless first is aligned to the size of T, the
+  // elements are assigned by std::fill.
+  template<typename T>
+    void
+    simd_stream_fill(T* first, T* last, const T& x)
+    {
+      if (reinterpret_cast<std::uintptr_t>(first) % sizeof(T) != 0) {
+        std::fill(first, last, x);
+        return;
+      }
+      for (; first != last && reinterpret_cast<std::uintptr_t>(first) & 15;
+           ++first)
+        *first = x;
+      alignas(16) char lanes[16];
+      for (std::size_t i = 0; i != 16; i += sizeof(T))
+        std::memcpy(lanes + i, &x, sizeof(T));
+      const __m128i v = simd_load(lanes);
+      constexpr std::size_t w = 16 / sizeof(T);
+      for (; std::size_t(last - first) >= 4 * w; first += 4 * w) {
+        __m128i* p = reinterpret_cast<__m128i*>(first);
+        _mm_stream_si128(p, v);
+        _mm_stream_si128(p + 1, v);
+        _mm_stream_si128(p + 2, v);
+        _mm_stream_si128(p + 3, v);
+      }
+      for (; std::size_t(last - first) >= w; first += w)
+        _mm_stream_si128(reinterpret_cast<__m128i*>(first), v);
+      std::fill(first, last, x);
+      _mm_sfence();
+    }
+
+  // Assign the results of gen() to the elements of [first, last), a block
+  // at a time: each block is generated into a buffer that stays in the
+  // cache, and is then copied with non-temporal stores.
+  template<typename T, typename Gen>
+    void
+    simd_stream_generate(T* first, T* last, Gen& gen)
+    {
+      constexpr std::size_t w = std::max<std::size_t>(1, 4096 / sizeof(T));
+      alignas(16) char buf[w * sizeof(T)];
+      while (first != last) {
+        std::size_t k = std::min<std::size_t>(w, last - first);
+        for (std::size_t i = 0; i != k; ++i) {
+          T x = gen();
+          std::memcpy(buf + i * sizeof(T), &x, sizeof(T));
+        }
+        simd_stream_copy(buf, reinterpret_cast<char*>(first), k * sizeof(T));
+        first += k;
+      }
+    }
+#endif
+
+
+  // Safely deduce the result of the expression r.data().
+  template<typename R>
+    struct get_data_result
+    {
+    private:
+      template<typename X>
+        static auto check(X&& x) -> decltype(x.data());
+      static subst_failure check(...);
+    public:
+      using type = decltype(check(std::declval<R>()));
+    };
+
+  // Returns true if the elements of the range R are stored contiguously:
+  // its iterators are pointers, or its data() member returns a pointer to
+  // its elements, as for vectors, strings and arrays.
+  template<typename R>
+    constexpr bool Contiguous_range()
+    {
+      using D = typename get_data_result<R&>::type;
+      using T = Value_type<Iterator_of<R>>;
+      return Pointer<Iterator_of<R>>()
+          || (Pointer<D>() && Same<Remove_cv<Remove_pointer<D>>, T>());
+    }
+
+  // The searches of [first, last) for values of type T use vector
+  // instructions if I is a pointer to T and T can be compared in vector
+  // registers. Searching a range uses them if it is contiguous.
+  template<typename I, typename T>
+    using Simd_iterator_search
+      = std::integral_constant<bool, Pointer<I>() && Same<Value_type<I>, T>()
+                                     && Simd_comparable<T>()>;
+
+  template<typename R, typename T>
+    using Simd_range_search
+      = std::integral_constant<bool, Contiguous_range<R>()
+                                     && Same<Value_type<Iterator_of<R>>, T>()
+                                     && Simd_comparable<T>()>;
+
+  // Removing values of type T from R1 into R2 uses vector instructions if
+  // both are contiguous ranges of T.
+  template<typename R1, typename R2, typename T>
+    using Simd_range_remove
+      = std::integral_constant<bool, Contiguous_range<R2>()
+                                     && Same<Value_type<Iterator_of<R2>>, T>()
+                                     && Simd_range_search<R1, T>::value>;
+
+  template<typename R1, typename R2>
+    using Simd_range_mismatch
+      = std::integral_constant<bool, Contiguous_range<R2>()
+                                     && Simd_range_search<
+                                          R1, Value_type<Iterator_of<R2>>
+                                        >::value>;
+
+  // Returns the first iterator i in [first, last) such that (*i == value)
+  // is equal, or last if there is none.
+  template<typename I, typename T>
+    inline I
+    find_match(I first, I last, const T& value, bool equal, std::false_type)
+    {
+      while (first != last && (*first == value) != equal)
+        ++first;
+      return first;
+    }
+
+  // Returns the number of elements in [first, last) equal to value.
+  template<typename I, typename T>
+    inline Difference_type<I>
+    count_match(I first, I last, const T& value, std::false_type)
+    {
+      return std::count(first, last, value);
+    }
+
+  // Returns the first iterator i in [first1, last1) such that *i is not
+  // equal to the corresponding element of [first2, ...), and that element.
+  template<typename I1, typename I2>
+    inline std::pair<I1, I2>
+    mismatch_match(I1 first1, I1 last1, I2 first2, std::false_type)
+    {
+      return std::mismatch(first1, last1, first2);
+    }
+
+  // Remove the elements of [first, last) equal to value, returning the end
+  // of the elements that remain, or copy the elements not equal to value to
+  // out, returning the end of the copy.
+  template<typename I, typename T>
+    inline I
+    remove_match(I first, I last, const T& value, std::false_type)
+    {
+      return std::remove(first, last, value);
+    }
+
+  template<typename I, typename O, typename T>
+    inline O
+    remove_copy_match(I first, I last, O out, const T& value, std::false_type)
+    {
+      return std::remove_copy(first, last, out, value);
+    }
+
+#if defined(__SSE2__)
+  // The contiguous iterators are converted to pointers to search.
+  template<typename I, typename T>
+    inline I
+    find_match(I first, I last, const T& value, bool equal, std::true_type)
+    {
+      if (first == last)
+        return first;
+      const T* p = std::addressof(*first);
+      return first + (simd_find(p, p + (last - first), value, equal) - p);
+    }
+
+  template<typename I, typename T>
+    inline Difference_type<I>
+    count_match(I first, I last, const T& value, std::true_type)
+    {
+      if (first == last)
+        return 0;
+      const T* p = std::addressof(*first);
+      return simd_count(p, p + (last - first), value);
+    }
+
+  template<typename I1, typename I2>
+    inline std::pair<I1, I2>
+    mismatch_match(I1 first1, I1 last1, I2 first2, std::true_type)
+    {
+      if (first1 == last1)
+        return std::make_pair(first1, first2);
+      const Value_type<I1>* p = std::addressof(*first1);
+      const Value_type<I2>* q = std::addressof(*first2);
+      auto n = simd_mismatch(p, p + (last1 - first1), q) - p;
+      return std::make_pair(first1 + n, first2 + n);
+    }
+
+  template<typename I, typename T>
+    inline I
+    remove_match(I first, I last, const T& value, std::true_type)
+    {
+      if (first == last)
+        return first;
+      T* p = std::addressof(*first);
+      return first + (simd_remove_copy(p, p + (last - first), p, value) - p);
+    }
+
+  template<typename I, typename O, typename T>
+    inline O
+    remove_copy_match(I first, I last, O out, const T& value, std::true_type)
+    {
+      if (first == last)
+        return out;
+      const T* p = std::addressof(*first);
+      T* q = std::addressof(*out);
+      return out + (simd_remove_copy(p, p + (last - first), q, value) - q);
+    }
+#endif
+
+} // namespace algorithm_impl
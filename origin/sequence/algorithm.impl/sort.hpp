@@ -0,0 +1,631 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+// -------------------------------------------------------------------------- //
+// Sorting networks                                               [algo.network]
+//
+// A sorting network sorts a fixed number of elements by a fixed sequence of
+// compare-exchanges, each of which orders the elements at two positions.
+// The sequence does not depend on the values, so that a network has no
+// branches other than those of its comparisons, and the compare-exchanges
+// of arithmetic values and pointers are written as conditional moves,
+// which compile to min and max instructions (minss, minsd, pminsd) or to
+// cmov, without branches.
+//
+// The networks are Batcher's merge exchange (Knuth, Algorithm 5.2.2M),
+// generated at compile time for any number of elements N: the template
+// merge_exchange walks the loops of the algorithm, whose state is held in
+// its template arguments, and instantiates one compare-exchange for each
+// comparator. Sorting N elements takes O(N log^2 N) comparisons; for
+// N = 16, 63.
+//
+// The pattern-defeating quicksort below sorts ranges of at most
+// network_threshold arithmetic values or pointers by network, rather than
+// by insertion.
+
+namespace algorithm_impl
+{
+  constexpr std::size_t network_threshold = 16;
+
+  // Order the elements at a and b, without a branch if B is true.
+  template<typename I, typename C>
+    inline void
+    network_exchange(I a, I b, C comp, std::true_type)
+    {
+      Value_type<I> x = *a;
+      Value_type<I> y = *b;
+      bool s = comp(y, x);
+      *a = s ? y : x;
+      *b = s ? x : y;
+    }
+
+  template<typename I, typename C>
+    inline void
+    network_exchange(I a, I b, C comp, std::false_type)
+    {
+      if (comp(*b, *a))
+        std::iter_swap(a, b);
+    }
+
+  // Order the elements at a and b if Apply is true.
+  template<bool Apply, typename I, typename C, typename B>
+    inline Requires<Apply, void>
+    network_exchange_if(I a, I b, C comp, B branchless)
+    {
+      network_exchange(a, b, comp, branchless);
+    }
+
+  template<bool Apply, typename I, typename C, typename B>
+    inline Requires<!Apply, void>
+    network_exchange_if(I, I, C, B)
+    { }
+
+  // Returns 2^(t - 1), where t is the least integer such that 2^t >= n.
+  constexpr std::size_t
+  network_top(std::size_t n, std::size_t p = 1)
+  {
+    return 2 * p < n ? network_top(n, 2 * p) : p;
+  }
+
+  template<std::size_t N, std::size_t T, std::size_t P>
+    struct merge_exchange_pass;
+
+  // Step M3 of the merge exchange of N elements: compare-exchange the
+  // elements K and K + D if K & P is R, for each K with K + D < N, and then
+  // take step M4. T is 2^(t - 1).
+  template<std::size_t N, std::size_t T, std::size_t P, std::size_t Q,
+           std::size_t R, std::size_t D, std::size_t K,
+           bool Scan = (K + D < N)>
+    struct merge_exchange
+    {
+      template<typename I, typename C, typename B>
+        static void apply(I first, C comp, B b)
+        {
+          network_exchange_if<(K & P) == R>(first + K, first + (K + D),
+                                            comp, b);
+          merge_exchange<N, T, P, Q, R, D, K + 1>::apply(first, comp, b);
+        }
+    };
+
+  // Step M4: repeat step M3 with the next distance, or take step M5 when
+  // the last distance of the pass is done.
+  template<std::size_t N, std::size_t T, std::size_t P, std::size_t Q,
+           bool More = (Q != P)>
+    struct merge_exchange_next
+    {
+      template<typename I, typename C, typename B>
+        static void apply(I first, C comp, B b)
+        {
+          merge_exchange<N, T, P, Q / 2, P, Q - P, 0>::apply(first, comp, b);
+        }
+    };
+
+  template<std::size_t N, std::size_t T, std::size_t P, std::size_t Q>
+    struct merge_exchange_next<N, T, P, Q, false>
+    {
+      template<typename I, typename C, typename B>
+        static void apply(I first, C comp, B b)
+        {
+          merge_exchange_pass<N, T, P / 2>::apply(first, comp, b);
+        }
+    };
+
+  template<std::size_t N, std::size_t T, std::size_t P, std::size_t Q,
+           std::size_t R, std::size_t D, std::size_t K>
+    struct merge_exchange<N, T, P, Q, R, D, K, false>
+      : merge_exchange_next<N, T, P, Q>
+    { };
+
+  // Step M2: start the pass for P, which ends the network when it is 0.
+  template<std::size_t N, std::size_t T, std::size_t P>
+    struct merge_exchange_pass
+    {
+      template<typename I, typename C, typename B>
+        static void apply(I first, C comp, B b)
+        {
+          merge_exchange<N, T, P, T, 0, P, 0>::apply(first, comp, b);
+        }
+    };
+
+  template<std::size_t N, std::size_t T>
+    struct merge_exchange_pass<N, T, 0>
+    {
+      template<typename I, typename C, typename B>
+        static void apply(I, C, B) { }
+    };
+
+  // The sorting network for N elements.
+  template<std::size_t N>
+    using sorting_network
+      = merge_exchange_pass<N, network_top(N), network_top(N)>;
+
+  // Sort the n <= network_threshold elements at first by network. Fewer
+  // than 2 elements are sorted.
+  template<typename I, typename C, typename B>
+    void
+    network_sort(I first, std::size_t n, C comp, B b)
+    {
+      switch (n) {
+      case 2: sorting_network<2>::apply(first, comp, b); break;
+      case 3: sorting_network<3>::apply(first, comp, b); break;
+      case 4: sorting_network<4>::apply(first, comp, b); break;
+      case 5: sorting_network<5>::apply(first, comp, b); break;
+      case 6: sorting_network<6>::apply(first, comp, b); break;
+      case 7: sorting_network<7>::apply(first, comp, b); break;
+      case 8: sorting_network<8>::apply(first, comp, b); break;
+      case 9: sorting_network<9>::apply(first, comp, b); break;
+      case 10: sorting_network<10>::apply(first, comp, b); break;
+      case 11: sorting_network<11>::apply(first, comp, b); break;
+      case 12: sorting_network<12>::apply(first, comp, b); break;
+      case 13: sorting_network<13>::apply(first, comp, b); break;
+      case 14: sorting_network<14>::apply(first, comp, b); break;
+      case 15: sorting_network<15>::apply(first, comp, b); break;
+      case 16: sorting_network<16>::apply(first, comp, b); break;
+      default: break;
+      }
+    }
+
+  // Sort the n elements at first by a branchless network if there are at
+  // most network_threshold, returning true if they were sorted.
+  template<typename I, typename C>
+    inline bool
+    network_sort_small(I first, std::size_t n, C comp, std::true_type)
+    {
+      if (n > network_threshold)
+        return false;
+      network_sort(first, n, comp, std::true_type());
+      return true;
+    }
+
+  template<typename I, typename C>
+    inline bool
+    network_sort_small(I, std::size_t, C, std::false_type)
+    {
+      return false;
+    }
+
+} // namespace algorithm_impl
+
+
+// -------------------------------------------------------------------------- //
+// Pattern-defeating quicksort                                    [algo.pdqsort]
+//
+// The comparison sorts of the sort algorithms are a pattern-defeating
+// quicksort (pdqsort), after Orson Peters: an introsort whose partitioning
+// adapts to the patterns found in real data.
+//
+//    - The pivot is the median of three elements, or of three medians of
+//      three (the ninther) in ranges of more than ninther_threshold
+//      elements. Ranges of fewer than insertion_threshold elements are
+//      insertion sorted, or sorted by network (see [algo.network]) if
+//      they hold at most network_threshold arithmetic values or pointers.
+//    - When the pivot equals the element before the range, which bounds it
+//      from below, no element is less than the pivot, and the elements equal
+//      to it are partitioned to the left and not sorted again. Ranges with
+//      few distinct values are sorted in time linear in their size for each
+//      distinct value.
+//    - When a partition swaps no elements, each side is insertion sorted
+//      until more than partial_insertion_limit elements have been moved, so
+//      that sorted and nearly sorted ranges take linear time.
+//    - A highly unbalanced partition shuffles a few elements of each side,
+//      breaking the patterns that defeat the median selection. After log n
+//      such partitions, the range is heap sorted, bounding the sort by
+//      O(n log n) comparisons.
+//
+// When the elements are arithmetic values or pointers, comparisons are
+// usually cheap and their results unpredictable, so the partition is
+// branchless, after BlockQuicksort (Edelkamp and Weiss): blocks of
+// block_size elements from each end are compared with the pivot, the
+// offsets of the elements on the wrong side are recorded by adding the
+// result of each comparison to a counter, and then the recorded elements
+// are swapped in a cyclic permutation.
+//
+// Before partitioning, the range is scanned for an ascending or strictly
+// descending run at its front. A descending run is reversed. When the run
+// covers the range, the sort is done; when it covers at least half of the
+// range, as for appended or incrementally updated data, the rest is sorted
+// and merged into it (using a temporary buffer when one can be allocated).
+
+namespace algorithm_impl
+{
+  constexpr std::size_t insertion_threshold = 24;
+  constexpr std::size_t ninther_threshold = 128;
+  constexpr std::size_t partial_insertion_limit = 8;
+  constexpr std::size_t block_size = 64;
+
+  // Sort [first, last) by insertion. If Guarded is false, the element
+  // before first is not greater than any element of the range, and bounds
+  // the search for the position of each element.
+  template<bool Guarded, typename I, typename C>
+    void
+    pdq_insertion_sort(I first, I last, C comp)
+    {
+      if (first == last)
+        return;
+      for (I i = first + 1; i != last; ++i) {
+        I j = i;
+        I k = i - 1;
+        if (comp(*j, *k)) {
+          Value_type<I> x = std::move(*j);
+          do
+            *j-- = std::move(*k);
+          while ((!Guarded || j != first) && comp(x, *--k));
+          *j = std::move(x);
+        }
+      }
+    }
+
+  // Insertion sort [first, last), giving up when more than
+  // partial_insertion_limit elements have been moved. Returns true if the
+  // range is sorted.
+  template<typename I, typename C>
+    bool
+    pdq_partial_insertion_sort(I first, I last, C comp)
+    {
+      if (first == last)
+        return true;
+      std::size_t moved = 0;
+      for (I i = first + 1; i != last; ++i) {
+        I j = i;
+        I k = i - 1;
+        if (comp(*j, *k)) {
+          Value_type<I> x = std::move(*j);
+          do
+            *j-- = std::move(*k);
+          while (j != first && comp(x, *--k));
+          *j = std::move(x);
+          moved += i - j;
+        }
+        if (moved > partial_insertion_limit)
+          return false;
+      }
+      return true;
+    }
+
+  // Order the elements at a, b, and c.
+  template<typename I, typename C>
+    inline void
+    pdq_sort2(I a, I b, C comp)
+    {
+      if (comp(*b, *a))
+        std::iter_swap(a, b);
+    }
+
+  template<typename I, typename C>
+    inline void
+    pdq_sort3(I a, I b, I c, C comp)
+    {
+      pdq_sort2(a, b, comp);
+      pdq_sort2(b, c, comp);
+      pdq_sort2(a, b, comp);
+    }
+
+  // Partition [first, last) about the pivot *first, so that the elements
+  // less than the pivot precede it and the others follow it. Returns the
+  // position of the pivot, and true if no elements were swapped. There is
+  // an element not less than the pivot at or after the median position,
+  // and, unless first is the range being sorted, an element before first
+  // not greater than any element of the range.
+  template<typename I, typename C>
+    std::pair<I, bool>
+    pdq_partition_right(I first, I last, C comp)
+    {
+      Value_type<I> pivot = std::move(*first);
+      I b = first;
+      I e = last;
+      while (comp(*++b, pivot))
+        ;
+      if (b - 1 == first)
+        while (b < e && !comp(*--e, pivot))
+          ;
+      else
+        while (!comp(*--e, pivot))
+          ;
+      bool partitioned = b >= e;
+      while (b < e) {
+        std::iter_swap(b, e);
+        while (comp(*++b, pivot))
+          ;
+        while (!comp(*--e, pivot))
+          ;
+      }
+      I p = b - 1;
+      *first = std::move(*p);
+      *p = std::move(pivot);
+      return {p, partitioned};
+    }
+
+  // Exchange the elements at the num offsets of the left and right blocks,
+  // by swaps if the blocks have the same number of elements to move, and
+  // otherwise by a cyclic permutation.
+  template<typename I>
+    inline void
+    pdq_swap_offsets(I l, I r, const unsigned char* offsets_l,
+                     const unsigned char* offsets_r, std::size_t num,
+                     bool swaps)
+    {
+      if (swaps) {
+        for (std::size_t i = 0; i != num; ++i)
+          std::iter_swap(l + offsets_l[i], r - offsets_r[i]);
+      } else if (num) {
+        I a = l + offsets_l[0];
+        I b = r - offsets_r[0];
+        Value_type<I> x = std::move(*a);
+        *a = std::move(*b);
+        for (std::size_t i = 1; i != num; ++i) {
+          a = l + offsets_l[i];
+          *b = std::move(*a);
+          b = r - offsets_r[i];
+          *a = std::move(*b);
+        }
+        *b = std::move(x);
+      }
+    }
+
+  // Partition [first, last) as pdq_partition_right does, comparing blocks
+  // of elements without branching on the results.
+  template<typename I, typename C>
+    std::pair<I, bool>
+    pdq_partition_right_branchless(I first, I last, C comp)
+    {
+      Value_type<I> pivot = std::move(*first);
+      I b = first;
+      I e = last;
+      while (comp(*++b, pivot))
+        ;
+      if (b - 1 == first)
+        while (b < e && !comp(*--e, pivot))
+          ;
+      else
+        while (!comp(*--e, pivot))
+          ;
+      bool partitioned = b >= e;
+      if (!partitioned) {
+        std::iter_swap(b, e);
+        ++b;
+
+        // The offsets of the elements of the left block that are not less
+        // than the pivot, and of those of the right block that are.
+        unsigned char offsets_l[block_size];
+        unsigned char offsets_r[block_size];
+        I base_l = b;
+        I base_r = e;
+        std::size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+        while (b < e) {
+          // Refill the empty blocks, splitting the remaining elements
+          // between them when both are empty.
+          std::size_t unknown = e - b;
+          std::size_t split_l =
+            num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+          std::size_t split_r = num_r == 0 ? unknown - split_l : 0;
+          std::size_t len_l = std::min(split_l, block_size);
+          std::size_t len_r = std::min(split_r, block_size);
+          for (std::size_t i = 0; i != len_l; ++i) {
+            offsets_l[num_l] = i;
+            num_l += !comp(*b, pivot);
+            ++b;
+          }
+          for (std::size_t i = 0; i != len_r;) {
+            offsets_r[num_r] = ++i;
+            num_r += comp(*--e, pivot);
+          }
+
+          std::size_t num = std::min(num_l, num_r);
+          pdq_swap_offsets(base_l, base_r, offsets_l + start_l,
+                           offsets_r + start_r, num, num_l == num_r);
+          num_l -= num;
+          num_r -= num;
+          start_l += num;
+          start_r += num;
+          if (num_l == 0) {
+            start_l = 0;
+            base_l = b;
+          }
+          if (num_r == 0) {
+            start_r = 0;
+            base_r = e;
+          }
+        }
+
+        // Move the elements remaining in either block to the middle.
+        if (num_l) {
+          while (num_l--)
+            std::iter_swap(base_l + offsets_l[start_l + num_l], --e);
+          b = e;
+        }
+        if (num_r) {
+          while (num_r--)
+            std::iter_swap(base_r - offsets_r[start_r + num_r], b++);
+          e = b;
+        }
+      }
+      I p = b - 1;
+      *first = std::move(*p);
+      *p = std::move(pivot);
+      return {p, partitioned};
+    }
+
+  // Partition [first, last) about the pivot *first, so that the elements
+  // equal to the pivot precede it and the greater elements follow it. No
+  // element of the range is less than the pivot. Returns the position of
+  // the pivot.
+  template<typename I, typename C>
+    I
+    pdq_partition_left(I first, I last, C comp)
+    {
+      Value_type<I> pivot = std::move(*first);
+      I b = first;
+      I e = last;
+      while (comp(pivot, *--e))
+        ;
+      if (e + 1 == last)
+        while (b < e && !comp(pivot, *++b))
+          ;
+      else
+        while (!comp(pivot, *++b))
+          ;
+      while (b < e) {
+        std::iter_swap(b, e);
+        while (comp(pivot, *--e))
+          ;
+        while (!comp(pivot, *++b))
+          ;
+      }
+      *first = std::move(*e);
+      *e = std::move(pivot);
+      return e;
+    }
+
+  // Swap a few elements at each end of [first, last), whose size is n, with
+  // elements a quarter of the way in, to break up the pattern on one side
+  // of an unbalanced partition.
+  template<typename I>
+    inline void
+    pdq_shuffle(I first, I last, Difference_type<I> n)
+    {
+      Difference_type<I> q = n / 4;
+      std::iter_swap(first, first + q);
+      std::iter_swap(last - 1, last - q);
+      if (std::size_t(n) > ninther_threshold) {
+        std::iter_swap(first + 1, first + (q + 1));
+        std::iter_swap(first + 2, first + (q + 2));
+        std::iter_swap(last - 2, last - (q + 1));
+        std::iter_swap(last - 3, last - (q + 2));
+      }
+    }
+
+  // Sort [first, last), allowing bad more highly unbalanced partitions
+  // before falling back to heap sort. If leftmost is false, the element
+  // before first is not greater than any element of the range.
+  template<bool Branchless, typename I, typename C>
+    void
+    pdq_loop(I first, I last, C comp, int bad, bool leftmost)
+    {
+      using D = Difference_type<I>;
+      while (true) {
+        D n = last - first;
+        if (network_sort_small(first, n, comp,
+                               std::integral_constant<bool, Branchless>()))
+          return;
+        if (std::size_t(n) < insertion_threshold) {
+          if (leftmost)
+            pdq_insertion_sort<true>(first, last, comp);
+          else
+            pdq_insertion_sort<false>(first, last, comp);
+          return;
+        }
+
+        // Move the pivot to the front.
+        D h = n / 2;
+        if (std::size_t(n) > ninther_threshold) {
+          pdq_sort3(first, first + h, last - 1, comp);
+          pdq_sort3(first + 1, first + (h - 1), last - 2, comp);
+          pdq_sort3(first + 2, first + (h + 1), last - 3, comp);
+          pdq_sort3(first + (h - 1), first + h, first + (h + 1), comp);
+          std::iter_swap(first, first + h);
+        } else {
+          pdq_sort3(first + h, first, last - 1, comp);
+        }
+
+        // A pivot equal to the element before the range is the least
+        // element, and so are the elements equal to it.
+        if (!leftmost && !comp(*(first - 1), *first)) {
+          first = pdq_partition_left(first, last, comp) + 1;
+          continue;
+        }
+
+        std::pair<I, bool> part =
+          Branchless ? pdq_partition_right_branchless(first, last, comp)
+                     : pdq_partition_right(first, last, comp);
+        I p = part.first;
+        D l = p - first;
+        D r = last - (p + 1);
+        if (l < n / 8 || r < n / 8) {
+          if (--bad == 0) {
+            std::make_heap(first, last, comp);
+            std::sort_heap(first, last, comp);
+            return;
+          }
+          if (std::size_t(l) >= insertion_threshold)
+            pdq_shuffle(first, p, l);
+          if (std::size_t(r) >= insertion_threshold)
+            pdq_shuffle(p + 1, last, r);
+        } else if (part.second
+                   && pdq_partial_insertion_sort(first, p, comp)
+                   && pdq_partial_insertion_sort(p + 1, last, comp)) {
+          return;
+        }
+
+        // Sort the left side, and then loop on the right side.
+        pdq_loop<Branchless>(first, p, comp, bad, leftmost);
+        first = p + 1;
+        leftmost = false;
+      }
+    }
+
+  // Returns the end of the ascending or strictly descending run at the
+  // front of [first, last), which is reversed if it is descending.
+  template<typename I, typename C>
+    I
+    pdq_run(I first, I last, C comp)
+    {
+      I i = first + 1;
+      if (comp(*i, *first)) {
+        while (++i != last && comp(*i, *(i - 1)))
+          ;
+        std::reverse(first, i);
+      } else {
+        while (++i != last && !comp(*i, *(i - 1)))
+          ;
+      }
+      return i;
+    }
+
+  // Sort [first, last), whose front run ends at run, using the branchless
+  // partition if Branchless.
+  template<bool Branchless, typename I, typename C>
+    void
+    pdq_sort(I first, I run, I last, C comp)
+    {
+      if (run == last)
+        return;
+      std::size_t n = last - first;
+      int bad = 1;
+      for (std::size_t m = n; m > 1; m >>= 1)
+        ++bad;
+      if (std::size_t(run - first) >= n / 2) {
+        pdq_loop<Branchless>(run, last, comp, bad, true);
+        std::inplace_merge(first, run, last, comp);
+      } else {
+        pdq_loop<Branchless>(first, last, comp, bad, true);
+      }
+    }
+
+  // Values of type T are sorted with the branchless partition if they are
+  // arithmetic values or pointers.
+  template<typename T>
+    using Branchless_sortable
+      = std::integral_constant<bool, std::is_arithmetic<T>::value
+                                     || std::is_pointer<T>::value>;
+
+  // Sort [first, last) by pattern-defeating quicksort.
+  template<typename I, typename C>
+    void
+    comparison_sort(I first, I last, C comp)
+    {
+      if (last - first < 2)
+        return;
+      I run = pdq_run(first, last, comp);
+      pdq_sort<Branchless_sortable<Value_type<I>>::value>(first, run, last,
+                                                          comp);
+    }
+
+} // namespace algorithm_impl
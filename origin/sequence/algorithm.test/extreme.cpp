@@ -0,0 +1,145 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the first least, first greatest and last greatest elements of v,
+// ignoring NaNs, or the first element if they are all NaN.
+template<typename T>
+  void
+  expected(const vector<T>& v, size_t& lo, size_t& hi, size_t& last_hi)
+  {
+    lo = hi = last_hi = 0;
+    size_t i = 0;
+    while (i != v.size() && v[i] != v[i])
+      ++i;
+    if (i == v.size())
+      return;
+    lo = hi = last_hi = i;
+    for (; i != v.size(); ++i) {
+      if (v[i] != v[i])
+        continue;
+      if (v[i] < v[lo])
+        lo = i;
+      if (v[hi] < v[i])
+        hi = i;
+      if (!(v[i] < v[last_hi]))
+        last_hi = i;
+    }
+  }
+
+// The extremes of v are found serially, in parallel, and in a deque.
+template<typename T>
+  void
+  check(const vector<T>& v, const parallel_policy& p)
+  {
+    size_t lo, hi, last_hi;
+    expected(v, lo, hi, last_hi);
+    assert(size_t(min_element(v) - v.begin()) == lo);
+    assert(size_t(max_element(v) - v.begin()) == hi);
+    auto mm = minmax_element(v);
+    assert(size_t(mm.first - v.begin()) == lo);
+    assert(size_t(mm.second - v.begin()) == last_hi);
+
+    assert(size_t(min_element(p, v) - v.begin()) == lo);
+    assert(size_t(max_element(p, v) - v.begin()) == hi);
+    auto pm = minmax_element(p, v);
+    assert(pm.first == mm.first && pm.second == mm.second);
+
+    deque<T> d(v.begin(), v.end());
+    assert(size_t(min_element(d) - d.begin()) == lo);
+    assert(size_t(max_element(d) - d.begin()) == hi);
+    assert(size_t(minmax_element(d).second - d.begin()) == last_hi);
+  }
+
+// Check values drawn from few distinct values, so that there are ties,
+// with NaNs at random places when T is floating point.
+template<typename T>
+  void
+  check_random(size_t n, const parallel_policy& p, bool nans)
+  {
+    minstd_rand prng(n);
+    vector<T> v(n);
+    for (T& x : v) {
+      x = T(prng() % 50) - T(prng() % 2 ? 0 : 20);
+      if (nans && prng() % 7 == 0)
+        x = numeric_limits<T>::quiet_NaN();
+    }
+    check(v, p);
+  }
+
+// NaNs are neither least nor greatest, unless every element is NaN, and
+// negative and positive zeros are equal.
+template<typename T>
+  void
+  check_nan(const parallel_policy& p)
+  {
+    T nan = numeric_limits<T>::quiet_NaN();
+    for (size_t n : {1, 2, 7, 64, 100, 5000, 100000}) {
+      vector<T> v(n, nan);
+      check(v, p);
+      v.back() = T(3);
+      check(v, p);
+      v.front() = T(-1);
+      check(v, p);
+
+      vector<T> z(n, T(0));
+      for (size_t i = 0; i < n; i += 3)
+        z[i] = -T(0);
+      check(z, p);
+      assert(min_element(z) == z.begin());
+      assert(max_element(z) == z.begin());
+      assert(minmax_element(z).second == z.end() - 1);
+    }
+  }
+
+int main()
+{
+  task_scheduler s4(4);
+  parallel_policy p = par.on(s4);
+  for (size_t n : {1, 2, 3, 15, 16, 17, 63, 64, 65, 1000, 100000}) {
+    check_random<int>(n, p, false);
+    check_random<unsigned>(n, p, false);
+    check_random<long>(n, p, false);
+    check_random<float>(n, p, false);
+    check_random<float>(n, p, true);
+    check_random<double>(n, p, true);
+  }
+  check_nan<float>(p);
+  check_nan<double>(p);
+
+  // Unsigned values are ordered as unsigned, not as signed.
+  vector<unsigned> u {1, 0x80000000u, 7, 0xffffffffu, 0};
+  assert(*min_element(u) == 0 && *max_element(u) == 0xffffffffu);
+
+  // Other orders are used as given.
+  vector<int> v {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+  assert(*min_element(v, greater<int>()) == 9);
+  assert(*max_element(v, greater<int>()) == 1);
+  assert(max_element(v, greater<int>()) == v.begin() + 1);
+  assert(max(v, greater<int>()) == 1);
+  assert(minmax(v, greater<int>()).first == 9);
+  assert(minmax_element(v, greater<int>()).second == v.begin() + 3);
+  assert(minmax_element(p, v, greater<int>()).second == v.begin() + 3);
+  assert(max_element(p, v, greater<int>()) == v.begin() + 1);
+
+  vector<int> empty;
+  assert(min_element(empty) == empty.end());
+  assert(minmax_element(empty).second == empty.end());
+  assert(max_element(p, empty) == empty.end());
+}
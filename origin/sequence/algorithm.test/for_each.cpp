@@ -57,4 +57,9 @@ int main()
   for_each(v, doubler {});
   for_each(v2, doubler {});
   assert(v == v2);
+
+  // Test for_each_index with the index of each element
+  for_each_index(v, [&](size_t i, int& x) { x += int(i); });
+  for (size_t i = 0; i != v.size(); ++i)
+    assert(v[i] == 3 * int(i));
 }
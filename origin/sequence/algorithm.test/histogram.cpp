@@ -0,0 +1,111 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/range.hpp>
+
+using namespace std;
+using namespace origin;
+
+using edge = pair<size_t, size_t>;
+
+vector<edge>
+random_edges(size_t n, size_t m)
+{
+  minstd_rand prng(m);
+  vector<edge> es(m);
+  for (size_t i = 0; i != m; ++i)
+    es[i] = {prng() % n, i};
+  return es;
+}
+
+auto source = [](const edge& e) { return e.first; };
+
+// The offsets of a counting sort are those of the scanned histogram, and
+// the sort is stable: edges of the same source stay in order.
+void
+check_counting(const vector<edge>& es, size_t n, const vector<edge>& sorted,
+               const vector<size_t>& off)
+{
+  vector<size_t> degree = histogram(es, n, source);
+  assert(off.size() == n + 1 && off[0] == 0 && off[n] == es.size());
+  for (size_t v = 0; v != n; ++v)
+    assert(off[v + 1] - off[v] == degree[v]);
+  for (size_t v = 0; v != n; ++v)
+    for (size_t i = off[v]; i != off[v + 1]; ++i) {
+      assert(sorted[i].first == v);
+      assert(i == off[v] || sorted[i - 1].second < sorted[i].second);
+    }
+}
+
+void
+check_graph(size_t n, size_t m)
+{
+  task_scheduler s4(4);
+  vector<edge> es = random_edges(n, m);
+  vector<size_t> degree = histogram(es, n, source);
+  assert(histogram(par.on(s4), es, n, source) == degree);
+  size_t sum = 0;
+  for (size_t d : degree)
+    sum += d;
+  assert(sum == m);
+
+  vector<edge> a = es;
+  check_counting(es, n, a, counting_sort(a, n, source));
+  vector<edge> b = es;
+  check_counting(es, n, b, counting_sort(par.on(s4), b, n, source));
+  assert(a == b);
+}
+
+// Bucket sorting by a key that is monotone in the order sorts the range.
+void
+check_bucket()
+{
+  task_scheduler s4(4);
+  minstd_rand prng(2);
+  vector<int> v(200000);
+  for (int& x : v)
+    x = prng() % 100000;
+  vector<int> expected = v;
+  std::sort(expected.begin(), expected.end());
+  auto bin = [](int x) { return size_t(x / 1000); };
+  vector<int> a = v;
+  vector<size_t> off = bucket_sort(a, 100, bin);
+  assert(a == expected);
+  assert(off[1] == size_t(lower_bound(a.begin(), a.end(), 1000) - a.begin()));
+  vector<int> b = v;
+  assert(bucket_sort(par.on(s4), b, 100, bin) == off);
+  assert(b == expected);
+}
+
+int main()
+{
+  check_graph(1, 0);
+  check_graph(10, 1000);
+  check_graph(1000, 200000);
+  check_graph(100000, 300000);
+
+  // Integers are their own keys, and the range may be an input range.
+  vector<int> v {3, 1, 3, 0, 2, 3};
+  assert((histogram(v, 4) == vector<size_t> {1, 1, 1, 3}));
+  assert((counting_sort(v, 4) == vector<size_t> {0, 1, 2, 3, 6}));
+  assert((v == vector<int> {0, 1, 2, 3, 3, 3}));
+  istringstream in("1 1 0 2");
+  auto r = bounded_range<istream_iterator<int>>(istream_iterator<int>(in),
+                                                istream_iterator<int>());
+  assert((histogram(r, 3) == vector<size_t> {1, 2, 1}));
+
+  check_bucket();
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <random>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns a sorted sequence of n values in [0, m). If strict, the values are
+// distinct.
+template<typename T>
+  vector<T>
+  random_sorted(size_t n, size_t m, bool strict, unsigned seed)
+  {
+    minstd_rand prng(seed);
+    vector<T> v;
+    for (size_t i = 0; i != n; ++i)
+      v.push_back(T(prng() % m));
+    std::sort(v.begin(), v.end());
+    if (strict)
+      v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+  }
+
+template<typename T>
+  vector<T>
+  std_intersection(const vector<T>& a, const vector<T>& b)
+  {
+    vector<T> c;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          back_inserter(c));
+    return c;
+  }
+
+// The intersections and their sizes agree with std::set_intersection,
+// whether merging or galloping, and with duplicate elements.
+template<typename T>
+  void
+  check_intersection(const vector<T>& a, const vector<T>& b)
+  {
+    vector<T> expected = std_intersection(a, b);
+    vector<T> c(std::min(a.size(), b.size()));
+    auto i = set_intersection(a, b, c);
+    assert(vector<T>(c.begin(), i) == expected);
+    assert(set_intersection_size(a, b) == expected.size());
+    assert(set_intersection_size(a, b, less<T>()) == expected.size());
+
+    list<T> l(b.begin(), b.end());
+    assert(set_intersection_size(a, l) == expected.size());
+  }
+
+template<typename T>
+  void
+  check_strict(const vector<T>& a, const vector<T>& b)
+  {
+    vector<T> expected = std_intersection(a, b);
+    vector<T> c(std::min(a.size(), b.size()));
+    auto i = strict_set_intersection(a, b, c);
+    assert(vector<T>(c.begin(), i) == expected);
+    assert(strict_set_intersection_size(a, b) == expected.size());
+    check_intersection(a, b);
+  }
+
+template<typename T>
+  void
+  check_type()
+  {
+    for (size_t n : {0, 3, 17, 100, 1000})
+      for (size_t m : {0, 5, 64, 1000, 50000}) {
+        check_strict(random_sorted<T>(n, 3000, true, n + m),
+                     random_sorted<T>(m, 3000, true, n * m + 1));
+        check_intersection(random_sorted<T>(n, 300, false, n + m),
+                           random_sorted<T>(m, 300, false, n * m + 1));
+      }
+
+    // Identical and disjoint ranges.
+    vector<T> a = random_sorted<T>(1000, 100000, true, 1);
+    check_strict(a, a);
+    vector<T> b(a.size());
+    for (size_t i = 0; i != a.size(); ++i)
+      b[i] = a[i] + 100000;
+    check_strict(a, b);
+  }
+
+int main()
+{
+  static_assert(algorithm_impl::Simd_intersection<vector<uint32_t>&,
+                                                  vector<uint32_t>&>()
+                || !algorithm_impl::Simd_comparable<uint32_t>(), "");
+  check_type<uint32_t>();
+  check_type<int32_t>();
+  check_type<uint64_t>();
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/range.hpp>
+
+using namespace std;
+using namespace origin;
+
+using P = pair<int, int>;
+
+// Pairs are ordered by their first elements only, so that the stability of
+// merges can be checked with the second.
+bool first_less(const P& a, const P& b) { return a.first < b.first; }
+bool first_greater(const P& a, const P& b) { return a.first > b.first; }
+
+// Returns k sorted runs of random sizes. Each element is paired with its
+// run and position, so its source can be identified.
+vector<vector<P>>
+random_runs(size_t k, size_t n, unsigned seed)
+{
+  minstd_rand prng(seed);
+  vector<vector<P>> runs(k);
+  for (size_t r = 0; r != k; ++r) {
+    size_t m = prng() % (2 * n + 1);
+    for (size_t i = 0; i != m; ++i)
+      runs[r].push_back(P(prng() % 100, r * 100000 + i));
+    std::sort(runs[r].begin(), runs[r].end(), first_less);
+  }
+  return runs;
+}
+
+// The merge of the runs is their concatenation, stably sorted.
+void
+check_merge(const vector<vector<P>>& runs)
+{
+  vector<P> expected;
+  for (const vector<P>& r : runs)
+    expected.insert(expected.end(), r.begin(), r.end());
+  std::stable_sort(expected.begin(), expected.end(), first_less);
+
+  vector<P> out(expected.size());
+  assert(k_way_merge(runs, out, first_less) == out.end());
+  assert(out == expected);
+
+  // Runs can be given as bounded ranges, and merged in reverse order.
+  vector<bounded_range<vector<P>::const_iterator>> views;
+  vector<vector<P>> reversed = runs;
+  for (vector<P>& r : reversed) {
+    std::reverse(r.begin(), r.end());
+    std::stable_sort(r.begin(), r.end(), first_greater);
+    views.push_back({r.begin(), r.end()});
+  }
+  assert(k_way_merge(views, out, first_greater) == out.end());
+  for (size_t i = 1; i < out.size(); ++i)
+    assert(out[i - 1].first >= out[i].first);
+}
+
+void
+check_values()
+{
+  // The default ordering is operator<.
+  vector<vector<int>> runs {{1, 4, 9}, {}, {2, 3, 10, 11}, {0}, {5}};
+  vector<int> out(9);
+  assert(k_way_merge(runs, out) == out.end());
+  assert((out == vector<int>{0, 1, 2, 3, 4, 5, 9, 10, 11}));
+
+  vector<vector<int>> none;
+  assert(k_way_merge(none, out) == out.begin());
+  vector<vector<int>> one {{3, 4}};
+  assert(k_way_merge(one, out) == out.begin() + 2);
+  assert(out[0] == 3 && out[1] == 4);
+}
+
+// The parallel merge is stable, and balanced on skewed inputs, in which one
+// range has all the small values.
+void
+check_parallel()
+{
+  task_scheduler s4(4);
+  vector<vector<P>> runs = random_runs(2, 50000, 3);
+  vector<P> a = runs[0];
+  vector<P> b = runs[1];
+  vector<P> c(a.size() + b.size());
+  vector<P> d(c.size());
+  assert(merge(par.on(s4), a, b, c, first_less) == c.end());
+  merge(a, b, d, first_less);
+  assert(c == d);
+
+  vector<int> x(100000);
+  vector<int> y(3000);
+  for (size_t i = 0; i != x.size(); ++i)
+    x[i] = i;
+  for (size_t i = 0; i != y.size(); ++i)
+    y[i] = i * 50;
+  vector<int> z(x.size() + y.size());
+  vector<int> w(z.size());
+  merge(par.on(s4), x, y, z);
+  merge(x, y, w);
+  assert(z == w);
+}
+
+int main()
+{
+  check_values();
+  for (size_t k : {1, 2, 3, 7, 16, 100})
+    check_merge(random_runs(k, 500, k));
+  check_parallel();
+}
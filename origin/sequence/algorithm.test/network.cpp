@@ -0,0 +1,115 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <array>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The network for N elements sorts every sequence of 0s and 1s, and so, by
+// the 0-1 principle, every sequence.
+template<size_t N>
+  void
+  check_zero_one()
+  {
+    for (size_t bits = 0; bits != (size_t(1) << N); ++bits) {
+      array<int, N> a;
+      for (size_t i = 0; i != N; ++i)
+        a[i] = (bits >> i) & 1;
+      sort_n(a);
+      assert(is_sorted(a));
+    }
+  }
+
+// Random values of several types and orders are sorted as by std::sort.
+template<size_t N>
+  void
+  check_random()
+  {
+    minstd_rand prng(N);
+    for (int k = 0; k != 100; ++k) {
+      double d[N];
+      vector<int> v(N);
+      array<string, N> s;
+      for (size_t i = 0; i != N; ++i) {
+        d[i] = double(prng() % 50) / 4;
+        v[i] = int(prng() % 50) - 25;
+        s[i] = to_string(prng() % 50);
+      }
+
+      vector<double> e(d, d + N);
+      std::sort(e.begin(), e.end());
+      sort_n(d);
+      assert(equal(e.begin(), e.end(), d));
+
+      vector<int> w = v;
+      std::sort(w.begin(), w.end(), greater<int>());
+      sort_n<N>(v.begin(), greater<int>());
+      assert(v == w);
+
+      array<string, N> t = s;
+      std::sort(t.begin(), t.end());
+      sort_n(s);
+      assert(s == t);
+    }
+  }
+
+// Small ranges are sorted by network within sort.
+void
+check_sort()
+{
+  minstd_rand prng(7);
+  for (size_t n = 0; n != 40; ++n) {
+    vector<unsigned> v(n);
+    for (unsigned& x : v)
+      x = prng() % 10;
+    vector<unsigned> w = v;
+    std::sort(w.begin(), w.end());
+    sort(v);
+    assert(v == w);
+
+    vector<float> f(n);
+    for (float& x : f)
+      x = float(prng() % 10) - 5;
+    vector<float> g = f;
+    std::sort(g.begin(), g.end(), greater<float>());
+    sort(f, greater<float>());
+    assert(f == g);
+  }
+}
+
+int main()
+{
+  check_zero_one<1>();
+  check_zero_one<2>();
+  check_zero_one<3>();
+  check_zero_one<4>();
+  check_zero_one<5>();
+  check_zero_one<6>();
+  check_zero_one<7>();
+  check_zero_one<8>();
+  check_zero_one<9>();
+  check_zero_one<12>();
+  check_zero_one<13>();
+  check_zero_one<16>();
+  check_zero_one<17>();
+  check_zero_one<20>();
+
+  check_random<3>();
+  check_random<10>();
+  check_random<16>();
+  check_random<32>();
+
+  check_sort();
+}
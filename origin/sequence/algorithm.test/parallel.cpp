@@ -0,0 +1,256 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+using V = vector<int>;
+
+bool odd(int n) { return n & 1; }
+
+// Returns n pseudo-random values in [0, m).
+V
+random_values(size_t n, int m, unsigned seed)
+{
+  minstd_rand prng(seed);
+  uniform_int_distribution<int> dist(0, m - 1);
+  V v(n);
+  for (int& x : v)
+    x = dist(prng);
+  return v;
+}
+
+void
+check_queries(const parallel_policy& p, const V& v)
+{
+  auto big = [](int x) { return x > 900; };
+  auto small = [](int x) { return x < 0; };
+  assert(all_of(p, v, big) == all_of(v, big));
+  assert(any_of(p, v, big) == any_of(v, big));
+  assert(none_of(p, v, small) == none_of(v, small));
+  assert(!any_of(p, v, small));
+
+  assert(find(p, v, 999) == find(v, 999));
+  assert(find(p, v, -1) == v.end());
+  assert(find_if(p, v, big) == find_if(v, big));
+  assert(find_if_not(p, v, odd) == find_if_not(v, odd));
+
+  assert(count(p, v, 7) == count(v, 7));
+  assert(count_if(p, v, odd) == count_if(v, odd));
+
+  assert(min_element(p, v) == min_element(v));
+  assert(max_element(p, v) == max_element(v));
+  assert(max_element(p, v, greater<int>()) == max_element(v, greater<int>()));
+}
+
+void
+check_modifiers(const parallel_policy& p, const V& v)
+{
+  V a(v.size());
+  assert(copy(p, v, a) == a.end());
+  assert(a == v);
+
+  fill(p, a, 3);
+  assert(count(a, 3) == V::difference_type(a.size()));
+
+  V b(v.size());
+  range_transform(p, v, b, [](int x) { return x * 2; });
+  for (size_t i = 0; i != v.size(); ++i)
+    assert(b[i] == v[i] * 2);
+  range_transform(p, v, b, a, plus<int>());
+  for (size_t i = 0; i != v.size(); ++i)
+    assert(a[i] == v[i] * 3);
+
+  atomic<long> sum(0);
+  for_each(p, v, [&sum](int x) { sum += x; });
+  long total = 0;
+  for (int x : v)
+    total += x;
+  assert(sum == total);
+
+  // Each index is visited once with its element, in blocks of a chunked
+  // policy's size.
+  vector<atomic<int>> seen(v.size());
+  for (auto& x : seen)
+    x.store(0);
+  for_each_index(p.chunked(100), v, [&](size_t i, int x) {
+    assert(x == v[i]);
+    ++seen[i];
+  });
+  for (auto& x : seen)
+    assert(x.load() == 1);
+  V c(v.size());
+  range_transform(p.chunked(7), v, c, [](int x) { return x + 1; });
+  for (size_t i = 0; i != v.size(); ++i)
+    assert(c[i] == v[i] + 1);
+}
+
+// The filters equal the serial filters.
+void
+check_filters(const parallel_policy& p, const V& v)
+{
+  auto big = [](int x) { return x > 900; };
+  V a(v.size()), b(v.size());
+  auto i = copy_if(v, a, big);
+  auto j = copy_if(p, v, b, big);
+  assert(j - b.begin() == i - a.begin());
+  assert(equal(a.begin(), i, b.begin()));
+
+  i = remove_copy(v, a, 7);
+  j = remove_copy(p, v, b, 7);
+  assert(j - b.begin() == i - a.begin());
+  assert(equal(a.begin(), i, b.begin()));
+
+  i = remove_copy_if(v, a, odd);
+  j = remove_copy_if(p, v, b, odd);
+  assert(j - b.begin() == i - a.begin());
+  assert(equal(a.begin(), i, b.begin()));
+
+  a = v;
+  b = v;
+  i = remove(a, 7);
+  j = remove(p, b, 7);
+  assert(j - b.begin() == i - a.begin());
+  assert(equal(a.begin(), i, b.begin()));
+
+  a = v;
+  b = v;
+  i = remove_if(a, big);
+  j = remove_if(p, b, big);
+  assert(j - b.begin() == i - a.begin());
+  assert(equal(a.begin(), i, b.begin()));
+}
+
+void
+check_sort(const parallel_policy& p, const V& v)
+{
+  V a = v;
+  V b = v;
+  sort(p, a);
+  sort(b);
+  assert(a == b);
+
+  a = v;
+  sort(p, a, greater<int>());
+  sort(b, greater<int>());
+  assert(a == b);
+
+  // Stable sorting preserves the order of equivalent elements.
+  vector<pair<int, size_t>> x(v.size());
+  for (size_t i = 0; i != v.size(); ++i)
+    x[i] = make_pair(v[i] % 10, i);
+  auto first = [](const pair<int, size_t>& a, const pair<int, size_t>& b) {
+    return a.first < b.first;
+  };
+  vector<pair<int, size_t>> y = x;
+  stable_sort(p, x, first);
+  stable_sort(y, first);
+  assert(x == y);
+
+  a = v;
+  b = v;
+  stable_sort(p, a);
+  sort(b);
+  assert(a == b);
+}
+
+void
+check_merge(const parallel_policy& p, V a, V b)
+{
+  sort(a);
+  sort(b);
+  V c(a.size() + b.size());
+  V d(c.size());
+  assert(merge(p, a, b, c) == c.end());
+  merge(a, b, d);
+  assert(c == d);
+}
+
+void
+check_sets(const parallel_policy& p, V a, V b)
+{
+  sort(a);
+  sort(b);
+  V c(a.size() + b.size());
+  V d(c.size());
+
+  auto n = set_union(p, a, b, c) - c.begin();
+  auto m = set_union(a, b, d) - d.begin();
+  assert(n == m && equal(c.begin(), c.begin() + n, d.begin()));
+
+  n = set_intersection(p, a, b, c) - c.begin();
+  m = set_intersection(a, b, d) - d.begin();
+  assert(n == m && equal(c.begin(), c.begin() + n, d.begin()));
+
+  n = set_difference(p, a, b, c) - c.begin();
+  m = set_difference(a, b, d) - d.begin();
+  assert(n == m && equal(c.begin(), c.begin() + n, d.begin()));
+
+  n = set_symmetric_difference(p, a, b, c) - c.begin();
+  m = set_symmetric_difference(a, b, d) - d.begin();
+  assert(n == m && equal(c.begin(), c.begin() + n, d.begin()));
+
+  assert(includes(p, a, b) == includes(a, b));
+  V s(a.begin(), a.begin() + a.size() / 3);
+  assert(includes(p, a, s));
+  s.push_back(-1);
+  sort(s);
+  assert(!includes(p, a, s));
+}
+
+void
+check_all(const parallel_policy& p)
+{
+  V v = random_values(200000, 1000, 1);
+  V w = random_values(50000, 1000, 2);
+  check_queries(p, v);
+  check_modifiers(p, v);
+  check_filters(p, v);
+  check_sort(p, v);
+  check_merge(p, v, w);
+  check_sets(p, v, w);
+  check_sets(p, w, v);
+
+  // Small and empty ranges are processed serially.
+  V u {3, 1, 2};
+  sort(p, u);
+  assert((u == V{1, 2, 3}));
+  V e;
+  sort(p, e);
+  assert(find(p, e, 0) == e.end());
+  assert(count(p, e, 0) == 0);
+  assert(min_element(p, e) == e.end());
+  assert(remove_if(p, e, odd) == e.end());
+  assert(copy_if(p, e, u, odd) == u.begin());
+}
+
+int main()
+{
+  task_scheduler s1(1);
+  task_scheduler s4(4);
+  check_all(par);
+  check_all(par.on(s1));
+  check_all(par.on(s4));
+
+  // Temporary policies select the parallel overloads.
+  V v = random_values(10000, 1000, 3);
+  V w = v;
+  sort(par.on(s4), v);
+  sort(w);
+  assert(v == w);
+  assert(count(par.on(s4), v, 7) == count(w, 7));
+}
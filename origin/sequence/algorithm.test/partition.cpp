@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+using V = vector<int>;
+
+// Returns n pseudo-random values in [0, m).
+V
+random_values(size_t n, int m, unsigned seed)
+{
+  minstd_rand prng(seed);
+  uniform_int_distribution<int> dist(0, m - 1);
+  V v(n);
+  for (int& x : v)
+    x = dist(prng);
+  return v;
+}
+
+void
+check_partition(const parallel_policy& p, const V& v)
+{
+  auto small = [](int x) { return x < 300; };
+  V expected = v;
+  auto m = std::stable_partition(expected.begin(), expected.end(), small);
+
+  V a = v;
+  auto i = partition(p, a, small);
+  assert(i - a.begin() == m - expected.begin());
+  assert(all_of(a.begin(), i, small));
+  assert(none_of(i, a.end(), small));
+  sort(a);
+  V b = v;
+  sort(b);
+  assert(a == b);
+
+  // Stable partitioning preserves the order of elements in each part.
+  a = v;
+  assert(stable_partition(p, a, small) - a.begin() == m - expected.begin());
+  assert(a == expected);
+}
+
+template<typename C>
+  void
+  check_select(const parallel_policy& p, const V& v, C comp)
+  {
+    V sorted = v;
+    sort(sorted, comp);
+    for (size_t k : {size_t(0), v.size() / 3, v.size() - 1}) {
+      V a = v;
+      nth_element(p, a, a.begin() + k, comp);
+      assert(a[k] == sorted[k]);
+      for (size_t i = 0; i != k; ++i)
+        assert(!comp(a[k], a[i]));
+      for (size_t i = k + 1; i != a.size(); ++i)
+        assert(!comp(a[i], a[k]));
+
+      a = v;
+      partial_sort(p, a, a.begin() + k, comp);
+      assert(equal(a.begin(), a.begin() + k, sorted.begin()));
+    }
+  }
+
+void
+check_all(const parallel_policy& p)
+{
+  for (int m : {1000000, 1000, 3}) {
+    V v = random_values(200000, m, m);
+    check_partition(p, v);
+    check_select(p, v, less<int>());
+    check_select(p, v, greater<int>());
+  }
+
+  V v = random_values(200000, 1000, 7);
+  V a = v;
+  nth_element(p, a, a.end());
+  partial_sort(p, a, a.end());
+  sort(v);
+  assert(a == v);
+  nth_element(p, a, a.begin() + 5);
+  assert(a[5] == v[5]);
+
+  V e;
+  assert(partition(p, e, [](int) { return true; }) == e.end());
+  nth_element(p, e, e.end());
+}
+
+void
+check_serial()
+{
+  V v = random_values(10000, 100, 8);
+  V a = v;
+  V b = v;
+  partial_sort(a, a.begin() + 100);
+  std::partial_sort(b.begin(), b.begin() + 100, b.end());
+  assert(equal(a.begin(), a.begin() + 100, b.begin()));
+  partial_sort(a.begin(), a.begin() + 100, a.end(), greater<int>());
+
+  a = v;
+  nth_element(a, a.begin() + 50, greater<int>());
+  b = v;
+  sort(b, greater<int>());
+  assert(a[50] == b[50]);
+  nth_element(a.begin(), a.begin() + 50, a.end());
+}
+
+int main()
+{
+  task_scheduler s1(1);
+  task_scheduler s4(4);
+  check_all(par);
+  check_all(par.on(s1));
+  check_all(par.on(s4));
+  check_serial();
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+using V = vector<int>;
+
+// Returns ranges of n values with the patterns that defeat naive
+// quicksorts: sorted, reversed, equal, few distinct values, organ pipes,
+// saw teeth, and sorted with an unsorted tail.
+vector<V>
+patterns(size_t n, unsigned seed)
+{
+  minstd_rand prng(seed);
+  vector<V> ps(9, V(n));
+  for (size_t i = 0; i != n; ++i) {
+    int x = int(i);
+    ps[0][i] = prng() % (4 * n + 1);
+    ps[1][i] = x;
+    ps[2][i] = int(n) - x;
+    ps[3][i] = 7;
+    ps[4][i] = prng() % 4;
+    ps[5][i] = i < n / 2 ? x : int(n) - x;
+    ps[6][i] = x % 31;
+    ps[7][i] = i < n - n / 8 ? x : int(prng() % n);
+    ps[8][i] = i % 2 ? x : -x;
+  }
+  return ps;
+}
+
+// Sorting v by comp orders it as std::sort does.
+template<typename C>
+  void
+  check_sort(V v, C comp)
+  {
+    V expected = v;
+    std::sort(expected.begin(), expected.end(), comp);
+    sort(v, comp);
+    assert(v == expected);
+  }
+
+// Strings are partitioned with branches; greater<int> is not the default
+// order, so ints are not radix sorted.
+void
+check_patterns(size_t n)
+{
+  for (const V& v : patterns(n, n)) {
+    check_sort(v, less<int>());
+    check_sort(v, greater<int>());
+
+    vector<string> s;
+    for (int x : v)
+      s.push_back(to_string(x));
+    vector<string> t = s;
+    std::sort(t.begin(), t.end());
+    sort(s);
+    assert(s == t);
+  }
+}
+
+// Move-only values are sorted, serially and in parallel.
+void
+check_move_only(const parallel_policy& p)
+{
+  auto deref = [](const unique_ptr<int>& a, const unique_ptr<int>& b) {
+    return *a < *b;
+  };
+  for (size_t n : {10, 1000, 100000}) {
+    vector<unique_ptr<int>> a;
+    vector<unique_ptr<int>> b;
+    minstd_rand prng(3);
+    for (size_t i = 0; i != n; ++i) {
+      int x = prng() % 1000;
+      a.emplace_back(new int(x));
+      b.emplace_back(new int(x));
+    }
+    sort(a, deref);
+    sort(p, b, deref);
+    for (size_t i = 0; i != n; ++i)
+      assert(*a[i] == *b[i]);
+    assert(is_sorted(a, deref));
+  }
+}
+
+// The parallel sort distributes the patterns into buckets.
+void
+check_parallel(const parallel_policy& p)
+{
+  for (const V& v : patterns(300000, 5)) {
+    V a = v;
+    V b = v;
+    sort(p, a, greater<int>());
+    std::sort(b.begin(), b.end(), greater<int>());
+    assert(a == b);
+
+    vector<double> c(v.begin(), v.end());
+    vector<double> d = c;
+    auto by_value = [](double x, double y) { return x < y; };
+    sort(p, c, by_value);
+    std::sort(d.begin(), d.end());
+    assert(c == d);
+  }
+}
+
+int main()
+{
+  for (size_t n : {0, 1, 2, 3, 23, 24, 25, 100, 129, 1000, 5000, 100000})
+    check_patterns(n);
+
+  task_scheduler s4(4);
+  check_move_only(par.on(s4));
+  check_parallel(par.on(s4));
+  check_parallel(par);
+}
@@ -7,6 +7,8 @@
 
 #include <cassert>
 #include <iostream>
+#include <list>
+#include <string>
 #include <vector>
 
 #include <origin/sequence/algorithm.hpp>
@@ -23,6 +25,59 @@ template <typename R>
     cout << '\n';
   }
 
+// A type with equality but no order or hash.
+struct point
+{
+  int x, y;
+};
+
+bool operator==(point a, point b) { return a.x == b.x && a.y == b.y; }
+bool operator!=(point a, point b) { return !(a == b); }
+
+// The permutations of values that are hashed, sorted, or only compared.
+void
+check_is_permutation()
+{
+  vector<int> a {3, 1, 4, 1, 5, 9, 2, 6};
+  vector<int> b {1, 1, 2, 3, 4, 5, 6, 9};
+  vector<int> c {1, 2, 2, 3, 4, 5, 6, 9};
+  assert(range_is_permutation(a, b));
+  assert(!range_is_permutation(a, c));
+  assert(range_is_permutation(vector<int> {}, vector<int> {}));
+
+  // Only the first elements of range2 are compared.
+  vector<int> d = b;
+  d.push_back(7);
+  assert(range_is_permutation(a, d));
+
+  list<string> s {"a", "b", "c", "b"};
+  vector<string> t {"b", "b", "a", "c"};
+  assert(range_is_permutation(s, t));
+  t[0] = "c";
+  assert(!range_is_permutation(s, t));
+
+  vector<vector<int>> u {{1}, {2, 3}, {}};
+  vector<vector<int>> w {{}, {1}, {2, 3}};
+  assert(range_is_permutation(u, w));
+  w[0] = {2};
+  assert(!range_is_permutation(u, w));
+
+  vector<point> p {{1, 2}, {3, 4}, {1, 2}};
+  vector<point> q {{3, 4}, {1, 2}, {1, 2}};
+  assert(range_is_permutation(p, q));
+  q[0] = {1, 2};
+  assert(!range_is_permutation(p, q));
+
+  // Large permutations are decided in linear time.
+  vector<int> big(1000000);
+  for (size_t i = 0; i != big.size(); ++i)
+    big[i] = int(i);
+  vector<int> rev(big.rbegin(), big.rend());
+  assert(range_is_permutation(big, rev));
+  rev[0] = -1;
+  assert(!range_is_permutation(big, rev));
+}
+
 int main()
 {
   using V = vector<int>;
@@ -87,4 +142,6 @@ int main()
     if (!x)
       break;
   }
+
+  check_is_permutation();
 }
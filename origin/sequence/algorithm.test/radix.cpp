@@ -0,0 +1,153 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns n pseudo-random values of type T in [lo, hi]. Byte values are
+// drawn as ints, since they cannot be generated directly.
+template<typename T>
+  vector<T>
+  random_integers(size_t n, T lo, T hi, unsigned seed)
+  {
+    using D = typename conditional<sizeof(T) == 1, int, T>::type;
+    mt19937_64 prng(seed);
+    uniform_int_distribution<D> dist(lo, hi);
+    vector<T> v(n);
+    for (T& x : v)
+      x = dist(prng);
+    return v;
+  }
+
+template<typename T>
+  vector<T>
+  random_reals(size_t n, T lo, T hi, unsigned seed)
+  {
+    minstd_rand prng(seed);
+    uniform_real_distribution<T> dist(lo, hi);
+    vector<T> v(n);
+    for (T& x : v)
+      x = dist(prng);
+    return v;
+  }
+
+// Radix sorting v, serially and in parallel, is equivalent to sorting it
+// with std::sort, as is sorting with the default ordering.
+template<typename T>
+  void
+  check_radix(const vector<T>& v)
+  {
+    vector<T> expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    vector<T> a = v;
+    radix_sort(a);
+    assert(a == expected);
+
+    task_scheduler s4(4);
+    a = v;
+    radix_sort(par.on(s4), a);
+    assert(a == expected);
+
+    a = v;
+    sort(a);
+    assert(a == expected);
+    a = v;
+    sort(a, less<T>());
+    assert(a == expected);
+    a = v;
+    stable_sort(a);
+    assert(a == expected);
+    a = v;
+    sort(par.on(s4), a);
+    assert(a == expected);
+  }
+
+template<typename T>
+  void
+  check_integers()
+  {
+    using L = numeric_limits<T>;
+    check_radix(random_integers<T>(100000, L::min(), L::max(), 1));
+    check_radix(random_integers<T>(100000, 0, 100, 2));
+    check_radix(random_integers<T>(20000, L::min(), L::max(), 3));
+    check_radix(random_integers<T>(100, L::min(), L::max(), 4));
+    check_radix(vector<T>(5000, T(7)));
+    check_radix(vector<T>());
+  }
+
+void
+check_reals()
+{
+  vector<double> d = random_reals<double>(100000, -1e6, 1e6, 5);
+  d.push_back(0.0);
+  d.push_back(numeric_limits<double>::infinity());
+  d.push_back(-numeric_limits<double>::infinity());
+  d.push_back(numeric_limits<double>::max());
+  d.push_back(-numeric_limits<double>::min());
+  check_radix(d);
+
+  vector<float> f = random_reals<float>(100000, -1.0f, 1.0f, 6);
+  f.push_back(numeric_limits<float>::denorm_min());
+  f.push_back(-numeric_limits<float>::denorm_min());
+  check_radix(f);
+}
+
+// Sorting pairs by key is stable.
+void
+check_keys()
+{
+  using P = pair<uint32_t, size_t>;
+  vector<uint32_t> k = random_integers<uint32_t>(100000, 0, 5000, 7);
+  vector<P> v(k.size());
+  for (size_t i = 0; i != k.size(); ++i)
+    v[i] = P(k[i], i);
+  auto key = [](const P& p) { return p.first; };
+
+  vector<P> expected = v;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const P& a, const P& b) { return a.first < b.first; });
+
+  vector<P> a = v;
+  radix_sort(a, key);
+  assert(a == expected);
+
+  task_scheduler s4(4);
+  a = v;
+  radix_sort(par.on(s4), a, key);
+  assert(a == expected);
+
+  // Keys can also be computed, here reversing the order.
+  a = v;
+  radix_sort(a, [](const P& p) { return -int64_t(p.first); });
+  for (size_t i = 1; i < a.size(); ++i)
+    assert(a[i - 1].first >= a[i].first);
+}
+
+int main()
+{
+  check_integers<uint8_t>();
+  check_integers<int16_t>();
+  check_integers<int32_t>();
+  check_integers<uint32_t>();
+  check_integers<int64_t>();
+  check_integers<uint64_t>();
+  check_reals();
+  check_keys();
+}
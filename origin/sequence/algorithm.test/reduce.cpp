@@ -0,0 +1,118 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <origin/concurrency/scheduler.hpp>
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The serial and parallel reductions of n integers of type T equal their
+// sums, including those of the vector kernels and their tails.
+template<typename T>
+  void
+  check_sums(task_scheduler& s, size_t n)
+  {
+    mt19937 prng {unsigned(n)};
+    vector<T> v(n), w(n);
+    for (size_t i = 0; i != n; ++i) {
+      v[i] = T(prng() % 100);
+      w[i] = T(prng() % 10);
+    }
+    T sum = accumulate(v.begin(), v.end(), T(3));
+    T dot = T(3);
+    for (size_t i = 0; i != n; ++i)
+      dot = T(dot + v[i] * w[i]);
+    auto twice = [](T x) { return T(2 * x); };
+
+    assert(reduce(v, T(3)) == sum);
+    assert(transform_reduce(v, T(6), plus<T>(), twice) == T(2 * sum));
+    assert(transform_reduce(v, w, T(3)) == dot);
+
+    auto pol = par.on(s);
+    assert(reduce(pol, v, T(3)) == sum);
+    assert(reduce(pol.deterministic(), v, T(3)) == sum);
+    assert(transform_reduce(pol, v, T(6), plus<T>(), twice) == T(2 * sum));
+    assert(transform_reduce(pol, v, w, T(3)) == dot);
+  }
+
+// A deterministic sum of floating point values is the same for any number
+// of threads.
+template<typename T>
+  void
+  check_deterministic()
+  {
+    mt19937 prng {7};
+    uniform_real_distribution<T> dist(-1, 1);
+    vector<T> v(300007);
+    for (T& x : v)
+      x = dist(prng) * T(1 << (prng() % 20));
+
+    task_scheduler s1(1), s2(2), s3(3), s4(4);
+    T r = reduce(par.on(s1).deterministic(), v, T(0));
+    assert(reduce(par.on(s2).deterministic(), v, T(0)) == r);
+    assert(reduce(par.on(s3).deterministic(), v, T(0)) == r);
+    assert(reduce(par.deterministic().on(s4), v, T(0)) == r);
+
+    T d = transform_reduce(par.on(s1).deterministic(), v, v, T(0));
+    assert(transform_reduce(par.on(s3).deterministic(), v, v, T(0)) == d);
+    assert(transform_reduce(par.on(s4).deterministic(), v, v, T(0)) == d);
+
+    // The vector and scalar partial sums round in the same way.
+    list<T> l(v.begin(), v.end());
+    assert(reduce(v, T(1)) == reduce(l, T(1)));
+  }
+
+// Other operations, value types, and ranges.
+void
+check_ops(task_scheduler& s)
+{
+  vector<int> v {3, 1, 4, 1, 5, 9, 2, 6};
+  auto max_op = [](int a, int b) { return max(a, b); };
+  assert(reduce(v, 0, max_op) == 9);
+  assert(reduce(v, 1, multiplies<int>()) == 6480);
+  assert(reduce(par.on(s), v, 10, max_op) == 10);
+
+  list<int> l(v.begin(), v.end());
+  assert(reduce(l, 0L) == 31);
+  assert(transform_reduce(l, 0, plus<int>(), [](int x) { return x * x; })
+         == 173);
+
+  vector<double> d(100000, 0.5);
+  assert(reduce(par.on(s), d, 1.0) == 50001);
+  assert(transform_reduce(par.on(s), d, d, 0.0) == 25000);
+  vector<int> big(100000, 2);
+  assert(reduce(par.on(s), big, 0, max_op) == 2);
+
+  vector<int> none;
+  assert(reduce(none, 5) == 5);
+  assert(reduce(par.on(s), none, 5) == 5);
+  assert(transform_reduce(par.on(s), none, none, 5) == 5);
+}
+
+int main()
+{
+  task_scheduler s(4);
+  for (size_t n : {0, 1, 3, 4, 5, 17, 1000, 100003}) {
+    check_sums<int>(s, n);
+    check_sums<unsigned>(s, n);
+    check_sums<long long>(s, n);
+    check_sums<std::uint8_t>(s, n);
+    check_sums<short>(s, n);
+  }
+  check_deterministic<float>();
+  check_deterministic<double>();
+  check_ops(s);
+}
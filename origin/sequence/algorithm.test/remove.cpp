@@ -6,7 +6,10 @@
 // and conditions.
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <vector>
 
 #include <origin/sequence/algorithm.hpp>
@@ -17,6 +20,31 @@ using namespace origin;
 bool odd(int n) { return n & 1; }
 bool neg(int n) { return n < 0; }
 
+// Removing a value from contiguous ranges of T, which uses vector
+// instructions, gives the result of std::remove, including for the tails of
+// the ranges and blocks with and without matches.
+template<typename T>
+  void
+  check_remove(size_t n, int m)
+  {
+    mt19937 prng {unsigned(n)};
+    vector<T> v(n);
+    for (T& x : v)
+      x = T(prng() % m);
+
+    vector<T> a = v;
+    vector<T> b = v;
+    auto i = remove(a, T(1));
+    auto j = std::remove(b.begin(), b.end(), T(1));
+    assert(i - a.begin() == j - b.begin());
+    assert(equal(a.begin(), i, b.begin()));
+
+    vector<T> c(n);
+    auto k = remove_copy(v, c, T(1));
+    assert(k - c.begin() == j - b.begin());
+    assert(equal(c.begin(), k, b.begin()));
+  }
+
 
 int main()
 {
@@ -52,4 +80,22 @@ int main()
   remove_copy_if(v1, v3, odd);
   remove_copy_if(v1.begin(), v1.end(), v4.begin(), odd);
   assert(v3 == v4);
+
+  for (size_t n : {0, 1, 7, 16, 33, 1000}) {
+    for (int m : {2, 50, 1000}) {
+      check_remove<int>(n, m);
+      check_remove<long long>(n, m);
+      check_remove<short>(n, m);
+      check_remove<std::uint8_t>(n, m);
+      check_remove<float>(n, m);
+      check_remove<double>(n, m);
+    }
+  }
+
+  // NaN is not equal to itself, and negative zero is equal to zero.
+  const double nan = numeric_limits<double>::quiet_NaN();
+  vector<double> d {nan, -0.0, 1, 0, 2, nan, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3};
+  vector<double> n(d.size());
+  assert(remove_copy(d, n, nan) == n.end());
+  assert(remove(d, 0.0) - d.begin() == 14);
 }
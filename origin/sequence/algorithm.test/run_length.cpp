@@ -0,0 +1,120 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the runs of v, found by hand.
+template<typename T>
+  pair<vector<T>, vector<size_t>>
+  runs(const vector<T>& v)
+  {
+    pair<vector<T>, vector<size_t>> r;
+    for (size_t i = 0; i != v.size(); ++i) {
+      if (i == 0 || !(v[i] == v[i - 1])) {
+        r.first.push_back(v[i]);
+        r.second.push_back(0);
+      }
+      ++r.second.back();
+    }
+    return r;
+  }
+
+// The runs of v are found serially and in parallel.
+template<typename T>
+  void
+  check(const vector<T>& v, const parallel_policy& p)
+  {
+    auto expected = runs(v);
+    size_t k = expected.first.size();
+    vector<T> a(v.size());
+    vector<size_t> b(v.size());
+    auto ends = run_length_encode(v, a, b);
+    assert(size_t(ends.first - a.begin()) == k);
+    assert(size_t(ends.second - b.begin()) == k);
+    assert(equal(a.begin(), ends.first, expected.first.begin()));
+    assert(equal(b.begin(), ends.second, expected.second.begin()));
+
+    vector<T> c(v.size());
+    vector<size_t> d(v.size());
+    ends = run_length_encode(p, v, c, d);
+    assert(size_t(ends.first - c.begin()) == k);
+    assert(equal(c.begin(), ends.first, expected.first.begin()));
+    assert(equal(d.begin(), ends.second, expected.second.begin()));
+  }
+
+// Runs of random lengths, up to max, including runs longer than a block.
+template<typename T>
+  void
+  check_random(size_t n, size_t max, const parallel_policy& p)
+  {
+    minstd_rand prng(n + max);
+    vector<T> v;
+    T x = T();
+    while (v.size() < n) {
+      x = x + T(1 + prng() % 3);
+      v.insert(v.end(), min(n - v.size(), 1 + prng() % max), x);
+    }
+    check(v, p);
+  }
+
+int main()
+{
+  task_scheduler s4(4);
+  parallel_policy p = par.on(s4);
+  for (size_t n : {0, 1, 2, 3, 17, 100, 5000, 100000}) {
+    for (size_t max : {1, 2, 5, 40, 10000, 1000000}) {
+      check_random<int>(n, max, p);
+      check_random<long long>(n, max, p);
+      check_random<unsigned char>(n, max, p);
+      check_random<double>(n, max, p);
+      check_random<int>(n, max, p.chunked(10));
+    }
+  }
+
+  // Strings and lists are compared by ==.
+  vector<string> s {"a", "a", "b", "c", "c", "c"};
+  check(s, p);
+  list<int> l {1, 1, 2, 1};
+  vector<int> v(4);
+  vector<int> c(4);
+  auto ends = run_length_encode(l, v, c);
+  assert(ends.first - v.begin() == 3);
+  assert((v == vector<int>{1, 2, 1, 0}));
+  assert((c == vector<int>{2, 1, 1, 0}));
+
+  // Values equivalent by eq are in the same run.
+  vector<int> w {1, 3, 5, 2, 4, 7};
+  auto parity = [](int a, int b) { return a % 2 == b % 2; };
+  ends = run_length_encode(w, v, c, parity);
+  assert(ends.first - v.begin() == 3);
+  assert(v[0] == 1 && v[1] == 2 && v[2] == 7);
+  assert(c[0] == 3 && c[1] == 2 && c[2] == 1);
+  vector<int> v2(6), c2(6);
+  auto e2 = run_length_encode(p.chunked(2), w, v2, c2, parity);
+  assert(e2.first - v2.begin() == 3);
+  assert(equal(v2.begin(), e2.first, v.begin()));
+
+  // The parallel overload is chosen for a non-const range.
+  vector<int> u {4, 4, 4, 9, 9, 4};
+  vector<int> v3(6), c3(6);
+  auto e3 = run_length_encode(p, u, v3, c3);
+  assert(e3.first - v3.begin() == 3 && e3.second - c3.begin() == 3);
+  assert(v3[0] == 4 && v3[1] == 9 && v3[2] == 4);
+  assert(c3[0] == 3 && c3[1] == 2 && c3[2] == 1);
+  assert(equal(c2.begin(), e2.second, c.begin()));
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <forward_list>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+using V = vector<int>;
+
+// A single pass range of integers read from a stream.
+struct int_stream
+{
+  int_stream(const string& s)
+    : in(s)
+  { }
+
+  istream_iterator<int> begin() { return istream_iterator<int>(in); }
+  istream_iterator<int> end() const { return istream_iterator<int>(); }
+
+  istringstream in;
+};
+
+// A sample holds distinct elements of the range.
+bool
+is_subset(V s, V v)
+{
+  sort(s);
+  sort(v);
+  return adjacent_find(s.begin(), s.end()) == s.end()
+      && std::includes(v.begin(), v.end(), s.begin(), s.end());
+}
+
+// Each of 10 elements is sampled in about 3 of each 10 samples of size 3.
+template<typename F>
+  void
+  check_uniform(F f)
+  {
+    V counts(10);
+    for (int t = 0; t != 10000; ++t)
+      for (int x : f())
+        ++counts[x];
+    for (int x : counts)
+      assert(x > 2700 && x < 3300);
+  }
+
+void
+check_sample()
+{
+  xoshiro256ss g(1);
+  V v {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  check_uniform([&]() { return sample(v, 3, g); });
+
+  forward_list<int> l(v.begin(), v.end());
+  check_uniform([&]() { return sample(l, 3, g); });
+
+  int_stream in("4 8 15 16 23 42");
+  V s = sample(in, 4, g);
+  assert(s.size() == 4);
+  assert(is_subset(s, V{4, 8, 15, 16, 23, 42}));
+
+  assert(sample(v, 0, g).empty());
+  assert(is_subset(sample(v, 20, g), v) && sample(v, 20, g).size() == 10);
+
+  V big(100000);
+  for (size_t i = 0; i != big.size(); ++i)
+    big[i] = i;
+  s = sample(big, 500, g);
+  assert(s.size() == 500 && is_subset(s, big));
+}
+
+void
+check_weighted()
+{
+  // Single elements are sampled in proportion to their weights.
+  splitmix64 g(2);
+  V v {0, 1, 2, 3};
+  auto weight = [](int x) { return double(x); };
+  V counts(4);
+  for (int t = 0; t != 6000; ++t)
+    ++counts[weighted_sample(v, 1, weight, g)[0]];
+  assert(counts[0] == 0);
+  assert(counts[1] > 800 && counts[1] < 1200);
+  assert(counts[2] > 1800 && counts[2] < 2200);
+  assert(counts[3] > 2800 && counts[3] < 3200);
+
+  V s = weighted_sample(v, 3, weight, g);
+  sort(s);
+  assert((s == V{1, 2, 3}));
+}
+
+void
+check_parallel()
+{
+  task_scheduler s1(1);
+  task_scheduler s4(4);
+  V v(100000);
+  for (size_t i = 0; i != v.size(); ++i)
+    v[i] = i;
+
+  // Parallel samples are the same for any number of threads.
+  xoshiro256ss g1(3);
+  xoshiro256ss g4(3);
+  V a = sample(par.on(s1), v, 1000, g1);
+  V b = sample(par.on(s4), v, 1000, g4);
+  assert(a == b);
+  assert(a.size() == 1000 && is_subset(a, v));
+
+  auto weight = [](int x) { return x < 50000 ? 1.0 : 3.0; };
+  a = weighted_sample(par.on(s1), v, 1000, weight, g1);
+  b = weighted_sample(par.on(s4), v, 1000, weight, g4);
+  assert(a == b);
+  assert(is_subset(a, v));
+  assert(count_if(a, [](int x) { return x >= 50000; }) > 700);
+
+  V w {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  check_uniform([&]() { return sample(par, w, 3, g1); });
+  assert(sample(par, w, 20, g1).size() == 10);
+  assert(sample(par, V(), 5, g1).empty());
+}
+
+void
+check_reservoir()
+{
+  // Merging the reservoirs of two halves samples the whole.
+  splitmix64 g(5);
+  V counts(10);
+  for (int t = 0; t != 10000; ++t) {
+    reservoir<int> a(3);
+    reservoir<int> b(3);
+    for (int i = 0; i != 10; ++i)
+      (i < 4 ? a : b).push(i, g);
+    a.merge(b);
+    assert(a.size() == 3);
+    for (int x : a.values())
+      ++counts[x];
+  }
+  for (int x : counts)
+    assert(x > 2700 && x < 3300);
+}
+
+int main()
+{
+  check_sample();
+  check_weighted();
+  check_parallel();
+  check_reservoir();
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <origin/concurrency/scheduler.hpp>
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the segmented inclusive scan of v under plus, computed directly.
+template<typename T>
+  vector<T>
+  segmented_sums(const vector<T>& v, const vector<char>& heads)
+  {
+    vector<T> r(v.size());
+    for (size_t i = 0; i != v.size(); ++i)
+      r[i] = i == 0 || heads[i] ? v[i] : T(r[i - 1] + v[i]);
+    return r;
+  }
+
+// The serial and parallel scans of n values of type T equal the partial
+// sums, including those of the vector kernels and their unaligned tails.
+template<typename T>
+  void
+  check_sums(task_scheduler& s, size_t n)
+  {
+    mt19937 prng {unsigned(n)};
+    vector<T> v(n);
+    for (T& x : v)
+      x = T(prng() % 100);
+    vector<char> heads(n);
+    for (char& h : heads)
+      h = prng() % 50 == 0;
+
+    vector<T> inc(n), exc(n);
+    partial_sum(v.begin(), v.end(), inc.begin());
+    for (size_t i = 0; i != n; ++i)
+      exc[i] = T(i == 0 ? 7 : exc[i - 1] + v[i - 1]);
+    vector<T> seg = segmented_sums(v, heads);
+
+    vector<T> r(n);
+    assert(inclusive_scan(v, r) == r.end());
+    assert(r == inc);
+    assert(exclusive_scan(v, r, 7) == r.end());
+    assert(r == exc);
+    assert(segmented_scan(v, heads, r) == r.end());
+    assert(r == seg);
+
+    auto pol = par.on(s);
+    vector<T> p(n);
+    assert(inclusive_scan(pol, v, p) == p.end());
+    assert(p == inc);
+    assert(exclusive_scan(pol, v, p, 7) == p.end());
+    assert(p == exc);
+    assert(segmented_scan(pol, v, heads, p) == p.end());
+    assert(p == seg);
+
+    // In place.
+    p = v;
+    inclusive_scan(pol, p, p);
+    assert(p == inc);
+    p = v;
+    exclusive_scan(p, p, 7);
+    assert(p == exc);
+  }
+
+// Other operations, value types, and ranges that are not contiguous.
+void
+check_ops(task_scheduler& s)
+{
+  vector<int> v {3, 1, 4, 1, 5, 9, 2, 6};
+  vector<int> r(8);
+  inclusive_scan(v, r, [](int a, int b) { return max(a, b); });
+  assert((r == vector<int> {3, 3, 4, 4, 5, 9, 9, 9}));
+  exclusive_scan(v, r, 1, multiplies<int>());
+  assert((r == vector<int> {1, 3, 3, 12, 12, 60, 540, 1080}));
+
+  vector<bool> heads {false, false, true, false, true, true, false, false};
+  segmented_scan(v, heads, r);
+  assert((r == vector<int> {3, 4, 4, 5, 5, 9, 11, 17}));
+
+  list<int> l(v.begin(), v.end());
+  list<long> out(8);
+  inclusive_scan(l, out);
+  assert(out.back() == 31);
+
+  vector<double> d(100000, 0.5);
+  vector<double> e(d.size());
+  inclusive_scan(par.on(s), d, e);
+  assert(e.back() == 50000);
+
+  vector<int> none;
+  assert(inclusive_scan(par.on(s), none, r) == r.begin());
+}
+
+int main()
+{
+  task_scheduler s(4);
+  for (size_t n : {0, 1, 3, 4, 5, 17, 1000, 100003}) {
+    check_sums<int>(s, n);
+    check_sums<unsigned>(s, n);
+    check_sums<long long>(s, n);
+    check_sums<std::uint8_t>(s, n);
+    check_sums<short>(s, n);
+  }
+  check_ops(s);
+}
@@ -6,7 +6,12 @@
 // and conditions.
 
 #include <cassert>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <list>
+#include <random>
+#include <string>
 #include <vector>
 
 #include <origin/sequence/algorithm.hpp>
@@ -15,8 +20,69 @@ using namespace std;
 using namespace origin;
 
 
+// Each searcher, and the automatic search, finds the first occurrence of
+// patterns of values of type T drawn from an alphabet of k values, as
+// std::search does. Small alphabets give periodic patterns and many
+// partial matches.
+template <typename T>
+  void
+  check_searchers(size_t n, unsigned k)
+  {
+    mt19937 prng {unsigned(n * k)};
+    vector<T> text(n);
+    for (T& x : text)
+      x = T(prng() % k);
+    for (size_t m : {0, 1, 2, 3, 5, 8, 17, 32, 33, 64, 100}) {
+      for (int trial = 0; trial != 4; ++trial) {
+        vector<T> pat(m);
+        if (trial % 2 == 0 && m <= n) {
+          size_t at = prng() % (n - m + 1);
+          copy(text.begin() + at, text.begin() + at + m, pat.begin());
+        } else {
+          for (T& x : pat)
+            x = T(prng() % k);
+        }
+        auto expect = std::search(text.begin(), text.end(),
+                                  pat.begin(), pat.end());
+        assert(search(text, pat) == expect);
+        assert(search(text, horspool_searcher<T>(pat)) == expect);
+        assert(search(text, two_way_searcher<T>(pat)) == expect);
+        assert(search(text, filter_searcher<T>(pat)) == expect);
+      }
+    }
+  }
+
 int main()
 {
+  for (size_t n : {0, 1, 10, 100, 5000}) {
+    for (unsigned k : {2, 4, 256}) {
+      check_searchers<char>(n, k);
+      check_searchers<std::uint8_t>(n, k);
+      check_searchers<short>(n, k);
+      check_searchers<int>(n, k);
+      check_searchers<long long>(n, k);
+    }
+  }
+
+  // Periodic patterns.
+  string log(10000, 'a');
+  log += "aab";
+  assert(search(log, string("aaab")) == log.end() - 4);
+  assert(search(log, two_way_searcher<char>(string(50, 'a') + "b"))
+         == log.end() - 51);
+  assert(search(log, horspool_searcher<char>(string("abab"))) == log.end());
+
+  // Ranges that are not contiguous use std::search.
+  list<int> lst {1, 2, 3, 1, 2, 4};
+  vector<int> pat {1, 2, 4};
+  assert(search(lst, pat) == next(lst.begin(), 3));
+
+  // Random access ranges that are not contiguous can be searched by the
+  // Horspool and two-way searchers.
+  deque<int> dq(lst.begin(), lst.end());
+  assert(search(dq, horspool_searcher<int>(pat)) == dq.begin() + 3);
+  assert(search(dq, two_way_searcher<int>(pat)) == dq.begin() + 3);
+
   using V = vector<int>;
   
   V v {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
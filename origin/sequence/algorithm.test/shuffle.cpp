@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <random>
 #include <vector>
 
 #include <origin/sequence/algorithm.hpp>
@@ -14,10 +15,56 @@
 using namespace std;
 using namespace origin;
 
-int main()
+using V = vector<int>;
+
+// The parallel shuffle permutes the range, and its result depends only on
+// the generator and the size of the range.
+void
+check_parallel(size_t n)
+{
+  V v0(n);
+  for (size_t i = 0; i != n; ++i)
+    v0[i] = i;
+
+  task_scheduler s1(1);
+  task_scheduler s4(4);
+  xoshiro256ss g1(3);
+  xoshiro256ss g4(3);
+  V v1 = v0;
+  V v4 = v0;
+  shuffle(par.on(s1), v1, g1);
+  shuffle(par.on(s4), v4, g4);
+  assert(v1 == v4);
+  assert(g1 == g4);
+  assert(n < 2 || v1 != v0);
+  V v2 = v1;
+  sort(v2);
+  assert(v2 == v0);
+
+  shuffle(par, v4, g4);
+  assert(n < 2 || v4 != v1);
+}
+
+// Each value is equally likely at the first position of a large shuffle.
+void
+check_uniform()
 {
-  using V = vector<int>;
+  const size_t n = 100000;
+  V counts(4);
+  splitmix64 g(11);
+  V v(n);
+  for (int t = 0; t != 400; ++t) {
+    for (size_t i = 0; i != n; ++i)
+      v[i] = i % 4;
+    shuffle(par, v, g);
+    ++counts[v[0]];
+  }
+  for (int x : counts)
+    assert(x > 60 && x < 140);
+}
 
+int main()
+{
   V v0 {1, 2, 3, 4, 5};
   V v1 = v0;
 
@@ -30,4 +77,14 @@ int main()
   std::minstd_rand prng;
   shuffle(v1, prng);
   assert(range_is_permutation(v1, v0));
+
+  xoshiro256ss x;
+  shuffle(v1, x);
+  assert(range_is_permutation(v1, v0));
+
+  check_parallel(0);
+  check_parallel(1000);
+  check_parallel(100000);
+  check_parallel(1 << 20);
+  check_uniform();
 }
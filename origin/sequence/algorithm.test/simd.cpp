@@ -0,0 +1,150 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+static_assert(algorithm_impl::Contiguous_range<vector<int>&>(), "");
+static_assert(algorithm_impl::Contiguous_range<const string&>(), "");
+static_assert(algorithm_impl::Contiguous_range<array<int, 3>&>(), "");
+static_assert(algorithm_impl::Contiguous_range<int(&)[3]>(), "");
+static_assert(!algorithm_impl::Contiguous_range<deque<int>&>(), "");
+static_assert(!algorithm_impl::Contiguous_range<vector<bool>&>(), "");
+
+#if defined(__SSE2__)
+static_assert(algorithm_impl::Simd_range_search<vector<int>&, int>(), "");
+static_assert(algorithm_impl::Simd_iterator_search<const double*, double>(),
+              "");
+#endif
+static_assert(!algorithm_impl::Simd_range_search<vector<int>&, long>(), "");
+
+// Searching every subrange starting at the first elements of v gives the
+// same results as the generic algorithms. The subranges start at different
+// alignments, and the target is placed at every position.
+template<typename T>
+  void
+  check_search(size_t n, T x, T y)
+  {
+    for (size_t s = 0; s != 4 && s <= n; ++s)
+      for (size_t k = s; k <= n; ++k) {
+        vector<T> v(n, x);
+        if (k != n)
+          v[k] = y;
+        vector<T> u(v.begin() + s, v.end());
+        const T* p = u.data();
+        const T* q = p + u.size();
+        auto i = std::find(u.begin(), u.end(), y);
+
+        assert(find(u, y) == i);
+        assert(any_match(u, y) == (i != u.end()));
+        assert(none_match(u, y) == (i == u.end()));
+        assert(all_match(u, x) == (i == u.end()));
+        assert(any_match(p, q, y) == (i != u.end()));
+        assert(none_match(p, q, y) == (i == u.end()));
+        assert(all_match(p, q, x) == (i == u.end()));
+        assert(count(u, y) == std::count(u.begin(), u.end(), y));
+        assert(count(u, x) == std::count(u.begin(), u.end(), x));
+
+        vector<T> w = u;
+        assert(range_equal(u, w));
+        assert(range_mismatch(u, w).first == u.end());
+        if (!w.empty()) {
+          w.back() = y;
+          auto m = std::mismatch(u.begin(), u.end(), w.begin());
+          assert(range_mismatch(u, w) == make_pair(m.first, m.second));
+          assert(range_equal(u, w) == (m.first == u.end()));
+        }
+      }
+  }
+
+template<typename T>
+  void
+  check_type()
+  {
+    for (size_t n : {0, 1, 7, 16, 33, 70, 130})
+      check_search<T>(n, T(1), T(2));
+    check_search<T>(70, numeric_limits<T>::max(), numeric_limits<T>::min());
+  }
+
+void
+check_floats()
+{
+  // NaNs are not equal to themselves, and zeros are equal.
+  double nan = numeric_limits<double>::quiet_NaN();
+  vector<double> v(100, nan);
+  assert(find(v, nan) == v.end());
+  assert(count(v, nan) == 0);
+  assert(!range_equal(v, v));
+  v[50] = -0.0;
+  assert(find(v, 0.0) == v.begin() + 50);
+  assert(count(v, 0.0) == 1);
+
+  vector<float> f(100, 0.0f);
+  f[70] = -0.0f;
+  assert(all_match(f, 0.0f));
+  assert(count(f, -0.0f) == 100);
+}
+
+void
+check_generic()
+{
+  // Values of other types than the value type, and ranges that are not
+  // contiguous, use the generic algorithms.
+  vector<int> v {1, 2, 3, 4};
+  assert(find(v, 3.0) == v.begin() + 2);
+  assert(find(v, 2.5) == v.end());
+  assert(count(v, 4L) == 1);
+  deque<int> d(v.begin(), v.end());
+  assert(find(d, 4) == d.begin() + 3);
+  assert(any_match(d, 1));
+  vector<bool> b(100, false);
+  b[60] = true;
+  assert(find(b, true) == b.begin() + 60);
+  string s(200, 'a');
+  s[150] = 'b';
+  assert(find(s, 'b') == s.begin() + 150);
+  assert(count(s, 'a') == 199);
+}
+
+// Counts of long ranges are not limited by the width of the counters.
+void
+check_long_count()
+{
+  vector<char> v(100003);
+  for (size_t i = 0; i != v.size(); ++i)
+    v[i] = i % 3 ? 'a' : 'b';
+  assert(count(v, 'b') == std::count(v.begin(), v.end(), 'b'));
+  vector<uint64_t> u(100003, 5);
+  assert(count(u, uint64_t(5)) == 100003);
+}
+
+int main()
+{
+  check_type<char>();
+  check_type<int8_t>();
+  check_type<uint16_t>();
+  check_type<int32_t>();
+  check_type<uint32_t>();
+  check_type<int64_t>();
+  check_type<uint64_t>();
+  check_type<float>();
+  check_type<double>();
+  check_floats();
+  check_generic();
+  check_long_count();
+}
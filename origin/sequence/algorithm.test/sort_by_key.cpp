@@ -0,0 +1,109 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Sorting keys with their positions as values orders the keys as
+// std::stable_sort orders the pairs by their keys.
+template<typename Sort>
+  void
+  check_sort(size_t n, int range, Sort s)
+  {
+    minstd_rand prng(n);
+    vector<int> keys(n);
+    vector<size_t> values(n);
+    vector<pair<int, size_t>> expected(n);
+    for (size_t i = 0; i != n; ++i) {
+      keys[i] = prng() % range;
+      values[i] = i;
+      expected[i] = {keys[i], i};
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const pair<int, size_t>& a,
+                        const pair<int, size_t>& b) {
+      return a.first > b.first;
+    });
+    s(keys, values);
+    for (size_t i = 0; i != n; ++i) {
+      assert(keys[i] == expected[i].first);
+      assert(values[i] == expected[i].second);
+    }
+  }
+
+// Several arrays are permuted in lockstep by sorting their positions.
+void
+check_zip()
+{
+  vector<double> keys {3.5, 1.0, 2.5, 1.0, 0.5};
+  vector<string> names {"d", "b", "c", "a", "e"};
+  vector<int> ids {4, 2, 3, 1, 5};
+  vector<size_t> pos {0, 1, 2, 3, 4};
+  sort_by_key(keys, pos);
+  assert((keys == vector<double> {0.5, 1.0, 1.0, 2.5, 3.5}));
+  assert((pos == vector<size_t> {4, 1, 3, 2, 0}));
+
+  vector<string> n2;
+  vector<int> i2;
+  for (size_t p : pos) {
+    n2.push_back(names[p]);
+    i2.push_back(ids[p]);
+  }
+  assert((n2 == vector<string> {"e", "b", "a", "c", "d"}));
+  assert((i2 == vector<int> {5, 2, 1, 3, 4}));
+}
+
+// Move-only values are moved with their keys.
+void
+check_move_only(const parallel_policy& p)
+{
+  size_t n = 100000;
+  vector<string> keys(n);
+  vector<unique_ptr<int>> values(n);
+  minstd_rand prng(9);
+  for (size_t i = 0; i != n; ++i) {
+    int x = prng() % 1000;
+    keys[i] = to_string(x);
+    values[i].reset(new int(x));
+  }
+  sort_by_key(p, keys, values);
+  assert(is_sorted(keys));
+  for (size_t i = 0; i != n; ++i)
+    assert(keys[i] == to_string(*values[i]));
+}
+
+int main()
+{
+  auto serial = [](vector<int>& k, vector<size_t>& v) {
+    sort_by_key(k, v, greater<int>());
+  };
+  for (size_t n : {0, 1, 2, 31, 32, 33, 100, 1000, 4097})
+    for (int r : {3, 1 << 20})
+      check_sort(n, r, serial);
+
+  task_scheduler s4(4);
+  auto parallel = [&](vector<int>& k, vector<size_t>& v) {
+    sort_by_key(par.on(s4), k, v, greater<int>());
+  };
+  for (size_t n : {10, 1000, 100000, 300001})
+    for (int r : {3, 1 << 20})
+      check_sort(n, r, parallel);
+
+  check_zip();
+  check_move_only(par.on(s4));
+  check_move_only(par);
+}
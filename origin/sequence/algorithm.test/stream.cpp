@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/range.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Large enough to be written with non-temporal stores.
+constexpr size_t large = (size_t(1) << 23) / sizeof(int) + 13;
+
+struct rgb
+{
+  char r, g, b;
+};
+
+// Copies and moves of large ranges, and of ranges that overlap.
+void
+check_copy(const parallel_policy& p)
+{
+  for (size_t n : {size_t(100), large}) {
+    vector<int> a(n);
+    for (size_t i = 0; i != n; ++i)
+      a[i] = int(i * 7);
+    vector<int> b(n);
+    vector<int> c(n);
+    assert(origin::copy(a, b) == b.end());
+    assert(origin::move(a, c) == c.end());
+    assert(a == b && a == c);
+    vector<int> d(n);
+    vector<int> e(n);
+    assert(origin::copy(p, a, d) == d.end());
+    assert(origin::move(p, a, e) == e.end());
+    assert(a == d && a == e);
+
+    // Shift a copy of a to the left by 5 elements.
+    int* q = b.data();
+    origin::copy(bounded_range<int*>(q + 5, q + n), bounded_range<int*>(q, q));
+    for (size_t i = 0; i + 5 < n; ++i)
+      assert(b[i] == a[i + 5]);
+  }
+
+  // The value types differ, so the copy is not streamed.
+  vector<int> a(large, 3);
+  vector<double> b(large);
+  origin::copy(p, a, b);
+  assert(b.front() == 3.0 && b.back() == 3.0);
+
+  vector<unique_ptr<int>> u(1000);
+  for (auto& x : u)
+    x.reset(new int(1));
+  vector<unique_ptr<int>> v(u.size());
+  origin::move(p, u, v);
+  assert(!u[0] && *v[999] == 1);
+}
+
+void
+check_fill(const parallel_policy& p)
+{
+  vector<double> a(large);
+  fill(a, 2);
+  for (double x : a)
+    assert(x == 2.0);
+  fill(p, a, 1.5);
+  for (double x : a)
+    assert(x == 1.5);
+
+  // A fill that starts at an odd address, and one of values whose size
+  // does not divide 16.
+  vector<char> c(3 * large);
+  fill(bounded_range<char*>(c.data() + 1, c.data() + c.size() - 3), 'x');
+  assert(c[0] == 0 && c[1] == 'x' && c[c.size() - 4] == 'x');
+  assert(c[c.size() - 3] == 0);
+  vector<uint16_t> h(large + 1);
+  uint16_t* q = h.data();
+  fill(p, bounded_range<uint16_t*>(q + 1, q + h.size()), uint16_t(9));
+  assert(h[0] == 0 && h[1] == 9 && h.back() == 9);
+
+  vector<rgb> r(large);
+  fill(r, rgb {1, 2, 3});
+  assert(r.back().b == 3);
+}
+
+void
+check_generate()
+{
+  vector<long> a(large);
+  long n = 0;
+  generate(a, [&]() { return n++; });
+  for (size_t i = 0; i != a.size(); ++i)
+    assert(a[i] == long(i));
+  vector<string> s(10);
+  generate(s, []() { return string("a"); });
+  assert(s[9] == "a");
+}
+
+int main()
+{
+  task_scheduler s4(4);
+  check_copy(par.on(s4));
+  check_fill(par.on(s4));
+  check_generate();
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/range.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns the first k values of v by comp, as partial_sort_copy does.
+template<typename T, typename C>
+  vector<T>
+  expected(const vector<T>& v, size_t k, C comp)
+  {
+    vector<T> r(min(k, v.size()));
+    std::partial_sort_copy(v.begin(), v.end(), r.begin(), r.end(), comp);
+    return r;
+  }
+
+// Values in random order, ascending and descending, so that many or all
+// of the values enter the heap.
+template<typename T>
+  vector<vector<T>>
+  inputs(size_t n)
+  {
+    minstd_rand prng(n);
+    vector<vector<T>> vs(3, vector<T>(n));
+    for (size_t i = 0; i != n; ++i) {
+      vs[0][i] = T(prng() % 100000) - T(5000);
+      vs[1][i] = T(i);
+      vs[2][i] = T(n - i);
+    }
+    return vs;
+  }
+
+template<typename T, typename C>
+  void
+  check_top_k(C comp)
+  {
+    task_scheduler s4(4);
+    for (size_t n : {0, 1, 7, 100, 1000, 100000})
+      for (const vector<T>& v : inputs<T>(n))
+        for (size_t k : {0, 1, 3, 10, 1000, 200000}) {
+          vector<T> r = expected(v, k, comp);
+          assert(top_k(v, k, comp) == r);
+          assert(top_k(par.on(s4), v, k, comp) == r);
+        }
+  }
+
+// The elements of an input range are read once.
+void
+check_input()
+{
+  istringstream in("5 3 9 1 7 3 8");
+  auto r = top_k(bounded_range<istream_iterator<int>>(
+                   istream_iterator<int>(in), istream_iterator<int>()), 3);
+  assert((r == vector<int> {1, 3, 3}));
+}
+
+int main()
+{
+  check_top_k<int>(less<int>());
+  check_top_k<int>(greater<int>());
+  check_top_k<unsigned>(greater<unsigned>());
+  check_top_k<unsigned>(algorithm_impl::less_than());
+  check_top_k<float>(less<float>());
+  check_top_k<double>(greater<double>());
+  check_top_k<long>(greater<long>());
+  check_top_k<double>([](double a, double b) { return a > b; });
+
+  vector<string> s {"pear", "fig", "apple", "kiwi", "plum"};
+  assert((top_k(s, 2) == vector<string> {"apple", "fig"}));
+
+  check_input();
+
+  vector<double> scores(1 << 20);
+  minstd_rand prng(1);
+  for (double& x : scores)
+    x = prng() / 7.0;
+  vector<double> top = top_k(par, scores, 1000, greater<double>());
+  assert(top == expected(scores, 1000, greater<double>()));
+}
@@ -7,15 +7,84 @@
 
 #include <cassert>
 #include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <origin/concurrency/scheduler.hpp>
 #include <origin/sequence/algorithm.hpp>
 
 using namespace std;
 using namespace origin;
 
+using edge = pair<int, int>;
+
+// The serial and parallel distinct values of random edges, with many
+// duplicates, are the first occurrences of each edge, in order.
+void
+check_distinct(task_scheduler& s, size_t n, int k)
+{
+  minstd_rand prng(unsigned(n + k));
+  vector<edge> v(n);
+  for (edge& e : v)
+    e = edge(int(prng() % k), int(prng() % k));
+
+  // The expected result, by a set of the values seen.
+  vector<edge> expect;
+  {
+    auto hash = [](const edge& e) {
+      return size_t(e.first) * 1000003u + size_t(e.second);
+    };
+    unordered_set<edge, decltype(hash)> set(16, hash);
+    for (const edge& e : v)
+      if (set.insert(e).second)
+        expect.push_back(e);
+  }
+
+  vector<edge> a = v;
+  a.erase(hash_unique(a), a.end());
+  assert(a == expect);
+  vector<edge> b(n);
+  b.erase(distinct(v, b), b.end());
+  assert(b == expect);
+
+  auto pol = par.on(s);
+  a = v;
+  a.erase(hash_unique(pol, a), a.end());
+  assert(a == expect);
+  b.assign(n, edge());
+  b.erase(distinct(pol, v, b), b.end());
+  assert(b == expect);
+}
+
 int main()
 {
+  {
+    vector<int> v {3, 1, 3, 2, 1, 5, 3};
+    v.erase(hash_unique(v), v.end());
+    assert((v == vector<int> {3, 1, 2, 5}));
+
+    list<string> l {"b", "a", "b", "c", "a"};
+    vector<string> out(5);
+    out.erase(distinct(l, out), out.end());
+    assert((out == vector<string> {"b", "a", "c"}));
+
+    // A poor hash gives the same result.
+    vector<int> w {7, 8, 7, 9, 8};
+    auto mod = [](int x) { return size_t(x % 2); };
+    w.erase(hash_unique(w, mod), w.end());
+    assert((w == vector<int> {7, 8, 9}));
+
+    task_scheduler s(4);
+    for (size_t n : {0, 1, 100, 50000, 200000})
+      for (int k : {3, 100, 100000})
+        check_distinct(s, n, k);
+  }
+
+
   using V = vector<int>;
 
   V v0 {0, 0, 1, 1, 2, 2};
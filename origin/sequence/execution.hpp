@@ -0,0 +1,131 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_EXECUTION_HPP
+#define ORIGIN_SEQUENCE_EXECUTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include <origin/concurrency/scheduler.hpp>
+
+namespace origin
+{
+  // Task scheduling is provided by the concurrency module, whose default
+  // scheduler is shared with the parallel operations of the other modules
+  // (see [conc.sched] and [conc.fork]).
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                               [exec.policy]
+  //                           Execution Policies
+  //
+  // An execution policy selects the parallel overload of an algorithm. The
+  // parallel policy par runs algorithms on the default scheduler; a policy
+  // that runs algorithms on another scheduler s is created by par.on(s).
+  //
+  // The blocks into which a parallel algorithm divides its ranges usually
+  // depend on the number of threads of the scheduler. The deterministic
+  // policy par.deterministic() divides ranges into blocks of a fixed size,
+  // so that results that depend on the grouping of the operations, such as
+  // the sums of floating point values computed by reduce, are the same for
+  // any number of threads. The policy par.chunked(n) divides them into
+  // blocks of n elements, which suits algorithms whose work per element is
+  // large or uneven (small blocks balance the load) or very small (large
+  // blocks reduce the number of tasks); the results are the same for any
+  // number of threads, as with par.deterministic().
+  struct parallel_policy
+  {
+    constexpr parallel_policy()
+      : sched(nullptr), fixed(false), chunk(0)
+    { }
+
+    // Returns a policy that runs algorithms on the scheduler s.
+    parallel_policy on(task_scheduler& s) const
+    {
+      parallel_policy p = *this;
+      p.sched = &s;
+      return p;
+    }
+
+    // Returns a policy that divides ranges into blocks of a fixed size.
+    parallel_policy deterministic() const
+    {
+      parallel_policy p = *this;
+      p.fixed = true;
+      return p;
+    }
+
+    // Returns a policy that divides ranges into blocks of n elements, or
+    // into blocks chosen by the algorithm if n is 0.
+    parallel_policy chunked(std::size_t n) const
+    {
+      parallel_policy p = *this;
+      p.chunk = n;
+      return p;
+    }
+
+    // Returns the scheduler on which algorithms run.
+    task_scheduler& scheduler() const
+    {
+      return sched ? *sched : default_scheduler();
+    }
+
+    task_scheduler* sched;
+    bool fixed;         // True if the blocks have a fixed size
+    std::size_t chunk;  // The size of the blocks, or 0
+  };
+
+  constexpr parallel_policy par { };
+
+
+  namespace execution_impl
+  {
+    // The least number of elements processed by a task.
+    constexpr std::size_t min_grain = 1 << 12;
+
+    // Returns the number of elements processed by each task when n elements
+    // are processed on the scheduler s. Each thread receives several tasks,
+    // so that threads that finish early can steal work.
+    inline std::size_t
+    grain(const task_scheduler& s, std::size_t n)
+    {
+      return std::max(min_grain, n / (8 * s.size()));
+    }
+
+    // Returns the number of elements processed by each task when n elements
+    // are processed with the policy p: the size of its blocks if it is
+    // chunked, and min_grain if it is deterministic.
+    inline std::size_t
+    grain(const parallel_policy& p, std::size_t n)
+    {
+      if (p.chunk)
+        return p.chunk;
+      return p.fixed ? min_grain : grain(p.scheduler(), n);
+    }
+
+    // Call f(first, last) for subranges [first, last) partitioning [0, n),
+    // each of at most grain elements, using the scheduler s.
+    template<typename F>
+      inline void
+      parallel_for(task_scheduler& s, std::size_t n, std::size_t grain, F f)
+      {
+        origin::parallel_for(s, std::size_t(0), n, grain, std::move(f));
+      }
+
+    template<typename F>
+      inline void
+      parallel_for(task_scheduler& s, std::size_t n, F f)
+      {
+        parallel_for(s, n, grain(s, n), f);
+      }
+
+  } // namespace execution_impl
+
+} // namespace origin
+
+#endif
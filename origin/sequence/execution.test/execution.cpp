@@ -0,0 +1,118 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/sequence/execution.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Compute the nth Fibonacci number with nested task groups.
+long
+fib(task_scheduler& s, int n)
+{
+  if (n < 2)
+    return n;
+  long a = 0;
+  task_group g(s);
+  g.run([&]() { a = fib(s, n - 1); });
+  long b = fib(s, n - 2);
+  g.wait();
+  return a + b;
+}
+
+void
+check_groups(task_scheduler& s)
+{
+  atomic<int> n(0);
+  task_group g(s);
+  for (int i = 0; i != 1000; ++i)
+    g.run([&n]() { ++n; });
+  g.wait();
+  assert(n == 1000);
+
+  // Groups can be reused after waiting.
+  g.run([&n]() { ++n; });
+  g.wait();
+  assert(n == 1001);
+
+  assert(fib(s, 20) == 6765);
+}
+
+void
+check_exceptions(task_scheduler& s)
+{
+  atomic<int> n(0);
+  task_group g(s);
+  for (int i = 0; i != 100; ++i)
+    g.run([&n, i]() {
+      ++n;
+      if (i % 10 == 0)
+        throw runtime_error("task");
+    });
+  try {
+    g.wait();
+    assert(false);
+  } catch (runtime_error&) { }
+
+  // Every task runs, and the exception is only rethrown once.
+  assert(n == 100);
+  g.wait();
+}
+
+void
+check_parallel_for(task_scheduler& s)
+{
+  // Each index is visited exactly once, in blocks of at most the grain.
+  vector<atomic<int>> seen(100000);
+  for (auto& x : seen)
+    x.store(0);
+  execution_impl::parallel_for(s, seen.size(), 1000,
+    [&](size_t first, size_t last) {
+      assert(first < last && last - first <= 1000);
+      for (size_t i = first; i != last; ++i)
+        ++seen[i];
+    });
+  for (auto& x : seen)
+    assert(x.load() == 1);
+
+  execution_impl::parallel_for(s, 0, [](size_t, size_t) { assert(false); });
+}
+
+void
+check_policies(task_scheduler& s)
+{
+  // A chunked policy fixes the grain; a chunk of 0 restores the default.
+  parallel_policy p = par.on(s);
+  assert(execution_impl::grain(p.chunked(100), 1 << 20) == 100);
+  assert(execution_impl::grain(p.chunked(100).chunked(0), 1 << 20)
+         == execution_impl::grain(s, 1 << 20));
+  assert(execution_impl::grain(p.deterministic(), 1 << 20)
+         == execution_impl::min_grain);
+  assert(&p.chunked(100).scheduler() == &s);
+}
+
+int main()
+{
+  task_scheduler s1(1);
+  assert(s1.size() == 1);
+  task_scheduler s4(4);
+  assert(s4.size() == 4);
+  assert(default_scheduler().size() >= 1);
+
+  for (task_scheduler* s : {&s1, &s4, &default_scheduler()}) {
+    check_groups(*s);
+    check_exceptions(*s);
+    check_parallel_for(*s);
+    check_policies(*s);
+  }
+}
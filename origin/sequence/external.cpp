@@ -0,0 +1,136 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cerrno>
+#include <cstdlib>
+
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "external.hpp"
+
+namespace origin
+{
+  namespace external_impl
+  {
+    namespace
+    {
+      [[noreturn]] void
+      fail(const std::string& path)
+      {
+        throw std::system_error(errno, std::system_category(), path);
+      }
+    } // namespace
+
+    file::file(const std::string& path, bool write)
+      : fd_(-1), path_(path)
+    {
+      fd_ = write ? ::open(path.c_str(), O_WRONLY | O_CREAT, 0666)
+                  : ::open(path.c_str(), O_RDONLY);
+      if (fd_ < 0)
+        fail(path);
+    }
+
+    file::file(file&& x)
+      : fd_(x.fd_), path_(std::move(x.path_))
+    {
+      x.fd_ = -1;
+    }
+
+    file&
+    file::operator=(file&& x)
+    {
+      std::swap(fd_, x.fd_);
+      std::swap(path_, x.path_);
+      return *this;
+    }
+
+    file::~file()
+    {
+      if (fd_ >= 0)
+        ::close(fd_);
+    }
+
+    // The file is unlinked as soon as it is created, so that it is removed
+    // when it is closed, however the program ends.
+    file
+    file::temporary()
+    {
+      const char* dir = std::getenv("TMPDIR");
+      std::string path = std::string(dir && *dir ? dir : "/tmp")
+                       + "/origin-sort-XXXXXX";
+      file f;
+      f.fd_ = ::mkstemp(&path[0]);
+      if (f.fd_ < 0)
+        fail(path);
+      ::unlink(path.c_str());
+      f.path_ = path;
+      return f;
+    }
+
+    std::size_t
+    file::read(void* p, std::size_t n)
+    {
+      char* q = static_cast<char*>(p);
+      std::size_t pos = 0;
+      while (pos != n) {
+        ssize_t r = ::read(fd_, q + pos, n - pos);
+        if (r < 0 && errno == EINTR)
+          continue;
+        if (r < 0)
+          fail(path_);
+        if (r == 0)
+          break;
+        pos += r;
+      }
+      return pos;
+    }
+
+    std::size_t
+    file::read_at(void* p, std::size_t n, std::uint64_t off) const
+    {
+      char* q = static_cast<char*>(p);
+      std::size_t pos = 0;
+      while (pos != n) {
+        ssize_t r = ::pread(fd_, q + pos, n - pos, off + pos);
+        if (r < 0 && errno == EINTR)
+          continue;
+        if (r < 0)
+          fail(path_);
+        if (r == 0)
+          break;
+        pos += r;
+      }
+      return pos;
+    }
+
+    void
+    file::write(const void* p, std::size_t n)
+    {
+      const char* q = static_cast<const char*>(p);
+      std::size_t pos = 0;
+      while (pos != n) {
+        ssize_t r = ::write(fd_, q + pos, n - pos);
+        if (r < 0 && errno == EINTR)
+          continue;
+        if (r < 0)
+          fail(path_);
+        pos += r;
+      }
+    }
+
+    void
+    file::resize(std::uint64_t n)
+    {
+      if (::ftruncate(fd_, n) != 0)
+        fail(path_);
+    }
+
+  } // namespace external_impl
+} // namespace origin
@@ -0,0 +1,554 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_EXTERNAL_HPP
+#define ORIGIN_SEQUENCE_EXTERNAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [algo.external]
+  //                             External Sorting
+  //
+  //    external_sort(range, out, budget[, comp])
+  //    external_sort_file<T>(input, output, budget[, comp])
+  //
+  // Sort a sequence that need not fit in memory, using about budget bytes
+  // of memory. The first algorithm sorts the elements of an input range
+  // into the output iterator out, and returns the end of the output. The
+  // second sorts the values of type T stored in the file named input into
+  // the file named output, which may be the same file. The values must be
+  // trivially copyable, since they are written to files as bytes. The sort
+  // is not stable.
+  //
+  // The input is read in runs that fill half of the budget, leaving the rest
+  // for the buffers of the in memory sort (see [algo.radix] and
+  // [algo.pdqsort]). Each run is sorted and written to a temporary file with
+  // a single sequential write. If the input fits in one run, it is sorted in
+  // memory and no file is written. Otherwise the runs are merged by a loser
+  // tree (see [algo.kmerge]). Each run being merged is read in blocks that
+  // share the budget, and the next block of a run is read asynchronously
+  // while the current one is merged; the merged output is written from a
+  // pair of blocks in the same way. When there are so many runs that their
+  // blocks would be smaller than min_block bytes, groups of runs are first
+  // merged into longer runs, in as many passes as needed.
+  //
+  // Temporary files are created in the directory named by the environment
+  // variable TMPDIR, or in /tmp, and are removed when they are closed,
+  // even if the sort throws. A std::system_error is thrown if a file cannot
+  // be created, read or written, and a std::runtime_error if the size of
+  // the input file is not a multiple of the size of T.
+  //
+  // The parallel overloads, external_sort(par, ...) and
+  // external_sort_file<T>(par, ...) sort each run with the parallel sort
+  // algorithm (see [algo.par]).
+
+  namespace external_impl
+  {
+    // The least number of bytes read or written at once by a merge, unless
+    // the budget is smaller.
+    constexpr std::size_t min_block = 1 << 20;
+
+    // A file read and written with system calls. A file that is opened for
+    // writing is created if it does not exist, and is written from its
+    // start. Files are moved but not copied.
+    class file
+    {
+    public:
+      file() : fd_(-1) { }
+      file(const std::string& path, bool write);
+
+      file(file&& x);
+      file& operator=(file&& x);
+
+      file(const file&) = delete;
+      file& operator=(const file&) = delete;
+
+      ~file();
+
+      // Returns a new, empty temporary file, which has no name.
+      static file temporary();
+
+      // Read up to n bytes into p from the current position, and return
+      // the number of bytes read, which is less than n only at the end of
+      // the file.
+      std::size_t read(void* p, std::size_t n);
+
+      // Read up to n bytes into p from the offset off. The file may be read
+      // concurrently at different offsets.
+      std::size_t read_at(void* p, std::size_t n, std::uint64_t off) const;
+
+      // Write the n bytes at p at the current position.
+      void write(const void* p, std::size_t n);
+
+      // Set the length of the file to n bytes.
+      void resize(std::uint64_t n);
+
+    private:
+      int fd_;
+      std::string path_;
+    };
+
+
+    // A sorted run of size values, stored at offset bytes in a file.
+    struct run
+    {
+      std::uint64_t offset;
+      std::size_t size;
+    };
+
+    // Returns the number of values of type T in each block of a merge of k
+    // runs with the given budget: k runs and the output each have two
+    // blocks.
+    template<typename T>
+      inline std::size_t
+      block_size(std::size_t budget, std::size_t k)
+      {
+        return std::max<std::size_t>(1, budget / ((2 * k + 2) * sizeof(T)));
+      }
+
+    // Reads a run from a file in blocks, reading the next block of the run
+    // asynchronously while the values of the current one are consumed.
+    template<typename T>
+      class run_reader
+      {
+      public:
+        run_reader(const file& f, run r, std::size_t block)
+          : f_(&f), off_(r.offset), left_(r.size), block_(block),
+            cur_(std::min(block, r.size)), next_(cur_.size()), pos_(0),
+            len_(0)
+        {
+          fetch();
+          refill();
+        }
+
+        bool empty() const { return pos_ == len_; }
+
+        const T& front() const { return cur_[pos_]; }
+
+        void pop()
+        {
+          if (++pos_ == len_)
+            refill();
+        }
+
+      private:
+        // Start reading the next block of the run into next_.
+        void fetch()
+        {
+          if (left_ == 0)
+            return;
+          std::size_t n = std::min(block_, left_);
+          const file* f = f_;
+          T* p = next_.data();
+          std::uint64_t off = off_;
+          pending_ = std::async(std::launch::async, [=]() {
+            if (f->read_at(p, n * sizeof(T), off) != n * sizeof(T))
+              throw std::runtime_error("external sort run is truncated");
+            return n;
+          });
+          off_ += n * sizeof(T);
+          left_ -= n;
+        }
+
+        // Make the block being read current, and start reading the next.
+        void refill()
+        {
+          pos_ = 0;
+          len_ = 0;
+          if (!pending_.valid())
+            return;
+          len_ = pending_.get();
+          std::swap(cur_, next_);
+          fetch();
+        }
+
+        const file* f_;
+        std::uint64_t off_;
+        std::size_t left_;
+        std::size_t block_;
+        std::vector<T> cur_;
+        std::vector<T> next_;
+        std::size_t pos_;
+        std::size_t len_;
+        std::future<std::size_t> pending_;
+      };
+
+    // An input iterator over the values of a run reader. The iterators of
+    // exhausted readers are equal to the default iterator.
+    template<typename T>
+      class run_iterator
+      {
+      public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        run_iterator() : r_(nullptr) { }
+        run_iterator(run_reader<T>& r) : r_(&r) { }
+
+        // Readable
+        reference operator*() const { return r_->front(); }
+
+        // Increment
+        run_iterator& operator++()
+        {
+          r_->pop();
+          return *this;
+        }
+
+        // Equality_comparable
+        bool operator==(const run_iterator& x) const
+        {
+          return done() == x.done();
+        }
+
+        bool operator!=(const run_iterator& x) const
+        {
+          return done() != x.done();
+        }
+
+      private:
+        bool done() const { return !r_ || r_->empty(); }
+
+        run_reader<T>* r_;
+      };
+
+    // Writes values to a file in blocks, writing each full block
+    // asynchronously while the next one is filled.
+    template<typename T>
+      class run_writer
+      {
+      public:
+        run_writer(file& f, std::size_t block)
+          : f_(&f), cur_(block), next_(block), pos_(0), count_(0)
+        { }
+
+        ~run_writer()
+        {
+          if (pending_.valid())
+            pending_.wait();
+        }
+
+        void push(const T& x)
+        {
+          cur_[pos_] = x;
+          if (++pos_ == cur_.size())
+            write();
+        }
+
+        // Write the buffered values, and wait until they are written.
+        void flush()
+        {
+          write();
+          if (pending_.valid())
+            pending_.get();
+        }
+
+        // Returns the number of values written.
+        std::size_t count() const { return count_; }
+
+      private:
+        void write()
+        {
+          if (pending_.valid())
+            pending_.get();
+          if (pos_ == 0)
+            return;
+          file* f = f_;
+          const T* p = cur_.data();
+          std::size_t n = pos_ * sizeof(T);
+          pending_ = std::async(std::launch::async, [=]() { f->write(p, n); });
+          std::swap(cur_, next_);
+          count_ += pos_;
+          pos_ = 0;
+        }
+
+        file* f_;
+        std::vector<T> cur_;
+        std::vector<T> next_;
+        std::size_t pos_;
+        std::size_t count_;
+        std::future<void> pending_;
+      };
+
+    // An output iterator that pushes values to a run writer.
+    template<typename T>
+      class write_iterator
+      {
+      public:
+        using value_type = void;
+        using reference = void;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::output_iterator_tag;
+
+        write_iterator(run_writer<T>& w) : w_(&w) { }
+
+        write_iterator& operator*() { return *this; }
+        write_iterator& operator++() { return *this; }
+        write_iterator& operator++(int) { return *this; }
+
+        write_iterator& operator=(const T& x)
+        {
+          w_->push(x);
+          return *this;
+        }
+
+      private:
+        run_writer<T>* w_;
+      };
+
+    // Merge the runs [first, last) of the file f into out.
+    template<typename T, typename O, typename C>
+      O
+      merge_runs(const file& f, const run* first, const run* last,
+                 std::size_t budget, O out, C comp)
+      {
+        std::size_t k = last - first;
+        std::size_t block = block_size<T>(budget, k);
+        std::vector<run_reader<T>> readers;
+        readers.reserve(k);
+        for (const run* r = first; r != last; ++r)
+          readers.emplace_back(f, *r, block);
+        std::vector<run_iterator<T>> begins(readers.begin(), readers.end());
+        std::vector<run_iterator<T>> ends(k);
+        return algorithm_impl::loser_tree_merge(begins, ends, out, comp);
+      }
+
+    // Sort the values read by fill into out. Each call fill(p, n) reads up
+    // to n values into p and returns the number read, which is less than n
+    // only at the end of the input. Each run [p, q) is sorted by
+    // sort_run(p, q).
+    template<typename T, typename F, typename S, typename O, typename C>
+      O
+      external_sort(F fill, S sort_run, O out, std::size_t budget, C comp)
+      {
+        static_assert(std::is_trivially_copyable<T>(),
+                      "externally sorted values must be trivially copyable");
+        std::size_t len = std::max<std::size_t>(1, budget / (2 * sizeof(T)));
+        std::vector<T> buf(len);
+        T* p = buf.data();
+        std::size_t n = fill(p, len);
+        if (n < len) {
+          sort_run(p, p + n);
+          return std::copy(p, p + n, out);
+        }
+
+        // Write the sorted runs to a temporary file.
+        file runs = file::temporary();
+        std::vector<run> bounds;
+        std::uint64_t off = 0;
+        while (n != 0) {
+          sort_run(p, p + n);
+          runs.write(p, n * sizeof(T));
+          bounds.push_back({off, n});
+          off += n * sizeof(T);
+          if (n < len)
+            break;
+          n = fill(p, len);
+        }
+        std::vector<T>().swap(buf);
+
+        // Merge groups of runs until all the runs can be merged at once.
+        std::size_t fan_in
+          = std::max<std::size_t>(2, budget / (2 * min_block) - 1);
+        while (bounds.size() > fan_in) {
+          file merged = file::temporary();
+          std::vector<run> next;
+          off = 0;
+          for (std::size_t i = 0; i < bounds.size(); i += fan_in) {
+            const run* first = bounds.data() + i;
+            const run* last = bounds.data()
+                            + std::min(bounds.size(), i + fan_in);
+            run_writer<T> w(merged, block_size<T>(budget, last - first));
+            merge_runs<T>(runs, first, last, budget, write_iterator<T>(w),
+                          comp);
+            w.flush();
+            next.push_back({off, w.count()});
+            off += w.count() * sizeof(T);
+          }
+          runs = std::move(merged);
+          bounds = std::move(next);
+        }
+        return merge_runs<T>(runs, bounds.data(),
+                             bounds.data() + bounds.size(), budget, out,
+                             comp);
+      }
+
+    // Sort the elements of range into out.
+    template<typename R, typename O, typename S, typename C>
+      O
+      external_sort_range(R&& range, O out, std::size_t budget, S sort_run,
+                          C comp)
+      {
+        using std::begin;
+        using std::end;
+        using T = Value_type<Iterator_of<R>>;
+        auto i = begin(range);
+        auto e = end(range);
+        auto fill = [&](T* p, std::size_t n) {
+          std::size_t k = 0;
+          for (; k != n && i != e; ++i)
+            p[k++] = *i;
+          return k;
+        };
+        return external_sort<T>(fill, sort_run, out, budget, comp);
+      }
+
+    // Sort the values of the file input into the file output.
+    template<typename T, typename S, typename C>
+      void
+      external_sort_file(const std::string& input, const std::string& output,
+                         std::size_t budget, S sort_run, C comp)
+      {
+        file in(input, false);
+        auto fill = [&](T* p, std::size_t n) {
+          std::size_t k = in.read(p, n * sizeof(T));
+          if (k % sizeof(T) != 0)
+            throw std::runtime_error(input + ": size is not a multiple of "
+                                     "the size of the values");
+          return k / sizeof(T);
+        };
+
+        // The output is not truncated until it has been written, since the
+        // input is read before any output is written, and they may be the
+        // same file.
+        file out(output, true);
+        run_writer<T> w(out, block_size<T>(budget, 1));
+        external_sort<T>(fill, sort_run, write_iterator<T>(w), budget, comp);
+        w.flush();
+        out.resize(w.count() * sizeof(T));
+      }
+
+    // Sorts runs serially.
+    template<typename C>
+      struct serial_run_sort
+      {
+        template<typename T>
+          void operator()(T* first, T* last) const
+          {
+            algorithm_impl::sort_dispatch(
+              first, last, comp, algorithm_impl::Radix_sortable<T*, C>());
+          }
+
+        C comp;
+      };
+
+    // Sorts runs with the parallel sort algorithm.
+    template<typename C>
+      struct parallel_run_sort
+      {
+        template<typename T>
+          void operator()(T* first, T* last) const
+          {
+            algorithm_impl::parallel_sort_dispatch(
+              pol, first, last, comp, false,
+              algorithm_impl::Radix_sortable<T*, C>());
+          }
+
+        parallel_policy pol;
+        C comp;
+      };
+
+  } // namespace external_impl
+
+
+  template<typename R, typename O, typename C>
+    inline O
+    external_sort(R&& range, O out, std::size_t budget, C comp)
+    {
+      static_assert(Input_range<R>(), "");
+      return external_impl::external_sort_range(
+        std::forward<R>(range), out, budget,
+        external_impl::serial_run_sort<C>{comp}, comp);
+    }
+
+  template<typename R, typename O>
+    inline O
+    external_sort(R&& range, O out, std::size_t budget)
+    {
+      return external_sort(std::forward<R>(range), out, budget,
+                           algorithm_impl::less_than());
+    }
+
+  template<typename R, typename O, typename C>
+    inline O
+    external_sort(parallel_policy pol, R&& range, O out, std::size_t budget,
+                  C comp)
+    {
+      static_assert(Input_range<R>(), "");
+      return external_impl::external_sort_range(
+        std::forward<R>(range), out, budget,
+        external_impl::parallel_run_sort<C>{pol, comp}, comp);
+    }
+
+  template<typename R, typename O>
+    inline O
+    external_sort(parallel_policy pol, R&& range, O out, std::size_t budget)
+    {
+      return external_sort(pol, std::forward<R>(range), out, budget,
+                           algorithm_impl::less_than());
+    }
+
+  template<typename T, typename C>
+    inline void
+    external_sort_file(const std::string& input, const std::string& output,
+                       std::size_t budget, C comp)
+    {
+      external_impl::external_sort_file<T>(
+        input, output, budget, external_impl::serial_run_sort<C>{comp},
+        comp);
+    }
+
+  template<typename T>
+    inline void
+    external_sort_file(const std::string& input, const std::string& output,
+                       std::size_t budget)
+    {
+      external_sort_file<T>(input, output, budget,
+                            algorithm_impl::less_than());
+    }
+
+  template<typename T, typename C>
+    inline void
+    external_sort_file(parallel_policy pol, const std::string& input,
+                       const std::string& output, std::size_t budget, C comp)
+    {
+      external_impl::external_sort_file<T>(
+        input, output, budget,
+        external_impl::parallel_run_sort<C>{pol, comp}, comp);
+    }
+
+  template<typename T>
+    inline void
+    external_sort_file(parallel_policy pol, const std::string& input,
+                       const std::string& output, std::size_t budget)
+    {
+      external_sort_file<T>(pol, input, output, budget,
+                            algorithm_impl::less_than());
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,124 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/external.hpp>
+
+using namespace std;
+using namespace origin;
+
+struct edge
+{
+  unsigned source;
+  unsigned target;
+};
+
+bool
+operator<(const edge& a, const edge& b)
+{
+  return a.source < b.source || (a.source == b.source && a.target < b.target);
+}
+
+vector<edge>
+random_edges(size_t n)
+{
+  minstd_rand prng(n);
+  vector<edge> es(n);
+  for (edge& e : es)
+    e = {unsigned(prng() % 1000), unsigned(prng() % 1000)};
+  return es;
+}
+
+bool
+equal_edges(const vector<edge>& a, const vector<edge>& b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i != a.size(); ++i)
+    if (a[i].source != b[i].source || a[i].target != b[i].target)
+      return false;
+  return true;
+}
+
+// Sort in memory, with one merge, and with several merge passes.
+void
+check_range()
+{
+  for (size_t n : {0, 1, 100, 5000, 100000}) {
+    vector<edge> es = random_edges(n);
+    vector<edge> expected = es;
+    std::sort(expected.begin(), expected.end());
+    for (size_t budget : {size_t(1) << 24, size_t(1) << 12}) {
+      vector<edge> out;
+      external_sort(es, back_inserter(out), budget);
+      assert(equal_edges(out, expected));
+    }
+  }
+
+  vector<int> v(30000);
+  minstd_rand prng(4);
+  for (int& x : v)
+    x = prng() % 100000;
+  vector<int> out(v.size());
+  auto i = external_sort(par, v, out.begin(), 1 << 14, greater<int>());
+  assert(i == out.end());
+  std::sort(v.begin(), v.end(), greater<int>());
+  assert(out == v);
+}
+
+// Sort a file in place.
+void
+check_file()
+{
+  string path = "external_sort.bin";
+  vector<edge> es = random_edges(50000);
+  {
+    ofstream f(path, ios::binary);
+    f.write(reinterpret_cast<const char*>(es.data()),
+            es.size() * sizeof(edge));
+  }
+  external_sort_file<edge>(path, path, 1 << 13);
+  vector<edge> sorted(es.size());
+  {
+    ifstream f(path, ios::binary);
+    f.read(reinterpret_cast<char*>(sorted.data()),
+           sorted.size() * sizeof(edge));
+    assert(f.gcount() == streamsize(sorted.size() * sizeof(edge)));
+    assert(f.peek() == EOF);
+  }
+  std::sort(es.begin(), es.end());
+  assert(equal_edges(sorted, es));
+
+  {
+    ofstream f(path, ios::binary | ios::app);
+    f.put(0);
+  }
+  bool thrown = false;
+  try {
+    external_sort_file<edge>(path, "external_sort.out", 1 << 13);
+  } catch (runtime_error&) {
+    thrown = true;
+  }
+  assert(thrown);
+  remove(path.c_str());
+  remove("external_sort.out");
+}
+
+int main()
+{
+  check_range();
+  check_file();
+}
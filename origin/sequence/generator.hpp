@@ -0,0 +1,285 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_GENERATOR_HPP
+#define ORIGIN_SEQUENCE_GENERATOR_HPP
+
+#include <cstddef>
+
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <origin/type/traits.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [seq.generator]
+  //                               Generators
+  //
+  //    generator<T>(f[, alloc])
+  //    make_generator<T>(f[, alloc])
+  //    lines(in)
+  //
+  // A generator is an input range whose values are computed as they are
+  // read, so that a traversal can be consumed by the range algorithms
+  // without first being stored. There are no coroutines in C++11, so the
+  // suspended state of the computation is written explicitly: a generator
+  // is made from a step function f, a function object for which f(x)
+  // assigns the next value to x and returns true, or returns false when
+  // there are no more values. The members of f hold the state of the
+  // computation between values, such as the queue of a breadth-first
+  // search (see [graph.search]) or the stream of a line reader:
+  //
+  //    int a = 0, b = 1;
+  //    auto fib = make_generator<int>([=](int& x) mutable {
+  //      x = a;
+  //      a = b;
+  //      b += x;
+  //      return true;
+  //    });
+  //    auto i = find_if(fib, [](int x) { return x > 100; });  // *i is 144
+  //
+  // The step function is moved into a frame, allocated once when the
+  // generator is made by alloc (by default, a std::allocator), which may be
+  // an arena_allocator (see [mem.arena_allocator]) when many short-lived
+  // generators are made. Computing a value then costs one indirect call,
+  // and no allocation. The frame is destroyed when the step function
+  // returns false, or when the generator is destroyed.
+  //
+  // A generator is a move-only, single-pass range of values of type T,
+  // which must be default constructible and assignable. Its begin() computes
+  // the first value; incrementing an iterator computes the next one, and
+  // invalidates the copies of that iterator. Calling begin() again returns
+  // an iterator to the current value. Reading a generator changes it, even
+  // through a const reference, as reading a stream does, so that it can be
+  // passed to the algorithms that take const ranges. The lines(in)
+  // generator reads the lines of the input stream in, without their
+  // newline characters.
+
+  namespace generator_impl
+  {
+    // The frame of a generator, holding its step function. A frame destroys
+    // and deallocates itself.
+    template<typename T>
+      struct frame
+      {
+        virtual bool next(T& x) = 0;
+        virtual void destroy() = 0;
+
+      protected:
+        ~frame() = default;
+      };
+
+    template<typename T, typename F, typename A>
+      struct step_frame : frame<T>
+      {
+        using Alloc = typename std::allocator_traits<A>::template
+                        rebind_alloc<step_frame>;
+
+        step_frame(F&& f, const Alloc& a)
+          : step(std::move(f)), alloc(a)
+        { }
+
+        bool next(T& x) override { return step(x); }
+
+        void destroy() override
+        {
+          Alloc a = alloc;
+          this->~step_frame();
+          std::allocator_traits<Alloc>::deallocate(a, this, 1);
+        }
+
+        F step;
+        Alloc alloc;
+      };
+
+  } // namespace generator_impl
+
+
+  template<typename T>
+    class generator
+    {
+    public:
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+
+      // The input iterator of a generator refers to its current value. The
+      // past-the-end iterator refers to no generator.
+      class iterator
+      {
+      public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator(const generator* g = nullptr)
+          : g(g)
+        { }
+
+        // Readable
+        reference operator*() const { return g->value; }
+        pointer operator->() const { return &g->value; }
+
+        // Increment
+        iterator& operator++()
+        {
+          if (!g->advance())
+            g = nullptr;
+          return *this;
+        }
+
+        void operator++(int) { operator++(); }
+
+        // Equality_comparable
+        bool operator==(const iterator& x) const { return g == x.g; }
+        bool operator!=(const iterator& x) const { return g != x.g; }
+
+      private:
+        const generator* g;
+      };
+
+      // Initialize an empty generator.
+      generator()
+        : f(nullptr), started(false), value()
+      { }
+
+      // Initialize the generator with the step function f, moved into a
+      // frame allocated by a.
+      template<typename F, typename A = std::allocator<char>,
+               typename = Requires<!Same<Decay<F>, generator>()>>
+        explicit generator(F f, const A& a = A())
+          : f(make_frame(std::move(f), a)), started(false), value()
+        { }
+
+      generator(generator&& x)
+        : f(x.f), started(x.started), value(std::move(x.value))
+      {
+        x.f = nullptr;
+      }
+
+      generator& operator=(generator&& x)
+      {
+        if (this != &x) {
+          clear();
+          f = x.f;
+          started = x.started;
+          value = std::move(x.value);
+          x.f = nullptr;
+        }
+        return *this;
+      }
+
+      generator(const generator&) = delete;
+      generator& operator=(const generator&) = delete;
+
+      ~generator() { clear(); }
+
+      // Range
+      iterator begin() const
+      {
+        if (!started) {
+          started = true;
+          advance();
+        }
+        return iterator(f ? this : nullptr);
+      }
+
+      iterator end() const { return iterator(); }
+
+    private:
+      template<typename F, typename A, typename Frame
+                 = generator_impl::step_frame<T, F, A>>
+        static generator_impl::frame<T>*
+        make_frame(F&& step, const A& a)
+        {
+          using Alloc = typename Frame::Alloc;
+          using Traits = std::allocator_traits<Alloc>;
+          Alloc alloc(a);
+          Frame* p = Traits::allocate(alloc, 1);
+          try {
+            ::new (static_cast<void*>(p)) Frame(std::move(step), alloc);
+          } catch (...) {
+            Traits::deallocate(alloc, p, 1);
+            throw;
+          }
+          return p;
+        }
+
+      // Compute the next value, returning false and destroying the frame
+      // if there is none.
+      bool advance() const
+      {
+        if (f && f->next(value))
+          return true;
+        clear();
+        return false;
+      }
+
+      void clear() const
+      {
+        if (f) {
+          f->destroy();
+          f = nullptr;
+        }
+      }
+
+    private:
+      mutable generator_impl::frame<T>* f;
+      mutable bool started;
+      mutable T value;
+    };
+
+
+  // Returns a generator of values of type T computed by the step function
+  // f, whose frame is allocated by alloc.
+  template<typename T, typename F, typename A>
+    inline generator<T>
+    make_generator(F f, const A& alloc)
+    {
+      return generator<T>(std::move(f), alloc);
+    }
+
+  template<typename T, typename F>
+    inline generator<T>
+    make_generator(F f)
+    {
+      return generator<T>(std::move(f));
+    }
+
+
+  namespace generator_impl
+  {
+    // The step function of a line reader.
+    struct line_reader
+    {
+      bool operator()(std::string& s) const
+      {
+        return bool(std::getline(*in, s));
+      }
+
+      std::istream* in;
+    };
+
+  } // namespace generator_impl
+
+
+  // Returns a generator of the lines of in.
+  inline generator<std::string>
+  lines(std::istream& in)
+  {
+    return generator<std::string>(generator_impl::line_reader {&in});
+  }
+
+} // namespace origin
+
+#endif
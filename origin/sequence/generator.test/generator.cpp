@@ -0,0 +1,110 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/memory/arena.hpp>
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/generator.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns a generator of the integers in [first, last).
+generator<int>
+iota(int first, int last)
+{
+  return make_generator<int>([=](int& x) mutable {
+    if (first == last)
+      return false;
+    x = first++;
+    return true;
+  });
+}
+
+// Counts the frames alive, to check that they are destroyed.
+struct tracked
+{
+  tracked(int& n) : n(&n) { ++*this->n; }
+  tracked(tracked&& x) : n(x.n) { ++*n; }
+  ~tracked() { --*n; }
+
+  bool operator()(int& x) { x = 0; return true; }
+
+  int* n;
+};
+
+int main()
+{
+  static_assert(Input_range<generator<int>>(), "");
+
+  // Values are read once, in order, by the range algorithms.
+  vector<int> v;
+  for (int x : iota(0, 5))
+    v.push_back(x);
+  assert((v == vector<int>{0, 1, 2, 3, 4}));
+  auto g = iota(0, 100);
+  assert(*find(g, 42) == 42);
+  auto i = g.begin();
+  assert(*i == 42);
+  assert(*++i == 43);
+  assert(count_if(g, [](int x) { return x % 2 == 0; }) == 28);
+  assert(g.begin() == g.end());
+
+  // Empty generators.
+  generator<int> e;
+  assert(e.begin() == e.end());
+  assert(iota(3, 3).begin() == iota(3, 3).end());
+
+  // An infinite generator can be read up to a value.
+  int a = 0, b = 1;
+  auto fib = make_generator<int>([=](int& x) mutable {
+    x = a;
+    a = b;
+    b += x;
+    return true;
+  });
+  assert(*find_if(fib, [](int x) { return x > 100; }) == 144);
+
+  // Generators are moved, and their frames are destroyed with them or
+  // when they end.
+  int live = 0;
+  {
+    generator<int> t(tracked {live});
+    assert(live == 1);
+    generator<int> u = std::move(t);
+    assert(live == 1 && t.begin() == t.end());
+    t = std::move(u);
+    assert(live == 1);
+  }
+  assert(live == 0);
+  auto f = iota(0, 2);
+  assert(*f.begin() == 0);
+  f = iota(5, 6);
+  assert(*f.begin() == 5);
+
+  // Frames are allocated from an arena.
+  arena ar;
+  for (int k = 0; k != 100; ++k) {
+    auto h = make_generator<int>([k](int& x) { x = k; return true; },
+                                 arena_allocator<char>(ar));
+    assert(*h.begin() == k);
+  }
+  assert(ar.capacity() != 0);
+
+  // Lines are read without their newlines.
+  istringstream in("first\nsecond\n\nfourth");
+  vector<string> ls;
+  for (const string& s : lines(in))
+    ls.push_back(s);
+  assert((ls == vector<string>{"first", "second", "", "fourth"}));
+}
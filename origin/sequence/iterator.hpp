@@ -8,17 +8,506 @@
 #ifndef ORIGIN_SEQUENCE_ITERATOR_HPP
 #define ORIGIN_SEQUENCE_ITERATOR_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "algorithm.hpp"
 
 namespace origin
 {
+	//////////////////////////////////////////////////////////////////////////////
+	// Iterator Facade
+	//
+	// The iterator facade defines the operators of an iterator in terms of a
+	// few members of the derived class D:
+	//
+	//    d.dereference()  -- returns *d
+	//    d.increment()    -- ++d
+	//    d.decrement()    -- --d, for bidirectional iterators
+	//    d.advance(n)     -- d += n, for random access iterators
+	//    d.distance_to(e) -- e - d, for random access iterators
+	//    d.equal(e)       -- d == e
+	//
+	// Only the operators used by a program are instantiated, so that the
+	// derived class need only define the members required by its category.
+	//
+	// Template Parameters:
+	//    D -- The derived iterator type
+	//    C -- The iterator category
+	//    V -- The value type
+	//    R -- The reference type
+	//    N -- The difference type
+	template <typename D, typename C, typename V, typename R,
+						typename N = std::ptrdiff_t>
+		class iterator_facade
+		{
+		public:
+			using iterator_category = C;
+			using value_type = V;
+			using reference = R;
+			using pointer = If<std::is_reference<R>::value,
+												 Remove_reference<R>*, void>;
+			using difference_type = N;
+
+			// Readable
+			reference operator*() const { return derived().dereference(); }
+
+			reference operator[](N n) const { return *(derived() + n); }
+
+			// Increment
+			D& operator++() { derived().increment(); return derived(); }
+			D operator++(int) { D tmp = derived(); ++*this; return tmp; }
+
+			// Decrement
+			D& operator--() { derived().decrement(); return derived(); }
+			D operator--(int) { D tmp = derived(); --*this; return tmp; }
+
+			// Advance
+			D& operator+=(N n) { derived().advance(n); return derived(); }
+			D& operator-=(N n) { derived().advance(-n); return derived(); }
+
+			friend D operator+(D i, N n) { return i += n; }
+			friend D operator+(N n, D i) { return i += n; }
+			friend D operator-(D i, N n) { return i -= n; }
+			friend N operator-(const D& a, const D& b) { return b.distance_to(a); }
+
+			// Equality comparable
+			friend bool operator==(const D& a, const D& b) { return a.equal(b); }
+			friend bool operator!=(const D& a, const D& b) { return !a.equal(b); }
+
+			// Totally ordered
+			friend bool operator<(const D& a, const D& b) { return a - b < 0; }
+			friend bool operator>(const D& a, const D& b) { return a - b > 0; }
+			friend bool operator<=(const D& a, const D& b) { return a - b <= 0; }
+			friend bool operator>=(const D& a, const D& b) { return a - b >= 0; }
+
+		private:
+			const D& derived() const { return static_cast<const D&>(*this); }
+			D& derived() { return static_cast<D&>(*this); }
+		};
+
+
+	namespace iterator_impl
+	{
+		// Returns the weaker of the iterator categories C1 and C2.
+		template <typename C1, typename C2>
+			using Weaker_category = If<Derived<C1, C2>(), C2, C1>;
+
+
+		// A function box holds a function object so that it can be assigned,
+		// even if the function object is not (e.g., a lambda expression), and
+		// default constructed, so that iterators holding functions are regular.
+		// A default constructed box holds no function, and must not be called.
+		template <typename F>
+			class function_box
+			{
+			public:
+				function_box()
+					: set(false)
+				{ }
+
+				function_box(const F& f)
+					: set(true)
+				{
+					new (&buf) F(f);
+				}
+
+				function_box(const function_box& x)
+					: set(x.set)
+				{
+					if (set)
+						new (&buf) F(x.get());
+				}
+
+				function_box& operator=(const function_box& x)
+				{
+					if (this != &x) {
+						reset();
+						if (x.set)
+							new (&buf) F(x.get());
+						set = x.set;
+					}
+					return *this;
+				}
+
+				~function_box() { reset(); }
+
+				const F& get() const { return *reinterpret_cast<const F*>(&buf); }
+
+				template <typename... Args>
+					auto operator()(Args&&... args) const
+						-> decltype(std::declval<const F&>()(std::forward<Args>(args)...))
+					{
+						return get()(std::forward<Args>(args)...);
+					}
+
+			private:
+				void reset()
+				{
+					if (set)
+						get().~F();
+					set = false;
+				}
+
+			private:
+				typename std::aligned_storage<sizeof(F), alignof(F)>::type buf;
+				bool set;
+			};
+
+		// Advance i by n, but not past last.
+		template <typename I>
+			inline void
+			bounded_advance(I& i, I last, Difference_type<I> n,
+											std::random_access_iterator_tag)
+			{
+				i += std::min(n, last - i);
+			}
+
+		template <typename I>
+			inline void
+			bounded_advance(I& i, I last, Difference_type<I> n,
+											std::input_iterator_tag)
+			{
+				for (; n != 0 && i != last; --n)
+					++i;
+			}
+
+		template <typename I>
+			inline void
+			bounded_advance(I& i, I last, Difference_type<I> n)
+			{
+				bounded_advance(i, last, n, Iterator_category<I>());
+			}
+	} // namespace iterator_impl
+
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Transform Iterator Adaptor
+	//
+	// A transform iterator refers to the results of applying a function to the
+	// elements of an underlying iterator. It has the category of the underlying
+	// iterator: its increment and dereference are those of the underlying
+	// iterator, followed by a call to the function.
+	//
+	// Template Parameters:
+	//    I -- The underlying iterator
+	//    F -- A function on the underlying iterator's reference type
+	template <typename I, typename F>
+		class transform_iterator
+			: public iterator_facade<transform_iterator<I, F>,
+															 Iterator_category<I>,
+															 Decay<Result_of<const F&(Reference_of<I>)>>,
+															 Result_of<const F&(Reference_of<I>)>,
+															 Difference_type<I>>
+		{
+			static_assert(Input_iterator<I>(), "");
+			using N = Difference_type<I>;
+		public:
+			transform_iterator() = default;
+
+			transform_iterator(I i, F f)
+				: cur(i), fn(f)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return cur; }
+
+			Result_of<const F&(Reference_of<I>)> dereference() const
+			{
+				return fn(*cur);
+			}
+
+			void increment() { ++cur; }
+			void decrement() { --cur; }
+			void advance(N n) { cur += n; }
+			N distance_to(const transform_iterator& x) const { return x.cur - cur; }
+			bool equal(const transform_iterator& x) const { return cur == x.cur; }
+
+		private:
+			I cur;
+			iterator_impl::function_box<F> fn;
+		};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Take Iterator Adaptor
+	//
+	// A take iterator counts the elements remaining in a prefix of a range.
+	// Two take iterators are equal when they have the same count, or the same
+	// underlying iterator, so that iteration stops at the end of the prefix or
+	// at the end of the underlying range, whichever comes first. For random
+	// access ranges, prefixes are taken directly, without this adaptor.
+	template <typename I>
+		class take_iterator
+			: public iterator_facade<take_iterator<I>,
+															 iterator_impl::Weaker_category<
+																 Iterator_category<I>,
+																 std::forward_iterator_tag>,
+															 Value_type<I>,
+															 Reference_of<I>,
+															 Difference_type<I>>
+		{
+			static_assert(Input_iterator<I>(), "");
+			using N = Difference_type<I>;
+		public:
+			take_iterator()
+				: cur(), count()
+			{ }
+
+			take_iterator(I i, N n)
+				: cur(i), count(n)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return cur; }
+
+			Reference_of<I> dereference() const { return *cur; }
+			void increment() { ++cur; --count; }
+			bool equal(const take_iterator& x) const
+			{
+				return count == x.count || cur == x.cur;
+			}
+
+		private:
+			I cur;
+			N count;
+		};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Stride Iterator Adaptor
+	//
+	// A stride iterator refers to every nth element of a range. Incrementing
+	// the iterator advances the underlying iterator by n elements, but not past
+	// the end of the range.
+	template <typename I>
+		class stride_iterator
+			: public iterator_facade<stride_iterator<I>,
+															 iterator_impl::Weaker_category<
+																 Iterator_category<I>,
+																 std::forward_iterator_tag>,
+															 Value_type<I>,
+															 Reference_of<I>,
+															 Difference_type<I>>
+		{
+			static_assert(Input_iterator<I>(), "");
+			using N = Difference_type<I>;
+		public:
+			stride_iterator()
+				: cur(), last(), step(1)
+			{ }
+
+			stride_iterator(I i, I l, N n)
+				: cur(i), last(l), step(n)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return cur; }
+
+			Reference_of<I> dereference() const { return *cur; }
+			void increment() { iterator_impl::bounded_advance(cur, last, step); }
+			bool equal(const stride_iterator& x) const { return cur == x.cur; }
+
+		private:
+			I cur;
+			I last;
+			N step;
+		};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Zip Iterator Adaptor
+	//
+	// A zip iterator refers to pairs of the elements of two ranges, traversed
+	// together. Two zip iterators are equal when either of their underlying
+	// iterators are, so that iteration stops at the end of the shorter range.
+	// The category is the weaker of the underlying iterators' categories.
+	template <typename I1, typename I2>
+		class zip_iterator
+			: public iterator_facade<zip_iterator<I1, I2>,
+															 iterator_impl::Weaker_category<
+																 Iterator_category<I1>,
+																 Iterator_category<I2>>,
+															 std::pair<Value_type<I1>, Value_type<I2>>,
+															 std::pair<Reference_of<I1>, Reference_of<I2>>,
+															 Difference_type<I1>>
+		{
+			static_assert(Input_iterator<I1>(), "");
+			static_assert(Input_iterator<I2>(), "");
+			using N = Difference_type<I1>;
+			using R = std::pair<Reference_of<I1>, Reference_of<I2>>;
+		public:
+			zip_iterator() = default;
+
+			zip_iterator(I1 i, I2 j)
+				: first(i), second(j)
+			{ }
+
+			// Returns the underlying iterators.
+			I1 base1() const { return first; }
+			I2 base2() const { return second; }
+
+			R dereference() const { return R(*first, *second); }
+			void increment() { ++first; ++second; }
+			void decrement() { --first; --second; }
+			void advance(N n) { first += n; second += n; }
+			N distance_to(const zip_iterator& x) const { return x.first - first; }
+			bool equal(const zip_iterator& x) const
+			{
+				return first == x.first || second == x.second;
+			}
+
+		private:
+			I1 first;
+			I2 second;
+		};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Enumerate Iterator Adaptor
+	//
+	// An enumerate iterator refers to pairs of the index and the element of
+	// the underlying iterator: (0, *first), (1, *++first), and so on.
+	template <typename I>
+		class enumerate_iterator
+			: public iterator_facade<enumerate_iterator<I>,
+															 Iterator_category<I>,
+															 std::pair<std::size_t, Value_type<I>>,
+															 std::pair<std::size_t, Reference_of<I>>,
+															 Difference_type<I>>
+		{
+			static_assert(Input_iterator<I>(), "");
+			using N = Difference_type<I>;
+			using R = std::pair<std::size_t, Reference_of<I>>;
+		public:
+			enumerate_iterator()
+				: cur(), index()
+			{ }
+
+			enumerate_iterator(I i, std::size_t n = 0)
+				: cur(i), index(n)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return cur; }
+
+			R dereference() const { return R(index, *cur); }
+			void increment() { ++cur; ++index; }
+			void decrement() { --cur; --index; }
+			void advance(N n) { cur += n; index += n; }
+			N distance_to(const enumerate_iterator& x) const { return x.cur - cur; }
+			bool equal(const enumerate_iterator& x) const { return cur == x.cur; }
+
+		private:
+			I cur;
+			std::size_t index;
+		};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Chunk Iterator Adaptor
+	//
+	// A chunk iterator refers to the consecutive parts of a forward range. The
+	// first extra parts have size + 1 elements, and the rest have size
+	// elements, except that the last may be shorter; the parts of chunk(range,
+	// n) have n elements, and the parts of split_for_threads(range, p) differ
+	// in size by at most one (see range.hpp). The reference type is a bounded
+	// range of the underlying iterator, passed as Range.
+	//
+	// A chunk iterator over a random access range is a random access iterator:
+	// the kth part is found in constant time, so that the parts can be divided
+	// among threads without traversing them.
+	template <typename I, typename Range>
+		class chunk_iterator
+			: public iterator_facade<chunk_iterator<I, Range>,
+															 If<Random_access_iterator<I>(),
+																	std::random_access_iterator_tag,
+																	std::forward_iterator_tag>,
+															 Range,
+															 Range,
+															 Difference_type<I>>
+		{
+			static_assert(Forward_iterator<I>(), "");
+			using N = Difference_type<I>;
+		public:
+			chunk_iterator()
+				: first(), cur(), next(), last(), index(0), size(1), extra(0)
+			{ }
+
+			// Construct an iterator to the kth part of [f, l). Unless I is a
+			// random access iterator, k must be 0: the end of the parts of [f, l)
+			// is the iterator to the first part of [l, l).
+			chunk_iterator(I f, I l, N n, N e = 0, N k = 0)
+				: first(f), cur(f), next(f), last(l), index(0), size(n), extra(e)
+			{
+				init(k, Iterator_category<I>());
+			}
+
+			// Returns the underlying iterator.
+			I base() const { return cur; }
+
+			Range dereference() const { return Range(cur, next); }
+
+			void increment()
+			{
+				cur = next;
+				++index;
+				iterator_impl::bounded_advance(next, last, size + (index < extra));
+			}
+
+			void decrement() { seek(index - 1); }
+			void advance(N n) { seek(index + n); }
+			N distance_to(const chunk_iterator& x) const { return x.index - index; }
+			bool equal(const chunk_iterator& x) const { return cur == x.cur; }
+
+		private:
+			void init(N k, std::random_access_iterator_tag) { seek(k); }
+			void init(N, std::forward_iterator_tag)
+			{
+				iterator_impl::bounded_advance(next, last, size + (extra > 0));
+			}
+
+			// Returns the offset of the kth part.
+			N start(N k) const { return k * size + std::min(k, extra); }
+
+			// Move to the kth part.
+			void seek(N k)
+			{
+				N len = last - first;
+				index = k;
+				cur = first + std::min(start(k), len);
+				next = first + std::min(start(k + 1), len);
+			}
+
+		private:
+			I first;
+			I cur;
+			I next;
+			I last;
+			N index;
+			N size;
+			N extra;
+		};
+
+
+
 	//////////////////////////////////////////////////////////////////////////////
 	// Filter Iterator Adaptor
 	//
-	// A filter iterator is
+	// A filter iterator refers to the elements of an underlying range that
+	// satisfy a predicate. The first such element is found on construction.
 	//
 	// Tempate Parameters:
 	//		I -- The underlying iterator
@@ -29,12 +518,19 @@ namespace origin
 			static_assert(Input_iterator<I>(), "");
 			static_assert(Predicate<P, Value_type<I>>(), "");
 		public:
+			using iterator_category
+				= iterator_impl::Weaker_category<Iterator_category<I>,
+				                                 std::forward_iterator_tag>;
 			using value_type = Value_type<I>;
 			using reference = Reference_of<I>;
 			using pointer = Pointer_of<I>;
+			using difference_type = Difference_type<I>;
 
 			// Constructors
 
+			// Construct a singular filter iterator.
+			filter_iterator() = default;
+
 			// Construct a filter iterator over the range [first, last).
 			filter_iterator(I first, I last, P pred = {});
 
@@ -54,7 +550,7 @@ namespace origin
 			const I& last() const { return std::get<1>(data); }
 
 			// Returns the predicate function of the filter iterator.
-			const P& pred() const { return std::get<2>(data); }
+			const P& pred() const { return std::get<2>(data).get(); }
 
 
 			// Readable
@@ -73,7 +569,7 @@ namespace origin
 			void advance();
 
 		private:
-			std::tuple<I, I, P> data;
+			std::tuple<I, I, iterator_impl::function_box<P>> data;
 		};
 
 
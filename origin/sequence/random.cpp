@@ -0,0 +1,15 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include "random.hpp"
+
+namespace origin
+{
+  constexpr std::uint64_t splitmix64::default_seed;
+  constexpr std::uint64_t splitmix64::gamma;
+  constexpr std::uint64_t xoshiro256ss::default_seed;
+} // namespace origin
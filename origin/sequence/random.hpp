@@ -0,0 +1,458 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_RANDOM_HPP
+#define ORIGIN_SEQUENCE_RANDOM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "concepts.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                             [random.urng]
+  //                      Uniform Random Number Generators
+  //
+  // A uniform random number generator is a generator whose results are
+  // unsigned integers uniformly distributed in [G::min(), G::max()]. The
+  // generators in this file model the concept, and can be used with the
+  // distributions and algorithms of the standard library.
+
+  namespace random_impl
+  {
+    // The result of G::min(), if any.
+    template<typename G>
+      struct get_min_result
+      {
+      private:
+        template<typename X>
+          static auto check(X*) -> decltype(X::min());
+        template<typename X>
+          static subst_failure check(...);
+      public:
+        using type = decltype(check<G>(nullptr));
+      };
+
+    // The result of G::max(), if any.
+    template<typename G>
+      struct get_max_result
+      {
+      private:
+        template<typename X>
+          static auto check(X*) -> decltype(X::max());
+        template<typename X>
+          static subst_failure check(...);
+      public:
+        using type = decltype(check<G>(nullptr));
+      };
+
+    template<typename G>
+      constexpr bool
+      Bounded_generator()
+      {
+        using R = Result_of<G()>;
+        return Same<typename get_min_result<G>::type, R>()
+            && Same<typename get_max_result<G>::type, R>();
+      }
+
+    template<typename G, bool = Generator<G>()>
+      struct urng_check : std::false_type { };
+
+    template<typename G>
+      struct urng_check<G, true>
+        : std::integral_constant<bool, Unsigned<Result_of<G()>>()
+                                       && Bounded_generator<G>()>
+      { };
+
+    inline std::uint64_t
+    rotl(std::uint64_t x, int k)
+    {
+      return (x << k) | (x >> (64 - k));
+    }
+
+    // The finalizer of splitmix64, a bijection on 64-bit integers whose
+    // outputs are well distributed even for consecutive inputs.
+    inline std::uint64_t
+    mix(std::uint64_t z)
+    {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      return z ^ (z >> 31);
+    }
+
+  } // namespace random_impl
+
+
+  // Returns true if G is a uniform random number generator.
+  template<typename G>
+    constexpr bool
+    Uniform_random_number_generator()
+    {
+      return random_impl::urng_check<Remove_reference<G>>::value;
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [random.splitmix]
+  //                                 Splitmix
+  //
+  // The splitmix64 engine is a counter-based generator: the ith result is a
+  // bijective mix of seed + i * gamma, for a fixed odd gamma. Since results
+  // are computed from the counter alone, discard(n) takes constant time, and
+  // stream(k) returns the kth of a family of generators whose seeds are
+  // derived from the seed of this one. Streams are identified by their
+  // index rather than by the thread that uses them, so that computations
+  // that draw from stream(k) for the kth unit of work are reproducible for
+  // any number of threads. The period of each stream is 2^64.
+  class splitmix64
+  {
+  public:
+    using result_type = std::uint64_t;
+
+    static constexpr std::uint64_t default_seed = 0;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit splitmix64(std::uint64_t s = default_seed)
+      : state(s)
+    { }
+
+    void seed(std::uint64_t s = default_seed) { state = s; }
+
+    result_type operator()()
+    {
+      state += gamma;
+      return random_impl::mix(state);
+    }
+
+    void discard(unsigned long long n) { state += n * gamma; }
+
+    // Returns the kth stream derived from the state of this generator.
+    splitmix64 stream(std::uint64_t k) const
+    {
+      return splitmix64(random_impl::mix(state ^ random_impl::mix(k + gamma)));
+    }
+
+    friend bool operator==(const splitmix64& a, const splitmix64& b)
+    {
+      return a.state == b.state;
+    }
+
+    friend bool operator!=(const splitmix64& a, const splitmix64& b)
+    {
+      return a.state != b.state;
+    }
+
+  private:
+    static constexpr std::uint64_t gamma = 0x9e3779b97f4a7c15ull;
+
+    std::uint64_t state;
+  };
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                           [random.xoshiro]
+  //                                 Xoshiro
+  //
+  // The xoshiro256ss engine implements xoshiro256** (Blackman and Vigna), a
+  // fast generator with 256 bits of state and a period of 2^256 - 1. It is
+  // seeded from the results of a splitmix64 engine, so that every seed gives
+  // a valid (non-zero) state. Calling jump() advances the engine by 2^128
+  // results, creating non-overlapping sequences for parallel computations.
+  class xoshiro256ss
+  {
+  public:
+    using result_type = std::uint64_t;
+
+    static constexpr std::uint64_t default_seed = 0;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    explicit xoshiro256ss(std::uint64_t s = default_seed)
+    {
+      seed(s);
+    }
+
+    void seed(std::uint64_t s = default_seed)
+    {
+      splitmix64 g(s);
+      for (std::uint64_t& x : state)
+        x = g();
+    }
+
+    result_type operator()()
+    {
+      using random_impl::rotl;
+      const std::uint64_t r = rotl(state[1] * 5, 7) * 9;
+      const std::uint64_t t = state[1] << 17;
+      state[2] ^= state[0];
+      state[3] ^= state[1];
+      state[1] ^= state[2];
+      state[0] ^= state[3];
+      state[2] ^= t;
+      state[3] = rotl(state[3], 45);
+      return r;
+    }
+
+    void discard(unsigned long long n)
+    {
+      for (; n != 0; --n)
+        (*this)();
+    }
+
+    // Advance the engine by 2^128 results.
+    void jump()
+    {
+      static constexpr std::uint64_t poly[] = {
+        0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+        0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+      };
+      std::uint64_t s[4] = {0, 0, 0, 0};
+      for (std::uint64_t p : poly) {
+        for (int b = 0; b != 64; ++b) {
+          if (p & (std::uint64_t(1) << b))
+            for (int i = 0; i != 4; ++i)
+              s[i] ^= state[i];
+          (*this)();
+        }
+      }
+      for (int i = 0; i != 4; ++i)
+        state[i] = s[i];
+    }
+
+    friend bool operator==(const xoshiro256ss& a, const xoshiro256ss& b)
+    {
+      for (int i = 0; i != 4; ++i)
+        if (a.state[i] != b.state[i])
+          return false;
+      return true;
+    }
+
+    friend bool operator!=(const xoshiro256ss& a, const xoshiro256ss& b)
+    {
+      return !(a == b);
+    }
+
+  private:
+    std::uint64_t state[4];
+  };
+
+
+  namespace random_impl
+  {
+    // Returns a uniformly distributed 64-bit integer using gen.
+    template<typename G>
+      inline std::uint64_t
+      random_bits(G& gen)
+      {
+        return std::uniform_int_distribution<std::uint64_t>()(gen);
+      }
+
+    // Returns a uniformly distributed real number in (0, 1) using gen.
+    template<typename G>
+      inline double
+      open_unit(G& gen)
+      {
+        return (double(random_bits(gen) >> 11) + 0.5) / 9007199254740992.0;
+      }
+
+  } // namespace random_impl
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                             [random.alias]
+  //                            Alias Distribution
+  //
+  // An alias distribution returns the index i of one of n weights with
+  // probability proportional to the ith weight, as std::discrete_distribution
+  // does, but in constant rather than logarithmic time. Each
+  // index is assigned a probability and an alias (Vose's alias method): a
+  // random index i is drawn uniformly, and i is returned with its
+  // probability, or its alias otherwise. Constructing the distribution takes
+  // linear time. The weights must be non-negative, with a positive sum.
+  class alias_distribution
+  {
+  public:
+    using result_type = std::size_t;
+
+    alias_distribution()
+      : prob(1, 1.0), alias(1, 0)
+    { }
+
+    template<typename I>
+      alias_distribution(I first, I last)
+      {
+        init(std::vector<double>(first, last));
+      }
+
+    alias_distribution(std::initializer_list<double> weights)
+    {
+      init(std::vector<double>(weights));
+    }
+
+    // Returns the number of weights.
+    std::size_t size() const { return prob.size(); }
+
+    result_type min() const { return 0; }
+    result_type max() const { return prob.size() - 1; }
+
+    template<typename G>
+      result_type operator()(G& gen) const
+      {
+        double x = random_impl::open_unit(gen) * prob.size();
+        std::size_t i = std::min(std::size_t(x), prob.size() - 1);
+        return x - i < prob[i] ? i : alias[i];
+      }
+
+  private:
+    void init(std::vector<double> w)
+    {
+      std::size_t n = w.size();
+      double sum = 0;
+      for (double x : w)
+        sum += x;
+      prob.assign(n, 1.0);
+      alias.resize(n);
+      for (std::size_t i = 0; i != n; ++i)
+        alias[i] = i;
+
+      // Each weight scaled to a mean of 1 is either small (below 1) or
+      // large. Each small index takes the rest of its probability from a
+      // large one, which is then small if its weight drops below 1.
+      std::vector<std::size_t> small;
+      std::vector<std::size_t> large;
+      for (std::size_t i = 0; i != n; ++i) {
+        w[i] *= n / sum;
+        (w[i] < 1.0 ? small : large).push_back(i);
+      }
+      while (!small.empty() && !large.empty()) {
+        std::size_t s = small.back();
+        std::size_t l = large.back();
+        small.pop_back();
+        prob[s] = w[s];
+        alias[s] = l;
+        w[l] -= 1.0 - w[s];
+        if (w[l] < 1.0) {
+          large.pop_back();
+          small.push_back(l);
+        }
+      }
+      // Any remaining indexes have a weight of 1, up to rounding.
+    }
+
+  private:
+    std::vector<double> prob;
+    std::vector<std::size_t> alias;
+  };
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                         [random.reservoir]
+  //                                Reservoirs
+  //
+  // A reservoir holds a random sample without replacement of at most k of
+  // the values pushed into it. Each value is given a random key, and the
+  // reservoir keeps the values with the k least keys (a bottom-k sample).
+  // The keys of weighted values are exponentially distributed with the
+  // weight as their rate, so that values are sampled with probabilities
+  // proportional to their weights (the A-Res algorithm of Efraimidis and
+  // Spirakis); unweighted values have a weight of 1.
+  //
+  // Since the sample of a set of values is determined by their keys,
+  // reservoirs are mergeable: merging the reservoirs of two sets of values
+  // gives the reservoir of their union. Parallel computations sample each
+  // block of a range into its own reservoir, and merge them.
+  template<typename T>
+    class reservoir
+    {
+    public:
+      using value_type = T;
+
+      explicit reservoir(std::size_t k = 0)
+        : cap(k)
+      {
+        items.reserve(k);
+      }
+
+      // Returns the greatest number of values held by the reservoir.
+      std::size_t capacity() const { return cap; }
+
+      // Returns the number of values held by the reservoir.
+      std::size_t size() const { return items.size(); }
+
+      bool empty() const { return items.empty(); }
+
+      // Offer the value x to the reservoir, with the given weight.
+      template<typename G>
+        void push(const T& x, G& gen, double weight = 1.0)
+        {
+          if (cap == 0 || weight <= 0)
+            return;
+          insert(-std::log(random_impl::open_unit(gen)) / weight, x);
+        }
+
+      // Add the values of the reservoir r to this one, which then holds a
+      // sample of the union of the values offered to both.
+      void merge(const reservoir& r)
+      {
+        for (const item& x : r.items)
+          insert(x.first, x.second);
+      }
+
+      // Returns the sampled values, in no particular order.
+      std::vector<T> values() const
+      {
+        std::vector<T> v;
+        v.reserve(items.size());
+        for (const item& x : items)
+          v.push_back(x.second);
+        return v;
+      }
+
+    private:
+      using item = std::pair<double, T>;
+
+      static bool less_key(const item& a, const item& b)
+      {
+        return a.first < b.first;
+      }
+
+      // The items are a max-heap on their keys.
+      void insert(double key, const T& x)
+      {
+        if (items.size() < cap) {
+          items.push_back(item(key, x));
+          std::push_heap(items.begin(), items.end(), less_key);
+        } else if (key < items.front().first) {
+          std::pop_heap(items.begin(), items.end(), less_key);
+          items.back() = item(key, x);
+          std::push_heap(items.begin(), items.end(), less_key);
+        }
+      }
+
+    private:
+      std::size_t cap;
+      std::vector<item> items;
+    };
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <origin/sequence/random.hpp>
+
+using namespace std;
+using namespace origin;
+
+static_assert(Uniform_random_number_generator<splitmix64>(), "");
+static_assert(Uniform_random_number_generator<xoshiro256ss&>(), "");
+static_assert(Uniform_random_number_generator<minstd_rand>(), "");
+static_assert(!Uniform_random_number_generator<int>(), "");
+static_assert(!Uniform_random_number_generator<int(*)()>(), "");
+
+// The results of an engine are roughly uniform: each of 16 buckets receives
+// about 1/16th of them.
+template<typename G>
+  void
+  check_uniform(G g)
+  {
+    vector<int> n(16);
+    for (int i = 0; i != 160000; ++i)
+      ++n[g() >> 60];
+    for (int x : n)
+      assert(x > 9000 && x < 11000);
+  }
+
+void
+check_splitmix()
+{
+  // The reference sequence for the seed 1234567.
+  splitmix64 g(1234567);
+  assert(g() == 6457827717110365317ull);
+  assert(g() == 3203168211198807973ull);
+  assert(g() == 9817491932198370423ull);
+
+  // Discarding is equivalent to drawing results.
+  splitmix64 a(42);
+  splitmix64 b(42);
+  for (int i = 0; i != 1000; ++i)
+    a();
+  b.discard(1000);
+  assert(a == b);
+  assert(a() == b());
+
+  // Streams depend on the state and the index.
+  assert(a.stream(0) == b.stream(0));
+  assert(a.stream(0) != a.stream(1));
+  assert(a.stream(0)() != a.stream(1)());
+  check_uniform(a);
+  check_uniform(a.stream(7));
+}
+
+void
+check_xoshiro()
+{
+  xoshiro256ss a;
+  xoshiro256ss b(xoshiro256ss::default_seed);
+  assert(a == b);
+  assert(a() == b());
+  b.seed(1);
+  assert(a != b);
+
+  a.seed(5);
+  b.seed(5);
+  for (int i = 0; i != 1000; ++i)
+    a();
+  b.discard(1000);
+  assert(a == b);
+
+  // Jumping gives a different, but reproducible, sequence.
+  b.jump();
+  assert(a != b);
+  a.jump();
+  assert(a == b);
+  check_uniform(a);
+
+  // The engines can be used with the standard distributions.
+  uniform_int_distribution<int> dist(1, 6);
+  for (int i = 0; i != 1000; ++i) {
+    int x = dist(a);
+    assert(1 <= x && x <= 6);
+  }
+}
+
+// Indexes are drawn in proportion to their weights.
+void
+check_alias()
+{
+  xoshiro256ss g(9);
+  alias_distribution d {1, 0, 3, 4};
+  assert(d.size() == 4 && d.min() == 0 && d.max() == 3);
+  vector<int> n(4);
+  for (int i = 0; i != 80000; ++i)
+    ++n[d(g)];
+  assert(n[1] == 0);
+  assert(n[0] > 9000 && n[0] < 11000);
+  assert(n[2] > 29000 && n[2] < 31000);
+  assert(n[3] > 39000 && n[3] < 41000);
+
+  vector<double> w(100, 1.0);
+  alias_distribution u(w.begin(), w.end());
+  vector<int> m(100);
+  for (int i = 0; i != 100000; ++i)
+    ++m[u(g)];
+  for (int x : m)
+    assert(x > 850 && x < 1150);
+
+  alias_distribution one;
+  assert(one(g) == 0);
+}
+
+int main()
+{
+  check_splitmix();
+  check_xoshiro();
+  check_alias();
+}
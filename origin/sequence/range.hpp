@@ -8,6 +8,13 @@
 #ifndef ORIGIN_SEQUENCE_RANGE_HPP
 #define ORIGIN_SEQUENCE_RANGE_HPP
 
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include <iterator>
+
 #include <origin/type/concepts.hpp>
 
 #include "concepts.hpp"
@@ -81,6 +88,327 @@ namespace origin
 
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Range Adaptors
+  //
+  // The range adaptors return lazy views of a range: bounded ranges of the
+  // iterator adaptors in iterator.hpp. No elements are copied, and no
+  // functions are called, until a view is traversed. Adaptors compose, and
+  // traversing a composition of adaptors is a single loop over the
+  // underlying range, with no intermediate containers. For example:
+  //
+  //    for (auto x : take(filter(transform(v, f), p), 10))
+  //      // do something with the first 10 values of f(v[i]) satisfying p
+  //
+  // The adaptors are:
+  //
+  //    transform(range, f)   -- the values f(x) for each x in range
+  //    filter(range, pred)   -- the elements x of range for which pred(x)
+  //    take(range, n)        -- the first n elements of range
+  //    stride(range, n)      -- every nth element of range, starting with
+  //                             the first
+  //    chunk(range, n)       -- consecutive subranges of n elements of a
+  //                             forward range; the last may be shorter
+  //    split_for_threads(range, p)
+  //                          -- at most p consecutive subranges of a forward
+  //                             range, whose sizes differ by at most one
+  //    zip(range1, range2)   -- pairs of the elements of both ranges, up to
+  //                             the end of the shorter
+  //    enumerate(range)      -- pairs of the index and element of each
+  //                             element of range
+  //
+  // A view refers to the elements of its underlying range, which must
+  // outlive it. The views of transform, zip and enumerate have the category
+  // of their underlying ranges; take of a random access range is a bounded
+  // range of its iterators. The views of chunk and split_for_threads are
+  // random access ranges when their underlying ranges are, so that their
+  // subranges can be found and divided among threads in constant time.
+
+  template <typename R, typename F>
+    inline bounded_range<transform_iterator<Iterator_of<R>, F>>
+    transform(R&& range, F f)
+    {
+      using std::begin;
+      using std::end;
+      using I = transform_iterator<Iterator_of<R>, F>;
+      return {I(begin(range), f), I(end(range), f)};
+    }
+
+  template <typename R, typename P>
+    inline bounded_range<filter_iterator<Iterator_of<R>, P>>
+    filter(R&& range, P pred)
+    {
+      using std::begin;
+      using std::end;
+      return {make_filter(begin(range), end(range), pred),
+              make_filter(end(range), pred)};
+    }
+
+
+  namespace range_impl
+  {
+    // Returns the parts of [first, last) with n + 1 elements for the first
+    // e parts, and n for the rest. The end of the parts of a random access
+    // range is found directly, so that the parts can be counted and divided
+    // in constant time.
+    template <typename I>
+      inline bounded_range<chunk_iterator<I, bounded_range<I>>>
+      parts(I first, I last, Difference_type<I> n, Difference_type<I> e,
+            std::random_access_iterator_tag)
+      {
+        using C = chunk_iterator<I, bounded_range<I>>;
+        Difference_type<I> len = last - first;
+        Difference_type<I> k = e != 0 ? e + (len - e * (n + 1)) / n
+                                      : (len + n - 1) / n;
+        return {C(first, last, n, e), C(first, last, n, e, k)};
+      }
+
+    template <typename I>
+      inline bounded_range<chunk_iterator<I, bounded_range<I>>>
+      parts(I first, I last, Difference_type<I> n, Difference_type<I> e,
+            std::forward_iterator_tag)
+      {
+        using C = chunk_iterator<I, bounded_range<I>>;
+        return {C(first, last, n, e), C(last, last, n, e)};
+      }
+
+    template <typename I>
+      inline bounded_range<I>
+      take(I first, I last, Difference_type<I> n,
+           std::random_access_iterator_tag)
+      {
+        return {first, first + std::min(n, last - first)};
+      }
+
+    template <typename I>
+      inline bounded_range<take_iterator<I>>
+      take(I first, I last, Difference_type<I> n, std::input_iterator_tag)
+      {
+        return {take_iterator<I>(first, n), take_iterator<I>(last, 0)};
+      }
+
+    // The end of a zip view stops at the end of the shorter range. For
+    // random access ranges, the end is computed, so that the difference of
+    // zip iterators is their distance.
+    template <typename I1, typename I2>
+      inline bounded_range<zip_iterator<I1, I2>>
+      zip(I1 first1, I1 last1, I2 first2, I2 last2, std::true_type)
+      {
+        using I = zip_iterator<I1, I2>;
+        auto n = std::min<Difference_type<I1>>(last1 - first1,
+                                               last2 - first2);
+        return {I(first1, first2), I(first1 + n, first2 + n)};
+      }
+
+    template <typename I1, typename I2>
+      inline bounded_range<zip_iterator<I1, I2>>
+      zip(I1 first1, I1 last1, I2 first2, I2 last2, std::false_type)
+      {
+        using I = zip_iterator<I1, I2>;
+        return {I(first1, first2), I(last1, last2)};
+      }
+  } // namespace range_impl
+
+
+  template <typename R>
+    inline auto
+    take(R&& range, Difference_type<Iterator_of<R>> n)
+      -> decltype(range_impl::take(std::begin(range), std::end(range), n,
+                                   Iterator_category<Iterator_of<R>>()))
+    {
+      using std::begin;
+      using std::end;
+      return range_impl::take(begin(range), end(range), n,
+                              Iterator_category<Iterator_of<R>>());
+    }
+
+  template <typename R>
+    inline bounded_range<stride_iterator<Iterator_of<R>>>
+    stride(R&& range, Difference_type<Iterator_of<R>> n)
+    {
+      using std::begin;
+      using std::end;
+      assert(n > 0);
+      using I = stride_iterator<Iterator_of<R>>;
+      return {I(begin(range), end(range), n), I(end(range), end(range), n)};
+    }
+
+  template <typename R>
+    inline bounded_range<chunk_iterator<Iterator_of<R>,
+                                        bounded_range<Iterator_of<R>>>>
+    chunk(R&& range, Difference_type<Iterator_of<R>> n)
+    {
+      using std::begin;
+      using std::end;
+      assert(n > 0);
+      return range_impl::parts(begin(range), end(range), n, 0,
+                               Iterator_category<Iterator_of<R>>());
+    }
+
+  template <typename R>
+    inline bounded_range<chunk_iterator<Iterator_of<R>,
+                                        bounded_range<Iterator_of<R>>>>
+    split_for_threads(R&& range, std::size_t workers)
+    {
+      using std::begin;
+      using std::end;
+      using N = Difference_type<Iterator_of<R>>;
+      assert(workers > 0);
+      N n = std::distance(begin(range), end(range));
+      N p = std::min(n, N(workers));
+      if (p == 0)
+        return chunk(range, 1);
+      return range_impl::parts(begin(range), end(range), n / p, n % p,
+                               Iterator_category<Iterator_of<R>>());
+    }
+
+  template <typename R1, typename R2>
+    inline bounded_range<zip_iterator<Iterator_of<R1>, Iterator_of<R2>>>
+    zip(R1&& range1, R2&& range2)
+    {
+      using std::begin;
+      using std::end;
+      using Ra = std::integral_constant<bool, Random_access_range<R1>()
+                                              && Random_access_range<R2>()>;
+      return range_impl::zip(begin(range1), end(range1),
+                             begin(range2), end(range2), Ra());
+    }
+
+  template <typename R>
+    inline bounded_range<enumerate_iterator<Iterator_of<R>>>
+    enumerate(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      using I = enumerate_iterator<Iterator_of<R>>;
+      return {I(begin(range)), I(end(range))};
+    }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Splittable Ranges
+  //
+  // A splittable range can be divided into two halves, in constant time, by
+  // split(range), which returns a pair of ranges. The halves are themselves
+  // splittable ranges of the same type, so that a range can be divided
+  // recursively, by a work-stealing scheduler, into as many subranges as
+  // there are idle threads. Random access ranges (including the views of
+  // chunk and split_for_threads of random access ranges) are splittable.
+  //
+  //    split(range)
+  //    split_size(range)
+  //    for_each_subrange(par, range, grain, f)
+  //
+  // The split_size function measures the range for splitting. For random
+  // access ranges it is the number of elements. Other splittable ranges
+  // overload both functions, found by argument dependent lookup; the size of
+  // such a range may be an upper bound on its number of elements, but each
+  // half of a split must be smaller than the range that was split.
+  //
+  // The for_each_subrange algorithm calls f(r) for subranges r of at most
+  // grain elements, partitioning range, in parallel (see [exec.sched]): a
+  // task splits its range, spawns a task for the second half and continues
+  // with the first, so that idle threads steal the largest subranges.
+
+  template <typename R>
+    inline auto
+    split(R&& range)
+      -> Requires<Random_access_range<R>(),
+                  std::pair<bounded_range<Iterator_of<R>>,
+                            bounded_range<Iterator_of<R>>>>
+    {
+      using std::begin;
+      using std::end;
+      using B = bounded_range<Iterator_of<R>>;
+      auto first = begin(range);
+      auto last = end(range);
+      auto mid = first + (last - first) / 2;
+      return {B(first, mid), B(mid, last)};
+    }
+
+  template <typename R>
+    inline auto
+    split_size(const R& range)
+      -> Requires<Random_access_range<R>(), std::size_t>
+    {
+      using std::begin;
+      using std::end;
+      return end(range) - begin(range);
+    }
+
+
+  namespace range_impl
+  {
+    // The result of split(r), if any.
+    template <typename R>
+      struct get_split_result
+      {
+      private:
+        template <typename X>
+          static auto check(X&& x) -> decltype(split(x));
+        static subst_failure check(...);
+      public:
+        using type = decltype(check(std::declval<R&>()));
+      };
+
+    template <typename R>
+      using Split_result = typename get_split_result<R>::type;
+
+    // The halves H of a split are splittable into halves of type H.
+    template <typename S>
+      struct split_closed : std::false_type { };
+
+    template <typename H>
+      struct split_closed<std::pair<H, H>>
+        : std::is_same<Split_result<H>, std::pair<H, H>>
+      { };
+  } // namespace range_impl
+
+
+  // Returns true if R is a splittable range.
+  template <typename R>
+    constexpr bool Splittable_range()
+    {
+      return Range<R>()
+          && range_impl::split_closed<range_impl::Split_result<R>>::value;
+    }
+
+
+  namespace range_impl
+  {
+    template <typename R, typename F>
+      void
+      for_each_subrange(task_group& g, R range, std::size_t grain, F& f)
+      {
+        while (split_size(range) > grain) {
+          auto halves = split(range);
+          g.run([&g, halves, grain, &f]() {
+            for_each_subrange(g, halves.second, grain, f);
+          });
+          range = halves.first;
+        }
+        f(range);
+      }
+  } // namespace range_impl
+
+
+  template <typename R, typename F>
+    void
+    for_each_subrange(parallel_policy pol, R&& range, std::size_t grain, F f)
+    {
+      static_assert(Splittable_range<R>(), "");
+      using std::begin;
+      using std::end;
+      using B = bounded_range<Iterator_of<R>>;
+      task_group g(pol.scheduler());
+      range_impl::for_each_subrange(g, B(begin(range), end(range)),
+                                    std::max<std::size_t>(grain, 1), f);
+      g.wait();
+    }
+
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Range Size
   //
@@ -113,12 +441,12 @@ namespace origin
     inline auto 
     size(const R& range) 
       -> Requires<Range<R>() && !Has_member_size<R>(),
-                  Make_unsigned<Difference_type<R>>
+                  Make_unsigned<Difference_type<Iterator_of<R>>>
       >
     {
       using std::begin;
       using std::end;
-      return distance(begin(range), end(range));
+      return std::distance(begin(range), end(range));
     }
   
 
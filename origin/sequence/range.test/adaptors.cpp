@@ -0,0 +1,134 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/range.hpp>
+
+using namespace std;
+using namespace origin;
+
+using V = vector<int>;
+
+// Returns the elements of a range, in order.
+template <typename R>
+  V
+  values(R&& range)
+  {
+    V v;
+    for (auto&& x : range)
+      v.push_back(x);
+    return v;
+  }
+
+void
+check_adaptors()
+{
+  V v {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  list<int> l(v.begin(), v.end());
+  auto square = [](int x) { return x * x; };
+  auto odd = [](int x) { return x % 2 == 1; };
+
+  assert((values(transform(v, square)) == V{0, 1, 4, 9, 16, 25, 36, 49, 64,
+                                            81}));
+  assert((values(filter(l, odd)) == V{1, 3, 5, 7, 9}));
+  assert((values(take(v, 3)) == V{0, 1, 2}));
+  assert((values(take(l, 3)) == V{0, 1, 2}));
+  assert(values(take(l, 20)) == v);
+  assert(values(take(v, 0)).empty());
+  assert((values(stride(v, 3)) == V{0, 3, 6, 9}));
+  assert((values(stride(l, 4)) == V{0, 4, 8}));
+
+  // Adaptors compose.
+  assert((values(take(filter(transform(l, square), odd), 3)) == V{1, 9, 25}));
+  assert((values(stride(filter(v, odd), 2)) == V{1, 5, 9}));
+
+  // Taking a prefix of a random access range gives its own iterators.
+  bounded_range<V::iterator> t = take(v, 4);
+  assert(t.end() - t.begin() == 4);
+}
+
+void
+check_chunk()
+{
+  V v {0, 1, 2, 3, 4, 5, 6};
+  vector<V> c;
+  for (auto r : chunk(v, 3))
+    c.push_back(values(r));
+  assert((c == vector<V>{{0, 1, 2}, {3, 4, 5}, {6}}));
+
+  list<int> l(v.begin(), v.end());
+  size_t n = 0;
+  for (auto r : chunk(l, 7))
+    n += values(r).size();
+  assert(n == 7);
+  assert(values(transform(chunk(v, 10), [](bounded_range<V::iterator> r) {
+    return int(r.end() - r.begin());
+  })) == V{7});
+  V e;
+  assert(chunk(e, 2).begin() == chunk(e, 2).end());
+}
+
+void
+check_zip()
+{
+  V v {1, 2, 3, 4};
+  list<string> s {"a", "b", "c"};
+  vector<string> z;
+  for (auto p : zip(v, s))
+    z.push_back(to_string(p.first) + p.second);
+  assert((z == vector<string>{"1a", "2b", "3c"}));
+
+  // Zipped random access ranges are random access, and their references
+  // can be assigned through.
+  V w {10, 20};
+  auto r = zip(v, w);
+  assert(r.end() - r.begin() == 2);
+  assert(r.begin()[1].second == 20);
+  for (auto p : r)
+    p.first = p.second;
+  assert((v == V{10, 20, 3, 4}));
+
+  for (auto p : enumerate(w))
+    p.second += p.first;
+  assert((w == V{10, 21}));
+  auto e = enumerate(s);
+  assert((*++e.begin()).first == 1 && (*++e.begin()).second == "b");
+}
+
+// Views of function objects are regular, so they can be used with the
+// standard algorithms, which assign iterators.
+void
+check_algorithms()
+{
+  V v {3, 1, 4, 1, 5, 9, 2, 6};
+  int k = 10;
+  auto r = transform(v, [k](int x) { return k - x; });
+  assert(*max_element(r.begin(), r.end()) == 9);
+  assert(max_element(r.begin(), r.end()).base() == v.begin() + 1);
+  assert(distance(r.begin(), r.end()) == 8);
+  auto i = r.begin();
+  i = r.end();
+  assert(i == r.end());
+
+  auto f = filter(v, [k](int x) { return x > 3; });
+  assert(count_if(f.begin(), f.end(), [](int) { return true; }) == 4);
+  assert(*min_element(f.begin(), f.end()) == 4);
+}
+
+int main()
+{
+  check_adaptors();
+  check_chunk();
+  check_zip();
+  check_algorithms();
+}
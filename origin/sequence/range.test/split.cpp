@@ -0,0 +1,116 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <origin/sequence/range.hpp>
+
+using namespace std;
+using namespace origin;
+
+using V = vector<int>;
+using B = bounded_range<V::iterator>;
+using C = decltype(chunk(declval<V&>(), 1));
+
+static_assert(Splittable_range<V>(), "");
+static_assert(Splittable_range<B>(), "");
+static_assert(Splittable_range<C>(), "");
+static_assert(Random_access_range<C>(), "");
+static_assert(!Splittable_range<list<int>>(), "");
+
+// Returns the sizes of the parts of a range.
+template <typename R>
+  V
+  sizes(R&& parts)
+  {
+    V v;
+    for (auto r : parts)
+      v.push_back(distance(r.begin(), r.end()));
+    return v;
+  }
+
+void
+check_parts()
+{
+  V v(10);
+  list<int> l(10);
+  assert((sizes(split_for_threads(v, 4)) == V{3, 3, 2, 2}));
+  assert((sizes(split_for_threads(l, 4)) == V{3, 3, 2, 2}));
+  assert((sizes(split_for_threads(v, 5)) == V{2, 2, 2, 2, 2}));
+  assert((sizes(split_for_threads(v, 20)) == V(10, 1)));
+  assert((sizes(chunk(v, 4)) == V{4, 4, 2}));
+  assert((sizes(chunk(l, 4)) == V{4, 4, 2}));
+  V e;
+  assert(sizes(split_for_threads(e, 3)).empty());
+  assert(sizes(chunk(e, 3)).empty());
+
+  // The parts of a random access range are found in constant time.
+  V w(1000);
+  auto p = split_for_threads(w, 7);
+  assert(p.end() - p.begin() == 7);
+  size_t n = 0;
+  for (int i = 0; i != 7; ++i) {
+    auto r = p.begin()[i];
+    assert(r.begin() == w.begin() + n);
+    n += r.end() - r.begin();
+  }
+  assert(n == w.size());
+  auto i = p.end();
+  --i;
+  assert((*i).end() == w.end());
+  assert(i - p.begin() == 6 && i > p.begin());
+
+  auto c = chunk(w, 300);
+  assert(c.end() - c.begin() == 4);
+  assert((*(c.begin() + 3)).end() - (*(c.begin() + 3)).begin() == 100);
+}
+
+void
+check_split()
+{
+  V v {1, 2, 3, 4, 5};
+  auto h = split(v);
+  assert(h.first.end() == h.second.begin());
+  assert(h.first.end() - h.first.begin() == 2);
+
+  // Subranges partition the range, and are at most grain elements.
+  task_scheduler s4(4);
+  V w(100000, 1);
+  atomic<long> sum(0);
+  atomic<int> calls(0);
+  for_each_subrange(par.on(s4), w, 1000, [&](B r) {
+    assert(r.end() - r.begin() <= 1000);
+    long n = 0;
+    for (int x : r)
+      n += x;
+    sum += n;
+    ++calls;
+  });
+  assert(sum == 100000);
+  assert(calls >= 100);
+
+  // The parts of a range can be split among threads.
+  atomic<long> parts(0);
+  for_each_subrange(par.on(s4), chunk(w, 10), 50, [&](C r) {
+    for (auto p : r)
+      parts += p.end() - p.begin();
+  });
+  assert(parts == 100000);
+
+  V e;
+  for_each_subrange(par, e, 10, [&](B r) { assert(r.begin() == r.end()); });
+}
+
+int main()
+{
+  check_parts();
+  check_split();
+}
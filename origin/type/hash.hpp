@@ -0,0 +1,159 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_TYPE_HASH_HPP
+#define ORIGIN_TYPE_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+
+#include "traits.hpp"
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                [type.hash]
+  //                                Hashing
+  //
+  // The hashing library provides fast, non-cryptographic hashes of integers
+  // and of tuples of values, for use by hash tables:
+  //
+  //    hash_mix(x)             Mix the bits of the 64-bit integer x
+  //    hash_combine(h, k)      Combine the hash h with the hash k
+  //    hash_value(x)           Hash the value x
+  //    hash_values(x, ...)     Hash the sequence of values x, ...
+  //    hash_each(range, out)   Write the hash of each value of range to out
+  //
+  // The mixer is that of wyhash: the 128-bit product of x and a constant,
+  // each offset by another, folded to 64 bits by xoring its halves. It takes
+  // one multiplication, and each bit of the result depends on every bit of
+  // x, so that the indexes of dense handles, which std::hash<std::size_t>
+  // returns unchanged, are spread over the whole range. Combining two
+  // hashes is one more such product, which depends on the order of the
+  // hashes.
+  //
+  // Integers, enumerations and pointers are hashed by the mixer; other
+  // types are hashed by std::hash. The hashes are not stable across
+  // platforms, and must not be stored.
+  namespace hash_impl
+  {
+    // The constants of wyhash.
+    constexpr std::uint64_t p0 = 0xa0761d6478bd642full;
+    constexpr std::uint64_t p1 = 0xe7037ed1a0b428dbull;
+
+    // Returns the xor of the halves of the 128-bit product of a and b.
+    inline std::uint64_t
+    mum(std::uint64_t a, std::uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+      unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+      return std::uint64_t(r) ^ std::uint64_t(r >> 64);
+#else
+      std::uint64_t ha = a >> 32, la = std::uint32_t(a);
+      std::uint64_t hb = b >> 32, lb = std::uint32_t(b);
+      std::uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+      std::uint64_t mid = (ll >> 32) + std::uint32_t(hl) + std::uint32_t(lh);
+      std::uint64_t lo = (mid << 32) | std::uint32_t(ll);
+      std::uint64_t hi = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+      return lo ^ hi;
+#endif
+    }
+  } // namespace hash_impl
+
+  inline std::size_t
+  hash_mix(std::uint64_t x)
+  {
+    return hash_impl::mum(x ^ hash_impl::p0, hash_impl::p1);
+  }
+
+  inline std::size_t
+  hash_combine(std::size_t h, std::size_t k)
+  {
+    return hash_impl::mum(h ^ hash_impl::p0, k ^ hash_impl::p1);
+  }
+
+
+  // Hash value
+  template<typename T>
+    inline Requires<std::is_integral<T>::value || std::is_enum<T>::value,
+                    std::size_t>
+    hash_value(T x)
+    {
+      return hash_mix(static_cast<std::uint64_t>(x));
+    }
+
+  template<typename T>
+    inline std::size_t
+    hash_value(T* p)
+    {
+      return hash_mix(reinterpret_cast<std::uintptr_t>(p));
+    }
+
+  template<typename T>
+    inline Requires<!std::is_integral<T>::value && !std::is_enum<T>::value,
+                    std::size_t>
+    hash_value(const T& x)
+    {
+      return std::hash<T>{}(x);
+    }
+
+
+  // Hash values
+  template<typename T>
+    inline std::size_t
+    hash_values(const T& x)
+    {
+      return hash_value(x);
+    }
+
+  template<typename T, typename... Ts>
+    inline std::size_t
+    hash_values(const T& x, const Ts&... xs)
+    {
+      return hash_combine(hash_value(x), hash_values(xs...));
+    }
+
+
+  // Hash each
+  //
+  // Write the hash of each value of range to the output iterator out, and
+  // return the end of the output. The hash function defaults to that of
+  // hash_value. The hashes of a batch are independent, so that the
+  // multiplications of several values are in flight at once.
+  template<typename R, typename O, typename H>
+    O
+    hash_each(const R& range, O out, H hash)
+    {
+      using std::begin;
+      using std::end;
+      for (auto i = begin(range); i != end(range); ++i, ++out)
+        *out = hash(*i);
+      return out;
+    }
+
+  namespace hash_impl
+  {
+    struct hash_value_fn
+    {
+      template<typename T>
+        std::size_t operator()(const T& x) const { return hash_value(x); }
+    };
+  } // namespace hash_impl
+
+  template<typename R, typename O>
+    inline O
+    hash_each(const R& range, O out)
+    {
+      return hash_each(range, out, hash_impl::hash_value_fn());
+    }
+
+} // namespace origin
+
+#endif
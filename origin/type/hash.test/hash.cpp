@@ -0,0 +1,70 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <origin/type/hash.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The probe positions of a table of 2^k slots (the low bits) and its
+// control bits (the high bits) of consecutive integers are all distinct.
+void check_mix()
+{
+  set<size_t> low, high;
+  for (uint64_t i = 0; i != 4096; ++i) {
+    size_t h = hash_mix(i);
+    low.insert(h & 0xffff);
+    high.insert(h >> 48);
+  }
+  assert(low.size() > 4000 && high.size() > 4000);
+
+  // Flipping one bit of the input flips about half of the output bits.
+  int total = 0;
+  for (int b = 0; b != 64; ++b) {
+    size_t d = hash_mix(12345) ^ hash_mix(12345 ^ (uint64_t(1) << b));
+    total += __builtin_popcountll(d);
+  }
+  assert(total > 64 * 24 && total < 64 * 40);
+}
+
+enum color { red, green };
+
+void check_values()
+{
+  assert(hash_value(3) == hash_mix(3));
+  assert(hash_value(green) == hash_mix(1));
+  int x = 0;
+  assert(hash_value(&x) == hash_value(&x));
+  assert(hash_value(string("a")) == hash<string>()("a"));
+
+  // Combining is deterministic and depends on the order.
+  assert(hash_values(1, 2) == hash_values(1, 2));
+  assert(hash_values(1, 2) != hash_values(2, 1));
+  assert(hash_values(1, 2, 3) != hash_values(1, 3, 2));
+  assert(hash_values(1, 2) == hash_combine(hash_value(1), hash_value(2)));
+
+  vector<int> v {4, 5, 6};
+  vector<size_t> h;
+  hash_each(v, back_inserter(h));
+  assert(h.size() == 3 && h[1] == hash_value(5));
+  size_t a[3];
+  assert(hash_each(v, a, [](int n) { return size_t(n); }) == a + 3);
+  assert(a[2] == 6);
+}
+
+int main()
+{
+  check_mix();
+  check_values();
+}
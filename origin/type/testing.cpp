@@ -7,7 +7,9 @@
 // and conditions.
 
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 #include "testing.hpp"
 
@@ -21,8 +23,13 @@ namespace origin
     // The context instance.
     context* context::inst = nullptr;
 
+    thread_local std::minstd_rand* context::stream = nullptr;
+    thread_local std::size_t context::stream_check = 0;
+    thread_local std::size_t context::stream_case = 0;
+
     context::context()
-      : prng(), os(&std::cerr), repeat(100), fail(0)
+      : prng(), os(&std::cerr), repeat(100), nthreads(0), base(0),
+        budget(0), checks(0), fail(0)
     {
       assert(!inst);
       inst = this;
@@ -40,6 +47,154 @@ namespace origin
       return *inst;
     }
 
+    // The seeds of the cases are those of a SplitMix64 generator, indexed
+    // by the check and case numbers, so that nearby cases have unrelated
+    // streams.
+    std::uint64_t
+    context::case_seed(std::size_t n, std::size_t i) const
+    {
+      std::uint64_t z = base + 0x9e3779b97f4a7c15ull
+                      * ((std::uint64_t(n) << 32) + i + 1);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      return z ^ (z >> 31);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Complexity Implementation
+
+    double
+    complexity_exponent(complexity c)
+    {
+      switch (c) {
+      case complexity::constant:
+      case complexity::logarithmic:
+        return 0;
+      case complexity::linear:
+      case complexity::linearithmic:
+        return 1;
+      case complexity::quadratic:
+        return 2;
+      case complexity::cubic:
+        return 3;
+      }
+      return 0;
+    }
+
+    double
+    complexity_growth(complexity c, double n)
+    {
+      switch (c) {
+      case complexity::constant:
+        return 1;
+      case complexity::logarithmic:
+        return std::log2(n);
+      case complexity::linear:
+        return n;
+      case complexity::linearithmic:
+        return n * std::log2(n);
+      case complexity::quadratic:
+        return n * n;
+      case complexity::cubic:
+        return n * n * n;
+      }
+      return 1;
+    }
+
+    std::ostream&
+    operator<<(std::ostream& os, complexity c)
+    {
+      switch (c) {
+      case complexity::constant:
+        return os << "O(1)";
+      case complexity::logarithmic:
+        return os << "O(log n)";
+      case complexity::linear:
+        return os << "O(n)";
+      case complexity::linearithmic:
+        return os << "O(n log n)";
+      case complexity::quadratic:
+        return os << "O(n^2)";
+      case complexity::cubic:
+        return os << "O(n^3)";
+      }
+      return os;
+    }
+
+    complexity_fit
+    fit_complexity(const std::vector<std::size_t>& sizes,
+                   const std::vector<double>& costs)
+    {
+      if (sizes.size() != costs.size() || sizes.size() < 2)
+        throw std::invalid_argument("fit_complexity: too few sizes");
+
+      // The slope of the log-log regression.
+      const double m = double(sizes.size());
+      double sx = 0, sy = 0, sxx = 0, sxy = 0;
+      for (std::size_t i = 0; i != sizes.size(); ++i) {
+        if (!(costs[i] > 0))
+          throw std::invalid_argument("fit_complexity: non-positive cost");
+        double x = std::log(double(sizes[i]));
+        double y = std::log(costs[i]);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+      }
+      double d = m * sxx - sx * sx;
+      if (d == 0)
+        throw std::invalid_argument("fit_complexity: sizes are all equal");
+
+      complexity_fit f;
+      f.sizes = sizes;
+      f.costs = costs;
+      f.exponent = (m * sxy - sx * sy) / d;
+
+      // The class with the least relative error. Each cost is weighted by
+      // its inverse, so that the large sizes do not dominate the fit.
+      double least = std::numeric_limits<double>::infinity();
+      f.best = complexity::constant;
+      for (int k = 0; k <= int(complexity::cubic); ++k) {
+        complexity c = complexity(k);
+        double sgy = 0, sgg = 0;
+        for (std::size_t i = 0; i != sizes.size(); ++i) {
+          double g = complexity_growth(c, double(sizes[i])) / costs[i];
+          sgy += g;
+          sgg += g * g;
+        }
+        double a = sgy / sgg;
+        double err = 0;
+        for (std::size_t i = 0; i != sizes.size(); ++i) {
+          double e = a * complexity_growth(c, double(sizes[i])) / costs[i] - 1;
+          err += e * e;
+        }
+        if (err < least) {
+          least = err;
+          f.best = c;
+        }
+      }
+      return f;
+    }
+
+    std::ostream&
+    operator<<(std::ostream& os, const complexity_fit& f)
+    {
+      os << "n^" << f.exponent << ' ' << f.best << " {";
+      for (std::size_t i = 0; i != f.sizes.size(); ++i)
+        os << (i ? ", " : "") << f.sizes[i] << ": " << f.costs[i];
+      return os << '}';
+    }
+
+    std::vector<std::size_t>
+    default_sweep()
+    {
+      std::vector<std::size_t> ns;
+      for (std::size_t n = 1 << 10; n <= 1 << 16; n *= 2)
+        ns.push_back(n);
+      return ns;
+    }
+
   } // namespace tessting
 } // namespace origin
 
@@ -8,9 +8,19 @@
 #ifndef ORIGIN_TYPE_TESTING_HPP
 #define ORIGIN_TYPE_TESTING_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <limits>
+#include <mutex>
+#include <ostream>
 #include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include "type.hpp"
 
@@ -39,6 +49,9 @@ namespace origin
 // The basic testing context and support functions.
 #include "testing.impl/context.hpp"
 
+// Checking the complexity of operations.
+#include "testing.impl/complexity.hpp"
+
 // Include test support for the type library.
 #include "testing.impl/properties.hpp"
 #include "testing.impl/concepts.hpp"
@@ -0,0 +1,148 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_TYPE_TESTING_HPP
+#  error This file cannot be included directly. Include type/testing.hpp.
+#endif
+
+namespace testing
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Complexity Properties
+  //
+  // A complexity property asserts how the cost of an operation grows with
+  // the size of its input. The cost is measured by a function cost(n) over a
+  // sweep of sizes: it may return a count of the steps taken by the operation
+  // (comparisons, probes, allocations), which is exact, or the time taken by
+  // the operation, which is noisy but needs no instrumentation. For example,
+  // the amortized cost of inserting into a container of n objects is:
+  //
+  //    std::vector<int> v;
+  //    check_complexity(complexity::constant, [&v](std::size_t n) {
+  //      v.assign(n, 0);
+  //      return time_per_call([&v]() { v.push_back(0); v.pop_back(); });
+  //    });
+  //
+  // The growth of the cost is fitted in two ways. The exponent of the
+  // growth is the slope of the least-squares line through the points
+  // (log n, log cost(n)), so that a cost of c * n^k has exponent k. The best
+  // fitting complexity class is the one for which c * g(n) has the least
+  // relative error.
+  //
+  // The property fails if the exponent of the growth exceeds the exponent
+  // of the asserted class by more than a tolerance (0.5 by default). The
+  // classes between two powers of n have the exponent of the lower power,
+  // since their logarithmic factors are hard to distinguish from noise over
+  // a short sweep: O(log n) has exponent 0, and O(n log n) has exponent 1.
+  // A regression by a factor of n is caught, even by timing.
+  enum class complexity
+  {
+    constant,
+    logarithmic,
+    linear,
+    linearithmic,
+    quadratic,
+    cubic
+  };
+
+  // Returns the exponent of the class c.
+  double complexity_exponent(complexity c);
+
+  // Returns the value of the growth function of the class c at n.
+  double complexity_growth(complexity c, double n);
+
+  // Write the class c in big-O notation, e.g., "O(n log n)".
+  std::ostream& operator<<(std::ostream& os, complexity c);
+
+
+  // The fit of a sweep of costs.
+  struct complexity_fit
+  {
+    std::vector<std::size_t> sizes;
+    std::vector<double>      costs;
+    double                   exponent;
+    complexity               best;
+  };
+
+  // Fit the costs measured at the given sizes. There must be at least two
+  // distinct sizes, and the costs must be positive.
+  complexity_fit
+  fit_complexity(const std::vector<std::size_t>& sizes,
+                 const std::vector<double>& costs);
+
+  // Write the fit f as its exponent and best fitting class, followed by its
+  // sweep.
+  std::ostream& operator<<(std::ostream& os, const complexity_fit& f);
+
+
+  // The default sweep doubles the size from 2^10 to 2^16.
+  std::vector<std::size_t> default_sweep();
+
+  // Measure the cost of an operation over a sweep of sizes, and fit it.
+  template <typename F>
+    complexity_fit
+    measure_complexity(F cost, const std::vector<std::size_t>& sizes)
+    {
+      std::vector<double> costs;
+      for (std::size_t n : sizes)
+        costs.push_back(cost(n));
+      return fit_complexity(sizes, costs);
+    }
+
+
+  // Returns the median time, in seconds, of a call to f. The calls are timed
+  // in batches of at least min_time seconds, and the median of the batches
+  // is taken so that a batch delayed by the system does not distort the
+  // result.
+  template <typename F>
+    double
+    time_per_call(F f, double min_time = 0.002, std::size_t batches = 5)
+    {
+      using clock = std::chrono::steady_clock;
+      std::vector<double> ts;
+      std::size_t n = 1;
+      while (ts.size() != batches) {
+        auto start = clock::now();
+        for (std::size_t i = 0; i != n; ++i)
+          f();
+        std::chrono::duration<double> t = clock::now() - start;
+        if (t.count() < min_time)
+          n *= 2;
+        else
+          ts.push_back(t.count() / n);
+      }
+      std::sort(ts.begin(), ts.end());
+      return ts[batches / 2];
+    }
+
+
+  // The predicate checked by check_complexity.
+  struct within_complexity
+  {
+    bool operator()(const complexity_fit& f) const
+    {
+      return f.exponent <= complexity_exponent(bound) + tolerance;
+    }
+
+    complexity bound;
+    double     tolerance;
+  };
+
+  // Check that the cost of an operation, measured by cost(n) over a sweep
+  // of sizes, grows no faster than the class c. A failure is logged with
+  // the fit of the sweep.
+  template <typename F>
+    inline void
+    check_complexity(complexity c, F cost,
+                     const std::vector<std::size_t>& sizes = default_sweep(),
+                     double tolerance = 0.5)
+    {
+      complexity_fit f = measure_complexity(cost, sizes);
+      context::instance().check(within_complexity {c, tolerance}, f);
+    }
+
+} // namespace testing
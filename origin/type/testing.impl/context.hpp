@@ -15,6 +15,28 @@ namespace testing
   // Context 
   //
   // The context class...
+  //
+  // By default, the test cases of each quick check are evaluated one after
+  // the other, with values drawn from a single pseudo-random number
+  // generator. Setting the number of threads to n (n >= 1) evaluates the
+  // cases of each quick check on n threads instead. Each case draws its
+  // values from its own stream: a generator seeded by the seed of the
+  // context, the number of the quick check within the context, and the
+  // number of the case within the check. The values of each case are
+  // therefore the same whatever the number of threads or the order in which
+  // the cases are evaluated, and a failure is replayed by running the tests
+  // again with the same seed, e.g., on one thread. The seed and case
+  // numbers are logged with each failure.
+  //
+  // A time budget, in seconds, bounds the wall-clock time of each quick
+  // check: no case is started once the budget is spent, even if fewer than
+  // repetitions() cases have been evaluated. So that long running suites can
+  // be bounded in time rather than in cases, a budgeted check may be given a
+  // large number of repetitions.
+  //
+  // Failures are counted and logged safely from any thread. A property that
+  // throws an exception during a parallel check stops the check, and the
+  // exception is rethrown by quick_check.
   class context
   {
   public:
@@ -27,8 +49,9 @@ namespace testing
     // Properties
 
     // Returns a reference to the pseudo-random number generator provided by the
-    // testing context.
-    std::minstd_rand& random_engine() { return prng; }
+    // testing context. When called while evaluating a case of a parallel
+    // quick check, this is the stream of the case.
+    std::minstd_rand& random_engine() { return stream ? *stream : prng; }
 
     // Get and set the stream to which errors are written 
     std::ostream& error_stream()                { return *os; }
@@ -37,9 +60,29 @@ namespace testing
     // Returns the number of observed test case failures.
     std::size_t failures() const { return fail; }
 
-    // Returns the number of values instantiated from quantified values for
-    // each testable property.
-    std::size_t repetitions() const { return repeat; }
+    // Get and set the number of values instantiated from quantified values
+    // for each testable property.
+    std::size_t repetitions() const      { return repeat; }
+    void        repetitions(std::size_t n) { repeat = n; }
+
+    // Get and set the number of threads evaluating the cases of each quick
+    // check. If n is 0, the cases are evaluated serially, drawing their
+    // values from random_engine().
+    std::size_t threads() const        { return nthreads; }
+    void        threads(std::size_t n) { nthreads = n; }
+
+    // Get and set the seed from which the stream of each case of a parallel
+    // quick check is derived.
+    std::uint64_t seed() const          { return base; }
+    void          seed(std::uint64_t s) { base = s; }
+
+    // Get and set the time budget, in seconds, of each quick check. If s is
+    // 0, the check is not bounded in time.
+    double time_budget() const   { return budget; }
+    void   time_budget(double s) { budget = s; }
+
+    // Returns the seed of the stream of case i of the quick check numbered n.
+    std::uint64_t case_seed(std::size_t n, std::size_t i) const;
 
     // Testing
 
@@ -50,6 +93,11 @@ namespace testing
       void quick_check(Prop prop, Args&&... args);
 
 
+    // Evaluate repetitions() cases of prop over the quantified variables
+    // args.
+    template <typename Prop, typename... Args>
+      void check_cases(Prop& prop, Args&... args);
+
   // private:
 
     // Write an error message for a failed test.
@@ -57,16 +105,32 @@ namespace testing
       void error(Prop prop, Args&&... args);
 
   private:
+    // Evaluate the cases of the parallel quick check numbered n.
+    template <typename Prop, typename... Args>
+      void check_parallel(std::size_t n, Prop& prop, Args&... args);
+
     // Singleton
     static context* inst;
 
+    // The stream of the case being evaluated by this thread, if any, and
+    // its numbers.
+    static thread_local std::minstd_rand* stream;
+    static thread_local std::size_t stream_check;
+    static thread_local std::size_t stream_case;
+
     // Resources
     std::minstd_rand prng;    // The pseudo-random number generator
     std::ostream* os;         // A logging output stream
+    std::mutex log_lock;      // Serializes writes to os
 
     // Quick-check poliices.
     std::size_t repeat;   // Number of repetitions for quantified tests.
-    std::size_t fail;     // Number of observed failures
+    std::size_t nthreads; // Number of threads evaluating cases
+    std::uint64_t base;   // The seed of parallel checks
+    double budget;        // The time budget of each check, in seconds
+    std::size_t checks;   // Number of parallel checks started
+
+    std::atomic<std::size_t> fail; // Number of observed failures
   };
 
 
@@ -98,8 +162,7 @@ namespace testing
       inline Requires<Predicate<Prop, Result_of<Args()>...>(), void>
       check_prop(context& cxt, Prop& prop, Args&&... args)
       {
-        for (std::size_t i = 0; i < cxt.repetitions(); ++i)
-          cxt.check(prop, args()...);
+        cxt.check_cases(prop, args...);
       }
 
     // When Prop is not a predicate, we call it as a function.
@@ -122,6 +185,76 @@ namespace testing
     }
 
 
+  template <typename Prop, typename... Args>
+    void context::check_cases(Prop& prop, Args&... args)
+    {
+      if (nthreads != 0) {
+        check_parallel(checks++, prop, args...);
+        return;
+      }
+
+      using clock = std::chrono::steady_clock;
+      auto start = clock::now();
+      for (std::size_t i = 0; i < repeat; ++i) {
+        if (budget > 0) {
+          std::chrono::duration<double> t = clock::now() - start;
+          if (t.count() >= budget)
+            break;
+        }
+        check(prop, args()...);
+      }
+    }
+
+
+  // Each thread evaluates cases with copies of the property and the
+  // quantified variables, so that the state of the variables (e.g., that of
+  // a random number distribution) is not shared between threads. The cases
+  // are claimed in order from a shared counter.
+  template <typename Prop, typename... Args>
+    void context::check_parallel(std::size_t n, Prop& prop, Args&... args)
+    {
+      using clock = std::chrono::steady_clock;
+      auto stop = clock::now() + std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(budget));
+
+      std::atomic<std::size_t> next(0);
+      std::exception_ptr thrown;
+      std::mutex lock;
+      auto work = [this, n, stop, &next, &thrown, &lock, prop, args...]()
+        mutable
+      {
+        std::minstd_rand engine;
+        stream = &engine;
+        stream_check = n;
+        try {
+          for (;;) {
+            std::size_t i = next++;
+            if (i >= repeat || (budget > 0 && clock::now() >= stop))
+              break;
+            engine.seed(case_seed(n, i));
+            stream_case = i;
+            check(prop, args()...);
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(lock);
+          if (!thrown)
+            thrown = std::current_exception();
+          next = repeat;
+        }
+        stream = nullptr;
+      };
+
+      std::vector<std::thread> workers;
+      for (std::size_t i = 1; i < nthreads; ++i)
+        workers.emplace_back(work);
+      work();
+      for (std::thread& t : workers)
+        t.join();
+      if (thrown)
+        std::rethrow_exception(thrown);
+    }
+
+
   namespace type_impl
   {
     // Write the specified argument to os along with its type. The output 
@@ -167,14 +300,24 @@ namespace testing
 
   // Write an error message to this->os regarding the failure of a test case.
   // The message includes the name of the failed property and the values of
-  // the arguments, if streamable.
+  // the arguments, if streamable. The failure of a case of a parallel check
+  // also gives the seed and numbers of the case, so that it can be replayed.
+  // The message is written as a whole, so that the messages of failures on
+  // different threads are not interleaved.
   template <typename Prop, typename... Args>
     void
     context::error(Prop prop, Args&&... args)
     {
-      *os << "error:" << ' ' << typestr<Prop>() << ':' << ' ';
-      type_impl::log_args(*os, std::forward<Args>(args)...);
-      *os << '\n';
+      std::ostringstream ss;
+      ss << "error:" << ' ' << typestr<Prop>() << ':' << ' ';
+      type_impl::log_args(ss, std::forward<Args>(args)...);
+      if (stream)
+        ss << " [seed " << base << ", check " << stream_check
+           << ", case " << stream_case << ']';
+      ss << '\n';
+
+      std::lock_guard<std::mutex> guard(log_lock);
+      *os << ss.str();
     }
 
 
@@ -214,11 +357,32 @@ namespace testing
   //    auto n = quantify_over(dist);
   //    quick_check(equvalence_relation {}, equal_to<int> {}, n);
   //
+  //
+  // The generator draws its values from the random engine of the testing
+  // context when it is called, so that the cases of a parallel quick check
+  // draw from their own streams.
+  template <typename Dist>
+    class quantifier
+    {
+    public:
+      quantifier(const Dist& d)
+        : dist(d)
+      { }
+
+      auto operator()()
+        -> decltype(std::declval<Dist&>()(std::declval<std::minstd_rand&>()))
+      {
+        return dist(context::instance().random_engine());
+      }
+
+    private:
+      Dist dist;
+    };
+
   template <typename Dist>
-    auto quantify_over(const Dist& dist)
-      -> decltype(std::bind(dist, context::instance().random_engine()))
+    quantifier<Dist> quantify_over(const Dist& dist)
     {
-      return std::bind(dist, context::instance().random_engine());
+      return {dist};
     }
 
 
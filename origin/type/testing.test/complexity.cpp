@@ -0,0 +1,114 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin::testing;
+
+// Returns the class that best fits the cost c * g(n) over the default
+// sweep.
+complexity
+best_fit(complexity c)
+{
+  return measure_complexity([c](size_t n) {
+    return 3 * complexity_growth(c, double(n));
+  }, default_sweep()).best;
+}
+
+void
+check_fit()
+{
+  for (int k = 0; k <= int(complexity::cubic); ++k)
+    assert(best_fit(complexity(k)) == complexity(k));
+
+  complexity_fit f = fit_complexity({10, 100, 1000}, {2, 20, 200});
+  assert(abs(f.exponent - 1) < 1e-9);
+  f = fit_complexity({10, 100, 1000}, {5, 5, 5});
+  assert(abs(f.exponent) < 1e-9 && f.best == complexity::constant);
+
+  ostringstream ss;
+  ss << complexity::linearithmic;
+  assert(ss.str() == "O(n log n)");
+
+  try {
+    fit_complexity({10, 10}, {1, 2});
+    assert(false);
+  } catch (invalid_argument&) { }
+}
+
+// Counts are exact, so their growth is checked without noise.
+void
+check_counts()
+{
+  context cxt;
+  ostringstream os;
+  cxt.error_stream(os);
+
+  // The number of comparisons of a search in a set of n integers.
+  auto search = [](size_t n) {
+    size_t count = 0;
+    auto less = [&count](int a, int b) { ++count; return a < b; };
+    set<int, decltype(less)> s(less);
+    for (size_t i = 0; i != n; ++i)
+      s.insert(int(i));
+    count = 0;
+    s.find(int(n / 3));
+    return double(count);
+  };
+  check_complexity(complexity::logarithmic, search);
+  assert(cxt.failures() == 0);
+
+  // A linear scan is not constant.
+  auto scan = [](size_t n) { return double(n); };
+  check_complexity(complexity::linear, scan);
+  assert(cxt.failures() == 0);
+  check_complexity(complexity::constant, scan);
+  assert(cxt.failures() == 1);
+  assert(os.str().find("n^1") != string::npos);
+}
+
+// Timed costs are noisy, but a growth by a factor of n is still seen.
+void
+check_times()
+{
+  context cxt;
+  ostringstream os;
+  cxt.error_stream(os);
+
+  vector<int> v;
+  auto push = [&v](size_t n) {
+    v.assign(n, 0);
+    return time_per_call([&v]() { v.push_back(0); v.pop_back(); });
+  };
+  check_complexity(complexity::constant, push);
+  assert(cxt.failures() == 0);
+
+  auto copy = [&v](size_t n) {
+    v.assign(n, 0);
+    return time_per_call([&v]() {
+      vector<int> w = v;
+      assert(w.size() == v.size());
+    });
+  };
+  check_complexity(complexity::constant, copy);
+  assert(cxt.failures() == 1);
+}
+
+int main()
+{
+  check_fit();
+  check_counts();
+  check_times();
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin::testing;
+
+// Records the values of the cases it evaluates.
+struct recorder
+{
+  bool operator()(int n) const
+  {
+    lock_guard<mutex> guard(*lock);
+    values->push_back(n);
+    return n % 2 == 0;
+  }
+
+  mutex* lock;
+  vector<int>* values;
+};
+
+// Returns the sorted values of the cases of a quick check on n threads, and
+// sets the number of failures and the log.
+vector<int>
+run_cases(size_t n, size_t& failures, string& log)
+{
+  context cxt;
+  ostringstream os;
+  cxt.error_stream(os);
+  cxt.threads(n);
+  cxt.seed(42);
+  cxt.repetitions(1000);
+
+  mutex lock;
+  vector<int> values;
+  quick_check(recorder {&lock, &values}, quantify_over<int>());
+  failures = cxt.failures();
+  log = os.str();
+  sort(values.begin(), values.end());
+  return values;
+}
+
+// The cases of a parallel check are the same whatever the number of
+// threads, and each failure is logged once, with its seed.
+void
+check_deterministic()
+{
+  size_t f1, f4;
+  string l1, l4;
+  vector<int> v1 = run_cases(1, f1, l1);
+  vector<int> v4 = run_cases(4, f4, l4);
+  assert(v1.size() == 1000);
+  assert(v1 == v4);
+  assert(f1 == f4 && f1 > 0 && f1 < 1000);
+  assert(size_t(count(l4.begin(), l4.end(), '\n')) == f4);
+  assert(l4.find("[seed 42, check 0, case ") != string::npos);
+
+  context cxt;
+  assert(cxt.case_seed(0, 1) != cxt.case_seed(0, 2));
+  assert(cxt.case_seed(0, 1) != cxt.case_seed(1, 1));
+}
+
+// A time budget stops a check that would otherwise run for a long time.
+void
+check_budget()
+{
+  context cxt;
+  cxt.threads(2);
+  cxt.time_budget(0.05);
+  cxt.repetitions(size_t(1) << 40);
+
+  auto start = chrono::steady_clock::now();
+  quick_check([](int) { return true; }, quantify_over<int>());
+  chrono::duration<double> t = chrono::steady_clock::now() - start;
+  assert(t.count() < 5);
+  assert(cxt.failures() == 0);
+
+  // Serial checks are also bounded.
+  cxt.threads(0);
+  start = chrono::steady_clock::now();
+  quick_check([](int) { return true; }, quantify_over<int>());
+  t = chrono::steady_clock::now() - start;
+  assert(t.count() < 5);
+}
+
+// An exception thrown by a property stops the check, and is rethrown.
+void
+check_exception()
+{
+  context cxt;
+  cxt.threads(3);
+  try {
+    quick_check([](int) -> bool { throw runtime_error("oops"); },
+                quantify_over<int>());
+    assert(false);
+  } catch (runtime_error&) { }
+}
+
+int main()
+{
+  check_deterministic();
+  check_budget();
+  check_exception();
+}
@@ -8,8 +8,11 @@
 #ifndef ORIGIN_TYPE_TRAITS_HPP
 #define ORIGIN_TYPE_TRAITS_HPP
 
+#include <memory>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "default.hpp"
 
@@ -1538,6 +1541,68 @@ namespace origin
   // required constructors and destructors (i.e., they must be trivial).
  template <typename T>
     constexpr bool Trivial() { return std::is_trivial<T>::value; }
+
+
+
+  // ------------------------------------------------------------------------ //
+  // Trivial Relocation                                       [type.relocatable]
+  //
+  // A type is trivially relocatable if moving an object to a new address
+  // and destroying the original has the same effect as copying its bytes
+  // and forgetting the original. Containers relocate the elements of such
+  // types with a single memcpy when they grow, rather than move-constructing
+  // and destroying each one. Objects that store pointers into themselves,
+  // such as std::string with its inline buffer and small_vector (see
+  // data.small_vector), are not trivially relocatable.
+  //
+  // Trivially copyable types are trivially relocatable. Other types opt in
+  // by specializing is_trivially_relocatable, as is done here for the
+  // standard allocator, smart pointers, pairs and tuples of trivially
+  // relocatable types, and, with the GNU and LLVM standard libraries, for
+  // vectors whose allocators are trivially relocatable.
+  template <typename T>
+    struct is_trivially_relocatable
+      : std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+    { };
+
+  // Returns true if T is trivially relocatable.
+  template <typename T>
+    constexpr bool Trivially_relocatable()
+    {
+      return is_trivially_relocatable<T>::value;
+    }
+
+  template <typename T>
+    struct is_trivially_relocatable<std::allocator<T>> : std::true_type { };
+
+  template <typename T, typename D>
+    struct is_trivially_relocatable<std::unique_ptr<T, D>>
+      : is_trivially_relocatable<D>
+    { };
+
+  template <typename T>
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type { };
+
+  template <typename T>
+    struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type { };
+
+  template <typename T, typename U>
+    struct is_trivially_relocatable<std::pair<T, U>>
+      : std::integral_constant<bool, Trivially_relocatable<T>()
+                                     && Trivially_relocatable<U>()>
+    { };
+
+  template <typename... Ts>
+    struct is_trivially_relocatable<std::tuple<Ts...>>
+      : std::integral_constant<bool, All(Trivially_relocatable<Ts>()...)>
+    { };
+
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)
+  template <typename T, typename A>
+    struct is_trivially_relocatable<std::vector<T, A>>
+      : is_trivially_relocatable<A>
+    { };
+#endif
     
 
 
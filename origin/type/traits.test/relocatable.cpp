@@ -0,0 +1,59 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <origin/type/traits.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A type that points into itself.
+struct self
+{
+  self() : p(&n) { }
+  self(const self& x) : n(x.n), p(&n) { }
+
+  int n;
+  int* p;
+};
+
+// A type that opts in.
+struct handle
+{
+  handle() { }
+  handle(const handle&) { }
+  ~handle() { }
+};
+
+namespace origin
+{
+  template <>
+    struct is_trivially_relocatable<handle> : std::true_type { };
+} // namespace origin
+
+int main()
+{
+  static_assert(Trivially_relocatable<int>(), "");
+  static_assert(Trivially_relocatable<int*>(), "");
+  static_assert(Trivially_relocatable<handle>(), "");
+  static_assert(!Trivially_relocatable<self>(), "");
+
+  static_assert(Trivially_relocatable<unique_ptr<int>>(), "");
+  static_assert(Trivially_relocatable<shared_ptr<self>>(), "");
+  static_assert(Trivially_relocatable<pair<const int, handle>>(), "");
+  static_assert(Trivially_relocatable<tuple<int, handle, unique_ptr<int>>>(),
+                "");
+  static_assert(!Trivially_relocatable<pair<int, self>>(), "");
+  static_assert(!Trivially_relocatable<tuple<int, self>>(), "");
+
+  // Strings may hold their characters in an inline buffer.
+  static_assert(!Trivially_relocatable<string>(), "");
+}
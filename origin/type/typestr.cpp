@@ -5,7 +5,7 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
-#include <cstring>
+#include <cstdlib>
 
 #include "typestr.hpp"
 
@@ -13,14 +13,19 @@ namespace origin
 {
   namespace type_impl
   {
+    // The demangler allocates the name, which is copied and freed.
     std::string to_string(const std::type_info& info)
     {
 #if defined(__GNUC__)
-        static constexpr std::size_t max_buffer = 8192;
-        char buf[max_buffer];
-        std::size_t n = max_buffer;
-        abi::__cxa_demangle(info.name(), buf, &n, 0); 
-        return std::move(std::string(buf, ::strlen(buf)));
+        int status = 0;
+        char* p = abi::__cxa_demangle(info.name(), nullptr, nullptr, &status);
+        if (!p)
+          return info.name();
+        std::string str(p);
+        std::free(p);
+        return str;
+#else
+        return info.name();
 #endif
     }
 
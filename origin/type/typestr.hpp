@@ -58,16 +58,21 @@ namespace origin
   //
   // When multiple arguments are given, the resulting string is written in
   // initializer list format: "{T1, T2, ...}".
+  //
+  // The string is computed once for each sequence of types, when it is first
+  // requested, and the same string is returned by every later call, so that
+  // logging a type name does not demangle it again or allocate.
   template <typename... Args>
-    inline std::string typestr()
+    inline const std::string& typestr()
     {
-      return type_impl::typestr_dispatch<Args...>{}();
+      static const std::string str = type_impl::typestr_dispatch<Args...>{}();
+      return str;
     }
     
   // Return a textual representation of the type name of the given argument.
   //
   template <typename... Args>
-    inline std::string typestr(Args&&...)
+    inline const std::string& typestr(Args&&...)
     {
       return typestr<Args...>();
     }
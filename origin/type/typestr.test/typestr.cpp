@@ -77,5 +77,9 @@ int main()
   assert((typestr<const int&, char*>() == "const int&, char*"));
 
 
+  // The name of a type is computed once.
+  assert(&typestr<int>() == &typestr<int>());
+  assert(&typestr(0) == &typestr<int>());
+
   // TODO: Test the use of typest with object arguments.
 }
@@ -0,0 +1,72 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+// Compare the results of the programs of a performance comparison, written
+// as CSV by each benchmark program (see origin_perf_comparison).
+//
+//    perf_report [--output=path] [--max-ratio=r] results...
+//
+// The report lists the median time of each benchmark in the first results
+// and its ratio in the others. If --max-ratio is given, the report fails
+// when any ratio exceeds r, so that a comparison can gate a release.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <origin/benchmark/benchmark.hpp>
+
+using namespace std;
+using namespace origin;
+
+int main(int argc, char** argv)
+{
+  string output;
+  double max_ratio = 0;
+  vector<string> names;
+  vector<vector<benchmark_result>> results;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      string arg = argv[i];
+      if (arg.compare(0, 9, "--output=") == 0) {
+        output = arg.substr(9);
+      } else if (arg.compare(0, 12, "--max-ratio=") == 0) {
+        max_ratio = atof(arg.c_str() + 12);
+      } else {
+        ifstream is(arg);
+        if (!is)
+          throw invalid_argument("cannot read " + arg);
+        results.push_back(read_csv(is));
+        string name = arg.substr(arg.find_last_of('/') + 1);
+        names.push_back(name.substr(0, name.find('.')));
+      }
+    }
+  } catch (invalid_argument& e) {
+    cerr << e.what() << '\n';
+    return 2;
+  }
+
+  double worst;
+  if (output.empty()) {
+    worst = write_comparison(cout, names, results);
+  } else {
+    ofstream os(output);
+    worst = write_comparison(os, names, results);
+    if (!os) {
+      cerr << "cannot write " << output << '\n';
+      return 1;
+    }
+  }
+  if (max_ratio > 0 && worst > max_ratio) {
+    cerr << "performance ratio " << worst << " exceeds " << max_ratio << '\n';
+    return 1;
+  }
+  return 0;
+}